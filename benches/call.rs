@@ -898,6 +898,9 @@ mod indirect {
                 different_callees(&mut group, lazy, calls);
             }
         }
+        for cache in [true, false] {
+            private_table(&mut group, cache, 65536);
+        }
     }
 
     fn same_callee(group: &mut BenchmarkGroup<'_, WallTime>, lazy: bool, calls: u64) {
@@ -1041,4 +1044,74 @@ mod indirect {
             });
         });
     }
+
+    /// Calls through a table private to the module, which is never modified
+    /// and holds functions of a single type, like the dispatch loop of an
+    /// interpreter. With `cache` each call site remembers its last callee,
+    /// see `Config::cache_call_indirects`.
+    fn private_table(group: &mut BenchmarkGroup<'_, WallTime>, cache: bool, calls: u64) {
+        let name = format!(
+            "private-table/cache-{}/{calls}-calls",
+            if cache { "on" } else { "off" }
+        );
+        group.bench_function(name, |b| {
+            let mut config = Config::new();
+            config.cache_call_indirects(cache);
+            let engine = Engine::new(&config).unwrap();
+
+            // Calls the same function four times in a row before moving on
+            // to the next one, like a loop of an interpreted program.
+            let module = Module::new(
+                &engine,
+                r#"
+                    (module
+                        (type $ty (func (param i32) (result i32)))
+                        (func $a (type $ty) (i32.add (local.get 0) (i32.const 1)))
+                        (func $b (type $ty) (i32.xor (local.get 0) (i32.const 3)))
+                        (func $c (type $ty) (i32.shl (local.get 0) (i32.const 1)))
+                        (func $d (type $ty) (i32.sub (local.get 0) (i32.const 5)))
+                        (table 4 4 funcref)
+                        (elem (table 0) (i32.const 0) func $a $b $c $d)
+                        (func (export "run") (param $calls i32) (result i32)
+                            (local $acc i32)
+                            loop
+                                (if (i32.eqz (local.get $calls))
+                                    (then (return (local.get $acc))))
+                                (local.set $calls (i32.sub (local.get $calls) (i32.const 1)))
+                                (local.set $acc
+                                    (call_indirect (type $ty)
+                                        (local.get $acc)
+                                        (i32.and
+                                            (i32.shr_u (local.get $calls) (i32.const 2))
+                                            (i32.const 3))))
+                                br 0
+                            end
+                            unreachable
+                        )
+                    )
+                "#,
+            )
+            .unwrap();
+
+            b.iter_custom(move |iters| {
+                let mut total = Duration::from_millis(0);
+
+                for _ in 0..iters {
+                    let mut store = Store::new(&engine, ());
+                    let instance = Instance::new(&mut store, &module, &[]).unwrap();
+                    let run = instance
+                        .get_typed_func::<u32, u32>(&mut store, "run")
+                        .unwrap();
+
+                    let start = Instant::now();
+                    let result = run.call(&mut store, calls.try_into().unwrap());
+                    total += start.elapsed();
+
+                    result.unwrap();
+                }
+
+                total
+            });
+        });
+    }
 }
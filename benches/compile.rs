@@ -2,6 +2,11 @@
 //!
 //! Drop in new `*.wasm` or `*.wat` files in `benches/compile` to add
 //! benchmarks. To try new compilation configurations, modify [`Scenario`].
+//!
+//! Files which export a `run` function taking no parameters and returning no
+//! results also have the run time of that function measured, so that the
+//! compile time of each scenario can be weighed against the speed of the code
+//! it produces, for example Winch against Cranelift.
 
 use core::fmt;
 use criterion::measurement::WallTime;
@@ -71,6 +76,20 @@ fn compile(group: &mut BenchmarkGroup<WallTime>, path: &Path, scenario: Scenario
     group.bench_function(id, |b| {
         b.iter(|| Module::new(&engine, &bytes).unwrap());
     });
+
+    let module = Module::new(&engine, &bytes).unwrap();
+    if module.get_export("run").is_none() {
+        return;
+    }
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[]).unwrap();
+    let run = instance
+        .get_typed_func::<(), ()>(&mut store, "run")
+        .expect("`run` should take no parameters and return no results");
+    let id = BenchmarkId::new("run", filename);
+    group.bench_function(id, |b| {
+        b.iter(|| run.call(&mut store, ()).unwrap());
+    });
 }
 
 fn bench_compile(c: &mut Criterion) {
@@ -0,0 +1,14 @@
+;; A loop over linear memory, exported as `run` so that the run time of the
+;; code produced by each compiler is measured alongside its compile time.
+(module
+  (memory 1)
+  (func (export "run")
+    (local $i i32)
+    (local $sum i32)
+    (loop $loop
+      (local.set $sum
+        (i32.add (local.get $sum) (i32.load (local.get $i))))
+      (i32.store (local.get $i) (local.get $sum))
+      (local.set $i (i32.add (local.get $i) (i32.const 4)))
+      (br_if $loop (i32.lt_u (local.get $i) (i32.const 65536)))))
+)
@@ -0,0 +1,216 @@
+//! Benchmarks of the canonical ABI for component calls with realistic value
+//! shapes: strings, lists, records and resources.
+//!
+//! The component used here lives in `benches/component/shapes.wat` and is
+//! shared with the C++ harness in `crates/c-api/tests/bench`. Calls between
+//! two components use `benches/component/adapters.wat`.
+
+use criterion::measurement::WallTime;
+use criterion::{BenchmarkGroup, Criterion, criterion_group, criterion_main};
+use std::time::Instant;
+use wasmtime::component::{
+    Component, ComponentType, Lift, Linker, Lower, Resource, ResourceType, Val,
+};
+use wasmtime::{Config, Engine, Store};
+
+criterion_main!(benches);
+criterion_group!(benches, measure_execution_time);
+
+const SHAPES: &str = include_str!("component/shapes.wat");
+const ADAPTERS: &str = include_str!("component/adapters.wat");
+
+/// The number of characters in strings, and elements in lists, which are
+/// passed to and from the guest.
+const LEN: usize = 100;
+
+#[derive(ComponentType, Lift, Lower, Clone, PartialEq, Debug)]
+#[component(record)]
+struct Point {
+    x: u32,
+    name: String,
+    data: Vec<u32>,
+}
+
+struct R;
+
+fn point() -> Point {
+    Point {
+        x: 1,
+        name: "a".repeat(LEN),
+        data: (0..LEN as u32).collect(),
+    }
+}
+
+fn point_val() -> Val {
+    Val::Record(vec![
+        ("x".to_string(), Val::U32(1)),
+        ("name".to_string(), Val::String("a".repeat(LEN))),
+        (
+            "data".to_string(),
+            Val::List((0..LEN as u32).map(Val::U32).collect()),
+        ),
+    ])
+}
+
+fn measure_execution_time(c: &mut Criterion) {
+    let mut config = Config::new();
+    config.wasm_component_model(true);
+    let engine = Engine::new(&config).unwrap();
+    let component = Component::new(&engine, SHAPES).unwrap();
+
+    let mut group = c.benchmark_group("component-shapes");
+    host_to_wasm(&mut group, &engine, &component);
+    wasm_to_host(&mut group, &engine, &component);
+    wasm_to_wasm(&mut group, &engine);
+}
+
+/// Returns a linker with the resource used by `SHAPES` and, if `typed`, host
+/// functions defined with `func_wrap`, or otherwise with `func_new`.
+fn linker(engine: &Engine, typed: bool) -> Linker<()> {
+    let mut linker = Linker::new(engine);
+    let mut root = linker.root();
+    root.resource("r", ResourceType::host::<R>(), |_, _| Ok(()))
+        .unwrap();
+    if typed {
+        root.func_wrap("host-string", |_, (s,): (String,)| Ok((s,)))
+            .unwrap();
+        root.func_wrap("host-list", |_, (l,): (Vec<u32>,)| Ok((l,)))
+            .unwrap();
+        root.func_wrap("host-record", |_, (p,): (Point,)| Ok((p,)))
+            .unwrap();
+    } else {
+        for name in ["host-string", "host-list", "host-record"] {
+            root.func_new(name, |_, _, params, results| {
+                results[0] = params[0].clone();
+                Ok(())
+            })
+            .unwrap();
+        }
+    }
+    linker
+}
+
+/// Benchmarks lowering arguments into, and lifting results out of, a guest.
+fn host_to_wasm(group: &mut BenchmarkGroup<'_, WallTime>, engine: &Engine, component: &Component) {
+    let mut store = Store::new(engine, ());
+    let instance = linker(engine, true)
+        .instantiate(&mut store, component)
+        .unwrap();
+
+    let s = "a".repeat(LEN);
+    group.bench_function("host-to-wasm - typed - string", |b| {
+        let f = instance
+            .get_typed_func::<(&str,), (String,)>(&mut store, "echo-string")
+            .unwrap();
+        b.iter(|| {
+            let (ret,) = f.call(&mut store, (s.as_str(),)).unwrap();
+            assert_eq!(ret.len(), LEN);
+        })
+    });
+
+    let l = (0..LEN as u32).collect::<Vec<_>>();
+    group.bench_function("host-to-wasm - typed - list", |b| {
+        let f = instance
+            .get_typed_func::<(&[u32],), (Vec<u32>,)>(&mut store, "echo-list")
+            .unwrap();
+        b.iter(|| {
+            let (ret,) = f.call(&mut store, (l.as_slice(),)).unwrap();
+            assert_eq!(ret.len(), LEN);
+        })
+    });
+
+    let p = point();
+    group.bench_function("host-to-wasm - typed - record", |b| {
+        let f = instance
+            .get_typed_func::<(&Point,), (Point,)>(&mut store, "echo-record")
+            .unwrap();
+        b.iter(|| {
+            let (ret,) = f.call(&mut store, (&p,)).unwrap();
+            assert_eq!(ret.data.len(), LEN);
+        })
+    });
+
+    group.bench_function("host-to-wasm - typed - borrow", |b| {
+        let f = instance
+            .get_typed_func::<(Resource<R>,), ()>(&mut store, "borrow")
+            .unwrap();
+        b.iter(|| f.call(&mut store, (Resource::new_borrow(1),)).unwrap())
+    });
+
+    group.bench_function("host-to-wasm - typed - own", |b| {
+        let f = instance
+            .get_typed_func::<(Resource<R>,), ()>(&mut store, "own")
+            .unwrap();
+        b.iter(|| f.call(&mut store, (Resource::new_own(1),)).unwrap())
+    });
+
+    let untyped = [
+        ("string", Val::String(s.clone())),
+        ("list", Val::List(l.iter().copied().map(Val::U32).collect())),
+        ("record", point_val()),
+    ];
+    for (shape, param) in untyped {
+        group.bench_function(&format!("host-to-wasm - untyped - {shape}"), |b| {
+            let f = instance
+                .get_func(&mut store, &format!("echo-{shape}"))
+                .unwrap();
+            let params = [param.clone()];
+            let mut results = [Val::Bool(false)];
+            b.iter(|| {
+                f.call(&mut store, &params, &mut results).unwrap();
+                assert_eq!(results[0], params[0]);
+            })
+        });
+    }
+}
+
+/// Benchmarks the dispatch of host functions called from a guest, including
+/// lifting their arguments out of, and lowering their results into, the guest.
+fn wasm_to_host(group: &mut BenchmarkGroup<'_, WallTime>, engine: &Engine, component: &Component) {
+    for (desc, typed) in [("typed", true), ("untyped", false)] {
+        let mut store = Store::new(engine, ());
+        let instance = linker(engine, typed)
+            .instantiate(&mut store, component)
+            .unwrap();
+        let args = [
+            ("string", Val::String("a".repeat(LEN))),
+            ("list", Val::List((0..LEN as u32).map(Val::U32).collect())),
+            ("record", point_val()),
+        ];
+        for (shape, arg) in args {
+            group.bench_function(&format!("wasm-to-host - {desc} - {shape}"), |b| {
+                let run = instance
+                    .get_func(&mut store, &format!("run-host-{shape}"))
+                    .unwrap();
+                b.iter_custom(|iters| {
+                    let start = Instant::now();
+                    run.call(&mut store, &[Val::U64(iters), arg.clone()], &mut [])
+                        .unwrap();
+                    start.elapsed()
+                })
+            });
+        }
+    }
+}
+
+/// Benchmarks calls from one component to another, which pass strings and
+/// lists through the adapters between the two.
+fn wasm_to_wasm(group: &mut BenchmarkGroup<'_, WallTime>, engine: &Engine) {
+    let component = Component::new(engine, ADAPTERS).unwrap();
+    let mut store = Store::new(engine, ());
+    let instance = Linker::new(engine)
+        .instantiate(&mut store, &component)
+        .unwrap();
+    for shape in ["string", "list"] {
+        group.bench_function(&format!("wasm-to-wasm - {shape}"), |b| {
+            let run = instance
+                .get_typed_func::<(u64, u32), ()>(&mut store, &format!("run-{shape}"))
+                .unwrap();
+            b.iter_custom(|iters| {
+                let start = Instant::now();
+                run.call(&mut store, (iters, LEN as u32)).unwrap();
+                start.elapsed()
+            })
+        });
+    }
+}
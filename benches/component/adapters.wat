@@ -0,0 +1,114 @@
+;; Two components, one of which calls the other, used to benchmark the adapters
+;; which copy strings and lists between their memories.
+(component
+  (component $callee
+    (core module $libc
+      (memory (export "memory") 1)
+      (global $bump (mut i32) (i32.const 1024))
+
+      ;; The same wrapping bump allocator as in `shapes.wat`.
+      (func (export "realloc") (param i32 i32) (param $align i32) (param $size i32) (result i32)
+        (local $ret i32)
+        (local.set $ret
+          (i32.and
+            (i32.add (global.get $bump) (i32.sub (local.get $align) (i32.const 1)))
+            (i32.sub (i32.const 0) (local.get $align))))
+        (if (i32.gt_u (i32.add (local.get $ret) (local.get $size)) (i32.const 65536))
+          (then (local.set $ret (i32.const 1024))))
+        (global.set $bump (i32.add (local.get $ret) (local.get $size)))
+        (local.get $ret))
+    )
+    (core instance $libc (instantiate $libc))
+
+    (core module $m
+      (import "libc" "memory" (memory 1))
+      (func (export "echo-ptr-len") (param i32 i32) (result i32)
+        (i32.store (i32.const 0) (local.get 0))
+        (i32.store (i32.const 4) (local.get 1))
+        (i32.const 0))
+    )
+    (core instance $i (instantiate $m (with "libc" (instance $libc))))
+
+    (func (export "echo-string") (param "s" string) (result string)
+      (canon lift (core func $i "echo-ptr-len")
+        (memory $libc "memory") (realloc (func $libc "realloc"))))
+    (func (export "echo-list") (param "l" (list u32)) (result (list u32))
+      (canon lift (core func $i "echo-ptr-len")
+        (memory $libc "memory") (realloc (func $libc "realloc"))))
+  )
+  (instance $callee (instantiate $callee))
+
+  (component $caller
+    (import "echo-string" (func $echo_string (param "s" string) (result string)))
+    (import "echo-list" (func $echo_list (param "l" (list u32)) (result (list u32))))
+
+    (core module $libc
+      (memory (export "memory") 1)
+      (global $bump (mut i32) (i32.const 1024))
+
+      (func (export "realloc") (param i32 i32) (param $align i32) (param $size i32) (result i32)
+        (local $ret i32)
+        (local.set $ret
+          (i32.and
+            (i32.add (global.get $bump) (i32.sub (local.get $align) (i32.const 1)))
+            (i32.sub (i32.const 0) (local.get $align))))
+        (if (i32.gt_u (i32.add (local.get $ret) (local.get $size)) (i32.const 65536))
+          (then (local.set $ret (i32.const 1024))))
+        (global.set $bump (i32.add (local.get $ret) (local.get $size)))
+        (local.get $ret))
+    )
+    (core instance $libc (instantiate $libc))
+
+    (core func $echo_string (canon lower (func $echo_string)
+      (memory $libc "memory") (realloc (func $libc "realloc"))))
+    (core func $echo_list (canon lower (func $echo_list)
+      (memory $libc "memory") (realloc (func $libc "realloc"))))
+
+    (core module $m
+      (import "libc" "realloc" (func $realloc (param i32 i32 i32 i32) (result i32)))
+      (import "" "echo-string" (func $echo_string (param i32 i32 i32)))
+      (import "" "echo-list" (func $echo_list (param i32 i32 i32)))
+
+      ;; Passes a string of `len` bytes to the callee `n` times.
+      (func (export "run-string") (param $n i64) (param $len i32)
+        (local $ptr i32)
+        (local.set $ptr
+          (call $realloc (i32.const 0) (i32.const 0) (i32.const 1) (local.get $len)))
+        (block $done
+          (loop $loop
+            (br_if $done (i64.eqz (local.get $n)))
+            (call $echo_string (local.get $ptr) (local.get $len) (i32.const 0))
+            (local.set $n (i64.sub (local.get $n) (i64.const 1)))
+            (br $loop))))
+
+      ;; Passes a list of `len` elements to the callee `n` times.
+      (func (export "run-list") (param $n i64) (param $len i32)
+        (local $ptr i32)
+        (local.set $ptr
+          (call $realloc (i32.const 0) (i32.const 0) (i32.const 4)
+            (i32.mul (local.get $len) (i32.const 4))))
+        (block $done
+          (loop $loop
+            (br_if $done (i64.eqz (local.get $n)))
+            (call $echo_list (local.get $ptr) (local.get $len) (i32.const 0))
+            (local.set $n (i64.sub (local.get $n) (i64.const 1)))
+            (br $loop))))
+    )
+    (core instance $i (instantiate $m
+      (with "libc" (instance $libc))
+      (with "" (instance
+        (export "echo-string" (func $echo_string))
+        (export "echo-list" (func $echo_list))))))
+
+    (func (export "run-string") (param "n" u64) (param "len" u32)
+      (canon lift (core func $i "run-string")))
+    (func (export "run-list") (param "n" u64) (param "len" u32)
+      (canon lift (core func $i "run-list")))
+  )
+  (instance $caller (instantiate $caller
+    (with "echo-string" (func $callee "echo-string"))
+    (with "echo-list" (func $callee "echo-list"))))
+
+  (export "run-string" (func $caller "run-string"))
+  (export "run-list" (func $caller "run-list"))
+)
@@ -0,0 +1,126 @@
+;; A component used to benchmark the canonical ABI with a few realistic value
+;; shapes. Each shape is both exported, to measure host-to-wasm calls, and
+;; imported, to measure wasm-to-host calls.
+(component
+  (import "r" (type $r (sub resource)))
+  (type $point' (record
+    (field "x" u32)
+    (field "name" string)
+    (field "data" (list u32))))
+  (import "point" (type $point (eq $point')))
+
+  (import "host-string" (func $host_string (param "s" string) (result string)))
+  (import "host-list" (func $host_list (param "l" (list u32)) (result (list u32))))
+  (import "host-record" (func $host_record (param "p" $point) (result $point)))
+
+  (core module $libc
+    (memory (export "memory") 1)
+    (global $bump (mut i32) (i32.const 1024))
+
+    ;; A bump allocator which wraps back around to the start of the heap when
+    ;; it runs out of space, so an arbitrary number of calls can be made with
+    ;; small values. The first 1024 bytes are used for return areas.
+    (func (export "realloc") (param i32 i32) (param $align i32) (param $size i32) (result i32)
+      (local $ret i32)
+      (local.set $ret
+        (i32.and
+          (i32.add (global.get $bump) (i32.sub (local.get $align) (i32.const 1)))
+          (i32.sub (i32.const 0) (local.get $align))))
+      (if (i32.gt_u (i32.add (local.get $ret) (local.get $size)) (i32.const 65536))
+        (then (local.set $ret (i32.const 1024))))
+      (global.set $bump (i32.add (local.get $ret) (local.get $size)))
+      (local.get $ret))
+  )
+  (core instance $libc (instantiate $libc))
+
+  (core func $host_string (canon lower (func $host_string)
+    (memory $libc "memory") (realloc (func $libc "realloc"))))
+  (core func $host_list (canon lower (func $host_list)
+    (memory $libc "memory") (realloc (func $libc "realloc"))))
+  (core func $host_record (canon lower (func $host_record)
+    (memory $libc "memory") (realloc (func $libc "realloc"))))
+  (core func $drop_r (canon resource.drop $r))
+
+  (core module $m
+    (import "libc" "memory" (memory 1))
+    (import "" "host-string" (func $host_string (param i32 i32 i32)))
+    (import "" "host-list" (func $host_list (param i32 i32 i32)))
+    (import "" "host-record" (func $host_record (param i32 i32 i32 i32 i32 i32)))
+    (import "" "drop-r" (func $drop_r (param i32)))
+
+    ;; Returns a string or list by writing its pointer and length to the
+    ;; return area at address 0.
+    (func (export "echo-ptr-len") (param i32 i32) (result i32)
+      (i32.store (i32.const 0) (local.get 0))
+      (i32.store (i32.const 4) (local.get 1))
+      (i32.const 0))
+
+    (func (export "echo-record") (param i32 i32 i32 i32 i32) (result i32)
+      (i32.store (i32.const 0) (local.get 0))
+      (i32.store (i32.const 4) (local.get 1))
+      (i32.store (i32.const 8) (local.get 2))
+      (i32.store (i32.const 12) (local.get 3))
+      (i32.store (i32.const 16) (local.get 4))
+      (i32.const 0))
+
+    (func (export "borrow") (param i32))
+    (func (export "own") (param i32)
+      (call $drop_r (local.get 0)))
+
+    ;; "Runner functions" which call an import the given number of times with
+    ;; their other arguments, using address 32 as the import's return area.
+    (func (export "run-host-string") (param $n i64) (param i32 i32)
+      (loop $l
+        (call $host_string (local.get 1) (local.get 2) (i32.const 32))
+        (br_if $l (i64.ne
+          (local.tee $n (i64.sub (local.get $n) (i64.const 1)))
+          (i64.const 0)))))
+
+    (func (export "run-host-list") (param $n i64) (param i32 i32)
+      (loop $l
+        (call $host_list (local.get 1) (local.get 2) (i32.const 32))
+        (br_if $l (i64.ne
+          (local.tee $n (i64.sub (local.get $n) (i64.const 1)))
+          (i64.const 0)))))
+
+    (func (export "run-host-record") (param $n i64) (param i32 i32 i32 i32 i32)
+      (loop $l
+        (call $host_record
+          (local.get 1) (local.get 2) (local.get 3) (local.get 4) (local.get 5)
+          (i32.const 32))
+        (br_if $l (i64.ne
+          (local.tee $n (i64.sub (local.get $n) (i64.const 1)))
+          (i64.const 0)))))
+  )
+  (core instance $i (instantiate $m
+    (with "libc" (instance $libc))
+    (with "" (instance
+      (export "host-string" (func $host_string))
+      (export "host-list" (func $host_list))
+      (export "host-record" (func $host_record))
+      (export "drop-r" (func $drop_r))))))
+
+  (func (export "echo-string") (param "s" string) (result string)
+    (canon lift (core func $i "echo-ptr-len")
+      (memory $libc "memory") (realloc (func $libc "realloc"))))
+  (func (export "echo-list") (param "l" (list u32)) (result (list u32))
+    (canon lift (core func $i "echo-ptr-len")
+      (memory $libc "memory") (realloc (func $libc "realloc"))))
+  (func (export "echo-record") (param "p" $point) (result $point)
+    (canon lift (core func $i "echo-record")
+      (memory $libc "memory") (realloc (func $libc "realloc"))))
+  (func (export "borrow") (param "r" (borrow $r))
+    (canon lift (core func $i "borrow")))
+  (func (export "own") (param "r" (own $r))
+    (canon lift (core func $i "own")))
+
+  (func (export "run-host-string") (param "n" u64) (param "s" string)
+    (canon lift (core func $i "run-host-string")
+      (memory $libc "memory") (realloc (func $libc "realloc"))))
+  (func (export "run-host-list") (param "n" u64) (param "l" (list u32))
+    (canon lift (core func $i "run-host-list")
+      (memory $libc "memory") (realloc (func $libc "realloc"))))
+  (func (export "run-host-record") (param "n" u64) (param "p" $point)
+    (canon lift (core func $i "run-host-record")
+      (memory $libc "memory") (realloc (func $libc "realloc"))))
+)
@@ -0,0 +1,48 @@
+#!/usr/bin/env bash
+
+# Usage:
+#
+#     cpp-embedding-rps.sh
+#
+# Measures the requests per second of the HTTP server in
+# `examples/http-rps/main.cc`, which embeds Wasmtime through its C++ API and
+# handles each request in a new `Store`. Compare with `wasmtime-serve-rps.sh`
+# to measure the overhead of the C and C++ APIs relative to the Rust embedding
+# of `wasmtime serve`.
+#
+# You must have the `hey` tool installed on your `$PATH`. It is available in at
+# least the `apt` and `brew` package managers, as well as a binary download via
+# its github page: https://github.com/rakyll/hey
+
+set -e
+
+repo_dir="$(dirname $0)/.."
+cargo_toml="$repo_dir/Cargo.toml"
+target_dir="$CARGO_TARGET_DIR"
+if [[ "$target_dir" == "" ]]; then
+    target_dir="$repo_dir/target"
+fi
+build_dir="$target_dir/cpp-embedding-rps"
+
+# Build the component handling requests, and the server.
+cargo build --manifest-path "$cargo_toml" --release -p example-http-rps-wasm \
+    --target wasm32-wasip2
+cmake -S "$repo_dir/examples" -B "$build_dir" -DCMAKE_BUILD_TYPE=Release \
+    -DWASMTIME_FASTEST_RUNTIME=ON
+cmake --build "$build_dir" --config Release --target wasmtime-http-rps-cpp
+
+# Spawn the server in the background.
+"$build_dir/wasmtime-http-rps-cpp" 8080 \
+    "$target_dir/wasm32-wasip2/release/http_rps.wasm" &
+pid=$!
+
+# Give it a second to compile the component and get the server up and running.
+sleep 1
+
+echo 'Running the C++ embedding in background as pid '"$pid"
+
+# Benchmark the server!
+echo "Benchmarking for 10 seconds..."
+hey -z 10s http://127.0.0.1:8080/
+
+kill "$pid"
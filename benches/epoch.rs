@@ -0,0 +1,93 @@
+//! Benchmarks of epoch-based interruption: the overhead of the epoch checks
+//! in generated code, and the cost of `Engine::increment_epoch` while other
+//! threads are running wasm which reads the epoch.
+
+use criterion::*;
+use std::sync::Arc;
+use std::sync::atomic::{AtomicBool, Ordering};
+use wasmtime::*;
+
+criterion_main!(benches);
+criterion_group!(benches, bench_epochs);
+
+const LOOP: &str = r#"
+    (module
+        (func (export "loop") (param i64)
+            (loop $l
+                (br_if $l
+                    (i64.ne
+                        (local.tee 0 (i64.sub (local.get 0) (i64.const 1)))
+                        (i64.const 0))))))
+"#;
+
+fn bench_epochs(c: &mut Criterion) {
+    bench_epoch_checks(c);
+    bench_increment_epoch(c);
+}
+
+fn engine(epochs: bool) -> Engine {
+    let mut config = Config::new();
+    config.epoch_interruption(epochs);
+    Engine::new(&config).unwrap()
+}
+
+/// Returns a store with a deadline which won't be reached, along with the
+/// `loop` export of `LOOP` instantiated in it.
+fn loop_func(engine: &Engine) -> (Store<()>, TypedFunc<u64, ()>) {
+    let module = Module::new(engine, LOOP).unwrap();
+    let mut store = Store::new(engine, ());
+    store.set_epoch_deadline(1 << 62);
+    let instance = Instance::new(&mut store, &module, &[]).unwrap();
+    let f = instance.get_typed_func(&mut store, "loop").unwrap();
+    (store, f)
+}
+
+/// Measures the time per iteration of a tight loop with and without the
+/// epoch check on its back-edge.
+fn bench_epoch_checks(c: &mut Criterion) {
+    let mut group = c.benchmark_group("epoch-checks");
+    for epochs in [false, true] {
+        let name = if epochs { "epochs" } else { "no-epochs" };
+        group.bench_function(name, |b| {
+            let (mut store, f) = loop_func(&engine(epochs));
+            b.iter_custom(|iters| {
+                let start = std::time::Instant::now();
+                f.call(&mut store, iters.max(1)).unwrap();
+                start.elapsed()
+            })
+        });
+    }
+}
+
+/// Measures `increment_epoch` while a number of threads run wasm which
+/// continuously reads the epoch.
+fn bench_increment_epoch(c: &mut Criterion) {
+    let mut group = c.benchmark_group("increment-epoch");
+    for num_bg_threads in [0, 1, 2, 4, 8, 16] {
+        group.bench_with_input(
+            BenchmarkId::from_parameter(num_bg_threads),
+            &num_bg_threads,
+            |b, &num_bg_threads| {
+                let engine = engine(true);
+                let done = Arc::new(AtomicBool::new(false));
+                let threads = (0..num_bg_threads)
+                    .map(|_| {
+                        let engine = engine.clone();
+                        let done = done.clone();
+                        std::thread::spawn(move || {
+                            let (mut store, f) = loop_func(&engine);
+                            while !done.load(Ordering::Relaxed) {
+                                f.call(&mut store, 100_000).unwrap();
+                            }
+                        })
+                    })
+                    .collect::<Vec<_>>();
+
+                b.iter(|| engine.increment_epoch());
+
+                done.store(true, Ordering::Relaxed);
+                threads.into_iter().for_each(|t| t.join().unwrap());
+            },
+        );
+    }
+}
@@ -0,0 +1,61 @@
+//! Benchmarks of the overhead of fuel metering in generated code, comparing
+//! per-block and per-loop metering with no metering at all.
+
+use criterion::*;
+use wasmtime::*;
+
+criterion_main!(benches);
+criterion_group!(benches, bench_fuel);
+
+/// Runs Collatz sequences for `n` starting values, which is a loop with
+/// branches in its body, and calls a small function on each step.
+const COLLATZ: &str = r#"
+    (module
+        (func $step (param $x i64) (result i64)
+            (if (result i64) (i64.eqz (i64.and (local.get $x) (i64.const 1)))
+                (then (i64.shr_u (local.get $x) (i64.const 1)))
+                (else (i64.add (i64.mul (local.get $x) (i64.const 3)) (i64.const 1)))))
+        (func (export "run") (param $n i64)
+            (local $x i64)
+            (loop $outer
+                (local.set $x (local.get $n))
+                (loop $inner
+                    (local.set $x (call $step (local.get $x)))
+                    (br_if $inner (i64.ne (local.get $x) (i64.const 1))))
+                (br_if $outer
+                    (i64.ne
+                        (local.tee $n (i64.sub (local.get $n) (i64.const 1)))
+                        (i64.const 0))))))
+"#;
+
+fn bench_fuel(c: &mut Criterion) {
+    let mut group = c.benchmark_group("fuel");
+    let modes = [
+        ("no-fuel", None),
+        ("per-block", Some(FuelMetering::PerBlock)),
+        ("per-loop", Some(FuelMetering::PerLoop)),
+    ];
+    for (name, metering) in modes {
+        group.bench_function(name, |b| {
+            let mut config = Config::new();
+            if let Some(metering) = metering {
+                config.consume_fuel(true).fuel_metering(metering);
+            }
+            let engine = Engine::new(&config).unwrap();
+            let module = Module::new(&engine, COLLATZ).unwrap();
+            let mut store = Store::new(&engine, ());
+            if metering.is_some() {
+                store.set_fuel(u64::MAX).unwrap();
+            }
+            let instance = Instance::new(&mut store, &module, &[]).unwrap();
+            let run = instance
+                .get_typed_func::<u64, ()>(&mut store, "run")
+                .unwrap();
+            b.iter_custom(|iters| {
+                let start = std::time::Instant::now();
+                run.call(&mut store, iters.max(1)).unwrap();
+                start.elapsed()
+            })
+        });
+    }
+}
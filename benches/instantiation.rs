@@ -1,10 +1,11 @@
-use criterion::{BenchmarkId, Criterion, criterion_group, criterion_main};
+use criterion::{BenchmarkId, Criterion, Throughput, criterion_group, criterion_main};
 use std::cell::LazyCell;
 use std::path::Path;
 use std::process::Command;
-use std::sync::Arc;
 use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering::SeqCst};
+use std::sync::{Arc, Barrier};
 use std::thread;
+use std::time::Instant;
 use wasmtime::*;
 use wasmtime_wasi::{WasiCtx, p1::WasiP1Ctx};
 
@@ -148,6 +149,79 @@ fn bench_parallel(c: &mut Criterion, path: &Path) {
     group.finish();
 }
 
+fn bench_scaling(c: &mut Criterion, path: &Path) {
+    let mut group = c.benchmark_group("scaling");
+
+    for strategy in strategies() {
+        let state = LazyCell::new(|| {
+            let mut config = Config::default();
+            config.allocation_strategy(strategy.clone());
+
+            let engine = Engine::new(&config).expect("failed to create engine");
+            let module =
+                Module::from_file(&engine, path).expect("failed to load WASI example module");
+            let mut linker = Linker::new(&engine);
+            linker.func_wrap("bench", "start", || {}).unwrap();
+            linker.func_wrap("bench", "end", || {}).unwrap();
+            wasmtime_wasi::p1::add_to_linker_sync(&mut linker, |cx| cx).unwrap();
+            let pre = Arc::new(
+                linker
+                    .instantiate_pre(&module)
+                    .expect("failed to pre-instantiate"),
+            );
+            (engine, pre)
+        });
+
+        // Unlike `bench_parallel`, which measures the latency of one
+        // instantiation with others in the background, this measures the
+        // total throughput of all threads instantiating at once, which should
+        // scale linearly with the number of threads.
+        let max_threads = thread::available_parallelism().map_or(1, |n| n.get().min(64));
+        let thread_counts = std::iter::successors(Some(1), |n| Some(n * 2))
+            .take_while(|n| *n < max_threads)
+            .chain([max_threads]);
+        for threads in thread_counts {
+            let name = format!(
+                "{}: with {} thread{}",
+                path.file_name().unwrap().to_str().unwrap(),
+                threads,
+                if threads == 1 { "" } else { "s" }
+            );
+            let id = BenchmarkId::new(benchmark_name(&strategy), name);
+            group.throughput(Throughput::Elements(threads as u64));
+            group.bench_function(id, |b| {
+                let (engine, pre) = &*state;
+                b.iter_custom(|iters| {
+                    // Each iteration is one instantiation on every thread,
+                    // all of which start together once they're spawned.
+                    let barrier = Arc::new(Barrier::new(threads + 1));
+                    let workers = (0..threads)
+                        .map(|_| {
+                            let pre = pre.clone();
+                            let engine = engine.clone();
+                            let barrier = barrier.clone();
+                            thread::spawn(move || {
+                                barrier.wait();
+                                for _ in 0..iters {
+                                    instantiate(&pre, &engine).unwrap();
+                                }
+                            })
+                        })
+                        .collect::<Vec<_>>();
+                    barrier.wait();
+                    let start = Instant::now();
+                    for t in workers {
+                        t.join().unwrap();
+                    }
+                    start.elapsed()
+                });
+            });
+        }
+    }
+
+    group.finish();
+}
+
 fn bench_deserialize_module(c: &mut Criterion, path: &Path) {
     let mut group = c.benchmark_group("deserialize");
 
@@ -210,6 +284,7 @@ fn bench_instantiation(c: &mut Criterion) {
         let path = file.unwrap().path();
         bench_sequential(c, &path);
         bench_parallel(c, &path);
+        bench_scaling(c, &path);
         bench_deserialize_module(c, &path);
     }
 }
@@ -0,0 +1,68 @@
+//! Measure SIMD kernels compiled for the host, with and without the AVX-512
+//! lowerings on x64.
+
+use criterion::{Criterion, criterion_group, criterion_main};
+use std::time::Instant;
+use wasmtime::{Config, Engine, Instance, Module, Store, TypedFunc};
+
+criterion_group!(benches, bench_simd);
+criterion_main!(benches);
+
+fn bench_simd(c: &mut Criterion) {
+    let _ = env_logger::try_init();
+
+    let mut configs = vec![("host", Config::new())];
+    if cfg!(target_arch = "x86_64") {
+        let mut config = Config::new();
+        for flag in [
+            "has_avx512f",
+            "has_avx512vl",
+            "has_avx512dq",
+            "has_avx512vnni",
+        ] {
+            // SAFETY: disabling CPU features only limits the instructions
+            // Cranelift uses.
+            unsafe {
+                config.cranelift_flag_set(flag, "false");
+            }
+        }
+        configs.push(("host-without-avx512", config));
+    }
+
+    // Benchmark each `*.wat` file in the `simd` directory.
+    for file in std::fs::read_dir("benches/simd").unwrap() {
+        let path = file.unwrap().path();
+        if path.extension().map(|e| e == "wat").unwrap_or(false) {
+            let wat = std::fs::read(&path).unwrap();
+            for (name, config) in &configs {
+                let (mut store, run_fn) = instantiate(config, &wat);
+                let bench_name = format!(
+                    "simd/{name}/{}",
+                    path.file_name().unwrap().to_string_lossy()
+                );
+                // To avoid overhead, the module itself must iterate the
+                // expected number of times in its `run` function, like the
+                // WASI benchmarks.
+                c.bench_function(&bench_name, move |b| {
+                    b.iter_custom(|iters| {
+                        let start = Instant::now();
+                        let result = run_fn.call(&mut store, iters).unwrap();
+                        assert_eq!(iters, result);
+                        start.elapsed()
+                    })
+                });
+            }
+        }
+    }
+}
+
+/// Compile and instantiate the Wasm module, returning the exported `run`
+/// function.
+fn instantiate(config: &Config, wat: &[u8]) -> (Store<()>, TypedFunc<u64, u64>) {
+    let engine = Engine::new(config).unwrap();
+    let mut store = Store::new(&engine, ());
+    let module = Module::new(&engine, wat).unwrap();
+    let instance = Instance::new(&mut store, &module, &[]).unwrap();
+    let run = instance.get_typed_func(&mut store, "run").unwrap();
+    (store, run)
+}
@@ -0,0 +1,25 @@
+(module
+    (func (export "run") (param $iters i64) (result i64)
+        (local $i i64)
+        (local $p i32)
+        (local $min v128)
+        (local.set $i (i64.const 0))
+        (loop $cont
+            ;; Take the minimum of each 16 bytes of the first 4 KiB of memory
+            ;; as `f32x4`s.
+            (local.set $p (i32.const 0))
+            (loop $kernel
+                (local.set $min
+                    (f32x4.min (v128.load (local.get $p)) (local.get $min)))
+                (local.set $p (i32.add (local.get $p) (i32.const 16)))
+                (br_if $kernel (i32.lt_u (local.get $p) (i32.const 4096)))
+            )
+            ;; Continue looping until $i reaches $iters.
+            (local.set $i (i64.add (local.get $i) (i64.const 1)))
+            (br_if $cont (i64.lt_u (local.get $i) (local.get $iters)))
+        )
+        (v128.store (i32.const 8192) (local.get $min))
+        (local.get $i)
+    )
+    (memory (export "memory") 1)
+)
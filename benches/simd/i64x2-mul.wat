@@ -0,0 +1,26 @@
+(module
+    (func (export "run") (param $iters i64) (result i64)
+        (local $i i64)
+        (local $p i32)
+        (local $product v128)
+        (local.set $i (i64.const 0))
+        (local.set $product (v128.const i64x2 1 1))
+        (loop $cont
+            ;; Multiply together each 16 bytes of the first 4 KiB of memory as
+            ;; `i64x2`s.
+            (local.set $p (i32.const 0))
+            (loop $kernel
+                (local.set $product
+                    (i64x2.mul (v128.load (local.get $p)) (local.get $product)))
+                (local.set $p (i32.add (local.get $p) (i32.const 16)))
+                (br_if $kernel (i32.lt_u (local.get $p) (i32.const 4096)))
+            )
+            ;; Continue looping until $i reaches $iters.
+            (local.set $i (i64.add (local.get $i) (i64.const 1)))
+            (br_if $cont (i64.lt_u (local.get $i) (local.get $iters)))
+        )
+        (v128.store (i32.const 8192) (local.get $product))
+        (local.get $i)
+    )
+    (memory (export "memory") 1)
+)
@@ -0,0 +1,28 @@
+(module
+    (func (export "run") (param $iters i64) (result i64)
+        (local $i i64)
+        (local $p i32)
+        (local $acc v128)
+        (local.set $i (i64.const 0))
+        (loop $cont
+            ;; Accumulate the dot product of each 16 bytes of the first 4 KiB
+            ;; of memory with the next 16 bytes.
+            (local.set $p (i32.const 0))
+            (loop $kernel
+                (local.set $acc
+                    (i32x4.relaxed_dot_i8x16_i7x16_add_s
+                        (v128.load (local.get $p))
+                        (v128.load offset=16 (local.get $p))
+                        (local.get $acc)))
+                (local.set $p (i32.add (local.get $p) (i32.const 16)))
+                (br_if $kernel (i32.lt_u (local.get $p) (i32.const 4096)))
+            )
+            ;; Continue looping until $i reaches $iters.
+            (local.set $i (i64.add (local.get $i) (i64.const 1)))
+            (br_if $cont (i64.lt_u (local.get $i) (local.get $iters)))
+        )
+        (v128.store (i32.const 8192) (local.get $acc))
+        (local.get $i)
+    )
+    (memory (export "memory") 1)
+)
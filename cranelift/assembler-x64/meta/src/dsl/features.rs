@@ -94,6 +94,7 @@ pub enum Feature {
     avx512dq,
     avx512bitalg,
     avx512vbmi,
+    avx512vnni,
     cmpxchg16b,
     fma,
 }
@@ -125,6 +126,7 @@ pub const ALL_FEATURES: &[Feature] = &[
     Feature::avx512dq,
     Feature::avx512bitalg,
     Feature::avx512vbmi,
+    Feature::avx512vnni,
     Feature::cmpxchg16b,
     Feature::fma,
 ];
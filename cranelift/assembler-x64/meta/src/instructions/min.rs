@@ -1,5 +1,5 @@
-use crate::dsl::{Feature::*, Inst, Length::*, Location::*};
-use crate::dsl::{align, fmt, inst, r, rex, rw, vex, w};
+use crate::dsl::{Feature::*, Inst, Length::*, Location::*, TupleType::*};
+use crate::dsl::{align, evex, fmt, inst, r, rex, rw, vex, w};
 
 #[rustfmt::skip] // Keeps instructions on a single line.
 pub fn list() -> Vec<Inst> {
@@ -14,6 +14,12 @@ pub fn list() -> Vec<Inst> {
         inst("vminsd", fmt("B", [w(xmm1), r(xmm2), r(xmm_m64)]), vex(LIG)._f2()._0f().op(0x5D).r(), (_64b | compat) & avx),
         inst("vminps", fmt("B", [w(xmm1), r(xmm2), r(xmm_m128)]), vex(L128)._0f().op(0x5D).r(), (_64b | compat) & avx),
         inst("vminpd", fmt("B", [w(xmm1), r(xmm2), r(xmm_m128)]), vex(L128)._66()._0f().op(0x5D).r(), (_64b | compat) & avx),
+        // Fix up special floating-point values: each lane of the second
+        // operand is classified (QNaN, SNaN, zero, one, infinity, ...) and the
+        // matching 4-bit field of the third operand's lane selects what to
+        // replace it with. Used to canonicalize the NaNs from `minps`/`minpd`.
+        inst("vfixupimmps", fmt("A", [rw(xmm1), r(xmm2), r(xmm_m128), r(imm8)]), evex(L128, Full)._66()._0f3a().w0().op(0x54).r().ib(), (_64b | compat) & avx512vl & avx512f),
+        inst("vfixupimmpd", fmt("A", [rw(xmm1), r(xmm2), r(xmm_m128), r(imm8)]), evex(L128, Full)._66()._0f3a().w1().op(0x54).r().ib(), (_64b | compat) & avx512vl & avx512f),
         // Packed integer minimum.
         inst("pminsb", fmt("A", [rw(xmm1), r(align(xmm_m128))]), rex([0x66, 0x0F, 0x38, 0x38]).r(), (_64b | compat) & sse41).alt(avx, "vpminsb_b"),
         inst("pminsw", fmt("A", [rw(xmm1), r(align(xmm_m128))]), rex([0x66, 0x0F, 0xEA]).r(), (_64b | compat) & sse2).alt(avx, "vpminsw_b"),
@@ -1,5 +1,5 @@
-use crate::dsl::{Feature::*, Inst, Length::*, Location::*};
-use crate::dsl::{align, fmt, inst, r, rex, rw, vex, w};
+use crate::dsl::{Feature::*, Inst, Length::*, Location::*, TupleType::*};
+use crate::dsl::{align, evex, fmt, inst, r, rex, rw, vex, w};
 
 #[rustfmt::skip] // Keeps instructions on a single line.
 pub fn list() -> Vec<Inst> {
@@ -24,5 +24,12 @@ pub fn list() -> Vec<Inst> {
         // and the saturated result is packed to the destination operand."
         inst("pmaddubsw", fmt("A", [rw(xmm1), r(align(xmm_m128))]), rex([0x66, 0x0F, 0x38, 0x04]), (_64b | compat) & ssse3).alt(avx, "vpmaddubsw_b"),
         inst("vpmaddubsw", fmt("B", [w(xmm1), r(xmm2), r(xmm_m128)]), vex(L128)._66()._0f38().op(0x04), (_64b | compat) & avx),
+        // Like `pmaddubsw` followed by `pmaddwd` with ones, without the
+        // saturation: "multiplies the individual unsigned bytes of the first
+        // source operand by the corresponding signed bytes of the second
+        // source operand, producing intermediate signed word results. The word
+        // results are then summed and accumulated in the destination dword
+        // element size operand."
+        inst("vpdpbusd", fmt("A", [rw(xmm1), r(xmm2), r(xmm_m128)]), evex(L128, Full)._66()._0f38().w0().op(0x50).r(), (_64b | compat) & avx512vl & avx512vnni),
      ]
 }
@@ -77,6 +77,12 @@ pub(crate) fn define() -> TargetIsa {
         "AVX512VBMI: CPUID.07H:ECX.AVX512VBMI[bit 1]",
         false,
     );
+    let has_avx512vnni = settings.add_bool(
+        "has_avx512vnni",
+        "Has support for AVX512VNNI.",
+        "AVX512VNNI: CPUID.07H:ECX.AVX512_VNNI[bit 11]",
+        false,
+    );
     let has_avx512f = settings.add_bool(
         "has_avx512f",
         "Has support for AVX512F.",
@@ -261,7 +267,7 @@ pub(crate) fn define() -> TargetIsa {
     let cascadelake = settings.add_preset(
         "cascadelake",
         "Cascade Lake microarchitecture.",
-        preset!(skylake_avx512),
+        preset!(skylake_avx512 && has_avx512vnni),
     );
     settings.add_preset(
         "cooperlake",
@@ -276,7 +282,7 @@ pub(crate) fn define() -> TargetIsa {
     let icelake_client = settings.add_preset(
         "icelake-client",
         "Ice Lake microarchitecture.",
-        preset!(cannonlake && has_avx512bitalg),
+        preset!(cannonlake && has_avx512bitalg && has_avx512vnni),
     );
     // LLVM doesn't use the name "icelake" but Cranelift did in the past; alias it
     settings.add_preset(
@@ -402,6 +408,7 @@ pub(crate) fn define() -> TargetIsa {
                 && has_avx512f
                 && has_avx512vbmi
                 && has_avx512vl
+                && has_avx512vnni
         ),
     );
 
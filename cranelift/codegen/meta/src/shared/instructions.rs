@@ -3401,6 +3401,27 @@ pub(crate) fn define(
         .operands_out(vec![Operand::new("a", I16x8)]),
     );
 
+    ig.push(
+        Inst::new(
+            "x86_vpdpbusd",
+            r#"
+        An instruction with equivalent semantics to `vpdpbusd` on x86.
+
+        This instruction will take signed bytes from the first argument and
+        multiply them against unsigned bytes in the second argument. Groups of
+        four adjacent products are then added, without saturating, to the
+        corresponding 32-bit lane of the third argument.
+            "#,
+            &formats.ternary,
+        )
+        .operands_in(vec![
+            Operand::new("x", I8x16),
+            Operand::new("y", I8x16),
+            Operand::new("z", I32x4),
+        ])
+        .operands_out(vec![Operand::new("a", I32x4)]),
+    );
+
     ig.push(
         Inst::new(
             "uextend",
@@ -407,6 +407,10 @@ pub trait TargetIsa: fmt::Display + Send + Sync {
     /// this ISA.
     fn has_x86_pmaddubsw_lowering(&self) -> bool;
 
+    /// Returns whether the CLIF `x86_vpdpbusd` instruction is implemented for
+    /// this ISA.
+    fn has_x86_vpdpbusd_lowering(&self) -> bool;
+
     /// Returns the mode of extension used for integer arguments smaller than
     /// the pointer width in function signatures.
     ///
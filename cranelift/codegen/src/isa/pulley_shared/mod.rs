@@ -248,6 +248,10 @@ where
         false
     }
 
+    fn has_x86_vpdpbusd_lowering(&self) -> bool {
+        false
+    }
+
     fn default_argument_extension(&self) -> ir::ArgumentExtension {
         ir::ArgumentExtension::None
     }
@@ -221,6 +221,10 @@ impl TargetIsa for Riscv64Backend {
         false
     }
 
+    fn has_x86_vpdpbusd_lowering(&self) -> bool {
+        false
+    }
+
     fn default_argument_extension(&self) -> ir::ArgumentExtension {
         // According to https://riscv.org/wp-content/uploads/2024/12/riscv-calling.pdf
         // it says:
@@ -201,6 +201,10 @@ impl TargetIsa for S390xBackend {
         false
     }
 
+    fn has_x86_vpdpbusd_lowering(&self) -> bool {
+        false
+    }
+
     fn default_argument_extension(&self) -> ir::ArgumentExtension {
         // This is copied/carried over from a historical piece of code in
         // Wasmtime:
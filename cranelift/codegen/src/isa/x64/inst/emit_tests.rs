@@ -362,6 +362,7 @@ fn test_x64_emit() {
     isa_flag_builder.enable("has_avx512dq").unwrap();
     isa_flag_builder.enable("has_avx512f").unwrap();
     isa_flag_builder.enable("has_avx512vbmi").unwrap();
+    isa_flag_builder.enable("has_avx512vnni").unwrap();
     isa_flag_builder.enable("has_avx512vl").unwrap();
     let isa_flags = x64::settings::Flags::new(&flags, &isa_flag_builder);
 
@@ -279,6 +279,11 @@ impl Context for IsleContext<'_, '_, MInst, X64Backend> {
         self.backend.x64_flags.has_avx512vbmi()
     }
 
+    #[inline]
+    fn has_avx512vnni(&mut self) -> bool {
+        self.backend.x64_flags.has_avx512vnni()
+    }
+
     #[inline]
     fn has_lzcnt(&mut self) -> bool {
         self.backend.x64_flags.has_lzcnt()
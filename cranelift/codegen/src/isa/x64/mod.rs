@@ -199,6 +199,10 @@ impl TargetIsa for X64Backend {
         self.x64_flags.has_ssse3()
     }
 
+    fn has_x86_vpdpbusd_lowering(&self) -> bool {
+        self.x64_flags.has_avx512vl() && self.x64_flags.has_avx512vnni()
+    }
+
     fn default_argument_extension(&self) -> ir::ArgumentExtension {
         // This is copied/carried over from a historical piece of code in
         // Wasmtime:
@@ -173,6 +173,14 @@ mod enabled {
         pub fn total(&self) -> Duration {
             self.pass.iter().map(|p| p.total - p.child).sum()
         }
+
+        /// Returns the amount of time taken by `pass`, excluding any passes
+        /// nested within it.
+        pub fn self_time(&self, pass: Pass) -> Duration {
+            self.pass
+                .get(pass.idx())
+                .map_or(Duration::ZERO, |p| p.total.saturating_sub(p.child))
+        }
     }
 
     impl Default for PassTimes {
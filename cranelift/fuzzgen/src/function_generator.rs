@@ -945,6 +945,7 @@ static OPCODE_SIGNATURES: LazyLock<Vec<OpcodeSignature>> = LazyLock::new(|| {
                 (Opcode::SshrImm),
                 (Opcode::ScalarToVector),
                 (Opcode::X86Pmaddubsw),
+                (Opcode::X86Vpdpbusd),
                 (Opcode::X86Cvtt2dq),
                 (Opcode::Umulhi, &[I128, I128], &[I128]),
                 (Opcode::Smulhi, &[I128, I128], &[I128]),
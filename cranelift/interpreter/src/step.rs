@@ -1354,6 +1354,7 @@ where
         Opcode::Blendv => unimplemented!("Blendv"),
         Opcode::X86Pmulhrsw => unimplemented!("X86Pmulhrsw"),
         Opcode::X86Pmaddubsw => unimplemented!("X86Pmaddubsw"),
+        Opcode::X86Vpdpbusd => unimplemented!("X86Vpdpbusd"),
         Opcode::X86Cvtt2dq => unimplemented!("X86Cvtt2dq"),
         Opcode::StackSwitch => unimplemented!("StackSwitch"),
 
@@ -6,6 +6,7 @@ const FEATURES: &[&str] = &[
     "ASYNC",
     "PROFILING",
     "CACHE",
+    "INCREMENTAL_CACHE",
     "PARALLEL_COMPILATION",
     "WASI",
     "LOGGING",
@@ -25,6 +26,7 @@ const FEATURES: &[&str] = &[
     "COMPONENT_MODEL",
     "PULLEY",
     "ALL_ARCH",
+    "STACK_SWITCHING",
 ];
 // ... if you add a line above this be sure to change the other locations
 // marked WASMTIME_FEATURE_LIST
@@ -29,6 +29,7 @@ endmacro()
 feature(profiling ON)
 feature(wat ON)
 feature(cache ON)
+feature(incremental-cache ON)
 feature(parallel-compilation ON)
 feature(wasi ON)
 feature(logging ON)
@@ -48,5 +49,6 @@ feature(pooling-allocator ON)
 feature(component-model ON)
 feature(pulley ON)
 feature(all-arch OFF)
+feature(stack-switching ON)
 # ... if you add a line above this be sure to change the other locations
 # marked WASMTIME_FEATURE_LIST
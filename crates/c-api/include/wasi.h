@@ -193,6 +193,63 @@ WASI_API_EXTERN void wasi_config_set_stderr_custom(
     ptrdiff_t (*callback)(void *, const unsigned char *, size_t), void *data,
     void (*finalizer)(void *));
 
+/**
+ * \typedef wasi_output_buffer_t
+ * \brief Convenience alias for #wasi_output_buffer_t
+ *
+ * \struct wasi_output_buffer_t
+ * \brief A bounded in-memory buffer capturing stdout or stderr.
+ *
+ * Output written by the guest is appended to the buffer, and once it holds
+ * its capacity in bytes the oldest bytes are dropped to make room. This is
+ * cheaper than redirecting output to a file and reading it back.
+ *
+ * \fn void wasi_output_buffer_delete(wasi_output_buffer_t *);
+ * \brief Deletes a buffer.
+ *
+ * Configs the buffer has been passed to keep their own reference to it.
+ */
+WASI_DECLARE_OWN(output_buffer)
+
+/**
+ * \brief Creates a new buffer which holds up to \p capacity bytes.
+ */
+WASI_API_EXTERN own wasi_output_buffer_t *
+wasi_output_buffer_new(size_t capacity);
+
+/**
+ * \brief Takes the output captured by \p buffer.
+ *
+ * The bytes currently held by the buffer, oldest first, are moved into
+ * \p out, which must later be deallocated with #wasm_byte_vec_delete. The
+ * buffer is left empty.
+ *
+ * \return The number of bytes dropped since the last call to this function
+ * because the buffer was full.
+ */
+WASI_API_EXTERN uint64_t wasi_output_buffer_take(
+    const wasi_output_buffer_t *buffer, own wasm_byte_vec_t *out);
+
+/**
+ * \brief Configures standard output to be captured in \p buffer.
+ *
+ * The \p buffer is not consumed and can be read with
+ * #wasi_output_buffer_take while the guest runs or after it has finished.
+ */
+WASI_API_EXTERN void
+wasi_config_set_stdout_buffer(wasi_config_t *config,
+                              const wasi_output_buffer_t *buffer);
+
+/**
+ * \brief Configures standard error to be captured in \p buffer.
+ *
+ * The \p buffer is not consumed and can be read with
+ * #wasi_output_buffer_take while the guest runs or after it has finished.
+ */
+WASI_API_EXTERN void
+wasi_config_set_stderr_buffer(wasi_config_t *config,
+                              const wasi_output_buffer_t *buffer);
+
 /**
  * \brief The permissions granted for a directory when preopening it.
  */
@@ -265,6 +322,134 @@ WASI_API_EXTERN bool wasi_config_preopen_dir(wasi_config_t *config,
                                              wasi_dir_perms dir_perms,
                                              wasi_file_perms file_perms);
 
+/**
+ * \typedef wasi_shared_dir_t
+ * \brief Convenience alias for #wasi_shared_dir_t
+ *
+ * \struct wasi_shared_dir_t
+ * \brief A read-only directory which can be preopened by many configs.
+ *
+ * The files and directories opened beneath a shared directory, and the
+ * listings of its directories, are cached and shared by every config it's
+ * preopened in, so repeatedly opening or listing the same path from any store
+ * only reaches the host filesystem once. The directory's contents are assumed
+ * not to change while it's shared.
+ *
+ * \fn void wasi_shared_dir_delete(wasi_shared_dir_t *);
+ * \brief Deletes a shared directory.
+ *
+ * Configs the directory has been preopened in keep their own reference to it.
+ */
+WASI_DECLARE_OWN(shared_dir)
+
+/**
+ * \brief Opens the directory at \p host_path to be shared.
+ *
+ * Returns `NULL` if the directory could not be opened.
+ */
+WASI_API_EXTERN own wasi_shared_dir_t *
+wasi_shared_dir_new(const char *host_path);
+
+/**
+ * \brief Configures \p dir as a "preopened directory" available to WASI APIs
+ * as \p guest_path.
+ *
+ * Unlike #wasi_config_preopen_dir the directory, and all files within it, can
+ * only be read. The \p dir is not consumed.
+ *
+ * Returns `false` if \p guest_path is not valid UTF-8.
+ */
+WASI_API_EXTERN bool
+wasi_config_preopen_shared_dir(wasi_config_t *config,
+                               const wasi_shared_dir_t *dir,
+                               const char *guest_path);
+
+/**
+ * \typedef wasi_archive_t
+ * \brief Convenience alias for #wasi_archive_t
+ *
+ * \struct wasi_archive_t
+ * \brief A read-only tree of files packed into a single buffer.
+ *
+ * Guests read the files of an archive preopened with
+ * #wasi_config_preopen_archive directly from its buffer, without any
+ * filesystem calls on the host. See `wasmtime_wasi::filesystem::Archive` for
+ * a description of the format.
+ *
+ * \fn void wasi_archive_delete(wasi_archive_t *);
+ * \brief Deletes an archive.
+ *
+ * Configs the archive has been preopened in keep their own reference to it.
+ */
+WASI_DECLARE_OWN(archive)
+
+/**
+ * \brief Creates an archive from a copy of its packed representation.
+ *
+ * Returns `NULL` if \p data isn't a valid archive.
+ */
+WASI_API_EXTERN own wasi_archive_t *wasi_archive_new(const uint8_t *data,
+                                                     size_t len);
+
+/**
+ * \brief Opens the archive at \p path.
+ *
+ * On Unix the file is mapped into memory rather than read, and must not be
+ * modified while the archive is alive.
+ *
+ * Returns `NULL` if the file could not be read or isn't a valid archive.
+ */
+WASI_API_EXTERN own wasi_archive_t *wasi_archive_open(const char *path);
+
+/**
+ * \brief Configures the files in \p archive to be available to WASI APIs,
+ * read-only, in the directory \p guest_path.
+ *
+ * The \p archive is not consumed.
+ *
+ * Returns `false` if \p guest_path is not valid UTF-8.
+ */
+WASI_API_EXTERN bool wasi_config_preopen_archive(wasi_config_t *config,
+                                                 const wasi_archive_t *archive,
+                                                 const char *guest_path);
+
+/**
+ * \typedef wasi_config_template_t
+ * \brief Convenience alias for #wasi_config_template_t
+ *
+ * \struct wasi_config_template_t
+ * \brief The argv, environment variables, preopened directories and network
+ * settings of a #wasi_config_t, which can be used to create many configs.
+ *
+ * Configs created from a template share its argv and environment variables
+ * rather than copying them, until they're added to. This makes creating a
+ * config for each store cheap when they all have the same settings. Other
+ * settings, such as stdio, aren't part of a template.
+ *
+ * \fn void wasi_config_template_delete(wasi_config_template_t *);
+ * \brief Deletes a template.
+ */
+WASI_DECLARE_OWN(config_template)
+
+/**
+ * \brief Creates a template of the settings configured so far in \p config.
+ *
+ * The \p config is not consumed, and changes to it after this call don't
+ * affect the template.
+ */
+WASI_API_EXTERN own wasi_config_template_t *
+wasi_config_template_new(const wasi_config_t *config);
+
+/**
+ * \brief Creates a new configuration object with the settings of
+ * \p template.
+ *
+ * Arguments and environment variables set on the returned config are added to
+ * those of the template, and its other settings can be configured as usual.
+ */
+WASI_API_EXTERN own wasi_config_t *
+wasi_config_new_from_template(const wasi_config_template_t *template_);
+
 #undef own
 
 #ifdef __cplusplus
@@ -188,6 +188,7 @@
 // clang-format off
 // IWYU pragma: begin_exports
 #include <wasmtime/config.h>
+#include <wasmtime/coredump.h>
 #include <wasmtime/engine.h>
 #include <wasmtime/error.h>
 #include <wasmtime/extern.h>
@@ -201,6 +202,7 @@
 #include <wasmtime/sharedmemory.h>
 #include <wasmtime/store.h>
 #include <wasmtime/table.h>
+#include <wasmtime/tag.h>
 #include <wasmtime/trap.h>
 #include <wasmtime/val.h>
 #include <wasmtime/async.h>
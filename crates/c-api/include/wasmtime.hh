@@ -36,6 +36,7 @@
 #define WASMTIME_HH
 
 #include <wasmtime/config.hh>
+#include <wasmtime/coredump.hh>
 #include <wasmtime/engine.hh>
 #include <wasmtime/error.hh>
 #include <wasmtime/extern.hh>
@@ -45,8 +46,11 @@
 #include <wasmtime/linker.hh>
 #include <wasmtime/memory.hh>
 #include <wasmtime/module.hh>
+#include <wasmtime/profiling.hh>
+#include <wasmtime/sharedmemory.hh>
 #include <wasmtime/store.hh>
 #include <wasmtime/table.hh>
+#include <wasmtime/tag.hh>
 #include <wasmtime/trap.hh>
 #include <wasmtime/types.hh>
 #include <wasmtime/val.hh>
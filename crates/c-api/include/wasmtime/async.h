@@ -67,6 +67,23 @@ extern "C" {
  */
 WASMTIME_CONFIG_PROP(void, async_stack_size, uint64_t)
 
+/**
+ * \brief Configures how many released fiber stacks the on-demand instance
+ * allocator keeps for reuse by later async calls.
+ *
+ * Without this each store which makes async calls maps a new fiber stack and
+ * unmaps it when the store is deleted. Cached stacks are shared by all stores
+ * of the engine, avoiding this `mmap`/`munmap` round trip. Stacks aren't cached
+ * when async stack zeroing is enabled, and this has no effect with the pooling
+ * allocator. Usage is reported by #wasmtime_engine_async_stack_cache_stats.
+ *
+ * This option defaults to 0, disabling the cache.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.async_stack_cache_size
+ */
+WASMTIME_CONFIG_PROP(void, async_stack_cache_size, size_t)
+
 /**
  * \brief Configures a Store to yield execution of async WebAssembly code
  * periodically.
@@ -87,6 +104,26 @@ WASM_API_EXTERN wasmtime_error_t *
 wasmtime_context_fuel_async_yield_interval(wasmtime_context_t *context,
                                            uint64_t interval);
 
+/**
+ * \brief Configures the fuel yield interval of a Store to adapt so that each
+ * slice of execution between yields takes about the given wall-clock time.
+ *
+ * The interval configured with #wasmtime_context_fuel_async_yield_interval,
+ * which must be set first, is the starting point. At each yield it's then
+ * tuned from the time the previous slice took, so that guests get fair time
+ * slices without yielding more often than necessary.
+ *
+ * \param context the context for the store to configure.
+ * \param slice_nanos the target duration of each slice in nanoseconds. A value
+ *        of 0 stops tuning, keeping the current interval.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Store.html#method.fuel_async_yield_time_slice
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_context_fuel_async_yield_time_slice(wasmtime_context_t *context,
+                                             uint64_t slice_nanos);
+
 /**
  * \brief Configures epoch-deadline expiration to yield to the async caller and
  * the update the deadline.
@@ -121,6 +158,39 @@ typedef struct wasmtime_async_continuation_t {
   void (*finalizer)(void *);
 } wasmtime_async_continuation_t;
 
+/**
+ * \brief Callback signature for #wasmtime_store_resource_limiter_async.
+ *
+ * This is the same as #wasmtime_resource_growing_callback_t except that the
+ * decision may be made asynchronously. The callback returns a continuation in
+ * `continuation_ret`, and `allowed` and `error_ret` are read once the
+ * continuation reports that it has completed. Until then the WebAssembly
+ * requesting the growth is suspended.
+ *
+ * Ownership of an error written to `error_ret` is transferred to the caller.
+ */
+typedef void (*wasmtime_resource_growing_async_callback_t)(
+    void *env, size_t current, size_t desired, int64_t maximum, bool *allowed,
+    wasmtime_error_t **error_ret,
+    wasmtime_async_continuation_t *continuation_ret);
+
+/**
+ * \brief Configures asynchronous callbacks to dynamically decide whether
+ * memories and tables within a store may grow.
+ *
+ * This is the asynchronous version of #wasmtime_store_resource_limiter, see
+ * its documentation for more information.
+ *
+ * Once configured the store may only be used with asynchronous APIs, such as
+ * #wasmtime_func_call_async and #wasmtime_linker_instantiate_async, since
+ * growth may need to suspend execution.
+ */
+WASM_API_EXTERN void wasmtime_store_resource_limiter_async(
+    wasmtime_store_t *store,
+    wasmtime_resource_growing_async_callback_t memory_growing,
+    wasmtime_resource_growing_async_callback_t table_growing, void *env,
+    void (*finalizer)(void *));
+
 /**
  * \brief Callback signature for #wasmtime_linker_define_async_func.
  *
@@ -183,6 +253,86 @@ typedef struct wasmtime_call_future wasmtime_call_future_t;
  */
 WASM_API_EXTERN bool wasmtime_call_future_poll(wasmtime_call_future_t *future);
 
+/**
+ * \brief Callback signature for #wasmtime_call_future_set_waker.
+ *
+ * Invoked with the `env` provided to #wasmtime_call_future_set_waker when the
+ * future may be able to make progress and should be polled again. This may be
+ * invoked from any thread, possibly while the future is being polled, so it
+ * should typically only schedule the future rather than poll it directly.
+ */
+typedef void (*wasmtime_waker_callback_t)(void *env);
+
+/**
+ * \brief Registers a callback which is invoked when this future can make
+ * progress.
+ *
+ * Without a waker an embedder has no indication of when a pending future
+ * should be polled again, and must poll it repeatedly. Once a waker is set the
+ * future is only runnable after `wake` has been invoked, which happens when
+ * execution yields due to fuel or epochs, or when an asynchronous host
+ * function wakes the future via #wasmtime_waker_wake after its result is
+ * ready. A future whose waker hasn't been invoked since it was last polled
+ * doesn't need to be polled.
+ *
+ * This replaces any previously registered waker, running its finalizer. The
+ * `finalizer` for `env` is run once the future and any wakers obtained via
+ * #wasmtime_caller_waker have been deleted.
+ */
+WASM_API_EXTERN void
+wasmtime_call_future_set_waker(wasmtime_call_future_t *future,
+                               wasmtime_waker_callback_t wake, void *env,
+                               void (*finalizer)(void *));
+
+/**
+ * \brief A handle used to notify a future that it can make progress.
+ *
+ * Wakers are obtained by asynchronous host functions with
+ * #wasmtime_caller_waker and must be deleted with #wasmtime_waker_delete.
+ * They may be sent to, and used from, any thread.
+ */
+typedef struct wasmtime_waker wasmtime_waker_t;
+
+/**
+ * \brief Returns a waker for the future which invoked the current
+ * asynchronous host function.
+ *
+ * This may only be called from within a #wasmtime_func_async_callback_t, and
+ * returns `NULL` otherwise. The host function should invoke
+ * #wasmtime_waker_wake once its continuation would report completion, so that
+ * the future is polled again. The returned waker is owned by the caller.
+ */
+WASM_API_EXTERN wasmtime_waker_t *
+wasmtime_caller_waker(const wasmtime_caller_t *caller);
+
+/**
+ * \brief Notifies the future associated with this waker that it should be
+ * polled again.
+ */
+WASM_API_EXTERN void wasmtime_waker_wake(const wasmtime_waker_t *waker);
+
+/**
+ * \brief Deletes a waker returned by #wasmtime_caller_waker.
+ */
+WASM_API_EXTERN void wasmtime_waker_delete(wasmtime_waker_t *waker);
+
+/**
+ * \brief Cancels the asynchronous operation represented by this future.
+ *
+ * The guest is trapped at the point where it's currently suspended, such as a
+ * fuel or epoch yield or an async host function, and unwound before this
+ * function returns. Its fiber stack is returned to the engine's allocator
+ * synchronously, and any continuation of a pending async host function is
+ * finalized. Instances created in the store remain until the store is deleted.
+ *
+ * Afterwards #wasmtime_call_future_poll returns `true` immediately, and none
+ * of the results, trap or error outputs of the operation are written. The
+ * future must still be deleted with #wasmtime_call_future_delete. Cancelling a
+ * completed future has no effect.
+ */
+WASM_API_EXTERN void
+wasmtime_call_future_cancel(wasmtime_call_future_t *future);
+
 /**
  * /brief Frees the underlying memory for a future.
  *
@@ -0,0 +1,639 @@
+/**
+ * \file wasmtime/async.hh
+ *
+ * C++20 coroutine support for the asynchronous functions in
+ * `wasmtime/async.h`.
+ *
+ * Calls such as `Func::call_async` and `Linker::instantiate_async` return
+ * awaitables which can be `co_await`-ed from a coroutine, for example a
+ * `Task`. Each awaitable is driven to completion by an `Executor` which polls
+ * its underlying `wasmtime_call_future_t` and resumes the awaiting coroutine
+ * once it's ready. `PollingExecutor` is a simple single-threaded executor, and
+ * embedders may implement `Executor` to integrate with their own event loop.
+ *
+ * Note that a store may only have one outstanding future at a time, so
+ * concurrency comes from running many stores on the same executor.
+ */
+
+#ifndef WASMTIME_ASYNC_HH
+#define WASMTIME_ASYNC_HH
+
+#include <wasmtime/conf.h>
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#endif
+#endif
+
+#if defined(WASMTIME_FEATURE_ASYNC) && defined(__cpp_lib_coroutine)
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <wasmtime/async.h>
+#include <wasmtime/func.hh>
+#include <wasmtime/helpers.hh>
+#include <wasmtime/linker.hh>
+
+namespace wasmtime {
+
+/**
+ * \brief An owned `wasmtime_call_future_t`, which is polled until the
+ * asynchronous operation it represents completes.
+ */
+class CallFuture {
+  WASMTIME_OWN_WRAPPER(CallFuture, wasmtime_call_future);
+
+  /// \brief Makes progress on this future, returning whether it's completed.
+  ///
+  /// This must not be called again after it has returned `true`.
+  bool poll() { return wasmtime_call_future_poll(ptr.get()); }
+
+  /// \brief Cancels the operation, unwinding the guest and releasing its
+  /// stack before returning.
+  ///
+  /// Afterwards `poll` returns `true` without writing any results. See
+  /// `wasmtime_call_future_cancel` for more information.
+  void cancel() { wasmtime_call_future_cancel(ptr.get()); }
+};
+
+/**
+ * \brief Drives the futures awaited by coroutines to completion.
+ *
+ * Awaitables hand their future to an executor when they'd otherwise block,
+ * and the executor is responsible for polling the future, on the thread that
+ * owns its store, until it completes and then resuming the waiting coroutine.
+ */
+class Executor {
+public:
+  virtual ~Executor() = default;
+
+  /// \brief Polls `future` until it's ready and then resumes `waiter`.
+  ///
+  /// The future has already been polled once when this is called, and it
+  /// stays alive until `waiter` is resumed.
+  virtual void await_future(CallFuture &future,
+                            std::coroutine_handle<> waiter) = 0;
+};
+
+/**
+ * \brief A single-threaded `Executor` which polls all pending futures in turn.
+ *
+ * Futures are queued until `run` is called, which polls each of them round
+ * robin and resumes coroutines as their futures complete.
+ */
+class PollingExecutor : public Executor {
+  std::deque<std::pair<CallFuture *, std::coroutine_handle<>>> pending;
+
+public:
+  /// \brief Queues `future` to be polled by `run`.
+  void await_future(CallFuture &future,
+                    std::coroutine_handle<> waiter) override {
+    pending.emplace_back(&future, waiter);
+  }
+
+  /// \brief Returns whether there are no futures left to poll.
+  bool empty() const { return pending.empty(); }
+
+  /// \brief Polls futures, resuming their coroutines as they complete, until
+  /// none are left.
+  void run() {
+    while (!pending.empty()) {
+      auto [future, waiter] = pending.front();
+      pending.pop_front();
+      if (future->poll()) {
+        waiter.resume();
+      } else {
+        pending.emplace_back(future, waiter);
+      }
+    }
+  }
+};
+
+/**
+ * \brief A multi-threaded `Executor` which polls futures on a pool of worker
+ * threads.
+ *
+ * Each worker has its own queue of futures ready to be polled and, when it
+ * runs out, steals from the queues of other workers, so stores migrate to
+ * whichever workers are idle. Futures are only queued when they're woken, see
+ * `wasmtime_call_future_set_waker`, so stores waiting on host functions cost
+ * nothing until then. This requires that all async host functions wake their
+ * future upon completion, as `AsyncCompletion` does.
+ *
+ * Coroutines are resumed on the worker that completed their future, so they
+ * may move between threads at each `co_await`. The executor must outlive all
+ * futures awaited on it, and wakers obtained from them.
+ */
+class ThreadPoolExecutor : public Executor {
+  enum State : int { Idle, Scheduled, Running, Notified, Done };
+
+  struct Entry {
+    ThreadPoolExecutor *pool;
+    CallFuture *future;
+    std::coroutine_handle<> waiter;
+    std::atomic<int> state{Scheduled};
+  };
+
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Entry *> queue;
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::thread> threads;
+  std::mutex idle_mutex;
+  std::condition_variable idle;
+  bool stopping = false;
+  std::atomic<size_t> queued{0};
+  std::atomic<size_t> pending_futures{0};
+  std::atomic<size_t> next_worker{0};
+  std::atomic<uint64_t> steal_count{0};
+
+  static void raw_wake(void *env) {
+    auto *entry = static_cast<Entry *>(env);
+    entry->pool->wake(entry);
+  }
+
+  static void raw_finalize(void *env) { delete static_cast<Entry *>(env); }
+
+  void push(Entry *entry) {
+    auto &worker = *workers[next_worker++ % workers.size()];
+    {
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      worker.queue.push_back(entry);
+    }
+    queued++;
+    { std::lock_guard<std::mutex> lock(idle_mutex); }
+    idle.notify_one();
+  }
+
+  void wake(Entry *entry) {
+    int state = entry->state.load();
+    while (true) {
+      if (state == Idle) {
+        if (entry->state.compare_exchange_weak(state, Scheduled)) {
+          push(entry);
+          return;
+        }
+      } else if (state == Running) {
+        if (entry->state.compare_exchange_weak(state, Notified)) {
+          return;
+        }
+      } else {
+        return;
+      }
+    }
+  }
+
+  Entry *take(size_t index) {
+    for (size_t i = 0; i < workers.size(); i++) {
+      auto &worker = *workers[(index + i) % workers.size()];
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      if (worker.queue.empty()) {
+        continue;
+      }
+      Entry *entry;
+      if (i == 0) {
+        entry = worker.queue.front();
+        worker.queue.pop_front();
+      } else {
+        entry = worker.queue.back();
+        worker.queue.pop_back();
+        steal_count++;
+      }
+      queued--;
+      return entry;
+    }
+    return nullptr;
+  }
+
+  void run(Entry *entry) {
+    entry->state.store(Running);
+    if (entry->future->poll()) {
+      // The entry is owned by the future's waker, so it may be deleted once
+      // the coroutine resumes and drops the future.
+      entry->state.store(Done);
+      pending_futures--;
+      entry->waiter.resume();
+      return;
+    }
+    int state = Running;
+    if (!entry->state.compare_exchange_strong(state, Idle)) {
+      // Woken while being polled, so poll it again.
+      entry->state.store(Scheduled);
+      push(entry);
+    }
+  }
+
+  void work(size_t index) {
+    while (true) {
+      if (Entry *entry = take(index)) {
+        run(entry);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(idle_mutex);
+      idle.wait(lock, [&] { return stopping || queued.load() > 0; });
+      if (stopping) {
+        return;
+      }
+    }
+  }
+
+public:
+  /// \brief Creates an executor with `threads` worker threads, or one per
+  /// hardware thread by default.
+  explicit ThreadPoolExecutor(
+      size_t threads = std::thread::hardware_concurrency()) {
+    threads = threads == 0 ? 1 : threads;
+    for (size_t i = 0; i < threads; i++) {
+      workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < threads; i++) {
+      this->threads.emplace_back([this, i] { work(i); });
+    }
+  }
+
+  ThreadPoolExecutor(const ThreadPoolExecutor &) = delete;
+  ThreadPoolExecutor &operator=(const ThreadPoolExecutor &) = delete;
+
+  /// \brief Stops and joins the worker threads, abandoning any futures which
+  /// haven't completed.
+  ~ThreadPoolExecutor() {
+    {
+      std::lock_guard<std::mutex> lock(idle_mutex);
+      stopping = true;
+    }
+    idle.notify_all();
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
+  /// \brief Registers a waker for `future` and queues it to be polled.
+  void await_future(CallFuture &future,
+                    std::coroutine_handle<> waiter) override {
+    auto *entry = new Entry{this, &future, waiter};
+    pending_futures++;
+    wasmtime_call_future_set_waker(future.capi(), raw_wake, entry,
+                                   raw_finalize);
+    push(entry);
+  }
+
+  /// \brief Returns the number of futures which are queued to be polled.
+  size_t queue_depth() const { return queued.load(); }
+
+  /// \brief Returns the number of futures which are queued to be polled by
+  /// each worker.
+  std::vector<size_t> worker_queue_depths() const {
+    std::vector<size_t> depths;
+    for (const auto &worker : workers) {
+      std::lock_guard<std::mutex> lock(worker->mutex);
+      depths.push_back(worker->queue.size());
+    }
+    return depths;
+  }
+
+  /// \brief Returns the number of futures which have been awaited on this
+  /// executor but haven't completed, whether queued or waiting to be woken.
+  size_t pending() const { return pending_futures.load(); }
+
+  /// \brief Returns the number of futures which workers have taken from the
+  /// queues of other workers.
+  uint64_t steals() const { return steal_count.load(); }
+};
+
+/**
+ * \brief A coroutine which produces a `T`.
+ *
+ * A `Task` starts running as soon as it's called, until its first suspension,
+ * and can be `co_await`-ed by another coroutine to get its result. The task
+ * must not be destroyed while it's suspended. Exceptions thrown from a task
+ * terminate the program.
+ */
+template <typename T> class Task {
+public:
+  /// \brief The promise type of the coroutine.
+  struct promise_type {
+    /// \brief The value that the coroutine returned, once it's completed.
+    std::optional<T> value;
+    /// \brief A coroutine awaiting this one, if any.
+    std::coroutine_handle<> continuation;
+
+    /// \brief Creates the `Task` for this coroutine.
+    Task get_return_object() {
+      return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    /// \brief Starts running the coroutine immediately.
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    /// \brief Resumes the awaiting coroutine, if any, upon completion.
+    auto final_suspend() noexcept {
+      struct Final {
+        bool await_ready() noexcept { return false; }
+        std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+          auto next = h.promise().continuation;
+          return next ? next : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+      };
+      return Final{};
+    }
+    /// \brief Records the value returned by the coroutine.
+    void return_value(T v) { value.emplace(std::move(v)); }
+    /// \brief Terminates the program.
+    void unhandled_exception() { std::terminate(); }
+  };
+
+private:
+  std::coroutine_handle<promise_type> handle;
+
+  explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+public:
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+
+  /// \brief Moves the coroutine from another task into this one.
+  Task(Task &&other) : handle(std::exchange(other.handle, nullptr)) {}
+
+  ~Task() {
+    if (handle) {
+      handle.destroy();
+    }
+  }
+
+  /// \brief Returns whether this task has completed.
+  bool done() const { return handle.done(); }
+
+  /// \brief Returns the value this task produced, which must have completed.
+  T &result() { return *handle.promise().value; }
+
+  /// \brief Returns whether this task has already completed when awaited.
+  bool await_ready() const { return done(); }
+
+  /// \brief Resumes `waiter` once this task completes.
+  void await_suspend(std::coroutine_handle<> waiter) {
+    handle.promise().continuation = waiter;
+  }
+
+  /// \brief Takes the value this task produced.
+  T await_resume() { return std::move(result()); }
+};
+
+namespace detail {
+
+/// Shared implementation of the awaitables below, where `Derived::start`
+/// creates the future once the awaitable is in its final location.
+template <typename Derived> class FutureAwaitable {
+  Executor *executor;
+  std::optional<CallFuture> future;
+
+protected:
+  explicit FutureAwaitable(Executor &executor) : executor(&executor) {}
+
+public:
+  FutureAwaitable(const FutureAwaitable &) = delete;
+  FutureAwaitable &operator=(const FutureAwaitable &) = delete;
+
+  /// Starts the operation, returning whether it completed immediately.
+  bool await_ready() {
+    future.emplace(static_cast<Derived *>(this)->start());
+    return future->poll();
+  }
+
+  /// Hands the future to the executor to complete.
+  void await_suspend(std::coroutine_handle<> waiter) {
+    executor->await_future(*future, waiter);
+  }
+};
+
+} // namespace detail
+
+/**
+ * \brief The awaitable returned by `Func::call_async`, which produces the
+ * function's results.
+ */
+class FuncCallAwaitable
+    : public detail::FutureAwaitable<FuncCallAwaitable> {
+  friend class Func;
+  friend class detail::FutureAwaitable<FuncCallAwaitable>;
+
+  wasmtime_context_t *cx;
+  wasmtime_func_t func;
+  std::vector<Val> params;
+  std::vector<Val> results;
+  wasm_trap_t *trap = nullptr;
+  wasmtime_error_t *error = nullptr;
+
+  FuncCallAwaitable(Executor &executor, wasmtime_context_t *cx,
+                    const wasmtime_func_t &func, std::vector<Val> params,
+                    size_t nresults)
+      : FutureAwaitable(executor), cx(cx), func(func),
+        params(std::move(params)), results(nresults, int32_t(0)) {}
+
+  CallFuture start() {
+    return CallFuture(wasmtime_func_call_async(
+        cx, &func,
+        reinterpret_cast<const wasmtime_val_t *>(params.data()), // NOLINT
+        params.size(),
+        reinterpret_cast<wasmtime_val_t *>(results.data()), // NOLINT
+        results.size(), &trap, &error));
+  }
+
+public:
+  /// \brief Returns the results of the call, or the trap or error it failed
+  /// with.
+  TrapResult<std::vector<Val>> await_resume() {
+    if (error != nullptr) {
+      return TrapError(Error(std::exchange(error, nullptr)));
+    }
+    if (trap != nullptr) {
+      return TrapError(Trap(std::exchange(trap, nullptr)));
+    }
+    return std::move(results);
+  }
+};
+
+inline FuncCallAwaitable Func::call_async(Store::Context cx,
+                                          std::vector<Val> params,
+                                          Executor &executor) const {
+  size_t nresults = this->type(cx)->results().size();
+  return FuncCallAwaitable(executor, cx.ptr, func, std::move(params),
+                           nresults);
+}
+
+/**
+ * \brief The awaitable returned by `Linker::instantiate_async`, which
+ * produces the new instance.
+ */
+class InstantiateAwaitable
+    : public detail::FutureAwaitable<InstantiateAwaitable> {
+  friend class Linker;
+  friend class detail::FutureAwaitable<InstantiateAwaitable>;
+
+  const wasmtime_linker_t *linker;
+  wasmtime_context_t *cx;
+  const wasmtime_module_t *module;
+  wasmtime_instance_t instance;
+  wasm_trap_t *trap = nullptr;
+  wasmtime_error_t *error = nullptr;
+
+  InstantiateAwaitable(Executor &executor, const wasmtime_linker_t *linker,
+                       wasmtime_context_t *cx, const wasmtime_module_t *module)
+      : FutureAwaitable(executor), linker(linker), cx(cx), module(module) {}
+
+  CallFuture start() {
+    return CallFuture(wasmtime_linker_instantiate_async(
+        linker, cx, module, &instance, &trap, &error));
+  }
+
+public:
+  /// \brief Returns the new instance, or the trap or error that
+  /// instantiation failed with.
+  TrapResult<Instance> await_resume() {
+    if (error != nullptr) {
+      return TrapError(Error(std::exchange(error, nullptr)));
+    }
+    if (trap != nullptr) {
+      return TrapError(Trap(std::exchange(trap, nullptr)));
+    }
+    return Instance(instance);
+  }
+};
+
+inline InstantiateAwaitable Linker::instantiate_async(Store::Context cx,
+                                                      const Module &m,
+                                                      Executor &executor) {
+  return InstantiateAwaitable(executor, ptr.get(), cx.ptr, m.capi());
+}
+
+/**
+ * \brief A handle through which an async host function reports its results.
+ *
+ * Host functions defined with `Linker::func_new_async` receive an
+ * `AsyncCompletion` and keep the calling WebAssembly suspended until
+ * `complete` is called. This may happen after the host function has returned,
+ * from any thread, for example once an I/O operation finishes. Completing a
+ * call wakes its future, see `wasmtime_call_future_set_waker`, so executors
+ * don't need to poll it in the meantime.
+ *
+ * `complete` must be called exactly once, otherwise the calling WebAssembly
+ * never resumes. If the call is cancelled before completing, by deleting its
+ * future, then `complete` does nothing.
+ */
+class AsyncCompletion {
+  friend class Linker;
+
+  struct State {
+    std::mutex mutex;
+    bool done = false;
+    wasmtime_val_t *results;
+    size_t nresults;
+    wasm_trap_t **trap_ret;
+    wasmtime_waker_t *waker;
+
+    ~State() {
+      if (waker != nullptr) {
+        wasmtime_waker_delete(waker);
+      }
+    }
+  };
+
+  std::shared_ptr<State> state;
+
+  explicit AsyncCompletion(std::shared_ptr<State> state)
+      : state(std::move(state)) {}
+
+  template <typename F>
+  static void raw_callback(void *env, wasmtime_caller_t *caller,
+                           const wasmtime_val_t *args, size_t nargs,
+                           wasmtime_val_t *results, size_t nresults,
+                           wasm_trap_t **trap_ret,
+                           wasmtime_async_continuation_t *continuation_ret) {
+    auto state = std::make_shared<State>();
+    state->results = results;
+    state->nresults = nresults;
+    state->trap_ret = trap_ret;
+    state->waker = wasmtime_caller_waker(caller);
+
+    continuation_ret->callback = raw_poll;
+    continuation_ret->env = new std::shared_ptr<State>(state);
+    continuation_ret->finalizer = raw_finalize;
+
+    F *func = reinterpret_cast<F *>(env);                          // NOLINT
+    Span<const Val> args_span(reinterpret_cast<const Val *>(args), // NOLINT
+                              nargs);
+    (*func)(Caller(caller), args_span, AsyncCompletion(std::move(state)));
+  }
+
+  static bool raw_poll(void *env) {
+    auto &state = *static_cast<std::shared_ptr<State> *>(env);
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->done;
+  }
+
+  static void raw_finalize(void *env) {
+    std::unique_ptr<std::shared_ptr<State>> state(
+        static_cast<std::shared_ptr<State> *>(env));
+    std::lock_guard<std::mutex> lock((*state)->mutex);
+    (*state)->results = nullptr;
+    (*state)->trap_ret = nullptr;
+  }
+
+public:
+  /// \brief Resumes the calling WebAssembly with the given results, or
+  /// traps it with the given trap.
+  void complete(Result<std::vector<Val>, Trap> result) {
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (state->trap_ret == nullptr) {
+        return;
+      }
+      if (!result) {
+        *state->trap_ret = result.err().capi_release();
+      } else if (result.ok().size() != state->nresults) {
+        *state->trap_ret =
+            Trap("async host function returned the wrong number of results")
+                .capi_release();
+      } else {
+        auto *results = reinterpret_cast<Val *>(state->results); // NOLINT
+        std::move(result.ok().begin(), result.ok().end(), results);
+      }
+      state->done = true;
+    }
+    if (state->waker != nullptr) {
+      wasmtime_waker_wake(state->waker);
+    }
+  }
+};
+
+template <typename F>
+Result<std::monostate> Linker::func_new_async(std::string_view module,
+                                              std::string_view name,
+                                              const FuncType &ty, F &&f) {
+  using Callable = std::remove_reference_t<F>;
+  auto *error = wasmtime_linker_define_async_func(
+      ptr.get(), module.data(), module.length(), name.data(), name.length(),
+      ty.ptr.get(), AsyncCompletion::raw_callback<Callable>,
+      std::make_unique<Callable>(std::forward<F>(f)).release(),
+      Func::raw_finalize<Callable>);
+  if (error != nullptr) {
+    return Error(error);
+  }
+  return std::monostate();
+}
+
+} // namespace wasmtime
+
+#endif // WASMTIME_FEATURE_ASYNC && __cpp_lib_coroutine
+
+#endif // WASMTIME_ASYNC_HH
@@ -1,6 +1,7 @@
 #ifndef WASMTIME_COMPONENT_H
 #define WASMTIME_COMPONENT_H
 
+#include <wasmtime/component/async.h>
 #include <wasmtime/component/component.h>
 #include <wasmtime/component/func.h>
 #include <wasmtime/component/instance.h>
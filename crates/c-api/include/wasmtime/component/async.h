@@ -0,0 +1,114 @@
+/**
+ * \file wasmtime/component/async.h
+ *
+ * \brief Async support for components.
+ *
+ * These functions are the component equivalents of those in
+ * `wasmtime/async.h`, and follow the same rules: the returned
+ * #wasmtime_call_future_t must be polled to completion with
+ * #wasmtime_call_future_poll, and all parameters must be kept alive and
+ * unmodified until the future is deleted.
+ */
+
+#ifndef WASMTIME_COMPONENT_ASYNC_H
+#define WASMTIME_COMPONENT_ASYNC_H
+
+#include <wasmtime/conf.h>
+
+#if defined(WASMTIME_FEATURE_COMPONENT_MODEL) &&                               \
+    defined(WASMTIME_FEATURE_ASYNC)
+
+#include <wasmtime/async.h>
+#include <wasmtime/component/func.h>
+#include <wasmtime/component/linker.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Type of the callback used in
+ * #wasmtime_component_linker_instance_add_func_async.
+ *
+ * This is the same as #wasmtime_component_func_callback_t except that the
+ * function may complete asynchronously. The callback returns a continuation
+ * in `continuation_ret`, and the results and `error_ret` are read once the
+ * continuation reports that it has completed. Until then the calling
+ * WebAssembly is suspended. The arguments, results and function type remain
+ * valid until the continuation completes.
+ *
+ * Ownership of an error written to `error_ret` is transferred to the caller.
+ */
+typedef void (*wasmtime_component_func_async_callback_t)(
+    void *env, wasmtime_context_t *context,
+    const wasmtime_component_func_type_t *ty, wasmtime_component_val_t *args,
+    size_t nargs, wasmtime_component_val_t *results, size_t nresults,
+    wasmtime_error_t **error_ret,
+    wasmtime_async_continuation_t *continuation_ret);
+
+/**
+ * \brief Defines an async function within this instance.
+ *
+ * This is the same as #wasmtime_component_linker_instance_add_func except
+ * that `callback` may complete asynchronously. The linker can then only be
+ * used to instantiate components with
+ * #wasmtime_component_linker_instantiate_async.
+ *
+ * \param linker_instance the instance to define the function in
+ * \param name the function name
+ * \param name_len length of \p name in bytes
+ * \param callback the callback when this function gets called
+ * \param data host-specific data passed to the callback invocation, can be
+ * `NULL`
+ * \param finalizer optional finalizer for \p data, can be `NULL`
+ * \return on success `NULL`, otherwise an error
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_component_linker_instance_add_func_async(
+    wasmtime_component_linker_instance_t *linker_instance, const char *name,
+    size_t name_len, wasmtime_component_func_async_callback_t callback,
+    void *data, void (*finalizer)(void *));
+
+/**
+ * \brief Instantiates a component with the items defined in this linker for
+ * an async store.
+ *
+ * This is the same as #wasmtime_component_linker_instantiate except that it's
+ * asynchronous. On completion either `instance_out` is filled in, or an error
+ * is written to `error_ret`, whose ownership is transferred to the caller.
+ *
+ * The returned future is owned by the caller and must be deleted with
+ * #wasmtime_call_future_delete.
+ */
+WASM_API_EXTERN wasmtime_call_future_t *
+wasmtime_component_linker_instantiate_async(
+    const wasmtime_component_linker_t *linker, wasmtime_context_t *context,
+    const wasmtime_component_t *component,
+    wasmtime_component_instance_t *instance_out, wasmtime_error_t **error_ret);
+
+/**
+ * \brief Invokes \p func with the \p args given, returning the results
+ * asynchronously.
+ *
+ * This is the same as #wasmtime_component_func_call except that it's
+ * asynchronous. On completion either the \p results are written, as with
+ * #wasmtime_component_func_call, or an error is written to `error_ret`, whose
+ * ownership is transferred to the caller.
+ *
+ * The returned future is owned by the caller and must be deleted with
+ * #wasmtime_call_future_delete. Only one future may be alive for a store at a
+ * time.
+ */
+WASM_API_EXTERN wasmtime_call_future_t *wasmtime_component_func_call_async(
+    const wasmtime_component_func_t *func, wasmtime_context_t *context,
+    const wasmtime_component_val_t *args, size_t args_size,
+    wasmtime_component_val_t *results, size_t results_size,
+    wasmtime_error_t **error_ret);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // WASMTIME_FEATURE_COMPONENT_MODEL && WASMTIME_FEATURE_ASYNC
+
+#endif // WASMTIME_COMPONENT_ASYNC_H
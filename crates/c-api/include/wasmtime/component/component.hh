@@ -9,6 +9,7 @@
 
 #ifdef WASMTIME_FEATURE_COMPONENT_MODEL
 
+#include <initializer_list>
 #include <memory>
 #include <optional>
 #include <string_view>
@@ -43,16 +44,15 @@ class Component {
   /**
    * \brief Compiles a component from the WebAssembly text format.
    *
-   * This function will automatically use `wat2wasm` on the input and then
-   * delegate to the #compile function.
+   * This function will automatically use `wat2wasm_bytes` on the input and
+   * then delegate to the #compile function.
    */
   static Result<Component> compile(Engine &engine, std::string_view wat) {
-    auto wasm = wat2wasm(wat);
+    auto wasm = wat2wasm_bytes(wat);
     if (!wasm) {
       return wasm.err();
     }
-    auto bytes = wasm.ok();
-    return compile(engine, bytes);
+    return compile(engine, wasm.ok_ref());
   }
 
   /**
@@ -161,6 +161,27 @@ class Component {
     return std::nullopt;
   };
 
+  /**
+   * \brief Looks up the export at the end of `path`, a list of names of
+   * nested instances ending with the export's name.
+   *
+   * For example `{"wasi:http/incoming-handler@0.2.0", "handle"}` finds the
+   * `handle` function of that exported interface. The returned index can be
+   * looked up on any instance of this component with `Instance::get_func`,
+   * so the names only need to be resolved once rather than per call.
+   */
+  std::optional<ExportIndex>
+  export_index(std::initializer_list<std::string_view> path) {
+    std::optional<ExportIndex> ret;
+    for (std::string_view name : path) {
+      ret = export_index(ret ? &*ret : nullptr, name);
+      if (!ret) {
+        break;
+      }
+    }
+    return ret;
+  }
+
   /// \brief Returns the type of this component.
   ComponentType type() const {
     return ComponentType(wasmtime_component_type(ptr.get()));
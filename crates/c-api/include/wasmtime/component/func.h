@@ -57,6 +57,78 @@ WASM_API_EXTERN wasmtime_error_t *wasmtime_component_func_call(
     const wasmtime_component_val_t *args, size_t args_size,
     wasmtime_component_val_t *results, size_t results_size);
 
+/// \brief Opaque type representing the results of a call made with
+/// #wasmtime_component_func_call_lazy.
+///
+/// This is only valid for the duration of the callback that it's passed to.
+typedef struct wasmtime_component_lazy_results
+    wasmtime_component_lazy_results_t;
+
+/// \brief Type of the callback used in #wasmtime_component_func_call_lazy.
+///
+/// Returning an error from this callback fails the call with that error.
+typedef wasmtime_error_t *(*wasmtime_component_lazy_results_callback_t)(
+    void *, wasmtime_component_lazy_results_t *);
+
+/**
+ * \brief Invokes \p func with the \p args given, and passes its results to
+ * \p callback without converting them to #wasmtime_component_val_t up front.
+ *
+ * This is like #wasmtime_component_func_call except that the results are
+ * read from the guest as they're accessed through the
+ * #wasmtime_component_lazy_results_t passed to \p callback. For example the
+ * elements of a large `list<T>` result can be read one at a time with
+ * #wasmtime_component_lazy_results_list_get and converted into the embedder's
+ * own data structures, without a #wasmtime_component_val_t of the entire list
+ * ever being created.
+ *
+ * The results are only valid until \p callback returns, after which the
+ * function's `post-return`, which may free them, is run. \p data is passed
+ * to \p callback as its first argument.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_component_func_call_lazy(
+    const wasmtime_component_func_t *func, wasmtime_context_t *context,
+    const wasmtime_component_val_t *args, size_t args_size,
+    wasmtime_component_lazy_results_callback_t callback, void *data);
+
+/// \brief Returns the number of results in \p results.
+WASM_API_EXTERN size_t wasmtime_component_lazy_results_len(
+    const wasmtime_component_lazy_results_t *results);
+
+/**
+ * \brief Reads the entire result at \p index into \p val_out.
+ *
+ * On success the caller owns \p val_out and must deallocate it with
+ * #wasmtime_component_val_delete. Returns an error if \p index is out of
+ * bounds or if the result is invalid.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_component_lazy_results_get(
+    wasmtime_component_lazy_results_t *results, size_t index,
+    wasmtime_component_val_t *val_out);
+
+/**
+ * \brief Returns the length of the `list<T>` result at \p index in
+ * \p len_out.
+ *
+ * Returns an error if \p index is out of bounds, if the result isn't a list,
+ * or if the list is out of bounds of the guest's memory.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_component_lazy_results_list_len(
+    wasmtime_component_lazy_results_t *results, size_t index, size_t *len_out);
+
+/**
+ * \brief Reads the element at \p elem_index of the `list<T>` result at
+ * \p index into \p val_out.
+ *
+ * On success the caller owns \p val_out and must deallocate it with
+ * #wasmtime_component_val_delete. Returns an error in the same situations as
+ * #wasmtime_component_lazy_results_list_len, or if \p elem_index is out of
+ * bounds of the list or the element is invalid.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_component_lazy_results_list_get(
+    wasmtime_component_lazy_results_t *results, size_t index, size_t elem_index,
+    wasmtime_component_val_t *val_out);
+
 /**
  * \brief No longer needs to be called; this function has no effect.
  *
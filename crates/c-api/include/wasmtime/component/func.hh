@@ -7,7 +7,14 @@
 
 #ifdef WASMTIME_FEATURE_COMPONENT_MODEL
 
+#include <optional>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
 #include <wasmtime/component/func.h>
 #include <wasmtime/component/types/func.hh>
 #include <wasmtime/component/val.hh>
@@ -18,6 +25,292 @@
 namespace wasmtime {
 namespace component {
 
+/**
+ * \brief Describes how the C++ type `T` corresponds to a component model type,
+ * for use with `TypedFunc` and typed host functions.
+ *
+ * Specializations are provided for `bool`, the fixed-width integer types,
+ * `float`, `double`, `std::string`, `std::vector<T>`, `std::optional<T>` and
+ * `std::tuple<T...>`. Also `std::string_view` can be used for parameters, but
+ * not results. Other types, for example structs corresponding to records, can
+ * be supported by specializing this template with the members:
+ *
+ * * `static bool typecheck(const ValType &ty)`, which returns whether `ty` is
+ *   the component model type of `T`.
+ * * `static Val lower(const T &value)`, which converts `value` to a `Val`.
+ * * `static T lift(const Val &value)`, which converts a `Val` whose type was
+ *   accepted by `typecheck` to a `T`.
+ */
+template <typename T> struct ComponentValue;
+
+/// Internal helper macro to define `ComponentValue` for primitive types.
+#define COMPONENT_PRIMITIVE(ty, name)                                          \
+  /** \brief The component model type `name`. */                               \
+  template <> struct ComponentValue<ty> {                                      \
+    /** \brief Returns whether `t` is `name`. */                               \
+    static bool typecheck(const ValType &t) { return t.is_##name(); }          \
+    /** \brief Converts `v` to a `Val`. */                                     \
+    static Val lower(ty v) { return Val(v); }                                  \
+    /** \brief Converts `v` back to a `ty`. */                                 \
+    static ty lift(const Val &v) { return v.get_##name(); }                    \
+  };
+
+COMPONENT_PRIMITIVE(bool, bool)
+COMPONENT_PRIMITIVE(int8_t, s8)
+COMPONENT_PRIMITIVE(uint8_t, u8)
+COMPONENT_PRIMITIVE(int16_t, s16)
+COMPONENT_PRIMITIVE(uint16_t, u16)
+COMPONENT_PRIMITIVE(int32_t, s32)
+COMPONENT_PRIMITIVE(uint32_t, u32)
+COMPONENT_PRIMITIVE(int64_t, s64)
+COMPONENT_PRIMITIVE(uint64_t, u64)
+COMPONENT_PRIMITIVE(float, f32)
+COMPONENT_PRIMITIVE(double, f64)
+
+#undef COMPONENT_PRIMITIVE
+
+/// \brief The component model type `string`.
+template <> struct ComponentValue<std::string> {
+  /// \brief Returns whether `t` is `string`.
+  static bool typecheck(const ValType &t) { return t.is_string(); }
+  /// \brief Converts `v` to a `Val`.
+  static Val lower(const std::string &v) { return Val::string(v); }
+  /// \brief Converts `v` back to a `std::string`.
+  static std::string lift(const Val &v) { return std::string(v.get_string()); }
+};
+
+/// \brief The component model type `string`, borrowed from a `Val`.
+///
+/// A lifted `std::string_view` points into the `Val` it was lifted from, so
+/// this can be used for the parameters of host functions defined with
+/// `LinkerInstance::add_func`, but it can't be used for the result of a
+/// `TypedFunc`.
+template <> struct ComponentValue<std::string_view> {
+  /// \brief Returns whether `t` is `string`.
+  static bool typecheck(const ValType &t) { return t.is_string(); }
+  /// \brief Converts `v` to a `Val`.
+  static Val lower(std::string_view v) { return Val::string(v); }
+  /// \brief Returns a view of the string in `v`.
+  static std::string_view lift(const Val &v) { return v.get_string(); }
+};
+
+/// \brief The component model type `list<T>`.
+///
+/// Lists of numbers are passed to Wasmtime as a `FlatList`, so they're copied
+/// in one go rather than element-by-element.
+template <typename T> struct ComponentValue<std::vector<T>> {
+  /// \brief Returns whether `t` is a list of `T`.
+  static bool typecheck(const ValType &t) {
+    return t.is_list() && ComponentValue<T>::typecheck(t.list().element());
+  }
+
+  /// \brief Converts `v` to a `Val`.
+  static Val lower(const std::vector<T> &v) {
+    if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+      return FlatList<T>(v);
+    } else {
+      std::vector<Val> elems;
+      elems.reserve(v.size());
+      for (const auto &elem : v) {
+        elems.push_back(ComponentValue<T>::lower(elem));
+      }
+      return List(std::move(elems));
+    }
+  }
+
+  /// \brief Converts `v` back to a `std::vector<T>`.
+  static std::vector<T> lift(const Val &v) {
+    const List &list = v.get_list();
+    std::vector<T> ret;
+    ret.reserve(list.size());
+    for (const Val &elem : list) {
+      ret.push_back(ComponentValue<T>::lift(elem));
+    }
+    return ret;
+  }
+};
+
+/// \brief The component model type `option<T>`.
+template <typename T> struct ComponentValue<std::optional<T>> {
+  /// \brief Returns whether `t` is an option of `T`.
+  static bool typecheck(const ValType &t) {
+    return t.is_option() && ComponentValue<T>::typecheck(t.option().ty());
+  }
+
+  /// \brief Converts `v` to a `Val`.
+  static Val lower(const std::optional<T> &v) {
+    if (!v) {
+      return WitOption(std::nullopt);
+    }
+    return WitOption(ComponentValue<T>::lower(*v));
+  }
+
+  /// \brief Converts `v` back to a `std::optional<T>`.
+  static std::optional<T> lift(const Val &v) {
+    const Val *inner = v.get_option().value();
+    if (inner == nullptr) {
+      return std::nullopt;
+    }
+    return ComponentValue<T>::lift(*inner);
+  }
+};
+
+/// \brief The component model type `tuple<T...>`.
+template <typename... T> struct ComponentValue<std::tuple<T...>> {
+  /// \brief Returns whether `t` is a tuple of `T...`.
+  static bool typecheck(const ValType &t) {
+    if (!t.is_tuple() || t.tuple().types_count() != sizeof...(T)) {
+      return false;
+    }
+    size_t n = 0;
+    return (typecheck_nth<T>(t.tuple(), n++) && ...);
+  }
+
+  /// \brief Converts `v` to a `Val`.
+  static Val lower(const std::tuple<T...> &v) {
+    return std::apply(
+        [](const auto &...elems) {
+          return Tuple(std::vector<Val>{ComponentValue<T>::lower(elems)...});
+        },
+        v);
+  }
+
+  /// \brief Converts `v` back to a `std::tuple<T...>`.
+  static std::tuple<T...> lift(const Val &v) {
+    return lift(v.get_tuple(), std::index_sequence_for<T...>());
+  }
+
+private:
+  template <typename U>
+  static bool typecheck_nth(const TupleType &t, size_t n) {
+    auto ty = t.types_nth(n);
+    return ty && ComponentValue<U>::typecheck(*ty);
+  }
+
+  template <size_t... I>
+  static std::tuple<T...> lift(const Tuple &t, std::index_sequence<I...>) {
+    return std::tuple<T...>(ComponentValue<T>::lift(t.begin()[I])...);
+  }
+};
+
+namespace detail {
+
+/// Internal helper for the parameters of a `TypedFunc`, which must be a
+/// `std::tuple`.
+template <typename Params> struct ComponentParams;
+
+template <typename... T> struct ComponentParams<std::tuple<T...>> {
+  static bool typecheck(const FuncType &ty) {
+    if (ty.param_count() != sizeof...(T)) {
+      return false;
+    }
+    size_t n = 0;
+    return (typecheck_nth<T>(ty, n++) && ...);
+  }
+
+  template <typename U>
+  static bool typecheck_nth(const FuncType &ty, size_t n) {
+    auto param = ty.param_nth(n);
+    return param && ComponentValue<U>::typecheck(param->second);
+  }
+
+  static std::vector<Val> lower(const std::tuple<T...> &params) {
+    std::vector<Val> args;
+    args.reserve(sizeof...(T));
+    std::apply(
+        [&](const auto &...param) {
+          (args.push_back(ComponentValue<T>::lower(param)), ...);
+        },
+        params);
+    return args;
+  }
+
+  static std::tuple<T...> lift(const Val *args) {
+    return lift(args, std::index_sequence_for<T...>());
+  }
+
+  template <size_t... I>
+  static std::tuple<T...> lift(const Val *args, std::index_sequence<I...>) {
+    (void)args;
+    return std::tuple<T...>(ComponentValue<T>::lift(args[I])...);
+  }
+};
+
+/// Internal helper for the result of a `TypedFunc`, where `std::monostate`
+/// means that there's no result.
+template <typename Results> struct ComponentResults {
+  static constexpr size_t size = 1;
+  static bool typecheck(const std::optional<ValType> &ty) {
+    return ty && ComponentValue<Results>::typecheck(*ty);
+  }
+  static Results lift(const Val &v) { return ComponentValue<Results>::lift(v); }
+};
+
+template <> struct ComponentResults<std::monostate> {
+  static constexpr size_t size = 0;
+  static bool typecheck(const std::optional<ValType> &ty) { return !ty; }
+  static std::monostate lift(const Val &v) {
+    (void)v;
+    return std::monostate();
+  }
+};
+
+} // namespace detail
+
+/**
+ * \brief The results of a call made with `Func::call_lazy`, which are read
+ * from the guest as they're accessed.
+ *
+ * This is only valid within the callback passed to `Func::call_lazy`.
+ */
+class LazyResults {
+  wasmtime_component_lazy_results_t *ptr;
+
+public:
+  /// \brief Wraps the C API results, which this doesn't own.
+  explicit LazyResults(wasmtime_component_lazy_results_t *ptr) : ptr(ptr) {}
+
+  /// \brief Returns the number of results.
+  size_t size() const { return wasmtime_component_lazy_results_len(ptr); }
+
+  /// \brief Reads the entire result at `index`.
+  Result<Val> get(size_t index) {
+    wasmtime_component_val_t raw;
+    wasmtime_error_t *error =
+        wasmtime_component_lazy_results_get(ptr, index, &raw);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return Val(std::move(raw));
+  }
+
+  /// \brief Returns the length of the `list<T>` result at `index`.
+  Result<size_t> list_size(size_t index) {
+    size_t len = 0;
+    wasmtime_error_t *error =
+        wasmtime_component_lazy_results_list_len(ptr, index, &len);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return len;
+  }
+
+  /// \brief Reads the element at `elem_index` of the `list<T>` result at
+  /// `index`.
+  Result<Val> list_get(size_t index, size_t elem_index) {
+    wasmtime_component_val_t raw;
+    wasmtime_error_t *error =
+        wasmtime_component_lazy_results_list_get(ptr, index, elem_index, &raw);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return Val(std::move(raw));
+  }
+};
+
+// forward-declaration for `Func::typed` below.
+template <typename Params, typename Results> class TypedFunc;
+
 /**
  * \brief Class representing an instantiated WebAssembly component.
  */
@@ -44,6 +337,30 @@ public:
     return std::monostate();
   }
 
+  /**
+   * \brief Invokes this component function with the provided `args`, and
+   * passes its results to `f` as `LazyResults` which are read from the guest
+   * as they're accessed.
+   *
+   * This avoids converting large results, such as long lists, to `Val`s all
+   * at once. The results are only valid until `f` returns, and an error
+   * returned by `f` fails the call.
+   */
+  template <typename F,
+            std::enable_if_t<
+                std::is_invocable_r_v<Result<std::monostate>, F, LazyResults &>,
+                bool> = true>
+  Result<std::monostate> call_lazy(Store::Context cx, Span<const Val> args,
+                                   F &&f) const {
+    wasmtime_error_t *error = wasmtime_component_func_call_lazy(
+        &func, cx.capi(), Val::to_capi(args.data()), args.size(),
+        raw_lazy_callback<std::remove_reference_t<F>>, &f);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::monostate();
+  }
+
   /**
    * \brief Invokes the `post-return` canonical ABI option, if specified.
    */
@@ -60,8 +377,83 @@ public:
   FuncType type(Store::Context cx) const {
     return FuncType(wasmtime_component_func_type(&func, cx.capi()));
   }
+
+  /**
+   * \brief Statically checks this function against the provided types.
+   *
+   * The `Params` of the function must be a `std::tuple` of its parameter
+   * types, and `Results` is the type of its result, or `std::monostate` if it
+   * has none. Each type must have a specialization of `ComponentValue`.
+   *
+   * The function's type is checked once here, rather than on every call, and
+   * an error is returned if it doesn't match. The returned `TypedFunc` can
+   * then be called with C++ values directly.
+   */
+  template <typename Params, typename Results>
+  Result<TypedFunc<Params, Results>> typed(Store::Context cx) const;
+
+private:
+  template <typename F>
+  static wasmtime_error_t *
+  raw_lazy_callback(void *env, wasmtime_component_lazy_results_t *results) {
+    F *func = reinterpret_cast<F *>(env);
+    LazyResults lazy(results);
+    Result<std::monostate> result = (*func)(lazy);
+    if (!result) {
+      return result.err().capi_release();
+    }
+    return nullptr;
+  }
 };
 
+/**
+ * \brief A version of a component `Func` whose type is statically known.
+ *
+ * Created with `Func::typed`, see `ComponentValue` for the supported types.
+ */
+template <typename Params, typename Results> class TypedFunc {
+  static_assert(!std::is_same_v<Results, std::string_view>,
+                "the result of a typed function can't borrow from it");
+
+  friend class Func;
+  Func f;
+  TypedFunc(Func func) : f(func) {}
+
+public:
+  /**
+   * \brief Calls this function with the provided parameters.
+   *
+   * This is akin to `Func::call` except that parameters are converted from,
+   * and the result is converted to, C++ values. Note that this may still
+   * return an error if the function traps.
+   */
+  Result<Results> call(Store::Context cx, const Params &params) const {
+    std::vector<Val> args = detail::ComponentParams<Params>::lower(params);
+    Val result(false);
+    constexpr size_t nresults = detail::ComponentResults<Results>::size;
+    auto ret = f.call(cx, Span<const Val>(args.data(), args.size()),
+                      Span<Val>(&result, nresults));
+    if (!ret) {
+      return ret.err();
+    }
+    return detail::ComponentResults<Results>::lift(result);
+  }
+
+  /// Returns the underlying un-typed `Func` for this function.
+  const Func &func() const { return f; }
+};
+
+template <typename Params, typename Results>
+inline Result<TypedFunc<Params, Results>>
+Func::typed(Store::Context cx) const {
+  FuncType ty = type(cx);
+  if (!detail::ComponentParams<Params>::typecheck(ty) ||
+      !detail::ComponentResults<Results>::typecheck(ty.result())) {
+    return Error("static type for this function does not match actual type");
+  }
+  return TypedFunc<Params, Results>(*this);
+}
+
 } // namespace component
 } // namespace wasmtime
 
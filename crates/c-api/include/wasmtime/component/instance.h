@@ -3,9 +3,11 @@
 #ifndef WASMTIME_COMPONENT_INSTANCE_H
 #define WASMTIME_COMPONENT_INSTANCE_H
 
+#include <wasmtime/async.h>
 #include <wasmtime/component/component.h>
 #include <wasmtime/component/func.h>
 #include <wasmtime/conf.h>
+#include <wasmtime/error.h>
 #include <wasmtime/store.h>
 
 #ifdef WASMTIME_FEATURE_COMPONENT_MODEL
@@ -60,6 +62,119 @@ WASM_API_EXTERN bool wasmtime_component_instance_get_func(
     const wasmtime_component_export_index_t *export_index,
     wasmtime_component_func_t *func_out);
 
+/**
+ * \brief Configures whether string and list arguments of calls to the exports
+ * of \p instance are lowered into guest memory that's reused across calls.
+ *
+ * When enabled the guest's `realloc` is only called when more memory is
+ * needed than previous calls used, rather than once per argument. This is
+ * only correct for guests which neither free nor retain their arguments past
+ * the end of a call. This is disabled by default.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/component/struct.Instance.html#method.set_argument_scratch
+ *
+ * \param instance the instance to configure
+ * \param context the store that \p instance lives in
+ * \param enable whether to reuse memory for arguments
+ */
+WASM_API_EXTERN void wasmtime_component_instance_set_argument_scratch(
+    const wasmtime_component_instance_t *instance, wasmtime_context_t *context,
+    bool enable);
+
+/**
+ * \typedef wasmtime_component_instance_pre_t
+ * \brief Convenience alias for #wasmtime_component_instance_pre
+ *
+ * \struct wasmtime_component_instance_pre
+ * \brief A component which has had all of its imports resolved and
+ * type-checked by a linker, ready to be instantiated.
+ *
+ * Instantiating a #wasmtime_component_instance_pre_t only needs to create the
+ * instance within a store, skipping the name resolution of the component's
+ * imports performed by #wasmtime_component_linker_instantiate. All imports
+ * must therefore be defined independently of any store. A
+ * #wasmtime_component_instance_pre_t is safe to share between threads.
+ *
+ * Created with #wasmtime_component_linker_instantiate_pre and deleted with
+ * #wasmtime_component_instance_pre_delete.
+ *
+ * For more information see the Rust documentation:
+ * https://docs.wasmtime.dev/api/wasmtime/component/struct.InstancePre.html
+ */
+typedef struct wasmtime_component_instance_pre
+    wasmtime_component_instance_pre_t;
+
+/**
+ * \brief Creates a new reference to the same pre-instantiated component.
+ *
+ * The returned value must be deleted with
+ * #wasmtime_component_instance_pre_delete.
+ */
+WASM_API_EXTERN wasmtime_component_instance_pre_t *
+wasmtime_component_instance_pre_clone(
+    const wasmtime_component_instance_pre_t *instance_pre);
+
+/**
+ * \brief Deletes a #wasmtime_component_instance_pre_t.
+ */
+WASM_API_EXTERN void wasmtime_component_instance_pre_delete(
+    wasmtime_component_instance_pre_t *instance_pre);
+
+/**
+ * \brief Instantiates the pre-instantiated component within a store.
+ *
+ * \param instance_pre the component to instantiate
+ * \param context the #wasmtime_context_t in which the instance should be
+ *        created
+ * \param instance_out on success, the instantiated
+ *        #wasmtime_component_instance_t
+ *
+ * \return `NULL` on success, otherwise an error describing why instantiation
+ *         failed.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_component_instance_pre_instantiate(
+    const wasmtime_component_instance_pre_t *instance_pre,
+    wasmtime_context_t *context, wasmtime_component_instance_t *instance_out);
+
+/**
+ * \brief Returns the component that \p instance_pre instantiates.
+ *
+ * The returned component is owned by the caller and must be deleted with
+ * #wasmtime_component_delete.
+ */
+WASM_API_EXTERN wasmtime_component_t *wasmtime_component_instance_pre_component(
+    const wasmtime_component_instance_pre_t *instance_pre);
+
+#ifdef WASMTIME_FEATURE_ASYNC
+
+/**
+ * \brief Instantiates the pre-instantiated component within a store using
+ * async instantiation.
+ *
+ * This is the async version of #wasmtime_component_instance_pre_instantiate,
+ * see #wasmtime_linker_instantiate_async for more information on async
+ * instantiation.
+ *
+ * \param instance_pre the component to instantiate
+ * \param context the store in which to create the instance
+ * \param instance_out where to store the returned instance
+ * \param error_ret where to store the returned error, if any
+ *
+ * The `error_ret` pointer may *not* be `NULL` and the returned memory is owned
+ * by the caller.
+ *
+ * All arguments to this function must outlive the returned future and be
+ * unmodified until the future is deleted.
+ */
+WASM_API_EXTERN wasmtime_call_future_t *
+wasmtime_component_instance_pre_instantiate_async(
+    const wasmtime_component_instance_pre_t *instance_pre,
+    wasmtime_context_t *context, wasmtime_component_instance_t *instance_out,
+    wasmtime_error_t **error_ret);
+
+#endif // WASMTIME_FEATURE_ASYNC
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -58,10 +58,56 @@ public:
     return Func(ret);
   }
 
+  /// \brief Configures whether string and list arguments of calls to this
+  /// instance's exports are lowered into guest memory that's reused across
+  /// calls.
+  ///
+  /// See `wasmtime_component_instance_set_argument_scratch` for more
+  /// information.
+  void set_argument_scratch(Store::Context cx, bool enable) const {
+    wasmtime_component_instance_set_argument_scratch(&instance, cx.capi(),
+                                                     enable);
+  }
+
   /// \brief Returns the underlying C API pointer.
   const wasmtime_component_instance_t *capi() const { return &instance; }
 };
 
+/**
+ * \brief A component which has had all of its imports resolved, ready to be
+ * instantiated.
+ *
+ * An `InstancePre` is created with `Linker::instantiate_pre` which performs
+ * all of the name resolution and type-checking of a component's imports up
+ * front. Repeatedly instantiating the component, for example into a fresh
+ * `Store` per request, then only needs to create the instance itself.
+ *
+ * Copies of an `InstancePre` share the same underlying state, and an
+ * `InstancePre` can be used concurrently from multiple threads.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/component/struct.InstancePre.html
+ */
+class InstancePre {
+  WASMTIME_CLONE_WRAPPER(InstancePre, wasmtime_component_instance_pre);
+
+  /// \brief Instantiates the component within the store `cx`.
+  Result<Instance> instantiate(Store::Context cx) const {
+    wasmtime_component_instance_t ret;
+    wasmtime_error_t *error = wasmtime_component_instance_pre_instantiate(
+        ptr.get(), cx.capi(), &ret);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return Instance(ret);
+  }
+
+  /// \brief Returns the component that this pre-instantiation instantiates.
+  Component component() const {
+    return Component(wasmtime_component_instance_pre_component(ptr.get()));
+  }
+};
+
 } // namespace component
 } // namespace wasmtime
 
@@ -76,6 +76,27 @@ WASM_API_EXTERN wasmtime_error_t *wasmtime_component_linker_instantiate(
     const wasmtime_component_t *component,
     wasmtime_component_instance_t *instance_out);
 
+/**
+ * \brief Performs all name resolution and type-checking required to
+ * instantiate \p component with \p linker.
+ *
+ * The returned #wasmtime_component_instance_pre_t can then be instantiated
+ * many times without resolving the component's imports again. Definitions
+ * added to \p linker afterwards don't affect it.
+ *
+ * \param linker the linker providing the component's imports
+ * \param component the #wasmtime_component_t to pre-instantiate
+ * \param instance_pre_out on success, the pre-instantiated component, which
+ *        must be deleted with #wasmtime_component_instance_pre_delete
+ *
+ * \return `NULL` on success, otherwise an error describing why the
+ *         component's imports couldn't be resolved.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_component_linker_instantiate_pre(
+    const wasmtime_component_linker_t *linker,
+    const wasmtime_component_t *component,
+    wasmtime_component_instance_pre_t **instance_pre_out);
+
 /**
  * \brief Defines all unknown imports of `component` as trapping functions.
  */
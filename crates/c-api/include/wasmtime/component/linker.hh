@@ -9,6 +9,10 @@
 
 #include <memory>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <wasmtime/component/func.hh>
 #include <wasmtime/component/instance.hh>
 #include <wasmtime/component/linker.h>
 #include <wasmtime/component/val.hh>
@@ -107,6 +111,47 @@ public:
     return std::monostate();
   }
 
+  /**
+   * \brief Defines a function within this linker instance whose parameters
+   * and result are C++ values.
+   *
+   * As with `Func::typed`, `Params` is a `std::tuple` of the parameter types
+   * and `Results` is the type of the result, or `std::monostate` if there's
+   * none. The function `f` is invoked with a `Store::Context` followed by each
+   * parameter, and returns a `Result<Results>`. See `ComponentValue` for the
+   * supported types.
+   *
+   * The type of a host function is determined by the component which imports
+   * it, so it's checked against `Params` and `Results` when it's called, and
+   * a mismatch traps. After that the arguments are converted without needing
+   * to inspect each `Val`, and `std::string_view` parameters borrow the
+   * argument's string rather than copying it.
+   */
+  template <typename Params, typename Results, typename F>
+  Result<std::monostate> add_func(std::string_view name, F &&f) {
+    using Fn = std::remove_cv_t<std::remove_reference_t<F>>;
+    return add_func(
+        name, [f = Fn(std::forward<F>(f))](
+                  Store::Context cx, const FuncType &ty, Span<Val> args,
+                  Span<Val> results) mutable -> Result<std::monostate> {
+          if (!detail::ComponentParams<Params>::typecheck(ty) ||
+              !detail::ComponentResults<Results>::typecheck(ty.result())) {
+            return Error("host function type does not match its static type");
+          }
+          auto params = detail::ComponentParams<Params>::lift(args.data());
+          Result<Results> ret = std::apply(
+              [&](auto &...param) { return f(cx, std::move(param)...); },
+              params);
+          if (!ret) {
+            return ret.err();
+          }
+          if constexpr (!std::is_same_v<Results, std::monostate>) {
+            results[0] = ComponentValue<Results>::lower(ret.ok());
+          }
+          return std::monostate();
+        });
+  }
+
 private:
   template <typename F>
   static wasmtime_error_t *
@@ -198,6 +243,19 @@ class Linker {
     return Instance(ret);
   }
 
+  /// \brief Performs all name resolution and type-checking required to
+  /// instantiate `component` with this linker, returning an `InstancePre`
+  /// which can be cheaply instantiated many times.
+  Result<InstancePre> instantiate_pre(const Component &component) const {
+    wasmtime_component_instance_pre_t *ret = nullptr;
+    wasmtime_error_t *error = wasmtime_component_linker_instantiate_pre(
+        ptr.get(), component.capi(), &ret);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return InstancePre(ret);
+  }
+
 #ifdef WASMTIME_FEATURE_WASI
   /**
    * \brief Adds WASIp2 API definitions to this linker.
@@ -25,6 +25,15 @@ WASM_API_EXTERN
 wasmtime_component_func_type_t *
 wasmtime_component_func_type_clone(const wasmtime_component_func_type_t *ty);
 
+/// \brief Compares two component function types for equality.
+///
+/// This is a constant-time comparison for types retrieved from the same
+/// component, and otherwise compares the types' parameters and results.
+WASM_API_EXTERN
+bool wasmtime_component_func_type_equal(
+    const wasmtime_component_func_type_t *a,
+    const wasmtime_component_func_type_t *b);
+
 /// \brief Deallocates a component instance type.
 WASM_API_EXTERN
 void wasmtime_component_func_type_delete(wasmtime_component_func_type_t *ty);
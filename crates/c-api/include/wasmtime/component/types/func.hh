@@ -19,7 +19,7 @@ namespace component {
  * \brief Type information about a component function.
  */
 class FuncType {
-  WASMTIME_CLONE_WRAPPER(FuncType, wasmtime_component_func_type);
+  WASMTIME_CLONE_EQUAL_WRAPPER(FuncType, wasmtime_component_func_type);
 
   /// Returns the number of parameters of this component function type.
   size_t param_count() const {
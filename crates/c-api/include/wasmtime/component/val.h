@@ -10,6 +10,8 @@
 #include <stdint.h>
 #include <wasm.h>
 #include <wasmtime/component/types/resource.h>
+#include <wasmtime/component/types/val.h>
+#include <wasmtime/error.h>
 #include <wasmtime/store.h>
 
 #ifdef __cplusplus
@@ -89,6 +91,16 @@ WASM_API_EXTERN
 wasmtime_error_t *wasmtime_component_resource_any_drop(
     wasmtime_context_t *ctx, const wasmtime_component_resource_any_t *resource);
 
+/// \brief Drops each of the `len` resources in `resources`, as with
+/// `wasmtime_component_resource_any_drop`.
+///
+/// Resources are dropped in order. If dropping one of them fails then the
+/// error is returned and the remaining resources aren't dropped.
+WASM_API_EXTERN
+wasmtime_error_t *wasmtime_component_resource_any_drop_many(
+    wasmtime_context_t *ctx,
+    const wasmtime_component_resource_any_t *const *resources, size_t len);
+
 /// \brief Deallocates a component resource.
 ///
 /// This function deallocates any host-side memory associated with this
@@ -197,6 +209,18 @@ wasmtime_error_t *wasmtime_component_resource_host_to_any(
     wasmtime_context_t *ctx, const wasmtime_component_resource_host_t *resource,
     wasmtime_component_resource_any_t **ret);
 
+/// \brief Converts each of the `len` resources in `resources`, as with
+/// `wasmtime_component_resource_host_to_any`.
+///
+/// On success `len` resources are written to `ret`, each of which must be
+/// deallocated with `wasmtime_component_resource_any_delete`. If an error is
+/// returned then `ret` is not modified.
+WASM_API_EXTERN
+wasmtime_error_t *wasmtime_component_resource_host_to_any_many(
+    wasmtime_context_t *ctx,
+    const wasmtime_component_resource_host_t *const *resources, size_t len,
+    wasmtime_component_resource_any_t **ret);
+
 /// \brief Discriminant used in #wasmtime_component_val_t::kind
 typedef uint8_t wasmtime_component_valkind_t;
 
@@ -266,6 +290,21 @@ typedef uint8_t wasmtime_component_valkind_t;
 /// \brief Value of #wasmtime_component_valkind_t meaning that
 /// #wasmtime_component_val_t is a resource
 #define WASMTIME_COMPONENT_RESOURCE 21
+/// \brief Value of #wasmtime_component_valkind_t meaning that
+/// #wasmtime_component_val_t is a list of numbers stored contiguously
+#define WASMTIME_COMPONENT_FLAT_LIST 22
+/// \brief Value of #wasmtime_component_valkind_t meaning that
+/// #wasmtime_component_val_t is flags given as a bitmask
+#define WASMTIME_COMPONENT_FLAGS_MASK 23
+/// \brief Value of #wasmtime_component_valkind_t meaning that
+/// #wasmtime_component_val_t is an enum given by the index of its case
+#define WASMTIME_COMPONENT_ENUM_INDEX 24
+/// \brief Value of #wasmtime_component_valkind_t meaning that
+/// #wasmtime_component_val_t is a variant given by the index of its case
+#define WASMTIME_COMPONENT_VARIANT_INDEX 25
+/// \brief Value of #wasmtime_component_valkind_t meaning that
+/// #wasmtime_component_val_t is a record given by the values of its fields
+#define WASMTIME_COMPONENT_RECORD_VALUES 26
 
 struct wasmtime_component_val;
 struct wasmtime_component_valrecord_entry;
@@ -296,9 +335,62 @@ DECLARE_VEC(wasmtime_component_valrecord,
             struct wasmtime_component_valrecord_entry)
 DECLARE_VEC(wasmtime_component_valtuple, struct wasmtime_component_val)
 DECLARE_VEC(wasmtime_component_valflags, wasm_name_t)
+DECLARE_VEC(wasmtime_component_valflagsmask, uint32_t)
 
 #undef DECLARE_VEC
 
+/// \brief Represents a list of numbers, such as a `list<u8>`, whose elements
+/// are stored contiguously rather than as individual values.
+///
+/// This is an alternative to #wasmtime_component_vallist_t for lists whose
+/// elements are all of the kind #wasmtime_component_valflatlist_t::kind,
+/// which must be one of #WASMTIME_COMPONENT_S8 through
+/// #WASMTIME_COMPONENT_F64. This avoids a #wasmtime_component_val_t per
+/// element, so for example a `list<u8>` can be created with a single copy of
+/// its bytes.
+///
+/// Flat lists are accepted anywhere a value is passed to Wasmtime, such as
+/// the arguments of #wasmtime_component_func_call or the results of a host
+/// function. Values produced by Wasmtime always represent lists with
+/// #WASMTIME_COMPONENT_LIST.
+///
+/// Flat lists must be created by one of the `wasmtime_component_valflatlist_*`
+/// functions below, and deallocated with
+/// #wasmtime_component_valflatlist_delete.
+typedef struct wasmtime_component_valflatlist {
+  /// The kind of every element of the list
+  wasmtime_component_valkind_t kind;
+  /// The number of elements in the list
+  size_t size;
+  /// Pointer to the elements, an array of `size` values of the C type for
+  /// `kind`, for example `uint8_t` for #WASMTIME_COMPONENT_U8
+  void *data;
+} wasmtime_component_valflatlist_t;
+
+/// \brief Creates a flat list of `size` elements of `kind`, copied from
+/// `data`.
+///
+/// The `data` pointer must point to `size` values of the C type for `kind`.
+WASM_API_EXTERN void
+wasmtime_component_valflatlist_new(wasmtime_component_valflatlist_t *out,
+                                   wasmtime_component_valkind_t kind,
+                                   size_t size, const void *data);
+
+/// \brief Creates a flat list of `size` zero-initialized elements of `kind`.
+WASM_API_EXTERN void
+wasmtime_component_valflatlist_new_uninit(wasmtime_component_valflatlist_t *out,
+                                          wasmtime_component_valkind_t kind,
+                                          size_t size);
+
+/// \brief Copies the flat list `src` to `dst`.
+WASM_API_EXTERN void wasmtime_component_valflatlist_copy(
+    wasmtime_component_valflatlist_t *dst,
+    const wasmtime_component_valflatlist_t *src);
+
+/// \brief Deallocates the elements of the flat list `value`.
+WASM_API_EXTERN void
+wasmtime_component_valflatlist_delete(wasmtime_component_valflatlist_t *value);
+
 /// Represents a variant type
 typedef struct {
   /// The discriminant of the variant
@@ -307,6 +399,26 @@ typedef struct {
   struct wasmtime_component_val *val;
 } wasmtime_component_valvariant_t;
 
+/// \brief Represents a variant whose case is identified by its index in the
+/// variant's type rather than by its name.
+///
+/// This, along with #WASMTIME_COMPONENT_ENUM_INDEX and
+/// #WASMTIME_COMPONENT_FLAGS_MASK, avoids allocating and comparing the names
+/// of cases and flags. Like flat lists these kinds are accepted anywhere a
+/// value is passed to Wasmtime, where the names are looked up in the type that
+/// the value is expected to have. Values produced by Wasmtime always identify
+/// cases and flags by name. The name of a case can be looked up on demand
+/// with, for example, #wasmtime_component_enum_type_names_nth.
+///
+/// For #WASMTIME_COMPONENT_FLAGS_MASK the flag at index `i` in the type is
+/// set if bit `i % 32` of element `i / 32` of the mask is set.
+typedef struct {
+  /// The index of the case of the variant
+  uint32_t discriminant;
+  /// The payload of the variant
+  struct wasmtime_component_val *val;
+} wasmtime_component_valvariantindex_t;
+
 /// Represents a result type
 typedef struct {
   /// The discriminant of the result
@@ -369,6 +481,28 @@ typedef union {
   /// Field used if #wasmtime_component_val_t::kind is
   /// #WASMTIME_COMPONENT_RESOURCE
   wasmtime_component_resource_any_t *resource;
+  /// Field used if #wasmtime_component_val_t::kind is
+  /// #WASMTIME_COMPONENT_FLAT_LIST
+  wasmtime_component_valflatlist_t flat_list;
+  /// Field used if #wasmtime_component_val_t::kind is
+  /// #WASMTIME_COMPONENT_FLAGS_MASK
+  wasmtime_component_valflagsmask_t flags_mask;
+  /// Field used if #wasmtime_component_val_t::kind is
+  /// #WASMTIME_COMPONENT_ENUM_INDEX
+  uint32_t enum_index;
+  /// Field used if #wasmtime_component_val_t::kind is
+  /// #WASMTIME_COMPONENT_VARIANT_INDEX
+  wasmtime_component_valvariantindex_t variant_index;
+  /// Field used if #wasmtime_component_val_t::kind is
+  /// #WASMTIME_COMPONENT_RECORD_VALUES
+  ///
+  /// The values of the record's fields in the order that the fields are
+  /// declared in its type, without their names. Like
+  /// #WASMTIME_COMPONENT_VARIANT_INDEX this is only accepted where a value is
+  /// passed to Wasmtime, and records produced by Wasmtime are always
+  /// #WASMTIME_COMPONENT_RECORD. The names of the fields can be looked up
+  /// with #wasmtime_component_record_type_field_nth.
+  wasmtime_component_valtuple_t record_values;
 } wasmtime_component_valunion_t;
 
 /// \brief Represents possible runtime values which a component function can
@@ -437,6 +571,39 @@ wasmtime_component_val_clone(const wasmtime_component_val_t *src,
 WASM_API_EXTERN void
 wasmtime_component_val_delete(wasmtime_component_val_t *value);
 
+/// \brief Encodes `val`, which has the type `ty`, in a compact binary format
+/// and writes it into `buf`.
+///
+/// The encoding is directed by `ty` so it doesn't contain any type
+/// information, such as record field names, and it must be decoded with
+/// `wasmtime_component_val_decode` and the same type. Integers are encoded
+/// with LEB128, floats as little-endian bytes, strings and lists as a length
+/// followed by their contents, and cases of variants, enums, options and
+/// results by their index.
+///
+/// On success `len_ret` is set to the length of the encoding. If that's
+/// larger than `buf_len` then only part of the encoding was written to `buf`
+/// and this should be called again with a buffer of at least `*len_ret`
+/// bytes.
+///
+/// Returns an error if `val` doesn't have the type `ty`, or if it contains a
+/// resource, future, stream or error context, which can't be encoded.
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_component_val_encode(const wasmtime_component_val_t *val,
+                              const wasmtime_component_valtype_t *ty,
+                              uint8_t *buf, size_t buf_len, size_t *len_ret);
+
+/// \brief Decodes a value of type `ty` from the `len` bytes at `buf`, which
+/// were produced by `wasmtime_component_val_encode`.
+///
+/// On success the value is stored in `val_ret`, which must have
+/// `wasmtime_component_val_delete` run to discard it. Returns an error if
+/// `buf` isn't exactly the encoding of a value of type `ty`.
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_component_val_decode(const wasmtime_component_valtype_t *ty,
+                              const uint8_t *buf, size_t len,
+                              wasmtime_component_val_t *val_ret);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -15,6 +15,7 @@
 #include <vector>
 #include <wasmtime/component/types/val.hh>
 #include <wasmtime/component/val.h>
+#include <wasmtime/span.hh>
 #include <wasmtime/store.hh>
 
 namespace wasmtime {
@@ -205,6 +206,111 @@ public:
   }
 };
 
+namespace detail {
+
+/// Internal helper to map the element types of `FlatList` to the kind of
+/// their values.
+template <typename T> struct flat_list_kind;
+
+#define FLAT_LIST_KIND(ty, kind)                                               \
+  template <> struct flat_list_kind<ty> {                                      \
+    static constexpr wasmtime_component_valkind_t value = kind;                \
+  };
+
+FLAT_LIST_KIND(int8_t, WASMTIME_COMPONENT_S8)
+FLAT_LIST_KIND(uint8_t, WASMTIME_COMPONENT_U8)
+FLAT_LIST_KIND(int16_t, WASMTIME_COMPONENT_S16)
+FLAT_LIST_KIND(uint16_t, WASMTIME_COMPONENT_U16)
+FLAT_LIST_KIND(int32_t, WASMTIME_COMPONENT_S32)
+FLAT_LIST_KIND(uint32_t, WASMTIME_COMPONENT_U32)
+FLAT_LIST_KIND(int64_t, WASMTIME_COMPONENT_S64)
+FLAT_LIST_KIND(uint64_t, WASMTIME_COMPONENT_U64)
+FLAT_LIST_KIND(float, WASMTIME_COMPONENT_F32)
+FLAT_LIST_KIND(double, WASMTIME_COMPONENT_F64)
+
+#undef FLAT_LIST_KIND
+
+} // namespace detail
+
+/// \brief Class representing a component model list of numbers, such as a
+/// `list<u8>`, whose elements are stored contiguously.
+///
+/// Unlike `List` this doesn't create a `Val` per element, so a list can be
+/// created with a single copy of its elements. Flat lists can be passed to
+/// Wasmtime anywhere a `List` can, but lists produced by Wasmtime are always
+/// a `List`. Aliases such as `ListU8` are provided for each element type.
+template <typename T> class FlatList {
+  friend class Val;
+
+  VAL_REPR(FlatList, wasmtime_component_valflatlist_t);
+
+  static constexpr wasmtime_component_valkind_t kind =
+      detail::flat_list_kind<T>::value;
+
+  static void transfer(Raw &&from, Raw &to) {
+    to = from;
+    from.size = 0;
+    from.data = nullptr;
+  }
+
+  void copy(const Raw &other) {
+    wasmtime_component_valflatlist_copy(&raw, &other);
+  }
+
+  void destroy() { wasmtime_component_valflatlist_delete(&raw); }
+
+public:
+  /// Creates a new list with a copy of `elems`.
+  FlatList(Span<const T> elems) {
+    wasmtime_component_valflatlist_new(&raw, kind, elems.size(), elems.data());
+  }
+
+  /// Creates a new list with a copy of `elems`.
+  FlatList(const std::vector<T> &elems)
+      : FlatList(Span<const T>(elems.data(), elems.size())) {}
+
+  /// Creates a new list of `size` zeros, to be filled in through `data()`.
+  explicit FlatList(size_t size) {
+    wasmtime_component_valflatlist_new_uninit(&raw, kind, size);
+  }
+
+  /// \brief Returns the number of elements in the list.
+  size_t size() const { return raw.size; }
+
+  /// \brief Returns a pointer to the elements of the list.
+  const T *data() const { return static_cast<const T *>(raw.data); }
+
+  /// \brief Returns a pointer to the elements of the list.
+  T *data() { return static_cast<T *>(raw.data); }
+
+  /// \brief Returns an iterator to the beginning of the list.
+  const T *begin() const { return data(); }
+
+  /// \brief Returns an iterator to the end of the list.
+  const T *end() const { return data() + size(); }
+};
+
+/// \brief A flat `list<s8>`.
+using ListS8 = FlatList<int8_t>;
+/// \brief A flat `list<u8>`.
+using ListU8 = FlatList<uint8_t>;
+/// \brief A flat `list<s16>`.
+using ListS16 = FlatList<int16_t>;
+/// \brief A flat `list<u16>`.
+using ListU16 = FlatList<uint16_t>;
+/// \brief A flat `list<s32>`.
+using ListS32 = FlatList<int32_t>;
+/// \brief A flat `list<u32>`.
+using ListU32 = FlatList<uint32_t>;
+/// \brief A flat `list<s64>`.
+using ListS64 = FlatList<int64_t>;
+/// \brief A flat `list<u64>`.
+using ListU64 = FlatList<uint64_t>;
+/// \brief A flat `list<f32>`.
+using ListF32 = FlatList<float>;
+/// \brief A flat `list<f64>`.
+using ListF64 = FlatList<double>;
+
 /// \brief Class representing a component model tuple.
 class Tuple {
   friend class Val;
@@ -239,6 +345,45 @@ public:
   }
 };
 
+/// Class representing a component model `record` value given by the values of
+/// its fields, in the order the fields are declared in its type.
+///
+/// Unlike `Record` this doesn't allocate the name of each field. Values
+/// produced by Wasmtime always use `Record`, and the name of a field can be
+/// looked up with `RecordType::field_nth`.
+class RecordValues {
+  friend class Val;
+
+  VAL_REPR(RecordValues, wasmtime_component_valtuple_t);
+
+  static void transfer(Raw &&from, Raw &to) {
+    to = from;
+    from.size = 0;
+    from.data = nullptr;
+  }
+
+  void copy(const Raw &other) {
+    wasmtime_component_valtuple_copy(&raw, &other);
+  }
+
+  void destroy() { wasmtime_component_valtuple_delete(&raw); }
+
+public:
+  /// Creates a new record from the values of its fields.
+  RecordValues(std::vector<Val> values);
+
+  /// \brief Returns the number of fields in the record.
+  size_t size() const { return raw.size; }
+
+  /// \brief Returns an iterator to the beginning of the fields.
+  const Val *begin() const { return reinterpret_cast<const Val *>(raw.data); }
+
+  /// \brief Returns an iterator to the end of the fields.
+  const Val *end() const {
+    return reinterpret_cast<const Val *>(raw.data + raw.size);
+  }
+};
+
 /// Class representing a component model `variant` value.
 class Variant {
   friend class Val;
@@ -282,6 +427,47 @@ public:
   const Val *value() const { return detail::val_from_capi(raw.val); }
 };
 
+/// Class representing a component model `variant` value whose case is
+/// identified by its index in the variant's type.
+///
+/// Unlike `Variant` this doesn't allocate the name of the case. Values
+/// produced by Wasmtime always use `Variant`, and the name of a case can be
+/// looked up with `VariantType::case_nth`.
+class VariantIndex {
+  friend class Val;
+
+  VAL_REPR(VariantIndex, wasmtime_component_valvariantindex_t);
+
+  static void transfer(Raw &&from, Raw &to) {
+    to = from;
+    from.val = nullptr;
+  }
+
+  void copy(const Raw &other) {
+    raw.discriminant = other.discriminant;
+    if (other.val) {
+      wasmtime_component_val_t clone;
+      wasmtime_component_val_clone(other.val, &clone);
+      raw.val = wasmtime_component_val_new(&clone);
+    } else {
+      raw.val = nullptr;
+    }
+  }
+
+  void destroy() { wasmtime_component_val_free(raw.val); }
+
+public:
+  /// Constructs a new variant value with the case at index `discriminant` and
+  /// the provided payload.
+  VariantIndex(uint32_t discriminant, std::optional<Val> x);
+
+  /// Returns the index of the case of this value.
+  uint32_t discriminant() const { return raw.discriminant; }
+
+  /// Returns the optional payload value associated with this variant value.
+  const Val *value() const { return detail::val_from_capi(raw.val); }
+};
+
 /// Class representing a component model `option` value.
 class WitOption {
   friend class Val;
@@ -417,6 +603,53 @@ public:
   }
 };
 
+/// Class representing a component model `flags` value as a bitmask of the
+/// indices of the flags in its type which are set.
+///
+/// Unlike `Flags` this doesn't allocate the name of each flag. Values produced
+/// by Wasmtime always use `Flags`, and the name of a flag can be looked up
+/// with `FlagsType::names_nth`.
+class FlagsMask {
+  friend class Val;
+
+  VAL_REPR(FlagsMask, wasmtime_component_valflagsmask_t);
+
+  static void transfer(Raw &&from, Raw &to) {
+    to = from;
+    from.size = 0;
+    from.data = nullptr;
+  }
+
+  void copy(const Raw &other) {
+    wasmtime_component_valflagsmask_copy(&raw, &other);
+  }
+
+  void destroy() { wasmtime_component_valflagsmask_delete(&raw); }
+
+public:
+  /// Creates a mask for a type with `count` flags, none of which are set.
+  explicit FlagsMask(size_t count) {
+    wasmtime_component_valflagsmask_new_uninit(&raw, (count + 31) / 32);
+  }
+
+  /// Sets the flag at index `i` in the type.
+  void set(size_t i) {
+    assert(i / 32 < raw.size);
+    raw.data[i / 32] |= uint32_t(1) << (i % 32);
+  }
+
+  /// Returns whether the flag at index `i` in the type is set.
+  bool test(size_t i) const {
+    return i / 32 < raw.size && (raw.data[i / 32] >> (i % 32)) & 1;
+  }
+
+  /// Returns the words of this mask, where the flag at index `i` is bit
+  /// `i % 32` of word `i / 32`.
+  Span<const uint32_t> words() const {
+    return Span<const uint32_t>(raw.data, raw.size);
+  }
+};
+
 class ResourceHost;
 
 /// Class representing a component model `resource` value which is either a
@@ -444,6 +677,24 @@ class ResourceAny {
     return std::monostate();
   }
 
+  /// \brief Drops each of `resources`, as with `drop`, with a single call
+  /// into Wasmtime.
+  ///
+  /// Stops at, and returns, the first error.
+  static Result<std::monostate> drop_all(Store::Context cx,
+                                         Span<const ResourceAny> resources) {
+    std::vector<const wasmtime_component_resource_any_t *> raw;
+    raw.reserve(resources.size());
+    for (const auto &resource : resources) {
+      raw.push_back(resource.capi());
+    }
+    wasmtime_error_t *err = wasmtime_component_resource_any_drop_many(
+        cx.capi(), raw.data(), raw.size());
+    if (err)
+      return Error(err);
+    return std::monostate();
+  }
+
   /// \brief Attempts to convert this resource to a host-defined resource.
   Result<ResourceHost> to_host(Store::Context cx) const;
 };
@@ -478,6 +729,85 @@ class ResourceHost {
       return Error(err);
     return ResourceAny(out);
   }
+
+  /// \brief Converts each of `resources` into a generic resource-any, as with
+  /// `to_any`, with a single call into Wasmtime.
+  static Result<std::vector<ResourceAny>>
+  to_any_all(Store::Context cx, Span<const ResourceHost> resources) {
+    std::vector<const wasmtime_component_resource_host_t *> raw;
+    raw.reserve(resources.size());
+    for (const auto &resource : resources) {
+      raw.push_back(resource.capi());
+    }
+    std::vector<wasmtime_component_resource_any_t *> out(raw.size());
+    wasmtime_error_t *err = wasmtime_component_resource_host_to_any_many(
+        cx.capi(), raw.data(), raw.size(), out.data());
+    if (err)
+      return Error(err);
+    std::vector<ResourceAny> ret;
+    ret.reserve(out.size());
+    for (auto *resource : out) {
+      ret.push_back(ResourceAny(resource));
+    }
+    return ret;
+  }
+};
+
+/**
+ * \brief A table of host objects which back host-defined resources, indexed by
+ * their "rep".
+ *
+ * Reps are allocated by `push`, which reuses the reps of removed objects, so
+ * they stay dense and finding the object for a `ResourceHost`, for example in
+ * its destructor, is a constant-time index into the table.
+ */
+template <typename T> class ResourceTable {
+  std::vector<std::optional<T>> entries;
+  std::vector<uint32_t> free;
+
+public:
+  /// \brief Inserts `value` into this table, returning its rep.
+  uint32_t push(T value) {
+    if (free.empty()) {
+      entries.emplace_back(std::move(value));
+      return static_cast<uint32_t>(entries.size() - 1);
+    }
+    uint32_t rep = free.back();
+    free.pop_back();
+    entries[rep].emplace(std::move(value));
+    return rep;
+  }
+
+  /// \brief Returns the object with the rep `rep`, or `nullptr` if there's
+  /// no such object.
+  T *get(uint32_t rep) {
+    if (rep >= entries.size() || !entries[rep]) {
+      return nullptr;
+    }
+    return &*entries[rep];
+  }
+
+  /// \brief Returns the object with the rep `rep`, or `nullptr` if there's
+  /// no such object.
+  const T *get(uint32_t rep) const {
+    return const_cast<ResourceTable *>(this)->get(rep);
+  }
+
+  /// \brief Removes the object with the rep `rep` from this table, returning
+  /// it if it was present.
+  std::optional<T> remove(uint32_t rep) {
+    T *value = get(rep);
+    if (value == nullptr) {
+      return std::nullopt;
+    }
+    std::optional<T> ret(std::move(*value));
+    entries[rep].reset();
+    free.push_back(rep);
+    return ret;
+  }
+
+  /// \brief Returns the number of objects in this table.
+  size_t size() const { return entries.size() - free.size(); }
 };
 
 inline Result<ResourceHost> ResourceAny::to_host(Store::Context cx) const {
@@ -494,6 +824,7 @@ inline Result<ResourceHost> ResourceAny::to_host(Store::Context cx) const {
  */
 class Val {
   friend class Variant;
+  friend class VariantIndex;
   friend class WitOption;
   friend class WitResult;
 
@@ -599,12 +930,24 @@ public:
     List::transfer(std::move(v.raw), raw.of.list);
   }
 
+  /// Creates a new list value from a flat list of numbers.
+  template <typename T> Val(FlatList<T> v) {
+    raw.kind = WASMTIME_COMPONENT_FLAT_LIST;
+    FlatList<T>::transfer(std::move(v.raw), raw.of.flat_list);
+  }
+
   /// Creates a new record value.
   Val(Record r) {
     raw.kind = WASMTIME_COMPONENT_RECORD;
     Record::transfer(std::move(r.raw), raw.of.record);
   }
 
+  /// Creates a new record value from the values of its fields.
+  Val(RecordValues r) {
+    raw.kind = WASMTIME_COMPONENT_RECORD_VALUES;
+    RecordValues::transfer(std::move(r.raw), raw.of.record_values);
+  }
+
   /// Creates a new tuple value.
   Val(Tuple v) {
     raw.kind = WASMTIME_COMPONENT_TUPLE;
@@ -617,6 +960,12 @@ public:
     Variant::transfer(std::move(v.raw), raw.of.variant);
   }
 
+  /// Creates a new variant value from the index of its case.
+  Val(VariantIndex v) {
+    raw.kind = WASMTIME_COMPONENT_VARIANT_INDEX;
+    VariantIndex::transfer(std::move(v.raw), raw.of.variant_index);
+  }
+
   /// Creates a new option value.
   Val(WitOption v) {
     raw.kind = WASMTIME_COMPONENT_OPTION;
@@ -638,12 +987,27 @@ public:
     return Val(std::move(raw));
   }
 
+  /// Creates a new enum value from the index of its case.
+  static Val enum_index(uint32_t discriminant) {
+    wasmtime_component_val_t raw = {
+        .kind = WASMTIME_COMPONENT_ENUM_INDEX,
+        .of = {.enum_index = discriminant},
+    };
+    return Val(std::move(raw));
+  }
+
   /// Creates a new flags value.
   Val(Flags f) {
     raw.kind = WASMTIME_COMPONENT_FLAGS;
     Flags::transfer(std::move(f.raw), raw.of.flags);
   }
 
+  /// Creates a new flags value from a bitmask.
+  Val(FlagsMask f) {
+    raw.kind = WASMTIME_COMPONENT_FLAGS_MASK;
+    FlagsMask::transfer(std::move(f.raw), raw.of.flags_mask);
+  }
+
   /// Creates a new resource value.
   Val(ResourceAny r) {
     raw.kind = WASMTIME_COMPONENT_RESOURCE;
@@ -767,6 +1131,18 @@ public:
     return *List::from_capi(&raw.of.list);
   }
 
+  /// \brief Returns whether this value is a flat list of `T`.
+  template <typename T> bool is_flat_list() const {
+    return raw.kind == WASMTIME_COMPONENT_FLAT_LIST &&
+           raw.of.flat_list.kind == FlatList<T>::kind;
+  }
+
+  /// \brief Returns the flat list value, only valid if `is_flat_list<T>()`.
+  template <typename T> const FlatList<T> &get_flat_list() const {
+    assert(is_flat_list<T>());
+    return *FlatList<T>::from_capi(&raw.of.flat_list);
+  }
+
   /// \brief Returns whether this value is a record.
   bool is_record() const { return raw.kind == WASMTIME_COMPONENT_RECORD; }
 
@@ -776,6 +1152,18 @@ public:
     return *Record::from_capi(&raw.of.record);
   }
 
+  /// \brief Returns whether this value is a record given by the values of its
+  /// fields.
+  bool is_record_values() const {
+    return raw.kind == WASMTIME_COMPONENT_RECORD_VALUES;
+  }
+
+  /// \brief Returns the record value, only valid if `is_record_values()`.
+  const RecordValues &get_record_values() const {
+    assert(is_record_values());
+    return *RecordValues::from_capi(&raw.of.record_values);
+  }
+
   /// \brief Returns whether this value is a tuple.
   bool is_tuple() const { return raw.kind == WASMTIME_COMPONENT_TUPLE; }
 
@@ -794,6 +1182,17 @@ public:
     return *Variant::from_capi(&raw.of.variant);
   }
 
+  /// \brief Returns whether this value is a variant given by case index.
+  bool is_variant_index() const {
+    return raw.kind == WASMTIME_COMPONENT_VARIANT_INDEX;
+  }
+
+  /// \brief Returns the variant value, only valid if `is_variant_index()`.
+  const VariantIndex &get_variant_index() const {
+    assert(is_variant_index());
+    return *VariantIndex::from_capi(&raw.of.variant_index);
+  }
+
   /// \brief Returns whether this value is an option.
   bool is_option() const { return raw.kind == WASMTIME_COMPONENT_OPTION; }
 
@@ -812,6 +1211,18 @@ public:
     return std::string_view(raw.of.enumeration.data, raw.of.enumeration.size);
   }
 
+  /// \brief Returns whether this value is an enum given by case index.
+  bool is_enum_index() const {
+    return raw.kind == WASMTIME_COMPONENT_ENUM_INDEX;
+  }
+
+  /// \brief Returns the index of the enum's case, only valid if
+  /// `is_enum_index()`.
+  uint32_t get_enum_index() const {
+    assert(is_enum_index());
+    return raw.of.enum_index;
+  }
+
   /// \brief Returns whether this value is a result.
   bool is_result() const { return raw.kind == WASMTIME_COMPONENT_RESULT; }
 
@@ -830,6 +1241,17 @@ public:
     return *Flags::from_capi(&raw.of.flags);
   }
 
+  /// \brief Returns whether this value is flags given as a bitmask.
+  bool is_flags_mask() const {
+    return raw.kind == WASMTIME_COMPONENT_FLAGS_MASK;
+  }
+
+  /// \brief Returns the flags value, only valid if `is_flags_mask()`.
+  const FlagsMask &get_flags_mask() const {
+    assert(is_flags_mask());
+    return *FlagsMask::from_capi(&raw.of.flags_mask);
+  }
+
   /// \brief Returns whether this value is a resource.
   bool is_resource() const { return raw.kind == WASMTIME_COMPONENT_RESOURCE; }
 
@@ -838,6 +1260,41 @@ public:
     assert(is_resource());
     return *ResourceAny::from_capi(&raw.of.resource);
   }
+
+  /// \brief Appends the encoding of this value, which has the type `ty`, to
+  /// `out`.
+  ///
+  /// See `wasmtime_component_val_encode` for more information.
+  Result<std::monostate> encode(const ValType &ty,
+                                std::vector<uint8_t> &out) const {
+    size_t start = out.size();
+    out.resize(out.capacity() > start ? out.capacity() : start + 64);
+    size_t len = 0;
+    auto *err = wasmtime_component_val_encode(
+        &raw, ty.capi(), out.data() + start, out.size() - start, &len);
+    if (err == nullptr && len > out.size() - start) {
+      out.resize(start + len);
+      err = wasmtime_component_val_encode(&raw, ty.capi(), out.data() + start,
+                                          len, &len);
+    }
+    if (err) {
+      out.resize(start);
+      return Error(err);
+    }
+    out.resize(start + len);
+    return std::monostate();
+  }
+
+  /// \brief Decodes a value of type `ty` from `bytes`, which were produced
+  /// by `encode`.
+  static Result<Val> decode(const ValType &ty, Span<const uint8_t> bytes) {
+    wasmtime_component_val_t out;
+    auto *err = wasmtime_component_val_decode(ty.capi(), bytes.data(),
+                                              bytes.size(), &out);
+    if (err)
+      return Error(err);
+    return Val(std::move(out));
+  }
 };
 
 #undef VAL_REPR
@@ -866,6 +1323,13 @@ inline Tuple::Tuple(std::vector<Val> values) {
     new (dst++) Val(std::move(val));
 }
 
+inline RecordValues::RecordValues(std::vector<Val> values) {
+  wasmtime_component_valtuple_new_uninit(&raw, values.size());
+  auto dst = raw.data;
+  for (auto &&val : values)
+    new (dst++) Val(std::move(val));
+}
+
 inline Variant::Variant(std::string_view discriminant, std::optional<Val> x) {
   wasm_name_new(&raw.discriminant, discriminant.size(), discriminant.data());
   if (x) {
@@ -875,6 +1339,16 @@ inline Variant::Variant(std::string_view discriminant, std::optional<Val> x) {
   }
 }
 
+inline VariantIndex::VariantIndex(uint32_t discriminant,
+                                  std::optional<Val> x) {
+  raw.discriminant = discriminant;
+  if (x) {
+    raw.val = wasmtime_component_val_new(&x->raw);
+  } else {
+    raw.val = nullptr;
+  }
+}
+
 inline WitOption::WitOption(std::optional<Val> v) {
   if (v) {
     raw = wasmtime_component_val_new(&v->raw);
@@ -87,6 +87,68 @@ enum wasmtime_profiling_strategy_enum { // ProfilingStrategy
   WASMTIME_PROFILING_STRATEGY_PERFMAP,
 };
 
+/**
+ * \brief Specifier for whether an optional host feature is used, values are
+ * in #wasmtime_enabled_enum.
+ */
+typedef uint8_t wasmtime_enabled_t;
+
+/**
+ * \brief Whether an optional host feature, such as huge pages, is used.
+ */
+enum wasmtime_enabled_enum { // Enabled
+  /// The feature is used if it's supported by the host.
+  WASMTIME_ENABLED_AUTO,
+  /// The feature is used, and creating an engine fails if it's not supported
+  /// by the host.
+  WASMTIME_ENABLED_YES,
+  /// The feature isn't used.
+  WASMTIME_ENABLED_NO,
+};
+
+/**
+ * \brief Specifier of how generated code accounts for fuel, values are in
+ * #wasmtime_fuel_metering_enum.
+ */
+typedef uint8_t wasmtime_fuel_metering_t;
+
+/**
+ * \brief Different ways generated code can account for fuel.
+ *
+ * The default value is #WASMTIME_FUEL_METERING_PER_BLOCK.
+ */
+enum wasmtime_fuel_metering_enum { // FuelMetering
+  /// Each basic block executed consumes fuel for its instructions.
+  WASMTIME_FUEL_METERING_PER_BLOCK,
+  /// Each loop iteration, and function call, consumes fuel for all the
+  /// instructions in its body up front. This is cheaper, but overestimates
+  /// the fuel consumed by code which branches over parts of a body.
+  WASMTIME_FUEL_METERING_PER_LOOP,
+};
+
+/**
+ * \brief Specifier of which garbage collector is used for GC heaps, values are
+ * in #wasmtime_collector_enum.
+ */
+typedef uint8_t wasmtime_collector_t;
+
+/**
+ * \brief Different garbage collectors which Wasmtime can use.
+ *
+ * The default value is #WASMTIME_COLLECTOR_AUTO.
+ */
+enum wasmtime_collector_enum { // Collector
+  /// Wasmtime picks the collector, currently always the deferred
+  /// reference-counting collector.
+  WASMTIME_COLLECTOR_AUTO,
+  /// A reference-counting collector which trades throughput for latency. It
+  /// cannot collect cycles, which leak until the store is dropped.
+  WASMTIME_COLLECTOR_DEFERRED_REFERENCE_COUNTING,
+  /// A collector which only allocates and never frees, trapping once the GC
+  /// heap is exhausted. This is useful for short-lived programs.
+  WASMTIME_COLLECTOR_NULL,
+};
+
 #define WASMTIME_CONFIG_PROP(ret, name, ty)                                    \
   WASM_API_EXTERN ret wasmtime_config_##name##_set(wasm_config_t *, ty);
 
@@ -110,6 +172,27 @@ WASMTIME_CONFIG_PROP(void, debug_info, bool)
  */
 WASMTIME_CONFIG_PROP(void, consume_fuel, bool)
 
+/**
+ * \brief Configures how generated code accounts for fuel.
+ *
+ * This setting is #WASMTIME_FUEL_METERING_PER_BLOCK by default.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.fuel_metering
+ */
+WASMTIME_CONFIG_PROP(void, fuel_metering, wasmtime_fuel_metering_t)
+
+/**
+ * \brief Configures whether generated code counts the calls to each function
+ * defined in a module, read with #wasmtime_instance_function_stats_nth.
+ *
+ * This setting is `false` by default, and isn't supported by Winch.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.count_function_calls
+ */
+WASMTIME_CONFIG_PROP(void, count_function_calls, bool)
+
 /**
  * \brief Whether or not epoch-based interruption is enabled for generated code.
  *
@@ -152,6 +235,21 @@ WASMTIME_CONFIG_PROP(void, wasm_threads, bool)
 
 #endif // WASMTIME_FEATURE_THREADS
 
+#ifdef WASMTIME_FEATURE_COREDUMP
+
+/**
+ * \brief Configures whether a core dump is captured when WebAssembly traps,
+ * which can be serialized with #wasmtime_trap_coredump.
+ *
+ * This setting is `false` by default.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.coredump_on_trap
+ */
+WASMTIME_CONFIG_PROP(void, coredump_on_trap, bool)
+
+#endif // WASMTIME_FEATURE_COREDUMP
+
 /**
  * \brief Configures whether shared memories can be created.
  *
@@ -189,6 +287,32 @@ WASMTIME_CONFIG_PROP(void, wasm_function_references, bool)
  */
 WASMTIME_CONFIG_PROP(void, wasm_gc, bool)
 
+/**
+ * \brief Configures which garbage collector is used for GC heaps.
+ *
+ * This setting is #WASMTIME_COLLECTOR_AUTO by default. Creating an engine
+ * fails if the chosen collector was disabled at compile time.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.collector
+ */
+WASMTIME_CONFIG_PROP(void, collector, wasmtime_collector_t)
+
+/**
+ * \brief Configures the factor by which a store's GC heap is grown when an
+ * allocation doesn't fit in it.
+ *
+ * The heap is grown before it's collected, so a larger factor means fewer
+ * collections at the cost of memory. The factor must be at least `1.0`,
+ * otherwise creating an engine fails.
+ *
+ * This setting is `2.0` by default.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.gc_heap_growth_factor
+ */
+WASMTIME_CONFIG_PROP(void, gc_heap_growth_factor, double)
+
 /**
  * \brief Configures whether the WebAssembly SIMD proposal is
  * enabled.
@@ -287,6 +411,41 @@ WASMTIME_CONFIG_PROP(void, strategy, wasmtime_strategy_t)
 
 #endif // WASMTIME_FEATURE_COMPILER
 
+#ifdef WASMTIME_FEATURE_STACK_SWITCHING
+
+/**
+ * \brief Configures how many continuation stacks the engine keeps for reuse
+ * once the stores which created them are deleted.
+ *
+ * Each continuation created by the stack switching proposal gets its own
+ * stack, which is otherwise mapped when the continuation is created and
+ * unmapped when its store is deleted. With this option up to `size` released
+ * stacks are instead cached by the engine and shared by all of its stores.
+ * Cache usage is reported by #wasmtime_engine_continuation_stack_cache_stats
+ * and cached stacks stay mapped until the engine is deleted.
+ *
+ * This option defaults to 0, disabling the cache.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.continuation_stack_cache_size
+ */
+WASMTIME_CONFIG_PROP(void, continuation_stack_cache_size, size_t)
+
+/**
+ * \brief Configures how many bytes at the top of each cached continuation
+ * stack stay resident.
+ *
+ * The rest of a stack's pages are returned to the OS when it's cached.
+ *
+ * This option defaults to 0.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.continuation_stack_keep_resident
+ */
+WASMTIME_CONFIG_PROP(void, continuation_stack_keep_resident, size_t)
+
+#endif // WASMTIME_FEATURE_STACK_SWITCHING
+
 #ifdef WASMTIME_FEATURE_PARALLEL_COMPILATION
 
 /**
@@ -298,6 +457,38 @@ WASMTIME_CONFIG_PROP(void, strategy, wasmtime_strategy_t)
  */
 WASMTIME_CONFIG_PROP(void, parallel_compilation, bool)
 
+/**
+ * \brief Configures the number of threads in the engine's own compilation
+ * thread pool, where 0 means one per CPU.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.compilation_threads.
+ */
+WASMTIME_CONFIG_PROP(void, compilation_threads, size_t)
+
+/**
+ * \brief Callback invoked at the start of each compilation thread with the
+ * thread's index in the pool.
+ */
+typedef void (*wasmtime_compilation_thread_start_callback_t)(void *env,
+                                                             size_t index);
+
+/**
+ * \brief Configures a callback to run at the start of each of the engine's
+ * compilation threads, for example to set their CPU affinity or priority.
+ *
+ * The `env` pointer is passed to `callback` and is released with `finalizer`,
+ * if provided, when the configuration and any engines created from it are
+ * dropped. The callback may be invoked concurrently from multiple threads.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.compilation_thread_start_handler.
+ */
+WASM_API_EXTERN void wasmtime_config_compilation_thread_start_set(
+    wasm_config_t *config,
+    wasmtime_compilation_thread_start_callback_t callback, void *env,
+    void (*finalizer)(void *));
+
 #endif // WASMTIME_FEATURE_PARALLEL_COMPILATION
 
 #ifdef WASMTIME_FEATURE_COMPILER
@@ -334,6 +525,33 @@ WASMTIME_CONFIG_PROP(void, cranelift_nan_canonicalization, bool)
  */
 WASMTIME_CONFIG_PROP(void, cranelift_opt_level, wasmtime_opt_level_t)
 
+#ifdef WASMTIME_FEATURE_CRANELIFT
+/**
+ * \brief Configures whether modules are first compiled quickly without
+ * optimizations and then recompiled in the background with the configured
+ * optimization level.
+ *
+ * This setting is `false` by default.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.tiered_compilation.
+ */
+WASMTIME_CONFIG_PROP(void, tiered_compilation, bool)
+#endif // WASMTIME_FEATURE_CRANELIFT
+
+/**
+ * \brief Configures the maximum time, in nanoseconds, that compiling a single
+ * module or component may take.
+ *
+ * Compilation that runs past the deadline fails with an error for which
+ * #wasmtime_error_is_compile_deadline_exceeded returns `true`. By default
+ * there is no deadline.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.compile_deadline.
+ */
+WASMTIME_CONFIG_PROP(void, compile_deadline, uint64_t)
+
 #endif // WASMTIME_FEATURE_COMPILER
 
 /**
@@ -380,6 +598,49 @@ WASMTIME_CONFIG_PROP(void, memory_guard_size, uint64_t)
  */
 WASMTIME_CONFIG_PROP(void, memory_reservation_for_growth, uint64_t)
 
+/**
+ * \brief Configures whether the pages of linear memories are populated
+ * eagerly when memories are created and grown, rather than on first access.
+ *
+ * This option defaults to false.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.memory_populate
+ */
+WASMTIME_CONFIG_PROP(void, memory_populate, bool)
+
+/**
+ * \brief Configures whether linear memories are backed by transparent huge
+ * pages.
+ *
+ * This option defaults to #WASMTIME_ENABLED_NO.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.memory_huge_pages
+ */
+WASMTIME_CONFIG_PROP(void, memory_huge_pages, wasmtime_enabled_t)
+
+/**
+ * \brief Configures compiled code to sample one in every given number of
+ * accesses to linear memory, for #wasmtime_memory_access_histogram.
+ *
+ * This option defaults to 0, which disables sampling.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.memory_access_sampling
+ */
+WASMTIME_CONFIG_PROP(void, memory_access_sampling, uint32_t)
+
+/**
+ * \brief Configures whether compiled code is backed by transparent huge pages.
+ *
+ * This option defaults to #WASMTIME_ENABLED_NO.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.code_huge_pages
+ */
+WASMTIME_CONFIG_PROP(void, code_huge_pages, wasmtime_enabled_t)
+
 /**
  * \brief Configures whether to generate native unwind information (e.g.
  * .eh_frame on Linux).
@@ -410,6 +671,52 @@ wasmtime_config_cache_config_load(wasm_config_t *, const char *);
 
 #endif // WASMTIME_FEATURE_CACHE
 
+#if defined(WASMTIME_FEATURE_INCREMENTAL_CACHE) &&                             \
+    defined(WASMTIME_FEATURE_CRANELIFT)
+
+/**
+ * \brief Callback to look up `key` in an incremental compilation cache.
+ *
+ * On a hit the callback initializes `value` with #wasm_byte_vec_new, or a
+ * similar function, with the bytes previously passed to the insert callback
+ * for `key` and returns `true`. On a miss it returns `false` and leaves
+ * `value` untouched.
+ */
+typedef bool (*wasmtime_incremental_cache_get_callback_t)(
+    void *env, const uint8_t *key, size_t key_len, wasm_byte_vec_t *value);
+
+/**
+ * \brief Callback to store `value` under `key` in an incremental compilation
+ * cache, returning whether it was stored.
+ */
+typedef bool (*wasmtime_incremental_cache_insert_callback_t)(
+    void *env, const uint8_t *key, size_t key_len, const uint8_t *value,
+    size_t value_len);
+
+/**
+ * \brief Enables Cranelift's incremental compilation cache, backed by the
+ * provided callbacks.
+ *
+ * The incremental cache stores the result of compiling each function
+ * individually, so recompiling a module in which only some functions changed
+ * only recompiles those functions. Storing entries in a shared store lets
+ * separate processes or machines reuse each other's compilations.
+ *
+ * The callbacks may be called from any of the threads compiling a module, and
+ * concurrently. `env` is passed to each callback and `finalizer`, if not
+ * `NULL`, is called with `env` when the configuration and all engines created
+ * from it have been deleted.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.enable_incremental_compilation.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_config_incremental_cache_set(
+    wasm_config_t *config, wasmtime_incremental_cache_get_callback_t get,
+    wasmtime_incremental_cache_insert_callback_t insert, void *env,
+    void (*finalizer)(void *));
+
+#endif // WASMTIME_FEATURE_INCREMENTAL_CACHE && WASMTIME_FEATURE_CRANELIFT
+
 /**
  * \brief Configures the target triple that this configuration will produce
  * machine code for.
@@ -531,6 +838,23 @@ typedef wasmtime_error_t *(*wasmtime_new_memory_callback_t)(
     size_t reserved_size_in_bytes, size_t guard_size_in_bytes,
     wasmtime_linear_memory_t *memory_ret);
 
+/**
+ * A callback which receives a LinearMemory previously created by a
+ * #wasmtime_new_memory_callback_t once Wasmtime no longer uses it.
+ *
+ * Ownership of `memory`, including the responsibility to call its `finalizer`,
+ * is transferred to the callback, so the memory can be recycled and returned
+ * by a later call to #wasmtime_new_memory_callback_t. Its contents must be
+ * reset to zero before it's handed out again.
+ *
+ * This callback must be thread-safe.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/trait.MemoryCreator.html#method.reuse_memory
+ */
+typedef void (*wasmtime_reuse_memory_callback_t)(
+    void *env, wasmtime_linear_memory_t *memory);
+
 /**
  * A representation of custom memory creator and methods for an instance of
  * LinearMemory.
@@ -545,6 +869,9 @@ typedef struct wasmtime_memory_creator {
   wasmtime_new_memory_callback_t new_memory;
   /// An optional finalizer for env.
   void (*finalizer)(void *);
+  /// An optional callback to recycle memories, must be thread safe. If this
+  /// is `NULL` the finalizer of each memory is called instead.
+  wasmtime_reuse_memory_callback_t reuse_memory;
 } wasmtime_memory_creator_t;
 
 /**
@@ -629,6 +956,55 @@ WASMTIME_POOLING_ALLOCATION_CONFIG_PROP(max_unused_warm_slots, uint32_t)
  */
 WASMTIME_POOLING_ALLOCATION_CONFIG_PROP(decommit_batch_size, size_t)
 
+/**
+ * \brief Whether to reset and decommit deallocated slots on a background
+ * thread.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.PoolingAllocationConfig.html#method.background_decommit.
+ */
+WASMTIME_POOLING_ALLOCATION_CONFIG_PROP(background_decommit, bool)
+
+/**
+ * \brief Whether linear memories are placed on the NUMA node of the thread
+ * which allocates them.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.PoolingAllocationConfig.html#method.numa_local_memory.
+ */
+WASMTIME_POOLING_ALLOCATION_CONFIG_PROP(numa_local_memory, bool)
+
+/**
+ * \brief Whether to use memory protection keys (MPK) to stripe linear memories
+ * of different stores, which packs more slots into the same address space.
+ *
+ * This option defaults to #WASMTIME_ENABLED_NO. It only has an effect with a
+ * `max_memory_size` smaller than the default, see the Rust documentation.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.PoolingAllocationConfig.html#method.memory_protection_keys.
+ */
+WASMTIME_POOLING_ALLOCATION_CONFIG_PROP(memory_protection_keys,
+                                        wasmtime_enabled_t)
+
+/**
+ * \brief The maximum number of memory protection keys to use.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.PoolingAllocationConfig.html#method.max_memory_protection_keys.
+ */
+WASMTIME_POOLING_ALLOCATION_CONFIG_PROP(max_memory_protection_keys, size_t)
+
+/**
+ * \brief Returns whether memory protection keys are available on this host,
+ * as detected for #WASMTIME_ENABLED_AUTO.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.PoolingAllocationConfig.html#method.are_memory_protection_keys_available.
+ */
+WASM_API_EXTERN bool
+wasmtime_pooling_allocation_config_are_memory_protection_keys_available();
+
 #ifdef WASMTIME_FEATURE_ASYNC
 /**
  * \brief How much memory, in bytes, to keep resident for async stacks allocated
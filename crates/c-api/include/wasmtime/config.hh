@@ -5,10 +5,16 @@
 #ifndef WASMTIME_CONFIG_HH
 #define WASMTIME_CONFIG_HH
 
+#include <chrono>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <wasmtime/conf.h>
 #include <wasmtime/config.h>
 #include <wasmtime/error.hh>
 #include <wasmtime/helpers.hh>
+#include <wasmtime/span.hh>
 #include <wasmtime/types/memory.hh>
 
 namespace wasmtime {
@@ -43,6 +49,34 @@ enum class ProfilingStrategy {
   Perfmap = WASMTIME_PROFILING_STRATEGY_PERFMAP,
 };
 
+/// \brief Values passed to `Config::memory_huge_pages` and similar options
+enum class Enabled {
+  /// Use the feature if the host supports it
+  Auto = WASMTIME_ENABLED_AUTO,
+  /// Use the feature, failing engine creation if the host doesn't support it
+  Yes = WASMTIME_ENABLED_YES,
+  /// Don't use the feature
+  No = WASMTIME_ENABLED_NO,
+};
+
+/// \brief Values passed to `Config::fuel_metering`
+enum class FuelMetering {
+  /// Fuel is consumed for the instructions of each basic block executed
+  PerBlock = WASMTIME_FUEL_METERING_PER_BLOCK,
+  /// Fuel is consumed up front for each loop iteration and function call
+  PerLoop = WASMTIME_FUEL_METERING_PER_LOOP,
+};
+
+/// \brief Values passed to `Config::collector`
+enum class Collector {
+  /// Wasmtime picks the collector
+  Auto = WASMTIME_COLLECTOR_AUTO,
+  /// The deferred reference-counting collector
+  DeferredReferenceCounting = WASMTIME_COLLECTOR_DEFERRED_REFERENCE_COUNTING,
+  /// The null collector, which never frees
+  Null = WASMTIME_COLLECTOR_NULL,
+};
+
 #ifdef WASMTIME_FEATURE_POOLING_ALLOCATOR
 /**
  * \brief Pool allocation configuration for Wasmtime.
@@ -73,6 +107,49 @@ class PoolAllocationConfig {
                                                                batch_size);
   }
 
+  /// \brief Whether to reset and decommit deallocated slots on a background
+  /// thread.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.PoolingAllocationConfig.html#method.background_decommit.
+  void background_decommit(bool enable) {
+    wasmtime_pooling_allocation_config_background_decommit_set(ptr.get(),
+                                                               enable);
+  }
+
+  /// \brief Whether linear memories are placed on the NUMA node of the thread
+  /// which allocates them.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.PoolingAllocationConfig.html#method.numa_local_memory.
+  void numa_local_memory(bool enable) {
+    wasmtime_pooling_allocation_config_numa_local_memory_set(ptr.get(), enable);
+  }
+
+  /// \brief Whether to use memory protection keys (MPK) to stripe linear
+  /// memories of different stores, which packs more slots into the same
+  /// address space.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.PoolingAllocationConfig.html#method.memory_protection_keys.
+  void memory_protection_keys(Enabled enable) {
+    wasmtime_pooling_allocation_config_memory_protection_keys_set(
+        ptr.get(), static_cast<wasmtime_enabled_t>(enable));
+  }
+
+  /// \brief The maximum number of memory protection keys to use.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.PoolingAllocationConfig.html#method.max_memory_protection_keys.
+  void max_memory_protection_keys(size_t max) {
+    wasmtime_pooling_allocation_config_max_memory_protection_keys_set(ptr.get(),
+                                                                      max);
+  }
+
+  /// \brief Returns whether memory protection keys are available on this
+  /// host.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.PoolingAllocationConfig.html#method.are_memory_protection_keys_available.
+  static bool are_memory_protection_keys_available() {
+    return wasmtime_pooling_allocation_config_are_memory_protection_keys_available();
+  }
+
 #ifdef WASMTIME_FEATURE_ASYNC
   /// \brief How much memory, in bytes, to keep resident for async stacks
   /// allocated with the pooling allocator.
@@ -273,6 +350,22 @@ class Config {
     wasmtime_config_consume_fuel_set(ptr.get(), enable);
   }
 
+  /// \brief Configures how generated code accounts for fuel.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.fuel_metering
+  void fuel_metering(FuelMetering metering) {
+    wasmtime_config_fuel_metering_set(
+        ptr.get(), static_cast<wasmtime_fuel_metering_t>(metering));
+  }
+
+  /// \brief Configures whether generated code counts the calls to each
+  /// function, read with `Instance::function_stats`.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.count_function_calls
+  void count_function_calls(bool enable) {
+    wasmtime_config_count_function_calls_set(ptr.get(), enable);
+  }
+
   /// \brief Configures the maximum amount of native stack wasm can consume.
   ///
   /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.max_wasm_stack
@@ -289,6 +382,16 @@ class Config {
   }
 #endif // WASMTIME_FEATURE_THREADS
 
+#ifdef WASMTIME_FEATURE_COREDUMP
+  /// \brief Configures whether a core dump is captured when WebAssembly
+  /// traps, serialized with `wasmtime::coredump`.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.coredump_on_trap
+  void coredump_on_trap(bool enable) {
+    wasmtime_config_coredump_on_trap_set(ptr.get(), enable);
+  }
+#endif // WASMTIME_FEATURE_COREDUMP
+
   /// \brief Configures whether wasm shared memories can be created.
   ///
   /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.shared_memory
@@ -367,6 +470,22 @@ class Config {
   /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.wasm_gc
   void wasm_gc(bool enable) { wasmtime_config_wasm_gc_set(ptr.get(), enable); }
 
+  /// \brief Configures which garbage collector is used for GC heaps
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.collector
+  void collector(Collector collector) {
+    wasmtime_config_collector_set(ptr.get(),
+                                  static_cast<wasmtime_collector_t>(collector));
+  }
+
+  /// \brief Configures the factor by which GC heaps are grown when an
+  /// allocation doesn't fit
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.gc_heap_growth_factor
+  void gc_heap_growth_factor(double factor) {
+    wasmtime_config_gc_heap_growth_factor_set(ptr.get(), factor);
+  }
+
   /// \brief Configures whether the WebAssembly function references proposal
   /// will be enabled
   ///
@@ -399,6 +518,34 @@ class Config {
     wasmtime_config_wasm_custom_page_sizes_set(ptr.get(), enable);
   }
 
+#ifdef WASMTIME_FEATURE_COMPILER
+  /// \brief Configures whether the WebAssembly stack switching proposal will
+  /// be enabled
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.wasm_stack_switching
+  void wasm_stack_switching(bool enable) {
+    wasmtime_config_wasm_stack_switching_set(ptr.get(), enable);
+  }
+#endif // WASMTIME_FEATURE_COMPILER
+
+#ifdef WASMTIME_FEATURE_STACK_SWITCHING
+  /// \brief Configures how many continuation stacks the engine keeps for
+  /// reuse.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.continuation_stack_cache_size
+  void continuation_stack_cache_size(size_t size) {
+    wasmtime_config_continuation_stack_cache_size_set(ptr.get(), size);
+  }
+
+  /// \brief Configures how many bytes at the top of each cached continuation
+  /// stack stay resident.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.continuation_stack_keep_resident
+  void continuation_stack_keep_resident(size_t size) {
+    wasmtime_config_continuation_stack_keep_resident_set(ptr.get(), size);
+  }
+#endif // WASMTIME_FEATURE_STACK_SWITCHING
+
 #ifdef WASMTIME_FEATURE_COMPONENT_MODEL
   /// \brief Configures whether the WebAssembly component model proposal will be
   /// enabled
@@ -417,6 +564,25 @@ class Config {
   void parallel_compilation(bool enable) {
     wasmtime_config_parallel_compilation_set(ptr.get(), enable);
   }
+
+  /// \brief Configures the number of threads in the engine's own
+  /// compilation thread pool, where 0 means one per CPU.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.compilation_threads
+  void compilation_threads(size_t threads) {
+    wasmtime_config_compilation_threads_set(ptr.get(), threads);
+  }
+
+  /// \brief Configures a function, called with the thread's index, to run at
+  /// the start of each of the engine's compilation threads.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.compilation_thread_start_handler
+  template <typename F> void compilation_thread_start_handler(F &&f) {
+    using T = std::remove_cv_t<std::remove_reference_t<F>>;
+    wasmtime_config_compilation_thread_start_set(
+        ptr.get(), raw_thread_start<T>,
+        std::make_unique<T>(std::forward<F>(f)).release(), raw_finalize<T>);
+  }
 #endif // WASMTIME_FEATURE_PARALLEL_COMPILATION
 
 #ifdef WASMTIME_FEATURE_COMPILER
@@ -450,6 +616,25 @@ class Config {
         ptr.get(), static_cast<wasmtime_opt_level_t>(level));
   }
 
+#ifdef WASMTIME_FEATURE_CRANELIFT
+  /// \brief Configures whether modules are compiled in a fast baseline tier
+  /// first and an optimized tier in the background.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.tiered_compilation
+  void tiered_compilation(bool enable) {
+    wasmtime_config_tiered_compilation_set(ptr.get(), enable);
+  }
+#endif // WASMTIME_FEATURE_CRANELIFT
+
+  /// \brief Configures the maximum time that compiling a single module or
+  /// component may take.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.compile_deadline
+  void compile_deadline(std::chrono::nanoseconds deadline) {
+    auto nanos = static_cast<uint64_t>(deadline.count());
+    wasmtime_config_compile_deadline_set(ptr.get(), nanos);
+  }
+
   /// \brief Enable the specified Cranelift flag
   ///
   /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.cranelift_flag_enable
@@ -488,6 +673,36 @@ class Config {
     wasmtime_config_memory_reservation_for_growth_set(ptr.get(), size);
   }
 
+  /// \brief Configures whether linear memory pages are populated eagerly
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.memory_populate
+  void memory_populate(bool enable) {
+    wasmtime_config_memory_populate_set(ptr.get(), enable);
+  }
+
+  /// \brief Configures whether linear memories use transparent huge pages
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.memory_huge_pages
+  void memory_huge_pages(Enabled enable) {
+    wasmtime_config_memory_huge_pages_set(
+        ptr.get(), static_cast<wasmtime_enabled_t>(enable));
+  }
+
+  /// \brief Configures sampling of accesses to linear memory
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.memory_access_sampling
+  void memory_access_sampling(uint32_t interval) {
+    wasmtime_config_memory_access_sampling_set(ptr.get(), interval);
+  }
+
+  /// \brief Configures whether compiled code uses transparent huge pages
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.code_huge_pages
+  void code_huge_pages(Enabled enable) {
+    wasmtime_config_code_huge_pages_set(
+        ptr.get(), static_cast<wasmtime_enabled_t>(enable));
+  }
+
   /// \brief Configures the size of memory's guard region
   ///
   /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.memory_guard_size
@@ -554,11 +769,60 @@ class Config {
   }
 #endif // WASMTIME_FEATURE_CACHE
 
+#if defined(WASMTIME_FEATURE_INCREMENTAL_CACHE) &&                             \
+    defined(WASMTIME_FEATURE_CRANELIFT)
+  /// \brief Enables Cranelift's incremental compilation cache, backed by
+  /// `store`.
+  ///
+  /// The `store` is called concurrently from compilation threads and must
+  /// have these methods:
+  ///
+  /// * `std::optional<std::vector<uint8_t>> get(Span<const uint8_t> key)`
+  /// * `bool insert(Span<const uint8_t> key, Span<const uint8_t> value)`
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.enable_incremental_compilation
+  template <typename T> Result<std::monostate> incremental_cache(T store) {
+    auto *error = wasmtime_config_incremental_cache_set(
+        ptr.get(), raw_cache_get<T>, raw_cache_insert<T>,
+        std::make_unique<T>(std::move(store)).release(), raw_finalize<T>);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::monostate();
+  }
+#endif // WASMTIME_FEATURE_INCREMENTAL_CACHE && WASMTIME_FEATURE_CRANELIFT
+
 private:
   template <typename T> static void raw_finalize(void *env) {
     std::unique_ptr<T> ptr(reinterpret_cast<T *>(env));
   }
 
+  template <typename F> static void raw_thread_start(void *env, size_t index) {
+    (*reinterpret_cast<F *>(env))(index);
+  }
+
+  template <typename T>
+  static bool raw_cache_get(void *env, const uint8_t *key, size_t key_len,
+                            wasm_byte_vec_t *value) {
+    T *store = reinterpret_cast<T *>(env);
+    std::optional<std::vector<uint8_t>> bytes =
+        store->get(Span<const uint8_t>(key, key_len));
+    if (!bytes) {
+      return false;
+    }
+    wasm_byte_vec_new(value, bytes->size(),
+                      reinterpret_cast<const wasm_byte_t *>(bytes->data()));
+    return true;
+  }
+
+  template <typename T>
+  static bool raw_cache_insert(void *env, const uint8_t *key, size_t key_len,
+                               const uint8_t *value, size_t value_len) {
+    T *store = reinterpret_cast<T *>(env);
+    return store->insert(Span<const uint8_t>(key, key_len),
+                         Span<const uint8_t>(value, value_len));
+  }
+
   template <typename M>
   static uint8_t *raw_get_memory(void *env, size_t *byte_size,
                                  size_t *byte_capacity) {
@@ -597,17 +861,44 @@ private:
     return nullptr;
   }
 
+  template <typename T>
+  static void raw_reuse_memory(void *env, wasmtime_linear_memory_t *memory) {
+    using Memory = typename T::Memory;
+    T *creator = reinterpret_cast<T *>(env);
+    std::unique_ptr<Memory> ptr(reinterpret_cast<Memory *>(memory->env));
+    creator->reuse_memory(std::move(*ptr));
+  }
+
+  template <typename T>
+  using reuse_memory_t = decltype(std::declval<T &>().reuse_memory(
+      std::declval<typename T::Memory>()));
+
+  template <typename T, typename = void>
+  struct has_reuse_memory : std::false_type {};
+
+  template <typename T>
+  struct has_reuse_memory<T, std::void_t<reuse_memory_t<T>>>
+      : std::true_type {};
+
 public:
   /// \brief Configures a custom memory creator for this configuration and
   /// eventual Engine.
   ///
   /// This can be used to use `creator` to allocate linear memories for the
   /// engine that this configuration will be used for.
+  ///
+  /// If `creator` has a `reuse_memory(Memory)` method then memories which
+  /// are no longer used are passed to it, instead of being destroyed, so that
+  /// they can be recycled by later calls to `new_memory`. See
+  /// `wasmtime_reuse_memory_callback_t` for more information.
   template <typename T> void host_memory_creator(T creator) {
     wasmtime_memory_creator_t config = {0};
     config.env = std::make_unique<T>(creator).release();
     config.finalizer = raw_finalize<T>;
     config.new_memory = raw_new_memory<T>;
+    if constexpr (has_reuse_memory<T>::value) {
+      config.reuse_memory = raw_reuse_memory<T>;
+    }
     wasmtime_config_host_memory_creator_set(ptr.get(), &config);
   }
 
@@ -0,0 +1,103 @@
+/**
+ * \file wasmtime/coredump.h
+ *
+ * \brief API for WebAssembly core dumps of trapping guests
+ */
+
+#ifndef WASMTIME_COREDUMP_H
+#define WASMTIME_COREDUMP_H
+
+#include <wasm.h>
+#include <wasmtime/conf.h>
+#include <wasmtime/error.h>
+#include <wasmtime/store.h>
+
+#ifdef WASMTIME_FEATURE_COREDUMP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Which contents of linear memories are included in a serialized core
+ * dump, values are in #wasmtime_coredump_memory_enum.
+ */
+typedef uint8_t wasmtime_coredump_memory_t;
+
+/**
+ * \brief Selections of linear memory contents for a core dump.
+ *
+ * Memories are always declared with their size, so only the amount of data
+ * differs between these.
+ */
+enum wasmtime_coredump_memory_enum { // CoreDumpMemory
+  /// The full contents of all memories are included.
+  WASMTIME_COREDUMP_MEMORY_ALL,
+  /// No memory contents are included, only the stack, globals and instances.
+  WASMTIME_COREDUMP_MEMORY_NONE,
+  /// Only the #wasmtime_coredump_range_t ranges passed along are included.
+  WASMTIME_COREDUMP_MEMORY_RANGES,
+};
+
+/**
+ * \brief A range of bytes of a linear memory to include in a core dump.
+ */
+typedef struct wasmtime_coredump_range {
+  /// The index of the memory amongst all memories of the store when the core
+  /// dump was captured, which is also its index in the core dump.
+  size_t memory;
+  /// The offset of the first byte to include.
+  size_t offset;
+  /// The number of bytes to include, clamped to the size of the memory.
+  size_t len;
+} wasmtime_coredump_range_t;
+
+/**
+ * \brief Serializes the core dump attached to a trap.
+ *
+ * \param trap the trap, returned from calling WebAssembly, to look at
+ * \param store the store the trap came from
+ * \param name the name of the program recorded in the core dump, as UTF-8
+ * \param name_len the length of `name` in bytes
+ * \param memory which contents of linear memories to include
+ * \param ranges the memory ranges to include, with
+ *        #WASMTIME_COREDUMP_MEMORY_RANGES
+ * \param nranges the number of elements in `ranges`
+ * \param out where the core dump, owned by the caller, is written on success
+ *
+ * \return Returns `false` if no core dump is attached to `trap`, which happens
+ * if #wasmtime_config_coredump_on_trap_set wasn't enabled.
+ *
+ * The core dump is in the standard format described at
+ * https://github.com/WebAssembly/tool-conventions/blob/main/Coredump.md.
+ * Memory contents are read when this is called, not when the trap happened, so
+ * they reflect any changes made since.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.WasmCoreDump.html#method.serialize_with
+ */
+WASM_API_EXTERN bool wasmtime_trap_coredump(
+    const wasm_trap_t *trap, wasmtime_context_t *store, const char *name,
+    size_t name_len, wasmtime_coredump_memory_t memory,
+    const wasmtime_coredump_range_t *ranges, size_t nranges,
+    wasm_byte_vec_t *out);
+
+/**
+ * \brief Serializes the core dump attached to an error.
+ *
+ * This is the same as #wasmtime_trap_coredump, but for errors returned by
+ * calls into WebAssembly, such as ones raised by host functions.
+ */
+WASM_API_EXTERN bool wasmtime_error_coredump(
+    const wasmtime_error_t *error, wasmtime_context_t *store, const char *name,
+    size_t name_len, wasmtime_coredump_memory_t memory,
+    const wasmtime_coredump_range_t *ranges, size_t nranges,
+    wasm_byte_vec_t *out);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // WASMTIME_FEATURE_COREDUMP
+
+#endif // WASMTIME_COREDUMP_H
@@ -0,0 +1,104 @@
+/**
+ * \file wasmtime/coredump.hh
+ */
+
+#ifndef WASMTIME_COREDUMP_HH
+#define WASMTIME_COREDUMP_HH
+
+#include <wasmtime/conf.h>
+
+#ifdef WASMTIME_FEATURE_COREDUMP
+
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <wasmtime/coredump.h>
+#include <wasmtime/error.hh>
+#include <wasmtime/store.hh>
+#include <wasmtime/trap.hh>
+
+namespace wasmtime {
+
+/**
+ * \brief Selects which contents of linear memories are included in a core
+ * dump serialized with `coredump`.
+ *
+ * See `wasmtime_coredump_memory_enum` for more information.
+ */
+class CoreDumpMemory {
+  wasmtime_coredump_memory_t kind;
+  std::vector<wasmtime_coredump_range_t> ranges;
+
+  CoreDumpMemory(wasmtime_coredump_memory_t kind,
+                 std::vector<wasmtime_coredump_range_t> ranges)
+      : kind(kind), ranges(std::move(ranges)) {}
+
+public:
+  /// Includes the full contents of all memories.
+  static CoreDumpMemory all() { return {WASMTIME_COREDUMP_MEMORY_ALL, {}}; }
+
+  /// Includes no memory contents, only the stack, globals and instances.
+  static CoreDumpMemory none() { return {WASMTIME_COREDUMP_MEMORY_NONE, {}}; }
+
+  /// Includes only the given ranges of memories.
+  static CoreDumpMemory
+  only(std::vector<wasmtime_coredump_range_t> ranges) {
+    return {WASMTIME_COREDUMP_MEMORY_RANGES, std::move(ranges)};
+  }
+
+  /// Returns the raw kind of this selection.
+  wasmtime_coredump_memory_t capi_kind() const { return kind; }
+
+  /// Returns the ranges of this selection.
+  const std::vector<wasmtime_coredump_range_t> &capi_ranges() const {
+    return ranges;
+  }
+};
+
+namespace detail {
+template <typename F>
+std::optional<std::vector<uint8_t>> serialize_coredump(F serialize) {
+  wasm_byte_vec_t out;
+  if (!serialize(&out)) {
+    return std::nullopt;
+  }
+  std::vector<uint8_t> ret(out.data, out.data + out.size);
+  wasm_byte_vec_delete(&out);
+  return ret;
+}
+} // namespace detail
+
+/// \brief Serializes the core dump attached to `trap`, or returns nothing if
+/// core dumps aren't enabled with `Config::coredump_on_trap`.
+///
+/// See `wasmtime_trap_coredump` for more information.
+inline std::optional<std::vector<uint8_t>>
+coredump(const Trap &trap, Store::Context cx, std::string_view name,
+         const CoreDumpMemory &memory = CoreDumpMemory::all()) {
+  return detail::serialize_coredump([&](wasm_byte_vec_t *out) {
+    return wasmtime_trap_coredump(
+        trap.capi(), cx.capi(), name.data(), name.size(), memory.capi_kind(),
+        memory.capi_ranges().data(), memory.capi_ranges().size(), out);
+  });
+}
+
+/// \brief Serializes the core dump attached to `error`, or returns nothing if
+/// there isn't one.
+///
+/// See `wasmtime_error_coredump` for more information.
+inline std::optional<std::vector<uint8_t>>
+coredump(const Error &error, Store::Context cx, std::string_view name,
+         const CoreDumpMemory &memory = CoreDumpMemory::all()) {
+  return detail::serialize_coredump([&](wasm_byte_vec_t *out) {
+    return wasmtime_error_coredump(
+        error.capi(), cx.capi(), name.data(), name.size(), memory.capi_kind(),
+        memory.capi_ranges().data(), memory.capi_ranges().size(), out);
+  });
+}
+
+} // namespace wasmtime
+
+#endif // WASMTIME_FEATURE_COREDUMP
+
+#endif // WASMTIME_COREDUMP_HH
@@ -8,6 +8,8 @@
 #define WASMTIME_ENGINE_H
 
 #include <wasm.h>
+#include <wasmtime/conf.h>
+#include <wasmtime/error.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -35,12 +37,204 @@ WASM_API_EXTERN wasm_engine_t *wasmtime_engine_clone(wasm_engine_t *engine);
  */
 WASM_API_EXTERN void wasmtime_engine_increment_epoch(wasm_engine_t *engine);
 
+/**
+ * \brief Prepares this engine for the process to `fork`, so that its modules
+ * and components can be used in the child process.
+ *
+ * Compiled code and memory images are inherited by the child with their pages
+ * shared copy-on-write, however the threads that Wasmtime uses in the
+ * background aren't, so they're paused by this function. Once it returns the
+ * process must fork, and then call #wasmtime_engine_after_fork_parent in the
+ * parent and #wasmtime_engine_after_fork_child in the child. No other thread
+ * may use Wasmtime in the meantime, and no WebAssembly may be executing.
+ *
+ * Returns an error if forking isn't supported for this engine, for example on
+ * Windows, or on macOS when traps are handled with Mach ports.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_engine_prepare_fork(wasm_engine_t *engine);
+
+/**
+ * \brief Resumes this engine in the parent process after a fork, see
+ * #wasmtime_engine_prepare_fork.
+ */
+WASM_API_EXTERN void wasmtime_engine_after_fork_parent(wasm_engine_t *engine);
+
+/**
+ * \brief Makes this engine usable in a child process forked after
+ * #wasmtime_engine_prepare_fork.
+ *
+ * This must be called on the thread which forked, before anything else uses
+ * the engine in the child. Returns an error if a background thread can't be
+ * respawned.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_engine_after_fork_child(wasm_engine_t *engine);
+
 /**
  * \brief Returns whether this engine is using the Pulley interpreter to execute
  * WebAssembly code.
  */
 WASM_API_EXTERN bool wasmtime_engine_is_pulley(wasm_engine_t *engine);
 
+/**
+ * \brief A snapshot of the compiled code and types loaded into an engine,
+ * returned by #wasmtime_engine_stats.
+ *
+ * Each value is a gauge of the state of the engine when the snapshot was
+ * taken.
+ */
+typedef struct wasmtime_engine_stats {
+  /// The number of compiled code objects currently loaded, one for each live
+  /// module or component.
+  uint64_t code_objects;
+  /// Bytes of memory mapped for loaded code objects, including metadata.
+  uint64_t code_bytes;
+  /// Bytes of executable machine code within loaded code objects.
+  uint64_t text_bytes;
+  /// The number of wasm-to-host trampolines within loaded code objects.
+  uint64_t trampolines;
+  /// The number of types registered in the engine's type registry.
+  uint64_t types;
+  /// The number of distinct rec groups registered in the engine's type
+  /// registry.
+  uint64_t rec_groups;
+} wasmtime_engine_stats_t;
+
+/**
+ * \brief Reads a snapshot of the code and types loaded into this engine.
+ *
+ * This is safe to call concurrently with other uses of the engine, but note
+ * that each value is read independently so the snapshot as a whole may not
+ * be perfectly consistent.
+ */
+WASM_API_EXTERN void wasmtime_engine_stats(const wasm_engine_t *engine,
+                                           wasmtime_engine_stats_t *stats);
+
+#ifdef WASMTIME_FEATURE_POOLING_ALLOCATOR
+
+/**
+ * \brief Runtime statistics of an engine's pooling allocator, returned by
+ * #wasmtime_engine_pooling_stats.
+ *
+ * For each kind of pool the live, warm and cold counts together account for
+ * every slot in the pool. A "warm" slot is one that was previously used and is
+ * now unused, and a "cold" slot is one that has never been used.
+ */
+typedef struct wasmtime_pooling_stats {
+  /// The number of core instances currently allocated.
+  uint64_t core_instances;
+  /// The number of component instances currently allocated.
+  uint64_t component_instances;
+  /// The number of linear memories currently allocated.
+  uint64_t memories;
+  /// The number of unused, previously-used, linear memory slots.
+  uint64_t unused_warm_memories;
+  /// The number of linear memory slots which have never been used.
+  uint64_t unused_cold_memories;
+  /// Bytes kept resident in unused linear memory slots.
+  uint64_t unused_memory_bytes_resident;
+  /// The number of tables currently allocated.
+  uint64_t tables;
+  /// The number of unused, previously-used, table slots.
+  uint64_t unused_warm_tables;
+  /// The number of table slots which have never been used.
+  uint64_t unused_cold_tables;
+  /// Bytes kept resident in unused table slots.
+  uint64_t unused_table_bytes_resident;
+  /// The number of async stacks currently allocated, or zero if async
+  /// support is disabled.
+  uint64_t stacks;
+  /// The number of unused, previously-used, async stack slots.
+  uint64_t unused_warm_stacks;
+  /// The number of async stack slots which have never been used.
+  uint64_t unused_cold_stacks;
+  /// The number of memory regions currently queued to be decommitted.
+  uint64_t decommit_queue_len;
+  /// The number of linear memory allocations which reused a slot previously
+  /// used by the same memory of the same module.
+  uint64_t memory_affinity_hits;
+  /// The number of linear memory allocations for which no slot previously
+  /// used by the same memory of the same module was available.
+  uint64_t memory_affinity_misses;
+  /// Bytes kept resident in unused async stack slots, see
+  /// #wasmtime_pooling_allocation_config_async_stack_keep_resident_set. This
+  /// is zero if async support or stack zeroing is disabled.
+  uint64_t unused_stack_bytes_resident;
+} wasmtime_pooling_stats_t;
+
+/**
+ * \brief Reads the current statistics of this engine's pooling allocator.
+ *
+ * Returns `false` and leaves `stats` untouched if `engine` was not configured
+ * with #wasmtime_pooling_allocation_strategy_set. Otherwise fills in `stats`
+ * and returns `true`.
+ *
+ * This is safe to call concurrently with other uses of the engine, but note
+ * that each value is read independently so the snapshot as a whole may not
+ * be perfectly consistent.
+ */
+WASM_API_EXTERN bool
+wasmtime_engine_pooling_stats(const wasm_engine_t *engine,
+                              wasmtime_pooling_stats_t *stats);
+
+#endif // WASMTIME_FEATURE_POOLING_ALLOCATOR
+
+#ifdef WASMTIME_FEATURE_ASYNC
+
+/**
+ * \brief Usage of the fiber stacks cached by an engine which uses the
+ * on-demand instance allocator.
+ *
+ * See #wasmtime_config_async_stack_cache_size_set for more information.
+ */
+typedef struct wasmtime_async_stack_cache_stats {
+  /// The number of released fiber stacks currently cached for reuse.
+  uint64_t cached_stacks;
+  /// The number of fiber stack allocations which reused a cached stack.
+  uint64_t hits;
+  /// The number of fiber stack allocations which found the cache empty.
+  uint64_t misses;
+} wasmtime_async_stack_cache_stats_t;
+
+/**
+ * \brief Reads the current usage of this engine's fiber stack cache.
+ *
+ * Returns `false` and leaves `stats` untouched if `engine` uses the pooling
+ * allocator, whose stacks are reported by #wasmtime_engine_pooling_stats
+ * instead. Otherwise fills in `stats` and returns `true`.
+ */
+WASM_API_EXTERN bool wasmtime_engine_async_stack_cache_stats(
+    const wasm_engine_t *engine, wasmtime_async_stack_cache_stats_t *stats);
+
+#endif // WASMTIME_FEATURE_ASYNC
+
+#ifdef WASMTIME_FEATURE_STACK_SWITCHING
+
+/**
+ * \brief Usage of the continuation stacks cached by an engine.
+ *
+ * See #wasmtime_config_continuation_stack_cache_size_set for more information.
+ */
+typedef struct wasmtime_continuation_stack_cache_stats {
+  /// The number of released continuation stacks currently cached for reuse.
+  uint64_t cached_stacks;
+  /// The number of continuation stack allocations which reused a cached stack.
+  uint64_t hits;
+  /// The number of continuation stack allocations which found the cache empty.
+  uint64_t misses;
+} wasmtime_continuation_stack_cache_stats_t;
+
+/**
+ * \brief Reads the current usage of this engine's continuation stack cache
+ * into `stats`.
+ */
+WASM_API_EXTERN void wasmtime_engine_continuation_stack_cache_stats(
+    const wasm_engine_t *engine,
+    wasmtime_continuation_stack_cache_stats_t *stats);
+
+#endif // WASMTIME_FEATURE_STACK_SWITCHING
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -6,8 +6,10 @@
 #define WASMTIME_ENGINE_HH
 
 #include <memory>
+#include <optional>
 #include <wasmtime/config.hh>
 #include <wasmtime/engine.h>
+#include <wasmtime/error.hh>
 #include <wasmtime/helpers.hh>
 
 namespace wasmtime {
@@ -36,8 +38,88 @@ class Engine {
   /// beyond the configured threshold.
   void increment_epoch() const { wasmtime_engine_increment_epoch(ptr.get()); }
 
+  /// \brief Prepares this engine for the process to fork.
+  ///
+  /// See `wasmtime_engine_prepare_fork` for more information.
+  Result<std::monostate> prepare_fork() const {
+    auto *error = wasmtime_engine_prepare_fork(ptr.get());
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::monostate();
+  }
+
+  /// \brief Resumes this engine in the parent process after a fork.
+  void after_fork_parent() const {
+    wasmtime_engine_after_fork_parent(ptr.get());
+  }
+
+  /// \brief Makes this engine usable in a child process after a fork.
+  ///
+  /// See `wasmtime_engine_after_fork_child` for more information.
+  Result<std::monostate> after_fork_child() const {
+    auto *error = wasmtime_engine_after_fork_child(ptr.get());
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::monostate();
+  }
+
   /// \brief Returns whether this engine is using Pulley for execution.
   void is_pulley() const { wasmtime_engine_is_pulley(ptr.get()); }
+
+  /// \brief Returns a snapshot of the compiled code and types loaded into
+  /// this engine.
+  ///
+  /// See `wasmtime_engine_stats` for more information.
+  wasmtime_engine_stats_t stats() const {
+    wasmtime_engine_stats_t stats;
+    wasmtime_engine_stats(ptr.get(), &stats);
+    return stats;
+  }
+
+#ifdef WASMTIME_FEATURE_POOLING_ALLOCATOR
+  /// \brief Returns the current statistics of this engine's pooling
+  /// allocator, or `std::nullopt` if it isn't using the pooling allocator.
+  ///
+  /// See `wasmtime_engine_pooling_stats` for more information.
+  std::optional<wasmtime_pooling_stats_t> pooling_stats() const {
+    wasmtime_pooling_stats_t stats;
+    if (wasmtime_engine_pooling_stats(ptr.get(), &stats)) {
+      return stats;
+    }
+    return std::nullopt;
+  }
+#endif // WASMTIME_FEATURE_POOLING_ALLOCATOR
+
+#ifdef WASMTIME_FEATURE_ASYNC
+  /// \brief Returns the current usage of this engine's fiber stack cache, or
+  /// `std::nullopt` if it's using the pooling allocator.
+  ///
+  /// See `wasmtime_engine_async_stack_cache_stats` for more information.
+  std::optional<wasmtime_async_stack_cache_stats_t>
+  async_stack_cache_stats() const {
+    wasmtime_async_stack_cache_stats_t stats;
+    if (wasmtime_engine_async_stack_cache_stats(ptr.get(), &stats)) {
+      return stats;
+    }
+    return std::nullopt;
+  }
+#endif // WASMTIME_FEATURE_ASYNC
+
+#ifdef WASMTIME_FEATURE_STACK_SWITCHING
+  /// \brief Returns the current usage of this engine's continuation stack
+  /// cache.
+  ///
+  /// See `wasmtime_engine_continuation_stack_cache_stats` for more
+  /// information.
+  wasmtime_continuation_stack_cache_stats_t
+  continuation_stack_cache_stats() const {
+    wasmtime_continuation_stack_cache_stats_t stats;
+    wasmtime_engine_continuation_stack_cache_stats(ptr.get(), &stats);
+    return stats;
+  }
+#endif // WASMTIME_FEATURE_STACK_SWITCHING
 };
 
 } // namespace wasmtime
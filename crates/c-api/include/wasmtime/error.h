@@ -61,6 +61,24 @@ WASM_API_EXTERN void wasmtime_error_message(const wasmtime_error_t *error,
 WASM_API_EXTERN bool wasmtime_error_exit_status(const wasmtime_error_t *,
                                                 int *status);
 
+/**
+ * \brief Attempts to extract the code of a trap created with
+ * #wasmtime_trap_new_static from this error.
+ *
+ * Host functions returning such a trap make calls into WebAssembly fail with
+ * an error rather than a trap. Returns `true` and writes the code through the
+ * `code` pointer if this is such an error, or `false` otherwise.
+ */
+WASM_API_EXTERN bool wasmtime_error_static_code(const wasmtime_error_t *,
+                                                int32_t *code);
+
+/**
+ * \brief Returns whether this error is the result of compilation running past
+ * the deadline configured with #wasmtime_config_compile_deadline_set.
+ */
+WASM_API_EXTERN bool
+wasmtime_error_is_compile_deadline_exceeded(const wasmtime_error_t *);
+
 /**
  * \brief Attempts to extract a WebAssembly trace from this error.
  *
@@ -48,6 +48,22 @@ class Error {
     return std::nullopt;
   }
 
+  /// If this error was caused by a host function returning a trap created
+  /// with `Trap::from_static`, returns that trap's code.
+  std::optional<int32_t> static_code() const {
+    int32_t code = 0;
+    if (wasmtime_error_static_code(ptr.get(), &code)) {
+      return code;
+    }
+    return std::nullopt;
+  }
+
+  /// Returns whether this error is the result of compilation running past the
+  /// deadline configured with `Config::compile_deadline`.
+  bool compile_deadline_exceeded() const {
+    return wasmtime_error_is_compile_deadline_exceeded(ptr.get());
+  }
+
   /// Returns the trace of WebAssembly frames associated with this error.
   ///
   /// Note that the `trace` cannot outlive this error object.
@@ -87,6 +87,24 @@ typedef struct wasmtime_global {
   uint32_t __private3;
 } wasmtime_global_t;
 
+/// \brief Representation of a tag in Wasmtime.
+///
+/// Tags in Wasmtime are represented as an index into a store and don't
+/// have any data or destructor associated with the #wasmtime_tag_t value.
+/// Tags cannot interoperate between #wasmtime_store_t instances and if the
+/// wrong tag is passed to the wrong store then it may trigger an assertion
+/// to abort the process.
+typedef struct wasmtime_tag {
+  struct {
+    /// Internal identifier of what store this belongs to, never zero.
+    uint64_t store_id;
+    /// Private field for Wasmtime.
+    uint32_t __private1;
+  };
+  /// Private field for Wasmtime.
+  uint32_t __private2;
+} wasmtime_tag_t;
+
 /// \brief Discriminant of #wasmtime_extern_t
 typedef uint8_t wasmtime_extern_kind_t;
 
@@ -105,6 +123,9 @@ typedef uint8_t wasmtime_extern_kind_t;
 /// \brief Value of #wasmtime_extern_kind_t meaning that #wasmtime_extern_t is a
 /// shared memory
 #define WASMTIME_EXTERN_SHAREDMEMORY 4
+/// \brief Value of #wasmtime_extern_kind_t meaning that #wasmtime_extern_t is a
+/// tag
+#define WASMTIME_EXTERN_TAG 5
 
 /**
  * \typedef wasmtime_extern_union_t
@@ -127,6 +148,8 @@ typedef union wasmtime_extern_union {
   wasmtime_memory_t memory;
   /// Field used if #wasmtime_extern_t::kind is #WASMTIME_EXTERN_SHAREDMEMORY
   struct wasmtime_sharedmemory *sharedmemory;
+  /// Field used if #wasmtime_extern_t::kind is #WASMTIME_EXTERN_TAG
+  wasmtime_tag_t tag;
 } wasmtime_extern_union_t;
 
 /**
@@ -11,6 +11,7 @@
 #include <wasmtime/global.hh>
 #include <wasmtime/memory.hh>
 #include <wasmtime/table.hh>
+#include <wasmtime/tag.hh>
 
 namespace wasmtime {
 
@@ -27,6 +28,8 @@ static Extern cvt_extern(wasmtime_extern_t &e) {
     return Memory(e.of.memory);
   case WASMTIME_EXTERN_TABLE:
     return Table(e.of.table);
+  case WASMTIME_EXTERN_TAG:
+    return Tag(e.of.tag);
   }
   std::abort();
 }
@@ -44,6 +47,9 @@ static void cvt_extern(const Extern &e, wasmtime_extern_t &raw) {
   } else if (const auto *memory = std::get_if<Memory>(&e)) {
     raw.kind = WASMTIME_EXTERN_MEMORY;
     raw.of.memory = memory->capi();
+  } else if (const auto *tag = std::get_if<Tag>(&e)) {
+    raw.kind = WASMTIME_EXTERN_TAG;
+    raw.of.tag = tag->capi();
   } else {
     std::abort();
   }
@@ -58,6 +64,14 @@ inline std::optional<Extern> Caller::get_export(std::string_view name) {
   return std::nullopt;
 }
 
+inline std::optional<Memory> Caller::memory(uint32_t index) {
+  wasmtime_memory_t memory;
+  if (wasmtime_caller_memory(ptr, index, &memory)) {
+    return Memory(memory);
+  }
+  return std::nullopt;
+}
+
 } // namespace wasmtime
 
 #endif // WASMTIME_EXTERN_HH
@@ -10,6 +10,7 @@
 #include <wasm.h>
 #include <wasmtime/extern.h>
 #include <wasmtime/store.h>
+#include <wasmtime/trap.h>
 #include <wasmtime/val.h>
 
 #ifdef __cplusplus
@@ -155,6 +156,22 @@ WASM_API_EXTERN wasm_functype_t *
 wasmtime_func_type(const wasmtime_context_t *store,
                    const wasmtime_func_t *func);
 
+/**
+ * \brief Returns an opaque identifier for the type of the function specified.
+ *
+ * Two functions whose stores were created within the same #wasm_engine_t
+ * return the same identifier if and only if their types are precisely equal.
+ * Unlike #wasmtime_func_type this does not allocate, so it's suitable for
+ * checking, or caching the results of checking, the signature of many
+ * functions.
+ *
+ * Identifiers may be reused by the engine once no store, module, or type
+ * references the function type anymore, so they should not be retained beyond
+ * the lifetime of the `store` which owns `func`.
+ */
+WASM_API_EXTERN uint64_t wasmtime_func_type_index(
+    const wasmtime_context_t *store, const wasmtime_func_t *func);
+
 /**
  * \brief Call a WebAssembly function.
  *
@@ -231,6 +248,56 @@ wasmtime_func_call_unchecked(wasmtime_context_t *store,
                              wasmtime_val_raw_t *args_and_results,
                              size_t args_and_results_len, wasm_trap_t **trap);
 
+/**
+ * \brief Call a WebAssembly function many times in an "unchecked" fashion.
+ *
+ * This function is equivalent to invoking #wasmtime_func_call_unchecked
+ * `ncalls` times, in order, but amortizes the cost of crossing from the
+ * embedder into Wasmtime over all of the invocations.
+ *
+ * The `args_and_results` array is `args_and_results_len * ncalls` elements
+ * long and is interpreted as `ncalls` consecutive chunks of
+ * `args_and_results_len` elements each. Each chunk has the same contract as
+ * the `args_and_results` parameter of #wasmtime_func_call_unchecked: the
+ * parameters of one invocation are read from the start of the chunk and the
+ * results of that invocation are written to the start of the same chunk.
+ *
+ * Execution stops at the first invocation which returns an error or a trap.
+ * In all cases `ncompleted` is set to the number of invocations which
+ * finished successfully, so when an error or trap is returned it's also the
+ * index of the invocation that failed. Only the chunks of successful
+ * invocations contain results.
+ *
+ * All of the invariants of #wasmtime_func_call_unchecked must be upheld for
+ * each chunk.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_func_call_unchecked_many(
+    wasmtime_context_t *store, const wasmtime_func_t *func,
+    wasmtime_val_raw_t *args_and_results, size_t args_and_results_len,
+    size_t ncalls, size_t *ncompleted, wasm_trap_t **trap);
+
+/**
+ * \brief Call a WebAssembly function in an "unchecked" fashion, reporting
+ * traps only by their code.
+ *
+ * This is the same as #wasmtime_func_call_unchecked except for how traps are
+ * returned. If the function traps then `trapped` is set to `true`, `trap_code`
+ * is set to the trap's code and `NULL` is returned. No #wasm_trap_t is
+ * allocated and the trap's message and backtrace are discarded, which makes
+ * this suitable for guests that trap frequently, for example on timeouts. To
+ * also avoid capturing the backtrace in the first place see
+ * #wasmtime_context_set_wasm_backtrace.
+ *
+ * Otherwise `trapped` is set to `false`, and any other error, such as one
+ * returned by a host function, is returned as a #wasmtime_error_t.
+ *
+ * All of the invariants of #wasmtime_func_call_unchecked must be upheld.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_func_call_unchecked_trap_code(
+    wasmtime_context_t *store, const wasmtime_func_t *func,
+    wasmtime_val_raw_t *args_and_results, size_t args_and_results_len,
+    bool *trapped, wasmtime_trap_code_t *trap_code);
+
 /**
  * \brief Loads a #wasmtime_extern_t from the caller's context
  *
@@ -254,6 +321,47 @@ WASM_API_EXTERN bool wasmtime_caller_export_get(wasmtime_caller_t *caller,
                                                 size_t name_len,
                                                 wasmtime_extern_t *item);
 
+/**
+ * \brief Loads an exported memory from the caller's context by its index in
+ * the caller's memory index space.
+ *
+ * This is like #wasmtime_caller_export_get but avoids looking up the export by
+ * name, see #wasmtime_instance_memory for more information.
+ *
+ * \param caller the caller object to look up the memory from
+ * \param index the index of the memory, including imported memories
+ * \param memory where to store the return value
+ *
+ * Returns a nonzero value if the memory was found, or 0 otherwise in which case
+ * `memory` isn't written to.
+ */
+WASM_API_EXTERN bool wasmtime_caller_memory(wasmtime_caller_t *caller,
+                                            uint32_t index,
+                                            wasmtime_memory_t *memory);
+
+/**
+ * \brief Returns the base pointer and length of the caller's memory 0.
+ *
+ * This is like calling #wasmtime_caller_memory with index 0 and then
+ * #wasmtime_memory_data and #wasmtime_memory_data_size, but reads the
+ * memory's base pointer and length directly from the calling instance, so
+ * it's cheap enough to use on every call of a host function.
+ *
+ * The pointer and length are only valid until the host function returns or
+ * calls back into WebAssembly, which might grow the memory.
+ *
+ * \param caller the caller object to look up the memory from
+ * \param data where to store the base pointer of the memory
+ * \param data_size where to store the length of the memory, in bytes
+ *
+ * Returns a nonzero value if the caller exports its memory 0 and it isn't a
+ * shared memory, or 0 otherwise in which case `data` and `data_size` aren't
+ * written to.
+ */
+WASM_API_EXTERN bool wasmtime_caller_memory_data(wasmtime_caller_t *caller,
+                                                 uint8_t **data,
+                                                 size_t *data_size);
+
 /**
  * \brief Returns the store context of the caller object.
  */
@@ -6,6 +6,7 @@
 #define WASMTIME_FUNC_HH
 
 #include <array>
+#include <iterator>
 #include <wasmtime/error.hh>
 #include <wasmtime/extern_declare.hh>
 #include <wasmtime/func.h>
@@ -16,8 +17,25 @@
 #include <wasmtime/types/val.hh>
 #include <wasmtime/val.hh>
 
+// Native vector types which can be used as `v128` values, see `WasmType`.
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WASMTIME_V128_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__ARM_NEON) && defined(__BYTE_ORDER__) &&                          \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define WASMTIME_V128_NEON
+#include <arm_neon.h>
+#endif
+
 namespace wasmtime {
 
+#ifdef WASMTIME_FEATURE_ASYNC
+class Executor;
+class FuncCallAwaitable;
+#endif // WASMTIME_FEATURE_ASYNC
+
 /**
  * \brief Structure provided to host functions to lookup caller information or
  * acquire a `Store::Context`.
@@ -26,6 +44,7 @@ namespace wasmtime {
  * used to create a `Store::Context`.
  */
 class Caller {
+  friend class AsyncCompletion;
   friend class Func;
   friend class Store;
   wasmtime_caller_t *ptr;
@@ -38,6 +57,27 @@ public:
   /// https://docs.wasmtime.dev/api/wasmtime/struct.Caller.html#method.get_export
   std::optional<Extern> get_export(std::string_view name);
 
+  /// Loads an exported memory of the calling instance by its index in the
+  /// instance's memory index space, avoiding a lookup by name.
+  ///
+  /// For more information see the Rust documentation -
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Caller.html#method.memory
+  std::optional<Memory> memory(uint32_t index);
+
+  /// Returns the contents of the calling instance's memory 0, which are only
+  /// valid until this host function returns or calls back into WebAssembly.
+  ///
+  /// For more information see the Rust documentation -
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Caller.html#method.memory_and_data_mut
+  std::optional<Span<uint8_t>> memory_data() {
+    uint8_t *data = nullptr;
+    size_t size = 0;
+    if (wasmtime_caller_memory_data(ptr, &data, &size)) {
+      return Span<uint8_t>(data, size);
+    }
+    return std::nullopt;
+  }
+
   /// Explicitly acquire a `Store::Context` from this `Caller`.
   Store::Context context() { return this; }
 };
@@ -113,6 +153,36 @@ template <> struct WasmType<std::optional<ExternRef>> {
   }
 };
 
+/// Type information for `i31ref`, represented on the host as an optional
+/// `I31`.
+///
+/// `i31ref`s are unboxed so these are converted without rooting anything.
+template <> struct WasmType<std::optional<I31>> {
+  static const bool valid = true;
+  static const ValKind kind = ValKind::AnyRef;
+  static void store(Store::Context cx, wasmtime_val_raw_t *p,
+                    const std::optional<I31> &i31) {
+    if (i31) {
+      p->anyref = AnyRef::i31(cx, *i31).borrow_raw(cx);
+    } else {
+      p->anyref = 0;
+    }
+  }
+  static std::optional<I31> load(Store::Context cx, wasmtime_val_raw_t *p) {
+    if (p->anyref == 0) {
+      return std::nullopt;
+    }
+    wasmtime_anyref_t val;
+    wasmtime_anyref_from_raw(cx.capi(), p->anyref, &val);
+    auto i31 = AnyRef(val).i31(cx);
+    if (!i31) {
+      fprintf(stderr, "expected an i31ref but found another anyref");
+      abort();
+    }
+    return I31(*i31);
+  }
+};
+
 /// Type information for the `V128` host value used as a wasm value.
 template <> struct WasmType<V128> {
   static const bool valid = true;
@@ -127,6 +197,56 @@ template <> struct WasmType<V128> {
   }
 };
 
+/// Helper macro to define `WasmType` definitions for native vector types, such
+/// as `__m128i`, which are loaded and stored directly as `v128` values.
+// NOLINTNEXTLINE
+#define VECTOR_WASM_TYPE(native, store_fn, load_fn, ptr)                       \
+  template <> struct WasmType<native> {                                        \
+    static const bool valid = true;                                            \
+    static const ValKind kind = ValKind::V128;                                 \
+    static void store(Store::Context cx, wasmtime_val_raw_t *p,                \
+                      const native &t) {                                       \
+      (void)cx;                                                                \
+      store_fn(reinterpret_cast<ptr *>(&p->v128[0]), t);                       \
+    }                                                                          \
+    static native load(Store::Context cx, wasmtime_val_raw_t *p) {             \
+      (void)cx;                                                                \
+      return load_fn(reinterpret_cast<const ptr *>(&p->v128[0]));              \
+    }                                                                          \
+  };
+
+#ifdef WASMTIME_V128_SSE2
+// GCC warns that the alignment and aliasing attributes of these types are
+// ignored as template arguments, which doesn't affect these definitions.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+VECTOR_WASM_TYPE(__m128i, _mm_storeu_si128, _mm_loadu_si128, __m128i)
+VECTOR_WASM_TYPE(__m128, _mm_storeu_ps, _mm_loadu_ps, float)
+VECTOR_WASM_TYPE(__m128d, _mm_storeu_pd, _mm_loadu_pd, double)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+#ifdef WASMTIME_V128_NEON
+VECTOR_WASM_TYPE(int8x16_t, vst1q_s8, vld1q_s8, int8_t)
+VECTOR_WASM_TYPE(uint8x16_t, vst1q_u8, vld1q_u8, uint8_t)
+VECTOR_WASM_TYPE(int16x8_t, vst1q_s16, vld1q_s16, int16_t)
+VECTOR_WASM_TYPE(uint16x8_t, vst1q_u16, vld1q_u16, uint16_t)
+VECTOR_WASM_TYPE(int32x4_t, vst1q_s32, vld1q_s32, int32_t)
+VECTOR_WASM_TYPE(uint32x4_t, vst1q_u32, vld1q_u32, uint32_t)
+VECTOR_WASM_TYPE(int64x2_t, vst1q_s64, vld1q_s64, int64_t)
+VECTOR_WASM_TYPE(uint64x2_t, vst1q_u64, vld1q_u64, uint64_t)
+VECTOR_WASM_TYPE(float32x4_t, vst1q_f32, vld1q_f32, float)
+#ifdef __aarch64__
+VECTOR_WASM_TYPE(float64x2_t, vst1q_f64, vld1q_f64, double)
+#endif
+#endif
+
+#undef VECTOR_WASM_TYPE
+
 /// A "trait" for a list of types and operations on them, used for `Func::wrap`
 /// and `TypedFunc::call`
 ///
@@ -208,15 +328,18 @@ template <typename... T> struct WasmTypeList<std::tuple<T...>> {
 /// A "trait" for what can be returned from closures specified to `Func::wrap`.
 ///
 /// The base case here is a bare return value like `int32_t`.
+///
+/// The `invoke` functions here return the raw trap, if any, to hand back to
+/// Wasmtime so nothing needs to be constructed on the success path.
 template <typename R> struct WasmHostRet {
   using Results = WasmTypeList<R>;
 
   template <typename F, typename... A>
-  static std::optional<Trap> invoke(F f, Caller cx, wasmtime_val_raw_t *raw,
-                                    A... args) {
+  static wasm_trap_t *invoke(F &f, Caller cx, wasmtime_val_raw_t *raw,
+                             A... args) {
     auto ret = f(args...);
     Results::store(cx, raw, ret);
-    return std::nullopt;
+    return nullptr;
   }
 };
 
@@ -225,12 +348,12 @@ template <> struct WasmHostRet<void> {
   using Results = WasmTypeList<std::tuple<>>;
 
   template <typename F, typename... A>
-  static std::optional<Trap> invoke(F f, Caller cx, wasmtime_val_raw_t *raw,
-                                    A... args) {
+  static wasm_trap_t *invoke(F &f, Caller cx, wasmtime_val_raw_t *raw,
+                             A... args) {
     (void)cx;
     (void)raw;
     f(args...);
-    return std::nullopt;
+    return nullptr;
   }
 };
 
@@ -244,14 +367,14 @@ template <typename R> struct WasmHostRet<Result<R, Trap>> {
   using Results = WasmTypeList<R>;
 
   template <typename F, typename... A>
-  static std::optional<Trap> invoke(F f, Caller cx, wasmtime_val_raw_t *raw,
-                                    A... args) {
+  static wasm_trap_t *invoke(F &f, Caller cx, wasmtime_val_raw_t *raw,
+                             A... args) {
     Result<R, Trap> ret = f(args...);
     if (!ret) {
-      return ret.err();
+      return ret.err().capi_release();
     }
     Results::store(cx, raw, ret.ok());
-    return std::nullopt;
+    return nullptr;
   }
 };
 
@@ -264,7 +387,7 @@ template <typename R, typename... A> struct WasmHostFunc<R (*)(A...)> {
   using Results = typename WasmHostRet<R>::Results;
 
   template <typename F>
-  static std::optional<Trap> invoke(F &f, Caller cx, wasmtime_val_raw_t *raw) {
+  static wasm_trap_t *invoke(F &f, Caller cx, wasmtime_val_raw_t *raw) {
     auto params = Params::load(cx, raw);
     return std::apply(
         [&](const auto &...val) {
@@ -279,7 +402,7 @@ template <typename R, typename... A>
 struct WasmHostFunc<R (*)(Caller, A...)> : public WasmHostFunc<R (*)(A...)> {
   // Override `invoke` here to pass the `cx` as the first parameter
   template <typename F>
-  static std::optional<Trap> invoke(F &f, Caller cx, wasmtime_val_raw_t *raw) {
+  static wasm_trap_t *invoke(F &f, Caller cx, wasmtime_val_raw_t *raw) {
     auto params = WasmTypeList<std::tuple<A...>>::load(cx, raw);
     return std::apply(
         [&](const auto &...val) {
@@ -321,6 +444,8 @@ using namespace detail;
 
 // forward-declaration for `Func::typed` below.
 template <typename Params, typename Results> class TypedFunc;
+// forward-declaration for `Func::raw` below.
+class RawFunc;
 
 /**
  * \brief Representation of a WebAssembly function.
@@ -338,6 +463,7 @@ class Func {
   friend class Instance;
   friend class Linker;
   template <typename Params, typename Results> friend class TypedFunc;
+  friend class RawFunc;
 
   wasmtime_func_t func;
 
@@ -367,11 +493,20 @@ class Func {
                          size_t nargs_and_results) {
     (void)nargs_and_results;
     using HostFunc = WasmHostFunc<F>;
-    Caller cx(caller);
     F *func = reinterpret_cast<F *>(env); // NOLINT
-    auto trap = HostFunc::invoke(*func, cx, args_and_results);
-    if (trap) {
-      return trap->capi_release();
+    return HostFunc::invoke(*func, Caller(caller), args_and_results);
+  }
+
+  template <typename F>
+  static wasm_trap_t *raw_callback_raw(void *env, wasmtime_caller_t *caller,
+                                       wasmtime_val_raw_t *args_and_results,
+                                       size_t nargs_and_results) {
+    F *func = reinterpret_cast<F *>(env); // NOLINT
+    Result<std::monostate, Trap> result =
+        (*func)(Caller(caller),
+                Span<wasmtime_val_raw_t>(args_and_results, nargs_and_results));
+    if (!result) {
+      return result.err().capi_release();
     }
     return nullptr;
   }
@@ -478,6 +613,40 @@ public:
     return func;
   }
 
+  /**
+   * \brief Creates a new host function which operates directly on raw
+   * `wasmtime_val_raw_t` storage.
+   *
+   * This is the C++ analog of `wasmtime_func_new_unchecked`. The callback `f`
+   * is invoked with a `Caller` and a `Span<wasmtime_val_raw_t>` which holds
+   * the parameters of the call on entry, starting at index 0. Results must be
+   * written to the same span, also starting at index 0. The span is as long
+   * as the maximum of the number of parameters and results of `ty`.
+   *
+   * The parameter `f` is expected to return `Result<std::monostate, Trap>`.
+   *
+   * No conversions through `Val` are performed which makes this the
+   * cheapest way to define a host function whose signature is only known at
+   * runtime. The tradeoff is that this is an unsafe API: nothing checks that
+   * `f` interprets parameters or writes results in accordance with `ty`, and
+   * the same invariants as `wasmtime_func_new_unchecked` must be upheld.
+   *
+   * When the signature is known statically prefer `Func::wrap`, which is
+   * just as fast but type-safe.
+   */
+  template <typename F,
+            std::enable_if_t<
+                std::is_invocable_r_v<Result<std::monostate, Trap>, F, Caller,
+                                      Span<wasmtime_val_raw_t>>,
+                bool> = true>
+  static Func new_unchecked(Store::Context cx, const FuncType &ty, F f) {
+    wasmtime_func_t func;
+    wasmtime_func_new_unchecked(cx.ptr, ty.ptr.get(), raw_callback_raw<F>,
+                                std::make_unique<F>(f).release(),
+                                raw_finalize<F>, &func);
+    return func;
+  }
+
   /**
    * \brief Invoke a WebAssembly function.
    *
@@ -498,7 +667,8 @@ public:
    * > signature is statically known it's recommended to use `Func::typed` and
    * > `TypedFunc::call`.
    */
-  template <typename I>
+  template <typename I,
+            typename = typename std::iterator_traits<I>::iterator_category>
   TrapResult<std::vector<Val>> call(Store::Context cx, const I &begin,
                                     const I &end) const {
     std::vector<wasmtime_val_t> raw_params;
@@ -550,11 +720,80 @@ public:
     return this->call(cx, params.begin(), params.end());
   }
 
+  /**
+   * \brief Invoke a WebAssembly function, writing results into
+   * caller-provided storage.
+   *
+   * This is similar to `call(Store::Context cx, const I &begin, const I &end)`
+   * except that no intermediate vectors are allocated and the type of this
+   * function is not queried. Instead the `results` span must have exactly as
+   * many elements as this function returns, which callers typically compute
+   * once (e.g. via `type(cx)->results().size()`) and reuse alongside the same
+   * storage for all subsequent calls.
+   *
+   * Any previous values within `results` are unrooted before the call. On
+   * success `results` holds the values returned by the function. If a trap or
+   * error is returned then `results` is left holding `i32` zeros.
+   */
+  TrapResult<std::monostate> call(Store::Context cx, Span<const Val> params,
+                                  Span<Val> results) const {
+    for (auto &result : results) {
+      result = Val();
+    }
+
+    wasm_trap_t *trap = nullptr;
+    auto *error = wasmtime_func_call(
+        cx.ptr, &func,
+        reinterpret_cast<const wasmtime_val_t *>(params.data()), // NOLINT
+        params.size(),
+        reinterpret_cast<wasmtime_val_t *>(results.data()), // NOLINT
+        results.size(), &trap);
+    if (error != nullptr) {
+      return TrapError(Error(error));
+    }
+    if (trap != nullptr) {
+      return TrapError(Trap(trap));
+    }
+    return std::monostate();
+  }
+
+#ifdef WASMTIME_FEATURE_ASYNC
+  /**
+   * \brief Invoke a WebAssembly function asynchronously from a coroutine.
+   *
+   * The returned awaitable produces the same results as `call`, and when the
+   * call yields, for example due to fuel or epochs, the awaiting coroutine is
+   * suspended until `executor` has polled the call to completion. The store
+   * must be configured for async support, and `cx` must not be used for
+   * anything else until the call has completed.
+   *
+   * This is defined in `wasmtime/async.hh`, which must be included to use it.
+   */
+  FuncCallAwaitable call_async(Store::Context cx, std::vector<Val> params,
+                               Executor &executor) const;
+#endif // WASMTIME_FEATURE_ASYNC
+
   /// Returns the type of this function.
   FuncType type(Store::Context cx) const {
     return wasmtime_func_type(cx.ptr, &func);
   }
 
+  /**
+   * \brief Returns an opaque identifier for the type of this function.
+   *
+   * Functions in stores of the same `Engine` have equal identifiers if and
+   * only if their types are precisely equal. This is much cheaper than
+   * `type()` since no `FuncType` is created, making it suitable as a cache
+   * key for the results of `typed()` or of sizing results for `call()`, for
+   * example across many instances of the same module.
+   *
+   * Identifiers should not be retained beyond the lifetime of the store that
+   * owns this function since the engine may reuse them afterwards.
+   */
+  uint64_t type_index(Store::Context cx) const {
+    return wasmtime_func_type_index(cx.ptr, &func);
+  }
+
   /**
    * \brief Statically checks this function against the provided types.
    *
@@ -585,10 +824,36 @@ public:
     return ret;
   }
 
+  /**
+   * \brief Dynamically checks this function against the type `ty`.
+   *
+   * If this function's parameters and results have the same kinds as those
+   * of `ty` then a `RawFunc` is returned, which calls this function with
+   * untagged `wasmtime_val_raw_t` values. This is intended for dispatchers
+   * which don't know function types statically, so they can check a
+   * function's type once and then call it many times.
+   */
+  Result<RawFunc, Trap> raw(Store::Context cx, FuncType::Ref ty) const;
+
   /// Returns the raw underlying C API function this is using.
   const wasmtime_func_t &capi() const { return func; }
 };
 
+/**
+ * \brief Error returned from `TypedFunc::call_many`, identifying which of the
+ * invocations failed.
+ */
+struct CallManyError {
+  /// The index of the invocation which failed. All invocations before this
+  /// one completed successfully.
+  size_t index;
+  /// The trap or error raised by the failing invocation.
+  TrapError error;
+
+  /// Returns the message associated with `error`.
+  std::string message() const { return error.message(); }
+};
+
 /**
  * \brief A version of a WebAssembly `Func` where the type signature of the
  * function is statically known.
@@ -629,10 +894,222 @@ public:
     return WasmTypeList<Results>::load(cx, ptr);
   }
 
+  /**
+   * \brief Calls this function, reporting traps only by their code.
+   *
+   * This is the same as `call` except that a trap is returned as its
+   * `wasmtime_trap_code_t` rather than as a `Trap`, which avoids allocating
+   * the trap and its message. See `wasmtime_func_call_unchecked_trap_code`
+   * for more information.
+   */
+  TrapCodeResult<Results> call_trap_code(Store::Context cx,
+                                         const Params &params) const {
+    std::array<wasmtime_val_raw_t, std::max(WasmTypeList<Params>::size,
+                                            WasmTypeList<Results>::size)>
+        storage;
+    wasmtime_val_raw_t *ptr = storage.data();
+    if (ptr == nullptr)
+      ptr = reinterpret_cast<wasmtime_val_raw_t *>(alignof(wasmtime_val_raw_t));
+    WasmTypeList<Params>::store(cx, ptr, params);
+    bool trapped = false;
+    wasmtime_trap_code_t code = 0;
+    auto *error = wasmtime_func_call_unchecked_trap_code(
+        cx.capi(), &f.func, ptr, storage.size(), &trapped, &code);
+    if (error != nullptr) {
+      return TrapCodeError(Error(error));
+    }
+    if (trapped) {
+      return TrapCodeError(code);
+    }
+    return WasmTypeList<Results>::load(cx, ptr);
+  }
+
+  /**
+   * \brief Calls this function once for each element of `params`.
+   *
+   * This is equivalent to invoking `call` for each element of `params` in
+   * order, writing each invocation's results to the corresponding element of
+   * `results`, but all invocations are performed with a single call into the
+   * Wasmtime C API. This amortizes the fixed per-call overhead on the host
+   * side for workloads with many small calls to the same function.
+   *
+   * The `results` span must be at least as long as `params`. Execution stops
+   * at the first invocation which traps or fails, in which case the returned
+   * error holds that invocation's index and only the results of prior
+   * invocations have been written.
+   *
+   * This allocates a buffer for the raw values of the invocations on each
+   * call, see the overload taking a `scratch` buffer to avoid that.
+   */
+  Result<std::monostate, CallManyError>
+  call_many(Store::Context cx, Span<const Params> params,
+            Span<Results> results) const {
+    std::vector<wasmtime_val_raw_t> scratch;
+    return call_many(cx, params, results, scratch);
+  }
+
+  /**
+   * \brief Same as `call_many`, but stores the raw values of the invocations
+   * in `scratch`, which is resized as needed.
+   *
+   * Passing the same `scratch` buffer to repeated calls avoids allocating once
+   * it has grown large enough.
+   */
+  Result<std::monostate, CallManyError>
+  call_many(Store::Context cx, Span<const Params> params, Span<Results> results,
+            std::vector<wasmtime_val_raw_t> &scratch) const {
+    if (results.size() < params.size()) {
+      return CallManyError{0, Error("not enough space for call results")};
+    }
+    constexpr size_t stride =
+        std::max(WasmTypeList<Params>::size, WasmTypeList<Results>::size);
+    scratch.resize(stride * params.size());
+    auto &storage = scratch;
+    for (size_t i = 0; i < params.size(); i++) {
+      WasmTypeList<Params>::store(cx, storage.data() + i * stride, params[i]);
+    }
+
+    size_t completed = 0;
+    wasm_trap_t *trap = nullptr;
+    auto *error = wasmtime_func_call_unchecked_many(
+        cx.capi(), &f.func, storage.data(), stride, params.size(), &completed,
+        &trap);
+    for (size_t i = 0; i < completed; i++) {
+      results[i] = WasmTypeList<Results>::load(cx, storage.data() + i * stride);
+    }
+    if (error != nullptr) {
+      return CallManyError{completed, TrapError(Error(error))};
+    }
+    if (trap != nullptr) {
+      return CallManyError{completed, TrapError(Trap(trap))};
+    }
+    return std::monostate();
+  }
+
+  /// Returns the underlying un-typed `Func` for this function.
+  const Func &func() const { return f; }
+};
+
+/**
+ * \brief A version of a WebAssembly `Func` whose type has been checked, called
+ * with `wasmtime_val_raw_t` values.
+ *
+ * This is created with `Func::raw`. Compared to `Func::call` the type of the
+ * function isn't checked on each call, and parameters and results are stored
+ * in a caller-provided array of untagged values rather than in `Val`s.
+ *
+ * Reference values in these arrays are subject to the same requirements as
+ * for `wasmtime_func_call_unchecked`.
+ */
+class RawFunc {
+  friend class Func;
+  Func f;
+  size_t num_params;
+  size_t num_results;
+
+  RawFunc(Func func, size_t num_params, size_t num_results)
+      : f(func), num_params(num_params), num_results(num_results) {}
+
+  static bool same_kinds(ValType::ListRef a, ValType::ListRef b) {
+    if (a.size() != b.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+      if (a.begin()[i].kind() != b.begin()[i].kind()) { // NOLINT
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Returns a non-null pointer to the start of `span`, even if it's empty.
+  static wasmtime_val_raw_t *data(Span<wasmtime_val_raw_t> span) {
+    if (span.data() == nullptr)
+      return reinterpret_cast<wasmtime_val_raw_t *>(
+          alignof(wasmtime_val_raw_t));
+    return span.data();
+  }
+
+public:
+  /// Returns the number of parameters this function takes.
+  size_t params() const { return num_params; }
+
+  /// Returns the number of results this function returns.
+  size_t results() const { return num_results; }
+
+  /// Returns the number of values needed for each call, which is the larger
+  /// of the number of parameters and results.
+  size_t stride() const { return std::max(num_params, num_results); }
+
+  /**
+   * \brief Calls this function with the parameters in `args_and_results`.
+   *
+   * The parameters are read from the start of `args_and_results`, which must
+   * have at least `stride()` elements, and are overwritten with the results
+   * of the function if it returns successfully.
+   */
+  TrapResult<std::monostate>
+  call(Store::Context cx, Span<wasmtime_val_raw_t> args_and_results) const {
+    if (args_and_results.size() < stride()) {
+      return TrapError(Error("not enough space for call params and results"));
+    }
+    wasm_trap_t *trap = nullptr;
+    auto *error =
+        wasmtime_func_call_unchecked(cx.capi(), &f.func, data(args_and_results),
+                                     args_and_results.size(), &trap);
+    if (error != nullptr) {
+      return TrapError(Error(error));
+    }
+    if (trap != nullptr) {
+      return TrapError(Trap(trap));
+    }
+    return std::monostate();
+  }
+
+  /**
+   * \brief Calls this function `ncalls` times, with consecutive
+   * `stride()`-sized chunks of `args_and_results`.
+   *
+   * This is the raw equivalent of `TypedFunc::call_many`. Each chunk holds
+   * the parameters of one invocation and is overwritten with its results.
+   * Execution stops at the first invocation which traps or fails, in which
+   * case the returned error holds its index.
+   */
+  Result<std::monostate, CallManyError>
+  call_many(Store::Context cx, Span<wasmtime_val_raw_t> args_and_results,
+            size_t ncalls) const {
+    if (stride() != 0 && args_and_results.size() / stride() < ncalls) {
+      return CallManyError{0, Error("not enough space for call params and "
+                                    "results")};
+    }
+    size_t completed = 0;
+    wasm_trap_t *trap = nullptr;
+    auto *error = wasmtime_func_call_unchecked_many(
+        cx.capi(), &f.func, data(args_and_results), stride(), ncalls,
+        &completed, &trap);
+    if (error != nullptr) {
+      return CallManyError{completed, TrapError(Error(error))};
+    }
+    if (trap != nullptr) {
+      return CallManyError{completed, TrapError(Trap(trap))};
+    }
+    return std::monostate();
+  }
+
   /// Returns the underlying un-typed `Func` for this function.
   const Func &func() const { return f; }
 };
 
+inline Result<RawFunc, Trap> Func::raw(Store::Context cx,
+                                       FuncType::Ref ty) const {
+  auto actual = this->type(cx);
+  if (!RawFunc::same_kinds(actual->params(), ty.params()) ||
+      !RawFunc::same_kinds(actual->results(), ty.results())) {
+    return Trap("type for this function does not match the expected type");
+  }
+  return RawFunc(*this, ty.params().size(), ty.results().size());
+}
+
 inline Val::Val(std::optional<Func> func) : val{} {
   val.kind = WASMTIME_FUNCREF;
   if (func) {
@@ -77,6 +77,42 @@ WASM_API_EXTERN wasmtime_error_t *
 wasmtime_global_set(wasmtime_context_t *store, const wasmtime_global_t *global,
                     const wasmtime_val_t *val);
 
+/**
+ * \brief Get the value of the specified global in its raw representation.
+ *
+ * \param store the store that owns `global`
+ * \param global the global to get
+ * \param out where to store the value in this global
+ *
+ * This is the same as #wasmtime_global_get but avoids creating a
+ * #wasmtime_val_t, which is cheaper when the type of the global is already
+ * known. References are stored in `out` as they are for
+ * #wasmtime_func_call_unchecked.
+ */
+WASM_API_EXTERN void wasmtime_global_get_raw(wasmtime_context_t *store,
+                                             const wasmtime_global_t *global,
+                                             wasmtime_val_raw_t *out);
+
+/**
+ * \brief Sets a global to a new value given in its raw representation.
+ *
+ * \param store the store that owns `global`
+ * \param global the global to set
+ * \param val the value to store in the global, interpreted according to the
+ * type of `global`
+ *
+ * This function may return an error if `global` is not mutable. It's unsafe to
+ * call with a `val` of the wrong type for `global`, or with a reference not
+ * owned by `store`.
+ *
+ * This does not take ownership of any argument but returns ownership of the
+ * error.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_global_set_raw(wasmtime_context_t *store,
+                        const wasmtime_global_t *global,
+                        const wasmtime_val_raw_t *val);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -25,6 +25,8 @@ namespace wasmtime {
  * argument to the functions defined on `Global`. Note that if the wrong `Store`
  * is passed in then the process will be aborted.
  */
+template <typename T> class TypedGlobal;
+
 class Global {
   friend class Instance;
   wasmtime_global_t global;
@@ -75,10 +77,61 @@ public:
     return std::monostate();
   }
 
+  /**
+   * \brief Returns a `TypedGlobal` for this global, which reads and writes
+   * values of type `T` directly rather than as a `Val`.
+   *
+   * Returns an error if the type of this global doesn't match `T`. The valid
+   * types are those mentioned as the arguments for `Func::wrap`.
+   */
+  template <typename T,
+            std::enable_if_t<detail::WasmType<T>::valid, bool> = true>
+  Result<TypedGlobal<T>> typed(Store::Context cx) const {
+    if (type(cx)->content().kind() != detail::WasmType<T>::kind) {
+      return Error("static type for this global does not match actual type");
+    }
+    return TypedGlobal<T>(*this);
+  }
+
   /// Returns the raw underlying C API global this is using.
   const wasmtime_global_t &capi() const { return global; }
 };
 
+/**
+ * \brief A version of a WebAssembly `Global` where the type of its value is
+ * statically known, created with `Global::typed`.
+ */
+template <typename T> class TypedGlobal {
+  friend class Global;
+  Global global_;
+
+  TypedGlobal(Global global) : global_(global) {}
+
+public:
+  /// Returns the current value of this global.
+  T get(Store::Context cx) const {
+    wasmtime_val_raw_t raw;
+    wasmtime_global_get_raw(cx.capi(), &global_.capi(), &raw);
+    return detail::WasmType<T>::load(cx, &raw);
+  }
+
+  /// Sets this global to a new value.
+  ///
+  /// This can fail if this global isn't mutable.
+  Result<std::monostate> set(Store::Context cx, const T &val) const {
+    wasmtime_val_raw_t raw;
+    detail::WasmType<T>::store(cx, &raw, val);
+    auto *error = wasmtime_global_set_raw(cx.capi(), &global_.capi(), &raw);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::monostate();
+  }
+
+  /// Returns the underlying un-typed `Global`.
+  const Global &global() const { return global_; }
+};
+
 } // namespace wasmtime
 
 #endif // WASMTIME_GLOBAL_HH
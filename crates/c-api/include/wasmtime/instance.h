@@ -87,6 +87,73 @@ WASM_API_EXTERN bool wasmtime_instance_export_get(
     wasmtime_context_t *store, const wasmtime_instance_t *instance,
     const char *name, size_t name_len, wasmtime_extern_t *item);
 
+/**
+ * \brief Get an export using a precomputed module export index.
+ *
+ * \param store the store that owns `instance`
+ * \param instance the instance to lookup within
+ * \param export_ the export index from #wasmtime_module_get_export_index
+ * \param item where to store the returned value
+ *
+ * This is a faster alternative to #wasmtime_instance_export_get which avoids
+ * looking up the export by name. Returns nonzero if `instance` is an instance
+ * of the module that `export_` was created from, in which case `item` is
+ * filled in. Otherwise returns 0.
+ *
+ * Doesn't take ownership of any arguments but does return ownership of the
+ * #wasmtime_extern_t.
+ */
+WASM_API_EXTERN bool wasmtime_instance_export_get_index(
+    wasmtime_context_t *store, const wasmtime_instance_t *instance,
+    const wasmtime_module_export_t *export_, wasmtime_extern_t *item);
+
+/**
+ * \brief Get the number of calls made to a function defined by an instance's
+ * module.
+ *
+ * \param store the store that owns `instance`
+ * \param instance the instance to inspect
+ * \param index the index of the defined function, starting at zero for the
+ *   first function defined after any imported functions
+ * \param func_index where to store the function's index in the module's
+ *   function index space
+ * \param calls where to store the number of times the function was called
+ * \param name where to store a pointer to the function's name from the name
+ *   section, or `NULL` if it has none
+ * \param name_len where to store the byte length of `name`
+ *
+ * Returns nonzero if `index` is in bounds and the outputs are filled in, and
+ * zero otherwise. This always returns zero unless the module was compiled
+ * with #wasmtime_config_count_function_calls_set enabled. The `name` is owned
+ * by the store and is valid for as long as the store is.
+ */
+WASM_API_EXTERN bool wasmtime_instance_function_stats_nth(
+    const wasmtime_context_t *store, const wasmtime_instance_t *instance,
+    size_t index, uint32_t *func_index, uint64_t *calls, const char **name,
+    size_t *name_len);
+
+/**
+ * \brief Get an exported memory by its index in an instance's memory index
+ * space.
+ *
+ * \param store the store that owns `instance`
+ * \param instance the instance to lookup within
+ * \param index the index of the memory, including imported memories
+ * \param memory where to store the returned memory
+ *
+ * This is a faster alternative to #wasmtime_instance_export_get for host
+ * functions which repeatedly access a memory other than the first of a module
+ * using multiple memories. Returns nonzero if the memory at `index` exists, is
+ * exported, and isn't a shared memory, in which case `memory` is filled in.
+ * Otherwise returns 0.
+ *
+ * Doesn't take ownership of any arguments.
+ */
+WASM_API_EXTERN bool
+wasmtime_instance_memory(wasmtime_context_t *store,
+                         const wasmtime_instance_t *instance, uint32_t index,
+                         wasmtime_memory_t *memory);
+
 /**
  * \brief Get an export by index from an instance.
  *
@@ -160,7 +227,7 @@ WASM_API_EXTERN wasmtime_error_t *wasmtime_instance_pre_instantiate(
  * delete it via `wasmtime_module_delete`.
  */
 WASM_API_EXTERN wasmtime_module_t *
-wasmtime_instance_pre_module(wasmtime_instance_pre_t *instance_pre);
+wasmtime_instance_pre_module(const wasmtime_instance_pre_t *instance_pre);
 
 #ifdef __cplusplus
 } // extern "C"
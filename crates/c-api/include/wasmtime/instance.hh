@@ -90,6 +90,40 @@ public:
     return detail::cvt_extern(e);
   }
 
+  /**
+   * \brief Load an instance's export by a precomputed module export index.
+   *
+   * This is a faster alternative to looking up exports by name when the same
+   * export is loaded repeatedly, possibly across many instances of the same
+   * module. Returns `std::nullopt` if this instance isn't an instance of the
+   * module that `index` was created from.
+   */
+  std::optional<Extern> get(Store::Context cx, const ModuleExport &index) {
+    wasmtime_extern_t e;
+    if (!wasmtime_instance_export_get_index(cx.ptr, &instance, index.capi(),
+                                            &e)) {
+      return std::nullopt;
+    }
+    return detail::cvt_extern(e);
+  }
+
+  /**
+   * \brief Load an instance's exported memory by its index in the instance's
+   * memory index space.
+   *
+   * This is a faster alternative to looking up a memory by name for host
+   * functions which repeatedly access a memory other than the first of a
+   * module using multiple memories. Returns `std::nullopt` if there's no
+   * memory at `index`, if it isn't exported, or if it's a shared memory.
+   */
+  std::optional<Memory> memory(Store::Context cx, uint32_t index) {
+    wasmtime_memory_t memory;
+    if (!wasmtime_instance_memory(cx.ptr, &instance, index, &memory)) {
+      return std::nullopt;
+    }
+    return Memory(memory);
+  }
+
   /**
    * \brief Load an instance's export by index.
    *
@@ -111,6 +145,89 @@ public:
     std::string_view n(name, len);
     return std::pair(n, detail::cvt_extern(e));
   }
+
+  /// \brief The number of calls made to a function of an instance, as
+  /// returned by `Instance::function_stats`.
+  struct FunctionStats {
+    /// The index of the function in its module's function index space.
+    uint32_t index;
+    /// The name of the function from the module's name section, if any,
+    /// which is valid for as long as the store is.
+    std::optional<std::string_view> name;
+    /// The number of times the function has been called.
+    uint64_t calls;
+  };
+
+  /**
+   * \brief Returns the number of times each function defined by this
+   * instance's module has been called.
+   *
+   * This is empty unless the module was compiled with
+   * `Config::count_function_calls` enabled.
+   */
+  std::vector<FunctionStats> function_stats(Store::Context cx) const {
+    std::vector<FunctionStats> ret;
+    FunctionStats stats;
+    const char *name = nullptr;
+    size_t len = 0;
+    while (wasmtime_instance_function_stats_nth(cx.capi(), &instance,
+                                                ret.size(), &stats.index,
+                                                &stats.calls, &name, &len)) {
+      stats.name = std::nullopt;
+      if (name != nullptr) {
+        stats.name = std::string_view(name, len);
+      }
+      ret.push_back(stats);
+    }
+    return ret;
+  }
+};
+
+/**
+ * \brief A module which has had all of its imports resolved, ready to be
+ * instantiated.
+ *
+ * An `InstancePre` is created with `Linker::instantiate_pre` which performs
+ * all of the name resolution and type-checking of a module's imports up
+ * front. Repeatedly instantiating the module, for example into a fresh `Store`
+ * per request, then only needs to perform the actual instantiation.
+ *
+ * Note that imports defined into the `Linker` must not be tied to a
+ * particular store, for example host functions defined with
+ * `Linker::func_new` or `Linker::func_wrap`. An `InstancePre` can be shared
+ * between threads and used concurrently to instantiate into different stores.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.InstancePre.html
+ */
+class InstancePre {
+  WASMTIME_OWN_WRAPPER(InstancePre, wasmtime_instance_pre);
+
+  /**
+   * \brief Instantiates the module within the store `cx`, also running the
+   * module's start function, if any.
+   *
+   * This can fail if an import of the module can't be created within `cx`, or
+   * if the start function traps.
+   */
+  TrapResult<Instance> instantiate(Store::Context cx) const {
+    wasmtime_instance_t instance;
+    wasm_trap_t *trap = nullptr;
+    auto *error = wasmtime_instance_pre_instantiate(ptr.get(), cx.capi(),
+                                                    &instance, &trap);
+    if (error != nullptr) {
+      return TrapError(Error(error));
+    }
+    if (trap != nullptr) {
+      return TrapError(Trap(trap));
+    }
+    return Instance(instance);
+  }
+
+  /// Returns the module that this pre-instantiation will instantiate.
+  Module module() const {
+    return Module(wasmtime_instance_pre_module(ptr.get()));
+  }
 };
 
 } // namespace wasmtime
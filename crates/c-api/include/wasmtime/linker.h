@@ -139,6 +139,50 @@ WASM_API_EXTERN wasmtime_error_t *wasmtime_linker_define_func(
     const char *name, size_t name_len, const wasm_functype_t *ty,
     wasmtime_func_callback_t cb, void *data, void (*finalizer)(void *));
 
+/**
+ * \brief A host function to define with #wasmtime_linker_define_funcs.
+ */
+typedef struct wasmtime_linker_func_def {
+  /// The module name the function is defined under.
+  const char *module;
+  /// The byte length of `module`.
+  size_t module_len;
+  /// The field name the function is defined under.
+  const char *name;
+  /// The byte length of `name`.
+  size_t name_len;
+  /// The type of the function.
+  const wasm_functype_t *ty;
+  /// The host callback to invoke when the function is called.
+  wasmtime_func_callback_t callback;
+  /// The data to provide as the first argument to `callback`.
+  void *data;
+} wasmtime_linker_func_def_t;
+
+/**
+ * \brief Defines many host functions in this linker at once.
+ *
+ * \param linker the linker the functions are being defined in.
+ * \param defs the functions to define.
+ * \param len the number of functions in `defs`.
+ * \param env data shared by all of the functions, which is passed to
+ *        `finalizer`.
+ * \param finalizer an optional finalizer for `env`.
+ *
+ * \return On success `NULL` is returned, otherwise an error is returned which
+ * describes why a definition failed. Functions in `defs` before the one which
+ * failed remain defined.
+ *
+ * This is equivalent to calling #wasmtime_linker_define_func for each element
+ * of `defs`, except that the functions share a single finalizer. The
+ * `finalizer` is called with `env` once all of the functions defined by this
+ * call have been dropped, so the `data` of each definition may point into
+ * `env`. The `defs` array itself is not retained after this call returns.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_linker_define_funcs(
+    wasmtime_linker_t *linker, const wasmtime_linker_func_def_t *defs,
+    size_t len, void *env, void (*finalizer)(void *));
+
 /**
  * \brief Defines a new function in this linker.
  *
@@ -311,6 +355,68 @@ wasmtime_linker_instantiate_pre(const wasmtime_linker_t *linker,
                                 const wasmtime_module_t *module,
                                 wasmtime_instance_pre_t **instance_pre);
 
+/**
+ * \typedef wasmtime_frozen_linker_t
+ * \brief Convenience alias for #wasmtime_frozen_linker
+ *
+ * \struct wasmtime_frozen_linker
+ * \brief An immutable, reference-counted linker which can be shared between
+ * threads.
+ *
+ * A frozen linker is created from a #wasmtime_linker_t with
+ * #wasmtime_linker_freeze once all of its items have been defined. Its
+ * definitions can't change afterwards, so unlike a #wasmtime_linker_t it may
+ * be used to instantiate modules from any number of threads at the same
+ * time, without any locking. #wasmtime_frozen_linker_clone only increments a
+ * reference count, so each thread may also cheaply hold its own handle.
+ *
+ * Deleted with #wasmtime_frozen_linker_delete.
+ */
+typedef struct wasmtime_frozen_linker wasmtime_frozen_linker_t;
+
+/**
+ * \brief Freezes `linker`, returning an immutable linker with the same
+ * definitions.
+ *
+ * This function takes ownership of `linker` and does not copy its
+ * definitions. The returned frozen linker is owned by the caller.
+ */
+WASM_API_EXTERN wasmtime_frozen_linker_t *
+wasmtime_linker_freeze(wasmtime_linker_t *linker);
+
+/**
+ * \brief Returns a new handle to the same frozen linker.
+ */
+WASM_API_EXTERN wasmtime_frozen_linker_t *
+wasmtime_frozen_linker_clone(const wasmtime_frozen_linker_t *linker);
+
+/**
+ * \brief Deletes a handle to a frozen linker.
+ */
+WASM_API_EXTERN void
+wasmtime_frozen_linker_delete(wasmtime_frozen_linker_t *linker);
+
+/**
+ * \brief Same as #wasmtime_linker_instantiate, but for a frozen linker.
+ *
+ * This may be called concurrently from multiple threads with the same
+ * `linker`, as long as each call uses a different `store`.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_frozen_linker_instantiate(
+    const wasmtime_frozen_linker_t *linker, wasmtime_context_t *store,
+    const wasmtime_module_t *module, wasmtime_instance_t *instance,
+    wasm_trap_t **trap);
+
+/**
+ * \brief Same as #wasmtime_linker_instantiate_pre, but for a frozen linker.
+ *
+ * This may be called concurrently from multiple threads with the same
+ * `linker`.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_frozen_linker_instantiate_pre(
+    const wasmtime_frozen_linker_t *linker, const wasmtime_module_t *module,
+    wasmtime_instance_pre_t **instance_pre);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -5,17 +5,69 @@
 #ifndef WASMTIME_LINKER_HH
 #define WASMTIME_LINKER_HH
 
+#include <memory>
+#include <string>
+#include <vector>
 #include <wasmtime/engine.hh>
 #include <wasmtime/error.hh>
 #include <wasmtime/extern.hh>
 #include <wasmtime/helpers.hh>
 #include <wasmtime/instance.hh>
 #include <wasmtime/linker.h>
+#include <wasmtime/sharedmemory.hh>
 #include <wasmtime/store.hh>
 #include <wasmtime/trap.hh>
 
 namespace wasmtime {
 
+template <typename Env> class HostFuncLibrary;
+
+#ifdef WASMTIME_FEATURE_ASYNC
+class AsyncCompletion;
+class Executor;
+class InstantiateAwaitable;
+#endif // WASMTIME_FEATURE_ASYNC
+
+/**
+ * \brief An immutable linker which can be shared between threads, created
+ * with `Linker::freeze`.
+ *
+ * Copies of a `FrozenLinker` share the same definitions, and any number of
+ * threads may instantiate modules with it at the same time.
+ */
+class FrozenLinker {
+  WASMTIME_CLONE_WRAPPER(FrozenLinker, wasmtime_frozen_linker);
+
+  /// Instantiates the module `m` provided within the store `cx` using the items
+  /// defined within this linker.
+  TrapResult<Instance> instantiate(Store::Context cx, const Module &m) const {
+    wasmtime_instance_t instance;
+    wasm_trap_t *trap = nullptr;
+    auto *error = wasmtime_frozen_linker_instantiate(
+        ptr.get(), cx.ptr, m.capi(), &instance, &trap);
+    if (error != nullptr) {
+      return TrapError(Error(error));
+    }
+    if (trap != nullptr) {
+      return TrapError(Trap(trap));
+    }
+    return Instance(instance);
+  }
+
+  /// Performs all name resolution and type-checking required to instantiate
+  /// the module `m` with the items defined within this linker, returning an
+  /// `InstancePre` which can be cheaply instantiated many times.
+  Result<InstancePre> instantiate_pre(const Module &m) const {
+    wasmtime_instance_pre_t *instance_pre = nullptr;
+    auto *error = wasmtime_frozen_linker_instantiate_pre(ptr.get(), m.capi(),
+                                                         &instance_pre);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return InstancePre(instance_pre);
+  }
+};
+
 /**
  * \brief Helper class for linking modules together with name-based resolution.
  *
@@ -26,6 +78,23 @@ namespace wasmtime {
 class Linker {
   WASMTIME_OWN_WRAPPER(Linker, wasmtime_linker);
 
+private:
+  template <typename Env> struct HostFuncTable;
+
+  template <typename Entry>
+  static wasm_trap_t *raw_host_func(void *data, wasmtime_caller_t *caller,
+                                    const wasmtime_val_t *args, size_t nargs,
+                                    wasmtime_val_t *results, size_t nresults) {
+    auto *entry = static_cast<Entry *>(data);
+    auto func = [entry](Caller caller, Span<const Val> params,
+                        Span<Val> results) {
+      return entry->callback(entry->table->env, caller, params, results);
+    };
+    return Func::raw_callback<decltype(func)>(&func, caller, args, nargs,
+                                              results, nresults);
+  }
+
+public:
   /// Creates a new linker which will instantiate in the given engine.
   explicit Linker(Engine &engine) : ptr(wasmtime_linker_new(engine.capi())) {}
 
@@ -50,6 +119,22 @@ class Linker {
     return std::monostate();
   }
 
+  /// Defines the shared memory `memory` into this linker with the given name.
+  Result<std::monostate> define(Store::Context cx, std::string_view module,
+                                std::string_view name,
+                                const SharedMemory &memory) {
+    wasmtime_extern_t raw;
+    raw.kind = WASMTIME_EXTERN_SHAREDMEMORY;
+    raw.of.sharedmemory = const_cast<wasmtime_sharedmemory_t *>(memory.capi());
+    auto *error =
+        wasmtime_linker_define(ptr.get(), cx.ptr, module.data(), module.size(),
+                               name.data(), name.size(), &raw);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::monostate();
+  }
+
 #ifdef WASMTIME_FEATURE_WASI
   /// Defines WASI functions within this linker.
   ///
@@ -92,6 +177,42 @@ class Linker {
     return Instance(instance);
   }
 
+#ifdef WASMTIME_FEATURE_ASYNC
+  /**
+   * \brief Instantiates the module `m` asynchronously from a coroutine.
+   *
+   * This is the same as `instantiate` except that the returned awaitable
+   * suspends the awaiting coroutine, until `executor` has polled
+   * instantiation to completion, whenever instantiation yields. This is
+   * required when async host functions are defined in this linker.
+   *
+   * This is defined in `wasmtime/async.hh`, which must be included to use it.
+   */
+  InstantiateAwaitable instantiate_async(Store::Context cx, const Module &m,
+                                         Executor &executor);
+#endif // WASMTIME_FEATURE_ASYNC
+
+  /// Performs all name resolution and type-checking required to instantiate
+  /// the module `m` with the items defined within this linker, returning an
+  /// `InstancePre` which can be cheaply instantiated many times.
+  Result<InstancePre> instantiate_pre(const Module &m) const {
+    wasmtime_instance_pre_t *instance_pre = nullptr;
+    auto *error =
+        wasmtime_linker_instantiate_pre(ptr.get(), m.capi(), &instance_pre);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return InstancePre(instance_pre);
+  }
+
+  /// \brief Consumes this linker, returning a `FrozenLinker` with the same
+  /// definitions which can be shared between threads.
+  ///
+  /// The definitions are moved, not copied.
+  FrozenLinker freeze() && {
+    return FrozenLinker(wasmtime_linker_freeze(capi_release()));
+  }
+
   /// Defines instantiations of the module `m` within this linker under the
   /// given `name`.
   Result<std::monostate> module(Store::Context cx, std::string_view name,
@@ -141,6 +262,114 @@ class Linker {
     return std::monostate();
   }
 
+#ifdef WASMTIME_FEATURE_ASYNC
+  /**
+   * \brief Defines an asynchronous host function in this linker.
+   *
+   * This is similar to `func_new` except that `f` is invoked with a `Caller`,
+   * the arguments to the function, and an `AsyncCompletion`. The calling
+   * WebAssembly is suspended until `AsyncCompletion::complete` provides the
+   * function's results, which may happen after `f` returns. Modules using
+   * this function must be instantiated and called asynchronously, for example
+   * with `instantiate_async` and `Func::call_async`.
+   *
+   * This is defined in `wasmtime/async.hh`, which must be included to use it.
+   */
+  template <typename F>
+  Result<std::monostate> func_new_async(std::string_view module,
+                                        std::string_view name,
+                                        const FuncType &ty, F &&f);
+#endif // WASMTIME_FEATURE_ASYNC
+
+  /// \brief A host function defined with `define_funcs`.
+  ///
+  /// The `callback` receives the environment shared by all of the functions
+  /// defined together, along with the arguments of `Func`'s callbacks.
+  template <typename Env> struct HostFunc {
+    /// The module name the function is defined under.
+    std::string_view module;
+    /// The field name the function is defined under.
+    std::string_view name;
+    /// The type of the function.
+    FuncType ty;
+    /// The callback invoked when the function is called.
+    Result<std::monostate, Trap> (*callback)(Env &env, Caller caller,
+                                             Span<const Val> params,
+                                             Span<Val> results);
+  };
+
+private:
+  template <typename Env> struct HostFuncTable {
+    struct Entry {
+      HostFuncTable *table;
+      decltype(HostFunc<Env>::callback) callback;
+    };
+    Env env;
+    std::vector<Entry> entries;
+  };
+
+public:
+  /// \brief Defines all of the host functions in `funcs` in this linker,
+  /// sharing a single environment `env`.
+  ///
+  /// This is equivalent to calling `func_new` for each function, but the
+  /// functions share one allocation holding `env`, which is destroyed once
+  /// they've all been dropped. Functions before one which fails to be defined
+  /// remain defined.
+  template <typename Env>
+  Result<std::monostate> define_funcs(const std::vector<HostFunc<Env>> &funcs,
+                                      Env env) {
+    auto table = std::make_unique<HostFuncTable<Env>>(HostFuncTable<Env>{
+        std::move(env), {}});
+    table->entries.reserve(funcs.size());
+    std::vector<wasmtime_linker_func_def_t> defs;
+    defs.reserve(funcs.size());
+    for (const auto &func : funcs) {
+      auto &entry = table->entries.emplace_back(
+          typename HostFuncTable<Env>::Entry{table.get(), func.callback});
+      defs.push_back({func.module.data(), func.module.size(), func.name.data(),
+                      func.name.size(), func.ty.ptr.get(),
+                      raw_host_func<typename HostFuncTable<Env>::Entry>,
+                      &entry});
+    }
+    auto *error =
+        wasmtime_linker_define_funcs(ptr.get(), defs.data(), defs.size(),
+                                     table.release(),
+                                     Func::raw_finalize<HostFuncTable<Env>>);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::monostate();
+  }
+
+  /// \brief Defines all of the host functions in `library` in this linker.
+  ///
+  /// The functions share the library's environment, which isn't copied, and
+  /// the library's state is kept alive until the functions defined here have
+  /// been dropped along with every other copy of the library. Functions
+  /// before one which fails to be defined remain defined.
+  template <typename Env>
+  Result<std::monostate> define_library(const HostFuncLibrary<Env> &library) {
+    using State = typename HostFuncLibrary<Env>::State;
+    using Entry = typename HostFuncLibrary<Env>::Entry;
+    std::vector<wasmtime_linker_func_def_t> defs;
+    defs.reserve(library.state->entries.size());
+    for (auto &entry : library.state->entries) {
+      defs.push_back({entry.module.data(), entry.module.size(),
+                      entry.name.data(), entry.name.size(),
+                      entry.ty.ptr.get(), raw_host_func<Entry>, &entry});
+    }
+    using Owner = std::shared_ptr<State>;
+    auto owner = std::make_unique<Owner>(library.state);
+    auto *error = wasmtime_linker_define_funcs(ptr.get(), defs.data(),
+                                               defs.size(), owner.release(),
+                                               Func::raw_finalize<Owner>);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::monostate();
+  }
+
   /// Defines a new function in this linker in the style of the `Func::wrap`
   /// constructor.
   template <typename F,
@@ -166,6 +395,30 @@ class Linker {
     return std::monostate();
   }
 
+  /// Defines a new function in this linker in the style of the
+  /// `Func::new_unchecked` constructor.
+  template <typename F,
+            std::enable_if_t<
+                std::is_invocable_r_v<Result<std::monostate, Trap>, F, Caller,
+                                      Span<wasmtime_val_raw_t>>,
+                bool> = true>
+  Result<std::monostate> func_new_unchecked(std::string_view module,
+                                            std::string_view name,
+                                            const FuncType &ty, F &&f) {
+    auto *error = wasmtime_linker_define_func_unchecked(
+        ptr.get(), module.data(), module.length(), name.data(), name.length(),
+        ty.ptr.get(), Func::raw_callback_raw<std::remove_reference_t<F>>,
+        std::make_unique<std::remove_reference_t<F>>(std::forward<F>(f))
+            .release(),
+        Func::raw_finalize<std::remove_reference_t<F>>);
+
+    if (error != nullptr) {
+      return Error(error);
+    }
+
+    return std::monostate();
+  }
+
   /// Loads the "default" function, according to WASI commands and reactors, of
   /// the module named `name` in this linker.
   Result<Func> get_default(Store::Context cx, std::string_view name) {
@@ -203,6 +456,57 @@ class Linker {
   }
 };
 
+/**
+ * \brief A set of host functions sharing one environment, which can be
+ * defined in any number of linkers with `Linker::define_library`.
+ *
+ * The functions of a library don't belong to any store or engine, so one
+ * library can be defined in linkers of different engines without copying its
+ * environment or its functions' names and types. Copies of a library share the
+ * same state, which is destroyed once the last copy and the last function
+ * defined from it have been dropped.
+ *
+ * The environment is passed to callbacks by mutable reference, but callbacks
+ * may run concurrently on any thread which uses a linker the library is
+ * defined in, so any mutable state within it must be synchronized.
+ */
+template <typename Env> class HostFuncLibrary {
+  friend class Linker;
+
+  struct State;
+
+  struct Entry {
+    State *table;
+    decltype(Linker::HostFunc<Env>::callback) callback;
+    std::string module;
+    std::string name;
+    FuncType ty;
+  };
+
+  struct State {
+    Env env;
+    std::vector<Entry> entries;
+  };
+
+  std::shared_ptr<State> state;
+
+public:
+  /// Creates a new library of the host functions in `funcs`, which all share
+  /// the environment `env`.
+  HostFuncLibrary(const std::vector<Linker::HostFunc<Env>> &funcs, Env env)
+      : state(std::make_shared<State>(State{std::move(env), {}})) {
+    state->entries.reserve(funcs.size());
+    for (const auto &func : funcs) {
+      state->entries.push_back(Entry{state.get(), func.callback,
+                                     std::string(func.module),
+                                     std::string(func.name), func.ty});
+    }
+  }
+
+  /// Returns the environment shared by the functions of this library.
+  Env &env() const { return state->env; }
+};
+
 } // namespace wasmtime
 
 #endif // WASMTIME_LINKER_HH
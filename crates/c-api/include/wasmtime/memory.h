@@ -126,6 +126,114 @@ WASM_API_EXTERN wasmtime_error_t *
 wasmtime_memory_grow(wasmtime_context_t *store, const wasmtime_memory_t *memory,
                      uint64_t delta, uint64_t *prev_size);
 
+/**
+ * \brief Grows the specified memory by `delta` pages like
+ * #wasmtime_memory_grow, and then populates the newly accessible pages.
+ *
+ * Populating means that the host's pages are faulted in now rather than on
+ * their first access, trading memory for more predictable latency. It's
+ * best-effort, and growth itself behaves exactly like #wasmtime_memory_grow.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Memory.html#method.grow_populated.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_memory_grow_populated(wasmtime_context_t *store,
+                               const wasmtime_memory_t *memory, uint64_t delta,
+                               uint64_t *prev_size);
+
+/**
+ * \brief Maps part of a file copy-on-write into a linear memory.
+ *
+ * \param store the store that owns `memory`
+ * \param memory the memory to map the file into
+ * \param offset the byte offset within `memory` to map the file at
+ * \param fd an open file descriptor for the file to map
+ * \param file_offset the byte offset within the file to start mapping from
+ * \param len the number of bytes to map
+ *
+ * This replaces the contents of `memory` from `offset` to `offset + len` with
+ * the contents of the file starting at `file_offset`, without copying them.
+ * Writes to the mapped range are private to `memory` and never written back
+ * to the file. The file descriptor may be closed once this returns.
+ *
+ * All of `offset`, `file_offset` and `len` must be multiples of the host page
+ * size, and the range must be within both the current size of `memory` and
+ * the file. Mapping is only supported on Unix platforms, and only for
+ * memories whose virtual memory is allocated by Wasmtime. If any of these
+ * requirements aren't met then an error is returned.
+ *
+ * This function is unsafe: pointers previously returned by
+ * #wasmtime_memory_data into the mapped range must not be used after it
+ * returns, and the file must not be truncated while it's mapped, since
+ * accessing mapped pages past the end of the file raises `SIGBUS`.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Memory.html#method.map_file.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_memory_map_file(wasmtime_context_t *store,
+                         const wasmtime_memory_t *memory, size_t offset,
+                         int fd, uint64_t file_offset, size_t len);
+
+/**
+ * \brief Reports the byte ranges of a memory which lie on written pages.
+ *
+ * \param store the store that owns `memory`
+ * \param memory the memory to find the dirty pages of
+ * \param callback invoked with `env` and each range, from `start` to `end`
+ * \param env the first argument passed to `callback`
+ *
+ * Ranges are reported in ascending order, and a page stays dirty until it's
+ * restored with #wasmtime_memory_reset_dirty_to_image. This is only supported
+ * on Linux 6.7 and later, and an error is returned on other platforms. If an
+ * error is returned then `callback` may have already been invoked.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Memory.html#method.dirty_pages.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_memory_dirty_pages(
+    wasmtime_context_t *store, const wasmtime_memory_t *memory,
+    void (*callback)(void *env, size_t start, size_t end), void *env);
+
+/**
+ * \brief Reports the number of sampled accesses to each page of a memory.
+ *
+ * \param store the store that owns `memory`
+ * \param memory the memory to report the accesses of
+ * \param callback invoked with `env`, and the index and count of each page
+ * \param env the first argument passed to `callback`
+ *
+ * `callback` is invoked once for each of the memory's current pages, in
+ * ascending order. Accesses are only sampled when enabled with
+ * #wasmtime_config_memory_access_sampling_set, and otherwise every count is
+ * zero.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Memory.html#method.access_histogram.
+ */
+WASM_API_EXTERN void wasmtime_memory_access_histogram(
+    const wasmtime_context_t *store, const wasmtime_memory_t *memory,
+    void (*callback)(void *env, uint64_t page, uint64_t count), void *env);
+
+/**
+ * \brief Restores the written pages of a memory to their original contents.
+ *
+ * \param store the store that owns `memory`
+ * \param memory the memory to reset
+ *
+ * Only the pages reported by #wasmtime_memory_dirty_pages are reset, either
+ * to the contents of the module's copy-on-write memory image or to zeros. An
+ * error is returned in the same situations as #wasmtime_memory_dirty_pages,
+ * and also if `memory` wasn't initialized from a copy-on-write image.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Memory.html#method.reset_dirty_to_image.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_memory_reset_dirty_to_image(wasmtime_context_t *store,
+                                     const wasmtime_memory_t *memory);
+
 /**
  * \brief Returns the size of a page, in bytes, for this memory.
  *
@@ -5,6 +5,11 @@
 #ifndef WASMTIME_MEMORY_HH
 #define WASMTIME_MEMORY_HH
 
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <wasmtime/error.hh>
 #include <wasmtime/memory.h>
 #include <wasmtime/span.hh>
@@ -63,6 +68,134 @@ public:
     return {base, size};
   }
 
+  /**
+   * \brief Returns a view of `count` values of type `T` in this memory
+   * starting at `offset`.
+   *
+   * `T` must be trivially copyable, and can be `const`-qualified for a
+   * read-only view. This fails if the range is out of bounds or if `offset`
+   * isn't suitably aligned for `T` in the host. Note that the view is
+   * invalidated in the same way as the result of `data`.
+   */
+  template <typename T>
+  Result<Span<T>> view(Store::Context cx, uint64_t offset,
+                       size_t count) const {
+    static_assert(std::is_trivially_copyable_v<std::remove_cv_t<T>>,
+                  "memory can only be viewed as trivially copyable types");
+    auto data = this->data(cx);
+    if (count > data.size() / sizeof(T) ||
+        !in_bounds(data, offset, count * sizeof(T))) {
+      return out_of_bounds();
+    }
+    auto *ptr = data.data() + offset;
+    if (reinterpret_cast<uintptr_t>(ptr) % alignof(T) != 0) {
+      return Error("misaligned memory access");
+    }
+    return Span<T>(reinterpret_cast<T *>(ptr), count);
+  }
+
+  /// Same as `view` above, except that the view has a static extent of `N`
+  /// values, which lets the compiler specialize code for its size.
+  template <typename T, size_t N>
+  Result<Span<T, N>> view(Store::Context cx, uint64_t offset) const {
+    auto view = this->view<T>(cx, offset, N);
+    if (!view) {
+      return view.err();
+    }
+    return Span<T, N>(view.ok().data(), N);
+  }
+
+  /// Copies `dst.size()` bytes of this memory starting at `offset` into `dst`.
+  ///
+  /// Fails, leaving `dst` untouched, if the range is out of bounds.
+  Result<std::monostate> read(Store::Context cx, uint64_t offset,
+                              Span<uint8_t> dst) const {
+    auto data = this->data(cx);
+    if (!in_bounds(data, offset, dst.size())) {
+      return out_of_bounds();
+    }
+    std::memcpy(dst.data(), data.data() + offset, dst.size());
+    return std::monostate();
+  }
+
+  /// Copies `src` into this memory starting at `offset`.
+  ///
+  /// Fails, leaving the memory untouched, if the range is out of bounds.
+  Result<std::monostate> write(Store::Context cx, uint64_t offset,
+                               Span<const uint8_t> src) const {
+    auto data = this->data(cx);
+    if (!in_bounds(data, offset, src.size())) {
+      return out_of_bounds();
+    }
+    std::memcpy(data.data() + offset, src.data(), src.size());
+    return std::monostate();
+  }
+
+  /// Reads consecutive bytes of this memory starting at `offset` into each of
+  /// the buffers in `dsts` in turn, like `readv`.
+  ///
+  /// The whole range is bounds-checked once up front, so either all of the
+  /// buffers are filled or, if the range is out of bounds, none are.
+  Result<std::monostate> read_vectored(Store::Context cx, uint64_t offset,
+                                       Span<const Span<uint8_t>> dsts) const {
+    auto data = this->data(cx);
+    if (!in_bounds(data, offset, total_size(dsts))) {
+      return out_of_bounds();
+    }
+    for (const auto &dst : dsts) {
+      std::memcpy(dst.data(), data.data() + offset, dst.size());
+      offset += dst.size();
+    }
+    return std::monostate();
+  }
+
+  /// Writes each of the buffers in `srcs` in turn to consecutive bytes of this
+  /// memory starting at `offset`, like `writev`.
+  ///
+  /// The whole range is bounds-checked once up front, so either all of the
+  /// buffers are written or, if the range is out of bounds, none are.
+  Result<std::monostate>
+  write_vectored(Store::Context cx, uint64_t offset,
+                 Span<const Span<const uint8_t>> srcs) const {
+    auto data = this->data(cx);
+    if (!in_bounds(data, offset, total_size(srcs))) {
+      return out_of_bounds();
+    }
+    for (const auto &src : srcs) {
+      std::memcpy(data.data() + offset, src.data(), src.size());
+      offset += src.size();
+    }
+    return std::monostate();
+  }
+
+  /// Copies `len` bytes of this memory from offset `src` to offset `dst`,
+  /// like wasm's `memory.copy`. The two ranges may overlap.
+  ///
+  /// Fails, leaving the memory untouched, if either range is out of bounds.
+  Result<std::monostate> copy_within(Store::Context cx, uint64_t dst,
+                                     uint64_t src, uint64_t len) const {
+    auto data = this->data(cx);
+    if (!in_bounds(data, dst, len) || !in_bounds(data, src, len)) {
+      return out_of_bounds();
+    }
+    std::memmove(data.data() + dst, data.data() + src, len);
+    return std::monostate();
+  }
+
+  /// Sets `len` bytes of this memory starting at `offset` to `value`, like
+  /// wasm's `memory.fill`.
+  ///
+  /// Fails, leaving the memory untouched, if the range is out of bounds.
+  Result<std::monostate> fill(Store::Context cx, uint64_t offset,
+                              uint8_t value, uint64_t len) const {
+    auto data = this->data(cx);
+    if (!in_bounds(data, offset, len)) {
+      return out_of_bounds();
+    }
+    std::memset(data.data() + offset, value, len);
+    return std::monostate();
+  }
+
   /// Grows the memory by `delta` WebAssembly pages.
   ///
   /// On success returns the previous size of this memory in units of
@@ -76,6 +209,73 @@ public:
     return prev;
   }
 
+  /// Grows the memory by `delta` WebAssembly pages like `grow`, and then
+  /// populates the newly accessible pages so they're not faulted in on first
+  /// access.
+  ///
+  /// On success returns the previous size of this memory in units of
+  /// WebAssembly pages.
+  Result<uint64_t> grow_populated(Store::Context cx, uint64_t delta) const {
+    uint64_t prev = 0;
+    auto *error =
+        wasmtime_memory_grow_populated(cx.ptr, &memory, delta, &prev);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return prev;
+  }
+
+  /// \brief Maps `len` bytes of the file `fd`, starting at `file_offset`,
+  /// copy-on-write into this memory at byte `offset`.
+  ///
+  /// See `wasmtime_memory_map_file` for the requirements on the arguments,
+  /// and for why this is unsafe: any `Span` previously returned by `data`
+  /// which overlaps the mapped range must not be used afterwards.
+  Result<std::monostate> map_file(Store::Context cx, size_t offset, int fd,
+                                  uint64_t file_offset, size_t len) const {
+    auto *error = wasmtime_memory_map_file(cx.ptr, &memory, offset, fd,
+                                           file_offset, len);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::monostate();
+  }
+
+  /// \brief Returns the `[start, end)` byte ranges of this memory which lie on
+  /// pages that have been written to.
+  ///
+  /// See `wasmtime_memory_dirty_pages` for when this is supported.
+  Result<std::vector<std::pair<size_t, size_t>>>
+  dirty_pages(Store::Context cx) const {
+    std::vector<std::pair<size_t, size_t>> ranges;
+    auto *error =
+        wasmtime_memory_dirty_pages(cx.ptr, &memory, push_range, &ranges);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return ranges;
+  }
+
+  /// \brief Returns the number of sampled accesses to each page of this
+  /// memory.
+  ///
+  /// See `Config::memory_access_sampling` for enabling sampling.
+  std::vector<uint64_t> access_histogram(Store::Context cx) const {
+    std::vector<uint64_t> counts;
+    wasmtime_memory_access_histogram(cx.ptr, &memory, push_count, &counts);
+    return counts;
+  }
+
+  /// \brief Restores the pages reported by `dirty_pages` to their contents
+  /// when this memory was instantiated.
+  Result<std::monostate> reset_dirty_to_image(Store::Context cx) const {
+    auto *error = wasmtime_memory_reset_dirty_to_image(cx.ptr, &memory);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::monostate();
+  }
+
   /// Returns the size of a page, in bytes, for this memory.
   ///
   /// WebAssembly memories are made up of a whole number of pages, so the byte
@@ -111,6 +311,31 @@ public:
 
   /// Returns the raw underlying C API memory this is using.
   const wasmtime_memory_t &capi() const { return memory; }
+
+private:
+  static bool in_bounds(Span<uint8_t> data, uint64_t offset, uint64_t len) {
+    return offset <= data.size() && len <= data.size() - offset;
+  }
+
+  template <typename T> static uint64_t total_size(Span<const Span<T>> bufs) {
+    uint64_t total = 0;
+    for (const auto &buf : bufs) {
+      total += buf.size();
+    }
+    return total;
+  }
+
+  static Error out_of_bounds() { return Error("out of bounds memory access"); }
+
+  static void push_range(void *env, size_t start, size_t end) {
+    static_cast<std::vector<std::pair<size_t, size_t>> *>(env)->emplace_back(
+        start, end);
+  }
+
+  static void push_count(void *env, uint64_t page, uint64_t count) {
+    (void)page;
+    static_cast<std::vector<uint64_t> *>(env)->push_back(count);
+  }
 };
 
 } // namespace wasmtime
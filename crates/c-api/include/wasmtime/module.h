@@ -49,6 +49,223 @@ WASM_API_EXTERN wasmtime_error_t *wasmtime_module_new(wasm_engine_t *engine,
                                                       size_t wasm_len,
                                                       wasmtime_module_t **ret);
 
+/**
+ * \brief Compiles the WebAssembly module in the file at `path` into a
+ * #wasmtime_module_t.
+ *
+ * This function is the same as #wasmtime_module_new except that the module is
+ * compiled directly from a memory mapping of the file, instead of from a buffer
+ * holding a copy of all of it. Function bodies are validated as they're
+ * compiled, in parallel if parallel compilation is enabled.
+ *
+ * The file must not be modified or truncated while it's being compiled.
+ *
+ * This function does not take ownership of any of its arguments, but the
+ * returned error and module are owned by the caller.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_module_compile_file(wasm_engine_t *engine, const char *path,
+                             wasmtime_module_t **ret);
+
+/**
+ * \typedef wasmtime_compile_report_t
+ * \brief Convenience alias for #wasmtime_compile_report
+ *
+ * \struct wasmtime_compile_report
+ * \brief Per-function measurements of the cost of compiling a module.
+ *
+ * Created with #wasmtime_module_new_with_report and deleted with
+ * #wasmtime_compile_report_delete.
+ */
+typedef struct wasmtime_compile_report wasmtime_compile_report_t;
+
+/**
+ * \brief Measurements taken while compiling a single function, as returned by
+ * #wasmtime_compile_report_get.
+ *
+ * Stages a compiler doesn't have, such as the IR stages of Winch, are reported
+ * as zero.
+ */
+typedef struct wasmtime_function_compile_stats {
+  /// The index of the function in the module's function index space.
+  uint32_t index;
+  /// The function's name from the `name` section, not NUL-terminated, or
+  /// `NULL` if it has none. Owned by the report it was returned from.
+  const char *name;
+  /// The length of `name` in bytes.
+  size_t name_len;
+  /// Total time spent compiling the function, in nanoseconds.
+  uint64_t total_time_nanos;
+  /// Time spent translating wasm to the compiler's IR, in nanoseconds.
+  uint64_t translation_time_nanos;
+  /// Time spent in IR optimization passes, in nanoseconds.
+  uint64_t optimization_time_nanos;
+  /// Time spent lowering IR to machine instructions, in nanoseconds.
+  uint64_t lowering_time_nanos;
+  /// Time spent in register allocation, in nanoseconds.
+  uint64_t regalloc_time_nanos;
+  /// Time spent emitting machine code, in nanoseconds.
+  uint64_t emission_time_nanos;
+  /// The number of IR instructions after translation.
+  size_t translated_ir_insts;
+  /// The number of IR instructions after optimization.
+  size_t optimized_ir_insts;
+  /// The size of the function's machine code in bytes.
+  size_t code_size;
+} wasmtime_function_compile_stats_t;
+
+/**
+ * \brief Same as #wasmtime_module_new, but also returns a report of the time
+ * spent compiling, and the code size of, each function in the module.
+ *
+ * On success both `ret` and `report` are filled in and owned by the caller.
+ * This always compiles the module, bypassing any configured cache.
+ *
+ * For more details see:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.CodeBuilder.html#method.compile_module_with_report
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_module_new_with_report(
+    wasm_engine_t *engine, const uint8_t *wasm, size_t wasm_len,
+    wasmtime_module_t **ret, wasmtime_compile_report_t **report);
+
+/**
+ * \brief Deletes a compile report.
+ */
+WASM_API_EXTERN void
+wasmtime_compile_report_delete(wasmtime_compile_report_t *report);
+
+/**
+ * \brief Returns the number of functions in a compile report.
+ */
+WASM_API_EXTERN size_t
+wasmtime_compile_report_len(const wasmtime_compile_report_t *report);
+
+/**
+ * \brief Fills in `out` with the measurements of the `index`th function of
+ * the report.
+ *
+ * Functions are ordered by their index in the module. Returns `false` if
+ * `index` is out of bounds.
+ */
+WASM_API_EXTERN bool
+wasmtime_compile_report_get(const wasmtime_compile_report_t *report,
+                            size_t index,
+                            wasmtime_function_compile_stats_t *out);
+
+/**
+ * \typedef wasmtime_lazy_module_t
+ * \brief Convenience alias for #wasmtime_lazy_module
+ *
+ * \struct wasmtime_lazy_module
+ * \brief A WebAssembly module which is compiled on first use.
+ *
+ * Created with #wasmtime_lazy_module_new and deleted with
+ * #wasmtime_lazy_module_delete.
+ */
+typedef struct wasmtime_lazy_module wasmtime_lazy_module_t;
+
+/**
+ * \brief Validates a WebAssembly binary and creates a module from it which is
+ * compiled the first time #wasmtime_lazy_module_get is called.
+ *
+ * On success the returned module is owned by the caller.
+ *
+ * For more details see:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.LazyModule.html#method.new
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_lazy_module_new(wasm_engine_t *engine, const uint8_t *wasm,
+                         size_t wasm_len, wasmtime_lazy_module_t **ret);
+
+/**
+ * \brief Deletes a lazy module.
+ */
+WASM_API_EXTERN void wasmtime_lazy_module_delete(wasmtime_lazy_module_t *m);
+
+/**
+ * \brief Returns the compiled module in `ret`, compiling it first if it
+ * hasn't been compiled yet.
+ *
+ * This blocks if the module is being compiled by another thread. The returned
+ * error and module are owned by the caller.
+ *
+ * For more details see:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.LazyModule.html#method.get
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_lazy_module_get(const wasmtime_lazy_module_t *module,
+                         wasmtime_module_t **ret);
+
+/**
+ * \brief Starts compiling a lazy module on a background thread, if it isn't
+ * compiled or being compiled already.
+ */
+WASM_API_EXTERN void
+wasmtime_lazy_module_warm(const wasmtime_lazy_module_t *module);
+
+/**
+ * \brief Returns whether a lazy module has finished compiling.
+ */
+WASM_API_EXTERN bool
+wasmtime_lazy_module_is_compiled(const wasmtime_lazy_module_t *module);
+
+/**
+ * \typedef wasmtime_module_builder_t
+ * \brief Convenience alias for #wasmtime_module_builder
+ *
+ * \struct wasmtime_module_builder
+ * \brief A builder for a module whose WebAssembly binary arrives in chunks.
+ *
+ * Created with #wasmtime_module_builder_new and deleted with
+ * #wasmtime_module_builder_delete.
+ */
+typedef struct wasmtime_module_builder wasmtime_module_builder_t;
+
+/**
+ * \brief Creates a new builder for a module compiled for `engine`.
+ *
+ * This function does not take ownership of `engine` and the returned builder
+ * is owned by the caller.
+ */
+WASM_API_EXTERN wasmtime_module_builder_t *
+wasmtime_module_builder_new(wasm_engine_t *engine);
+
+/**
+ * \brief Deletes a module builder.
+ */
+WASM_API_EXTERN void
+wasmtime_module_builder_delete(wasmtime_module_builder_t *builder);
+
+/**
+ * \brief Appends the next chunk of a WebAssembly binary to `builder`.
+ *
+ * The input is parsed and its structure validated as far as possible as soon
+ * as it's fed, so an error is returned as soon as the binary is known to be
+ * malformed. Function bodies are validated by
+ * #wasmtime_module_builder_finish while compiling them. After an error the
+ * builder should be deleted.
+ *
+ * For more details see:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.ModuleBuilder.html#method.feed
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_module_builder_feed(wasmtime_module_builder_t *builder,
+                             const uint8_t *bytes, size_t bytes_len);
+
+/**
+ * \brief Compiles the WebAssembly binary fed to `builder` into a module.
+ *
+ * This can only be called once for each builder, which must still be deleted
+ * with #wasmtime_module_builder_delete afterwards. The returned error and
+ * module are owned by the caller.
+ *
+ * For more details see:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.ModuleBuilder.html#method.finish
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_module_builder_finish(wasmtime_module_builder_t *builder,
+                               wasmtime_module_t **ret);
+
 #endif // WASMTIME_FEATURE_COMPILER
 
 /**
@@ -74,6 +291,69 @@ WASM_API_EXTERN void wasmtime_module_imports(const wasmtime_module_t *module,
 WASM_API_EXTERN void wasmtime_module_exports(const wasmtime_module_t *module,
                                              wasm_exporttype_vec_t *out);
 
+/**
+ * \brief Returns the types imported by `module` without copying them.
+ *
+ * Like #wasmtime_module_imports except that the list is created on the first
+ * call and cached within `module`, so later calls don't allocate. The
+ * returned list is owned by `module` and is valid until `module` is deleted.
+ * It must not be deleted or modified by the caller.
+ *
+ * Note that the cache is per #wasmtime_module_t, so clones of `module` made
+ * with #wasmtime_module_clone have their own caches.
+ */
+WASM_API_EXTERN const wasm_importtype_vec_t *
+wasmtime_module_import_types(const wasmtime_module_t *module);
+
+/**
+ * \brief Returns the types exported by `module` without copying them.
+ *
+ * This is the same as #wasmtime_module_import_types but for exports.
+ */
+WASM_API_EXTERN const wasm_exporttype_vec_t *
+wasmtime_module_export_types(const wasmtime_module_t *module);
+
+/**
+ * \typedef wasmtime_module_export_t
+ * \brief Convenience alias for #wasmtime_module_export
+ *
+ * \struct wasmtime_module_export
+ * \brief A precomputed index of an export of a #wasmtime_module_t.
+ *
+ * This type is created with #wasmtime_module_get_export_index and can be used
+ * with #wasmtime_instance_export_get_index to load an export from any instance
+ * of the module it was created from without looking up the export by name.
+ */
+typedef struct wasmtime_module_export wasmtime_module_export_t;
+
+/**
+ * \brief Looks up the export named `name` in `module`, returning a
+ * precomputed index for it.
+ *
+ * \param module the module to look up the export in
+ * \param name the name of the export
+ * \param name_len the byte length of `name`
+ *
+ * Returns `NULL` if `module` has no export named `name`, otherwise returns an
+ * owned #wasmtime_module_export_t which must be deleted with
+ * #wasmtime_module_export_delete.
+ */
+WASM_API_EXTERN wasmtime_module_export_t *
+wasmtime_module_get_export_index(const wasmtime_module_t *module,
+                                 const char *name, size_t name_len);
+
+/**
+ * \brief Creates a copy of the specified export index.
+ */
+WASM_API_EXTERN wasmtime_module_export_t *
+wasmtime_module_export_clone(const wasmtime_module_export_t *export_);
+
+/**
+ * \brief Deletes an export index.
+ */
+WASM_API_EXTERN void
+wasmtime_module_export_delete(wasmtime_module_export_t *export_);
+
 #ifdef WASMTIME_FEATURE_COMPILER
 
 /**
@@ -108,6 +388,51 @@ wasmtime_module_validate(wasm_engine_t *engine, const uint8_t *wasm,
 WASM_API_EXTERN wasmtime_error_t *
 wasmtime_module_serialize(wasmtime_module_t *module, wasm_byte_vec_t *ret);
 
+/**
+ * \brief Compiles a batch of modules, serializing each of them.
+ *
+ * The `count` WebAssembly binaries to compile are described by the arrays
+ * `wasm` and `wasm_lens`. On success each of the `count` byte vectors in
+ * `ret` is initialized with the serialized form of the corresponding module,
+ * as with #wasmtime_module_serialize, and must be deleted by the caller. On
+ * failure `ret` isn't touched.
+ *
+ * Modules in the batch are compiled in parallel with one another and
+ * identical inputs are only compiled once.
+ *
+ * For more details see:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Engine.html#method.precompile_modules
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_engine_precompile_modules(
+    wasm_engine_t *engine, const uint8_t *const *wasm, const size_t *wasm_lens,
+    size_t count, wasm_byte_vec_t *ret);
+
+/**
+ * \brief Callback which receives the next `len` bytes of a serialized module
+ * at `data`, returning whether they were written successfully.
+ */
+typedef bool (*wasmtime_module_serialize_callback_t)(void *env,
+                                                     const uint8_t *data,
+                                                     size_t len);
+
+/**
+ * \brief Same as #wasmtime_module_serialize except that the serialized module
+ * is passed to `callback` rather than copied into a byte vector.
+ *
+ * The bytes passed to `callback` come directly from the module's in-memory
+ * image, which for example allows writing a serialized module to a file or
+ * socket without making a copy of it first. The `callback` is called one or
+ * more times with successive pieces of the serialized module and `env`, and
+ * if it returns `false` serialization stops and an error is returned.
+ *
+ * This function does not take ownership of `module`, and the caller is
+ * expected to deallocate the returned #wasmtime_error_t.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_module_serialize_to(wasmtime_module_t *module,
+                             wasmtime_module_serialize_callback_t callback,
+                             void *env);
+
 #endif // WASMTIME_FEATURE_COMPILER
 
 /**
@@ -124,6 +449,66 @@ WASM_API_EXTERN wasmtime_error_t *
 wasmtime_module_deserialize(wasm_engine_t *engine, const uint8_t *bytes,
                             size_t bytes_len, wasmtime_module_t **ret);
 
+/**
+ * \brief Deserialize a module in-place from caller-owned memory.
+ *
+ * This function is the same as #wasmtime_module_deserialize except that the
+ * serialized module in `bytes` is used directly rather than copied. This
+ * allows, for example, many processes to share the physical pages of a module
+ * mapped from shared memory.
+ *
+ * The memory pointed to by `bytes` must remain valid and unmodified until
+ * `finalizer` is called with `data`, which happens once the returned module
+ * and all of its instances have been deleted, or if this function returns an
+ * error. The `finalizer` may be `NULL`.
+ *
+ * Wasmtime never changes the protection of this memory, so unless the engine
+ * uses the Pulley interpreter (see #wasmtime_engine_is_pulley) the memory
+ * must already be mapped executable.
+ *
+ * This function is not safe to receive arbitrary user input. See the Rust
+ * documentation for more information on what inputs are safe to pass in here
+ * (e.g. only that of `wasmtime_module_serialize`)
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_module_deserialize_raw(
+    wasm_engine_t *engine, const uint8_t *bytes, size_t bytes_len, void *data,
+    void (*finalizer)(void *), wasmtime_module_t **ret);
+
+/**
+ * \brief Sizes read from the headers of a serialized module by
+ * #wasmtime_module_inspect_serialized.
+ */
+typedef struct wasmtime_serialized_module_info {
+  /// The size, in bytes, of the whole serialized module.
+  size_t image_size;
+  /// The size, in bytes, of the executable code in the serialized module.
+  uint64_t text_size;
+  /// The size, in bytes, of the module's data segments.
+  uint64_t wasm_data_size;
+} wasmtime_serialized_module_info_t;
+
+/**
+ * \brief Reads the headers of a serialized module and checks whether it can
+ * be deserialized with `engine`.
+ *
+ * This is much cheaper than #wasmtime_module_deserialize since only the
+ * artifact's headers and embedded engine configuration are read. The contents
+ * of the artifact are not validated though, so a compatible artifact may
+ * still fail to deserialize.
+ *
+ * Returns an error if `bytes` doesn't look like a serialized module at all.
+ * Otherwise `info` is filled in and `incompatibility` is set to `NULL` if the
+ * module is compatible with `engine`, or to an error describing why it isn't
+ * which is owned by the caller.
+ *
+ * For more details see:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Module.html#method.inspect_serialized
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_module_inspect_serialized(
+    wasm_engine_t *engine, const uint8_t *bytes, size_t bytes_len,
+    wasmtime_serialized_module_info_t *info,
+    wasmtime_error_t **incompatibility);
+
 /**
  * \brief Deserialize a module from an on-disk file.
  *
@@ -142,6 +527,59 @@ WASM_API_EXTERN wasmtime_error_t *
 wasmtime_module_deserialize_file(wasm_engine_t *engine, const char *path,
                                  wasmtime_module_t **ret);
 
+/**
+ * \typedef wasmtime_shared_code_registry_t
+ * \brief Convenience alias for #wasmtime_shared_code_registry
+ *
+ * \struct wasmtime_shared_code_registry
+ * \brief A directory of serialized modules shared between processes.
+ *
+ * Modules deserialized through a registry are mapped from a file within its
+ * directory, holding one copy of each distinct artifact, so all processes
+ * using the same directory share the memory of identical modules.
+ *
+ * Created with #wasmtime_shared_code_registry_new and deleted with
+ * #wasmtime_shared_code_registry_delete.
+ */
+typedef struct wasmtime_shared_code_registry wasmtime_shared_code_registry_t;
+
+/**
+ * \brief Creates a registry storing its serialized modules in `dir`, creating
+ * the directory if it doesn't exist.
+ *
+ * On success the returned registry is owned by the caller.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_shared_code_registry_new(const char *dir,
+                                  wasmtime_shared_code_registry_t **ret);
+
+/**
+ * \brief Deletes a shared code registry.
+ *
+ * Modules deserialized through the registry remain valid.
+ */
+WASM_API_EXTERN void wasmtime_shared_code_registry_delete(
+    wasmtime_shared_code_registry_t *registry);
+
+/**
+ * \brief Deserializes a module through a shared code registry.
+ *
+ * This function is the same as #wasmtime_module_deserialize except that the
+ * module is mapped from the registry's copy of `bytes`, which is first written
+ * to the registry's directory if it's not already present there.
+ *
+ * This function does not take ownership of any of its arguments, but the
+ * returned error and module are owned by the caller.
+ *
+ * This function is not safe to receive arbitrary user input, and the files
+ * within the registry's directory must not be modified while modules
+ * deserialized from them are alive. For more details see:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.SharedCodeRegistry.html#method.deserialize
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_shared_code_registry_deserialize(
+    const wasmtime_shared_code_registry_t *registry, wasm_engine_t *engine,
+    const uint8_t *bytes, size_t bytes_len, wasmtime_module_t **ret);
+
 /**
  * \brief Returns the range of bytes in memory where this module’s compilation
  * image resides.
@@ -157,6 +595,76 @@ WASM_API_EXTERN void
 wasmtime_module_image_range(const wasmtime_module_t *module, void **start,
                             void **end);
 
+/**
+ * \brief An estimate of the resources needed by a module, filled in by
+ * #wasmtime_module_resource_estimate.
+ *
+ * Memories and tables imported by the module aren't included.
+ */
+typedef struct wasmtime_module_resource_estimate {
+  /// The size, in bytes, of the module's compiled code object, shared by all
+  /// of its instances.
+  size_t code_bytes;
+  /// The size, in bytes, of the executable code within the code object.
+  size_t text_bytes;
+  /// The size, in bytes, of the module's data segments within the code
+  /// object.
+  size_t data_bytes;
+  /// The number of linear memories defined by the module.
+  size_t memories;
+  /// The sum of the minimum sizes, in bytes, of the module's defined linear
+  /// memories.
+  uint64_t min_memory_bytes;
+  /// The number of tables defined by the module.
+  size_t tables;
+  /// The sum of the minimum number of elements of the module's defined
+  /// tables.
+  uint64_t min_table_elements;
+  /// The size, in bytes, of the host state allocated for each instance.
+  size_t instance_bytes;
+} wasmtime_module_resource_estimate_t;
+
+/**
+ * \brief Estimates the resources needed by `module` and each of its instances
+ * from its compiled metadata, without instantiating it.
+ *
+ * For more details see:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Module.html#method.resource_estimate
+ */
+WASM_API_EXTERN void
+wasmtime_module_resource_estimate(const wasmtime_module_t *module,
+                                  wasmtime_module_resource_estimate_t *out);
+
+#ifdef WASMTIME_FEATURE_CRANELIFT
+
+/**
+ * \brief Returns the optimized tier of a module compiled with tiered
+ * compilation, or `NULL` if it isn't available yet.
+ *
+ * The returned module, if any, is owned by the caller.
+ *
+ * For more details see:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Module.html#method.optimized_tier
+ */
+WASM_API_EXTERN wasmtime_module_t *
+wasmtime_module_optimized_tier(const wasmtime_module_t *module);
+
+/**
+ * \brief Blocks until the optimized tier of a module compiled with tiered
+ * compilation is available and returns it in `ret`.
+ *
+ * If `module` wasn't compiled with tiering then a clone of it is returned.
+ * The returned error and module are owned by the caller.
+ *
+ * For more details see:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Module.html#method.wait_optimized_tier
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_module_wait_optimized_tier(const wasmtime_module_t *module,
+                                    wasmtime_module_t **ret);
+
+#endif // WASMTIME_FEATURE_CRANELIFT
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -6,7 +6,12 @@
 #define WASMTIME_MODULE_HH
 
 #include <memory>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
 #include <wasmtime/engine.hh>
 #include <wasmtime/helpers.hh>
 #include <wasmtime/module.h>
@@ -17,6 +22,59 @@
 
 namespace wasmtime {
 
+/**
+ * \brief A precomputed index of an export of a `Module`.
+ *
+ * Created with `Module::export_index` and used with `Instance::get` to load an
+ * export from any instance of that module without a by-name lookup.
+ */
+class ModuleExport {
+  WASMTIME_CLONE_WRAPPER(ModuleExport, wasmtime_module_export);
+};
+
+#ifdef WASMTIME_FEATURE_COMPILER
+/// \brief Measurements taken while compiling a single function.
+using FunctionCompileStats = wasmtime_function_compile_stats_t;
+
+/**
+ * \brief Per-function measurements of the cost of compiling a module.
+ *
+ * Created with `Module::compile_with_report`.
+ */
+class CompileReport {
+  WASMTIME_OWN_WRAPPER(CompileReport, wasmtime_compile_report);
+
+  /// \brief Returns the number of functions in this report.
+  size_t size() const { return wasmtime_compile_report_len(capi()); }
+
+  /// \brief Returns the measurements of the `index`th function, ordered by
+  /// index in the module, or `std::nullopt` if `index` is out of bounds.
+  std::optional<FunctionCompileStats> get(size_t index) const {
+    FunctionCompileStats stats;
+    if (!wasmtime_compile_report_get(capi(), index, &stats)) {
+      return std::nullopt;
+    }
+    return stats;
+  }
+};
+#endif // WASMTIME_FEATURE_COMPILER
+
+/**
+ * \brief Information read from the headers of a serialized module by
+ * `Module::inspect_serialized`.
+ */
+struct SerializedModuleInfo {
+  /// Sizes read from the serialized module's headers.
+  wasmtime_serialized_module_info_t sizes;
+  /// Why the module can't be deserialized by the engine it was inspected
+  /// with, or `std::nullopt` if it can be.
+  std::optional<std::string> incompatibility;
+
+  /// \brief Returns whether the module can be deserialized by the engine it
+  /// was inspected with.
+  bool compatible() const { return !incompatibility.has_value(); }
+};
+
 /**
  * \brief Representation of a compiled WebAssembly module.
  *
@@ -32,16 +90,24 @@ class Module {
   /**
    * \brief Compiles a module from the WebAssembly text format.
    *
-   * This function will automatically use `wat2wasm` on the input and then
-   * delegate to the #compile function.
+   * This is the same as #compile_wat.
    */
   static Result<Module> compile(Engine &engine, std::string_view wat) {
-    auto wasm = wat2wasm(wat);
+    return compile_wat(engine, wat);
+  }
+
+  /**
+   * \brief Compiles a module from the WebAssembly text format.
+   *
+   * This function will automatically use `wat2wasm_bytes` on the input and
+   * then compile the resulting buffer directly, without copying it.
+   */
+  static Result<Module> compile_wat(Engine &engine, std::string_view wat) {
+    auto wasm = wat2wasm_bytes(wat);
     if (!wasm) {
       return wasm.err();
     }
-    auto bytes = wasm.ok();
-    return compile(engine, bytes);
+    return compile(engine, wasm.ok_ref());
   }
 
   /**
@@ -64,6 +130,43 @@ class Module {
     return Module(ret);
   }
 
+  /**
+   * \brief Compiles the WebAssembly module in the file at `path`.
+   *
+   * This is the same as `compile` except that the module is compiled directly
+   * from a memory mapping of the file rather than a copy of its contents. The
+   * file must not be modified or truncated while it's being compiled.
+   *
+   * https://docs.wasmtime.dev/api/wasmtime/struct.Module.html#method.from_mapped_file
+   */
+  static Result<Module> compile_file(Engine &engine, const std::string &path) {
+    wasmtime_module_t *ret = nullptr;
+    auto *error =
+        wasmtime_module_compile_file(engine.capi(), path.c_str(), &ret);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return Module(ret);
+  }
+
+  /**
+   * \brief Same as `compile`, but also returns a report of the time spent
+   * compiling, and the code size of, each function in the module.
+   *
+   * https://docs.wasmtime.dev/api/wasmtime/struct.CodeBuilder.html#method.compile_module_with_report
+   */
+  static Result<std::pair<Module, CompileReport>>
+  compile_with_report(Engine &engine, Span<uint8_t> wasm) {
+    wasmtime_module_t *ret = nullptr;
+    wasmtime_compile_report_t *report = nullptr;
+    auto *error = wasmtime_module_new_with_report(
+        engine.capi(), wasm.data(), wasm.size(), &ret, &report);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::make_pair(Module(ret), CompileReport(report));
+  }
+
   /**
    * \brief Validates the provided WebAssembly binary without compiling it.
    *
@@ -102,6 +205,53 @@ class Module {
     return Module(ret);
   }
 
+  /**
+   * \brief Reads the headers of a serialized module and checks whether it
+   * can be deserialized with `engine`.
+   *
+   * See `wasmtime_module_inspect_serialized` for more information.
+   */
+  static Result<SerializedModuleInfo> inspect_serialized(Engine &engine,
+                                                         Span<uint8_t> bytes) {
+    SerializedModuleInfo info;
+    wasmtime_error_t *incompatibility = nullptr;
+    auto *error = wasmtime_module_inspect_serialized(
+        engine.capi(), bytes.data(), bytes.size(), &info.sizes,
+        &incompatibility);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    if (incompatibility != nullptr) {
+      info.incompatibility = Error(incompatibility).message();
+    }
+    return info;
+  }
+
+  /**
+   * \brief Deserializes a module in-place from caller-owned memory.
+   *
+   * This function is the same as `deserialize` except that `wasm` is used
+   * directly instead of being copied. The memory must remain valid and
+   * unmodified until `release` is invoked, which happens once the returned
+   * module and all of its instances are gone, or if deserialization fails.
+   *
+   * It is not safe to pass arbitrary input to this function, see
+   * `wasmtime_module_deserialize_raw` for more information.
+   */
+  template <typename F>
+  static Result<Module> deserialize_raw(Engine &engine, Span<uint8_t> wasm,
+                                        F release) {
+    wasmtime_module_t *ret = nullptr;
+    auto *error = wasmtime_module_deserialize_raw(
+        engine.capi(), wasm.data(), wasm.size(),
+        std::make_unique<F>(std::move(release)).release(), raw_release<F>,
+        &ret);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return Module(ret);
+  }
+
   /**
    * \brief Deserializes a module from an on-disk file.
    *
@@ -139,6 +289,52 @@ class Module {
     return list;
   }
 
+  /// \brief Returns the types imported by this module, without allocating
+  /// after the first call.
+  ///
+  /// The returned view is cached within this module and is valid for as long
+  /// as this module is alive.
+  Span<const ImportType::Ref> import_types() const {
+    const auto *list = wasmtime_module_import_types(ptr.get());
+    return {reinterpret_cast<const ImportType::Ref *>(list->data), // NOLINT
+            list->size};
+  }
+
+  /// \brief Returns the types exported by this module, without allocating
+  /// after the first call.
+  ///
+  /// The returned view is cached within this module and is valid for as long
+  /// as this module is alive.
+  Span<const ExportType::Ref> export_types() const {
+    const auto *list = wasmtime_module_export_types(ptr.get());
+    return {reinterpret_cast<const ExportType::Ref *>(list->data), // NOLINT
+            list->size};
+  }
+
+  /**
+   * \brief Looks up the export `name` of this module, returning an index
+   * which can be used to quickly load that export from instances of this
+   * module with `Instance::get`.
+   *
+   * Returns `std::nullopt` if this module has no export named `name`.
+   */
+  std::optional<ModuleExport> export_index(std::string_view name) const {
+    auto *ret =
+        wasmtime_module_get_export_index(ptr.get(), name.data(), name.size());
+    if (ret == nullptr) {
+      return std::nullopt;
+    }
+    return ModuleExport(ret);
+  }
+
+  /// \brief Estimates the resources needed by this module and each of its
+  /// instances, without instantiating it.
+  wasmtime_module_resource_estimate_t resource_estimate() const {
+    wasmtime_module_resource_estimate_t estimate;
+    wasmtime_module_resource_estimate(ptr.get(), &estimate);
+    return estimate;
+  }
+
 #ifdef WASMTIME_FEATURE_COMPILER
   /**
    * \brief Serializes this module to a list of bytes.
@@ -147,19 +343,238 @@ class Module {
    * quickly recreate this module in a different process perhaps.
    */
   Result<std::vector<uint8_t>> serialize() const {
-    wasm_byte_vec_t bytes;
-    auto *error = wasmtime_module_serialize(ptr.get(), &bytes);
+    std::vector<uint8_t> ret;
+    auto result = serialize_to([&ret](Span<const uint8_t> bytes) {
+      ret.insert(ret.end(), bytes.begin(), bytes.end());
+      return true;
+    });
+    if (!result) {
+      return result.err();
+    }
+    return ret;
+  }
+
+  /**
+   * \brief Compiles a batch of modules, returning the serialized form of
+   * each.
+   *
+   * Modules in the batch are compiled in parallel with one another and
+   * identical inputs are only compiled once. The returned artifacts can be
+   * passed to `deserialize`.
+   */
+  static Result<std::vector<std::vector<uint8_t>>>
+  precompile_batch(Engine &engine, const std::vector<Span<uint8_t>> &wasm) {
+    std::vector<const uint8_t *> ptrs;
+    std::vector<size_t> lens;
+    for (auto &module : wasm) {
+      ptrs.push_back(module.data());
+      lens.push_back(module.size());
+    }
+    std::vector<wasm_byte_vec_t> artifacts(wasm.size());
+    auto *error = wasmtime_engine_precompile_modules(
+        engine.capi(), ptrs.data(), lens.data(), wasm.size(), artifacts.data());
     if (error != nullptr) {
       return Error(error);
     }
-    std::vector<uint8_t> ret;
-    // NOLINTNEXTLINE TODO can this be done without triggering lints?
-    Span<uint8_t> raw(reinterpret_cast<uint8_t *>(bytes.data), bytes.size);
-    ret.assign(raw.begin(), raw.end());
-    wasm_byte_vec_delete(&bytes);
+    std::vector<std::vector<uint8_t>> ret;
+    for (auto &artifact : artifacts) {
+      // NOLINTNEXTLINE TODO can this be done without triggering lints?
+      auto *data = reinterpret_cast<uint8_t *>(artifact.data);
+      ret.emplace_back(data, data + artifact.size);
+      wasm_byte_vec_delete(&artifact);
+    }
     return ret;
   }
+
+  /**
+   * \brief Serializes this module, passing the bytes to `write` instead of
+   * returning them.
+   *
+   * The `write` callable receives successive pieces of the serialized module
+   * as a `Span<const uint8_t>` and returns whether it wrote them
+   * successfully. The pieces come directly from the module's in-memory image
+   * so no copy of the whole artifact is made.
+   */
+  template <typename F> Result<std::monostate> serialize_to(F &&write) const {
+    auto *error = wasmtime_module_serialize_to(ptr.get(), raw_write<F>, &write);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::monostate();
+  }
+#endif // WASMTIME_FEATURE_COMPILER
+
+#ifdef WASMTIME_FEATURE_CRANELIFT
+  /**
+   * \brief Returns the optimized tier of this module, if it was compiled with
+   * tiered compilation and that tier has finished compiling.
+   *
+   * https://docs.wasmtime.dev/api/wasmtime/struct.Module.html#method.optimized_tier
+   */
+  std::optional<Module> optimized_tier() const {
+    auto *ret = wasmtime_module_optimized_tier(ptr.get());
+    if (ret == nullptr) {
+      return std::nullopt;
+    }
+    return Module(ret);
+  }
+
+  /**
+   * \brief Blocks until the optimized tier of this module is available and
+   * returns it.
+   *
+   * https://docs.wasmtime.dev/api/wasmtime/struct.Module.html#method.wait_optimized_tier
+   */
+  Result<Module> wait_optimized_tier() const {
+    wasmtime_module_t *ret = nullptr;
+    auto *error = wasmtime_module_wait_optimized_tier(ptr.get(), &ret);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return Module(ret);
+  }
+#endif // WASMTIME_FEATURE_CRANELIFT
+
+private:
+  template <typename F>
+  static bool raw_write(void *env, const uint8_t *data, size_t len) {
+    auto &write = *static_cast<std::remove_reference_t<F> *>(env);
+    return write(Span<const uint8_t>(data, len));
+  }
+
+  template <typename F> static void raw_release(void *env) {
+    std::unique_ptr<F> release(static_cast<F *>(env));
+    (*release)();
+  }
+};
+
+#ifdef WASMTIME_FEATURE_COMPILER
+/**
+ * \brief A WebAssembly module which is compiled on first use.
+ *
+ * Creating a `LazyModule` only validates the input, and the module is compiled
+ * the first time `get` is called. Use `warm` to compile it ahead of time on a
+ * background thread.
+ *
+ * https://docs.wasmtime.dev/api/wasmtime/struct.LazyModule.html
+ */
+class LazyModule {
+  WASMTIME_OWN_WRAPPER(LazyModule, wasmtime_lazy_module);
+
+  /// \brief Validates the provided WebAssembly text and creates a lazy module
+  /// from it.
+  static Result<LazyModule> create(Engine &engine, std::string_view wat) {
+    auto wasm = wat2wasm_bytes(wat);
+    if (!wasm) {
+      return wasm.err();
+    }
+    return create(engine, wasm.ok_ref());
+  }
+
+  /// \brief Validates the provided WebAssembly binary and creates a lazy
+  /// module from it.
+  static Result<LazyModule> create(Engine &engine, Span<uint8_t> wasm) {
+    wasmtime_lazy_module_t *ret = nullptr;
+    auto *error =
+        wasmtime_lazy_module_new(engine.capi(), wasm.data(), wasm.size(), &ret);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return LazyModule(ret);
+  }
+
+  /// \brief Returns the compiled module, compiling it first if necessary.
+  Result<Module> get() const {
+    wasmtime_module_t *ret = nullptr;
+    auto *error = wasmtime_lazy_module_get(capi(), &ret);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return Module(ret);
+  }
+
+  /// \brief Starts compiling this module on a background thread.
+  void warm() const { wasmtime_lazy_module_warm(capi()); }
+
+  /// \brief Returns whether this module has finished compiling.
+  bool is_compiled() const { return wasmtime_lazy_module_is_compiled(capi()); }
+};
+
+/**
+ * \brief A builder for a `Module` whose WebAssembly binary arrives in chunks.
+ *
+ * Each chunk passed to `feed` is parsed and its structure validated as soon as
+ * it arrives, overlapping that work with waiting for the rest of the input.
+ * Once the whole binary has been fed `finish` validates the function bodies
+ * while compiling them.
+ *
+ * https://docs.wasmtime.dev/api/wasmtime/struct.ModuleBuilder.html
+ */
+class ModuleBuilder {
+  WASMTIME_OWN_WRAPPER(ModuleBuilder, wasmtime_module_builder);
+
+  /// \brief Creates a new builder for a module compiled for `engine`.
+  explicit ModuleBuilder(Engine &engine)
+      : ptr(wasmtime_module_builder_new(engine.capi())) {}
+
+  /// \brief Appends the next chunk of the WebAssembly binary.
+  Result<std::monostate> feed(Span<uint8_t> bytes) {
+    auto *error =
+        wasmtime_module_builder_feed(capi(), bytes.data(), bytes.size());
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::monostate();
+  }
+
+  /// \brief Compiles the WebAssembly binary fed to this builder.
+  ///
+  /// This can only be called once.
+  Result<Module> finish() {
+    wasmtime_module_t *ret = nullptr;
+    auto *error = wasmtime_module_builder_finish(capi(), &ret);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return Module(ret);
+  }
+};
 #endif // WASMTIME_FEATURE_COMPILER
+
+/**
+ * \brief A directory of serialized modules shared between processes.
+ *
+ * Modules deserialized through a registry are mapped from a file within its
+ * directory, holding one copy of each distinct artifact, so all processes
+ * using the same directory share the memory of identical modules.
+ */
+class SharedCodeRegistry {
+  WASMTIME_OWN_WRAPPER(SharedCodeRegistry, wasmtime_shared_code_registry);
+
+  /// \brief Creates a registry storing its serialized modules in `dir`.
+  static Result<SharedCodeRegistry> create(const std::string &dir) {
+    wasmtime_shared_code_registry_t *ret = nullptr;
+    auto *error = wasmtime_shared_code_registry_new(dir.c_str(), &ret);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return SharedCodeRegistry(ret);
+  }
+
+  /// \brief Deserializes a module, mapping it from the registry's copy of
+  /// `wasm`.
+  ///
+  /// This function is not safe to receive arbitrary user input, see
+  /// `Module::deserialize` for more information.
+  Result<Module> deserialize(Engine &engine, Span<uint8_t> wasm) const {
+    wasmtime_module_t *ret = nullptr;
+    auto *error = wasmtime_shared_code_registry_deserialize(
+        capi(), engine.capi(), wasm.data(), wasm.size(), &ret);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return Module(ret);
+  }
 };
 
 } // namespace wasmtime
@@ -96,6 +96,24 @@ wasmtime_guestprofiler_sample(wasmtime_guestprofiler_t *guestprofiler,
                               const wasmtime_store_t *store,
                               uint64_t delta_nanos);
 
+/**
+ * \brief Add a sample to the profile, collecting the backtrace from a store
+ * context.
+ *
+ * \param guestprofiler the profiler the sample is being added to
+ * \param context       context of the store that is being used to collect the
+ *                      backtraces
+ * \param delta_nanos   CPU time in nanoseconds that was used by this guest
+ *                      since the previous sample
+ *
+ * This is the same as #wasmtime_guestprofiler_sample except that it takes a
+ * context, such as the one passed to a callback registered with
+ * #wasmtime_store_epoch_deadline_callback, instead of a store.
+ */
+WASM_API_EXTERN void wasmtime_guestprofiler_sample_context(
+    wasmtime_guestprofiler_t *guestprofiler, const wasmtime_context_t *context,
+    uint64_t delta_nanos);
+
 /**
  * \brief Writes out the captured profile.
  *
@@ -118,6 +136,97 @@ WASM_API_EXTERN /* own */ wasmtime_error_t *
 wasmtime_guestprofiler_finish(/* own */ wasmtime_guestprofiler_t *guestprofiler,
                               /* own */ wasm_byte_vec_t *out);
 
+/**
+ * \brief Collects profiling data for WebAssembly guests as a count of samples
+ * per distinct stack, with bounded memory usage.
+ *
+ * Unlike #wasmtime_guestprofiler_t this can run indefinitely: call
+ * #wasmtime_aggregate_profiler_sample as with #wasmtime_guestprofiler_sample,
+ * and periodically write out and discard what's been collected with
+ * #wasmtime_aggregate_profiler_flush.
+ *
+ * For more information see the Rust documentation at:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.AggregateGuestProfiler.html
+ */
+typedef struct wasmtime_aggregate_profiler wasmtime_aggregate_profiler_t;
+
+/**
+ * \brief Format of a profile written by #wasmtime_aggregate_profiler_flush,
+ * values are in #wasmtime_profile_format_enum.
+ */
+typedef uint8_t wasmtime_profile_format_t;
+
+/**
+ * \brief Formats an aggregated profile can be written in.
+ */
+enum wasmtime_profile_format_enum { // ProfileFormat
+  /// An uncompressed protobuf in the pprof format.
+  WASMTIME_PROFILE_FORMAT_PPROF,
+  /// One line per stack with its `;`-separated frames followed by its sample
+  /// count, as consumed by `flamegraph.pl`.
+  WASMTIME_PROFILE_FORMAT_COLLAPSED,
+};
+
+/**
+ * \brief Begin profiling guests with an aggregating profiler.
+ *
+ * \param engine         engine in which to perform the profiling
+ * \param interval_nanos intended sampling interval in nanoseconds recorded in
+ *                       the profile
+ * \param max_stacks     maximum number of distinct stacks recorded between
+ *                       flushes, samples of further stacks are counted
+ *                       together as truncated
+ * \param modules        modules and associated names that will appear in
+ *                       captured stack traces, pointer to the first element
+ * \param modules_len    count of elements in `modules`
+ *
+ * \return Created profiler that is owned by the caller.
+ *
+ * This function does not take ownership of the arguments.
+ */
+WASM_API_EXTERN /* own */ wasmtime_aggregate_profiler_t *
+wasmtime_aggregate_profiler_new(const wasm_engine_t *engine,
+                                uint64_t interval_nanos, size_t max_stacks,
+                                const wasmtime_guestprofiler_modules_t *modules,
+                                size_t modules_len);
+
+/**
+ * \brief Deletes an aggregating profiler, discarding its samples.
+ */
+WASM_API_EXTERN void wasmtime_aggregate_profiler_delete(
+    /* own */ wasmtime_aggregate_profiler_t *profiler);
+
+/**
+ * \brief Add a sample of the stack of `context` to the profile.
+ *
+ * \param profiler    the profiler the sample is being added to
+ * \param context     context of the store that is being used to collect the
+ *                    backtraces
+ * \param delta_nanos CPU time in nanoseconds that was used by this guest
+ *                    since the previous sample
+ */
+WASM_API_EXTERN void
+wasmtime_aggregate_profiler_sample(wasmtime_aggregate_profiler_t *profiler,
+                                   const wasmtime_context_t *context,
+                                   uint64_t delta_nanos);
+
+/**
+ * \brief Writes out the samples collected since the profiler was created or
+ * last flushed, and then discards them.
+ *
+ * \param profiler the profiler being flushed
+ * \param format   the format to write the profile in
+ * \param out      where the #wasm_byte_vec_t containing the profile, owned by
+ *                 the caller, is written on success
+ *
+ * \return Returns #wasmtime_error_t owned by the caller in case of error,
+ * `NULL` otherwise. The samples are discarded in either case.
+ */
+WASM_API_EXTERN /* own */ wasmtime_error_t *
+wasmtime_aggregate_profiler_flush(wasmtime_aggregate_profiler_t *profiler,
+                                  wasmtime_profile_format_t format,
+                                  /* own */ wasm_byte_vec_t *out);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,158 @@
+/**
+ * \file wasmtime/profiling.hh
+ */
+
+#ifndef WASMTIME_PROFILING_HH
+#define WASMTIME_PROFILING_HH
+
+#include <wasmtime/conf.h>
+
+#ifdef WASMTIME_FEATURE_PROFILING
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <wasmtime/engine.hh>
+#include <wasmtime/error.hh>
+#include <wasmtime/module.hh>
+#include <wasmtime/profiling.h>
+#include <wasmtime/store.hh>
+
+namespace wasmtime {
+
+/**
+ * \brief Collects a sampled profile of WebAssembly guests.
+ *
+ * A profiler can sample any number of stores, which all contribute to one
+ * profile. Samples are either taken explicitly with `sample`, or
+ * automatically on each epoch deadline of the stores passed to `attach`.
+ * Copies of a `GuestProfiler` refer to the same profile, and it's safe to
+ * sample stores running on different threads concurrently.
+ *
+ * The profile is written out in the Firefox profiler format by `finish`.
+ *
+ * See `wasmtime_guestprofiler_t` for more information.
+ */
+class GuestProfiler {
+  struct State {
+    std::mutex mutex;
+    wasmtime_guestprofiler_t *profiler;
+
+    explicit State(wasmtime_guestprofiler_t *profiler) : profiler(profiler) {}
+    ~State() {
+      if (profiler != nullptr) {
+        wasmtime_guestprofiler_delete(profiler);
+      }
+    }
+  };
+
+  std::shared_ptr<State> state;
+
+  static wasm_name_t name_of(std::string_view s) {
+    wasm_name_t ret;
+    wasm_byte_vec_new(&ret, s.size(), s.data());
+    return ret;
+  }
+
+  static void sample(State &state, const wasmtime_context_t *context,
+                     std::chrono::nanoseconds delta) {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (state.profiler != nullptr) {
+      wasmtime_guestprofiler_sample_context(state.profiler, context,
+                                            delta.count());
+    }
+  }
+
+public:
+  /// \brief Creates a new profiler.
+  ///
+  /// The `name` is recorded in the profile, as is the intended sampling
+  /// `interval`. Only frames of the named `modules` appear in captured
+  /// stacks.
+  GuestProfiler(const Engine &engine, std::string_view name,
+                std::chrono::nanoseconds interval,
+                const std::vector<std::pair<std::string, Module>> &modules) {
+    wasm_name_t profile_name = name_of(name);
+    std::vector<wasm_name_t> names;
+    std::vector<wasmtime_guestprofiler_modules_t> raw;
+    names.reserve(modules.size());
+    raw.reserve(modules.size());
+    for (const auto &[module_name, module] : modules) {
+      names.push_back(name_of(module_name));
+      raw.push_back({&names.back(), module.capi()});
+    }
+    wasmtime_guestprofiler_t *profiler = wasmtime_guestprofiler_new(
+        engine.capi(), &profile_name, interval.count(), raw.data(), raw.size());
+    wasm_byte_vec_delete(&profile_name);
+    for (auto &module_name : names) {
+      wasm_byte_vec_delete(&module_name);
+    }
+    state = std::make_shared<State>(profiler);
+  }
+
+  /// \brief Adds a sample of the stack of `cx` to the profile, recording
+  /// `delta` as the CPU time used since the store's previous sample.
+  ///
+  /// Does nothing once the profile has been finished.
+  void sample(Store::Context cx, std::chrono::nanoseconds delta =
+                                     std::chrono::nanoseconds(0)) {
+    sample(*state, cx.capi(), delta);
+  }
+
+  /// \brief Samples `store` automatically every `ticks` epochs.
+  ///
+  /// This replaces the store's epoch deadline callback, and sets its epoch
+  /// deadline to `ticks` from now, so the engine must have epoch
+  /// interruption enabled and something must call `Engine::increment_epoch`
+  /// periodically. Each sample records the wall-clock time since the
+  /// store's previous sample.
+  ///
+  /// The store keeps the profile alive until its callback is replaced or
+  /// the store is dropped.
+  void attach(Store &store, uint64_t ticks = 1) {
+    store.epoch_deadline_callback(
+        [state = state, ticks, last = std::chrono::steady_clock::now()](
+            Store::Context cx,
+            uint64_t &delta) mutable -> Result<DeadlineKind> {
+          auto now = std::chrono::steady_clock::now();
+          sample(*state, cx.capi(), now - last);
+          last = now;
+          delta = ticks;
+          return DeadlineKind::Continue;
+        });
+    store.context().set_epoch_deadline(ticks);
+  }
+
+  /// \brief Writes out the profile in the Firefox profiler format.
+  ///
+  /// Later samples, including those from attached stores, are ignored. An
+  /// error is returned if the profile has already been finished.
+  Result<std::vector<uint8_t>> finish() {
+    wasmtime_guestprofiler_t *profiler = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      std::swap(profiler, state->profiler);
+    }
+    if (profiler == nullptr) {
+      return Error("profile has already been finished");
+    }
+    wasm_byte_vec_t out;
+    auto *error = wasmtime_guestprofiler_finish(profiler, &out);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    std::vector<uint8_t> ret(out.data, out.data + out.size);
+    wasm_byte_vec_delete(&out);
+    return ret;
+  }
+};
+
+} // namespace wasmtime
+
+#endif // WASMTIME_FEATURE_PROFILING
+
+#endif // WASMTIME_PROFILING_HH
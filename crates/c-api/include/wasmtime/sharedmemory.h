@@ -101,6 +101,193 @@ WASM_API_EXTERN wasmtime_error_t *
 wasmtime_sharedmemory_grow(const wasmtime_sharedmemory_t *memory,
                            uint64_t delta, uint64_t *prev_size);
 
+/**
+ * \brief Atomically loads the 32-bit value at byte offset `addr` within
+ * `memory`, like the wasm `i32.atomic.load` instruction.
+ *
+ * \param memory the memory to load from
+ * \param addr the byte offset to load from, which must be 4-byte aligned
+ * \param ret where to store the loaded value
+ *
+ * Returns an error, and leaves `ret` unchanged, if `addr` is out of bounds or
+ * misaligned. All of the atomic operations on shared memories are sequentially
+ * consistent, matching the semantics of wasm's atomic instructions.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_sharedmemory_atomic_load32(const wasmtime_sharedmemory_t *memory,
+                                    uint64_t addr, uint32_t *ret);
+
+/**
+ * \brief Atomically stores the 32-bit `value` at byte offset `addr` within
+ * `memory`, like the wasm `i32.atomic.store` instruction.
+ *
+ * Returns an error if `addr` is out of bounds or not 4-byte aligned.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_sharedmemory_atomic_store32(const wasmtime_sharedmemory_t *memory,
+                                     uint64_t addr, uint32_t value);
+
+/**
+ * \brief Atomically replaces the 32-bit value at byte offset `addr` within
+ * `memory` with `replacement` if it's equal to `expected`, like the wasm
+ * `i32.atomic.rmw.cmpxchg` instruction.
+ *
+ * The value previously at `addr` is stored in `ret`, regardless of whether it
+ * was replaced. Returns an error if `addr` is out of bounds or not 4-byte
+ * aligned.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_sharedmemory_atomic_cmpxchg32(const wasmtime_sharedmemory_t *memory,
+                                       uint64_t addr, uint32_t expected,
+                                       uint32_t replacement, uint32_t *ret);
+
+/**
+ * \brief The 64-bit version of #wasmtime_sharedmemory_atomic_load32, for
+ * which `addr` must be 8-byte aligned.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_sharedmemory_atomic_load64(const wasmtime_sharedmemory_t *memory,
+                                    uint64_t addr, uint64_t *ret);
+
+/**
+ * \brief The 64-bit version of #wasmtime_sharedmemory_atomic_store32, for
+ * which `addr` must be 8-byte aligned.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_sharedmemory_atomic_store64(const wasmtime_sharedmemory_t *memory,
+                                     uint64_t addr, uint64_t value);
+
+/**
+ * \brief The 64-bit version of #wasmtime_sharedmemory_atomic_cmpxchg32, for
+ * which `addr` must be 8-byte aligned.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_sharedmemory_atomic_cmpxchg64(const wasmtime_sharedmemory_t *memory,
+                                       uint64_t addr, uint64_t expected,
+                                       uint64_t replacement, uint64_t *ret);
+
+/**
+ * \brief Wakes up to `count` threads waiting on byte offset `addr` within
+ * `memory`, like the wasm `memory.atomic.notify` instruction.
+ *
+ * Both wasm threads blocked in `memory.atomic.wait*` and host threads blocked
+ * in #wasmtime_sharedmemory_atomic_wait32 or
+ * #wasmtime_sharedmemory_atomic_wait64 are woken. The number of threads woken
+ * is stored in `woken`. Returns an error if `addr` is out of bounds or not
+ * 4-byte aligned.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_sharedmemory_atomic_notify(const wasmtime_sharedmemory_t *memory,
+                                    uint64_t addr, uint32_t count,
+                                    uint32_t *woken);
+
+/**
+ * \brief The outcome of #wasmtime_sharedmemory_atomic_wait32 and
+ * #wasmtime_sharedmemory_atomic_wait64, values are in
+ * #wasmtime_wait_result_enum.
+ */
+typedef uint8_t wasmtime_wait_result_t;
+
+/**
+ * \brief The possible outcomes of waiting on a shared memory.
+ */
+enum wasmtime_wait_result_enum { // WaitResult
+  /// The thread blocked and was then woken by a notification.
+  WASMTIME_WAIT_RESULT_OK,
+  /// The value in memory didn't match the expected value, so the thread
+  /// didn't block.
+  WASMTIME_WAIT_RESULT_MISMATCH,
+  /// The thread blocked but the timeout expired before it was notified.
+  WASMTIME_WAIT_RESULT_TIMED_OUT,
+};
+
+/**
+ * \brief Blocks the current thread until it's notified, if the 32-bit value at
+ * byte offset `addr` within `memory` is `expected`, like the wasm
+ * `memory.atomic.wait32` instruction.
+ *
+ * \param memory the memory to wait on
+ * \param addr the byte offset to wait on, which must be 4-byte aligned
+ * \param expected the value expected at `addr`
+ * \param timeout_nanos the maximum time to block for, in nanoseconds, or
+ *        `NULL` to block indefinitely
+ * \param ret where to store the #wasmtime_wait_result_enum describing why
+ *        this function returned
+ *
+ * Returns an error if `addr` is out of bounds or misaligned.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_sharedmemory_atomic_wait32(const wasmtime_sharedmemory_t *memory,
+                                    uint64_t addr, uint32_t expected,
+                                    const uint64_t *timeout_nanos,
+                                    wasmtime_wait_result_t *ret);
+
+/**
+ * \brief The 64-bit version of #wasmtime_sharedmemory_atomic_wait32, for
+ * which `addr` must be 8-byte aligned.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_sharedmemory_atomic_wait64(const wasmtime_sharedmemory_t *memory,
+                                    uint64_t addr, uint64_t expected,
+                                    const uint64_t *timeout_nanos,
+                                    wasmtime_wait_result_t *ret);
+
+/// \brief A #wasmtime_sharedmemory_event_t describing a thread about to wait.
+#define WASMTIME_SHAREDMEMORY_EVENT_WAIT 0
+/// \brief A #wasmtime_sharedmemory_event_t describing a notification.
+#define WASMTIME_SHAREDMEMORY_EVENT_NOTIFY 1
+
+/**
+ * \brief An atomic wait or notify operation on a shared memory, passed to
+ * the hook installed with #wasmtime_sharedmemory_set_atomic_hook.
+ */
+typedef struct wasmtime_sharedmemory_event {
+  /// Either #WASMTIME_SHAREDMEMORY_EVENT_WAIT or
+  /// #WASMTIME_SHAREDMEMORY_EVENT_NOTIFY.
+  uint8_t kind;
+  /// The byte address being waited on or notified.
+  uint64_t addr;
+  /// For notifications, the maximum number of waiters to wake.
+  uint32_t count;
+  /// For notifications, the number of waiters that were actually woken.
+  uint32_t woken;
+} wasmtime_sharedmemory_event_t;
+
+/**
+ * \brief Callback signature for #wasmtime_sharedmemory_set_atomic_hook.
+ */
+typedef void (*wasmtime_sharedmemory_atomic_hook_t)(
+    void *env, const wasmtime_sharedmemory_event_t *event);
+
+/**
+ * \brief Installs a hook invoked for every atomic wait and notify on
+ * `memory`, replacing any previously installed hook.
+ *
+ * This lets an embedder integrate the threads of wasm guests with its own
+ * scheduler, for example by writing to an eventfd from the hook. The hook
+ * receives a #WASMTIME_SHAREDMEMORY_EVENT_WAIT event just before a wasm or host
+ * thread checks the expected value and blocks. The value may change before the
+ * thread blocks, in which case it returns immediately. A
+ * #WASMTIME_SHAREDMEMORY_EVENT_NOTIFY event is received after any
+ * notification, from wasm or from the host, has woken its waiters.
+ *
+ * The hook is shared by all clones of `memory` and runs synchronously on the
+ * thread performing the operation, so it must be safe to call from any thread
+ * and should not block. It may call #wasmtime_sharedmemory_atomic_notify and
+ * this function.
+ *
+ * \param memory the memory to install the hook on
+ * \param hook the hook to install, or `NULL` to remove the current hook
+ * \param env data passed to `hook`
+ * \param finalizer optional finalizer for `env`, run once the hook has been
+ *        removed or replaced and is no longer running, or immediately if
+ *        `hook` is `NULL`
+ */
+WASM_API_EXTERN void wasmtime_sharedmemory_set_atomic_hook(
+    const wasmtime_sharedmemory_t *memory,
+    wasmtime_sharedmemory_atomic_hook_t hook, void *env,
+    void (*finalizer)(void *));
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
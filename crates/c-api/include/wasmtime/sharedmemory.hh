@@ -0,0 +1,254 @@
+/**
+ * \file wasmtime/sharedmemory.hh
+ */
+
+#ifndef WASMTIME_SHAREDMEMORY_HH
+#define WASMTIME_SHAREDMEMORY_HH
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <wasmtime/engine.hh>
+#include <wasmtime/error.hh>
+#include <wasmtime/helpers.hh>
+#include <wasmtime/sharedmemory.h>
+#include <wasmtime/span.hh>
+#include <wasmtime/types/memory.hh>
+
+namespace wasmtime {
+
+/// \brief The outcome of `SharedMemory::atomic_wait`.
+enum class WaitResult {
+  /// The thread blocked and was then woken by a notification.
+  Ok = WASMTIME_WAIT_RESULT_OK,
+  /// The value in memory didn't match the expected value, so the thread
+  /// didn't block.
+  Mismatch = WASMTIME_WAIT_RESULT_MISMATCH,
+  /// The thread blocked but the timeout expired before it was notified.
+  TimedOut = WASMTIME_WAIT_RESULT_TIMED_OUT,
+};
+
+/// \brief An atomic wait or notify operation on a `SharedMemory`, passed to
+/// the hook installed with `SharedMemory::set_atomic_hook`.
+struct SharedMemoryEvent {
+  /// \brief The kinds of `SharedMemoryEvent`.
+  enum class Kind {
+    /// A thread is about to wait on `addr`.
+    Wait = WASMTIME_SHAREDMEMORY_EVENT_WAIT,
+    /// A thread notified waiters on `addr`.
+    Notify = WASMTIME_SHAREDMEMORY_EVENT_NOTIFY,
+  };
+
+  /// The kind of operation.
+  Kind kind;
+  /// The byte address being waited on or notified.
+  uint64_t addr;
+  /// For notifications, the maximum number of waiters to wake.
+  uint32_t count;
+  /// For notifications, the number of waiters that were actually woken.
+  uint32_t woken;
+};
+
+/**
+ * \brief A WebAssembly linear memory which can be shared between threads.
+ *
+ * Unlike `Memory` a shared memory isn't owned by a `Store`, and copies of a
+ * `SharedMemory` refer to the same memory, which may be accessed by any number
+ * of host and wasm threads at the same time.
+ *
+ * Other threads may concurrently modify the memory, so host code should access
+ * any data shared with them through the `atomic_*` methods. These behave like
+ * wasm's `memory.atomic.*` instructions: they're sequentially consistent, and
+ * fail if the address is out of bounds or not aligned to the size of the
+ * access.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.SharedMemory.html
+ */
+class SharedMemory {
+  WASMTIME_CLONE_WRAPPER(SharedMemory, wasmtime_sharedmemory);
+
+#ifdef WASMTIME_FEATURE_THREADS
+  /// Creates a new shared memory with the shared type `ty`.
+  static Result<SharedMemory> create(Engine &engine, const MemoryType &ty) {
+    wasmtime_sharedmemory_t *ret = nullptr;
+    auto *error = wasmtime_sharedmemory_new(engine.capi(), ty.ptr.get(), &ret);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return SharedMemory(ret);
+  }
+#endif // WASMTIME_FEATURE_THREADS
+
+  /// Returns the type of this memory.
+  MemoryType type() const { return wasmtime_sharedmemory_type(ptr.get()); }
+
+  /// Returns the size, in WebAssembly pages, of this memory.
+  uint64_t size() const { return wasmtime_sharedmemory_size(ptr.get()); }
+
+  /// Returns a `Span` of where this memory is located in the host.
+  ///
+  /// Shared memories never move, so the span remains valid for as long as
+  /// this memory is alive, but it doesn't cover pages added by later calls to
+  /// `grow`. Other threads may be accessing the memory at the same time, so
+  /// any bytes which they might modify should only be accessed with the
+  /// `atomic_*` methods.
+  Span<uint8_t> data() const {
+    auto *base = wasmtime_sharedmemory_data(ptr.get());
+    auto size = wasmtime_sharedmemory_data_size(ptr.get());
+    return {base, size};
+  }
+
+  /// Grows the memory by `delta` WebAssembly pages.
+  ///
+  /// On success returns the previous size of this memory in units of
+  /// WebAssembly pages.
+  Result<uint64_t> grow(uint64_t delta) const {
+    uint64_t prev = 0;
+    auto *error = wasmtime_sharedmemory_grow(ptr.get(), delta, &prev);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return prev;
+  }
+
+  /// Atomically loads the `uint32_t` or `uint64_t` at byte offset `addr`.
+  template <typename T> Result<T> atomic_load(uint64_t addr) const {
+    check_atomic<T>();
+    T ret = 0;
+    wasmtime_error_t *error = nullptr;
+    if constexpr (sizeof(T) == 4) {
+      error = wasmtime_sharedmemory_atomic_load32(ptr.get(), addr, &ret);
+    } else {
+      error = wasmtime_sharedmemory_atomic_load64(ptr.get(), addr, &ret);
+    }
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return ret;
+  }
+
+  /// Atomically stores the `uint32_t` or `uint64_t` `value` at byte offset
+  /// `addr`.
+  template <typename T>
+  Result<std::monostate> atomic_store(uint64_t addr, T value) const {
+    check_atomic<T>();
+    wasmtime_error_t *error = nullptr;
+    if constexpr (sizeof(T) == 4) {
+      error = wasmtime_sharedmemory_atomic_store32(ptr.get(), addr, value);
+    } else {
+      error = wasmtime_sharedmemory_atomic_store64(ptr.get(), addr, value);
+    }
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::monostate();
+  }
+
+  /// Atomically replaces the `uint32_t` or `uint64_t` at byte offset `addr`
+  /// with `replacement` if it's equal to `expected`.
+  ///
+  /// Returns the value previously at `addr`, so the exchange happened if and
+  /// only if the returned value is equal to `expected`.
+  template <typename T>
+  Result<T> atomic_cmpxchg(uint64_t addr, T expected, T replacement) const {
+    check_atomic<T>();
+    T ret = 0;
+    wasmtime_error_t *error = nullptr;
+    if constexpr (sizeof(T) == 4) {
+      error = wasmtime_sharedmemory_atomic_cmpxchg32(ptr.get(), addr, expected,
+                                                     replacement, &ret);
+    } else {
+      error = wasmtime_sharedmemory_atomic_cmpxchg64(ptr.get(), addr, expected,
+                                                     replacement, &ret);
+    }
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return ret;
+  }
+
+  /// Wakes up to `count` threads, host or wasm, waiting on byte offset
+  /// `addr`, returning the number of threads woken.
+  Result<uint32_t> atomic_notify(uint64_t addr, uint32_t count) const {
+    uint32_t woken = 0;
+    auto *error =
+        wasmtime_sharedmemory_atomic_notify(ptr.get(), addr, count, &woken);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return woken;
+  }
+
+  /// Blocks the current thread until it's notified, if the `uint32_t` or
+  /// `uint64_t` at byte offset `addr` is equal to `expected`.
+  ///
+  /// If `timeout` is given then the thread blocks for at most that long. This
+  /// doesn't return due to spurious wakeups.
+  template <typename T>
+  Result<WaitResult>
+  atomic_wait(uint64_t addr, T expected,
+              std::optional<std::chrono::nanoseconds> timeout = {}) const {
+    check_atomic<T>();
+    uint64_t nanos = timeout && timeout->count() > 0 ? timeout->count() : 0;
+    const uint64_t *timeout_nanos = timeout ? &nanos : nullptr;
+    wasmtime_wait_result_t ret = 0;
+    wasmtime_error_t *error = nullptr;
+    if constexpr (sizeof(T) == 4) {
+      error = wasmtime_sharedmemory_atomic_wait32(ptr.get(), addr, expected,
+                                                  timeout_nanos, &ret);
+    } else {
+      error = wasmtime_sharedmemory_atomic_wait64(ptr.get(), addr, expected,
+                                                  timeout_nanos, &ret);
+    }
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return static_cast<WaitResult>(ret);
+  }
+
+  /// \brief Installs `f` as the hook invoked with a `SharedMemoryEvent` for
+  /// every atomic wait and notify on this memory, replacing any previous hook.
+  ///
+  /// See `wasmtime_sharedmemory_set_atomic_hook` for when the hook runs. It
+  /// may run concurrently on any thread which uses this memory.
+  template <typename F,
+            std::enable_if_t<std::is_invocable_v<F, const SharedMemoryEvent &>,
+                             bool> = true>
+  void set_atomic_hook(F &&f) const {
+    using Hook = std::remove_cv_t<std::remove_reference_t<F>>;
+    wasmtime_sharedmemory_set_atomic_hook(
+        ptr.get(), raw_hook<Hook>,
+        std::make_unique<Hook>(std::forward<F>(f)).release(),
+        raw_finalize<Hook>);
+  }
+
+  /// \brief Removes the hook installed with `set_atomic_hook`, if any.
+  void clear_atomic_hook() const {
+    wasmtime_sharedmemory_set_atomic_hook(ptr.get(), nullptr, nullptr,
+                                          nullptr);
+  }
+
+private:
+  template <typename F>
+  static void raw_hook(void *env, const wasmtime_sharedmemory_event_t *raw) {
+    SharedMemoryEvent event{static_cast<SharedMemoryEvent::Kind>(raw->kind),
+                            raw->addr, raw->count, raw->woken};
+    (*static_cast<F *>(env))(event);
+  }
+
+  template <typename F> static void raw_finalize(void *env) {
+    std::unique_ptr<F> ptr(static_cast<F *>(env));
+  }
+
+  template <typename T> static constexpr void check_atomic() {
+    static_assert(std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t>,
+                  "shared memory atomics are either 32 or 64 bits wide");
+  }
+};
+
+} // namespace wasmtime
+
+#endif // WASMTIME_SHAREDMEMORY_HH
@@ -12,6 +12,7 @@
 #endif
 
 #ifndef __cpp_lib_span
+#include <array>
 #include <cstddef>
 #include <limits>
 #include <type_traits>
@@ -45,20 +46,32 @@ template <typename T, std::size_t Extent>
 struct IsSpan<Span<T, Extent>> : std::true_type {};
 
 template <typename T, std::size_t Extent> class Span {
-  static_assert(Extent == dynamic_extent,
-                "The current implementation supports dynamic-extent span only");
+  static constexpr bool is_dynamic = Extent == dynamic_extent;
+
+  template <typename U>
+  static constexpr bool is_compatible = std::is_convertible_v<U (*)[], T (*)[]>;
 
 public:
   /// \brief Type used to iterate over this span (a raw pointer)
   using iterator = T *;
 
+  /// \brief The number of elements in this span, or `dynamic_extent` if
+  /// that's only known at runtime.
+  static constexpr std::size_t extent = Extent;
+
   /// \brief Constructor of Span class
+  template <bool D = is_dynamic, std::enable_if_t<D, int> = 0>
   Span(T *t, std::size_t n) : ptr_{t}, size_{n} {}
 
+  /// \brief Constructor of Span class with a static extent, where `n` must
+  /// be `Extent`
+  template <bool D = is_dynamic, std::enable_if_t<!D, int> = 0>
+  explicit Span(T *t, std::size_t n) : ptr_{t}, size_{n} {}
+
   /// \brief Constructor of Span class for containers
   template <typename C,
             std::enable_if_t<
-                !IsSpan<C>::value &&
+                is_dynamic && !IsSpan<C>::value &&
                     std::is_pointer_v<decltype(std::declval<C &>().data())> &&
                     std::is_convertible_v<
                         std::remove_pointer_t<
@@ -69,6 +82,27 @@ public:
                 int> = 0>
   Span(C &range) : ptr_{range.data()}, size_{range.size()} {}
 
+  /// \brief Constructor of Span class with a static extent for arrays
+  template <typename U, std::size_t N,
+            std::enable_if_t<!is_dynamic && N == Extent && is_compatible<U>,
+                             int> = 0>
+  Span(std::array<U, N> &arr) : ptr_{arr.data()}, size_{N} {}
+
+  /// \brief Constructor of Span class with a static extent for arrays
+  template <typename U, std::size_t N,
+            std::enable_if_t<!is_dynamic && N == Extent &&
+                                 is_compatible<const U>,
+                             int> = 0>
+  Span(const std::array<U, N> &arr) : ptr_{arr.data()}, size_{N} {}
+
+  /// \brief Constructor of Span class from another span with a compatible
+  /// element type, such as a `Span<const T>` from a `Span<T>`, or a span with
+  /// a dynamic extent from one with a static extent.
+  template <typename U, std::size_t N,
+            std::enable_if_t<(is_dynamic || N == Extent) && is_compatible<U>,
+                             int> = 0>
+  Span(const Span<U, N> &other) : ptr_{other.data()}, size_{other.size()} {}
+
   /// \brief Returns item by index
   T &operator[](ptrdiff_t idx) const {
     return ptr_[idx]; // NOLINT
@@ -78,18 +112,34 @@ public:
   T *data() const { return ptr_; }
 
   /// \brief Returns number of data that referred by Span class
-  std::size_t size() const { return size_; }
+  std::size_t size() const { return is_dynamic ? size_ : Extent; }
+
+  /// \brief Returns whether this span is empty
+  bool empty() const { return size() == 0; }
 
   /// \brief Returns begin iterator
   iterator begin() const { return ptr_; }
 
   /// \brief Returns end iterator
   iterator end() const {
-    return ptr_ + size_; // NOLINT
+    return ptr_ + size(); // NOLINT
   }
 
   /// \brief Returns size in bytes
-  std::size_t size_bytes() const { return sizeof(T) * size_; }
+  std::size_t size_bytes() const { return sizeof(T) * size(); }
+
+  /// \brief Returns a span of the first `Count` elements of this span
+  template <std::size_t Count> Span<T, Count> first() const {
+    return Span<T, Count>(ptr_, Count);
+  }
+
+  /// \brief Returns a span of `count` elements starting at `offset`, or of
+  /// the rest of this span if `count` is `dynamic_extent`
+  Span<T> subspan(std::size_t offset,
+                  std::size_t count = dynamic_extent) const {
+    return {ptr_ + offset, // NOLINT
+            count == dynamic_extent ? size() - offset : count};
+  }
 
 private:
   T *ptr_;
@@ -114,6 +114,79 @@ WASM_API_EXTERN void wasmtime_store_limiter(wasmtime_store_t *store,
                                             int64_t instances, int64_t tables,
                                             int64_t memories);
 
+/**
+ * \brief Callback signature for #wasmtime_store_resource_limiter.
+ *
+ * \param env the user-provided argument passed to
+ * #wasmtime_store_resource_limiter.
+ * \param current the current size of the memory, in bytes, or table, in
+ * elements.
+ * \param desired the size the memory or table is requested to grow to. The
+ * first growth of a memory or table when it is created has `current` of zero.
+ * \param maximum the maximum size the memory or table may grow to, or a
+ * negative value if it is unbounded.
+ * \param allowed where to write whether the growth is permitted.
+ *
+ * Returning a non-`NULL` error will cause the growth, and the WebAssembly
+ * instruction or host API that requested it, to fail with that error.
+ * Ownership of the error is transferred to the caller.
+ */
+typedef wasmtime_error_t *(*wasmtime_resource_growing_callback_t)(
+    void *env, size_t current, size_t desired, int64_t maximum, bool *allowed);
+
+/**
+ * \brief Configures callbacks to dynamically decide whether memories and
+ * tables within a store may grow.
+ *
+ * \param store the store to configure.
+ * \param memory_growing invoked when a linear memory is allocated or grown,
+ * or `NULL` to permit all memory growth.
+ * \param table_growing invoked when a table is allocated or grown, or `NULL`
+ * to permit all table growth.
+ * \param env user-provided data passed to both callbacks.
+ * \param finalizer an optional finalizer for `env`.
+ *
+ * The callbacks are only consulted for growth that is within the limits
+ * configured with #wasmtime_store_limiter. This is suitable for accounting
+ * against a budget that's shared between stores, for example. Configuring
+ * a new limiter replaces any previously configured with this function or
+ * #wasmtime_store_resource_limiter_async.
+ */
+WASM_API_EXTERN void wasmtime_store_resource_limiter(
+    wasmtime_store_t *store,
+    wasmtime_resource_growing_callback_t memory_growing,
+    wasmtime_resource_growing_callback_t table_growing, void *env,
+    void (*finalizer)(void *));
+
+/**
+ * \brief Resets a store so it can be reused for a fresh set of instances.
+ *
+ * \param store the store to reset.
+ *
+ * This drops all instances, functions, memories, tables, globals and GC roots
+ * that were created within `store`, as if the store had been deleted and
+ * re-created with #wasmtime_store_new. Any slots acquired from the pooling
+ * allocator are returned to the pool, where they may be reused by later
+ * instantiations in this (or another) store.
+ *
+ * The following configuration is preserved across a reset:
+ *
+ * * The user-provided data and its finalizer, see #wasmtime_context_get_data.
+ * * Limits configured with #wasmtime_store_limiter.
+ * * The callback configured with #wasmtime_store_epoch_deadline_callback.
+ * * Callbacks configured with #wasmtime_store_resource_limiter.
+ * * The key configured with #wasmtime_context_set_pooling_affinity.
+ * * The node configured with #wasmtime_context_set_numa_node.
+ *
+ * Fuel, the epoch deadline, the setting of
+ * #wasmtime_context_set_wasm_backtrace and any WASI configuration are reset to
+ * their defaults and must be configured again if needed.
+ *
+ * All objects previously created within `store` are invalidated by this
+ * function and must not be used afterwards.
+ */
+WASM_API_EXTERN void wasmtime_store_reset(wasmtime_store_t *store);
+
 /**
  * \brief Deletes a store.
  */
@@ -147,6 +220,47 @@ WASM_API_EXTERN void wasmtime_context_set_data(wasmtime_context_t *context,
 WASM_API_EXTERN wasmtime_error_t *
 wasmtime_context_gc(wasmtime_context_t *context);
 
+/**
+ * \brief Statistics about the garbage collections performed within a store,
+ * returned by #wasmtime_context_gc_stats.
+ */
+typedef struct wasmtime_gc_stats {
+  /// The number of collections performed.
+  uint64_t collections;
+  /// The total time spent in collections, in nanoseconds.
+  uint64_t total_pause_nanos;
+  /// The longest time spent in a single collection, in nanoseconds.
+  uint64_t max_pause_nanos;
+  /// The total number of bytes freed by collections.
+  uint64_t bytes_freed;
+  /// The number of times the GC heap has been grown.
+  uint64_t heap_grows;
+  /// The current size of the GC heap, in bytes.
+  uint64_t heap_size;
+  /// The number of bytes of the GC heap currently allocated to objects,
+  /// including objects which are unreachable but not yet collected.
+  uint64_t allocated_bytes;
+} wasmtime_gc_stats_t;
+
+/**
+ * \brief Returns statistics about the garbage collections performed within
+ * this context's store.
+ *
+ * \param context the store to query.
+ * \param stats where to write the statistics.
+ *
+ * Collections happen both when requested with #wasmtime_context_gc and when
+ * an allocation doesn't fit in the GC heap and growing it fails. The counters
+ * are maintained as collections happen, so this function is cheap to call.
+ * They're reset by #wasmtime_store_reset.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Store.html#method.gc_stats.
+ */
+WASM_API_EXTERN void
+wasmtime_context_gc_stats(const wasmtime_context_t *context,
+                          wasmtime_gc_stats_t *stats);
+
 /**
  * \brief Set fuel to this context's store for wasm to consume while executing.
  *
@@ -177,6 +291,223 @@ wasmtime_context_set_fuel(wasmtime_context_t *store, uint64_t fuel);
 WASM_API_EXTERN wasmtime_error_t *
 wasmtime_context_get_fuel(const wasmtime_context_t *context, uint64_t *fuel);
 
+/**
+ * \brief Configures a key used by the pooling allocator to pick slots for
+ * this store's linear memories.
+ *
+ * \param context the store to configure.
+ * \param key the affinity key, or 0 to clear it.
+ *
+ * Amongst slots previously used by the same module, the pooling allocator will
+ * prefer the one most recently used by a store with the same key. Using a key
+ * per tenant, for example, makes it more likely that a tenant's requests reuse
+ * memory which is still resident from its previous request. This is only a
+ * hint and has no effect with other allocation strategies.
+ *
+ * The key is preserved by #wasmtime_store_reset.
+ */
+WASM_API_EXTERN void
+wasmtime_context_set_pooling_affinity(wasmtime_context_t *context,
+                                      uint64_t key);
+
+/**
+ * \brief Configures the NUMA node that this store's linear memories are placed
+ * on.
+ *
+ * \param context the store to configure.
+ * \param node the node to place memories on, or `NULL` to clear it.
+ *
+ * Memories allocated by instantiation after this call have their pages placed
+ * on `node`, and with the pooling allocator pages which are still resident from
+ * a slot's previous use are migrated to it. This is only a preference and
+ * never causes allocation to fail. NUMA placement is currently only supported
+ * on Linux.
+ *
+ * The node is preserved by #wasmtime_store_reset.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Store.html#method.set_numa_node.
+ */
+WASM_API_EXTERN void wasmtime_context_set_numa_node(wasmtime_context_t *context,
+                                                    const uint32_t *node);
+
+/**
+ * \brief Configures whether a backtrace is captured when WebAssembly in this
+ * store traps.
+ *
+ * \param context the store to configure.
+ * \param enable whether to capture backtraces.
+ *
+ * Backtraces are captured by default. Disabling them makes traps cheaper for
+ * guests which use them for control flow, such as timeouts, and
+ * #wasm_trap_trace and #wasm_trap_origin then return no frames. Debug
+ * information is only consulted for a captured frame when its details are
+ * first requested.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Store.html#method.set_wasm_backtrace.
+ */
+WASM_API_EXTERN void
+wasmtime_context_set_wasm_backtrace(wasmtime_context_t *context, bool enable);
+
+/**
+ * \brief A snapshot of the resources consumed within a store, returned by
+ * #wasmtime_context_resource_usage.
+ */
+typedef struct wasmtime_resource_usage {
+  /// Bytes of linear memory, including any GC heap, that the store's limiter
+  /// has permitted instances to allocate or grow to. This is only counted
+  /// while a limiter is configured with #wasmtime_store_limiter or
+  /// #wasmtime_store_resource_limiter, and is zero otherwise.
+  uint64_t memory_bytes;
+  /// Table elements that the store's limiter has permitted tables to allocate
+  /// or grow to. Like `memory_bytes` this requires a configured limiter.
+  uint64_t table_elements;
+  /// The number of instances created within the store.
+  uint64_t instances;
+  /// The number of linear memories defined by instances within the store.
+  uint64_t memories;
+  /// The number of tables defined by instances within the store.
+  uint64_t tables;
+  /// Fuel consumed by wasm so far, as measured against the amounts configured
+  /// with #wasmtime_context_set_fuel. This is zero if fuel consumption is not
+  /// enabled.
+  uint64_t fuel_consumed;
+} wasmtime_resource_usage_t;
+
+/**
+ * \brief Returns a snapshot of the resources consumed within this context's
+ * store.
+ *
+ * \param context the store to query.
+ * \param usage where to write the snapshot.
+ *
+ * The values returned are counters maintained by the store as resources are
+ * created and grown, so this function is cheap to call and does not need to
+ * visit each instance within the store. All counters are reset by
+ * #wasmtime_store_reset.
+ */
+WASM_API_EXTERN void
+wasmtime_context_resource_usage(const wasmtime_context_t *context,
+                                wasmtime_resource_usage_t *usage);
+
+/**
+ * \brief Starts measuring the CPU used by WebAssembly executing in this
+ * context's store.
+ *
+ * The thread CPU time is read each time that execution switches between
+ * WebAssembly and the host, and each time that an async call is suspended and
+ * resumed, so the time spent in host functions is kept separate from the time
+ * spent in WebAssembly itself. See #wasmtime_context_cpu_usage.
+ *
+ * Returns an error if CPU accounting isn't supported on this platform, which
+ * is currently the case everywhere but Unix.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_context_enable_cpu_accounting(wasmtime_context_t *context);
+
+/**
+ * \brief The CPU used by WebAssembly executing in a store, returned by
+ * #wasmtime_context_cpu_usage.
+ */
+typedef struct wasmtime_cpu_usage {
+  /// CPU time, in nanoseconds, consumed by calls from the host into
+  /// WebAssembly, including the host functions that they called. Calls made on
+  /// async fibers aren't included.
+  uint64_t cpu_time_nanos;
+  /// CPU time, in nanoseconds, consumed while executing WebAssembly code
+  /// itself, excluding host functions and suspended async calls, on whichever
+  /// thread the WebAssembly executed.
+  uint64_t guest_cpu_time_nanos;
+  /// The number of instructions retired in user mode, if `has_instructions`.
+  uint64_t instructions;
+  /// Whether instructions could be counted on this platform.
+  bool has_instructions;
+} wasmtime_cpu_usage_t;
+
+/**
+ * \brief Returns the CPU used by WebAssembly executing in this context's
+ * store so far.
+ *
+ * \param context the store to query.
+ * \param usage where to write the usage.
+ *
+ * Returns `false`, leaving `usage` untouched, if
+ * #wasmtime_context_enable_cpu_accounting wasn't called for this store. Calls
+ * into WebAssembly which are still in progress aren't included.
+ */
+WASM_API_EXTERN bool
+wasmtime_context_cpu_usage(const wasmtime_context_t *context,
+                           wasmtime_cpu_usage_t *usage);
+
+/**
+ * \brief Sets up the state of calls into WebAssembly once for all the calls
+ * made in this context's store on this thread until the matching
+ * #wasmtime_context_exit.
+ *
+ * Each call into WebAssembly otherwise sets up, and then tears down, the stack
+ * limit for WebAssembly and its registration with the engine's epoch ticker and
+ * signal interruption. Hosts which make many calls in a row into the same store
+ * can enter it first so that the calls reuse this state. The stack limit is
+ * computed relative to this call's stack pointer, so the calls must be made on
+ * the same stack, and get less stack the deeper they're made. Calls to this
+ * function may be nested.
+ *
+ * Returns an error if the store is already entered on another thread. Calls
+ * into WebAssembly also fail while the store is entered on another thread.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Store.html#method.enter
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_context_enter(wasmtime_context_t *context);
+
+/**
+ * \brief Exits a call to #wasmtime_context_enter.
+ *
+ * Returns an error if the store isn't entered, or was entered on another
+ * thread.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_context_exit(wasmtime_context_t *context);
+
+/**
+ * \brief Saves the contents of the linear memories of this context's store
+ * and releases the memory backing them, for stores which are expected to sit
+ * idle for a while.
+ *
+ * \param context the store to hibernate.
+ * \param saved_bytes where to write the number of bytes that the saved
+ * contents take up.
+ *
+ * The contents are restored by #wasmtime_context_resume_from_hibernation,
+ * which is called automatically the next time that WebAssembly is called in
+ * this store. Until then the memories read as zeros from the host, so the
+ * host must resume the store before accessing them itself.
+ *
+ * Returns an error if the store is already hibernating, if WebAssembly is
+ * executing in the store, or if saving the memories fails.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Store.html#method.hibernate
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_context_hibernate(wasmtime_context_t *context, size_t *saved_bytes);
+
+/**
+ * \brief Restores the memories saved by #wasmtime_context_hibernate, if the
+ * store is hibernating.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_context_resume_from_hibernation(wasmtime_context_t *context);
+
+/**
+ * \brief Returns whether #wasmtime_context_hibernate was called and the store
+ * hasn't resumed since.
+ */
+WASM_API_EXTERN bool
+wasmtime_context_is_hibernating(const wasmtime_context_t *context);
+
 #ifdef WASMTIME_FEATURE_WASI
 
 /**
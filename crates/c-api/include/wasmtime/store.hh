@@ -6,6 +6,8 @@
 #define WASMTIME_STORE_HH
 
 #include <any>
+#include <cassert>
+#include <chrono>
 #include <memory>
 #include <optional>
 #include <wasmtime/conf.h>
@@ -43,14 +45,20 @@ class Store {
   WASMTIME_OWN_WRAPPER(Store, wasmtime_store);
 
 private:
+  /// Embedder state attached to each `Store` as its C API data pointer.
+  struct Data {
+    std::any any;
+    void *raw = nullptr;
+  };
+
   static void finalizer(void *ptr) {
-    std::unique_ptr<std::any> _ptr(static_cast<std::any *>(ptr));
+    std::unique_ptr<Data> _ptr(static_cast<Data *>(ptr));
   }
 
 public:
   /// Creates a new `Store` within the provided `Engine`.
   explicit Store(Engine &engine)
-      : ptr(wasmtime_store_new(engine.capi(), nullptr, finalizer)) {}
+      : ptr(wasmtime_store_new(engine.capi(), new Data(), finalizer)) {}
 
   /**
    * \brief An interior pointer into a `Store`.
@@ -62,6 +70,11 @@ public:
    * This object is an argument to most APIs in Wasmtime but typically doesn't
    * need to be constructed explicitly since it can be created from a `Store&`
    * or a `Caller&`.
+   *
+   * The data accessors, `set_data`, `get_data`, `set_data_ptr` and
+   * `get_data_ptr`, may only be used when the store was created by `Store`,
+   * which attaches its own data to it. For a store created with
+   * `wasmtime_store_new` in C, use `wasmtime_context_get_data` instead.
    */
   class Context {
     friend class Global;
@@ -70,12 +83,21 @@ public:
     friend class Func;
     friend class Instance;
     friend class Linker;
+    friend class FrozenLinker;
     friend class ExternRef;
     friend class AnyRef;
+    friend class Tag;
+    friend class ExnRef;
     friend class Val;
     friend class Store;
     wasmtime_context_t *ptr;
 
+    Data *store_data() const {
+      auto *data = static_cast<Data *>(wasmtime_context_get_data(ptr));
+      assert(data != nullptr && "store wasn't created by `wasmtime::Store`");
+      return data;
+    }
+
   public:
     /// Creates a context from the raw C API pointer.
     explicit Context(wasmtime_context_t *ptr) : ptr(ptr) {}
@@ -99,6 +121,16 @@ public:
       return std::monostate();
     }
 
+    /// \brief Returns statistics about the garbage collections performed
+    /// within this store.
+    ///
+    /// See `wasmtime_context_gc_stats` for more information.
+    wasmtime_gc_stats_t gc_stats() const {
+      wasmtime_gc_stats_t stats;
+      wasmtime_context_gc_stats(ptr, &stats);
+      return stats;
+    }
+
     /// Injects fuel to be consumed within this store.
     ///
     /// Stores start with 0 fuel and if `Config::consume_fuel` is enabled then
@@ -126,17 +158,159 @@ public:
     }
 
     /// Set user specified data associated with this store.
-    void set_data(std::any data) const {
-      finalizer(static_cast<std::any *>(wasmtime_context_get_data(ptr)));
-      wasmtime_context_set_data(
-          ptr, std::make_unique<std::any>(std::move(data)).release());
-    }
+    ///
+    /// The store must have been created by `Store`, see `Context`.
+    void set_data(std::any data) const { store_data()->any = std::move(data); }
 
     /// Get user specified data associated with this store.
-    std::any &get_data() const {
-      return *static_cast<std::any *>(wasmtime_context_get_data(ptr));
+    ///
+    /// The store must have been created by `Store`, see `Context`.
+    std::any &get_data() const { return store_data()->any; }
+
+    /// \brief Set a raw pointer associated with this store.
+    ///
+    /// This is a separate slot from `set_data` which is not type-erased, so
+    /// reading it back with `get_data_ptr` involves no RTTI checks. This is
+    /// intended for host functions on hot paths that need access to embedder
+    /// state. The pointee is not owned by the store and must outlive its use.
+    void set_data_ptr(void *data) const { store_data()->raw = data; }
+
+    /// \brief Get the raw pointer configured with `set_data_ptr`, or
+    /// `nullptr` if none was set.
+    ///
+    /// No checks are performed that `T` is the type of the pointer that was
+    /// configured.
+    template <typename T = void> T *get_data_ptr() const {
+      return static_cast<T *>(store_data()->raw);
+    }
+
+    /// \brief Configures the key used by the pooling allocator to prefer
+    /// slots last used by stores with the same key, or 0 to clear it.
+    ///
+    /// See `wasmtime_context_set_pooling_affinity` for more information.
+    void set_pooling_affinity(uint64_t key) const {
+      wasmtime_context_set_pooling_affinity(ptr, key);
+    }
+
+    /// \brief Configures the NUMA node that this store's linear memories are
+    /// placed on, or clears it with `std::nullopt`.
+    ///
+    /// See `wasmtime_context_set_numa_node` for more information.
+    void set_numa_node(std::optional<uint32_t> node) const {
+      wasmtime_context_set_numa_node(ptr, node ? &*node : nullptr);
+    }
+
+    /// \brief Configures whether a backtrace is captured when WebAssembly in
+    /// this store traps.
+    ///
+    /// See `wasmtime_context_set_wasm_backtrace` for more information.
+    void set_wasm_backtrace(bool enable) const {
+      wasmtime_context_set_wasm_backtrace(ptr, enable);
+    }
+
+    /// \brief Returns a snapshot of the resources consumed within this store.
+    ///
+    /// See `wasmtime_context_resource_usage` for more information.
+    wasmtime_resource_usage_t resource_usage() const {
+      wasmtime_resource_usage_t usage;
+      wasmtime_context_resource_usage(ptr, &usage);
+      return usage;
+    }
+
+    /// Starts measuring the CPU used by WebAssembly executing in this store.
+    ///
+    /// See `wasmtime_context_enable_cpu_accounting` for more information.
+    Result<std::monostate> enable_cpu_accounting() {
+      auto *error = wasmtime_context_enable_cpu_accounting(ptr);
+      if (error != nullptr) {
+        return Error(error);
+      }
+      return std::monostate();
+    }
+
+    /// Returns the CPU time consumed so far by WebAssembly executing in this
+    /// store, excluding the time spent in host functions and while async calls
+    /// are suspended.
+    ///
+    /// Returns `std::nullopt` if `enable_cpu_accounting` wasn't called.
+    std::optional<std::chrono::nanoseconds> cpu_time() const {
+      wasmtime_cpu_usage_t usage;
+      if (!wasmtime_context_cpu_usage(ptr, &usage)) {
+        return std::nullopt;
+      }
+      return std::chrono::nanoseconds(usage.guest_cpu_time_nanos);
+    }
+
+    /**
+     * \brief Keeps the state of calls into WebAssembly set up until it's
+     * destroyed, created with `Context::enter`.
+     */
+    class Scope {
+      friend class Context;
+      wasmtime_context_t *ptr;
+
+      explicit Scope(wasmtime_context_t *ptr) : ptr(ptr) {}
+
+    public:
+      Scope(const Scope &) = delete;
+      Scope &operator=(const Scope &) = delete;
+      Scope &operator=(Scope &&) = delete;
+
+      /// Moves the scope out of `other`, which then no longer exits the store.
+      Scope(Scope &&other) noexcept : ptr(other.ptr) { other.ptr = nullptr; }
+
+      /// Exits the store on the thread that entered it.
+      ~Scope() {
+        if (ptr != nullptr) {
+          auto *error = wasmtime_context_exit(ptr);
+          if (error != nullptr) {
+            wasmtime_error_delete(error);
+          }
+        }
+      }
+    };
+
+    /// \brief Sets up the state of calls into WebAssembly once for all the
+    /// calls made on this thread while the returned `Scope` is alive.
+    ///
+    /// See `wasmtime_context_enter` for more information.
+    Result<Scope> enter() {
+      auto *error = wasmtime_context_enter(ptr);
+      if (error != nullptr) {
+        return Error(error);
+      }
+      return Scope(ptr);
+    }
+
+    /// \brief Saves the contents of this store's linear memories and releases
+    /// the memory backing them, returning the number of bytes that the saved
+    /// contents take up.
+    ///
+    /// See `wasmtime_context_hibernate` for more information.
+    Result<size_t> hibernate() {
+      size_t saved_bytes = 0;
+      auto *error = wasmtime_context_hibernate(ptr, &saved_bytes);
+      if (error != nullptr) {
+        return Error(error);
+      }
+      return saved_bytes;
     }
 
+    /// \brief Restores the memories saved by `hibernate`, if the store is
+    /// hibernating.
+    ///
+    /// See `wasmtime_context_resume_from_hibernation` for more information.
+    Result<std::monostate> resume() {
+      auto *error = wasmtime_context_resume_from_hibernation(ptr);
+      if (error != nullptr) {
+        return Error(error);
+      }
+      return std::monostate();
+    }
+
+    /// \brief Returns whether this store is hibernating.
+    bool is_hibernating() const { return wasmtime_context_is_hibernating(ptr); }
+
 #ifdef WASMTIME_FEATURE_WASI
     /// Configures the WASI state used by this store.
     ///
@@ -225,12 +399,46 @@ public:
         ptr.get(), raw_epoch_callback<std::remove_reference_t<F>>,
         std::make_unique<std::remove_reference_t<F>>(std::forward<F>(f))
             .release(),
-        raw_epoch_finalizer<std::remove_reference_t<F>>);
+        raw_finalizer<std::remove_reference_t<F>>);
+  }
+
+  /// \brief Configures a dynamic resource limiter for this store.
+  ///
+  /// The `limiter` provided must have `memory_growing` and `table_growing`
+  /// methods, both with the signature:
+  ///
+  /// ```cpp
+  /// Result<bool> (size_t current, size_t desired,
+  ///               std::optional<size_t> maximum);
+  /// ```
+  ///
+  /// These are invoked when a memory or table is created or grown within this
+  /// store, after the growth has been checked against the limits configured
+  /// with `limiter`, and return whether the growth is permitted. Returning an
+  /// error causes the growth to fail with that error.
+  ///
+  /// See `wasmtime_store_resource_limiter` for more information.
+  template <typename F> void resource_limiter(F &&limiter) {
+    using L = std::remove_reference_t<F>;
+    wasmtime_store_resource_limiter(
+        ptr.get(), raw_memory_growing<L>, raw_table_growing<L>,
+        std::make_unique<L>(std::forward<F>(limiter)).release(),
+        raw_finalizer<L>);
   }
 
   /// Explicit function to acquire a `Context` from this store.
   Context context() { return this; }
 
+  /// \brief Drops all instances and objects within this store so it can be
+  /// reused for a fresh set of instances.
+  ///
+  /// The store's data, limits and epoch deadline callback are preserved, but
+  /// fuel, the epoch deadline and WASI configuration are reset. All objects
+  /// previously created within this store are invalidated.
+  ///
+  /// See `wasmtime_store_reset` for more information.
+  void reset() { wasmtime_store_reset(ptr.get()); }
+
   /// Runs a garbage collection pass in the referenced store to collect loose
   /// GC-managed objects, if any are available.
   Result<std::monostate> gc() { return context().gc(); }
@@ -252,7 +460,43 @@ private:
     return nullptr;
   }
 
-  template <typename F> static void raw_epoch_finalizer(void *data) {
+  template <typename F>
+  static wasmtime_error_t *raw_memory_growing(void *data, size_t current,
+                                              size_t desired, int64_t maximum,
+                                              bool *allowed) {
+    auto &limiter = *static_cast<F *>(data);
+    return limiter_result(
+        limiter.memory_growing(current, desired, limiter_maximum(maximum)),
+        allowed);
+  }
+
+  template <typename F>
+  static wasmtime_error_t *raw_table_growing(void *data, size_t current,
+                                             size_t desired, int64_t maximum,
+                                             bool *allowed) {
+    auto &limiter = *static_cast<F *>(data);
+    return limiter_result(
+        limiter.table_growing(current, desired, limiter_maximum(maximum)),
+        allowed);
+  }
+
+  static std::optional<size_t> limiter_maximum(int64_t maximum) {
+    if (maximum < 0) {
+      return std::nullopt;
+    }
+    return static_cast<size_t>(maximum);
+  }
+
+  static wasmtime_error_t *limiter_result(Result<bool> result,
+                                          bool *allowed) {
+    if (!result) {
+      return result.err().capi_release();
+    }
+    *allowed = result.ok();
+    return nullptr;
+  }
+
+  template <typename F> static void raw_finalizer(void *data) {
     std::unique_ptr<F> _ptr(static_cast<F *>(data));
   }
 };
@@ -76,6 +76,64 @@ WASM_API_EXTERN wasmtime_error_t *
 wasmtime_table_set(wasmtime_context_t *store, const wasmtime_table_t *table,
                    uint64_t index, const wasmtime_val_t *value);
 
+/**
+ * \brief Gets a range of values in a table.
+ *
+ * \param store the store that owns `table`
+ * \param table the table to access
+ * \param index the index of the first element to access
+ * \param vals where to store the `len` values read
+ * \param len the number of elements to access
+ *
+ * This is equivalent to calling #wasmtime_table_get for each of the `len`
+ * elements starting at `index`, but with a single call and bounds check. If
+ * `true` is returned then all of `vals` is filled in and owned by the caller.
+ * Otherwise `false` is returned because the range is out-of-bounds, and `vals`
+ * is left untouched.
+ */
+WASM_API_EXTERN bool wasmtime_table_get_range(wasmtime_context_t *store,
+                                              const wasmtime_table_t *table,
+                                              uint64_t index,
+                                              wasmtime_val_t *vals, size_t len);
+
+/**
+ * \brief Sets a range of values in a table.
+ *
+ * \param store the store that owns `table`
+ * \param table the table to write to
+ * \param index the index of the first element to write
+ * \param vals the `len` values to store
+ * \param len the number of elements to write
+ *
+ * This stores `vals` into the `len` elements starting at `index`, and can fail
+ * if the range is out of bounds, in which case nothing is written, or if a
+ * value has the wrong type for the table, in which case the values before it
+ * have been written. This does not take ownership of any argument but yields
+ * ownership of the error.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_table_set_range(wasmtime_context_t *store,
+                         const wasmtime_table_t *table, uint64_t index,
+                         const wasmtime_val_t *vals, size_t len);
+
+/**
+ * \brief Fills a range of a table with a value.
+ *
+ * \param store the store that owns `table`
+ * \param table the table to write to
+ * \param index the index of the first element to write
+ * \param val the value to store
+ * \param len the number of elements to write
+ *
+ * This stores `val` into the `len` elements starting at `index`. This can fail
+ * if `val` has the wrong type for the table, or if the range is out of bounds,
+ * in which case nothing is written. This does not take ownership of any
+ * argument but yields ownership of the error.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_table_fill(wasmtime_context_t *store, const wasmtime_table_t *table,
+                    uint64_t index, const wasmtime_val_t *val, uint64_t len);
+
 /**
  * \brief Returns the size, in elements, of the specified table
  */
@@ -8,6 +8,7 @@
 #include <optional>
 
 #include <wasmtime/error.hh>
+#include <wasmtime/span.hh>
 #include <wasmtime/store.hh>
 #include <wasmtime/table.h>
 #include <wasmtime/types/table.hh>
@@ -88,6 +89,51 @@ public:
     return std::monostate();
   }
 
+  /// Loads the `vals.size()` values starting at `idx` in this table into
+  /// `vals`.
+  ///
+  /// Any previous values within `vals` are unrooted first. Returns `false`,
+  /// leaving `vals` holding `i32` zeros, if the range is out of bounds.
+  bool get_range(Store::Context cx, uint64_t idx, Span<Val> vals) const {
+    for (auto &val : vals) {
+      val = Val();
+    }
+    return wasmtime_table_get_range(
+        cx.ptr, &table, idx,
+        reinterpret_cast<wasmtime_val_t *>(vals.data()), // NOLINT
+        vals.size());
+  }
+
+  /// Stores `vals` into the `vals.size()` elements starting at `idx` in this
+  /// table.
+  ///
+  /// Returns an error if the range is out of bounds or if a value has the
+  /// wrong type.
+  Result<std::monostate> set_range(Store::Context cx, uint64_t idx,
+                                   Span<const Val> vals) const {
+    auto *error = wasmtime_table_set_range(
+        cx.ptr, &table, idx,
+        reinterpret_cast<const wasmtime_val_t *>(vals.data()), // NOLINT
+        vals.size());
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::monostate();
+  }
+
+  /// Stores `val` into the `len` elements starting at `idx` in this table.
+  ///
+  /// Returns an error if the range is out of bounds or if `val` has the wrong
+  /// type.
+  Result<std::monostate> fill(Store::Context cx, uint64_t idx, const Val &val,
+                              uint64_t len) const {
+    auto *error = wasmtime_table_fill(cx.ptr, &table, idx, &val.val, len);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::monostate();
+  }
+
   /// Grow this table.
   ///
   /// \param cx the store that owns this table.
@@ -0,0 +1,212 @@
+/**
+ * \file wasmtime/tag.h
+ *
+ * Wasmtime APIs for interacting with wasm tags and exceptions.
+ *
+ * With the exceptions proposal enabled (see
+ * #wasmtime_config_wasm_exceptions_set) a host function can throw a wasm
+ * exception with #wasmtime_context_throw, which guest code can catch with
+ * `try_table` like any other exception. Exceptions which aren't caught by the
+ * guest make #wasmtime_func_call return an error, after which the exception can
+ * be inspected with #wasmtime_context_take_pending_exception. Neither
+ * direction captures a backtrace or formats a message, so this is much cheaper
+ * than signaling failure with a trap.
+ */
+
+#ifndef WASMTIME_TAG_H
+#define WASMTIME_TAG_H
+
+#include <wasm.h>
+#include <wasmtime/error.h>
+#include <wasmtime/extern.h>
+#include <wasmtime/store.h>
+#include <wasmtime/val.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Creates a new host-defined tag.
+ *
+ * \param store the store in which to create the tag
+ * \param ty the type of the tag's payload, which must have no results
+ * \param ret where to store the returned tag
+ *
+ * If an error is returned then ownership of the error is transferred to the
+ * caller and `ret` is not written to.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_tag_new(wasmtime_context_t *store,
+                                                   const wasm_functype_t *ty,
+                                                   wasmtime_tag_t *ret);
+
+/**
+ * \brief Returns the type of the payload of the tag specified, which the caller
+ * owns.
+ */
+WASM_API_EXTERN wasm_functype_t *
+wasmtime_tag_type(const wasmtime_context_t *store, const wasmtime_tag_t *tag);
+
+/**
+ * \brief Returns whether `a` and `b` are the same tag.
+ *
+ * Tags are nominal, so two tags with the same type created separately are not
+ * the same tag.
+ */
+WASM_API_EXTERN bool wasmtime_tag_eq(const wasmtime_context_t *store,
+                                     const wasmtime_tag_t *a,
+                                     const wasmtime_tag_t *b);
+
+/**
+ * \typedef wasmtime_exnref_t
+ * \brief Convenience alias for #wasmtime_exnref
+ *
+ * \struct wasmtime_exnref
+ * \brief A reference to a WebAssembly exception object.
+ *
+ * This structure is similar to #wasmtime_externref_t but represents the
+ * `exnref` type in WebAssembly, an exception's tag along with its payload. Note
+ * that this value is itself a reference into a #wasmtime_context_t and must be
+ * explicitly unrooted to enable garbage collection.
+ *
+ * Note that null is represented with this structure and created with
+ * `wasmtime_exnref_set_null`. Null can be tested for with the
+ * `wasmtime_exnref_is_null` function.
+ */
+typedef struct wasmtime_exnref {
+  /// Internal metadata tracking within the store, embedders should not
+  /// configure or modify these fields.
+  uint64_t store_id;
+  /// Internal to Wasmtime.
+  uint32_t __private1;
+  /// Internal to Wasmtime.
+  uint32_t __private2;
+  /// Internal to Wasmtime.
+  void *__private3;
+} wasmtime_exnref_t;
+
+/// \brief Helper function to initialize the `ref` provided to a null exnref
+/// value.
+static inline void wasmtime_exnref_set_null(wasmtime_exnref_t *ref) {
+  ref->store_id = 0;
+}
+
+/// \brief Helper function to return whether the provided `ref` points to a null
+/// `exnref` value.
+static inline bool wasmtime_exnref_is_null(const wasmtime_exnref_t *ref) {
+  return ref->store_id == 0;
+}
+
+/**
+ * \brief Creates a new exception object.
+ *
+ * \param context the store context to allocate the exception within
+ * \param tag the tag of the exception
+ * \param fields the payload of the exception, which must match the parameters
+ *        of the type of `tag`
+ * \param nfields the number of values in `fields`
+ * \param out where to store the returned exception
+ *
+ * If an error is returned then ownership of the error is transferred to the
+ * caller and `out` is not written to. Otherwise `out` must eventually be
+ * unrooted with #wasmtime_exnref_unroot, or be passed to
+ * #wasmtime_context_throw.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_exnref_new(wasmtime_context_t *context, const wasmtime_tag_t *tag,
+                    const wasmtime_val_t *fields, size_t nfields,
+                    wasmtime_exnref_t *out);
+
+/**
+ * \brief Returns the tag of the exception `exnref` in `out`.
+ *
+ * An error is returned if `exnref` is null.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_exnref_tag(wasmtime_context_t *context,
+                    const wasmtime_exnref_t *exnref, wasmtime_tag_t *out);
+
+/**
+ * \brief Returns the number of values in the payload of `exnref`, or zero if
+ * it's null.
+ */
+WASM_API_EXTERN size_t wasmtime_exnref_field_count(
+    const wasmtime_context_t *context, const wasmtime_exnref_t *exnref);
+
+/**
+ * \brief Reads the `index`th value of the payload of `exnref` into `out`.
+ *
+ * An error is returned if `exnref` is null or `index` is out of bounds.
+ * Otherwise the caller owns the value written to `out` and must release it
+ * with #wasmtime_val_unroot.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_exnref_field(wasmtime_context_t *context,
+                      const wasmtime_exnref_t *exnref, size_t index,
+                      wasmtime_val_t *out);
+
+/**
+ * \brief Creates a new reference pointing to the same exception that `ref`
+ * points to.
+ *
+ * The `out` parameter stores the cloned reference. This reference must
+ * eventually be unrooted with #wasmtime_exnref_unroot in the future to
+ * enable GC'ing it.
+ */
+WASM_API_EXTERN void wasmtime_exnref_clone(const wasmtime_exnref_t *ref,
+                                           wasmtime_exnref_t *out);
+
+/**
+ * \brief Unroots the pointer `ref` from the `context` provided.
+ *
+ * The `ref` value may be mutated in place by this function and its contents
+ * are undefined after this function returns. Note that null exnref values do
+ * not need to be unrooted but are still valid to pass to this function.
+ */
+WASM_API_EXTERN void wasmtime_exnref_unroot(wasmtime_exnref_t *ref);
+
+/**
+ * \brief Throws `exnref` as a WebAssembly exception from a host function.
+ *
+ * This takes ownership of `exnref`, sets it as the pending exception of the
+ * store and returns a trap which must be returned from the host function that
+ * is executing. WebAssembly then unwinds to the nearest `try_table` which
+ * catches the exception's tag, or, if there isn't one, the call which entered
+ * WebAssembly returns an error and the exception stays pending until it's
+ * taken with #wasmtime_context_take_pending_exception.
+ *
+ * The returned trap is only a marker that an exception is pending: it doesn't
+ * capture a backtrace or contain a message. If `exnref` is null, or an
+ * exception is already pending, then the returned trap is instead an ordinary
+ * error.
+ */
+WASM_API_EXTERN wasm_trap_t *wasmtime_context_throw(wasmtime_context_t *context,
+                                                    wasmtime_exnref_t *exnref);
+
+/**
+ * \brief Returns whether an exception thrown by WebAssembly, or by
+ * #wasmtime_context_throw, is pending in the store.
+ *
+ * This is the case after #wasmtime_func_call returns an error because of an
+ * uncaught exception.
+ */
+WASM_API_EXTERN bool
+wasmtime_context_has_pending_exception(wasmtime_context_t *context);
+
+/**
+ * \brief Takes the pending exception of the store, if any.
+ *
+ * If an exception is pending it's removed from the store, `out` is filled in
+ * with it and `true` is returned, in which case `out` must eventually be
+ * unrooted with #wasmtime_exnref_unroot. Otherwise `out` is set to null and
+ * `false` is returned.
+ */
+WASM_API_EXTERN bool
+wasmtime_context_take_pending_exception(wasmtime_context_t *context,
+                                        wasmtime_exnref_t *out);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // WASMTIME_TAG_H
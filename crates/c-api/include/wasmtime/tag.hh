@@ -0,0 +1,175 @@
+/**
+ * \file wasmtime/tag.hh
+ */
+
+#ifndef WASMTIME_TAG_HH
+#define WASMTIME_TAG_HH
+
+#include <optional>
+#include <vector>
+#include <wasmtime/error.hh>
+#include <wasmtime/store.hh>
+#include <wasmtime/tag.h>
+#include <wasmtime/trap.hh>
+#include <wasmtime/types/func.hh>
+#include <wasmtime/val.hh>
+
+namespace wasmtime {
+
+/**
+ * \brief A WebAssembly tag.
+ *
+ * Tags identify WebAssembly exceptions: `try_table` catches exceptions by their
+ * tag, and a tag's type is the type of the payload its exceptions carry.
+ *
+ * Note that this type does not itself own any resources. It points to resources
+ * owned within a `Store` and the `Store` must be passed in as the first
+ * argument to the functions defined on `Tag`. Note that if the wrong `Store`
+ * is passed in then the process will be aborted.
+ */
+class Tag {
+  friend class Instance;
+  wasmtime_tag_t tag;
+
+public:
+  /// Creates a new tag from the raw underlying C API representation.
+  Tag(wasmtime_tag_t tag) : tag(tag) {}
+
+  /// Creates a new host-defined tag whose payload has the parameters of `ty`,
+  /// which must have no results.
+  static Result<Tag> create(Store::Context cx, const FuncType &ty) {
+    wasmtime_tag_t tag;
+    auto *error = wasmtime_tag_new(cx.ptr, ty.ptr.get(), &tag);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return Tag(tag);
+  }
+
+  /// Returns the type of this tag.
+  FuncType type(Store::Context cx) const {
+    return wasmtime_tag_type(cx.ptr, &tag);
+  }
+
+  /// Returns whether this is the same tag as `other`.
+  bool same(Store::Context cx, const Tag &other) const {
+    return wasmtime_tag_eq(cx.ptr, &tag, &other.tag);
+  }
+
+  /// Returns the raw underlying C API tag this is using.
+  const wasmtime_tag_t &capi() const { return tag; }
+};
+
+/**
+ * \brief Representation of a WebAssembly `exnref` value, an exception object.
+ *
+ * An `ExnRef` can be thrown from a host function with `throw_exception`, and
+ * exceptions thrown by WebAssembly which aren't caught before returning to the
+ * host can be retrieved with `take_pending`, after `Func::call` fails.
+ *
+ * Note that `ExnRef` values are rooted within a `Store` and are unrooted when
+ * they're destroyed.
+ */
+class ExnRef {
+  wasmtime_exnref_t val;
+
+public:
+  /// Creates a new `ExnRef` directly from its C-API representation.
+  explicit ExnRef(wasmtime_exnref_t val) : val(val) {}
+
+  /// Copy constructor to clone `other`.
+  ExnRef(const ExnRef &other) { wasmtime_exnref_clone(&other.val, &val); }
+
+  /// Copy assignment to clone from `other`.
+  ExnRef &operator=(const ExnRef &other) {
+    wasmtime_exnref_unroot(&val);
+    wasmtime_exnref_clone(&other.val, &val);
+    return *this;
+  }
+
+  /// Move constructor to move the contents of `other`.
+  ExnRef(ExnRef &&other) {
+    val = other.val;
+    wasmtime_exnref_set_null(&other.val);
+  }
+
+  /// Move assignment to move the contents of `other`.
+  ExnRef &operator=(ExnRef &&other) {
+    wasmtime_exnref_unroot(&val);
+    val = other.val;
+    wasmtime_exnref_set_null(&other.val);
+    return *this;
+  }
+
+  ~ExnRef() { wasmtime_exnref_unroot(&val); }
+
+  /// Creates a new exception with the tag `tag` and the payload `fields`.
+  static Result<ExnRef> create(Store::Context cx, const Tag &tag,
+                               const std::vector<Val> &fields) {
+    std::vector<wasmtime_val_t> raw;
+    raw.reserve(fields.size());
+    for (const auto &field : fields) {
+      raw.push_back(field.val);
+    }
+    wasmtime_exnref_t val;
+    auto *error = wasmtime_exnref_new(cx.ptr, &tag.capi(), raw.data(),
+                                      raw.size(), &val);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return ExnRef(val);
+  }
+
+  /// Returns the tag of this exception.
+  Result<Tag> tag(Store::Context cx) const {
+    wasmtime_tag_t tag;
+    auto *error = wasmtime_exnref_tag(cx.ptr, &val, &tag);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return Tag(tag);
+  }
+
+  /// Returns the number of values in the payload of this exception.
+  size_t field_count(Store::Context cx) const {
+    return wasmtime_exnref_field_count(cx.ptr, &val);
+  }
+
+  /// Returns the `index`th value of the payload of this exception.
+  Result<Val> field(Store::Context cx, size_t index) const {
+    wasmtime_val_t ret;
+    auto *error = wasmtime_exnref_field(cx.ptr, &val, index, &ret);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return Val(ret);
+  }
+
+  /// \brief Throws `exn` to WebAssembly from a host function.
+  ///
+  /// The returned trap must be returned from the host function, after which
+  /// WebAssembly unwinds to the nearest `try_table` catching the exception's
+  /// tag. Unlike other traps it has no message or backtrace.
+  static Trap throw_exception(Store::Context cx, ExnRef exn) {
+    return Trap(wasmtime_context_throw(cx.ptr, &exn.val));
+  }
+
+  /// Returns whether an exception is pending in the store, for example after
+  /// `Func::call` fails because WebAssembly didn't catch an exception.
+  static bool has_pending(Store::Context cx) {
+    return wasmtime_context_has_pending_exception(cx.ptr);
+  }
+
+  /// Takes the exception pending in the store, if any.
+  static std::optional<ExnRef> take_pending(Store::Context cx) {
+    wasmtime_exnref_t val;
+    if (wasmtime_context_take_pending_exception(cx.ptr, &val)) {
+      return ExnRef(val);
+    }
+    return std::nullopt;
+  }
+};
+
+} // namespace wasmtime
+
+#endif // WASMTIME_TAG_HH
@@ -142,6 +142,34 @@ WASM_API_EXTERN wasm_trap_t *wasmtime_trap_new_code(wasmtime_trap_code_t code);
 WASM_API_EXTERN bool wasmtime_trap_code(const wasm_trap_t *,
                                         wasmtime_trap_code_t *code);
 
+/**
+ * \brief Creates a new trap with a numeric code and a static message.
+ *
+ * \param code an embedder-defined code to associate with this trap
+ * \param msg the nul-terminated message to associate with this trap
+ *
+ * Unlike #wasmtime_trap_new the message isn't copied, so it must stay valid
+ * and unchanged for the rest of the program, as string literals do. This
+ * makes creating the trap, for example to return from a host function, cost
+ * no more than a single small allocation. The code can be retrieved with
+ * #wasmtime_trap_static_code, or with #wasmtime_error_static_code from the
+ * error returned by a call into WebAssembly that the trap unwound through.
+ *
+ * The #wasm_trap_t returned is owned by the caller.
+ */
+WASM_API_EXTERN wasm_trap_t *wasmtime_trap_new_static(int32_t code,
+                                                      const char *msg);
+
+/**
+ * \brief Attempts to extract the code of a trap created with
+ * #wasmtime_trap_new_static.
+ *
+ * Returns `true` and writes the code through the `code` pointer if the trap
+ * was created with #wasmtime_trap_new_static, or `false` otherwise.
+ */
+WASM_API_EXTERN bool wasmtime_trap_static_code(const wasm_trap_t *,
+                                               int32_t *code);
+
 /**
  * \brief Returns a human-readable name for this frame's function.
  *
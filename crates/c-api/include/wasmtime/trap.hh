@@ -120,6 +120,14 @@ class Trap {
   /// Creates a new trap with the given wasmtime trap code.
   Trap(wasmtime_trap_code_enum code) : Trap(wasmtime_trap_new_code(code)) {}
 
+  /// Creates a new trap with an embedder-defined code and a static message,
+  /// which isn't copied and so must live forever, such as a string literal.
+  ///
+  /// See `wasmtime_trap_new_static` for more information.
+  static Trap from_static(int32_t code, const char *msg) {
+    return Trap(wasmtime_trap_new_static(code, msg));
+  }
+
   /// Returns the descriptive message associated with this trap.
   std::string message() const {
     wasm_byte_vec_t msg;
@@ -147,6 +155,15 @@ class Trap {
       return code;
     return std::nullopt;
   }
+
+  /// \brief Returns the code this trap was created with by `from_static`, or
+  /// nothing if it was created otherwise.
+  std::optional<int32_t> static_code() const {
+    int32_t code;
+    if (wasmtime_trap_static_code(ptr.get(), &code))
+      return code;
+    return std::nullopt;
+  }
 };
 
 /// Structure used to represent either a `Trap` or an `Error`.
@@ -175,6 +192,38 @@ struct TrapError {
 /// (such as a type error) as well as because of a WebAssembly trap.
 template <typename T> using TrapResult = Result<T, TrapError>;
 
+/// Structure used to represent either the code of a WebAssembly trap or an
+/// `Error`, for calls which don't materialize a `Trap`.
+struct TrapCodeError {
+  /// Storage for what this trap represents.
+  std::variant<wasmtime_trap_code_t, Error> data;
+
+  /// Creates a new `TrapCodeError` from a trap code.
+  TrapCodeError(wasmtime_trap_code_t code) : data(code) {}
+  /// Creates a new `TrapCodeError` from an `Error`
+  TrapCodeError(Error e) : data(std::move(e)) {}
+
+  /// Returns the trap code, or nothing if this is an `Error`.
+  std::optional<wasmtime_trap_code_t> code() const {
+    if (const auto *code = std::get_if<wasmtime_trap_code_t>(&data)) {
+      return *code;
+    }
+    return std::nullopt;
+  }
+
+  /// Returns the message associated with this error, which is formatted
+  /// from the code of a trap.
+  std::string message() const {
+    if (const auto *code = std::get_if<wasmtime_trap_code_t>(&data)) {
+      return Trap(static_cast<wasmtime_trap_code_enum>(*code)).message();
+    }
+    return std::string(std::get<Error>(data).message());
+  }
+};
+
+/// Result used by calls which report WebAssembly traps only by their code.
+template <typename T> using TrapCodeResult = Result<T, TrapCodeError>;
+
 } // namespace wasmtime
 
 #endif // WASMTIME_TRAP_HH
@@ -9,6 +9,7 @@
 
 #include <stdalign.h>
 #include <wasm.h>
+#include <wasmtime/error.h>
 #include <wasmtime/extern.h>
 
 #ifdef __cplusplus
@@ -36,6 +37,10 @@ extern "C" {
  * Store*, there will be some memory leaked, because GC roots use a
  * separate allocation to track liveness.
  *
+ * The exception is `i31ref` values, which are stored unboxed in this structure
+ * without being rooted. Creating, copying and inspecting them never allocates
+ * or roots anything in the store, and unrooting them is a no-op.
+ *
  * Null anyref values are represented by this structure and can be tested and
  * created with the `wasmtime_anyref_is_null` and `wasmtime_anyref_set_null`
  * functions.
@@ -123,6 +128,9 @@ WASM_API_EXTERN uint32_t wasmtime_anyref_to_raw(wasmtime_context_t *context,
  * pointer to it.
  *
  * If `i31val` does not fit in 31 bits, it is wrapped.
+ *
+ * The `i31ref` is stored unboxed in `out`, so this doesn't allocate or root
+ * anything within `context`.
  */
 WASM_API_EXTERN void wasmtime_anyref_from_i31(wasmtime_context_t *context,
                                               uint32_t i31val,
@@ -154,6 +162,55 @@ WASM_API_EXTERN bool wasmtime_anyref_i31_get_s(wasmtime_context_t *context,
                                                const wasmtime_anyref_t *anyref,
                                                int32_t *dst);
 
+/**
+ * \brief Returns whether the given `anyref` is an instance of `arrayref`.
+ */
+WASM_API_EXTERN bool wasmtime_anyref_is_array(const wasmtime_context_t *context,
+                                              const wasmtime_anyref_t *anyref);
+
+/**
+ * \brief Gets the length of the array that `anyref` refers to.
+ *
+ * Returns an error if `anyref` isn't an array, otherwise its number of
+ * elements is written to `len`.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_anyref_array_len(const wasmtime_context_t *context,
+                          const wasmtime_anyref_t *anyref, uint32_t *len);
+
+/**
+ * \brief Gets the storage of the elements of the array that `anyref` refers
+ * to, without copying them.
+ *
+ * This is only supported for arrays of numeric or vector elements, such as
+ * `(array i8)` or `(array f64)`. Their elements are stored contiguously in
+ * little-endian order, starting at `*data` and taking up `*size` bytes, which
+ * is the array's length times the size of its element type.
+ *
+ * Returns an error if `anyref` isn't an array or its elements are references.
+ *
+ * The returned pointer is only valid until `context` is next used to run
+ * WebAssembly, allocate a GC object or collect garbage, all of which may move
+ * the array's storage. The array must not be written through this pointer,
+ * see #wasmtime_anyref_array_data_mut for that.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_anyref_array_data(const wasmtime_context_t *context,
+                           const wasmtime_anyref_t *anyref,
+                           const uint8_t **data, size_t *size);
+
+/**
+ * \brief Gets the storage of the elements of the array that `anyref` refers
+ * to for writing, without copying them.
+ *
+ * This is the same as #wasmtime_anyref_array_data, except that it also
+ * returns an error if the array's elements aren't mutable.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_anyref_array_data_mut(wasmtime_context_t *context,
+                               const wasmtime_anyref_t *anyref, uint8_t **data,
+                               size_t *size);
+
 /**
  * \typedef wasmtime_externref_t
  * \brief Convenience alias for #wasmtime_externref
@@ -235,10 +292,37 @@ WASM_API_EXTERN bool wasmtime_externref_new(wasmtime_context_t *context,
  *
  * Returns the original `data` passed to #wasmtime_externref_new. It is required
  * that `data` is not `NULL`.
+ *
+ * Returns `NULL` if the `externref` wasn't created by #wasmtime_externref_new.
  */
 WASM_API_EXTERN void *wasmtime_externref_data(wasmtime_context_t *context,
                                               const wasmtime_externref_t *data);
 
+/**
+ * \brief Create a new `externref` value wrapping a 64-bit integer.
+ *
+ * This is like #wasmtime_externref_new except that `data` is stored inline
+ * within the store rather than needing a separate allocation, and there's no
+ * finalizer to run when the reference is reclaimed. This makes it a cheaper
+ * way to pass integer handles to WebAssembly as `externref`s.
+ *
+ * The wrapped value can be retrieved with #wasmtime_externref_u64.
+ */
+WASM_API_EXTERN bool wasmtime_externref_new_u64(wasmtime_context_t *context,
+                                                uint64_t data,
+                                                wasmtime_externref_t *out);
+
+/**
+ * \brief Get the 64-bit integer wrapped by an `externref`, if any.
+ *
+ * If the given `externref` was created by #wasmtime_externref_new_u64 then the
+ * value it wraps is written to `dst` and `true` is returned. Otherwise `false`
+ * is returned and `dst` is left unmodified.
+ */
+WASM_API_EXTERN bool
+wasmtime_externref_u64(wasmtime_context_t *context,
+                       const wasmtime_externref_t *externref, uint64_t *dst);
+
 /**
  * \brief Creates a new reference pointing to the same data that `ref` points
  * to (depending on the configured collector this might increase a reference
@@ -288,6 +372,30 @@ WASM_API_EXTERN void wasmtime_externref_from_raw(wasmtime_context_t *context,
 WASM_API_EXTERN uint32_t wasmtime_externref_to_raw(
     wasmtime_context_t *context, const wasmtime_externref_t *ref);
 
+/**
+ * \brief Enters a new scope for rooting `anyref` and `externref` values.
+ *
+ * While a scope is active, references created by #wasmtime_anyref_from_raw,
+ * #wasmtime_externref_new, #wasmtime_externref_new_u64 and
+ * #wasmtime_externref_from_raw are rooted in the innermost scope rather than
+ * individually. Cloning such a reference is a plain copy and unrooting it is a
+ * no-op, and all of them are unrooted together, and become invalid, when the
+ * scope is exited with #wasmtime_root_scope_exit. This avoids a call to unroot
+ * each reference when many short-lived references are created.
+ *
+ * The returned value must be passed to #wasmtime_root_scope_exit, and scopes
+ * must be exited in the reverse order that they were entered. Scopes entered
+ * outside of a host function don't apply to references created within it.
+ */
+WASM_API_EXTERN size_t wasmtime_root_scope_enter(wasmtime_context_t *context);
+
+/**
+ * \brief Exits a scope entered with #wasmtime_root_scope_enter, unrooting all
+ * references created within it.
+ */
+WASM_API_EXTERN void wasmtime_root_scope_exit(wasmtime_context_t *context,
+                                              size_t scope);
+
 /// \brief Discriminant stored in #wasmtime_val::kind
 typedef uint8_t wasmtime_valkind_t;
 /// \brief Value of #wasmtime_valkind_t meaning that #wasmtime_val_t is an i32
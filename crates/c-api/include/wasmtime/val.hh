@@ -5,7 +5,13 @@
 #ifndef WASMTIME_VAL_HH
 #define WASMTIME_VAL_HH
 
+#include <cstdint>
+#include <cstring>
 #include <optional>
+#include <type_traits>
+#include <variant>
+#include <wasmtime/error.hh>
+#include <wasmtime/span.hh>
 #include <wasmtime/store.hh>
 #include <wasmtime/types/val.hh>
 #include <wasmtime/val.h>
@@ -80,7 +86,32 @@ public:
     }
   }
 
+  /// Creates a new `externref` value wrapping the integer `handle`.
+  ///
+  /// Unlike the `std::any` constructor the value is stored inline in the
+  /// store, without an allocation or a finalizer, which makes this a cheaper
+  /// way to pass integer handles to WebAssembly.
+  static ExternRef u64(Store::Context cx, uint64_t handle) {
+    wasmtime_externref_t other;
+    if (!wasmtime_externref_new_u64(cx.ptr, handle, &other)) {
+      fprintf(stderr, "failed to allocate a new externref");
+      abort();
+    }
+    return ExternRef(other);
+  }
+
+  /// Returns the integer wrapped by this `ExternRef` if it was created with
+  /// `ExternRef::u64`.
+  std::optional<uint64_t> u64(Store::Context cx) const {
+    uint64_t ret = 0;
+    if (wasmtime_externref_u64(cx.ptr, &val, &ret))
+      return ret;
+    return std::nullopt;
+  }
+
   /// Returns the underlying host data associated with this `ExternRef`.
+  ///
+  /// This must have been created with the `std::any` constructor.
   std::any &data(Store::Context cx) {
     return *static_cast<std::any *>(wasmtime_externref_data(cx.ptr, &val));
   }
@@ -99,11 +130,42 @@ public:
   }
 };
 
+/**
+ * \brief A 31-bit integer, the host representation of an `i31ref`.
+ *
+ * This is used with `Func::wrap` and `TypedFunc` to pass `i31ref` values to
+ * and from WebAssembly as plain integers, without creating an `AnyRef`.
+ */
+class I31 {
+  uint32_t value;
+
+public:
+  /// Creates a new `I31` from `value`, wrapped to 31 bits.
+  explicit I31(int32_t value)
+      : value(static_cast<uint32_t>(value) & 0x7fffffff) {}
+
+  /// Returns this value sign-extended to 32 bits.
+  int32_t i31() const {
+    return static_cast<int32_t>(value << 1) >> 1; // NOLINT
+  }
+
+  /// Returns this value zero-extended to 32 bits.
+  uint32_t u31() const { return value; }
+
+  /// Returns whether this and `other` are the same value.
+  bool operator==(const I31 &other) const { return value == other.value; }
+  /// Returns whether this and `other` are different values.
+  bool operator!=(const I31 &other) const { return value != other.value; }
+};
+
+class ArrayRef;
+
 /**
  * \brief Representation of a WebAssembly `anyref` value.
  */
 class AnyRef {
   friend class Val;
+  friend class ArrayRef;
 
   wasmtime_anyref_t val;
 
@@ -139,12 +201,26 @@ public:
 
   /// Creates a new `AnyRef` which is an `i31` with the given `value`,
   /// truncated if the upper bit is set.
+  ///
+  /// The `i31` is stored unboxed, so this doesn't allocate or root anything
+  /// in the store.
   static AnyRef i31(Store::Context cx, uint32_t value) {
     wasmtime_anyref_t other;
     wasmtime_anyref_from_i31(cx.ptr, value, &other);
     return AnyRef(other);
   }
 
+  /// Creates a new `AnyRef` which is an `i31` with the given signed `value`,
+  /// wrapped to 31 bits.
+  static AnyRef i31(Store::Context cx, int32_t value) {
+    return i31(cx, static_cast<uint32_t>(value));
+  }
+
+  /// Creates a new `AnyRef` which is the `i31` `value`.
+  static AnyRef i31(Store::Context cx, I31 value) {
+    return i31(cx, value.u31());
+  }
+
   /// Consumes ownership of the underlying `wasmtime_anyref_t` and returns the
   /// result of `wasmtime_anyref_to_raw`.
   uint32_t take_raw(Store::Context cx) {
@@ -173,6 +249,174 @@ public:
       return ret;
     return std::nullopt;
   }
+
+  /// Returns whether this is an `arrayref`.
+  bool is_array(Store::Context cx) const {
+    return wasmtime_anyref_is_array(cx.capi(), &val);
+  }
+
+  /// Returns this reference as an `ArrayRef` if it's an `arrayref`.
+  std::optional<ArrayRef> as_array(Store::Context cx) const;
+};
+
+/**
+ * \brief Representation of a WebAssembly `arrayref` value.
+ *
+ * This is an `AnyRef` which is known to be an array, and is rooted in the
+ * same way. Arrays of numeric or vector elements, such as `(array i8)` or
+ * `(array f64)`, can be accessed in bulk through spans over their storage,
+ * which avoids accessing each element individually.
+ *
+ * Note that array elements are stored in little-endian order, and that spans
+ * returned by `data` and `data_mut` are invalidated by calls into WebAssembly,
+ * allocating GC objects, or collecting garbage, all of which may move the
+ * array's storage.
+ */
+class ArrayRef {
+  friend class AnyRef;
+
+  AnyRef ref;
+
+  explicit ArrayRef(AnyRef ref) : ref(std::move(ref)) {}
+
+  template <typename T, typename U>
+  Result<Span<T>> as_span(Store::Context cx, U *data, size_t size) const {
+    static_assert(std::is_trivially_copyable_v<std::remove_cv_t<T>>,
+                  "arrays can only be viewed as trivially copyable types");
+    auto len = this->len(cx);
+    if (!len) {
+      return len.err();
+    }
+    if (size != len.ok() * sizeof(T)) {
+      return Error("array elements aren't the size of the requested type");
+    }
+    if (reinterpret_cast<uintptr_t>(data) % alignof(T) != 0) {
+      return Error("misaligned array data");
+    }
+    return Span<T>(reinterpret_cast<T *>(data), len.ok());
+  }
+
+  static bool in_bounds(size_t len, uint32_t index, size_t count) {
+    return index <= len && count <= len - index;
+  }
+
+  static Error out_of_bounds() { return Error("out of bounds array access"); }
+
+public:
+  /// Returns this array as an `AnyRef`.
+  const AnyRef &anyref() const { return ref; }
+
+  /// Returns the number of elements in this array.
+  Result<uint32_t> len(Store::Context cx) const {
+    uint32_t ret = 0;
+    auto *error = wasmtime_anyref_array_len(cx.capi(), &ref.val, &ret);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return ret;
+  }
+
+  /**
+   * \brief Returns a read-only span over this array's elements, viewed as
+   * values of type `T`.
+   *
+   * This fails if the array's elements are references, or if `T` isn't the
+   * size of the array's element type, such as `uint8_t` for `(array i8)` or
+   * `double` for `(array f64)`.
+   */
+  template <typename T> Result<Span<const T>> data(Store::Context cx) const {
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+    auto *error = wasmtime_anyref_array_data(cx.capi(), &ref.val, &data, &size);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return as_span<const T>(cx, data, size);
+  }
+
+  /// Same as `data`, except that the returned span is mutable, which fails if
+  /// the array's elements aren't mutable.
+  template <typename T> Result<Span<T>> data_mut(Store::Context cx) const {
+    uint8_t *data = nullptr;
+    size_t size = 0;
+    auto *error =
+        wasmtime_anyref_array_data_mut(cx.capi(), &ref.val, &data, &size);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return as_span<T>(cx, data, size);
+  }
+
+  /// Copies `dst.size()` elements of this array starting at `index` into
+  /// `dst`.
+  ///
+  /// Fails, leaving `dst` untouched, if the range is out of bounds or `data`
+  /// fails.
+  template <typename T>
+  Result<std::monostate> read(Store::Context cx, uint32_t index,
+                              Span<T> dst) const {
+    auto src = data<T>(cx);
+    if (!src) {
+      return src.err();
+    }
+    if (!in_bounds(src.ok().size(), index, dst.size())) {
+      return out_of_bounds();
+    }
+    std::memcpy(dst.data(), src.ok().data() + index, dst.size() * sizeof(T));
+    return std::monostate();
+  }
+
+  /// Copies `src` into this array starting at `index`.
+  ///
+  /// Fails, leaving the array untouched, if the range is out of bounds or
+  /// `data_mut` fails.
+  template <typename T>
+  Result<std::monostate> write(Store::Context cx, uint32_t index,
+                               Span<const T> src) const {
+    auto dst = data_mut<T>(cx);
+    if (!dst) {
+      return dst.err();
+    }
+    if (!in_bounds(dst.ok().size(), index, src.size())) {
+      return out_of_bounds();
+    }
+    std::memcpy(dst.ok().data() + index, src.data(), src.size() * sizeof(T));
+    return std::monostate();
+  }
+};
+
+inline std::optional<ArrayRef> AnyRef::as_array(Store::Context cx) const {
+  if (!is_array(cx)) {
+    return std::nullopt;
+  }
+  return ArrayRef(*this);
+}
+
+/**
+ * \brief A scope in which new `AnyRef` and `ExternRef` values are rooted.
+ *
+ * While a `RootScope` is alive, references created with the `ExternRef`
+ * constructors, or from raw values, are rooted in the scope instead of
+ * individually. Copying them is then a plain copy, and they're all unrooted
+ * together when the scope is destroyed, after which they must not be used.
+ * Scopes must be destroyed in the reverse order of their creation.
+ *
+ * See `wasmtime_root_scope_enter` for more information.
+ */
+class RootScope {
+  wasmtime_context_t *cx;
+  size_t scope;
+
+public:
+  /// Enters a new scope in the store `cx`.
+  explicit RootScope(Store::Context cx)
+      : cx(cx.capi()), scope(wasmtime_root_scope_enter(cx.capi())) {}
+
+  RootScope(const RootScope &) = delete;
+  RootScope &operator=(const RootScope &) = delete;
+
+  /// Exits this scope, unrooting all references created within it.
+  ~RootScope() { wasmtime_root_scope_exit(cx, scope); }
 };
 
 /// \brief Container for the `v128` WebAssembly type.
@@ -205,6 +449,7 @@ class Val {
   friend class Global;
   friend class Table;
   friend class Func;
+  friend class ExnRef;
 
   wasmtime_val_t val;
 
@@ -6,16 +6,102 @@
 #define WASMTIME_WASI_HH
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include <wasi.h>
 #include <wasmtime/conf.h>
 #include <wasmtime/helpers.hh>
+#include <wasmtime/span.hh>
 
 #ifdef WASMTIME_FEATURE_WASI
 
 namespace wasmtime {
 
+/**
+ * \brief Output captured by a `WasiOutputBuffer`.
+ */
+struct WasiOutput {
+  /// The captured bytes, oldest first.
+  std::vector<uint8_t> data;
+  /// The number of bytes dropped because the buffer was full.
+  uint64_t dropped;
+};
+
+/**
+ * \brief A bounded in-memory buffer capturing a guest's stdout or stderr.
+ *
+ * Once the buffer holds its capacity the oldest bytes are dropped to make
+ * room for new output. See `wasi_output_buffer_t` for more information.
+ */
+class WasiOutputBuffer {
+  WASMTIME_OWN_WRAPPER(WasiOutputBuffer, wasi_output_buffer);
+
+  /// Creates a new buffer which holds up to `capacity` bytes.
+  explicit WasiOutputBuffer(size_t capacity)
+      : ptr(wasi_output_buffer_new(capacity)) {}
+
+  /// Takes the output captured so far, leaving the buffer empty.
+  WasiOutput take() const {
+    wasm_byte_vec_t out;
+    uint64_t dropped = wasi_output_buffer_take(ptr.get(), &out);
+    WasiOutput ret{std::vector<uint8_t>(out.data, out.data + out.size),
+                   dropped};
+    wasm_byte_vec_delete(&out);
+    return ret;
+  }
+};
+
+/**
+ * \brief A read-only directory which can be preopened by many `WasiConfig`s,
+ * which share its caches of opened files and directory listings.
+ *
+ * See `wasi_shared_dir_t` for more information.
+ */
+class WasiSharedDir {
+  WASMTIME_OWN_WRAPPER(WasiSharedDir, wasi_shared_dir);
+
+  /// Opens the directory at `path` to be shared, returning `std::nullopt` if
+  /// it can't be opened.
+  static std::optional<WasiSharedDir> open(const std::string &path) {
+    auto *raw = wasi_shared_dir_new(path.c_str());
+    if (raw == nullptr) {
+      return std::nullopt;
+    }
+    return WasiSharedDir(raw);
+  }
+};
+
+/**
+ * \brief A read-only tree of files packed into a single buffer, which guests
+ * read without any filesystem calls on the host.
+ *
+ * See `wasi_archive_t` for more information.
+ */
+class WasiArchive {
+  WASMTIME_OWN_WRAPPER(WasiArchive, wasi_archive);
+
+  /// Creates an archive from a copy of its packed representation, returning
+  /// `std::nullopt` if it's invalid.
+  static std::optional<WasiArchive> create(Span<uint8_t> data) {
+    auto *raw = wasi_archive_new(data.data(), data.size());
+    if (raw == nullptr) {
+      return std::nullopt;
+    }
+    return WasiArchive(raw);
+  }
+
+  /// Opens the archive at `path`, returning `std::nullopt` if it can't be
+  /// read or is invalid.
+  static std::optional<WasiArchive> open(const std::string &path) {
+    auto *raw = wasi_archive_open(path.c_str());
+    if (raw == nullptr) {
+      return std::nullopt;
+    }
+    return WasiArchive(raw);
+  }
+};
+
 /**
  * \brief Configuration for an instance of WASI.
  *
@@ -89,6 +175,18 @@ class WasiConfig {
   /// process.
   void inherit_stderr() { return wasi_config_inherit_stderr(ptr.get()); }
 
+  /// Configures stdout to be captured in `buffer`, which can be read while
+  /// the guest runs or after it has finished.
+  void stdout_buffer(const WasiOutputBuffer &buffer) {
+    wasi_config_set_stdout_buffer(ptr.get(), buffer.capi());
+  }
+
+  /// Configures stderr to be captured in `buffer`, which can be read while
+  /// the guest runs or after it has finished.
+  void stderr_buffer(const WasiOutputBuffer &buffer) {
+    wasi_config_set_stderr_buffer(ptr.get(), buffer.capi());
+  }
+
   /// Opens `path` to be opened as `guest_path` in the WASI pseudo-filesystem.
   [[nodiscard]] bool preopen_dir(const std::string &path,
                                  const std::string &guest_path,
@@ -96,6 +194,43 @@ class WasiConfig {
     return wasi_config_preopen_dir(ptr.get(), path.c_str(), guest_path.c_str(),
                                    dir_perms, file_perms);
   }
+
+  /// Opens the shared directory `dir` as `guest_path` in the WASI
+  /// pseudo-filesystem, with read-only access.
+  [[nodiscard]] bool preopen_shared_dir(const WasiSharedDir &dir,
+                                        const std::string &guest_path) {
+    return wasi_config_preopen_shared_dir(ptr.get(), dir.capi(),
+                                          guest_path.c_str());
+  }
+
+  /// Makes the files in `archive` available, read-only, as `guest_path` in
+  /// the WASI pseudo-filesystem.
+  [[nodiscard]] bool preopen_archive(const WasiArchive &archive,
+                                     const std::string &guest_path) {
+    return wasi_config_preopen_archive(ptr.get(), archive.capi(),
+                                       guest_path.c_str());
+  }
+};
+
+/**
+ * \brief The argv, environment variables, preopened directories and network
+ * settings of a `WasiConfig`, used to cheaply create many configs with the
+ * same settings.
+ *
+ * See `wasi_config_template_t` for more information.
+ */
+class WasiConfigTemplate {
+  WASMTIME_OWN_WRAPPER(WasiConfigTemplate, wasi_config_template);
+
+  /// Creates a template of the settings configured so far in `config`.
+  explicit WasiConfigTemplate(const WasiConfig &config)
+      : ptr(wasi_config_template_new(config.capi())) {}
+
+  /// Creates a new configuration with the settings of this template, which
+  /// further arguments and environment variables are added to.
+  WasiConfig config() const {
+    return WasiConfig(wasi_config_new_from_template(ptr.get()));
+  }
 };
 
 } // namespace wasmtime
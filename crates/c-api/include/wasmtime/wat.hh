@@ -16,6 +16,73 @@ namespace wasmtime {
 
 #ifdef WASMTIME_FEATURE_WAT
 
+/**
+ * \brief An owned buffer of WebAssembly binary bytes allocated by Wasmtime.
+ *
+ * This is returned by `wat2wasm_bytes` and owns the underlying
+ * `wasm_byte_vec_t`, so the bytes can be used without being copied.
+ */
+class WasmBytes {
+  wasm_byte_vec_t vec;
+
+public:
+  /// Takes ownership of `vec`.
+  explicit WasmBytes(wasm_byte_vec_t vec) : vec(vec) {}
+  /// Moves the bytes out of `other`.
+  WasmBytes(WasmBytes &&other) : vec(other.vec) {
+    other.vec.size = 0;
+    other.vec.data = nullptr;
+  }
+  /// Moves the bytes out of `other`.
+  WasmBytes &operator=(WasmBytes &&other) {
+    std::swap(vec, other.vec);
+    return *this;
+  }
+  WasmBytes(const WasmBytes &) = delete;
+  WasmBytes &operator=(const WasmBytes &) = delete;
+  ~WasmBytes() { wasm_byte_vec_delete(&vec); }
+
+  /// Returns a pointer to the bytes.
+  uint8_t *data() {
+    return reinterpret_cast<uint8_t *>(vec.data); // NOLINT
+  }
+  /// Returns a pointer to the bytes.
+  const uint8_t *data() const {
+    return reinterpret_cast<const uint8_t *>(vec.data); // NOLINT
+  }
+  /// Returns the number of bytes.
+  size_t size() const { return vec.size; }
+
+  /// Returns an iterator to the first byte.
+  uint8_t *begin() { return data(); }
+  /// Returns an iterator past the last byte.
+  uint8_t *end() { return data() + size(); } // NOLINT
+  /// Returns an iterator to the first byte.
+  const uint8_t *begin() const { return data(); }
+  /// Returns an iterator past the last byte.
+  const uint8_t *end() const { return data() + size(); } // NOLINT
+
+  /// Returns a view of the bytes.
+  operator Span<uint8_t>() { return {data(), size()}; }
+};
+
+/**
+ * \brief Converts the WebAssembly text format into the WebAssembly binary
+ * format.
+ *
+ * This is the same as `wat2wasm` except that the bytes are returned in the
+ * buffer Wasmtime allocated for them, rather than being copied into a
+ * `std::vector`.
+ */
+inline Result<WasmBytes> wat2wasm_bytes(std::string_view wat) {
+  wasm_byte_vec_t ret;
+  auto *error = wasmtime_wat2wasm(wat.data(), wat.size(), &ret);
+  if (error != nullptr) {
+    return Error(error);
+  }
+  return WasmBytes(ret);
+}
+
 /**
  * \brief Converts the WebAssembly text format into the WebAssembly binary
  * format.
@@ -28,17 +95,12 @@ namespace wasmtime {
  * Returns either an error if parsing failed or the wasm binary.
  */
 inline Result<std::vector<uint8_t>> wat2wasm(std::string_view wat) {
-  wasm_byte_vec_t ret;
-  auto *error = wasmtime_wat2wasm(wat.data(), wat.size(), &ret);
-  if (error != nullptr) {
-    return Error(error);
+  auto bytes = wat2wasm_bytes(wat);
+  if (!bytes) {
+    return bytes.err();
   }
-  std::vector<uint8_t> vec;
-  // NOLINTNEXTLINE TODO can this be done without triggering lints?
-  Span<uint8_t> raw(reinterpret_cast<uint8_t *>(ret.data), ret.size);
-  vec.assign(raw.begin(), raw.end());
-  wasm_byte_vec_delete(&ret);
-  return vec;
+  auto &raw = bytes.ok_ref();
+  return std::vector<uint8_t>(raw.begin(), raw.end());
 }
 
 #endif // WASMTIME_FEATURE_WAT
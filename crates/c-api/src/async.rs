@@ -5,17 +5,19 @@ use std::num::NonZeroU64;
 use std::ops::Range;
 use std::pin::Pin;
 use std::sync::Arc;
-use std::task::{Context, Poll, Waker};
+use std::task::{Context, Poll, Wake, Waker};
 use std::{ptr, str};
 use wasmtime::{
-    AsContextMut, Func, Instance, Result, RootScope, StackCreator, StackMemory, Trap, Val,
+    AsContextMut, Func, Instance, ResourceLimiter, ResourceLimiterAsync, Result, RootScope,
+    StackCreator, StackMemory, Trap, Val,
 };
 
+use crate::store::{CStoreLimiter, LimiterCallbacks, c_maximum, install_store_hooks};
 use crate::{
-    WASMTIME_I32, WasmtimeCaller, WasmtimeStoreContextMut, bad_utf8, handle_result, to_str,
-    translate_args, wasm_config_t, wasm_functype_t, wasm_trap_t, wasmtime_caller_t,
+    ForeignData, WASMTIME_I32, WasmtimeCaller, WasmtimeStoreContextMut, bad_utf8, handle_result,
+    to_str, translate_args, wasm_config_t, wasm_functype_t, wasm_trap_t, wasmtime_caller_t,
     wasmtime_error_t, wasmtime_instance_pre_t, wasmtime_linker_t, wasmtime_module_t,
-    wasmtime_val_t, wasmtime_val_union,
+    wasmtime_store_t, wasmtime_val_t, wasmtime_val_union,
 };
 
 #[unsafe(no_mangle)]
@@ -23,6 +25,11 @@ pub extern "C" fn wasmtime_config_async_stack_size_set(c: &mut wasm_config_t, si
     c.config.async_stack_size(size);
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_config_async_stack_cache_size_set(c: &mut wasm_config_t, size: usize) {
+    c.config.async_stack_cache_size(size);
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_context_epoch_deadline_async_yield_and_update(
     mut store: WasmtimeStoreContextMut<'_>,
@@ -42,6 +49,15 @@ pub extern "C" fn wasmtime_context_fuel_async_yield_interval(
     )
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_context_fuel_async_yield_time_slice(
+    mut store: WasmtimeStoreContextMut<'_>,
+    slice_nanos: Option<NonZeroU64>,
+) -> Option<Box<wasmtime_error_t>> {
+    let slice = slice_nanos.map(|n| std::time::Duration::from_nanos(n.get()));
+    handle_result(store.fuel_async_yield_time_slice(slice), |()| {})
+}
+
 pub type wasmtime_func_async_callback_t = extern "C" fn(
     *mut c_void,
     *mut wasmtime_caller_t,
@@ -86,7 +102,7 @@ impl Future for wasmtime_async_continuation_t {
 ///
 /// This is useful in closures that need to capture some C data.
 #[derive(Debug)]
-struct CallbackDataPtr {
+pub(crate) struct CallbackDataPtr {
     pub ptr: *mut std::ffi::c_void,
 }
 
@@ -95,6 +111,136 @@ unsafe impl Sync for CallbackDataPtr {}
 
 pub type wasmtime_func_async_continuation_callback_t = extern "C" fn(*mut c_void) -> bool;
 
+pub type wasmtime_resource_growing_async_callback_t = extern "C" fn(
+    *mut c_void,
+    usize,
+    usize,
+    i64,
+    &mut bool,
+    &mut Option<Box<wasmtime_error_t>>,
+    &mut wasmtime_async_continuation_t,
+);
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_store_resource_limiter_async(
+    store: &mut wasmtime_store_t,
+    memory_growing: Option<wasmtime_resource_growing_async_callback_t>,
+    table_growing: Option<wasmtime_resource_growing_async_callback_t>,
+    data: *mut c_void,
+    finalizer: Option<extern "C" fn(*mut c_void)>,
+) {
+    store.store.data_mut().store_limits.callbacks = Some(LimiterCallbacks::Async {
+        memory_growing,
+        table_growing,
+        foreign: ForeignData { data, finalizer },
+    });
+    install_store_hooks(&mut store.store);
+}
+
+impl CStoreLimiter {
+    async fn growing_async(
+        &mut self,
+        memory: bool,
+        current: usize,
+        desired: usize,
+        maximum: Option<usize>,
+    ) -> Result<bool> {
+        let (callback, data) = match &self.callbacks {
+            Some(LimiterCallbacks::Async {
+                memory_growing,
+                table_growing,
+                foreign,
+            }) => {
+                let callback = if memory {
+                    *memory_growing
+                } else {
+                    *table_growing
+                };
+                (callback, CallbackDataPtr { ptr: foreign.data })
+            }
+            _ => return self.growing(memory, current, desired, maximum),
+        };
+        if !self.check_limits(memory, current, desired, maximum)? {
+            return Ok(false);
+        }
+        if let Some(callback) = callback {
+            extern "C" fn panic_callback(_: *mut c_void) -> bool {
+                panic!("callback must be set")
+            }
+            let mut allowed = false;
+            let mut error = None;
+            let mut continuation = wasmtime_async_continuation_t {
+                callback: panic_callback,
+                env: ptr::null_mut(),
+                finalizer: None,
+            };
+            callback(
+                data.ptr,
+                current,
+                desired,
+                c_maximum(maximum),
+                &mut allowed,
+                &mut error,
+                &mut continuation,
+            );
+            continuation.await;
+            if let Some(err) = error {
+                return Err((*err).into());
+            }
+            if !allowed {
+                return Ok(false);
+            }
+        }
+        self.record_growth(memory, current, desired);
+        Ok(true)
+    }
+}
+
+#[async_trait::async_trait]
+impl ResourceLimiterAsync for CStoreLimiter {
+    async fn memory_growing(
+        &mut self,
+        current: usize,
+        desired: usize,
+        maximum: Option<usize>,
+    ) -> Result<bool> {
+        self.growing_async(true, current, desired, maximum).await
+    }
+
+    fn memory_grow_failed(&mut self, error: wasmtime::Error) -> Result<()> {
+        // Refund the growth approved by `growing_async` before deferring to
+        // the static limits.
+        self.grow_failed(true);
+        self.limits.memory_grow_failed(error)
+    }
+
+    async fn table_growing(
+        &mut self,
+        current: usize,
+        desired: usize,
+        maximum: Option<usize>,
+    ) -> Result<bool> {
+        self.growing_async(false, current, desired, maximum).await
+    }
+
+    fn table_grow_failed(&mut self, error: wasmtime::Error) -> Result<()> {
+        self.grow_failed(false);
+        self.limits.table_grow_failed(error)
+    }
+
+    fn instances(&self) -> usize {
+        ResourceLimiter::instances(self)
+    }
+
+    fn tables(&self) -> usize {
+        ResourceLimiter::tables(self)
+    }
+
+    fn memories(&self) -> usize {
+        ResourceLimiter::memories(self)
+    }
+}
+
 async fn invoke_c_async_callback<'a>(
     cb: wasmtime_func_async_callback_t,
     data: CallbackDataPtr,
@@ -120,8 +266,15 @@ async fn invoke_c_async_callback<'a>(
     }));
     let (params, out_results) = hostcall_val_storage.split_at_mut(params.len());
 
+    // Make the waker of the future polling this call available to
+    // `wasmtime_caller_waker` so the callback can signal its completion.
+    let waker = std::future::poll_fn(|cx| Poll::Ready(cx.waker().clone())).await;
+    caller.data_mut().async_waker = Some(waker);
+
     // Invoke the C function pointer.
     // The result will be a continuation which we will wrap in a Future.
+    // See `c_callback_to_rust_fn` for why root scopes are reset.
+    let root_scopes = mem::take(&mut caller.data_mut().root_scopes);
     let mut caller = wasmtime_caller_t { caller };
     let mut trap = None;
     extern "C" fn panic_callback(_: *mut c_void) -> bool {
@@ -143,6 +296,8 @@ async fn invoke_c_async_callback<'a>(
         &mut continuation,
     );
     continuation.await;
+    caller.caller.data_mut().async_waker = None;
+    caller.caller.data_mut().root_scopes = root_scopes;
 
     if let Some(trap) = trap {
         return Err(trap.error);
@@ -184,26 +339,94 @@ unsafe fn c_async_callback_to_rust_fn(
     }
 }
 
-#[repr(transparent)]
 pub struct wasmtime_call_future_t<'a> {
     underlying: Pin<Box<dyn Future<Output = ()> + 'a>>,
+    waker: Option<Waker>,
+}
+
+impl<'a> wasmtime_call_future_t<'a> {
+    pub(crate) fn new(underlying: Pin<Box<dyn Future<Output = ()> + 'a>>) -> Box<Self> {
+        Box::new(wasmtime_call_future_t {
+            underlying,
+            waker: None,
+        })
+    }
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_call_future_delete(_future: Box<wasmtime_call_future_t>) {}
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_call_future_cancel(future: &mut wasmtime_call_future_t) {
+    // Dropping an in-progress call resumes its fiber with an error, which
+    // unwinds the guest and deallocates the fiber's stack before this returns.
+    // The waker is kept as executors may still reference it.
+    future.underlying = Box::pin(async {});
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_call_future_poll(future: &mut wasmtime_call_future_t) -> bool {
+    let waker = future.waker.as_ref().unwrap_or(Waker::noop());
     match future
         .underlying
         .as_mut()
-        .poll(&mut Context::from_waker(Waker::noop()))
+        .poll(&mut Context::from_waker(waker))
     {
         Poll::Ready(()) => true,
         Poll::Pending => false,
     }
 }
 
+pub type wasmtime_waker_callback_t = extern "C" fn(*mut c_void);
+
+/// A `Waker` which invokes a callback registered with
+/// `wasmtime_call_future_set_waker`.
+struct CWaker {
+    wake: wasmtime_waker_callback_t,
+    foreign: ForeignData,
+}
+
+impl Wake for CWaker {
+    fn wake(self: Arc<Self>) {
+        self.wake_by_ref();
+    }
+
+    fn wake_by_ref(self: &Arc<Self>) {
+        (self.wake)(self.foreign.data);
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_call_future_set_waker(
+    future: &mut wasmtime_call_future_t,
+    wake: wasmtime_waker_callback_t,
+    data: *mut c_void,
+    finalizer: Option<extern "C" fn(*mut c_void)>,
+) {
+    let foreign = ForeignData { data, finalizer };
+    future.waker = Some(Waker::from(Arc::new(CWaker { wake, foreign })));
+}
+
+pub struct wasmtime_waker_t {
+    waker: Waker,
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_caller_waker(
+    caller: &wasmtime_caller_t,
+) -> Option<Box<wasmtime_waker_t>> {
+    let waker = caller.caller.data().async_waker.clone()?;
+    Some(Box::new(wasmtime_waker_t { waker }))
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_waker_wake(waker: &wasmtime_waker_t) {
+    waker.waker.wake_by_ref();
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_waker_delete(_waker: Box<wasmtime_waker_t>) {}
+
 fn handle_call_error(
     err: wasmtime::Error,
     trap_ret: &mut *mut wasm_trap_t,
@@ -265,7 +488,7 @@ pub unsafe extern "C" fn wasmtime_func_call_async<'a>(
         trap_ret,
         err_ret,
     ));
-    Box::new(wasmtime_call_future_t { underlying: fut })
+    wasmtime_call_future_t::new(fut)
 }
 
 #[unsafe(no_mangle)]
@@ -323,7 +546,7 @@ pub extern "C" fn wasmtime_linker_instantiate_async<'a>(
         trap_ret,
         err_ret,
     ));
-    Box::new(crate::wasmtime_call_future_t { underlying: fut })
+    crate::wasmtime_call_future_t::new(fut)
 }
 
 async fn do_instance_pre_instantiate_async(
@@ -355,7 +578,7 @@ pub extern "C" fn wasmtime_instance_pre_instantiate_async<'a>(
         trap_ret,
         err_ret,
     ));
-    Box::new(crate::wasmtime_call_future_t { underlying: fut })
+    crate::wasmtime_call_future_t::new(fut)
 }
 
 pub type wasmtime_stack_memory_get_callback_t =
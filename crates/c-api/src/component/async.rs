@@ -0,0 +1,193 @@
+//! Async support for components, see `wasmtime/component/async.h`.
+
+use super::{
+    wasmtime_component_linker_instance_t, wasmtime_component_linker_t, wasmtime_component_t,
+    wasmtime_component_val_t,
+};
+use crate::r#async::CallbackDataPtr;
+use crate::{
+    WasmtimeStoreContextMut, wasmtime_async_continuation_t, wasmtime_call_future_t,
+    wasmtime_component_func_type_t, wasmtime_error_t,
+};
+use std::ffi::c_void;
+use std::ptr;
+use wasmtime::Result;
+use wasmtime::component::types::ComponentFunc;
+use wasmtime::component::{Func, Instance, Val};
+
+pub type wasmtime_component_func_async_callback_t = extern "C" fn(
+    *mut c_void,
+    WasmtimeStoreContextMut<'_>,
+    &wasmtime_component_func_type_t,
+    *mut wasmtime_component_val_t,
+    usize,
+    *mut wasmtime_component_val_t,
+    usize,
+    &mut Option<Box<wasmtime_error_t>>,
+    &mut wasmtime_async_continuation_t,
+);
+
+/// The values passed to an async host function, which are kept alive until
+/// its continuation completes.
+struct HostcallVals(Vec<wasmtime_component_val_t>);
+
+// SAFETY: these values are only accessed by the future for a single host
+// call, and the C API requires that future to only be polled by one thread
+// at a time.
+unsafe impl Send for HostcallVals {}
+
+async fn invoke_c_async_callback(
+    callback: wasmtime_component_func_async_callback_t,
+    data: CallbackDataPtr,
+    store: WasmtimeStoreContextMut<'_>,
+    ty: ComponentFunc,
+    args: &[Val],
+    rets: &mut [Val],
+) -> Result<()> {
+    let mut vals = HostcallVals(Vec::with_capacity(args.len() + rets.len()));
+    vals.0
+        .extend(args.iter().map(|x| wasmtime_component_val_t::from(x)));
+    vals.0
+        .resize_with(args.len() + rets.len(), Default::default);
+    let ty = wasmtime_component_func_type_t::from(ty);
+
+    extern "C" fn panic_callback(_: *mut c_void) -> bool {
+        panic!("callback must be set")
+    }
+    let mut error = None;
+    let mut continuation = wasmtime_async_continuation_t {
+        callback: panic_callback,
+        env: ptr::null_mut(),
+        finalizer: None,
+    };
+    let (c_args, c_rets) = vals.0.split_at_mut(args.len());
+    callback(
+        data.ptr,
+        store,
+        &ty,
+        c_args.as_mut_ptr(),
+        c_args.len(),
+        c_rets.as_mut_ptr(),
+        c_rets.len(),
+        &mut error,
+        &mut continuation,
+    );
+    continuation.await;
+
+    if let Some(error) = error {
+        return Err((*error).into());
+    }
+    let results = || ty.ty.results().collect();
+    super::move_vals(rets, vals.0.drain(args.len()..), results)
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_component_linker_instance_add_func_async(
+    linker_instance: &mut wasmtime_component_linker_instance_t,
+    name: *const u8,
+    name_len: usize,
+    callback: wasmtime_component_func_async_callback_t,
+    data: *mut c_void,
+    finalizer: Option<extern "C" fn(*mut c_void)>,
+) -> Option<Box<wasmtime_error_t>> {
+    let name = unsafe { std::slice::from_raw_parts(name, name_len) };
+    let Ok(name) = std::str::from_utf8(name) else {
+        return crate::bad_utf8();
+    };
+
+    let foreign = crate::ForeignData { data, finalizer };
+
+    let result =
+        linker_instance
+            .linker_instance
+            .func_new_async(&name, move |store, ty, args, rets| {
+                let _ = &foreign;
+                let data = CallbackDataPtr { ptr: foreign.data };
+                Box::new(invoke_c_async_callback(
+                    callback, data, store, ty, args, rets,
+                ))
+            });
+
+    crate::handle_result(result, |_| ())
+}
+
+async fn do_func_call_async(
+    mut store: WasmtimeStoreContextMut<'_>,
+    func: &Func,
+    mut vals: Vec<Val>,
+    nargs: usize,
+    results: &mut [wasmtime_component_val_t],
+    error_ret: &mut *mut wasmtime_error_t,
+) {
+    let (args, rust_results) = vals.split_at_mut(nargs);
+    match func.call_async(&mut store, args, rust_results).await {
+        Ok(()) => {
+            for (c_val, rust_val) in std::iter::zip(results, vals.drain(nargs..)) {
+                *c_val = wasmtime_component_val_t::from(rust_val);
+            }
+        }
+        Err(err) => *error_ret = Box::into_raw(Box::new(wasmtime_error_t::from(err))),
+    }
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_component_func_call_async<'a>(
+    func: &'a Func,
+    context: WasmtimeStoreContextMut<'a>,
+    args: *const wasmtime_component_val_t,
+    args_len: usize,
+    results: *mut wasmtime_component_val_t,
+    results_len: usize,
+    error_ret: &'a mut *mut wasmtime_error_t,
+) -> Box<wasmtime_call_future_t<'a>> {
+    let c_args = unsafe { crate::slice_from_raw_parts(args, args_len) };
+    let c_results = unsafe { crate::slice_from_raw_parts_mut(results, results_len) };
+
+    let mut vals = Vec::with_capacity(args_len + results_len);
+    let params = || func.ty(&context).params().map(|(_, ty)| ty).collect();
+    if let Err(e) = super::extend_vals(&mut vals, c_args, params) {
+        *error_ret = Box::into_raw(Box::new(wasmtime_error_t::from(e)));
+        return wasmtime_call_future_t::new(Box::pin(async {}));
+    }
+    vals.resize(args_len + results_len, Val::Bool(false));
+
+    let fut = Box::pin(do_func_call_async(
+        context, func, vals, args_len, c_results, error_ret,
+    ));
+    wasmtime_call_future_t::new(fut)
+}
+
+async fn do_linker_instantiate_async(
+    linker: &wasmtime_component_linker_t,
+    store: WasmtimeStoreContextMut<'_>,
+    component: &wasmtime_component_t,
+    instance_out: &mut Instance,
+    error_ret: &mut *mut wasmtime_error_t,
+) {
+    let result = linker
+        .linker
+        .instantiate_async(store, &component.component)
+        .await;
+    match result {
+        Ok(instance) => *instance_out = instance,
+        Err(err) => *error_ret = Box::into_raw(Box::new(wasmtime_error_t::from(err))),
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_linker_instantiate_async<'a>(
+    linker: &'a wasmtime_component_linker_t,
+    context: WasmtimeStoreContextMut<'a>,
+    component: &'a wasmtime_component_t,
+    instance_out: &'a mut Instance,
+    error_ret: &'a mut *mut wasmtime_error_t,
+) -> Box<wasmtime_call_future_t<'a>> {
+    let fut = Box::pin(do_linker_instantiate_async(
+        linker,
+        context,
+        component,
+        instance_out,
+        error_ret,
+    ));
+    wasmtime_call_future_t::new(fut)
+}
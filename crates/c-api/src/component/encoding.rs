@@ -0,0 +1,443 @@
+//! A compact binary encoding of component values, see
+//! `wasmtime_component_val_encode`.
+
+use crate::{
+    handle_result, wasm_name_t, wasmtime_component_val_t, wasmtime_component_valrecord_entry_t,
+    wasmtime_component_valresult_t, wasmtime_component_valtype_t, wasmtime_component_valvariant_t,
+    wasmtime_error_t,
+};
+use std::mem::MaybeUninit;
+use wasmtime::component::types::Type;
+use wasmtime::{Result, bail};
+
+/// Writes the encoding of a value into a fixed buffer, counting the bytes
+/// which didn't fit so that the caller can learn how large the buffer needs
+/// to be.
+struct Encoder<'a> {
+    buf: &'a mut [u8],
+    len: usize,
+}
+
+impl Encoder<'_> {
+    fn bytes(&mut self, bytes: &[u8]) {
+        if let Some(dst) = self.buf.get_mut(self.len..self.len + bytes.len()) {
+            dst.copy_from_slice(bytes);
+        }
+        self.len += bytes.len();
+    }
+
+    fn unsigned(&mut self, mut val: u64) {
+        loop {
+            let byte = (val & 0x7f) as u8;
+            val >>= 7;
+            if val == 0 {
+                return self.bytes(&[byte]);
+            }
+            self.bytes(&[byte | 0x80]);
+        }
+    }
+
+    fn signed(&mut self, mut val: i64) {
+        loop {
+            let byte = (val & 0x7f) as u8;
+            val >>= 7;
+            let sign = byte & 0x40 != 0;
+            if (val == 0 && !sign) || (val == -1 && sign) {
+                return self.bytes(&[byte]);
+            }
+            self.bytes(&[byte | 0x80]);
+        }
+    }
+
+    fn len(&mut self, len: usize) {
+        self.unsigned(len as u64);
+    }
+
+    fn val(&mut self, ty: &Type, val: &wasmtime_component_val_t) -> Result<()> {
+        use wasmtime_component_val_t as V;
+        match (ty, val) {
+            (Type::Bool, V::Bool(x)) => self.bytes(&[u8::from(*x)]),
+            (Type::S8, V::S8(x)) => self.bytes(&[*x as u8]),
+            (Type::U8, V::U8(x)) => self.bytes(&[*x]),
+            (Type::S16, V::S16(x)) => self.signed((*x).into()),
+            (Type::U16, V::U16(x)) => self.unsigned((*x).into()),
+            (Type::S32, V::S32(x)) => self.signed((*x).into()),
+            (Type::U32, V::U32(x)) => self.unsigned((*x).into()),
+            (Type::S64, V::S64(x)) => self.signed(*x),
+            (Type::U64, V::U64(x)) => self.unsigned(*x),
+            (Type::Float32, V::F32(x)) => self.bytes(&x.to_le_bytes()),
+            (Type::Float64, V::F64(x)) => self.bytes(&x.to_le_bytes()),
+            (Type::Char, V::Char(x)) => self.unsigned((*x).into()),
+            (Type::String, V::String(s)) => {
+                self.len(s.as_slice().len());
+                self.bytes(s.as_slice());
+            }
+            (Type::List(ty), V::List(elems)) => {
+                let ty = ty.ty();
+                self.len(elems.as_slice().len());
+                for elem in elems.as_slice() {
+                    self.val(&ty, elem)?;
+                }
+            }
+            (Type::List(ty), V::FlatList(list)) => {
+                let ty = ty.ty();
+                let elems = list.to_vals();
+                self.len(elems.len());
+                for elem in elems {
+                    self.val(&ty, &elem.into())?;
+                }
+            }
+            (Type::Record(ty), V::Record(fields)) => {
+                let fields = fields.as_slice();
+                if ty.fields().len() != fields.len() {
+                    bail!(
+                        "expected {} record fields, found {}",
+                        ty.fields().len(),
+                        fields.len()
+                    );
+                }
+                for (field_ty, field) in ty.fields().zip(fields) {
+                    if field.name.as_slice() != field_ty.name.as_bytes() {
+                        bail!("expected record field `{}`", field_ty.name);
+                    }
+                    self.val(&field_ty.ty, &field.val)?;
+                }
+            }
+            (Type::Record(ty), V::RecordValues(vals)) => {
+                let vals = vals.as_slice();
+                if ty.fields().len() != vals.len() {
+                    bail!(
+                        "expected {} record fields, found {}",
+                        ty.fields().len(),
+                        vals.len()
+                    );
+                }
+                for (field_ty, val) in ty.fields().zip(vals) {
+                    self.val(&field_ty.ty, val)?;
+                }
+            }
+            (Type::Tuple(ty), V::Tuple(elems)) => {
+                let elems = elems.as_slice();
+                if ty.types().len() != elems.len() {
+                    bail!(
+                        "expected {} tuple elements, found {}",
+                        ty.types().len(),
+                        elems.len()
+                    );
+                }
+                for (ty, elem) in ty.types().zip(elems) {
+                    self.val(&ty, elem)?;
+                }
+            }
+            (Type::Variant(ty), V::Variant(variant)) => {
+                let name = variant.discriminant.as_slice();
+                let Some((i, case)) = ty
+                    .cases()
+                    .enumerate()
+                    .find(|(_, case)| case.name.as_bytes() == name)
+                else {
+                    bail!("unknown variant case `{}`", String::from_utf8_lossy(name));
+                };
+                self.len(i);
+                self.payload(case.ty.as_ref(), variant.val.as_deref())?;
+            }
+            (Type::Variant(ty), V::VariantIndex(variant)) => {
+                let i = variant.discriminant as usize;
+                let Some(case) = ty.cases().nth(i) else {
+                    bail!("variant case index {i} is out of bounds");
+                };
+                self.len(i);
+                self.payload(case.ty.as_ref(), variant.val.as_deref())?;
+            }
+            (Type::Enum(ty), V::EnumIndex(i)) => {
+                let i = *i as usize;
+                if i >= ty.names().len() {
+                    bail!("enum case index {i} is out of bounds");
+                }
+                self.len(i);
+            }
+            (Type::Enum(ty), V::Enum(name)) => {
+                let name = name.as_slice();
+                let Some(i) = ty.names().position(|n| n.as_bytes() == name) else {
+                    bail!("unknown enum case `{}`", String::from_utf8_lossy(name));
+                };
+                self.len(i);
+            }
+            (Type::Option(ty), V::Option(val)) => match val {
+                None => self.bytes(&[0]),
+                Some(val) => {
+                    self.bytes(&[1]);
+                    self.val(&ty.ty(), val)?;
+                }
+            },
+            (Type::Result(ty), V::Result(result)) => {
+                self.bytes(&[u8::from(!result.is_ok)]);
+                let ty = if result.is_ok { ty.ok() } else { ty.err() };
+                self.payload(ty.as_ref(), result.val.as_deref())?;
+            }
+            (Type::Flags(ty), V::Flags(flags)) => {
+                let mut bits = vec![0u8; ty.names().len().div_ceil(8)];
+                for flag in flags.as_slice() {
+                    let flag = flag.as_slice();
+                    let Some(i) = ty.names().position(|n| n.as_bytes() == flag) else {
+                        bail!("unknown flag `{}`", String::from_utf8_lossy(flag));
+                    };
+                    bits[i / 8] |= 1 << (i % 8);
+                }
+                self.bytes(&bits);
+            }
+            (Type::Flags(ty), V::FlagsMask(mask)) => {
+                let count = ty.names().len();
+                let mut bits = vec![0u8; count.div_ceil(8)];
+                for (i, word) in mask.as_slice().iter().enumerate() {
+                    for (j, byte) in word.to_le_bytes().into_iter().enumerate() {
+                        match bits.get_mut(i * 4 + j) {
+                            Some(dst) => *dst = byte,
+                            None if byte == 0 => {}
+                            None => {
+                                bail!("flags mask sets a bit beyond the {count} flags of its type")
+                            }
+                        }
+                    }
+                }
+                if count % 8 != 0 && bits.last().is_some_and(|b| b >> (count % 8) != 0) {
+                    bail!("flags mask sets a bit beyond the {count} flags of its type");
+                }
+                self.bytes(&bits);
+            }
+            (
+                Type::Own(_)
+                | Type::Borrow(_)
+                | Type::Future(_)
+                | Type::Stream(_)
+                | Type::ErrorContext,
+                _,
+            ) => bail!("resources, futures, streams and error contexts can't be encoded"),
+            _ => bail!("value doesn't match the type it's encoded with"),
+        }
+        Ok(())
+    }
+
+    fn payload(&mut self, ty: Option<&Type>, val: Option<&wasmtime_component_val_t>) -> Result<()> {
+        match (ty, val) {
+            (Some(ty), Some(val)) => self.val(ty, val),
+            (None, None) => Ok(()),
+            (Some(_), None) => bail!("missing payload"),
+            (None, Some(_)) => bail!("unexpected payload"),
+        }
+    }
+}
+
+fn name(name: &str) -> wasm_name_t {
+    wasm_name_t::from_name(name.to_string())
+}
+
+/// Reads a value back out of the encoding produced by `Encoder`.
+struct Decoder<'a> {
+    bytes: &'a [u8],
+}
+
+impl<'a> Decoder<'a> {
+    fn bytes(&mut self, len: usize) -> Result<&'a [u8]> {
+        if len > self.bytes.len() {
+            bail!("unexpected end of encoded value");
+        }
+        let (ret, rest) = self.bytes.split_at(len);
+        self.bytes = rest;
+        Ok(ret)
+    }
+
+    fn byte(&mut self) -> Result<u8> {
+        Ok(self.bytes(1)?[0])
+    }
+
+    fn array<const N: usize>(&mut self) -> Result<[u8; N]> {
+        Ok(self.bytes(N)?.try_into().unwrap())
+    }
+
+    fn unsigned(&mut self) -> Result<u64> {
+        let mut ret = 0;
+        let mut shift = 0;
+        loop {
+            let byte = self.byte()?;
+            if shift >= 64 {
+                bail!("integer too large in encoded value");
+            }
+            ret |= u64::from(byte & 0x7f) << shift;
+            shift += 7;
+            if byte & 0x80 == 0 {
+                return Ok(ret);
+            }
+        }
+    }
+
+    fn signed(&mut self) -> Result<i64> {
+        let mut ret = 0;
+        let mut shift = 0;
+        loop {
+            let byte = self.byte()?;
+            if shift >= 64 {
+                bail!("integer too large in encoded value");
+            }
+            ret |= i64::from(byte & 0x7f) << shift;
+            shift += 7;
+            if byte & 0x80 == 0 {
+                if shift < 64 && byte & 0x40 != 0 {
+                    ret |= -1 << shift;
+                }
+                return Ok(ret);
+            }
+        }
+    }
+
+    fn len(&mut self) -> Result<usize> {
+        Ok(usize::try_from(self.unsigned()?)?)
+    }
+
+    fn val(&mut self, ty: &Type) -> Result<wasmtime_component_val_t> {
+        use wasmtime_component_val_t as V;
+        Ok(match ty {
+            Type::Bool => match self.byte()? {
+                0 => V::Bool(false),
+                1 => V::Bool(true),
+                _ => bail!("invalid bool in encoded value"),
+            },
+            Type::S8 => V::S8(self.byte()? as i8),
+            Type::U8 => V::U8(self.byte()?),
+            Type::S16 => V::S16(self.signed()?.try_into()?),
+            Type::U16 => V::U16(self.unsigned()?.try_into()?),
+            Type::S32 => V::S32(self.signed()?.try_into()?),
+            Type::U32 => V::U32(self.unsigned()?.try_into()?),
+            Type::S64 => V::S64(self.signed()?),
+            Type::U64 => V::U64(self.unsigned()?),
+            Type::Float32 => V::F32(f32::from_le_bytes(self.array()?)),
+            Type::Float64 => V::F64(f64::from_le_bytes(self.array()?)),
+            Type::Char => match char::from_u32(self.unsigned()?.try_into()?) {
+                Some(c) => V::Char(c.into()),
+                None => bail!("invalid char in encoded value"),
+            },
+            Type::String => {
+                let len = self.len()?;
+                let s = std::str::from_utf8(self.bytes(len)?)?;
+                V::String(name(s))
+            }
+            Type::List(ty) => {
+                let ty = ty.ty();
+                let len = self.len()?;
+                let mut elems = Vec::with_capacity(len.min(self.bytes.len()));
+                for _ in 0..len {
+                    elems.push(self.val(&ty)?);
+                }
+                V::List(elems.into())
+            }
+            Type::Record(ty) => {
+                let mut fields = Vec::with_capacity(ty.fields().len());
+                for field in ty.fields() {
+                    fields.push(wasmtime_component_valrecord_entry_t {
+                        name: name(field.name),
+                        val: self.val(&field.ty)?,
+                    });
+                }
+                V::Record(fields.into())
+            }
+            Type::Tuple(ty) => {
+                let mut elems = Vec::with_capacity(ty.types().len());
+                for ty in ty.types() {
+                    elems.push(self.val(&ty)?);
+                }
+                V::Tuple(elems.into())
+            }
+            Type::Variant(ty) => {
+                let i = self.len()?;
+                let Some(case) = ty.cases().nth(i) else {
+                    bail!("invalid variant case in encoded value");
+                };
+                V::Variant(wasmtime_component_valvariant_t {
+                    discriminant: name(case.name),
+                    val: self.payload(case.ty.as_ref())?,
+                })
+            }
+            Type::Enum(ty) => {
+                let i = self.len()?;
+                let Some(case) = ty.names().nth(i) else {
+                    bail!("invalid enum case in encoded value");
+                };
+                V::Enum(name(case))
+            }
+            Type::Option(ty) => match self.byte()? {
+                0 => V::Option(None),
+                1 => V::Option(Some(Box::new(self.val(&ty.ty())?))),
+                _ => bail!("invalid option in encoded value"),
+            },
+            Type::Result(ty) => {
+                let (is_ok, ty) = match self.byte()? {
+                    0 => (true, ty.ok()),
+                    1 => (false, ty.err()),
+                    _ => bail!("invalid result in encoded value"),
+                };
+                V::Result(wasmtime_component_valresult_t {
+                    is_ok,
+                    val: self.payload(ty.as_ref())?,
+                })
+            }
+            Type::Flags(ty) => {
+                let bits = self.bytes(ty.names().len().div_ceil(8))?;
+                let mut flags = Vec::new();
+                for (i, flag) in ty.names().enumerate() {
+                    if bits[i / 8] & (1 << (i % 8)) != 0 {
+                        flags.push(name(flag));
+                    }
+                }
+                V::Flags(flags.into())
+            }
+            Type::Own(_)
+            | Type::Borrow(_)
+            | Type::Future(_)
+            | Type::Stream(_)
+            | Type::ErrorContext => {
+                bail!("resources, futures, streams and error contexts can't be decoded")
+            }
+        })
+    }
+
+    fn payload(&mut self, ty: Option<&Type>) -> Result<Option<Box<wasmtime_component_val_t>>> {
+        match ty {
+            Some(ty) => Ok(Some(Box::new(self.val(ty)?))),
+            None => Ok(None),
+        }
+    }
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_component_val_encode(
+    val: &wasmtime_component_val_t,
+    ty: &wasmtime_component_valtype_t,
+    buf: *mut u8,
+    buf_len: usize,
+    len_ret: &mut usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let buf = unsafe { crate::slice_from_raw_parts_mut(buf, buf_len) };
+    let mut encoder = Encoder { buf, len: 0 };
+    let result = encoder.val(&Type::from(ty), val);
+    handle_result(result, |()| *len_ret = encoder.len)
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_component_val_decode(
+    ty: &wasmtime_component_valtype_t,
+    buf: *const u8,
+    len: usize,
+    val_ret: &mut MaybeUninit<wasmtime_component_val_t>,
+) -> Option<Box<wasmtime_error_t>> {
+    let bytes = unsafe { crate::slice_from_raw_parts(buf, len) };
+    let mut decoder = Decoder { bytes };
+    let result = decoder.val(&Type::from(ty)).and_then(|val| {
+        if !decoder.bytes.is_empty() {
+            bail!("trailing bytes after encoded value");
+        }
+        Ok(val)
+    });
+    handle_result(result, |val| {
+        val_ret.write(val);
+    })
+}
@@ -1,6 +1,9 @@
 use super::wasmtime_component_val_t;
 use crate::{WasmtimeStoreContextMut, wasmtime_component_func_type_t, wasmtime_error_t};
-use wasmtime::component::{Func, Val};
+use std::ffi::c_void;
+use std::mem::MaybeUninit;
+use wasmtime::component::{Func, LazyResults, Val};
+use wasmtime::{Result, bail};
 
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn wasmtime_component_func_call(
@@ -14,18 +17,127 @@ pub unsafe extern "C" fn wasmtime_component_func_call(
     let c_args = unsafe { crate::slice_from_raw_parts(args, args_len) };
     let c_results = unsafe { crate::slice_from_raw_parts_mut(results, results_len) };
 
-    let args = c_args.iter().map(Val::from).collect::<Vec<_>>();
-    let mut results = vec![Val::Bool(false); results_len];
+    // Allocate the arguments and results together to save an allocation for
+    // each call.
+    let mut vals = Vec::with_capacity(args_len + results_len);
+    let params = || func.ty(&context).params().map(|(_, ty)| ty).collect();
+    if let Err(e) = super::extend_vals(&mut vals, c_args, params) {
+        return Some(Box::new(e.into()));
+    }
+    vals.resize(args_len + results_len, Val::Bool(false));
+    let (args, results) = vals.split_at_mut(args_len);
 
-    let result = func.call(&mut context, &args, &mut results);
+    let result = func.call(&mut context, args, results);
 
     crate::handle_result(result, |_| {
-        for (c_val, rust_val) in std::iter::zip(c_results, results) {
-            *c_val = wasmtime_component_val_t::from(&rust_val);
+        for (c_val, rust_val) in std::iter::zip(c_results, vals.drain(args_len..)) {
+            *c_val = wasmtime_component_val_t::from(rust_val);
         }
     })
 }
 
+pub struct wasmtime_component_lazy_results_t<'a, 'b> {
+    results: LazyResults<'a, 'b>,
+}
+
+pub type wasmtime_component_lazy_results_callback_t =
+    extern "C" fn(
+        *mut c_void,
+        &mut wasmtime_component_lazy_results_t<'_, '_>,
+    ) -> Option<Box<wasmtime_error_t>>;
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_component_func_call_lazy(
+    func: &Func,
+    mut context: WasmtimeStoreContextMut<'_>,
+    args: *const wasmtime_component_val_t,
+    args_len: usize,
+    callback: wasmtime_component_lazy_results_callback_t,
+    data: *mut c_void,
+) -> Option<Box<wasmtime_error_t>> {
+    let c_args = unsafe { crate::slice_from_raw_parts(args, args_len) };
+
+    let mut args = Vec::with_capacity(args_len);
+    let params = || func.ty(&context).params().map(|(_, ty)| ty).collect();
+    if let Err(e) = super::extend_vals(&mut args, c_args, params) {
+        return Some(Box::new(e.into()));
+    }
+
+    let result = func.call_lazy(&mut context, &args, |results| {
+        let mut results = wasmtime_component_lazy_results_t { results };
+        match callback(data, &mut results) {
+            Some(err) => Err((*err).into()),
+            None => Ok(()),
+        }
+    });
+    crate::handle_result(result, |()| ())
+}
+
+impl wasmtime_component_lazy_results_t<'_, '_> {
+    fn check_index(&self, index: usize) -> Result<()> {
+        if index >= self.results.len() {
+            bail!(
+                "result index {index} is out of bounds for {} results",
+                self.results.len()
+            );
+        }
+        Ok(())
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_lazy_results_len(
+    results: &wasmtime_component_lazy_results_t<'_, '_>,
+) -> usize {
+    results.results.len()
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_lazy_results_get(
+    results: &mut wasmtime_component_lazy_results_t<'_, '_>,
+    index: usize,
+    val_out: &mut MaybeUninit<wasmtime_component_val_t>,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = results
+        .check_index(index)
+        .and_then(|()| results.results.get(index));
+    crate::handle_result(result, |val| {
+        val_out.write(wasmtime_component_val_t::from(val));
+    })
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_lazy_results_list_len(
+    results: &mut wasmtime_component_lazy_results_t<'_, '_>,
+    index: usize,
+    len_out: &mut usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = results
+        .check_index(index)
+        .and_then(|()| Ok(results.results.list(index)?.list_len()));
+    crate::handle_result(result, |len| *len_out = len)
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_lazy_results_list_get(
+    results: &mut wasmtime_component_lazy_results_t<'_, '_>,
+    index: usize,
+    elem_index: usize,
+    val_out: &mut MaybeUninit<wasmtime_component_val_t>,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = results.check_index(index).and_then(|()| {
+        let mut list = results.results.list(index)?;
+        let len = list.list_len();
+        match list.get(elem_index) {
+            Some(val) => val,
+            None => bail!("list index {elem_index} is out of bounds for length {len}"),
+        }
+    });
+    crate::handle_result(result, |val| {
+        val_out.write(wasmtime_component_val_t::from(val));
+    })
+}
+
 #[deprecated(note = "no longer has any effect")]
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn wasmtime_component_func_post_return(
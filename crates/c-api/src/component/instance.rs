@@ -1,8 +1,8 @@
-use wasmtime::component::{Func, Instance};
+use wasmtime::component::{Func, Instance, InstancePre};
 
-use crate::WasmtimeStoreContextMut;
+use crate::{WasmtimeStoreContextMut, WasmtimeStoreData, wasmtime_error_t};
 
-use super::wasmtime_component_export_index_t;
+use super::{wasmtime_component_export_index_t, wasmtime_component_t};
 
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn wasmtime_component_instance_get_export_index(
@@ -42,3 +42,81 @@ pub unsafe extern "C" fn wasmtime_component_instance_get_func(
         false
     }
 }
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_instance_set_argument_scratch(
+    instance: &Instance,
+    context: WasmtimeStoreContextMut<'_>,
+    enable: bool,
+) {
+    instance.set_argument_scratch(context, enable);
+}
+
+#[repr(transparent)]
+pub struct wasmtime_component_instance_pre_t {
+    pub(crate) underlying: InstancePre<WasmtimeStoreData>,
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_instance_pre_clone(
+    instance_pre: &wasmtime_component_instance_pre_t,
+) -> Box<wasmtime_component_instance_pre_t> {
+    Box::new(wasmtime_component_instance_pre_t {
+        underlying: instance_pre.underlying.clone(),
+    })
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_instance_pre_delete(
+    _instance_pre: Box<wasmtime_component_instance_pre_t>,
+) {
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_instance_pre_instantiate(
+    instance_pre: &wasmtime_component_instance_pre_t,
+    context: WasmtimeStoreContextMut<'_>,
+    instance_out: &mut Instance,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = instance_pre.underlying.instantiate(context);
+    crate::handle_result(result, |instance| *instance_out = instance)
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_instance_pre_component(
+    instance_pre: &wasmtime_component_instance_pre_t,
+) -> Box<wasmtime_component_t> {
+    Box::new(wasmtime_component_t {
+        component: instance_pre.underlying.component().clone(),
+    })
+}
+
+#[cfg(feature = "async")]
+async fn do_instance_pre_instantiate_async(
+    instance_pre: &wasmtime_component_instance_pre_t,
+    context: WasmtimeStoreContextMut<'_>,
+    instance_out: &mut Instance,
+    error_ret: &mut *mut wasmtime_error_t,
+) {
+    match instance_pre.underlying.instantiate_async(context).await {
+        Ok(instance) => *instance_out = instance,
+        Err(err) => *error_ret = Box::into_raw(Box::new(wasmtime_error_t::from(err))),
+    }
+}
+
+#[unsafe(no_mangle)]
+#[cfg(feature = "async")]
+pub extern "C" fn wasmtime_component_instance_pre_instantiate_async<'a>(
+    instance_pre: &'a wasmtime_component_instance_pre_t,
+    context: WasmtimeStoreContextMut<'a>,
+    instance_out: &'a mut Instance,
+    error_ret: &'a mut *mut wasmtime_error_t,
+) -> Box<crate::wasmtime_call_future_t<'a>> {
+    let fut = Box::pin(do_instance_pre_instantiate_async(
+        instance_pre,
+        context,
+        instance_out,
+        error_ret,
+    ));
+    crate::wasmtime_call_future_t::new(fut)
+}
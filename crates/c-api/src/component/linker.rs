@@ -3,9 +3,9 @@ use crate::{
     wasmtime_component_resource_type_t, wasmtime_error_t, wasmtime_module_t,
 };
 use std::ffi::c_void;
-use wasmtime::component::{Instance, Linker, LinkerInstance, Val};
+use wasmtime::component::{Instance, Linker, LinkerInstance};
 
-use super::{wasmtime_component_t, wasmtime_component_val_t};
+use super::{wasmtime_component_instance_pre_t, wasmtime_component_t, wasmtime_component_val_t};
 
 #[repr(transparent)]
 pub struct wasmtime_component_linker_t {
@@ -54,6 +54,19 @@ pub extern "C" fn wasmtime_component_linker_instantiate(
     crate::handle_result(result, |instance| *instance_out = instance)
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_linker_instantiate_pre(
+    linker: &wasmtime_component_linker_t,
+    component: &wasmtime_component_t,
+    instance_pre_out: &mut *mut wasmtime_component_instance_pre_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = linker.linker.instantiate_pre(&component.component);
+    crate::handle_result(result, |underlying| {
+        let instance_pre = Box::new(wasmtime_component_instance_pre_t { underlying });
+        *instance_pre_out = Box::into_raw(instance_pre);
+    })
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_component_linker_delete(_linker: Box<wasmtime_component_linker_t>) {}
 
@@ -127,19 +140,20 @@ pub unsafe extern "C" fn wasmtime_component_linker_instance_add_func(
         .func_new(&name, move |ctx, ty, args, rets| {
             let _ = &foreign;
 
-            let mut args = args
-                .iter()
-                .map(|x| wasmtime_component_val_t::from(x))
-                .collect::<Vec<_>>();
-
-            let mut c_rets = vec![wasmtime_component_val_t::Bool(false); rets.len()];
+            // As with `wasmtime_component_func_call` the arguments and
+            // results share one allocation.
+            let mut vals = Vec::with_capacity(args.len() + rets.len());
+            vals.extend(args.iter().map(|x| wasmtime_component_val_t::from(x)));
+            vals.resize_with(args.len() + rets.len(), Default::default);
+            let (c_args, c_rets) = vals.split_at_mut(args.len());
 
+            let ty = wasmtime_component_func_type_t::from(ty);
             let res = callback(
                 foreign.data,
                 ctx,
-                &ty.into(),
-                args.as_mut_ptr(),
-                args.len(),
+                &ty,
+                c_args.as_mut_ptr(),
+                c_args.len(),
                 c_rets.as_mut_ptr(),
                 c_rets.len(),
             );
@@ -148,11 +162,8 @@ pub unsafe extern "C" fn wasmtime_component_linker_instance_add_func(
                 return Err((*res).into());
             }
 
-            for (rust_val, c_val) in std::iter::zip(rets, c_rets) {
-                *rust_val = Val::from(&c_val);
-            }
-
-            Ok(())
+            let results = || ty.ty.results().collect();
+            super::move_vals(rets, vals.drain(args.len()..), results)
         });
 
     crate::handle_result(result, |_| ())
@@ -1,11 +1,17 @@
+#[cfg(feature = "async")]
+mod r#async;
 mod component;
+mod encoding;
 mod func;
 mod instance;
 mod linker;
 mod types;
 mod val;
 
+#[cfg(feature = "async")]
+pub use r#async::*;
 pub use component::*;
+pub use encoding::*;
 pub use func::*;
 pub use instance::*;
 pub use linker::*;
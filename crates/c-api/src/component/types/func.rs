@@ -9,6 +9,7 @@ type_wrapper! {
 
     clone: wasmtime_component_func_type_clone,
     delete: wasmtime_component_func_type_delete,
+    equal: wasmtime_component_func_type_equal,
 }
 
 #[unsafe(no_mangle)]
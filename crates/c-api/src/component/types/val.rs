@@ -66,6 +66,40 @@ impl From<Type> for wasmtime_component_valtype_t {
     }
 }
 
+impl From<&wasmtime_component_valtype_t> for Type {
+    fn from(item: &wasmtime_component_valtype_t) -> Self {
+        use wasmtime_component_valtype_t as T;
+        match item {
+            T::Bool => Type::Bool,
+            T::S8 => Type::S8,
+            T::S16 => Type::S16,
+            T::S32 => Type::S32,
+            T::S64 => Type::S64,
+            T::U8 => Type::U8,
+            T::U16 => Type::U16,
+            T::U32 => Type::U32,
+            T::U64 => Type::U64,
+            T::F32 => Type::Float32,
+            T::F64 => Type::Float64,
+            T::Char => Type::Char,
+            T::String => Type::String,
+            T::List(ty) => Type::List(ty.ty.clone()),
+            T::Record(ty) => Type::Record(ty.ty.clone()),
+            T::Tuple(ty) => Type::Tuple(ty.ty.clone()),
+            T::Variant(ty) => Type::Variant(ty.ty.clone()),
+            T::Enum(ty) => Type::Enum(ty.ty.clone()),
+            T::Option(ty) => Type::Option(ty.ty.clone()),
+            T::Result(ty) => Type::Result(ty.ty.clone()),
+            T::Flags(ty) => Type::Flags(ty.ty.clone()),
+            T::Own(ty) => Type::Own(ty.ty.clone()),
+            T::Borrow(ty) => Type::Borrow(ty.ty.clone()),
+            T::Future(ty) => Type::Future(ty.ty.clone()),
+            T::Stream(ty) => Type::Stream(ty.ty.clone()),
+            T::ErrorContext => Type::ErrorContext,
+        }
+    }
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_component_valtype_clone(
     ty: &wasmtime_component_valtype_t,
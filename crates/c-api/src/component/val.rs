@@ -2,11 +2,14 @@ use crate::{
     WasmtimeStoreContextMut, handle_result, wasm_name_t, wasmtime_component_resource_type_t,
     wasmtime_error_t,
 };
+use std::ffi::c_void;
 use std::mem;
 use std::mem::{ManuallyDrop, MaybeUninit};
 use std::ptr;
 use std::slice;
+use wasmtime::component::types::Type;
 use wasmtime::component::{ResourceAny, ResourceDynamic, Val};
+use wasmtime::{Result, bail};
 
 crate::declare_vecs! {
     (
@@ -45,6 +48,15 @@ crate::declare_vecs! {
         copy: wasmtime_component_valflags_copy,
         delete: wasmtime_component_valflags_delete,
     )
+    (
+        name: wasmtime_component_valflagsmask_t,
+        ty: u32,
+        new: wasmtime_component_valflagsmask_new,
+        empty: wasmtime_component_valflagsmask_new_empty,
+        uninit: wasmtime_component_valflagsmask_new_uninit,
+        copy: wasmtime_component_valflagsmask_copy,
+        delete: wasmtime_component_valflagsmask_delete,
+    )
 }
 
 impl From<&wasmtime_component_vallist_t> for Vec<Val> {
@@ -66,8 +78,8 @@ impl From<&[Val]> for wasmtime_component_vallist_t {
 #[derive(Clone)]
 #[repr(C)]
 pub struct wasmtime_component_valrecord_entry_t {
-    name: wasm_name_t,
-    val: wasmtime_component_val_t,
+    pub(crate) name: wasm_name_t,
+    pub(crate) val: wasmtime_component_val_t,
 }
 
 impl Default for wasmtime_component_valrecord_entry_t {
@@ -151,11 +163,169 @@ impl From<&[String]> for wasmtime_component_valflags_t {
     }
 }
 
+/// A list of numbers stored contiguously, whose elements are all of the kind
+/// `kind`.
+///
+/// The elements are a boxed slice of the Rust type corresponding to `kind`,
+/// see `match_flat_kind!`, and `data` is null if there isn't one.
+#[repr(C)]
+pub struct wasmtime_component_valflatlist_t {
+    kind: u8,
+    size: usize,
+    data: *mut c_void,
+}
+
+/// Invokes the generic function `$f` instantiated with the element type of
+/// flat lists of `$kind`, whose values are the same as the discriminants of
+/// `wasmtime_component_val_t`.
+macro_rules! match_flat_kind {
+    ($kind:expr, $f:ident($($arg:expr),*)) => {
+        match $kind {
+            1 => $f::<i8>($($arg),*),
+            2 => $f::<u8>($($arg),*),
+            3 => $f::<i16>($($arg),*),
+            4 => $f::<u16>($($arg),*),
+            5 => $f::<i32>($($arg),*),
+            6 => $f::<u32>($($arg),*),
+            7 => $f::<i64>($($arg),*),
+            8 => $f::<u64>($($arg),*),
+            9 => $f::<f32>($($arg),*),
+            10 => $f::<f64>($($arg),*),
+            kind => panic!("invalid flat list element kind: {kind}"),
+        }
+    };
+}
+
+trait FlatElem: Copy + Default {
+    fn into_val(self) -> Val;
+}
+
+macro_rules! flat_elems {
+    ($($ty:ident => $val:ident,)*) => {$(
+        impl FlatElem for $ty {
+            fn into_val(self) -> Val {
+                Val::$val(self)
+            }
+        }
+    )*};
+}
+
+flat_elems! {
+    i8 => S8,
+    u8 => U8,
+    i16 => S16,
+    u16 => U16,
+    i32 => S32,
+    u32 => U32,
+    i64 => S64,
+    u64 => U64,
+    f32 => Float32,
+    f64 => Float64,
+}
+
+impl wasmtime_component_valflatlist_t {
+    /// Creates a flat list of `size` elements of `kind` copied from `data`,
+    /// or zeroed if `data` is null.
+    ///
+    /// # Safety
+    ///
+    /// If `data` isn't null it must point to `size` elements of `kind`.
+    unsafe fn new(kind: u8, size: usize, data: *const c_void) -> Self {
+        unsafe fn alloc<T: FlatElem>(size: usize, data: *const c_void) -> *mut c_void {
+            let elems: Box<[T]> = if data.is_null() {
+                vec![T::default(); size].into()
+            } else {
+                unsafe { slice::from_raw_parts(data.cast::<T>(), size).into() }
+            };
+            Box::into_raw(elems).cast()
+        }
+        let data = unsafe { match_flat_kind!(kind, alloc(size, data)) };
+        Self { kind, size, data }
+    }
+
+    pub(crate) fn to_vals(&self) -> Vec<Val> {
+        unsafe fn to_vals<T: FlatElem>(size: usize, data: *const c_void) -> Vec<Val> {
+            let elems = unsafe { slice::from_raw_parts(data.cast::<T>(), size) };
+            elems.iter().map(|x| x.into_val()).collect()
+        }
+        if self.data.is_null() {
+            return Vec::new();
+        }
+        unsafe { match_flat_kind!(self.kind, to_vals(self.size, self.data)) }
+    }
+
+    fn take(&mut self) {
+        unsafe fn free<T: FlatElem>(size: usize, data: *mut c_void) {
+            drop(unsafe { Box::from_raw(ptr::slice_from_raw_parts_mut(data.cast::<T>(), size)) });
+        }
+        if self.data.is_null() {
+            return;
+        }
+        unsafe { match_flat_kind!(self.kind, free(self.size, self.data)) }
+        self.size = 0;
+        self.data = ptr::null_mut();
+    }
+}
+
+impl Clone for wasmtime_component_valflatlist_t {
+    fn clone(&self) -> Self {
+        if self.data.is_null() {
+            return Self {
+                kind: self.kind,
+                size: 0,
+                data: ptr::null_mut(),
+            };
+        }
+        unsafe { Self::new(self.kind, self.size, self.data) }
+    }
+}
+
+impl Drop for wasmtime_component_valflatlist_t {
+    fn drop(&mut self) {
+        self.take();
+    }
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_component_valflatlist_new(
+    out: &mut MaybeUninit<wasmtime_component_valflatlist_t>,
+    kind: u8,
+    size: usize,
+    data: *const c_void,
+) {
+    let data = if size == 0 { ptr::null() } else { data };
+    out.write(unsafe { wasmtime_component_valflatlist_t::new(kind, size, data) });
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_valflatlist_new_uninit(
+    out: &mut MaybeUninit<wasmtime_component_valflatlist_t>,
+    kind: u8,
+    size: usize,
+) {
+    out.write(unsafe { wasmtime_component_valflatlist_t::new(kind, size, ptr::null()) });
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_valflatlist_copy(
+    dst: &mut MaybeUninit<wasmtime_component_valflatlist_t>,
+    src: &wasmtime_component_valflatlist_t,
+) {
+    dst.write(src.clone());
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_valflatlist_delete(
+    value: &mut wasmtime_component_valflatlist_t,
+) {
+    value.take();
+}
+
 #[repr(C)]
 #[derive(Clone)]
 pub struct wasmtime_component_valvariant_t {
-    discriminant: wasm_name_t,
-    val: Option<Box<wasmtime_component_val_t>>,
+    pub(crate) discriminant: wasm_name_t,
+    pub(crate) val: Option<Box<wasmtime_component_val_t>>,
 }
 
 impl From<(&String, &Option<Box<Val>>)> for wasmtime_component_valvariant_t {
@@ -178,11 +348,19 @@ impl From<&wasmtime_component_valvariant_t> for (String, Option<Box<Val>>) {
     }
 }
 
+/// A variant whose case is identified by its index in the variant's type.
+#[repr(C)]
+#[derive(Clone)]
+pub struct wasmtime_component_valvariantindex_t {
+    pub(crate) discriminant: u32,
+    pub(crate) val: Option<Box<wasmtime_component_val_t>>,
+}
+
 #[repr(C)]
 #[derive(Clone)]
 pub struct wasmtime_component_valresult_t {
-    is_ok: bool,
-    val: Option<Box<wasmtime_component_val_t>>,
+    pub(crate) is_ok: bool,
+    pub(crate) val: Option<Box<wasmtime_component_val_t>>,
 }
 
 impl From<&wasmtime_component_valresult_t> for Result<Option<Box<Val>>, Option<Box<Val>>> {
@@ -234,6 +412,11 @@ pub enum wasmtime_component_val_t {
     Result(wasmtime_component_valresult_t),
     Flags(wasmtime_component_valflags_t),
     Resource(Box<wasmtime_component_resource_any_t>),
+    FlatList(wasmtime_component_valflatlist_t),
+    FlagsMask(wasmtime_component_valflagsmask_t),
+    EnumIndex(u32),
+    VariantIndex(wasmtime_component_valvariantindex_t),
+    RecordValues(wasmtime_component_valtuple_t),
 }
 
 impl Default for wasmtime_component_val_t {
@@ -276,7 +459,189 @@ impl From<&wasmtime_component_val_t> for Val {
             wasmtime_component_val_t::Result(x) => Val::Result(x.into()),
             wasmtime_component_val_t::Flags(x) => Val::Flags(x.into()),
             wasmtime_component_val_t::Resource(x) => Val::Resource(x.resource),
+            wasmtime_component_val_t::FlatList(x) => Val::List(x.to_vals()),
+            wasmtime_component_val_t::FlagsMask(_)
+            | wasmtime_component_val_t::EnumIndex(_)
+            | wasmtime_component_val_t::VariantIndex(_)
+            | wasmtime_component_val_t::RecordValues(_) => {
+                panic!("indices of cases, flags and fields can only be resolved with a type")
+            }
+        }
+    }
+}
+
+impl wasmtime_component_val_t {
+    /// Returns whether this value, or a value within it, identifies a case,
+    /// flags or record fields by index, and so needs its type to be converted
+    /// to a `Val`.
+    pub(crate) fn needs_type(&self) -> bool {
+        use wasmtime_component_val_t as V;
+        match self {
+            V::FlagsMask(_) | V::EnumIndex(_) | V::VariantIndex(_) | V::RecordValues(_) => true,
+            V::List(x) | V::Tuple(x) => x.as_slice().iter().any(|x| x.needs_type()),
+            V::Record(x) => x.as_slice().iter().any(|x| x.val.needs_type()),
+            V::Variant(x) => x.val.as_ref().is_some_and(|x| x.needs_type()),
+            V::Option(x) => x.as_ref().is_some_and(|x| x.needs_type()),
+            V::Result(x) => x.val.as_ref().is_some_and(|x| x.needs_type()),
+            _ => false,
+        }
+    }
+
+    /// Converts this value, which is expected to have the type `ty`, to a
+    /// `Val`, looking up the names of cases, flags and fields given by index.
+    pub(crate) fn to_val(&self, ty: &Type) -> Result<Val> {
+        use wasmtime_component_val_t as V;
+        if !self.needs_type() {
+            return Ok(Val::from(self));
         }
+        Ok(match (ty, self) {
+            (Type::Flags(ty), V::FlagsMask(mask)) => {
+                let mask = mask.as_slice();
+                let is_set = |i: usize| mask.get(i / 32).is_some_and(|w| w & (1 << (i % 32)) != 0);
+                let count = ty.names().len();
+                if (count..mask.len() * 32).any(is_set) {
+                    bail!("flags mask sets a bit beyond the {count} flags of its type");
+                }
+                let names = ty.names().enumerate().filter(|(i, _)| is_set(*i));
+                Val::Flags(names.map(|(_, name)| name.to_string()).collect())
+            }
+            (Type::Enum(ty), V::EnumIndex(i)) => match ty.names().nth(*i as usize) {
+                Some(name) => Val::Enum(name.to_string()),
+                None => bail!("enum case index {i} is out of bounds"),
+            },
+            (Type::Variant(ty), V::VariantIndex(variant)) => {
+                let i = variant.discriminant;
+                let Some(case) = ty.cases().nth(i as usize) else {
+                    bail!("variant case index {i} is out of bounds");
+                };
+                let val = payload_to_val(case.ty.as_ref(), variant.val.as_deref())?;
+                Val::Variant(case.name.to_string(), val)
+            }
+            (Type::Variant(ty), V::Variant(variant)) => {
+                let name = variant.discriminant.as_slice();
+                let Some(case) = ty.cases().find(|case| case.name.as_bytes() == name) else {
+                    bail!("unknown variant case `{}`", String::from_utf8_lossy(name));
+                };
+                let val = payload_to_val(case.ty.as_ref(), variant.val.as_deref())?;
+                Val::Variant(case.name.to_string(), val)
+            }
+            (Type::List(ty), V::List(elems)) => {
+                let ty = ty.ty();
+                let elems = elems.as_slice().iter().map(|elem| elem.to_val(&ty));
+                Val::List(elems.collect::<Result<_>>()?)
+            }
+            (Type::Record(ty), V::Record(fields)) => {
+                let fields = fields.as_slice();
+                if ty.fields().len() != fields.len() {
+                    bail!(
+                        "expected {} record fields, found {}",
+                        ty.fields().len(),
+                        fields.len()
+                    );
+                }
+                let fields = ty.fields().zip(fields).map(|(field_ty, field)| {
+                    let name = String::from_utf8(field.name.as_slice().to_vec())?;
+                    Ok((name, field.val.to_val(&field_ty.ty)?))
+                });
+                Val::Record(fields.collect::<Result<_>>()?)
+            }
+            (Type::Record(ty), V::RecordValues(vals)) => {
+                let vals = vals.as_slice();
+                if ty.fields().len() != vals.len() {
+                    bail!(
+                        "expected {} record fields, found {}",
+                        ty.fields().len(),
+                        vals.len()
+                    );
+                }
+                let fields = ty.fields().zip(vals).map(|(field_ty, val)| {
+                    Ok((field_ty.name.to_string(), val.to_val(&field_ty.ty)?))
+                });
+                Val::Record(fields.collect::<Result<_>>()?)
+            }
+            (Type::Tuple(ty), V::Tuple(elems)) => {
+                let elems = elems.as_slice();
+                if ty.types().len() != elems.len() {
+                    bail!(
+                        "expected {} tuple elements, found {}",
+                        ty.types().len(),
+                        elems.len()
+                    );
+                }
+                let elems = ty.types().zip(elems).map(|(ty, elem)| elem.to_val(&ty));
+                Val::Tuple(elems.collect::<Result<_>>()?)
+            }
+            (Type::Option(ty), V::Option(val)) => {
+                let val = val.as_ref().map(|val| val.to_val(&ty.ty())).transpose()?;
+                Val::Option(val.map(Box::new))
+            }
+            (Type::Result(ty), V::Result(result)) => {
+                let payload_ty = if result.is_ok { ty.ok() } else { ty.err() };
+                let val = payload_to_val(payload_ty.as_ref(), result.val.as_deref())?;
+                Val::Result(if result.is_ok { Ok(val) } else { Err(val) })
+            }
+            _ => bail!("value doesn't match its expected type"),
+        })
+    }
+}
+
+/// Converts `c_vals`, which are expected to have the types returned by
+/// `types`, to `Val`s which are appended to `vals`.
+///
+/// The types are only computed if one of the values identifies a case,
+/// flags or record fields by index.
+pub(crate) fn extend_vals(
+    vals: &mut Vec<Val>,
+    c_vals: &[wasmtime_component_val_t],
+    types: impl FnOnce() -> Vec<Type>,
+) -> Result<()> {
+    if !c_vals.iter().any(|val| val.needs_type()) {
+        vals.extend(c_vals.iter().map(Val::from));
+        return Ok(());
+    }
+    let types = types();
+    if types.len() != c_vals.len() {
+        bail!("expected {} values, found {}", types.len(), c_vals.len());
+    }
+    for (c_val, ty) in c_vals.iter().zip(&types) {
+        vals.push(c_val.to_val(ty)?);
+    }
+    Ok(())
+}
+
+/// Like `extend_vals`, but moves `c_vals` into `vals`, which must have the
+/// same length.
+pub(crate) fn move_vals(
+    vals: &mut [Val],
+    c_vals: impl Iterator<Item = wasmtime_component_val_t>,
+    types: impl FnOnce() -> Vec<Type>,
+) -> Result<()> {
+    let mut types = Some(types);
+    let mut resolved = Vec::new();
+    for (i, (val, c_val)) in vals.iter_mut().zip(c_vals).enumerate() {
+        *val = if c_val.needs_type() {
+            if let Some(types) = types.take() {
+                resolved = types();
+            }
+            let Some(ty) = resolved.get(i) else {
+                bail!("expected {} values, found more", resolved.len());
+            };
+            c_val.to_val(ty)?
+        } else {
+            Val::from(c_val)
+        };
+    }
+    Ok(())
+}
+
+fn payload_to_val(
+    ty: Option<&Type>,
+    val: Option<&wasmtime_component_val_t>,
+) -> Result<Option<Box<Val>>> {
+    match (ty, val) {
+        (Some(ty), Some(val)) => Ok(Some(Box::new(val.to_val(ty)?))),
+        (_, None) => Ok(None),
+        (None, Some(_)) => bail!("unexpected payload"),
     }
 }
 
@@ -321,6 +686,65 @@ impl From<&Val> for wasmtime_component_val_t {
     }
 }
 
+/// Like `From<&wasmtime_component_val_t>`, but moves strings and the elements
+/// of lists, tuples and options rather than copying them.
+impl From<wasmtime_component_val_t> for Val {
+    fn from(value: wasmtime_component_val_t) -> Self {
+        match value {
+            wasmtime_component_val_t::String(mut x) => {
+                Val::String(String::from_utf8(x.take()).unwrap())
+            }
+            wasmtime_component_val_t::List(mut x) => {
+                Val::List(x.take().into_iter().map(Val::from).collect())
+            }
+            wasmtime_component_val_t::Tuple(mut x) => {
+                Val::Tuple(x.take().into_iter().map(Val::from).collect())
+            }
+            wasmtime_component_val_t::Option(x) => Val::Option(x.map(|x| Box::new(Val::from(*x)))),
+            other => Val::from(&other),
+        }
+    }
+}
+
+/// Like `From<&Val>`, but moves strings, names and the elements of lists,
+/// tuples, options and variants rather than copying them.
+impl From<Val> for wasmtime_component_val_t {
+    fn from(value: Val) -> Self {
+        match value {
+            Val::String(x) => wasmtime_component_val_t::String(wasm_name_t::from_name(x)),
+            Val::List(x) => wasmtime_component_val_t::List(
+                x.into_iter()
+                    .map(wasmtime_component_val_t::from)
+                    .collect::<Vec<_>>()
+                    .into(),
+            ),
+            Val::Tuple(x) => wasmtime_component_val_t::Tuple(
+                x.into_iter()
+                    .map(wasmtime_component_val_t::from)
+                    .collect::<Vec<_>>()
+                    .into(),
+            ),
+            Val::Option(x) => wasmtime_component_val_t::Option(
+                x.map(|x| Box::new(wasmtime_component_val_t::from(*x))),
+            ),
+            Val::Variant(discriminant, val) => {
+                wasmtime_component_val_t::Variant(wasmtime_component_valvariant_t {
+                    discriminant: wasm_name_t::from_name(discriminant),
+                    val: val.map(|x| Box::new(wasmtime_component_val_t::from(*x))),
+                })
+            }
+            Val::Enum(x) => wasmtime_component_val_t::Enum(wasm_name_t::from_name(x)),
+            Val::Flags(x) => wasmtime_component_val_t::Flags(
+                x.into_iter()
+                    .map(wasm_name_t::from_name)
+                    .collect::<Vec<_>>()
+                    .into(),
+            ),
+            other => wasmtime_component_val_t::from(&other),
+        }
+    }
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_component_val_new(
     src: &mut wasmtime_component_val_t,
@@ -387,6 +811,19 @@ pub extern "C" fn wasmtime_component_resource_any_drop(
     handle_result(resource.resource.resource_drop(store), |()| ())
 }
 
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_component_resource_any_drop_many(
+    mut store: WasmtimeStoreContextMut<'_>,
+    resources: *const &wasmtime_component_resource_any_t,
+    len: usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let resources = unsafe { crate::slice_from_raw_parts(resources, len) };
+    let result = resources
+        .iter()
+        .try_for_each(|r| r.resource.resource_drop(&mut store));
+    handle_result(result, |()| ())
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_component_resource_any_delete(
     _resource: Option<Box<wasmtime_component_resource_any_t>>,
@@ -489,3 +926,23 @@ pub extern "C" fn wasmtime_component_resource_host_to_any(
         },
     )
 }
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_component_resource_host_to_any_many(
+    mut store: WasmtimeStoreContextMut<'_>,
+    resources: *const &wasmtime_component_resource_host_t,
+    len: usize,
+    ret: *mut MaybeUninit<Box<wasmtime_component_resource_any_t>>,
+) -> Option<Box<wasmtime_error_t>> {
+    let resources = unsafe { crate::slice_from_raw_parts(resources, len) };
+    let result = resources
+        .iter()
+        .map(|r| r.resource().try_into_resource_any(&mut store))
+        .collect::<wasmtime::Result<Vec<_>>>();
+    handle_result(result, |anys| {
+        let ret = unsafe { crate::slice_from_raw_parts_mut(ret, len) };
+        for (dst, resource) in std::iter::zip(ret, anys) {
+            dst.write(Box::new(wasmtime_component_resource_any_t { resource }));
+        }
+    })
+}
@@ -7,8 +7,8 @@ use std::os::raw::c_char;
 use std::ptr;
 use std::{ffi::CStr, sync::Arc};
 use wasmtime::{
-    Config, InstanceAllocationStrategy, LinearMemory, MemoryCreator, OptLevel, ProfilingStrategy,
-    Result, Strategy,
+    Collector, Config, Enabled, FuelMetering, InstanceAllocationStrategy, LinearMemory,
+    MemoryCreator, OptLevel, ProfilingStrategy, Result, Strategy,
 };
 
 #[cfg(feature = "pooling-allocator")]
@@ -46,6 +46,39 @@ pub enum wasmtime_profiling_strategy_t {
     WASMTIME_PROFILING_STRATEGY_PERFMAP,
 }
 
+#[repr(u8)]
+#[derive(Clone)]
+pub enum wasmtime_enabled_t {
+    WASMTIME_ENABLED_AUTO,
+    WASMTIME_ENABLED_YES,
+    WASMTIME_ENABLED_NO,
+}
+
+#[repr(u8)]
+#[derive(Clone)]
+pub enum wasmtime_fuel_metering_t {
+    WASMTIME_FUEL_METERING_PER_BLOCK,
+    WASMTIME_FUEL_METERING_PER_LOOP,
+}
+
+#[repr(u8)]
+#[derive(Clone)]
+pub enum wasmtime_collector_t {
+    WASMTIME_COLLECTOR_AUTO,
+    WASMTIME_COLLECTOR_DEFERRED_REFERENCE_COUNTING,
+    WASMTIME_COLLECTOR_NULL,
+}
+
+impl From<wasmtime_enabled_t> for Enabled {
+    fn from(enabled: wasmtime_enabled_t) -> Enabled {
+        match enabled {
+            wasmtime_enabled_t::WASMTIME_ENABLED_AUTO => Enabled::Auto,
+            wasmtime_enabled_t::WASMTIME_ENABLED_YES => Enabled::Yes,
+            wasmtime_enabled_t::WASMTIME_ENABLED_NO => Enabled::No,
+        }
+    }
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasm_config_new() -> Box<wasm_config_t> {
     Box::new(wasm_config_t {
@@ -63,6 +96,23 @@ pub extern "C" fn wasmtime_config_consume_fuel_set(c: &mut wasm_config_t, enable
     c.config.consume_fuel(enable);
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_config_count_function_calls_set(c: &mut wasm_config_t, enable: bool) {
+    c.config.count_function_calls(enable);
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_config_fuel_metering_set(
+    c: &mut wasm_config_t,
+    metering: wasmtime_fuel_metering_t,
+) {
+    use wasmtime_fuel_metering_t::*;
+    c.config.fuel_metering(match metering {
+        WASMTIME_FUEL_METERING_PER_BLOCK => FuelMetering::PerBlock,
+        WASMTIME_FUEL_METERING_PER_LOOP => FuelMetering::PerLoop,
+    });
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_config_epoch_interruption_set(c: &mut wasm_config_t, enable: bool) {
     c.config.epoch_interruption(enable);
@@ -79,6 +129,12 @@ pub extern "C" fn wasmtime_config_wasm_threads_set(c: &mut wasm_config_t, enable
     c.config.wasm_threads(enable);
 }
 
+#[unsafe(no_mangle)]
+#[cfg(feature = "coredump")]
+pub extern "C" fn wasmtime_config_coredump_on_trap_set(c: &mut wasm_config_t, enable: bool) {
+    c.config.coredump_on_trap(enable);
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_config_shared_memory_set(c: &mut wasm_config_t, enable: bool) {
     c.config.shared_memory(enable);
@@ -107,6 +163,24 @@ pub extern "C" fn wasmtime_config_wasm_gc_set(c: &mut wasm_config_t, enable: boo
     c.config.wasm_gc(enable);
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_config_collector_set(
+    c: &mut wasm_config_t,
+    collector: wasmtime_collector_t,
+) {
+    use wasmtime_collector_t::*;
+    c.config.collector(match collector {
+        WASMTIME_COLLECTOR_AUTO => Collector::Auto,
+        WASMTIME_COLLECTOR_DEFERRED_REFERENCE_COUNTING => Collector::DeferredReferenceCounting,
+        WASMTIME_COLLECTOR_NULL => Collector::Null,
+    });
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_config_gc_heap_growth_factor_set(c: &mut wasm_config_t, factor: f64) {
+    c.config.gc_heap_growth_factor(factor);
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_config_wasm_simd_set(c: &mut wasm_config_t, enable: bool) {
     c.config.wasm_simd(enable);
@@ -150,6 +224,24 @@ pub extern "C" fn wasmtime_config_wasm_stack_switching_set(c: &mut wasm_config_t
     c.config.wasm_stack_switching(enable);
 }
 
+#[unsafe(no_mangle)]
+#[cfg(feature = "stack-switching")]
+pub extern "C" fn wasmtime_config_continuation_stack_cache_size_set(
+    c: &mut wasm_config_t,
+    size: usize,
+) {
+    c.config.continuation_stack_cache_size(size);
+}
+
+#[unsafe(no_mangle)]
+#[cfg(feature = "stack-switching")]
+pub extern "C" fn wasmtime_config_continuation_stack_keep_resident_set(
+    c: &mut wasm_config_t,
+    size: usize,
+) {
+    c.config.continuation_stack_keep_resident(size);
+}
+
 #[unsafe(no_mangle)]
 #[cfg(any(feature = "cranelift", feature = "winch"))]
 pub extern "C" fn wasmtime_config_strategy_set(
@@ -169,6 +261,30 @@ pub extern "C" fn wasmtime_config_parallel_compilation_set(c: &mut wasm_config_t
     c.config.parallel_compilation(enable);
 }
 
+#[unsafe(no_mangle)]
+#[cfg(feature = "parallel-compilation")]
+pub extern "C" fn wasmtime_config_compilation_threads_set(c: &mut wasm_config_t, threads: usize) {
+    c.config.compilation_threads(threads);
+}
+
+#[unsafe(no_mangle)]
+#[cfg(feature = "parallel-compilation")]
+pub extern "C" fn wasmtime_config_compilation_thread_start_set(
+    c: &mut wasm_config_t,
+    callback: extern "C" fn(*mut std::ffi::c_void, usize),
+    env: *mut std::ffi::c_void,
+    finalizer: Option<extern "C" fn(*mut std::ffi::c_void)>,
+) {
+    let foreign = crate::ForeignData {
+        data: env,
+        finalizer,
+    };
+    c.config.compilation_thread_start_handler(move |index| {
+        let foreign = &foreign;
+        callback(foreign.data, index);
+    });
+}
+
 #[unsafe(no_mangle)]
 #[cfg(any(feature = "cranelift", feature = "winch"))]
 pub extern "C" fn wasmtime_config_cranelift_debug_verifier_set(
@@ -201,6 +317,19 @@ pub extern "C" fn wasmtime_config_cranelift_opt_level_set(
     });
 }
 
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_config_compile_deadline_set(c: &mut wasm_config_t, nanos: u64) {
+    c.config
+        .compile_deadline(std::time::Duration::from_nanos(nanos));
+}
+
+#[unsafe(no_mangle)]
+#[cfg(feature = "cranelift")]
+pub extern "C" fn wasmtime_config_tiered_compilation_set(c: &mut wasm_config_t, enable: bool) {
+    c.config.tiered_compilation(enable);
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_config_profiler_set(
     c: &mut wasm_config_t,
@@ -215,6 +344,85 @@ pub extern "C" fn wasmtime_config_profiler_set(
     });
 }
 
+/// Looks up `key` in an embedder's incremental compilation cache, filling in
+/// `value` and returning `true` on a hit.
+#[cfg(all(feature = "incremental-cache", feature = "cranelift"))]
+pub type wasmtime_incremental_cache_get_callback_t = extern "C" fn(
+    env: *mut std::ffi::c_void,
+    key: *const u8,
+    key_len: usize,
+    value: &mut crate::wasm_byte_vec_t,
+) -> bool;
+
+/// Stores `value` under `key` in an embedder's incremental compilation cache.
+#[cfg(all(feature = "incremental-cache", feature = "cranelift"))]
+pub type wasmtime_incremental_cache_insert_callback_t = extern "C" fn(
+    env: *mut std::ffi::c_void,
+    key: *const u8,
+    key_len: usize,
+    value: *const u8,
+    value_len: usize,
+) -> bool;
+
+#[cfg(all(feature = "incremental-cache", feature = "cranelift"))]
+struct CIncrementalCache {
+    get: wasmtime_incremental_cache_get_callback_t,
+    insert: wasmtime_incremental_cache_insert_callback_t,
+    foreign: crate::ForeignData,
+}
+
+#[cfg(all(feature = "incremental-cache", feature = "cranelift"))]
+impl std::fmt::Debug for CIncrementalCache {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("CIncrementalCache").finish_non_exhaustive()
+    }
+}
+
+#[cfg(all(feature = "incremental-cache", feature = "cranelift"))]
+impl wasmtime::CacheStore for CIncrementalCache {
+    fn get(&self, key: &[u8]) -> Option<std::borrow::Cow<'_, [u8]>> {
+        let mut value = crate::wasm_byte_vec_t::default();
+        if (self.get)(self.foreign.data, key.as_ptr(), key.len(), &mut value) {
+            Some(value.take().into())
+        } else {
+            None
+        }
+    }
+
+    fn insert(&self, key: &[u8], value: Vec<u8>) -> bool {
+        (self.insert)(
+            self.foreign.data,
+            key.as_ptr(),
+            key.len(),
+            value.as_ptr(),
+            value.len(),
+        )
+    }
+}
+
+#[unsafe(no_mangle)]
+#[cfg(all(feature = "incremental-cache", feature = "cranelift"))]
+pub extern "C" fn wasmtime_config_incremental_cache_set(
+    c: &mut wasm_config_t,
+    get: wasmtime_incremental_cache_get_callback_t,
+    insert: wasmtime_incremental_cache_insert_callback_t,
+    env: *mut std::ffi::c_void,
+    finalizer: Option<extern "C" fn(*mut std::ffi::c_void)>,
+) -> Option<Box<wasmtime_error_t>> {
+    let store = CIncrementalCache {
+        get,
+        insert,
+        foreign: crate::ForeignData {
+            data: env,
+            finalizer,
+        },
+    };
+    handle_result(
+        c.config.enable_incremental_compilation(Arc::new(store)),
+        |_cfg| {},
+    )
+}
+
 #[unsafe(no_mangle)]
 #[cfg(feature = "cache")]
 pub unsafe extern "C" fn wasmtime_config_cache_config_load(
@@ -263,6 +471,32 @@ pub extern "C" fn wasmtime_config_memory_reservation_for_growth_set(
     c.config.memory_reservation_for_growth(size);
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_config_memory_populate_set(c: &mut wasm_config_t, enable: bool) {
+    c.config.memory_populate(enable);
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_config_memory_huge_pages_set(
+    c: &mut wasm_config_t,
+    enable: wasmtime_enabled_t,
+) {
+    c.config.memory_huge_pages(enable.into());
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_config_memory_access_sampling_set(c: &mut wasm_config_t, interval: u32) {
+    c.config.memory_access_sampling(interval);
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_config_code_huge_pages_set(
+    c: &mut wasm_config_t,
+    enable: wasmtime_enabled_t,
+) {
+    c.config.code_huge_pages(enable.into());
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_config_native_unwind_info_set(c: &mut wasm_config_t, enabled: bool) {
     c.config.native_unwind_info(enabled);
@@ -336,6 +570,9 @@ pub type wasmtime_new_memory_callback_t = extern "C" fn(
     memory_ret: *mut wasmtime_linear_memory_t,
 ) -> Option<Box<wasmtime_error_t>>;
 
+pub type wasmtime_reuse_memory_callback_t =
+    extern "C" fn(env: *mut std::ffi::c_void, memory: &mut wasmtime_linear_memory_t);
+
 struct CHostLinearMemory {
     foreign: crate::ForeignData,
     get_memory: wasmtime_memory_get_callback_t,
@@ -379,11 +616,13 @@ pub struct wasmtime_memory_creator_t {
     env: *mut std::ffi::c_void,
     new_memory: wasmtime_new_memory_callback_t,
     finalizer: Option<extern "C" fn(arg1: *mut std::ffi::c_void)>,
+    reuse_memory: Option<wasmtime_reuse_memory_callback_t>,
 }
 
 struct CHostMemoryCreator {
     foreign: crate::ForeignData,
     new_memory: wasmtime_new_memory_callback_t,
+    reuse_memory: Option<wasmtime_reuse_memory_callback_t>,
 }
 unsafe impl Send for CHostMemoryCreator {}
 unsafe impl Sync for CHostMemoryCreator {}
@@ -444,6 +683,25 @@ unsafe impl MemoryCreator for CHostMemoryCreator {
             }
         }
     }
+
+    fn reuse_memory(&self, memory: Box<dyn wasmtime::LinearMemory>) {
+        let Some(cb) = self.reuse_memory else {
+            return;
+        };
+        let memory: Box<dyn std::any::Any> = memory;
+        let mut memory = memory
+            .downcast::<CHostLinearMemory>()
+            .expect("only creates `CHostLinearMemory`");
+        // Ownership of the memory's data, and the responsibility to finalize
+        // it, are handed to the callback.
+        let mut memory = wasmtime_linear_memory_t {
+            env: memory.foreign.data,
+            get_memory: memory.get_memory,
+            grow_memory: memory.grow_memory,
+            finalizer: memory.foreign.finalizer.take(),
+        };
+        cb(self.foreign.data, &mut memory);
+    }
 }
 
 #[unsafe(no_mangle)]
@@ -457,6 +715,7 @@ pub unsafe extern "C" fn wasmtime_config_host_memory_creator_set(
             finalizer: creator.finalizer,
         },
         new_memory: creator.new_memory,
+        reuse_memory: creator.reuse_memory,
     }));
 }
 
@@ -521,6 +780,49 @@ pub extern "C" fn wasmtime_pooling_allocation_config_decommit_batch_size_set(
     c.config.decommit_batch_size(batch_size);
 }
 
+#[unsafe(no_mangle)]
+#[cfg(feature = "pooling-allocator")]
+pub extern "C" fn wasmtime_pooling_allocation_config_background_decommit_set(
+    c: &mut wasmtime_pooling_allocation_config_t,
+    enable: bool,
+) {
+    c.config.background_decommit(enable);
+}
+
+#[unsafe(no_mangle)]
+#[cfg(feature = "pooling-allocator")]
+pub extern "C" fn wasmtime_pooling_allocation_config_numa_local_memory_set(
+    c: &mut wasmtime_pooling_allocation_config_t,
+    enable: bool,
+) {
+    c.config.numa_local_memory(enable);
+}
+
+#[unsafe(no_mangle)]
+#[cfg(feature = "pooling-allocator")]
+pub extern "C" fn wasmtime_pooling_allocation_config_memory_protection_keys_set(
+    c: &mut wasmtime_pooling_allocation_config_t,
+    enable: wasmtime_enabled_t,
+) {
+    c.config.memory_protection_keys(enable.into());
+}
+
+#[unsafe(no_mangle)]
+#[cfg(feature = "pooling-allocator")]
+pub extern "C" fn wasmtime_pooling_allocation_config_max_memory_protection_keys_set(
+    c: &mut wasmtime_pooling_allocation_config_t,
+    max: usize,
+) {
+    c.config.max_memory_protection_keys(max);
+}
+
+#[unsafe(no_mangle)]
+#[cfg(feature = "pooling-allocator")]
+pub extern "C" fn wasmtime_pooling_allocation_config_are_memory_protection_keys_available() -> bool
+{
+    PoolingAllocationConfig::are_memory_protection_keys_available()
+}
+
 #[unsafe(no_mangle)]
 #[cfg(all(feature = "pooling-allocator", feature = "async"))]
 pub extern "C" fn wasmtime_pooling_allocation_config_async_stack_keep_resident_set(
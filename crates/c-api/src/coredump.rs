@@ -0,0 +1,82 @@
+use crate::{WasmtimeStoreContextMut, wasm_byte_vec_t, wasm_trap_t, wasmtime_error_t};
+use wasmtime::{CoreDumpMemory, Error, WasmCoreDump};
+
+#[repr(u8)]
+#[derive(Clone)]
+pub enum wasmtime_coredump_memory_t {
+    WASMTIME_COREDUMP_MEMORY_ALL,
+    WASMTIME_COREDUMP_MEMORY_NONE,
+    WASMTIME_COREDUMP_MEMORY_RANGES,
+}
+
+#[repr(C)]
+pub struct wasmtime_coredump_range_t {
+    memory: usize,
+    offset: usize,
+    len: usize,
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_trap_coredump(
+    trap: &wasm_trap_t,
+    store: WasmtimeStoreContextMut<'_>,
+    name: *const u8,
+    name_len: usize,
+    memory: wasmtime_coredump_memory_t,
+    ranges: *const wasmtime_coredump_range_t,
+    nranges: usize,
+    out: &mut wasm_byte_vec_t,
+) -> bool {
+    let name = unsafe { crate::slice_from_raw_parts(name, name_len) };
+    let memory = unsafe { memory_selection(memory, ranges, nranges) };
+    serialize(&trap.error, store, name, &memory, out)
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_error_coredump(
+    error: &wasmtime_error_t,
+    store: WasmtimeStoreContextMut<'_>,
+    name: *const u8,
+    name_len: usize,
+    memory: wasmtime_coredump_memory_t,
+    ranges: *const wasmtime_coredump_range_t,
+    nranges: usize,
+    out: &mut wasm_byte_vec_t,
+) -> bool {
+    let name = unsafe { crate::slice_from_raw_parts(name, name_len) };
+    let memory = unsafe { memory_selection(memory, ranges, nranges) };
+    serialize(&error.error, store, name, &memory, out)
+}
+
+unsafe fn memory_selection(
+    memory: wasmtime_coredump_memory_t,
+    ranges: *const wasmtime_coredump_range_t,
+    nranges: usize,
+) -> CoreDumpMemory {
+    use wasmtime_coredump_memory_t::*;
+    match memory {
+        WASMTIME_COREDUMP_MEMORY_ALL => CoreDumpMemory::All,
+        WASMTIME_COREDUMP_MEMORY_NONE => CoreDumpMemory::None,
+        WASMTIME_COREDUMP_MEMORY_RANGES => CoreDumpMemory::Ranges(
+            unsafe { crate::slice_from_raw_parts(ranges, nranges) }
+                .iter()
+                .map(|r| (r.memory, r.offset..r.offset.saturating_add(r.len)))
+                .collect(),
+        ),
+    }
+}
+
+fn serialize(
+    error: &Error,
+    store: WasmtimeStoreContextMut<'_>,
+    name: &[u8],
+    memory: &CoreDumpMemory,
+    out: &mut wasm_byte_vec_t,
+) -> bool {
+    let Some(coredump) = error.downcast_ref::<WasmCoreDump>() else {
+        return false;
+    };
+    let name = String::from_utf8_lossy(name);
+    out.set_buffer(coredump.serialize_with(store, &name, memory));
+    true
+}
@@ -1,4 +1,4 @@
-use crate::wasm_config_t;
+use crate::{wasm_config_t, wasmtime_error_t};
 use wasmtime::Engine;
 
 #[repr(C)]
@@ -48,7 +48,180 @@ pub extern "C" fn wasmtime_engine_increment_epoch(engine: &wasm_engine_t) {
     engine.engine.increment_epoch();
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_engine_prepare_fork(
+    engine: &wasm_engine_t,
+) -> Option<Box<wasmtime_error_t>> {
+    #[cfg(unix)]
+    return crate::handle_result(engine.engine.prepare_fork(), |()| {});
+    #[cfg(not(unix))]
+    {
+        let _ = engine;
+        Some(Box::new(
+            wasmtime::format_err!("fork is not supported on this platform").into(),
+        ))
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_engine_after_fork_parent(engine: &wasm_engine_t) {
+    #[cfg(unix)]
+    engine.engine.after_fork_parent();
+    #[cfg(not(unix))]
+    let _ = engine;
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_engine_after_fork_child(
+    engine: &wasm_engine_t,
+) -> Option<Box<wasmtime_error_t>> {
+    #[cfg(unix)]
+    return crate::handle_result(engine.engine.after_fork_child(), |()| {});
+    #[cfg(not(unix))]
+    {
+        let _ = engine;
+        Some(Box::new(
+            wasmtime::format_err!("fork is not supported on this platform").into(),
+        ))
+    }
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_engine_is_pulley(engine: &wasm_engine_t) -> bool {
     engine.engine.is_pulley()
 }
+
+#[repr(C)]
+pub struct wasmtime_engine_stats_t {
+    pub code_objects: u64,
+    pub code_bytes: u64,
+    pub text_bytes: u64,
+    pub trampolines: u64,
+    pub types: u64,
+    pub rec_groups: u64,
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_engine_stats(engine: &wasm_engine_t, out: &mut wasmtime_engine_stats_t) {
+    let stats = engine.engine.stats();
+    *out = wasmtime_engine_stats_t {
+        code_objects: stats.code_objects() as u64,
+        code_bytes: stats.code_bytes() as u64,
+        text_bytes: stats.text_bytes() as u64,
+        trampolines: stats.trampolines() as u64,
+        types: stats.types() as u64,
+        rec_groups: stats.rec_groups() as u64,
+    };
+}
+
+#[cfg(feature = "pooling-allocator")]
+#[repr(C)]
+pub struct wasmtime_pooling_stats_t {
+    pub core_instances: u64,
+    pub component_instances: u64,
+    pub memories: u64,
+    pub unused_warm_memories: u64,
+    pub unused_cold_memories: u64,
+    pub unused_memory_bytes_resident: u64,
+    pub tables: u64,
+    pub unused_warm_tables: u64,
+    pub unused_cold_tables: u64,
+    pub unused_table_bytes_resident: u64,
+    pub stacks: u64,
+    pub unused_warm_stacks: u64,
+    pub unused_cold_stacks: u64,
+    pub decommit_queue_len: u64,
+    pub memory_affinity_hits: u64,
+    pub memory_affinity_misses: u64,
+    pub unused_stack_bytes_resident: u64,
+}
+
+#[cfg(feature = "pooling-allocator")]
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_engine_pooling_stats(
+    engine: &wasm_engine_t,
+    stats: &mut wasmtime_pooling_stats_t,
+) -> bool {
+    let Some(metrics) = engine.engine.pooling_allocator_metrics() else {
+        return false;
+    };
+    *stats = wasmtime_pooling_stats_t {
+        core_instances: metrics.core_instances(),
+        component_instances: metrics.component_instances(),
+        memories: metrics.memories() as u64,
+        unused_warm_memories: metrics.unused_warm_memories().into(),
+        unused_cold_memories: metrics.unused_cold_memories().into(),
+        unused_memory_bytes_resident: metrics.unused_memory_bytes_resident() as u64,
+        tables: metrics.tables() as u64,
+        unused_warm_tables: metrics.unused_warm_tables().into(),
+        unused_cold_tables: metrics.unused_cold_tables().into(),
+        unused_table_bytes_resident: metrics.unused_table_bytes_resident() as u64,
+        #[cfg(feature = "async")]
+        stacks: metrics.stacks() as u64,
+        #[cfg(feature = "async")]
+        unused_warm_stacks: metrics.unused_warm_stacks().into(),
+        #[cfg(feature = "async")]
+        unused_cold_stacks: metrics.unused_cold_stacks().into(),
+        #[cfg(not(feature = "async"))]
+        stacks: 0,
+        #[cfg(not(feature = "async"))]
+        unused_warm_stacks: 0,
+        #[cfg(not(feature = "async"))]
+        unused_cold_stacks: 0,
+        decommit_queue_len: metrics.decommit_queue_len() as u64,
+        memory_affinity_hits: metrics.memory_affinity_hits(),
+        memory_affinity_misses: metrics.memory_affinity_misses(),
+        #[cfg(feature = "async")]
+        unused_stack_bytes_resident: metrics.unused_stack_bytes_resident().unwrap_or(0) as u64,
+        #[cfg(not(feature = "async"))]
+        unused_stack_bytes_resident: 0,
+    };
+    true
+}
+
+#[cfg(feature = "async")]
+#[repr(C)]
+pub struct wasmtime_async_stack_cache_stats_t {
+    pub cached_stacks: u64,
+    pub hits: u64,
+    pub misses: u64,
+}
+
+#[cfg(feature = "async")]
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_engine_async_stack_cache_stats(
+    engine: &wasm_engine_t,
+    stats: &mut wasmtime_async_stack_cache_stats_t,
+) -> bool {
+    let Some(cache) = engine.engine.async_stack_cache_stats() else {
+        return false;
+    };
+    *stats = wasmtime_async_stack_cache_stats_t {
+        cached_stacks: cache.cached_stacks() as u64,
+        hits: cache.hits(),
+        misses: cache.misses(),
+    };
+    true
+}
+
+#[cfg(feature = "stack-switching")]
+#[repr(C)]
+pub struct wasmtime_continuation_stack_cache_stats_t {
+    pub cached_stacks: u64,
+    pub hits: u64,
+    pub misses: u64,
+}
+
+#[cfg(feature = "stack-switching")]
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_engine_continuation_stack_cache_stats(
+    engine: &wasm_engine_t,
+    stats: &mut wasmtime_continuation_stack_cache_stats_t,
+) {
+    let cache = engine.engine.continuation_stack_cache_stats();
+    *stats = wasmtime_continuation_stack_cache_stats_t {
+        cached_stacks: cache.cached_stacks() as u64,
+        hits: cache.hits(),
+        misses: cache.misses(),
+    };
+}
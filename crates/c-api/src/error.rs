@@ -3,7 +3,7 @@ use wasmtime::{Error, Result, format_err};
 
 #[repr(C)]
 pub struct wasmtime_error_t {
-    error: Error,
+    pub(crate) error: Error,
 }
 
 wasmtime_c_api_macros::declare_own!(wasmtime_error_t);
@@ -53,6 +53,11 @@ pub extern "C" fn wasmtime_error_message(error: &wasmtime_error_t, message: &mut
     message.set_buffer(format!("{:?}", error.error).into_bytes());
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_error_static_code(raw: &wasmtime_error_t, code: &mut i32) -> bool {
+    crate::trap::static_code(&raw.error, code)
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_error_exit_status(raw: &wasmtime_error_t, status: &mut i32) -> bool {
     #[cfg(feature = "wasi")]
@@ -67,6 +72,17 @@ pub extern "C" fn wasmtime_error_exit_status(raw: &wasmtime_error_t, status: &mu
     false
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_error_is_compile_deadline_exceeded(raw: &wasmtime_error_t) -> bool {
+    #[cfg(any(feature = "cranelift", feature = "winch"))]
+    if raw.error.is::<wasmtime::CompileDeadlineExceeded>() {
+        return true;
+    }
+
+    let _ = raw;
+    false
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_error_wasm_trace<'a>(
     raw: &'a wasmtime_error_t,
@@ -11,8 +11,8 @@ use std::panic::{self, AssertUnwindSafe};
 use std::ptr;
 use std::str;
 use wasmtime::{
-    AsContext, AsContextMut, Error, Extern, Func, Result, RootScope, StoreContext, StoreContextMut,
-    Trap, Val, ValRaw,
+    AsContext, AsContextMut, Error, Extern, Func, Memory, Result, RootScope, StoreContext,
+    StoreContextMut, Trap, Val, ValRaw,
 };
 
 #[derive(Clone)]
@@ -257,8 +257,23 @@ pub(crate) unsafe fn c_callback_to_rust_fn(
     finalizer: Option<extern "C" fn(*mut std::ffi::c_void)>,
 ) -> impl Fn(WasmtimeCaller<'_>, &[Val], &mut [Val]) -> Result<()> {
     let foreign = crate::ForeignData { data, finalizer };
+    c_callback_with_owner_to_rust_fn(callback, data, foreign)
+}
+
+/// Same as `c_callback_to_rust_fn`, except that instead of a finalizer for
+/// `data` the returned closure keeps `owner` alive, which may be shared with
+/// other closures.
+pub(crate) unsafe fn c_callback_with_owner_to_rust_fn(
+    callback: wasmtime_func_callback_t,
+    data: *mut c_void,
+    owner: impl Send + Sync + 'static,
+) -> impl Fn(WasmtimeCaller<'_>, &[Val], &mut [Val]) -> Result<()> {
+    let foreign = crate::ForeignData {
+        data,
+        finalizer: None,
+    };
     move |mut caller, params, results| {
-        let _ = &foreign; // move entire foreign into this closure
+        let _ = (&foreign, &owner); // move both entirely into this closure
 
         // Convert `params/results` to `wasmtime_val_t`. Use the previous
         // storage in `hostcall_val_storage` to help avoid allocations all the
@@ -278,7 +293,10 @@ pub(crate) unsafe fn c_callback_to_rust_fn(
         }));
         let (params, out_results) = vals.split_at_mut(params.len());
 
-        // Invoke the C function pointer, getting the results.
+        // Invoke the C function pointer, getting the results. Root scopes
+        // entered by the embedder outside of this call don't apply within it,
+        // as anything rooted here is unrooted once this call returns.
+        let root_scopes = mem::take(&mut caller.data_mut().root_scopes);
         let mut caller = wasmtime_caller_t { caller };
         let out = callback(
             foreign.data,
@@ -288,6 +306,7 @@ pub(crate) unsafe fn c_callback_to_rust_fn(
             out_results.as_mut_ptr(),
             out_results.len(),
         );
+        caller.caller.data_mut().root_scopes = root_scopes;
         if let Some(trap) = out {
             return Err(trap.error);
         }
@@ -329,12 +348,16 @@ pub(crate) unsafe fn c_unchecked_callback_to_rust_fn(
     move |caller, values| {
         let _ = &foreign; // move entire foreign into this closure
         let mut caller = wasmtime_caller_t { caller };
-        match callback(
+        // See `c_callback_to_rust_fn` for why root scopes are reset.
+        let root_scopes = mem::take(&mut caller.caller.data_mut().root_scopes);
+        let out = callback(
             foreign.data,
             &mut caller,
             values.as_mut_ptr().cast(),
             values.len(),
-        ) {
+        );
+        caller.caller.data_mut().root_scopes = root_scopes;
+        match out {
             None => Ok(()),
             Some(trap) => Err(trap.error),
         }
@@ -402,6 +425,52 @@ pub unsafe extern "C" fn wasmtime_func_call_unchecked(
     }
 }
 
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_func_call_unchecked_many(
+    mut store: WasmtimeStoreContextMut<'_>,
+    func: &Func,
+    args_and_results: *mut ValRaw,
+    args_and_results_len: usize,
+    ncalls: usize,
+    ncompleted: &mut usize,
+    trap_ret: &mut *mut wasm_trap_t,
+) -> Option<Box<wasmtime_error_t>> {
+    for i in 0..ncalls {
+        *ncompleted = i;
+        let chunk = args_and_results.wrapping_add(i * args_and_results_len);
+        let slice = std::ptr::slice_from_raw_parts_mut(chunk, args_and_results_len);
+        if let Err(trap) = func.call_unchecked(&mut store, slice) {
+            return store_err(trap, trap_ret);
+        }
+    }
+    *ncompleted = ncalls;
+    None
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_func_call_unchecked_trap_code(
+    store: WasmtimeStoreContextMut<'_>,
+    func: &Func,
+    args_and_results: *mut ValRaw,
+    args_and_results_len: usize,
+    trapped: &mut bool,
+    trap_code: &mut u8,
+) -> Option<Box<wasmtime_error_t>> {
+    let slice = std::ptr::slice_from_raw_parts_mut(args_and_results, args_and_results_len);
+    *trapped = false;
+    match func.call_unchecked(store, slice) {
+        Ok(()) => None,
+        Err(err) => match err.downcast_ref::<Trap>() {
+            Some(trap) => {
+                *trapped = true;
+                *trap_code = *trap as u8;
+                None
+            }
+            None => Some(Box::new(wasmtime_error_t::from(err))),
+        },
+    }
+}
+
 fn store_err(err: Error, trap_ret: &mut *mut wasm_trap_t) -> Option<Box<wasmtime_error_t>> {
     if err.is::<Trap>() {
         *trap_ret = Box::into_raw(Box::new(wasm_trap_t::new(err)));
@@ -419,6 +488,11 @@ pub extern "C" fn wasmtime_func_type(
     Box::new(wasm_functype_t::new(func.ty(store)))
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_func_type_index(store: WasmtimeStoreContext<'_>, func: &Func) -> u64 {
+    func.ty_index(store)
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_caller_context<'a>(
     caller: &'a mut wasmtime_caller_t,
@@ -445,6 +519,37 @@ pub unsafe extern "C" fn wasmtime_caller_export_get(
     true
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_caller_memory(
+    caller: &mut wasmtime_caller_t,
+    index: u32,
+    memory: &mut MaybeUninit<Memory>,
+) -> bool {
+    match caller.caller.memory(index) {
+        Some(m) => {
+            crate::initialize(memory, m);
+            true
+        }
+        None => false,
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_caller_memory_data(
+    caller: &mut wasmtime_caller_t,
+    data: &mut *mut u8,
+    data_size: &mut usize,
+) -> bool {
+    match caller.caller.memory_and_data_mut() {
+        Some((memory, _)) => {
+            *data = memory.as_mut_ptr();
+            *data_size = memory.len();
+            true
+        }
+        None => false,
+    }
+}
+
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn wasmtime_func_from_raw(
     store: WasmtimeStoreContextMut<'_>,
@@ -3,7 +3,7 @@ use crate::{
     wasm_store_t, wasm_val_t, wasmtime_error_t, wasmtime_val_t,
 };
 use std::mem::MaybeUninit;
-use wasmtime::{Extern, Global, RootScope};
+use wasmtime::{Extern, Global, RootScope, Val, ValRaw};
 
 #[derive(Clone)]
 #[repr(transparent)]
@@ -121,3 +121,29 @@ pub unsafe extern "C" fn wasmtime_global_set(
     let val = val.to_val(&mut scope);
     handle_result(global.set(scope, val), |()| {})
 }
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_global_get_raw(
+    store: WasmtimeStoreContextMut<'_>,
+    global: &Global,
+    val: &mut MaybeUninit<ValRaw>,
+) {
+    let mut scope = RootScope::new(store);
+    let gval = global.get(&mut scope);
+    // The value was just read from a global of this store, so it can always
+    // be converted.
+    let raw = gval.to_raw(&mut scope).unwrap();
+    crate::initialize(val, raw);
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_global_set_raw(
+    mut store: WasmtimeStoreContextMut<'_>,
+    global: &Global,
+    val: &ValRaw,
+) -> Option<Box<wasmtime_error_t>> {
+    let mut scope = RootScope::new(&mut store);
+    let ty = global.ty(&scope).content().clone();
+    let val = Val::from_raw(&mut scope, *val, ty);
+    handle_result(global.set(scope, val), |()| {})
+}
@@ -1,10 +1,10 @@
 use crate::{
-    WasmStoreRef, WasmtimeStoreContextMut, WasmtimeStoreData, wasm_extern_t, wasm_extern_vec_t,
-    wasm_module_t, wasm_store_t, wasm_trap_t, wasmtime_error_t, wasmtime_extern_t,
-    wasmtime_module_t,
+    WasmStoreRef, WasmtimeStoreContext, WasmtimeStoreContextMut, WasmtimeStoreData, wasm_extern_t,
+    wasm_extern_vec_t, wasm_module_t, wasm_store_t, wasm_trap_t, wasmtime_error_t,
+    wasmtime_extern_t, wasmtime_module_export_t, wasmtime_module_t,
 };
 use std::mem::MaybeUninit;
-use wasmtime::{Instance, InstancePre, Trap};
+use wasmtime::{Instance, InstancePre, Memory, Trap};
 
 #[derive(Clone)]
 pub struct wasm_instance_t {
@@ -132,6 +132,38 @@ pub unsafe extern "C" fn wasmtime_instance_export_get(
     }
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_instance_export_get_index(
+    store: WasmtimeStoreContextMut<'_>,
+    instance: &Instance,
+    export: &wasmtime_module_export_t,
+    item: &mut MaybeUninit<wasmtime_extern_t>,
+) -> bool {
+    match instance.get_module_export(store, &export.export) {
+        Some(e) => {
+            crate::initialize(item, e.into());
+            true
+        }
+        None => false,
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_instance_memory(
+    store: WasmtimeStoreContextMut<'_>,
+    instance: &Instance,
+    index: u32,
+    memory: &mut MaybeUninit<Memory>,
+) -> bool {
+    match instance.memory(store, index) {
+        Some(m) => {
+            crate::initialize(memory, m);
+            true
+        }
+        None => false,
+    }
+}
+
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn wasmtime_instance_export_nth(
     store: WasmtimeStoreContextMut<'_>,
@@ -152,6 +184,28 @@ pub unsafe extern "C" fn wasmtime_instance_export_nth(
     }
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_instance_function_stats_nth(
+    store: WasmtimeStoreContext<'_>,
+    instance: &Instance,
+    index: usize,
+    func_index: &mut u32,
+    calls: &mut u64,
+    name_ptr: &mut *const u8,
+    name_len: &mut usize,
+) -> bool {
+    match instance.function_stats(store).nth(index) {
+        Some(stats) => {
+            *func_index = stats.index;
+            *calls = stats.calls;
+            *name_ptr = stats.name.map_or(std::ptr::null(), |n| n.as_ptr());
+            *name_len = stats.name.map_or(0, |n| n.len());
+            true
+        }
+        None => false,
+    }
+}
+
 #[repr(transparent)]
 pub struct wasmtime_instance_pre_t {
     pub(crate) underlying: InstancePre<WasmtimeStoreData>,
@@ -177,5 +231,5 @@ pub unsafe extern "C" fn wasmtime_instance_pre_module(
     instance_pre: &wasmtime_instance_pre_t,
 ) -> Box<wasmtime_module_t> {
     let module = instance_pre.underlying.module().clone();
-    Box::new(wasmtime_module_t { module })
+    Box::new(wasmtime_module_t::new(module))
 }
@@ -18,6 +18,8 @@
 pub use wasmtime;
 
 mod config;
+#[cfg(feature = "coredump")]
+mod coredump;
 mod engine;
 mod error;
 mod r#extern;
@@ -33,6 +35,7 @@ mod r#ref;
 mod sharedmemory;
 mod store;
 mod table;
+mod tag;
 mod trap;
 mod types;
 mod val;
@@ -51,6 +54,7 @@ pub use crate::module::*;
 pub use crate::r#ref::*;
 pub use crate::store::*;
 pub use crate::table::*;
+pub use crate::tag::*;
 pub use crate::trap::*;
 pub use crate::types::*;
 pub use crate::val::*;
@@ -6,6 +6,7 @@ use crate::{
 use std::ffi::c_void;
 use std::mem::MaybeUninit;
 use std::str;
+use std::sync::Arc;
 use wasmtime::{Func, Instance, Linker};
 
 #[repr(C)]
@@ -85,6 +86,42 @@ pub unsafe extern "C" fn wasmtime_linker_define_func(
     handle_result(linker.linker.func_new(module, name, ty, cb), |_linker| ())
 }
 
+#[repr(C)]
+pub struct wasmtime_linker_func_def_t<'a> {
+    pub module: *const u8,
+    pub module_len: usize,
+    pub name: *const u8,
+    pub name_len: usize,
+    pub ty: &'a wasm_functype_t,
+    pub callback: crate::wasmtime_func_callback_t,
+    pub data: *mut c_void,
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_linker_define_funcs(
+    linker: &mut wasmtime_linker_t,
+    defs: *const wasmtime_linker_func_def_t<'_>,
+    len: usize,
+    env: *mut c_void,
+    finalizer: Option<extern "C" fn(*mut std::ffi::c_void)>,
+) -> Option<Box<wasmtime_error_t>> {
+    let owner = Arc::new(crate::ForeignData {
+        data: env,
+        finalizer,
+    });
+    for def in crate::slice_from_raw_parts(defs, len) {
+        let ty = def.ty.ty().ty(linker.linker.engine());
+        let module = to_str!(def.module, def.module_len);
+        let name = to_str!(def.name, def.name_len);
+        let cb =
+            crate::func::c_callback_with_owner_to_rust_fn(def.callback, def.data, owner.clone());
+        if let Err(e) = linker.linker.func_new(module, name, ty, cb) {
+            return Some(Box::new(wasmtime_error_t::from(e)));
+        }
+    }
+    None
+}
+
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn wasmtime_linker_define_func_unchecked(
     linker: &mut wasmtime_linker_t,
@@ -238,3 +275,50 @@ pub unsafe extern "C" fn wasmtime_linker_define_unknown_imports_as_default_value
         |_| (),
     )
 }
+
+#[derive(Clone)]
+pub struct wasmtime_frozen_linker_t {
+    linker: Arc<Linker<crate::WasmtimeStoreData>>,
+}
+
+wasmtime_c_api_macros::declare_own!(wasmtime_frozen_linker_t);
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_linker_freeze(
+    linker: Box<wasmtime_linker_t>,
+) -> Box<wasmtime_frozen_linker_t> {
+    Box::new(wasmtime_frozen_linker_t {
+        linker: Arc::new(linker.linker),
+    })
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_frozen_linker_clone(
+    linker: &wasmtime_frozen_linker_t,
+) -> Box<wasmtime_frozen_linker_t> {
+    Box::new(linker.clone())
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_frozen_linker_instantiate(
+    linker: &wasmtime_frozen_linker_t,
+    store: WasmtimeStoreContextMut<'_>,
+    module: &wasmtime_module_t,
+    instance_ptr: &mut Instance,
+    trap_ptr: &mut *mut wasm_trap_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = linker.linker.instantiate(store, &module.module);
+    super::instance::handle_instantiate(result, instance_ptr, trap_ptr)
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_frozen_linker_instantiate_pre(
+    linker: &wasmtime_frozen_linker_t,
+    module: &wasmtime_module_t,
+    instance_ptr: &mut *mut wasmtime_instance_pre_t,
+) -> Option<Box<wasmtime_error_t>> {
+    handle_result(linker.linker.instantiate_pre(&module.module), |i| {
+        let instance_pre = Box::new(wasmtime_instance_pre_t { underlying: i });
+        *instance_ptr = Box::into_raw(instance_pre)
+    })
+}
@@ -3,6 +3,7 @@ use crate::{
     wasm_store_t, wasmtime_error_t,
 };
 use std::convert::TryFrom;
+use std::ffi::c_void;
 use wasmtime::{Extern, Memory};
 
 #[derive(Clone)]
@@ -105,7 +106,7 @@ pub extern "C" fn wasmtime_memory_type(
 
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_memory_data(store: WasmtimeStoreContext<'_>, mem: &Memory) -> *const u8 {
-    mem.data(store).as_ptr()
+    mem.data_ptr(store)
 }
 
 #[unsafe(no_mangle)]
@@ -131,6 +132,75 @@ pub extern "C" fn wasmtime_memory_grow(
     handle_result(mem.grow(store, delta), |prev| *prev_size = prev)
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_memory_grow_populated(
+    store: WasmtimeStoreContextMut<'_>,
+    mem: &Memory,
+    delta: u64,
+    prev_size: &mut u64,
+) -> Option<Box<wasmtime_error_t>> {
+    handle_result(mem.grow_populated(store, delta), |prev| *prev_size = prev)
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_memory_map_file(
+    store: WasmtimeStoreContextMut<'_>,
+    mem: &Memory,
+    offset: usize,
+    fd: i32,
+    file_offset: u64,
+    len: usize,
+) -> Option<Box<wasmtime_error_t>> {
+    #[cfg(unix)]
+    let result = (|| -> wasmtime::Result<()> {
+        let fd = unsafe { std::os::fd::BorrowedFd::borrow_raw(fd) };
+        let file = std::fs::File::from(fd.try_clone_to_owned()?);
+        unsafe { mem.map_file(store, offset, &file, file_offset, len) }
+    })();
+    #[cfg(not(unix))]
+    let result = {
+        let _ = (store, mem, offset, fd, file_offset, len);
+        Err(wasmtime::Error::msg(
+            "mapping files isn't supported on this platform",
+        ))
+    };
+    handle_result(result, |()| {})
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_memory_dirty_pages(
+    store: WasmtimeStoreContext<'_>,
+    mem: &Memory,
+    callback: extern "C" fn(*mut c_void, usize, usize),
+    env: *mut c_void,
+) -> Option<Box<wasmtime_error_t>> {
+    handle_result(mem.dirty_pages(store), |ranges| {
+        for range in ranges {
+            callback(env, range.start, range.end);
+        }
+    })
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_memory_access_histogram(
+    store: WasmtimeStoreContext<'_>,
+    mem: &Memory,
+    callback: extern "C" fn(*mut c_void, u64, u64),
+    env: *mut c_void,
+) {
+    for (page, count) in mem.access_histogram(store).into_iter().enumerate() {
+        callback(env, page as u64, count);
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_memory_reset_dirty_to_image(
+    store: WasmtimeStoreContextMut<'_>,
+    mem: &Memory,
+) -> Option<Box<wasmtime_error_t>> {
+    handle_result(mem.reset_dirty_to_image(store), |()| {})
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_memory_page_size(store: WasmtimeStoreContext<'_>, mem: &Memory) -> u64 {
     mem.page_size(store)
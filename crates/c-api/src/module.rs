@@ -1,12 +1,16 @@
 use crate::{
-    CExternType, handle_result, wasm_byte_vec_t, wasm_engine_t, wasm_exporttype_t,
+    CExternType, ForeignData, handle_result, wasm_byte_vec_t, wasm_engine_t, wasm_exporttype_t,
     wasm_exporttype_vec_t, wasm_importtype_t, wasm_importtype_vec_t, wasm_store_t,
     wasmtime_error_t,
 };
-use std::ffi::CStr;
+use std::ffi::{CStr, c_void};
 use std::os::raw::c_char;
+use std::ptr::{self, NonNull};
+use std::sync::OnceLock;
 use wasmtime::error::Context;
-use wasmtime::{Engine, Module};
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+use wasmtime::{CodeBuilder, CompileReport, LazyModule, ModuleBuilder};
+use wasmtime::{Engine, Module, ModuleExport, SharedCodeRegistry};
 
 #[derive(Clone)]
 pub struct wasm_module_t {
@@ -126,13 +130,30 @@ pub unsafe extern "C" fn wasm_module_deserialize(
     }
 }
 
-#[derive(Clone)]
 pub struct wasmtime_module_t {
     pub(crate) module: Module,
+    imports: OnceLock<wasm_importtype_vec_t>,
+    exports: OnceLock<wasm_exporttype_vec_t>,
 }
 
 wasmtime_c_api_macros::declare_own!(wasmtime_module_t);
 
+impl wasmtime_module_t {
+    pub(crate) fn new(module: Module) -> wasmtime_module_t {
+        wasmtime_module_t {
+            module,
+            imports: OnceLock::new(),
+            exports: OnceLock::new(),
+        }
+    }
+}
+
+impl Clone for wasmtime_module_t {
+    fn clone(&self) -> wasmtime_module_t {
+        wasmtime_module_t::new(self.module.clone())
+    }
+}
+
 #[unsafe(no_mangle)]
 #[cfg(any(feature = "cranelift", feature = "winch"))]
 pub unsafe extern "C" fn wasmtime_module_new(
@@ -144,11 +165,200 @@ pub unsafe extern "C" fn wasmtime_module_new(
     handle_result(
         Module::from_binary(&engine.engine, crate::slice_from_raw_parts(wasm, len)),
         |module| {
-            *out = Box::into_raw(Box::new(wasmtime_module_t { module }));
+            *out = Box::into_raw(Box::new(wasmtime_module_t::new(module)));
+        },
+    )
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub unsafe extern "C" fn wasmtime_module_compile_file(
+    engine: &wasm_engine_t,
+    path: *const c_char,
+    out: &mut *mut wasmtime_module_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let path = CStr::from_ptr(path);
+    let result = path
+        .to_str()
+        .context("input path is not valid utf-8")
+        .and_then(|path| Module::from_mapped_file(&engine.engine, path));
+    handle_result(result, |module| {
+        *out = Box::into_raw(Box::new(wasmtime_module_t::new(module)));
+    })
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub unsafe extern "C" fn wasmtime_module_new_with_report(
+    engine: &wasm_engine_t,
+    wasm: *const u8,
+    len: usize,
+    out: &mut *mut wasmtime_module_t,
+    report_out: &mut *mut wasmtime_compile_report_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = CodeBuilder::new(&engine.engine)
+        .wasm_binary(crate::slice_from_raw_parts(wasm, len), None)
+        .and_then(|builder| builder.compile_module_with_report());
+    handle_result(result, |(module, report)| {
+        *out = Box::into_raw(Box::new(wasmtime_module_t::new(module)));
+        *report_out = Box::into_raw(Box::new(wasmtime_compile_report_t { report }));
+    })
+}
+
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub struct wasmtime_compile_report_t {
+    report: CompileReport,
+}
+
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+wasmtime_c_api_macros::declare_own!(wasmtime_compile_report_t);
+
+#[repr(C)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub struct wasmtime_function_compile_stats_t {
+    pub index: u32,
+    pub name: *const c_char,
+    pub name_len: usize,
+    pub total_time_nanos: u64,
+    pub translation_time_nanos: u64,
+    pub optimization_time_nanos: u64,
+    pub lowering_time_nanos: u64,
+    pub regalloc_time_nanos: u64,
+    pub emission_time_nanos: u64,
+    pub translated_ir_insts: usize,
+    pub optimized_ir_insts: usize,
+    pub code_size: usize,
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_compile_report_len(report: &wasmtime_compile_report_t) -> usize {
+    report.report.functions().len()
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_compile_report_get(
+    report: &wasmtime_compile_report_t,
+    index: usize,
+    out: &mut wasmtime_function_compile_stats_t,
+) -> bool {
+    let Some(func) = report.report.functions().get(index) else {
+        return false;
+    };
+    let nanos = |d: std::time::Duration| u64::try_from(d.as_nanos()).unwrap_or(u64::MAX);
+    let stats = func.stats();
+    *out = wasmtime_function_compile_stats_t {
+        index: func.index(),
+        name: func.name().map_or(std::ptr::null(), |n| n.as_ptr().cast()),
+        name_len: func.name().map_or(0, str::len),
+        total_time_nanos: nanos(stats.total_time),
+        translation_time_nanos: nanos(stats.translation_time),
+        optimization_time_nanos: nanos(stats.optimization_time),
+        lowering_time_nanos: nanos(stats.lowering_time),
+        regalloc_time_nanos: nanos(stats.regalloc_time),
+        emission_time_nanos: nanos(stats.emission_time),
+        translated_ir_insts: stats.translated_ir_insts,
+        optimized_ir_insts: stats.optimized_ir_insts,
+        code_size: stats.code_size,
+    };
+    true
+}
+
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub struct wasmtime_lazy_module_t {
+    module: LazyModule,
+}
+
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+wasmtime_c_api_macros::declare_own!(wasmtime_lazy_module_t);
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub unsafe extern "C" fn wasmtime_lazy_module_new(
+    engine: &wasm_engine_t,
+    wasm: *const u8,
+    len: usize,
+    out: &mut *mut wasmtime_lazy_module_t,
+) -> Option<Box<wasmtime_error_t>> {
+    handle_result(
+        LazyModule::new(&engine.engine, crate::slice_from_raw_parts(wasm, len)),
+        |module| {
+            *out = Box::into_raw(Box::new(wasmtime_lazy_module_t { module }));
         },
     )
 }
 
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_lazy_module_get(
+    module: &wasmtime_lazy_module_t,
+    out: &mut *mut wasmtime_module_t,
+) -> Option<Box<wasmtime_error_t>> {
+    handle_result(module.module.get(), |module| {
+        *out = Box::into_raw(Box::new(wasmtime_module_t::new(module)));
+    })
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_lazy_module_warm(module: &wasmtime_lazy_module_t) {
+    module.module.warm();
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_lazy_module_is_compiled(module: &wasmtime_lazy_module_t) -> bool {
+    module.module.is_compiled()
+}
+
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub struct wasmtime_module_builder_t {
+    builder: Option<ModuleBuilder>,
+}
+
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+wasmtime_c_api_macros::declare_own!(wasmtime_module_builder_t);
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_module_builder_new(
+    engine: &wasm_engine_t,
+) -> Box<wasmtime_module_builder_t> {
+    Box::new(wasmtime_module_builder_t {
+        builder: Some(ModuleBuilder::new(&engine.engine)),
+    })
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub unsafe extern "C" fn wasmtime_module_builder_feed(
+    builder: &mut wasmtime_module_builder_t,
+    bytes: *const u8,
+    len: usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = match &mut builder.builder {
+        Some(b) => b.feed(crate::slice_from_raw_parts(bytes, len)),
+        None => Err(wasmtime::format_err!("module builder has already finished")),
+    };
+    handle_result(result, |()| {})
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_module_builder_finish(
+    builder: &mut wasmtime_module_builder_t,
+    out: &mut *mut wasmtime_module_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = match builder.builder.take() {
+        Some(b) => b.finish(),
+        None => Err(wasmtime::format_err!("module builder has already finished")),
+    };
+    handle_result(result, |module| {
+        *out = Box::into_raw(Box::new(wasmtime_module_t::new(module)));
+    })
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_module_clone(module: &wasmtime_module_t) -> Box<wasmtime_module_t> {
     Box::new(module.clone())
@@ -162,6 +372,35 @@ pub extern "C" fn wasmtime_module_exports(
     fill_exports(&module.module, out);
 }
 
+#[repr(transparent)]
+pub struct wasmtime_module_export_t {
+    pub(crate) export: ModuleExport,
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_module_get_export_index(
+    module: &wasmtime_module_t,
+    name: *const u8,
+    name_len: usize,
+) -> Option<Box<wasmtime_module_export_t>> {
+    let name = crate::slice_from_raw_parts(name, name_len);
+    let name = std::str::from_utf8(name).ok()?;
+    let export = module.module.get_export_index(name)?;
+    Some(Box::new(wasmtime_module_export_t { export }))
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_module_export_clone(
+    export: &wasmtime_module_export_t,
+) -> Box<wasmtime_module_export_t> {
+    Box::new(wasmtime_module_export_t {
+        export: export.export,
+    })
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_module_export_delete(_export: Box<wasmtime_module_export_t>) {}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_module_imports(
     module: &wasmtime_module_t,
@@ -170,6 +409,28 @@ pub extern "C" fn wasmtime_module_imports(
     fill_imports(&module.module, out);
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_module_import_types(
+    module: &wasmtime_module_t,
+) -> &wasm_importtype_vec_t {
+    module.imports.get_or_init(|| {
+        let mut imports = wasm_importtype_vec_t::default();
+        fill_imports(&module.module, &mut imports);
+        imports
+    })
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_module_export_types(
+    module: &wasmtime_module_t,
+) -> &wasm_exporttype_vec_t {
+    module.exports.get_or_init(|| {
+        let mut exports = wasm_exporttype_vec_t::default();
+        fill_exports(&module.module, &mut exports);
+        exports
+    })
+}
+
 #[unsafe(no_mangle)]
 #[cfg(any(feature = "cranelift", feature = "winch"))]
 pub unsafe extern "C" fn wasmtime_module_validate(
@@ -190,6 +451,82 @@ pub extern "C" fn wasmtime_module_serialize(
     handle_result(module.module.serialize(), |buf| ret.set_buffer(buf))
 }
 
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub unsafe extern "C" fn wasmtime_engine_precompile_modules(
+    engine: &wasm_engine_t,
+    wasm: *const *const u8,
+    wasm_lens: *const usize,
+    count: usize,
+    ret: *mut wasm_byte_vec_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let ptrs = crate::slice_from_raw_parts(wasm, count);
+    let lens = crate::slice_from_raw_parts(wasm_lens, count);
+    let modules = ptrs
+        .iter()
+        .zip(lens)
+        .map(|(ptr, len)| crate::slice_from_raw_parts(*ptr, *len))
+        .collect::<Vec<_>>();
+    handle_result(engine.engine.precompile_modules(&modules), |artifacts| {
+        for (i, artifact) in artifacts.into_iter().enumerate() {
+            (*ret.add(i)).set_buffer(artifact);
+        }
+    })
+}
+
+pub type wasmtime_module_serialize_callback_t =
+    extern "C" fn(env: *mut c_void, data: *const u8, len: usize) -> bool;
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_module_serialize_to(
+    module: &wasmtime_module_t,
+    callback: wasmtime_module_serialize_callback_t,
+    env: *mut c_void,
+) -> Option<Box<wasmtime_error_t>> {
+    struct CallbackWriter {
+        callback: wasmtime_module_serialize_callback_t,
+        env: *mut c_void,
+    }
+
+    impl std::io::Write for CallbackWriter {
+        fn write(&mut self, buf: &[u8]) -> std::io::Result<usize> {
+            if (self.callback)(self.env, buf.as_ptr(), buf.len()) {
+                Ok(buf.len())
+            } else {
+                Err(std::io::Error::other("serialization callback failed"))
+            }
+        }
+
+        fn flush(&mut self) -> std::io::Result<()> {
+            Ok(())
+        }
+    }
+
+    let writer = CallbackWriter { callback, env };
+    handle_result(module.module.serialize_to(writer), |()| {})
+}
+
+#[unsafe(no_mangle)]
+#[cfg(feature = "cranelift")]
+pub extern "C" fn wasmtime_module_optimized_tier(
+    module: &wasmtime_module_t,
+) -> Option<Box<wasmtime_module_t>> {
+    let module = module.module.optimized_tier()?;
+    Some(Box::new(wasmtime_module_t::new(module)))
+}
+
+#[unsafe(no_mangle)]
+#[cfg(feature = "cranelift")]
+pub extern "C" fn wasmtime_module_wait_optimized_tier(
+    module: &wasmtime_module_t,
+    out: &mut *mut wasmtime_module_t,
+) -> Option<Box<wasmtime_error_t>> {
+    handle_result(module.module.wait_optimized_tier(), |module| {
+        *out = Box::into_raw(Box::new(wasmtime_module_t::new(module)));
+    })
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_module_image_range(
     module: &wasmtime_module_t,
@@ -201,6 +538,36 @@ pub extern "C" fn wasmtime_module_image_range(
     *end = range.end;
 }
 
+#[repr(C)]
+pub struct wasmtime_module_resource_estimate_t {
+    pub code_bytes: usize,
+    pub text_bytes: usize,
+    pub data_bytes: usize,
+    pub memories: usize,
+    pub min_memory_bytes: u64,
+    pub tables: usize,
+    pub min_table_elements: u64,
+    pub instance_bytes: usize,
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_module_resource_estimate(
+    module: &wasmtime_module_t,
+    out: &mut wasmtime_module_resource_estimate_t,
+) {
+    let estimate = module.module.resource_estimate();
+    *out = wasmtime_module_resource_estimate_t {
+        code_bytes: estimate.code_bytes(),
+        text_bytes: estimate.text_bytes(),
+        data_bytes: estimate.data_bytes(),
+        memories: estimate.memories(),
+        min_memory_bytes: estimate.min_memory_bytes(),
+        tables: estimate.tables(),
+        min_table_elements: estimate.min_table_elements(),
+        instance_bytes: estimate.instance_bytes(),
+    };
+}
+
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn wasmtime_module_deserialize(
     engine: &wasm_engine_t,
@@ -210,7 +577,55 @@ pub unsafe extern "C" fn wasmtime_module_deserialize(
 ) -> Option<Box<wasmtime_error_t>> {
     let bytes = crate::slice_from_raw_parts(bytes, len);
     handle_result(Module::deserialize(&engine.engine, bytes), |module| {
-        *out = Box::into_raw(Box::new(wasmtime_module_t { module }));
+        *out = Box::into_raw(Box::new(wasmtime_module_t::new(module)));
+    })
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_module_deserialize_raw(
+    engine: &wasm_engine_t,
+    bytes: *const u8,
+    len: usize,
+    data: *mut c_void,
+    finalizer: Option<extern "C" fn(*mut c_void)>,
+    out: &mut *mut wasmtime_module_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let owner = ForeignData { data, finalizer };
+    let result = match NonNull::new(ptr::slice_from_raw_parts_mut(bytes.cast_mut(), len)) {
+        Some(memory) => Module::deserialize_raw_with_owner(&engine.engine, memory, owner),
+        None => Err(wasmtime::format_err!("serialized module cannot be null")),
+    };
+    handle_result(result, |module| {
+        *out = Box::into_raw(Box::new(wasmtime_module_t::new(module)));
+    })
+}
+
+#[repr(C)]
+pub struct wasmtime_serialized_module_info_t {
+    pub image_size: usize,
+    pub text_size: u64,
+    pub wasm_data_size: u64,
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_module_inspect_serialized(
+    engine: &wasm_engine_t,
+    bytes: *const u8,
+    len: usize,
+    info: &mut wasmtime_serialized_module_info_t,
+    incompatibility: &mut *mut wasmtime_error_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let bytes = crate::slice_from_raw_parts(bytes, len);
+    handle_result(Module::inspect_serialized(&engine.engine, bytes), |i| {
+        *info = wasmtime_serialized_module_info_t {
+            image_size: i.image_size(),
+            text_size: i.text_size(),
+            wasm_data_size: i.wasm_data_size(),
+        };
+        *incompatibility = match i.incompatibility() {
+            Some(msg) => Box::into_raw(Box::new(wasmtime::format_err!("{msg}").into())),
+            None => ptr::null_mut(),
+        };
     })
 }
 
@@ -226,6 +641,42 @@ pub unsafe extern "C" fn wasmtime_module_deserialize_file(
         .context("input path is not valid utf-8")
         .and_then(|path| Module::deserialize_file(&engine.engine, path));
     handle_result(result, |module| {
-        *out = Box::into_raw(Box::new(wasmtime_module_t { module }));
+        *out = Box::into_raw(Box::new(wasmtime_module_t::new(module)));
+    })
+}
+
+pub struct wasmtime_shared_code_registry_t {
+    registry: SharedCodeRegistry,
+}
+
+wasmtime_c_api_macros::declare_own!(wasmtime_shared_code_registry_t);
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_shared_code_registry_new(
+    dir: *const c_char,
+    out: &mut *mut wasmtime_shared_code_registry_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let dir = CStr::from_ptr(dir);
+    let result = dir
+        .to_str()
+        .context("input path is not valid utf-8")
+        .and_then(SharedCodeRegistry::new);
+    handle_result(result, |registry| {
+        *out = Box::into_raw(Box::new(wasmtime_shared_code_registry_t { registry }));
+    })
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_shared_code_registry_deserialize(
+    registry: &wasmtime_shared_code_registry_t,
+    engine: &wasm_engine_t,
+    bytes: *const u8,
+    len: usize,
+    out: &mut *mut wasmtime_module_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let bytes = crate::slice_from_raw_parts(bytes, len);
+    let result = registry.registry.deserialize(&engine.engine, bytes);
+    handle_result(result, |module| {
+        *out = Box::into_raw(Box::new(wasmtime_module_t::new(module)));
     })
 }
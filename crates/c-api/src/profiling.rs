@@ -1,11 +1,11 @@
 use crate::{
-    wasm_byte_vec_t, wasm_engine_t, wasm_name_t, wasmtime_error_t, wasmtime_module_t,
-    wasmtime_store_t,
+    WasmtimeStoreContext, wasm_byte_vec_t, wasm_engine_t, wasm_name_t, wasmtime_error_t,
+    wasmtime_module_t, wasmtime_store_t,
 };
 use std::slice;
 use std::str::from_utf8;
 use std::time::Duration;
-use wasmtime::GuestProfiler;
+use wasmtime::{AggregateGuestProfiler, GuestProfiler, ProfileFormat};
 
 pub struct wasmtime_guestprofiler_t {
     guest_profiler: GuestProfiler,
@@ -28,17 +28,7 @@ pub unsafe extern "C" fn wasmtime_guestprofiler_new(
     modules_len: usize,
 ) -> Box<wasmtime_guestprofiler_t> {
     let module_name = from_utf8(&module_name.as_slice()).expect("not valid utf-8");
-    let list = slice::from_raw_parts(modules, modules_len)
-        .iter()
-        .map(|entry| {
-            (
-                from_utf8(entry.name.as_slice())
-                    .expect("not valid utf-8")
-                    .to_owned(),
-                entry.module.module.clone(),
-            )
-        })
-        .collect::<Vec<_>>();
+    let list = module_list(modules, modules_len);
     Box::new(wasmtime_guestprofiler_t {
         guest_profiler: GuestProfiler::new(
             &engine.engine,
@@ -61,6 +51,17 @@ pub extern "C" fn wasmtime_guestprofiler_sample(
         .sample(&store.store, Duration::from_nanos(delta_nanos));
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_guestprofiler_sample_context(
+    guestprofiler: &mut wasmtime_guestprofiler_t,
+    store: WasmtimeStoreContext<'_>,
+    delta_nanos: u64,
+) {
+    guestprofiler
+        .guest_profiler
+        .sample(store, Duration::from_nanos(delta_nanos));
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_guestprofiler_finish(
     guestprofiler: Box<wasmtime_guestprofiler_t>,
@@ -75,3 +76,85 @@ pub extern "C" fn wasmtime_guestprofiler_finish(
         Err(e) => Some(Box::new(e.into())),
     }
 }
+
+unsafe fn module_list(
+    modules: *const wasmtime_guestprofiler_modules_t,
+    modules_len: usize,
+) -> Vec<(String, wasmtime::Module)> {
+    slice::from_raw_parts(modules, modules_len)
+        .iter()
+        .map(|entry| {
+            (
+                from_utf8(entry.name.as_slice())
+                    .expect("not valid utf-8")
+                    .to_owned(),
+                entry.module.module.clone(),
+            )
+        })
+        .collect()
+}
+
+pub struct wasmtime_aggregate_profiler_t {
+    profiler: AggregateGuestProfiler,
+}
+
+wasmtime_c_api_macros::declare_own!(wasmtime_aggregate_profiler_t);
+
+#[repr(u8)]
+#[derive(Clone)]
+pub enum wasmtime_profile_format_t {
+    WASMTIME_PROFILE_FORMAT_PPROF,
+    WASMTIME_PROFILE_FORMAT_COLLAPSED,
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_aggregate_profiler_new(
+    engine: &wasm_engine_t,
+    interval_nanos: u64,
+    max_stacks: usize,
+    modules: *const wasmtime_guestprofiler_modules_t,
+    modules_len: usize,
+) -> Box<wasmtime_aggregate_profiler_t> {
+    let list = module_list(modules, modules_len);
+    Box::new(wasmtime_aggregate_profiler_t {
+        profiler: AggregateGuestProfiler::new(
+            &engine.engine,
+            Duration::from_nanos(interval_nanos),
+            max_stacks,
+            list,
+        )
+        .unwrap(),
+    })
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_aggregate_profiler_sample(
+    profiler: &mut wasmtime_aggregate_profiler_t,
+    store: WasmtimeStoreContext<'_>,
+    delta_nanos: u64,
+) {
+    profiler
+        .profiler
+        .sample(store, Duration::from_nanos(delta_nanos));
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_aggregate_profiler_flush(
+    profiler: &mut wasmtime_aggregate_profiler_t,
+    format: wasmtime_profile_format_t,
+    out: &mut wasm_byte_vec_t,
+) -> Option<Box<wasmtime_error_t>> {
+    use wasmtime_profile_format_t::*;
+    let format = match format {
+        WASMTIME_PROFILE_FORMAT_PPROF => ProfileFormat::Pprof,
+        WASMTIME_PROFILE_FORMAT_COLLAPSED => ProfileFormat::Collapsed,
+    };
+    let mut buf = vec![];
+    match profiler.profiler.flush(format, &mut buf) {
+        Ok(()) => {
+            out.set_buffer(buf);
+            None
+        }
+        Err(e) => Some(Box::new(e.into())),
+    }
+}
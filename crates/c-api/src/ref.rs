@@ -1,7 +1,14 @@
-use crate::{WasmtimeStoreContextMut, abort};
+use crate::{
+    WasmtimeStoreContext, WasmtimeStoreContextMut, abort, handle_result, wasm_trap_t,
+    wasmtime_error_t, wasmtime_val_t,
+};
+use std::convert::Infallible;
 use std::mem::{ManuallyDrop, MaybeUninit};
 use std::{num::NonZeroU64, os::raw::c_void, ptr};
-use wasmtime::{AnyRef, ExternRef, I31, OwnedRooted, Ref, RootScope, Val};
+use wasmtime::{
+    AnyRef, ArrayRef, AsContext, AsContextMut, ExnRef, ExnRefPre, ExnType, ExternRef, I31,
+    OwnedRooted, Ref, RootScope, Rooted, Tag, Val, format_err,
+};
 
 /// `*mut wasm_ref_t` is a reference type (`externref` or `funcref`), as seen by
 /// the C API. Because we do not have a uniform representation for `funcref`s
@@ -183,11 +190,19 @@ pub extern "C" fn wasm_foreign_new(_store: &crate::wasm_store_t) -> Box<wasm_for
     abort("wasm_foreign_new")
 }
 
+/// Value of `c` for an `anyref` which is an unboxed `i31ref`, whose raw
+/// value is stored in `a`. These aren't rooted at all. The liveness flag of an
+/// `OwnedRooted` is an `Arc` so is never this pointer.
+const I31_TAG: *const () = ptr::without_provenance(1);
+
 /// C-API representation of `anyref`.
 ///
 /// This represented differently in the C API from the header to handle how
 /// this is dispatched internally. Null anyref values are represented with a
-/// `store_id` of zero, and otherwise the `rooted` field is valid.
+/// `store_id` of zero. Otherwise a null `c` means the value is a `Rooted`
+/// which lives in a scope entered with `wasmtime_root_scope_enter`, a `c` of
+/// `I31_TAG` means it's an unboxed `i31ref`, and any other `c` means it's an
+/// `OwnedRooted`.
 ///
 /// Note that this relies on the Wasmtime definition of `OwnedRooted` to have
 /// a 64-bit store_id first.
@@ -201,7 +216,18 @@ macro_rules! ref_wrapper {
         }
 
         impl $c {
+            fn is_scoped(&self) -> bool {
+                self.store_id != 0 && self.c.is_null()
+            }
+
+            fn is_owned(&self) -> bool {
+                self.store_id != 0 && !self.c.is_null() && self.c != I31_TAG
+            }
+
             pub unsafe fn as_wasmtime(&self) -> Option<OwnedRooted<$wasmtime>> {
+                if !self.is_owned() {
+                    return None;
+                }
                 let store_id = NonZeroU64::new(self.store_id)?;
                 Some(OwnedRooted::from_borrowed_raw_parts_for_c_api(
                     store_id, self.a, self.b, self.c,
@@ -213,11 +239,87 @@ macro_rules! ref_wrapper {
             }
 
             unsafe fn to_owned(&self) -> Option<OwnedRooted<$wasmtime>> {
+                if !self.is_owned() {
+                    return None;
+                }
                 let store_id = NonZeroU64::new(self.store_id)?;
                 Some(OwnedRooted::from_owned_raw_parts_for_c_api(
                     store_id, self.a, self.b, self.c,
                 ))
             }
+
+            fn as_scoped(&self) -> Option<Rooted<$wasmtime>> {
+                if !self.is_scoped() {
+                    return None;
+                }
+                let store_id = NonZeroU64::new(self.store_id)?;
+                Some(Rooted::from_raw_parts_for_c_api(store_id, self.a, self.b))
+            }
+
+            pub fn null() -> $c {
+                $c {
+                    store_id: 0,
+                    a: 0,
+                    b: 0,
+                    c: core::ptr::null(),
+                }
+            }
+
+            /// Calls `f` with the object this refers to, or returns `None` if
+            /// this is null or an unboxed `i31ref`.
+            pub unsafe fn with_ref<R>(&self, f: impl FnOnce(&$wasmtime) -> R) -> Option<R> {
+                match self.as_scoped() {
+                    Some(rooted) => Some(f(&rooted)),
+                    None => self.as_wasmtime().map(|owned| f(&owned)),
+                }
+            }
+
+            /// Returns this reference rooted in the current scope of `cx`,
+            /// or `None` if this is null or an unboxed `i31ref`.
+            unsafe fn to_rooted_ref(
+                &self,
+                cx: impl AsContextMut,
+            ) -> Option<Rooted<$wasmtime>> {
+                match self.as_scoped() {
+                    Some(rooted) => Some(rooted),
+                    None => self.as_wasmtime().map(|owned| owned.to_rooted(cx)),
+                }
+            }
+
+            /// Returns a new reference to the same object. Copies of values
+            /// rooted in a scope, and of unboxed `i31ref`s, are plain copies.
+            pub unsafe fn clone_ref(&self) -> $c {
+                if !self.is_owned() {
+                    return $c {
+                        store_id: self.store_id,
+                        a: self.a,
+                        b: self.b,
+                        c: self.c,
+                    };
+                }
+                self.as_wasmtime().into()
+            }
+
+            /// Creates a new reference with `f`, which roots its result in the
+            /// scope it's given.
+            ///
+            /// If a scope has been entered with `wasmtime_root_scope_enter`
+            /// the result stays rooted in it, otherwise it's rooted
+            /// individually with an `OwnedRooted`.
+            fn new_with<E>(
+                mut cx: WasmtimeStoreContextMut<'_>,
+                f: impl FnOnce(
+                    &mut WasmtimeStoreContextMut<'_>,
+                ) -> Result<Option<Rooted<$wasmtime>>, E>,
+            ) -> Result<$c, E> {
+                if cx.data().root_scopes > 0 {
+                    return Ok(f(&mut cx)?.into());
+                }
+                let mut scope = RootScope::new(cx);
+                let rooted = f(&mut scope.as_context_mut())?;
+                let owned = rooted.map(|r| r.to_owned_rooted(&mut scope).expect("in scope"));
+                Ok(owned.into())
+            }
         }
 
         impl Drop for $c {
@@ -230,12 +332,7 @@ macro_rules! ref_wrapper {
 
         impl From<Option<OwnedRooted<$wasmtime>>> for $c {
             fn from(rooted: Option<OwnedRooted<$wasmtime>>) -> $c {
-                let mut ret = $c {
-                    store_id: 0,
-                    a: 0,
-                    b: 0,
-                    c: core::ptr::null(),
-                };
+                let mut ret = $c::null();
                 if let Some(rooted) = rooted {
                     let (store_id, a, b, c) = rooted.into_parts_for_c_api();
                     ret.store_id = store_id.get();
@@ -247,6 +344,19 @@ macro_rules! ref_wrapper {
             }
         }
 
+        impl From<Option<Rooted<$wasmtime>>> for $c {
+            fn from(rooted: Option<Rooted<$wasmtime>>) -> $c {
+                let mut ret = $c::null();
+                if let Some(rooted) = rooted {
+                    let (store_id, a, b) = rooted.into_parts_for_c_api();
+                    ret.store_id = store_id.get();
+                    ret.a = a;
+                    ret.b = b;
+                }
+                ret
+            }
+        }
+
         // SAFETY: The `*const ()` comes from (and is converted back
         // into) an `Arc<()>`, and is only accessed as such, so this
         // type is both Send and Sync. These constraints are necessary
@@ -258,14 +368,70 @@ macro_rules! ref_wrapper {
 
 ref_wrapper!(AnyRef => wasmtime_anyref_t);
 ref_wrapper!(ExternRef => wasmtime_externref_t);
+ref_wrapper!(ExnRef => wasmtime_exnref_t);
+
+impl wasmtime_anyref_t {
+    /// Creates an unboxed `i31ref`, which doesn't need to be rooted.
+    fn from_i31(i31: I31) -> wasmtime_anyref_t {
+        wasmtime_anyref_t {
+            store_id: u64::MAX,
+            a: i31.to_raw_for_c_api(),
+            b: 0,
+            c: I31_TAG,
+        }
+    }
+
+    /// Returns the value of this `anyref` if it's an unboxed `i31ref`.
+    fn as_unboxed_i31(&self) -> Option<I31> {
+        if self.store_id != 0 && self.c == I31_TAG {
+            I31::from_raw_for_c_api(self.a)
+        } else {
+            None
+        }
+    }
+
+    /// Creates the C representation of `anyref`, leaving `i31ref`s unboxed.
+    pub fn from_rooted(cx: impl AsContextMut, anyref: Option<Rooted<AnyRef>>) -> wasmtime_anyref_t {
+        let Some(anyref) = anyref else {
+            return wasmtime_anyref_t::null();
+        };
+        match anyref.as_i31(&cx) {
+            Ok(Some(i31)) => wasmtime_anyref_t::from_i31(i31),
+            _ => anyref.to_owned_rooted(cx).ok().into(),
+        }
+    }
+
+    /// Returns this reference rooted in the current scope of `cx`.
+    pub unsafe fn to_rooted(&self, cx: impl AsContextMut) -> Option<Rooted<AnyRef>> {
+        match self.as_unboxed_i31() {
+            Some(i31) => Some(AnyRef::from_i31(cx, i31)),
+            None => self.to_rooted_ref(cx),
+        }
+    }
+
+    /// Returns the `i31ref` this refers to, if any, without rooting it.
+    unsafe fn as_i31(&self, cx: impl AsContext) -> Option<I31> {
+        match self.as_unboxed_i31() {
+            Some(i31) => Some(i31),
+            None => self.with_ref(|a| a.as_i31(&cx).ok().flatten()).flatten(),
+        }
+    }
+}
+
+impl wasmtime_externref_t {
+    /// Returns this reference rooted in the current scope of `cx`.
+    pub unsafe fn to_rooted(&self, cx: impl AsContextMut) -> Option<Rooted<ExternRef>> {
+        self.to_rooted_ref(cx)
+    }
+}
 
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn wasmtime_anyref_clone(
     anyref: Option<&wasmtime_anyref_t>,
     out: &mut MaybeUninit<wasmtime_anyref_t>,
 ) {
-    let anyref = anyref.and_then(|a| a.as_wasmtime());
-    crate::initialize(out, anyref.into());
+    let anyref = anyref.map_or_else(wasmtime_anyref_t::null, |a| a.clone_ref());
+    crate::initialize(out, anyref);
 }
 
 #[unsafe(no_mangle)]
@@ -282,8 +448,14 @@ pub unsafe extern "C" fn wasmtime_anyref_to_raw(
     cx: WasmtimeStoreContextMut<'_>,
     val: Option<&wasmtime_anyref_t>,
 ) -> u32 {
-    val.and_then(|v| v.as_wasmtime())
-        .and_then(|e| e.to_raw(cx).ok())
+    let Some(val) = val else {
+        return 0;
+    };
+    if let Some(i31) = val.as_unboxed_i31() {
+        return i31.to_raw_for_c_api();
+    }
+    val.with_ref(|a| a.to_raw(cx).ok())
+        .flatten()
         .unwrap_or_default()
 }
 
@@ -293,22 +465,22 @@ pub unsafe extern "C" fn wasmtime_anyref_from_raw(
     raw: u32,
     val: &mut MaybeUninit<wasmtime_anyref_t>,
 ) {
-    let mut scope = RootScope::new(cx);
-    let anyref =
-        AnyRef::from_raw(&mut scope, raw).map(|a| a.to_owned_rooted(&mut scope).expect("in scope"));
-    crate::initialize(val, anyref.into());
+    if let Some(i31) = I31::from_raw_for_c_api(raw) {
+        crate::initialize(val, wasmtime_anyref_t::from_i31(i31));
+        return;
+    }
+    let Ok(anyref) =
+        wasmtime_anyref_t::new_with(cx, |cx| Ok::<_, Infallible>(AnyRef::from_raw(cx, raw)));
+    crate::initialize(val, anyref);
 }
 
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_anyref_from_i31(
-    cx: WasmtimeStoreContextMut<'_>,
+    _cx: WasmtimeStoreContextMut<'_>,
     val: u32,
     out: &mut MaybeUninit<wasmtime_anyref_t>,
 ) {
-    let mut scope = RootScope::new(cx);
-    let anyref = AnyRef::from_i31(&mut scope, I31::wrapping_u32(val));
-    let anyref = anyref.to_owned_rooted(&mut scope).expect("in scope");
-    crate::initialize(out, Some(anyref).into())
+    crate::initialize(out, wasmtime_anyref_t::from_i31(I31::wrapping_u32(val)))
 }
 
 #[unsafe(no_mangle)]
@@ -317,16 +489,13 @@ pub unsafe extern "C" fn wasmtime_anyref_i31_get_u(
     anyref: Option<&wasmtime_anyref_t>,
     dst: &mut MaybeUninit<u32>,
 ) -> bool {
-    match anyref.and_then(|a| a.as_wasmtime()) {
-        Some(anyref) if anyref.is_i31(&cx).expect("OwnedRooted always in scope") => {
-            let val = anyref
-                .unwrap_i31(&cx)
-                .expect("OwnedRooted always in scope")
-                .get_u32();
-            crate::initialize(dst, val);
+    let i31 = anyref.and_then(|a| a.as_i31(&cx));
+    match i31 {
+        Some(i31) => {
+            crate::initialize(dst, i31.get_u32());
             true
         }
-        _ => false,
+        None => false,
     }
 }
 
@@ -336,19 +505,85 @@ pub unsafe extern "C" fn wasmtime_anyref_i31_get_s(
     anyref: Option<&wasmtime_anyref_t>,
     dst: &mut MaybeUninit<i32>,
 ) -> bool {
-    match anyref.and_then(|a| a.as_wasmtime()) {
-        Some(anyref) if anyref.is_i31(&cx).expect("OwnedRooted always in scope") => {
-            let val = anyref
-                .unwrap_i31(&cx)
-                .expect("OwnedRooted always in scope")
-                .get_i32();
-            crate::initialize(dst, val);
+    let i31 = anyref.and_then(|a| a.as_i31(&cx));
+    match i31 {
+        Some(i31) => {
+            crate::initialize(dst, i31.get_i32());
             true
         }
-        _ => false,
+        None => false,
     }
 }
 
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_anyref_is_array(
+    cx: WasmtimeStoreContext<'_>,
+    anyref: Option<&wasmtime_anyref_t>,
+) -> bool {
+    anyref
+        .and_then(|a| a.with_ref(|a| a.is_array(&cx).unwrap_or(false)))
+        .unwrap_or(false)
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_anyref_array_len(
+    cx: WasmtimeStoreContext<'_>,
+    anyref: Option<&wasmtime_anyref_t>,
+    len: &mut MaybeUninit<u32>,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = with_array(cx, anyref, |cx, a| a.len(cx));
+    handle_result(result, |l| crate::initialize(len, l))
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_anyref_array_data(
+    cx: WasmtimeStoreContext<'_>,
+    anyref: Option<&wasmtime_anyref_t>,
+    data: &mut MaybeUninit<*const u8>,
+    size: &mut MaybeUninit<usize>,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = with_array(cx, anyref, |cx, a| {
+        a.data(cx).map(|d| (d.as_ptr(), d.len()))
+    });
+    handle_result(result, |(ptr, len)| {
+        crate::initialize(data, ptr);
+        crate::initialize(size, len);
+    })
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_anyref_array_data_mut(
+    cx: WasmtimeStoreContextMut<'_>,
+    anyref: Option<&wasmtime_anyref_t>,
+    data: &mut MaybeUninit<*mut u8>,
+    size: &mut MaybeUninit<usize>,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = with_array(cx, anyref, |cx, a| {
+        a.data_mut(cx).map(|d| (d.as_mut_ptr(), d.len()))
+    });
+    handle_result(result, |(ptr, len)| {
+        crate::initialize(data, ptr);
+        crate::initialize(size, len);
+    })
+}
+
+/// Calls `f` with the array that `anyref` refers to, or returns an error if it
+/// isn't an array.
+unsafe fn with_array<C: AsContext, R>(
+    cx: C,
+    anyref: Option<&wasmtime_anyref_t>,
+    f: impl FnOnce(C, Rooted<ArrayRef>) -> wasmtime::Result<R>,
+) -> wasmtime::Result<R> {
+    anyref
+        .and_then(|a| {
+            a.with_ref(|a| match a.as_array(&cx)? {
+                Some(array) => f(cx, array),
+                None => Err(format_err!("anyref is not an array")),
+            })
+        })
+        .unwrap_or_else(|| Err(format_err!("anyref is not an array")))
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_externref_new(
     cx: WasmtimeStoreContextMut<'_>,
@@ -356,14 +591,48 @@ pub extern "C" fn wasmtime_externref_new(
     finalizer: Option<extern "C" fn(*mut c_void)>,
     out: &mut MaybeUninit<wasmtime_externref_t>,
 ) -> bool {
-    let mut scope = RootScope::new(cx);
-    let e = match ExternRef::new(&mut scope, crate::ForeignData { data, finalizer }) {
-        Ok(e) => e,
-        Err(_) => return false,
-    };
-    let e = e.to_owned_rooted(&mut scope).expect("in scope");
-    crate::initialize(out, Some(e).into());
-    true
+    let data = crate::ForeignData { data, finalizer };
+    match wasmtime_externref_t::new_with(cx, |cx| ExternRef::new(cx, data).map(Some)) {
+        Ok(e) => {
+            crate::initialize(out, e);
+            true
+        }
+        Err(_) => false,
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_externref_new_u64(
+    cx: WasmtimeStoreContextMut<'_>,
+    data: u64,
+    out: &mut MaybeUninit<wasmtime_externref_t>,
+) -> bool {
+    match wasmtime_externref_t::new_with(cx, |cx| ExternRef::new(cx, data).map(Some)) {
+        Ok(e) => {
+            crate::initialize(out, e);
+            true
+        }
+        Err(_) => false,
+    }
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_externref_u64(
+    cx: WasmtimeStoreContextMut<'_>,
+    externref: Option<&wasmtime_externref_t>,
+    dst: &mut MaybeUninit<u64>,
+) -> bool {
+    let data = externref.and_then(|e| {
+        e.with_ref(|e| e.data(cx).ok()??.downcast_ref::<u64>().copied())
+            .flatten()
+    });
+    match data {
+        Some(data) => {
+            crate::initialize(dst, data);
+            true
+        }
+        None => false,
+    }
 }
 
 #[unsafe(no_mangle)]
@@ -372,10 +641,12 @@ pub unsafe extern "C" fn wasmtime_externref_data(
     externref: Option<&wasmtime_externref_t>,
 ) -> *mut c_void {
     externref
-        .and_then(|e| e.as_wasmtime())
         .and_then(|e| {
-            let data = e.data(cx).ok()??;
-            Some(data.downcast_ref::<crate::ForeignData>().unwrap().data)
+            e.with_ref(|e| {
+                let data = e.data(cx).ok()??;
+                Some(data.downcast_ref::<crate::ForeignData>()?.data)
+            })
+            .flatten()
         })
         .unwrap_or(ptr::null_mut())
 }
@@ -385,8 +656,8 @@ pub unsafe extern "C" fn wasmtime_externref_clone(
     externref: Option<&wasmtime_externref_t>,
     out: &mut MaybeUninit<wasmtime_externref_t>,
 ) {
-    let externref = externref.and_then(|e| e.as_wasmtime());
-    crate::initialize(out, externref.into());
+    let externref = externref.map_or_else(wasmtime_externref_t::null, |e| e.clone_ref());
+    crate::initialize(out, externref);
 }
 
 #[unsafe(no_mangle)]
@@ -405,8 +676,7 @@ pub unsafe extern "C" fn wasmtime_externref_to_raw(
     cx: WasmtimeStoreContextMut<'_>,
     val: Option<&wasmtime_externref_t>,
 ) -> u32 {
-    val.and_then(|e| e.as_wasmtime())
-        .and_then(|e| e.to_raw(cx).ok())
+    val.and_then(|e| e.with_ref(|e| e.to_raw(cx).ok()).flatten())
         .unwrap_or_default()
 }
 
@@ -416,8 +686,138 @@ pub unsafe extern "C" fn wasmtime_externref_from_raw(
     raw: u32,
     val: &mut MaybeUninit<wasmtime_externref_t>,
 ) {
+    let Ok(externref) =
+        wasmtime_externref_t::new_with(cx, |cx| Ok::<_, Infallible>(ExternRef::from_raw(cx, raw)));
+    crate::initialize(val, externref);
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_exnref_new(
+    cx: WasmtimeStoreContextMut<'_>,
+    tag: &Tag,
+    fields: *const wasmtime_val_t,
+    nfields: usize,
+    out: &mut MaybeUninit<wasmtime_exnref_t>,
+) -> Option<Box<wasmtime_error_t>> {
+    let fields = crate::slice_from_raw_parts(fields, nfields);
+    let result = wasmtime_exnref_t::new_with(cx, |cx| {
+        let ty = ExnType::from_tag_type(&tag.ty(&*cx))?;
+        let allocator = ExnRefPre::new(&mut *cx, ty);
+        let fields = fields
+            .iter()
+            .map(|f| f.to_val_unscoped(&mut *cx))
+            .collect::<Vec<_>>();
+        ExnRef::new(cx, &allocator, tag, &fields).map(Some)
+    });
+    handle_result(result, |exnref| crate::initialize(out, exnref))
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_exnref_tag(
+    cx: WasmtimeStoreContextMut<'_>,
+    exnref: &wasmtime_exnref_t,
+    out: &mut MaybeUninit<Tag>,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = exnref
+        .with_ref(|e| e.tag(cx))
+        .unwrap_or_else(|| Err(format_err!("exnref is null")));
+    handle_result(result, |tag| crate::initialize(out, tag))
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_exnref_field_count(
+    cx: WasmtimeStoreContext<'_>,
+    exnref: &wasmtime_exnref_t,
+) -> usize {
+    exnref
+        .with_ref(|e| e.ty(cx).map(|ty| ty.fields().len()).ok())
+        .flatten()
+        .unwrap_or(0)
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_exnref_field(
+    cx: WasmtimeStoreContextMut<'_>,
+    exnref: &wasmtime_exnref_t,
+    index: usize,
+    out: &mut MaybeUninit<wasmtime_val_t>,
+) -> Option<Box<wasmtime_error_t>> {
     let mut scope = RootScope::new(cx);
-    let rooted = ExternRef::from_raw(&mut scope, raw)
-        .map(|e| e.to_owned_rooted(&mut scope).expect("in scope"));
-    crate::initialize(val, rooted.into());
+    let result = exnref
+        .with_ref(|e| e.field(&mut scope, index))
+        .unwrap_or_else(|| Err(format_err!("exnref is null")));
+    handle_result(result, |val| {
+        crate::initialize(out, wasmtime_val_t::from_val(&mut scope, val))
+    })
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_exnref_clone(
+    exnref: Option<&wasmtime_exnref_t>,
+    out: &mut MaybeUninit<wasmtime_exnref_t>,
+) {
+    let exnref = exnref.map_or_else(wasmtime_exnref_t::null, |e| e.clone_ref());
+    crate::initialize(out, exnref);
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_exnref_unroot(val: Option<&mut ManuallyDrop<wasmtime_exnref_t>>) {
+    if let Some(val) = val {
+        unsafe {
+            ManuallyDrop::drop(val);
+        }
+    }
+}
+
+/// Sets `exnref` as the store's pending exception and returns the trap which,
+/// when returned from a host function, throws it to WebAssembly. The trap
+/// carries no message or backtrace, only the marker that an exception is
+/// pending.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_context_throw(
+    mut cx: WasmtimeStoreContextMut<'_>,
+    exnref: &mut ManuallyDrop<wasmtime_exnref_t>,
+) -> Box<wasm_trap_t> {
+    let exnref = ManuallyDrop::take(exnref);
+    if cx.has_pending_exception() {
+        return Box::new(wasm_trap_t::new(format_err!(
+            "an exception is already pending in this store"
+        )));
+    }
+    let mut scope = RootScope::new(&mut cx);
+    let Some(rooted) = exnref.to_rooted_ref(&mut scope) else {
+        return Box::new(wasm_trap_t::new(format_err!("cannot throw a null exnref")));
+    };
+    let Err(thrown) = scope.as_context_mut().throw::<Infallible>(rooted);
+    Box::new(wasm_trap_t::new(thrown.into()))
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_context_has_pending_exception(cx: WasmtimeStoreContextMut<'_>) -> bool {
+    cx.has_pending_exception()
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_context_take_pending_exception(
+    cx: WasmtimeStoreContextMut<'_>,
+    out: &mut MaybeUninit<wasmtime_exnref_t>,
+) -> bool {
+    let Ok(exnref) =
+        wasmtime_exnref_t::new_with(cx, |cx| Ok::<_, Infallible>(cx.take_pending_exception()));
+    let taken = exnref.store_id != 0;
+    crate::initialize(out, exnref);
+    taken
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_root_scope_enter(mut cx: WasmtimeStoreContextMut<'_>) -> usize {
+    cx.data_mut().root_scopes += 1;
+    RootScope::enter_for_c_api(&mut cx)
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_root_scope_exit(mut cx: WasmtimeStoreContextMut<'_>, scope: usize) {
+    RootScope::exit_for_c_api(&mut cx, scope);
+    let data = cx.data_mut();
+    data.root_scopes = data.root_scopes.saturating_sub(1);
 }
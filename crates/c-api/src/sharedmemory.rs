@@ -1,6 +1,9 @@
 use crate::{handle_result, wasm_memorytype_t, wasmtime_error_t};
 use std::cell::UnsafeCell;
-use wasmtime::SharedMemory;
+use std::ffi::c_void;
+use std::sync::atomic::{AtomicU32, AtomicU64, Ordering::SeqCst};
+use std::time::Duration;
+use wasmtime::{SharedMemory, SharedMemoryEvent, Trap, WaitResult};
 
 type wasmtime_sharedmemory_t = SharedMemory;
 
@@ -58,3 +61,173 @@ pub extern "C" fn wasmtime_sharedmemory_grow(
 ) -> Option<Box<wasmtime_error_t>> {
     handle_result(mem.grow(delta), |prev| *prev_size = prev)
 }
+
+/// Returns a pointer to the `T` at byte offset `addr` within `mem`, checking
+/// it in the same way as the wasm `memory.atomic.*` instructions do.
+fn atomic_addr<T>(mem: &wasmtime_sharedmemory_t, addr: u64) -> Result<*mut T, Trap> {
+    let size = std::mem::size_of::<T>() as u64;
+    if addr % size != 0 {
+        return Err(Trap::HeapMisaligned);
+    }
+    let data = mem.data();
+    match addr.checked_add(size) {
+        Some(end) if end <= data.len() as u64 => Ok(data[addr as usize].get().cast()),
+        _ => Err(Trap::MemoryOutOfBounds),
+    }
+}
+
+macro_rules! atomic_accessors {
+    ($load:ident, $store:ident, $cmpxchg:ident, $ty:ty, $atomic:ty) => {
+        #[unsafe(no_mangle)]
+        pub extern "C" fn $load(
+            mem: &wasmtime_sharedmemory_t,
+            addr: u64,
+            ret: &mut $ty,
+        ) -> Option<Box<wasmtime_error_t>> {
+            let result = atomic_addr::<$ty>(mem, addr)
+                // SAFETY: the address is in bounds and aligned, and all
+                // accesses by wasm to shared memories are atomic.
+                .map(|ptr| unsafe { <$atomic>::from_ptr(ptr) }.load(SeqCst));
+            handle_result(result.map_err(Into::into), |value| *ret = value)
+        }
+
+        #[unsafe(no_mangle)]
+        pub extern "C" fn $store(
+            mem: &wasmtime_sharedmemory_t,
+            addr: u64,
+            value: $ty,
+        ) -> Option<Box<wasmtime_error_t>> {
+            let result = atomic_addr::<$ty>(mem, addr)
+                // SAFETY: see above.
+                .map(|ptr| unsafe { <$atomic>::from_ptr(ptr) }.store(value, SeqCst));
+            handle_result(result.map_err(Into::into), |()| {})
+        }
+
+        #[unsafe(no_mangle)]
+        pub extern "C" fn $cmpxchg(
+            mem: &wasmtime_sharedmemory_t,
+            addr: u64,
+            expected: $ty,
+            replacement: $ty,
+            ret: &mut $ty,
+        ) -> Option<Box<wasmtime_error_t>> {
+            let result = atomic_addr::<$ty>(mem, addr).map(|ptr| {
+                // SAFETY: see above.
+                let atomic = unsafe { <$atomic>::from_ptr(ptr) };
+                match atomic.compare_exchange(expected, replacement, SeqCst, SeqCst) {
+                    Ok(prev) | Err(prev) => prev,
+                }
+            });
+            handle_result(result.map_err(Into::into), |prev| *ret = prev)
+        }
+    };
+}
+
+atomic_accessors!(
+    wasmtime_sharedmemory_atomic_load32,
+    wasmtime_sharedmemory_atomic_store32,
+    wasmtime_sharedmemory_atomic_cmpxchg32,
+    u32,
+    AtomicU32
+);
+atomic_accessors!(
+    wasmtime_sharedmemory_atomic_load64,
+    wasmtime_sharedmemory_atomic_store64,
+    wasmtime_sharedmemory_atomic_cmpxchg64,
+    u64,
+    AtomicU64
+);
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_sharedmemory_atomic_notify(
+    mem: &wasmtime_sharedmemory_t,
+    addr: u64,
+    count: u32,
+    woken: &mut u32,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = mem.atomic_notify(addr, count);
+    handle_result(result.map_err(Into::into), |n| *woken = n)
+}
+
+pub type wasmtime_wait_result_t = u8;
+
+fn wait_result(result: WaitResult) -> wasmtime_wait_result_t {
+    match result {
+        WaitResult::Ok => 0,
+        WaitResult::Mismatch => 1,
+        WaitResult::TimedOut => 2,
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_sharedmemory_atomic_wait32(
+    mem: &wasmtime_sharedmemory_t,
+    addr: u64,
+    expected: u32,
+    timeout_nanos: Option<&u64>,
+    ret: &mut wasmtime_wait_result_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let timeout = timeout_nanos.map(|n| Duration::from_nanos(*n));
+    let result = mem.atomic_wait32(addr, expected, timeout);
+    handle_result(result.map_err(Into::into), |r| *ret = wait_result(r))
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_sharedmemory_atomic_wait64(
+    mem: &wasmtime_sharedmemory_t,
+    addr: u64,
+    expected: u64,
+    timeout_nanos: Option<&u64>,
+    ret: &mut wasmtime_wait_result_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let timeout = timeout_nanos.map(|n| Duration::from_nanos(*n));
+    let result = mem.atomic_wait64(addr, expected, timeout);
+    handle_result(result.map_err(Into::into), |r| *ret = wait_result(r))
+}
+
+pub const WASMTIME_SHAREDMEMORY_EVENT_WAIT: u8 = 0;
+pub const WASMTIME_SHAREDMEMORY_EVENT_NOTIFY: u8 = 1;
+
+#[repr(C)]
+pub struct wasmtime_sharedmemory_event_t {
+    kind: u8,
+    addr: u64,
+    count: u32,
+    woken: u32,
+}
+
+pub type wasmtime_sharedmemory_atomic_hook_t =
+    extern "C" fn(*mut c_void, *const wasmtime_sharedmemory_event_t);
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_sharedmemory_set_atomic_hook(
+    mem: &wasmtime_sharedmemory_t,
+    hook: Option<wasmtime_sharedmemory_atomic_hook_t>,
+    data: *mut c_void,
+    finalizer: Option<extern "C" fn(*mut c_void)>,
+) {
+    let foreign = crate::ForeignData { data, finalizer };
+    let Some(hook) = hook else {
+        mem.clear_atomic_hook();
+        return;
+    };
+    mem.set_atomic_hook(move |event| {
+        let _ = &foreign; // move `foreign` entirely into this closure
+        let event = match event {
+            SharedMemoryEvent::Wait { addr } => wasmtime_sharedmemory_event_t {
+                kind: WASMTIME_SHAREDMEMORY_EVENT_WAIT,
+                addr,
+                count: 0,
+                woken: 0,
+            },
+            SharedMemoryEvent::Notify { addr, count, woken } => wasmtime_sharedmemory_event_t {
+                kind: WASMTIME_SHAREDMEMORY_EVENT_NOTIFY,
+                addr,
+                count,
+                woken,
+            },
+            _ => return,
+        };
+        hook(foreign.data, &event);
+    });
+}
@@ -3,8 +3,8 @@ use std::cell::UnsafeCell;
 use std::ffi::c_void;
 use std::sync::Arc;
 use wasmtime::{
-    AsContext, AsContextMut, Caller, Store, StoreContext, StoreContextMut, StoreLimits,
-    StoreLimitsBuilder, UpdateDeadline, Val,
+    AsContext, AsContextMut, Caller, ResourceLimiter, Result, Store, StoreContext, StoreContextMut,
+    StoreLimits, StoreLimitsBuilder, UpdateDeadline, Val,
 };
 
 // Store-related type aliases for `wasm.h` APIs. Not for use with `wasmtime.h`
@@ -93,8 +93,272 @@ pub struct WasmtimeStoreData {
     /// for a different direction.
     pub wasm_val_storage: Vec<Val>,
 
-    /// Limits for the store.
-    pub store_limits: StoreLimits,
+    /// Limits for the store, which also track resource usage.
+    pub store_limits: CStoreLimiter,
+
+    /// Fuel most recently configured with `wasmtime_context_set_fuel`.
+    fuel_set: u64,
+
+    /// Fuel consumed prior to the most recent `wasmtime_context_set_fuel`.
+    fuel_consumed: u64,
+
+    /// Callback configured via `wasmtime_store_epoch_deadline_callback`, if
+    /// any.
+    epoch_deadline_callback: Option<EpochDeadlineCallback>,
+
+    /// The number of scopes entered with `wasmtime_root_scope_enter` and not
+    /// yet exited, within the current host function call if any. While this
+    /// is nonzero new `anyref`s and `externref`s are rooted in the innermost
+    /// scope rather than individually.
+    pub(crate) root_scopes: usize,
+
+    /// Waker of the future polling an in-progress async host function, handed
+    /// out by `wasmtime_caller_waker`.
+    #[cfg(feature = "async")]
+    pub(crate) async_waker: Option<std::task::Waker>,
+}
+
+type EpochDeadlineCallbackFn = extern "C" fn(
+    WasmtimeStoreContextMut<'_>,
+    *mut c_void,
+    *mut u64,
+    *mut wasmtime_update_deadline_kind_t,
+) -> Option<Box<wasmtime_error_t>>;
+
+struct EpochDeadlineCallback {
+    func: EpochDeadlineCallbackFn,
+    foreign: ForeignData,
+}
+
+impl WasmtimeStoreData {
+    fn new(foreign: ForeignData) -> WasmtimeStoreData {
+        WasmtimeStoreData {
+            foreign,
+            #[cfg(feature = "wasi")]
+            wasi: None,
+            hostcall_val_storage: Vec::new(),
+            wasm_val_storage: Vec::new(),
+            store_limits: CStoreLimiter::default(),
+            fuel_set: 0,
+            fuel_consumed: 0,
+            epoch_deadline_callback: None,
+            root_scopes: 0,
+            #[cfg(feature = "async")]
+            async_waker: None,
+        }
+    }
+}
+
+/// The resource limiter of a `wasmtime_store_t`.
+///
+/// This enforces the `StoreLimits` configured with `wasmtime_store_limiter`
+/// and additionally keeps a running total of the memory and table growth it
+/// has approved, which is reported by `wasmtime_context_resource_usage`.
+///
+/// It's only installed in the store once limits or limiter callbacks have
+/// been configured, so that stores without limits don't pay for a limiter
+/// call on every instantiation and growth.
+#[derive(Default)]
+pub struct CStoreLimiter {
+    pub(crate) limits: StoreLimits,
+    /// Whether limits have been configured with `wasmtime_store_limiter`.
+    limited: bool,
+    pub(crate) callbacks: Option<LimiterCallbacks>,
+    memory_bytes: usize,
+    table_elements: usize,
+    // Growth approved by the most recent `*_growing` call, rolled back if the
+    // runtime then reports that the growth failed.
+    pending_memory_bytes: usize,
+    pending_table_elements: usize,
+}
+
+pub type wasmtime_resource_growing_callback_t =
+    extern "C" fn(*mut c_void, usize, usize, i64, &mut bool) -> Option<Box<wasmtime_error_t>>;
+
+/// Embedder callbacks consulted by `CStoreLimiter` once the static limits
+/// have permitted a growth.
+pub(crate) enum LimiterCallbacks {
+    Sync {
+        memory_growing: Option<wasmtime_resource_growing_callback_t>,
+        table_growing: Option<wasmtime_resource_growing_callback_t>,
+        foreign: ForeignData,
+    },
+    #[cfg(feature = "async")]
+    Async {
+        memory_growing: Option<crate::wasmtime_resource_growing_async_callback_t>,
+        table_growing: Option<crate::wasmtime_resource_growing_async_callback_t>,
+        foreign: ForeignData,
+    },
+}
+
+/// Converts a limiter's `maximum` argument to the C representation, where a
+/// negative value means there is no maximum.
+pub(crate) fn c_maximum(maximum: Option<usize>) -> i64 {
+    match maximum {
+        Some(max) => i64::try_from(max).unwrap_or(i64::MAX),
+        None => -1,
+    }
+}
+
+impl CStoreLimiter {
+    /// Checks a growth request against the static limits configured with
+    /// `wasmtime_store_limiter`.
+    pub(crate) fn check_limits(
+        &mut self,
+        memory: bool,
+        current: usize,
+        desired: usize,
+        maximum: Option<usize>,
+    ) -> Result<bool> {
+        if memory {
+            self.pending_memory_bytes = 0;
+            self.limits.memory_growing(current, desired, maximum)
+        } else {
+            self.pending_table_elements = 0;
+            self.limits.table_growing(current, desired, maximum)
+        }
+    }
+
+    /// Records `desired - current` as approved growth, which is rolled back by
+    /// `grow_failed` if the runtime fails to actually perform it.
+    pub(crate) fn record_growth(&mut self, memory: bool, current: usize, desired: usize) {
+        let (total, pending) = if memory {
+            (&mut self.memory_bytes, &mut self.pending_memory_bytes)
+        } else {
+            (&mut self.table_elements, &mut self.pending_table_elements)
+        };
+        *pending = desired.saturating_sub(current);
+        *total += *pending;
+    }
+
+    pub(crate) fn grow_failed(&mut self, memory: bool) {
+        if memory {
+            self.memory_bytes -= std::mem::take(&mut self.pending_memory_bytes);
+        } else {
+            self.table_elements -= std::mem::take(&mut self.pending_table_elements);
+        }
+    }
+
+    pub(crate) fn growing(
+        &mut self,
+        memory: bool,
+        current: usize,
+        desired: usize,
+        maximum: Option<usize>,
+    ) -> Result<bool> {
+        if !self.check_limits(memory, current, desired, maximum)? {
+            return Ok(false);
+        }
+        let allowed = match &self.callbacks {
+            Some(LimiterCallbacks::Sync {
+                memory_growing,
+                table_growing,
+                foreign,
+            }) => {
+                let callback = if memory {
+                    memory_growing
+                } else {
+                    table_growing
+                };
+                match callback {
+                    Some(callback) => {
+                        let mut allowed = false;
+                        let max = c_maximum(maximum);
+                        let err = callback(foreign.data, current, desired, max, &mut allowed);
+                        if let Some(err) = err {
+                            return Err((*err).into());
+                        }
+                        allowed
+                    }
+                    None => true,
+                }
+            }
+            _ => true,
+        };
+        if allowed {
+            self.record_growth(memory, current, desired);
+        }
+        Ok(allowed)
+    }
+}
+
+impl ResourceLimiter for CStoreLimiter {
+    fn memory_growing(
+        &mut self,
+        current: usize,
+        desired: usize,
+        maximum: Option<usize>,
+    ) -> Result<bool> {
+        self.growing(true, current, desired, maximum)
+    }
+
+    fn memory_grow_failed(&mut self, error: wasmtime::Error) -> Result<()> {
+        self.grow_failed(true);
+        self.limits.memory_grow_failed(error)
+    }
+
+    fn table_growing(
+        &mut self,
+        current: usize,
+        desired: usize,
+        maximum: Option<usize>,
+    ) -> Result<bool> {
+        self.growing(false, current, desired, maximum)
+    }
+
+    fn table_grow_failed(&mut self, error: wasmtime::Error) -> Result<()> {
+        self.grow_failed(false);
+        self.limits.table_grow_failed(error)
+    }
+
+    fn instances(&self) -> usize {
+        self.limits.instances()
+    }
+
+    fn tables(&self) -> usize {
+        self.limits.tables()
+    }
+
+    fn memories(&self) -> usize {
+        self.limits.memories()
+    }
+}
+
+/// Installs the limiter and epoch deadline hooks recorded in the store's
+/// `WasmtimeStoreData` onto the store itself.
+pub(crate) fn install_store_hooks(store: &mut WasmtimeStore) {
+    let limits = &store.data().store_limits;
+    match (&limits.callbacks, limits.limited) {
+        #[cfg(feature = "async")]
+        (Some(LimiterCallbacks::Async { .. }), _) => {
+            store.limiter_async(|data| &mut data.store_limits);
+        }
+        (Some(_), _) | (None, true) => store.limiter(|data| &mut data.store_limits),
+        (None, false) => {}
+    }
+    if store.data().epoch_deadline_callback.is_some() {
+        store.epoch_deadline_callback(|mut store_ctx| {
+            let callback = store_ctx.data().epoch_deadline_callback.as_ref().unwrap();
+            let (func, data) = (callback.func, callback.foreign.data);
+            let mut delta: u64 = 0;
+            let mut kind = WASMTIME_UPDATE_DEADLINE_CONTINUE;
+            let result = func(
+                store_ctx.as_context_mut(),
+                data,
+                &mut delta as *mut u64,
+                &mut kind as *mut wasmtime_update_deadline_kind_t,
+            );
+            match result {
+                Some(err) => Err((*err).into()),
+                None if kind == WASMTIME_UPDATE_DEADLINE_CONTINUE => {
+                    Ok(UpdateDeadline::Continue(delta))
+                }
+                #[cfg(feature = "async")]
+                None if kind == WASMTIME_UPDATE_DEADLINE_YIELD => Ok(UpdateDeadline::Yield(delta)),
+                _ => panic!("unknown wasmtime_update_deadline_kind_t: {kind}"),
+            }
+        });
+    }
 }
 
 #[cfg(all(feature = "component-model", feature = "wasi"))]
@@ -110,19 +374,51 @@ pub extern "C" fn wasmtime_store_new(
     data: *mut c_void,
     finalizer: Option<extern "C" fn(*mut c_void)>,
 ) -> Box<wasmtime_store_t> {
-    Box::new(wasmtime_store_t {
-        store: Store::new(
-            &engine.engine,
-            WasmtimeStoreData {
-                foreign: ForeignData { data, finalizer },
-                #[cfg(feature = "wasi")]
-                wasi: None,
-                hostcall_val_storage: Vec::new(),
-                wasm_val_storage: Vec::new(),
-                store_limits: StoreLimits::default(),
-            },
-        ),
-    })
+    let mut store = Store::new(
+        &engine.engine,
+        WasmtimeStoreData::new(ForeignData { data, finalizer }),
+    );
+    install_store_hooks(&mut store);
+    Box::new(wasmtime_store_t { store })
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_store_reset(store: &mut wasmtime_store_t) {
+    let engine = store.store.engine().clone();
+    let placeholder = Store::new(
+        &engine,
+        WasmtimeStoreData::new(ForeignData {
+            data: std::ptr::null_mut(),
+            finalizer: None,
+        }),
+    );
+
+    // Tear down the old store, which releases all of its instances and
+    // GC roots (returning any pooling allocator slots to the pool), but
+    // keep the embedder-visible configuration in its data around.
+    let pooling_affinity = store.store.pooling_affinity();
+    let numa_node = store.store.numa_node();
+    let old = std::mem::replace(&mut store.store, placeholder);
+    let mut data = old.into_data();
+    #[cfg(feature = "wasi")]
+    {
+        data.wasi = None;
+    }
+    data.hostcall_val_storage.clear();
+    data.wasm_val_storage.clear();
+    data.store_limits = CStoreLimiter {
+        limits: data.store_limits.limits,
+        limited: data.store_limits.limited,
+        callbacks: data.store_limits.callbacks,
+        ..CStoreLimiter::default()
+    };
+    data.fuel_set = 0;
+    data.fuel_consumed = 0;
+    data.root_scopes = 0;
+    *store.store.data_mut() = data;
+    store.store.set_pooling_affinity(pooling_affinity);
+    store.store.set_numa_node(numa_node);
+    install_store_hooks(&mut store.store);
 }
 
 pub type wasmtime_update_deadline_kind_t = u8;
@@ -132,36 +428,13 @@ pub const WASMTIME_UPDATE_DEADLINE_YIELD: wasmtime_update_deadline_kind_t = 1;
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_store_epoch_deadline_callback(
     store: &mut wasmtime_store_t,
-    func: extern "C" fn(
-        WasmtimeStoreContextMut<'_>,
-        *mut c_void,
-        *mut u64,
-        *mut wasmtime_update_deadline_kind_t,
-    ) -> Option<Box<wasmtime_error_t>>,
+    func: EpochDeadlineCallbackFn,
     data: *mut c_void,
     finalizer: Option<extern "C" fn(*mut c_void)>,
 ) {
     let foreign = crate::ForeignData { data, finalizer };
-    store.store.epoch_deadline_callback(move |mut store_ctx| {
-        let _ = &foreign; // Move foreign into this closure
-        let mut delta: u64 = 0;
-        let mut kind = WASMTIME_UPDATE_DEADLINE_CONTINUE;
-        let result = (func)(
-            store_ctx.as_context_mut(),
-            foreign.data,
-            &mut delta as *mut u64,
-            &mut kind as *mut wasmtime_update_deadline_kind_t,
-        );
-        match result {
-            Some(err) => Err((*err).into()),
-            None if kind == WASMTIME_UPDATE_DEADLINE_CONTINUE => {
-                Ok(UpdateDeadline::Continue(delta))
-            }
-            #[cfg(feature = "async")]
-            None if kind == WASMTIME_UPDATE_DEADLINE_YIELD => Ok(UpdateDeadline::Yield(delta)),
-            _ => panic!("unknown wasmtime_update_deadline_kind_t: {kind}"),
-        }
-    });
+    store.store.data_mut().epoch_deadline_callback = Some(EpochDeadlineCallback { func, foreign });
+    install_store_hooks(&mut store.store);
 }
 
 #[unsafe(no_mangle)]
@@ -196,8 +469,26 @@ pub extern "C" fn wasmtime_store_limiter(
     if memories >= 0 {
         limiter = limiter.memories(memories as usize);
     }
-    store.store.data_mut().store_limits = limiter.build();
-    store.store.limiter(|data| &mut data.store_limits);
+    let limits = &mut store.store.data_mut().store_limits;
+    limits.limits = limiter.build();
+    limits.limited = true;
+    install_store_hooks(&mut store.store);
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_store_resource_limiter(
+    store: &mut wasmtime_store_t,
+    memory_growing: Option<wasmtime_resource_growing_callback_t>,
+    table_growing: Option<wasmtime_resource_growing_callback_t>,
+    data: *mut c_void,
+    finalizer: Option<extern "C" fn(*mut c_void)>,
+) {
+    store.store.data_mut().store_limits.callbacks = Some(LimiterCallbacks::Sync {
+        memory_growing,
+        table_growing,
+        foreign: ForeignData { data, finalizer },
+    });
+    install_store_hooks(&mut store.store);
 }
 
 #[unsafe(no_mangle)]
@@ -231,12 +522,48 @@ pub extern "C" fn wasmtime_context_gc(
     crate::handle_result(context.gc(None), |()| {})
 }
 
+#[repr(C)]
+pub struct wasmtime_gc_stats_t {
+    pub collections: u64,
+    pub total_pause_nanos: u64,
+    pub max_pause_nanos: u64,
+    pub bytes_freed: u64,
+    pub heap_grows: u64,
+    pub heap_size: u64,
+    pub allocated_bytes: u64,
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_context_gc_stats(
+    store: WasmtimeStoreContext<'_>,
+    stats: &mut wasmtime_gc_stats_t,
+) {
+    let gc = store.gc_stats();
+    let nanos = |d: std::time::Duration| u64::try_from(d.as_nanos()).unwrap_or(u64::MAX);
+    *stats = wasmtime_gc_stats_t {
+        collections: gc.collections,
+        total_pause_nanos: nanos(gc.total_pause),
+        max_pause_nanos: nanos(gc.max_pause),
+        bytes_freed: gc.bytes_freed,
+        heap_grows: gc.heap_grows,
+        heap_size: gc.heap_size,
+        allocated_bytes: gc.allocated_bytes,
+    };
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_context_set_fuel(
     mut store: WasmtimeStoreContextMut<'_>,
     fuel: u64,
 ) -> Option<Box<wasmtime_error_t>> {
-    crate::handle_result(store.set_fuel(fuel), |()| {})
+    let remaining = store.get_fuel();
+    crate::handle_result(store.set_fuel(fuel), |()| {
+        let data = store.data_mut();
+        if let Ok(remaining) = remaining {
+            data.fuel_consumed += data.fuel_set.saturating_sub(remaining);
+        }
+        data.fuel_set = fuel;
+    })
 }
 
 #[unsafe(no_mangle)]
@@ -249,6 +576,130 @@ pub extern "C" fn wasmtime_context_get_fuel(
     })
 }
 
+#[repr(C)]
+pub struct wasmtime_resource_usage_t {
+    pub memory_bytes: u64,
+    pub table_elements: u64,
+    pub instances: u64,
+    pub memories: u64,
+    pub tables: u64,
+    pub fuel_consumed: u64,
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_context_resource_usage(
+    store: WasmtimeStoreContext<'_>,
+    usage: &mut wasmtime_resource_usage_t,
+) {
+    let counts = store.resource_counts();
+    let data = store.data();
+    let fuel_consumed = match store.get_fuel() {
+        Ok(remaining) => data.fuel_consumed + data.fuel_set.saturating_sub(remaining),
+        Err(_) => 0,
+    };
+    *usage = wasmtime_resource_usage_t {
+        memory_bytes: data.store_limits.memory_bytes as u64,
+        table_elements: data.store_limits.table_elements as u64,
+        instances: counts.instances as u64,
+        memories: counts.memories as u64,
+        tables: counts.tables as u64,
+        fuel_consumed,
+    };
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_context_enable_cpu_accounting(
+    mut store: WasmtimeStoreContextMut<'_>,
+) -> Option<Box<wasmtime_error_t>> {
+    crate::handle_result(store.enable_cpu_accounting(), |()| {})
+}
+
+#[repr(C)]
+pub struct wasmtime_cpu_usage_t {
+    pub cpu_time_nanos: u64,
+    pub guest_cpu_time_nanos: u64,
+    pub instructions: u64,
+    pub has_instructions: bool,
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_context_cpu_usage(
+    store: WasmtimeStoreContext<'_>,
+    usage: &mut wasmtime_cpu_usage_t,
+) -> bool {
+    let nanos = |d: core::time::Duration| u64::try_from(d.as_nanos()).unwrap_or(u64::MAX);
+    match store.cpu_usage() {
+        Some(cpu) => {
+            *usage = wasmtime_cpu_usage_t {
+                cpu_time_nanos: nanos(cpu.cpu_time),
+                guest_cpu_time_nanos: nanos(cpu.guest_cpu_time),
+                instructions: cpu.instructions.unwrap_or(0),
+                has_instructions: cpu.instructions.is_some(),
+            };
+            true
+        }
+        None => false,
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_context_enter(
+    mut store: WasmtimeStoreContextMut<'_>,
+) -> Option<Box<wasmtime_error_t>> {
+    crate::handle_result(store.enter(), |()| {})
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_context_exit(
+    mut store: WasmtimeStoreContextMut<'_>,
+) -> Option<Box<wasmtime_error_t>> {
+    crate::handle_result(store.exit(), |()| {})
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_context_hibernate(
+    mut store: WasmtimeStoreContextMut<'_>,
+    saved_bytes: &mut usize,
+) -> Option<Box<wasmtime_error_t>> {
+    crate::handle_result(store.hibernate(), |saved| *saved_bytes = saved)
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_context_resume_from_hibernation(
+    mut store: WasmtimeStoreContextMut<'_>,
+) -> Option<Box<wasmtime_error_t>> {
+    crate::handle_result(store.resume_from_hibernation(), |()| {})
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_context_is_hibernating(store: WasmtimeStoreContext<'_>) -> bool {
+    store.is_hibernating()
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_context_set_pooling_affinity(
+    mut store: WasmtimeStoreContextMut<'_>,
+    key: u64,
+) {
+    store.set_pooling_affinity(if key == 0 { None } else { Some(key) });
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_context_set_numa_node(
+    mut store: WasmtimeStoreContextMut<'_>,
+    node: Option<&u32>,
+) {
+    store.set_numa_node(node.copied());
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_context_set_wasm_backtrace(
+    mut store: WasmtimeStoreContextMut<'_>,
+    enable: bool,
+) {
+    store.set_wasm_backtrace(enable);
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_context_set_epoch_deadline(
     mut store: WasmtimeStoreContextMut<'_>,
@@ -3,7 +3,7 @@ use crate::{
     wasm_store_t, wasm_tabletype_t, wasmtime_error_t, wasmtime_val_t,
 };
 use std::mem::MaybeUninit;
-use wasmtime::{Extern, Ref, RootScope, Table, TableType, format_err};
+use wasmtime::{AsContext, Extern, Ref, RootScope, Table, TableType, format_err};
 
 #[derive(Clone)]
 #[repr(transparent)]
@@ -172,6 +172,76 @@ pub unsafe extern "C" fn wasmtime_table_set(
     )
 }
 
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_table_get_range(
+    store: WasmtimeStoreContextMut<'_>,
+    table: &Table,
+    index: u64,
+    vals: *mut MaybeUninit<wasmtime_val_t>,
+    len: usize,
+) -> bool {
+    let mut scope = RootScope::new(store);
+    if !range_in_bounds(&scope, table, index, len) {
+        return false;
+    }
+    let vals = crate::slice_from_raw_parts_mut(vals, len);
+    for (index, ret) in (index..).zip(vals) {
+        let r = table.get(&mut scope, index).unwrap();
+        crate::initialize(ret, wasmtime_val_t::from_val(&mut scope, r.into()));
+    }
+    true
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_table_set_range(
+    mut store: WasmtimeStoreContextMut<'_>,
+    table: &Table,
+    index: u64,
+    vals: *const wasmtime_val_t,
+    len: usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let mut scope = RootScope::new(&mut store);
+    let vals = crate::slice_from_raw_parts(vals, len);
+    let result = if range_in_bounds(&scope, table, index, len) {
+        (index..).zip(vals).try_for_each(|(index, val)| {
+            val.to_val(&mut scope)
+                .ref_()
+                .ok_or_else(|| format_err!("wasmtime_table_set_range value is not a reference"))
+                .and_then(|val| table.set(&mut scope, index, val))
+        })
+    } else {
+        Err(format_err!("wasmtime_table_set_range range out of bounds"))
+    };
+    handle_result(result, |()| {})
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_table_fill(
+    mut store: WasmtimeStoreContextMut<'_>,
+    table: &Table,
+    index: u64,
+    val: &wasmtime_val_t,
+    len: u64,
+) -> Option<Box<wasmtime_error_t>> {
+    let mut scope = RootScope::new(&mut store);
+    handle_result(
+        val.to_val(&mut scope)
+            .ref_()
+            .ok_or_else(|| format_err!("wasmtime_table_fill value is not a reference"))
+            .and_then(|val| table.fill(scope, index, val, len)),
+        |()| {},
+    )
+}
+
+/// Returns whether the `len` elements of `table` starting at `index` are all
+/// in bounds.
+fn range_in_bounds(store: impl AsContext, table: &Table, index: u64, len: usize) -> bool {
+    u64::try_from(len)
+        .ok()
+        .and_then(|len| index.checked_add(len))
+        .is_some_and(|end| end <= table.size(store))
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_table_size(store: WasmtimeStoreContext<'_>, table: &Table) -> u64 {
     table.size(store)
@@ -0,0 +1,27 @@
+use crate::{
+    WasmtimeStoreContext, WasmtimeStoreContextMut, handle_result, wasm_functype_t, wasmtime_error_t,
+};
+use wasmtime::{Tag, TagType};
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_tag_new(
+    store: WasmtimeStoreContextMut<'_>,
+    ty: &wasm_functype_t,
+    ret: &mut Tag,
+) -> Option<Box<wasmtime_error_t>> {
+    let ty = TagType::new(ty.ty().ty(store.engine()));
+    handle_result(Tag::new(store, &ty), |tag| *ret = tag)
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_tag_type(
+    store: WasmtimeStoreContext<'_>,
+    tag: &Tag,
+) -> Box<wasm_functype_t> {
+    Box::new(wasm_functype_t::new(tag.ty(store).ty().clone()))
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_tag_eq(store: WasmtimeStoreContext<'_>, a: &Tag, b: &Tag) -> bool {
+    Tag::eq(a, b, store)
+}
@@ -1,5 +1,7 @@
 use crate::{wasm_frame_vec_t, wasm_instance_t, wasm_name_t, wasm_store_t};
 use std::cell::OnceCell;
+use std::ffi::{CStr, c_char};
+use std::fmt;
 use wasmtime::{Error, Trap, WasmBacktrace, format_err};
 
 // Help ensure the Rust enum matches the C one.  If any of these assertions
@@ -112,6 +114,69 @@ pub unsafe extern "C" fn wasmtime_trap_new_code(code: u8) -> Box<wasm_trap_t> {
     })
 }
 
+/// A trap created by `wasmtime_trap_new_static`, holding a code and a message
+/// which the embedder keeps alive forever so that neither needs copying.
+struct StaticTrap {
+    code: i32,
+    message: *const c_char,
+}
+
+// SAFETY: the message is never written to and lives forever, per the
+// documentation of `wasmtime_trap_new_static`.
+unsafe impl Send for StaticTrap {}
+unsafe impl Sync for StaticTrap {}
+
+impl StaticTrap {
+    fn message(&self) -> &CStr {
+        // SAFETY: see `wasmtime_trap_new_static`.
+        unsafe { CStr::from_ptr(self.message) }
+    }
+}
+
+impl fmt::Display for StaticTrap {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.write_str(&self.message().to_string_lossy())
+    }
+}
+
+impl fmt::Debug for StaticTrap {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("StaticTrap")
+            .field("code", &self.code)
+            .field("message", &self.message())
+            .finish()
+    }
+}
+
+impl core::error::Error for StaticTrap {}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_trap_new_static(
+    code: i32,
+    message: *const c_char,
+) -> Box<wasm_trap_t> {
+    Box::new(wasm_trap_t {
+        error: Error::new(StaticTrap { code, message }),
+    })
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_trap_static_code(raw: &wasm_trap_t, code: &mut i32) -> bool {
+    static_code(&raw.error, code)
+}
+
+/// Writes the code of `error` to `code` if it was created by
+/// `wasmtime_trap_new_static`, returning whether it was.
+pub(crate) fn static_code(error: &Error, code: &mut i32) -> bool {
+    match error.downcast_ref::<StaticTrap>() {
+        Some(trap) => {
+            *code = trap.code;
+            true
+        }
+        None => false,
+    }
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasm_trap_message(trap: &wasm_trap_t, out: &mut wasm_message_t) {
     let mut buffer = Vec::new();
@@ -37,6 +37,7 @@ pub(crate) fn into_valtype(kind: wasm_valkind_t) -> ValType {
         WASM_EXTERNREF => ValType::EXTERNREF,
         WASM_FUNCREF => ValType::FUNCREF,
         WASMTIME_V128 => ValType::V128,
+        WASMTIME_ANYREF => ValType::ANYREF,
         _ => panic!("unexpected kind: {kind}"),
     }
 }
@@ -51,6 +52,9 @@ pub(crate) fn from_valtype(ty: &ValType) -> wasm_valkind_t {
         ValType::Ref(r) => match (r.is_nullable(), r.heap_type()) {
             (true, HeapType::Extern) => WASM_EXTERNREF,
             (true, HeapType::Func) => WASM_FUNCREF,
+            // The abstract types which `i31ref`s inhabit are all reported as
+            // `anyref`, so that `i31ref`s can be passed to any of them.
+            (true, HeapType::Any | HeapType::Eq | HeapType::I31) => WASMTIME_ANYREF,
             _ => crate::abort("support for non-externref and non-funcref references"),
         },
     }
@@ -253,7 +253,7 @@ impl wasmtime_val_t {
             Val::AnyRef(a) => wasmtime_val_t {
                 kind: crate::WASMTIME_ANYREF,
                 of: wasmtime_val_union {
-                    anyref: ManuallyDrop::new(a.and_then(|a| a.to_owned_rooted(cx).ok()).into()),
+                    anyref: ManuallyDrop::new(wasmtime_anyref_t::from_rooted(cx, a)),
                 },
             },
             Val::ExternRef(e) => wasmtime_val_t {
@@ -301,12 +301,8 @@ impl wasmtime_val_t {
             crate::WASMTIME_F32 => Val::F32(self.of.f32),
             crate::WASMTIME_F64 => Val::F64(self.of.f64),
             crate::WASMTIME_V128 => Val::V128(u128::from_le_bytes(self.of.v128).into()),
-            crate::WASMTIME_ANYREF => {
-                Val::AnyRef(self.of.anyref.as_wasmtime().map(|a| a.to_rooted(cx)))
-            }
-            crate::WASMTIME_EXTERNREF => {
-                Val::ExternRef(self.of.externref.as_wasmtime().map(|e| e.to_rooted(cx)))
-            }
+            crate::WASMTIME_ANYREF => Val::AnyRef(self.of.anyref.to_rooted(cx)),
+            crate::WASMTIME_EXTERNREF => Val::ExternRef(self.of.externref.to_rooted(cx)),
             crate::WASMTIME_FUNCREF => Val::FuncRef(self.of.funcref.as_wasmtime()),
             other => panic!("unknown wasmtime_valkind_t: {other}"),
         }
@@ -325,10 +321,10 @@ pub unsafe extern "C" fn wasmtime_val_clone(
 ) {
     let of = match src.kind {
         crate::WASMTIME_ANYREF => wasmtime_val_union {
-            anyref: ManuallyDrop::new(src.of.anyref.as_wasmtime().into()),
+            anyref: ManuallyDrop::new(src.of.anyref.clone_ref()),
         },
         crate::WASMTIME_EXTERNREF => wasmtime_val_union {
-            externref: ManuallyDrop::new(src.of.externref.as_wasmtime().into()),
+            externref: ManuallyDrop::new(src.of.externref.clone_ref()),
         },
         crate::WASMTIME_I32 => wasmtime_val_union { i32: src.of.i32 },
         crate::WASMTIME_I64 => wasmtime_val_union { i64: src.of.i64 },
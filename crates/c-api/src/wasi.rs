@@ -2,11 +2,14 @@
 
 use crate::wasm_byte_vec_t;
 use bytes::Bytes;
+use std::collections::VecDeque;
 use std::ffi::{CStr, c_char, c_void};
 use std::fs::File;
+use std::mem;
 use std::path::Path;
 use std::pin::Pin;
 use std::slice;
+use std::sync::{Arc, Mutex};
 use std::task::{Context, Poll};
 use tokio::io::{self, AsyncWrite};
 use wasmtime::Result;
@@ -295,6 +298,127 @@ pub extern "C" fn wasi_config_set_stderr_custom(
     ));
 }
 
+/// A bounded in-memory buffer of a guest's stdout or stderr which keeps the
+/// most recent output, dropping the oldest bytes once full.
+#[derive(Clone)]
+pub struct wasi_output_buffer_t {
+    inner: Arc<Mutex<OutputBuffer>>,
+}
+
+wasmtime_c_api_macros::declare_own!(wasi_output_buffer_t);
+
+struct OutputBuffer {
+    data: VecDeque<u8>,
+    capacity: usize,
+    dropped: u64,
+}
+
+impl wasi_output_buffer_t {
+    fn write(&self, bufs: &[&[u8]]) -> usize {
+        let mut buffer = self.inner.lock().unwrap();
+        let mut total = 0;
+        for buf in bufs {
+            total += buf.len();
+            let keep = &buf[buf.len().saturating_sub(buffer.capacity)..];
+            let overflow = (buffer.data.len() + keep.len()).saturating_sub(buffer.capacity);
+            buffer.data.drain(..overflow);
+            buffer.data.extend(keep);
+            buffer.dropped += (overflow + buf.len() - keep.len()) as u64;
+        }
+        total
+    }
+}
+
+#[async_trait::async_trait]
+impl wasmtime_wasi::p2::Pollable for wasi_output_buffer_t {
+    async fn ready(&mut self) {}
+}
+
+#[async_trait::async_trait]
+impl wasmtime_wasi::p2::OutputStream for wasi_output_buffer_t {
+    fn write(&mut self, bytes: Bytes) -> Result<(), StreamError> {
+        wasi_output_buffer_t::write(self, &[&bytes]);
+        Ok(())
+    }
+    fn flush(&mut self) -> Result<(), StreamError> {
+        Ok(())
+    }
+    fn check_write(&mut self) -> Result<usize, StreamError> {
+        Ok(usize::MAX)
+    }
+    fn blocking_write_vectored(&mut self, bufs: &[&[u8]]) -> Option<Result<usize, StreamError>> {
+        Some(Ok(wasi_output_buffer_t::write(self, bufs)))
+    }
+}
+
+impl AsyncWrite for wasi_output_buffer_t {
+    fn poll_write(
+        self: Pin<&mut Self>,
+        _cx: &mut Context<'_>,
+        buf: &[u8],
+    ) -> Poll<io::Result<usize>> {
+        Poll::Ready(Ok(self.write(&[buf])))
+    }
+    fn poll_flush(self: Pin<&mut Self>, _cx: &mut Context<'_>) -> Poll<io::Result<()>> {
+        Poll::Ready(Ok(()))
+    }
+    fn poll_shutdown(self: Pin<&mut Self>, _cx: &mut Context<'_>) -> Poll<io::Result<()>> {
+        Poll::Ready(Ok(()))
+    }
+}
+
+impl wasmtime_wasi::cli::IsTerminal for wasi_output_buffer_t {
+    fn is_terminal(&self) -> bool {
+        false
+    }
+}
+
+impl wasmtime_wasi::cli::StdoutStream for wasi_output_buffer_t {
+    fn async_stream(&self) -> Box<dyn AsyncWrite + Send + Sync> {
+        Box::new(self.clone())
+    }
+    fn p2_stream(&self) -> Box<dyn wasmtime_wasi::p2::OutputStream> {
+        Box::new(self.clone())
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasi_output_buffer_new(capacity: usize) -> Box<wasi_output_buffer_t> {
+    Box::new(wasi_output_buffer_t {
+        inner: Arc::new(Mutex::new(OutputBuffer {
+            data: VecDeque::new(),
+            capacity,
+            dropped: 0,
+        })),
+    })
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasi_output_buffer_take(
+    buffer: &wasi_output_buffer_t,
+    out: &mut wasm_byte_vec_t,
+) -> u64 {
+    let mut buffer = buffer.inner.lock().unwrap();
+    out.set_buffer(buffer.data.drain(..).collect());
+    mem::take(&mut buffer.dropped)
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasi_config_set_stdout_buffer(
+    config: &mut wasi_config_t,
+    buffer: &wasi_output_buffer_t,
+) {
+    config.builder.stdout(buffer.clone());
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasi_config_set_stderr_buffer(
+    config: &mut wasi_config_t,
+    buffer: &wasi_output_buffer_t,
+) {
+    config.builder.stderr(buffer.clone());
+}
+
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn wasi_config_preopen_dir(
     config: &mut wasi_config_t,
@@ -328,3 +452,93 @@ pub unsafe extern "C" fn wasi_config_preopen_dir(
         .preopened_dir(host_path, guest_path, dir_perms, file_perms)
         .is_ok()
 }
+
+pub struct wasi_shared_dir_t {
+    dir: wasmtime_wasi::filesystem::SharedDir,
+}
+
+wasmtime_c_api_macros::declare_own!(wasi_shared_dir_t);
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasi_shared_dir_new(
+    path: *const c_char,
+) -> Option<Box<wasi_shared_dir_t>> {
+    let dir = wasmtime_wasi::filesystem::SharedDir::new(cstr_to_path(path)?).ok()?;
+    Some(Box::new(wasi_shared_dir_t { dir }))
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasi_config_preopen_shared_dir(
+    config: &mut wasi_config_t,
+    dir: &wasi_shared_dir_t,
+    guest_path: *const c_char,
+) -> bool {
+    let guest_path = match cstr_to_str(guest_path) {
+        Some(p) => p,
+        None => return false,
+    };
+
+    config.builder.preopened_shared_dir(&dir.dir, guest_path);
+    true
+}
+
+pub struct wasi_archive_t {
+    archive: wasmtime_wasi::filesystem::Archive,
+}
+
+wasmtime_c_api_macros::declare_own!(wasi_archive_t);
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasi_archive_new(
+    data: *const u8,
+    len: usize,
+) -> Option<Box<wasi_archive_t>> {
+    let data = crate::slice_from_raw_parts(data, len).to_vec();
+    let archive = wasmtime_wasi::filesystem::Archive::new(data).ok()?;
+    Some(Box::new(wasi_archive_t { archive }))
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasi_archive_open(path: *const c_char) -> Option<Box<wasi_archive_t>> {
+    let archive = wasmtime_wasi::filesystem::Archive::open(cstr_to_path(path)?).ok()?;
+    Some(Box::new(wasi_archive_t { archive }))
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasi_config_preopen_archive(
+    config: &mut wasi_config_t,
+    archive: &wasi_archive_t,
+    guest_path: *const c_char,
+) -> bool {
+    let guest_path = match cstr_to_str(guest_path) {
+        Some(p) => p,
+        None => return false,
+    };
+
+    config
+        .builder
+        .preopened_archive(&archive.archive, guest_path);
+    true
+}
+
+pub struct wasi_config_template_t {
+    template: wasmtime_wasi::WasiCtxTemplate,
+}
+
+wasmtime_c_api_macros::declare_own!(wasi_config_template_t);
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasi_config_template_new(config: &wasi_config_t) -> Box<wasi_config_template_t> {
+    Box::new(wasi_config_template_t {
+        template: config.builder.template(),
+    })
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasi_config_new_from_template(
+    template: &wasi_config_template_t,
+) -> Box<wasi_config_t> {
+    Box::new(wasi_config_t {
+        builder: template.template.builder(),
+    })
+}
@@ -0,0 +1,271 @@
+#include <array>
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <wasmtime/async.hh>
+
+#if defined(WASMTIME_FEATURE_ASYNC) && defined(__cpp_lib_coroutine)
+
+using namespace wasmtime;
+
+namespace {
+
+const char *SUM = R"(
+  (module
+    (func (export "sum") (param $n i32) (result i32)
+      (local $sum i32)
+      (loop $l
+        (local.set $sum (i32.add (local.get $sum) (local.get $n)))
+        (br_if $l (local.tee $n (i32.sub (local.get $n) (i32.const 1)))))
+      (local.get $sum))
+  )
+)";
+
+Task<int32_t> sum(Engine &engine, Store &store, const Module &module,
+                  Executor &executor, int32_t n) {
+  Store::Context cx = store;
+  Linker linker(engine);
+  auto instance =
+      (co_await linker.instantiate_async(cx, module, executor)).unwrap();
+  auto f = std::get<Func>(*instance.get(cx, "sum"));
+  std::vector<Val> params = {n};
+  auto results =
+      (co_await f.call_async(cx, std::move(params), executor)).unwrap();
+  co_return results[0].i32();
+}
+
+// Returns whether calling the export "f" of `module` traps.
+Task<bool> call_traps(Engine &engine, Store &store, const Module &module,
+                      Executor &executor) {
+  Store::Context cx = store;
+  Linker linker(engine);
+  auto instance =
+      (co_await linker.instantiate_async(cx, module, executor)).unwrap();
+  auto f = std::get<Func>(*instance.get(cx, "f"));
+  auto results = co_await f.call_async(cx, std::vector<Val>(), executor);
+  co_return !results;
+}
+
+const char *DOUBLE = R"(
+  (module
+    (import "host" "double" (func $double (param i32) (result i32)))
+    (func (export "run") (param i32) (result i32)
+      (call $double (local.get 0)))
+  )
+)";
+
+Task<int32_t> call_run(Linker &linker, Store &store, const Module &module,
+                       Executor &executor, int32_t n) {
+  Store::Context cx = store;
+  auto instance =
+      (co_await linker.instantiate_async(cx, module, executor)).unwrap();
+  auto f = std::get<Func>(*instance.get(cx, "run"));
+  std::vector<Val> params = {n};
+  auto results =
+      (co_await f.call_async(cx, std::move(params), executor)).unwrap();
+  co_return results[0].i32();
+}
+
+// Like `sum`, but records the result in `*result` and then increments
+// `finished`, for tasks run on other threads.
+Task<int32_t> sum_counted(Engine &engine, Store &store, const Module &module,
+                          Executor &executor, int32_t n, int32_t *result,
+                          std::atomic<size_t> &finished) {
+  *result = co_await sum(engine, store, module, executor, n);
+  finished++;
+  co_return *result;
+}
+
+Store yielding_store(Engine &engine) {
+  Store store(engine);
+  store.context().set_fuel(1'000'000'000).unwrap();
+  wasmtime_context_fuel_async_yield_interval(store.context().capi(), 100);
+  return store;
+}
+
+} // namespace
+
+TEST(Async, CallAwaitable) {
+  Config config;
+  config.consume_fuel(true);
+  Engine engine(std::move(config));
+  Module module = Module::compile(engine, SUM).unwrap();
+
+  PollingExecutor executor;
+  Store a = yielding_store(engine);
+  Store b = yielding_store(engine);
+  Task<int32_t> ta = sum(engine, a, module, executor, 1000);
+  Task<int32_t> tb = sum(engine, b, module, executor, 2000);
+
+  // Both calls yield for fuel, so neither can complete until the executor
+  // interleaves them.
+  EXPECT_FALSE(ta.done());
+  EXPECT_FALSE(tb.done());
+  EXPECT_FALSE(executor.empty());
+
+  executor.run();
+  ASSERT_TRUE(ta.done());
+  ASSERT_TRUE(tb.done());
+  EXPECT_EQ(ta.result(), 500500);
+  EXPECT_EQ(tb.result(), 2001000);
+}
+
+TEST(Async, CallTrap) {
+  Engine engine;
+  Module module =
+      Module::compile(engine, "(module (func (export \"f\") unreachable))")
+          .unwrap();
+  Store store(engine);
+  PollingExecutor executor;
+
+  Task<bool> task = call_traps(engine, store, module, executor);
+  executor.run();
+  ASSERT_TRUE(task.done());
+  EXPECT_TRUE(task.result());
+}
+
+TEST(Async, Waker) {
+  Config config;
+  config.consume_fuel(true);
+  Engine engine(std::move(config));
+  Module module = Module::compile(engine, SUM).unwrap();
+  Store store = yielding_store(engine);
+  Store::Context cx = store;
+  Instance instance = Linker(engine).instantiate(cx, module).unwrap();
+  Func f = std::get<Func>(*instance.get(cx, "sum"));
+
+  size_t wakes = 0;
+  std::array<Val, 1> params = {int32_t(1000)};
+  std::array<Val, 1> results = {int32_t(0)};
+  wasm_trap_t *trap = nullptr;
+  wasmtime_error_t *error = nullptr;
+  CallFuture future(wasmtime_func_call_async(
+      cx.capi(), &f.capi(),
+      reinterpret_cast<const wasmtime_val_t *>(params.data()), params.size(),
+      reinterpret_cast<wasmtime_val_t *>(results.data()), results.size(),
+      &trap, &error));
+  wasmtime_call_future_set_waker(
+      future.capi(), [](void *env) { ++*static_cast<size_t *>(env); }, &wakes,
+      nullptr);
+
+  // Each yield for fuel wakes the future, so it's only ever polled after it
+  // has been woken.
+  size_t polls = 1;
+  while (!future.poll()) {
+    EXPECT_GE(wakes, polls);
+    polls++;
+  }
+  EXPECT_GT(polls, 1);
+  EXPECT_EQ(trap, nullptr);
+  EXPECT_EQ(error, nullptr);
+  EXPECT_EQ(results[0].i32(), 500500);
+}
+
+TEST(Async, Cancel) {
+  Config config;
+  config.consume_fuel(true);
+  wasmtime_config_async_stack_cache_size_set(config.capi(), 1);
+  Engine engine(std::move(config));
+  Module module = Module::compile(engine, SUM).unwrap();
+  Store store = yielding_store(engine);
+  Store::Context cx = store;
+  Instance instance = Linker(engine).instantiate(cx, module).unwrap();
+  Func f = std::get<Func>(*instance.get(cx, "sum"));
+
+  std::array<Val, 1> params = {int32_t(1000)};
+  std::array<Val, 1> results = {int32_t(0)};
+  wasm_trap_t *trap = nullptr;
+  wasmtime_error_t *error = nullptr;
+  CallFuture future(wasmtime_func_call_async(
+      cx.capi(), &f.capi(),
+      reinterpret_cast<const wasmtime_val_t *>(params.data()), params.size(),
+      reinterpret_cast<wasmtime_val_t *>(results.data()), results.size(),
+      &trap, &error));
+  ASSERT_FALSE(future.poll());
+
+  // The suspended guest is unwound, and its stack released, by `cancel`
+  // rather than when the future is deleted.
+  EXPECT_EQ(engine.async_stack_cache_stats()->cached_stacks, 0);
+  future.cancel();
+  EXPECT_EQ(engine.async_stack_cache_stats()->cached_stacks, 1);
+  EXPECT_TRUE(future.poll());
+  EXPECT_EQ(trap, nullptr);
+  EXPECT_EQ(error, nullptr);
+  EXPECT_EQ(results[0].i32(), 0);
+
+  // The store remains usable afterwards.
+  PollingExecutor executor;
+  Task<int32_t> task = sum(engine, store, module, executor, 10);
+  executor.run();
+  EXPECT_EQ(task.result(), 55);
+}
+
+TEST(Async, HostFunc) {
+  Engine engine;
+  Module module = Module::compile(engine, DOUBLE).unwrap();
+  Linker linker(engine);
+  std::optional<AsyncCompletion> pending;
+  int32_t arg = 0;
+  linker
+      .func_new_async("host", "double",
+                      FuncType({ValKind::I32}, {ValKind::I32}),
+                      [&](Caller, Span<const Val> args, AsyncCompletion c) {
+                        arg = args[0].i32();
+                        pending.emplace(std::move(c));
+                      })
+      .unwrap();
+
+  Store store(engine);
+  PollingExecutor executor;
+  Task<int32_t> task = call_run(linker, store, module, executor, 21);
+
+  // The guest stays suspended in the host function until its completion is
+  // signalled, here from another thread.
+  ASSERT_TRUE(pending);
+  EXPECT_FALSE(task.done());
+  std::thread([&] {
+    pending->complete(std::vector<Val>{arg * 2});
+  }).join();
+
+  executor.run();
+  ASSERT_TRUE(task.done());
+  EXPECT_EQ(task.result(), 42);
+}
+
+TEST(Async, ThreadPoolExecutor) {
+  Config config;
+  config.consume_fuel(true);
+  Engine engine(std::move(config));
+  Module module = Module::compile(engine, SUM).unwrap();
+
+  constexpr size_t N = 16;
+  std::vector<Store> stores;
+  std::vector<Task<int32_t>> tasks;
+  std::array<int32_t, N> results = {};
+  std::atomic<size_t> finished{0};
+  stores.reserve(N);
+  tasks.reserve(N);
+  {
+    ThreadPoolExecutor executor(4);
+    for (size_t i = 0; i < N; i++) {
+      stores.push_back(yielding_store(engine));
+      tasks.push_back(sum_counted(engine, stores[i], module, executor,
+                                  int32_t(1000 * (i + 1)), &results[i],
+                                  finished));
+    }
+    while (finished.load() < N) {
+      std::this_thread::yield();
+    }
+    EXPECT_EQ(executor.worker_queue_depths().size(), 4);
+    // Joining the workers here ensures they're done with the tasks before
+    // they're inspected.
+  }
+
+  for (size_t i = 0; i < N; i++) {
+    int64_t n = 1000 * (i + 1);
+    ASSERT_TRUE(tasks[i].done());
+    EXPECT_EQ(results[i], n * (n + 1) / 2);
+  }
+}
+
+#endif // WASMTIME_FEATURE_ASYNC && __cpp_lib_coroutine
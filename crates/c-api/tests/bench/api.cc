@@ -0,0 +1,280 @@
+// Benchmarks of the overhead of the C++ API itself, using Google Benchmark.
+//
+// These measure the wrappers around calls, instantiation, memory accesses and
+// component values, rather than the wasm being run, so that regressions such
+// as extra allocations in `Func::call` show up. Components use the same
+// component as `benches/component.rs`, whose path is passed in as
+// `SHAPES_WAT`. It's built as the `bench-api` target when `BUILD_BENCHMARKS`
+// is enabled and isn't run as part of the test suite.
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <wasmtime.hh>
+#include <wasmtime/component.hh>
+
+using namespace wasmtime;
+
+namespace {
+
+constexpr const char *WAT = R"(
+  (module
+    (memory (export "memory") 1)
+    (func (export "nop"))
+    (func (export "add") (param i32 i32) (result i32)
+      (i32.add (local.get 0) (local.get 1))))
+)";
+
+// A store with an instance of `WAT`.
+struct Core {
+  Engine engine;
+  Module module;
+  Store store;
+  Instance instance;
+
+  Core()
+      : module(Module::compile(engine, WAT).unwrap()), store(engine),
+        instance(Instance::create(store, module, {}).unwrap()) {}
+
+  Func func(std::string_view name) {
+    return std::get<Func>(*instance.get(store, name));
+  }
+};
+
+void FuncCallNop(benchmark::State &state) {
+  Core core;
+  Func nop = core.func("nop");
+  for (auto _ : state) {
+    nop.call(core.store, {}).unwrap();
+  }
+}
+BENCHMARK(FuncCallNop);
+
+void FuncCallAdd(benchmark::State &state) {
+  Core core;
+  Func add = core.func("add");
+  for (auto _ : state) {
+    auto results = add.call(core.store, {Val(1), Val(2)}).unwrap();
+    benchmark::DoNotOptimize(results);
+  }
+}
+BENCHMARK(FuncCallAdd);
+
+void FuncCallAddSpan(benchmark::State &state) {
+  Core core;
+  Func add = core.func("add");
+  std::array<Val, 2> params = {Val(1), Val(2)};
+  std::array<Val, 1> results = {Val(0)};
+  for (auto _ : state) {
+    add.call(core.store, params, results).unwrap();
+    benchmark::DoNotOptimize(results);
+  }
+}
+BENCHMARK(FuncCallAddSpan);
+
+void TypedFuncCallNop(benchmark::State &state) {
+  Core core;
+  auto nop = core.func("nop")
+                 .typed<std::monostate, std::monostate>(core.store)
+                 .unwrap();
+  for (auto _ : state) {
+    nop.call(core.store, {}).unwrap();
+  }
+}
+BENCHMARK(TypedFuncCallNop);
+
+void TypedFuncCallAdd(benchmark::State &state) {
+  Core core;
+  auto add = core.func("add")
+                 .typed<std::tuple<int32_t, int32_t>, int32_t>(core.store)
+                 .unwrap();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(add.call(core.store, {1, 2}).unwrap());
+  }
+}
+BENCHMARK(TypedFuncCallAdd);
+
+// Each iteration instantiates into a new store, so stores don't accumulate
+// instances, and so includes the cost of creating and dropping the store.
+void LinkerInstantiate(benchmark::State &state) {
+  Core core;
+  Linker linker(core.engine);
+  for (auto _ : state) {
+    Store store(core.engine);
+    benchmark::DoNotOptimize(
+        linker.instantiate(store, core.module).unwrap());
+  }
+}
+BENCHMARK(LinkerInstantiate);
+
+void InstancePreInstantiate(benchmark::State &state) {
+  Core core;
+  auto pre = Linker(core.engine).instantiate_pre(core.module).unwrap();
+  for (auto _ : state) {
+    Store store(core.engine);
+    benchmark::DoNotOptimize(pre.instantiate(store).unwrap());
+  }
+}
+BENCHMARK(InstancePreInstantiate);
+
+void MemoryRead(benchmark::State &state) {
+  Core core;
+  auto memory = std::get<Memory>(*core.instance.get(core.store, "memory"));
+  std::vector<uint8_t> buf(state.range(0));
+  for (auto _ : state) {
+    memory.read(core.store, 0, buf).unwrap();
+    benchmark::DoNotOptimize(buf.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(MemoryRead)->Arg(8)->Arg(4096);
+
+void MemoryWrite(benchmark::State &state) {
+  Core core;
+  auto memory = std::get<Memory>(*core.instance.get(core.store, "memory"));
+  std::vector<uint8_t> buf(state.range(0));
+  for (auto _ : state) {
+    memory.write(core.store, 0, buf).unwrap();
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(MemoryWrite)->Arg(8)->Arg(4096);
+
+void MemoryData(benchmark::State &state) {
+  Core core;
+  auto memory = std::get<Memory>(*core.instance.get(core.store, "memory"));
+  for (auto _ : state) {
+    auto data = memory.data(core.store);
+    data[0]++;
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(MemoryData);
+
+// The number of characters in strings, and elements in lists, which are
+// passed to and from components.
+constexpr size_t LEN = 100;
+
+// A store with an instance of the `SHAPES_WAT` component, whose imports just
+// echo their arguments.
+struct Shapes {
+  Engine engine;
+  component::Component component;
+  Store store;
+  component::Instance instance;
+
+  static std::string wat() {
+    std::ifstream file(SHAPES_WAT);
+    std::stringstream wat;
+    wat << file.rdbuf();
+    return wat.str();
+  }
+
+  static component::Linker linker(Engine &engine) {
+    component::Linker linker(engine);
+    auto root = linker.root();
+    root.add_resource("r", component::ResourceType(1),
+                      [](Store::Context, uint32_t) -> Result<std::monostate> {
+                        return std::monostate();
+                      })
+        .unwrap();
+    for (auto name : {"host-string", "host-list", "host-record"}) {
+      root.add_func(name,
+                    [](Store::Context, const component::FuncType &,
+                       Span<component::Val> args,
+                       Span<component::Val> results) -> Result<std::monostate> {
+                      results[0] = args[0];
+                      return std::monostate();
+                    })
+          .unwrap();
+    }
+    return linker;
+  }
+
+  Shapes()
+      : component(component::Component::compile(engine, wat()).unwrap()),
+        store(engine),
+        instance(linker(engine).instantiate(store, component).unwrap()) {}
+
+  component::Func func(std::string_view name) {
+    return *instance.get_func(store, *component.export_index(nullptr, name));
+  }
+};
+
+component::Val list_val() {
+  std::vector<component::Val> elems;
+  for (uint32_t i = 0; i < LEN; i++) {
+    elems.emplace_back(i);
+  }
+  return component::List(std::move(elems));
+}
+
+void ComponentCallString(benchmark::State &state) {
+  Shapes shapes;
+  auto f = shapes.func("echo-string");
+  std::array<component::Val, 1> args = {
+      component::Val::string(std::string(LEN, 'a'))};
+  std::array<component::Val, 1> results = {false};
+  for (auto _ : state) {
+    f.call(shapes.store, args, results).unwrap();
+  }
+}
+BENCHMARK(ComponentCallString);
+
+void ComponentCallList(benchmark::State &state) {
+  Shapes shapes;
+  auto f = shapes.func("echo-list");
+  std::array<component::Val, 1> args = {list_val()};
+  std::array<component::Val, 1> results = {false};
+  for (auto _ : state) {
+    f.call(shapes.store, args, results).unwrap();
+  }
+}
+BENCHMARK(ComponentCallList);
+
+void ComponentCallRecord(benchmark::State &state) {
+  Shapes shapes;
+  auto f = shapes.func("echo-record");
+  std::array<component::Val, 1> args = {component::Record({
+      {"x", uint32_t(1)},
+      {"name", component::Val::string(std::string(LEN, 'a'))},
+      {"data", list_val()},
+  })};
+  std::array<component::Val, 1> results = {false};
+  for (auto _ : state) {
+    f.call(shapes.store, args, results).unwrap();
+  }
+}
+BENCHMARK(ComponentCallRecord);
+
+void TypedComponentCallString(benchmark::State &state) {
+  Shapes shapes;
+  auto f = shapes.func("echo-string")
+               .typed<std::tuple<std::string_view>, std::string>(shapes.store)
+               .unwrap();
+  std::string s(LEN, 'a');
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(f.call(shapes.store, {s}).unwrap());
+  }
+}
+BENCHMARK(TypedComponentCallString);
+
+void TypedComponentCallList(benchmark::State &state) {
+  Shapes shapes;
+  auto f = shapes.func("echo-list")
+               .typed<std::tuple<std::vector<uint32_t>>,
+                      std::vector<uint32_t>>(shapes.store)
+               .unwrap();
+  std::vector<uint32_t> l(LEN);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(f.call(shapes.store, {l}).unwrap());
+  }
+}
+BENCHMARK(TypedComponentCallList);
+
+} // namespace
@@ -0,0 +1,220 @@
+// Benchmarks of the canonical ABI for component calls through the C++ API.
+//
+// This uses the same component as `benches/component.rs`, whose path is
+// passed in as `SHAPES_WAT`, and prints the average time per call for each
+// value shape. It's built as the `bench-component` target and isn't run as
+// part of the test suite.
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <wasmtime/component.hh>
+#include <wasmtime/store.hh>
+
+using namespace wasmtime::component;
+using wasmtime::Engine;
+using wasmtime::Result;
+using wasmtime::Span;
+using wasmtime::Store;
+
+namespace {
+
+// The number of characters in strings, and elements in lists, which are
+// passed to and from the guest.
+constexpr size_t LEN = 100;
+
+constexpr uint32_t RESOURCE_TYPE = 1;
+
+// Runs `f(iters)`, which performs `iters` calls, with a doubling number of
+// iterations until it takes long enough to be measured, and prints the
+// average time per call.
+template <typename F> void bench(const std::string &name, F f) {
+  using Clock = std::chrono::steady_clock;
+  f(1);
+  for (uint64_t iters = 1;; iters *= 2) {
+    auto start = Clock::now();
+    f(iters);
+    auto elapsed = Clock::now() - start;
+    if (elapsed >= std::chrono::milliseconds(200)) {
+      auto ns = std::chrono::duration<double, std::nano>(elapsed).count();
+      std::printf("%-40s %10.1f ns/call\n", name.c_str(), ns / iters);
+      return;
+    }
+  }
+}
+
+Val list_val() {
+  std::vector<Val> elems;
+  for (uint32_t i = 0; i < LEN; i++) {
+    elems.emplace_back(i);
+  }
+  return List(std::move(elems));
+}
+
+Val point_val() {
+  return Record({
+      {"x", uint32_t(1)},
+      {"name", Val::string(std::string(LEN, 'a'))},
+      {"data", list_val()},
+  });
+}
+
+Func get_func(Store::Context cx, const Component &component,
+              const Instance &instance, std::string_view name) {
+  return *instance.get_func(cx, *component.export_index(nullptr, name));
+}
+
+// Defines the imports of the component, with host functions that either
+// use `Val`s directly or, if `typed`, C++ values.
+Linker make_linker(Engine &engine, bool typed) {
+  Linker linker(engine);
+  LinkerInstance root = linker.root();
+  root.add_resource("r", ResourceType(RESOURCE_TYPE),
+                    [](Store::Context, uint32_t) -> Result<std::monostate> {
+                      return std::monostate();
+                    })
+      .unwrap();
+  if (typed) {
+    root.add_func<std::tuple<std::string>, std::string>(
+            "host-string",
+            [](Store::Context, std::string s) -> Result<std::string> {
+              return s;
+            })
+        .unwrap();
+    root.add_func<std::tuple<std::vector<uint32_t>>, std::vector<uint32_t>>(
+            "host-list",
+            [](Store::Context,
+               std::vector<uint32_t> l) -> Result<std::vector<uint32_t>> {
+              return l;
+            })
+        .unwrap();
+  } else {
+    for (auto name : {"host-string", "host-list"}) {
+      root.add_func(name,
+                    [](Store::Context, const FuncType &, Span<Val> args,
+                       Span<Val> results) -> Result<std::monostate> {
+                      results[0] = args[0];
+                      return std::monostate();
+                    })
+          .unwrap();
+    }
+  }
+  // Records have no C++ representation, so they're always untyped.
+  root.add_func("host-record",
+                [](Store::Context, const FuncType &, Span<Val> args,
+                   Span<Val> results) -> Result<std::monostate> {
+                  results[0] = args[0];
+                  return std::monostate();
+                })
+      .unwrap();
+  return linker;
+}
+
+void host_to_wasm(Engine &engine, const Component &component) {
+  Store store(engine);
+  auto cx = store.context();
+  auto instance =
+      make_linker(engine, true).instantiate(cx, component).unwrap();
+
+  auto echo_string =
+      get_func(cx, component, instance, "echo-string")
+          .typed<std::tuple<std::string_view>, std::string>(cx)
+          .unwrap();
+  std::string s(LEN, 'a');
+  bench("host-to-wasm - typed - string", [&](uint64_t iters) {
+    for (uint64_t i = 0; i < iters; i++) {
+      echo_string.call(cx, {s}).unwrap();
+    }
+  });
+
+  auto echo_list =
+      get_func(cx, component, instance, "echo-list")
+          .typed<std::tuple<std::vector<uint32_t>>, std::vector<uint32_t>>(cx)
+          .unwrap();
+  std::vector<uint32_t> l(LEN);
+  bench("host-to-wasm - typed - list", [&](uint64_t iters) {
+    for (uint64_t i = 0; i < iters; i++) {
+      echo_list.call(cx, {l}).unwrap();
+    }
+  });
+
+  auto borrow = get_func(cx, component, instance, "borrow");
+  bench("host-to-wasm - untyped - borrow", [&](uint64_t iters) {
+    for (uint64_t i = 0; i < iters; i++) {
+      std::array<Val, 1> args = {
+          ResourceHost(false, 1, RESOURCE_TYPE).to_any(cx).unwrap()};
+      borrow.call(cx, args, Span<Val>()).unwrap();
+    }
+  });
+
+  auto own = get_func(cx, component, instance, "own");
+  bench("host-to-wasm - untyped - own", [&](uint64_t iters) {
+    for (uint64_t i = 0; i < iters; i++) {
+      std::array<Val, 1> args = {
+          ResourceHost(true, 1, RESOURCE_TYPE).to_any(cx).unwrap()};
+      own.call(cx, args, Span<Val>()).unwrap();
+    }
+  });
+
+  std::array<std::pair<const char *, Val>, 3> untyped = {{
+      {"string", Val::string(s)},
+      {"list", list_val()},
+      {"record", point_val()},
+  }};
+  for (auto &[shape, arg] : untyped) {
+    auto f = get_func(cx, component, instance, std::string("echo-") + shape);
+    std::array<Val, 1> args = {arg};
+    std::array<Val, 1> results = {false};
+    bench(std::string("host-to-wasm - untyped - ") + shape,
+          [&](uint64_t iters) {
+            for (uint64_t i = 0; i < iters; i++) {
+              f.call(cx, args, results).unwrap();
+            }
+          });
+  }
+}
+
+void wasm_to_host(Engine &engine, const Component &component) {
+  for (bool typed : {true, false}) {
+    Store store(engine);
+    auto cx = store.context();
+    auto instance =
+        make_linker(engine, typed).instantiate(cx, component).unwrap();
+
+    std::array<std::pair<const char *, Val>, 3> shapes = {{
+        {"string", Val::string(std::string(LEN, 'a'))},
+        {"list", list_val()},
+        {"record", point_val()},
+    }};
+    for (auto &[shape, arg] : shapes) {
+      auto run =
+          get_func(cx, component, instance, std::string("run-host-") + shape);
+      std::string name = std::string("wasm-to-host - ") +
+                         (typed ? "typed - " : "untyped - ") + shape;
+      bench(name, [&](uint64_t iters) {
+        std::array<Val, 2> args = {iters, arg};
+        run.call(cx, args, Span<Val>()).unwrap();
+      });
+    }
+  }
+}
+
+} // namespace
+
+int main() {
+  std::ifstream file(SHAPES_WAT);
+  std::stringstream wat;
+  wat << file.rdbuf();
+
+  Engine engine;
+  auto component = Component::compile(engine, wat.str()).unwrap();
+
+  host_to_wasm(engine, component);
+  wasm_to_host(engine, component);
+  return 0;
+}
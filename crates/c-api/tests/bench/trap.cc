@@ -0,0 +1,82 @@
+// Benchmarks of the cost of traps through the C++ API.
+//
+// This compares calls which materialize a `Trap`, including its message and
+// backtrace, with calls which only report the trap's code, with and without
+// backtraces being captured, and prints the average time per trapping call.
+// It's built as the `bench-trap` target and isn't run as part of the test
+// suite.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <wasmtime.hh>
+
+using namespace wasmtime;
+
+namespace {
+
+// Runs `f(iters)`, which performs `iters` calls, with a doubling number of
+// iterations until it takes long enough to be measured, and prints the
+// average time per call.
+template <typename F> void bench(const std::string &name, F f) {
+  using Clock = std::chrono::steady_clock;
+  f(1);
+  for (uint64_t iters = 1;; iters *= 2) {
+    auto start = Clock::now();
+    f(iters);
+    auto elapsed = Clock::now() - start;
+    if (elapsed >= std::chrono::milliseconds(200)) {
+      auto ns = std::chrono::duration<double, std::nano>(elapsed).count();
+      std::printf("%-40s %10.1f ns/call\n", name.c_str(), ns / iters);
+      return;
+    }
+  }
+}
+
+// A module whose `run` export traps after recursing `depth` frames deep, so
+// that the cost of backtraces is visible.
+constexpr const char *WAT = R"(
+  (module
+    (func $run (export "run") (param $depth i32)
+      (if (i32.eqz (local.get $depth))
+        (then unreachable))
+      (call $run (i32.sub (local.get $depth) (i32.const 1)))))
+)";
+
+} // namespace
+
+int main() {
+  Engine engine;
+  Module module = Module::compile(engine, WAT).unwrap();
+
+  for (int32_t depth : {0, 10, 100}) {
+    for (bool backtrace : {true, false}) {
+      Store store(engine);
+      store.context().set_wasm_backtrace(backtrace);
+      Instance instance = Instance::create(store, module, {}).unwrap();
+      auto run = std::get<Func>(*instance.get(store, "run"))
+                     .typed<int32_t, std::monostate>(store)
+                     .unwrap();
+
+      std::string suffix = "/depth-" + std::to_string(depth) +
+                           (backtrace ? "/backtrace" : "/no-backtrace");
+      bench("trap" + suffix, [&](uint64_t iters) {
+        for (uint64_t i = 0; i < iters; i++) {
+          auto trap = std::get<Trap>(run.call(store, depth).err().data);
+          if (!trap.code()) {
+            std::abort();
+          }
+        }
+      });
+      bench("trap-code" + suffix, [&](uint64_t iters) {
+        for (uint64_t i = 0; i < iters; i++) {
+          if (!run.call_trap_code(store, depth).err().code()) {
+            std::abort();
+          }
+        }
+      });
+    }
+  }
+  return 0;
+}
@@ -48,3 +48,126 @@ TEST(component, call_func) {
   EXPECT_TRUE(results[0].is_u32());
   EXPECT_EQ(results[0].get_u32(), 69);
 }
+
+TEST(component, call_func_argument_scratch) {
+  static constexpr auto component_text = std::string_view{
+      R"END(
+(component
+    (core module $m
+        (memory (export "memory") 1)
+        (global $calls (mut i32) (i32.const 0))
+        (global $bump (mut i32) (i32.const 16))
+        (func (export "realloc") (param i32 i32 i32 i32) (result i32)
+            (local $ret i32)
+            (global.set $calls (i32.add (global.get $calls) (i32.const 1)))
+            (local.set $ret (global.get $bump))
+            (global.set $bump
+                (i32.and
+                    (i32.add (i32.add (local.get $ret) (local.get 3)) (i32.const 7))
+                    (i32.const -8)))
+            (local.get $ret))
+        (func (export "len") (param i32 i32) (result i32)
+            (local.get 1))
+        (func (export "calls") (result i32)
+            (global.get $calls))
+    )
+    (core instance $i (instantiate $m))
+    (func (export "len") (param "s" string) (result u32)
+        (canon lift (core func $i "len")
+            (memory $i "memory") (realloc (func $i "realloc"))))
+    (func (export "calls") (result u32)
+        (canon lift (core func $i "calls")))
+)
+      )END",
+  };
+
+  wasmtime::Engine engine;
+  wasmtime::Store store(engine);
+  auto context = store.context();
+  auto component = Component::compile(engine, component_text).unwrap();
+  Linker linker(engine);
+  auto instance = linker.instantiate(context, component).unwrap();
+
+  auto len = instance.get_func(context, *component.export_index(nullptr, "len"))
+                 ->typed<std::tuple<std::string_view>, uint32_t>(context)
+                 .unwrap();
+  auto calls =
+      instance.get_func(context, *component.export_index(nullptr, "calls"))
+          ->typed<std::tuple<>, uint32_t>(context)
+          .unwrap();
+
+  EXPECT_EQ(len.call(context, {"hello"}).unwrap(), 5);
+  EXPECT_EQ(calls.call(context, {}).unwrap(), 1);
+
+  // All of these fit in the first region that's allocated.
+  instance.set_argument_scratch(context, true);
+  EXPECT_EQ(len.call(context, {"a"}).unwrap(), 1);
+  EXPECT_EQ(len.call(context, {"bc"}).unwrap(), 2);
+  EXPECT_EQ(len.call(context, {std::string(100, 'x')}).unwrap(), 100);
+  EXPECT_EQ(calls.call(context, {}).unwrap(), 2);
+
+  // Larger arguments allocate another region once, which is then reused.
+  std::string large(5000, 'x');
+  EXPECT_EQ(len.call(context, {large}).unwrap(), 5000);
+  EXPECT_EQ(len.call(context, {large}).unwrap(), 5000);
+  EXPECT_EQ(calls.call(context, {}).unwrap(), 3);
+
+  instance.set_argument_scratch(context, false);
+  EXPECT_EQ(len.call(context, {"a"}).unwrap(), 1);
+  EXPECT_EQ(calls.call(context, {}).unwrap(), 4);
+}
+
+TEST(component, call_func_lazy) {
+  static constexpr auto component_text = std::string_view{
+      R"END(
+(component
+    (core module $m
+        (memory (export "memory") 1)
+        (data (i32.const 16) "\01\00\00\00\02\00\00\00\03\00\00\00")
+        (data (i32.const 8) "\10\00\00\00\03\00\00\00")
+        (func (export "f") (result i32)
+            (i32.const 8))
+    )
+    (core instance $i (instantiate $m))
+    (func (export "f") (result (list u32))
+        (canon lift (core func $i "f") (memory $i "memory")))
+)
+      )END",
+  };
+
+  wasmtime::Engine engine;
+  wasmtime::Store store(engine);
+  auto context = store.context();
+  auto component = Component::compile(engine, component_text).unwrap();
+  auto f = *component.export_index(nullptr, "f");
+
+  Linker linker(engine);
+  auto instance = linker.instantiate(context, component).unwrap();
+  auto func = *instance.get_func(context, f);
+
+  auto params = std::array<Val, 0>{};
+  uint32_t sum = 0;
+  func.call_lazy(context, params,
+                 [&](LazyResults &results) -> wasmtime::Result<std::monostate> {
+                   EXPECT_EQ(results.size(), 1);
+                   size_t len = results.list_size(0).unwrap();
+                   EXPECT_EQ(len, 3);
+                   for (size_t i = 0; i < len; i++) {
+                     sum += results.list_get(0, i).unwrap().get_u32();
+                   }
+                   EXPECT_FALSE(results.list_get(0, 3));
+
+                   Val all = results.get(0).unwrap();
+                   EXPECT_EQ(all.get_list().size(), 3);
+                   return std::monostate();
+                 })
+      .unwrap();
+  EXPECT_EQ(sum, 6);
+
+  auto err = func.call_lazy(
+      context, params, [](LazyResults &) -> wasmtime::Result<std::monostate> {
+        return wasmtime::Error("stop");
+      });
+  EXPECT_FALSE(err);
+  EXPECT_EQ(err.err().message(), "stop");
+}
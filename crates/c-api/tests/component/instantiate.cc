@@ -21,3 +21,33 @@ TEST(component, instantiate) {
 
   linker.instantiate(context, component).unwrap();
 }
+
+TEST(component, instantiate_pre) {
+  static constexpr auto bytes = std::string_view{
+      R"END(
+      (component
+          (import "a" (func))
+          (core module)
+      )
+      )END",
+  };
+
+  wasmtime::Engine engine;
+  Component component = Component::compile(engine, bytes).unwrap();
+  Linker linker(engine);
+
+  EXPECT_FALSE(linker.instantiate_pre(component));
+  linker.define_unknown_imports_as_traps(component).unwrap();
+  InstancePre pre = linker.instantiate_pre(component).unwrap();
+  InstancePre copy = pre;
+
+  for (int i = 0; i < 2; i++) {
+    wasmtime::Store store(engine);
+    pre.instantiate(store).unwrap();
+    copy.instantiate(store).unwrap();
+  }
+
+  Component same = pre.component();
+  wasmtime::Store store(engine);
+  linker.instantiate(store, same).unwrap();
+}
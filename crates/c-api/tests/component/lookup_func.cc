@@ -39,3 +39,38 @@ TEST(component, lookup_func) {
   auto f2 = instance.get_export_index(context, nullptr, "f");
   EXPECT_TRUE(f2);
 }
+
+TEST(component, lookup_nested_func) {
+  static constexpr auto component_text = std::string_view{
+      R"END(
+(component
+    (core module $m
+        (func (export "f"))
+    )
+    (core instance $i (instantiate $m))
+    (func $f (canon lift (core func $i "f")))
+    (instance $a (export "f" (func $f)))
+    (export "a" (instance $a))
+)
+      )END",
+  };
+
+  wasmtime::Engine engine;
+  wasmtime::Store store(engine);
+  auto context = store.context();
+  Component component = Component::compile(engine, component_text).unwrap();
+
+  EXPECT_FALSE(component.export_index({"b", "f"}));
+  EXPECT_FALSE(component.export_index({"a", "g"}));
+  EXPECT_FALSE(component.export_index({}));
+  auto f = component.export_index({"a", "f"});
+  EXPECT_TRUE(f);
+
+  Linker linker(engine);
+  for (int i = 0; i < 2; i++) {
+    auto instance = linker.instantiate(context, component).unwrap();
+    auto func = instance.get_func(context, *f);
+    EXPECT_TRUE(func);
+    func->call(context, {}, {}).unwrap();
+  }
+}
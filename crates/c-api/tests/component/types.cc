@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <wasmtime/component.hh>
 
@@ -102,6 +103,38 @@ TEST(types, component_func) {
   EXPECT_EQ(*ty.result(), ValType::new_string());
 }
 
+TEST(types, component_func_equal) {
+  Engine engine;
+
+  auto component = Component::compile(engine, R"(
+(component
+  (import "a" (func (param "x" u32) (result string)))
+  (import "b" (func (param "x" u32) (result string)))
+  (import "c" (func (param "y" u32) (result string)))
+  (import "d" (func (param "x" u32)))
+)
+      )")
+                       .unwrap()
+                       .type();
+  auto a = component.import_get(engine, "a")->component_func();
+  auto b = component.import_get(engine, "b")->component_func();
+  auto c = component.import_get(engine, "c")->component_func();
+  auto d = component.import_get(engine, "d")->component_func();
+  EXPECT_EQ(a, a);
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_NE(a, d);
+
+  auto other = Component::compile(engine, R"(
+(component
+  (import "a" (func (param "x" u32) (result string)))
+)
+      )")
+                   .unwrap()
+                   .type();
+  EXPECT_EQ(a, other.import_get(engine, "a")->component_func());
+}
+
 TEST(types, module_type) {
   Engine engine;
 
@@ -294,6 +327,49 @@ TEST(types, valtype_result) {
   EXPECT_FALSE(ty.result().err().has_value());
 }
 
+TEST(types, valtype_encode) {
+  auto ty = result(R"(
+  (component
+    (type $f' (flags "a" "b" "c"))
+    (import "fl" (type $f (eq $f')))
+    (type $t' (record
+      (field "x" s32)
+      (field "y" (list string))
+      (field "z" (option u64))
+      (field "w" $f)))
+    (import "t" (type $t (eq $t')))
+    (import "f" (func (result $t)))
+  )
+  )");
+
+  Val val = Record({
+      {"x", int32_t(-5)},
+      {"y", List({Val::string("hi"), Val::string("")})},
+      {"z", WitOption(Val(uint64_t(300)))},
+      {"w", Flags({Flag("a"), Flag("c")})},
+  });
+  std::vector<uint8_t> bytes;
+  val.encode(ty, bytes).unwrap();
+  EXPECT_EQ(bytes, (std::vector<uint8_t>{0x7b, 2, 2, 'h', 'i', 0, 1, 0xac, 0x02,
+                                         0b101}));
+
+  auto decoded = Val::decode(ty, bytes).unwrap();
+  const auto &record = decoded.get_record();
+  EXPECT_EQ(record.size(), 4);
+  EXPECT_EQ(record.begin()->name(), "x");
+  EXPECT_EQ(record.begin()->value().get_s32(), -5);
+  std::vector<uint8_t> reencoded = {0xff};
+  decoded.encode(ty, reencoded).unwrap();
+  EXPECT_EQ(reencoded.size(), bytes.size() + 1);
+  EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), reencoded.begin() + 1));
+
+  EXPECT_FALSE(Val(uint8_t(1)).encode(ty, bytes));
+  EXPECT_EQ(bytes.size(), 10);
+  EXPECT_FALSE(Val::decode(ty, Span<const uint8_t>(bytes.data(), 9)));
+  bytes.push_back(0);
+  EXPECT_FALSE(Val::decode(ty, bytes));
+}
+
 TEST(types, func_result) {
   Engine engine;
   auto wat = R"(
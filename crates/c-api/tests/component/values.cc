@@ -165,6 +165,65 @@ local.get $res
   check(res, 3, 4);
 }
 
+TEST(component, value_record_values) {
+  static const auto check = [](const Val &v, uint64_t x, uint64_t y) {
+    EXPECT_TRUE(v.is_record());
+    const Record &r = v.get_record();
+    EXPECT_EQ(r.size(), 2);
+    EXPECT_EQ(r.begin()[0].name(), "x");
+    EXPECT_EQ(r.begin()[0].value().get_u64(), x);
+    EXPECT_EQ(r.begin()[1].name(), "y");
+    EXPECT_EQ(r.begin()[1].value().get_u64(), y);
+  };
+
+  static const auto make = [](uint64_t x, uint64_t y) -> Val {
+    return RecordValues({x, y});
+  };
+
+  auto ctx = create(
+      R"((record (field "x" u64) (field "y" u64)))", R"(
+(param $x i64)
+(param $y i64)
+(result i32)
+(local $res i32)
+local.get $x
+local.get $y
+(call $realloc
+	(i32.const 0)
+	(i32.const 0)
+	(i32.const 4)
+	(i32.const 16))
+local.tee $res
+call $do
+local.get $res
+	  )",
+      "(param i64 i64 i32)",
+      +[](Store::Context, const FuncType &_ty, Span<const Val> args,
+          Span<Val> rets) -> Result<std::monostate> {
+        EXPECT_EQ(args.size(), 1);
+        check(args[0], 1, 2);
+
+        EXPECT_EQ(rets.size(), 1);
+        rets[0] = make(3, 4);
+
+        return std::monostate();
+      });
+
+  auto arg = make(1, 2);
+  auto res = Val(false);
+
+  ctx.func.call(ctx.context, Span<const Val>(&arg, 1), Span<Val>(&res, 1))
+      .unwrap();
+  ctx.func.post_return(ctx.context).unwrap();
+
+  check(res, 3, 4);
+
+  arg = RecordValues({uint64_t(1)});
+  auto err = ctx.func.call(ctx.context, Span<const Val>(&arg, 1),
+                           Span<Val>(&res, 1));
+  EXPECT_FALSE(err);
+}
+
 TEST(component, value_string) {
   static const auto check = [](const Val &v, std::string_view text) {
     EXPECT_TRUE(v.is_string());
@@ -270,6 +329,158 @@ local.get $res
   check(res, {4, 5, 6, 7});
 }
 
+TEST(component, value_flat_list) {
+  static const auto check = [](const Val &v, std::vector<uint8_t> data) {
+    // Lists produced by Wasmtime are never flat.
+    EXPECT_TRUE(v.is_list());
+    const List &l = v.get_list();
+    EXPECT_EQ(l.size(), data.size());
+
+    for (auto i = 0; i < data.size(); i++) {
+      const auto &elem = l.begin()[i];
+      EXPECT_TRUE(elem.is_u8());
+      EXPECT_EQ(elem.get_u8(), data[i]);
+    }
+  };
+
+  auto ctx = create(
+      R"((list u8))", R"(
+(param $x i32)
+(param $y i32)
+(result i32)
+(local $res i32)
+local.get $x
+local.get $y
+(call $realloc
+	(i32.const 0)
+	(i32.const 0)
+	(i32.const 4)
+	(i32.const 8))
+local.tee $res
+call $do
+local.get $res
+	  )",
+      "(param i32 i32 i32)",
+      +[](Store::Context, const FuncType &, Span<const Val> args,
+          Span<Val> rets) -> Result<std::monostate> {
+        EXPECT_EQ(args.size(), 1);
+        check(args[0], {1, 2, 3});
+
+        EXPECT_EQ(rets.size(), 1);
+        ListU8 list(4);
+        for (auto i = 0; i < list.size(); i++) {
+          list.data()[i] = 4 + i;
+        }
+        rets[0] = std::move(list);
+
+        return std::monostate();
+      });
+
+  auto arg = Val(ListU8(std::vector<uint8_t>{1, 2, 3}));
+  auto res = Val(false);
+
+  ctx.func.call(ctx.context, Span<const Val>(&arg, 1), Span<Val>(&res, 1))
+      .unwrap();
+  ctx.func.post_return(ctx.context).unwrap();
+
+  check(res, {4, 5, 6, 7});
+}
+
+TEST(component, typed_func) {
+  auto ctx = create(
+      R"((list u8))", R"(
+(param $x i32)
+(param $y i32)
+(result i32)
+(local $res i32)
+local.get $x
+local.get $y
+(call $realloc
+	(i32.const 0)
+	(i32.const 0)
+	(i32.const 4)
+	(i32.const 8))
+local.tee $res
+call $do
+local.get $res
+	  )",
+      "(param i32 i32 i32)",
+      +[](Store::Context, const FuncType &, Span<const Val> args,
+          Span<Val> rets) -> Result<std::monostate> {
+        EXPECT_EQ(args.size(), 1);
+        EXPECT_TRUE(args[0].is_list());
+        EXPECT_EQ(args[0].get_list().size(), 3);
+
+        EXPECT_EQ(rets.size(), 1);
+        rets[0] = ListU8(std::vector<uint8_t>{4, 5, 6, 7});
+
+        return std::monostate();
+      });
+
+  using Params = std::tuple<std::vector<uint8_t>>;
+  auto typed =
+      ctx.func.typed<Params, std::vector<uint8_t>>(ctx.context).unwrap();
+  auto res = typed.call(ctx.context, {{1, 2, 3}}).unwrap();
+  EXPECT_EQ(res, (std::vector<uint8_t>{4, 5, 6, 7}));
+
+  EXPECT_FALSE((ctx.func.typed<Params, std::monostate>(ctx.context)));
+  EXPECT_FALSE((ctx.func.typed<Params, std::vector<uint32_t>>(ctx.context)));
+  EXPECT_FALSE((ctx.func.typed<std::tuple<std::string>, std::vector<uint8_t>>(
+      ctx.context)));
+  EXPECT_FALSE((ctx.func.typed<std::tuple<>, std::vector<uint8_t>>(
+      ctx.context)));
+}
+
+TEST(component, typed_host_func) {
+  static const auto body = R"(
+(param $x i32)
+(param $y i32)
+(result i32)
+(local $res i32)
+local.get $x
+local.get $y
+(call $realloc
+	(i32.const 0)
+	(i32.const 0)
+	(i32.const 4)
+	(i32.const 8))
+local.tee $res
+call $do
+local.get $res
+	  )";
+  auto component_text =
+      echo_component("string", body, "(param i32 i32 i32)");
+
+  Engine engine;
+  Linker linker(engine);
+  linker.root()
+      .add_func<std::tuple<std::string_view>, std::string>(
+          "do",
+          [](Store::Context, std::string_view arg) -> Result<std::string> {
+            EXPECT_EQ(arg, "hello from A!");
+            return std::string("hello from B!");
+          })
+      .unwrap();
+  auto ctx = Context::New(engine, component_text, linker);
+
+  using Params = std::tuple<std::string_view>;
+  auto typed = ctx.func.typed<Params, std::string>(ctx.context).unwrap();
+  auto res = typed.call(ctx.context, {"hello from A!"}).unwrap();
+  EXPECT_EQ(res, "hello from B!");
+
+  Linker mismatched(engine);
+  mismatched.root()
+      .add_func<std::tuple<uint32_t>, std::monostate>(
+          "do", [](Store::Context, uint32_t) -> Result<std::monostate> {
+            ADD_FAILURE() << "host function shouldn't be called";
+            return std::monostate();
+          })
+      .unwrap();
+  auto ctx2 = Context::New(engine, component_text, mismatched);
+  auto typed2 = ctx2.func.typed<Params, std::string>(ctx2.context).unwrap();
+  EXPECT_FALSE(typed2.call(ctx2.context, {"hello from A!"}));
+}
+
 TEST(component, value_tuple) {
   static const auto check = [](const Val &v, std::vector<uint32_t> data) {
     EXPECT_TRUE(v.is_tuple());
@@ -600,6 +811,93 @@ call $do
   check(res, {"aa", "bb"});
 }
 
+TEST(component, value_enum_index) {
+  auto ctx = create(
+      R"((enum "aa" "bb"))", R"(
+(param $x i32)
+(result i32)
+local.get $x
+call $do
+	  )",
+      "(param i32) (result i32)",
+      +[](Store::Context, const FuncType &, Span<const Val> args,
+          Span<Val> rets) -> Result<std::monostate> {
+        EXPECT_EQ(args.size(), 1);
+        EXPECT_TRUE(args[0].is_enum());
+        EXPECT_EQ(args[0].get_enum(), "aa");
+
+        EXPECT_EQ(rets.size(), 1);
+        rets[0] = Val::enum_index(1);
+
+        return std::monostate();
+      });
+
+  auto arg = Val::enum_index(0);
+  auto res = Val(false);
+
+  ctx.func.call(ctx.context, Span<const Val>(&arg, 1), Span<Val>(&res, 1))
+      .unwrap();
+  ctx.func.post_return(ctx.context).unwrap();
+
+  EXPECT_TRUE(res.is_enum());
+  EXPECT_EQ(res.get_enum(), "bb");
+
+  arg = Val::enum_index(2);
+  auto err = ctx.func.call(ctx.context, Span<const Val>(&arg, 1),
+                           Span<Val>(&res, 1));
+  EXPECT_FALSE(err);
+}
+
+TEST(component, value_flags_mask) {
+  auto ctx = create(
+      R"((flags "aa" "bb"))", R"(
+(param $x i32)
+(result i32)
+local.get $x
+call $do
+	  )",
+      "(param i32) (result i32)",
+      +[](Store::Context, const FuncType &, Span<const Val> args,
+          Span<Val> rets) -> Result<std::monostate> {
+        EXPECT_EQ(args.size(), 1);
+        EXPECT_TRUE(args[0].is_flags());
+        EXPECT_EQ(args[0].get_flags().size(), 1);
+        EXPECT_EQ(args[0].get_flags().begin()[0].name(), "bb");
+
+        EXPECT_EQ(rets.size(), 1);
+        FlagsMask mask(2);
+        mask.set(0);
+        mask.set(1);
+        rets[0] = mask;
+
+        return std::monostate();
+      });
+
+  FlagsMask mask(2);
+  mask.set(1);
+  EXPECT_FALSE(mask.test(0));
+  EXPECT_TRUE(mask.test(1));
+  EXPECT_EQ(mask.words().size(), 1);
+  EXPECT_EQ(mask.words()[0], 0b10);
+
+  auto arg = Val(mask);
+  auto res = Val(false);
+
+  ctx.func.call(ctx.context, Span<const Val>(&arg, 1), Span<Val>(&res, 1))
+      .unwrap();
+  ctx.func.post_return(ctx.context).unwrap();
+
+  EXPECT_TRUE(res.is_flags());
+  EXPECT_EQ(res.get_flags().size(), 2);
+
+  FlagsMask out_of_range(3);
+  out_of_range.set(2);
+  arg = Val(out_of_range);
+  auto err = ctx.func.call(ctx.context, Span<const Val>(&arg, 1),
+                           Span<Val>(&res, 1));
+  EXPECT_FALSE(err);
+}
+
 TEST(component, value_list_inner) {
   auto x = wasmtime_component_val_t{
       .kind = WASMTIME_COMPONENT_LIST,
@@ -711,6 +1009,35 @@ TEST(component, lists) {
   value.get_list();
 }
 
+TEST(component, flat_lists) {
+  std::vector<double> elems = {1.5, 2.5};
+  ListF64 l(elems);
+  EXPECT_EQ(l.size(), 2);
+  EXPECT_EQ(std::vector<double>(l.begin(), l.end()), elems);
+
+  ListF64 l2 = l;
+  EXPECT_EQ(l.size(), 2);
+  EXPECT_NE(l2.data(), l.data());
+  EXPECT_EQ(l2.data()[1], 2.5);
+
+  ListF64 l3 = std::move(l);
+  EXPECT_EQ(l.size(), 0);
+  EXPECT_EQ(l3.size(), 2);
+
+  Val value(l3);
+  EXPECT_FALSE(value.is_list());
+  EXPECT_TRUE(value.is_flat_list<double>());
+  EXPECT_FALSE(value.is_flat_list<float>());
+  EXPECT_EQ(value.get_flat_list<double>().data()[0], 1.5);
+
+  Val clone = value;
+  EXPECT_EQ(clone.get_flat_list<double>().size(), 2);
+
+  ListS32 empty(std::vector<int32_t>{});
+  EXPECT_EQ(empty.size(), 0);
+  EXPECT_EQ(empty.begin(), empty.end());
+}
+
 TEST(component, tuples) {
   Tuple l({uint32_t(1), uint64_t(2), uint8_t(3)});
   EXPECT_EQ(l.size(), 3);
@@ -757,6 +1084,22 @@ TEST(component, variants) {
   EXPECT_EQ(v3.value()->get_u32(), 42);
 }
 
+TEST(component, variant_indices) {
+  VariantIndex v(3, uint32_t(42));
+  EXPECT_EQ(v.discriminant(), 3);
+  EXPECT_TRUE(v.value()->is_u32());
+  EXPECT_EQ(v.value()->get_u32(), 42);
+
+  Val value = v;
+  EXPECT_TRUE(value.is_variant_index());
+  auto v2 = value.get_variant_index();
+  EXPECT_EQ(v2.discriminant(), 3);
+  EXPECT_EQ(v2.value()->get_u32(), 42);
+
+  VariantIndex empty(0, std::nullopt);
+  EXPECT_EQ(empty.value(), nullptr);
+}
+
 TEST(component, strings) {
   Val v = Val::string("hi");
   EXPECT_TRUE(v.is_string());
@@ -1091,3 +1434,42 @@ TEST(component, resources) {
   EXPECT_TRUE(r5.owned());
   EXPECT_EQ(r5.type(), ResourceType(2));
 }
+
+TEST(component, resources_many) {
+  Engine engine;
+  Store store(engine);
+  std::vector<ResourceHost> hosts = {ResourceHost(true, 1, 2),
+                                     ResourceHost(true, 2, 2),
+                                     ResourceHost(false, 3, 2)};
+  auto anys = ResourceHost::to_any_all(store, hosts).unwrap();
+  EXPECT_EQ(anys.size(), 3);
+  EXPECT_TRUE(anys[0].owned());
+  EXPECT_FALSE(anys[2].owned());
+  EXPECT_EQ(anys[1].type(), ResourceType(2));
+
+  Span<const ResourceAny> owned(anys.data(), 2);
+  EXPECT_TRUE(ResourceAny::drop_all(store, owned));
+  EXPECT_FALSE(ResourceAny::drop_all(store, owned));
+  EXPECT_TRUE(ResourceAny::drop_all(store, {}));
+}
+
+TEST(component, resource_table) {
+  ResourceTable<std::string> table;
+  uint32_t a = table.push("a");
+  uint32_t b = table.push("b");
+  EXPECT_NE(a, b);
+  EXPECT_EQ(table.size(), 2);
+  EXPECT_EQ(*table.get(a), "a");
+  EXPECT_EQ(*table.get(b), "b");
+  EXPECT_EQ(table.get(100), nullptr);
+
+  EXPECT_EQ(table.remove(a), "a");
+  EXPECT_EQ(table.get(a), nullptr);
+  EXPECT_EQ(table.remove(a), std::nullopt);
+  EXPECT_EQ(table.size(), 1);
+
+  uint32_t c = table.push("c");
+  EXPECT_EQ(c, a);
+  EXPECT_EQ(*table.get(c), "c");
+  EXPECT_EQ(table.size(), 2);
+}
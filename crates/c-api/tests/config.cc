@@ -1,3 +1,6 @@
+#include <atomic>
+#include <map>
+#include <mutex>
 #include <gtest/gtest.h>
 #include <wasmtime.hh>
 #include <wasmtime/config.hh>
@@ -8,6 +11,7 @@ TEST(PoolAllocationConfig, Smoke) {
   PoolAllocationConfig config;
   config.max_unused_warm_slots(1);
   config.decommit_batch_size(2);
+  config.background_decommit(true);
   config.async_stack_keep_resident(3);
   config.linear_memory_keep_resident(4);
   config.table_keep_resident(5);
@@ -26,6 +30,9 @@ TEST(PoolAllocationConfig, Smoke) {
   config.max_memories_per_module(18);
   config.max_memory_size(19);
   config.total_gc_heaps(20);
+  config.memory_protection_keys(Enabled::No);
+  config.max_memory_protection_keys(21);
+  PoolAllocationConfig::are_memory_protection_keys_available();
 
   PoolAllocationConfig config2 = std::move(config);
   PoolAllocationConfig config3(std::move(config));
@@ -42,6 +49,8 @@ TEST(Config, Smoke) {
   config.wasm_reference_types(false);
   config.wasm_function_references(false);
   config.wasm_gc(false);
+  config.collector(Collector::Auto);
+  config.gc_heap_growth_factor(2.0);
   config.wasm_simd(false);
   config.wasm_relaxed_simd(false);
   config.wasm_relaxed_simd_deterministic(false);
@@ -60,6 +69,9 @@ TEST(Config, Smoke) {
   config.profiler(ProfilingStrategy::None);
   config.memory_reservation(0);
   config.memory_reservation_for_growth(0);
+  config.memory_populate(false);
+  config.memory_huge_pages(Enabled::No);
+  config.code_huge_pages(Enabled::No);
   config.memory_guard_size(0);
   config.memory_may_move(false);
   config.memory_init_cow(false);
@@ -137,3 +149,117 @@ TEST(Config, MemoryCreator) {
     }
   }
 }
+
+struct RecyclingMemoryCreator {
+  using Memory = MyMemoryCreator::Memory;
+
+  std::shared_ptr<std::vector<Memory>> free =
+      std::make_shared<std::vector<Memory>>();
+  std::shared_ptr<size_t> created = std::make_shared<size_t>(0);
+
+  Result<Memory> new_memory(const MemoryType::Ref &ty, size_t minimum,
+                            size_t maximum, size_t reserved_size_in_bytes,
+                            size_t guard_size_in_bytes) {
+    if (!free->empty()) {
+      Memory mem = std::move(free->back());
+      free->pop_back();
+      mem.storage.assign(minimum, 0);
+      return mem;
+    }
+    *created += 1;
+    return MyMemoryCreator().new_memory(ty, minimum, maximum,
+                                        reserved_size_in_bytes,
+                                        guard_size_in_bytes);
+  }
+
+  void reuse_memory(Memory memory) { free->push_back(std::move(memory)); }
+};
+
+TEST(Config, MemoryCreatorReuse) {
+  RecyclingMemoryCreator creator;
+  auto free = creator.free;
+  auto created = creator.created;
+
+  Config config;
+  config.memory_guard_size(0);
+  config.memory_reservation(0);
+  config.memory_reservation_for_growth(0);
+  config.host_memory_creator(creator);
+
+  Engine engine(std::move(config));
+  Module m =
+      Module::compile(engine, "(module (memory (export \"x\") 1))").unwrap();
+
+  for (int i = 0; i < 3; i++) {
+    Store store(engine);
+    Instance instance = Instance::create(store, m, {}).unwrap();
+    Memory mem = std::get<Memory>(*instance.get(store, "x"));
+    auto data = mem.data(store);
+    EXPECT_EQ(data.size(), 65536);
+    for (auto &byte : data) {
+      EXPECT_EQ(byte, 0);
+    }
+    data[0] = 1;
+  }
+
+  EXPECT_EQ(*created, 1);
+  EXPECT_EQ(free->size(), 1);
+}
+
+TEST(Config, CompilationThreads) {
+  auto started = std::make_shared<std::atomic<size_t>>(0);
+  Config config;
+  config.parallel_compilation(true);
+  config.compilation_threads(2);
+  config.compilation_thread_start_handler([started](size_t index) {
+    EXPECT_LT(index, 2);
+    started->fetch_add(1);
+  });
+
+  Engine engine(std::move(config));
+  Module::compile(engine, "(module (func) (func))").unwrap();
+  EXPECT_GE(started->load(), 1);
+}
+
+#if defined(WASMTIME_FEATURE_INCREMENTAL_CACHE) &&                             \
+    defined(WASMTIME_FEATURE_CRANELIFT)
+TEST(Config, IncrementalCache) {
+  struct Entries {
+    std::mutex lock;
+    std::map<std::vector<uint8_t>, std::vector<uint8_t>> map;
+    size_t hits = 0;
+  };
+
+  struct Store {
+    std::shared_ptr<Entries> entries;
+
+    std::optional<std::vector<uint8_t>> get(Span<const uint8_t> key) {
+      std::lock_guard<std::mutex> guard(entries->lock);
+      auto it = entries->map.find(std::vector<uint8_t>(key.begin(), key.end()));
+      if (it == entries->map.end()) {
+        return std::nullopt;
+      }
+      entries->hits++;
+      return it->second;
+    }
+
+    bool insert(Span<const uint8_t> key, Span<const uint8_t> value) {
+      std::lock_guard<std::mutex> guard(entries->lock);
+      entries->map[std::vector<uint8_t>(key.begin(), key.end())] =
+          std::vector<uint8_t>(value.begin(), value.end());
+      return true;
+    }
+  };
+
+  auto entries = std::make_shared<Entries>();
+  auto wat = "(module (func (result i32) i32.const 1))";
+  for (int i = 0; i < 2; i++) {
+    Config config;
+    config.incremental_cache(Store{entries}).unwrap();
+    Engine engine(std::move(config));
+    Module::compile(engine, wat).unwrap();
+  }
+  EXPECT_FALSE(entries->map.empty());
+  EXPECT_GT(entries->hits, 0);
+}
+#endif // WASMTIME_FEATURE_INCREMENTAL_CACHE && WASMTIME_FEATURE_CRANELIFT
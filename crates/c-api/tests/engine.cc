@@ -1,6 +1,9 @@
 #include <wasmtime/engine.hh>
 
 #include <gtest/gtest.h>
+#include <wasmtime/instance.hh>
+#include <wasmtime/module.hh>
+#include <wasmtime/store.hh>
 
 using namespace wasmtime;
 
@@ -13,3 +16,135 @@ TEST(Engine, Simple) {
   engine2 = Engine();
   engine.is_pulley();
 }
+
+TEST(Engine, Stats) {
+  Engine engine;
+  auto before = engine.stats();
+  EXPECT_EQ(before.code_objects, 0);
+  EXPECT_EQ(before.text_bytes, 0);
+
+  {
+    auto m = Module::compile(engine, "(module (func (export \"f\")))");
+    ASSERT_TRUE(m);
+    auto stats = engine.stats();
+    EXPECT_EQ(stats.code_objects, 1);
+    EXPECT_GT(stats.text_bytes, 0);
+    EXPECT_GE(stats.code_bytes, stats.text_bytes);
+    EXPECT_GE(stats.types, 1);
+  }
+
+  auto after = engine.stats();
+  EXPECT_EQ(after.code_objects, 0);
+  EXPECT_EQ(after.code_bytes, 0);
+  EXPECT_EQ(after.text_bytes, 0);
+}
+
+#ifdef WASMTIME_FEATURE_POOLING_ALLOCATOR
+TEST(Engine, PoolingStats) {
+  EXPECT_FALSE(Engine().pooling_stats());
+
+  PoolAllocationConfig pooling;
+  pooling.total_memories(10);
+  pooling.total_tables(10);
+  pooling.total_core_instances(10);
+  Config config;
+  config.pooling_allocation_strategy(pooling);
+  Engine engine(std::move(config));
+
+  auto stats = engine.pooling_stats();
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(stats->memories, 0);
+  EXPECT_EQ(stats->unused_cold_memories, 10);
+  EXPECT_EQ(stats->unused_cold_tables, 10);
+}
+
+TEST(Engine, PoolingAffinity) {
+  PoolAllocationConfig pooling;
+  pooling.total_memories(10);
+  Config config;
+  config.pooling_allocation_strategy(pooling);
+  Engine engine(std::move(config));
+  auto m = Module::compile(engine, "(module (memory (export \"m\") 1))");
+  ASSERT_TRUE(m);
+
+  auto base = [&](Store &store, uint64_t tenant) {
+    store.context().set_pooling_affinity(tenant);
+    Instance i = Instance::create(store, m.ok(), {}).unwrap();
+    return std::get<Memory>(*i.get(store, "m")).data(store).data();
+  };
+
+  // Each tenant's store takes its own slot, and tenant 1's is freed last.
+  uint8_t *base1, *base2;
+  {
+    Store store1(engine), store2(engine);
+    base1 = base(store1, 1);
+    base2 = base(store2, 2);
+    ASSERT_NE(base1, base2);
+  }
+
+  // Both slots are affine to the module, but each tenant gets back its own
+  // slot rather than the one most recently freed.
+  for (int i = 0; i < 2; i++) {
+    {
+      Store store(engine);
+      EXPECT_EQ(base(store, 2), base2);
+    }
+    {
+      Store store(engine);
+      EXPECT_EQ(base(store, 1), base1);
+    }
+  }
+
+  auto stats = engine.pooling_stats();
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(stats->memory_affinity_misses, 2);
+  EXPECT_EQ(stats->memory_affinity_hits, 4);
+}
+
+TEST(Engine, NumaPlacement) {
+  PoolAllocationConfig pooling;
+  pooling.total_memories(1);
+  pooling.numa_local_memory(true);
+  Config config;
+  config.pooling_allocation_strategy(pooling);
+  Engine engine(std::move(config));
+  auto m = Module::compile(engine, "(module (memory 1))");
+  ASSERT_TRUE(m);
+
+  for (std::optional<uint32_t> node : {std::optional<uint32_t>(0),
+                                       std::optional<uint32_t>()}) {
+    Store store(engine);
+    store.context().set_numa_node(node);
+    EXPECT_TRUE(Instance::create(store, m.ok(), {}));
+  }
+}
+
+TEST(Engine, MemoryProtectionKeys) {
+  PoolAllocationConfig pooling;
+  pooling.total_memories(10);
+  pooling.max_memory_size(1 << 20);
+  pooling.memory_protection_keys(Enabled::Auto);
+  pooling.max_memory_protection_keys(2);
+  Config config;
+  config.pooling_allocation_strategy(pooling);
+  Engine engine(std::move(config));
+  auto m = Module::compile(engine, "(module (memory 1))");
+  ASSERT_TRUE(m);
+  Store store(engine);
+  EXPECT_TRUE(Instance::create(store, m.ok(), {}));
+}
+#endif
+
+#ifdef WASMTIME_FEATURE_STACK_SWITCHING
+TEST(Engine, ContinuationStackCacheStats) {
+  Config config;
+  config.continuation_stack_cache_size(4);
+  config.continuation_stack_keep_resident(4096);
+  Engine engine(std::move(config));
+
+  auto stats = engine.continuation_stack_cache_stats();
+  EXPECT_EQ(stats.cached_stacks, 0);
+  EXPECT_EQ(stats.hits, 0);
+  EXPECT_EQ(stats.misses, 0);
+}
+#endif
@@ -259,3 +259,266 @@ TEST(TypedFunc, WrapRuntime) {
                  .unwrap();
   EXPECT_EQ(ret, 3);
 }
+
+TEST(Func, CallWithSpans) {
+  Engine engine;
+  Store store(engine);
+  Func f(store, FuncType({ValKind::I32, ValKind::I64}, {ValKind::I64}),
+         [](auto caller, auto params, auto results) {
+           results[0] = params[0].i32() + params[1].i64();
+           return std::monostate();
+         });
+
+  size_t nresults = f.type(store)->results().size();
+  EXPECT_EQ(nresults, 1);
+  std::vector<Val> params = {int32_t(1), int64_t(2)};
+  std::vector<Val> results(nresults, int32_t(0));
+  for (int64_t i = 0; i < 3; i++) {
+    params[1] = i;
+    f.call(store, params, results).unwrap();
+    EXPECT_EQ(results[0].i64(), 1 + i);
+  }
+
+  Func trap(store, FuncType({}, {ValKind::I32}),
+            [](auto caller, auto params, auto results) {
+              return Trap("message");
+            });
+  std::vector<Val> none;
+  Val out(int32_t(5));
+  auto err = trap.call(store, none, Span<Val>(&out, 1)).err();
+  EXPECT_EQ(err.message(), "message");
+  EXPECT_EQ(out.i32(), 0);
+
+  // A mismatched amount of result storage is an error, not a trap.
+  EXPECT_FALSE(f.call(store, params, none));
+}
+
+TEST(Func, TypeIndex) {
+  Engine engine;
+  Store store(engine);
+  auto noop = [](auto caller, auto params, auto results) {
+    return std::monostate();
+  };
+  Func a(store, FuncType({ValKind::I32}, {}), noop);
+  Func b(store, FuncType({ValKind::I32}, {}), noop);
+  Func c(store, FuncType({ValKind::I64}, {}), noop);
+  EXPECT_EQ(a.type_index(store), b.type_index(store));
+  EXPECT_NE(a.type_index(store), c.type_index(store));
+
+  Func wrapped = Func::wrap(store, [](int32_t) {});
+  EXPECT_EQ(a.type_index(store), wrapped.type_index(store));
+
+  Store store2(engine);
+  Func d(store2, FuncType({ValKind::I32}, {}), noop);
+  EXPECT_EQ(a.type_index(store), d.type_index(store2));
+}
+
+TEST(TypedFunc, CallMany) {
+  Engine engine;
+  Store store(engine);
+
+  Func f = Func::wrap(store, [](int32_t a, int32_t b) -> Result<int32_t, Trap> {
+    if (b == 0) {
+      return Trap("division by zero");
+    }
+    return a / b;
+  });
+  auto func = f.typed<std::tuple<int32_t, int32_t>, int32_t>(store).unwrap();
+
+  std::vector<std::tuple<int32_t, int32_t>> params = {{6, 3}, {8, 2}, {9, 9}};
+  std::vector<int32_t> results(params.size());
+  func.call_many(store, params, results).unwrap();
+  EXPECT_EQ(results, (std::vector<int32_t>{2, 4, 1}));
+
+  params = {{4, 2}, {1, 0}, {3, 1}};
+  results = {0, 0, 0};
+  auto err = func.call_many(store, params, results).err();
+  EXPECT_EQ(err.index, 1);
+  EXPECT_EQ(err.message(), "division by zero");
+  EXPECT_EQ(results, (std::vector<int32_t>{2, 0, 0}));
+
+  // A scratch buffer is reused across calls once it's large enough.
+  std::vector<wasmtime_val_raw_t> scratch;
+  params = {{6, 3}, {8, 2}, {9, 9}};
+  func.call_many(store, params, results, scratch).unwrap();
+  EXPECT_EQ(results, (std::vector<int32_t>{2, 4, 1}));
+  const auto *buffer = scratch.data();
+  params = {{10, 5}, {8, 8}};
+  func.call_many(store, params, results, scratch).unwrap();
+  EXPECT_EQ(results, (std::vector<int32_t>{2, 1, 1}));
+  EXPECT_EQ(scratch.data(), buffer);
+
+  Func thunk = Func::wrap(store, []() {});
+  auto typed_thunk = thunk.typed<empty_t, empty_t>(store).unwrap();
+  std::vector<empty_t> none(4);
+  typed_thunk.call_many(store, none, none).unwrap();
+}
+
+TEST(TypedFunc, CallTrapCode) {
+  Engine engine;
+  Store store(engine);
+  Module m = Module::compile(engine, R"(
+    (module
+      (func (export "div") (param i32 i32) (result i32)
+        (i32.div_s (local.get 0) (local.get 1))))
+  )")
+                 .unwrap();
+  Instance i = Instance::create(store, m, {}).unwrap();
+  auto div = std::get<Func>(*i.get(store, "div"));
+  auto func = div.typed<std::tuple<int32_t, int32_t>, int32_t>(store).unwrap();
+
+  EXPECT_EQ(func.call_trap_code(store, {6, 3}).unwrap(), 2);
+  auto err = func.call_trap_code(store, {1, 0}).err();
+  EXPECT_EQ(err.code(), WASMTIME_TRAP_CODE_INTEGER_DIVISION_BY_ZERO);
+
+  Func host = Func::wrap(store, []() -> Result<std::monostate, Trap> {
+    return Trap("host failure");
+  });
+  auto typed_host = host.typed<empty_t, empty_t>(store).unwrap();
+  err = typed_host.call_trap_code(store, {}).err();
+  EXPECT_EQ(err.code(), std::nullopt);
+  EXPECT_NE(std::get<Error>(err.data).message().find("host failure"),
+            std::string::npos);
+}
+
+TEST(Func, NewUnchecked) {
+  Engine engine;
+  Store store(engine);
+  Func f = Func::new_unchecked(
+      store, FuncType({ValKind::I32, ValKind::I64}, {ValKind::I64}),
+      [](Caller caller, Span<wasmtime_val_raw_t> args_and_results)
+          -> Result<std::monostate, Trap> {
+        EXPECT_EQ(args_and_results.size(), 2);
+        int64_t sum = args_and_results[0].i32 + args_and_results[1].i64;
+        if (sum < 0) {
+          return Trap("negative");
+        }
+        args_and_results[0].i64 = sum;
+        return std::monostate();
+      });
+
+  auto func = f.typed<std::tuple<int32_t, int64_t>, int64_t>(store).unwrap();
+  EXPECT_EQ(func.call(store, {1, 2}).unwrap(), 3);
+  EXPECT_EQ(func.call(store, {-4, 2}).err().message(), "negative");
+}
+
+TEST(TypedFunc, I31) {
+  Config config;
+  config.wasm_gc(true);
+  config.wasm_function_references(true);
+  Engine engine(std::move(config));
+  Store store(engine);
+  Module m = Module::compile(engine, R"(
+    (module
+      (func (export "inc") (param i31ref) (result i31ref)
+        (ref.i31 (i32.add (i31.get_s (local.get 0)) (i32.const 1)))))
+  )")
+                 .unwrap();
+  Instance i = Instance::create(store, m, {}).unwrap();
+  auto inc = std::get<Func>(*i.get(store, "inc"))
+                 .typed<std::optional<I31>, std::optional<I31>>(store)
+                 .unwrap();
+  EXPECT_EQ(inc.call(store, I31(41)).unwrap(), I31(42));
+  EXPECT_EQ(inc.call(store, I31(-2)).unwrap()->i31(), -1);
+  EXPECT_EQ(inc.call(store, I31(0x3fffffff)).unwrap()->i31(), -0x40000000);
+
+  Func neg = Func::wrap(store, [](std::optional<I31> i) {
+    return std::optional<I31>(I31(i ? -i->i31() : 0));
+  });
+  auto typed_neg =
+      neg.typed<std::optional<I31>, std::optional<I31>>(store).unwrap();
+  EXPECT_EQ(typed_neg.call(store, I31(5)).unwrap(), I31(-5));
+  EXPECT_EQ(typed_neg.call(store, std::nullopt).unwrap(), I31(0));
+
+  AnyRef r = AnyRef::i31(store, int32_t(-7));
+  EXPECT_EQ(r.i31(store), -7);
+  EXPECT_EQ(r.u31(store), 0x7ffffff9);
+  AnyRef copy = r;
+  EXPECT_EQ(copy.i31(store), -7);
+}
+
+TEST(RawFunc, Call) {
+  Engine engine;
+  Store store(engine);
+  Module m = Module::compile(engine, R"(
+    (module
+      (func (export "add") (param i32 i64) (result i64)
+        (i64.add (i64.extend_i32_s (local.get 0)) (local.get 1)))
+      (func (export "trap") unreachable))
+  )")
+                 .unwrap();
+  Instance i = Instance::create(store, m, {}).unwrap();
+  auto add = std::get<Func>(*i.get(store, "add"));
+
+  EXPECT_FALSE(add.raw(store, FuncType({ValKind::I32}, {ValKind::I64})));
+  auto raw =
+      add.raw(store, FuncType({ValKind::I32, ValKind::I64}, {ValKind::I64}))
+          .unwrap();
+  EXPECT_EQ(raw.params(), 2);
+  EXPECT_EQ(raw.results(), 1);
+  EXPECT_EQ(raw.stride(), 2);
+
+  std::array<wasmtime_val_raw_t, 2> storage;
+  storage[0].i32 = -1;
+  storage[1].i64 = 10;
+  raw.call(store, storage).unwrap();
+  EXPECT_EQ(storage[0].i64, 9);
+
+  std::array<wasmtime_val_raw_t, 1> small;
+  EXPECT_FALSE(raw.call(store, small));
+
+  std::vector<wasmtime_val_raw_t> many(6);
+  for (size_t n = 0; n < 3; n++) {
+    many[n * 2].i32 = int32_t(n);
+    many[n * 2 + 1].i64 = 100;
+  }
+  raw.call_many(store, many, 3).unwrap();
+  for (size_t n = 0; n < 3; n++) {
+    EXPECT_EQ(many[n * 2].i64, 100 + int64_t(n));
+  }
+  EXPECT_EQ(raw.call_many(store, many, 4).err().index, 0);
+
+  auto trap = std::get<Func>(*i.get(store, "trap"))
+                  .raw(store, FuncType({}, {}))
+                  .unwrap();
+  EXPECT_EQ(trap.stride(), 0);
+  std::vector<wasmtime_val_raw_t> none;
+  Span<wasmtime_val_raw_t> empty(none);
+  EXPECT_FALSE(trap.call(store, empty));
+  EXPECT_EQ(trap.call_many(store, empty, 2).err().index, 0);
+}
+
+#ifdef WASMTIME_V128_SSE2
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+
+TEST(TypedFunc, Sse2) {
+  Engine engine;
+  Store store(engine);
+  Module m = Module::compile(engine, R"(
+    (module
+      (func (export "add") (param v128 v128) (result v128)
+        (i32x4.add (local.get 0) (local.get 1))))
+  )")
+                 .unwrap();
+  Instance i = Instance::create(store, m, {}).unwrap();
+  auto add = std::get<Func>(*i.get(store, "add"))
+                 .typed<std::tuple<__m128i, __m128i>, __m128i>(store)
+                 .unwrap();
+  __m128i a = _mm_setr_epi32(1, 2, 3, 4);
+  __m128i b = _mm_setr_epi32(10, 20, 30, 40);
+  alignas(16) int32_t out[4];
+  _mm_store_si128(reinterpret_cast<__m128i *>(out),
+                  add.call(store, {a, b}).unwrap());
+  EXPECT_EQ(out[0], 11);
+  EXPECT_EQ(out[3], 44);
+
+  Func scale = Func::wrap(store, [](__m128 v) { return _mm_add_ps(v, v); });
+  auto typed = scale.typed<__m128, __m128>(store).unwrap();
+  alignas(16) float f[4];
+  _mm_store_ps(f, typed.call(store, _mm_setr_ps(1, 2, 3, 4)).unwrap());
+  EXPECT_EQ(f[0], 2);
+  EXPECT_EQ(f[3], 8);
+}
+#endif
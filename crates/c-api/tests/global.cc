@@ -22,3 +22,22 @@ TEST(Global, Smoke) {
   EXPECT_EQ(g.type(store)->content().kind(), ValKind::I32);
   EXPECT_TRUE(g.type(store)->is_mutable());
 }
+
+TEST(Global, Typed) {
+  Engine engine;
+  Store store(engine);
+  Global g = Global::create(store, GlobalType(ValKind::I64, true), int64_t(4))
+                 .unwrap();
+  EXPECT_FALSE(g.typed<int32_t>(store));
+  auto typed = g.typed<int64_t>(store).unwrap();
+  EXPECT_EQ(typed.get(store), 4);
+  typed.set(store, 5).unwrap();
+  EXPECT_EQ(typed.get(store), 5);
+  EXPECT_EQ(g.get(store).i64(), 5);
+
+  Global c =
+      Global::create(store, GlobalType(ValKind::F64, false), 1.5).unwrap();
+  auto constant = c.typed<double>(store).unwrap();
+  EXPECT_EQ(constant.get(store), 1.5);
+  EXPECT_FALSE(constant.set(store, 2.0));
+}
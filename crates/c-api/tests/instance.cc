@@ -45,3 +45,140 @@ TEST(Instance, Smoke) {
   auto [name, func] = *i.get(store, 0);
   EXPECT_EQ(name, "f");
 }
+
+TEST(Instance, ExportIndex) {
+  Engine engine;
+  Module mod =
+      Module::compile(engine, "(module"
+                              "(func (export \"f\") (result i32) i32.const 7)"
+                              "(global (export \"g\") i32 (i32.const 0))"
+                              ")")
+          .unwrap();
+  EXPECT_FALSE(mod.export_index("not-present"));
+  ModuleExport f_index = *mod.export_index("f");
+  ModuleExport g_index = *mod.export_index("g");
+
+  for (int i = 0; i < 2; i++) {
+    Store store(engine);
+    Instance instance = Instance::create(store, mod, {}).unwrap();
+    Func f = std::get<Func>(*instance.get(store, f_index));
+    auto typed = f.typed<std::tuple<>, int32_t>(store).unwrap();
+    EXPECT_EQ(typed.call(store, {}).unwrap(), 7);
+    EXPECT_TRUE(std::holds_alternative<Global>(*instance.get(store, g_index)));
+  }
+
+  Module other =
+      Module::compile(engine, "(module (func (export \"f\")))").unwrap();
+  Store store(engine);
+  Instance instance = Instance::create(store, other, {}).unwrap();
+  EXPECT_FALSE(instance.get(store, f_index));
+}
+
+TEST(Instance, MemoryIndex) {
+  Engine engine;
+  Store store(engine);
+  Memory imported = Memory::create(store, MemoryType(1)).unwrap();
+  Func poke = Func::wrap(store, [](Caller caller, int32_t addr) {
+    Memory scratch = *caller.memory(1);
+    scratch.data(caller)[addr] = 42;
+  });
+
+  Module mod =
+      Module::compile(engine, "(module"
+                              "(import \"\" \"m\" (memory 1))"
+                              "(import \"\" \"f\" (func (param i32)))"
+                              "(memory (export \"scratch\") 1)"
+                              "(memory 1)"
+                              "(export \"m\" (memory 0))"
+                              "(func (export \"run\")"
+                              "  (call 0 (i32.const 3)))"
+                              ")")
+          .unwrap();
+  Instance i = Instance::create(store, mod, {imported, poke}).unwrap();
+
+  Memory m = *i.memory(store, 0);
+  EXPECT_EQ(m.data(store).data(), imported.data(store).data());
+  Memory scratch = *i.memory(store, 1);
+  EXPECT_EQ(scratch.data(store).data(),
+            std::get<Memory>(*i.get(store, "scratch")).data(store).data());
+  EXPECT_FALSE(i.memory(store, 2));
+  EXPECT_FALSE(i.memory(store, 3));
+
+  Func run = std::get<Func>(*i.get(store, "run"));
+  auto typed = run.typed<std::tuple<>, std::tuple<>>(store).unwrap();
+  typed.call(store, {}).unwrap();
+  EXPECT_EQ(scratch.data(store)[3], 42);
+}
+
+TEST(Instance, CallerMemoryData) {
+  Engine engine;
+  Store store(engine);
+  Func sum = Func::wrap(store, [](Caller caller, int32_t ptr, int32_t len) {
+    Span<uint8_t> data = *caller.memory_data();
+    int32_t total = 0;
+    for (int32_t i = 0; i < len; i++) {
+      total += data[ptr + i];
+    }
+    data[0] = static_cast<uint8_t>(total);
+  });
+
+  Module mod =
+      Module::compile(engine, "(module"
+                              "(import \"\" \"f\" (func (param i32 i32)))"
+                              "(memory (export \"memory\") 1)"
+                              "(data (i32.const 8) \"\\01\\02\\03\")"
+                              "(func (export \"run\")"
+                              "  (call 0 (i32.const 8) (i32.const 3)))"
+                              ")")
+          .unwrap();
+  Instance i = Instance::create(store, mod, {sum}).unwrap();
+  Func run = std::get<Func>(*i.get(store, "run"));
+  auto typed = run.typed<std::tuple<>, std::tuple<>>(store).unwrap();
+  typed.call(store, {}).unwrap();
+  Memory memory = std::get<Memory>(*i.get(store, "memory"));
+  EXPECT_EQ(memory.data(store)[0], 6);
+
+  Func missing = Func::wrap(store, [](Caller caller) {
+    EXPECT_FALSE(caller.memory_data());
+  });
+  Module hidden = Module::compile(engine, "(module"
+                                          "(import \"\" \"f\" (func $f))"
+                                          "(memory 1)"
+                                          "(start $f))")
+                      .unwrap();
+  Instance::create(store, hidden, {missing}).unwrap();
+}
+
+TEST(Instance, FunctionStats) {
+  Config config;
+  config.count_function_calls(true);
+  Engine engine(std::move(config));
+  Module module = Module::compile(engine, R"(
+    (module
+      (func $leaf)
+      (func (export "run")
+        call $leaf
+        call $leaf))
+  )")
+                      .unwrap();
+  Store store(engine);
+  Instance instance = Instance::create(store, module, {}).unwrap();
+  Func run = std::get<Func>(*instance.get(store, "run"));
+  run.call(store, {}).unwrap();
+
+  auto stats = instance.function_stats(store);
+  ASSERT_EQ(stats.size(), 2);
+  EXPECT_EQ(stats[0].index, 0);
+  EXPECT_EQ(stats[0].name, "leaf");
+  EXPECT_EQ(stats[0].calls, 2);
+  EXPECT_EQ(stats[1].index, 1);
+  EXPECT_EQ(stats[1].name, std::nullopt);
+  EXPECT_EQ(stats[1].calls, 1);
+
+  // Nothing is counted unless enabled.
+  Engine plain;
+  Module other = Module::compile(plain, "(module (func))").unwrap();
+  Store other_store(plain);
+  Instance other_instance = Instance::create(other_store, other, {}).unwrap();
+  EXPECT_TRUE(other_instance.function_stats(other_store).empty());
+}
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <thread>
+#include <vector>
 #include <wasmtime/linker.hh>
 
 using namespace wasmtime;
@@ -20,6 +22,13 @@ TEST(Linker, Smoke) {
   linker.func_wrap("a", "f2", []() {}).unwrap();
   linker.func_wrap("a", "f3", [](Caller arg) {}).unwrap();
   linker.func_wrap("a", "f4", [](Caller arg, int32_t a) {}).unwrap();
+  linker
+      .func_new_unchecked("a", "f5", FuncType({ValKind::I32}, {}),
+                          [](Caller caller, Span<wasmtime_val_raw_t> raw)
+                              -> Result<std::monostate, Trap> {
+                            return std::monostate();
+                          })
+      .unwrap();
   Module mod = Module::compile(engine, "(module)").unwrap();
   Instance i = Instance::create(store, mod, {}).unwrap();
   linker.define_instance(store, "x", i).unwrap();
@@ -106,3 +115,162 @@ TEST(Linker, DefineUnknownImportsAsDefaultValues) {
   Func f = std::get<Func>(*instance.get(store.context(), "x"));
   f.call(store.context(), {}).unwrap();
 }
+
+TEST(Linker, InstantiatePre) {
+  Engine engine;
+  Linker linker(engine);
+  linker.func_wrap("host", "get", []() { return int32_t(42); }).unwrap();
+  Module mod = Module::compile(engine, "(module"
+                                       "(import \"host\" \"get\" "
+                                       "(func $get (result i32)))"
+                                       "(func (export \"f\") (result i32)"
+                                       "call $get))")
+                   .unwrap();
+  Module missing =
+      Module::compile(engine, "(module (import \"host\" \"nope\" (func)))")
+          .unwrap();
+  EXPECT_FALSE(linker.instantiate_pre(missing));
+
+  InstancePre pre = linker.instantiate_pre(mod).unwrap();
+  EXPECT_EQ(pre.module().exports().size(), 1);
+  for (int i = 0; i < 3; i++) {
+    Store store(engine);
+    Instance instance = pre.instantiate(store).unwrap();
+    Func f = std::get<Func>(*instance.get(store, "f"));
+    auto typed = f.typed<std::tuple<>, int32_t>(store).unwrap();
+    EXPECT_EQ(typed.call(store, {}).unwrap(), 42);
+  }
+}
+
+TEST(Linker, Freeze) {
+  Engine engine;
+  Linker linker(engine);
+  linker.func_wrap("host", "get", []() { return int32_t(42); }).unwrap();
+  Module mod = Module::compile(engine, "(module"
+                                       "(import \"host\" \"get\" "
+                                       "(func $get (result i32)))"
+                                       "(func (export \"f\") (result i32)"
+                                       "call $get))")
+                   .unwrap();
+  FrozenLinker frozen = std::move(linker).freeze();
+  EXPECT_TRUE(frozen.instantiate_pre(mod));
+
+  std::vector<int32_t> results(4);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < results.size(); i++) {
+    threads.emplace_back([&, i, frozen] {
+      Store store(engine);
+      Instance instance = frozen.instantiate(store, mod).unwrap();
+      Func f = std::get<Func>(*instance.get(store, "f"));
+      auto typed = f.typed<std::tuple<>, int32_t>(store).unwrap();
+      results[i] = typed.call(store, {}).unwrap();
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (auto result : results) {
+    EXPECT_EQ(result, 42);
+  }
+}
+
+TEST(Linker, DefineFuncs) {
+  struct Env {
+    int32_t base = 0;
+    std::shared_ptr<bool> alive = std::make_shared<bool>(true);
+  };
+  using HostFunc = Linker::HostFunc<Env>;
+
+  Engine engine;
+  FuncType ty({}, {ValKind::I32});
+  std::vector<HostFunc> funcs = {
+      {"host", "a", ty,
+       [](Env &env, Caller, Span<const Val>, Span<Val> results)
+           -> Result<std::monostate, Trap> {
+         results[0] = env.base + 1;
+         return std::monostate();
+       }},
+      {"host", "b", ty,
+       [](Env &env, Caller, Span<const Val>, Span<Val> results)
+           -> Result<std::monostate, Trap> {
+         results[0] = env.base + 2;
+         return std::monostate();
+       }},
+  };
+  Env env;
+  env.base = 40;
+  std::weak_ptr<bool> alive = env.alive;
+
+  {
+    Linker linker(engine);
+    linker.define_funcs(funcs, std::move(env)).unwrap();
+    Module mod = Module::compile(engine, "(module"
+                                         "(import \"host\" \"a\" "
+                                         "(func $a (result i32)))"
+                                         "(import \"host\" \"b\" "
+                                         "(func $b (result i32)))"
+                                         "(func (export \"f\") (result i32)"
+                                         "call $a call $b i32.add))")
+                     .unwrap();
+    Store store(engine);
+    Instance instance = linker.instantiate(store, mod).unwrap();
+    Func f = std::get<Func>(*instance.get(store, "f"));
+    auto typed = f.typed<std::tuple<>, int32_t>(store).unwrap();
+    EXPECT_EQ(typed.call(store, {}).unwrap(), 83);
+    EXPECT_FALSE(alive.expired());
+  }
+  EXPECT_TRUE(alive.expired());
+}
+
+TEST(Linker, DefineLibrary) {
+  struct Env {
+    int32_t base = 0;
+    std::shared_ptr<bool> alive = std::make_shared<bool>(true);
+  };
+  using HostFunc = Linker::HostFunc<Env>;
+
+  FuncType ty({}, {ValKind::I32});
+  std::vector<HostFunc> funcs = {
+      {"host", "a", ty,
+       [](Env &env, Caller, Span<const Val>, Span<Val> results)
+           -> Result<std::monostate, Trap> {
+         results[0] = env.base + 1;
+         return std::monostate();
+       }},
+  };
+  Env env;
+  env.base = 40;
+  std::weak_ptr<bool> alive = env.alive;
+  auto library = std::make_unique<HostFuncLibrary<Env>>(funcs, std::move(env));
+
+  // Define the same library in linkers of two differently configured engines.
+  Engine engine1;
+  Config config;
+  config.cranelift_opt_level(OptLevel::None);
+  Engine engine2(std::move(config));
+  std::vector<Linker> linkers;
+  for (Engine *engine : {&engine1, &engine2}) {
+    linkers.emplace_back(*engine).define_library(*library).unwrap();
+  }
+  library->env().base = 41;
+  library.reset();
+  EXPECT_FALSE(alive.expired());
+
+  Engine *engines[] = {&engine1, &engine2};
+  for (size_t i = 0; i < 2; i++) {
+    Engine &engine = *engines[i];
+    Module mod = Module::compile(engine, "(module"
+                                         "(import \"host\" \"a\" "
+                                         "(func $a (result i32)))"
+                                         "(export \"a\" (func $a)))")
+                     .unwrap();
+    Store store(engine);
+    Instance instance = linkers[i].instantiate(store, mod).unwrap();
+    Func f = std::get<Func>(*instance.get(store, "a"));
+    auto typed = f.typed<std::tuple<>, int32_t>(store).unwrap();
+    EXPECT_EQ(typed.call(store, {}).unwrap(), 42);
+  }
+
+  linkers.clear();
+  EXPECT_TRUE(alive.expired());
+}
@@ -1,6 +1,8 @@
 #include <wasmtime/memory.hh>
 
+#include <cstdio>
 #include <gtest/gtest.h>
+#include <vector>
 #include <wasmtime.hh>
 
 using namespace wasmtime;
@@ -17,6 +19,64 @@ TEST(Memory, Smoke) {
   EXPECT_EQ(m.page_size(store), 1 << 16);
 }
 
+TEST(Memory, Populate) {
+  Config config;
+  config.memory_populate(true);
+  Engine engine(std::move(config));
+  Store store(engine);
+  Memory m = Memory::create(store, MemoryType(1)).unwrap();
+  EXPECT_EQ(m.grow(store, 1).unwrap(), 1);
+  EXPECT_EQ(m.grow_populated(store, 1).unwrap(), 2);
+  auto data = m.data(store);
+  EXPECT_EQ(data.size(), 3 << 16);
+  EXPECT_EQ(data[0], 0);
+  EXPECT_EQ(data[(3 << 16) - 1], 0);
+  EXPECT_FALSE(m.grow_populated(store, 1ull << 40));
+}
+
+TEST(Memory, DirtyPages) {
+  Engine engine;
+  Store store(engine);
+  Memory m = Memory::create(store, MemoryType(1)).unwrap();
+  auto initial = m.dirty_pages(store);
+  if (!initial) {
+    // Dirty page tracking isn't supported on this platform.
+    return;
+  }
+  EXPECT_TRUE(initial.ok_ref().empty());
+
+  m.data(store)[100] = 1;
+  auto dirty = m.dirty_pages(store).unwrap();
+  ASSERT_EQ(dirty.size(), 1);
+  EXPECT_LE(dirty[0].first, 100);
+  EXPECT_GT(dirty[0].second, 100);
+
+  // Host memories have no image to reset to.
+  EXPECT_FALSE(m.reset_dirty_to_image(store));
+}
+
+TEST(Memory, AccessHistogram) {
+  Config config;
+  config.memory_access_sampling(1);
+  Engine engine(std::move(config));
+  Store store(engine);
+  Module mod =
+      Module::compile(engine, "(module"
+                              "(memory (export \"m\") 2)"
+                              "(func (export \"load\") (param i32) (result i32)"
+                              "  (i32.load (local.get 0)))"
+                              ")")
+          .unwrap();
+  Instance i = Instance::create(store, mod, {}).unwrap();
+  Memory m = std::get<Memory>(*i.get(store, "m"));
+  EXPECT_EQ(m.access_histogram(store), (std::vector<uint64_t>{0, 0}));
+
+  Func load = std::get<Func>(*i.get(store, "load"));
+  load.call(store, {int32_t(65536)}).unwrap();
+  load.call(store, {int32_t(65540)}).unwrap();
+  EXPECT_EQ(m.access_histogram(store), (std::vector<uint64_t>{0, 2}));
+}
+
 TEST(Memory, OneBytePageSize) {
   Engine engine;
   Store store(engine);
@@ -43,3 +103,103 @@ TEST(Memory, OneBytePageSize) {
   EXPECT_EQ(mem.size(store), 2);
   EXPECT_EQ(mem.data(store).size(), 2);
 }
+
+TEST(Memory, ReadWrite) {
+  Engine engine;
+  Store store(engine);
+  Memory m = Memory::create(store, MemoryType(1)).unwrap();
+  const uint64_t end = 1 << 16;
+
+  std::vector<uint8_t> src = {1, 2, 3, 4};
+  m.write(store, 8, src).unwrap();
+  std::vector<uint8_t> dst(4);
+  m.read(store, 8, dst).unwrap();
+  EXPECT_EQ(dst, src);
+
+  m.copy_within(store, 10, 8, 4).unwrap();
+  m.read(store, 8, dst).unwrap();
+  EXPECT_EQ(dst, std::vector<uint8_t>({1, 2, 1, 2}));
+
+  m.fill(store, 0, 0xff, 4).unwrap();
+  EXPECT_EQ(m.data(store)[3], 0xff);
+  EXPECT_EQ(m.data(store)[4], 0);
+
+  // Out-of-bounds accesses fail without touching anything.
+  EXPECT_FALSE(m.write(store, end - 2, src));
+  EXPECT_EQ(m.data(store)[end - 1], 0);
+  EXPECT_FALSE(m.read(store, end + 1, Span<uint8_t>(dst.data(), 0)));
+  m.read(store, end, Span<uint8_t>(dst.data(), 0)).unwrap();
+  EXPECT_FALSE(m.copy_within(store, 0, end - 1, 2));
+  EXPECT_FALSE(m.fill(store, UINT64_MAX, 0, 2));
+}
+
+TEST(Memory, Vectored) {
+  Engine engine;
+  Store store(engine);
+  Memory m = Memory::create(store, MemoryType(1)).unwrap();
+
+  std::vector<uint8_t> a = {1, 2}, b = {3, 4, 5};
+  std::vector<Span<const uint8_t>> srcs = {a, b};
+  m.write_vectored(store, 100, srcs).unwrap();
+
+  std::vector<uint8_t> x(3), y(2);
+  std::vector<Span<uint8_t>> dsts = {x, y};
+  m.read_vectored(store, 100, dsts).unwrap();
+  EXPECT_EQ(x, std::vector<uint8_t>({1, 2, 3}));
+  EXPECT_EQ(y, std::vector<uint8_t>({4, 5}));
+
+  EXPECT_FALSE(m.write_vectored(store, (1 << 16) - 4, srcs));
+  EXPECT_EQ(m.data(store)[(1 << 16) - 4], 0);
+}
+
+TEST(Memory, View) {
+  Engine engine;
+  Store store(engine);
+  Memory m = Memory::create(store, MemoryType(1)).unwrap();
+
+  auto words = m.view<uint32_t, 4>(store, 8).unwrap();
+  static_assert(decltype(words)::extent == 4);
+  EXPECT_EQ(words.size(), 4);
+  words[1] = 0x01020304;
+  Span<const uint32_t> all = words;
+  EXPECT_EQ(all.size(), 4);
+  EXPECT_EQ(all.subspan(1)[0], 0x01020304);
+  EXPECT_EQ(words.first<2>()[1], 0x01020304);
+
+  auto read = m.view<const uint32_t>(store, 12, 1).unwrap();
+  EXPECT_EQ(read[0], 0x01020304);
+  EXPECT_EQ(m.data(store)[12], 0x04);
+
+  EXPECT_FALSE(m.view<uint32_t>(store, 1, 1));
+  EXPECT_FALSE(m.view<uint32_t>(store, (1 << 16) - 4, 2));
+  EXPECT_FALSE((m.view<uint64_t, 1>(store, 1 << 16)));
+  EXPECT_TRUE(m.view<uint8_t>(store, 1 << 16, 0));
+}
+
+#ifndef _WIN32
+TEST(Memory, MapFile) {
+  constexpr size_t page = 1 << 16;
+  FILE *file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  std::vector<uint8_t> contents(page, 0xab);
+  ASSERT_EQ(std::fwrite(contents.data(), 1, page, file), page);
+  ASSERT_EQ(std::fflush(file), 0);
+  int fd = fileno(file);
+
+  Engine engine;
+  Store store(engine);
+  Memory m = Memory::create(store, MemoryType(2)).unwrap();
+  m.map_file(store, page, fd, 0, page).unwrap();
+  EXPECT_FALSE(m.map_file(store, 1, fd, 0, page));
+  EXPECT_FALSE(m.map_file(store, 0, fd, 0, 2 * page));
+  EXPECT_FALSE(m.map_file(store, 2 * page, fd, 0, page));
+  std::fclose(file);
+
+  auto data = m.data(store);
+  EXPECT_EQ(data[page - 1], 0);
+  EXPECT_EQ(data[page], 0xab);
+  EXPECT_EQ(data[2 * page - 1], 0xab);
+  data[page] = 1;
+  EXPECT_EQ(m.data(store)[page], 1);
+}
+#endif
@@ -1,5 +1,7 @@
 #include <wasmtime/module.hh>
 
+#include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
 
 using namespace wasmtime;
@@ -10,7 +12,237 @@ TEST(Module, Simple) {
   auto wasm = wat2wasm("(module)").unwrap();
   Module::compile(engine, wasm).unwrap();
   Module::validate(engine, wasm).unwrap();
+  Module::compile_wat(engine, "(module)").unwrap();
+  EXPECT_FALSE(Module::compile_wat(engine, "(module"));
 
   auto serialized = m.serialize().unwrap();
   Module::deserialize(engine, serialized).unwrap();
 }
+
+TEST(Module, SerializeTo) {
+  Engine engine;
+  Module m = Module::compile(engine, "(module (func))").unwrap();
+
+  std::vector<uint8_t> written;
+  auto append = [&written](Span<const uint8_t> bytes) {
+    written.insert(written.end(), bytes.begin(), bytes.end());
+    return true;
+  };
+  m.serialize_to(append).unwrap();
+  EXPECT_EQ(written, m.serialize().unwrap());
+  Module::deserialize(engine, written).unwrap();
+
+  auto failed = m.serialize_to([](Span<const uint8_t>) { return false; });
+  EXPECT_FALSE(failed);
+}
+
+TEST(Module, InspectSerialized) {
+  Engine engine;
+  Module m = Module::compile(engine, "(module (func))").unwrap();
+  auto serialized = m.serialize().unwrap();
+
+  auto info = Module::inspect_serialized(engine, serialized).unwrap();
+  EXPECT_TRUE(info.compatible());
+  EXPECT_EQ(info.sizes.image_size, serialized.size());
+  EXPECT_GT(info.sizes.text_size, 0);
+
+  Config config;
+  config.memory_reservation(1 << 20);
+  Engine other(std::move(config));
+  info = Module::inspect_serialized(other, serialized).unwrap();
+  EXPECT_FALSE(info.compatible());
+
+  std::vector<uint8_t> garbage = {1, 2, 3};
+  EXPECT_FALSE(Module::inspect_serialized(engine, garbage));
+}
+
+TEST(Module, TypeViews) {
+  Engine engine;
+  Module m = Module::compile(engine, "(module"
+                                     "(import \"a\" \"b\" (func))"
+                                     "(global (export \"x\") i32 (i32.const 0))"
+                                     ")")
+                 .unwrap();
+
+  auto imports = m.import_types();
+  EXPECT_EQ(imports.size(), 1);
+  auto i = imports[0];
+  EXPECT_EQ(i.module(), "a");
+  EXPECT_EQ(i.name(), "b");
+  EXPECT_EQ(m.import_types().data(), imports.data());
+
+  auto exports = m.export_types();
+  EXPECT_EQ(exports.size(), 1);
+  auto e = exports[0];
+  EXPECT_EQ(e.name(), "x");
+  EXPECT_EQ(m.export_types().data(), exports.data());
+}
+
+TEST(Module, ResourceEstimate) {
+  Engine engine;
+  Module m = Module::compile(engine, "(module"
+                                     "(memory 2)"
+                                     "(table 10 funcref)"
+                                     "(data (i32.const 0) \"abc\"))")
+                 .unwrap();
+  auto estimate = m.resource_estimate();
+  EXPECT_GT(estimate.code_bytes, 0);
+  EXPECT_GT(estimate.data_bytes, 0);
+  EXPECT_EQ(estimate.memories, 1);
+  EXPECT_EQ(estimate.min_memory_bytes, 2 * 65536);
+  EXPECT_EQ(estimate.tables, 1);
+  EXPECT_EQ(estimate.min_table_elements, 10);
+  EXPECT_GT(estimate.instance_bytes, 0);
+}
+
+TEST(Module, SharedCodeRegistry) {
+  auto dir = std::filesystem::temp_directory_path() / "wasmtime-shared-code";
+  std::filesystem::remove_all(dir);
+
+  Engine engine;
+  auto serialized = Module::compile(engine, "(module)").unwrap().serialize();
+  auto bytes = serialized.unwrap();
+
+  auto registry = SharedCodeRegistry::create(dir.string()).unwrap();
+  Module m1 = registry.deserialize(engine, bytes).unwrap();
+  Module m2 = registry.deserialize(engine, bytes).unwrap();
+
+  std::vector<uint8_t> garbage = {1, 2, 3};
+  EXPECT_FALSE(registry.deserialize(engine, garbage));
+
+  auto files = std::filesystem::directory_iterator(dir);
+  EXPECT_EQ(std::distance(begin(files), end(files)), 1);
+}
+
+TEST(Module, CompileFile) {
+  auto path = std::filesystem::temp_directory_path() / "wasmtime-compile.wasm";
+  auto wasm = wat2wasm("(module (func (export \"f\")))").unwrap();
+  {
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(wasm.data()), wasm.size());
+  }
+
+  Engine engine;
+  Module m = Module::compile_file(engine, path.string()).unwrap();
+  EXPECT_EQ(m.exports().size(), 1);
+
+  std::filesystem::remove(path);
+  EXPECT_FALSE(Module::compile_file(engine, path.string()));
+}
+
+TEST(Module, DeserializeRaw) {
+  Engine engine;
+  auto serialized = Module::compile(engine, "(module)").unwrap().serialize();
+  auto bytes = serialized.unwrap();
+
+  bool released = false;
+  auto release = [&released] { released = true; };
+  {
+    Module m = Module::deserialize_raw(engine, bytes, release).unwrap();
+    EXPECT_FALSE(released);
+  }
+  EXPECT_TRUE(released);
+
+  released = false;
+  std::vector<uint8_t> garbage(16);
+  EXPECT_FALSE(Module::deserialize_raw(engine, garbage, release));
+  EXPECT_TRUE(released);
+}
+
+TEST(Module, PrecompileBatch) {
+  Engine engine;
+  auto a = wat2wasm("(module (func (export \"a\")))").unwrap();
+  auto b = wat2wasm("(module (func (export \"b\")))").unwrap();
+  auto artifacts = Module::precompile_batch(engine, {a, b, a}).unwrap();
+  ASSERT_EQ(artifacts.size(), 3);
+  EXPECT_EQ(artifacts[0], artifacts[2]);
+
+  for (auto &artifact : artifacts) {
+    Module m = Module::deserialize(engine, artifact).unwrap();
+    EXPECT_EQ(m.exports().size(), 1);
+  }
+
+  std::vector<uint8_t> invalid = {0, 1, 2};
+  EXPECT_FALSE(Module::precompile_batch(engine, {a, invalid}));
+}
+
+TEST(Module, TieredCompilation) {
+  Config config;
+  config.tiered_compilation(true);
+  Engine engine(std::move(config));
+  Module m = Module::compile(engine, "(module (func))").unwrap();
+
+  Module optimized = m.wait_optimized_tier().unwrap();
+  EXPECT_TRUE(m.optimized_tier().has_value());
+  EXPECT_FALSE(optimized.optimized_tier().has_value());
+
+  Engine plain;
+  Module untiered = Module::compile(plain, "(module)").unwrap();
+  EXPECT_FALSE(untiered.optimized_tier().has_value());
+  untiered.wait_optimized_tier().unwrap();
+}
+
+TEST(Module, CompileWithReport) {
+  Engine engine;
+  auto wasm =
+      wat2wasm("(module (func $f (result i32) i32.const 1) (func))").unwrap();
+  auto [module, report] = Module::compile_with_report(engine, wasm).unwrap();
+  EXPECT_EQ(module.exports().size(), 0);
+
+  ASSERT_EQ(report.size(), 2);
+  FunctionCompileStats f = report.get(0).value();
+  EXPECT_EQ(f.index, 0);
+  EXPECT_EQ(std::string_view(f.name, f.name_len), "f");
+  EXPECT_GT(f.code_size, 0);
+  EXPECT_GE(f.total_time_nanos, f.translation_time_nanos);
+  EXPECT_EQ(report.get(1).value().name, nullptr);
+  EXPECT_FALSE(report.get(2).has_value());
+}
+
+TEST(Module, CompileDeadline) {
+  auto wat = "(module (func))";
+
+  Config config;
+  config.compile_deadline(std::chrono::nanoseconds(0));
+  Engine engine(std::move(config));
+  auto result = Module::compile(engine, wat);
+  ASSERT_FALSE(result);
+  EXPECT_TRUE(result.err().compile_deadline_exceeded());
+
+  Config generous;
+  generous.compile_deadline(std::chrono::hours(1));
+  Engine ok(std::move(generous));
+  Module::compile(ok, wat).unwrap();
+  auto invalid = Module::compile(ok, "(module");
+  EXPECT_FALSE(invalid.err().compile_deadline_exceeded());
+}
+
+TEST(Module, Lazy) {
+  Engine engine;
+  EXPECT_FALSE(LazyModule::create(engine, "(module (func (result i32)))"));
+
+  auto lazy = LazyModule::create(engine, "(module (func))").unwrap();
+  EXPECT_FALSE(lazy.is_compiled());
+  lazy.warm();
+  Module module = lazy.get().unwrap();
+  EXPECT_TRUE(lazy.is_compiled());
+  lazy.get().unwrap();
+}
+
+TEST(Module, Builder) {
+  Engine engine;
+  auto wasm = wat2wasm("(module (func (export \"f\")))").unwrap();
+  Span<uint8_t> bytes = wasm;
+
+  ModuleBuilder builder(engine);
+  for (size_t i = 0; i < bytes.size(); i++) {
+    builder.feed(Span<uint8_t>(bytes.data() + i, 1)).unwrap();
+  }
+  Module module = builder.finish().unwrap();
+  EXPECT_EQ(module.exports().size(), 1);
+  EXPECT_FALSE(builder.finish());
+
+  ModuleBuilder truncated(engine);
+  truncated.feed(Span<uint8_t>(bytes.data(), bytes.size() - 1)).unwrap();
+  EXPECT_FALSE(truncated.finish());
+}
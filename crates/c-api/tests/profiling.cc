@@ -0,0 +1,47 @@
+#include <wasmtime/profiling.hh>
+
+#include <gtest/gtest.h>
+#include <wasmtime/instance.hh>
+
+#ifdef WASMTIME_FEATURE_PROFILING
+
+using namespace wasmtime;
+
+TEST(GuestProfiler, EpochSampling) {
+  Config config;
+  config.epoch_interruption(true);
+  Engine engine(std::move(config));
+  Module module =
+      Module::compile(engine, "(module (func $work (export \"work\")))")
+          .unwrap();
+  GuestProfiler profiler(engine, "multi-store", std::chrono::milliseconds(1),
+                         {{"guest", module}});
+
+  // Both stores feed the same profile, taking a sample on entry to `work`
+  // whenever the epoch has advanced.
+  Store a(engine);
+  Store b(engine);
+  profiler.attach(a);
+  profiler.attach(b);
+  for (Store *store : {&a, &b}) {
+    Instance instance = Instance::create(*store, module, {}).unwrap();
+    Func work = std::get<Func>(*instance.get(*store, "work"));
+    engine.increment_epoch();
+    work.call(*store, {}).unwrap();
+  }
+  profiler.sample(a);
+
+  auto profile = profiler.finish().unwrap();
+  std::string json(profile.begin(), profile.end());
+  EXPECT_NE(json.find("multi-store"), std::string::npos);
+  EXPECT_NE(json.find("work"), std::string::npos);
+
+  // Samples are ignored once the profile is finished, and it can't be
+  // finished twice.
+  engine.increment_epoch();
+  Instance instance = Instance::create(a, module, {}).unwrap();
+  std::get<Func>(*instance.get(a, "work")).call(a, {}).unwrap();
+  EXPECT_FALSE(profiler.finish());
+}
+
+#endif // WASMTIME_FEATURE_PROFILING
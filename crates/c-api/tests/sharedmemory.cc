@@ -0,0 +1,113 @@
+#include <wasmtime/sharedmemory.hh>
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <wasmtime.hh>
+
+using namespace wasmtime;
+
+static SharedMemory create_shared(Engine &engine) {
+  MemoryType ty =
+      MemoryType::Builder().min(1).max(2).shared(true).build().unwrap();
+  return SharedMemory::create(engine, ty).unwrap();
+}
+
+TEST(SharedMemory, Smoke) {
+  Engine engine;
+  SharedMemory mem = create_shared(engine);
+  EXPECT_EQ(mem.size(), 1);
+  EXPECT_EQ(mem.data().size(), 1 << 16);
+  EXPECT_TRUE(mem.type()->is_shared());
+  EXPECT_EQ(mem.grow(1).unwrap(), 1);
+  EXPECT_EQ(mem.size(), 2);
+
+  SharedMemory copy = mem;
+  EXPECT_EQ(copy.size(), 2);
+}
+
+TEST(SharedMemory, Atomics) {
+  Engine engine;
+  SharedMemory mem = create_shared(engine);
+
+  mem.atomic_store<uint32_t>(4, 10).unwrap();
+  EXPECT_EQ(mem.atomic_load<uint32_t>(4).unwrap(), 10);
+  EXPECT_EQ(mem.atomic_cmpxchg<uint32_t>(4, 11, 12).unwrap(), 10);
+  EXPECT_EQ(mem.atomic_cmpxchg<uint32_t>(4, 10, 12).unwrap(), 10);
+  EXPECT_EQ(mem.atomic_load<uint32_t>(4).unwrap(), 12);
+
+  mem.atomic_store<uint64_t>(8, 1ull << 40).unwrap();
+  EXPECT_EQ(mem.atomic_load<uint64_t>(8).unwrap(), 1ull << 40);
+  EXPECT_EQ(mem.data()[13], 1);
+
+  // Misaligned and out-of-bounds accesses fail like wasm's atomics.
+  EXPECT_FALSE(mem.atomic_load<uint32_t>(2));
+  EXPECT_FALSE(mem.atomic_load<uint64_t>(4));
+  EXPECT_FALSE(mem.atomic_store<uint32_t>(1 << 16, 0));
+  EXPECT_FALSE(mem.atomic_notify(1 << 16, 1));
+}
+
+TEST(SharedMemory, WaitNotify) {
+  Engine engine;
+  SharedMemory mem = create_shared(engine);
+
+  EXPECT_EQ(mem.atomic_wait<uint32_t>(0, 1).unwrap(), WaitResult::Mismatch);
+  EXPECT_EQ(
+      mem.atomic_wait<uint64_t>(0, 0, std::chrono::milliseconds(1)).unwrap(),
+      WaitResult::TimedOut);
+
+  std::thread waiter([mem] {
+    EXPECT_EQ(mem.atomic_wait<uint32_t>(0, 0).unwrap(), WaitResult::Ok);
+  });
+  // Keep notifying until the waiter has started waiting and been woken.
+  while (mem.atomic_notify(0, 1).unwrap() == 0) {
+    std::this_thread::yield();
+  }
+  waiter.join();
+}
+
+TEST(SharedMemory, Import) {
+  Engine engine;
+  SharedMemory mem = create_shared(engine);
+  Store store(engine);
+  Linker linker(engine);
+  linker.define(store, "env", "memory", mem).unwrap();
+
+  Module m = Module::compile(engine, "(module"
+                                     "(import \"env\" \"memory\" "
+                                     "(memory 1 2 shared))"
+                                     "(func (export \"load\") (result i32)"
+                                     "i32.const 16 i32.atomic.load))")
+                 .unwrap();
+  Instance instance = linker.instantiate(store, m).unwrap();
+  Func load = std::get<Func>(*instance.get(store, "load"));
+  auto typed = load.typed<std::tuple<>, int32_t>(store).unwrap();
+
+  mem.atomic_store<uint32_t>(16, 42).unwrap();
+  EXPECT_EQ(typed.call(store, {}).unwrap(), 42);
+}
+
+TEST(SharedMemory, AtomicHook) {
+  Engine engine;
+  SharedMemory mem = create_shared(engine);
+  auto events = std::make_shared<std::vector<SharedMemoryEvent>>();
+  mem.set_atomic_hook(
+      [events](const SharedMemoryEvent &e) { events->push_back(e); });
+
+  EXPECT_EQ(mem.atomic_wait<uint32_t>(8, 1).unwrap(), WaitResult::Mismatch);
+  EXPECT_EQ(mem.atomic_notify(8, 3).unwrap(), 0);
+  ASSERT_EQ(events->size(), 2);
+  EXPECT_EQ((*events)[0].kind, SharedMemoryEvent::Kind::Wait);
+  EXPECT_EQ((*events)[0].addr, 8);
+  EXPECT_EQ((*events)[1].kind, SharedMemoryEvent::Kind::Notify);
+  EXPECT_EQ((*events)[1].addr, 8);
+  EXPECT_EQ((*events)[1].count, 3);
+  EXPECT_EQ((*events)[1].woken, 0);
+
+  // The hook is released once it's removed.
+  mem.clear_atomic_hook();
+  mem.atomic_notify(8, 1).unwrap();
+  EXPECT_EQ(events->size(), 2);
+  EXPECT_EQ(events.use_count(), 1);
+}
@@ -5,7 +5,9 @@
 #include <wasmtime/error.hh>
 #include <wasmtime/func.hh>
 #include <wasmtime/instance.hh>
+#include <wasmtime/memory.hh>
 #include <wasmtime/module.hh>
+#include <wasmtime/table.hh>
 
 using namespace wasmtime;
 
@@ -81,3 +83,234 @@ TEST(Store, EpochDeadlineCallback) {
   EXPECT_TRUE(result.err().message().find("error from callback") !=
               std::string::npos);
 }
+
+TEST(Store, Reset) {
+  Engine engine;
+  Store store(engine);
+  store.limiter(-1, -1, 1, -1, -1);
+  store.context().set_data(42);
+
+  Module m = unwrap(Module::compile(engine, "(module (func (export \"f\")))"));
+  unwrap(Instance::create(store, m, {}));
+  EXPECT_FALSE(Instance::create(store, m, {}));
+
+  store.reset();
+  EXPECT_EQ(std::any_cast<int>(store.context().get_data()), 42);
+
+  Instance i = unwrap(Instance::create(store, m, {}));
+  auto f = std::get<Func>(*i.get(store, "f"));
+  unwrap(f.call(store, {}));
+  EXPECT_FALSE(Instance::create(store, m, {}));
+}
+
+TEST(Store, DataPtr) {
+  Engine engine;
+  Store store(engine);
+  EXPECT_EQ(store.context().get_data_ptr(), nullptr);
+
+  int state = 3;
+  store.context().set_data_ptr(&state);
+  store.context().set_data(std::string("unrelated"));
+
+  Func f(store, FuncType({}, {}),
+         [](auto caller, auto params,
+            auto results) -> Result<std::monostate, Trap> {
+           *caller.context().template get_data_ptr<int>() += 1;
+           return std::monostate();
+         });
+  unwrap(f.call(store, {}));
+  EXPECT_EQ(state, 4);
+  EXPECT_EQ(std::any_cast<std::string>(store.context().get_data()),
+            "unrelated");
+}
+
+TEST(Store, ResourceUsage) {
+  Config config;
+  config.consume_fuel(true);
+  Engine engine(std::move(config));
+  Store store(engine);
+  auto usage = store.context().resource_usage();
+  EXPECT_EQ(usage.instances, 0);
+  EXPECT_EQ(usage.memory_bytes, 0);
+
+  Module m = unwrap(Module::compile(engine, R"(
+    (module
+      (memory (export "m") 1)
+      (table 3 funcref)
+      (func (export "f") nop nop nop)
+    )
+  )"));
+
+  // Without a limiter only the counts the store keeps itself are reported.
+  Instance i = unwrap(Instance::create(store, m, {}));
+  usage = store.context().resource_usage();
+  EXPECT_EQ(usage.instances, 1);
+  EXPECT_EQ(usage.memory_bytes, 0);
+  store.reset();
+
+  store.limiter(-1, -1, -1, -1, -1);
+  i = unwrap(Instance::create(store, m, {}));
+  auto mem = std::get<Memory>(*i.get(store, "m"));
+  unwrap(mem.grow(store, 1));
+
+  unwrap(store.context().set_fuel(100));
+  auto f = std::get<Func>(*i.get(store, "f"));
+  unwrap(f.call(store, {}));
+
+  usage = store.context().resource_usage();
+  EXPECT_EQ(usage.instances, 1);
+  EXPECT_EQ(usage.memories, 1);
+  EXPECT_EQ(usage.tables, 1);
+  EXPECT_EQ(usage.memory_bytes, 2 * 65536);
+  EXPECT_EQ(usage.table_elements, 3);
+  EXPECT_GT(usage.fuel_consumed, 0);
+  EXPECT_EQ(usage.fuel_consumed, 100 - unwrap(store.context().get_fuel()));
+
+  store.reset();
+  usage = store.context().resource_usage();
+  EXPECT_EQ(usage.instances, 0);
+  EXPECT_EQ(usage.memory_bytes, 0);
+}
+
+TEST(Store, Hibernate) {
+  Engine engine;
+  Store store(engine);
+  Module m = unwrap(Module::compile(engine, R"(
+    (module
+      (memory (export "m") 1)
+      (func (export "load") (result i32) (i32.load8_u (i32.const 0)))
+      (data (i32.const 0) "x")
+    )
+  )"));
+  Instance i = unwrap(Instance::create(store, m, {}));
+  auto mem = std::get<Memory>(*i.get(store, "m"));
+
+  EXPECT_GT(unwrap(store.context().hibernate()), 0);
+  EXPECT_TRUE(store.context().is_hibernating());
+  EXPECT_EQ(mem.data(store)[0], 0);
+  EXPECT_FALSE(store.context().hibernate());
+
+  auto load = std::get<Func>(*i.get(store, "load"));
+  auto results = unwrap(load.call(store, {}));
+  EXPECT_EQ(results[0].i32(), 'x');
+  EXPECT_FALSE(store.context().is_hibernating());
+
+  unwrap(store.context().hibernate());
+  unwrap(store.context().resume());
+  EXPECT_EQ(mem.data(store)[0], 'x');
+}
+
+TEST(Store, Enter) {
+  Engine engine;
+  Store store(engine);
+  Module m = unwrap(Module::compile(engine, R"(
+    (module
+      (global $g (mut i32) (i32.const 0))
+      (func (export "incr") (result i32)
+        (global.set $g (i32.add (global.get $g) (i32.const 1)))
+        (global.get $g))
+    )
+  )"));
+  Instance i = unwrap(Instance::create(store, m, {}));
+  auto incr = std::get<Func>(*i.get(store, "incr"));
+
+  {
+    auto scope = unwrap(store.context().enter());
+    auto nested = unwrap(store.context().enter());
+    for (int n = 1; n <= 100; n++) {
+      auto results = unwrap(incr.call(store, {}));
+      EXPECT_EQ(results[0].i32(), n);
+    }
+  }
+  auto *error = wasmtime_context_exit(store.context().capi());
+  EXPECT_NE(error, nullptr);
+  wasmtime_error_delete(error);
+  auto results = unwrap(incr.call(store, {}));
+  EXPECT_EQ(results[0].i32(), 101);
+}
+
+TEST(Store, GcStats) {
+  Config config;
+  config.wasm_gc(true);
+  config.wasm_function_references(true);
+  config.collector(Collector::DeferredReferenceCounting);
+  Engine engine(std::move(config));
+  Store store(engine);
+  auto stats = store.context().gc_stats();
+  EXPECT_EQ(stats.collections, 0);
+  EXPECT_EQ(stats.heap_size, 0);
+
+  Module m = unwrap(Module::compile(engine, R"(
+    (module
+      (type $s (struct (field i64)))
+      (func (export "f")
+        (drop (struct.new $s (i64.const 1))))
+    )
+  )"));
+  Instance i = unwrap(Instance::create(store, m, {}));
+  auto f = std::get<Func>(*i.get(store, "f"));
+  for (int n = 0; n < 10; n++) {
+    unwrap(f.call(store, {}));
+  }
+
+  stats = store.context().gc_stats();
+  EXPECT_GT(stats.allocated_bytes, 0);
+  EXPECT_GE(stats.heap_size, stats.allocated_bytes);
+  auto allocated = stats.allocated_bytes;
+
+  unwrap(store.context().gc());
+  stats = store.context().gc_stats();
+  EXPECT_EQ(stats.collections, 1);
+  EXPECT_GT(stats.bytes_freed, 0);
+  EXPECT_EQ(stats.allocated_bytes, allocated - stats.bytes_freed);
+  EXPECT_LE(stats.max_pause_nanos, stats.total_pause_nanos);
+
+  store.reset();
+  stats = store.context().gc_stats();
+  EXPECT_EQ(stats.collections, 0);
+}
+
+TEST(Store, ResourceLimiter) {
+  struct Budget {
+    size_t *remaining;
+
+    Result<bool> memory_growing(size_t current, size_t desired,
+                                std::optional<size_t> maximum) {
+      size_t delta = desired - current;
+      if (delta > *remaining) {
+        return false;
+      }
+      *remaining -= delta;
+      return true;
+    }
+
+    Result<bool> table_growing(size_t current, size_t desired,
+                               std::optional<size_t> maximum) {
+      if (desired > 10) {
+        return Error("table too large");
+      }
+      return true;
+    }
+  };
+
+  Engine engine;
+  size_t remaining = 3 * 65536;
+  Store store(engine);
+  store.resource_limiter(Budget{&remaining});
+
+  Module m = unwrap(Module::compile(engine, R"(
+    (module (memory (export "m") 1) (table (export "t") 1 funcref))
+  )"));
+  Instance i = unwrap(Instance::create(store, m, {}));
+  EXPECT_EQ(remaining, 2 * 65536);
+
+  auto mem = std::get<Memory>(*i.get(store, "m"));
+  EXPECT_TRUE(mem.grow(store, 2));
+  EXPECT_EQ(remaining, 0);
+  EXPECT_FALSE(mem.grow(store, 1));
+
+  auto table = std::get<Table>(*i.get(store, "t"));
+  EXPECT_TRUE(table.grow(store, 1, std::optional<Func>()));
+  auto result = table.grow(store, 10, std::optional<Func>());
+  EXPECT_FALSE(result);
+}
@@ -23,3 +23,33 @@ TEST(Table, Smoke) {
   EXPECT_EQ(t.size(store), 5);
   EXPECT_EQ(t.type(store)->element().kind(), ValKind::FuncRef);
 }
+
+TEST(Table, Range) {
+  Engine engine;
+  Store store(engine);
+  Func f(store, FuncType({}, {}),
+         [](auto caller, auto params, auto results) {
+           return std::monostate();
+         });
+  Val null = std::optional<Func>();
+  Table t =
+      Table::create(store, TableType(ValKind::FuncRef, 10), null).unwrap();
+
+  t.fill(store, 2, f, 3).unwrap();
+  t.fill(store, 8, f, 3).err();
+  t.fill(store, 0, 1, 1).err();
+
+  std::vector<Val> vals(4, 0);
+  EXPECT_TRUE(t.get_range(store, 1, vals));
+  EXPECT_FALSE(vals[0].funcref());
+  EXPECT_TRUE(vals[1].funcref());
+  EXPECT_TRUE(vals[3].funcref());
+  EXPECT_FALSE(t.get_range(store, 7, vals));
+
+  std::vector<Val> nulls(2, null);
+  t.set_range(store, 2, nulls).unwrap();
+  t.set_range(store, 9, nulls).err();
+  EXPECT_FALSE(t.get(store, 2)->funcref());
+  EXPECT_FALSE(t.get(store, 3)->funcref());
+  EXPECT_TRUE(t.get(store, 4)->funcref());
+}
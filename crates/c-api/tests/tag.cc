@@ -0,0 +1,82 @@
+#include <wasmtime/tag.hh>
+
+#include <gtest/gtest.h>
+#include <wasmtime.hh>
+
+using namespace wasmtime;
+
+static Engine exceptions_engine() {
+  Config config;
+  config.wasm_exceptions(true);
+  return Engine(std::move(config));
+}
+
+TEST(Tag, Smoke) {
+  Engine engine = exceptions_engine();
+  Store store(engine);
+  Tag tag = Tag::create(store, FuncType({ValKind::I32}, {})).unwrap();
+  EXPECT_EQ(tag.type(store)->params().size(), 1);
+  EXPECT_TRUE(tag.same(store, tag));
+
+  Tag other = Tag::create(store, FuncType({ValKind::I32}, {})).unwrap();
+  EXPECT_FALSE(tag.same(store, other));
+
+  EXPECT_FALSE(Tag::create(store, FuncType({}, {ValKind::I32})));
+}
+
+TEST(Tag, Exceptions) {
+  Engine engine = exceptions_engine();
+  Module m = Module::compile(engine, R"(
+    (module
+      (import "" "tag" (tag $t (param i32)))
+      (import "" "throw" (func $throw (param i32)))
+      (func (export "catch") (param i32) (result i32)
+        (block $h (result i32)
+          (try_table (catch $t $h)
+            local.get 0
+            call $throw)
+          i32.const -1))
+      (func (export "uncaught") (param i32)
+        local.get 0
+        call $throw)
+      (func (export "guest") (param i32)
+        local.get 0
+        throw $t)
+    )
+  )")
+                 .unwrap();
+  Store store(engine);
+  Tag tag = Tag::create(store, FuncType({ValKind::I32}, {})).unwrap();
+  Func thrower(store, FuncType({ValKind::I32}, {}),
+               [&tag](auto caller, auto params,
+                      auto results) -> Result<std::monostate, Trap> {
+                 auto exn =
+                     ExnRef::create(caller, tag, {params[0].i32()}).unwrap();
+                 return ExnRef::throw_exception(caller, std::move(exn));
+               });
+  Instance i = Instance::create(store, m, {tag, thrower}).unwrap();
+
+  // Exceptions thrown by the host are caught by the guest.
+  auto catch_ = std::get<Func>(*i.get(store, "catch"));
+  auto results = catch_.call(store, {42}).unwrap();
+  EXPECT_EQ(results[0].i32(), 42);
+  EXPECT_FALSE(ExnRef::has_pending(store));
+
+  // Exceptions which aren't caught are returned to the host.
+  for (auto name : {"uncaught", "guest"}) {
+    auto func = std::get<Func>(*i.get(store, name));
+    EXPECT_FALSE(func.call(store, {7}));
+    EXPECT_TRUE(ExnRef::has_pending(store));
+    auto exn = ExnRef::take_pending(store);
+    ASSERT_TRUE(exn);
+    EXPECT_FALSE(ExnRef::has_pending(store));
+    EXPECT_TRUE(exn->tag(store).unwrap().same(store, tag));
+    EXPECT_EQ(exn->field_count(store), 1);
+    EXPECT_EQ(exn->field(store, 0).unwrap().i32(), 7);
+    EXPECT_FALSE(exn->field(store, 1));
+  }
+  EXPECT_FALSE(ExnRef::take_pending(store));
+
+  // Payloads are checked against the tag's type.
+  EXPECT_FALSE(ExnRef::create(store, tag, {}));
+}
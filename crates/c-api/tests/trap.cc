@@ -1,5 +1,6 @@
 #include <wasmtime/trap.hh>
 
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <wasmtime.hh>
 
@@ -44,6 +45,92 @@ TEST(Trap, Smoke) {
               std::string::npos);
 }
 
+TEST(Trap, Static) {
+  Trap t = Trap::from_static(42, "static failure");
+  EXPECT_EQ(t.message(), "static failure");
+  EXPECT_EQ(t.static_code(), 42);
+  EXPECT_EQ(t.code(), std::nullopt);
+  EXPECT_EQ(Trap("foo").static_code(), std::nullopt);
+
+  Engine engine;
+  Store store(engine);
+  Func host = Func::wrap(store, []() -> Result<std::monostate, Trap> {
+    return Trap::from_static(7, "host failure");
+  });
+  auto err = std::get<Error>(host.call(store, {}).err().data);
+  EXPECT_EQ(err.static_code(), 7);
+  EXPECT_NE(err.message().find("host failure"), std::string::npos);
+  EXPECT_EQ(Error("foo").static_code(), std::nullopt);
+}
+
+TEST(Trap, BacktraceDisabled) {
+  Engine engine;
+  Module m =
+      Module::compile(engine, "(module (func (export \"\") unreachable))")
+          .unwrap();
+  Store store(engine);
+  store.context().set_wasm_backtrace(false);
+  Instance i = Instance::create(store, m, {}).unwrap();
+  auto func = std::get<Func>(*i.get(store, ""));
+  auto trap = std::get<Trap>(func.call(store, {}).err().data);
+  EXPECT_EQ(trap.code(), WASMTIME_TRAP_CODE_UNREACHABLE_CODE_REACHED);
+  EXPECT_EQ(trap.trace().size(), 0);
+
+  store.context().set_wasm_backtrace(true);
+  trap = std::get<Trap>(func.call(store, {}).err().data);
+  EXPECT_EQ(trap.trace().size(), 1);
+}
+
+#ifdef WASMTIME_FEATURE_COREDUMP
+TEST(Trap, Coredump) {
+  Config config;
+  config.coredump_on_trap(true);
+  Engine engine(std::move(config));
+  Module m = Module::compile(engine, R"(
+    (module
+      (memory (export "memory") 1)
+      (data (i32.const 0) "hello")
+      (data (i32.const 0x8000) "world")
+      (func (export "") unreachable))
+  )")
+                 .unwrap();
+  Store store(engine);
+  Instance i = Instance::create(store, m, {}).unwrap();
+  auto func = std::get<Func>(*i.get(store, ""));
+  auto trap = std::get<Trap>(func.call(store, {}).err().data);
+
+  auto contains = [](const std::vector<uint8_t> &dump, std::string_view s) {
+    return std::search(dump.begin(), dump.end(), s.begin(), s.end()) !=
+           dump.end();
+  };
+  auto all = coredump(trap, store, "all").value();
+  EXPECT_TRUE(contains(all, "hello"));
+  EXPECT_TRUE(contains(all, "world"));
+
+  auto none = coredump(trap, store, "none", CoreDumpMemory::none()).value();
+  EXPECT_FALSE(contains(none, "hello"));
+  EXPECT_FALSE(contains(none, "world"));
+  EXPECT_LT(none.size(), all.size());
+
+  auto some = coredump(trap, store, "some",
+                       CoreDumpMemory::only({{0, 0x8000, 16}}))
+                  .value();
+  EXPECT_FALSE(contains(some, "hello"));
+  EXPECT_TRUE(contains(some, "world"));
+
+  Engine plain;
+  Store plain_store(plain);
+  Module plain_module =
+      Module::compile(plain, "(module (func (export \"\") unreachable))")
+          .unwrap();
+  Instance i3 = Instance::create(plain_store, plain_module, {}).unwrap();
+  auto plain_func = std::get<Func>(*i3.get(plain_store, ""));
+  auto plain_trap =
+      std::get<Trap>(plain_func.call(plain_store, {}).err().data);
+  EXPECT_EQ(coredump(plain_trap, plain_store, "plain"), std::nullopt);
+}
+#endif // WASMTIME_FEATURE_COREDUMP
+
 TEST(Trap, Codes) {
 #define TEST_CODE(trapcode)                                                    \
   EXPECT_EQ(Trap(WASMTIME_TRAP_CODE_##trapcode).code(),                        \
@@ -154,3 +154,113 @@ TEST(Val, DropsExternRef) {
   store.gc();
   EXPECT_TRUE(flag->load());
 }
+
+TEST(Val, RootScope) {
+  std::shared_ptr<std::atomic<bool>> flag;
+  Engine engine;
+  Store store(engine);
+
+  {
+    RootScope scope(store);
+    SetOnDrop guard;
+    flag = guard.flag();
+    ExternRef r(store, std::make_shared<SetOnDrop>(std::move(guard)));
+    ExternRef copy = r;
+    Val val = copy;
+    EXPECT_EQ(val.kind(), ValKind::ExternRef);
+
+    AnyRef i = AnyRef::i31(store, 7);
+    AnyRef i_copy = i;
+    EXPECT_EQ(i_copy.i31(store), 7);
+
+    // Values in the scope remain rooted until the scope is exited.
+    store.gc().unwrap();
+    EXPECT_FALSE(flag->load());
+    auto data = std::any_cast<std::shared_ptr<SetOnDrop>>(r.data(store));
+    EXPECT_NE(data, nullptr);
+  }
+  store.gc().unwrap();
+  EXPECT_TRUE(flag->load());
+}
+
+TEST(Val, ExternRefU64) {
+  Engine engine;
+  Store store(engine);
+
+  ExternRef r = ExternRef::u64(store, 0x1234'5678'9abc'def0);
+  EXPECT_EQ(r.u64(store), 0x1234'5678'9abc'def0);
+  ExternRef copy = r;
+  EXPECT_EQ(copy.u64(store), 0x1234'5678'9abc'def0);
+
+  Val val = r;
+  EXPECT_EQ(val.externref()->u64(store), 0x1234'5678'9abc'def0);
+
+  ExternRef boxed(store, 5);
+  EXPECT_EQ(boxed.u64(store), std::nullopt);
+}
+
+TEST(Val, ArrayRef) {
+  Config config;
+  config.wasm_gc(true);
+  config.wasm_function_references(true);
+  Engine engine(std::move(config));
+  Store store(engine);
+  Module m = Module::compile(engine, R"(
+    (module
+      (type $bytes (array i8))
+      (type $floats (array (mut f64)))
+      (func (export "bytes") (result anyref)
+        (array.new_fixed $bytes 3 (i32.const 1) (i32.const 2) (i32.const 0x103)))
+      (func (export "floats") (param i32) (result anyref)
+        (array.new $floats (f64.const 1.5) (local.get 0)))
+      (func (export "sum") (param anyref) (result f64)
+        (local $a (ref $floats))
+        (local $i i32)
+        (local $sum f64)
+        (local.set $a (ref.cast (ref $floats) (local.get 0)))
+        (block $done
+          (loop $loop
+            (br_if $done (i32.ge_u (local.get $i) (array.len (local.get $a))))
+            (local.set $sum
+              (f64.add (local.get $sum)
+                       (array.get $floats (local.get $a) (local.get $i))))
+            (local.set $i (i32.add (local.get $i) (i32.const 1)))
+            (br $loop)))
+        (local.get $sum)))
+  )")
+                 .unwrap();
+  Instance i = Instance::create(store, m, {}).unwrap();
+  auto bytes_fn = std::get<Func>(*i.get(store, "bytes"));
+  auto floats_fn = std::get<Func>(*i.get(store, "floats"));
+  auto sum_fn = std::get<Func>(*i.get(store, "sum"));
+
+  EXPECT_FALSE(AnyRef::i31(store, 1u).is_array(store));
+  EXPECT_FALSE(AnyRef::i31(store, 1u).as_array(store));
+
+  AnyRef bytes = *bytes_fn.call(store, {}).unwrap()[0].anyref();
+  EXPECT_TRUE(bytes.is_array(store));
+  auto bytes_array = bytes.as_array(store);
+  ASSERT_TRUE(bytes_array);
+  EXPECT_EQ(bytes_array->len(store).unwrap(), 3);
+  auto data = bytes_array->data<uint8_t>(store).unwrap();
+  ASSERT_EQ(data.size(), 3);
+  EXPECT_EQ(data[0], 1);
+  EXPECT_EQ(data[2], 3);
+  // The elements are immutable, and not the size of a `uint16_t`.
+  EXPECT_FALSE(bytes_array->data_mut<uint8_t>(store));
+  EXPECT_FALSE(bytes_array->data<uint16_t>(store));
+
+  AnyRef floats =
+      *floats_fn.call(store, {Val(int32_t(4))}).unwrap()[0].anyref();
+  ArrayRef floats_array = *floats.as_array(store);
+  std::vector<double> src = {1, 2, 3};
+  floats_array.write<double>(store, 1, src).unwrap();
+  EXPECT_FALSE(floats_array.write<double>(store, 2, src));
+  floats_array.data_mut<double>(store).unwrap()[0] = 0.5;
+
+  std::vector<double> dst(4);
+  floats_array.read<double>(store, 0, dst).unwrap();
+  EXPECT_EQ(dst, (std::vector<double>{0.5, 1, 2, 3}));
+  EXPECT_FALSE(floats_array.read<double>(store, 1, dst));
+  EXPECT_EQ(sum_fn.call(store, {Val(floats)}).unwrap()[0].f64(), 6.5);
+}
@@ -25,3 +25,95 @@ TEST(WasiConfig, Smoke) {
     EXPECT_FALSE(store.context().set_wasi(std::move(config2)));
   }
 }
+
+TEST(WasiConfig, OutputBuffer) {
+  Engine engine;
+  Module module = Module::compile(engine, R"(
+    (module
+      (import "wasi_snapshot_preview1" "fd_write"
+        (func $fd_write (param i32 i32 i32 i32) (result i32)))
+      (memory (export "memory") 1)
+      (data (i32.const 0) "\10\00\00\00\06\00\00\00")
+      (data (i32.const 16) "hello\0a")
+      (func (export "run") (param $fd i32)
+        (drop (call $fd_write (local.get $fd) (i32.const 0) (i32.const 1)
+                              (i32.const 8)))))
+  )")
+                      .unwrap();
+
+  WasiOutputBuffer out(1024);
+  WasiOutputBuffer err(4);
+  WasiConfig config;
+  config.stdout_buffer(out);
+  config.stderr_buffer(err);
+  Store store(engine);
+  store.context().set_wasi(std::move(config)).unwrap();
+  Linker linker(engine);
+  linker.define_wasi().unwrap();
+  Instance instance = linker.instantiate(store, module).unwrap();
+  auto run = std::get<Func>(*instance.get(store, "run"))
+                 .typed<int32_t, std::monostate>(store)
+                 .unwrap();
+
+  run.call(store, 1).unwrap();
+  run.call(store, 1).unwrap();
+  run.call(store, 2).unwrap();
+
+  WasiOutput stdout_output = out.take();
+  EXPECT_EQ(std::string(stdout_output.data.begin(), stdout_output.data.end()),
+            "hello\nhello\n");
+  EXPECT_EQ(stdout_output.dropped, 0);
+  EXPECT_TRUE(out.take().data.empty());
+
+  WasiOutput stderr_output = err.take();
+  EXPECT_EQ(std::string(stderr_output.data.begin(), stderr_output.data.end()),
+            "llo\n");
+  EXPECT_EQ(stderr_output.dropped, 2);
+}
+
+TEST(WasiConfig, SharedDir) {
+  EXPECT_FALSE(WasiSharedDir::open("nonexistent"));
+  auto dir = WasiSharedDir::open(".");
+  ASSERT_TRUE(dir);
+
+  Engine engine;
+  for (int i = 0; i < 2; i++) {
+    WasiConfig config;
+    EXPECT_TRUE(config.preopen_shared_dir(*dir, "."));
+    Store store(engine);
+    store.context().set_wasi(std::move(config)).unwrap();
+  }
+}
+
+TEST(WasiConfig, Archive) {
+  std::vector<uint8_t> invalid = {1, 2, 3};
+  EXPECT_FALSE(WasiArchive::create(invalid));
+  EXPECT_FALSE(WasiArchive::open("nonexistent"));
+
+  // An archive with no files.
+  std::vector<uint8_t> empty = {'w', 'a', 's', 'i', 'a', 'r', 'c', '1',
+                                0,   0,   0,   0};
+  auto archive = WasiArchive::create(empty);
+  ASSERT_TRUE(archive);
+
+  Engine engine;
+  WasiConfig config;
+  EXPECT_TRUE(config.preopen_archive(*archive, "assets"));
+  Store store(engine);
+  store.context().set_wasi(std::move(config)).unwrap();
+}
+
+TEST(WasiConfig, Template) {
+  WasiConfig base;
+  base.argv({"main.wasm"});
+  base.env({{"FOO", "bar"}});
+  WasiConfigTemplate tmpl(base);
+
+  Engine engine;
+  for (int i = 0; i < 2; i++) {
+    WasiConfig config = tmpl.config();
+    config.env({{"REQUEST", std::to_string(i)}});
+    Store store(engine);
+    store.context().set_wasi(std::move(config)).unwrap();
+  }
+}
@@ -8,3 +8,13 @@ TEST(wat2wasm, Simple) {
   EXPECT_TRUE(wat2wasm("(module)"));
   EXPECT_FALSE(wat2wasm("not a module"));
 }
+
+TEST(wat2wasm, Bytes) {
+  auto bytes = wat2wasm_bytes("(module)").unwrap();
+  auto vec = wat2wasm("(module)").unwrap();
+  EXPECT_EQ(std::vector<uint8_t>(bytes.begin(), bytes.end()), vec);
+  WasmBytes moved = std::move(bytes);
+  EXPECT_EQ(moved.size(), vec.size());
+  EXPECT_EQ(bytes.size(), 0);
+  EXPECT_FALSE(wat2wasm_bytes("not a module"));
+}
@@ -89,6 +89,14 @@ pub struct CacheConfig {
         deserialize_with = "deserialize_percent"
     )]
     files_total_size_limit_percent_if_deleting: u8,
+    #[serde(
+        default = "default_files_total_size_hard_limit",
+        rename = "files-total-size-hard-limit",
+        deserialize_with = "deserialize_disk_space"
+    )]
+    files_total_size_hard_limit: u64,
+    #[serde(default = "default_write_behind", rename = "write-behind")]
+    write_behind: bool,
 }
 
 impl Default for CacheConfig {
@@ -109,6 +117,8 @@ impl Default for CacheConfig {
             file_count_limit_percent_if_deleting: default_file_count_limit_percent_if_deleting(),
             files_total_size_limit_percent_if_deleting:
                 default_files_total_size_limit_percent_if_deleting(),
+            files_total_size_hard_limit: default_files_total_size_hard_limit(),
+            write_behind: default_write_behind(),
         }
     }
 }
@@ -219,6 +229,15 @@ const fn default_file_count_limit_percent_if_deleting() -> u8 {
 const fn default_files_total_size_limit_percent_if_deleting() -> u8 {
     70
 }
+// zero means that there's no hard limit
+// if changed, update cli-cache.md
+const fn default_files_total_size_hard_limit() -> u64 {
+    0
+}
+// if changed, update cli-cache.md
+const fn default_write_behind() -> bool {
+    false
+}
 
 fn project_dirs() -> Option<ProjectDirs> {
     ProjectDirs::from("", "BytecodeAlliance", "wasmtime")
@@ -379,6 +398,8 @@ impl CacheConfig {
     generate_setting_getter!(files_total_size_soft_limit: u64);
     generate_setting_getter!(file_count_limit_percent_if_deleting: u8);
     generate_setting_getter!(files_total_size_limit_percent_if_deleting: u8);
+    generate_setting_getter!(files_total_size_hard_limit: u64);
+    generate_setting_getter!(write_behind: bool);
 
     /// Returns path to the cache directory if one is set.
     pub fn directory(&self) -> Option<&PathBuf> {
@@ -503,6 +524,32 @@ impl CacheConfig {
         self
     }
 
+    /// Hard limit for the total size* of files in the cache directory, or zero for no hard limit.
+    ///
+    /// Unlike the soft limit, which is only checked by the periodic cleanup task, this limit is
+    /// enforced by the cache worker after every cache file it's notified about, by deleting the
+    /// least recently used cache files until the total size is within the limit.
+    ///
+    /// This doesn't include files with metadata. To learn more, please refer to the cache system
+    /// section.
+    ///
+    /// *this is the file size, not the space physically occupied on the disk.
+    pub fn with_files_total_size_hard_limit(&mut self, limit: u64) -> &mut Self {
+        self.files_total_size_hard_limit = limit;
+        self
+    }
+
+    /// Whether new cache files are compressed and written to the disk by the cache worker rather
+    /// than by the thread which compiled them.
+    ///
+    /// This keeps disk writes out of compilation latency. Until a file has been written, lookups
+    /// in the same process are served from memory. If the worker's event queue is full, the file
+    /// isn't written at all.
+    pub fn with_write_behind(&mut self, enable: bool) -> &mut Self {
+        self.write_behind = enable;
+        self
+    }
+
     /// validate values and fill in defaults
     pub(crate) fn validate(&mut self) -> Result<()> {
         self.validate_directory_or_default()?;
@@ -71,7 +71,9 @@ fn test_all_settings() {
          file-count-soft-limit = '65536'\n\
          files-total-size-soft-limit = '512Mi'\n\
          file-count-limit-percent-if-deleting = '70%'\n\
-         files-total-size-limit-percent-if-deleting = '70%'",
+         files-total-size-limit-percent-if-deleting = '70%'\n\
+         files-total-size-hard-limit = '1Gi'\n\
+         write-behind = true",
         cd
     );
     check_conf(&conf, &cd);
@@ -91,7 +93,9 @@ fn test_all_settings() {
          file-count-soft-limit = '\t \t65536\t'\n\
          files-total-size-soft-limit = '512\t\t Mi '\n\
          file-count-limit-percent-if-deleting = '70\t%'\n\
-         files-total-size-limit-percent-if-deleting = ' 70 %'",
+         files-total-size-limit-percent-if-deleting = ' 70 %'\n\
+         files-total-size-hard-limit = ' 1 Gi'\n\
+         write-behind =  true",
         cd
     );
     check_conf(&conf, &cd);
@@ -118,6 +122,8 @@ fn test_all_settings() {
         assert_eq!(conf.files_total_size_soft_limit(), 512 * (1u64 << 20));
         assert_eq!(conf.file_count_limit_percent_if_deleting(), 70);
         assert_eq!(conf.files_total_size_limit_percent_if_deleting(), 70);
+        assert_eq!(conf.files_total_size_hard_limit(), 1 << 30);
+        assert!(conf.write_behind());
     }
 }
 
@@ -511,6 +517,11 @@ fn test_builder_default() {
         config.files_total_size_limit_percent_if_deleting,
         expected_config.files_total_size_limit_percent_if_deleting
     );
+    assert_eq!(
+        config.files_total_size_hard_limit,
+        expected_config.files_total_size_hard_limit
+    );
+    assert_eq!(config.write_behind, expected_config.write_behind);
 }
 
 #[test]
@@ -529,7 +540,9 @@ fn test_builder_all_settings() {
         .with_file_count_soft_limit(0x10_000)
         .with_files_total_size_soft_limit(512 * (1u64 << 20))
         .with_file_count_limit_percent_if_deleting(70)
-        .with_files_total_size_limit_percent_if_deleting(70);
+        .with_files_total_size_limit_percent_if_deleting(70)
+        .with_files_total_size_hard_limit(1 << 30)
+        .with_write_behind(true);
     conf.validate().expect("validation failed");
     check_conf(&conf, &cd);
 
@@ -555,5 +568,7 @@ fn test_builder_all_settings() {
         assert_eq!(conf.files_total_size_soft_limit(), 512 * (1u64 << 20));
         assert_eq!(conf.file_count_limit_percent_if_deleting(), 70);
         assert_eq!(conf.files_total_size_limit_percent_if_deleting(), 70);
+        assert_eq!(conf.files_total_size_hard_limit(), 1 << 30);
+        assert!(conf.write_behind());
     }
 }
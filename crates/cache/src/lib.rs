@@ -9,12 +9,13 @@ use base64::Engine;
 use log::{debug, trace, warn};
 use serde::{Deserialize, Serialize};
 use sha2::{Digest, Sha256};
+use std::collections::HashMap;
 use std::hash::Hash;
 use std::hash::Hasher;
 use std::io::Write;
 use std::path::{Path, PathBuf};
-use std::sync::Arc;
-use std::sync::atomic::{AtomicUsize, Ordering::SeqCst};
+use std::sync::atomic::{AtomicU64, AtomicUsize, Ordering::SeqCst};
+use std::sync::{Arc, Mutex};
 use std::time::Duration;
 use std::{fs, io};
 use wasmtime_environ::error::Result;
@@ -53,10 +54,11 @@ impl Cache {
     /// Returns an error if the configuration is invalid.
     pub fn new(mut config: CacheConfig) -> Result<Self> {
         config.validate()?;
+        let state = Arc::new(CacheState::default());
         Ok(Self {
-            worker: Worker::start_new(&config),
+            worker: Worker::start_new(&config, state.clone()),
             config,
-            state: Default::default(),
+            state,
         })
     }
 
@@ -93,6 +95,8 @@ impl Cache {
     generate_config_setting_getter!(files_total_size_soft_limit: u64);
     generate_config_setting_getter!(file_count_limit_percent_if_deleting: u8);
     generate_config_setting_getter!(files_total_size_limit_percent_if_deleting: u8);
+    generate_config_setting_getter!(files_total_size_hard_limit: u64);
+    generate_config_setting_getter!(write_behind: bool);
 
     /// Returns path to the cache directory.
     pub fn directory(&self) -> &PathBuf {
@@ -117,21 +121,92 @@ impl Cache {
         self.state.misses.load(SeqCst)
     }
 
+    /// Returns statistics about the use of this cache so far.
+    pub fn stats(&self) -> CacheStats {
+        CacheStats {
+            hits: self.state.hits.load(SeqCst) as u64,
+            misses: self.state.misses.load(SeqCst) as u64,
+            bytes_read: self.state.bytes_read.load(SeqCst),
+            bytes_written: self.state.bytes_written.load(SeqCst),
+            evictions: self.state.evictions.load(SeqCst),
+            writes_dropped: self.state.writes_dropped.load(SeqCst),
+        }
+    }
+
     pub(crate) fn on_cache_get_async(&self, path: impl AsRef<Path>) {
-        self.state.hits.fetch_add(1, SeqCst);
         self.worker.on_cache_get_async(path)
     }
 
     pub(crate) fn on_cache_update_async(&self, path: impl AsRef<Path>) {
-        self.state.misses.fetch_add(1, SeqCst);
         self.worker.on_cache_update_async(path)
     }
+
+    /// Hands `data` to the worker to be compressed and written to `path`,
+    /// serving lookups of `path` from memory until it has been written.
+    fn write_async(&self, path: PathBuf, data: Vec<u8>) {
+        let data: Arc<[u8]> = data.into();
+        self.state
+            .pending_writes
+            .lock()
+            .unwrap()
+            .insert(path.clone(), data.clone());
+        if !self.worker.write_async(path.clone(), data.clone()) {
+            self.state.writes_dropped.fetch_add(1, SeqCst);
+            self.state.remove_pending_write(&path, &data);
+        }
+    }
+
+    fn pending_write(&self, path: &Path) -> Option<Vec<u8>> {
+        let pending = self.state.pending_writes.lock().unwrap();
+        Some(pending.get(path)?.to_vec())
+    }
+}
+
+/// Statistics about the use of a [`Cache`], as returned by [`Cache::stats`].
+///
+/// These only cover the use of the cache by the current process, and are
+/// counted from when the [`Cache`] was created.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct CacheStats {
+    /// The number of lookups which found a usable cache entry.
+    pub hits: u64,
+    /// The number of lookups which didn't find a usable cache entry, and so
+    /// had to compute the data.
+    pub misses: u64,
+    /// The number of compressed bytes read from cache files on hits.
+    pub bytes_read: u64,
+    /// The number of compressed bytes written to new cache files.
+    pub bytes_written: u64,
+    /// The number of cache files deleted to stay within the
+    /// `files-total-size-hard-limit`.
+    pub evictions: u64,
+    /// The number of new cache files which weren't written because the
+    /// worker's event queue was full, with `write-behind` enabled.
+    pub writes_dropped: u64,
 }
 
 #[derive(Default, Debug)]
 struct CacheState {
     hits: AtomicUsize,
     misses: AtomicUsize,
+    bytes_read: AtomicU64,
+    bytes_written: AtomicU64,
+    evictions: AtomicU64,
+    writes_dropped: AtomicU64,
+    /// The data of cache files which are waiting to be written by the worker,
+    /// with `write-behind` enabled.
+    pending_writes: Mutex<HashMap<PathBuf, Arc<[u8]>>>,
+}
+
+impl CacheState {
+    /// Forgets the pending write of `data` to `path`, unless it has been
+    /// replaced by a newer one in the meantime.
+    fn remove_pending_write(&self, path: &Path, data: &Arc<[u8]>) {
+        let mut pending = self.pending_writes.lock().unwrap();
+        if pending.get(path).is_some_and(|d| Arc::ptr_eq(d, data)) {
+            pending.remove(path);
+        }
+    }
 }
 
 /// Module level cache entry.
@@ -201,17 +276,29 @@ impl<'cache> ModuleCacheEntry<'cache> {
         // standard encoding uses '/' which can't be used for filename
         let hash = base64::engine::general_purpose::URL_SAFE_NO_PAD.encode(&hash);
 
-        if let Some(cached_val) = inner.get_data(&hash) {
+        let cache_state = &inner.cache.state;
+        let mod_cache_path = inner.root_path.join(&hash);
+        if let Some(cached_val) = inner.cache.pending_write(&mod_cache_path) {
             if let Some(val) = deserialize(state, cached_val) {
-                let mod_cache_path = inner.root_path.join(&hash);
+                cache_state.hits.fetch_add(1, SeqCst);
+                return Ok(val);
+            }
+        }
+        if let Some((cached_val, size)) = inner.get_data(&hash) {
+            if let Some(val) = deserialize(state, cached_val) {
+                cache_state.hits.fetch_add(1, SeqCst);
+                cache_state.bytes_read.fetch_add(size, SeqCst);
                 inner.cache.on_cache_get_async(&mod_cache_path); // call on success
                 return Ok(val);
             }
         }
+        cache_state.misses.fetch_add(1, SeqCst);
         let val_to_cache = compute(state)?;
         if let Some(bytes) = serialize(state, &val_to_cache) {
-            if inner.update_data(&hash, &bytes).is_some() {
-                let mod_cache_path = inner.root_path.join(&hash);
+            if inner.cache.write_behind() {
+                inner.cache.write_async(mod_cache_path, bytes);
+            } else if let Some(size) = inner.update_data(&hash, &bytes) {
+                cache_state.bytes_written.fetch_add(size, SeqCst);
                 inner.cache.on_cache_update_async(&mod_cache_path); // call on success
             }
         }
@@ -259,59 +346,75 @@ impl<'cache> ModuleCacheEntryInner<'cache> {
         Self { root_path, cache }
     }
 
-    fn get_data(&self, hash: &str) -> Option<Vec<u8>> {
+    /// Returns the decompressed data cached under `hash` and the size of its
+    /// cache file.
+    fn get_data(&self, hash: &str) -> Option<(Vec<u8>, u64)> {
         let mod_cache_path = self.root_path.join(hash);
         trace!("get_data() for path: {}", mod_cache_path.display());
         let compressed_cache_bytes = fs::read(&mod_cache_path).ok()?;
         let cache_bytes = zstd::decode_all(&compressed_cache_bytes[..])
             .map_err(|err| warn!("Failed to decompress cached code: {err}"))
             .ok()?;
-        Some(cache_bytes)
+        Some((cache_bytes, compressed_cache_bytes.len() as u64))
     }
 
-    fn update_data(&self, hash: &str, serialized_data: &[u8]) -> Option<()> {
+    /// Writes `serialized_data` to the cache under `hash`, returning the size
+    /// of the cache file.
+    fn update_data(&self, hash: &str, serialized_data: &[u8]) -> Option<u64> {
         let mod_cache_path = self.root_path.join(hash);
-        trace!("update_data() for path: {}", mod_cache_path.display());
-        let compressed_data = zstd::encode_all(
-            &serialized_data[..],
+        write_cache_file(
+            &mod_cache_path,
+            serialized_data,
             self.cache.baseline_compression_level(),
         )
+    }
+}
+
+/// Compresses `serialized_data` and writes it to the cache file at
+/// `mod_cache_path`, returning the size of the file.
+fn write_cache_file(
+    mod_cache_path: &Path,
+    serialized_data: &[u8],
+    compression_level: i32,
+) -> Option<u64> {
+    trace!("write_cache_file() for path: {}", mod_cache_path.display());
+    let compressed_data = zstd::encode_all(&serialized_data[..], compression_level)
         .map_err(|err| warn!("Failed to compress cached code: {err}"))
         .ok()?;
+    let size = compressed_data.len() as u64;
 
-        // Optimize syscalls: first, try writing to disk. It should succeed in most cases.
-        // Otherwise, try creating the cache directory and retry writing to the file.
-        if fs_write_atomic(&mod_cache_path, "mod", &compressed_data).is_ok() {
-            return Some(());
-        }
+    // Optimize syscalls: first, try writing to disk. It should succeed in most cases.
+    // Otherwise, try creating the cache directory and retry writing to the file.
+    if fs_write_atomic(&mod_cache_path, "mod", &compressed_data).is_ok() {
+        return Some(size);
+    }
 
-        debug!(
-            "Attempting to create the cache directory, because \
-             failed to write cached code to disk, path: {}",
-            mod_cache_path.display(),
-        );
-
-        let cache_dir = mod_cache_path.parent().unwrap();
-        fs::create_dir_all(cache_dir)
-            .map_err(|err| {
-                warn!(
-                    "Failed to create cache directory, path: {}, message: {}",
-                    cache_dir.display(),
-                    err
-                )
-            })
-            .ok()?;
+    debug!(
+        "Attempting to create the cache directory, because \
+         failed to write cached code to disk, path: {}",
+        mod_cache_path.display(),
+    );
+
+    let cache_dir = mod_cache_path.parent().unwrap();
+    fs::create_dir_all(cache_dir)
+        .map_err(|err| {
+            warn!(
+                "Failed to create cache directory, path: {}, message: {}",
+                cache_dir.display(),
+                err
+            )
+        })
+        .ok()?;
 
-        match fs_write_atomic(&mod_cache_path, "mod", &compressed_data) {
-            Ok(_) => Some(()),
-            Err(err) => {
-                warn!(
-                    "Failed to write file with rename, target path: {}, err: {}",
-                    mod_cache_path.display(),
-                    err
-                );
-                None
-            }
+    match fs_write_atomic(&mod_cache_path, "mod", &compressed_data) {
+        Ok(_) => Some(size),
+        Err(err) => {
+            warn!(
+                "Failed to write file with rename, target path: {}, err: {}",
+                mod_cache_path.display(),
+                err
+            );
+            None
         }
     }
 }
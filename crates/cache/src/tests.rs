@@ -88,3 +88,31 @@ fn test_write_read_cache() {
     entry1.get_data::<_, i32, i32>(4, |_| panic!()).unwrap();
     entry2.get_data::<_, i32, i32>(1, |_| panic!()).unwrap();
 }
+
+#[test]
+fn test_write_behind_and_stats() {
+    let (_tempdir, cache_dir, config_path) = test_prolog();
+    let cache_config = load_config!(
+        config_path,
+        "[cache]\n\
+         directory = '{cache_dir}'\n\
+         write-behind = true\n",
+        cache_dir
+    );
+    let cache = Cache::new(cache_config).unwrap();
+    let entry = ModuleCacheEntry::from_inner(ModuleCacheEntryInner::new("test", &cache));
+
+    entry.get_data::<_, i32, i32>(1, |_| Ok(100)).unwrap();
+    entry.get_data::<_, i32, i32>(1, |_| panic!()).unwrap();
+    cache.worker().wait_for_all_events_handled();
+    assert!(cache.state.pending_writes.lock().unwrap().is_empty());
+    entry.get_data::<_, i32, i32>(1, |_| panic!()).unwrap();
+
+    let stats = cache.stats();
+    assert_eq!(stats.hits, 2);
+    assert_eq!(stats.misses, 1);
+    assert!(stats.bytes_written > 0);
+    assert_eq!(stats.bytes_read, stats.bytes_written);
+    assert_eq!(stats.evictions, 0);
+    assert_eq!(stats.writes_dropped, 0);
+}
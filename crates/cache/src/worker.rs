@@ -1,6 +1,7 @@
 //! Background worker that watches over the cache.
 //!
 //! It cleans up old cache, updates statistics and optimizes the cache.
+//! With `write-behind` enabled it also writes new cache files.
 //! We allow losing some messages (it doesn't hurt) and some races,
 //! but we guarantee eventual consistency and fault tolerancy.
 //! Background tasks can be CPU intensive, but the worker thread has low priority.
@@ -16,18 +17,21 @@
     )
 )]
 
-use super::{CacheConfig, fs_write_atomic};
+use super::{CacheConfig, CacheState, fs_write_atomic, write_cache_file};
 use log::{debug, info, trace, warn};
 use serde_derive::{Deserialize, Serialize};
+use std::cell::Cell;
 use std::cmp;
 use std::collections::HashMap;
 use std::ffi::OsStr;
 use std::fmt;
 use std::fs;
 use std::path::{Path, PathBuf};
+use std::sync::Arc;
+use std::sync::atomic::Ordering::SeqCst;
 use std::sync::mpsc::{Receiver, SyncSender, sync_channel};
 #[cfg(test)]
-use std::sync::{Arc, Condvar, Mutex};
+use std::sync::{Condvar, Mutex};
 use std::thread;
 use std::time::Duration;
 #[cfg(not(test))]
@@ -45,6 +49,10 @@ pub(super) struct Worker {
 struct WorkerThread {
     receiver: Receiver<CacheEvent>,
     cache_config: CacheConfig,
+    state: Arc<CacheState>,
+    /// The total size of the module files in the cache, as of the last time
+    /// that the hard limit was enforced plus what was written since then.
+    total_size: Cell<Option<u64>>,
     #[cfg(test)]
     stats: Arc<(Mutex<WorkerStats>, Condvar)>,
 }
@@ -57,14 +65,29 @@ struct WorkerStats {
     handled: u32,
 }
 
-#[derive(Debug, Clone)]
+#[derive(Clone)]
 enum CacheEvent {
     OnCacheGet(PathBuf),
     OnCacheUpdate(PathBuf),
+    Write { path: PathBuf, data: Arc<[u8]> },
+}
+
+impl fmt::Debug for CacheEvent {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            Self::OnCacheGet(path) => f.debug_tuple("OnCacheGet").field(path).finish(),
+            Self::OnCacheUpdate(path) => f.debug_tuple("OnCacheUpdate").field(path).finish(),
+            Self::Write { path, data } => f
+                .debug_struct("Write")
+                .field("path", path)
+                .field("len", &data.len())
+                .finish(),
+        }
+    }
 }
 
 impl Worker {
-    pub(super) fn start_new(cache_config: &CacheConfig) -> Self {
+    pub(super) fn start_new(cache_config: &CacheConfig, state: Arc<CacheState>) -> Self {
         let queue_size = match cache_config.worker_event_queue_size() {
             num if num <= usize::max_value() as u64 => num as usize,
             _ => usize::max_value(),
@@ -77,6 +100,8 @@ impl Worker {
         let worker_thread = WorkerThread {
             receiver: rx,
             cache_config: cache_config.clone(),
+            state,
+            total_size: Cell::new(None),
             #[cfg(test)]
             stats: stats.clone(),
         };
@@ -103,8 +128,14 @@ impl Worker {
         self.send_cache_event(event);
     }
 
+    /// Asks the worker to compress `data` and write it to the cache file at
+    /// `path`, returning whether the request was queued.
+    pub(super) fn write_async(&self, path: PathBuf, data: Arc<[u8]>) -> bool {
+        self.send_cache_event(CacheEvent::Write { path, data })
+    }
+
     #[inline]
-    fn send_cache_event(&self, event: CacheEvent) {
+    fn send_cache_event(&self, event: CacheEvent) -> bool {
         let sent_event = self.sender.try_send(event.clone());
 
         if let Err(ref err) = sent_event {
@@ -128,6 +159,8 @@ impl Worker {
                 stats.dropped += 1;
             }
         }
+
+        sent_event.is_ok()
     }
 
     #[cfg(test)]
@@ -211,6 +244,7 @@ impl WorkerThread {
             match event {
                 CacheEvent::OnCacheGet(path) => self.handle_on_cache_get(path),
                 CacheEvent::OnCacheUpdate(path) => self.handle_on_cache_update(path),
+                CacheEvent::Write { path, data } => self.handle_write(path, data),
             }
 
             #[cfg(test)]
@@ -399,6 +433,19 @@ impl WorkerThread {
             .expect("CacheConfig should be validated before being passed to a WorkerThread")
     }
 
+    fn handle_write(&self, path: PathBuf, data: Arc<[u8]>) {
+        trace!("handle_write() for path: {}", path.display());
+
+        let size = write_cache_file(&path, &data, self.cache_config.baseline_compression_level());
+        // Lookups can find the file on disk from now on, or have to compute
+        // the data again if it couldn't be written.
+        self.state.remove_pending_write(&path, &data);
+        if let Some(size) = size {
+            self.state.bytes_written.fetch_add(size, SeqCst);
+            self.handle_on_cache_update(path);
+        }
+    }
+
     fn handle_on_cache_update(&self, path: PathBuf) {
         trace!("handle_on_cache_update() for path: {}", path.display());
 
@@ -417,7 +464,11 @@ impl WorkerThread {
         stats.usages += 1;
         write_stats_file(&stats_path, &stats);
 
-        // ---------------------- step 2: perform cleanup task if needed
+        // ---------------------- step 2: enforce the hard limit if there's one
+
+        self.enforce_hard_limit(&path);
+
+        // ---------------------- step 3: perform cleanup task if needed
 
         // acquire lock for cleanup task
         // Lock is a proof of recent cleanup task, so we don't want to delete them.
@@ -437,35 +488,7 @@ impl WorkerThread {
         trace!("Trying to clean up cache");
 
         let mut cache_index = self.list_cache_contents();
-        let future_tolerance = SystemTime::now()
-            .checked_add(
-                self.cache_config
-                    .allowed_clock_drift_for_files_from_future(),
-            )
-            .expect("Brace your cache, the next Big Bang is coming (time overflow)");
-        cache_index.sort_unstable_by(|lhs, rhs| {
-            // sort by age
-            use CacheEntry::*;
-            match (lhs, rhs) {
-                (Recognized { mtime: lhs_mt, .. }, Recognized { mtime: rhs_mt, .. }) => {
-                    match (*lhs_mt > future_tolerance, *rhs_mt > future_tolerance) {
-                        // later == younger
-                        (false, false) => rhs_mt.cmp(lhs_mt),
-                        // files from far future are treated as oldest recognized files
-                        // we want to delete them, so the cache keeps track of recent files
-                        // however, we don't delete them uncodintionally,
-                        // because .stats file can be overwritten with a meaningful mtime
-                        (true, false) => cmp::Ordering::Greater,
-                        (false, true) => cmp::Ordering::Less,
-                        (true, true) => cmp::Ordering::Equal,
-                    }
-                }
-                // unrecognized is kind of infinity
-                (Recognized { .. }, Unrecognized { .. }) => cmp::Ordering::Less,
-                (Unrecognized { .. }, Recognized { .. }) => cmp::Ordering::Greater,
-                (Unrecognized { .. }, Unrecognized { .. }) => cmp::Ordering::Equal,
-            }
-        });
+        self.sort_by_age(&mut cache_index);
 
         // find "cut" boundary:
         // - remove unrecognized files anyway,
@@ -530,11 +553,101 @@ impl WorkerThread {
                     );
                 }
             }
+            self.total_size.set(None);
         }
 
         trace!("Task finished: clean up cache");
     }
 
+    /// Sorts `cache_index` from the youngest to the oldest recognized entry,
+    /// followed by the unrecognized ones.
+    fn sort_by_age(&self, cache_index: &mut [CacheEntry]) {
+        let future_tolerance = SystemTime::now()
+            .checked_add(
+                self.cache_config
+                    .allowed_clock_drift_for_files_from_future(),
+            )
+            .expect("Brace your cache, the next Big Bang is coming (time overflow)");
+        cache_index.sort_unstable_by(|lhs, rhs| {
+            // sort by age
+            use CacheEntry::*;
+            match (lhs, rhs) {
+                (Recognized { mtime: lhs_mt, .. }, Recognized { mtime: rhs_mt, .. }) => {
+                    match (*lhs_mt > future_tolerance, *rhs_mt > future_tolerance) {
+                        // later == younger
+                        (false, false) => rhs_mt.cmp(lhs_mt),
+                        // files from far future are treated as oldest recognized files
+                        // we want to delete them, so the cache keeps track of recent files
+                        // however, we don't delete them uncodintionally,
+                        // because .stats file can be overwritten with a meaningful mtime
+                        (true, false) => cmp::Ordering::Greater,
+                        (false, true) => cmp::Ordering::Less,
+                        (true, true) => cmp::Ordering::Equal,
+                    }
+                }
+                // unrecognized is kind of infinity
+                (Recognized { .. }, Unrecognized { .. }) => cmp::Ordering::Less,
+                (Unrecognized { .. }, Recognized { .. }) => cmp::Ordering::Greater,
+                (Unrecognized { .. }, Unrecognized { .. }) => cmp::Ordering::Equal,
+            }
+        });
+    }
+
+    /// Deletes the least recently used module files until the cache is within
+    /// `files-total-size-hard-limit`, right after `path` was written.
+    ///
+    /// The total size is only recomputed by listing the cache once it seems
+    /// to exceed the limit, so this is cheap as long as it doesn't.
+    fn enforce_hard_limit(&self, path: &Path) {
+        let limit = self.cache_config.files_total_size_hard_limit();
+        if limit == 0 {
+            return;
+        }
+
+        let size = path.metadata().map_or(0, |m| m.len());
+        if let Some(total_size) = self.total_size.get() {
+            let total_size = total_size.saturating_add(size);
+            if total_size <= limit {
+                self.total_size.set(Some(total_size));
+                return;
+            }
+        }
+
+        trace!("Enforcing the hard limit of the cache size");
+
+        let mut cache_index = self.list_cache_contents();
+        self.sort_by_age(&mut cache_index);
+
+        // Unrecognized entries are left to the cleanup task.
+        let mut total_size = 0u64;
+        let mut evicting = false;
+        for item in &cache_index {
+            let CacheEntry::Recognized { path, size, .. } = item else {
+                continue;
+            };
+            if !evicting && total_size + size <= limit {
+                total_size += size;
+                continue;
+            }
+            evicting = true;
+
+            if let Err(err) = fs::remove_file(path) {
+                warn!(
+                    "Failed to remove file over the hard limit, path: {}, err: {}",
+                    path.display(),
+                    err
+                );
+                total_size += size;
+                continue;
+            }
+            let _ = fs::remove_file(path.with_extension("stats"));
+            self.state.evictions.fetch_add(1, SeqCst);
+        }
+        self.total_size.set(Some(total_size));
+
+        trace!("Task finished: enforce the hard limit of the cache size");
+    }
+
     // Be fault tolerant: list as much as you can, and ignore the rest
     fn list_cache_contents(&self) -> Vec<CacheEntry> {
         fn enter_dir(
@@ -17,7 +17,7 @@ fn test_on_get_create_stats_file() {
          directory = '{cache_dir}'",
         cache_dir
     );
-    let worker = Worker::start_new(&cache_config);
+    let worker = Worker::start_new(&cache_config, Default::default());
 
     let mod_file = cache_dir.join("some-mod");
     worker.on_cache_get_async(mod_file);
@@ -43,7 +43,7 @@ fn test_on_get_update_usage_counter() {
          worker-event-queue-size = '16'",
         cache_dir
     );
-    let worker = Worker::start_new(&cache_config);
+    let worker = Worker::start_new(&cache_config, Default::default());
 
     let mod_file = cache_dir.join("some-mod");
     let stats_file = cache_dir.join("some-mod.stats");
@@ -78,7 +78,7 @@ fn test_on_get_recompress_no_mod_file() {
          optimized-compression-usage-counter-threshold = '256'",
         cache_dir
     );
-    let worker = Worker::start_new(&cache_config);
+    let worker = Worker::start_new(&cache_config, Default::default());
 
     let mod_file = cache_dir.join("some-mod");
     let stats_file = cache_dir.join("some-mod.stats");
@@ -118,7 +118,7 @@ fn test_on_get_recompress_with_mod_file() {
          optimized-compression-usage-counter-threshold = '256'",
         cache_dir
     );
-    let worker = Worker::start_new(&cache_config);
+    let worker = Worker::start_new(&cache_config, Default::default());
 
     let mod_file = cache_dir.join("some-mod");
     let mod_data = "some test data to be compressed";
@@ -193,7 +193,7 @@ fn test_on_get_recompress_lock() {
          allowed-clock-drift-for-files-from-future = '1d'",
         cache_dir
     );
-    let worker = Worker::start_new(&cache_config);
+    let worker = Worker::start_new(&cache_config, Default::default());
 
     let mod_file = cache_dir.join("some-mod");
     let mod_data = "some test data to be compressed";
@@ -259,7 +259,7 @@ fn test_on_update_fresh_stats_file() {
          cleanup-interval = '1h'",
         cache_dir
     );
-    let worker = Worker::start_new(&cache_config);
+    let worker = Worker::start_new(&cache_config, Default::default());
 
     let mod_file = cache_dir.join("some-mod");
     let stats_file = cache_dir.join("some-mod.stats");
@@ -311,7 +311,7 @@ fn test_on_update_cleanup_limits_trash_locks() {
          ",
         cache_dir
     );
-    let worker = Worker::start_new(&cache_config);
+    let worker = Worker::start_new(&cache_config, Default::default());
     let content_1k = "a".repeat(1_000);
     let content_10k = "a".repeat(10_000);
 
@@ -446,7 +446,7 @@ fn test_on_update_cleanup_lru_policy() {
          files-total-size-limit-percent-if-deleting = '70%'",
         cache_dir
     );
-    let worker = Worker::start_new(&cache_config);
+    let worker = Worker::start_new(&cache_config, Default::default());
     let content_1k = "a".repeat(1_000);
     let content_5k = "a".repeat(5_000);
     let content_10k = "a".repeat(10_000);
@@ -577,7 +577,7 @@ fn test_on_update_cleanup_future_files() {
          files-total-size-limit-percent-if-deleting = '70%'",
         cache_dir
     );
-    let worker = Worker::start_new(&cache_config);
+    let worker = Worker::start_new(&cache_config, Default::default());
     let content_1k = "a".repeat(1_000);
 
     let mods_files_dir = cache_dir.join("target-triple").join("compiler-version");
@@ -680,7 +680,7 @@ fn test_on_update_cleanup_self_lock() {
          allowed-clock-drift-for-files-from-future = '1d'",
         cache_dir
     );
-    let worker = Worker::start_new(&cache_config);
+    let worker = Worker::start_new(&cache_config, Default::default());
 
     let mod_file = cache_dir.join("some-mod");
     let trash_file = cache_dir.join("trash-file.txt");
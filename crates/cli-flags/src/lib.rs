@@ -64,6 +64,14 @@ wasmtime_option_group! {
         /// Bytes to reserve at the end of linear memory for growth into.
         pub memory_reservation_for_growth: Option<u64>,
 
+        /// Reserve at least as many bytes for growth as the new size of a
+        /// linear memory when it moves.
+        pub memory_reservation_for_growth_geometric: Option<bool>,
+
+        /// Populate the pages of linear memories when they're created and
+        /// grown, instead of on first access.
+        pub memory_populate: Option<bool>,
+
         /// Size, in bytes, of guard pages for linear memories.
         pub memory_guard_size: Option<u64>,
 
@@ -228,6 +236,9 @@ wasmtime_option_group! {
         #[serde(default)]
         #[serde(deserialize_with = "crate::opt::cli_parse_wrapper")]
         pub collector: Option<wasmtime::Collector>,
+        /// Whether Wasm code allocates GC objects inline, rather than always
+        /// calling into the runtime.
+        pub gc_inline_alloc: Option<bool>,
         /// Enable Cranelift's internal debug verifier (expensive)
         pub cranelift_debug_verifier: Option<bool>,
         /// Whether or not to enable caching of compiled modules.
@@ -263,6 +274,9 @@ wasmtime_option_group! {
     pub struct DebugOptions {
         /// Enable generation of DWARF debug information in compiled code.
         pub debug_info: Option<bool>,
+        /// Only register DWARF debug information with a debugger once one is
+        /// attached to the process.
+        pub debug_info_lazy: Option<bool>,
         /// Enable guest debugging insrumentation.
         pub guest_debug: Option<bool>,
         /// Configure whether compiled code can map native addresses to wasm.
@@ -744,6 +758,11 @@ impl CommonOptions {
             collector => config.collector(collector),
             _ => err,
         }
+        match_feature! {
+            ["gc" : self.codegen.gc_inline_alloc]
+            enable => config.gc_inline_alloc(enable),
+            true => err,
+        }
         if let Some(target) = &self.target {
             config.target(target)?;
         }
@@ -755,6 +774,9 @@ impl CommonOptions {
         if let Some(enable) = self.debug.debug_info {
             config.debug_info(enable);
         }
+        if let Some(enable) = self.debug.debug_info_lazy {
+            config.debug_info_lazy(enable);
+        }
         match_feature! {
             ["debug" : self.debug.guest_debug]
             enable => config.guest_debug(enable),
@@ -859,6 +881,12 @@ impl CommonOptions {
         if let Some(size) = mem_for_growth {
             config.memory_reservation_for_growth(size);
         }
+        if let Some(enable) = self.opts.memory_reservation_for_growth_geometric {
+            config.memory_reservation_for_growth_geometric(enable);
+        }
+        if let Some(enable) = self.opts.memory_populate {
+            config.memory_populate(enable);
+        }
         if let Some(enable) = self.opts.guard_before_linear_memory {
             config.guard_before_linear_memory(enable);
         }
@@ -31,6 +31,7 @@ use cranelift_codegen::{
     ir::{Expr, Fact},
 };
 use cranelift_frontend::FunctionBuilder;
+use std::collections::HashMap;
 
 /// The kind of bounds check to perform when accessing a Wasm linear memory or
 /// GC heap.
@@ -71,6 +72,82 @@ pub enum BoundsCheck {
     },
 }
 
+/// The explicit bounds checks emitted earlier in the current extended basic
+/// block, which later accesses can be merged into.
+///
+/// Each entry records that `index + extent <= bound` for the heap with the
+/// given bound. Heaps never shrink, so this keeps holding after the check, but
+/// it only holds where the check dominates. The entries are therefore only
+/// used in `block`, which is either the block that the checks were emitted in
+/// or a continuation which is only reachable from it, see
+/// `FuncEnvironment::conditionally_trap`.
+#[derive(Default)]
+pub struct CheckedHeapAccesses {
+    block: Option<ir::Block>,
+    extents: HashMap<(ir::GlobalValue, ir::Value), u64>,
+}
+
+impl CheckedHeapAccesses {
+    /// Returns the extents recorded for the current block, forgetting those
+    /// of any other block.
+    fn extents(
+        &mut self,
+        builder: &FunctionBuilder,
+    ) -> Option<&mut HashMap<(ir::GlobalValue, ir::Value), u64>> {
+        let block = builder.current_block()?;
+        if self.block != Some(block) {
+            self.block = Some(block);
+            self.extents.clear();
+        }
+        Some(&mut self.extents)
+    }
+
+    /// Records that a check of `index + extent <= bound` was just emitted.
+    fn record(
+        &mut self,
+        builder: &FunctionBuilder,
+        bound: ir::GlobalValue,
+        index: ir::Value,
+        extent: u64,
+    ) {
+        if let Some(extents) = self.extents(builder) {
+            let e = extents.entry((bound, index)).or_insert(extent);
+            *e = (*e).max(extent);
+        }
+    }
+
+    /// Returns whether an earlier check established that `index + extent <=
+    /// bound`, where `extent` is computed from the constant that was added to
+    /// the checked index to get `index`, if any.
+    fn covers(
+        &mut self,
+        builder: &FunctionBuilder,
+        bound: ir::GlobalValue,
+        index: ir::Value,
+        extent: impl Fn(u64) -> u64,
+    ) -> bool {
+        let func = &builder.func;
+        let Some(extents) = self.extents(builder) else {
+            return false;
+        };
+        let covered = |base, delta| {
+            extents
+                .get(&(bound, base))
+                .is_some_and(|e| extent(delta) <= *e)
+        };
+        covered(index, 0)
+            || split_constant_offset(func, index).is_some_and(|(base, delta)| covered(base, delta))
+    }
+
+    /// Notes that the current block `from` continues in `to`, which is only
+    /// reachable from `from`, so that the checks emitted so far remain valid.
+    pub fn continue_in(&mut self, from: Option<ir::Block>, to: ir::Block) {
+        if from.is_some() && self.block == from {
+            self.block = Some(to);
+        }
+    }
+}
+
 /// Helper used to emit bounds checks (as necessary) and compute the native
 /// address of a heap access.
 ///
@@ -222,6 +299,12 @@ fn bounds_check_field_access(
         OobBehavior::ExplicitTrap
     };
 
+    // Whether earlier explicit checks can cover this access, and whether this
+    // access's check can cover later ones. This requires that out-of-bounds
+    // accesses trap: the `select` of the other `OobBehavior`s doesn't
+    // establish anything about the index.
+    let merge_checks = matches!(oob_behavior, OobBehavior::ExplicitTrap) && !pcc;
+
     let make_compare = |builder: &mut FunctionBuilder,
                         compare_kind: IntCC,
                         lhs: ir::Value,
@@ -358,6 +441,7 @@ fn bounds_check_field_access(
             can_use_virtual_memory,
             "static memories require the ability to use virtual memory"
         );
+        env.bounds_checks_elided += 1;
         return Reachable(compute_addr(
             &mut builder.cursor(),
             heap,
@@ -371,6 +455,7 @@ fn bounds_check_field_access(
     // Special case when the `index` is a constant and statically known to be
     // in-bounds on this memory, no bounds checks necessary.
     if statically_in_bounds {
+        env.bounds_checks_elided += 1;
         return Reachable(compute_addr(
             &mut builder.cursor(),
             heap,
@@ -381,6 +466,89 @@ fn bounds_check_field_access(
         ));
     }
 
+    // Special case for when an earlier explicit check in this extended basic
+    // block already covers this access. Heaps never shrink, so if the earlier
+    // check established
+    //
+    //     base + extent <= bound
+    //
+    // then an access at `index = base + delta` needs no check of its own if
+    //
+    //     delta + offset + access_size <= extent
+    //
+    // or, if the guard region covers `offset + access_size`, if just
+    //
+    //     delta <= extent
+    //
+    // in the same way as the guard region special case below. The addition
+    // in `base + delta` can't have wrapped around since `bound` is no larger
+    // than the index space. This merges the checks of accesses to adjacent
+    // fields or array elements, for example in an unrolled loop, which
+    // matters most when signals-based traps are disabled and every access
+    // needs an explicit check.
+    let covered_by_guard = can_use_virtual_memory && offset_and_size <= memory_guard_size;
+    if merge_checks
+        && env
+            .checked_heap_accesses
+            .covers(builder, bound_gv, orig_index, |delta| {
+                if covered_by_guard {
+                    delta
+                } else {
+                    delta.saturating_add(offset_and_size)
+                }
+            })
+    {
+        env.bounds_checks_elided += 1;
+        env.bounds_checks_merged += 1;
+        return Reachable(compute_addr(
+            &mut builder.cursor(),
+            heap,
+            env.pointer_type(),
+            index,
+            offset,
+            None,
+        ));
+    }
+
+    // Special case for 64-bit memories when index masking is enabled, the
+    // memory can't move, and its minimum byte size fits within a
+    // power-of-two `memory_reservation`. In this situation memory never
+    // grows beyond the reservation, so instead of checking `index` we clear
+    // all of its bits which lie beyond the reservation:
+    //
+    //     index & (memory_reservation - 1)
+    //
+    // The masked index is always less than `memory_reservation`, so if the
+    // guard region covers `offset + access_size` then the access either
+    // lands within linear memory or faults in the unmapped remainder of the
+    // reservation or in the guard region, neither of which requires an
+    // explicit check. Note that this deviates from wasm semantics because an
+    // index beyond the reservation wraps around instead of trapping, which
+    // is why this is an opt-in setting. Accesses still can't escape the
+    // reservation though, so this also doesn't need any Spectre mitigation.
+    if env.tunables().memory64_index_masking
+        && heap.index_type() == ir::types::I64
+        && pointer_bit_width == 64
+        && can_use_virtual_memory
+        && !pcc
+        && memory_reservation.is_power_of_two()
+        && heap.memory.minimum_byte_size().unwrap_or(u64::MAX) <= memory_reservation
+        && !heap.memory.memory_may_move(env.tunables())
+        && offset_and_size <= memory_guard_size
+    {
+        let mask = (memory_reservation - 1) as i64;
+        let index = builder.ins().band_imm(index, mask);
+        env.bounds_checks_elided += 1;
+        return Reachable(compute_addr(
+            &mut builder.cursor(),
+            heap,
+            env.pointer_type(),
+            index,
+            offset,
+            None,
+        ));
+    }
+
     // Special case for when we can rely on virtual memory, the minimum
     // byte size of this memory fits within the memory reservation, and
     // memory isn't allowed to move. In this situation we know that
@@ -454,7 +622,7 @@ fn bounds_check_field_access(
             bound,
             Some(0),
         );
-        return Reachable(explicit_check_oob_condition_and_compute_addr(
+        let addr = explicit_check_oob_condition_and_compute_addr(
             env,
             builder,
             heap,
@@ -465,7 +633,12 @@ fn bounds_check_field_access(
             AddrPcc::dynamic(heap.pcc_memory_type, bound_gv),
             oob,
             trap,
-        ));
+        );
+        if merge_checks {
+            env.checked_heap_accesses
+                .record(builder, bound_gv, orig_index, 1);
+        }
+        return Reachable(addr);
     }
 
     // Special case for when we know that there are enough guard
@@ -503,7 +676,7 @@ fn bounds_check_field_access(
             bound,
             Some(0),
         );
-        return Reachable(explicit_check_oob_condition_and_compute_addr(
+        let addr = explicit_check_oob_condition_and_compute_addr(
             env,
             builder,
             heap,
@@ -514,7 +687,12 @@ fn bounds_check_field_access(
             AddrPcc::dynamic(heap.pcc_memory_type, bound_gv),
             oob,
             trap,
-        ));
+        );
+        if merge_checks {
+            env.checked_heap_accesses
+                .record(builder, bound_gv, orig_index, 0);
+        }
+        return Reachable(addr);
     }
 
     // Special case for when `offset + access_size <= min_size`.
@@ -548,7 +726,7 @@ fn bounds_check_field_access(
             adjusted_bound,
             Some(adjustment),
         );
-        return Reachable(explicit_check_oob_condition_and_compute_addr(
+        let addr = explicit_check_oob_condition_and_compute_addr(
             env,
             builder,
             heap,
@@ -559,7 +737,12 @@ fn bounds_check_field_access(
             AddrPcc::dynamic(heap.pcc_memory_type, bound_gv),
             oob,
             trap,
-        ));
+        );
+        if merge_checks {
+            env.checked_heap_accesses
+                .record(builder, bound_gv, orig_index, offset_and_size);
+        }
+        return Reachable(addr);
     }
 
     // General case for dynamic bounds checks:
@@ -593,7 +776,7 @@ fn bounds_check_field_access(
         bound,
         Some(0),
     );
-    Reachable(explicit_check_oob_condition_and_compute_addr(
+    let addr = explicit_check_oob_condition_and_compute_addr(
         env,
         builder,
         heap,
@@ -604,7 +787,12 @@ fn bounds_check_field_access(
         AddrPcc::dynamic(heap.pcc_memory_type, bound_gv),
         oob,
         trap,
-    ))
+    );
+    if merge_checks {
+        env.checked_heap_accesses
+            .record(builder, bound_gv, orig_index, offset_and_size);
+    }
+    Reachable(addr)
 }
 
 /// Get the bound of a dynamic heap as an `ir::Value`.
@@ -758,6 +946,7 @@ fn explicit_check_oob_condition_and_compute_addr(
     oob_condition: ir::Value,
     trap: ir::TrapCode,
 ) -> ir::Value {
+    env.bounds_checks += 1;
     if let OobBehavior::ExplicitTrap = oob_behavior {
         env.trapnz(builder, oob_condition, trap);
     }
@@ -935,6 +1124,32 @@ fn offset_plus_size(offset: u32, size: u8) -> u64 {
     offset as u64 + size as u64
 }
 
+/// Splits `index` into a base value and a constant which was added to it, if
+/// it's defined by an `iadd` with a constant operand.
+fn split_constant_offset(func: &ir::Function, index: ir::Value) -> Option<(ir::Value, u64)> {
+    let inst = func.dfg.value_def(index).inst()?;
+    let ir::InstructionData::Binary {
+        opcode: ir::Opcode::Iadd,
+        args: [a, b],
+    } = func.dfg.insts[inst]
+    else {
+        return None;
+    };
+    let ty = func.dfg.value_type(index);
+    let constant = |v: ir::Value| match func.dfg.insts[func.dfg.value_def(v).inst()?] {
+        ir::InstructionData::UnaryImm {
+            opcode: ir::Opcode::Iconst,
+            imm,
+        } => Some(imm.zero_extend_from_width(ty.bits()).bits().cast_unsigned()),
+        _ => None,
+    };
+    match (constant(a), constant(b)) {
+        (_, Some(c)) => Some((a, c)),
+        (Some(c), None) => Some((b, c)),
+        (None, None) => None,
+    }
+}
+
 /// Returns whether `index` is statically in-bounds with respect to this
 /// `heap`'s configuration.
 ///
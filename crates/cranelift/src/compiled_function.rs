@@ -69,6 +69,9 @@ pub struct CompiledFunction {
     pub debug_slot_descriptor: Option<FrameStateSlotBuilder>,
     /// Debug breakpoint patches: Wasm PC, offset range in buffer.
     pub breakpoint_patch_points: Vec<(u32, Range<u32>)>,
+    /// The number of IR instructions the function had once optimized, or zero
+    /// if it wasn't compiled from IR.
+    pub ir_insts: usize,
 }
 
 impl CompiledFunction {
@@ -87,6 +90,7 @@ impl CompiledFunction {
             metadata: Default::default(),
             debug_slot_descriptor: None,
             breakpoint_patch_points: vec![],
+            ir_insts: 0,
         };
         this.finalize_breakpoints();
 
@@ -14,6 +14,7 @@ use cranelift_codegen::isa::{
     unwind::{UnwindInfo, UnwindInfoKind},
 };
 use cranelift_codegen::print_errors::pretty_error;
+use cranelift_codegen::timing::Pass;
 use cranelift_codegen::{
     CompiledCode, Context, FinalizedMachCallSite, MachBufferDebugTagList, MachBufferFrameLayout,
     MachDebugTagPos,
@@ -30,15 +31,17 @@ use std::mem;
 use std::ops::Range;
 use std::path;
 use std::sync::{Arc, Mutex};
+use std::time::Duration;
 use wasmparser::{FuncValidatorAllocations, FunctionBody};
 use wasmtime_environ::error::{Context as _, Result};
 use wasmtime_environ::obj::{ELF_WASMTIME_EXCEPTIONS, ELF_WASMTIME_FRAMES};
 use wasmtime_environ::{
     Abi, AddressMapSection, BuiltinFunctionIndex, CacheStore, CompileError, CompiledFunctionBody,
     DefinedFuncIndex, FlagValue, FrameInstPos, FrameStackShape, FrameStateSlotBuilder,
-    FrameTableBuilder, FuncKey, FunctionBodyData, FunctionLoc, HostCall, InliningCompiler,
-    ModuleTranslation, ModuleTypesBuilder, PtrSize, StackMapSection, StaticModuleIndex,
-    TrapEncodingBuilder, TrapSentinel, TripleExt, Tunables, WasmFuncType, WasmValType, prelude::*,
+    FrameTableBuilder, FuncKey, FunctionBodyData, FunctionCompileStats, FunctionLoc, HostCall,
+    InliningCompiler, ModuleTranslation, ModuleTypesBuilder, PtrSize, StackMapSection,
+    StaticModuleIndex, TrapEncodingBuilder, TrapSentinel, TripleExt, Tunables, WasmFuncType,
+    WasmValType, prelude::*,
 };
 use wasmtime_unwinder::ExceptionTableBuilder;
 
@@ -343,9 +346,20 @@ impl wasmtime_environ::Compiler for Compiler {
         log::debug!("`{symbol}` translated to CLIF in {:?}", timing.total());
         log::trace!("`{symbol}` timing info\n{timing}");
 
+        let stats = FunctionCompileStats {
+            total_time: timing.total(),
+            translation_time: timing.total(),
+            translated_ir_insts: live_insts(&compiler.cx.codegen_context.func),
+            bounds_checks: func_env.bounds_checks,
+            bounds_checks_elided: func_env.bounds_checks_elided,
+            bounds_checks_merged: func_env.bounds_checks_merged,
+            ..Default::default()
+        };
+
         Ok(CompiledFunctionBody {
             code: box_dyn_any_compiler_context(Some(compiler.cx)),
             needs_gc_heap,
+            stats,
         })
     }
 
@@ -444,6 +458,7 @@ impl wasmtime_environ::Compiler for Compiler {
         Ok(CompiledFunctionBody {
             code: box_dyn_any_compiler_context(Some(compiler.cx)),
             needs_gc_heap: false,
+            stats: Default::default(),
         })
     }
 
@@ -800,6 +815,7 @@ impl wasmtime_environ::Compiler for Compiler {
         Ok(CompiledFunctionBody {
             code: box_dyn_any_compiler_context(Some(compiler.cx)),
             needs_gc_heap: false,
+            stats: Default::default(),
         })
     }
 
@@ -952,11 +968,42 @@ impl InliningCompiler for Compiler {
         log::debug!("`{symbol}` compiled in {:?}", timing.total());
         log::trace!("`{symbol}` timing info\n{timing}");
 
+        let time =
+            |passes: &[Pass]| -> Duration { passes.iter().map(|p| timing.self_time(*p)).sum() };
+        let stats = &mut func_body.stats;
+        stats.total_time += timing.total();
+        stats.optimization_time = time(&[
+            Pass::flowgraph,
+            Pass::domtree,
+            Pass::loop_analysis,
+            Pass::preopt,
+            Pass::egraph,
+            Pass::gvn,
+            Pass::licm,
+            Pass::unreachable_code,
+            Pass::remove_constant_phis,
+            Pass::canonicalize_nans,
+        ]);
+        stats.lowering_time = time(&[Pass::vcode_lower]);
+        stats.regalloc_time = time(&[Pass::regalloc, Pass::regalloc_checker]);
+        stats.emission_time = time(&[Pass::vcode_emit, Pass::vcode_emit_finish]);
+        stats.optimized_ir_insts = compiled_func.ir_insts;
+        stats.code_size = compiled_func.buffer.data().len();
+
         func_body.code = box_dyn_any_compiled_function(compiled_func);
         Ok(())
     }
 }
 
+/// Returns the number of instructions in `func`'s layout, which unlike
+/// `DataFlowGraph::num_insts` excludes instructions removed by optimizations.
+fn live_insts(func: &ir::Function) -> usize {
+    func.layout
+        .blocks()
+        .map(|block| func.layout.block_insts(block).count())
+        .sum()
+}
+
 #[cfg(feature = "incremental-cache")]
 mod incremental_cache {
     use super::*;
@@ -1411,6 +1458,7 @@ impl Compiler {
         Ok(CompiledFunctionBody {
             code: box_dyn_any_compiler_context(Some(compiler.cx)),
             needs_gc_heap: false,
+            stats: Default::default(),
         })
     }
 }
@@ -1488,6 +1536,7 @@ impl FunctionCompiler<'_> {
             context.func.params.user_named_funcs().clone(),
             alignment,
         );
+        compiled_function.ir_insts = live_insts(&context.func);
 
         if let Some((body, tunables)) = body_and_tunables {
             let data = body.get_binary_reader();
@@ -1618,6 +1618,7 @@ impl ComponentCompiler for Compiler {
         Ok(CompiledFunctionBody {
             code: super::box_dyn_any_compiler_context(Some(compiler.cx)),
             needs_gc_heap: false,
+            stats: Default::default(),
         })
     }
 
@@ -1724,6 +1725,7 @@ impl ComponentCompiler for Compiler {
         Ok(CompiledFunctionBody {
             code: super::box_dyn_any_compiler_context(Some(compiler.cx)),
             needs_gc_heap: false,
+            stats: Default::default(),
         })
     }
 }
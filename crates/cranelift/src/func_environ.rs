@@ -26,13 +26,24 @@ use wasmtime_core::math::f64_cvt_to_int_bounds;
 use wasmtime_environ::{
     BuiltinFunctionIndex, DataIndex, DefinedFuncIndex, ElemIndex, EngineOrModuleTypeIndex,
     FrameStateSlotBuilder, FrameValType, FuncIndex, FuncKey, GlobalConstValue, GlobalIndex,
-    IndexType, Memory, MemoryIndex, Module, ModuleInternedTypeIndex, ModuleTranslation,
-    ModuleTypesBuilder, PtrSize, Table, TableIndex, TagIndex, TripleExt, Tunables, TypeConvert,
-    TypeIndex, VMOffsets, WasmCompositeInnerType, WasmFuncType, WasmHeapTopType, WasmHeapType,
-    WasmRefType, WasmResult, WasmValType,
+    HostIntrinsic, IndexType, Memory, MemoryIndex, Module, ModuleInternedTypeIndex,
+    ModuleTranslation, ModuleTypesBuilder, PtrSize, Table, TableIndex, TagIndex, TripleExt,
+    Tunables, TypeConvert, TypeIndex, VMOffsets, WasmCompositeInnerType, WasmFuncType,
+    WasmHeapTopType, WasmHeapType, WasmRefType, WasmResult, WasmValType,
 };
 use wasmtime_environ::{FUNCREF_INIT_BIT, FUNCREF_MASK};
 
+/// A function body or loop whose fuel is charged up front, once per entry or
+/// iteration, with per-loop fuel metering.
+struct FuelLoop {
+    /// The instruction adding this body's cost to the fuel variable, whose
+    /// immediate is patched once the whole body has been translated.
+    increment: Option<ir::Inst>,
+    /// The static cost of the instructions in this body, excluding those in
+    /// nested loops.
+    cost: i64,
+}
+
 #[derive(Debug)]
 pub(crate) enum Extension {
     Sign,
@@ -194,6 +205,26 @@ pub struct FuncEnvironment<'module_environment> {
 
     fuel_consumed: i64,
 
+    /// With per-loop fuel metering, whether each open control frame, starting
+    /// with the function body, is a loop, and the loops among them.
+    fuel_frames: Vec<bool>,
+    fuel_loops: Vec<FuelLoop>,
+
+    /// The `call_indirect` cache of the next `call_indirect` instruction, see
+    /// `ModuleTranslation::call_indirect_caches`.
+    next_call_indirect_cache: u32,
+
+    /// The number of explicit bounds checks emitted so far, the number of
+    /// heap accesses which didn't need one, and how many of those were covered
+    /// by an earlier check, see `FunctionCompileStats`.
+    pub(crate) bounds_checks: usize,
+    pub(crate) bounds_checks_elided: usize,
+    pub(crate) bounds_checks_merged: usize,
+
+    /// The explicit bounds checks which later heap accesses can be merged
+    /// into.
+    pub(crate) checked_heap_accesses: crate::bounds_checks::CheckedHeapAccesses,
+
     /// A `GlobalValue` in CLIF which represents the stack limit.
     ///
     /// Typically this resides in the `stack_limit` value of `ir::Function` but
@@ -233,6 +264,15 @@ impl<'module_environment> FuncEnvironment<'module_environment> {
         // being unused from the compiler.
         let _ = BuiltinFunctions::raise;
 
+        let next_call_indirect_cache = match key {
+            FuncKey::DefinedWasmFunction(_, index) => translation
+                .call_indirect_caches
+                .get(index)
+                .copied()
+                .unwrap_or(u32::MAX),
+            _ => u32::MAX,
+        };
+
         Self {
             key,
             isa: compiler.isa(),
@@ -268,6 +308,15 @@ impl<'module_environment> FuncEnvironment<'module_environment> {
             // Start with at least one fuel being consumed because even empty
             // functions should consume at least some fuel.
             fuel_consumed: 1,
+            fuel_frames: Vec::new(),
+            fuel_loops: Vec::new(),
+
+            next_call_indirect_cache,
+
+            bounds_checks: 0,
+            bounds_checks_elided: 0,
+            bounds_checks_merged: 0,
+            checked_heap_accesses: Default::default(),
 
             translation,
 
@@ -280,6 +329,24 @@ impl<'module_environment> FuncEnvironment<'module_environment> {
         }
     }
 
+    /// Returns the `call_indirect` cache of the `call_indirect` instruction
+    /// being translated, if it has one, see `Tunables::cache_call_indirects`.
+    ///
+    /// Only calls through 32-bit tables of untyped functions which never
+    /// change after instantiation are cached.
+    fn call_indirect_cache(&self, table_index: TableIndex) -> Option<u32> {
+        let cache = self.next_call_indirect_cache;
+        if cache >= self.offsets.num_call_indirect_caches {
+            return None;
+        }
+        self.translation.immutable_tables[table_index].as_ref()?;
+        let table = &self.module.tables[table_index];
+        if table.idx_type != IndexType::I32 || table.ref_type.heap_type != WasmHeapType::Func {
+            return None;
+        }
+        Some(cache)
+    }
+
     pub(crate) fn pointer_type(&self) -> ir::Type {
         self.isa.pointer_type()
     }
@@ -394,9 +461,36 @@ impl<'module_environment> FuncEnvironment<'module_environment> {
         debug_assert!(self.fuel_var.is_reserved_value());
         self.fuel_var = builder.declare_var(ir::types::I64);
         self.fuel_load_into_var(builder);
+        if self.tunables.fuel_per_loop {
+            // The function body is charged for like a loop that's entered
+            // once, with the same minimum cost.
+            let cost = mem::replace(&mut self.fuel_consumed, 0);
+            self.fuel_frames.push(true);
+            self.fuel_loops.push(FuelLoop {
+                increment: None,
+                cost,
+            });
+        }
         self.fuel_check(builder);
     }
 
+    /// Increments this function's counter in the `call_counters` array of the
+    /// `VMContext`.
+    fn count_function_call(&mut self, builder: &mut FunctionBuilder<'_>) {
+        let FuncKey::DefinedWasmFunction(_, index) = self.key else {
+            return;
+        };
+        let offset = i32::try_from(self.offsets.vmctx_call_counter(index)).unwrap();
+        let vmctx = self.vmctx_val(&mut builder.cursor());
+        let calls = builder
+            .ins()
+            .load(ir::types::I64, ir::MemFlags::trusted(), vmctx, offset);
+        let calls = builder.ins().iadd_imm(calls, 1);
+        builder
+            .ins()
+            .store(ir::MemFlags::trusted(), calls, vmctx, offset);
+    }
+
     fn fuel_function_exit(&mut self, builder: &mut FunctionBuilder<'_>) {
         // On exiting the function we need to be sure to save the fuel we have
         // cached locally in `self.fuel_var` back into the Store-defined
@@ -410,6 +504,9 @@ impl<'module_environment> FuncEnvironment<'module_environment> {
         builder: &mut FunctionBuilder<'_>,
         reachable: bool,
     ) {
+        if self.tunables.fuel_per_loop {
+            return self.fuel_per_loop_before_op(op, builder, reachable);
+        }
         if !reachable {
             // In unreachable code we shouldn't have any leftover fuel we
             // haven't accounted for since the reason for us to become
@@ -511,6 +608,76 @@ impl<'module_environment> FuncEnvironment<'module_environment> {
         }
     }
 
+    /// Per-loop fuel metering, where each loop iteration is charged the static
+    /// cost of the whole loop body on entry to the loop header, and the rest
+    /// of the function is charged on entry to the function. No per-block
+    /// accounting is done, so the fuel variable is only updated at function
+    /// entry and loop headers and saved around calls.
+    fn fuel_per_loop_before_op(
+        &mut self,
+        op: &Operator<'_>,
+        builder: &mut FunctionBuilder<'_>,
+        reachable: bool,
+    ) {
+        // Control frames are tracked in unreachable code too, so that each
+        // `end` is matched with its frame.
+        match op {
+            Operator::Block { .. } | Operator::If { .. } | Operator::TryTable { .. } => {
+                self.fuel_frames.push(false);
+            }
+            Operator::Loop { .. } => {
+                self.fuel_frames.push(true);
+                self.fuel_loops.push(FuelLoop {
+                    increment: None,
+                    cost: 0,
+                });
+            }
+            Operator::End => {
+                if self.fuel_frames.pop().unwrap() {
+                    let fuel_loop = self.fuel_loops.pop().unwrap();
+                    if let Some(inst) = fuel_loop.increment {
+                        let fuel = builder.func.dfg.inst_args(inst)[0];
+                        builder
+                            .func
+                            .dfg
+                            .replace(inst)
+                            .iadd_imm(fuel, fuel_loop.cost);
+                    }
+                }
+            }
+            _ => {}
+        }
+        if !reachable {
+            return;
+        }
+
+        self.fuel_loops.last_mut().unwrap().cost += match op {
+            Operator::Nop | Operator::Drop => 0,
+            Operator::Block { .. }
+            | Operator::Loop { .. }
+            | Operator::Unreachable
+            | Operator::Return
+            | Operator::Else
+            | Operator::End => 0,
+            _ => 1,
+        };
+
+        match op {
+            // As with per-block metering, the fuel is saved when leaving this
+            // function, and reloaded after calls in `fuel_after_op`.
+            Operator::Unreachable
+            | Operator::Return
+            | Operator::CallIndirect { .. }
+            | Operator::Call { .. }
+            | Operator::ReturnCall { .. }
+            | Operator::ReturnCallRef { .. }
+            | Operator::ReturnCallIndirect { .. }
+            | Operator::Throw { .. }
+            | Operator::ThrowRef => self.fuel_save_from_var(builder),
+            _ => {}
+        }
+    }
+
     fn fuel_after_op(&mut self, op: &Operator<'_>, builder: &mut FunctionBuilder<'_>) {
         // After a function call we need to reload our fuel value since the
         // function may have changed it.
@@ -571,6 +738,19 @@ impl<'module_environment> FuncEnvironment<'module_environment> {
     /// the out-of-fuel function.
     fn fuel_check(&mut self, builder: &mut FunctionBuilder) {
         self.fuel_increment_var(builder);
+        if self.tunables.fuel_per_loop {
+            // Charge for the innermost body with an increment whose cost is
+            // filled in at the body's end. Loops which aren't wasm loops,
+            // such as those emitted for `array.fill`, are charged as part of
+            // their enclosing body instead.
+            let fuel_loop = self.fuel_loops.last_mut().unwrap();
+            if fuel_loop.increment.is_none() {
+                let fuel = builder.use_var(self.fuel_var);
+                let fuel = builder.ins().iadd_imm(fuel, 0);
+                builder.def_var(self.fuel_var, fuel);
+                fuel_loop.increment = builder.func.dfg.value_def(fuel).inst();
+            }
+        }
         let out_of_gas_block = builder.create_block();
         let continuation_block = builder.create_block();
 
@@ -888,6 +1068,15 @@ impl<'module_environment> FuncEnvironment<'module_environment> {
         assert_eq!(FUNCREF_MASK as isize, -2);
         let value_masked = builder.ins().band_imm(value, Imm64::from(-2));
 
+        // Elements of eagerly-initialized tables still carry the initialized
+        // bit, but are never null.
+        if self
+            .module
+            .table_initialized_eagerly(self.tunables, table_index)
+        {
+            return value_masked;
+        }
+
         let null_block = builder.create_block();
         let continuation_block = builder.create_block();
         if cold_blocks {
@@ -1063,6 +1252,10 @@ impl<'module_environment> FuncEnvironment<'module_environment> {
         let trap_block = builder.create_block();
         builder.set_cold_block(trap_block);
         let continuation_block = builder.create_block();
+        // The continuation is only reachable from the current block, so heap
+        // accesses there can still be merged into the checks made so far.
+        self.checked_heap_accesses
+            .continue_in(builder.current_block(), continuation_block);
 
         builder
             .ins()
@@ -1427,11 +1620,12 @@ impl FuncEnvironment<'_> {
         }
 
         if !self.module.globals[index].mutability {
-            if let Some(index) = self.module.defined_global_index(index) {
-                let init = &self.module.global_initializers[index];
-                if let Some(value) = init.const_eval() {
-                    return GlobalVariable::Constant { value };
-                }
+            let init = match self.module.defined_global_index(index) {
+                Some(index) => Some(&self.module.global_initializers[index]),
+                None => self.module.specialized_globals.get(&index),
+            };
+            if let Some(value) = init.and_then(|init| init.const_eval()) {
+                return GlobalVariable::Constant { value };
             }
         }
 
@@ -1969,6 +2163,16 @@ impl<'a, 'func, 'module_env> Call<'a, 'func, 'module_env> {
             return Ok(self.direct_call_inst(callee, &real_call_args));
         }
 
+        // Calls to imported functions with a known trivial behavior are
+        // replaced by that behavior. Tail calls still call the import so that
+        // the results don't need to be returned here.
+        if !self.tail {
+            if let Some(intrinsic) = self.env.module.inlined_imports.get(&callee_index) {
+                let result = self.env.translate_host_intrinsic(self.builder, *intrinsic);
+                return Ok(smallvec![result]);
+            }
+        }
+
         // Handle direct calls to imported functions. We use an indirect call
         // so that we don't have to patch the code at runtime.
         let pointer_type = self.env.pointer_type();
@@ -2049,6 +2253,20 @@ impl<'a, 'func, 'module_env> Call<'a, 'func, 'module_env> {
         callee: ir::Value,
         call_args: &[ir::Value],
     ) -> WasmResult<Option<CallRets>> {
+        if let Some(cache) = self.env.call_indirect_cache(table_index) {
+            return self
+                .cached_indirect_call(
+                    cache,
+                    features,
+                    table_index,
+                    ty_index,
+                    sig_ref,
+                    callee,
+                    call_args,
+                )
+                .map(Some);
+        }
+
         let (code_ptr, callee_vmctx) = match self.check_and_load_code_and_callee_vmctx(
             features,
             table_index,
@@ -2064,6 +2282,86 @@ impl<'a, 'func, 'module_env> Call<'a, 'func, 'module_env> {
             .map(Some)
     }
 
+    /// Does an indirect call through the `call_indirect` cache `cache` of this
+    /// call site.
+    ///
+    /// The cache holds the table index that this site last called and the
+    /// function that it found there. The table never changes, so a call with
+    /// the same index can use that function without repeating any of the
+    /// checks that found it. Otherwise the function is looked up and checked
+    /// as usual, and then stored in the cache.
+    fn cached_indirect_call(
+        mut self,
+        cache: u32,
+        features: &WasmFeatures,
+        table_index: TableIndex,
+        ty_index: TypeIndex,
+        sig_ref: ir::SigRef,
+        callee: ir::Value,
+        call_args: &[ir::Value],
+    ) -> WasmResult<CallRets> {
+        let pointer_type = self.env.pointer_type();
+        let offsets = &self.env.offsets;
+        let cache = offsets.vmctx_call_indirect_cache(cache);
+        let field = |offset: u8| i32::try_from(cache + u32::from(offset)).unwrap();
+        let index_offset = field(offsets.call_indirect_cache_index());
+        let wasm_call_offset = field(offsets.call_indirect_cache_wasm_call());
+        let vmctx_offset = field(offsets.call_indirect_cache_vmctx());
+        let vmctx = self.caller_vmctx();
+        let flags = ir::MemFlags::trusted();
+
+        // The cached index is a `u64` so that its initial value of
+        // `u64::MAX` never matches a 32-bit table index.
+        let index = self.builder.ins().uextend(I64, callee);
+        let cached_index = self.builder.ins().load(I64, flags, vmctx, index_offset);
+        let hit = self.builder.ins().icmp(IntCC::Equal, index, cached_index);
+
+        let hit_block = self.builder.create_block();
+        let miss_block = self.builder.create_block();
+        let call_block = self.builder.create_block();
+        self.builder.append_block_param(call_block, pointer_type);
+        self.builder.append_block_param(call_block, pointer_type);
+        self.builder
+            .ins()
+            .brif(hit, hit_block, &[], miss_block, &[]);
+
+        self.builder.switch_to_block(hit_block);
+        self.builder.seal_block(hit_block);
+        let code_ptr = self
+            .builder
+            .ins()
+            .load(pointer_type, flags, vmctx, wasm_call_offset);
+        let callee_vmctx = self
+            .builder
+            .ins()
+            .load(pointer_type, flags, vmctx, vmctx_offset);
+        self.builder
+            .ins()
+            .jump(call_block, &[code_ptr.into(), callee_vmctx.into()]);
+
+        self.builder.switch_to_block(miss_block);
+        self.builder.seal_block(miss_block);
+        let (code_ptr, callee_vmctx) = self
+            .check_and_load_code_and_callee_vmctx(features, table_index, ty_index, callee, false)?
+            .expect("calls through untyped funcref tables never trap statically");
+        self.builder
+            .ins()
+            .store(flags, code_ptr, vmctx, wasm_call_offset);
+        self.builder
+            .ins()
+            .store(flags, callee_vmctx, vmctx, vmctx_offset);
+        self.builder.ins().store(flags, index, vmctx, index_offset);
+        self.builder
+            .ins()
+            .jump(call_block, &[code_ptr.into(), callee_vmctx.into()]);
+
+        self.builder.switch_to_block(call_block);
+        self.builder.seal_block(call_block);
+        let code_ptr = self.builder.block_params(call_block)[0];
+        let callee_vmctx = self.builder.block_params(call_block)[1];
+        self.unchecked_call_impl(sig_ref, code_ptr, callee_vmctx, call_args)
+    }
+
     fn check_and_load_code_and_callee_vmctx(
         &mut self,
         features: &WasmFeatures,
@@ -2125,6 +2423,18 @@ impl<'a, 'func, 'module_env> Call<'a, 'func, 'module_env> {
         let sig_id_size = self.env.offsets.size_of_vmshared_type_index();
         let sig_id_type = Type::int(u16::from(sig_id_size) * 8).unwrap();
 
+        // If the table never changes after instantiation and every function
+        // in it has exactly the type of this call, then no typecheck is
+        // necessary either.
+        if let Some(immutable) = &self.env.translation.immutable_tables[table_index] {
+            let specified_ty = self.env.module.types[ty_index].unwrap_module_type_index();
+            if immutable.uniform_type == Some(specified_ty) {
+                return CheckIndirectCallTypeSignature::StaticMatch {
+                    may_be_null: table.ref_type.nullable,
+                };
+            }
+        }
+
         // Test if a type check is necessary for this table. If this table is a
         // table of typed functions and that type matches `ty_index`, then
         // there's no need to perform a typecheck.
@@ -3266,6 +3576,41 @@ impl FuncEnvironment<'_> {
         )
     }
 
+    /// Translates `intrinsic`, which a call to an imported function was
+    /// replaced with, and returns its result.
+    fn translate_host_intrinsic(
+        &mut self,
+        builder: &mut FunctionBuilder<'_>,
+        intrinsic: HostIntrinsic,
+    ) -> ir::Value {
+        let (ty, offset) = match intrinsic {
+            HostIntrinsic::I32Const(x) => return builder.ins().iconst(I32, i64::from(x)),
+            HostIntrinsic::I64Const(x) => return builder.ins().iconst(I64, x),
+            HostIntrinsic::F32Const(x) => {
+                return builder.ins().f32const(ir::immediates::Ieee32::with_bits(x));
+            }
+            HostIntrinsic::F64Const(x) => {
+                return builder.ins().f64const(ir::immediates::Ieee64::with_bits(x));
+            }
+            HostIntrinsic::I32StoreData(offset) => (I32, offset),
+            HostIntrinsic::I64StoreData(offset) => (I64, offset),
+            HostIntrinsic::F32StoreData(offset) => (F32, offset),
+            HostIntrinsic::F64StoreData(offset) => (F64, offset),
+        };
+
+        // The pointer to the store's data never changes, but the data itself
+        // may be modified by the host between any two calls.
+        let store_ctx = self.get_vmstore_context_ptr(builder);
+        let data = builder.ins().load(
+            self.pointer_type(),
+            ir::MemFlags::trusted().with_readonly().with_can_move(),
+            store_ctx,
+            i32::from(self.offsets.ptr.vmstore_context_store_data()),
+        );
+        let addr = builder.ins().iadd_imm(data, i64::from(offset));
+        builder.ins().load(ty, ir::MemFlags::trusted(), addr, 0)
+    }
+
     pub fn translate_call<'a>(
         &mut self,
         builder: &'a mut FunctionBuilder,
@@ -3817,6 +4162,11 @@ impl FuncEnvironment<'_> {
         if self.is_reachable() {
             self.update_state_slot_stack(validator, builder)?;
         }
+        // Every `call_indirect` is assigned a cache, even in unreachable
+        // code, to match the numbering of `ModuleTranslation`.
+        if let Operator::CallIndirect { .. } = op {
+            self.next_call_indirect_cache = self.next_call_indirect_cache.saturating_add(1);
+        }
         Ok(())
     }
 
@@ -3837,6 +4187,10 @@ impl FuncEnvironment<'_> {
             self.conditionally_trap(builder, overflow, ir::TrapCode::STACK_OVERFLOW);
         }
 
+        if self.offsets.num_call_counters > 0 {
+            self.count_function_call(builder);
+        }
+
         // Additionally we initialize `fuel_var` if it will get used.
         if self.tunables.consume_fuel {
             self.fuel_function_entry(builder);
@@ -4006,6 +4360,10 @@ impl FuncEnvironment<'_> {
         self.isa.has_x86_pmaddubsw_lowering()
     }
 
+    pub fn use_x86_vpdpbusd_for_dot(&self) -> bool {
+        self.isa.has_x86_vpdpbusd_lowering()
+    }
+
     pub fn handle_before_return(&mut self, retvals: &[ir::Value], builder: &mut FunctionBuilder) {
         #[cfg(feature = "wmemcheck")]
         if self.compiler.wmemcheck {
@@ -4062,6 +4420,63 @@ impl FuncEnvironment<'_> {
         let _ = (builder, val_size, addr, offset);
     }
 
+    /// Counts down to the next sampled memory access when
+    /// `Config::memory_access_sampling` is enabled, and records an access to
+    /// `memory_index` at `index + offset` when it's reached.
+    pub fn sample_memory_access(
+        &mut self,
+        builder: &mut FunctionBuilder,
+        memory_index: MemoryIndex,
+        index: ir::Value,
+        offset: u64,
+    ) {
+        let memory = self.memory(memory_index);
+        if self.tunables.memory_access_sample_interval == 0 || memory.shared {
+            return;
+        }
+
+        let vmstore_ctx = self.get_vmstore_context_ptr(builder);
+        let countdown_offset =
+            i32::from(self.offsets.ptr.vmstore_context_memory_access_countdown());
+        let countdown = builder.ins().load(
+            self.pointer_type(),
+            ir::MemFlags::trusted(),
+            vmstore_ctx,
+            countdown_offset,
+        );
+        let countdown = builder.ins().iadd_imm(countdown, -1);
+        builder.ins().store(
+            ir::MemFlags::trusted(),
+            countdown,
+            vmstore_ctx,
+            countdown_offset,
+        );
+
+        let sample_block = builder.create_block();
+        let continuation_block = builder.create_block();
+        builder.set_cold_block(sample_block);
+        builder
+            .ins()
+            .brif(countdown, continuation_block, &[], sample_block, &[]);
+        builder.seal_block(sample_block);
+
+        builder.switch_to_block(sample_block);
+        let mut pos = builder.cursor();
+        let addr = self.cast_index_to_i64(&mut pos, index, memory.idx_type);
+        let addr = pos.ins().iadd_imm(addr, offset.cast_signed());
+        let record_memory_access = self.builtin_functions.record_memory_access(&mut pos.func);
+        let (memory_vmctx, defined_memory_index) =
+            self.memory_vmctx_and_defined_index(&mut pos, memory_index);
+        pos.ins().call(
+            record_memory_access,
+            &[memory_vmctx, defined_memory_index, addr],
+        );
+        builder.ins().jump(continuation_block, &[]);
+        builder.seal_block(continuation_block);
+
+        builder.switch_to_block(continuation_block);
+    }
+
     pub fn update_global(
         &mut self,
         builder: &mut FunctionBuilder,
@@ -8,7 +8,11 @@ use cranelift_codegen::ir::condcodes::IntCC;
 use cranelift_codegen::ir::{self, InstBuilder};
 use cranelift_frontend::FunctionBuilder;
 use smallvec::SmallVec;
-use wasmtime_environ::drc::{EXCEPTION_TAG_DEFINED_OFFSET, EXCEPTION_TAG_INSTANCE_OFFSET};
+use wasmtime_environ::drc::{
+    ALLOC_ALIGN, EXCEPTION_TAG_DEFINED_OFFSET, EXCEPTION_TAG_INSTANCE_OFFSET,
+    HEADER_IN_OVER_APPROX_LIST_BIT, HEAP_DATA_BUMP_END_OFFSET, HEAP_DATA_BUMP_NEXT_OFFSET,
+    HEAP_DATA_OVER_APPROX_LIST_HEAD_OFFSET,
+};
 use wasmtime_environ::{
     GcTypeLayouts, ModuleInternedTypeIndex, PtrSize, TypeIndex, VMGcKind, WasmHeapTopType,
     WasmHeapType, WasmRefType, WasmResult, WasmStorageType, WasmValType, drc::DrcTypeLayouts,
@@ -347,7 +351,37 @@ impl DrcCompiler {
     }
 }
 
-/// Emit CLIF to call the `gc_raw_alloc` libcall.
+/// Emit CLIF to allocate a GC object.
+///
+/// Without `Tunables::gc_inline_alloc` this is just a call to the
+/// `gc_alloc_raw` libcall. With it, the object is bump-allocated inline when
+/// the DRC heap's bump region has room for it, which is the common case, and
+/// otherwise the libcall allocates it and refills the bump region:
+///
+/// ```text
+/// current_block:
+///     let heap_data = load vmctx.gc_heap_data
+///     let next = load heap_data.bump_next
+///     let end = load heap_data.bump_end
+///     let new_next = next + round_up(size, ALLOC_ALIGN)
+///     brif new_next <= end, bump_block, libcall_block
+///
+/// bump_block:
+///     store heap_data.bump_next, new_next
+///     initialize the `VMDrcHeader` at `next` with a ref count of 1
+///     push `next` onto the over-approximated-stack-roots list
+///     jump continue_block(next)
+///
+/// libcall_block: ;; cold
+///     let gc_ref = call gc_alloc_raw(...)
+///     jump continue_block(gc_ref)
+///
+/// continue_block(gc_ref):
+///     ...
+/// ```
+///
+/// Either way the new object ends up with a ref count of one, held by the
+/// over-approximated-stack-roots list, just like `gc_alloc_raw`'s objects.
 fn emit_gc_raw_alloc(
     func_env: &mut FuncEnvironment<'_>,
     builder: &mut FunctionBuilder<'_>,
@@ -355,6 +389,156 @@ fn emit_gc_raw_alloc(
     ty: ModuleInternedTypeIndex,
     size: ir::Value,
     align: u32,
+) -> ir::Value {
+    assert_eq!(builder.func.dfg.value_type(size), ir::types::I32);
+    assert!(align.is_power_of_two());
+    assert!(align <= ALLOC_ALIGN);
+
+    if !func_env.tunables.gc_inline_alloc {
+        let gc_ref = emit_gc_alloc_raw_call(func_env, builder, kind, ty, size, align);
+        builder.declare_value_needs_stack_map(gc_ref);
+        return gc_ref;
+    }
+
+    let current_block = builder.current_block().unwrap();
+    let bump_block = builder.create_block();
+    let libcall_block = builder.create_block();
+    let continue_block = builder.create_block();
+    let gc_ref = builder.append_block_param(continue_block, ir::types::I32);
+
+    builder.ensure_inserted_block();
+    builder.insert_block_after(bump_block, current_block);
+    builder.insert_block_after(continue_block, bump_block);
+    builder.insert_block_after(libcall_block, continue_block);
+
+    // Current block: check whether the bump region has room for the object.
+    // The arithmetic is done in 64 bits so that it can't overflow.
+    let ptr_ty = func_env.pointer_type();
+    let vmctx = func_env.vmctx_val(&mut builder.cursor());
+    let heap_data = builder.ins().load(
+        ptr_ty,
+        ir::MemFlags::trusted().with_readonly(),
+        vmctx,
+        i32::from(func_env.offsets.ptr.vmctx_gc_heap_data()),
+    );
+    let next = builder.ins().load(
+        ir::types::I32,
+        ir::MemFlags::trusted(),
+        heap_data,
+        i32::try_from(HEAP_DATA_BUMP_NEXT_OFFSET).unwrap(),
+    );
+    let end = builder.ins().load(
+        ir::types::I32,
+        ir::MemFlags::trusted(),
+        heap_data,
+        i32::try_from(HEAP_DATA_BUMP_END_OFFSET).unwrap(),
+    );
+    let size_i64 = builder.ins().uextend(ir::types::I64, size);
+    let alloc_size = builder.ins().iadd_imm(size_i64, i64::from(ALLOC_ALIGN - 1));
+    let alloc_size = builder.ins().band_imm(alloc_size, -i64::from(ALLOC_ALIGN));
+    let next_i64 = builder.ins().uextend(ir::types::I64, next);
+    let end_i64 = builder.ins().uextend(ir::types::I64, end);
+    let new_next = builder.ins().iadd(next_i64, alloc_size);
+    let fits = builder
+        .ins()
+        .icmp(IntCC::UnsignedLessThanOrEqual, new_next, end_i64);
+    builder
+        .ins()
+        .brif(fits, bump_block, &[], libcall_block, &[]);
+
+    // Bump block: claim the space and initialize the object's header. The
+    // bump region is always within the heap, so these accesses don't need
+    // bounds checks.
+    log::trace!("emit_gc_raw_alloc: bump_block");
+    builder.switch_to_block(bump_block);
+    builder.seal_block(bump_block);
+    let new_next = builder.ins().ireduce(ir::types::I32, new_next);
+    builder.ins().store(
+        ir::MemFlags::trusted(),
+        new_next,
+        heap_data,
+        i32::try_from(HEAP_DATA_BUMP_NEXT_OFFSET).unwrap(),
+    );
+    let base = func_env.get_gc_heap_base(builder);
+    let extended_next = uextend_i32_to_pointer_type(builder, ptr_ty, next);
+    let object_addr = builder.ins().iadd(base, extended_next);
+    let kind_and_reserved = builder.ins().iconst(
+        ir::types::I32,
+        i64::from(kind.as_u32() | HEADER_IN_OVER_APPROX_LIST_BIT),
+    );
+    builder.ins().store(
+        ir::MemFlags::trusted(),
+        kind_and_reserved,
+        object_addr,
+        i32::try_from(func_env.offsets.vm_gc_header_kind()).unwrap(),
+    );
+    let shared_ty = func_env.module_interned_to_shared_ty(&mut builder.cursor(), ty);
+    builder.ins().store(
+        ir::MemFlags::trusted(),
+        shared_ty,
+        object_addr,
+        i32::try_from(func_env.offsets.vm_gc_header_ty()).unwrap(),
+    );
+    let ref_count = builder.ins().iconst(ir::types::I64, 1);
+    builder.ins().store(
+        ir::MemFlags::trusted(),
+        ref_count,
+        object_addr,
+        i32::try_from(func_env.offsets.vm_drc_header_ref_count()).unwrap(),
+    );
+    builder.ins().store(
+        ir::MemFlags::trusted(),
+        size,
+        object_addr,
+        i32::try_from(func_env.offsets.vm_drc_header_object_size()).unwrap(),
+    );
+    let head = builder.ins().load(
+        ir::types::I32,
+        ir::MemFlags::trusted(),
+        heap_data,
+        i32::try_from(HEAP_DATA_OVER_APPROX_LIST_HEAD_OFFSET).unwrap(),
+    );
+    builder.ins().store(
+        ir::MemFlags::trusted(),
+        head,
+        object_addr,
+        i32::try_from(
+            func_env
+                .offsets
+                .vm_drc_header_next_over_approximated_stack_root(),
+        )
+        .unwrap(),
+    );
+    builder.ins().store(
+        ir::MemFlags::trusted(),
+        next,
+        heap_data,
+        i32::try_from(HEAP_DATA_OVER_APPROX_LIST_HEAD_OFFSET).unwrap(),
+    );
+    builder.ins().jump(continue_block, &[next.into()]);
+
+    // Libcall block: allocate the object in the runtime.
+    log::trace!("emit_gc_raw_alloc: libcall_block");
+    builder.switch_to_block(libcall_block);
+    builder.seal_block(libcall_block);
+    builder.set_cold_block(libcall_block);
+    let allocated = emit_gc_alloc_raw_call(func_env, builder, kind, ty, size, align);
+    builder.ins().jump(continue_block, &[allocated.into()]);
+
+    builder.switch_to_block(continue_block);
+    builder.seal_block(continue_block);
+    builder.declare_value_needs_stack_map(gc_ref);
+    gc_ref
+}
+
+/// Emit CLIF to call the `gc_alloc_raw` libcall.
+fn emit_gc_alloc_raw_call(
+    func_env: &mut FuncEnvironment<'_>,
+    builder: &mut FunctionBuilder<'_>,
+    kind: VMGcKind,
+    ty: ModuleInternedTypeIndex,
+    size: ir::Value,
+    align: u32,
 ) -> ir::Value {
     let gc_alloc_raw_builtin = func_env.builtin_functions.gc_alloc_raw(builder.func);
     let vmctx = func_env.vmctx_val(&mut builder.cursor());
@@ -365,16 +549,13 @@ fn emit_gc_raw_alloc(
 
     let ty = builder.ins().iconst(ir::types::I32, i64::from(ty.as_u32()));
 
-    assert!(align.is_power_of_two());
     let align = builder.ins().iconst(ir::types::I32, i64::from(align));
 
     let call_inst = builder
         .ins()
         .call(gc_alloc_raw_builtin, &[vmctx, kind, ty, size, align]);
 
-    let gc_ref = builder.func.dfg.first_result(call_inst);
-    builder.declare_value_needs_stack_map(gc_ref);
-    gc_ref
+    builder.func.dfg.first_result(call_inst)
 }
 
 impl GcCompiler for DrcCompiler {
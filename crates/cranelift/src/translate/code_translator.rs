@@ -2556,8 +2556,14 @@ pub fn translate_operator(
         Operator::I32x4RelaxedDotI8x16I7x16AddS => {
             let c = pop1_with_bitcast(environ, I32X4, builder);
             let (a, b) = pop2_with_bitcast(environ, I8X16, builder);
-            let dot =
-                if environ.relaxed_simd_deterministic() || !environ.use_x86_pmaddubsw_for_dot() {
+            if !environ.relaxed_simd_deterministic() && environ.use_x86_vpdpbusd_for_dot() {
+                // VNNI performs the whole operation in one instruction, and
+                // unlike `pmaddubsw` doesn't saturate intermediate sums.
+                environ.stacks.push1(builder.ins().x86_vpdpbusd(a, b, c));
+            } else {
+                let dot = if environ.relaxed_simd_deterministic()
+                    || !environ.use_x86_pmaddubsw_for_dot()
+                {
                     // Deterministic semantics are to treat both operands as
                     // signed integers and perform the dot product.
                     let alo = builder.ins().swiden_low(a);
@@ -2570,10 +2576,11 @@ pub fn translate_operator(
                 } else {
                     builder.ins().x86_pmaddubsw(a, b)
                 };
-            let dotlo = builder.ins().swiden_low(dot);
-            let dothi = builder.ins().swiden_high(dot);
-            let dot32 = builder.ins().iadd_pairwise(dotlo, dothi);
-            environ.stacks.push1(builder.ins().iadd(dot32, c));
+                let dotlo = builder.ins().swiden_low(dot);
+                let dothi = builder.ins().swiden_high(dot);
+                let dot32 = builder.ins().iadd_pairwise(dotlo, dothi);
+                environ.stacks.push1(builder.ins().iadd(dot32, c));
+            }
         }
 
         Operator::BrOnNull { relative_depth } => {
@@ -3466,6 +3473,7 @@ fn prepare_addr(
 
     let memory_index = MemoryIndex::from_u32(memarg.memory);
     let heap = environ.get_or_create_heap(builder.func, memory_index);
+    environ.sample_memory_access(builder, memory_index, index, memarg.offset);
 
     // How exactly the bounds check is performed here and what it's performed
     // on is a bit tricky. Generally we want to rely on access violations (e.g.
@@ -250,6 +250,10 @@ macro_rules! foreach_builtin_function {
 
             // Process a debug breakpoint.
             breakpoint(vmctx: vmctx) -> bool;
+
+            // Records a sampled access to the byte address `addr` of a locally
+            // defined memory, see `Config::memory_access_sampling`.
+            record_memory_access(vmctx: vmctx, memory: u32, addr: u64);
         }
     };
 }
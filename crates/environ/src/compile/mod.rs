@@ -7,6 +7,7 @@ use crate::{
     DefinedFuncIndex, FlagValue, FuncKey, FunctionLoc, ObjectKind, PrimaryMap, StaticModuleIndex,
     TripleExt, Tunables, WasmError, WasmFuncType, obj,
 };
+use core::time::Duration;
 use object::write::{Object, SymbolId};
 use object::{Architecture, BinaryFormat, FileFlags};
 use std::any::Any;
@@ -175,6 +176,47 @@ pub struct CompiledFunctionBody {
     /// Whether the compiled function needs a GC heap to run; that is, whether
     /// it reads a struct field, allocates, an array, or etc...
     pub needs_gc_heap: bool,
+    /// Measurements of the cost of compiling this function.
+    pub stats: FunctionCompileStats,
+}
+
+/// Measurements taken while compiling a single function, used to diagnose
+/// where compile time goes.
+///
+/// Compilers fill in whatever they're able to measure and leave the rest as
+/// zero. Times for functions inlined into another function are attributed to
+/// the function they were inlined into.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct FunctionCompileStats {
+    /// Total time spent compiling this function.
+    pub total_time: Duration,
+    /// Time spent translating wasm into the compiler's IR.
+    pub translation_time: Duration,
+    /// Time spent in IR optimization passes.
+    pub optimization_time: Duration,
+    /// Time spent lowering IR into machine instructions.
+    pub lowering_time: Duration,
+    /// Time spent in register allocation.
+    pub regalloc_time: Duration,
+    /// Time spent emitting machine code.
+    pub emission_time: Duration,
+    /// The number of IR instructions after translation.
+    pub translated_ir_insts: usize,
+    /// The number of IR instructions after optimization.
+    pub optimized_ir_insts: usize,
+    /// The size, in bytes, of the emitted machine code.
+    pub code_size: usize,
+    /// The number of explicit bounds checks emitted for accesses to linear
+    /// memories and the GC heap.
+    pub bounds_checks: usize,
+    /// The number of accesses to linear memories and the GC heap which didn't
+    /// need an explicit bounds check, for example because guard regions cover
+    /// every address they can compute.
+    pub bounds_checks_elided: usize,
+    /// The number of accesses included in `bounds_checks_elided` which didn't
+    /// need an explicit bounds check because an earlier check of the same or a
+    /// nearby address already covered them.
+    pub bounds_checks_merged: usize,
 }
 
 /// An implementation of a compiler which can compile WebAssembly functions to
@@ -21,8 +21,8 @@ use std::path::PathBuf;
 use std::sync::Arc;
 use wasmparser::{
     CustomSectionReader, DataKind, ElementItems, ElementKind, Encoding, ExternalKind,
-    FuncToValidate, FunctionBody, KnownCustom, NameSectionReader, Naming, Parser, Payload, TypeRef,
-    Validator, ValidatorResources, types::Types,
+    FuncToValidate, FunctionBody, KnownCustom, NameSectionReader, Naming, Operator, Parser,
+    Payload, TypeRef, Validator, ValidatorResources, types::Types,
 };
 
 /// Object containing the standalone environment information.
@@ -36,6 +36,10 @@ pub struct ModuleEnvironment<'a, 'data> {
     // Various bits and pieces of configuration
     validator: &'a mut Validator,
     tunables: &'a Tunables,
+
+    /// Tables which are modified by an instruction in some function body,
+    /// when `call_indirect` caching is enabled.
+    mutated_tables: SecondaryMap<TableIndex, bool>,
 }
 
 /// The result of translating via `ModuleEnvironment`.
@@ -66,6 +70,18 @@ pub struct ModuleTranslation<'data> {
     /// `FuncKey::DefinedWasmFunction(..)`s and `FuncKey::Intrinsic(..)`s.
     pub known_imported_functions: SecondaryMap<FuncIndex, Option<FuncKey>>,
 
+    /// The tables whose contents never change after instantiation, when
+    /// `call_indirect` caching is enabled.
+    pub immutable_tables: SecondaryMap<TableIndex, Option<ImmutableTable>>,
+
+    /// The index of the first `call_indirect` cache of each defined function,
+    /// when `call_indirect` caching is enabled.
+    ///
+    /// Every `call_indirect` instruction in a function, in order, is assigned
+    /// the next cache, but only those below `Module::num_call_indirect_caches`
+    /// exist.
+    pub call_indirect_caches: PrimaryMap<DefinedFuncIndex, u32>,
+
     /// A list of type signatures which are considered exported from this
     /// module, or those that can possibly be called. This list is sorted, and
     /// trampolines for each of these signatures are required.
@@ -120,6 +136,8 @@ impl<'data> ModuleTranslation<'data> {
             wasm: &[],
             function_body_inputs: PrimaryMap::default(),
             known_imported_functions: SecondaryMap::default(),
+            immutable_tables: SecondaryMap::default(),
+            call_indirect_caches: PrimaryMap::default(),
             exported_signatures: Vec::default(),
             debuginfo: DebugInfoData::default(),
             has_unparsed_debuginfo: false,
@@ -181,6 +199,18 @@ pub struct NameSection<'a> {
     pub locals_names: HashMap<FuncIndex, HashMap<u32, &'a str>>,
 }
 
+/// A table whose contents never change after instantiation, see
+/// `ModuleTranslation::immutable_tables`.
+#[derive(Clone, Debug)]
+pub struct ImmutableTable {
+    /// The type of every function that the table is initialized with, if
+    /// they all have the same type.
+    pub uniform_type: Option<ModuleInternedTypeIndex>,
+}
+
+/// The maximum number of `call_indirect` caches in a module.
+const MAX_CALL_INDIRECT_CACHES: usize = 50_000;
+
 #[derive(Debug, Default)]
 #[expect(missing_docs, reason = "self-describing fields")]
 pub struct WasmFileInfo {
@@ -210,6 +240,7 @@ impl<'a, 'data> ModuleEnvironment<'a, 'data> {
             types,
             tunables,
             validator,
+            mutated_tables: SecondaryMap::default(),
         }
     }
 
@@ -272,6 +303,14 @@ impl<'a, 'data> ModuleEnvironment<'a, 'data> {
                     .collect();
                 self.result.exported_signatures.sort_unstable();
                 self.result.exported_signatures.dedup();
+
+                if self.tunables.count_function_calls {
+                    self.result.module.num_call_counters = self.result.module.num_defined_funcs();
+                }
+
+                if self.tunables.cache_call_indirects {
+                    self.find_immutable_tables();
+                }
             }
 
             Payload::TypeSection(types) => {
@@ -614,6 +653,9 @@ impl<'a, 'data> ModuleEnvironment<'a, 'data> {
                     // all be flagged as escaping.
                     self.flag_func_escaped(func_index);
                 }
+                if self.tunables.cache_call_indirects {
+                    self.scan_table_uses(&body);
+                }
                 self.result
                     .function_body_inputs
                     .push(FunctionBodyData { validator, body });
@@ -840,6 +882,117 @@ and for re-adding support for interface types you can see this issue:
         }
     }
 
+    /// Assigns `call_indirect` caches to the function `body` and records the
+    /// tables that it modifies.
+    ///
+    /// The body hasn't been validated yet, so if it fails to parse then the
+    /// scan just stops, and validation reports the error later.
+    fn scan_table_uses(&mut self, body: &FunctionBody<'data>) {
+        let mut caches = self.result.module.num_call_indirect_caches;
+        self.result
+            .call_indirect_caches
+            .push(u32::try_from(caches).unwrap_or(u32::MAX));
+        let Ok(mut reader) = body.get_operators_reader() else {
+            return;
+        };
+        while !reader.eof() {
+            let Ok(op) = reader.read() else {
+                break;
+            };
+            let table = match op {
+                Operator::CallIndirect { .. } => {
+                    caches += 1;
+                    continue;
+                }
+                Operator::TableSet { table }
+                | Operator::TableFill { table }
+                | Operator::TableGrow { table }
+                | Operator::TableInit { table, .. }
+                | Operator::TableCopy {
+                    dst_table: table, ..
+                } => table,
+                _ => continue,
+            };
+            self.mutated_tables[TableIndex::from_u32(table)] = true;
+        }
+        self.result.module.num_call_indirect_caches = caches;
+    }
+
+    /// Fills in `ModuleTranslation::immutable_tables` once the whole module
+    /// has been scanned with `scan_table_uses`.
+    ///
+    /// A table can't change after instantiation if it's defined by this
+    /// module, isn't exported, and no instruction modifies it. The functions
+    /// it holds are then those of its initial value and of the active
+    /// element segments for it.
+    fn find_immutable_tables(&mut self) {
+        let module = &mut self.result.module;
+        module.num_call_indirect_caches = module
+            .num_call_indirect_caches
+            .min(MAX_CALL_INDIRECT_CACHES);
+        let module = &self.result.module;
+
+        let mut exported = SecondaryMap::<TableIndex, bool>::new();
+        for export in module.exports.values() {
+            if let EntityIndex::Table(table) = *export {
+                exported[table] = true;
+            }
+        }
+
+        for (table, ty) in module.tables.iter() {
+            let Some(defined) = module.defined_table_index(table) else {
+                continue;
+            };
+            if exported[table]
+                || self.mutated_tables[table]
+                || !matches!(
+                    ty.ref_type.heap_type,
+                    WasmHeapType::Func | WasmHeapType::ConcreteFunc(_)
+                )
+            {
+                continue;
+            }
+
+            // The types of the non-null functions that the table is
+            // initialized with, or `None` for elements of unknown type.
+            let func_type =
+                |func: FuncIndex| Some(module.functions[func].signature.unwrap_module_type_index());
+            let expr_type = |expr: &ConstExpr| match expr.ops() {
+                [ConstOp::RefNull(_)] => None,
+                [ConstOp::RefFunc(func)] => Some(func_type(*func)),
+                _ => Some(None),
+            };
+            let mut types = Vec::new();
+            if let TableInitialValue::Expr(expr) =
+                &module.table_initialization.initial_values[defined]
+            {
+                types.extend(expr_type(expr));
+            }
+            for segment in module.table_initialization.segments.iter() {
+                if segment.table_index != table {
+                    continue;
+                }
+                match &segment.elements {
+                    TableSegmentElements::Functions(funcs) => types.extend(
+                        funcs
+                            .iter()
+                            .filter(|f| !f.is_reserved_value())
+                            .map(|f| func_type(*f)),
+                    ),
+                    TableSegmentElements::Expressions(exprs) => {
+                        types.extend(exprs.iter().filter_map(expr_type))
+                    }
+                }
+            }
+            let uniform_type = match types.split_first() {
+                Some((first, rest)) if rest.iter().all(|ty| ty == first) => *first,
+                _ => None,
+            };
+
+            self.result.immutable_tables[table] = Some(ImmutableTable { uniform_type });
+        }
+    }
+
     fn flag_func_escaped(&mut self, func: FuncIndex) {
         let ty = &mut self.result.module.functions[func];
         // If this was already assigned a funcref index no need to re-assign it.
@@ -2405,7 +2405,11 @@ impl<'a, 'b> Compiler<'a, 'b> {
         dst: &WasmString<'_>,
         op: Transcode,
     ) -> FuncIndex {
-        match (src.opts.data_model, dst.opts.data_model) {
+        self.transcoder_between(src.opts, dst.opts, op)
+    }
+
+    fn transcoder_between(&mut self, src: &Options, dst: &Options, op: Transcode) -> FuncIndex {
+        match (src.data_model, dst.data_model) {
             (DataModel::Gc {}, _) | (_, DataModel::Gc {}) => {
                 todo!("CM+GC")
             }
@@ -2578,13 +2582,27 @@ impl<'a, 'b> Compiler<'a, 'b> {
             Trap::ListOutOfBounds,
         );
 
+        // Integers and floats have the same representation in both memories,
+        // so lists of them are copied in one go rather than element by
+        // element. The copy reuses the host's `latin1-to-latin1` transcoder,
+        // which is a plain copy of the given number of bytes, and both
+        // buffers were validated to be in-bounds above.
+        let copy_bytes = src_element_ty == dst_element_ty && is_plain_bytes(src_element_ty);
+        if copy_bytes {
+            let copy = self.transcoder_between(src_opts, dst_opts, Transcode::Copy(FE::Latin1));
+            self.instruction(LocalGet(src_mem.addr.idx));
+            self.instruction(LocalGet(src_byte_len.idx));
+            self.instruction(LocalGet(dst_mem.addr.idx));
+            self.instruction(Call(copy.as_u32()));
+        }
+
         self.free_temp_local(src_byte_len);
         self.free_temp_local(dst_byte_len);
 
         // This is the main body of the loop to actually translate list types.
         // Note that if both element sizes are 0 then this won't actually do
         // anything so the loop is removed entirely.
-        if src_size > 0 || dst_size > 0 {
+        if !copy_bytes && (src_size > 0 || dst_size > 0) {
             // This block encompasses the entire loop and is use to exit before even
             // entering the loop if the list size is zero.
             self.instruction(Block(BlockType::Empty));
@@ -4117,6 +4135,24 @@ where
     .0
 }
 
+/// Whether values of type `ty` are translated by copying their bytes as-is,
+/// without any validation or canonicalization.
+fn is_plain_bytes(ty: &InterfaceType) -> bool {
+    matches!(
+        ty,
+        InterfaceType::U8
+            | InterfaceType::S8
+            | InterfaceType::U16
+            | InterfaceType::S16
+            | InterfaceType::U32
+            | InterfaceType::S32
+            | InterfaceType::U64
+            | InterfaceType::S64
+            | InterfaceType::Float32
+            | InterfaceType::Float64
+    )
+}
+
 enum MallocSize {
     Const(u32),
     Local(u32),
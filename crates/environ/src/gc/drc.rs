@@ -26,6 +26,22 @@ pub const HEADER_MARK_BIT: u32 = 1 << 0;
 /// in-the-over-approximated-stack-roots list bit.
 pub const HEADER_IN_OVER_APPROX_LIST_BIT: u32 = 1 << 1;
 
+/// The alignment of every object in the DRC heap, and of every object's size
+/// once rounded up.
+pub const ALLOC_ALIGN: u32 = 16;
+
+/// The offset, within the DRC heap's data pointed to by the vmctx, of the head
+/// of the over-approximated-stack-roots list.
+pub const HEAP_DATA_OVER_APPROX_LIST_HEAD_OFFSET: u32 = 0;
+
+/// The offset, within the DRC heap's data pointed to by the vmctx, of the next
+/// index in the heap that objects can be bump-allocated at.
+pub const HEAP_DATA_BUMP_NEXT_OFFSET: u32 = 4;
+
+/// The offset, within the DRC heap's data pointed to by the vmctx, of the end
+/// of the heap's region that objects can be bump-allocated in.
+pub const HEAP_DATA_BUMP_END_OFFSET: u32 = 8;
+
 /// The layout of Wasm GC objects in the deferred reference-counting collector.
 #[derive(Default)]
 pub struct DrcTypeLayouts;
@@ -349,6 +349,16 @@ pub struct Module {
     /// an `func_ref` index (and is the maximum func_ref index).
     pub num_escaped_funcs: usize,
 
+    /// Number of function call counters in the `VMContext` of instances of
+    /// this module: either zero, or one per defined function when function
+    /// call counting is enabled.
+    pub num_call_counters: usize,
+
+    /// Number of `call_indirect` caches in the `VMContext` of instances of
+    /// this module: either zero, or one per `call_indirect` instruction, up
+    /// to a limit, when `call_indirect` caching is enabled.
+    pub num_call_indirect_caches: usize,
+
     /// Types of functions, imported and local.
     pub functions: PrimaryMap<FuncIndex, FunctionType>,
 
@@ -364,6 +374,15 @@ pub struct Module {
     /// WebAssembly global initializers for locally-defined globals.
     pub global_initializers: PrimaryMap<DefinedGlobalIndex, ConstExpr>,
 
+    /// Constant values of imported immutable globals which this module's code
+    /// was specialized for, and which these globals must have when the
+    /// module is instantiated.
+    pub specialized_globals: BTreeMap<GlobalIndex, ConstExpr>,
+
+    /// Imported functions whose calls are compiled to the given trivial
+    /// behavior instead of calling the function itself.
+    pub inlined_imports: BTreeMap<FuncIndex, HostIntrinsic>,
+
     /// WebAssembly exception and control tags.
     pub tags: PrimaryMap<TagIndex, Tag>,
 }
@@ -406,11 +425,15 @@ impl Module {
             num_imported_tags: Default::default(),
             needs_gc_heap: Default::default(),
             num_escaped_funcs: Default::default(),
+            num_call_counters: Default::default(),
+            num_call_indirect_caches: Default::default(),
             functions: Default::default(),
             tables: Default::default(),
             memories: Default::default(),
             globals: Default::default(),
             global_initializers: Default::default(),
+            specialized_globals: Default::default(),
+            inlined_imports: Default::default(),
             tags: Default::default(),
         }
     }
@@ -465,6 +488,18 @@ impl Module {
         index.index() < self.num_imported_tables
     }
 
+    /// Returns whether the funcref table `index` is initialized eagerly
+    /// during instantiation even though `tunables` enable lazy table
+    /// initialization, see `Tunables::table_eager_init_threshold`.
+    ///
+    /// Imported tables never are, since this module can't know how they were
+    /// initialized.
+    pub fn table_initialized_eagerly(&self, tunables: &Tunables, index: TableIndex) -> bool {
+        tunables.table_lazy_init
+            && !self.is_imported_table(index)
+            && self.tables[index].limits.min < tunables.table_eager_init_threshold
+    }
+
     /// Convert a `DefinedMemoryIndex` into a `MemoryIndex`.
     #[inline]
     pub fn memory_index(&self, defined_memory: DefinedMemoryIndex) -> MemoryIndex {
@@ -686,12 +721,16 @@ impl TypeTrace for Module {
             num_imported_globals: _,
             num_imported_tags: _,
             num_escaped_funcs: _,
+            num_call_counters: _,
+            num_call_indirect_caches: _,
             needs_gc_heap: _,
             functions,
             tables,
             memories: _,
             globals,
             global_initializers: _,
+            specialized_globals: _,
+            inlined_imports: _,
             tags,
         } = self;
 
@@ -737,12 +776,16 @@ impl TypeTrace for Module {
             num_imported_globals: _,
             num_imported_tags: _,
             num_escaped_funcs: _,
+            num_call_counters: _,
+            num_call_indirect_caches: _,
             needs_gc_heap: _,
             functions,
             tables,
             memories: _,
             globals,
             global_initializers: _,
+            specialized_globals: _,
+            inlined_imports: _,
             tags,
         } = self;
 
@@ -765,6 +808,43 @@ impl TypeTrace for Module {
     }
 }
 
+/// The behavior of a trivial host function, which calls to an imported
+/// function can be compiled to instead of calling it.
+///
+/// Each of these take no parameters and return a single value. The store's
+/// data is the `T` of the `Store<T>` in Wasmtime.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash, Serialize, Deserialize)]
+pub enum HostIntrinsic {
+    /// Returns this `i32`.
+    I32Const(i32),
+    /// Returns this `i64`.
+    I64Const(i64),
+    /// Returns the `f32` with these bits.
+    F32Const(u32),
+    /// Returns the `f64` with these bits.
+    F64Const(u64),
+    /// Returns the `i32` at this byte offset into the store's data.
+    I32StoreData(u32),
+    /// Returns the `i64` at this byte offset into the store's data.
+    I64StoreData(u32),
+    /// Returns the `f32` at this byte offset into the store's data.
+    F32StoreData(u32),
+    /// Returns the `f64` at this byte offset into the store's data.
+    F64StoreData(u32),
+}
+
+impl HostIntrinsic {
+    /// The type of the value this intrinsic returns.
+    pub fn result_type(&self) -> WasmValType {
+        match self {
+            HostIntrinsic::I32Const(_) | HostIntrinsic::I32StoreData(_) => WasmValType::I32,
+            HostIntrinsic::I64Const(_) | HostIntrinsic::I64StoreData(_) => WasmValType::I64,
+            HostIntrinsic::F32Const(_) | HostIntrinsic::F32StoreData(_) => WasmValType::F32,
+            HostIntrinsic::F64Const(_) | HostIntrinsic::F64StoreData(_) => WasmValType::F64,
+        }
+    }
+}
+
 /// Type information about functions in a wasm module.
 #[derive(Debug, Serialize, Deserialize)]
 pub struct FunctionType {
@@ -63,6 +63,11 @@ define_tunables! {
         /// GC objects and barriers that must be emitted in Wasm code.
         pub collector: Option<Collector>,
 
+        /// Whether Wasm code allocates GC objects inline, by bumping an index
+        /// through a region of the GC heap reserved by the collector, rather
+        /// than always calling into the runtime.
+        pub gc_inline_alloc: bool,
+
         /// Initial size, in bytes, to be allocated for linear memories.
         pub memory_reservation: u64,
 
@@ -73,9 +78,29 @@ define_tunables! {
         /// memory for growth.
         pub memory_reservation_for_growth: u64,
 
+        /// Whether a relocated linear memory reserves at least as many bytes
+        /// for growth as its new size, in addition to
+        /// `memory_reservation_for_growth`.
+        pub memory_reservation_for_growth_geometric: bool,
+
+        /// Whether pages of linear memories are populated, rather than
+        /// faulted in on first access, as memories are created and grown.
+        pub memory_populate: bool,
+
+        /// Whether linear memories ask to be backed by transparent huge
+        /// pages.
+        pub memory_huge_pages: bool,
+
+        /// Whether compiled code asks to be backed by transparent huge pages.
+        pub code_huge_pages: bool,
+
         /// Whether or not to generate native DWARF debug information.
         pub debug_native: bool,
 
+        /// Whether native debug information is only registered with a
+        /// debugger once one is attached to the process.
+        pub debug_native_lazy: bool,
+
         /// Whether we are enabling precise Wasm-level debugging in
         /// the guest.
         pub debug_guest: bool,
@@ -87,6 +112,21 @@ define_tunables! {
         /// will be consumed every time a wasm instruction is executed.
         pub consume_fuel: bool,
 
+        /// Whether fuel is charged once per loop iteration, and once per
+        /// function call, for the static cost of the whole body rather than
+        /// per basic block executed.
+        pub fuel_per_loop: bool,
+
+        /// Whether generated code counts the calls to each defined function
+        /// in a per-instance array of counters in the `VMContext`.
+        pub count_function_calls: bool,
+
+        /// Whether `call_indirect` sites through tables which are never
+        /// modified after instantiation cache the last function they called
+        /// in the `VMContext`, and skip signature checks which those tables'
+        /// contents make redundant.
+        pub cache_call_indirects: bool,
+
         /// Whether or not we use epoch-based interruption.
         pub epoch_interruption: bool,
 
@@ -98,12 +138,27 @@ define_tunables! {
         /// beginning of the allocation in addition to the end.
         pub guard_before_linear_memory: bool,
 
+        /// Whether the indices of 64-bit linear memories which can't move are
+        /// masked to fit within `memory_reservation`, instead of being bounds
+        /// checked, when the reservation is a power of two.
+        pub memory64_index_masking: bool,
+
+        /// If nonzero then one in this many accesses to linear memories is
+        /// recorded in the memory's access histogram.
+        pub memory_access_sample_interval: u32,
+
         /// Whether to initialize tables lazily, so that instantiation is fast but
         /// indirect calls are a little slower. If false, tables are initialized
         /// eagerly from any active element segments that apply to them during
         /// instantiation.
         pub table_lazy_init: bool,
 
+        /// With lazy table initialization, funcref tables defined by a module
+        /// with fewer initial elements than this are still initialized eagerly
+        /// during instantiation, so that compiled code doesn't check whether
+        /// their elements are initialized.
+        pub table_eager_init_threshold: u64,
+
         /// Indicates whether an address map from compiled native code back to wasm
         /// offsets in the original file is generated.
         pub generate_address_map: bool,
@@ -192,22 +247,34 @@ impl Tunables {
     pub const fn default_miri() -> Tunables {
         Tunables {
             collector: None,
+            gc_inline_alloc: false,
 
             // No virtual memory tricks are available on miri so make these
             // limits quite conservative.
             memory_reservation: 1 << 20,
             memory_guard_size: 0,
             memory_reservation_for_growth: 0,
+            memory_reservation_for_growth_geometric: false,
+            memory_populate: false,
+            memory_huge_pages: false,
+            code_huge_pages: false,
 
             // General options which have the same defaults regardless of
             // architecture.
             debug_native: false,
+            debug_native_lazy: false,
             parse_wasm_debuginfo: true,
             consume_fuel: false,
+            fuel_per_loop: false,
+            count_function_calls: false,
+            cache_call_indirects: false,
             epoch_interruption: false,
             memory_may_move: true,
             guard_before_linear_memory: true,
+            memory64_index_masking: false,
+            memory_access_sample_interval: 0,
             table_lazy_init: true,
+            table_eager_init_threshold: 0,
             generate_address_map: true,
             debug_adapter_modules: false,
             relaxed_simd_deterministic: false,
@@ -232,6 +299,7 @@ impl Tunables {
             memory_reservation: 10 * (1 << 20),
             memory_guard_size: 0x1_0000,
             memory_reservation_for_growth: 1 << 20, // 1MB
+            memory_reservation_for_growth_geometric: false,
             signals_based_traps: true,
 
             ..Tunables::default_miri()
@@ -258,6 +326,7 @@ impl Tunables {
             // not exactly fast so reduce memory consumption instead of trying
             // to avoid memory movement.
             memory_reservation_for_growth: 2 << 30, // 2GB
+            memory_reservation_for_growth_geometric: false,
 
             signals_based_traps: true,
             ..Tunables::default_miri()
@@ -31,11 +31,14 @@
 //      globals: [VMGlobalDefinition; module.num_defined_globals],
 //      tags: [VMTagDefinition; module.num_defined_tags],
 //      func_refs: [VMFuncRef; module.num_escaped_funcs],
+//      call_counters: [u64; module.num_call_counters],
+//      call_indirect_caches: [VMCallIndirectCache; module.num_call_indirect_caches],
 // }
 
 use crate::{
-    DefinedGlobalIndex, DefinedMemoryIndex, DefinedTableIndex, DefinedTagIndex, FuncIndex,
-    FuncRefIndex, GlobalIndex, MemoryIndex, Module, OwnedMemoryIndex, TableIndex, TagIndex,
+    DefinedFuncIndex, DefinedGlobalIndex, DefinedMemoryIndex, DefinedTableIndex, DefinedTagIndex,
+    FuncIndex, FuncRefIndex, GlobalIndex, MemoryIndex, Module, OwnedMemoryIndex, TableIndex,
+    TagIndex,
 };
 use cranelift_entity::packed_option::ReservedValue;
 
@@ -83,6 +86,12 @@ pub struct VMOffsets<P> {
     /// The number of escaped functions in the module, the size of the func_refs
     /// array.
     pub num_escaped_funcs: u32,
+    /// The number of function call counters, the size of the call_counters
+    /// array.
+    pub num_call_counters: u32,
+    /// The number of `call_indirect` caches, the size of the
+    /// call_indirect_caches array.
+    pub num_call_indirect_caches: u32,
 
     // precalculated offsets of various member fields
     imported_functions: u32,
@@ -96,6 +105,8 @@ pub struct VMOffsets<P> {
     defined_globals: u32,
     defined_tags: u32,
     defined_func_refs: u32,
+    call_counters: u32,
+    call_indirect_caches: u32,
     size: u32,
 }
 
@@ -243,6 +254,12 @@ pub trait PtrSize {
         self.vmstore_context_stack_chain() + self.size_of_vmstack_chain()
     }
 
+    /// Return the offset of the `memory_access_countdown` field of
+    /// `VMStoreContext`.
+    fn vmstore_context_memory_access_countdown(&self) -> u8 {
+        self.vmstore_context_store_data() + self.size()
+    }
+
     // Offsets within `VMMemoryDefinition`
 
     /// The offset of the `base` field.
@@ -516,6 +533,12 @@ pub struct VMOffsetsFields<P> {
     /// The number of escaped functions in the module, the size of the function
     /// references array.
     pub num_escaped_funcs: u32,
+    /// The number of function call counters, the size of the call counters
+    /// array.
+    pub num_call_counters: u32,
+    /// The number of `call_indirect` caches, the size of the call_indirect
+    /// caches array.
+    pub num_call_indirect_caches: u32,
 }
 
 impl<P: PtrSize> VMOffsets<P> {
@@ -542,6 +565,8 @@ impl<P: PtrSize> VMOffsets<P> {
             num_defined_globals: cast_to_u32(module.globals.len() - module.num_imported_globals),
             num_defined_tags: cast_to_u32(module.tags.len() - module.num_imported_tags),
             num_escaped_funcs: cast_to_u32(module.num_escaped_funcs),
+            num_call_counters: cast_to_u32(module.num_call_counters),
+            num_call_indirect_caches: cast_to_u32(module.num_call_indirect_caches),
         })
     }
 
@@ -573,6 +598,8 @@ impl<P: PtrSize> VMOffsets<P> {
                     num_defined_tags: _,
                     num_owned_memories: _,
                     num_escaped_funcs: _,
+                    num_call_counters: _,
+                    num_call_indirect_caches: _,
 
                     // used as the initial size below
                     size,
@@ -601,6 +628,8 @@ impl<P: PtrSize> VMOffsets<P> {
         }
 
         calculate_sizes! {
+            call_indirect_caches: "call_indirect caches",
+            call_counters: "function call counters",
             defined_func_refs: "module functions",
             defined_tags: "defined tags",
             defined_globals: "defined globals",
@@ -631,6 +660,8 @@ impl<P: PtrSize> From<VMOffsetsFields<P>> for VMOffsets<P> {
             num_defined_globals: fields.num_defined_globals,
             num_defined_tags: fields.num_defined_tags,
             num_escaped_funcs: fields.num_escaped_funcs,
+            num_call_counters: fields.num_call_counters,
+            num_call_indirect_caches: fields.num_call_indirect_caches,
             imported_functions: 0,
             imported_tables: 0,
             imported_memories: 0,
@@ -642,6 +673,8 @@ impl<P: PtrSize> From<VMOffsetsFields<P>> for VMOffsets<P> {
             defined_globals: 0,
             defined_tags: 0,
             defined_func_refs: 0,
+            call_counters: 0,
+            call_indirect_caches: 0,
             size: 0,
         };
 
@@ -700,6 +733,12 @@ impl<P: PtrSize> From<VMOffsetsFields<P>> for VMOffsets<P> {
                 ret.num_escaped_funcs,
                 ret.ptr.size_of_vm_func_ref(),
             ),
+            align(8),
+            size(call_counters) = cmul(ret.num_call_counters, 8),
+            size(call_indirect_caches) = cmul(
+                ret.num_call_indirect_caches,
+                ret.size_of_call_indirect_cache(),
+            ),
         }
 
         ret.size = next_field_offset;
@@ -769,6 +808,37 @@ impl<P: PtrSize> VMOffsets<P> {
     }
 }
 
+/// Offsets for the `call_indirect` caches in the `VMContext`.
+///
+/// Each cache holds the table index that its call site last called as a
+/// `u64`, which is `u64::MAX` before the first call, followed by the
+/// `wasm_call` and `vmctx` of the function it found there.
+impl<P: PtrSize> VMOffsets<P> {
+    /// The offset of the `index` field.
+    #[inline]
+    pub fn call_indirect_cache_index(&self) -> u8 {
+        0
+    }
+
+    /// The offset of the `wasm_call` field.
+    #[inline]
+    pub fn call_indirect_cache_wasm_call(&self) -> u8 {
+        8
+    }
+
+    /// The offset of the `vmctx` field.
+    #[inline]
+    pub fn call_indirect_cache_vmctx(&self) -> u8 {
+        8 + self.pointer_size()
+    }
+
+    /// Return the size of a `call_indirect` cache.
+    #[inline]
+    pub fn size_of_call_indirect_cache(&self) -> u8 {
+        8 + 2 * self.pointer_size()
+    }
+}
+
 /// Offsets for `VMTableDefinition`.
 impl<P: PtrSize> VMOffsets<P> {
     /// The offset of the `base` field.
@@ -942,6 +1012,18 @@ impl<P: PtrSize> VMOffsets<P> {
         self.defined_func_refs
     }
 
+    /// The offset of the `call_counters` array.
+    #[inline]
+    pub fn vmctx_call_counters_begin(&self) -> u32 {
+        self.call_counters
+    }
+
+    /// The offset of the `call_indirect_caches` array.
+    #[inline]
+    pub fn vmctx_call_indirect_caches_begin(&self) -> u32 {
+        self.call_indirect_caches
+    }
+
     /// Return the size of the `VMContext` allocation.
     #[inline]
     pub fn size_of_vmctx(&self) -> u32 {
@@ -1034,6 +1116,21 @@ impl<P: PtrSize> VMOffsets<P> {
         self.vmctx_func_refs_begin() + index.as_u32() * u32::from(self.ptr.size_of_vm_func_ref())
     }
 
+    /// Return the offset to the call counter of the defined function `index`.
+    #[inline]
+    pub fn vmctx_call_counter(&self, index: DefinedFuncIndex) -> u32 {
+        assert!(index.as_u32() < self.num_call_counters);
+        self.vmctx_call_counters_begin() + index.as_u32() * 8
+    }
+
+    /// Return the offset to the `call_indirect` cache `index`.
+    #[inline]
+    pub fn vmctx_call_indirect_cache(&self, index: u32) -> u32 {
+        assert!(index < self.num_call_indirect_caches);
+        self.vmctx_call_indirect_caches_begin()
+            + index * u32::from(self.size_of_call_indirect_cache())
+    }
+
     /// Return the offset to the `wasm_call` field in `*const VMFunctionBody` index `index`.
     #[inline]
     pub fn vmctx_vmfunction_import_wasm_call(&self, index: FuncIndex) -> u32 {
@@ -1152,6 +1249,12 @@ impl<P: PtrSize> VMOffsets<P> {
     pub fn vm_drc_header_next_over_approximated_stack_root(&self) -> u32 {
         self.vm_drc_header_ref_count() + 8
     }
+
+    /// Return the offset for `VMDrcHeader::object_size`.
+    #[inline]
+    pub fn vm_drc_header_object_size(&self) -> u32 {
+        self.vm_drc_header_next_over_approximated_stack_root() + 4
+    }
 }
 
 /// Magic value for core Wasm VM contexts.
@@ -0,0 +1,37 @@
+//! Benchmarks of switching to and from a fiber, and of creating one, which
+//! are what `call_async` and friends pay for on top of the wasm being run.
+
+use criterion::*;
+use wasmtime_internal_fiber::{Fiber, FiberStack};
+
+criterion_main!(benches);
+criterion_group!(benches, bench_switch, bench_new);
+
+const STACK_SIZE: usize = 1 << 20;
+
+/// A round trip of resuming a fiber which immediately suspends back.
+fn bench_switch(c: &mut Criterion) {
+    let stack = FiberStack::new(STACK_SIZE, false).unwrap();
+    let fiber = Fiber::<bool, (), ()>::new(stack, |mut keep_going, s| {
+        while keep_going {
+            keep_going = s.suspend(());
+        }
+    })
+    .unwrap();
+    c.bench_function("fiber-switch", |b| {
+        b.iter(|| assert!(fiber.resume(true).is_err()))
+    });
+    assert!(fiber.resume(false).is_ok());
+}
+
+/// Creating a fiber on an existing stack and running it to completion.
+fn bench_new(c: &mut Criterion) {
+    let mut stack = Some(FiberStack::new(STACK_SIZE, false).unwrap());
+    c.bench_function("fiber-new", |b| {
+        b.iter(|| {
+            let fiber = Fiber::<(), (), ()>::new(stack.take().unwrap(), |(), _s| {}).unwrap();
+            assert!(fiber.resume(()).is_ok());
+            stack = Some(fiber.into_stack());
+        })
+    });
+}
@@ -18,7 +18,12 @@ fn main() {
         _ => {}
     }
 
-    if os == "windows" {
+    // Windows uses Win32 fibers, and needs this C shim, unless the
+    // `windows-stackswitch` feature selects the routines in `src/stackswitch`
+    // on an architecture which has them.
+    let stackswitch = env::var_os("CARGO_FEATURE_WINDOWS_STACKSWITCH").is_some()
+        && (arch == "x86_64" || arch == "aarch64");
+    if os == "windows" && !stackswitch {
         println!("cargo:rerun-if-changed=src/windows.c");
         build.file("src/windows.c");
         build.define("VERSIONED_SUFFIX", Some(versioned_suffix!()));
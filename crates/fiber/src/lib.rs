@@ -26,6 +26,14 @@ cfg_if::cfg_if! {
     } else if #[cfg(miri)] {
         mod miri;
         use miri as imp;
+    } else if #[cfg(all(
+        windows,
+        feature = "windows-stackswitch",
+        any(target_arch = "x86_64", target_arch = "aarch64"),
+    ))] {
+        mod windows_stackswitch;
+        use windows_stackswitch as imp;
+        mod stackswitch;
     } else if #[cfg(windows)] {
         mod windows;
         use windows as imp;
@@ -5,7 +5,15 @@
 // accessed via the `extern "C"` declarations below that.
 
 cfg_if::cfg_if! {
-    if #[cfg(target_arch = "aarch64")] {
+    if #[cfg(all(windows, feature = "windows-stackswitch", target_arch = "aarch64"))] {
+        mod aarch64_windows;
+        pub(crate) use supported::*;
+        pub(crate) use aarch64_windows::*;
+    } else if #[cfg(all(windows, feature = "windows-stackswitch", target_arch = "x86_64"))] {
+        mod x86_64_windows;
+        pub(crate) use supported::*;
+        pub(crate) use x86_64_windows::*;
+    } else if #[cfg(target_arch = "aarch64")] {
         mod aarch64;
         pub(crate) use supported::*;
         pub(crate) use aarch64::*;
@@ -0,0 +1,175 @@
+// A WORD OF CAUTION
+//
+// This entire file basically needs to be kept in sync with itself. It's not
+// really possible to modify just one bit of this file without understanding
+// all the other bits. Documentation tries to reference various bits here and
+// there but try to make sure to read over everything before tweaking things!
+//
+// This is the Windows flavor of the aarch64 file, and is also heavily based
+// off the x86_64 Windows file, so you'll probably want to read both of those.
+// Like on x86_64 the description of the current stack in the Thread
+// Information Block (TIB) is switched along with the stack itself. The TIB is
+// addressed through `x18`, which is reserved for that purpose on Windows, at
+// the same offsets as on x86_64.
+//
+// Pointer authentication isn't used here since Windows doesn't enable it for
+// user code.
+
+use core::arch::naked_asm;
+
+#[inline(never)] // FIXME(rust-lang/rust#148307)
+pub(crate) unsafe extern "C" fn wasmtime_fiber_switch(top_of_stack: *mut u8) {
+    unsafe { wasmtime_fiber_switch_(top_of_stack) }
+}
+
+#[unsafe(naked)]
+unsafe extern "C" fn wasmtime_fiber_switch_(top_of_stack: *mut u8 /* x0 */) {
+    naked_asm!(
+        "
+        // Save all callee-saved registers on the stack since we're assuming
+        // they're clobbered as a result of the stack switch.
+        stp x29, x30, [sp, -16]!
+        stp x27, x28, [sp, -16]!
+        stp x25, x26, [sp, -16]!
+        stp x23, x24, [sp, -16]!
+        stp x21, x22, [sp, -16]!
+        stp x19, x20, [sp, -16]!
+        stp d14, d15, [sp, -16]!
+        stp d12, d13, [sp, -16]!
+        stp d10, d11, [sp, -16]!
+        stp d8, d9, [sp, -16]!
+
+        // Save the TIB's description of the current stack.
+        ldr x9, [x18, 0x1478]
+        ldr x10, [x18, 0x10]
+        stp x10, x9, [sp, -16]!
+        ldr x9, [x18, 0x08]
+        ldr w10, [x18, 0x1748]
+        stp x10, x9, [sp, -16]!
+
+        // Load our previously saved stack pointer to resume to, and save
+        // off our current stack pointer on where to come back to
+        // eventually.
+        ldr x8, [x0, -0x10]
+        mov x9, sp
+        str x9, [x0, -0x10]
+
+        // Switch to the new stack and restore everything saved above, in
+        // reverse.
+        mov sp, x8
+        ldp x10, x9, [sp], 16
+        str w10, [x18, 0x1748]
+        str x9, [x18, 0x08]
+        ldp x10, x9, [sp], 16
+        str x10, [x18, 0x10]
+        str x9, [x18, 0x1478]
+
+        ldp d8, d9, [sp], 16
+        ldp d10, d11, [sp], 16
+        ldp d12, d13, [sp], 16
+        ldp d14, d15, [sp], 16
+
+        ldp x19, x20, [sp], 16
+        ldp x21, x22, [sp], 16
+        ldp x23, x24, [sp], 16
+        ldp x25, x26, [sp], 16
+        ldp x27, x28, [sp], 16
+        ldp x29, x30, [sp], 16
+        ret
+        ",
+    );
+}
+
+/// Initializes the stack ending at `top_of_stack` to start executing
+/// `entry_point` when it's first switched to.
+///
+/// `stack_limit` is the lowest usable address of the stack and
+/// `deallocation_stack` is the start of its allocation, including guard
+/// pages, which are recorded in the TIB while the fiber runs.
+pub(crate) unsafe fn wasmtime_fiber_init(
+    top_of_stack: *mut u8,
+    stack_limit: *mut u8,
+    deallocation_stack: *mut u8,
+    entry_point: extern "C" fn(*mut u8, *mut u8),
+    entry_arg0: *mut u8,
+) {
+    #[repr(C)]
+    #[derive(Default)]
+    struct InitialStack {
+        guaranteed_stack_bytes: u64,
+        stack_base: *mut u8,
+        stack_limit: *mut u8,
+        deallocation_stack: *mut u8,
+
+        d8: u64,
+        d9: u64,
+        d10: u64,
+        d11: u64,
+        d12: u64,
+        d13: u64,
+        d14: u64,
+        d15: u64,
+
+        x19: *mut u8,
+        x20: *mut u8,
+        x21: *mut u8,
+        x22: *mut u8,
+        x23: *mut u8,
+        x24: *mut u8,
+        x25: *mut u8,
+        x26: *mut u8,
+        x27: *mut u8,
+        x28: *mut u8,
+
+        // A null frame pointer ends frame pointer chains at the fiber's first
+        // frame.
+        fp: *mut u8,
+        lr: *mut u8,
+
+        // windows_stackswitch.rs reserved space
+        last_sp: *mut u8,
+        run_result: *mut u8,
+    }
+
+    unsafe {
+        let initial_stack = top_of_stack.cast::<InitialStack>().sub(1);
+        initial_stack.write(InitialStack {
+            stack_base: top_of_stack,
+            stack_limit,
+            deallocation_stack,
+            x19: top_of_stack,
+            x20: entry_point as *mut u8,
+            x21: entry_arg0,
+            lr: wasmtime_fiber_start as *mut u8,
+            last_sp: initial_stack.cast(),
+            ..InitialStack::default()
+        });
+    }
+}
+
+// See the x86_64 Windows file for why unwinding ends here. The unwinding
+// information of this function says that it saves the frame pointer and link
+// register, but it saves zeros instead so that unwinders find a null return
+// address.
+#[unsafe(naked)]
+unsafe extern "C" fn wasmtime_fiber_start() -> ! {
+    naked_asm!(
+        "
+        .seh_proc {start}
+        stp xzr, xzr, [sp, -16]!
+        .seh_save_fplr_x 16
+        .seh_endprologue
+
+        // Move the values that `wasmtime_fiber_init` arranged to be restored
+        // into registers into the argument registers and call the entry
+        // point. Use a noticeable payload on the trailing `brk` so one can grep
+        // for it in the codebase.
+        mov x0, x21
+        mov x1, x19
+        blr x20
+        brk 0xf1b3
+        .seh_endproc
+        ",
+        start = sym wasmtime_fiber_start,
+    );
+}
@@ -0,0 +1,198 @@
+// A WORD OF CAUTION
+//
+// This entire file basically needs to be kept in sync with itself. It's not
+// really possible to modify just one bit of this file without understanding
+// all the other bits. Documentation tries to reference various bits here and
+// there but try to make sure to read over everything before tweaking things!
+//
+// This is the Windows flavor of the x86_64 file, so you'll probably want to
+// read that one as well. The differences are that the Windows x64 calling
+// convention additionally has `rdi`, `rsi` and `xmm6`-`xmm15` as callee-saved
+// registers, and that the description of the current stack in the Thread
+// Information Block (TIB), which Windows consults when dispatching exceptions
+// and probing the stack, is switched along with the stack itself. The TIB is
+// addressed through the `gs` segment, and the fields which describe the stack
+// are:
+//
+// * `gs:[0x08]` - `StackBase`, the top of the stack.
+// * `gs:[0x10]` - `StackLimit`, the bottom of the committed stack.
+// * `gs:[0x1478]` - `DeallocationStack`, the bottom of the stack's
+//   allocation, including its guard pages.
+// * `gs:[0x1748]` - `GuaranteedStackBytes`, a 32-bit value configured with
+//   `SetThreadStackGuarantee`.
+//
+// These are the same fields that `SwitchToFiber` swaps.
+
+use core::arch::naked_asm;
+
+#[inline(never)] // FIXME(rust-lang/rust#148307)
+pub(crate) unsafe extern "C" fn wasmtime_fiber_switch(top_of_stack: *mut u8) {
+    unsafe { wasmtime_fiber_switch_(top_of_stack) }
+}
+
+#[unsafe(naked)]
+unsafe extern "C" fn wasmtime_fiber_switch_(top_of_stack: *mut u8 /* rcx */) {
+    naked_asm!(
+        "
+        // Save all callee-saved general purpose registers, the order of which
+        // matches `InitialStack` below.
+        push rbp
+        push rbx
+        push rdi
+        push rsi
+        push r12
+        push r13
+        push r14
+        push r15
+
+        // Save the TIB's description of the current stack.
+        push qword ptr gs:[0x1478]
+        push qword ptr gs:[0x10]
+        push qword ptr gs:[0x08]
+        mov eax, dword ptr gs:[0x1748]
+        push rax
+
+        // Save the callee-saved vector registers. The stack is 8 bytes off of
+        // 16-byte alignment at this point so 8 bytes of padding are included
+        // to be able to use aligned stores.
+        sub rsp, 0xa8
+        movaps [rsp + 0x00], xmm6
+        movaps [rsp + 0x10], xmm7
+        movaps [rsp + 0x20], xmm8
+        movaps [rsp + 0x30], xmm9
+        movaps [rsp + 0x40], xmm10
+        movaps [rsp + 0x50], xmm11
+        movaps [rsp + 0x60], xmm12
+        movaps [rsp + 0x70], xmm13
+        movaps [rsp + 0x80], xmm14
+        movaps [rsp + 0x90], xmm15
+
+        // Load pointer that we're going to resume at and store where we're going
+        // to get resumed from. This is in accordance with the diagram at the top
+        // of windows_stackswitch.rs.
+        mov rax, -0x10[rcx]
+        mov -0x10[rcx], rsp
+
+        // Swap stacks and restore everything saved above, in reverse.
+        mov rsp, rax
+        movaps xmm6, [rsp + 0x00]
+        movaps xmm7, [rsp + 0x10]
+        movaps xmm8, [rsp + 0x20]
+        movaps xmm9, [rsp + 0x30]
+        movaps xmm10, [rsp + 0x40]
+        movaps xmm11, [rsp + 0x50]
+        movaps xmm12, [rsp + 0x60]
+        movaps xmm13, [rsp + 0x70]
+        movaps xmm14, [rsp + 0x80]
+        movaps xmm15, [rsp + 0x90]
+        add rsp, 0xa8
+
+        pop rax
+        mov dword ptr gs:[0x1748], eax
+        pop qword ptr gs:[0x08]
+        pop qword ptr gs:[0x10]
+        pop qword ptr gs:[0x1478]
+
+        pop r15
+        pop r14
+        pop r13
+        pop r12
+        pop rsi
+        pop rdi
+        pop rbx
+        pop rbp
+        ret
+        ",
+    );
+}
+
+/// Initializes the stack ending at `top_of_stack` to start executing
+/// `entry_point` when it's first switched to.
+///
+/// `stack_limit` is the lowest usable address of the stack and
+/// `deallocation_stack` is the start of its allocation, including guard
+/// pages, which are recorded in the TIB while the fiber runs.
+pub(crate) unsafe fn wasmtime_fiber_init(
+    top_of_stack: *mut u8,
+    stack_limit: *mut u8,
+    deallocation_stack: *mut u8,
+    entry_point: extern "C" fn(*mut u8, *mut u8),
+    entry_arg0: *mut u8,
+) {
+    #[repr(C)]
+    #[derive(Default)]
+    struct InitialStack {
+        xmm6_to_xmm15: [u64; 20],
+        padding: u64,
+
+        guaranteed_stack_bytes: u64,
+        stack_base: *mut u8,
+        stack_limit: *mut u8,
+        deallocation_stack: *mut u8,
+
+        r15: *mut u8,
+        r14: *mut u8,
+        r13: *mut u8,
+        r12: *mut u8,
+        rsi: *mut u8,
+        rdi: *mut u8,
+        rbx: *mut u8,
+        rbp: *mut u8,
+        return_address: *mut u8,
+
+        // The return address of `wasmtime_fiber_start` as far as unwinders
+        // are concerned, which is null to end unwinding there, plus padding
+        // to keep the stack aligned.
+        start_return_address: *mut u8,
+        start_padding: u64,
+
+        // windows_stackswitch.rs reserved space
+        last_sp: *mut u8,
+        run_result: *mut u8,
+    }
+
+    unsafe {
+        let initial_stack = top_of_stack.cast::<InitialStack>().sub(1);
+        initial_stack.write(InitialStack {
+            stack_base: top_of_stack,
+            stack_limit,
+            deallocation_stack,
+            r12: entry_arg0,
+            rbx: entry_point as *mut u8,
+            rbp: top_of_stack,
+            return_address: wasmtime_fiber_start as *mut u8,
+            last_sp: initial_stack.cast(),
+            ..InitialStack::default()
+        });
+    }
+}
+
+// The "base" function of all fibers, see the x86_64 file.
+//
+// Windows doesn't use DWARF unwinding information, and its unwinding
+// information can't describe how to unwind onto the stack that resumed the
+// fiber, so instead unwinding ends here. This function's unwinding information
+// says that it allocates 32 bytes of stack, which are the shadow space for
+// calling the entry point, and its return address above that is null.
+#[unsafe(naked)]
+unsafe extern "C" fn wasmtime_fiber_start() -> ! {
+    naked_asm!(
+        "
+        .seh_proc {start}
+        sub rsp, 0x20
+        .seh_stackalloc 0x20
+        .seh_endprologue
+
+        // Move the values that `wasmtime_fiber_init` arranged to be restored
+        // into registers into the argument registers of the Windows calling
+        // convention and call the entry point. The trailing `ud2` is just for
+        // safety.
+        mov rcx, r12
+        mov rdx, rbp
+        call rbx
+        ud2
+        .seh_endproc
+        ",
+        start = sym wasmtime_fiber_start,
+    );
+}
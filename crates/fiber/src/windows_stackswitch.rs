@@ -0,0 +1,303 @@
+//! Fibers on 64-bit Windows which switch stacks with the routines in
+//! `stackswitch`, rather than with the Win32 fiber API. This is only used with
+//! the `windows-stackswitch` feature, and `windows.rs` otherwise.
+//!
+//! Switching with `SwitchToFiber` requires converting the current thread to a
+//! fiber, and back, on every `resume`, whereas this only swaps registers and
+//! the stack. This otherwise mirrors `unix.rs`, and the stack is laid out the
+//! same way:
+//!
+//! ```text
+//! 0xB000 +-----------------------+   <- top of stack
+//!        | &Cell<RunResult>      |   <- where to store results
+//! 0xAff8 +-----------------------+
+//!        | *const u8             |   <- last sp to resume from
+//! 0xAff0 +-----------------------+   <- 16-byte aligned
+//!        |                       |
+//!        ~        ...            ~   <- actual native stack space to use
+//!        |                       |
+//! 0x1000 +-----------------------+
+//!        |  guard page           |
+//! 0x0000 +-----------------------+
+//! ```
+//!
+//! The one Windows-specific detail is that the Thread Information Block
+//! describes the bounds of the current stack, which Windows consults when
+//! probing the stack and dispatching exceptions, so the stack-switching
+//! routines swap that description along with the stack. The whole stack is
+//! committed up front, so the TIB's stack limit is the bottom of the usable
+//! stack, and the guard page below it is `PAGE_NOACCESS`.
+
+use crate::stackswitch::*;
+use crate::{RunResult, RuntimeFiberStack};
+use std::boxed::Box;
+use std::cell::Cell;
+use std::io;
+use std::mem::MaybeUninit;
+use std::ops::Range;
+use std::ptr;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use windows_sys::Win32::System::Memory::*;
+use windows_sys::Win32::System::SystemInformation::*;
+
+pub type Error = io::Error;
+
+pub struct FiberStack {
+    base: BasePtr,
+    len: usize,
+
+    /// Stored here to ensure that when this `FiberStack` the backing storage,
+    /// if any, is additionally dropped.
+    storage: FiberStackStorage,
+}
+
+struct BasePtr(*mut u8);
+
+unsafe impl Send for BasePtr {}
+unsafe impl Sync for BasePtr {}
+
+enum FiberStackStorage {
+    VirtualAlloc(VirtualAllocFiberStack),
+    Unmanaged(usize),
+    Custom(Box<dyn RuntimeFiberStack>),
+}
+
+// FIXME: this is a duplicate copy of what's already in the `wasmtime` crate. If
+// this changes that should change over there, and ideally one day we should
+// probably deduplicate the two.
+fn host_page_size() -> usize {
+    static PAGE_SIZE: AtomicUsize = AtomicUsize::new(0);
+
+    return match PAGE_SIZE.load(Ordering::Relaxed) {
+        0 => {
+            let size = unsafe {
+                let mut info = MaybeUninit::uninit();
+                GetSystemInfo(info.as_mut_ptr());
+                info.assume_init_ref().dwPageSize as usize
+            };
+            assert!(size != 0);
+            PAGE_SIZE.store(size, Ordering::Relaxed);
+            size
+        }
+        n => n,
+    };
+}
+
+impl FiberStack {
+    pub fn new(size: usize, zeroed: bool) -> io::Result<Self> {
+        let page_size = host_page_size();
+        // Memory from `VirtualAlloc` is always zeroed.
+        let _ = zeroed;
+
+        let stack = VirtualAllocFiberStack::new(size)?;
+
+        // A `VirtualAllocFiberStack` has a guard page at the bottom of the
+        // region so the base and length of our stack are both offset by a
+        // single page.
+        Ok(FiberStack {
+            base: BasePtr(stack.base.wrapping_byte_add(page_size)),
+            len: stack.len - page_size,
+            storage: FiberStackStorage::VirtualAlloc(stack),
+        })
+    }
+
+    pub unsafe fn from_raw_parts(base: *mut u8, guard_size: usize, len: usize) -> io::Result<Self> {
+        Ok(FiberStack {
+            base: BasePtr(unsafe { base.add(guard_size) }),
+            len,
+            storage: FiberStackStorage::Unmanaged(guard_size),
+        })
+    }
+
+    pub fn is_from_raw_parts(&self) -> bool {
+        matches!(self.storage, FiberStackStorage::Unmanaged(_))
+    }
+
+    pub fn from_custom(custom: Box<dyn RuntimeFiberStack>) -> io::Result<Self> {
+        let range = custom.range();
+        let page_size = host_page_size();
+        let start_ptr = range.start as *mut u8;
+        assert!(
+            start_ptr.align_offset(page_size) == 0,
+            "expected fiber stack base ({start_ptr:?}) to be page aligned ({page_size:#x})",
+        );
+        let end_ptr = range.end as *const u8;
+        assert!(
+            end_ptr.align_offset(page_size) == 0,
+            "expected fiber stack end ({end_ptr:?}) to be page aligned ({page_size:#x})",
+        );
+        Ok(FiberStack {
+            base: BasePtr(start_ptr),
+            len: range.len(),
+            storage: FiberStackStorage::Custom(custom),
+        })
+    }
+
+    pub fn top(&self) -> Option<*mut u8> {
+        Some(self.base.0.wrapping_byte_add(self.len))
+    }
+
+    pub fn range(&self) -> Option<Range<usize>> {
+        let base = self.base.0 as usize;
+        Some(base..base + self.len)
+    }
+
+    pub fn guard_range(&self) -> Option<Range<*mut u8>> {
+        match &self.storage {
+            FiberStackStorage::Unmanaged(guard_size) => unsafe {
+                let start = self.base.0.sub(*guard_size);
+                Some(start..self.base.0)
+            },
+            FiberStackStorage::VirtualAlloc(stack) => Some(stack.base..self.base.0),
+            FiberStackStorage::Custom(custom) => Some(custom.guard_range()),
+        }
+    }
+}
+
+struct VirtualAllocFiberStack {
+    base: *mut u8,
+    len: usize,
+}
+
+unsafe impl Send for VirtualAllocFiberStack {}
+unsafe impl Sync for VirtualAllocFiberStack {}
+
+impl VirtualAllocFiberStack {
+    fn new(size: usize) -> io::Result<Self> {
+        // Round up our stack size request to the nearest multiple of the
+        // page size.
+        let page_size = host_page_size();
+        let size = if size == 0 {
+            page_size
+        } else {
+            (size + (page_size - 1)) & (!(page_size - 1))
+        };
+
+        unsafe {
+            // Add in one page for a guard page and then ask for some memory.
+            let len = size + page_size;
+            let base = VirtualAlloc(
+                ptr::null_mut(),
+                len,
+                MEM_RESERVE | MEM_COMMIT,
+                PAGE_READWRITE,
+            );
+            if base.is_null() {
+                return Err(io::Error::last_os_error());
+            }
+            let stack = VirtualAllocFiberStack {
+                base: base.cast(),
+                len,
+            };
+
+            let mut old = 0;
+            if VirtualProtect(base, page_size, PAGE_NOACCESS, &mut old) == 0 {
+                return Err(io::Error::last_os_error());
+            }
+
+            Ok(stack)
+        }
+    }
+}
+
+impl Drop for VirtualAllocFiberStack {
+    fn drop(&mut self) {
+        unsafe {
+            let ret = VirtualFree(self.base.cast(), 0, MEM_RELEASE);
+            debug_assert!(ret != 0);
+        }
+    }
+}
+
+pub struct Fiber;
+
+pub struct Suspend {
+    top_of_stack: *mut u8,
+}
+
+extern "C" fn fiber_start<F, A, B, C>(arg0: *mut u8, top_of_stack: *mut u8)
+where
+    F: FnOnce(A, &mut super::Suspend<A, B, C>) -> C,
+{
+    unsafe {
+        let inner = Suspend { top_of_stack };
+        let initial = inner.take_resume::<A, B, C>();
+        super::Suspend::<A, B, C>::execute(inner, initial, Box::from_raw(arg0.cast::<F>()))
+    }
+}
+
+impl Fiber {
+    pub fn new<F, A, B, C>(stack: &FiberStack, func: F) -> io::Result<Self>
+    where
+        F: FnOnce(A, &mut super::Suspend<A, B, C>) -> C,
+    {
+        let top = stack.top().unwrap();
+        let limit = stack.base.0;
+        let deallocation_stack = stack.guard_range().unwrap().start;
+        unsafe {
+            let data = Box::into_raw(Box::new(func)).cast();
+            wasmtime_fiber_init(
+                top,
+                limit,
+                deallocation_stack,
+                fiber_start::<F, A, B, C>,
+                data,
+            );
+        }
+
+        Ok(Self)
+    }
+
+    pub(crate) fn resume<A, B, C>(&self, stack: &FiberStack, result: &Cell<RunResult<A, B, C>>) {
+        unsafe {
+            // Store where our result is going at the very tip-top of the
+            // stack, otherwise known as our reserved slot for this information.
+            //
+            // In the diagram above this is updating address 0xAff8
+            let addr = stack.top().unwrap().cast::<usize>().offset(-1);
+            addr.write(result as *const _ as usize);
+
+            wasmtime_fiber_switch(stack.top().unwrap());
+
+            // null this out to help catch use-after-free
+            addr.write(0);
+        }
+    }
+
+    pub(crate) unsafe fn drop<A, B, C>(&mut self) {}
+}
+
+impl Suspend {
+    pub(crate) fn switch<A, B, C>(&mut self, result: RunResult<A, B, C>) -> A {
+        unsafe {
+            // Calculate 0xAff8 and then write to it
+            (*self.result_location::<A, B, C>()).set(result);
+
+            wasmtime_fiber_switch(self.top_of_stack);
+
+            self.take_resume::<A, B, C>()
+        }
+    }
+
+    pub(crate) fn exit<A, B, C>(&mut self, result: RunResult<A, B, C>) {
+        self.switch(result);
+        unreachable!()
+    }
+
+    unsafe fn take_resume<A, B, C>(&self) -> A {
+        unsafe {
+            match (*self.result_location::<A, B, C>()).replace(RunResult::Executing) {
+                RunResult::Resuming(val) => val,
+                _ => panic!("not in resuming state"),
+            }
+        }
+    }
+
+    unsafe fn result_location<A, B, C>(&self) -> *const Cell<RunResult<A, B, C>> {
+        unsafe {
+            let ret = self.top_of_stack.cast::<*const u8>().offset(-1).read();
+            assert!(!ret.is_null());
+            ret.cast()
+        }
+    }
+}
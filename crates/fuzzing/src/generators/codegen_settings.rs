@@ -127,6 +127,7 @@ impl<'a> Arbitrary<'a> for CodegenSettings {
                     std:"avx512f" => clif:"has_avx512f" ratio: 1 in 1000,
                     std:"avx512vl" => clif:"has_avx512vl" ratio: 1 in 1000,
                     std:"avx512vbmi" => clif:"has_avx512vbmi" ratio: 1 in 1000,
+                    std:"avx512vnni" => clif:"has_avx512vnni" ratio: 1 in 1000,
                 },
                 "aarch64" => {
                     test: is_aarch64_feature_detected,
@@ -318,6 +318,7 @@ impl Config {
             cfg.wasm.relaxed_simd = Some(false);
         }
         cfg.codegen.collector = Some(self.wasmtime.collector.to_wasmtime());
+        cfg.codegen.gc_inline_alloc = Some(self.wasmtime.gc_inline_alloc);
 
         let compiler_strategy = &self.wasmtime.compiler_strategy;
         let cranelift_strategy = match compiler_strategy {
@@ -615,6 +616,7 @@ pub struct WasmtimeConfig {
     /// Configuration for the compiler to use.
     pub compiler_strategy: CompilerStrategy,
     collector: Collector,
+    gc_inline_alloc: bool,
     table_lazy_init: bool,
 
     /// Whether or not fuzzing should enable PCC.
@@ -10,6 +10,7 @@
 //! When an oracle finds a bug, it should report it to the fuzzing engine by
 //! panicking.
 
+pub mod blowup;
 pub mod component_api;
 pub mod component_async;
 #[cfg(feature = "fuzz-spec-interpreter")]
@@ -0,0 +1,169 @@
+//! Oracles for inputs which make compilation or instantiation disproportionately
+//! expensive.
+//!
+//! Compiling and instantiating a module should take time and memory roughly
+//! proportional to its size. These oracles measure both and panic if either
+//! exceeds a generous budget of a fixed amount plus an amount per byte of the
+//! module, so that libFuzzer records the input as a crash and can minimize it
+//! with `-minimize_crash=1`.
+
+use crate::generators;
+use crate::oracles::{StoreLimits, compile_module, instantiate_with_dummy};
+use crate::single_module_fuzzer::KnownValid;
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::time::{Duration, Instant};
+use wasmtime::{Engine, Store};
+
+/// A budget of a fixed amount plus an amount per byte of the module.
+struct Budget<T> {
+    base: T,
+    per_byte: T,
+}
+
+/// The wall-clock time that compiling a module may take.
+const COMPILE_TIME: Budget<Duration> = Budget {
+    base: Duration::from_secs(1),
+    per_byte: Duration::from_micros(20),
+};
+
+/// The bytes of heap in use at once while compiling a module, on top of what
+/// was in use beforehand.
+const COMPILE_MEMORY: Budget<usize> = Budget {
+    base: 64 << 20,
+    per_byte: 4 << 10,
+};
+
+/// The size of the compiled code of a module.
+const CODE_SIZE: Budget<usize> = Budget {
+    base: 64 << 10,
+    per_byte: 1 << 10,
+};
+
+/// The wall-clock time that instantiating a module may take.
+const INSTANTIATE_TIME: Budget<Duration> = Budget {
+    base: Duration::from_millis(100),
+    per_byte: Duration::from_micros(10),
+};
+
+impl Budget<Duration> {
+    fn for_size(&self, size: usize) -> Duration {
+        self.base + self.per_byte * u32::try_from(size).unwrap_or(u32::MAX)
+    }
+}
+
+impl Budget<usize> {
+    fn for_size(&self, size: usize) -> usize {
+        self.base.saturating_add(self.per_byte.saturating_mul(size))
+    }
+}
+
+/// A global allocator which tracks the peak number of bytes allocated, used by
+/// [`check_compile_and_instantiate_cost`] to measure compilation's memory use.
+///
+/// Fuzz targets using that oracle must register it with
+/// `#[global_allocator]`.
+pub struct PeakAllocator {
+    current: AtomicUsize,
+    peak: AtomicUsize,
+}
+
+impl PeakAllocator {
+    /// Creates a new allocator which hasn't allocated anything yet.
+    pub const fn new() -> PeakAllocator {
+        PeakAllocator {
+            current: AtomicUsize::new(0),
+            peak: AtomicUsize::new(0),
+        }
+    }
+
+    /// Resets the peak to the number of bytes currently allocated, returning
+    /// that number.
+    fn reset_peak(&self) -> usize {
+        let current = self.current.load(Ordering::Relaxed);
+        self.peak.store(current, Ordering::Relaxed);
+        current
+    }
+
+    fn peak(&self) -> usize {
+        self.peak.load(Ordering::Relaxed)
+    }
+}
+
+unsafe impl GlobalAlloc for PeakAllocator {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        let ptr = unsafe { System.alloc(layout) };
+        if !ptr.is_null() {
+            let current = self.current.fetch_add(layout.size(), Ordering::Relaxed);
+            self.peak
+                .fetch_max(current + layout.size(), Ordering::Relaxed);
+        }
+        ptr
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        self.current.fetch_sub(layout.size(), Ordering::Relaxed);
+        unsafe { System.dealloc(ptr, layout) }
+    }
+}
+
+/// Compiles and instantiates `wasm`, panicking if the time, memory or code
+/// size that this takes is out of proportion with the size of `wasm`.
+///
+/// `allocator` must be the global allocator, and `config` mustn't allow start
+/// functions since instantiation isn't expected to run any WebAssembly code.
+/// Modules which aren't known to be valid may have a start function anyway,
+/// so they're only compiled.
+pub fn check_compile_and_instantiate_cost(
+    wasm: &[u8],
+    known_valid: KnownValid,
+    config: &generators::Config,
+    allocator: &PeakAllocator,
+) {
+    assert!(!config.module_config.config.allow_start_export);
+
+    // The verifier only checks the compiler and at least doubles compilation
+    // time, so leave it out of the measurements.
+    let mut wasmtime_config = config.to_wasmtime();
+    wasmtime_config.cranelift_debug_verifier(false);
+    let engine = Engine::new(&wasmtime_config).unwrap();
+    let mut store = Store::new(&engine, StoreLimits::new());
+    config.configure_store(&mut store);
+    let size = wasm.len();
+
+    let before = allocator.reset_peak();
+    let start = Instant::now();
+    let Some(module) = compile_module(store.engine(), wasm, known_valid, config) else {
+        return;
+    };
+    let compile_time = start.elapsed();
+    let compile_memory = allocator.peak().saturating_sub(before);
+    log::debug!(
+        "compiled {size} bytes of wasm in {compile_time:?} using {compile_memory} bytes of heap"
+    );
+    assert!(
+        compile_time <= COMPILE_TIME.for_size(size),
+        "compiling {size} bytes of wasm took {compile_time:?}"
+    );
+    assert!(
+        compile_memory <= COMPILE_MEMORY.for_size(size),
+        "compiling {size} bytes of wasm used {compile_memory} bytes of heap"
+    );
+    let code_size = module.text().len();
+    assert!(
+        code_size <= CODE_SIZE.for_size(size),
+        "compiling {size} bytes of wasm produced {code_size} bytes of code"
+    );
+
+    if known_valid == KnownValid::No {
+        return;
+    }
+    let start = Instant::now();
+    instantiate_with_dummy(&mut store, &module);
+    let instantiate_time = start.elapsed();
+    log::debug!("instantiated {size} bytes of wasm in {instantiate_time:?}");
+    assert!(
+        instantiate_time <= INSTANTIATE_TIME.for_size(size),
+        "instantiating {size} bytes of wasm took {instantiate_time:?}"
+    );
+}
@@ -104,21 +104,39 @@ pub struct GdbJitImageRegistration {
 impl GdbJitImageRegistration {
     /// Registers JIT image using __jit_debug_register_code
     pub fn register(file: Vec<u8>) -> Self {
+        let mut reg = Self::new(file);
+        unsafe {
+            let _lock = gdb_registration::lock();
+            register_gdb_jit_image(&mut *reg.entry);
+        }
+        reg
+    }
+
+    /// Registers many JIT images at once, which only takes the registration
+    /// lock once rather than once per image.
+    pub fn register_batch(files: impl IntoIterator<Item = Vec<u8>>) -> Vec<Self> {
+        let mut regs: Vec<Self> = files.into_iter().map(Self::new).collect();
+        unsafe {
+            let _lock = gdb_registration::lock();
+            for reg in regs.iter_mut() {
+                register_gdb_jit_image(&mut *reg.entry);
+            }
+        }
+        regs
+    }
+
+    fn new(file: Vec<u8>) -> Self {
         let file = Pin::new(file.into_boxed_slice());
 
         // Create a code entry for the file, which gives the start and size
         // of the symbol file.
-        let mut entry = Pin::new(Box::new(JITCodeEntry {
+        let entry = Pin::new(Box::new(JITCodeEntry {
             next_entry: ptr::null_mut(),
             prev_entry: ptr::null_mut(),
             symfile_addr: file.as_ptr(),
             symfile_size: file.len() as u64,
         }));
 
-        unsafe {
-            register_gdb_jit_image(&mut *entry);
-        }
-
         Self { entry, file }
     }
 
@@ -139,9 +157,31 @@ impl Drop for GdbJitImageRegistration {
 unsafe impl Send for GdbJitImageRegistration {}
 unsafe impl Sync for GdbJitImageRegistration {}
 
+/// Whether a debugger is currently attached to this process.
+///
+/// This is only known on Linux, and otherwise a debugger is assumed to be
+/// attached.
+pub fn debugger_attached() -> bool {
+    #[cfg(all(feature = "std", target_os = "linux"))]
+    {
+        let Ok(status) = std::fs::read_to_string("/proc/self/status") else {
+            return true;
+        };
+        status
+            .lines()
+            .find_map(|line| line.strip_prefix("TracerPid:"))
+            .is_none_or(|pid| pid.trim() != "0")
+    }
+    #[cfg(not(all(feature = "std", target_os = "linux")))]
+    {
+        true
+    }
+}
+
+/// Adds `entry` to the debugger's list of images and notifies it, which
+/// requires the registration lock to be held.
 unsafe fn register_gdb_jit_image(entry: *mut JITCodeEntry) {
     unsafe {
-        let _lock = gdb_registration::lock();
         let desc = &mut *wasmtime_jit_debug_descriptor();
 
         // Add it to the linked list in the JIT descriptor.
@@ -314,6 +314,41 @@ impl JitDumpFile {
         self.maybe_atomic_write_all(&record)?;
         Ok(())
     }
+
+    /// Writes a record of the source lines of the code at `address`, which
+    /// must be written before the code load record for that code.
+    ///
+    /// Each entry describes the code from its address up to the address of
+    /// the next entry.
+    pub fn dump_debug_info_record(
+        &mut self,
+        address: u64,
+        entries: &[DebugEntry],
+        timestamp: u64,
+    ) -> io::Result<()> {
+        let mut record = Vec::new();
+        record.extend_from_slice(object::bytes_of(&DebugInfoRecord::default()));
+        for entry in entries {
+            record.extend_from_slice(&entry.address.to_ne_bytes());
+            record.extend_from_slice(&entry.line.to_ne_bytes());
+            record.extend_from_slice(&entry.discriminator.to_ne_bytes());
+            record.extend_from_slice(entry.filename.as_bytes());
+            record.push(0); // null terminator for the file name
+        }
+
+        let dir = DebugInfoRecord {
+            header: RecordHeader {
+                id: RecordId::JitCodeDebugInfo as u32,
+                record_size: record.len() as u32,
+                timestamp,
+            },
+            address,
+            count: entries.len() as u64,
+        };
+        record[..mem::size_of::<DebugInfoRecord>()].copy_from_slice(object::bytes_of(&dir));
+        self.maybe_atomic_write_all(&record)?;
+        Ok(())
+    }
 }
 
 impl Drop for JitDumpFile {
@@ -220,6 +220,8 @@
 
 mod error;
 mod http_impl;
+#[cfg(feature = "default-send-request")]
+mod pool;
 mod types_impl;
 
 pub mod body;
@@ -236,6 +238,8 @@ pub mod p3;
 pub use crate::error::{
     HttpError, HttpResult, http_request_error, hyper_request_error, hyper_response_error,
 };
+#[cfg(feature = "default-send-request")]
+pub use crate::pool::ConnectionPool;
 #[doc(inline)]
 pub use crate::types::{
     DEFAULT_OUTGOING_BODY_BUFFER_CHUNKS, DEFAULT_OUTGOING_BODY_CHUNK_SIZE, WasiHttpCtx,
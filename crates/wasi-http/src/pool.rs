@@ -0,0 +1,191 @@
+//! Reuse of connections across outgoing requests, see [`ConnectionPool`].
+
+use crate::bindings::http::types::ErrorCode;
+use crate::body::HyperOutgoingBody;
+use crate::hyper_request_error;
+use crate::types::{self, HostFutureIncomingResponse, IncomingResponse, OutgoingRequestConfig};
+use http_body_util::BodyExt;
+use hyper::client::conn::http1::SendRequest;
+use std::collections::HashMap;
+use std::sync::{Arc, Mutex};
+use std::time::{Duration, Instant};
+use tokio::time::timeout;
+use wasmtime_wasi::runtime::AbortOnDropJoinHandle;
+
+/// A pool of idle HTTP/1.1 connections which outgoing requests are sent over,
+/// rather than opening a new connection, and TLS session, for each request.
+///
+/// A pool is used by a [`WasiHttpCtx`](crate::WasiHttpCtx) created with
+/// [`WasiHttpCtx::with_connection_pool`](crate::WasiHttpCtx::with_connection_pool).
+/// Clones of a pool share its connections, so one pool can be used by all the
+/// stores of an engine.
+///
+/// Connections are keyed by whether they use TLS and by their authority. Once
+/// the body of a response has been read to completion its connection is
+/// returned to the pool, to be reused by the next request to the same host.
+#[derive(Clone)]
+pub struct ConnectionPool {
+    inner: Arc<PoolInner>,
+}
+
+struct PoolInner {
+    max_idle_per_host: usize,
+    idle_timeout: Duration,
+    /// The TLS configuration shared by all connections, since building it
+    /// parses the root certificates.
+    tls_config: Arc<rustls::ClientConfig>,
+    idle: Mutex<HashMap<(bool, String), Vec<IdleConnection>>>,
+}
+
+struct IdleConnection {
+    sender: SendRequest<HyperOutgoingBody>,
+    worker: AbortOnDropJoinHandle<()>,
+    since: Instant,
+}
+
+impl IdleConnection {
+    fn is_usable(&self, idle_timeout: Duration) -> bool {
+        self.sender.is_ready() && self.since.elapsed() < idle_timeout
+    }
+}
+
+impl ConnectionPool {
+    /// Creates a pool which keeps up to `max_idle_per_host` idle connections
+    /// to each host, and doesn't reuse connections which have been idle for
+    /// longer than `idle_timeout`.
+    pub fn new(max_idle_per_host: usize, idle_timeout: Duration) -> ConnectionPool {
+        ConnectionPool {
+            inner: Arc::new(PoolInner {
+                max_idle_per_host,
+                idle_timeout,
+                tls_config: types::default_tls_config(),
+                idle: Mutex::new(HashMap::new()),
+            }),
+        }
+    }
+
+    /// Returns the number of idle connections in this pool.
+    pub fn idle_connections(&self) -> usize {
+        let idle = self.inner.idle.lock().unwrap();
+        idle.values().map(|conns| conns.len()).sum()
+    }
+
+    /// Sends `request` over a connection from this pool.
+    ///
+    /// This behaves like [`default_send_request`](types::default_send_request)
+    /// other than reusing connections.
+    pub fn send_request(
+        &self,
+        request: hyper::Request<HyperOutgoingBody>,
+        config: OutgoingRequestConfig,
+    ) -> HostFutureIncomingResponse {
+        let pool = self.clone();
+        let handle = wasmtime_wasi::runtime::spawn(async move {
+            Ok(pool.send_request_handler(request, config).await)
+        });
+        HostFutureIncomingResponse::pending(handle)
+    }
+
+    /// The underlying implementation of [`ConnectionPool::send_request`],
+    /// which should likely be spawned in a task.
+    pub async fn send_request_handler(
+        &self,
+        mut request: hyper::Request<HyperOutgoingBody>,
+        OutgoingRequestConfig {
+            use_tls,
+            connect_timeout,
+            first_byte_timeout,
+            between_bytes_timeout,
+        }: OutgoingRequestConfig,
+    ) -> Result<IncomingResponse, ErrorCode> {
+        let key = (use_tls, types::request_authority(&request, use_tls)?);
+        types::strip_scheme_and_authority(&mut request);
+
+        loop {
+            let (mut sender, worker, reused) = match self.checkout(&key) {
+                Some(conn) => (conn.sender, conn.worker, true),
+                None => {
+                    let tls_config = use_tls.then(|| self.inner.tls_config.clone());
+                    let (sender, worker) =
+                        types::connect(&key.1, tls_config, connect_timeout).await?;
+                    (sender, worker, false)
+                }
+            };
+
+            let send = timeout(first_byte_timeout, sender.try_send_request(request));
+            let resp = match send.await {
+                Ok(Ok(resp)) => resp,
+                Ok(Err(mut e)) => match e.take_message() {
+                    // The server closed an idle connection before the request
+                    // was written to it, so try again with another connection.
+                    Some(req) if reused => {
+                        request = req;
+                        continue;
+                    }
+                    _ => return Err(hyper_request_error(e.into_error())),
+                },
+                Err(_) => return Err(ErrorCode::ConnectionReadTimeout),
+            };
+
+            // The connection can be reused once the response's body has been
+            // read, so wait for that in the background and then return it to
+            // the pool. If the body is dropped early the connection is closed
+            // and is dropped here instead.
+            let pool = self.clone();
+            tokio::task::spawn(async move {
+                if sender.ready().await.is_ok() {
+                    pool.checkin(key, sender, worker);
+                }
+            });
+
+            return Ok(IncomingResponse {
+                resp: resp.map(|body| body.map_err(hyper_request_error).boxed_unsync()),
+                // The connection's task is owned by the pool rather than by
+                // the response.
+                worker: None,
+                between_bytes_timeout,
+            });
+        }
+    }
+
+    fn checkout(&self, key: &(bool, String)) -> Option<IdleConnection> {
+        let mut idle = self.inner.idle.lock().unwrap();
+        let conns = idle.get_mut(key)?;
+        // The most recently used connections are at the end, and are the
+        // least likely to have been closed by the server.
+        while let Some(conn) = conns.pop() {
+            if conn.is_usable(self.inner.idle_timeout) {
+                return Some(conn);
+            }
+        }
+        idle.remove(key);
+        None
+    }
+
+    fn checkin(
+        &self,
+        key: (bool, String),
+        sender: SendRequest<HyperOutgoingBody>,
+        worker: AbortOnDropJoinHandle<()>,
+    ) {
+        let mut idle = self.inner.idle.lock().unwrap();
+        let conns = idle.entry(key).or_default();
+        conns.retain(|conn| conn.is_usable(self.inner.idle_timeout));
+        if conns.len() < self.inner.max_idle_per_host {
+            conns.push(IdleConnection {
+                sender,
+                worker,
+                since: Instant::now(),
+            });
+        }
+    }
+}
+
+impl std::fmt::Debug for ConnectionPool {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("ConnectionPool")
+            .field("max_idle_per_host", &self.inner.max_idle_per_host)
+            .field("idle_timeout", &self.inner.idle_timeout)
+            .finish_non_exhaustive()
+    }
+}
@@ -18,6 +18,7 @@ use wasmtime_wasi::runtime::AbortOnDropJoinHandle;
 
 #[cfg(feature = "default-send-request")]
 use {
+    crate::ConnectionPool,
     crate::io::TokioIo,
     crate::{error::dns_error, hyper_request_error},
     tokio::net::TcpStream,
@@ -27,13 +28,36 @@ use {
 /// Capture the state necessary for use in the wasi-http API implementation.
 #[derive(Debug)]
 pub struct WasiHttpCtx {
+    #[cfg(feature = "default-send-request")]
+    connection_pool: Option<ConnectionPool>,
     _priv: (),
 }
 
 impl WasiHttpCtx {
     /// Create a new context.
     pub fn new() -> Self {
-        Self { _priv: () }
+        Self {
+            #[cfg(feature = "default-send-request")]
+            connection_pool: None,
+            _priv: (),
+        }
+    }
+
+    /// Create a new context whose outgoing requests are sent over
+    /// connections from `pool` by the default
+    /// [`WasiHttpView::send_request`].
+    #[cfg(feature = "default-send-request")]
+    pub fn with_connection_pool(pool: ConnectionPool) -> Self {
+        Self {
+            connection_pool: Some(pool),
+            _priv: (),
+        }
+    }
+
+    /// Returns the connection pool of this context, if any.
+    #[cfg(feature = "default-send-request")]
+    pub fn connection_pool(&self) -> Option<&ConnectionPool> {
+        self.connection_pool.as_ref()
     }
 }
 
@@ -125,7 +149,10 @@ pub trait WasiHttpView {
         request: hyper::Request<HyperOutgoingBody>,
         config: OutgoingRequestConfig,
     ) -> crate::HttpResult<HostFutureIncomingResponse> {
-        Ok(default_send_request(request, config))
+        match self.ctx().connection_pool() {
+            Some(pool) => Ok(pool.send_request(request, config)),
+            None => Ok(default_send_request(request, config)),
+        }
     }
 
     /// Send an outgoing request.
@@ -365,17 +392,76 @@ pub async fn default_send_request_handler(
         between_bytes_timeout,
     }: OutgoingRequestConfig,
 ) -> Result<IncomingResponse, types::ErrorCode> {
-    let authority = if let Some(authority) = request.uri().authority() {
+    let authority = request_authority(&request, use_tls)?;
+    let tls_config = if use_tls {
+        Some(default_tls_config())
+    } else {
+        None
+    };
+    let (mut sender, worker) = connect(&authority, tls_config, connect_timeout).await?;
+
+    strip_scheme_and_authority(&mut request);
+
+    let resp = timeout(first_byte_timeout, sender.send_request(request))
+        .await
+        .map_err(|_| types::ErrorCode::ConnectionReadTimeout)?
+        .map_err(hyper_request_error)?
+        .map(|body| body.map_err(hyper_request_error).boxed_unsync());
+
+    Ok(IncomingResponse {
+        resp,
+        worker: Some(worker),
+        between_bytes_timeout,
+    })
+}
+
+/// Returns the `host:port` that `request` is sent to.
+#[cfg(feature = "default-send-request")]
+pub(crate) fn request_authority(
+    request: &hyper::Request<HyperOutgoingBody>,
+    use_tls: bool,
+) -> Result<String, types::ErrorCode> {
+    if let Some(authority) = request.uri().authority() {
         if authority.port().is_some() {
-            authority.to_string()
+            Ok(authority.to_string())
         } else {
             let port = if use_tls { 443 } else { 80 };
-            format!("{}:{port}", authority.to_string())
+            Ok(format!("{}:{port}", authority.to_string()))
         }
     } else {
-        return Err(types::ErrorCode::HttpRequestUriInvalid);
+        Err(types::ErrorCode::HttpRequestUriInvalid)
+    }
+}
+
+/// Returns the TLS configuration used for outgoing requests, which trusts the
+/// Mozilla root certificates.
+#[cfg(feature = "default-send-request")]
+pub(crate) fn default_tls_config() -> std::sync::Arc<rustls::ClientConfig> {
+    // derived from https://github.com/rustls/rustls/blob/main/examples/src/bin/simpleclient.rs
+    let root_cert_store = rustls::RootCertStore {
+        roots: webpki_roots::TLS_SERVER_ROOTS.into(),
     };
-    let tcp_stream = timeout(connect_timeout, TcpStream::connect(&authority))
+    let config = rustls::ClientConfig::builder()
+        .with_root_certificates(root_cert_store)
+        .with_no_client_auth();
+    std::sync::Arc::new(config)
+}
+
+/// Opens an HTTP/1.1 connection to `authority`, over TLS if `tls_config` is
+/// given, returning the connection's sender along with the task driving it.
+#[cfg(feature = "default-send-request")]
+pub(crate) async fn connect(
+    authority: &str,
+    tls_config: Option<std::sync::Arc<rustls::ClientConfig>>,
+    connect_timeout: Duration,
+) -> Result<
+    (
+        hyper::client::conn::http1::SendRequest<HyperOutgoingBody>,
+        AbortOnDropJoinHandle<()>,
+    ),
+    types::ErrorCode,
+> {
+    let tcp_stream = timeout(connect_timeout, TcpStream::connect(authority))
         .await
         .map_err(|_| types::ErrorCode::ConnectionTimeout)?
         .map_err(|e| match e.kind() {
@@ -394,19 +480,12 @@ pub async fn default_send_request_handler(
             }
         })?;
 
-    let (mut sender, worker) = if use_tls {
+    let (sender, worker) = if let Some(tls_config) = tls_config {
         use rustls::pki_types::ServerName;
 
-        // derived from https://github.com/rustls/rustls/blob/main/examples/src/bin/simpleclient.rs
-        let root_cert_store = rustls::RootCertStore {
-            roots: webpki_roots::TLS_SERVER_ROOTS.into(),
-        };
-        let config = rustls::ClientConfig::builder()
-            .with_root_certificates(root_cert_store)
-            .with_no_client_auth();
-        let connector = tokio_rustls::TlsConnector::from(std::sync::Arc::new(config));
+        let connector = tokio_rustls::TlsConnector::from(tls_config);
         let mut parts = authority.split(":");
-        let host = parts.next().unwrap_or(&authority);
+        let host = parts.next().unwrap_or(authority);
         let domain = ServerName::try_from(host)
             .map_err(|e| {
                 tracing::warn!("dns lookup error: {e:?}");
@@ -459,6 +538,12 @@ pub async fn default_send_request_handler(
         (sender, worker)
     };
 
+    Ok((sender, worker))
+}
+
+/// Removes the scheme and authority from the URI of `request`.
+#[cfg(feature = "default-send-request")]
+pub(crate) fn strip_scheme_and_authority(request: &mut hyper::Request<HyperOutgoingBody>) {
     // at this point, the request contains the scheme and the authority, but
     // the http packet should only include those if addressing a proxy, so
     // remove them here, since SendRequest::send_request does not do it for us
@@ -472,18 +557,6 @@ pub async fn default_send_request_handler(
         )
         .build()
         .expect("comes from valid request");
-
-    let resp = timeout(first_byte_timeout, sender.send_request(request))
-        .await
-        .map_err(|_| types::ErrorCode::ConnectionReadTimeout)?
-        .map_err(hyper_request_error)?
-        .map(|body| body.map_err(hyper_request_error).boxed_unsync());
-
-    Ok(IncomingResponse {
-        resp,
-        worker: Some(worker),
-        between_bytes_timeout,
-    })
 }
 
 impl From<http::Method> for types::Method {
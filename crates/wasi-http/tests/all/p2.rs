@@ -5,7 +5,17 @@ use http_body::Frame;
 use http_body_util::{BodyExt, Collected, Empty, StreamBody, combinators::BoxBody};
 use hyper::{Method, StatusCode, body::Bytes, server::conn::http1, service::service_fn};
 use sha2::{Digest, Sha256};
-use std::{collections::HashMap, iter, net::Ipv4Addr, str, sync::Arc};
+use std::{
+    collections::HashMap,
+    iter,
+    net::Ipv4Addr,
+    str,
+    sync::{
+        Arc,
+        atomic::{AtomicUsize, Ordering},
+    },
+    time::Duration,
+};
 use tokio::task;
 use wasmtime::{
     Config, Engine, Result, Store,
@@ -583,3 +593,67 @@ async fn wasi_http_no_trap_on_early_drop() -> Result<()> {
         panic!("test expects an error");
     }
 }
+
+#[test_log::test(tokio::test)]
+async fn wasi_http_connection_pool_reuses_connections() -> Result<()> {
+    let listener = tokio::net::TcpListener::bind((Ipv4Addr::new(127, 0, 0, 1), 0)).await?;
+    let addr = listener.local_addr()?;
+    let accepted = Arc::new(AtomicUsize::new(0));
+
+    let server = task::spawn({
+        let accepted = accepted.clone();
+        async move {
+            loop {
+                let (stream, _) = listener.accept().await?;
+                accepted.fetch_add(1, Ordering::SeqCst);
+                task::spawn(http1::Builder::new().keep_alive(true).serve_connection(
+                    TokioIo::new(stream),
+                    service_fn(|_| async {
+                        Ok::<_, wasmtime::Error>(hyper::Response::new(body::full(
+                            Bytes::from_static(b"hello"),
+                        )))
+                    }),
+                ));
+
+                // Help rustc with type inference:
+                if false {
+                    return Ok::<_, wasmtime::Error>(());
+                }
+            }
+        }
+    });
+
+    let pool = wasmtime_wasi_http::ConnectionPool::new(2, Duration::from_secs(60));
+    for _ in 0..3 {
+        let request = hyper::Request::builder()
+            .uri(format!("http://{addr}/"))
+            .body(Empty::new().map_err(|x| match x {}).boxed_unsync())?;
+        let config = OutgoingRequestConfig {
+            use_tls: false,
+            connect_timeout: Duration::from_secs(5),
+            first_byte_timeout: Duration::from_secs(5),
+            between_bytes_timeout: Duration::from_secs(5),
+        };
+        let response = pool
+            .send_request_handler(request, config)
+            .await
+            .map_err(|e| format_err!("{e:?}"))?;
+        let body = response.resp.into_body().collect().await;
+        let body = body.map_err(|e| format_err!("{e:?}"))?.to_bytes();
+        assert_eq!(body, "hello");
+
+        // The connection is returned to the pool in the background once the
+        // response has been read.
+        tokio::time::timeout(Duration::from_secs(5), async {
+            while pool.idle_connections() == 0 {
+                tokio::time::sleep(Duration::from_millis(1)).await;
+            }
+        })
+        .await?;
+    }
+
+    assert_eq!(accepted.load(Ordering::SeqCst), 1);
+    assert_eq!(pool.idle_connections(), 1);
+    server.abort();
+    Ok(())
+}
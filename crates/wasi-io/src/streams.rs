@@ -228,6 +228,23 @@ pub trait OutputStream: Pollable {
         Ok(())
     }
 
+    /// Writes the concatenation of `bufs` directly from the caller's
+    /// buffers, for example with `writev`, and flushes it, blocking until
+    /// both are complete.
+    ///
+    /// This is an optional fast path for streams backed by a host file
+    /// descriptor, such as stdout, which lets callers like WASIp1's
+    /// `fd_write` skip copying data into [`Bytes`] first. Fewer bytes than
+    /// given may be written, and the number written is returned.
+    ///
+    /// Returns `None`, which is the default, if the stream doesn't support
+    /// this, in which case callers fall back to
+    /// [`blocking_write_and_flush`](Self::blocking_write_and_flush).
+    fn blocking_write_vectored(&mut self, bufs: &[&[u8]]) -> Option<StreamResult<usize>> {
+        let _ = bufs;
+        None
+    }
+
     /// Repeatedly write a byte to a stream.
     /// Important: this write must be non-blocking!
     /// Returning an Err which downcasts to a [`StreamError`] will be
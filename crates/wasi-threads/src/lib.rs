@@ -2,10 +2,10 @@
 //!
 //! [`wasi-threads`]: https://github.com/WebAssembly/wasi-threads
 
+use pool::ThreadPool;
 use std::panic::{AssertUnwindSafe, catch_unwind};
 use std::sync::Arc;
 use std::sync::atomic::{AtomicI32, Ordering};
-use std::thread;
 use wasmtime::{
     Caller, ExternType, InstancePre, Linker, Module, Result, SharedMemory, Store, format_err,
 };
@@ -14,10 +14,13 @@ use wasmtime::{
 // https://github.com/WebAssembly/wasi-threads/#detailed-design-discussion
 const WASI_ENTRY_POINT: &str = "wasi_thread_start";
 
+mod pool;
+
 pub struct WasiThreadsCtx<T> {
     instance_pre: Arc<InstancePre<T>>,
     tid: AtomicI32,
     use_async: bool,
+    pool: ThreadPool,
 }
 
 impl<T: Clone + Send + 'static> WasiThreadsCtx<T> {
@@ -28,6 +31,7 @@ impl<T: Clone + Send + 'static> WasiThreadsCtx<T> {
             instance_pre,
             tid,
             use_async,
+            pool: ThreadPool::new(),
         })
     }
 
@@ -63,10 +67,11 @@ impl<T: Clone + Send + 'static> WasiThreadsCtx<T> {
         }
         let wasi_thread_id = wasi_thread_id.unwrap();
 
-        // Start a Rust thread running a new instance of the current module.
-        let builder = thread::Builder::new().name(format!("wasi-thread-{wasi_thread_id}"));
+        // Run a new instance of the current module on a thread of the pool,
+        // which only starts a new Rust thread if none of its threads is idle.
+        let name = format!("wasi-thread-{wasi_thread_id}");
         let use_async = self.use_async;
-        builder.spawn(move || {
+        self.pool.execute(name, Box::new(move || {
             // Catch any panic failures in host code; e.g., if a WASI module
             // were to crash, we want all threads to exit, not just this one.
             let result = catch_unwind(AssertUnwindSafe(|| {
@@ -115,7 +120,7 @@ impl<T: Clone + Send + 'static> WasiThreadsCtx<T> {
                 eprintln!("wasi-thread-{wasi_thread_id} panicked: {e:?}");
                 std::process::exit(1);
             }
-        })?;
+        }))?;
 
         Ok(wasi_thread_id)
     }
@@ -0,0 +1,92 @@
+//! A pool of OS threads to run wasi-threads on.
+//!
+//! Fork-join style guests spawn many short-lived threads, so instead of
+//! exiting once a wasi-thread returns, its OS thread waits for a while to run
+//! the next one. Spawning a wasi-thread only creates a new OS thread when no
+//! idle one is waiting.
+
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::mpsc::{self, Receiver, RecvTimeoutError, Sender};
+use std::sync::{Arc, Mutex};
+use std::thread;
+use std::time::Duration;
+
+/// How long an idle thread waits for a new wasi-thread before exiting.
+const IDLE_TIMEOUT: Duration = Duration::from_secs(10);
+
+type Job = Box<dyn FnOnce() + Send>;
+
+pub(crate) struct ThreadPool {
+    jobs: Sender<Job>,
+    shared: Arc<Shared>,
+}
+
+struct Shared {
+    jobs: Mutex<Receiver<Job>>,
+    /// The number of threads waiting for a job, minus the number of jobs
+    /// sent to them which haven't been received yet.
+    idle: AtomicUsize,
+}
+
+impl ThreadPool {
+    pub(crate) fn new() -> Self {
+        let (sender, receiver) = mpsc::channel();
+        Self {
+            jobs: sender,
+            shared: Arc::new(Shared {
+                jobs: Mutex::new(receiver),
+                idle: AtomicUsize::new(0),
+            }),
+        }
+    }
+
+    /// Runs `job` on an idle thread of the pool, or on a new thread named
+    /// `name` if there isn't one.
+    pub(crate) fn execute(&self, name: String, job: Job) -> std::io::Result<()> {
+        let claimed_idle = self
+            .shared
+            .idle
+            .fetch_update(Ordering::AcqRel, Ordering::Acquire, |n| n.checked_sub(1))
+            .is_ok();
+        if claimed_idle {
+            // The receiver lives as long as the pool, so this can't fail.
+            self.jobs.send(job).unwrap();
+            return Ok(());
+        }
+        let shared = self.shared.clone();
+        thread::Builder::new().name(name).spawn(move || {
+            job();
+            shared.run();
+        })?;
+        Ok(())
+    }
+}
+
+impl Shared {
+    /// Runs the jobs sent to idle threads until this thread has been idle for
+    /// `IDLE_TIMEOUT`, or the pool is dropped.
+    fn run(&self) {
+        self.idle.fetch_add(1, Ordering::AcqRel);
+        loop {
+            let job = self.jobs.lock().unwrap().recv_timeout(IDLE_TIMEOUT);
+            match job {
+                Ok(job) => {
+                    job();
+                    self.idle.fetch_add(1, Ordering::AcqRel);
+                }
+                Err(RecvTimeoutError::Timeout) => {
+                    // Exit only if no job has been sent expecting this thread
+                    // to be waiting for it.
+                    let unclaimed = self
+                        .idle
+                        .fetch_update(Ordering::AcqRel, Ordering::Acquire, |n| n.checked_sub(1))
+                        .is_ok();
+                    if unclaimed {
+                        return;
+                    }
+                }
+                Err(RecvTimeoutError::Disconnected) => return,
+            }
+        }
+    }
+}
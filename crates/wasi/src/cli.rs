@@ -76,8 +76,8 @@ pub struct WasiCliCtxView<'a> {
 }
 
 pub struct WasiCliCtx {
-    pub(crate) environment: Vec<(String, String)>,
-    pub(crate) arguments: Vec<String>,
+    pub(crate) environment: Arc<Vec<(String, String)>>,
+    pub(crate) arguments: Arc<Vec<String>>,
     pub(crate) initial_cwd: Option<String>,
     pub(crate) stdin: Box<dyn StdinStream>,
     pub(crate) stdout: Box<dyn StdoutStream>,
@@ -87,8 +87,8 @@ pub struct WasiCliCtx {
 impl Default for WasiCliCtx {
     fn default() -> WasiCliCtx {
         WasiCliCtx {
-            environment: Vec::new(),
-            arguments: Vec::new(),
+            environment: Arc::default(),
+            arguments: Arc::default(),
             initial_cwd: None,
             stdin: Box::new(empty()),
             stdout: Box::new(empty()),
@@ -92,6 +92,20 @@ impl OutputStream for StdioOutputStream {
     fn check_write(&mut self) -> p2::StreamResult<usize> {
         Ok(1024 * 1024)
     }
+
+    fn blocking_write_vectored(&mut self, bufs: &[&[u8]]) -> Option<p2::StreamResult<usize>> {
+        fn write(mut out: impl Write, bufs: &[&[u8]]) -> io::Result<usize> {
+            let bufs = bufs.iter().map(|b| io::IoSlice::new(b)).collect::<Vec<_>>();
+            let n = out.write_vectored(&bufs)?;
+            out.flush()?;
+            Ok(n)
+        }
+        let result = match self {
+            StdioOutputStream::Stdout => write(std::io::stdout().lock(), bufs),
+            StdioOutputStream::Stderr => write(std::io::stderr().lock(), bufs),
+        };
+        Some(result.map_err(|e| p2::StreamError::LastOperationFailed(wasmtime::format_err!(e))))
+    }
 }
 
 impl AsyncWrite for StdioOutputStream {
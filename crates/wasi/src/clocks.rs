@@ -155,6 +155,58 @@ impl HostMonotonicClock for MonotonicClock {
     }
 }
 
+/// A clock for deterministic execution, which starts at a fixed time and
+/// advances by a fixed step each time it's read, rather than reading the
+/// host's clock.
+///
+/// This can be used as either a wall clock, where times are durations since
+/// the Unix epoch, or as a monotonic clock, with
+/// [`WasiCtxBuilder::wall_clock`](crate::WasiCtxBuilder::wall_clock) and
+/// [`WasiCtxBuilder::monotonic_clock`](crate::WasiCtxBuilder::monotonic_clock).
+/// Together with a deterministic random number generator this makes a
+/// guest's execution replayable.
+pub struct StepClock {
+    now: std::cell::Cell<Duration>,
+    step: Duration,
+}
+
+impl StepClock {
+    /// Creates a clock which first reads as `start` and then advances by
+    /// `step` each time it's read.
+    pub fn new(start: Duration, step: Duration) -> Self {
+        Self {
+            now: std::cell::Cell::new(start),
+            step,
+        }
+    }
+
+    fn tick(&self) -> Duration {
+        let now = self.now.get();
+        self.now.set(now.saturating_add(self.step));
+        now
+    }
+}
+
+impl HostWallClock for StepClock {
+    fn resolution(&self) -> Duration {
+        self.step.max(Duration::from_nanos(1))
+    }
+
+    fn now(&self) -> Duration {
+        self.tick()
+    }
+}
+
+impl HostMonotonicClock for StepClock {
+    fn resolution(&self) -> u64 {
+        self.step.as_nanos().clamp(1, u64::MAX.into()) as u64
+    }
+
+    fn now(&self) -> u64 {
+        self.tick().as_nanos().try_into().unwrap_or(u64::MAX)
+    }
+}
+
 pub fn monotonic_clock() -> Box<dyn HostMonotonicClock + Send> {
     Box::new(MonotonicClock::default())
 }
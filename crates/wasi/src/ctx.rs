@@ -1,6 +1,6 @@
 use crate::cli::{StdinStream, StdoutStream, WasiCliCtx};
 use crate::clocks::{HostMonotonicClock, HostWallClock, WasiClocksCtx};
-use crate::filesystem::{Dir, WasiFilesystemCtx};
+use crate::filesystem::{Archive, Descriptor, Dir, SharedDir, WasiFilesystemCtx};
 use crate::random::WasiRandomCtx;
 use crate::sockets::{SocketAddrCheck, SocketAddrUse, WasiSocketsCtx};
 use crate::{DirPerms, FilePerms, OpenMode};
@@ -11,6 +11,7 @@ use std::mem;
 use std::net::SocketAddr;
 use std::path::Path;
 use std::pin::Pin;
+use std::sync::Arc;
 use tokio::io::{stderr, stdin, stdout};
 use wasmtime::Result;
 
@@ -184,7 +185,7 @@ impl WasiCtxBuilder {
     /// ]);
     /// ```
     pub fn envs(&mut self, env: &[(impl AsRef<str>, impl AsRef<str>)]) -> &mut Self {
-        self.cli.environment.extend(
+        Arc::make_mut(&mut self.cli.environment).extend(
             env.iter()
                 .map(|(k, v)| (k.as_ref().to_owned(), v.as_ref().to_owned())),
         );
@@ -205,8 +206,7 @@ impl WasiCtxBuilder {
     /// wasi.env("FOO", "bar");
     /// ```
     pub fn env(&mut self, k: impl AsRef<str>, v: impl AsRef<str>) -> &mut Self {
-        self.cli
-            .environment
+        Arc::make_mut(&mut self.cli.environment)
             .push((k.as_ref().to_owned(), v.as_ref().to_owned()));
         self
     }
@@ -217,28 +217,26 @@ impl WasiCtxBuilder {
     /// This will use [`envs`](WasiCtxBuilder::envs) to append all host-defined
     /// environment variables.
     pub fn inherit_env(&mut self) -> &mut Self {
-        self.cli.environment.extend(std::env::vars());
+        Arc::make_mut(&mut self.cli.environment).extend(std::env::vars());
         self
     }
 
     /// Appends a list of arguments to the argument array to pass to wasm.
     pub fn args(&mut self, args: &[impl AsRef<str>]) -> &mut Self {
-        self.cli
-            .arguments
-            .extend(args.iter().map(|a| a.as_ref().to_owned()));
+        Arc::make_mut(&mut self.cli.arguments).extend(args.iter().map(|a| a.as_ref().to_owned()));
         self
     }
 
     /// Appends a single argument to get passed to wasm.
     pub fn arg(&mut self, arg: impl AsRef<str>) -> &mut Self {
-        self.cli.arguments.push(arg.as_ref().to_owned());
+        Arc::make_mut(&mut self.cli.arguments).push(arg.as_ref().to_owned());
         self
     }
 
     /// Appends all host process arguments to the list of arguments to get
     /// passed to wasm.
     pub fn inherit_args(&mut self) -> &mut Self {
-        self.cli.arguments.extend(std::env::args());
+        Arc::make_mut(&mut self.cli.arguments).extend(std::env::args());
         self
     }
 
@@ -304,18 +302,89 @@ impl WasiCtxBuilder {
             open_mode |= OpenMode::WRITE;
         }
         self.filesystem.preopens.push((
-            Dir::new(
+            Descriptor::Dir(Dir::new(
                 dir,
                 dir_perms,
                 file_perms,
                 open_mode,
                 self.filesystem.allow_blocking_current_thread,
-            ),
+            )),
             guest_path.as_ref().to_owned(),
         ));
         Ok(self)
     }
 
+    /// Provides read-only access to the shared directory `dir` from
+    /// WebAssembly as `guest_path`.
+    ///
+    /// Unlike [`WasiCtxBuilder::preopened_dir`] the same [`SharedDir`] can be
+    /// preopened by many contexts, which share its caches of opened files and
+    /// directory listings. This is useful when many stores read the same tree
+    /// of assets.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use wasmtime_wasi::WasiCtxBuilder;
+    /// use wasmtime_wasi::filesystem::SharedDir;
+    ///
+    /// # fn main() {}
+    /// # fn foo() -> wasmtime::Result<()> {
+    /// let assets = SharedDir::new("./assets")?;
+    ///
+    /// for _ in 0..10 {
+    ///     let mut wasi = WasiCtxBuilder::new();
+    ///     wasi.preopened_shared_dir(&assets, "/assets");
+    /// }
+    /// # Ok(())
+    /// # }
+    /// ```
+    pub fn preopened_shared_dir(
+        &mut self,
+        dir: &SharedDir,
+        guest_path: impl AsRef<str>,
+    ) -> &mut Self {
+        self.filesystem.preopens.push((
+            Descriptor::Dir(dir.preopen(self.filesystem.allow_blocking_current_thread)),
+            guest_path.as_ref().to_owned(),
+        ));
+        self
+    }
+
+    /// Provides read-only access to the files of `archive` from WebAssembly
+    /// as `guest_path`.
+    ///
+    /// Files are read directly from the archive's buffer, so guests reading
+    /// them don't cause any filesystem calls on the host. See [`Archive`] for
+    /// more information.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use wasmtime_wasi::WasiCtxBuilder;
+    /// use wasmtime_wasi::filesystem::{Archive, ArchiveBuilder};
+    ///
+    /// # fn main() {}
+    /// # fn foo() -> wasmtime::Result<()> {
+    /// let archive = Archive::new(ArchiveBuilder::new().file("a/b.txt", "hello").finish())?;
+    ///
+    /// let mut wasi = WasiCtxBuilder::new();
+    /// wasi.preopened_archive(&archive, "/assets");
+    /// # Ok(())
+    /// # }
+    /// ```
+    pub fn preopened_archive(
+        &mut self,
+        archive: &Archive,
+        guest_path: impl AsRef<str>,
+    ) -> &mut Self {
+        self.filesystem.preopens.push((
+            Descriptor::Archive(archive.root()),
+            guest_path.as_ref().to_owned(),
+        ));
+        self
+    }
+
     /// Set the generator for the `wasi:random/random` number generator to the
     /// custom generator specified.
     ///
@@ -468,6 +537,71 @@ impl WasiCtxBuilder {
         let wasi = self.build();
         crate::p1::WasiP1Ctx::new(wasi)
     }
+
+    /// Returns a [`WasiCtxTemplate`] of the arguments, environment variables,
+    /// preopened directories and network settings configured so far.
+    ///
+    /// The template can then be used to create many builders with these
+    /// settings, for example one per [`Store`], without copying them each
+    /// time.
+    ///
+    /// [`Store`]: wasmtime::Store
+    pub fn template(&self) -> WasiCtxTemplate {
+        WasiCtxTemplate {
+            environment: self.cli.environment.clone(),
+            arguments: self.cli.arguments.clone(),
+            filesystem: self.filesystem.clone(),
+            sockets: self.sockets.clone(),
+        }
+    }
+}
+
+/// The arguments, environment variables, preopened directories and network
+/// settings of a [`WasiCtxBuilder`], created with
+/// [`WasiCtxBuilder::template`].
+///
+/// Each call to [`WasiCtxTemplate::builder`] returns a new builder with these
+/// settings. The arguments and environment variables are shared by the
+/// template and its builders until a builder adds to them, so creating a
+/// builder doesn't copy them.
+///
+/// # Examples
+///
+/// ```
+/// use wasmtime_wasi::WasiCtx;
+///
+/// let mut wasi = WasiCtx::builder();
+/// wasi.arg("./foo.wasm");
+/// wasi.env("FOO", "bar");
+/// let template = wasi.template();
+///
+/// for i in 0..10 {
+///     let mut wasi = template.builder();
+///     wasi.env("REQUEST", i.to_string());
+///     let wasi: WasiCtx = wasi.build();
+/// }
+/// ```
+#[derive(Clone)]
+pub struct WasiCtxTemplate {
+    environment: Arc<Vec<(String, String)>>,
+    arguments: Arc<Vec<String>>,
+    filesystem: WasiFilesystemCtx,
+    sockets: WasiSocketsCtx,
+}
+
+impl WasiCtxTemplate {
+    /// Creates a builder with the settings of this template.
+    ///
+    /// Settings which aren't part of a template, such as stdio, clocks and
+    /// random number generators, have their defaults in the returned builder.
+    pub fn builder(&self) -> WasiCtxBuilder {
+        let mut builder = WasiCtxBuilder::new();
+        builder.cli.environment = self.environment.clone();
+        builder.cli.arguments = self.arguments.clone();
+        builder.filesystem = self.filesystem.clone();
+        builder.sockets = self.sockets.clone();
+        builder
+    }
 }
 
 /// Per-[`Store`] state which holds state necessary to implement WASI from this
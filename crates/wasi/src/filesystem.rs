@@ -2,12 +2,17 @@ use crate::clocks::Datetime;
 use crate::runtime::{AbortOnDropJoinHandle, spawn_blocking};
 use cap_fs_ext::{FileTypeExt as _, MetadataExt as _};
 use fs_set_times::SystemTimeSpec;
-use std::collections::hash_map;
-use std::sync::Arc;
+use std::collections::{HashMap, hash_map};
+use std::path::Path;
+use std::sync::{Arc, Mutex};
 use tracing::debug;
 use wasmtime::component::{HasData, Resource, ResourceTable};
 use wasmtime::error::Context as _;
 
+mod archive;
+
+pub use self::archive::{Archive, ArchiveBuilder, ArchiveNode};
+
 /// A helper struct which implements [`HasData`] for the `wasi:filesystem` APIs.
 ///
 /// This can be useful when directly calling `add_to_linker` functions directly,
@@ -55,7 +60,7 @@ impl HasData for WasiFilesystem {
 #[derive(Clone, Default)]
 pub struct WasiFilesystemCtx {
     pub(crate) allow_blocking_current_thread: bool,
-    pub(crate) preopens: Vec<(Dir, String)>,
+    pub(crate) preopens: Vec<(Descriptor, String)>,
 }
 
 pub struct WasiFilesystemCtxView<'a> {
@@ -449,6 +454,8 @@ impl From<std::io::Error> for ErrorCode {
 pub enum Descriptor {
     File(File),
     Dir(Dir),
+    /// A file or directory within a read-only [`Archive`].
+    Archive(ArchiveNode),
 }
 
 impl Descriptor {
@@ -456,6 +463,8 @@ impl Descriptor {
         match self {
             Descriptor::File(f) => Ok(f),
             Descriptor::Dir(_) => Err(ErrorCode::BadDescriptor),
+            // Archives can only be read, which is handled separately.
+            Descriptor::Archive(_) => Err(ErrorCode::NotPermitted),
         }
     }
 
@@ -463,6 +472,10 @@ impl Descriptor {
         match self {
             Descriptor::Dir(d) => Ok(d),
             Descriptor::File(_) => Err(ErrorCode::NotDirectory),
+            // Archives can't be modified, and lookups in them are handled
+            // separately.
+            Descriptor::Archive(a) if a.is_dir() => Err(ErrorCode::NotPermitted),
+            Descriptor::Archive(_) => Err(ErrorCode::NotDirectory),
         }
     }
 
@@ -476,6 +489,7 @@ impl Descriptor {
                 // No permissions check on metadata: if opened, allowed to stat it
                 d.run_blocking(|d| d.dir_metadata()).await
             }
+            Self::Archive(_) => Err(std::io::ErrorKind::Unsupported.into()),
         }
     }
 
@@ -505,6 +519,7 @@ impl Descriptor {
                 })
                 .await
             }
+            Self::Archive(_) => Ok(()),
         }
     }
 
@@ -547,6 +562,7 @@ impl Descriptor {
                 }
                 Ok(flags)
             }
+            Self::Archive(_) => Ok(DescriptorFlags::READ),
         }
     }
 
@@ -557,6 +573,7 @@ impl Descriptor {
                 Ok(meta.file_type().into())
             }
             Self::Dir(_) => Ok(DescriptorType::Directory),
+            Self::Archive(a) => Ok(a.stat().type_),
         }
     }
 
@@ -581,6 +598,7 @@ impl Descriptor {
                 d.run_blocking(|d| d.set_times(atim, mtim)).await?;
                 Ok(())
             }
+            Self::Archive(_) => Err(ErrorCode::NotPermitted),
         }
     }
 
@@ -610,6 +628,7 @@ impl Descriptor {
                 })
                 .await
             }
+            Self::Archive(_) => Ok(()),
         }
     }
 
@@ -625,11 +644,17 @@ impl Descriptor {
                 let meta = d.run_blocking(|d| d.dir_metadata()).await?;
                 Ok(meta.into())
             }
+            Self::Archive(a) => Ok(a.stat()),
         }
     }
 
     pub(crate) async fn is_same_object(&self, other: &Self) -> wasmtime::Result<bool> {
         use cap_fs_ext::MetadataExt;
+        match (self, other) {
+            (Self::Archive(a), Self::Archive(b)) => return Ok(a.is_same_object(b)),
+            (Self::Archive(_), _) | (_, Self::Archive(_)) => return Ok(false),
+            _ => {}
+        }
         let meta_a = self.get_metadata().await?;
         let meta_b = other.get_metadata().await?;
         if meta_a.dev() == meta_b.dev() && meta_a.ino() == meta_b.ino() {
@@ -651,6 +676,9 @@ impl Descriptor {
     }
 
     pub(crate) async fn metadata_hash(&self) -> Result<MetadataHashValue, ErrorCode> {
+        if let Self::Archive(a) = self {
+            return Ok(a.metadata_hash());
+        }
         let meta = self.get_metadata().await?;
         Ok(MetadataHashValue::from(&meta))
     }
@@ -764,6 +792,132 @@ impl File {
     }
 }
 
+/// A read-only directory tree which can be preopened by many contexts, see
+/// [`WasiCtxBuilder::preopened_shared_dir`](crate::WasiCtxBuilder::preopened_shared_dir).
+///
+/// The directory is opened once, and the files and directories opened beneath
+/// it along with the directory listings read from it are cached and shared by
+/// every context it's preopened in. This means that repeatedly opening or
+/// listing the same path, from any context, only reaches the host filesystem
+/// the first time.
+///
+/// The tree is assumed not to change while it's shared, and changes to it may
+/// not be observed by guests.
+#[derive(Clone)]
+pub struct SharedDir {
+    inner: Arc<SharedDirInner>,
+}
+
+struct SharedDirInner {
+    dir: Arc<cap_std::fs::Dir>,
+    cache: Mutex<SharedDirCache>,
+}
+
+#[derive(Default)]
+struct SharedDirCache {
+    /// Opened files and directories, by their path beneath the root.
+    opened: HashMap<String, Opened>,
+    /// The entries of directories, by their path beneath the root.
+    listings: HashMap<String, Arc<[(cap_std::fs::FileType, String)]>>,
+    stats: SharedDirStats,
+}
+
+#[derive(Clone)]
+enum Opened {
+    Dir(Arc<cap_std::fs::Dir>),
+    File(Arc<cap_std::fs::File>),
+}
+
+/// Counts of the lookups in a [`SharedDir`]'s caches, as returned by
+/// [`SharedDir::stats`].
+#[derive(Copy, Clone, Debug, Default, PartialEq, Eq)]
+pub struct SharedDirStats {
+    /// The number of opens and listings served from the cache.
+    pub hits: u64,
+    /// The number of opens and listings which reached the host filesystem.
+    pub misses: u64,
+}
+
+impl SharedDir {
+    /// Opens the directory at `host_path` to be shared.
+    pub fn new(host_path: impl AsRef<Path>) -> std::io::Result<SharedDir> {
+        let dir =
+            cap_std::fs::Dir::open_ambient_dir(host_path.as_ref(), cap_std::ambient_authority())?;
+        Ok(SharedDir {
+            inner: Arc::new(SharedDirInner {
+                dir: Arc::new(dir),
+                cache: Mutex::new(SharedDirCache::default()),
+            }),
+        })
+    }
+
+    /// Returns the number of cache hits and misses so far.
+    pub fn stats(&self) -> SharedDirStats {
+        self.inner.cache.lock().unwrap().stats
+    }
+
+    pub(crate) fn preopen(&self, allow_blocking_current_thread: bool) -> Dir {
+        Dir {
+            dir: self.inner.dir.clone(),
+            perms: DirPerms::READ,
+            file_perms: FilePerms::READ,
+            open_mode: OpenMode::READ,
+            allow_blocking_current_thread,
+            shared: Some(SharedPath {
+                dir: self.clone(),
+                path: String::new(),
+            }),
+        }
+    }
+}
+
+/// A directory beneath a [`SharedDir`], identifying it in the caches.
+#[derive(Clone)]
+struct SharedPath {
+    dir: SharedDir,
+    /// The path from the root, which is empty for the root itself.
+    path: String,
+}
+
+impl SharedPath {
+    /// Returns the path of `path` beneath this directory, or `None` if it
+    /// isn't a plain relative path which can be cached.
+    fn join(&self, path: &str) -> Option<SharedPath> {
+        let plain = |c: &str| !c.is_empty() && c != "." && c != ".." && !c.contains('\\');
+        if !path.split('/').all(plain) {
+            return None;
+        }
+        let path = if self.path.is_empty() {
+            path.to_string()
+        } else {
+            format!("{}/{path}", self.path)
+        };
+        Some(SharedPath {
+            dir: self.dir.clone(),
+            path,
+        })
+    }
+
+    fn lookup<T: Clone>(&self, get: impl FnOnce(&SharedDirCache) -> Option<&T>) -> Option<T> {
+        let mut cache = self.dir.inner.cache.lock().unwrap();
+        let ret = get(&cache).cloned();
+        match ret {
+            Some(_) => cache.stats.hits += 1,
+            None => cache.stats.misses += 1,
+        }
+        ret
+    }
+
+    fn opened(&self) -> Option<Opened> {
+        self.lookup(|cache| cache.opened.get(&self.path))
+    }
+
+    fn insert_opened(&self, opened: Opened) {
+        let mut cache = self.dir.inner.cache.lock().unwrap();
+        cache.opened.insert(self.path.clone(), opened);
+    }
+}
+
 #[derive(Clone)]
 pub struct Dir {
     /// The operating system file descriptor this struct is mediating access
@@ -787,6 +941,8 @@ pub struct Dir {
     pub open_mode: OpenMode,
 
     pub(crate) allow_blocking_current_thread: bool,
+    /// Where this directory is, if it's beneath a [`SharedDir`].
+    shared: Option<SharedPath>,
 }
 
 impl Dir {
@@ -803,6 +959,25 @@ impl Dir {
             file_perms,
             open_mode,
             allow_blocking_current_thread,
+            shared: None,
+        }
+    }
+
+    /// Returns the cached entries of this directory, if it's beneath a
+    /// [`SharedDir`] and they've been read before.
+    pub(crate) fn cached_entries(&self) -> Option<Arc<[(cap_std::fs::FileType, String)]>> {
+        let shared = self.shared.as_ref()?;
+        shared.lookup(|cache| cache.listings.get(&shared.path))
+    }
+
+    /// Caches the entries of this directory if it's beneath a [`SharedDir`].
+    pub(crate) fn cache_entries(
+        &self,
+        entries: impl FnOnce() -> Arc<[(cap_std::fs::FileType, String)]>,
+    ) {
+        if let Some(shared) = &self.shared {
+            let mut cache = shared.dir.inner.cache.lock().unwrap();
+            cache.listings.insert(shared.path.clone(), entries());
         }
     }
 
@@ -1012,6 +1187,16 @@ impl Dir {
             return Err(ErrorCode::NotPermitted);
         }
 
+        // Beneath a `SharedDir` nothing can be opened for writing, so all
+        // opens of the same path are equivalent and can share a handle.
+        let shared = match &self.shared {
+            Some(shared) if path_flags.contains(PathFlags::SYMLINK_FOLLOW) => shared.join(&path),
+            _ => None,
+        };
+        if let Some(opened) = shared.as_ref().and_then(|s| s.opened()) {
+            return self.opened_shared(opened, shared, oflags, allow_blocking_current_thread);
+        }
+
         // Represents each possible outcome from the spawn_blocking operation.
         // This makes sure we don't have to give spawn_blocking any way to
         // manipulate the table.
@@ -1049,6 +1234,18 @@ impl Dir {
                 Err(ErrorCode::IsDirectory)
             }
 
+            OpenResult::Dir(dir) if shared.is_some() => {
+                let opened = Opened::Dir(Arc::new(dir));
+                shared.as_ref().unwrap().insert_opened(opened.clone());
+                self.opened_shared(opened, shared, oflags, allow_blocking_current_thread)
+            }
+
+            OpenResult::File(file) if shared.is_some() => {
+                let opened = Opened::File(Arc::new(file));
+                shared.as_ref().unwrap().insert_opened(opened.clone());
+                self.opened_shared(opened, shared, oflags, allow_blocking_current_thread)
+            }
+
             OpenResult::Dir(dir) => Ok(Descriptor::Dir(Dir::new(
                 dir,
                 self.perms,
@@ -1068,6 +1265,36 @@ impl Dir {
         }
     }
 
+    /// Creates a descriptor for a file or directory opened beneath a
+    /// [`SharedDir`], which is always opened only for reading.
+    fn opened_shared(
+        &self,
+        opened: Opened,
+        shared: Option<SharedPath>,
+        oflags: OpenFlags,
+        allow_blocking_current_thread: bool,
+    ) -> Result<Descriptor, ErrorCode> {
+        match opened {
+            Opened::Dir(dir) => Ok(Descriptor::Dir(Dir {
+                dir,
+                perms: self.perms,
+                file_perms: self.file_perms,
+                open_mode: OpenMode::READ,
+                allow_blocking_current_thread,
+                shared,
+            })),
+            Opened::File(_) if oflags.contains(OpenFlags::DIRECTORY) => {
+                Err(ErrorCode::NotDirectory)
+            }
+            Opened::File(file) => Ok(Descriptor::File(File {
+                file,
+                perms: self.file_perms,
+                open_mode: OpenMode::READ,
+                allow_blocking_current_thread,
+            })),
+        }
+    }
+
     pub(crate) async fn readlink_at(&self, path: String) -> Result<String, ErrorCode> {
         if !self.perms.contains(DirPerms::READ) {
             return Err(ErrorCode::NotPermitted);
@@ -1160,7 +1387,7 @@ impl WasiFilesystemCtxView<'_> {
         for (dir, name) in preopens {
             let fd = self
                 .table
-                .push(Descriptor::Dir(dir))
+                .push(dir)
                 .with_context(|| format!("failed to push preopen {name}"))?;
             results.push((fd, name));
         }
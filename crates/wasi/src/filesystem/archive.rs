@@ -0,0 +1,423 @@
+//! A read-only filesystem backed by a packed archive held in memory, see
+//! [`Archive`].
+
+use super::{
+    Descriptor, DescriptorFlags, DescriptorStat, DescriptorType, ErrorCode, MetadataHashValue,
+    OpenFlags,
+};
+use bytes::Bytes;
+use std::collections::BTreeMap;
+use std::io;
+use std::path::Path;
+use std::sync::Arc;
+
+/// The magic bytes at the start of every archive.
+const MAGIC: &[u8; 8] = b"wasiarc1";
+
+/// A read-only tree of files packed into a single buffer, which can be
+/// preopened with
+/// [`WasiCtxBuilder::preopened_archive`](crate::WasiCtxBuilder::preopened_archive).
+///
+/// Guests read the files of an archive straight out of its buffer, without
+/// any filesystem calls on the host, and archives are cheap to clone and can
+/// be preopened by any number of contexts at once. Archives are created with
+/// [`ArchiveBuilder`] and are laid out as:
+///
+/// * the 8 bytes `wasiarc1`,
+/// * the number of files, as a little-endian `u32`,
+/// * for each file, the length of its path as a little-endian `u32`, its
+///   `/`-separated UTF-8 path, and the offset from the start of the archive
+///   and length of its contents as little-endian `u64`s,
+/// * the contents of the files.
+///
+/// Directories are implied by the paths of the files within them.
+#[derive(Clone)]
+pub struct Archive {
+    inner: Arc<ArchiveInner>,
+}
+
+struct ArchiveInner {
+    /// Every file and directory, with the root directory first.
+    nodes: Vec<Node>,
+}
+
+struct Node {
+    /// The directory containing this node, which is the root for the root.
+    parent: usize,
+    kind: NodeKind,
+}
+
+impl Node {
+    fn descriptor_type(&self) -> DescriptorType {
+        match self.kind {
+            NodeKind::Dir(_) => DescriptorType::Directory,
+            NodeKind::File(_) => DescriptorType::RegularFile,
+        }
+    }
+}
+
+enum NodeKind {
+    Dir(BTreeMap<String, usize>),
+    File(Bytes),
+}
+
+impl Archive {
+    /// Creates an archive from its packed representation in `data`.
+    ///
+    /// The contents of files are slices of `data`, which isn't copied.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `data` isn't a valid archive.
+    pub fn new(data: impl Into<Bytes>) -> io::Result<Archive> {
+        let data = data.into();
+        let nodes = parse(&data).map_err(|msg| {
+            io::Error::new(
+                io::ErrorKind::InvalidData,
+                format!("invalid archive: {msg}"),
+            )
+        })?;
+        Ok(Archive {
+            inner: Arc::new(ArchiveInner { nodes }),
+        })
+    }
+
+    /// Opens the archive at `path`.
+    ///
+    /// On Unix the file is mapped into memory rather than read, so that only
+    /// the parts of it which are read by guests are loaded from disk. The file
+    /// must not be modified while the archive is alive.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the file can't be read or isn't a valid archive.
+    pub fn open(path: impl AsRef<Path>) -> io::Result<Archive> {
+        #[cfg(unix)]
+        {
+            Archive::new(Mmap::new(&std::fs::File::open(path)?)?)
+        }
+        #[cfg(not(unix))]
+        {
+            Archive::new(std::fs::read(path)?)
+        }
+    }
+
+    pub(crate) fn root(&self) -> ArchiveNode {
+        ArchiveNode {
+            archive: self.clone(),
+            index: 0,
+        }
+    }
+}
+
+fn parse(data: &Bytes) -> Result<Vec<Node>, &'static str> {
+    fn take<'a>(data: &mut &'a [u8], n: usize) -> Result<&'a [u8], &'static str> {
+        if data.len() < n {
+            return Err("unexpected end of index");
+        }
+        let (ret, rest) = data.split_at(n);
+        *data = rest;
+        Ok(ret)
+    }
+    fn u32(data: &mut &[u8]) -> Result<u32, &'static str> {
+        Ok(u32::from_le_bytes(take(data, 4)?.try_into().unwrap()))
+    }
+    fn u64(data: &mut &[u8]) -> Result<u64, &'static str> {
+        Ok(u64::from_le_bytes(take(data, 8)?.try_into().unwrap()))
+    }
+
+    let mut index = &data[..];
+    if take(&mut index, MAGIC.len())? != MAGIC {
+        return Err("bad magic");
+    }
+    let mut nodes = vec![Node {
+        parent: 0,
+        kind: NodeKind::Dir(BTreeMap::new()),
+    }];
+    for _ in 0..u32(&mut index)? {
+        let len = u32(&mut index)?;
+        let path = take(&mut index, len as usize)?;
+        let path = core::str::from_utf8(path).map_err(|_| "path isn't UTF-8")?;
+        let offset = u64(&mut index)?;
+        let len = u64(&mut index)?;
+        let contents = offset
+            .checked_add(len)
+            .and_then(|end| usize::try_from(end).ok())
+            .filter(|end| *end <= data.len())
+            .map(|end| data.slice(offset as usize..end))
+            .ok_or("file contents out of bounds")?;
+
+        let mut components = path.split('/').peekable();
+        let mut dir = 0;
+        while let Some(name) = components.next() {
+            if name.is_empty() || name == "." || name == ".." {
+                return Err("invalid path");
+            }
+            let kind = if components.peek().is_some() {
+                NodeKind::Dir(BTreeMap::new())
+            } else {
+                NodeKind::File(contents.clone())
+            };
+            let next = nodes.len();
+            let NodeKind::Dir(children) = &mut nodes[dir].kind else {
+                return Err("file used as a directory");
+            };
+            dir = match children.get(name) {
+                Some(_) if matches!(kind, NodeKind::File(_)) => return Err("duplicate path"),
+                Some(child) => *child,
+                None => {
+                    children.insert(name.to_string(), next);
+                    nodes.push(Node { parent: dir, kind });
+                    next
+                }
+            };
+        }
+    }
+    Ok(nodes)
+}
+
+/// Builds the packed representation of an [`Archive`].
+#[derive(Default)]
+pub struct ArchiveBuilder {
+    files: Vec<(String, Vec<u8>)>,
+}
+
+impl ArchiveBuilder {
+    /// Creates a new builder for an empty archive.
+    pub fn new() -> ArchiveBuilder {
+        ArchiveBuilder::default()
+    }
+
+    /// Adds a file at the `/`-separated `path` with the given `contents`.
+    pub fn file(&mut self, path: impl Into<String>, contents: impl Into<Vec<u8>>) -> &mut Self {
+        self.files.push((path.into(), contents.into()));
+        self
+    }
+
+    /// Returns the packed archive, which can be written to disk to later be
+    /// opened with [`Archive::open`] or passed to [`Archive::new`].
+    pub fn finish(&self) -> Vec<u8> {
+        let index_len = MAGIC.len()
+            + 4
+            + self
+                .files
+                .iter()
+                .map(|(path, _)| 4 + path.len() + 16)
+                .sum::<usize>();
+        let mut out =
+            Vec::with_capacity(index_len + self.files.iter().map(|(_, c)| c.len()).sum::<usize>());
+        out.extend_from_slice(MAGIC);
+        out.extend_from_slice(&u32::try_from(self.files.len()).unwrap().to_le_bytes());
+        let mut offset = index_len as u64;
+        for (path, contents) in &self.files {
+            out.extend_from_slice(&u32::try_from(path.len()).unwrap().to_le_bytes());
+            out.extend_from_slice(path.as_bytes());
+            out.extend_from_slice(&offset.to_le_bytes());
+            out.extend_from_slice(&(contents.len() as u64).to_le_bytes());
+            offset += contents.len() as u64;
+        }
+        for (_, contents) in &self.files {
+            out.extend_from_slice(contents);
+        }
+        out
+    }
+}
+
+/// A file or directory within an [`Archive`], which is what the descriptors
+/// of archives refer to.
+#[derive(Clone)]
+pub struct ArchiveNode {
+    archive: Archive,
+    index: usize,
+}
+
+impl ArchiveNode {
+    fn node(&self) -> &Node {
+        &self.archive.inner.nodes[self.index]
+    }
+
+    fn at(&self, index: usize) -> ArchiveNode {
+        ArchiveNode {
+            archive: self.archive.clone(),
+            index,
+        }
+    }
+
+    pub(crate) fn is_dir(&self) -> bool {
+        matches!(self.node().kind, NodeKind::Dir(_))
+    }
+
+    /// Returns the contents of this node if it's a file.
+    pub(crate) fn contents(&self) -> Result<&Bytes, ErrorCode> {
+        match &self.node().kind {
+            NodeKind::File(contents) => Ok(contents),
+            NodeKind::Dir(_) => Err(ErrorCode::IsDirectory),
+        }
+    }
+
+    /// Returns the names and types of the entries of this directory, in
+    /// order of name.
+    pub(crate) fn entries(&self) -> Result<Vec<(DescriptorType, String)>, ErrorCode> {
+        let NodeKind::Dir(children) = &self.node().kind else {
+            return Err(ErrorCode::NotDirectory);
+        };
+        Ok(children
+            .iter()
+            .map(|(name, child)| {
+                let child = &self.archive.inner.nodes[*child];
+                (child.descriptor_type(), name.clone())
+            })
+            .collect())
+    }
+
+    /// Looks up `path` relative to this directory, which can't resolve to
+    /// anything outside of it.
+    pub(crate) fn lookup(&self, path: &str) -> Result<ArchiveNode, ErrorCode> {
+        if path.is_empty() {
+            return Err(ErrorCode::NoEntry);
+        }
+        if path.starts_with('/') {
+            return Err(ErrorCode::NotPermitted);
+        }
+        let nodes = &self.archive.inner.nodes;
+        let mut depth = 0;
+        let mut node = self.index;
+        for name in path.split('/') {
+            let NodeKind::Dir(children) = &nodes[node].kind else {
+                return Err(ErrorCode::NotDirectory);
+            };
+            match name {
+                "" | "." => {}
+                ".." if depth == 0 => return Err(ErrorCode::NotPermitted),
+                ".." => {
+                    depth -= 1;
+                    node = nodes[node].parent;
+                }
+                _ => {
+                    depth += 1;
+                    node = *children.get(name).ok_or(ErrorCode::NoEntry)?;
+                }
+            }
+        }
+        Ok(self.at(node))
+    }
+
+    /// Opens `path` relative to this directory, which can only be done for
+    /// reading.
+    pub(crate) fn open_at(
+        &self,
+        path: &str,
+        oflags: OpenFlags,
+        flags: DescriptorFlags,
+    ) -> Result<Descriptor, ErrorCode> {
+        if oflags.intersects(OpenFlags::CREATE | OpenFlags::TRUNCATE)
+            || flags.intersects(DescriptorFlags::WRITE | DescriptorFlags::MUTATE_DIRECTORY)
+        {
+            return Err(ErrorCode::NotPermitted);
+        }
+        let node = self.lookup(path)?;
+        if !node.is_dir() && oflags.contains(OpenFlags::DIRECTORY) {
+            return Err(ErrorCode::NotDirectory);
+        }
+        Ok(Descriptor::Archive(node))
+    }
+
+    pub(crate) fn stat(&self) -> DescriptorStat {
+        DescriptorStat {
+            type_: self.node().descriptor_type(),
+            link_count: 1,
+            size: match &self.node().kind {
+                NodeKind::File(contents) => contents.len() as u64,
+                NodeKind::Dir(_) => 0,
+            },
+            data_access_timestamp: None,
+            data_modification_timestamp: None,
+            status_change_timestamp: None,
+        }
+    }
+
+    pub(crate) fn metadata_hash(&self) -> MetadataHashValue {
+        use std::collections::hash_map::DefaultHasher;
+        use std::hash::Hasher;
+        let mut hasher = DefaultHasher::new();
+        hasher.write_usize(Arc::as_ptr(&self.archive.inner) as usize);
+        hasher.write_usize(self.index);
+        let lower = hasher.finish();
+        // See the `From<&cap_std::fs::Metadata>` implementation for this
+        // constant.
+        let upper = lower ^ 4614256656552045848u64;
+        MetadataHashValue { lower, upper }
+    }
+
+    pub(crate) fn is_same_object(&self, other: &ArchiveNode) -> bool {
+        Arc::ptr_eq(&self.archive.inner, &other.archive.inner) && self.index == other.index
+    }
+}
+
+/// A read-only mapping of a whole file.
+#[cfg(unix)]
+struct Mmap {
+    ptr: *mut core::ffi::c_void,
+    len: usize,
+}
+
+// SAFETY: the mapping is read-only and is only unmapped when dropped.
+#[cfg(unix)]
+unsafe impl Send for Mmap {}
+#[cfg(unix)]
+unsafe impl Sync for Mmap {}
+
+#[cfg(unix)]
+impl Mmap {
+    fn new(file: &std::fs::File) -> io::Result<Mmap> {
+        use rustix::mm::{MapFlags, ProtFlags, mmap};
+        let len = usize::try_from(file.metadata()?.len())
+            .map_err(|_| io::Error::from(io::ErrorKind::OutOfMemory))?;
+        if len == 0 {
+            return Ok(Mmap {
+                ptr: core::ptr::NonNull::dangling().as_ptr(),
+                len,
+            });
+        }
+        // SAFETY: a new mapping is created, which doesn't alias anything.
+        let ptr = unsafe {
+            mmap(
+                core::ptr::null_mut(),
+                len,
+                ProtFlags::READ,
+                MapFlags::PRIVATE,
+                file,
+                0,
+            )?
+        };
+        Ok(Mmap { ptr, len })
+    }
+}
+
+#[cfg(unix)]
+impl AsRef<[u8]> for Mmap {
+    fn as_ref(&self) -> &[u8] {
+        // SAFETY: `ptr` is valid for `len` bytes until dropped.
+        unsafe { core::slice::from_raw_parts(self.ptr.cast(), self.len) }
+    }
+}
+
+#[cfg(unix)]
+impl Drop for Mmap {
+    fn drop(&mut self) {
+        if self.len > 0 {
+            // SAFETY: this mapping was created in `Mmap::new`, and no slices
+            // of it outlive `self`.
+            unsafe {
+                rustix::mm::munmap(self.ptr, self.len).unwrap();
+            }
+        }
+    }
+}
+
+#[cfg(unix)]
+impl From<Mmap> for Bytes {
+    fn from(mmap: Mmap) -> Bytes {
+        Bytes::from_owner(mmap)
+    }
+}
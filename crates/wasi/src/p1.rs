@@ -75,6 +75,7 @@ use crate::p2::bindings::{
 use crate::p2::{FsError, IsATTY};
 use crate::{ResourceTable, WasiCtx, WasiCtxView, WasiView};
 use std::collections::{BTreeMap, BTreeSet, HashSet, btree_map};
+use std::io::IoSlice;
 use std::mem::{self, size_of, size_of_val};
 use std::slice;
 use std::sync::Arc;
@@ -92,7 +93,6 @@ use wiggle::{GuestError, GuestMemory, GuestPtr, GuestType};
 // Bring all WASI traits in scope that this implementation builds on.
 use crate::p2::bindings::cli::environment::Host as _;
 use crate::p2::bindings::filesystem::types::HostDescriptor as _;
-use crate::p2::bindings::random::random::Host as _;
 use wasmtime_wasi_io::bindings::wasi::io::poll::Host as _;
 
 /// Structure containing state for WASIp1.
@@ -153,6 +153,34 @@ impl WasiP1Ctx {
             adapter: WasiP1Adapter::new(),
         }
     }
+
+    /// Returns how many of the bytes read and written by `fd_read`,
+    /// `fd_write` and `fd_pwrite` went directly between wasm memory and the
+    /// host, and how many were copied through intermediate buffers.
+    ///
+    /// Writes pass through when wasm memory isn't shared and either the
+    /// descriptor is a file and
+    /// [`WasiCtxBuilder::allow_blocking_current_thread`] is enabled, or
+    /// it's stdout or stderr and the stream supports
+    /// [`OutputStream::blocking_write_vectored`], as the host's stdio does.
+    /// Reads of files pass through under the same conditions.
+    ///
+    /// [`WasiCtxBuilder::allow_blocking_current_thread`]: crate::WasiCtxBuilder::allow_blocking_current_thread
+    /// [`OutputStream::blocking_write_vectored`]: wasmtime_wasi_io::streams::OutputStream::blocking_write_vectored
+    pub fn io_stats(&self) -> IoStats {
+        self.adapter.io_stats
+    }
+}
+
+/// Counts of bytes transferred by WASIp1 reads and writes, returned by
+/// [`WasiP1Ctx::io_stats`].
+#[derive(Copy, Clone, Debug, Default, PartialEq, Eq)]
+pub struct IoStats {
+    /// Bytes passed directly between wasm memory and the host, for example
+    /// with a single `writev` of all of a guest's buffers.
+    pub passed_through: u64,
+    /// Bytes copied between wasm memory and an intermediate host buffer.
+    pub copied: u64,
 }
 
 impl WasiView for WasiP1Ctx {
@@ -271,6 +299,7 @@ enum Descriptor {
 #[derive(Debug, Default)]
 struct WasiP1Adapter {
     descriptors: Option<Descriptors>,
+    io_stats: IoStats,
 }
 
 #[derive(Debug, Default)]
@@ -577,31 +606,49 @@ impl WasiP1Ctx {
                 let append = *append;
                 drop(t);
                 let f = self.table.get(&fd)?.file()?;
-                let buf = first_non_empty_ciovec(memory, ciovs)?;
 
-                let do_write = move |f: &cap_std::fs::File, buf: &[u8]| match (append, write) {
-                    // Note that this is implementing Linux semantics of
-                    // `pwrite` where the offset is ignored if the file was
-                    // opened in append mode.
-                    (true, _) => f.append(&buf),
-                    (false, FdWrite::At(pos)) => f.write_at(&buf, pos),
-                    (false, FdWrite::AtCur) => f.write_at(&buf, pos),
-                };
+                let do_write =
+                    move |f: &cap_std::fs::File, bufs: &[IoSlice<'_>]| match (append, write) {
+                        // Note that this is implementing Linux semantics of
+                        // `pwrite` where the offset is ignored if the file was
+                        // opened in append mode.
+                        (true, _) => f.append_vectored(bufs),
+                        (false, FdWrite::At(pos)) => f.write_vectored_at(bufs, pos),
+                        (false, FdWrite::AtCur) => f.write_vectored_at(bufs, pos),
+                    };
 
-                let nwritten = match f.as_blocking_file() {
-                    // If we can block then skip the copy out of wasm memory and
-                    // write directly to `f`.
-                    Some(f) => do_write(f, &memory.as_cow(buf)?),
-                    // ... otherwise copy out of wasm memory and use
-                    // `spawn_blocking` to do this write in a thread that can
-                    // block.
-                    None => {
-                        let buf = memory.to_vec(buf)?;
-                        f.run_blocking(move |f| do_write(f, &buf)).await
+                let slices = ciovec_slices(memory, ciovs)?;
+                let (nwritten, copied) = match (f.as_blocking_file(), slices) {
+                    // If we can block, and wasm memory isn't shared, then
+                    // skip the copy out of wasm memory and write all of the
+                    // buffers directly to `f`.
+                    (Some(f), Some(bufs)) => {
+                        let bufs = bufs.iter().map(|b| IoSlice::new(b)).collect::<Vec<_>>();
+                        (do_write(f, &bufs), false)
+                    }
+                    // ... otherwise copy the first buffer out of wasm memory
+                    // and, if necessary, use `spawn_blocking` to do this write
+                    // in a thread that can block.
+                    (blocking_file, _) => {
+                        let buf = memory.to_vec(first_non_empty_ciovec(memory, ciovs)?)?;
+                        let nwritten = match blocking_file {
+                            Some(f) => do_write(f, &[IoSlice::new(&buf)]),
+                            None => {
+                                f.run_blocking(move |f| do_write(f, &[IoSlice::new(&buf)]))
+                                    .await
+                            }
+                        };
+                        (nwritten, true)
                     }
                 };
 
                 let nwritten = nwritten.map_err(|e| StreamError::LastOperationFailed(e.into()))?;
+                let stats = &mut self.adapter.io_stats;
+                if copied {
+                    stats.copied += nwritten as u64;
+                } else {
+                    stats.passed_through += nwritten as u64;
+                }
 
                 // If this was a write at the current position then update the
                 // current position with the result, otherwise the current
@@ -628,12 +675,23 @@ impl WasiP1Ctx {
                 }
                 let stream = stream.borrowed();
                 drop(t);
+                // Write all of the buffers directly from wasm memory if both
+                // it and the stream allow it...
+                if let Some(bufs) = ciovec_slices(memory, ciovs)? {
+                    let stream = self.table.get_mut(&stream)?;
+                    if let Some(n) = stream.blocking_write_vectored(&bufs) {
+                        let n = n?;
+                        self.adapter.io_stats.passed_through += n as u64;
+                        return Ok(n.try_into()?);
+                    }
+                }
+                // ... otherwise copy the first buffer into the stream.
                 let buf = first_non_empty_ciovec(memory, ciovs)?;
                 let n = BlockingMode::Blocking
                     .write(memory, &mut self.table, stream, buf)
-                    .await?
-                    .try_into()?;
-                Ok(n)
+                    .await?;
+                self.adapter.io_stats.copied += n as u64;
+                Ok(n.try_into()?)
             }
             _ => Err(types::Errno::Badf.into()),
         }
@@ -1112,6 +1170,26 @@ fn read_string<'a>(memory: &'a GuestMemory<'_>, ptr: GuestPtr<str>) -> Result<St
 
 // Returns the first non-empty buffer in `ciovs` or a single empty buffer if
 // they're all empty.
+// Returns the non-empty buffers in `ciovs` as slices of wasm memory, or
+// `None` if wasm memory is shared and can't be borrowed.
+fn ciovec_slices<'a>(
+    memory: &'a GuestMemory<'_>,
+    ciovs: types::CiovecArray,
+) -> Result<Option<Vec<&'a [u8]>>> {
+    let mut slices = Vec::new();
+    for iov in ciovs.iter() {
+        let iov = memory.read(iov?)?;
+        if iov.buf_len == 0 {
+            continue;
+        }
+        match memory.as_slice(iov.buf.as_array(iov.buf_len))? {
+            Some(slice) => slices.push(slice),
+            None => return Ok(None),
+        }
+    }
+    Ok(Some(slices))
+}
+
 fn first_non_empty_ciovec(
     memory: &GuestMemory<'_>,
     ciovs: types::CiovecArray,
@@ -1643,33 +1721,53 @@ impl wasi_snapshot_preview1::WasiSnapshotPreview1 for WasiP1Ctx {
                 let position = position.clone();
                 drop(t);
                 let pos = position.load(Ordering::Relaxed);
-                let file = self.table.get(&fd)?.file()?;
                 let iov = first_non_empty_iovec(memory, iovs)?;
-                let bytes_read = match (file.as_blocking_file(), memory.as_slice_mut(iov)?) {
-                    // Try to read directly into wasm memory where possible
-                    // when the current thread can block and additionally wasm
-                    // memory isn't shared.
-                    (Some(file), Some(mut buf)) => file
-                        .read_at(&mut buf, pos)
-                        .map_err(|e| StreamError::LastOperationFailed(e.into()))?,
-                    // ... otherwise fall back to performing the read on a
-                    // blocking thread and which copies the data back into wasm
-                    // memory.
-                    (_, buf) => {
-                        drop(buf);
-                        let mut buf = vec![0; iov.len() as usize];
-                        let buf = file
-                            .run_blocking(move |file| -> Result<_, types::Error> {
-                                let bytes_read = file
-                                    .read_at(&mut buf, pos)
-                                    .map_err(|e| StreamError::LastOperationFailed(e.into()))?;
-                                buf.truncate(bytes_read);
-                                Ok(buf)
-                            })
-                            .await?;
-                        let iov = iov.get_range(0..u32::try_from(buf.len())?).unwrap();
-                        memory.copy_from_slice(&buf, iov)?;
-                        buf.len()
+                let desc = self.table.get(&fd)?;
+                let bytes_read = if let crate::filesystem::Descriptor::Archive(a) = desc {
+                    // Files in archives are copied straight out of the
+                    // archive into wasm memory.
+                    let contents = a.contents()?;
+                    let start = usize::try_from(pos)
+                        .unwrap_or(usize::MAX)
+                        .min(contents.len());
+                    let n = (contents.len() - start).min(iov.len() as usize);
+                    let iov = iov.get_range(0..u32::try_from(n)?).unwrap();
+                    memory.copy_from_slice(&contents[start..][..n], iov)?;
+                    self.adapter.io_stats.passed_through += n as u64;
+                    n
+                } else {
+                    let file = desc.file()?;
+                    match (file.as_blocking_file(), memory.as_slice_mut(iov)?) {
+                        // Try to read directly into wasm memory where possible
+                        // when the current thread can block and additionally wasm
+                        // memory isn't shared.
+                        (Some(file), Some(mut buf)) => {
+                            let n = file
+                                .read_at(&mut buf, pos)
+                                .map_err(|e| StreamError::LastOperationFailed(e.into()))?;
+                            self.adapter.io_stats.passed_through += n as u64;
+                            n
+                        }
+                        // ... otherwise fall back to performing the read on a
+                        // blocking thread and which copies the data back into wasm
+                        // memory.
+                        (_, buf) => {
+                            drop(buf);
+                            let mut buf = vec![0; iov.len() as usize];
+                            let buf = file
+                                .run_blocking(move |file| -> Result<_, types::Error> {
+                                    let bytes_read = file
+                                        .read_at(&mut buf, pos)
+                                        .map_err(|e| StreamError::LastOperationFailed(e.into()))?;
+                                    buf.truncate(bytes_read);
+                                    Ok(buf)
+                                })
+                                .await?;
+                            let iov = iov.get_range(0..u32::try_from(buf.len())?).unwrap();
+                            memory.copy_from_slice(&buf, iov)?;
+                            self.adapter.io_stats.copied += buf.len() as u64;
+                            buf.len()
+                        }
                     }
                 };
 
@@ -1692,6 +1790,7 @@ impl wasi_snapshot_preview1::WasiSnapshotPreview1 for WasiP1Ctx {
                 }
                 let buf = buf.get_range(0..u32::try_from(read.len())?).unwrap();
                 memory.copy_from_slice(&read, buf)?;
+                self.adapter.io_stats.copied += read.len() as u64;
                 let n = read.len().try_into()?;
                 Ok(n)
             }
@@ -2159,17 +2258,23 @@ impl wasi_snapshot_preview1::WasiSnapshotPreview1 for WasiP1Ctx {
             .open_at(dirfd, dirflags.into(), path, oflags.into(), flags)
             .await?;
         let mut t = self.transact()?;
-        let desc = match t.view.table.get(&fd)? {
-            crate::filesystem::Descriptor::Dir(_) => Descriptor::Directory {
+        let is_dir = match t.view.table.get(&fd)? {
+            crate::filesystem::Descriptor::Dir(_) => true,
+            crate::filesystem::Descriptor::File(_) => false,
+            crate::filesystem::Descriptor::Archive(a) => a.is_dir(),
+        };
+        let desc = if is_dir {
+            Descriptor::Directory {
                 fd,
                 preopen_path: None,
-            },
-            crate::filesystem::Descriptor::File(_) => Descriptor::File(File {
+            }
+        } else {
+            Descriptor::File(File {
                 fd,
                 position: Default::default(),
                 append: fdflags.contains(types::Fdflags::APPEND),
                 blocking_mode: BlockingMode::from_fdflags(&fdflags),
-            }),
+            })
         };
         let fd = t.descriptors.push(desc)?;
         Ok(fd.into())
@@ -2564,13 +2669,17 @@ impl wasi_snapshot_preview1::WasiSnapshotPreview1 for WasiP1Ctx {
         buf: GuestPtr<u8>,
         buf_len: types::Size,
     ) -> Result<(), types::Error> {
-        let rand = self
-            .wasi
-            .random
-            .get_random_bytes(buf_len.into())
-            .context("failed to call `get-random-bytes`")
-            .map_err(types::Error::trap)?;
-        write_bytes(memory, buf, &rand)?;
+        // Fill wasm memory directly from the generator where possible, which
+        // isn't possible when wasm memory is shared.
+        let buf = buf.as_array(buf_len);
+        match memory.as_slice_mut(buf)? {
+            Some(dst) => self.wasi.random.random.fill_bytes(dst),
+            None => {
+                let mut rand = vec![0; buf_len as usize];
+                self.wasi.random.random.fill_bytes(&mut rand);
+                memory.copy_from_slice(&rand, buf)?;
+            }
+        }
         Ok(())
     }
 
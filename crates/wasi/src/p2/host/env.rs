@@ -3,10 +3,10 @@ use crate::p2::bindings::cli::environment;
 
 impl environment::Host for WasiCliCtxView<'_> {
     fn get_environment(&mut self) -> wasmtime::Result<Vec<(String, String)>> {
-        Ok(self.ctx.environment.clone())
+        Ok(self.ctx.environment.to_vec())
     }
     fn get_arguments(&mut self) -> wasmtime::Result<Vec<String>> {
-        Ok(self.ctx.arguments.clone())
+        Ok(self.ctx.arguments.to_vec())
     }
     fn initial_cwd(&mut self) -> wasmtime::Result<Option<String>> {
         Ok(self.ctx.initial_cwd.clone())
@@ -5,6 +5,7 @@ use crate::p2::bindings::filesystem::types::{
     self, ErrorCode, HostDescriptor, HostDirectoryEntryStream,
 };
 use crate::p2::filesystem::{FileInputStream, FileOutputStream, ReaddirIterator};
+use crate::p2::pipe::MemoryInputPipe;
 use crate::p2::{FsError, FsResult};
 use crate::{DirPerms, FilePerms};
 use wasmtime::component::Resource;
@@ -108,6 +109,17 @@ impl HostDescriptor for WasiFilesystemCtxView<'_> {
         use std::io::IoSliceMut;
         use system_interface::fs::FileIoExt;
 
+        if let Descriptor::Archive(a) = self.table.get(&fd)? {
+            let contents = a.contents()?;
+            let start = usize::try_from(offset)
+                .unwrap_or(usize::MAX)
+                .min(contents.len());
+            let len = usize::try_from(len).unwrap_or(usize::MAX);
+            let buffer = contents[start..][..len.min(contents.len() - start)].to_vec();
+            let state = buffer.is_empty();
+            return Ok((buffer, state));
+        }
+
         let f = self.table.get(&fd)?.file()?;
         if !f.perms.contains(FilePerms::READ) {
             return Err(ErrorCode::NotPermitted.into());
@@ -156,6 +168,20 @@ impl HostDescriptor for WasiFilesystemCtxView<'_> {
         &mut self,
         fd: Resource<types::Descriptor>,
     ) -> FsResult<Resource<types::DirectoryEntryStream>> {
+        if let Descriptor::Archive(a) = self.table.get(&fd)? {
+            let entries = a
+                .entries()?
+                .into_iter()
+                .map(|(type_, name)| {
+                    Ok(types::DirectoryEntry {
+                        type_: type_.into(),
+                        name,
+                    })
+                })
+                .collect::<Vec<FsResult<_>>>();
+            return Ok(self.table.push(ReaddirIterator::new(entries.into_iter()))?);
+        }
+
         let d = self.table.get(&fd)?.dir()?;
         if !d.perms.contains(DirPerms::READ) {
             return Err(ErrorCode::NotPermitted.into());
@@ -171,6 +197,19 @@ impl HostDescriptor for WasiFilesystemCtxView<'_> {
             }
         }
 
+        if let Some(entries) = d.cached_entries() {
+            let entries = entries
+                .iter()
+                .map(|(type_, name)| {
+                    Ok(types::DirectoryEntry {
+                        type_: descriptortype_from(*type_),
+                        name: name.clone(),
+                    })
+                })
+                .collect::<Vec<FsResult<_>>>();
+            return Ok(self.table.push(ReaddirIterator::new(entries.into_iter()))?);
+        }
+
         let entries = d
             .run_blocking(|d| {
                 // Both `entries` and `metadata` perform syscalls, which is why they are done
@@ -181,18 +220,23 @@ impl HostDescriptor for WasiFilesystemCtxView<'_> {
                         .map(|entry| {
                             let entry = entry?;
                             let meta = entry.metadata()?;
-                            let type_ = descriptortype_from(meta.file_type());
                             let name = entry
                                 .file_name()
                                 .into_string()
                                 .map_err(|_| ReaddirError::IllegalSequence)?;
-                            Ok(types::DirectoryEntry { type_, name })
+                            Ok((meta.file_type(), name))
                         })
-                        .collect::<Vec<Result<types::DirectoryEntry, ReaddirError>>>(),
+                        .collect::<Vec<Result<(cap_std::fs::FileType, String), ReaddirError>>>(),
                 )
             })
-            .await?
-            .into_iter();
+            .await?;
+
+        // Listings beneath a `SharedDir` are cached, unless reading them
+        // failed.
+        if entries.iter().all(|entry| entry.is_ok()) {
+            d.cache_entries(|| entries.iter().flatten().cloned().collect());
+        }
+        let entries = entries.into_iter();
 
         // On windows, filter out files like `C:\DumpStack.log.tmp` which we
         // can't get full metadata for.
@@ -209,7 +253,10 @@ impl HostDescriptor for WasiFilesystemCtxView<'_> {
             true
         });
         let entries = entries.map(|r| match r {
-            Ok(r) => Ok(r),
+            Ok((type_, name)) => Ok(types::DirectoryEntry {
+                type_: descriptortype_from(type_),
+                name,
+            }),
             Err(ReaddirError::Io(e)) => Err(e.into()),
             Err(ReaddirError::IllegalSequence) => Err(ErrorCode::IllegalByteSequence.into()),
         });
@@ -244,6 +291,10 @@ impl HostDescriptor for WasiFilesystemCtxView<'_> {
         path_flags: types::PathFlags,
         path: String,
     ) -> FsResult<types::DescriptorStat> {
+        if let Descriptor::Archive(a) = self.table.get(&fd)? {
+            return Ok(a.lookup(&path)?.stat().try_into()?);
+        }
+
         let d = self.table.get(&fd)?.dir()?;
         let stat = d.stat_at(path_flags.into(), path).await?;
         Ok(stat.try_into()?)
@@ -289,6 +340,11 @@ impl HostDescriptor for WasiFilesystemCtxView<'_> {
         oflags: types::OpenFlags,
         flags: types::DescriptorFlags,
     ) -> FsResult<Resource<types::Descriptor>> {
+        if let Descriptor::Archive(a) = self.table.get(&fd)? {
+            let fd = a.open_at(&path, oflags.into(), flags.into())?;
+            return Ok(self.table.push(fd)?);
+        }
+
         let d = self.table.get(&fd)?.dir()?;
         let fd = d
             .open_at(
@@ -319,6 +375,12 @@ impl HostDescriptor for WasiFilesystemCtxView<'_> {
         fd: Resource<types::Descriptor>,
         path: String,
     ) -> FsResult<String> {
+        if let Descriptor::Archive(a) = self.table.get(&fd)? {
+            // Archives don't contain symbolic links.
+            a.lookup(&path)?;
+            return Err(ErrorCode::Invalid.into());
+        }
+
         let d = self.table.get(&fd)?.dir()?;
         let path = d.readlink_at(path).await?;
         Ok(path)
@@ -374,14 +436,26 @@ impl HostDescriptor for WasiFilesystemCtxView<'_> {
         offset: types::Filesize,
     ) -> FsResult<Resource<DynInputStream>> {
         // Trap if fd lookup fails:
-        let f = self.table.get(&fd)?.file()?;
+        let reader: DynInputStream = match self.table.get(&fd)? {
+            // Archive files are streamed straight out of the archive.
+            Descriptor::Archive(a) => {
+                let contents = a.contents()?;
+                let start = usize::try_from(offset)
+                    .unwrap_or(usize::MAX)
+                    .min(contents.len());
+                Box::new(MemoryInputPipe::new(contents.slice(start..)))
+            }
+            d => {
+                let f = d.file()?;
 
-        if !f.perms.contains(FilePerms::READ) {
-            Err(types::ErrorCode::BadDescriptor)?;
-        }
+                if !f.perms.contains(FilePerms::READ) {
+                    Err(types::ErrorCode::BadDescriptor)?;
+                }
 
-        // Create a stream view for it.
-        let reader: DynInputStream = Box::new(FileInputStream::new(f, offset));
+                // Create a stream view for it.
+                Box::new(FileInputStream::new(f, offset))
+            }
+        };
 
         // Insert the stream view into the table. Trap if the table is full.
         let index = self.table.push(reader)?;
@@ -455,6 +529,10 @@ impl HostDescriptor for WasiFilesystemCtxView<'_> {
         path_flags: types::PathFlags,
         path: String,
     ) -> FsResult<types::MetadataHashValue> {
+        if let Descriptor::Archive(a) = self.table.get(&fd)? {
+            return Ok(a.lookup(&path)?.metadata_hash().into());
+        }
+
         let d = self.table.get(&fd)?.dir()?;
         let meta = d.metadata_hash_at(path_flags.into(), path).await?;
         Ok(meta.into())
@@ -4,10 +4,9 @@ use cap_rand::{Rng, distributions::Standard};
 
 impl random::Host for WasiRandomCtx {
     fn get_random_bytes(&mut self, len: u64) -> wasmtime::Result<Vec<u8>> {
-        Ok((&mut self.random)
-            .sample_iter(Standard)
-            .take(len as usize)
-            .collect())
+        let mut bytes = vec![0; len as usize];
+        self.random.fill_bytes(&mut bytes);
+        Ok(bytes)
     }
 
     fn get_random_u64(&mut self) -> wasmtime::Result<u64> {
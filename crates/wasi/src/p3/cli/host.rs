@@ -268,11 +268,11 @@ impl stderr::Host for WasiCliCtxView<'_> {}
 
 impl environment::Host for WasiCliCtxView<'_> {
     fn get_environment(&mut self) -> wasmtime::Result<Vec<(String, String)>> {
-        Ok(self.ctx.environment.clone())
+        Ok(self.ctx.environment.to_vec())
     }
 
     fn get_arguments(&mut self) -> wasmtime::Result<Vec<String>> {
-        Ok(self.ctx.arguments.clone())
+        Ok(self.ctx.arguments.to_vec())
     }
 
     fn get_initial_cwd(&mut self) -> wasmtime::Result<Option<String>> {
@@ -1,9 +1,13 @@
 use crate::store::Ctx;
 use std::path::Path;
+use std::time::Duration;
 use test_programs_artifacts::*;
 use wasmtime::Result;
 use wasmtime::{Linker, Module};
+use wasmtime_wasi::clocks::StepClock;
+use wasmtime_wasi::filesystem::{Archive, ArchiveBuilder, SharedDir, SharedDirStats};
 use wasmtime_wasi::p1::{WasiP1Ctx, add_to_linker_async};
+use wasmtime_wasi::random::Deterministic;
 
 async fn run(path: &str, inherit_stdio: bool) -> Result<()> {
     let path = Path::new(path);
@@ -247,3 +251,222 @@ async fn p1_path_open_lots() {
     reason = "tested in the wasi-cli crate, satisfying foreach_api! macro"
 )]
 fn p1_cli_much_stdout() {}
+
+#[test_log::test(tokio::test(flavor = "multi_thread"))]
+async fn p1_fd_write_vectored_io_stats() -> Result<()> {
+    let engine = test_programs_artifacts::engine(|_config| {});
+    let mut linker = Linker::<Ctx<WasiP1Ctx>>::new(&engine);
+    add_to_linker_async(&mut linker, |t| &mut t.wasi)?;
+
+    // Opens `out.txt` in the preopened directory and writes "hello " and
+    // "world" to it, with an empty buffer in between, in one `fd_write`.
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (import "wasi_snapshot_preview1" "path_open"
+                    (func $path_open (param i32 i32 i32 i32 i32 i64 i64 i32 i32) (result i32)))
+                (import "wasi_snapshot_preview1" "fd_write"
+                    (func $fd_write (param i32 i32 i32 i32) (result i32)))
+                (memory (export "memory") 1)
+                (data (i32.const 0) "out.txt")
+                (data (i32.const 16) "hello ")
+                (data (i32.const 32) "world")
+                (data (i32.const 64) "\10\00\00\00\06\00\00\00\00\00\00\00\00\00\00\00\20\00\00\00\05\00\00\00")
+                (func (export "run") (result i32)
+                    (if (call $path_open (i32.const 3) (i32.const 0) (i32.const 0) (i32.const 7)
+                            (i32.const 1) (i64.const 64) (i64.const 0) (i32.const 0) (i32.const 96))
+                        (then (return (i32.const -1))))
+                    (if (call $fd_write (i32.load (i32.const 96)) (i32.const 64) (i32.const 3)
+                            (i32.const 100))
+                        (then (return (i32.const -2))))
+                    (i32.load (i32.const 100))))
+        "#,
+    )?;
+
+    for allow_blocking in [true, false] {
+        let (mut store, td) = Ctx::new(&engine, "fd_write_vectored", |builder| {
+            builder.allow_blocking_current_thread(allow_blocking);
+            builder.build_p1()
+        })?;
+        let instance = linker.instantiate_async(&mut store, &module).await?;
+        let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+        let nwritten = run.call_async(&mut store, ()).await?;
+        let stats = store.data().wasi.io_stats();
+        let contents = std::fs::read(td.path().join("out.txt"))?;
+        if allow_blocking {
+            // All of the buffers are written directly from wasm memory.
+            assert_eq!(nwritten, 11);
+            assert_eq!(contents, b"hello world");
+            assert_eq!(stats.passed_through, 11);
+            assert_eq!(stats.copied, 0);
+        } else {
+            // Only the first buffer is copied out of wasm memory.
+            assert_eq!(nwritten, 6);
+            assert_eq!(contents, b"hello ");
+            assert_eq!(stats.passed_through, 0);
+            assert_eq!(stats.copied, 6);
+        }
+    }
+    Ok(())
+}
+
+#[test_log::test(tokio::test(flavor = "multi_thread"))]
+async fn p1_shared_dir_cache() -> Result<()> {
+    let engine = test_programs_artifacts::engine(|_config| {});
+    let mut linker = Linker::<Ctx<WasiP1Ctx>>::new(&engine);
+    add_to_linker_async(&mut linker, |t| &mut t.wasi)?;
+
+    // Opens and reads `a.txt` from the shared directory, preopened as fd 4,
+    // and then lists the directory, returning the number of bytes read.
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (import "wasi_snapshot_preview1" "path_open"
+                    (func $path_open (param i32 i32 i32 i32 i32 i64 i64 i32 i32) (result i32)))
+                (import "wasi_snapshot_preview1" "fd_read"
+                    (func $fd_read (param i32 i32 i32 i32) (result i32)))
+                (import "wasi_snapshot_preview1" "fd_readdir"
+                    (func $fd_readdir (param i32 i32 i32 i64 i32) (result i32)))
+                (memory (export "memory") 1)
+                (data (i32.const 0) "a.txt")
+                (data (i32.const 64) "\80\00\00\00\10\00\00\00")
+                (func (export "run") (result i32)
+                    (if (call $path_open (i32.const 4) (i32.const 1) (i32.const 0) (i32.const 5)
+                            (i32.const 0) (i64.const 2) (i64.const 0) (i32.const 0) (i32.const 96))
+                        (then (return (i32.const -1))))
+                    (if (call $fd_read (i32.load (i32.const 96)) (i32.const 64) (i32.const 1)
+                            (i32.const 100))
+                        (then (return (i32.const -2))))
+                    (if (call $fd_readdir (i32.const 4) (i32.const 256) (i32.const 256)
+                            (i64.const 0) (i32.const 104))
+                        (then (return (i32.const -3))))
+                    (i32.load (i32.const 100))))
+        "#,
+    )?;
+
+    let assets = tempfile::tempdir()?;
+    std::fs::write(assets.path().join("a.txt"), "shared")?;
+    let shared = SharedDir::new(assets.path())?;
+
+    for i in 0..3 {
+        let (mut store, _td) = Ctx::new(&engine, "shared_dir_cache", |builder| {
+            builder.preopened_shared_dir(&shared, "assets");
+            builder.build_p1()
+        })?;
+        let instance = linker.instantiate_async(&mut store, &module).await?;
+        let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+        assert_eq!(run.call_async(&mut store, ()).await?, 6);
+        let memory = instance.get_memory(&mut store, "memory").unwrap();
+        assert_eq!(&memory.data(&store)[128..134], b"shared");
+
+        // The open and the listing only reach the filesystem the first time.
+        assert_eq!(
+            shared.stats(),
+            SharedDirStats {
+                hits: 2 * i,
+                misses: 2
+            }
+        );
+    }
+    Ok(())
+}
+
+#[test_log::test(tokio::test(flavor = "multi_thread"))]
+async fn p1_archive() -> Result<()> {
+    let engine = test_programs_artifacts::engine(|_config| {});
+    let mut linker = Linker::<Ctx<WasiP1Ctx>>::new(&engine);
+    add_to_linker_async(&mut linker, |t| &mut t.wasi)?;
+
+    // Reads `dir/b.txt` from the archive, preopened as fd 4, returning the
+    // number of bytes read, and checks that it can't be opened for writing.
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (import "wasi_snapshot_preview1" "path_open"
+                    (func $path_open (param i32 i32 i32 i32 i32 i64 i64 i32 i32) (result i32)))
+                (import "wasi_snapshot_preview1" "fd_read"
+                    (func $fd_read (param i32 i32 i32 i32) (result i32)))
+                (memory (export "memory") 1)
+                (data (i32.const 0) "dir/b.txt")
+                (data (i32.const 64) "\80\00\00\00\10\00\00\00")
+                (func (export "run") (result i32)
+                    (if (i32.ne (call $path_open (i32.const 4) (i32.const 1) (i32.const 0)
+                                    (i32.const 9) (i32.const 0) (i64.const 64) (i64.const 0)
+                                    (i32.const 0) (i32.const 96))
+                                (i32.const 63))
+                        (then (return (i32.const -1))))
+                    (if (call $path_open (i32.const 4) (i32.const 1) (i32.const 0) (i32.const 9)
+                            (i32.const 0) (i64.const 2) (i64.const 0) (i32.const 0) (i32.const 96))
+                        (then (return (i32.const -2))))
+                    (if (call $fd_read (i32.load (i32.const 96)) (i32.const 64) (i32.const 1)
+                            (i32.const 100))
+                        (then (return (i32.const -3))))
+                    (i32.load (i32.const 100))))
+        "#,
+    )?;
+
+    let archive = Archive::new(
+        ArchiveBuilder::new()
+            .file("a.txt", "a")
+            .file("dir/b.txt", "archived")
+            .finish(),
+    )?;
+    let (mut store, _td) = Ctx::new(&engine, "archive", |builder| {
+        builder.preopened_archive(&archive, "assets");
+        builder.build_p1()
+    })?;
+    let instance = linker.instantiate_async(&mut store, &module).await?;
+    let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+    assert_eq!(run.call_async(&mut store, ()).await?, 8);
+    let memory = instance.get_memory(&mut store, "memory").unwrap();
+    assert_eq!(&memory.data(&store)[128..136], b"archived");
+    Ok(())
+}
+
+#[test_log::test(tokio::test(flavor = "multi_thread"))]
+async fn p1_deterministic_clock_and_random() -> Result<()> {
+    let engine = test_programs_artifacts::engine(|_config| {});
+    let mut linker = Linker::<Ctx<WasiP1Ctx>>::new(&engine);
+    add_to_linker_async(&mut linker, |t| &mut t.wasi)?;
+
+    // Reads the monotonic clock twice, to offsets 0 and 8, and fills 6 bytes
+    // at offset 16 with random data.
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (import "wasi_snapshot_preview1" "clock_time_get"
+                    (func $clock_time_get (param i32 i64 i32) (result i32)))
+                (import "wasi_snapshot_preview1" "random_get"
+                    (func $random_get (param i32 i32) (result i32)))
+                (memory (export "memory") 1)
+                (func (export "run") (result i32)
+                    (i32.or
+                        (i32.or
+                            (call $clock_time_get (i32.const 1) (i64.const 0) (i32.const 0))
+                            (call $clock_time_get (i32.const 1) (i64.const 0) (i32.const 8)))
+                        (call $random_get (i32.const 16) (i32.const 6)))))
+        "#,
+    )?;
+
+    let (mut store, _td) = Ctx::new(&engine, "deterministic", |builder| {
+        builder.monotonic_clock(StepClock::new(
+            Duration::from_nanos(100),
+            Duration::from_nanos(10),
+        ));
+        builder.secure_random(Deterministic::new(vec![1, 2, 3, 4]));
+        builder.build_p1()
+    })?;
+    let instance = linker.instantiate_async(&mut store, &module).await?;
+    let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+    assert_eq!(run.call_async(&mut store, ()).await?, 0);
+    let memory = instance.get_memory(&mut store, "memory").unwrap();
+    let data = memory.data(&store);
+    assert_eq!(u64::from_le_bytes(data[0..8].try_into()?), 100);
+    assert_eq!(u64::from_le_bytes(data[8..16].try_into()?), 110);
+    assert_eq!(&data[16..22], &[1, 2, 3, 4, 1, 2]);
+    Ok(())
+}
@@ -26,11 +26,17 @@ fn main() {
         && (supported_os || cfg!(feature = "custom-native-signals"))
         && has_host_compiler_backend;
     let has_virtual_memory = supported_os || cfg!(feature = "custom-virtual-memory");
-    let has_custom_sync = !cfg!(feature = "std") && cfg!(feature = "custom-sync-primitives");
+    let has_atomic_sync = !cfg!(feature = "std") && cfg!(feature = "atomic-sync-primitives");
+    let has_custom_sync =
+        !cfg!(feature = "std") && cfg!(feature = "custom-sync-primitives") && !has_atomic_sync;
+    let has_virtual_memory_batch =
+        !cfg!(feature = "std") && cfg!(feature = "custom-virtual-memory-batch");
 
     custom_cfg("has_native_signals", has_native_signals);
     custom_cfg("has_virtual_memory", has_virtual_memory);
     custom_cfg("has_custom_sync", has_custom_sync);
+    custom_cfg("has_atomic_sync", has_atomic_sync);
+    custom_cfg("has_virtual_memory_batch", has_virtual_memory_batch);
     custom_cfg("has_host_compiler_backend", has_host_compiler_backend);
 
     // If this OS isn't supported and no debug-builtins or if Cranelift doesn't support
@@ -33,9 +33,10 @@ use call_graph::CallGraph;
 use wasmtime_environ::component::Translator;
 use wasmtime_environ::{
     Abi, CompiledFunctionBody, CompiledFunctionsTable, CompiledFunctionsTableBuilder,
-    CompiledModuleInfo, Compiler, DefinedFuncIndex, FilePos, FinishedObject, FuncKey,
-    FunctionBodyData, InliningCompiler, IntraModuleInlining, ModuleEnvironment, ModuleTranslation,
-    ModuleTypes, ModuleTypesBuilder, ObjectKind, PrimaryMap, StaticModuleIndex, Tunables,
+    CompiledModuleInfo, Compiler, ConstExpr, ConstOp, DefinedFuncIndex, EntityIndex, FilePos,
+    FinishedObject, FuncKey, FunctionBodyData, HostIntrinsic, Initializer, InliningCompiler,
+    IntraModuleInlining, ModuleEnvironment, ModuleTranslation, ModuleTypes, ModuleTypesBuilder,
+    ObjectKind, PrimaryMap, StaticModuleIndex, Tunables, WasmValType,
 };
 
 mod call_graph;
@@ -43,7 +44,17 @@ mod scc;
 mod stratify;
 
 mod code_builder;
-pub use self::code_builder::{CodeBuilder, CodeHint, HashedEngineCompileEnv};
+pub use self::code_builder::{CodeBuilder, CodeHint, HashedEngineCompileEnv, HostIntrinsic};
+
+mod report;
+pub use self::report::{CompileReport, FunctionCompileReport, FunctionCompileStats};
+
+mod profile;
+pub use self::profile::CompileProfile;
+
+mod deadline;
+use self::deadline::CompileDeadline;
+pub use self::deadline::CompileDeadlineExceeded;
 
 #[cfg(feature = "runtime")]
 mod runtime;
@@ -60,11 +71,24 @@ mod runtime;
 /// Additionally compilation returns an `Option` here which is always
 /// `Some`, notably compiled metadata about the module in addition to the
 /// type information found within.
+///
+/// The code is specialized for the values of any imported immutable globals
+/// in `specialized_globals`, see `CodeBuilder::specialize_global`, with the
+/// calls to imported functions in `inlined_imports` replaced by their
+/// behavior, see `CodeBuilder::inline_import`, and optimized according to
+/// `profile`, see `CodeBuilder::profile`.
+///
+/// If `report` is provided then it's filled in with measurements of each
+/// defined function's compilation.
 pub(crate) fn build_module_artifacts<T: FinishedObject>(
     engine: &Engine,
     wasm: &[u8],
     dwarf_package: Option<&[u8]>,
+    specialized_globals: &[(String, String, ConstOp)],
+    inlined_imports: &[(String, String, HostIntrinsic)],
+    profile: Option<&CompileProfile>,
     obj_state: &T::State,
+    report: Option<&mut CompileReport>,
 ) -> Result<(
     T,
     Option<(CompiledModuleInfo, CompiledFunctionsTable, ModuleTypes)>,
@@ -88,10 +112,15 @@ pub(crate) fn build_module_artifacts<T: FinishedObject>(
     )
     .translate(parser, wasm)
     .context("failed to parse WebAssembly module")?;
+    specialize_globals(&mut translation, specialized_globals)?;
+    inline_imports(&mut translation, &types, inlined_imports)?;
     let functions = mem::take(&mut translation.function_body_inputs);
 
     let compile_inputs = CompileInputs::for_module(&types, &translation, functions);
-    let unlinked_compile_outputs = compile_inputs.compile(engine)?;
+    let unlinked_compile_outputs = compile_inputs.compile(engine, profile)?;
+    if let Some(report) = report {
+        unlinked_compile_outputs.report(&translation, report);
+    }
     let PreLinkOutput {
         needs_gc_heap,
         compiled_funcs,
@@ -130,6 +159,78 @@ pub(crate) fn build_module_artifacts<T: FinishedObject>(
     Ok((result, Some((info, index, types))))
 }
 
+/// Records the values in `specialized_globals` of the imported immutable
+/// globals of `translation`, which its functions are then compiled with.
+///
+/// Values for globals which the module doesn't import are ignored.
+fn specialize_globals(
+    translation: &mut ModuleTranslation<'_>,
+    specialized_globals: &[(String, String, ConstOp)],
+) -> Result<()> {
+    let module = &mut translation.module;
+    for (name, field, value) in specialized_globals {
+        let index = module.initializers.iter().find_map(|init| match init {
+            Initializer::Import {
+                name: n,
+                field: f,
+                index: EntityIndex::Global(index),
+            } if n == name && f == field => Some(*index),
+            _ => None,
+        });
+        let Some(index) = index else { continue };
+        let global = &module.globals[index];
+        ensure!(
+            !global.mutability,
+            "cannot specialize mutable global import `{name}::{field}`"
+        );
+        let matches = match (global.wasm_ty, value) {
+            (WasmValType::I32, ConstOp::I32Const(_))
+            | (WasmValType::I64, ConstOp::I64Const(_))
+            | (WasmValType::F32, ConstOp::F32Const(_))
+            | (WasmValType::F64, ConstOp::F64Const(_))
+            | (WasmValType::V128, ConstOp::V128Const(_)) => true,
+            _ => false,
+        };
+        ensure!(
+            matches,
+            "value specialized for global import `{name}::{field}` doesn't match its type"
+        );
+        module
+            .specialized_globals
+            .insert(index, ConstExpr::new([*value]));
+    }
+    Ok(())
+}
+
+/// Records the behavior in `inlined_imports` of the imported functions of
+/// `translation`, which calls to them are then compiled to.
+fn inline_imports(
+    translation: &mut ModuleTranslation<'_>,
+    types: &ModuleTypesBuilder,
+    inlined_imports: &[(String, String, HostIntrinsic)],
+) -> Result<()> {
+    let module = &mut translation.module;
+    for (name, field, intrinsic) in inlined_imports {
+        let index = module.initializers.iter().find_map(|init| match init {
+            Initializer::Import {
+                name: n,
+                field: f,
+                index: EntityIndex::Function(index),
+            } if n == name && f == field => Some(*index),
+            _ => None,
+        });
+        let Some(index) = index else { continue };
+        let ty = module.functions[index].signature.unwrap_module_type_index();
+        let ty = types[ty].unwrap_func();
+        ensure!(
+            ty.params().is_empty() && ty.returns() == [intrinsic.result_type()],
+            "the type of function import `{name}::{field}` doesn't match its inlined behavior"
+        );
+        module.inlined_imports.insert(index, *intrinsic);
+    }
+    Ok(())
+}
+
 /// Performs the compilation phase for a component, translating and
 /// validating the provided wasm binary to machine code.
 ///
@@ -173,7 +274,7 @@ pub(crate) fn build_component_artifacts<T: FinishedObject>(
             (i, &*translation, functions)
         }),
     );
-    let unlinked_compile_outputs = compile_inputs.compile(&engine)?;
+    let unlinked_compile_outputs = compile_inputs.compile(&engine, None)?;
 
     let PreLinkOutput {
         needs_gc_heap,
@@ -234,9 +335,13 @@ struct InlineHeuristicParams<'a> {
     caller_size: u32,
     caller_key: FuncKey,
     caller_needs_gc_heap: bool,
+    /// The number of calls of the caller in the compile profile, if any.
+    caller_calls: Option<u64>,
     callee_size: u32,
     callee_key: FuncKey,
     callee_needs_gc_heap: bool,
+    /// Whether the compile profile, if any, says the callee is hot.
+    callee_is_hot: bool,
 }
 
 /// The collection of things we need to compile for a Wasm module or component.
@@ -521,7 +626,13 @@ impl<'a> CompileInputs<'a> {
 
     /// Compile these `CompileInput`s (maybe in parallel) and return the
     /// resulting `UnlinkedCompileOutput`s.
-    fn compile(self, engine: &Engine) -> Result<UnlinkedCompileOutputs<'a>> {
+    ///
+    /// The `profile`, if any, guides inlining decisions.
+    fn compile(
+        self,
+        engine: &Engine,
+        profile: Option<&CompileProfile>,
+    ) -> Result<UnlinkedCompileOutputs<'a>> {
         let compiler = engine.try_compiler()?;
 
         if self.inputs.len() > 0 && cfg!(miri) {
@@ -542,15 +653,18 @@ the use case.
             );
         }
 
+        let deadline = CompileDeadline::start(engine);
         let mut raw_outputs = if let Some(inlining_compiler) = compiler.inlining_compiler() {
             if engine.tunables().inlining {
-                self.compile_with_inlining(engine, compiler, inlining_compiler)?
+                self.compile_with_inlining(engine, compiler, inlining_compiler, profile, deadline)?
             } else {
                 // Inlining compiler but inlining is disabled: compile each
                 // input and immediately finish its output in parallel, skipping
                 // call graph computation and all that.
                 engine.run_maybe_parallel::<_, _, Error, _>(self.inputs, |f| {
+                    deadline.check()?;
                     let mut compiled = f(compiler)?;
+                    deadline.check()?;
                     inlining_compiler.finish_compiling(
                         &mut compiled.function,
                         compiled.func_body.take(),
@@ -561,7 +675,10 @@ the use case.
             }
         } else {
             // No inlining: just compile each individual input in parallel.
-            engine.run_maybe_parallel(self.inputs, |f| f(compiler))?
+            engine.run_maybe_parallel(self.inputs, |f| {
+                deadline.check()?;
+                f(compiler)
+            })?
         };
 
         if cfg!(debug_assertions) {
@@ -596,6 +713,8 @@ the use case.
         engine: &Engine,
         compiler: &dyn Compiler,
         inlining_compiler: &dyn InliningCompiler,
+        profile: Option<&CompileProfile>,
+        deadline: CompileDeadline,
     ) -> Result<Vec<CompileOutput<'a>>, Error> {
         /// The index of a function (of any kind: Wasm function, trampoline, or
         /// etc...) in our list of unlinked outputs.
@@ -605,7 +724,10 @@ the use case.
 
         // Our list of unlinked outputs.
         let mut outputs = PrimaryMap::<OutputIndex, Option<CompileOutput<'_>>>::from(
-            engine.run_maybe_parallel(self.inputs, |f| f(compiler).map(Some))?,
+            engine.run_maybe_parallel(self.inputs, |f| {
+                deadline.check()?;
+                f(compiler).map(Some)
+            })?,
         );
 
         /// Whether a function (as described by the given `FuncKey`) can
@@ -709,6 +831,18 @@ the use case.
         // same layer into each other).
         let strata =
             stratify::Strata::<OutputIndex>::new(inlining_functions(&outputs), &call_graph);
+        // The number of calls of a Wasm function in the compile profile, if
+        // there is one. Functions that the profile doesn't mention were never
+        // called.
+        let profiled_calls = |output: &CompileOutput<'_>| -> Option<u64> {
+            let profile = profile?;
+            let FuncKey::DefinedWasmFunction(_, index) = output.key else {
+                return None;
+            };
+            let index = output.translation?.module.func_index(index);
+            Some(profile.calls(index.as_u32()).unwrap_or(0))
+        };
+
         let mut layer_outputs = vec![];
         for layer in strata.layers() {
             // Temporarily take this layer's outputs out of our unlinked outputs
@@ -725,10 +859,12 @@ the use case.
                 |output: &mut CompileOutput<'_>| {
                     log::trace!("processing inlining for {:?}", output.key);
                     debug_assert!(is_inlining_function(output.key));
+                    deadline.check()?;
 
                     let caller_key = output.key;
                     let caller_needs_gc_heap =
                         output.translation.is_some_and(|t| t.module.needs_gc_heap);
+                    let caller_calls = profiled_calls(output);
                     let caller = &mut output.function;
 
                     let mut caller_size = inlining_compiler.size(caller);
@@ -753,15 +889,20 @@ the use case.
                         let callee_needs_gc_heap = callee_output
                             .translation
                             .is_some_and(|t| t.module.needs_gc_heap);
+                        let callee_is_hot = profile
+                            .zip(profiled_calls(callee_output))
+                            .is_some_and(|(profile, calls)| profile.is_hot(calls));
 
                         if Self::should_inline(InlineHeuristicParams {
                             tunables: engine.tunables(),
                             caller_size,
                             caller_key,
                             caller_needs_gc_heap,
+                            caller_calls,
                             callee_size,
                             callee_key,
                             callee_needs_gc_heap,
+                            callee_is_hot,
                         }) {
                             caller_size = caller_size.saturating_add(callee_size);
                             Some(callee)
@@ -780,6 +921,7 @@ the use case.
 
         // Fan out in parallel again and finish compiling each function.
         engine.run_maybe_parallel(outputs.into(), |output| {
+            deadline.check()?;
             let mut output = output.unwrap();
             inlining_compiler.finish_compiling(
                 &mut output.function,
@@ -818,9 +960,11 @@ the use case.
             caller_size,
             caller_key,
             caller_needs_gc_heap,
+            caller_calls,
             callee_size,
             callee_key,
             callee_needs_gc_heap,
+            callee_is_hot,
         }: InlineHeuristicParams,
     ) -> bool {
         log::trace!(
@@ -828,9 +972,11 @@ the use case.
              \tcaller = {caller_key:?}\n\
              \t\tsize = {caller_size}\n\
              \t\tneeds_gc_heap = {caller_needs_gc_heap}\n\
+             \t\tprofiled calls = {caller_calls:?}\n\
              \tcallee = {callee_key:?}\n\
              \t\tsize = {callee_size}\n\
-             \t\tneeds_gc_heap = {callee_needs_gc_heap}"
+             \t\tneeds_gc_heap = {callee_needs_gc_heap}\n\
+             \t\thot = {callee_is_hot}"
         );
 
         debug_assert!(
@@ -861,19 +1007,29 @@ the use case.
             return false;
         }
 
+        // Code that the compile profile says never ran isn't worth growing
+        // with inlined callees.
+        if caller_calls == Some(0) {
+            log::trace!("  --> not inlining: caller was never called in the compile profile");
+            return false;
+        }
+
         // Consider whether this is an intra-module call.
         //
         // Inlining within a single core module has most often already been done
         // by the toolchain that produced the module, e.g. LLVM, and any extant
         // function calls to small callees were presumably annotated with the
         // equivalent of `#[inline(never)]` or `#[cold]` but we don't have that
-        // information anymore.
+        // information anymore. The compile profile, however, tells us which
+        // callees are worth inlining after all.
         match (caller_key, callee_key) {
             (
                 FuncKey::DefinedWasmFunction(caller_module, _),
                 FuncKey::DefinedWasmFunction(callee_module, _),
             ) => {
-                if caller_module == callee_module {
+                if caller_module == callee_module && callee_is_hot {
+                    log::trace!("  --> intra-module call to a callee that is hot in the profile");
+                } else if caller_module == callee_module {
                     match tunables.inlining_intra_module {
                         IntraModuleInlining::Yes => {}
 
@@ -971,6 +1127,23 @@ struct UnlinkedCompileOutputs<'a> {
 }
 
 impl UnlinkedCompileOutputs<'_> {
+    /// Records the compile stats of each function defined by `translation`
+    /// into `report`.
+    fn report(&self, translation: &ModuleTranslation<'_>, report: &mut CompileReport) {
+        for output in self.outputs.values() {
+            let FuncKey::DefinedWasmFunction(_, def_func_index) = output.key else {
+                continue;
+            };
+            let func_index = translation.module.func_index(def_func_index);
+            let name = translation
+                .debuginfo
+                .name_section
+                .func_names
+                .get(&func_index);
+            report.push(func_index.as_u32(), name.copied(), output.function.stats);
+        }
+    }
+
     /// Flatten all our functions into a single list and remember each of their
     /// indices within it.
     fn pre_link(self) -> PreLinkOutput {
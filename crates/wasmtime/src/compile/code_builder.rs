@@ -1,7 +1,10 @@
-use crate::Engine;
 use crate::prelude::*;
+use crate::{CompileProfile, Engine};
 use std::borrow::Cow;
 use std::path::Path;
+use wasmtime_environ::ConstOp;
+
+pub use wasmtime_environ::HostIntrinsic;
 
 #[cfg(feature = "compile-time-builtins")]
 use crate::hash_map::HashMap;
@@ -48,6 +51,18 @@ pub struct CodeBuilder<'a> {
     dwarf_package_path: Option<Cow<'a, Path>>,
     unsafe_intrinsics_import: Option<String>,
 
+    /// Values of imported immutable globals to specialize the module's code
+    /// for, by their module and field names.
+    specialized_globals: Vec<(String, String, ConstOp)>,
+
+    /// The behavior of imported functions which calls to them are compiled
+    /// to, by their module and field names.
+    inlined_imports: Vec<(String, String, HostIntrinsic)>,
+
+    /// Call counts from a previous run of the module guiding its
+    /// optimization.
+    profile: Option<&'a CompileProfile>,
+
     /// A map from import name to the Wasm bytes of the associated compile-time
     /// builtin and its file path, if any.
     //
@@ -79,6 +94,9 @@ impl<'a> CodeBuilder<'a> {
             dwarf_package: None,
             dwarf_package_path: None,
             unsafe_intrinsics_import: None,
+            specialized_globals: Vec::new(),
+            inlined_imports: Vec::new(),
+            profile: None,
             #[cfg(feature = "compile-time-builtins")]
             compile_time_builtins: HashMap::default(),
         }
@@ -722,6 +740,23 @@ impl<'a> CodeBuilder<'a> {
         Ok(self)
     }
 
+    /// Configures a profile of how often the module's functions were called
+    /// when it previously ran, which guides the optimization of its code.
+    ///
+    /// See [`CompileProfile`] for how a profile is collected and what it
+    /// influences. A profile only makes sense for the exact module it was
+    /// collected from; the functions it mentions are identified by index.
+    /// Profiles are only used when compiling modules and are ignored for
+    /// components.
+    pub fn profile(&mut self, profile: &'a CompileProfile) -> &mut Self {
+        self.profile = Some(profile);
+        self
+    }
+
+    pub(super) fn get_profile(&self) -> Option<&'a CompileProfile> {
+        self.profile
+    }
+
     /// Returns a hint, if possible, of what the provided bytes are.
     ///
     /// This method can be use to detect what the previously supplied bytes to
@@ -771,8 +806,16 @@ impl<'a> CodeBuilder<'a> {
 
         let wasm = self.get_wasm()?;
         let dwarf_package = self.get_dwarf_package();
-        let (v, _) =
-            super::build_module_artifacts(self.engine, &wasm, dwarf_package.as_deref(), &())?;
+        let (v, _) = super::build_module_artifacts(
+            self.engine,
+            &wasm,
+            dwarf_package.as_deref(),
+            &self.specialized_globals,
+            &self.inlined_imports,
+            self.profile,
+            &(),
+            None,
+        )?;
         Ok(v)
     }
 
@@ -795,6 +838,122 @@ impl<'a> CodeBuilder<'a> {
     pub(super) fn get_unsafe_intrinsics_import(&self) -> Option<&str> {
         self.unsafe_intrinsics_import.as_deref()
     }
+
+    /// Compiles the module's code with `value` as the value of its imported
+    /// immutable global `module::name`, if it has one, instead of loading
+    /// the global's value at runtime.
+    ///
+    /// Instantiating the compiled module fails unless the global provided for
+    /// this import has this value. This is used by
+    /// [`Linker::instantiate_pre_specialized`](crate::Linker::instantiate_pre_specialized).
+    #[cfg(feature = "runtime")]
+    pub(crate) fn specialize_global(
+        &mut self,
+        module: &str,
+        name: &str,
+        value: ConstOp,
+    ) -> &mut Self {
+        self.specialized_globals
+            .push((module.to_string(), name.to_string(), value));
+        self
+    }
+
+    pub(super) fn get_specialized_globals(&self) -> &[(String, String, ConstOp)] {
+        &self.specialized_globals
+    }
+
+    /// Compiles calls to the imported function `module::name`, if the module
+    /// imports it, to `intrinsic` instead of calls to the function provided
+    /// at instantiation.
+    ///
+    /// Host functions which just return a constant or a field of the store's
+    /// data are still a full call through a trampoline from Wasm. Describing
+    /// them with a [`HostIntrinsic`] instead lets the compiler emit their
+    /// behavior at each call site. The import must still be provided when
+    /// instantiating, and is called by code that isn't compiled with
+    /// Cranelift, for example with [`Strategy::Winch`](crate::Strategy::Winch),
+    /// and by tail calls to the import.
+    ///
+    /// Compilation fails if the type of the imported function isn't `[] ->
+    /// [t]` where `t` is the type of the intrinsic's result.
+    ///
+    /// # Unsafety
+    ///
+    /// The host function provided for this import must behave exactly like
+    /// `intrinsic`, since which one is run is an implementation detail.
+    ///
+    /// For the `*StoreData` intrinsics the module may only be instantiated
+    /// in stores whose data, the `T` of `Store<T>`, has a properly aligned
+    /// value of the intrinsic's type at the given byte offset, for example
+    /// one found with [`core::mem::offset_of!`]. The value is read without
+    /// synchronization, so it must not be modified concurrently with the
+    /// execution of Wasm.
+    ///
+    /// # Example
+    ///
+    /// ```
+    /// use wasmtime::*;
+    ///
+    /// # fn main() -> Result<()> {
+    /// struct Data {
+    ///     name: String,
+    ///     limit: i64,
+    /// }
+    ///
+    /// let engine = Engine::default();
+    /// let mut builder = CodeBuilder::new(&engine);
+    /// builder.wasm_binary_or_text(
+    ///     r#"
+    ///         (module
+    ///             (import "host" "limit" (func $limit (result i64)))
+    ///             (import "host" "version" (func $version (result i32)))
+    ///             (func (export "run") (result i64)
+    ///                 (i64.add (call $limit) (i64.extend_i32_u (call $version)))))
+    ///     "#.as_bytes(),
+    ///     None,
+    /// )?;
+    ///
+    /// // SAFETY: the host functions below return the same values, and `Data`
+    /// // has an `i64` field at this offset.
+    /// let offset = u32::try_from(core::mem::offset_of!(Data, limit))?;
+    /// unsafe {
+    ///     builder.inline_import("host", "version", HostIntrinsic::I32Const(3));
+    ///     builder.inline_import("host", "limit", HostIntrinsic::I64StoreData(offset));
+    /// }
+    /// let module = builder.compile_module()?;
+    ///
+    /// let mut linker = Linker::<Data>::new(&engine);
+    /// linker.func_wrap("host", "limit", |caller: Caller<'_, Data>| caller.data().limit)?;
+    /// linker.func_wrap("host", "version", || 3_i32)?;
+    ///
+    /// let data = Data {
+    ///     name: "example".to_string(),
+    ///     limit: 100,
+    /// };
+    /// let mut store = Store::new(&engine, data);
+    /// let instance = linker.instantiate(&mut store, &module)?;
+    /// let run = instance.get_typed_func::<(), i64>(&mut store, "run")?;
+    /// assert_eq!(run.call(&mut store, ())?, 103);
+    /// store.data_mut().limit = 200;
+    /// assert_eq!(run.call(&mut store, ())?, 203);
+    /// # assert_eq!(store.data().name, "example");
+    /// # Ok(())
+    /// # }
+    /// ```
+    pub unsafe fn inline_import(
+        &mut self,
+        module: &str,
+        name: &str,
+        intrinsic: HostIntrinsic,
+    ) -> &mut Self {
+        self.inlined_imports
+            .push((module.to_string(), name.to_string(), intrinsic));
+        self
+    }
+
+    pub(super) fn get_inlined_imports(&self) -> &[(String, String, HostIntrinsic)] {
+        &self.inlined_imports
+    }
 }
 
 /// This is a helper struct used when caching to hash the state of an `Engine`
@@ -0,0 +1,62 @@
+//! Support for `Config::compile_deadline`.
+
+use crate::Engine;
+use crate::prelude::*;
+use core::fmt;
+use core::time::Duration;
+use std::time::Instant;
+
+/// An error returned when compiling a module or component takes longer than
+/// [`Config::compile_deadline`](crate::Config::compile_deadline).
+#[derive(Debug)]
+pub struct CompileDeadlineExceeded {
+    deadline: Duration,
+}
+
+impl core::error::Error for CompileDeadlineExceeded {}
+
+impl fmt::Display for CompileDeadlineExceeded {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(
+            f,
+            "compilation exceeded its deadline of {:?}",
+            self.deadline
+        )
+    }
+}
+
+impl CompileDeadlineExceeded {
+    /// Returns the deadline that compilation exceeded.
+    pub fn deadline(&self) -> Duration {
+        self.deadline
+    }
+}
+
+/// The point in time by which an in-progress compilation must finish, if the
+/// engine is configured with one.
+#[derive(Clone, Copy)]
+pub(super) struct CompileDeadline {
+    limit: Option<(Instant, Duration)>,
+}
+
+impl CompileDeadline {
+    /// Starts the clock for a compilation with `engine`.
+    pub(super) fn start(engine: &Engine) -> CompileDeadline {
+        CompileDeadline {
+            limit: engine
+                .config()
+                .compile_deadline
+                .map(|deadline| (Instant::now() + deadline, deadline)),
+        }
+    }
+
+    /// Returns an error if the deadline has passed.
+    pub(super) fn check(&self) -> Result<()> {
+        match self.limit {
+            Some((at, deadline)) if Instant::now() >= at => {
+                Err(CompileDeadlineExceeded { deadline }.into())
+            }
+            _ => Ok(()),
+        }
+    }
+}
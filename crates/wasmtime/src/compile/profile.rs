@@ -0,0 +1,114 @@
+//! Profiles of how often a module's functions are called, used to guide its
+//! compilation, see `CodeBuilder::profile`.
+
+use crate::prelude::*;
+use core::fmt;
+use core::str::FromStr;
+use std::collections::BTreeMap;
+
+/// Functions called at least this fraction of the number of times that the
+/// most-called function was are considered hot.
+const HOT_FRACTION: u64 = 100;
+
+/// The number of times each function of a module was called while running a
+/// representative workload, used to guide optimization when the module is
+/// compiled again.
+///
+/// A profile is collected by running a module compiled with
+/// [`Config::count_function_calls`](crate::Config::count_function_calls)
+/// enabled and adding the counts of its instances with
+/// [`CompileProfile::add_instance`]. It can be saved with its `Display`
+/// implementation, which writes a line of `<function index> <calls>` per
+/// function, and loaded again with [`str::parse`]. The profile is then passed
+/// to [`CodeBuilder::profile`](crate::CodeBuilder::profile) when compiling the
+/// same module without call counting.
+///
+/// The profile currently guides [inlining](crate::Config::compiler_inlining):
+/// calls aren't inlined into functions which were never called, and calls to
+/// hot functions are inlined even when calls within a module otherwise
+/// wouldn't be.
+#[derive(Debug, Clone, Default, Hash, PartialEq, Eq)]
+pub struct CompileProfile {
+    calls: BTreeMap<u32, u64>,
+    max_calls: u64,
+}
+
+impl CompileProfile {
+    /// Creates an empty profile.
+    pub fn new() -> CompileProfile {
+        CompileProfile::default()
+    }
+
+    /// Adds `calls` calls of the function at `func_index` in the module's
+    /// function index space to this profile.
+    pub fn add_calls(&mut self, func_index: u32, calls: u64) {
+        let total = self.calls.entry(func_index).or_insert(0);
+        *total = total.saturating_add(calls);
+        self.max_calls = self.max_calls.max(*total);
+    }
+
+    /// Adds the calls counted by `instance` to this profile.
+    ///
+    /// See [`Instance::function_stats`](crate::Instance::function_stats).
+    ///
+    /// # Panics
+    ///
+    /// Panics if `store` does not own `instance`.
+    #[cfg(feature = "runtime")]
+    pub fn add_instance<'a, T: 'static>(
+        &mut self,
+        store: impl Into<crate::StoreContext<'a, T>>,
+        instance: &crate::Instance,
+    ) {
+        for stats in instance.function_stats(store) {
+            self.add_calls(stats.index, stats.calls);
+        }
+    }
+
+    /// Returns the number of calls of the function at `func_index` in this
+    /// profile, or `None` if the profile doesn't mention it.
+    pub fn calls(&self, func_index: u32) -> Option<u64> {
+        self.calls.get(&func_index).copied()
+    }
+
+    /// Whether a function called `calls` times is hot relative to the rest of
+    /// this profile.
+    pub(crate) fn is_hot(&self, calls: u64) -> bool {
+        calls > 0 && calls >= self.max_calls / HOT_FRACTION
+    }
+}
+
+impl fmt::Display for CompileProfile {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        for (index, calls) in &self.calls {
+            writeln!(f, "{index} {calls}")?;
+        }
+        Ok(())
+    }
+}
+
+impl FromStr for CompileProfile {
+    type Err = Error;
+
+    fn from_str(s: &str) -> Result<CompileProfile> {
+        let mut profile = CompileProfile::new();
+        for (i, line) in s.lines().enumerate() {
+            let line = line.trim();
+            if line.is_empty() || line.starts_with('#') {
+                continue;
+            }
+            let parse = || -> Option<(u32, u64)> {
+                let (index, calls) = line.split_once(' ')?;
+                Some((index.parse().ok()?, calls.trim().parse().ok()?))
+            };
+            let (index, calls) = parse().ok_or_else(|| {
+                format_err!(
+                    "invalid compile profile on line {}: expected `<function index> <calls>`",
+                    i + 1
+                )
+            })?;
+            profile.add_calls(index, calls);
+        }
+        Ok(profile)
+    }
+}
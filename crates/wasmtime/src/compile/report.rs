@@ -0,0 +1,103 @@
+//! Per-function measurements of the cost of compiling a module, see
+//! `CodeBuilder::compile_module_with_report`.
+
+use crate::prelude::*;
+use core::time::Duration;
+
+pub use wasmtime_environ::FunctionCompileStats;
+
+/// A report of where time and code size went while compiling a module.
+///
+/// Created by [`CodeBuilder::compile_module_with_report`] and useful for
+/// finding the functions of a module which dominate its compile time.
+///
+/// [`CodeBuilder::compile_module_with_report`]: crate::CodeBuilder::compile_module_with_report
+#[derive(Debug, Clone, Default)]
+pub struct CompileReport {
+    functions: Vec<FunctionCompileReport>,
+}
+
+/// Measurements for a single function defined in a compiled module.
+#[derive(Debug, Clone)]
+pub struct FunctionCompileReport {
+    index: u32,
+    name: Option<String>,
+    stats: FunctionCompileStats,
+}
+
+impl CompileReport {
+    pub(crate) fn push(&mut self, index: u32, name: Option<&str>, stats: FunctionCompileStats) {
+        self.functions.push(FunctionCompileReport {
+            index,
+            name: name.map(|n| n.to_string()),
+            stats,
+        });
+    }
+
+    /// Returns the functions defined in the module, in order of their index.
+    pub fn functions(&self) -> &[FunctionCompileReport] {
+        &self.functions
+    }
+
+    /// Returns the sum of the compile times of all functions in the module.
+    ///
+    /// Functions are compiled in parallel when
+    /// [`Config::parallel_compilation`](crate::Config::parallel_compilation)
+    /// is enabled, so this may exceed the wall time of the compilation.
+    pub fn total_time(&self) -> Duration {
+        self.functions.iter().map(|f| f.stats.total_time).sum()
+    }
+
+    /// Returns the total size, in bytes, of the machine code of all functions
+    /// in the module.
+    pub fn code_size(&self) -> usize {
+        self.functions.iter().map(|f| f.stats.code_size).sum()
+    }
+
+    /// Returns the total number of explicit bounds checks emitted for memory
+    /// accesses in all functions in the module.
+    pub fn bounds_checks(&self) -> usize {
+        self.functions.iter().map(|f| f.stats.bounds_checks).sum()
+    }
+
+    /// Returns the total number of memory accesses in all functions in the
+    /// module which didn't need an explicit bounds check.
+    pub fn bounds_checks_elided(&self) -> usize {
+        self.functions
+            .iter()
+            .map(|f| f.stats.bounds_checks_elided)
+            .sum()
+    }
+
+    /// Returns the total number of memory accesses in all functions in the
+    /// module which didn't need an explicit bounds check because an earlier
+    /// check already covered them, for example when accessing adjacent
+    /// addresses.
+    ///
+    /// These are included in [`CompileReport::bounds_checks_elided`].
+    pub fn bounds_checks_merged(&self) -> usize {
+        self.functions
+            .iter()
+            .map(|f| f.stats.bounds_checks_merged)
+            .sum()
+    }
+}
+
+impl FunctionCompileReport {
+    /// Returns the index of this function in the module's function index
+    /// space, which includes imported functions.
+    pub fn index(&self) -> u32 {
+        self.index
+    }
+
+    /// Returns the name of this function from the module's `name` section, if
+    /// any.
+    pub fn name(&self) -> Option<&str> {
+        self.name.as_deref()
+    }
+
+    /// Returns the measurements taken while compiling this function.
+    pub fn stats(&self) -> &FunctionCompileStats {
+        &self.stats
+    }
+}
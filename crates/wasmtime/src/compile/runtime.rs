@@ -2,7 +2,7 @@
 use crate::component::Component;
 use crate::prelude::*;
 use crate::runtime::vm::MmapVec;
-use crate::{CodeBuilder, CodeMemory, Engine, Module};
+use crate::{CodeBuilder, CodeMemory, CompileReport, Engine, Module, RuntimeEventKind};
 use object::write::WritableBuffer;
 use std::sync::Arc;
 use wasmtime_environ::{FinishedObject, ObjectBuilder};
@@ -22,6 +22,9 @@ impl<'a> CodeBuilder<'a> {
         let wasm = self.get_wasm()?;
         let dwarf_package = self.get_dwarf_package();
         let unsafe_intrinsics_import = self.get_unsafe_intrinsics_import();
+        let specialized_globals = self.get_specialized_globals();
+        let inlined_imports = self.get_inlined_imports();
+        let profile = self.get_profile();
 
         self.engine
             .check_compatible_with_native_host()
@@ -34,6 +37,9 @@ impl<'a> CodeBuilder<'a> {
                 &wasm,
                 &dwarf_package,
                 &unsafe_intrinsics_import,
+                specialized_globals,
+                inlined_imports,
+                profile,
                 // Don't hash this as it's just its own "pure" function pointer.
                 NotHashed(build_artifacts),
                 // Don't hash the FinishedObject state: this contains
@@ -51,6 +57,9 @@ impl<'a> CodeBuilder<'a> {
                             wasm,
                             dwarf_package,
                             unsafe_intrinsics_import,
+                            _specialized_globals,
+                            _inlined_imports,
+                            _profile,
                             build_artifacts,
                             state,
                         )|
@@ -66,11 +75,11 @@ impl<'a> CodeBuilder<'a> {
                             Ok((code, info))
                         },
                         // Implementation of how to serialize artifacts
-                        |(_engine, _wasm, _, _, _, _), (code, _info_and_types)| {
+                        |(_engine, _wasm, _, _, _, _, _, _, _), (code, _info_and_types)| {
                             Some(code.mmap().to_vec())
                         },
                         // Cache hit, deserialize the provided artifacts
-                        |(engine, wasm, _, _, _, _), serialized_bytes| {
+                        |(engine, wasm, _, _, _, _, _, _, _), serialized_bytes| {
                             let kind = if wasmparser::Parser::is_component(&wasm) {
                                 wasmtime_environ::ObjectKind::Component
                             } else {
@@ -120,21 +129,103 @@ impl<'a> CodeBuilder<'a> {
             "compile-time builtins can only be used with components"
         );
 
-        let custom_alignment = self.custom_alignment();
+        let start = self.engine.start_event();
+        let state = (
+            self.custom_alignment(),
+            self.get_specialized_globals(),
+            self.get_inlined_imports(),
+            self.get_profile(),
+        );
         let (code, info_and_types) = self.compile_cached(
-            |engine, wasm, dwarf, unsafe_intrinsics_import, state| {
+            |engine,
+             wasm,
+             dwarf,
+             unsafe_intrinsics_import,
+             (alignment, specialized_globals, inlined_imports, profile)| {
                 assert!(unsafe_intrinsics_import.is_none());
-                super::build_module_artifacts(engine, wasm, dwarf, state)
+                super::build_module_artifacts(
+                    engine,
+                    wasm,
+                    dwarf,
+                    specialized_globals,
+                    inlined_imports,
+                    *profile,
+                    alignment,
+                    None,
+                )
             },
-            &custom_alignment,
+            &state,
+        )?;
+        let module = Module::from_parts(self.engine, code, info_and_types)?;
+        self.engine
+            .finish_event(start, |duration| RuntimeEventKind::Compile { duration });
+
+        #[cfg(feature = "cranelift")]
+        if self.engine.tiered_compilation() && !Engine::compiling_optimized_tier() {
+            let wasm = self.get_wasm()?.into_owned();
+            let dwarf_package = self.get_dwarf_package().map(|d| d.to_vec());
+            let specialized_globals = self.get_specialized_globals().to_vec();
+            let inlined_imports = self.get_inlined_imports().to_vec();
+            let profile = self.get_profile().cloned();
+            return Ok(module.start_tier_up(
+                wasm,
+                dwarf_package,
+                specialized_globals,
+                inlined_imports,
+                profile,
+            ));
+        }
+
+        Ok(module)
+    }
+
+    /// Same as [`CodeBuilder::compile_module`] except that a
+    /// [`CompileReport`] of the time spent compiling, and the code size of,
+    /// each function in the module is returned as well.
+    ///
+    /// To measure the compilation this method always compiles the module,
+    /// bypassing any cache configured in [`Config`](crate::Config), and the
+    /// returned module does not use
+    /// [`Config::tiered_compilation`](crate::Config::tiered_compilation).
+    pub fn compile_module_with_report(&self) -> Result<(Module, CompileReport)> {
+        ensure!(
+            self.get_unsafe_intrinsics_import().is_none(),
+            "`CodeBuilder::expose_unsafe_intrinsics` can only be used with components"
+        );
+
+        #[cfg(feature = "compile-time-builtins")]
+        ensure!(
+            self.get_compile_time_builtins().is_empty(),
+            "compile-time builtins can only be used with components"
+        );
+
+        self.engine
+            .check_compatible_with_native_host()
+            .context("compilation settings are not compatible with the native host")?;
+
+        let wasm = self.get_wasm()?;
+        let dwarf_package = self.get_dwarf_package();
+        let mut report = CompileReport::default();
+        let (mmap, info_and_types) = super::build_module_artifacts::<MmapVecWrapper>(
+            self.engine,
+            &wasm,
+            dwarf_package.as_deref(),
+            self.get_specialized_globals(),
+            self.get_inlined_imports(),
+            self.get_profile(),
+            &self.custom_alignment(),
+            Some(&mut report),
         )?;
-        Module::from_parts(self.engine, code, info_and_types)
+        let code = publish_mmap(self.engine, mmap.0)?;
+        let module = Module::from_parts(self.engine, code, info_and_types)?;
+        Ok((module, report))
     }
 
     /// Same as [`CodeBuilder::compile_module`] except that it compiles a
     /// [`Component`] instead of a module.
     #[cfg(feature = "component-model")]
     pub fn compile_component(&self) -> Result<Component> {
+        let start = self.engine.start_event();
         let custom_alignment = self.custom_alignment();
         let (code, artifacts) = self.compile_cached(
             |engine, wasm, dwarf, unsafe_intrinsics_import, state| {
@@ -148,7 +239,10 @@ impl<'a> CodeBuilder<'a> {
             },
             &custom_alignment,
         )?;
-        Component::from_parts(self.engine, code, artifacts)
+        let component = Component::from_parts(self.engine, code, artifacts)?;
+        self.engine
+            .finish_event(start, |duration| RuntimeEventKind::Compile { duration });
+        Ok(component)
     }
 
     fn custom_alignment(&self) -> CustomAlignment {
@@ -27,7 +27,7 @@ use wasmtime_fiber::RuntimeFiberStackCreator;
 #[cfg(feature = "runtime")]
 pub use crate::runtime::code_memory::CustomCodeMemory;
 #[cfg(feature = "cache")]
-pub use wasmtime_cache::{Cache, CacheConfig};
+pub use wasmtime_cache::{Cache, CacheConfig, CacheStats};
 #[cfg(all(feature = "incremental-cache", feature = "cranelift"))]
 pub use wasmtime_environ::CacheStore;
 
@@ -149,6 +149,8 @@ pub struct Config {
     target: Option<target_lexicon::Triple>,
     #[cfg(feature = "gc")]
     collector: Collector,
+    #[cfg(feature = "gc")]
+    pub(crate) gc_heap_growth_factor: f64,
     profiling_strategy: ProfilingStrategy,
     tunables: ConfigTunables,
 
@@ -177,15 +179,34 @@ pub struct Config {
     #[cfg(feature = "async")]
     pub(crate) async_stack_zeroing: bool,
     #[cfg(feature = "async")]
+    pub(crate) async_stack_cache_size: usize,
+    #[cfg(feature = "stack-switching")]
+    pub(crate) continuation_stack_cache_size: usize,
+    #[cfg(feature = "stack-switching")]
+    pub(crate) continuation_stack_keep_resident: usize,
+    #[cfg(feature = "async")]
     pub(crate) stack_creator: Option<Arc<dyn RuntimeFiberStackCreator>>,
     pub(crate) module_version: ModuleVersionStrategy,
     pub(crate) parallel_compilation: bool,
+    #[cfg(feature = "parallel-compilation")]
+    pub(crate) compilation_threads: Option<usize>,
+    #[cfg(feature = "cranelift")]
+    pub(crate) tiered_compilation: bool,
+    #[cfg(feature = "parallel-compilation")]
+    pub(crate) compilation_thread_start: Option<Arc<dyn Fn(usize) + Send + Sync>>,
+    #[cfg(any(feature = "cranelift", feature = "winch"))]
+    pub(crate) compile_deadline: Option<core::time::Duration>,
     pub(crate) memory_guaranteed_dense_image_size: u64,
     pub(crate) force_memory_init_memfd: bool,
+    pub(crate) memory_huge_pages: Enabled,
+    pub(crate) code_huge_pages: Enabled,
     pub(crate) wmemcheck: bool,
     #[cfg(feature = "coredump")]
     pub(crate) coredump_on_trap: bool,
+    #[cfg(all(feature = "runtime", feature = "std"))]
+    pub(crate) event_sink: Option<crate::EventSink>,
     pub(crate) macos_use_mach_ports: bool,
+    pub(crate) signal_interruption: bool,
     pub(crate) detect_host_feature: Option<fn(&str) -> Option<bool>>,
     pub(crate) x86_float_abi_ok: Option<bool>,
     pub(crate) shared_memory: bool,
@@ -257,6 +278,8 @@ impl Config {
             target: None,
             #[cfg(feature = "gc")]
             collector: Collector::default(),
+            #[cfg(feature = "gc")]
+            gc_heap_growth_factor: 2.0,
             #[cfg(feature = "cache")]
             cache: None,
             profiling_strategy: ProfilingStrategy::None,
@@ -284,15 +307,34 @@ impl Config {
             #[cfg(feature = "async")]
             async_stack_zeroing: false,
             #[cfg(feature = "async")]
+            async_stack_cache_size: 0,
+            #[cfg(feature = "stack-switching")]
+            continuation_stack_cache_size: 0,
+            #[cfg(feature = "stack-switching")]
+            continuation_stack_keep_resident: 0,
+            #[cfg(feature = "async")]
             stack_creator: None,
             module_version: ModuleVersionStrategy::default(),
             parallel_compilation: !cfg!(miri),
+            #[cfg(feature = "parallel-compilation")]
+            compilation_threads: None,
+            #[cfg(feature = "cranelift")]
+            tiered_compilation: false,
+            #[cfg(feature = "parallel-compilation")]
+            compilation_thread_start: None,
+            #[cfg(any(feature = "cranelift", feature = "winch"))]
+            compile_deadline: None,
             memory_guaranteed_dense_image_size: 16 << 20,
             force_memory_init_memfd: false,
+            memory_huge_pages: Enabled::No,
+            code_huge_pages: Enabled::No,
             wmemcheck: false,
             #[cfg(feature = "coredump")]
             coredump_on_trap: false,
+            #[cfg(all(feature = "runtime", feature = "std"))]
+            event_sink: None,
             macos_use_mach_ports: !cfg!(miri),
+            signal_interruption: false,
             #[cfg(feature = "std")]
             detect_host_feature: Some(detect_host_feature),
             #[cfg(not(feature = "std"))]
@@ -429,6 +471,28 @@ impl Config {
         self
     }
 
+    /// Configures whether the native debug information enabled with
+    /// [`Config::debug_info`] is only registered with a debugger once one is
+    /// attached to the process.
+    ///
+    /// Registering debug information with a debugger requires relocating a
+    /// copy of each module's DWARF, and debuggers such as GDB slow down with
+    /// each registered image, which makes loading many modules slow. With
+    /// this enabled code loaded while no debugger is attached isn't
+    /// registered yet. Instead all such code is registered at once the next
+    /// time code is loaded with a debugger attached, or when
+    /// [`Engine::register_pending_debug_info`](crate::Engine::register_pending_debug_info)
+    /// is called.
+    ///
+    /// Whether a debugger is attached is currently only known on Linux, and
+    /// elsewhere this option has no effect.
+    ///
+    /// By default this option is `false`.
+    pub fn debug_info_lazy(&mut self, enable: bool) -> &mut Self {
+        self.tunables.debug_native_lazy = Some(enable);
+        self
+    }
+
     /// Configures whether compiled guest code will be instrumented to
     /// provide debugging at the Wasm VM level.
     ///
@@ -485,7 +549,8 @@ impl Config {
     /// backtrace. When this option is disabled then this context is never
     /// applied to errors coming out of wasm.
     ///
-    /// This option is `true` by default.
+    /// This option is `true` by default, and can be overridden for individual
+    /// stores with [`Store::set_wasm_backtrace`](crate::Store::set_wasm_backtrace).
     ///
     /// [`WasmBacktrace`]: crate::WasmBacktrace
     pub fn wasm_backtrace(&mut self, enable: bool) -> &mut Self {
@@ -577,6 +642,74 @@ impl Config {
         self
     }
 
+    /// Configures how generated code accounts for the fuel consumed by
+    /// WebAssembly when [`consume_fuel`](Config::consume_fuel) is enabled.
+    ///
+    /// See [`FuelMetering`] for the available modes and their trade-offs. The
+    /// amount of fuel consumed by a given execution is deterministic in every
+    /// mode.
+    ///
+    /// The default value for this is `FuelMetering::PerBlock`.
+    ///
+    /// **Note** Per-loop metering is not supported by the Winch compiler.
+    pub fn fuel_metering(&mut self, metering: FuelMetering) -> &mut Self {
+        self.tunables.fuel_per_loop = Some(metering == FuelMetering::PerLoop);
+        self
+    }
+
+    /// Configures whether generated code counts the number of times each
+    /// function defined in a module is called.
+    ///
+    /// Each instance gets its own set of counters, starting at zero, which
+    /// can be read with [`Instance::function_stats`]. This is intended for
+    /// finding the hot functions of a guest: the cost is one increment of a
+    /// counter in memory on entry to each function.
+    ///
+    /// By default this option is `false`.
+    ///
+    /// **Note** Enabling this option is not compatible with the Winch compiler.
+    ///
+    /// [`Instance::function_stats`]: crate::Instance::function_stats
+    pub fn count_function_calls(&mut self, enable: bool) -> &mut Self {
+        self.tunables.count_function_calls = Some(enable);
+        self
+    }
+
+    /// Configures whether `call_indirect` instructions are optimized for
+    /// tables whose contents can't change after instantiation.
+    ///
+    /// A table qualifies when it's defined by the module itself, isn't
+    /// exported, and isn't modified by any instruction such as `table.set`,
+    /// `table.grow` or `table.init`: the table of function pointers that
+    /// languages such as C and Rust compile to is typically one. For such
+    /// tables:
+    ///
+    /// * Each `call_indirect` site gets a monomorphic inline cache in its
+    ///   instance, which remembers the last table index it called and the
+    ///   function found there. Calls which hit the cache skip the table's
+    ///   bounds check, its lazy initialization and the signature check.
+    ///
+    /// * If every function in the table has the same type then calls with
+    ///   that type skip the signature check altogether, and only check that
+    ///   the callee isn't null.
+    ///
+    /// Finding these tables requires an extra pass over the code of each
+    /// module when compiling it, and the caches take
+    /// `8 + 2 * size_of::<usize>()` bytes of instance memory per
+    /// `call_indirect` instruction in the module, up to a limit of 50,000
+    /// instructions, after which further ones aren't cached. The caches pay
+    /// off for call sites which mostly call the same function, such as the
+    /// dispatch of an interpreter compiled to WebAssembly which keeps
+    /// running the same opcodes in a loop.
+    ///
+    /// By default this option is `false`.
+    ///
+    /// **Note** Enabling this option is not compatible with the Winch compiler.
+    pub fn cache_call_indirects(&mut self, enable: bool) -> &mut Self {
+        self.tunables.cache_call_indirects = Some(enable);
+        self
+    }
+
     /// Enables epoch-based interruption.
     ///
     /// When executing code in async mode, we sometimes want to
@@ -681,6 +814,7 @@ impl Config {
     /// # See Also
     ///
     /// - [`Engine::increment_epoch`](crate::Engine::increment_epoch)
+    /// - [`Engine::start_epoch_ticker`](crate::Engine::start_epoch_ticker)
     /// - [`Store::set_epoch_deadline`](crate::Store::set_epoch_deadline)
     /// - [`Store::epoch_deadline_trap`](crate::Store::epoch_deadline_trap)
     /// - [`Store::epoch_deadline_callback`](crate::Store::epoch_deadline_callback)
@@ -690,6 +824,47 @@ impl Config {
         self
     }
 
+    /// Enables interrupting WebAssembly by signaling the thread that runs it,
+    /// without any instrumentation of the generated code.
+    ///
+    /// Both [fuel](Config::consume_fuel) and
+    /// [epochs](Config::epoch_interruption) insert checks into compiled code,
+    /// in function prologues and loop headers, which cost time even when no
+    /// interruption ever happens. With this option nothing is inserted, and
+    /// instead [`Store::interrupt_handle`](crate::Store::interrupt_handle)
+    /// returns a handle whose
+    /// [`InterruptHandle::interrupt`](crate::InterruptHandle::interrupt) sends
+    /// a signal (`SIGURG`) to the thread running WebAssembly in the store. If
+    /// that thread is executing compiled WebAssembly code, the signal handler
+    /// makes it trap with [`Trap::Interrupt`](crate::Trap::Interrupt) right
+    /// away. Otherwise, for example while it's running a host function, the
+    /// trap happens as soon as it returns to WebAssembly.
+    ///
+    /// Unlike with epochs, interrupted execution can't be resumed: there's no
+    /// equivalent of
+    /// [`Store::epoch_deadline_callback`](crate::Store::epoch_deadline_callback),
+    /// as the code isn't compiled with points at which it could safely call
+    /// back into the host. This option can be combined with epoch
+    /// interruption, for example to use epochs for cooperative yielding and
+    /// signals to cancel runaway execution without waiting for the next epoch
+    /// check.
+    ///
+    /// WebAssembly executed on an async fiber is only interrupted when it
+    /// calls or returns from host functions, since the fiber may move between
+    /// threads.
+    ///
+    /// This requires [signals-based traps](Config::signals_based_traps) and
+    /// [address maps](Config::generate_address_map), which are used to only
+    /// interrupt code at points where its state is consistent, and is only
+    /// supported on Unix with Cranelift. It's not compatible with garbage
+    /// collection, see [`Config::gc_support`].
+    ///
+    /// This option is `false` by default.
+    pub fn signal_interruption(&mut self, enable: bool) -> &mut Self {
+        self.signal_interruption = enable;
+        self
+    }
+
     /// Configures the maximum amount of stack space available for
     /// executing WebAssembly code.
     ///
@@ -796,6 +971,68 @@ impl Config {
         self
     }
 
+    /// Configures how many fiber stacks the on-demand instance allocator keeps
+    /// for reuse once async calls are done with them.
+    ///
+    /// Each store already keeps its most recently used fiber stack, but with
+    /// [`InstanceAllocationStrategy::OnDemand`] a stack released by a store is
+    /// otherwise unmapped, and the next store to make an async call maps a new
+    /// one. With this option up to `size` released stacks are instead cached
+    /// by the engine and shared by all of its stores, avoiding an
+    /// `mmap`/`munmap` round trip per store. Cached stacks stay mapped, using
+    /// up to `size` times [`Config::async_stack_size`] of address space.
+    ///
+    /// Stacks aren't cached when [`Config::async_stack_zeroing`] is enabled.
+    /// The pooling allocator manages its own stacks and ignores this option.
+    /// Cache usage is reported by [`Engine::async_stack_cache_stats`].
+    ///
+    /// This option defaults to 0, disabling the cache.
+    ///
+    /// [`Engine::async_stack_cache_stats`]: crate::Engine::async_stack_cache_stats
+    #[cfg(feature = "async")]
+    pub fn async_stack_cache_size(&mut self, size: usize) -> &mut Self {
+        self.async_stack_cache_size = size;
+        self
+    }
+
+    /// Configures how many continuation stacks the engine keeps for reuse once
+    /// the stores which created them are dropped.
+    ///
+    /// Each continuation created by the stack switching proposal's `cont.new`
+    /// gets its own stack of [`Config::async_stack_size`] bytes, which is
+    /// otherwise mapped when the continuation is created and unmapped when its
+    /// store is dropped. With this option up to `size` released stacks are
+    /// instead cached by the engine and shared by all of its stores, so that
+    /// creating a continuation only takes a stack from the cache. Cached stacks
+    /// stay mapped, using up to `size` times [`Config::async_stack_size`] of
+    /// address space, and are released by [`Engine::trim`]. Cache usage is
+    /// reported by [`Engine::continuation_stack_cache_stats`].
+    ///
+    /// This option defaults to 0, disabling the cache.
+    ///
+    /// [`Engine::trim`]: crate::Engine::trim
+    /// [`Engine::continuation_stack_cache_stats`]: crate::Engine::continuation_stack_cache_stats
+    #[cfg(feature = "stack-switching")]
+    pub fn continuation_stack_cache_size(&mut self, size: usize) -> &mut Self {
+        self.continuation_stack_cache_size = size;
+        self
+    }
+
+    /// Configures how many bytes at the top of each continuation stack cached
+    /// by [`Config::continuation_stack_cache_size`] stay resident.
+    ///
+    /// The rest of a stack's pages are returned to the OS when it's cached.
+    /// Keeping the pages that continuations typically use resident avoids
+    /// page faults when the stack is reused, at the cost of memory held by the
+    /// cache.
+    ///
+    /// This option defaults to 0.
+    #[cfg(feature = "stack-switching")]
+    pub fn continuation_stack_keep_resident(&mut self, size: usize) -> &mut Self {
+        self.continuation_stack_keep_resident = size;
+        self
+    }
+
     /// Explicitly enables (and un-disables) a given set of [`WasmFeatures`].
     ///
     /// Note: this is a low-level method that does not necessarily imply that
@@ -1289,6 +1526,49 @@ impl Config {
         self
     }
 
+    /// Configures whether Wasm code allocates GC objects inline.
+    ///
+    /// With the deferred reference-counting collector, `struct.new`,
+    /// `array.new` and friends otherwise always call into the runtime, which
+    /// finds room for the object in the GC heap's free list. When this is
+    /// enabled they instead bump an index through a region of free space that
+    /// the collector reserves in the GC heap, and only call into the runtime
+    /// once that region is exhausted, to reserve another. This makes
+    /// allocating many short-lived objects much cheaper, at the cost of larger
+    /// code at every allocation site.
+    ///
+    /// The null collector always allocates inline, so this has no effect on
+    /// it.
+    ///
+    /// The default value for this is `false`.
+    #[cfg(feature = "gc")]
+    pub fn gc_inline_alloc(&mut self, enable: bool) -> &mut Self {
+        self.tunables.gc_inline_alloc = Some(enable);
+        self
+    }
+
+    /// Configures the factor by which a store's GC heap is grown when an
+    /// allocation doesn't fit in it.
+    ///
+    /// When an allocation fails the GC heap is first grown, and only collected
+    /// if growing it fails. A larger factor means fewer, but larger, growths
+    /// and so fewer collections at the cost of memory, while a factor of `1.0`
+    /// grows the heap by only as much as the failed allocation needs. The heap
+    /// is always grown by at least that much, and never beyond the limits of
+    /// the GC heap's memory.
+    ///
+    /// The factor must be at least `1.0`, otherwise [`Engine::new`] will
+    /// fail.
+    ///
+    /// The default value for this is `2.0`, doubling the heap on each growth.
+    ///
+    /// [`Engine::new`]: crate::Engine::new
+    #[cfg(feature = "gc")]
+    pub fn gc_heap_growth_factor(&mut self, factor: f64) -> &mut Self {
+        self.gc_heap_growth_factor = factor;
+        self
+    }
+
     /// Creates a default profiler based on the profiling strategy chosen.
     ///
     /// Profiler creation calls the type's default initializer where the purpose is
@@ -1366,6 +1646,34 @@ impl Config {
         self
     }
 
+    /// Configures whether modules are compiled in two tiers.
+    ///
+    /// When enabled, [`Module::new`](crate::Module::new) and the other module
+    /// compilation entry points first compile with Cranelift at
+    /// [`OptLevel::None`], which compiles quickly and lets the module be
+    /// instantiated sooner. The module is then recompiled on a background
+    /// thread with the optimization level configured with
+    /// [`Config::cranelift_opt_level`]. A single such thread is shared by all
+    /// engines in the process, which recompiles modules one at a time. Once
+    /// a module's recompilation finishes, instances created from it use the
+    /// optimized code; instances created before then keep running the
+    /// baseline code.
+    ///
+    /// The state of the optimized tier can be inspected with
+    /// [`Module::optimized_tier`](crate::Module::optimized_tier) and
+    /// [`Module::wait_optimized_tier`](crate::Module::wait_optimized_tier).
+    ///
+    /// Only the Cranelift compilation strategy supports tiering, and
+    /// components are always compiled with the configured optimization level
+    /// directly. Serializing a module serializes the baseline tier.
+    ///
+    /// The default value for this is `false`.
+    #[cfg(feature = "cranelift")]
+    pub fn tiered_compilation(&mut self, enable: bool) -> &mut Self {
+        self.tiered_compilation = enable;
+        self
+    }
+
     /// Configures the regalloc algorithm used by the Cranelift code generator.
     ///
     /// Cranelift can select any of several register allocator algorithms. Each
@@ -1525,6 +1833,8 @@ impl Config {
     ///
     /// Custom memory creators are used when creating host `Memory` objects or when
     /// creating instance linear memories for the on-demand instance allocation strategy.
+    /// The pooling allocator always uses its own memory, but creators can recycle
+    /// memories themselves with [`MemoryCreator::reuse_memory`].
     #[cfg(feature = "runtime")]
     pub fn with_host_memory(&mut self, mem_creator: Arc<dyn MemoryCreator>) -> &mut Self {
         self.mem_creator = Some(Arc::new(MemoryCreatorProxy(mem_creator)));
@@ -1842,6 +2152,78 @@ impl Config {
         self
     }
 
+    /// Configures whether the indices of 64-bit linear memories are masked,
+    /// instead of bounds checked, to keep accesses within
+    /// [`Config::memory_reservation`].
+    ///
+    /// Guard regions can only remove the bounds checks of 32-bit linear
+    /// memories because a 64-bit index can address far more than any
+    /// reservation, so accesses to memories created with
+    /// [`Config::wasm_memory64`] are otherwise always checked explicitly.
+    /// When this option is enabled the reservation is instead treated as a cap
+    /// on the size of 64-bit memories, and each index is masked with
+    /// `memory_reservation - 1` so that every access lands within the
+    /// reservation or its guard region, where out-of-bounds accesses trap
+    /// through virtual memory.
+    ///
+    /// > **Note**: this doesn't implement WebAssembly's semantics exactly. An
+    /// > index of `memory_reservation` or more, which should trap, instead
+    /// > wraps around and accesses memory at the masked index. Accesses can
+    /// > never escape the memory's reservation though, so this doesn't affect
+    /// > the isolation of instances, only the behavior of guests which access
+    /// > memory beyond the cap.
+    ///
+    /// Masking is only applied to accesses to a 64-bit linear memory when:
+    ///
+    /// * Compiling with Cranelift for a 64-bit target.
+    /// * [`Config::memory_reservation`] is a power of two which is at least
+    ///   the minimum size of the memory.
+    /// * [`Config::memory_may_move`] is disabled.
+    /// * [`Config::memory_guard_size`] covers the static offset and size of
+    ///   the access.
+    ///
+    /// Other accesses are bounds checked as usual. The number of bounds
+    /// checks which were elided can be found with
+    /// [`CodeBuilder::compile_module_with_report`].
+    ///
+    /// It's an error to enable this option without
+    /// [`Config::signals_based_traps`], a power-of-two
+    /// [`Config::memory_reservation`], or with [`Config::memory_may_move`]
+    /// enabled.
+    ///
+    /// This option is disabled by default.
+    ///
+    /// [`CodeBuilder::compile_module_with_report`]: crate::CodeBuilder::compile_module_with_report
+    pub fn memory64_index_masking(&mut self, enable: bool) -> &mut Self {
+        self.tunables.memory64_index_masking = Some(enable);
+        self
+    }
+
+    /// Configures compiled code to sample one in every `interval` loads and
+    /// stores to linear memory, recording which page of memory each sampled
+    /// access touched.
+    ///
+    /// The recorded counts can be read with [`Memory::access_histogram`] to
+    /// find which parts of a memory are hot, for example to guide data layout
+    /// or to pick pages to prefetch or keep resident. Sampling is counted per
+    /// [`Store`](crate::Store) across all of its memories, so compiled code
+    /// only decrements a counter on each access and calls into the runtime
+    /// when it reaches zero. Larger intervals therefore add less overhead but
+    /// give a coarser picture of the accesses.
+    ///
+    /// Only accesses made by load, store and atomic instructions are sampled,
+    /// not those of bulk memory instructions such as `memory.copy`, and
+    /// accesses to shared memories aren't recorded.
+    ///
+    /// An `interval` of zero disables sampling, which is the default. It's an
+    /// error to enable sampling when compiling with Winch.
+    ///
+    /// [`Memory::access_histogram`]: crate::Memory::access_histogram
+    pub fn memory_access_sampling(&mut self, interval: u32) -> &mut Self {
+        self.tunables.memory_access_sample_interval = Some(interval);
+        self
+    }
+
     /// Configures the size, in bytes, of the extra virtual memory space
     /// reserved after a linear memory is relocated.
     ///
@@ -1907,6 +2289,119 @@ impl Config {
         self
     }
 
+    /// Configures whether linear memories which move when they grow reserve
+    /// room for growth in proportion to their size.
+    ///
+    /// With a fixed [`Config::memory_reservation_for_growth`], a guest which
+    /// grows its memory one page at a time moves it every time it outgrows
+    /// the reservation, and each move copies all of memory, so the total
+    /// number of bytes copied is quadratic in the final size of memory. When
+    /// this option is enabled then a moved memory reserves at least as many
+    /// bytes for growth as its new size, but no more than its maximum size,
+    /// so its capacity at least doubles with each move and the total number
+    /// of bytes copied is linear instead.
+    ///
+    /// This only affects memories which can move, see
+    /// [`Config::memory_may_move`], and which are allocated with virtual
+    /// memory by Wasmtime. The number of moves and bytes copied can be
+    /// observed with [`Memory::growth_stats`](crate::Memory::growth_stats).
+    ///
+    /// The default value for this option is `false`.
+    pub fn memory_reservation_for_growth_geometric(&mut self, enable: bool) -> &mut Self {
+        self.tunables.memory_reservation_for_growth_geometric = Some(enable);
+        self
+    }
+
+    /// Configures whether the pages of linear memories are populated eagerly
+    /// when memories are created and grown.
+    ///
+    /// By default the host's pages backing a linear memory are only allocated
+    /// by the operating system when wasm first touches them, and each first
+    /// touch takes a page fault. For latency-sensitive workloads these faults
+    /// can show up as unpredictable pauses in the middle of execution. When
+    /// this option is enabled then all accessible pages of a linear memory
+    /// are faulted in up-front when it's created, and newly accessible pages
+    /// are faulted in as part of [`Memory::grow`](crate::Memory::grow), so
+    /// their cost is paid by instantiation and growth instead.
+    ///
+    /// This trades memory for predictability: every page of a memory
+    /// occupies physical memory as soon as it's accessible, even if it's
+    /// never used. Memories can also be populated for individual growth
+    /// requests with [`Memory::grow_populated`](crate::Memory::grow_populated).
+    ///
+    /// Populating is best-effort. On Linux it uses `MADV_POPULATE_WRITE` for
+    /// anonymous memory and `MADV_POPULATE_READ` for the parts of a memory
+    /// which map a file, such as its copy-on-write image, so that those pages
+    /// stay shared rather than being copied up-front, and falls back to
+    /// `MADV_WILLNEED` on kernels which support neither. On other platforms
+    /// this option currently has no effect.
+    ///
+    /// The default value for this option is `false`.
+    pub fn memory_populate(&mut self, enable: bool) -> &mut Self {
+        self.tunables.memory_populate = Some(enable);
+        self
+    }
+
+    /// Configures whether linear memories ask the operating system to back
+    /// them with transparent huge pages.
+    ///
+    /// Memory-intensive guests which access large amounts of linear memory
+    /// can spend a noticeable amount of time on TLB misses with the host's
+    /// default page size. Backing linear memory with huge pages, 2MiB on
+    /// x86\_64 Linux for example, reduces the number of TLB entries needed to
+    /// cover it. When this is enabled the virtual memory reserved for each
+    /// linear memory is marked with `MADV_HUGEPAGE`, and the kernel then uses
+    /// huge pages for the 2MiB-aligned parts of it which are written to. This
+    /// also applies to slots of the pooling allocator, and combines with
+    /// [`Config::memory_populate`] to fault in huge pages up-front.
+    ///
+    /// The downside of huge pages is that memory is allocated, and zeroed, in
+    /// much larger units, so a memory which only touches a few bytes of each
+    /// 2MiB region may use far more physical memory than it otherwise would.
+    /// Pages initialized from a module's copy-on-write image with
+    /// [`Config::memory_init_cow`] are also not backed by huge pages until
+    /// they're written to and the kernel collapses them.
+    ///
+    /// * [`Enabled::No`] - the host's default policy is used, which on Linux
+    ///   is configured in `/sys/kernel/mm/transparent_hugepage/enabled`.
+    /// * [`Enabled::Auto`] - huge pages are requested if the host supports
+    ///   them.
+    /// * [`Enabled::Yes`] - huge pages are requested and creating an
+    ///   [`Engine`] fails if the host doesn't support them.
+    ///
+    /// Transparent huge pages are currently only supported on Linux. This
+    /// defaults to [`Enabled::No`].
+    pub fn memory_huge_pages(&mut self, enable: Enabled) -> &mut Self {
+        self.memory_huge_pages = enable;
+        self
+    }
+
+    /// Configures whether compiled code asks the operating system to back it
+    /// with transparent huge pages.
+    ///
+    /// This is similar to [`Config::memory_huge_pages`] except that it
+    /// applies to the text section of compiled modules and components, which
+    /// can reduce instruction TLB misses for very large modules. Only the
+    /// 2MiB-aligned parts of the text section can be backed by huge pages, so
+    /// this has no effect on small modules. Code loaded from a file, for
+    /// example with [`Module::deserialize_file`](crate::Module::deserialize_file),
+    /// additionally requires the kernel to support huge pages for read-only
+    /// file mappings.
+    ///
+    /// Transparent huge pages are currently only supported on Linux. This
+    /// defaults to [`Enabled::No`].
+    pub fn code_huge_pages(&mut self, enable: Enabled) -> &mut Self {
+        self.code_huge_pages = enable;
+        self
+    }
+
+    /// Tests whether [`Config::memory_huge_pages`] and
+    /// [`Config::code_huge_pages`] are supported by the host system.
+    #[cfg(feature = "runtime")]
+    pub fn are_huge_pages_available() -> bool {
+        crate::runtime::vm::huge_pages_available()
+    }
+
     /// Indicates whether a guard region is present before allocations of
     /// linear memory.
     ///
@@ -1946,6 +2441,29 @@ impl Config {
         self
     }
 
+    /// Configures funcref tables with fewer than `elements` initial elements
+    /// to be initialized eagerly even when [`Config::table_lazy_init`] is
+    /// enabled.
+    ///
+    /// Lazy table initialization makes every `call_indirect` and `table.get`
+    /// check whether the element it reads is initialized, and initializes it
+    /// with a call into the runtime the first time. Compiled code skips that
+    /// check for the tables defined by a module which are initialized eagerly
+    /// instead, trading a little instantiation time for steadier call
+    /// latency. Imported tables are always checked.
+    ///
+    /// The number of elements initialized lazily so far is reported by
+    /// [`Instance::lazy_table_inits`](crate::Instance::lazy_table_inits).
+    ///
+    /// ## Default
+    ///
+    /// This value defaults to 0, meaning that tables are always initialized
+    /// lazily.
+    pub fn table_eager_init_threshold(&mut self, elements: u64) -> &mut Self {
+        self.tunables.table_eager_init_threshold = Some(elements);
+        self
+    }
+
     /// Configure the version information used in serialized and deserialized [`crate::Module`]s.
     /// This effects the behavior of [`crate::Module::serialize()`], as well as
     /// [`crate::Module::deserialize()`] and related functions.
@@ -1978,6 +2496,65 @@ impl Config {
         self
     }
 
+    /// Configures the number of threads used to compile modules in parallel.
+    ///
+    /// By default parallel compilation uses the global `rayon` thread pool,
+    /// which is shared with anything else in the process using `rayon` and
+    /// has one thread per CPU. When this option is set the [`Engine`] instead
+    /// creates its own pool with `threads` threads, shared by all clones of
+    /// the engine, which bounds how much of the host compilation can occupy.
+    ///
+    /// A value of `0` selects the number of available CPUs.
+    ///
+    /// This has no effect if [`Config::parallel_compilation`] is disabled.
+    ///
+    /// [`Engine`]: crate::Engine
+    #[cfg(feature = "parallel-compilation")]
+    pub fn compilation_threads(&mut self, threads: usize) -> &mut Self {
+        self.compilation_threads = Some(threads);
+        self
+    }
+
+    /// Configures a function to run at the start of each of the engine's
+    /// compilation threads.
+    ///
+    /// The function is passed the index of the thread within the pool, and
+    /// runs on that thread before it compiles anything. This is the place to
+    /// pin threads to particular cores or lower their scheduling priority so
+    /// that compilation stays off of latency-critical cores.
+    ///
+    /// Setting this implies that the engine uses its own thread pool, as with
+    /// [`Config::compilation_threads`].
+    #[cfg(feature = "parallel-compilation")]
+    pub fn compilation_thread_start_handler(
+        &mut self,
+        handler: impl Fn(usize) + Send + Sync + 'static,
+    ) -> &mut Self {
+        self.compilation_thread_start = Some(Arc::new(handler));
+        self
+    }
+
+    /// Configures the maximum amount of time that compiling a single module
+    /// or component may take.
+    ///
+    /// Compiling untrusted input can take an unbounded amount of time, for
+    /// example a module with a very large number of functions or functions
+    /// which are pathological for the optimizer. With a deadline configured
+    /// compilation which runs past it is abandoned and fails with a
+    /// [`CompileDeadlineExceeded`](crate::CompileDeadlineExceeded) error,
+    /// which can be detected with [`Error::is`](crate::Error::is).
+    ///
+    /// The deadline is checked before each function is translated and before
+    /// it's optimized and lowered to machine code, so compilation may overrun
+    /// the deadline by up to the time it takes to compile one function.
+    ///
+    /// By default there is no deadline.
+    #[cfg(any(feature = "cranelift", feature = "winch"))]
+    pub fn compile_deadline(&mut self, deadline: core::time::Duration) -> &mut Self {
+        self.compile_deadline = Some(deadline);
+        self
+    }
+
     /// Configures whether compiled artifacts will contain information to map
     /// native program addresses back to the original wasm module.
     ///
@@ -2081,6 +2658,24 @@ impl Config {
         self
     }
 
+    /// Configures an [`EventSink`](crate::EventSink) which records
+    /// compilations, instantiations, traps, memory growth and garbage
+    /// collections across all stores of engines created with this
+    /// configuration.
+    ///
+    /// Events are buffered per thread until they're drained with
+    /// [`EventSink::drain`](crate::EventSink::drain), see [`EventSink`] for
+    /// more information. Engines without a sink record nothing.
+    ///
+    /// This option is `None` by default.
+    ///
+    /// [`EventSink`]: crate::EventSink
+    #[cfg(all(feature = "runtime", feature = "std"))]
+    pub fn event_sink(&mut self, sink: Option<crate::EventSink>) -> &mut Self {
+        self.event_sink = sink;
+        self
+    }
+
     /// Enables memory error checking for wasm programs.
     ///
     /// This option is disabled by default.
@@ -2379,6 +2974,11 @@ impl Config {
             bail!("support for GC was disabled at compile time")
         }
 
+        #[cfg(feature = "gc")]
+        if !(self.gc_heap_growth_factor >= 1.0) {
+            bail!("gc_heap_growth_factor must be at least 1.0");
+        }
+
         if !cfg!(feature = "gc") && features.contains(WasmFeatures::EXCEPTIONS) {
             bail!("exceptions support requires garbage collection (GC) to be enabled in the build");
         }
@@ -2433,6 +3033,9 @@ impl Config {
 
         self.tunables.configure(&mut tunables);
 
+        tunables.memory_huge_pages = Self::huge_pages(self.memory_huge_pages)?;
+        tunables.code_huge_pages = Self::huge_pages(self.code_huge_pages)?;
+
         // If we're going to compile with winch, we must use the winch calling convention.
         #[cfg(any(feature = "cranelift", feature = "winch"))]
         {
@@ -2458,6 +3061,80 @@ impl Config {
             None
         };
 
+        if tunables.memory64_index_masking {
+            ensure!(
+                tunables.signals_based_traps,
+                "memory64 index masking requires signals-based traps"
+            );
+            ensure!(
+                tunables.memory_reservation.is_power_of_two(),
+                "memory64 index masking requires the memory reservation to be a power of two"
+            );
+            ensure!(
+                !tunables.memory_may_move,
+                "memory64 index masking requires that memories can't move"
+            );
+        }
+
+        if tunables.memory_access_sample_interval != 0 {
+            ensure!(
+                !tunables.winch_callable,
+                "memory access sampling is not supported by Winch"
+            );
+        }
+
+        if tunables.fuel_per_loop {
+            ensure!(
+                !tunables.winch_callable,
+                "per-loop fuel metering is not supported by Winch"
+            );
+        }
+
+        if tunables.count_function_calls {
+            ensure!(
+                !tunables.winch_callable,
+                "function call counting is not supported by Winch"
+            );
+        }
+
+        if tunables.cache_call_indirects {
+            ensure!(
+                !tunables.winch_callable,
+                "call_indirect caching is not supported by Winch"
+            );
+        }
+
+        if self.signal_interruption {
+            ensure!(
+                cfg!(all(feature = "std", unix, has_native_signals)),
+                "signal-based interruption is not supported on this platform"
+            );
+            ensure!(
+                tunables.signals_based_traps,
+                "signal-based interruption requires signals-based traps"
+            );
+            ensure!(
+                tunables.generate_address_map,
+                "signal-based interruption requires address maps"
+            );
+            ensure!(
+                !tunables.winch_callable,
+                "signal-based interruption is not supported by Winch"
+            );
+            ensure!(
+                !self.compiler_target().is_pulley(),
+                "signal-based interruption is not supported by Pulley"
+            );
+            // Compiled code may be in the middle of updating the GC heap, for
+            // example between writing a reference and its reference count, at
+            // any point where it could be interrupted.
+            ensure!(
+                !features.gc_types(),
+                "signal-based interruption is not compatible with GC, \
+                 see `Config::gc_support`"
+            );
+        }
+
         if tunables.debug_guest {
             ensure!(
                 cfg!(feature = "debug"),
@@ -2515,6 +3192,10 @@ impl Config {
                 if let Some(stack_creator) = &self.stack_creator {
                     _allocator.set_stack_creator(stack_creator.clone());
                 }
+                #[cfg(feature = "async")]
+                if !stack_zeroing {
+                    _allocator.set_stack_cache_size(self.async_stack_cache_size);
+                }
                 Ok(_allocator as _)
             }
             #[cfg(feature = "pooling-allocator")]
@@ -2576,6 +3257,54 @@ impl Config {
         })
     }
 
+    #[cfg(feature = "parallel-compilation")]
+    pub(crate) fn build_compilation_pool(&self) -> Result<Option<rayon::ThreadPool>> {
+        if !self.parallel_compilation
+            || (self.compilation_threads.is_none() && self.compilation_thread_start.is_none())
+        {
+            return Ok(None);
+        }
+        let mut builder = rayon::ThreadPoolBuilder::new()
+            .num_threads(self.compilation_threads.unwrap_or(0))
+            .thread_name(|i| format!("wasmtime-compile-{i}"));
+        if let Some(start) = self.compilation_thread_start.clone() {
+            builder = builder.start_handler(move |i| start(i));
+        }
+        let pool = builder
+            .build()
+            .context("failed to create compilation thread pool")?;
+        Ok(Some(pool))
+    }
+
+    /// Builds the compiler used for all compilation, and additionally the
+    /// compiler for the optimized tier if tiered compilation is enabled.
+    #[cfg(any(feature = "cranelift", feature = "winch"))]
+    pub(crate) fn build_compilers(
+        self,
+        tunables: &mut Tunables,
+        features: WasmFeatures,
+    ) -> Result<(
+        Self,
+        Box<dyn wasmtime_environ::Compiler>,
+        Option<Box<dyn wasmtime_environ::Compiler>>,
+    )> {
+        #[cfg(feature = "cranelift")]
+        if self.tiered_compilation {
+            let strategy = self.compiler_config.as_ref().and_then(|c| c.strategy);
+            if strategy != Some(Strategy::Cranelift) {
+                bail!("tiered compilation requires the Cranelift compilation strategy");
+            }
+            let mut baseline = self.clone();
+            baseline.cranelift_opt_level(OptLevel::None);
+            let (_, baseline) = baseline.build_compiler(tunables, features)?;
+            let (config, optimized) = self.build_compiler(tunables, features)?;
+            return Ok((config, baseline, Some(optimized)));
+        }
+
+        let (config, compiler) = self.build_compiler(tunables, features)?;
+        Ok((config, compiler, None))
+    }
+
     #[cfg(any(feature = "cranelift", feature = "winch"))]
     pub(crate) fn build_compiler(
         mut self,
@@ -3013,6 +3742,22 @@ impl Config {
         self
     }
 
+    /// Resolves the `Enabled` setting of a huge page option.
+    fn huge_pages(enable: Enabled) -> Result<bool> {
+        #[cfg(feature = "runtime")]
+        let available = crate::runtime::vm::huge_pages_available();
+        #[cfg(not(feature = "runtime"))]
+        let available = false;
+        match enable {
+            Enabled::Auto => Ok(available),
+            Enabled::Yes if available => Ok(true),
+            Enabled::Yes => bail!(
+                "required to use transparent huge pages but this system does not support them"
+            ),
+            Enabled::No => Ok(false),
+        }
+    }
+
     /// Validate if the current configuration has conflicting overrides that prevent
     /// execution determinism. Returns an error if a conflict exists.
     ///
@@ -3076,6 +3821,12 @@ impl fmt::Debug for Config {
         }
 
         f.field("parallel_compilation", &self.parallel_compilation);
+        #[cfg(feature = "parallel-compilation")]
+        f.field("compilation_threads", &self.compilation_threads);
+        #[cfg(feature = "cranelift")]
+        f.field("tiered_compilation", &self.tiered_compilation);
+        #[cfg(any(feature = "cranelift", feature = "winch"))]
+        f.field("compile_deadline", &self.compile_deadline);
         #[cfg(any(feature = "cranelift", feature = "winch"))]
         {
             f.field("compiler_config", &self.compiler_config);
@@ -3275,6 +4026,30 @@ pub enum OptLevel {
     SpeedAndSize,
 }
 
+/// Possible ways for generated code to account for fuel, configured with
+/// [`Config::fuel_metering`].
+#[non_exhaustive]
+#[derive(Copy, Clone, Debug, Default, Eq, PartialEq)]
+pub enum FuelMetering {
+    /// Each basic block executed consumes one unit of fuel per instruction
+    /// in it.
+    ///
+    /// This closely tracks the number of instructions executed, but updates
+    /// the fuel counter at the end of every basic block.
+    #[default]
+    PerBlock,
+    /// Each iteration of a loop consumes one unit of fuel per instruction in
+    /// the loop's body, and each call of a function one unit per instruction
+    /// in the function outside of its loops, whether or not the instructions
+    /// are executed.
+    ///
+    /// The fuel counter is only updated on function entry and at loop headers,
+    /// making this cheaper for compute-heavy code with many branches. Fuel is
+    /// charged up front for the whole body, so it overestimates the fuel
+    /// consumed by code which branches over, or out of, parts of a body.
+    PerLoop,
+}
+
 /// Possible register allocator algorithms for the Cranelift codegen backend.
 #[non_exhaustive]
 #[derive(Copy, Clone, Debug, Eq, PartialEq)]
@@ -3342,7 +4117,8 @@ pub enum WasmBacktraceDetails {
     Environment,
 }
 
-/// Describe the tri-state configuration of keys such as MPK or PAGEMAP_SCAN.
+/// Describe the tri-state configuration of keys such as MPK, PAGEMAP_SCAN or
+/// huge pages.
 #[derive(Clone, Copy, Debug, Eq, PartialEq, Hash)]
 pub enum Enabled {
     /// Enable this feature if it's detected on the host system, otherwise leave
@@ -3530,6 +4306,54 @@ impl PoolingAllocationConfig {
         self
     }
 
+    /// Whether to reset and decommit deallocated memories, tables, and stacks
+    /// on a dedicated background thread.
+    ///
+    /// By default the thread that drops a [`Store`](crate::Store) performs
+    /// the work of returning its slots to the pool: zeroing the memory kept
+    /// resident by options such as
+    /// [`PoolingAllocationConfig::linear_memory_keep_resident`], and issuing
+    /// the system calls that decommit the rest. When this option is enabled
+    /// that work is instead handed to a background thread, spawned lazily on
+    /// first use, which keeps it off latency-sensitive request paths.
+    ///
+    /// Slots being processed by the background thread can't be reused until
+    /// it's done with them. If an allocation fails because a pool is
+    /// exhausted, the allocator waits for the background thread to catch up
+    /// before retrying.
+    ///
+    /// Defaults to `false`.
+    pub fn background_decommit(&mut self, enable: bool) -> &mut Self {
+        self.config.background_decommit = enable;
+        self
+    }
+
+    /// Whether linear memories are placed on the NUMA node of the thread
+    /// which allocates them.
+    ///
+    /// Slots in the pool are reused by whichever store allocates next, so on
+    /// hosts with several NUMA nodes a slot's resident pages are often on a
+    /// different node than the thread which runs the new store, and every
+    /// access to them pays the cost of crossing between sockets. When this
+    /// option is enabled each linear memory allocated from the pool is bound
+    /// to the node of the CPU that the allocating thread is running on, which
+    /// moves pages which are still resident from the slot's previous use and
+    /// places pages faulted in later on that node as well. Stores configured
+    /// with [`Store::set_numa_node`](crate::Store::set_numa_node) use their
+    /// own node instead.
+    ///
+    /// This is most effective when each store is created and run on worker
+    /// threads pinned to a single node. Placement is a preference rather than
+    /// a requirement, so memory is still allocated on other nodes if the
+    /// preferred node is out of memory.
+    ///
+    /// NUMA placement is currently only supported on Linux. This defaults to
+    /// `false`.
+    pub fn numa_local_memory(&mut self, enable: bool) -> &mut Self {
+        self.config.numa_local_memory = enable;
+        self
+    }
+
     /// How much memory, in bytes, to keep resident for async stacks allocated
     /// with the pooling allocator.
     ///
@@ -4045,6 +4869,7 @@ fn detect_host_feature(feature: &str) -> Option<bool> {
             "avx512f" => Some(std::is_x86_feature_detected!("avx512f")),
             "avx512vl" => Some(std::is_x86_feature_detected!("avx512vl")),
             "avx512vbmi" => Some(std::is_x86_feature_detected!("avx512vbmi")),
+            "avx512vnni" => Some(std::is_x86_feature_detected!("avx512vnni")),
             "lzcnt" => Some(std::is_x86_feature_detected!("lzcnt")),
 
             _ => None,
@@ -18,7 +18,41 @@ use std::{fs::File, path::Path};
 use wasmparser::WasmFeatures;
 use wasmtime_environ::{FlagValue, ObjectKind, TripleExt, Tunables};
 
+mod compression;
+mod multi_target;
 mod serialization;
+pub use serialization::SerializedModuleInfo;
+#[cfg(all(feature = "runtime", feature = "std", target_has_atomic = "64"))]
+pub(crate) mod epoch_ticker;
+#[cfg(feature = "runtime")]
+mod events;
+#[cfg(all(feature = "runtime", feature = "std", target_os = "linux"))]
+mod memory_pressure;
+#[cfg(feature = "runtime")]
+mod stats;
+
+#[cfg(feature = "runtime")]
+pub(crate) use events::EventStart;
+#[cfg(feature = "runtime")]
+pub use events::RuntimeEventKind;
+#[cfg(all(feature = "runtime", feature = "std"))]
+pub use events::{EventSink, RuntimeEvent};
+#[cfg(all(feature = "runtime", feature = "async"))]
+pub use stats::AsyncStackCacheStats;
+#[cfg(feature = "runtime")]
+pub(crate) use stats::CodeStats;
+#[cfg(all(feature = "runtime", feature = "stack-switching"))]
+pub use stats::ContinuationStackCacheStats;
+#[cfg(feature = "runtime")]
+pub use stats::EngineStats;
+
+#[cfg(feature = "cranelift")]
+std::thread_local! {
+    /// Whether the current thread is compiling the optimized tier of a module,
+    /// see `Engine::with_optimized_tier`.
+    static COMPILING_OPTIMIZED_TIER: core::cell::Cell<bool> =
+        const { core::cell::Cell::new(false) };
+}
 
 /// An `Engine` which is a global context for compilation and management of wasm
 /// modules.
@@ -53,6 +87,18 @@ struct EngineInner {
     tunables: Tunables,
     #[cfg(any(feature = "cranelift", feature = "winch"))]
     compiler: Option<Box<dyn wasmtime_environ::Compiler>>,
+    /// The compiler for the optimized tier when tiered compilation is
+    /// enabled, in which case `compiler` is the baseline compiler.
+    #[cfg(any(feature = "cranelift", feature = "winch"))]
+    tier_up_compiler: Option<Box<dyn wasmtime_environ::Compiler>>,
+    /// The engine's own compilation thread pool, if configured, otherwise
+    /// parallel compilation uses rayon's global pool.
+    #[cfg(feature = "parallel-compilation")]
+    compilation_pool: Option<rayon::ThreadPool>,
+    /// Set in a forked child process, where the threads of the compilation
+    /// pools no longer exist, see `Engine::after_fork_child`.
+    #[cfg(feature = "parallel-compilation")]
+    compile_serially: core::sync::atomic::AtomicBool,
     #[cfg(feature = "runtime")]
     allocator: Box<dyn crate::runtime::vm::InstanceAllocator + Send + Sync>,
     #[cfg(feature = "runtime")]
@@ -61,8 +107,20 @@ struct EngineInner {
     profiler: Box<dyn crate::profiling_agent::ProfilingAgent>,
     #[cfg(feature = "runtime")]
     signatures: TypeRegistry,
+    #[cfg(feature = "runtime")]
+    code_stats: CodeStats,
     #[cfg(all(feature = "runtime", target_has_atomic = "64"))]
-    epoch: AtomicU64,
+    epoch: EpochCounter,
+    /// The engine's ticker, see `Engine::start_epoch_ticker`.
+    #[cfg(all(feature = "runtime", feature = "std", target_has_atomic = "64"))]
+    epoch_ticker: std::sync::OnceLock<Arc<epoch_ticker::EpochTicker>>,
+    /// The thread of `Engine::trim_on_memory_pressure`, if it was called.
+    #[cfg(all(feature = "runtime", feature = "std", target_os = "linux"))]
+    memory_pressure_watcher: memory_pressure::Watcher,
+    /// Stacks of continuations of dropped stores, see
+    /// `Config::continuation_stack_cache_size`.
+    #[cfg(all(feature = "runtime", feature = "stack-switching"))]
+    continuation_stacks: crate::runtime::vm::VMContinuationStackCache,
 
     /// One-time check of whether the compiler's settings, if present, are
     /// compatible with the native host.
@@ -73,8 +131,31 @@ struct EngineInner {
     /// heap.
     #[cfg(feature = "runtime")]
     empty_module_runtime_info: ModuleRuntimeInfo,
+
+    /// Modules compiled by `Linker::instantiate_pre_specialized`.
+    #[cfg(all(feature = "runtime", any(feature = "cranelift", feature = "winch")))]
+    specialized_modules: crate::runtime::module::SpecializedModules,
+
+    /// Modules compiled by `Engine::compile_cached`.
+    #[cfg(all(feature = "runtime", any(feature = "cranelift", feature = "winch")))]
+    cached_modules: crate::runtime::module::CachedModules,
 }
 
+/// The epoch counter of an engine, aligned to keep it on a cache line of its
+/// own.
+///
+/// Every thread running wasm with epoch interruption reads the counter in its
+/// epoch checks, so writes to neighboring fields of the engine, such as code
+/// statistics, would otherwise evict it from their caches. Some processors
+/// prefetch pairs of 64-byte lines, hence the larger alignment on those.
+#[cfg(all(feature = "runtime", target_has_atomic = "64"))]
+#[cfg_attr(any(target_arch = "x86_64", target_arch = "aarch64"), repr(align(128)))]
+#[cfg_attr(
+    not(any(target_arch = "x86_64", target_arch = "aarch64")),
+    repr(align(64))
+)]
+struct EpochCounter(AtomicU64);
+
 impl core::fmt::Debug for Engine {
     fn fmt(&self, f: &mut core::fmt::Formatter<'_>) -> core::fmt::Result {
         f.debug_tuple("Engine")
@@ -113,6 +194,10 @@ impl Engine {
             // handlers, etc.
             #[cfg(has_native_signals)]
             crate::runtime::vm::init_traps(config.macos_use_mach_ports);
+            #[cfg(all(feature = "std", unix, has_native_signals))]
+            if config.signal_interruption {
+                crate::runtime::vm::init_interrupts();
+            }
             if !cfg!(miri) {
                 #[cfg(all(has_host_compiler_backend, feature = "debug-builtins"))]
                 crate::runtime::vm::debug_builtins::init();
@@ -120,11 +205,12 @@ impl Engine {
         }
 
         #[cfg(any(feature = "cranelift", feature = "winch"))]
-        let (config, compiler) = if config.has_compiler() {
-            let (config, compiler) = config.build_compiler(&mut tunables, features)?;
-            (config, Some(compiler))
+        let (config, compiler, tier_up_compiler) = if config.has_compiler() {
+            let (config, compiler, tier_up_compiler) =
+                config.build_compilers(&mut tunables, features)?;
+            (config, Some(compiler), tier_up_compiler)
         } else {
-            (config.clone(), None)
+            (config.clone(), None, None)
         };
         #[cfg(not(any(feature = "cranelift", feature = "winch")))]
         let _ = &mut tunables;
@@ -138,6 +224,12 @@ impl Engine {
             inner: try_new::<Arc<_>>(EngineInner {
                 #[cfg(any(feature = "cranelift", feature = "winch"))]
                 compiler,
+                #[cfg(any(feature = "cranelift", feature = "winch"))]
+                tier_up_compiler,
+                #[cfg(feature = "parallel-compilation")]
+                compilation_pool: config.build_compilation_pool()?,
+                #[cfg(feature = "parallel-compilation")]
+                compile_serially: Default::default(),
                 #[cfg(feature = "runtime")]
                 allocator: {
                     let allocator = config.build_allocator(&tunables)?;
@@ -156,14 +248,29 @@ impl Engine {
                 profiler: config.build_profiler()?,
                 #[cfg(feature = "runtime")]
                 signatures: TypeRegistry::new(),
+                #[cfg(feature = "runtime")]
+                code_stats: CodeStats::default(),
                 #[cfg(all(feature = "runtime", target_has_atomic = "64"))]
-                epoch: AtomicU64::new(0),
+                epoch: EpochCounter(AtomicU64::new(0)),
+                #[cfg(all(feature = "runtime", feature = "std", target_has_atomic = "64"))]
+                epoch_ticker: Default::default(),
+                #[cfg(all(feature = "runtime", feature = "std", target_os = "linux"))]
+                memory_pressure_watcher: Default::default(),
+                #[cfg(all(feature = "runtime", feature = "stack-switching"))]
+                continuation_stacks: crate::runtime::vm::VMContinuationStackCache::new(
+                    config.continuation_stack_cache_size,
+                    config.continuation_stack_keep_resident,
+                ),
                 compatible_with_native_host: Default::default(),
                 config,
                 tunables,
                 features,
                 #[cfg(feature = "runtime")]
                 empty_module_runtime_info,
+                #[cfg(all(feature = "runtime", any(feature = "cranelift", feature = "winch")))]
+                specialized_modules: Default::default(),
+                #[cfg(all(feature = "runtime", any(feature = "cranelift", feature = "winch")))]
+                cached_modules: Default::default(),
             })?,
         })
     }
@@ -189,17 +296,20 @@ impl Engine {
         input: Vec<A>,
         f: F,
     ) -> Result<Vec<B>, E> {
-        if self.config().parallel_compilation {
+        if self.compiles_in_parallel() {
             #[cfg(feature = "parallel-compilation")]
             {
                 use rayon::prelude::*;
                 // If we collect into Result<Vec<B>, E> directly, the returned error is not
                 // deterministic, because any error could be returned early. So we first materialize
                 // all results in order and then return the first error deterministically, or Ok(_).
-                return input
-                    .into_par_iter()
-                    .map(|a| f(a))
-                    .collect::<Vec<Result<B, E>>>()
+                return self
+                    .install_compilation_pool(|| {
+                        input
+                            .into_par_iter()
+                            .map(|a| f(a))
+                            .collect::<Vec<Result<B, E>>>()
+                    })
                     .into_iter()
                     .collect::<Result<Vec<B>, E>>();
             }
@@ -223,7 +333,7 @@ impl Engine {
         input: &mut [T],
         f: F,
     ) -> Result<(), E> {
-        if self.config().parallel_compilation {
+        if self.compiles_in_parallel() {
             #[cfg(feature = "parallel-compilation")]
             {
                 use rayon::prelude::*;
@@ -232,10 +342,13 @@ impl Engine {
                 // returned early. So we first materialize all results in order
                 // and then return the first error deterministically, or
                 // `Ok(_)`.
-                return input
-                    .into_par_iter()
-                    .map(|a| f(a))
-                    .collect::<Vec<Result<(), E>>>()
+                return self
+                    .install_compilation_pool(|| {
+                        input
+                            .into_par_iter()
+                            .map(|a| f(a))
+                            .collect::<Vec<Result<(), E>>>()
+                    })
                     .into_iter()
                     .collect::<Result<(), E>>();
             }
@@ -247,6 +360,28 @@ impl Engine {
         input.into_iter().map(|a| f(a)).collect::<Result<(), E>>()
     }
 
+    fn compiles_in_parallel(&self) -> bool {
+        #[cfg(feature = "parallel-compilation")]
+        if self
+            .inner
+            .compile_serially
+            .load(core::sync::atomic::Ordering::Relaxed)
+        {
+            return false;
+        }
+        self.config().parallel_compilation
+    }
+
+    /// Runs `f` within this engine's compilation thread pool, if it has one,
+    /// so that any parallel iterators inside it run on that pool.
+    #[cfg(feature = "parallel-compilation")]
+    fn install_compilation_pool<R: Send>(&self, f: impl FnOnce() -> R + Send) -> R {
+        match &self.inner.compilation_pool {
+            Some(pool) => pool.install(f),
+            None => f(),
+        }
+    }
+
     /// Take a weak reference to this engine.
     pub fn weak(&self) -> EngineWeak {
         EngineWeak {
@@ -309,6 +444,76 @@ impl Engine {
         serialization::detect_precompiled_bytes(bytes)
     }
 
+    /// Compresses a precompiled module or component so that it's cheaper to
+    /// store and transfer.
+    ///
+    /// The `bytes` must be the output of [`Engine::precompile_module`],
+    /// [`Engine::precompile_component`],
+    /// [`Module::serialize`](crate::Module::serialize) or
+    /// [`Component::serialize`](crate::component::Component::serialize).
+    /// They are compressed with zstd at the given `level`, in independently
+    /// compressed chunks which never span the boundary of a section of the
+    /// artifact, and which are compressed in parallel when
+    /// [`Config::parallel_compilation`](crate::Config::parallel_compilation)
+    /// is enabled.
+    ///
+    /// The compressed artifact can be passed to
+    /// [`Module::deserialize`](crate::Module::deserialize),
+    /// [`Module::deserialize_file`](crate::Module::deserialize_file) and their
+    /// `Component` counterparts like the original, and is recognized by
+    /// [`Engine::detect_precompiled`]. It's decompressed into anonymous memory
+    /// when it's loaded, in parallel when parallel compilation is enabled, so
+    /// unlike an uncompressed artifact loaded with `deserialize_file` its
+    /// pages aren't shared with other processes through the page cache. It
+    /// can't be loaded with `deserialize_raw`.
+    #[cfg(feature = "compressed-artifacts")]
+    pub fn compress_precompiled(&self, bytes: &[u8], level: i32) -> Result<Vec<u8>> {
+        compression::compress(self, bytes, level)
+    }
+
+    /// Bundles several variants of the same precompiled module or component
+    /// into one multi-target artifact, from which the best variant for the
+    /// host is picked when it's loaded.
+    ///
+    /// Each of `variants` must be the output of
+    /// [`Engine::precompile_module`], [`Engine::precompile_component`],
+    /// [`Module::serialize`](crate::Module::serialize) or
+    /// [`Component::serialize`](crate::component::Component::serialize),
+    /// typically from engines which only differ in the ISA features that they
+    /// compile for, for example through
+    /// [`Config::cranelift_flag_enable`](crate::Config::cranelift_flag_enable).
+    /// All of them must be modules, or all of them components.
+    ///
+    /// The bundle can be passed to
+    /// [`Module::deserialize`](crate::Module::deserialize),
+    /// [`Module::deserialize_file`](crate::Module::deserialize_file) and their
+    /// `Component` counterparts like any one of the variants, and is
+    /// recognized by [`Engine::detect_precompiled`]. When it's loaded, each
+    /// variant is checked for compatibility with the engine and for whether
+    /// the host supports all the ISA features that it uses, like a single
+    /// artifact would be, and the compatible variant which uses the most ISA
+    /// features is loaded. Ties go to the variant which comes first, so
+    /// variants should be ordered from the most to the least specialized, and
+    /// a variant for the baseline ISA is a good last resort.
+    ///
+    /// The selected variant is copied out of the bundle, so unlike a single
+    /// artifact loaded with `deserialize_file` its pages aren't shared with
+    /// other processes through the page cache. A bundle can't be loaded with
+    /// `deserialize_raw`, and [`Module::serialize`](crate::Module::serialize)
+    /// of a module loaded from a bundle returns the selected variant only.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `variants` is empty, if one of them isn't a
+    /// precompiled artifact, or if they aren't all of the same kind.
+    pub fn bundle_precompiled(variants: &[&[u8]]) -> Result<Vec<u8>> {
+        multi_target::bundle(variants)
+    }
+
+    pub(crate) fn inspect_precompiled_module(&self, bytes: &[u8]) -> Result<SerializedModuleInfo> {
+        serialization::inspect_module(self, bytes)
+    }
+
     /// Like [`Engine::detect_precompiled`], but performs the detection on a file.
     #[cfg(feature = "std")]
     pub fn detect_precompiled_file(path: impl AsRef<Path>) -> Result<Option<Precompiled>> {
@@ -604,6 +809,7 @@ information about this check\
             "has_avx512f" => "avx512f",
             "has_avx512vl" => "avx512vl",
             "has_avx512vbmi" => "avx512vbmi",
+            "has_avx512vnni" => "avx512vnni",
             "has_lzcnt" => "lzcnt",
 
             // pulley features
@@ -668,9 +874,51 @@ information about this check\
 #[cfg(any(feature = "cranelift", feature = "winch"))]
 impl Engine {
     pub(crate) fn compiler(&self) -> Option<&dyn wasmtime_environ::Compiler> {
+        #[cfg(feature = "cranelift")]
+        if COMPILING_OPTIMIZED_TIER.get() {
+            if let Some(compiler) = self.inner.tier_up_compiler.as_deref() {
+                return Some(compiler);
+            }
+        }
         self.inner.compiler.as_deref()
     }
 
+    #[cfg(feature = "runtime")]
+    pub(crate) fn specialized_modules(&self) -> &crate::runtime::module::SpecializedModules {
+        &self.inner.specialized_modules
+    }
+
+    /// Returns whether this engine compiles modules in two tiers, see
+    /// [`Config::tiered_compilation`].
+    #[cfg(any(feature = "cranelift", feature = "winch"))]
+    pub(crate) fn tiered_compilation(&self) -> bool {
+        self.inner.tier_up_compiler.is_some()
+    }
+
+    /// Runs `f` with this thread's compilations using the optimized tier's
+    /// compiler instead of the baseline compiler.
+    ///
+    /// All uses of the compiler during a compilation happen on the thread
+    /// that started it, even when functions are compiled in parallel, so a
+    /// thread-local is sufficient to select the tier.
+    #[cfg(feature = "cranelift")]
+    pub(crate) fn with_optimized_tier<R>(&self, f: impl FnOnce() -> R) -> R {
+        struct Reset(bool);
+        impl Drop for Reset {
+            fn drop(&mut self) {
+                COMPILING_OPTIMIZED_TIER.set(self.0);
+            }
+        }
+        let _reset = Reset(COMPILING_OPTIMIZED_TIER.replace(true));
+        f()
+    }
+
+    /// Returns whether the current thread is compiling an optimized tier.
+    #[cfg(feature = "cranelift")]
+    pub(crate) fn compiling_optimized_tier() -> bool {
+        COMPILING_OPTIMIZED_TIER.get()
+    }
+
     pub(crate) fn try_compiler(&self) -> Result<&dyn wasmtime_environ::Compiler> {
         self.compiler()
             .ok_or_else(|| format_err!("Engine was not configured with a compiler"))
@@ -704,6 +952,98 @@ impl Engine {
             .compile_module_serialized()
     }
 
+    /// Same as [`Engine::precompile_module`] except that many modules are
+    /// compiled together as a batch.
+    ///
+    /// The returned vector contains the serialized form of each module in
+    /// `modules`, in the same order. Modules within the batch are compiled in
+    /// parallel with one another, in addition to the functions within each
+    /// module, when
+    /// [`Config::parallel_compilation`](crate::Config::parallel_compilation)
+    /// is enabled, and identical inputs are only compiled once.
+    ///
+    /// Functions which are identical across different modules, such as those
+    /// from a shared language runtime, can additionally be compiled only once
+    /// by configuring
+    /// [`Config::enable_incremental_compilation`](crate::Config::enable_incremental_compilation).
+    ///
+    /// # Errors
+    ///
+    /// Returns the error of the first module in `modules` which failed to
+    /// compile.
+    pub fn precompile_modules(&self, modules: &[&[u8]]) -> Result<Vec<Vec<u8>>> {
+        // Map each input to the first input with identical contents so that
+        // duplicates are only compiled once.
+        let mut unique = crate::hash_map::HashMap::new();
+        let firsts = modules
+            .iter()
+            .enumerate()
+            .map(|(i, bytes)| *unique.entry(*bytes).or_insert(i))
+            .collect::<Vec<_>>();
+        let mut uses = vec![0; modules.len()];
+        for &first in firsts.iter() {
+            uses[first] += 1;
+        }
+
+        let to_compile = (0..modules.len()).filter(|&i| uses[i] > 0).collect();
+        let compiled = self.run_maybe_parallel(to_compile, |i| {
+            self.precompile_module(modules[i])
+                .with_context(|| format!("failed to compile module {i}"))
+                .map(|bytes| (i, bytes))
+        })?;
+        let mut artifacts = (0..modules.len()).map(|_| None).collect::<Vec<_>>();
+        for (i, bytes) in compiled {
+            artifacts[i] = Some(bytes);
+        }
+
+        // Hand out copies to duplicates, moving the artifact out on its last
+        // use.
+        Ok(firsts
+            .into_iter()
+            .map(|first| {
+                uses[first] -= 1;
+                if uses[first] == 0 {
+                    artifacts[first].take().unwrap()
+                } else {
+                    artifacts[first].clone().unwrap()
+                }
+            })
+            .collect())
+    }
+
+    /// Compiles `bytes` like [`Module::new`](crate::Module::new), sharing the
+    /// result with any other module compiled from identical bytes by this
+    /// method on this engine.
+    ///
+    /// When many modules, such as those uploaded by different tenants, are
+    /// often byte-for-byte identical, this avoids compiling them more than
+    /// once and holding more than one copy of their code and metadata in
+    /// memory. If a module compiled from the same `bytes` is still alive then
+    /// it's returned without compiling anything. The engine only holds weak
+    /// references to the modules it returns, so a module is freed as usual
+    /// once all of its users have dropped it, after which the next call with
+    /// its bytes compiles it again.
+    ///
+    /// Modules are keyed by their exact contents, and are only shared within
+    /// one engine, whose [`Config`](crate::Config) they were compiled with.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// # use wasmtime::*;
+    /// # fn main() -> Result<()> {
+    /// let engine = Engine::default();
+    /// let a = engine.compile_cached(b"(module (func))")?;
+    /// let b = engine.compile_cached(b"(module (func))")?;
+    /// assert!(Module::same(&a, &b));
+    /// # Ok(())
+    /// # }
+    /// ```
+    #[cfg(feature = "runtime")]
+    pub fn compile_cached(&self, bytes: &[u8]) -> Result<crate::Module> {
+        self.inner.cached_modules.get_or_compile(self, bytes)
+    }
+
     /// Same as [`Engine::precompile_module`] except for a
     /// [`Component`](crate::component::Component)
     #[cfg(feature = "component-model")]
@@ -783,6 +1123,81 @@ impl Engine {
         crate::runtime::vm::PoolingAllocatorMetrics::new(self)
     }
 
+    /// Returns a snapshot of the compiled code and types currently loaded into
+    /// this engine.
+    ///
+    /// This is cheap enough to call periodically, for example to export the
+    /// values as gauges to a metrics system.
+    pub fn stats(&self) -> EngineStats {
+        let (types, rec_groups) = self.signatures().len();
+        EngineStats::new(&self.inner.code_stats, types, rec_groups)
+    }
+
+    /// Returns a snapshot of the fiber stacks cached for async calls, see
+    /// [`Config::async_stack_cache_size`].
+    ///
+    /// Returns `None` if this engine uses the pooling allocator, whose stacks
+    /// are reported by [`Engine::pooling_allocator_metrics`] instead.
+    #[cfg(feature = "async")]
+    pub fn async_stack_cache_stats(&self) -> Option<AsyncStackCacheStats> {
+        let (cached_stacks, hits, misses) = self.allocator().as_on_demand()?.stack_cache_stats();
+        Some(AsyncStackCacheStats {
+            cached_stacks,
+            hits,
+            misses,
+        })
+    }
+
+    /// Returns a snapshot of the continuation stacks cached for reuse, see
+    /// [`Config::continuation_stack_cache_size`].
+    #[cfg(feature = "stack-switching")]
+    pub fn continuation_stack_cache_stats(&self) -> ContinuationStackCacheStats {
+        let (cached_stacks, hits, misses) = self.inner.continuation_stacks.stats();
+        ContinuationStackCacheStats {
+            cached_stacks,
+            hits,
+            misses,
+        }
+    }
+
+    #[cfg(feature = "stack-switching")]
+    pub(crate) fn continuation_stacks(&self) -> &crate::runtime::vm::VMContinuationStackCache {
+        &self.inner.continuation_stacks
+    }
+
+    /// Releases memory that this engine's instance allocator keeps around to
+    /// speed up later instantiations, until at least `target_bytes` have been
+    /// released or nothing is left to release. Pass `usize::MAX` to release
+    /// everything.
+    ///
+    /// With the pooling allocator this releases the pages of unused slots that
+    /// are kept resident by `PoolingAllocationConfig::linear_memory_keep_resident`,
+    /// `table_keep_resident` and `async_stack_keep_resident`, least recently
+    /// used first. Trimmed memory slots also lose their copy-on-write image
+    /// and their affinity to the module that last used them. With the
+    /// on-demand allocator this drops the fiber stacks cached by
+    /// `Config::async_stack_cache_size`. With either allocator this also drops
+    /// the continuation stacks cached by
+    /// `Config::continuation_stack_cache_size`.
+    ///
+    /// Nothing in use is released, so this only makes some later
+    /// instantiations slower. Returns an estimate of the number of bytes
+    /// released.
+    pub fn trim(&self, target_bytes: usize) -> usize {
+        let trimmed = self.allocator().trim(target_bytes);
+        #[cfg(feature = "stack-switching")]
+        let trimmed = trimmed
+            + self
+                .inner
+                .continuation_stacks
+                .trim(target_bytes.saturating_sub(trimmed));
+        trimmed
+    }
+
+    pub(crate) fn code_stats(&self) -> &CodeStats {
+        &self.inner.code_stats
+    }
+
     pub(crate) fn allocator(&self) -> &dyn crate::runtime::vm::InstanceAllocator {
         let r: &(dyn crate::runtime::vm::InstanceAllocator + Send + Sync) =
             self.inner.allocator.as_ref();
@@ -797,6 +1212,48 @@ impl Engine {
         self.inner.profiler.as_ref()
     }
 
+    /// Starts timing an event which is recorded by `finish_event` if this
+    /// engine has an [`EventSink`].
+    #[inline]
+    pub(crate) fn start_event(&self) -> EventStart {
+        EventStart {
+            #[cfg(feature = "std")]
+            start: self
+                .inner
+                .config
+                .event_sink
+                .as_ref()
+                .map(|_| std::time::Instant::now()),
+        }
+    }
+
+    /// Records the event started by `start`, with its duration, if this
+    /// engine has an [`EventSink`].
+    #[inline]
+    pub(crate) fn finish_event(
+        &self,
+        start: EventStart,
+        kind: impl FnOnce(core::time::Duration) -> RuntimeEventKind,
+    ) {
+        #[cfg(feature = "std")]
+        if let (Some(sink), Some(start)) = (&self.inner.config.event_sink, start.start) {
+            sink.record(kind(start.elapsed()));
+        }
+        #[cfg(not(feature = "std"))]
+        let _ = (start, kind);
+    }
+
+    /// Records an event if this engine has an [`EventSink`].
+    #[inline]
+    pub(crate) fn record_event(&self, kind: impl FnOnce() -> RuntimeEventKind) {
+        #[cfg(feature = "std")]
+        if let Some(sink) = &self.inner.config.event_sink {
+            sink.record(kind());
+        }
+        #[cfg(not(feature = "std"))]
+        let _ = kind;
+    }
+
     #[cfg(all(feature = "cache", any(feature = "cranelift", feature = "winch")))]
     pub(crate) fn cache(&self) -> Option<&wasmtime_cache::Cache> {
         self.config().cache.as_ref()
@@ -813,7 +1270,7 @@ impl Engine {
 
     #[cfg(target_has_atomic = "64")]
     pub(crate) fn epoch_counter(&self) -> &AtomicU64 {
-        &self.inner.epoch
+        &self.inner.epoch.0
     }
 
     #[cfg(target_has_atomic = "64")]
@@ -848,7 +1305,172 @@ impl Engine {
     /// memory.
     #[cfg(target_has_atomic = "64")]
     pub fn increment_epoch(&self) {
-        self.inner.epoch.fetch_add(1, Ordering::Relaxed);
+        self.inner.epoch.0.fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// Starts incrementing this engine's epoch every `interval`, or changes
+    /// the interval if the ticker is already running.
+    ///
+    /// This replaces a thread of the embedder's own which calls
+    /// [`Engine::increment_epoch`] in a loop. All engines in the process share
+    /// one ticker thread, which is spawned the first time this is called.
+    /// Ticks are scheduled at fixed intervals, so they don't drift, and the
+    /// epoch is only incremented while wasm is executing in one of this
+    /// engine's stores. When no wasm is executing in any engine with a ticker
+    /// the thread sleeps until some starts again.
+    ///
+    /// Only calls into wasm which start after the ticker has been started
+    /// keep it running. The ticker stops when [`Engine::stop_epoch_ticker`] is
+    /// called, or when the engine is dropped.
+    ///
+    /// See [`Config::epoch_interruption`](crate::Config::epoch_interruption)
+    /// for an introduction to epoch-based interruption.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `interval` is zero, or if the ticker thread can't
+    /// be spawned.
+    #[cfg(all(feature = "std", target_has_atomic = "64"))]
+    pub fn start_epoch_ticker(&self, interval: std::time::Duration) -> Result<()> {
+        epoch_ticker::EpochTicker::start(self, &self.inner.epoch_ticker, interval)
+    }
+
+    /// Stops the ticker started by [`Engine::start_epoch_ticker`], if any.
+    #[cfg(all(feature = "std", target_has_atomic = "64"))]
+    pub fn stop_epoch_ticker(&self) {
+        if let Some(ticker) = self.inner.epoch_ticker.get() {
+            ticker.stop();
+        }
+    }
+
+    /// Returns the interval of the ticker started by
+    /// [`Engine::start_epoch_ticker`], or `None` if it isn't running.
+    #[cfg(all(feature = "std", target_has_atomic = "64"))]
+    pub fn epoch_ticker_interval(&self) -> Option<std::time::Duration> {
+        self.inner.epoch_ticker.get()?.interval()
+    }
+
+    /// Calls [`Engine::trim`] with `target_bytes` whenever the process's
+    /// cgroup is under memory pressure, for as long as this engine is alive.
+    ///
+    /// Pressure is detected with a Linux PSI trigger on the cgroup's
+    /// `memory.pressure` file, or on `/proc/pressure/memory` if the process
+    /// isn't in a cgroup v2 hierarchy, which fires when some tasks spent at
+    /// least 150ms of a 1s window stalled on memory. A thread is spawned to
+    /// wait for the trigger.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if this was already called for this engine, if the
+    /// kernel doesn't support PSI triggers or the pressure file isn't
+    /// writable, or if the thread can't be spawned.
+    #[cfg(all(feature = "std", target_os = "linux"))]
+    pub fn trim_on_memory_pressure(&self, target_bytes: usize) -> Result<()> {
+        memory_pressure::start(self, target_bytes)
+    }
+
+    /// Records that a call into wasm is starting in one of this engine's
+    /// stores, for the engine's epoch ticker, until the returned guard is
+    /// dropped.
+    #[cfg(all(feature = "std", target_has_atomic = "64"))]
+    #[inline]
+    pub(crate) fn enter_epoch_ticker(&self) -> Option<epoch_ticker::ExecutingGuard> {
+        Some(self.inner.epoch_ticker.get()?.enter())
+    }
+
+    /// Prepares this engine for the process to `fork`, so that its modules
+    /// and components can be used in the child process.
+    ///
+    /// This is intended for servers which load or deserialize all of their
+    /// modules in a parent process and then fork worker processes. Compiled
+    /// code, memory images, and type registrations are inherited by the
+    /// children, with their pages shared copy-on-write, so the workers start
+    /// without compiling or loading anything. Trap handlers are inherited as
+    /// well, however threads aren't, so the threads which Wasmtime uses in the
+    /// background must be paused before the fork and replaced in the child:
+    ///
+    /// * the thread of [`Engine::start_epoch_ticker`] is parked, and
+    ///   respawned in the child,
+    /// * the thread of [`Engine::trim_on_memory_pressure`] is stopped once any
+    ///   trim it's doing completes, and respawned in both processes,
+    /// * outstanding deallocations of
+    ///   `PoolingAllocationConfig::background_decommit` are completed, and its
+    ///   thread is respawned in the child,
+    /// * the child compiles on the calling thread from then on, since the
+    ///   threads of `Config::parallel_compilation` are gone.
+    ///
+    /// Once this returns the process must fork, and then call
+    /// [`Engine::after_fork_parent`] in the parent and
+    /// [`Engine::after_fork_child`] in the child. As with any `fork` in a
+    /// multithreaded program, no other thread may be using Wasmtime from the
+    /// call to this method until the fork, and no background compilation, such
+    /// as that of `LazyModule::warm` or of `Config::tiered_compilation`, may be
+    /// in progress, since its result would never arrive in the child.
+    /// WebAssembly must not be executing in any store either.
+    ///
+    /// When several engines are used they each need to be prepared.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error on macOS if this engine handles traps with Mach ports,
+    /// which aren't inherited by child processes, see
+    /// [`Config::macos_use_mach_ports`](crate::Config::macos_use_mach_ports).
+    #[cfg(all(feature = "std", unix))]
+    pub fn prepare_fork(&self) -> Result<()> {
+        #[cfg(target_vendor = "apple")]
+        if self.config().macos_use_mach_ports && self.tunables().signals_based_traps {
+            bail!("an engine which handles traps with Mach ports cannot be used across a fork");
+        }
+        // Stopped first, since a trim could queue more work for the pool.
+        #[cfg(target_os = "linux")]
+        memory_pressure::prepare_fork(self);
+        #[cfg(target_has_atomic = "64")]
+        epoch_ticker::prepare_fork();
+        #[cfg(feature = "pooling-allocator")]
+        if let Some(pool) = self.allocator().as_pooling() {
+            pool.prepare_fork();
+        }
+        Ok(())
+    }
+
+    /// Resumes this engine in the parent process after a fork, see
+    /// [`Engine::prepare_fork`].
+    #[cfg(all(feature = "std", unix))]
+    pub fn after_fork_parent(&self) {
+        #[cfg(target_has_atomic = "64")]
+        epoch_ticker::after_fork_parent();
+        #[cfg(target_os = "linux")]
+        if let Err(e) = memory_pressure::after_fork(self) {
+            log::warn!("failed to restart the memory pressure thread: {e:?}");
+        }
+    }
+
+    /// Makes this engine usable in a child process forked after
+    /// [`Engine::prepare_fork`].
+    ///
+    /// This must be called on the thread which forked, before anything else
+    /// uses the engine in the child.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if a background thread can't be respawned.
+    #[cfg(all(feature = "std", unix))]
+    pub fn after_fork_child(&self) -> Result<()> {
+        #[cfg(feature = "parallel-compilation")]
+        self.inner
+            .compile_serially
+            .store(true, core::sync::atomic::Ordering::Relaxed);
+        #[cfg(feature = "pooling-allocator")]
+        if let Some(pool) = self.allocator().as_pooling() {
+            pool.after_fork_child();
+        }
+        #[cfg(has_native_signals)]
+        crate::runtime::vm::reset_thread_counters();
+        #[cfg(target_has_atomic = "64")]
+        epoch_ticker::after_fork_child()?;
+        #[cfg(target_os = "linux")]
+        memory_pressure::after_fork(self)?;
+        Ok(())
     }
 
     /// Returns a [`std::hash::Hash`] that can be used to check precompiled WebAssembly compatibility.
@@ -881,6 +1503,13 @@ impl Engine {
         bytes: &[u8],
         expected: ObjectKind,
     ) -> Result<Arc<crate::CodeMemory>> {
+        if compression::is_compressed(bytes) {
+            return self.load_code(compression::decompress(self, bytes)?, expected);
+        }
+        if multi_target::is_multi_target(bytes) {
+            let variant = multi_target::select(self, bytes, expected)?;
+            return self.load_code_bytes(variant, expected);
+        }
         self.load_code(
             crate::runtime::vm::MmapVec::from_slice_with_alignment(
                 bytes,
@@ -915,18 +1544,42 @@ impl Engine {
         unsafe { self.load_code(crate::runtime::vm::MmapVec::from_raw(memory)?, expected) }
     }
 
+    /// Same as `load_code_raw`, except that `owner` is dropped once the
+    /// returned `CodeMemory` no longer uses `memory`.
+    ///
+    /// # Safety
+    ///
+    /// Same as `load_code_raw`, and `memory` must remain valid until `owner`
+    /// is dropped.
+    pub(crate) unsafe fn load_code_raw_with_owner(
+        &self,
+        memory: NonNull<[u8]>,
+        owner: Box<dyn core::any::Any + Send + Sync>,
+        expected: ObjectKind,
+    ) -> Result<Arc<crate::CodeMemory>> {
+        // SAFETY: the contract of this function is the same as that of
+        // `from_raw_with_owner`.
+        let mmap = unsafe { crate::runtime::vm::MmapVec::from_raw_with_owner(memory, owner)? };
+        self.load_code(mmap, expected)
+    }
+
     /// Like `load_code_bytes`, but creates a mmap from a file on disk.
+    ///
+    /// Compressed artifacts are decompressed from the file mapping into
+    /// anonymous memory, and the selected variant of multi-target artifacts is
+    /// copied into it, after which the file mapping is dropped.
     #[cfg(feature = "std")]
     pub(crate) fn load_code_file(
         &self,
         file: File,
         expected: ObjectKind,
     ) -> Result<Arc<crate::CodeMemory>> {
-        self.load_code(
-            crate::runtime::vm::MmapVec::from_file(file)
-                .with_context(|| "Failed to create file mapping".to_string())?,
-            expected,
-        )
+        let mmap = crate::runtime::vm::MmapVec::from_file(file)
+            .with_context(|| "Failed to create file mapping".to_string())?;
+        if compression::is_compressed(&mmap) || multi_target::is_multi_target(&mmap) {
+            return self.load_code_bytes(&mmap, expected);
+        }
+        self.load_code(mmap, expected)
     }
 
     pub(crate) fn load_code(
@@ -934,6 +1587,12 @@ impl Engine {
         mmap: crate::runtime::vm::MmapVec,
         expected: ObjectKind,
     ) -> Result<Arc<crate::CodeMemory>> {
+        if compression::is_compressed(&mmap) || multi_target::is_multi_target(&mmap) {
+            bail!(
+                "compressed and multi-target artifacts can't be used in place, \
+                 they must be loaded with `deserialize` or `deserialize_file`"
+            );
+        }
         self.check_compatible_with_native_host()
             .context("compilation settings are not compatible with the native host")?;
 
@@ -943,6 +1602,19 @@ impl Engine {
         Ok(Arc::new(code))
     }
 
+    /// Registers the native debug information of all code which hasn't been
+    /// registered with a debugger yet because of
+    /// [`Config::debug_info_lazy`](crate::Config::debug_info_lazy).
+    ///
+    /// This applies to code loaded by any engine in this process, and is
+    /// intended to be called once a debugger has been attached, so that code
+    /// which has already been loaded becomes visible to it.
+    pub fn register_pending_debug_info(&self) -> Result<()> {
+        #[cfg(feature = "debug-builtins")]
+        crate::runtime::code_memory::register_pending_debug_images()?;
+        Ok(())
+    }
+
     /// Unload process-related trap/signal handlers and destroy this engine.
     ///
     /// This method is not safe and is not widely applicable. It is not required
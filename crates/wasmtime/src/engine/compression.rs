@@ -0,0 +1,216 @@
+//! Compressed precompiled artifacts, see `Engine::compress_precompiled`.
+//!
+//! A compressed artifact is a header followed by the chunks of an ordinary
+//! artifact, each of which is compressed independently with zstd. Chunks never
+//! span the boundary of an ELF section and are at most `CHUNK_SIZE` bytes
+//! long, so sections can be decompressed without their neighbors and large
+//! sections can be decompressed in parallel. The header is:
+//!
+//! 1. The 8-byte `MAGIC`, which can't be mistaken for the start of an ELF file.
+//! 2. A version byte, currently `VERSION`.
+//! 3. A byte indicating whether the artifact is a module (0) or a component
+//!    (1), so that it can be detected without decompressing anything.
+//! 4. Two reserved zero bytes.
+//! 5. The size of the uncompressed artifact as a little-endian `u64`.
+//! 6. The number of chunks as a little-endian `u32`.
+//! 7. For each chunk, its uncompressed and compressed sizes as little-endian
+//!    `u32`s.
+
+use crate::Precompiled;
+use crate::prelude::*;
+
+const MAGIC: &[u8; 8] = b"\0wasmzst";
+const VERSION: u8 = 0;
+
+/// The size of the fixed part of the header.
+#[cfg(feature = "compressed-artifacts")]
+const HEADER_SIZE: usize = 24;
+
+/// The maximum uncompressed size of a chunk.
+#[cfg(feature = "compressed-artifacts")]
+const CHUNK_SIZE: usize = 1 << 20;
+
+/// Returns whether `bytes` starts like a compressed artifact.
+pub fn is_compressed(bytes: &[u8]) -> bool {
+    bytes.starts_with(MAGIC)
+}
+
+/// Returns which kind of artifact the compressed artifact in `bytes` is, if it
+/// is one.
+pub fn detect_precompiled(bytes: &[u8]) -> Option<Precompiled> {
+    if !is_compressed(bytes) || bytes.get(MAGIC.len()) != Some(&VERSION) {
+        return None;
+    }
+    match bytes.get(MAGIC.len() + 1)? {
+        0 => Some(Precompiled::Module),
+        1 => Some(Precompiled::Component),
+        _ => None,
+    }
+}
+
+/// The size of the prefix of a compressed artifact that `detect_precompiled`
+/// needs.
+pub const DETECT_SIZE: usize = MAGIC.len() + 2;
+
+/// The parsed header of a compressed artifact.
+#[cfg(feature = "compressed-artifacts")]
+struct Header<'a> {
+    /// The size of the uncompressed artifact.
+    len: usize,
+    /// The uncompressed and compressed size of each chunk.
+    chunks: Vec<(usize, usize)>,
+    /// The compressed chunks, one after another.
+    data: &'a [u8],
+}
+
+#[cfg(feature = "compressed-artifacts")]
+impl<'a> Header<'a> {
+    fn parse(bytes: &'a [u8]) -> Result<Header<'a>> {
+        if detect_precompiled(bytes).is_none() || bytes.len() < HEADER_SIZE {
+            bail!("invalid compressed artifact header");
+        }
+        let u32_at = |i: usize| u32::from_le_bytes(bytes[i..i + 4].try_into().unwrap()) as usize;
+        let len = u64::from_le_bytes(bytes[12..20].try_into().unwrap());
+        let len = usize::try_from(len).context("compressed artifact is too large")?;
+        let count = u32_at(20);
+        let table_end = count
+            .checked_mul(8)
+            .and_then(|n| n.checked_add(HEADER_SIZE))
+            .filter(|n| *n <= bytes.len())
+            .ok_or_else(|| format_err!("compressed artifact is truncated"))?;
+        let chunks = (0..count)
+            .map(|i| (u32_at(HEADER_SIZE + 8 * i), u32_at(HEADER_SIZE + 8 * i + 4)))
+            .collect();
+        Ok(Header {
+            len,
+            chunks,
+            data: &bytes[table_end..],
+        })
+    }
+
+    /// Splits `dst`, which must be `self.len` bytes long, and the compressed
+    /// data into the pairs of uncompressed and compressed chunks.
+    fn split<'b>(&self, mut dst: &'b mut [u8]) -> Result<Vec<(&'b mut [u8], &'a [u8])>> {
+        let mut src = self.data;
+        let mut chunks = Vec::with_capacity(self.chunks.len());
+        for &(len, compressed_len) in self.chunks.iter() {
+            if len > dst.len() || compressed_len > src.len() {
+                bail!("compressed artifact is truncated");
+            }
+            let (chunk, rest) = core::mem::take(&mut dst).split_at_mut(len);
+            dst = rest;
+            let (compressed, rest) = src.split_at(compressed_len);
+            src = rest;
+            chunks.push((chunk, compressed));
+        }
+        if !dst.is_empty() || !src.is_empty() {
+            bail!("compressed artifact doesn't match its header");
+        }
+        Ok(chunks)
+    }
+}
+
+/// Compresses the artifact in `bytes`, see `Engine::compress_precompiled`.
+#[cfg(feature = "compressed-artifacts")]
+pub fn compress(engine: &crate::Engine, bytes: &[u8], level: i32) -> Result<Vec<u8>> {
+    use object::endian::Endianness;
+    use object::{Object, ObjectSection, read::elf::ElfFile64};
+    use wasmtime_environ::obj;
+
+    let kind = match super::serialization::detect_precompiled_bytes(bytes) {
+        Some(Precompiled::Module) => 0,
+        Some(Precompiled::Component) => 1,
+        None => bail!("not a precompiled module or component"),
+    };
+    let obj = ElfFile64::<Endianness>::parse(bytes).map_err(obj::ObjectCrateErrorWrapper)?;
+
+    // Start a new chunk at every section boundary, and then split chunks
+    // that are larger than `CHUNK_SIZE`.
+    let mut boundaries = vec![0, bytes.len()];
+    for section in obj.sections() {
+        if let Some((start, size)) = section.file_range() {
+            boundaries.extend([start, start + size].map(|b| b as usize));
+        }
+    }
+    boundaries.retain(|b| *b <= bytes.len());
+    boundaries.sort_unstable();
+    boundaries.dedup();
+    let mut chunks = Vec::new();
+    for range in boundaries.windows(2) {
+        let mut start = range[0];
+        while start < range[1] {
+            let end = range[1].min(start + CHUNK_SIZE);
+            chunks.push(&bytes[start..end]);
+            start = end;
+        }
+    }
+
+    let compressed = engine.run_maybe_parallel(chunks.clone(), |chunk| {
+        zstd::bulk::compress(chunk, level).context("failed to compress artifact")
+    })?;
+
+    let mut result = Vec::with_capacity(
+        HEADER_SIZE + 8 * chunks.len() + compressed.iter().map(|c| c.len()).sum::<usize>(),
+    );
+    result.extend_from_slice(MAGIC);
+    result.extend_from_slice(&[VERSION, kind, 0, 0]);
+    result.extend_from_slice(&(bytes.len() as u64).to_le_bytes());
+    result.extend_from_slice(&u32::try_from(chunks.len())?.to_le_bytes());
+    for (chunk, compressed) in chunks.iter().zip(&compressed) {
+        result.extend_from_slice(&u32::try_from(chunk.len())?.to_le_bytes());
+        result.extend_from_slice(&u32::try_from(compressed.len())?.to_le_bytes());
+    }
+    for compressed in compressed.iter() {
+        result.extend_from_slice(compressed);
+    }
+    Ok(result)
+}
+
+/// Decompresses the compressed artifact in `bytes` into a new mapping, with
+/// chunks decompressed in parallel if the engine compiles in parallel.
+#[cfg(all(feature = "compressed-artifacts", feature = "runtime"))]
+pub fn decompress(engine: &crate::Engine, bytes: &[u8]) -> Result<crate::runtime::vm::MmapVec> {
+    let header = Header::parse(bytes)?;
+    let mut mmap = crate::runtime::vm::MmapVec::with_capacity_and_alignment(
+        header.len,
+        engine.required_code_alignment(),
+    )?;
+    // SAFETY: the mapping was just created, so nothing else refers to it and
+    // it hasn't been made readonly.
+    let mut chunks = header.split(unsafe { mmap.as_mut_slice() })?;
+    engine.run_maybe_parallel_mut(&mut chunks, |(chunk, compressed)| {
+        decompress_chunk(compressed, chunk)
+    })?;
+    Ok(mmap)
+}
+
+#[cfg(all(not(feature = "compressed-artifacts"), feature = "runtime"))]
+pub fn decompress(_engine: &crate::Engine, _bytes: &[u8]) -> Result<crate::runtime::vm::MmapVec> {
+    bail!("loading compressed artifacts requires the `compressed-artifacts` feature")
+}
+
+/// Decompresses the compressed artifact in `bytes` into a vector.
+#[cfg(feature = "compressed-artifacts")]
+pub fn decompress_to_vec(bytes: &[u8]) -> Result<Vec<u8>> {
+    let header = Header::parse(bytes)?;
+    let mut result = vec![0; header.len];
+    for (chunk, compressed) in header.split(&mut result)? {
+        decompress_chunk(compressed, chunk)?;
+    }
+    Ok(result)
+}
+
+#[cfg(not(feature = "compressed-artifacts"))]
+pub fn decompress_to_vec(_bytes: &[u8]) -> Result<Vec<u8>> {
+    bail!("loading compressed artifacts requires the `compressed-artifacts` feature")
+}
+
+#[cfg(feature = "compressed-artifacts")]
+fn decompress_chunk(compressed: &[u8], chunk: &mut [u8]) -> Result<()> {
+    let len = zstd::bulk::decompress_to_buffer(compressed, chunk)
+        .context("failed to decompress artifact")?;
+    if len != chunk.len() {
+        bail!("compressed artifact doesn't match its header");
+    }
+    Ok(())
+}
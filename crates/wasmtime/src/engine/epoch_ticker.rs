@@ -0,0 +1,292 @@
+//! A process-wide thread which increments the epochs of engines at regular
+//! intervals, see `Engine::start_epoch_ticker`.
+//!
+//! All engines with a ticker share a single thread. Each engine's ticker
+//! counts how many calls into wasm are in progress in the engine's stores, and
+//! its epoch is only incremented while that count is nonzero. When it drops to
+//! zero the thread stops scheduling ticks for the engine, and it sleeps
+//! entirely once no engine needs ticks, until the next call into wasm wakes
+//! it up again.
+//!
+//! Ticks are scheduled at absolute times, each one interval after the last,
+//! so that the epoch advances at the configured rate regardless of how long
+//! the thread takes to wake up. If the thread falls more than an interval
+//! behind, for example because the process was suspended, the missed ticks
+//! are skipped rather than all delivered at once.
+//!
+//! The thread doesn't survive a `fork`, so `prepare_fork` parks it where it
+//! doesn't hold any locks and `after_fork_child` spawns a replacement in the
+//! child, which takes over the state of the inherited tickers.
+
+use crate::prelude::*;
+use crate::{Engine, EngineWeak};
+use core::sync::atomic::{AtomicBool, AtomicU32, AtomicU64, AtomicUsize, Ordering};
+use std::sync::{Arc, Condvar, Mutex, MutexGuard, OnceLock};
+use std::time::{Duration, Instant};
+
+/// The ticker of one engine.
+pub(crate) struct EpochTicker {
+    engine: EngineWeak,
+    /// The interval between ticks, in nanoseconds, or zero once the ticker
+    /// has been stopped.
+    interval: AtomicU64,
+    /// How many calls into wasm are in progress in the engine's stores.
+    executing: AtomicUsize,
+    /// Whether the thread has stopped scheduling ticks for this engine because
+    /// `executing` was zero, in which case it must be woken up once it isn't.
+    sleeping: AtomicBool,
+}
+
+/// State of the ticker thread, shared by all engines.
+struct Thread {
+    state: Mutex<State>,
+    /// Signaled when a ticker is added or changed, when a sleeping ticker
+    /// starts executing wasm, or when the thread is unpaused.
+    wakeup: Condvar,
+    /// Signaled by the thread once it's parked, see `prepare_fork`.
+    parked: Condvar,
+    /// The id of the process in which the thread is running.
+    process: AtomicU32,
+}
+
+#[derive(Default)]
+struct State {
+    tickers: Vec<(Arc<EpochTicker>, Option<Instant>)>,
+    /// The number of `prepare_fork` calls without a matching
+    /// `after_fork_parent` or `after_fork_child`.
+    paused: usize,
+    /// Whether the thread is waiting for `paused` to drop back to zero.
+    parked: bool,
+}
+
+static THREAD: OnceLock<Result<&'static Thread, String>> = OnceLock::new();
+
+fn thread() -> Result<&'static Thread> {
+    let thread = THREAD.get_or_init(|| {
+        let thread: &'static Thread = Box::leak(Box::new(Thread {
+            state: Mutex::new(State::default()),
+            wakeup: Condvar::new(),
+            parked: Condvar::new(),
+            process: AtomicU32::new(std::process::id()),
+        }));
+        thread.spawn().map(|_| thread).map_err(|e| e.to_string())
+    });
+    match thread {
+        Ok(thread) => Ok(thread),
+        Err(e) => bail!("failed to spawn the epoch ticker thread: {e}"),
+    }
+}
+
+impl EpochTicker {
+    /// Starts ticking `engine`'s epoch every `interval`, or changes the
+    /// interval of its existing `ticker`.
+    pub(crate) fn start(
+        engine: &Engine,
+        ticker: &OnceLock<Arc<EpochTicker>>,
+        interval: Duration,
+    ) -> Result<()> {
+        let nanos = u64::try_from(interval.as_nanos()).unwrap_or(u64::MAX);
+        if nanos == 0 {
+            bail!("the epoch ticker interval must not be zero");
+        }
+        let thread = thread()?;
+        let ticker = ticker.get_or_init(|| {
+            Arc::new(EpochTicker {
+                engine: engine.weak(),
+                interval: AtomicU64::new(0),
+                executing: AtomicUsize::new(0),
+                sleeping: AtomicBool::new(true),
+            })
+        });
+        let mut state = thread.state.lock().unwrap();
+        ticker.interval.store(nanos, Ordering::Relaxed);
+        match state
+            .tickers
+            .iter_mut()
+            .find(|(t, _)| Arc::ptr_eq(t, ticker))
+        {
+            // Reschedule the next tick with the new interval.
+            Some((_, next)) => *next = None,
+            None => state.tickers.push((ticker.clone(), None)),
+        }
+        thread.wakeup.notify_one();
+        Ok(())
+    }
+
+    /// Stops this ticker. It can be started again with `start`.
+    pub(crate) fn stop(&self) {
+        self.interval.store(0, Ordering::Relaxed);
+    }
+
+    /// Returns the interval between ticks, if the ticker is running.
+    pub(crate) fn interval(&self) -> Option<Duration> {
+        match self.interval.load(Ordering::Relaxed) {
+            0 => None,
+            nanos => Some(Duration::from_nanos(nanos)),
+        }
+    }
+
+    /// Records that a call into wasm has started, until the returned guard is
+    /// dropped.
+    #[inline]
+    pub(crate) fn enter(self: &Arc<Self>) -> ExecutingGuard {
+        if self.executing.fetch_add(1, Ordering::SeqCst) == 0 {
+            self.wake();
+        }
+        ExecutingGuard(self.clone())
+    }
+
+    #[cold]
+    fn wake(&self) {
+        if !self.sleeping.swap(false, Ordering::SeqCst) {
+            return;
+        }
+        // The thread sets `sleeping` while holding its lock, so taking the
+        // lock here ensures that it's waiting by the time it's notified.
+        let Some(Ok(thread)) = THREAD.get() else {
+            return;
+        };
+        let _state = thread.state.lock().unwrap();
+        thread.wakeup.notify_one();
+    }
+}
+
+/// See `EpochTicker::enter`.
+pub(crate) struct ExecutingGuard(Arc<EpochTicker>);
+
+impl Drop for ExecutingGuard {
+    #[inline]
+    fn drop(&mut self) {
+        // There's no need to wake the thread here, it notices that the engine
+        // is idle at its next tick.
+        self.0.executing.fetch_sub(1, Ordering::SeqCst);
+    }
+}
+
+/// Parks the ticker thread, if it was spawned, until `after_fork_parent` or
+/// `after_fork_child` is called, so that it doesn't hold its lock when the
+/// process forks.
+pub(crate) fn prepare_fork() {
+    let Some(Ok(thread)) = THREAD.get() else {
+        return;
+    };
+    let mut state = thread.state.lock().unwrap();
+    state.paused += 1;
+    thread.wakeup.notify_one();
+    while !state.parked {
+        state = thread.parked.wait(state).unwrap();
+    }
+}
+
+/// Unparks the ticker thread after the process forked, see `prepare_fork`.
+pub(crate) fn after_fork_parent() {
+    let Some(Ok(thread)) = THREAD.get() else {
+        return;
+    };
+    let mut state = thread.state.lock().unwrap();
+    state.paused = state.paused.saturating_sub(1);
+    thread.wakeup.notify_one();
+}
+
+/// Spawns a new ticker thread in a forked child, if the parent had one, and
+/// unparks it, see `prepare_fork`.
+pub(crate) fn after_fork_child() -> Result<()> {
+    let Some(Ok(thread)) = THREAD.get() else {
+        return Ok(());
+    };
+    {
+        let mut state = thread.state.lock().unwrap();
+        state.paused = state.paused.saturating_sub(1);
+        thread.wakeup.notify_one();
+    }
+    let process = std::process::id();
+    if thread.process.load(Ordering::SeqCst) != process {
+        thread
+            .spawn()
+            .context("failed to spawn the epoch ticker thread")?;
+        thread.process.store(process, Ordering::SeqCst);
+    }
+    Ok(())
+}
+
+impl Thread {
+    fn spawn(&'static self) -> std::io::Result<()> {
+        std::thread::Builder::new()
+            .name("wasmtime-epoch-ticker".to_string())
+            .spawn(move || self.run())
+            .map(drop)
+    }
+
+    fn run(&self) {
+        let mut state = self.state.lock().unwrap();
+        loop {
+            if state.paused > 0 {
+                state.parked = true;
+                self.parked.notify_all();
+                state = self.wakeup.wait(state).unwrap();
+                continue;
+            }
+            state.parked = false;
+            let now = Instant::now();
+            let mut wake_at: Option<Instant> = None;
+            state.tickers.retain_mut(|(ticker, next)| {
+                let Some(interval) = ticker.interval() else {
+                    return false;
+                };
+                let Some(engine) = ticker.engine.upgrade() else {
+                    return false;
+                };
+                if !ticker.is_executing() {
+                    *next = None;
+                    return true;
+                }
+                let at = next.get_or_insert(now + interval);
+                if *at <= now {
+                    engine.increment_epoch();
+                    *at += interval;
+                    if *at <= now {
+                        *at = now + interval;
+                    }
+                }
+                wake_at = Some(wake_at.map_or(*at, |w| w.min(*at)));
+                true
+            });
+            state = self.sleep(state, wake_at);
+        }
+    }
+
+    fn sleep<'a>(
+        &self,
+        state: MutexGuard<'a, State>,
+        wake_at: Option<Instant>,
+    ) -> MutexGuard<'a, State> {
+        match wake_at {
+            Some(at) => {
+                let timeout = at.saturating_duration_since(Instant::now());
+                self.wakeup.wait_timeout(state, timeout).unwrap().0
+            }
+            None => self.wakeup.wait(state).unwrap(),
+        }
+    }
+}
+
+impl EpochTicker {
+    /// Returns whether wasm is executing in the engine, or otherwise marks
+    /// the ticker as sleeping so that the next call into wasm wakes the
+    /// thread. Called by the thread with its lock held.
+    fn is_executing(&self) -> bool {
+        if self.executing.load(Ordering::SeqCst) > 0 {
+            self.sleeping.store(false, Ordering::SeqCst);
+            return true;
+        }
+        self.sleeping.store(true, Ordering::SeqCst);
+        // A call may have started between the load above and setting
+        // `sleeping`, in which case it may not have seen `sleeping` and so
+        // not woken the thread.
+        if self.executing.load(Ordering::SeqCst) > 0 {
+            self.sleeping.store(false, Ordering::SeqCst);
+            return true;
+        }
+        false
+    }
+}
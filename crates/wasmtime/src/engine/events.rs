@@ -0,0 +1,239 @@
+//! An engine-wide stream of runtime events, see [`EventSink`].
+//!
+//! Each thread records into a buffer of its own which only that thread ever
+//! writes to, so recording an event is a couple of atomic operations and
+//! never contends with other threads or with draining.
+
+use crate::Trap;
+use core::time::Duration;
+#[cfg(feature = "std")]
+use {
+    crate::prelude::*,
+    alloc::sync::{Arc, Weak},
+    core::cell::{RefCell, UnsafeCell},
+    core::mem::MaybeUninit,
+    core::sync::atomic::{AtomicU64, AtomicUsize, Ordering},
+    std::sync::Mutex,
+    std::time::Instant,
+};
+
+/// What happened in a [`RuntimeEvent`].
+#[derive(Copy, Clone, Debug, PartialEq)]
+#[non_exhaustive]
+pub enum RuntimeEventKind {
+    /// A module or component was compiled.
+    Compile {
+        /// How long compilation took, including any lookup in the
+        /// compilation cache.
+        duration: Duration,
+    },
+    /// A core module was instantiated, including running its start function.
+    ///
+    /// Instantiating a component records one of these for each core module
+    /// instance it creates.
+    Instantiate {
+        /// How long instantiation took.
+        duration: Duration,
+    },
+    /// WebAssembly code trapped.
+    Trap {
+        /// The reason for the trap.
+        code: Trap,
+    },
+    /// A linear memory was grown, either by WebAssembly's `memory.grow` or
+    /// by the host.
+    MemoryGrow {
+        /// The number of pages requested.
+        delta: u64,
+        /// Whether the memory was grown.
+        succeeded: bool,
+        /// How long the growth took.
+        duration: Duration,
+    },
+    /// A store's GC heap was collected.
+    Gc {
+        /// How long the collection took.
+        duration: Duration,
+    },
+}
+
+/// An event recorded by an [`EventSink`].
+#[cfg(feature = "std")]
+#[derive(Copy, Clone, Debug)]
+pub struct RuntimeEvent {
+    /// What happened.
+    pub kind: RuntimeEventKind,
+    /// When the event was recorded, which is when it finished for events
+    /// with a duration.
+    pub timestamp: Instant,
+}
+
+/// A destination for events about compilation, instantiation, traps, memory
+/// growth and garbage collection across all stores of an engine.
+///
+/// A sink is registered with
+/// [`Config::event_sink`](crate::Config::event_sink), and the embedder keeps
+/// a clone of it to periodically [`drain`](EventSink::drain) the recorded
+/// events, for example to aggregate counts and latencies for metrics.
+///
+/// Events aren't delivered through a callback, instead each thread buffers
+/// the events it records in a fixed-size ring of its own without taking any
+/// locks. When a thread's buffer is full further events from that thread are
+/// dropped, and counted, until the buffer is next drained.
+#[cfg(feature = "std")]
+#[derive(Clone)]
+pub struct EventSink {
+    inner: Arc<SinkInner>,
+}
+
+#[cfg(feature = "std")]
+struct SinkInner {
+    capacity: usize,
+    /// The buffers of every thread which has recorded an event to this sink,
+    /// locked only to add a thread's buffer and to drain.
+    buffers: Mutex<Vec<Arc<ThreadBuffer>>>,
+}
+
+#[cfg(feature = "std")]
+std::thread_local! {
+    /// This thread's buffer for each sink it has recorded events to.
+    static BUFFERS: RefCell<Vec<(Weak<SinkInner>, Arc<ThreadBuffer>)>> =
+        const { RefCell::new(Vec::new()) };
+}
+
+#[cfg(feature = "std")]
+impl EventSink {
+    /// Creates a new sink which buffers up to `capacity` events per thread
+    /// between calls to [`EventSink::drain`].
+    pub fn new(capacity: usize) -> EventSink {
+        EventSink {
+            inner: Arc::new(SinkInner {
+                capacity,
+                buffers: Mutex::new(Vec::new()),
+            }),
+        }
+    }
+
+    /// Returns the events recorded since the last call to this method,
+    /// ordered by timestamp, along with the number of events which were
+    /// dropped because a thread's buffer was full.
+    pub fn drain(&self) -> (Vec<RuntimeEvent>, u64) {
+        let mut buffers = self.inner.buffers.lock().unwrap();
+        let mut events = Vec::new();
+        let mut dropped = 0;
+        for buffer in buffers.iter() {
+            buffer.drain_into(&mut events);
+            dropped += buffer.dropped.swap(0, Ordering::Relaxed);
+        }
+        // The buffers of threads which have exited can't receive any more
+        // events, so they're done with once drained.
+        buffers.retain(|buffer| Arc::strong_count(buffer) > 1);
+        events.sort_by_key(|event| event.timestamp);
+        (events, dropped)
+    }
+
+    pub(crate) fn record(&self, kind: RuntimeEventKind) {
+        let event = RuntimeEvent {
+            kind,
+            timestamp: Instant::now(),
+        };
+        // Events recorded while this thread's locals are being destroyed
+        // are ignored.
+        let _ = BUFFERS.try_with(|buffers| {
+            let mut buffers = buffers.borrow_mut();
+            let sink = Arc::as_ptr(&self.inner);
+            let i = match buffers.iter().position(|(s, _)| s.as_ptr() == sink) {
+                Some(i) => i,
+                None => {
+                    buffers.retain(|(s, _)| s.strong_count() > 0);
+                    let buffer = Arc::new(ThreadBuffer::new(self.inner.capacity));
+                    self.inner.buffers.lock().unwrap().push(buffer.clone());
+                    buffers.push((Arc::downgrade(&self.inner), buffer));
+                    buffers.len() - 1
+                }
+            };
+            buffers[i].1.push(event);
+        });
+    }
+}
+
+#[cfg(feature = "std")]
+impl core::fmt::Debug for EventSink {
+    fn fmt(&self, f: &mut core::fmt::Formatter<'_>) -> core::fmt::Result {
+        f.debug_struct("EventSink")
+            .field("capacity", &self.inner.capacity)
+            .finish_non_exhaustive()
+    }
+}
+
+/// A single-producer single-consumer ring buffer of events.
+///
+/// Only the thread owning the buffer pushes, and only `EventSink::drain`,
+/// holding the sink's lock, pops. `tail` is advanced by the producer after
+/// writing a slot and `head` by the consumer after reading slots, so a slot
+/// is never accessed by both at once.
+#[cfg(feature = "std")]
+struct ThreadBuffer {
+    slots: Box<[UnsafeCell<MaybeUninit<RuntimeEvent>>]>,
+    head: AtomicUsize,
+    tail: AtomicUsize,
+    dropped: AtomicU64,
+}
+
+// SAFETY: slots are only accessed as described on `ThreadBuffer`.
+#[cfg(feature = "std")]
+unsafe impl Send for ThreadBuffer {}
+#[cfg(feature = "std")]
+unsafe impl Sync for ThreadBuffer {}
+
+#[cfg(feature = "std")]
+impl ThreadBuffer {
+    fn new(capacity: usize) -> ThreadBuffer {
+        ThreadBuffer {
+            slots: (0..capacity)
+                .map(|_| UnsafeCell::new(MaybeUninit::uninit()))
+                .collect(),
+            head: AtomicUsize::new(0),
+            tail: AtomicUsize::new(0),
+            dropped: AtomicU64::new(0),
+        }
+    }
+
+    /// Pushes `event`, which must only be done by the owning thread.
+    fn push(&self, event: RuntimeEvent) {
+        let tail = self.tail.load(Ordering::Relaxed);
+        let head = self.head.load(Ordering::Acquire);
+        if tail.wrapping_sub(head) == self.slots.len() {
+            self.dropped.fetch_add(1, Ordering::Relaxed);
+            return;
+        }
+        // SAFETY: the slot at `tail` isn't between `head` and `tail` so the
+        // consumer won't read it until `tail` is advanced below.
+        unsafe {
+            (*self.slots[tail % self.slots.len()].get()).write(event);
+        }
+        self.tail.store(tail.wrapping_add(1), Ordering::Release);
+    }
+
+    /// Pops all events into `events`, which must only be done with the
+    /// sink's lock held.
+    fn drain_into(&self, events: &mut Vec<RuntimeEvent>) {
+        let mut head = self.head.load(Ordering::Relaxed);
+        let tail = self.tail.load(Ordering::Acquire);
+        while head != tail {
+            // SAFETY: slots between `head` and `tail` were initialized by
+            // the producer before it advanced `tail`, and it won't write
+            // them again until `head` is advanced below.
+            events.push(unsafe { (*self.slots[head % self.slots.len()].get()).assume_init() });
+            head = head.wrapping_add(1);
+        }
+        self.head.store(head, Ordering::Release);
+    }
+}
+
+/// The start of an event being timed, see `Engine::start_event`.
+pub(crate) struct EventStart {
+    /// When the event started, if the engine has an event sink.
+    #[cfg(feature = "std")]
+    pub(crate) start: Option<Instant>,
+}
@@ -0,0 +1,182 @@
+//! Trimming engines when their cgroup is under memory pressure, see
+//! `Engine::trim_on_memory_pressure`.
+//!
+//! Pressure is detected with a PSI trigger on the `memory.pressure` file of
+//! the process's cgroup, or on the system-wide `/proc/pressure/memory` if the
+//! process isn't in a cgroup v2 hierarchy. Each engine gets a thread which
+//! polls its trigger and calls `Engine::trim` whenever it fires, and which
+//! exits once the engine is dropped.
+//!
+//! The thread is stopped and joined by `prepare_fork`, so that no trim, and
+//! therefore none of the locks that trimming takes, is in progress when the
+//! process forks, and it's restarted in both processes afterwards.
+
+use crate::prelude::*;
+use crate::{Engine, EngineWeak};
+use std::fs::{File, OpenOptions};
+use std::io::Write;
+use std::os::fd::{AsRawFd, FromRawFd};
+use std::sync::Mutex;
+use std::thread::JoinHandle;
+
+/// The PSI trigger: fire when some tasks were stalled on memory for 150ms
+/// within a 1s window, the threshold suggested by the kernel's documentation.
+const TRIGGER: &str = "some 150000 1000000";
+
+/// How long the thread waits for the trigger before checking whether the
+/// engine has been dropped, in milliseconds.
+const POLL_TIMEOUT_MS: libc::c_int = 1000;
+
+/// The memory pressure watcher of an engine, present once
+/// `Engine::trim_on_memory_pressure` has been called.
+#[derive(Default)]
+pub(crate) struct Watcher(Mutex<Option<WatcherState>>);
+
+struct WatcherState {
+    target_bytes: usize,
+    /// The running thread, or `None` while it's stopped for a fork.
+    thread: Option<WatcherThread>,
+}
+
+struct WatcherThread {
+    handle: JoinHandle<()>,
+    /// An eventfd which the thread polls alongside the trigger, and which is
+    /// written to ask it to exit.
+    stop: File,
+}
+
+/// Starts trimming `engine` by up to `target_bytes` each time the trigger
+/// fires.
+pub(crate) fn start(engine: &Engine, target_bytes: usize) -> Result<()> {
+    let mut state = engine.inner.memory_pressure_watcher.0.lock().unwrap();
+    if state.is_some() {
+        bail!("memory pressure trimming was already started for this engine");
+    }
+    let thread = spawn(engine, target_bytes)?;
+    *state = Some(WatcherState {
+        target_bytes,
+        thread: Some(thread),
+    });
+    Ok(())
+}
+
+/// Stops and joins `engine`'s watcher thread, if it has one, ahead of a
+/// fork.
+pub(crate) fn prepare_fork(engine: &Engine) {
+    let mut state = engine.inner.memory_pressure_watcher.0.lock().unwrap();
+    let Some(thread) = state.as_mut().and_then(|s| s.thread.take()) else {
+        return;
+    };
+    // A single write to a fresh eventfd can't overflow its counter, so this
+    // can't fail.
+    (&thread.stop)
+        .write_all(&1u64.to_ne_bytes())
+        .expect("failed to stop the memory pressure thread");
+    let _ = thread.handle.join();
+}
+
+/// Restarts `engine`'s watcher thread, if it was stopped by `prepare_fork`,
+/// in either process after the fork.
+pub(crate) fn after_fork(engine: &Engine) -> Result<()> {
+    let mut state = engine.inner.memory_pressure_watcher.0.lock().unwrap();
+    let Some(state) = state.as_mut() else {
+        return Ok(());
+    };
+    if state.thread.is_none() {
+        state.thread = Some(spawn(engine, state.target_bytes)?);
+    }
+    Ok(())
+}
+
+fn spawn(engine: &Engine, target_bytes: usize) -> Result<WatcherThread> {
+    let trigger = open_trigger()?;
+    // SAFETY: `eventfd` returns a new file descriptor owned by no one else,
+    // or an error.
+    let stop = unsafe {
+        let fd = libc::eventfd(0, libc::EFD_CLOEXEC);
+        if fd < 0 {
+            return Err(Error::from(std::io::Error::last_os_error())
+                .context("failed to create an eventfd for the memory pressure thread"));
+        }
+        File::from_raw_fd(fd)
+    };
+    let thread_stop = stop.try_clone()?;
+    let engine = engine.weak();
+    let handle = std::thread::Builder::new()
+        .name("wasmtime-memory-pressure".to_string())
+        .spawn(move || run(trigger, thread_stop, engine, target_bytes))
+        .context("failed to spawn the memory pressure thread")?;
+    Ok(WatcherThread { handle, stop })
+}
+
+/// Returns the pressure files to try, the cgroup's first.
+fn pressure_files() -> Vec<String> {
+    let mut files = Vec::new();
+    if let Ok(cgroups) = std::fs::read_to_string("/proc/self/cgroup") {
+        // The cgroup v2 hierarchy is the line `0::<path>`.
+        if let Some(path) = cgroups.lines().find_map(|l| l.strip_prefix("0::")) {
+            files.push(format!(
+                "/sys/fs/cgroup{}/memory.pressure",
+                path.trim_end_matches('/')
+            ));
+        }
+    }
+    files.push("/proc/pressure/memory".to_string());
+    files
+}
+
+fn open_trigger() -> Result<File> {
+    let mut error = None;
+    for path in pressure_files() {
+        let file = OpenOptions::new()
+            .read(true)
+            .write(true)
+            .open(&path)
+            .and_then(|mut file| file.write_all(TRIGGER.as_bytes()).map(|()| file));
+        match file {
+            Ok(file) => return Ok(file),
+            Err(e) => {
+                error =
+                    Some(Error::from(e).context(format!("failed to add a PSI trigger to `{path}`")))
+            }
+        }
+    }
+    Err(error.unwrap())
+}
+
+fn run(trigger: File, stop: File, engine: EngineWeak, target_bytes: usize) {
+    let mut pollfds = [
+        libc::pollfd {
+            fd: trigger.as_raw_fd(),
+            events: libc::POLLPRI,
+            revents: 0,
+        },
+        libc::pollfd {
+            fd: stop.as_raw_fd(),
+            events: libc::POLLIN,
+            revents: 0,
+        },
+    ];
+    loop {
+        let rc = unsafe { libc::poll(pollfds.as_mut_ptr(), 2, POLL_TIMEOUT_MS) };
+        if pollfds[1].revents != 0 {
+            return;
+        }
+        let Some(engine) = engine.upgrade() else {
+            return;
+        };
+        if rc < 0 {
+            if std::io::Error::last_os_error().kind() == std::io::ErrorKind::Interrupted {
+                continue;
+            }
+            return;
+        }
+        // `POLLERR` means that the cgroup was removed.
+        if pollfds[0].revents & libc::POLLERR != 0 {
+            return;
+        }
+        if pollfds[0].revents & libc::POLLPRI != 0 {
+            engine.trim(target_bytes);
+        }
+    }
+}
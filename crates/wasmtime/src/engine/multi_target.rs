@@ -0,0 +1,150 @@
+//! Multi-target artifacts, see `Engine::bundle_precompiled`.
+//!
+//! A multi-target artifact bundles several variants of the same precompiled
+//! module or component, typically compiled for different levels of ISA
+//! features, and the best one for the host is picked when it's loaded. Its
+//! header is:
+//!
+//! 1. The 8-byte `MAGIC`, which can't be mistaken for the start of an ELF file.
+//! 2. A version byte, currently `VERSION`.
+//! 3. A byte indicating whether the variants are modules (0) or components
+//!    (1), so that the artifact can be detected without parsing any variant.
+//! 4. Two reserved zero bytes.
+//! 5. The number of variants as a little-endian `u32`.
+//! 6. For each variant, its offset from the start of the artifact and its
+//!    size as little-endian `u64`s.
+
+use super::serialization;
+use crate::prelude::*;
+use crate::{Engine, Precompiled};
+use wasmtime_environ::ObjectKind;
+
+const MAGIC: &[u8; 8] = b"\0wasmfat";
+const VERSION: u8 = 0;
+
+/// The size of the fixed part of the header.
+const HEADER_SIZE: usize = 16;
+
+/// Returns whether `bytes` starts like a multi-target artifact.
+pub fn is_multi_target(bytes: &[u8]) -> bool {
+    bytes.starts_with(MAGIC)
+}
+
+/// Returns which kind of artifact the multi-target artifact in `bytes` is, if
+/// it is one.
+pub fn detect_precompiled(bytes: &[u8]) -> Option<Precompiled> {
+    if !is_multi_target(bytes) || bytes.get(MAGIC.len()) != Some(&VERSION) {
+        return None;
+    }
+    match bytes.get(MAGIC.len() + 1)? {
+        0 => Some(Precompiled::Module),
+        1 => Some(Precompiled::Component),
+        _ => None,
+    }
+}
+
+/// The size of the prefix of a multi-target artifact that
+/// `detect_precompiled` needs.
+pub const DETECT_SIZE: usize = MAGIC.len() + 2;
+
+/// Bundles `variants` into a multi-target artifact, see
+/// `Engine::bundle_precompiled`.
+pub fn bundle(variants: &[&[u8]]) -> Result<Vec<u8>> {
+    let Some(first) = variants.first() else {
+        bail!("a multi-target artifact needs at least one variant");
+    };
+    let kind = serialization::detect_precompiled_bytes(first);
+    for (i, variant) in variants.iter().enumerate() {
+        if super::compression::is_compressed(variant) || is_multi_target(variant) {
+            bail!("variant {i} must be an uncompressed artifact for a single target");
+        }
+        match serialization::detect_precompiled_bytes(variant) {
+            None => bail!("variant {i} is not a precompiled module or component"),
+            k if k != kind => bail!("variant {i} is not the same kind of artifact as variant 0"),
+            _ => {}
+        }
+    }
+    let kind = match kind {
+        Some(Precompiled::Module) => 0,
+        _ => 1,
+    };
+
+    let table_end = HEADER_SIZE + 16 * variants.len();
+    let mut result =
+        Vec::with_capacity(table_end + variants.iter().map(|v| v.len()).sum::<usize>());
+    result.extend_from_slice(MAGIC);
+    result.extend_from_slice(&[VERSION, kind, 0, 0]);
+    result.extend_from_slice(&u32::try_from(variants.len())?.to_le_bytes());
+    let mut offset = table_end;
+    for variant in variants {
+        result.extend_from_slice(&(offset as u64).to_le_bytes());
+        result.extend_from_slice(&(variant.len() as u64).to_le_bytes());
+        offset += variant.len();
+    }
+    for variant in variants {
+        result.extend_from_slice(variant);
+    }
+    Ok(result)
+}
+
+/// Returns the variants of the multi-target artifact in `bytes`.
+fn variants(bytes: &[u8]) -> Result<Vec<&[u8]>> {
+    if detect_precompiled(bytes).is_none() || bytes.len() < HEADER_SIZE {
+        bail!("invalid multi-target artifact header");
+    }
+    let u64_at = |i: usize| u64::from_le_bytes(bytes[i..i + 8].try_into().unwrap());
+    let count = u32::from_le_bytes(bytes[12..16].try_into().unwrap()) as usize;
+    if count
+        .checked_mul(16)
+        .and_then(|n| n.checked_add(HEADER_SIZE))
+        .is_none_or(|n| n > bytes.len())
+    {
+        bail!("multi-target artifact is truncated");
+    }
+    (0..count)
+        .map(|i| {
+            let start = usize::try_from(u64_at(HEADER_SIZE + 16 * i))?;
+            let len = usize::try_from(u64_at(HEADER_SIZE + 16 * i + 8))?;
+            start
+                .checked_add(len)
+                .and_then(|end| bytes.get(start..end))
+                .ok_or_else(|| format_err!("multi-target artifact is truncated"))
+        })
+        .collect()
+}
+
+/// Picks the variant of the multi-target artifact in `bytes` which is
+/// compatible with `engine` and the host and which uses the most ISA features.
+///
+/// If several variants use the same number of features then the first one is
+/// picked, so variants should be bundled from the most to the least
+/// specialized.
+pub fn select<'a>(engine: &Engine, bytes: &'a [u8], expected: ObjectKind) -> Result<&'a [u8]> {
+    let mut best: Option<(usize, &[u8])> = None;
+    let mut errors = Vec::new();
+    for (i, variant) in variants(bytes)?.into_iter().enumerate() {
+        match serialization::check_compatible_variant(engine, variant, expected) {
+            Ok(features) => {
+                if best.is_none_or(|(best, _)| features > best) {
+                    best = Some((features, variant));
+                }
+            }
+            Err(e) => errors.push(format!("variant {i}: {e:#}")),
+        }
+    }
+    match best {
+        Some((_, variant)) => Ok(variant),
+        None => bail!(
+            "no variant of the multi-target artifact is compatible with this host:\n{}",
+            errors.join("\n")
+        ),
+    }
+}
+
+/// Returns the first variant of the multi-target artifact in `bytes`.
+pub fn first_variant(bytes: &[u8]) -> Result<&[u8]> {
+    variants(bytes)?
+        .into_iter()
+        .next()
+        .ok_or_else(|| format_err!("multi-target artifact has no variants"))
+}
@@ -21,6 +21,7 @@
 //! other random ELF files, as well as provide better error messages for
 //! using wasmtime artifacts across versions.
 
+use super::{compression, multi_target};
 use crate::prelude::*;
 use crate::{Engine, ModuleVersionStrategy, Precompiled};
 use core::fmt;
@@ -44,6 +45,34 @@ const VERSION: u8 = 0;
 /// compiler options, etc. If a mismatch is found and the compilation metadata
 /// specified is incompatible then an error is returned.
 pub fn check_compatible(engine: &Engine, mmap: &[u8], expected: ObjectKind) -> Result<()> {
+    read_metadata(engine, mmap, expected)?.check_compatible(engine)
+}
+
+/// Same as `check_compatible`, but additionally returns how many ISA features
+/// the code in `mmap` was compiled to use, which is used to pick the best
+/// variant of a multi-target artifact.
+pub fn check_compatible_variant(
+    engine: &Engine,
+    mmap: &[u8],
+    expected: ObjectKind,
+) -> Result<usize> {
+    let metadata = read_metadata(engine, mmap, expected)?;
+    let isa_features = metadata
+        .isa_flags
+        .iter()
+        .filter(|(_, value)| matches!(value, FlagValue::Bool(true)))
+        .count();
+    metadata.check_compatible(engine)?;
+    Ok(isa_features)
+}
+
+/// Reads the `Metadata` of the artifact in `mmap`, after checking that it's a
+/// Wasmtime artifact of the `expected` kind and version.
+fn read_metadata<'a>(
+    engine: &Engine,
+    mmap: &'a [u8],
+    expected: ObjectKind,
+) -> Result<Metadata<'a>> {
     // Parse the input `mmap` as an ELF file and see if the header matches the
     // Wasmtime-generated header. This includes a Wasmtime-specific `os_abi` and
     // the `e_flags` field should indicate whether `expected` matches or not.
@@ -103,7 +132,7 @@ pub fn check_compatible(engine: &Engine, mmap: &[u8], expected: ObjectKind) -> R
             }
         }
     }
-    postcard::from_bytes::<Metadata<'_>>(data)?.check_compatible(engine)
+    Ok(postcard::from_bytes::<Metadata<'_>>(data)?)
 }
 
 #[cfg(any(feature = "cranelift", feature = "winch"))]
@@ -146,16 +175,116 @@ fn detect_precompiled<'data, R: object::ReadRef<'data>>(
 }
 
 pub fn detect_precompiled_bytes(bytes: &[u8]) -> Option<Precompiled> {
+    if compression::is_compressed(bytes) {
+        return compression::detect_precompiled(bytes);
+    }
+    if multi_target::is_multi_target(bytes) {
+        return multi_target::detect_precompiled(bytes);
+    }
     detect_precompiled(ElfFile64::parse(bytes).ok()?)
 }
 
 #[cfg(feature = "std")]
 pub fn detect_precompiled_file(path: impl AsRef<std::path::Path>) -> Result<Option<Precompiled>> {
+    use object::ReadRef;
+
     let read_cache = object::ReadCache::new(std::fs::File::open(path)?);
+    let detect_size = compression::DETECT_SIZE.max(multi_target::DETECT_SIZE);
+    if let Ok(prefix) = (&read_cache).read_bytes_at(0, detect_size as u64) {
+        if compression::is_compressed(prefix) || multi_target::is_multi_target(prefix) {
+            return Ok(detect_precompiled_bytes(prefix));
+        }
+    }
     let obj = ElfFile64::parse(&read_cache)?;
     Ok(detect_precompiled(obj))
 }
 
+/// Information about a precompiled module read from its headers, returned by
+/// [`Module::inspect_serialized`](crate::Module::inspect_serialized).
+#[derive(Debug, Clone)]
+pub struct SerializedModuleInfo {
+    incompatibility: Option<String>,
+    image_size: usize,
+    text_size: u64,
+    wasm_data_size: u64,
+}
+
+impl SerializedModuleInfo {
+    /// Returns whether the module can be deserialized by the engine it was
+    /// inspected with.
+    pub fn is_compatible(&self) -> bool {
+        self.incompatibility.is_none()
+    }
+
+    /// Returns why the module can't be deserialized by the engine it was
+    /// inspected with, if it can't.
+    pub fn incompatibility(&self) -> Option<&str> {
+        self.incompatibility.as_deref()
+    }
+
+    /// Returns the size, in bytes, of the whole artifact, which is the memory
+    /// it will occupy once deserialized.
+    pub fn image_size(&self) -> usize {
+        self.image_size
+    }
+
+    /// Returns the size, in bytes, of the executable code in the artifact.
+    pub fn text_size(&self) -> u64 {
+        self.text_size
+    }
+
+    /// Returns the size, in bytes, of the module's data segments and other
+    /// wasm data copied into memories at instantiation.
+    pub fn wasm_data_size(&self) -> u64 {
+        self.wasm_data_size
+    }
+}
+
+/// Reads the headers of the precompiled module in `bytes`, without otherwise
+/// validating it, and checks whether it's compatible with `engine`.
+pub fn inspect_module(engine: &Engine, bytes: &[u8]) -> Result<SerializedModuleInfo> {
+    if compression::is_compressed(bytes) {
+        if compression::detect_precompiled(bytes) != Some(Precompiled::Module) {
+            bail!("not a precompiled module");
+        }
+        return inspect_module(engine, &compression::decompress_to_vec(bytes)?);
+    }
+    if multi_target::is_multi_target(bytes) {
+        let variant = multi_target::select(engine, bytes, ObjectKind::Module);
+        return match variant {
+            Ok(variant) => inspect_module(engine, variant),
+            // None of the variants is compatible, so report why for the
+            // first one along with its sizes.
+            Err(e) => {
+                let info = inspect_module(engine, multi_target::first_variant(bytes)?)?;
+                Ok(SerializedModuleInfo {
+                    incompatibility: Some(format!("{e:?}")),
+                    ..info
+                })
+            }
+        };
+    }
+    let obj = ElfFile64::<Endianness>::parse(bytes)
+        .map_err(obj::ObjectCrateErrorWrapper)
+        .context("failed to parse precompiled artifact as an ELF")?;
+    let section_size = |name: &str| obj.section_by_name(name).map_or(0, |s| s.size());
+    let info = SerializedModuleInfo {
+        incompatibility: None,
+        image_size: bytes.len(),
+        text_size: section_size(".text"),
+        wasm_data_size: section_size(obj::ELF_WASM_DATA),
+    };
+    if detect_precompiled(obj) != Some(Precompiled::Module) {
+        bail!("not a precompiled module");
+    }
+    Ok(SerializedModuleInfo {
+        incompatibility: check_compatible(engine, bytes, ObjectKind::Module)
+            .err()
+            .map(|e| format!("{e:?}")),
+        ..info
+    })
+}
+
 #[derive(Serialize, Deserialize)]
 pub struct Metadata<'a> {
     target: String,
@@ -263,10 +392,16 @@ impl Metadata<'_> {
             debug_guest,
             parse_wasm_debuginfo,
             consume_fuel,
+            fuel_per_loop,
+            count_function_calls,
+            cache_call_indirects,
             epoch_interruption,
             memory_may_move,
             guard_before_linear_memory,
+            memory64_index_masking,
+            memory_access_sample_interval,
             table_lazy_init,
+            table_eager_init_threshold,
             relaxed_simd_deterministic,
             winch_callable,
             signals_based_traps,
@@ -277,8 +412,13 @@ impl Metadata<'_> {
             inlining_sum_size_threshold,
             concurrency_support,
 
-            // This doesn't affect compilation, it's just a runtime setting.
+            // These don't affect compilation, they're just runtime settings.
             memory_reservation_for_growth: _,
+            memory_reservation_for_growth_geometric: _,
+            memory_populate: _,
+            memory_huge_pages: _,
+            code_huge_pages: _,
+            debug_native_lazy: _,
 
             // This does technically affect compilation but modules with/without
             // trap information can be loaded into engines with the opposite
@@ -288,6 +428,10 @@ impl Metadata<'_> {
 
             // Just a debugging aid, doesn't affect functionality at all.
             debug_adapter_modules: _,
+
+            // This changes the code that allocates GC objects, but inline and
+            // out-of-line allocation both work with the same runtime.
+            gc_inline_alloc: _,
         } = self.tunables;
 
         Self::check_collector(collector, other.collector)?;
@@ -313,6 +457,17 @@ impl Metadata<'_> {
             "WebAssembly backtrace support",
         )?;
         Self::check_bool(consume_fuel, other.consume_fuel, "fuel support")?;
+        Self::check_bool(fuel_per_loop, other.fuel_per_loop, "per-loop fuel metering")?;
+        Self::check_bool(
+            count_function_calls,
+            other.count_function_calls,
+            "function call counting",
+        )?;
+        Self::check_bool(
+            cache_call_indirects,
+            other.cache_call_indirects,
+            "call_indirect caching",
+        )?;
         Self::check_bool(
             epoch_interruption,
             other.epoch_interruption,
@@ -324,7 +479,22 @@ impl Metadata<'_> {
             other.guard_before_linear_memory,
             "guard before linear memory",
         )?;
+        Self::check_bool(
+            memory64_index_masking,
+            other.memory64_index_masking,
+            "memory64 index masking",
+        )?;
+        Self::check_int(
+            memory_access_sample_interval,
+            other.memory_access_sample_interval,
+            "memory access sample interval",
+        )?;
         Self::check_bool(table_lazy_init, other.table_lazy_init, "table lazy init")?;
+        Self::check_int(
+            table_eager_init_threshold,
+            other.table_eager_init_threshold,
+            "table eager init threshold",
+        )?;
         Self::check_bool(
             relaxed_simd_deterministic,
             other.relaxed_simd_deterministic,
@@ -0,0 +1,179 @@
+//! Engine-wide gauges of loaded code, see `Engine::stats`.
+
+use crate::runtime::code::EngineCode;
+use core::sync::atomic::{AtomicUsize, Ordering};
+
+/// Running totals of the compiled code currently loaded into an engine.
+///
+/// These are updated as `EngineCode` is created and dropped so that taking a
+/// snapshot with `Engine::stats` never needs to walk the loaded modules.
+#[derive(Default)]
+pub(crate) struct CodeStats {
+    code_objects: AtomicUsize,
+    code_bytes: AtomicUsize,
+    text_bytes: AtomicUsize,
+    trampolines: AtomicUsize,
+}
+
+impl CodeStats {
+    /// Records that `code` has been loaded into the engine.
+    pub(crate) fn register(&self, code: &EngineCode) {
+        self.code_objects.fetch_add(1, Ordering::Relaxed);
+        self.code_bytes
+            .fetch_add(code.image().len(), Ordering::Relaxed);
+        self.text_bytes
+            .fetch_add(code.text_size(), Ordering::Relaxed);
+        self.trampolines
+            .fetch_add(code.signatures().trampoline_count(), Ordering::Relaxed);
+    }
+
+    /// Records that `code`, previously passed to `register`, is being
+    /// unloaded from the engine.
+    pub(crate) fn unregister(&self, code: &EngineCode) {
+        self.code_objects.fetch_sub(1, Ordering::Relaxed);
+        self.code_bytes
+            .fetch_sub(code.image().len(), Ordering::Relaxed);
+        self.text_bytes
+            .fetch_sub(code.text_size(), Ordering::Relaxed);
+        self.trampolines
+            .fetch_sub(code.signatures().trampoline_count(), Ordering::Relaxed);
+    }
+}
+
+/// A snapshot of the compiled code and types loaded into an
+/// [`Engine`](crate::Engine), returned by
+/// [`Engine::stats`](crate::Engine::stats).
+///
+/// Each value is a gauge reflecting the state of the engine at the time the
+/// snapshot was taken. Modules and components which are still alive anywhere,
+/// including those only kept alive by instances within a store, are counted.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct EngineStats {
+    pub(crate) code_objects: usize,
+    pub(crate) code_bytes: usize,
+    pub(crate) text_bytes: usize,
+    pub(crate) trampolines: usize,
+    pub(crate) types: usize,
+    pub(crate) rec_groups: usize,
+}
+
+impl EngineStats {
+    pub(crate) fn new(stats: &CodeStats, types: usize, rec_groups: usize) -> EngineStats {
+        EngineStats {
+            code_objects: stats.code_objects.load(Ordering::Relaxed),
+            code_bytes: stats.code_bytes.load(Ordering::Relaxed),
+            text_bytes: stats.text_bytes.load(Ordering::Relaxed),
+            trampolines: stats.trampolines.load(Ordering::Relaxed),
+            types,
+            rec_groups,
+        }
+    }
+
+    /// Returns the number of compiled code objects currently loaded.
+    ///
+    /// Each [`Module`](crate::Module) and each
+    /// [`Component`](crate::component::Component) owns one code object, which
+    /// is shared by all clones of it and, for components, by the core modules
+    /// within it.
+    pub fn code_objects(&self) -> usize {
+        self.code_objects
+    }
+
+    /// Returns the total size, in bytes, of the memory mapped for loaded code
+    /// objects, including their metadata and data segments.
+    pub fn code_bytes(&self) -> usize {
+        self.code_bytes
+    }
+
+    /// Returns the total size, in bytes, of the executable machine code within
+    /// the loaded code objects.
+    pub fn text_bytes(&self) -> usize {
+        self.text_bytes
+    }
+
+    /// Returns the number of wasm-to-host trampolines compiled into the loaded
+    /// code objects.
+    pub fn trampolines(&self) -> usize {
+        self.trampolines
+    }
+
+    /// Returns the number of types registered in the engine's type registry.
+    pub fn types(&self) -> usize {
+        self.types
+    }
+
+    /// Returns the number of distinct rec groups registered in the engine's
+    /// type registry.
+    pub fn rec_groups(&self) -> usize {
+        self.rec_groups
+    }
+}
+
+/// A snapshot of the fiber stacks cached by an [`Engine`](crate::Engine)
+/// using the on-demand instance allocator, returned by
+/// [`Engine::async_stack_cache_stats`](crate::Engine::async_stack_cache_stats).
+///
+/// See [`Config::async_stack_cache_size`](crate::Config::async_stack_cache_size)
+/// for more information about the cache.
+#[cfg(feature = "async")]
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct AsyncStackCacheStats {
+    pub(crate) cached_stacks: usize,
+    pub(crate) hits: u64,
+    pub(crate) misses: u64,
+}
+
+#[cfg(feature = "async")]
+impl AsyncStackCacheStats {
+    /// Returns the number of released fiber stacks currently cached for reuse.
+    pub fn cached_stacks(&self) -> usize {
+        self.cached_stacks
+    }
+
+    /// Returns the number of fiber stack allocations which reused a cached
+    /// stack.
+    pub fn hits(&self) -> u64 {
+        self.hits
+    }
+
+    /// Returns the number of fiber stack allocations which found the cache
+    /// empty and allocated a new stack.
+    pub fn misses(&self) -> u64 {
+        self.misses
+    }
+}
+
+/// A snapshot of the continuation stacks cached by an
+/// [`Engine`](crate::Engine), returned by
+/// [`Engine::continuation_stack_cache_stats`](crate::Engine::continuation_stack_cache_stats).
+///
+/// See [`Config::continuation_stack_cache_size`](crate::Config::continuation_stack_cache_size)
+/// for more information about the cache.
+#[cfg(feature = "stack-switching")]
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct ContinuationStackCacheStats {
+    pub(crate) cached_stacks: usize,
+    pub(crate) hits: u64,
+    pub(crate) misses: u64,
+}
+
+#[cfg(feature = "stack-switching")]
+impl ContinuationStackCacheStats {
+    /// Returns the number of released continuation stacks currently cached
+    /// for reuse.
+    pub fn cached_stacks(&self) -> usize {
+        self.cached_stacks
+    }
+
+    /// Returns the number of continuations whose stack was taken from the
+    /// cache.
+    pub fn hits(&self) -> u64 {
+        self.hits
+    }
+
+    /// Returns the number of continuations which found the cache empty and
+    /// allocated a new stack.
+    pub fn misses(&self) -> u64 {
+        self.misses
+    }
+}
@@ -493,7 +493,10 @@ pub use runtime::*;
 #[cfg(any(feature = "cranelift", feature = "winch"))]
 mod compile;
 #[cfg(any(feature = "cranelift", feature = "winch"))]
-pub use compile::{CodeBuilder, CodeHint};
+pub use compile::{
+    CodeBuilder, CodeHint, CompileDeadlineExceeded, CompileProfile, CompileReport,
+    FunctionCompileReport, FunctionCompileStats, HostIntrinsic,
+};
 
 mod config;
 mod engine;
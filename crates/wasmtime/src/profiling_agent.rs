@@ -1,4 +1,5 @@
 use crate::prelude::*;
+use core::ops::Range;
 
 cfg_if::cfg_if! {
     if #[cfg(all(feature = "profiling", target_os = "linux"))] {
@@ -62,16 +63,41 @@ cfg_if::cfg_if! {
     }
 }
 
+/// The source location of the code starting at `offset` within a function,
+/// as provided to `ProfilingAgent::register_function_with_lines`.
+pub struct SourceLine {
+    pub offset: usize,
+    pub file: String,
+    pub line: u32,
+}
+
 /// Common interface for profiling tools.
 pub trait ProfilingAgent: Send + Sync + 'static {
     fn register_function(&self, name: &str, code: &[u8]);
 
+    /// Same as `register_function`, but `lines` can be called to look up the
+    /// source lines of `code`, for agents which are able to report them.
+    fn register_function_with_lines(
+        &self,
+        name: &str,
+        code: &[u8],
+        lines: &dyn Fn() -> Vec<SourceLine>,
+    ) {
+        let _ = lines;
+        self.register_function(name, code);
+    }
+
     #[cfg(all(feature = "runtime", feature = "pulley"))]
     fn register_interpreter(&self, interp: &crate::vm::Interpreter) {
         let _ = interp;
     }
 
-    fn register_module(&self, code: &[u8], custom_name: &dyn Fn(usize) -> Option<String>) {
+    fn register_module(
+        &self,
+        code: &[u8],
+        custom_name: &dyn Fn(usize) -> Option<String>,
+        source_lines: &dyn Fn(Range<usize>) -> Vec<SourceLine>,
+    ) {
         use object::{File, Object as _, ObjectSection, ObjectSymbol, SectionKind, SymbolKind};
 
         let image = match File::parse(code) {
@@ -111,8 +137,9 @@ pub trait ProfilingAgent: Send + Sync + 'static {
                     }
                     None => name,
                 };
-                let code = &text[address as usize..][..size as usize];
-                self.register_function(name, code)
+                let range = address as usize..(address + size) as usize;
+                let code = &text[range.clone()];
+                self.register_function_with_lines(name, code, &|| source_lines(range.clone()))
             }
         }
     }
@@ -127,5 +154,11 @@ struct NullProfilerAgent;
 
 impl ProfilingAgent for NullProfilerAgent {
     fn register_function(&self, _name: &str, _code: &[u8]) {}
-    fn register_module(&self, _code: &[u8], _custom_name: &dyn Fn(usize) -> Option<String>) {}
+    fn register_module(
+        &self,
+        _code: &[u8],
+        _custom_name: &dyn Fn(usize) -> Option<String>,
+        _source_lines: &dyn Fn(Range<usize>) -> Vec<SourceLine>,
+    ) {
+    }
 }
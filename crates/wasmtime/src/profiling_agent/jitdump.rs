@@ -12,7 +12,7 @@
 //! Note: For descriptive results, the WASM file being executed should contain dwarf debug data
 
 use crate::prelude::*;
-use crate::profiling_agent::ProfilingAgent;
+use crate::profiling_agent::{ProfilingAgent, SourceLine};
 use object::elf;
 use std::process;
 use std::sync::Mutex;
@@ -51,6 +51,27 @@ pub fn new() -> Result<Box<dyn ProfilingAgent>> {
 
 impl ProfilingAgent for JitDumpAgent {
     fn register_function(&self, name: &str, code: &[u8]) {
+        self.register_function_with_lines(name, code, &|| Vec::new());
+    }
+
+    /// Source lines are written as a debug info record ahead of the code load
+    /// record, which `perf inject` turns into a line table for the function.
+    fn register_function_with_lines(
+        &self,
+        name: &str,
+        code: &[u8],
+        lines: &dyn Fn() -> Vec<SourceLine>,
+    ) {
+        let entries = lines()
+            .into_iter()
+            .map(|line| DebugEntry {
+                address: code.as_ptr() as u64 + line.offset as u64,
+                line: line.line,
+                discriminator: 0,
+                filename: line.file,
+            })
+            .collect::<Vec<_>>();
+
         let mut jitdump_file = JITDUMP_FILE.lock().unwrap();
         let jitdump_file = jitdump_file.as_mut().unwrap();
         let timestamp = jitdump_file.get_time_stamp();
@@ -58,6 +79,13 @@ impl ProfilingAgent for JitDumpAgent {
             .as_raw_nonzero()
             .get()
             .cast_unsigned();
+        if !entries.is_empty() {
+            if let Err(err) =
+                jitdump_file.dump_debug_info_record(code.as_ptr() as u64, &entries, timestamp)
+            {
+                println!("Jitdump: dump_debug_info_record failed: {err:?}\n");
+            }
+        }
         if let Err(err) = jitdump_file.dump_code_load_record(&name, code, timestamp, self.pid, tid)
         {
             println!("Jitdump: write_code_load_failed_record failed: {err:?}\n");
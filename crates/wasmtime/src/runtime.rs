@@ -82,15 +82,30 @@ pub use exception::*;
 pub use externals::*;
 pub use func::*;
 pub use gc::*;
-pub use instance::{Instance, InstancePre};
+pub use instance::{
+    FunctionStats, Instance, InstancePool, InstancePre, InstanceSnapshot, PooledInstance,
+    ResetPolicy,
+};
 pub use instantiate::CompiledModule;
 pub use limits::*;
 pub use linker::*;
 pub use memory::*;
-pub use module::{Module, ModuleExport};
+#[cfg(feature = "std")]
+pub use module::SharedCodeRegistry;
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub use module::{LazyModule, ModuleBuilder};
+pub use module::{Module, ModuleExport, ModuleResourceEstimate};
 pub use resources::*;
 #[cfg(all(feature = "async", feature = "call-hook"))]
 pub use store::CallHookHandler;
+#[cfg(all(feature = "call-hook", feature = "std"))]
+pub use store::CallTransition;
+#[cfg(feature = "std")]
+pub use store::CpuUsage;
+#[cfg(feature = "gc")]
+pub use store::GcStats;
+#[cfg(all(feature = "std", unix, has_native_signals))]
+pub use store::InterruptHandle;
 pub use store::{
     AsContext, AsContextMut, CallHook, Store, StoreContext, StoreContextMut, UpdateDeadline,
 };
@@ -105,7 +120,7 @@ pub use vm::{PoolConcurrencyLimitError, PoolingAllocatorMetrics};
 #[cfg(feature = "profiling")]
 mod profiling;
 #[cfg(feature = "profiling")]
-pub use profiling::GuestProfiler;
+pub use profiling::{AggregateGuestProfiler, GuestProfiler, ProfileFormat};
 
 #[cfg(feature = "async")]
 pub(crate) mod stack;
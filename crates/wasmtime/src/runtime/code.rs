@@ -130,11 +130,13 @@ impl EngineCode {
         // EngineCode`.
         crate::module::register_code(&mmap, mmap.raw_addr_range());
 
-        EngineCode {
+        let code = EngineCode {
             original_code: mmap,
             signatures,
             types,
-        }
+        };
+        code.signatures.engine().code_stats().register(&code);
+        code
     }
 
     #[cfg(feature = "component-model")]
@@ -254,6 +256,7 @@ impl EngineCode {
 impl Drop for EngineCode {
     fn drop(&mut self) {
         crate::module::unregister_code(self.original_code.raw_addr_range());
+        self.signatures.engine().code_stats().unregister(self);
     }
 }
 
@@ -3,7 +3,16 @@
 use crate::Engine;
 use crate::prelude::*;
 use crate::runtime::vm::MmapVec;
+#[cfg(feature = "debug-builtins")]
+use crate::{
+    runtime::vm::{GdbJitImageRegistration, SendSyncPtr},
+    sync::RwLock,
+};
 use alloc::sync::Arc;
+#[cfg(feature = "debug-builtins")]
+use alloc::sync::Weak;
+#[cfg(feature = "debug-builtins")]
+use core::mem;
 use core::ops::Range;
 use object::SectionFlags;
 use object::endian::Endianness;
@@ -20,13 +29,20 @@ pub struct CodeMemory {
     #[cfg(has_host_compiler_backend)]
     unwind_registration: Option<crate::runtime::vm::UnwindRegistration>,
     #[cfg(feature = "debug-builtins")]
-    debug_registration: Option<crate::runtime::vm::GdbJitImageRegistration>,
+    debug_image: Option<Arc<DebugImage>>,
     published: bool,
     registered: bool,
     enable_branch_protection: bool,
     needs_executable: bool,
+    #[cfg_attr(
+        not(has_virtual_memory),
+        allow(dead_code, reason = "only used with virtual memory")
+    )]
+    huge_pages: bool,
     #[cfg(feature = "debug-builtins")]
     has_native_debug_info: bool,
+    #[cfg(feature = "debug-builtins")]
+    lazy_debug_info: bool,
     custom_code_memory: Option<Arc<dyn CustomCodeMemory>>,
 
     // Ranges within `self.mmap` of where the particular sections lie.
@@ -63,7 +79,9 @@ impl Drop for CodeMemory {
         #[cfg(has_host_compiler_backend)]
         let _ = self.unwind_registration.take();
         #[cfg(feature = "debug-builtins")]
-        let _ = self.debug_registration.take();
+        if let Some(image) = self.debug_image.take() {
+            *image.state.write() = DebugImageState::Dropped;
+        }
     }
 }
 
@@ -210,14 +228,17 @@ impl CodeMemory {
             #[cfg(has_host_compiler_backend)]
             unwind_registration: None,
             #[cfg(feature = "debug-builtins")]
-            debug_registration: None,
+            debug_image: None,
             published: false,
             registered: false,
             enable_branch_protection: enable_branch_protection
                 .ok_or_else(|| format_err!("missing `{}` section", obj::ELF_WASM_BTI))?,
             needs_executable,
+            huge_pages: engine.tunables().code_huge_pages,
             #[cfg(feature = "debug-builtins")]
             has_native_debug_info,
+            #[cfg(feature = "debug-builtins")]
+            lazy_debug_info: engine.tunables().debug_native_lazy,
             custom_code_memory: engine.custom_code_memory().cloned(),
             text,
             unwind,
@@ -340,6 +361,11 @@ impl CodeMemory {
         //   both the actual unwinding tables as well as the validity of the
         //   pointers we pass in itself.
         unsafe {
+            // On platforms which can batch protection changes, freezing the
+            // image and switching its executable portion to read/execute
+            // below is done with a single batch instead.
+            let batched = self.publish_batched()?;
+
             // Next freeze the contents of this image by making all of the
             // memory readonly. Nothing after this point should ever be modified
             // so commit everything. For a compiled-in-memory image this will
@@ -353,19 +379,27 @@ impl CodeMemory {
             // defense-in-depth measure and isn't required for correctness.
             #[cfg(has_virtual_memory)]
             if self.mmap.supports_virtual_memory() {
-                self.mmap.make_readonly(0..self.mmap.len())?;
+                if self.huge_pages {
+                    self.advise_huge_pages();
+                }
+                if !batched {
+                    self.mmap.make_readonly(0..self.mmap.len())?;
+                }
             }
 
             // Switch the executable portion from readonly to read/execute.
-            if self.needs_executable {
+            if self.needs_executable && !batched {
                 if !self.custom_publish()? {
                     if !self.mmap.supports_virtual_memory() {
                         bail!("this target requires virtual memory to be enabled");
                     }
                     #[cfg(has_virtual_memory)]
-                    self.mmap
-                        .make_executable(self.text.clone(), self.enable_branch_protection)
-                        .context("unable to make memory executable")?;
+                    {
+                        self.mmap
+                            .make_executable(self.text.clone(), self.enable_branch_protection)
+                            .context("unable to make memory executable")?;
+                        flush_pipelines()?;
+                    }
                 }
             }
 
@@ -385,6 +419,56 @@ impl CodeMemory {
         Ok(())
     }
 
+    /// Asks the host to back the text section with transparent huge pages,
+    /// see `Config::code_huge_pages`.
+    ///
+    /// Only whole pages within the text section are affected, and failures are
+    /// only logged since this is just a hint.
+    #[cfg(has_virtual_memory)]
+    fn advise_huge_pages(&self) {
+        let page_size = crate::runtime::vm::host_page_size();
+        let text = self.text();
+        let base = text.as_ptr().addr();
+        let start = base.next_multiple_of(page_size) - base;
+        let end = ((base + text.len()) & !(page_size - 1)).saturating_sub(base);
+        if start >= end {
+            return;
+        }
+        // SAFETY: the range is within the text section, and huge page advice
+        // doesn't change the contents of memory.
+        let result = unsafe {
+            crate::runtime::vm::advise_huge_pages(text.as_ptr().add(start).cast_mut(), end - start)
+        };
+        if let Err(e) = result {
+            log::debug!("failed to request huge pages for compiled code: {e}");
+        }
+    }
+
+    /// Makes this image read-only and its text read/execute with a single
+    /// batch of protection changes, if that's supported and applicable.
+    ///
+    /// Returns whether that was done.
+    #[cfg(has_virtual_memory_batch)]
+    unsafe fn publish_batched(&self) -> Result<bool> {
+        if !self.needs_executable
+            || self.custom_code_memory.is_some()
+            || !self.mmap.supports_virtual_memory()
+        {
+            return Ok(false);
+        }
+        unsafe {
+            self.mmap
+                .make_readonly_and_executable(self.text.clone(), self.enable_branch_protection)
+                .context("unable to make memory executable")?;
+        }
+        Ok(true)
+    }
+
+    #[cfg(not(has_virtual_memory_batch))]
+    unsafe fn publish_batched(&self) -> Result<bool> {
+        Ok(false)
+    }
+
     fn custom_publish(&mut self) -> Result<bool> {
         if let Some(mem) = self.custom_code_memory.as_ref() {
             let text = self.text();
@@ -511,14 +595,30 @@ impl CodeMemory {
             return Ok(());
         }
 
-        // TODO-DebugInfo: we're copying the whole image here, which is pretty wasteful.
-        // Use the existing memory by teaching code here about relocations in DWARF sections
-        // and anything else necessary that is done in "create_gdbjit_image" right now.
-        let image = self.mmap().to_vec();
-        let text: &[u8] = self.text();
-        let bytes = crate::native_debug::create_gdbjit_image(image, (text.as_ptr(), text.len()))?;
-        let reg = crate::runtime::vm::GdbJitImageRegistration::register(bytes);
-        self.debug_registration = Some(reg);
+        let image = Arc::new(DebugImage {
+            state: RwLock::new(DebugImageState::Pending {
+                image: SendSyncPtr::from(&self.mmap[..]),
+                text: SendSyncPtr::from(self.text()),
+            }),
+        });
+        if self.lazy_debug_info {
+            let mut pending = PENDING_DEBUG_IMAGES.write();
+            // Forget about dropped code before growing the list, so that it
+            // doesn't grow with code which is repeatedly loaded and dropped.
+            if pending.len() == pending.capacity() {
+                pending.retain(|image| image.strong_count() > 0);
+            }
+            pending.push(Arc::downgrade(&image));
+            drop(pending);
+            if GdbJitImageRegistration::debugger_attached() {
+                register_pending_debug_images()?;
+            }
+        } else {
+            let mut state = image.state.write();
+            let file = state.create_gdbjit_image()?.unwrap();
+            *state = DebugImageState::Registered(GdbJitImageRegistration::register(file));
+        }
+        self.debug_image = Some(image);
         Ok(())
     }
 
@@ -546,6 +646,123 @@ impl CodeMemory {
     }
 }
 
+#[cfg(feature = "std")]
+std::thread_local! {
+    /// Whether a `publish_batch` is running on this thread.
+    static IN_PUBLISH_BATCH: core::cell::Cell<bool> = const { core::cell::Cell::new(false) };
+}
+
+/// Flushes the pipelines of all cores running threads of this process, so
+/// that none of them executes stale instructions from newly executable code,
+/// unless that's left to a `publish_batch` running on this thread.
+///
+/// On some platforms, notably AArch64 Linux, this interrupts all of those
+/// cores, which is why it's batched.
+#[cfg(has_virtual_memory)]
+fn flush_pipelines() -> Result<()> {
+    #[cfg(feature = "std")]
+    if !IN_PUBLISH_BATCH.get() {
+        wasmtime_jit_icache_coherence::pipeline_flush_mt().context("Failed pipeline flush")?;
+    }
+    Ok(())
+}
+
+/// Runs `f`, which may publish many `CodeMemory`s on this thread, flushing the
+/// pipelines of other cores once for all of them after it returns instead of
+/// once per `CodeMemory`.
+///
+/// Code published by `f` must not run on other threads before this returns,
+/// so `f` shouldn't share it.
+#[cfg(feature = "std")]
+pub(crate) fn publish_batch<R>(f: impl FnOnce() -> Result<R>) -> Result<R> {
+    struct Reset(bool);
+
+    impl Drop for Reset {
+        fn drop(&mut self) {
+            IN_PUBLISH_BATCH.set(self.0);
+        }
+    }
+
+    let nested = IN_PUBLISH_BATCH.replace(true);
+    let reset = Reset(nested);
+    let result = f();
+    drop(reset);
+    if !nested {
+        #[cfg(has_virtual_memory)]
+        flush_pipelines()?;
+    }
+    result
+}
+
+/// The native debug image of a `CodeMemory`, which with
+/// `Config::debug_info_lazy` may be registered after the `CodeMemory` was
+/// published, by `register_pending_debug_images`.
+#[cfg(feature = "debug-builtins")]
+struct DebugImage {
+    state: RwLock<DebugImageState>,
+}
+
+#[cfg(feature = "debug-builtins")]
+enum DebugImageState {
+    /// Not registered yet. The pointers are to the `CodeMemory`'s whole image
+    /// and its text section, which stay valid until the state is `Dropped`.
+    Pending {
+        image: SendSyncPtr<[u8]>,
+        text: SendSyncPtr<[u8]>,
+    },
+    #[allow(dead_code, reason = "only held to keep the image registered")]
+    Registered(GdbJitImageRegistration),
+    /// The `CodeMemory` has been dropped, or is being dropped.
+    Dropped,
+}
+
+#[cfg(feature = "debug-builtins")]
+impl DebugImageState {
+    /// Creates the image to register with the debugger, if this is still
+    /// pending.
+    fn create_gdbjit_image(&self) -> Result<Option<Vec<u8>>> {
+        let DebugImageState::Pending { image, text } = self else {
+            return Ok(None);
+        };
+        // SAFETY: pending pointers are valid, see `DebugImageState::Pending`.
+        let image = unsafe { &*image.as_ptr() };
+        let text = (text.as_ptr().cast::<u8>().cast_const(), text.len());
+        // TODO-DebugInfo: we're copying the whole image here, which is pretty wasteful.
+        // Use the existing memory by teaching code here about relocations in DWARF sections
+        // and anything else necessary that is done in "create_gdbjit_image" right now.
+        crate::native_debug::create_gdbjit_image(image.to_vec(), text).map(Some)
+    }
+}
+
+/// Debug images which haven't been registered yet because of
+/// `Config::debug_info_lazy`.
+#[cfg(feature = "debug-builtins")]
+static PENDING_DEBUG_IMAGES: RwLock<Vec<Weak<DebugImage>>> = RwLock::new(Vec::new());
+
+/// Registers all pending debug images with the debugger in one batch.
+#[cfg(feature = "debug-builtins")]
+pub(crate) fn register_pending_debug_images() -> Result<()> {
+    let pending = mem::take(&mut *PENDING_DEBUG_IMAGES.write());
+    let images = pending.iter().filter_map(Weak::upgrade).collect::<Vec<_>>();
+
+    // Each image's state stays locked until it's registered so that its
+    // `CodeMemory` can't be dropped in the meantime.
+    let mut states = Vec::with_capacity(images.len());
+    let mut files = Vec::with_capacity(images.len());
+    for image in images.iter() {
+        let state = image.state.write();
+        if let Some(file) = state.create_gdbjit_image()? {
+            states.push(state);
+            files.push(file);
+        }
+    }
+    let registrations = GdbJitImageRegistration::register_batch(files);
+    for (mut state, registration) in states.into_iter().zip(registrations) {
+        *state = DebugImageState::Registered(registration);
+    }
+    Ok(())
+}
+
 /// Returns the range of `inner` within `outer`, such that `outer[range]` is the
 /// same as `inner`.
 ///
@@ -5,6 +5,7 @@ use crate::prelude::*;
 #[cfg(feature = "std")]
 use crate::runtime::vm::open_file_for_mmap;
 use crate::runtime::vm::{CompiledModuleId, VMArrayCallFunction, VMFuncRef, VMWasmCallFunction};
+use crate::sync::{OnceLock, RwLock};
 use crate::{
     Engine, Module, ResourcesRequired, code::EngineCode, code_memory::CodeMemory,
     type_registry::TypeCollection,
@@ -20,8 +21,8 @@ use wasmtime_environ::component::{
     GlobalInitializer, InstantiateModule, NameMapNoIntern, OptionsIndex, StaticModuleIndex,
     TrampolineIndex, TypeComponentIndex, TypeFuncIndex, UnsafeIntrinsic, VMComponentOffsets,
 };
-use wasmtime_environ::{Abi, CompiledFunctionsTable, FuncKey, TypeTrace};
-use wasmtime_environ::{FunctionLoc, HostPtr, ObjectKind, PrimaryMap};
+use wasmtime_environ::{Abi, CompiledFunctionsTable, CompiledModuleInfo, FuncKey, TypeTrace};
+use wasmtime_environ::{FunctionLoc, HostPtr, ObjectKind, PrimaryMap, VMOffsets};
 
 /// A compiled WebAssembly Component.
 ///
@@ -74,7 +75,7 @@ struct ComponentInner {
 
     /// Core wasm modules that the component defined internally, indexed by the
     /// compile-time-assigned `ModuleUpvarIndex`.
-    static_modules: PrimaryMap<StaticModuleIndex, Module>,
+    static_modules: PrimaryMap<StaticModuleIndex, StaticModule>,
 
     /// Code-related information such as the compiled artifact, type
     /// information, etc.
@@ -96,6 +97,37 @@ struct ComponentInner {
     realloc_func_type: Arc<FuncType>,
 }
 
+/// A core wasm module defined within a component which is turned into a
+/// [`Module`] the first time that it's needed, typically when it's first
+/// instantiated.
+///
+/// Components may contain core modules which are only instantiated
+/// conditionally, for example as part of optional features, so this avoids
+/// paying for the creation of those which are never used when a component is
+/// loaded.
+struct StaticModule {
+    /// The module's compilation metadata, taken when `module` is created.
+    info: RwLock<Option<CompiledModuleInfo>>,
+    module: OnceLock<Module>,
+}
+
+impl StaticModule {
+    fn get(
+        &self,
+        engine: &Engine,
+        code: &Arc<EngineCode>,
+        index: &Arc<CompiledFunctionsTable>,
+    ) -> &Module {
+        self.module.get_or_init(|| {
+            let info = self.info.write().take().unwrap();
+            // The module was already validated against the engine's instance
+            // allocator when the component was created, so this can't fail.
+            Module::from_parts_raw(engine, code.clone(), info, index.clone(), false)
+                .expect("static module was validated when its component was created")
+        })
+    }
+}
+
 pub(crate) struct AllCallFuncPointers {
     pub wasm_call: NonNull<VMWasmCallFunction>,
     pub array_call: NonNull<VMArrayCallFunction>,
@@ -256,6 +288,29 @@ impl Component {
         Component::from_parts(engine, code, None)
     }
 
+    /// Same as [`Module::deserialize_files`], but for components.
+    ///
+    /// # Unsafety
+    ///
+    /// The unsafety of this method is the same as that of the
+    /// [`Module::deserialize_files`] method.
+    ///
+    /// [`Module::deserialize_files`]: crate::Module::deserialize_files
+    #[cfg(feature = "std")]
+    pub unsafe fn deserialize_files<P: AsRef<Path>>(
+        engine: &Engine,
+        paths: impl IntoIterator<Item = P>,
+    ) -> Result<Vec<Component>> {
+        crate::runtime::code_memory::publish_batch(|| {
+            paths
+                .into_iter()
+                // SAFETY: the contract of `deserialize_file` is the same as
+                // this function's for each path.
+                .map(|path| unsafe { Self::deserialize_file(engine, path) })
+                .collect()
+        })
+    }
+
     /// Returns the type of this component as a [`types::Component`].
     ///
     /// This method enables runtime introspection of the type of a component
@@ -435,15 +490,20 @@ impl Component {
         let types = Arc::new(types);
         let code = Arc::new(EngineCode::new(code_memory, signatures, types.into()));
 
-        // Convert all information about static core wasm modules into actual
-        // `Module` instances by converting each `CompiledModuleInfo`, the
-        // `types` type information, and the code memory to a runtime object.
+        // Validate that each static core wasm module can be used with the
+        // current instance allocator, but defer converting them into actual
+        // `Module` instances until they're first needed, see `StaticModule`.
+        for (_, info) in static_modules.iter() {
+            let offsets = VMOffsets::new(HostPtr, &info.module);
+            engine.allocator().validate_module(&info.module, &offsets)?;
+        }
         let static_modules = static_modules
             .into_iter()
-            .map(|(_, info)| {
-                Module::from_parts_raw(engine, code.clone(), info, index.clone(), false)
+            .map(|(_, info)| StaticModule {
+                info: RwLock::new(Some(info)),
+                module: OnceLock::new(),
             })
-            .collect::<Result<_>>()?;
+            .collect();
 
         let realloc_func_type = Arc::new(FuncType::new(
             engine,
@@ -474,12 +534,16 @@ impl Component {
     }
 
     pub(crate) fn static_module(&self, idx: StaticModuleIndex) -> &Module {
-        &self.inner.static_modules[idx]
+        let inner = &*self.inner;
+        inner.static_modules[idx].get(&inner.engine, &inner.code, &inner.index)
     }
 
     #[cfg(feature = "profiling")]
     pub(crate) fn static_modules(&self) -> impl Iterator<Item = &Module> {
-        self.inner.static_modules.values()
+        self.inner
+            .static_modules
+            .keys()
+            .map(|idx| self.static_module(idx))
     }
 
     #[inline]
@@ -703,8 +767,8 @@ impl Component {
     /// as a performance optimization if required but is otherwise handled
     /// automatically.
     pub fn initialize_copy_on_write_image(&self) -> Result<()> {
-        for (_, module) in self.inner.static_modules.iter() {
-            module.initialize_copy_on_write_image()?;
+        for idx in self.inner.static_modules.keys() {
+            self.static_module(idx).initialize_copy_on_write_image()?;
         }
         Ok(())
     }
@@ -929,8 +993,11 @@ mod tests {
         )
         .unwrap();
 
-        for (_, module) in component.inner.static_modules.iter() {
-            let init = &module.env_module().memory_initialization;
+        for idx in component.inner.static_modules.keys() {
+            let init = &component
+                .static_module(idx)
+                .env_module()
+                .memory_initialization;
             assert!(matches!(init, MemoryInitialization::Static { .. }));
         }
     }
@@ -957,4 +1024,35 @@ mod tests {
         // Length may be strictly greater if it becomes page-aligned.
         assert!(len >= bytes.len());
     }
+    #[test]
+    #[cfg_attr(miri, ignore)]
+    fn static_modules_created_on_first_use() {
+        let wat = r#"
+                (component
+                    (core module $a)
+                    (core module $b)
+                    (core instance (instantiate $a))
+                )
+            "#;
+        let engine = Engine::default();
+        let mut builder = CodeBuilder::new(&engine);
+        builder.wasm_binary_or_text(wat.as_bytes(), None).unwrap();
+        let bytes = builder.compile_component_serialized().unwrap();
+
+        let comp = unsafe { Component::deserialize(&engine, &bytes).unwrap() };
+        let created = |comp: &Component| {
+            comp.inner
+                .static_modules
+                .values()
+                .map(|m| m.info.read().is_none())
+                .collect::<Vec<_>>()
+        };
+        assert_eq!(created(&comp), [false, false]);
+
+        let mut store = crate::Store::new(&engine, ());
+        crate::component::Linker::new(&engine)
+            .instantiate(&mut store, &comp)
+            .unwrap();
+        assert_eq!(created(&comp), [true, false]);
+    }
 }
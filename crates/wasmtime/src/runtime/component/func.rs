@@ -20,9 +20,11 @@ use wasmtime_environ::component::{
 use crate::component::concurrent::{self, AsAccessor, PreparedCall};
 
 mod host;
+mod lazy;
 mod options;
 mod typed;
 pub use self::host::*;
+pub use self::lazy::*;
 pub use self::options::*;
 pub use self::typed::*;
 
@@ -238,6 +240,71 @@ impl Func {
         Ok(())
     }
 
+    /// Calls this function like [`Func::call`], but provides its results to
+    /// `results` as they're stored in the guest rather than as [`Val`]s.
+    ///
+    /// The [`LazyResults`] passed to `results` lifts each result, or each
+    /// element of a `list<T>` result, only when it's accessed. This means that
+    /// large results can be converted to the embedder's own representation
+    /// without first materializing them as a tree of [`Val`]s. The results
+    /// are only valid within the `results` closure, after which the
+    /// `post-return` function of the callee, which may free them, is run.
+    ///
+    /// The value returned by `results` is returned from this function, and
+    /// an error returned by `results` is propagated without running
+    /// `post-return`, like a failure to lift the results of [`Func::call`].
+    ///
+    /// # Errors
+    ///
+    /// Returns an error in the same situations as [`Func::call`].
+    ///
+    /// # Panics
+    ///
+    /// Panics if `store` does not own this function.
+    pub fn call_lazy<R>(
+        &self,
+        mut store: impl AsContextMut,
+        params: &[Val],
+        results: impl FnOnce(LazyResults<'_, '_>) -> Result<R>,
+    ) -> Result<R> {
+        let mut store = store.as_context_mut();
+        store.0.validate_sync_call()?;
+
+        let ty = self.ty(&store);
+        if ty.params().len() != params.len() {
+            bail!(
+                "expected {} argument(s), got {}",
+                ty.params().len(),
+                params.len(),
+            );
+        }
+
+        if self.abi_async(store.0) {
+            unreachable!(
+                "async-lifted exports should have failed validation \
+                 when `component-model-async` feature disabled"
+            );
+        }
+
+        // SAFETY: see `call_impl`, the parameters and results are modeled in
+        // the same way here.
+        let (ret, post_return_arg) = unsafe {
+            self.call_raw(
+                store.as_context_mut(),
+                |cx, ty, dst: &mut MaybeUninit<[MaybeUninit<ValRaw>; MAX_FLAT_PARAMS]>| {
+                    let dst: &mut [MaybeUninit<ValRaw>] = dst.assume_init_mut();
+                    Self::lower_args(cx, params, ty, dst)
+                },
+                |cx, results_ty, src: &[ValRaw; MAX_FLAT_RESULTS]| {
+                    results(LazyResults::new(cx, results_ty, src, MAX_FLAT_RESULTS)?)
+                },
+            )?
+        };
+
+        self.post_return_impl(store, post_return_arg)?;
+        Ok(ret)
+    }
+
     /// Exactly like [`Self::call`] except for use on async stores.
     ///
     /// # Panics
@@ -633,6 +700,7 @@ impl Func {
 
         self.with_lower_context(store.as_context_mut(), |cx, ty| {
             cx.enter_call();
+            cx.use_argument_scratch();
             lower(cx, ty, map_maybe_uninit!(space.params))
         })?;
 
@@ -0,0 +1,209 @@
+use crate::ValRaw;
+use crate::component::func::LiftContext;
+use crate::component::values::{self, Val};
+use crate::prelude::*;
+use wasmtime_environ::component::InterfaceType;
+
+/// The results of a call made with [`Func::call_lazy`](super::Func::call_lazy),
+/// which are lifted from the guest as they're accessed rather than all at
+/// once.
+///
+/// Unlike the results of [`Func::call`](super::Func::call) this doesn't
+/// require converting the entire result into [`Val`]s up front. For example
+/// the elements of a large `list<T>` result can be read one at a time with
+/// [`LazyResults::list`], and converted into the embedder's own data
+/// structures as they go, without first building a [`Val::List`] of all of
+/// them.
+pub struct LazyResults<'a, 'b> {
+    cx: &'a mut LiftContext<'b>,
+    types: &'b [InterfaceType],
+    src: Src<'a>,
+}
+
+enum Src<'a> {
+    /// The results were returned as flat core wasm values.
+    Flat(&'a [ValRaw]),
+    /// The results were returned in linear memory, starting at this offset.
+    Memory(usize),
+}
+
+impl<'a, 'b> LazyResults<'a, 'b> {
+    pub(crate) fn new(
+        cx: &'a mut LiftContext<'b>,
+        results_ty: InterfaceType,
+        src: &'a [ValRaw],
+        max_flat: usize,
+    ) -> Result<LazyResults<'a, 'b>> {
+        let all_types = cx.types;
+        let results_ty = match results_ty {
+            InterfaceType::Tuple(i) => &all_types[i],
+            _ => unreachable!(),
+        };
+        let src = if results_ty.abi.flat_count(max_flat).is_some() {
+            Src::Flat(src)
+        } else {
+            // FIXME(#4311): needs to read an i64 for memory64
+            let ptr = usize::try_from(src[0].get_u32())?;
+            if ptr % usize::try_from(results_ty.abi.align32)? != 0 {
+                bail!("return pointer not aligned");
+            }
+            match ptr.checked_add(usize::try_from(results_ty.abi.size32)?) {
+                Some(end) if end <= cx.memory().len() => {}
+                _ => bail!("pointer out of bounds of memory"),
+            }
+            Src::Memory(ptr)
+        };
+        Ok(LazyResults {
+            cx,
+            types: &results_ty.types,
+            src,
+        })
+    }
+
+    /// Returns the number of results of the function.
+    pub fn len(&self) -> usize {
+        self.types.len()
+    }
+
+    /// Returns whether the function has no results.
+    pub fn is_empty(&self) -> bool {
+        self.types.is_empty()
+    }
+
+    /// Lifts the entire result at `index` into a [`Val`].
+    ///
+    /// # Panics
+    ///
+    /// Panics if `index` is out of bounds.
+    pub fn get(&mut self, index: usize) -> Result<Val> {
+        let ty = self.types[index];
+        match self.src {
+            Src::Flat(src) => {
+                let start = self.flat_offset(index);
+                Val::lift(self.cx, ty, &mut src[start..].iter())
+            }
+            Src::Memory(ptr) => {
+                let (offset, size) = self.memory_offset(index);
+                let bytes = &self.cx.memory()[ptr + offset..][..size];
+                Val::load(self.cx, ty, bytes)
+            }
+        }
+    }
+
+    /// Returns a view of the `list<T>` result at `index` whose elements are
+    /// lifted one at a time as they're accessed.
+    ///
+    /// Returns an error if the result isn't a list, or if the list is out of
+    /// bounds of the guest's memory.
+    ///
+    /// # Panics
+    ///
+    /// Panics if `index` is out of bounds.
+    pub fn list(&mut self, index: usize) -> Result<LazyList<'_, 'b>> {
+        let elem = match self.types[index] {
+            InterfaceType::List(i) => self.cx.types[i].element,
+            _ => bail!("result {index} is not a list"),
+        };
+        // FIXME(#4311): needs memory64 treatment
+        let (ptr, len) = match self.src {
+            Src::Flat(src) => {
+                let start = self.flat_offset(index);
+                (src[start].get_u32(), src[start + 1].get_u32())
+            }
+            Src::Memory(ptr) => {
+                let (offset, _) = self.memory_offset(index);
+                let bytes = &self.cx.memory()[ptr + offset..][..8];
+                (
+                    u32::from_le_bytes(bytes[..4].try_into().unwrap()),
+                    u32::from_le_bytes(bytes[4..].try_into().unwrap()),
+                )
+            }
+        };
+        let (ptr, len) = (usize::try_from(ptr)?, usize::try_from(len)?);
+        let elem_size = values::check_list(self.cx, elem, ptr, len)?;
+        Ok(LazyList {
+            cx: &mut *self.cx,
+            elem,
+            elem_size,
+            ptr,
+            len,
+            next: 0,
+        })
+    }
+
+    /// Returns the index of the first flat value of the result at `index`.
+    fn flat_offset(&self, index: usize) -> usize {
+        let types = self.cx.types;
+        self.types[..index]
+            .iter()
+            .map(|ty| types.canonical_abi(ty).flat_count(usize::MAX).unwrap())
+            .sum()
+    }
+
+    /// Returns the offset and size in memory of the result at `index`,
+    /// relative to the start of the results.
+    fn memory_offset(&self, index: usize) -> (usize, usize) {
+        let types = self.cx.types;
+        let mut offset = 0;
+        let mut field = 0;
+        for ty in &self.types[..=index] {
+            field = types.canonical_abi(ty).next_field32_size(&mut offset);
+        }
+        let size = types.canonical_abi(&self.types[index]).size32;
+        (field, usize::try_from(size).unwrap())
+    }
+}
+
+/// A `list<T>` result of a call made with
+/// [`Func::call_lazy`](super::Func::call_lazy), see [`LazyResults::list`].
+///
+/// This is an iterator which lifts each element of the list as it's reached.
+/// The bounds of the list were checked when this was created, but each element
+/// is validated only when it's lifted.
+pub struct LazyList<'a, 'b> {
+    cx: &'a mut LiftContext<'b>,
+    elem: InterfaceType,
+    elem_size: usize,
+    ptr: usize,
+    len: usize,
+    next: usize,
+}
+
+impl LazyList<'_, '_> {
+    /// Returns the total number of elements in this list, including those
+    /// already iterated over.
+    pub fn list_len(&self) -> usize {
+        self.len
+    }
+
+    /// Lifts the element at `index` of this list.
+    ///
+    /// Returns `None` if `index` is out of bounds. This doesn't affect the
+    /// position of this iterator.
+    pub fn get(&mut self, index: usize) -> Option<Result<Val>> {
+        if index >= self.len {
+            return None;
+        }
+        // The bounds of the whole list were checked when it was created, so
+        // this can't go out of bounds.
+        let bytes = &self.cx.memory()[self.ptr + index * self.elem_size..][..self.elem_size];
+        Some(Val::load(self.cx, self.elem, bytes))
+    }
+}
+
+impl Iterator for LazyList<'_, '_> {
+    type Item = Result<Val>;
+
+    fn next(&mut self) -> Option<Result<Val>> {
+        let ret = self.get(self.next)?;
+        self.next += 1;
+        Some(ret)
+    }
+
+    fn size_hint(&self) -> (usize, Option<usize>) {
+        let remaining = self.len - self.next;
+        (remaining, Some(remaining))
+    }
+}
+
+impl ExactSizeIterator for LazyList<'_, '_> {}
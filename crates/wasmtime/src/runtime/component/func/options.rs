@@ -5,13 +5,15 @@ use crate::component::resources::{HostResourceData, HostResourceIndex, HostResou
 use crate::component::{Instance, ResourceType, RuntimeInstance};
 use crate::prelude::*;
 use crate::runtime::vm::VMFuncRef;
-use crate::runtime::vm::component::{CallContexts, ComponentInstance, HandleTable, ResourceTables};
+use crate::runtime::vm::component::{
+    ArgumentScratch, CallContexts, ComponentInstance, HandleTable, ResourceTables,
+};
 use crate::store::{StoreId, StoreOpaque};
 use alloc::sync::Arc;
 use core::pin::Pin;
 use core::ptr::NonNull;
 use wasmtime_environ::component::{
-    CanonicalOptions, CanonicalOptionsDataModel, ComponentTypes, OptionsIndex,
+    CanonicalOptions, CanonicalOptionsDataModel, ComponentTypes, OptionsIndex, RuntimeReallocIndex,
     TypeResourceTableIndex,
 };
 
@@ -47,6 +49,10 @@ pub struct LowerContext<'a, T: 'static> {
 
     /// Whether to allow `options.realloc` to be used when lowering.
     allow_realloc: bool,
+
+    /// Whether allocations are made from the instance's `ArgumentScratch`,
+    /// see `use_argument_scratch`.
+    argument_scratch: bool,
 }
 
 #[doc(hidden)]
@@ -70,6 +76,7 @@ impl<'a, T: 'static> LowerContext<'a, T> {
             types: component.types(),
             instance,
             allow_realloc: true,
+            argument_scratch: false,
         }
     }
 
@@ -94,6 +101,7 @@ impl<'a, T: 'static> LowerContext<'a, T> {
             types: component.types(),
             instance,
             allow_realloc: false,
+            argument_scratch: false,
         }
     }
 
@@ -138,15 +146,62 @@ impl<'a, T: 'static> LowerContext<'a, T> {
     ) -> Result<usize> {
         assert!(self.allow_realloc);
 
-        let (component, store) = self.instance.component_and_store_mut(self.store.0);
-        let instance = self.instance.id().get(store);
-        let options = &component.env_component().options[self.options];
-        let realloc_ty = component.realloc_func_ty();
-        let realloc = match options.data_model {
+        let realloc = match self.options().data_model {
             CanonicalOptionsDataModel::Gc {} => unreachable!(),
             CanonicalOptionsDataModel::LinearMemory(m) => m.realloc.unwrap(),
         };
-        let realloc = instance.runtime_realloc(realloc);
+        if self.argument_scratch && old == 0 {
+            return self.scratch_alloc(realloc, old_align, new_size);
+        }
+        self.call_realloc(realloc, old, old_size, old_align, new_size)
+    }
+
+    /// Allocates from the instance's `ArgumentScratch`, allocating a new
+    /// region with `realloc` if none of the existing ones have enough space.
+    fn scratch_alloc(
+        &mut self,
+        realloc: RuntimeReallocIndex,
+        align: u32,
+        size: usize,
+    ) -> Result<usize> {
+        let scratch = self.instance_mut().argument_scratch().unwrap();
+        if let Some(ret) = scratch.alloc(realloc, align, size) {
+            return Ok(ret);
+        }
+        let region_align = align.max(ArgumentScratch::REGION_ALIGN);
+        let region_size = size.max(ArgumentScratch::MIN_REGION_SIZE);
+        let base = self.call_realloc(realloc, 0, 0, region_align, region_size)?;
+        let scratch = self.instance_mut().argument_scratch().unwrap();
+        scratch.push(realloc, base, region_size, size);
+        Ok(base)
+    }
+
+    /// Lowers strings and lists into the instance's `ArgumentScratch`, if it's
+    /// enabled, instead of allocating them with `realloc` individually.
+    ///
+    /// This must only be used for the arguments of a call to an export, and
+    /// it starts reusing the scratch from the beginning.
+    pub(crate) fn use_argument_scratch(&mut self) {
+        self.argument_scratch = match self.instance_mut().argument_scratch() {
+            Some(scratch) => {
+                scratch.reset();
+                true
+            }
+            None => false,
+        };
+    }
+
+    fn call_realloc(
+        &mut self,
+        realloc: RuntimeReallocIndex,
+        old: usize,
+        old_size: usize,
+        old_align: u32,
+        new_size: usize,
+    ) -> Result<usize> {
+        let (component, store) = self.instance.component_and_store_mut(self.store.0);
+        let realloc_ty = component.realloc_func_ty();
+        let realloc = self.instance.id().get(store).runtime_realloc(realloc);
 
         let params = (
             u32::try_from(old)?,
@@ -347,6 +347,31 @@ impl Instance {
         })
     }
 
+    /// Configures whether string and list arguments of synchronous calls to
+    /// this instance's exports are lowered into guest memory that's reused
+    /// across calls.
+    ///
+    /// By default each string or list argument is allocated by calling the
+    /// guest's `realloc` function, and the guest takes ownership of the
+    /// allocation. When this is enabled arguments are instead placed in
+    /// regions which are allocated with `realloc` the first time they're
+    /// needed and then reused by later calls, so repeated calls with similarly
+    /// sized arguments don't call `realloc` at all.
+    ///
+    /// This is only correct for guests which neither free nor retain their
+    /// arguments past the end of a call, since the next call overwrites them.
+    /// Disabling this forgets the regions without returning them to the
+    /// guest's allocator.
+    ///
+    /// # Panics
+    ///
+    /// Panics if `store` does not own this instance.
+    pub fn set_argument_scratch(&self, mut store: impl AsContextMut, enable: bool) {
+        self.id()
+            .get_mut(store.as_context_mut().0)
+            .set_argument_scratch(enable);
+    }
+
     fn lookup_export<'a>(
         &self,
         store: &'a StoreOpaque,
@@ -127,7 +127,8 @@ pub use self::concurrent::{
 #[cfg(feature = "component-model-async")]
 pub use self::func::TaskExit;
 pub use self::func::{
-    ComponentNamedList, ComponentType, Func, Lift, Lower, TypedFunc, WasmList, WasmStr,
+    ComponentNamedList, ComponentType, Func, LazyList, LazyResults, Lift, Lower, TypedFunc,
+    WasmList, WasmStr,
 };
 pub use self::has_data::*;
 pub use self::instance::{Instance, InstanceExportLookup, InstancePre};
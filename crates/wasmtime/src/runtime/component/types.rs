@@ -267,6 +267,15 @@ impl TypeChecker<'_> {
             .all(|(&a, &b)| self.interface_types_equal(a, b))
     }
 
+    fn funcs_equal(&self, f1: TypeFuncIndex, f2: TypeFuncIndex) -> bool {
+        let a = &self.a_types[f1];
+        let b = &self.b_types[f2];
+        a.async_ == b.async_
+            && a.param_names == b.param_names
+            && self.tuples_equal(a.params, b.params)
+            && self.tuples_equal(a.results, b.results)
+    }
+
     fn flags_equal(&self, f1: TypeFlagsIndex, f2: TypeFlagsIndex) -> bool {
         let a = &self.a_types[f1];
         let b = &self.b_types[f2];
@@ -896,6 +905,14 @@ impl Type {
 #[derive(Clone, Debug)]
 pub struct ComponentFunc(Handle<TypeFuncIndex>);
 
+impl PartialEq for ComponentFunc {
+    fn eq(&self, other: &Self) -> bool {
+        self.0.equivalent(&other.0, TypeChecker::funcs_equal)
+    }
+}
+
+impl Eq for ComponentFunc {}
+
 impl ComponentFunc {
     pub(crate) fn from(index: TypeFuncIndex, ty: &InstanceType<'_>) -> Self {
         Self(Handle::new(index, ty))
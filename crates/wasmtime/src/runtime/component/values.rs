@@ -909,8 +909,14 @@ impl GenericVariant<'_> {
     }
 }
 
-fn load_list(cx: &mut LiftContext<'_>, ty: TypeListIndex, ptr: usize, len: usize) -> Result<Val> {
-    let elem = cx.types[ty].element;
+/// Checks that the list at `ptr` with `len` elements of type `elem` is within
+/// bounds of memory and aligned, returning the size of each element.
+pub(crate) fn check_list(
+    cx: &LiftContext<'_>,
+    elem: InterfaceType,
+    ptr: usize,
+    len: usize,
+) -> Result<usize> {
     let abi = cx.types.canonical_abi(&elem);
     let element_size = usize::try_from(abi.size32).unwrap();
     let element_alignment = abi.align32;
@@ -925,6 +931,12 @@ fn load_list(cx: &mut LiftContext<'_>, ty: TypeListIndex, ptr: usize, len: usize
     if ptr % usize::try_from(element_alignment)? != 0 {
         bail!("list pointer is not aligned")
     }
+    Ok(element_size)
+}
+
+fn load_list(cx: &mut LiftContext<'_>, ty: TypeListIndex, ptr: usize, len: usize) -> Result<Val> {
+    let elem = cx.types[ty].element;
+    let element_size = check_list(cx, elem, ptr, len)?;
 
     Ok(Val::List(
         (0..len)
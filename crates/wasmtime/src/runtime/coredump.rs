@@ -4,6 +4,7 @@ use crate::{
     AsContextMut, FrameInfo, Global, HeapType, Instance, Memory, Module, StoreContextMut, Val,
     ValType, WasmBacktrace, store::StoreOpaque,
 };
+use core::ops::Range;
 use std::fmt;
 
 /// Representation of a core dump of a WebAssembly module
@@ -37,6 +38,28 @@ pub struct WasmCoreDump {
     backtrace: WasmBacktrace,
 }
 
+/// Which contents of linear memories are included when serializing a
+/// [`WasmCoreDump`] with [`WasmCoreDump::serialize_with`].
+///
+/// Memories are always declared with their current size, so the layout of
+/// the store is preserved either way. Serializing a large memory in full can
+/// be expensive, so these options allow limiting the dump to the parts that
+/// are interesting for a post-mortem.
+#[derive(Clone, Debug, Default)]
+pub enum CoreDumpMemory {
+    /// The full contents of all memories are included.
+    #[default]
+    All,
+    /// No memory contents are included, leaving only the stack, globals and
+    /// instances.
+    None,
+    /// Only the given byte ranges are included. Each range is paired with the
+    /// index of its memory in [`WasmCoreDump::memories`], which is also its
+    /// index in the serialized core dump. Ranges are clamped to the size of
+    /// their memory.
+    Ranges(Vec<(usize, Range<usize>)>),
+}
+
 impl WasmCoreDump {
     pub(crate) fn new(store: &mut StoreOpaque, backtrace: WasmBacktrace) -> WasmCoreDump {
         let modules: Vec<_> = store.modules().all_modules().cloned().collect();
@@ -99,12 +122,28 @@ impl WasmCoreDump {
     /// dumps.
     ///
     /// [spec]: https://github.com/WebAssembly/tool-conventions/blob/main/Coredump.md
-    pub fn serialize(&self, mut store: impl AsContextMut, name: &str) -> Vec<u8> {
+    pub fn serialize(&self, store: impl AsContextMut, name: &str) -> Vec<u8> {
+        self.serialize_with(store, name, &CoreDumpMemory::All)
+    }
+
+    /// Same as [`WasmCoreDump::serialize`], but only includes the contents of
+    /// linear memories selected by `memory`.
+    pub fn serialize_with(
+        &self,
+        mut store: impl AsContextMut,
+        name: &str,
+        memory: &CoreDumpMemory,
+    ) -> Vec<u8> {
         let store = store.as_context_mut();
-        self._serialize(store, name)
+        self._serialize(store, name, memory)
     }
 
-    fn _serialize<T: 'static>(&self, mut store: StoreContextMut<'_, T>, name: &str) -> Vec<u8> {
+    fn _serialize<T: 'static>(
+        &self,
+        mut store: StoreContextMut<'_, T>,
+        name: &str,
+        memory: &CoreDumpMemory,
+    ) -> Vec<u8> {
         let mut core_dump = wasm_encoder::Module::new();
 
         core_dump.section(&wasm_encoder::CoreDumpSection::new(name));
@@ -117,7 +156,7 @@ impl WasmCoreDump {
 
         {
             let mut memories = wasm_encoder::MemorySection::new();
-            for mem in self.memories() {
+            for (i, mem) in self.memories().iter().enumerate() {
                 let memory_idx = memories.len();
                 memory_to_idx.insert(mem.hash_key(&store.0), memory_idx);
                 let ty = mem.ty(&store);
@@ -140,18 +179,33 @@ impl WasmCoreDump {
                 // into reasonably-sized chunks and then trim runs of zeroes
                 // from the start and end of each chunk.
                 const CHUNK_SIZE: usize = 4096;
-                for (i, chunk) in mem.data(&store).chunks_exact(CHUNK_SIZE).enumerate() {
-                    if let Some(start) = chunk.iter().position(|byte| *byte != 0) {
-                        let end = chunk.iter().rposition(|byte| *byte != 0).unwrap() + 1;
-                        let offset = i * CHUNK_SIZE + start;
-                        let offset = if ty.is_64() {
-                            let offset = u64::try_from(offset).unwrap();
-                            wasm_encoder::ConstExpr::i64_const(offset as i64)
-                        } else {
-                            let offset = u32::try_from(offset).unwrap();
-                            wasm_encoder::ConstExpr::i32_const(offset as i32)
-                        };
-                        data.active(memory_idx, &offset, chunk[start..end].iter().copied());
+                let bytes = mem.data(&store);
+                let ranges = match memory {
+                    CoreDumpMemory::All => vec![0..bytes.len()],
+                    CoreDumpMemory::None => Vec::new(),
+                    CoreDumpMemory::Ranges(ranges) => ranges
+                        .iter()
+                        .filter(|(memory, _)| *memory == i)
+                        .map(|(_, range)| {
+                            let start = range.start.min(bytes.len());
+                            start..range.end.clamp(start, bytes.len())
+                        })
+                        .collect(),
+                };
+                for range in ranges {
+                    for (j, chunk) in bytes[range.clone()].chunks(CHUNK_SIZE).enumerate() {
+                        if let Some(start) = chunk.iter().position(|byte| *byte != 0) {
+                            let end = chunk.iter().rposition(|byte| *byte != 0).unwrap() + 1;
+                            let offset = range.start + j * CHUNK_SIZE + start;
+                            let offset = if ty.is_64() {
+                                let offset = u64::try_from(offset).unwrap();
+                                wasm_encoder::ConstExpr::i64_const(offset as i64)
+                            } else {
+                                let offset = u32::try_from(offset).unwrap();
+                                wasm_encoder::ConstExpr::i32_const(offset as i32)
+                            };
+                            data.active(memory_idx, &offset, chunk[start..end].iter().copied());
+                        }
                     }
                 }
             }
@@ -12,12 +12,24 @@ use crate::store::InstanceId;
 
 /// A WebAssembly `tag`.
 #[derive(Copy, Clone, Debug)]
-#[repr(C)] // here for the C API in the future
+#[repr(C)] // here for the C API
 pub struct Tag {
     instance: StoreInstanceId,
     index: DefinedTagIndex,
 }
 
+// Double-check that the C representation in `extern.h` matches our in-Rust
+// representation here in terms of size/alignment/etc.
+const _: () = {
+    #[repr(C)]
+    struct Tmp(u64, u32);
+    #[repr(C)]
+    struct C(Tmp, u32);
+    assert!(core::mem::size_of::<C>() == core::mem::size_of::<Tag>());
+    assert!(core::mem::align_of::<C>() == core::mem::align_of::<Tag>());
+    assert!(core::mem::offset_of!(Tag, instance) == 0);
+};
+
 impl Tag {
     pub(crate) fn from_raw(instance: StoreInstanceId, index: DefinedTagIndex) -> Tag {
         Tag { instance, index }
@@ -211,20 +211,30 @@ impl<'a, 'b> BlockingContext<'a, 'b> {
         let future_cx = unsafe { Some(state.current_future_cx.take().unwrap().as_mut()) };
         let suspend = unsafe { state.current_suspend.take().unwrap().as_mut() };
 
+        // WebAssembly blocking here, for example to yield at an epoch
+        // deadline, may be resumed on another thread, so its CPU time can't
+        // be measured across this.
+        let resume_guest_cpu_time = opaque.pause_guest_cpu_time();
+
         let mut reset = ResetBlockingContext {
             store,
             cx: BlockingContext { future_cx, suspend },
+            resume_guest_cpu_time,
         };
         return f(&mut reset.store, &mut reset.cx);
 
         struct ResetBlockingContext<'a, 'b, S: AsStoreOpaque> {
             store: &'a mut S,
             cx: BlockingContext<'a, 'b>,
+            resume_guest_cpu_time: bool,
         }
 
         impl<S: AsStoreOpaque> Drop for ResetBlockingContext<'_, '_, S> {
             fn drop(&mut self) {
                 let store = self.store.as_store_opaque();
+                if self.resume_guest_cpu_time {
+                    store.resume_guest_cpu_time();
+                }
                 let state = store.fiber_async_state_mut();
 
                 debug_assert!(state.current_future_cx.is_none());
@@ -706,6 +716,7 @@ fn resume_fiber<'a>(
     result: WasmtimeResume,
 ) -> Result<WasmtimeComplete, StoreFiberYield> {
     assert_eq!(store.id(), fiber.id);
+    store.restart_fuel_yield_slice();
 
     struct Restore<'a, 'b> {
         store: &'b mut StoreOpaque,
@@ -7,8 +7,8 @@ use crate::runtime::vm::{
 use crate::store::{Asyncness, AutoAssertNoGc, InstanceId, StoreId, StoreOpaque};
 use crate::type_registry::RegisteredType;
 use crate::{
-    AsContext, AsContextMut, CallHook, Engine, Extern, FuncType, Instance, ModuleExport, Ref,
-    StoreContext, StoreContextMut, Val, ValRaw, ValType,
+    AsContext, AsContextMut, CallHook, Engine, Extern, FuncType, Instance, Memory, ModuleExport,
+    Ref, StoreContext, StoreContextMut, Val, ValRaw, ValType,
 };
 use alloc::sync::Arc;
 use core::convert::Infallible;
@@ -17,7 +17,7 @@ use core::ffi::c_void;
 use core::future::Future;
 use core::mem::{self, MaybeUninit};
 use core::ptr::NonNull;
-use wasmtime_environ::VMSharedTypeIndex;
+use wasmtime_environ::{MemoryIndex, VMSharedTypeIndex};
 
 /// A reference to the abstract `nofunc` heap value.
 ///
@@ -828,6 +828,25 @@ impl Func {
         self.load_ty(&store.as_context().0)
     }
 
+    /// Returns an opaque identifier for this function's type.
+    ///
+    /// Two functions whose stores share the same [`Engine`] have the same
+    /// identifier if and only if their types are precisely equal, in the sense
+    /// of [`FuncType::eq`]. Unlike [`Func::ty`] this does not take any locks or
+    /// clone any types, so it's suitable for cheaply checking (or caching the
+    /// result of checking) the signature of many functions.
+    ///
+    /// Identifiers may be reused by the engine once a type is no longer
+    /// referenced by any store, module, or type, so they should not be retained
+    /// beyond the lifetime of this function's store.
+    ///
+    /// # Panics
+    ///
+    /// Panics if `store` does not own this function.
+    pub fn ty_index(&self, store: impl AsContext) -> u64 {
+        u64::from(self.type_index(&store.as_context().0).bits())
+    }
+
     /// Forcibly loads the type of this function from the `Engine`.
     ///
     /// Note that this is a somewhat expensive method since it requires taking a
@@ -1404,6 +1423,15 @@ pub(crate) fn invoke_wasm_and_catch_traps<T>(
     store: &mut StoreContextMut<'_, T>,
     closure: impl FnMut(NonNull<VMContext>, Option<InterpreterRef<'_>>) -> bool,
 ) -> Result<()> {
+    if store.0.is_hibernating() {
+        store.0.resume_from_hibernation()?;
+    }
+
+    // If the store was entered with `Store::enter` then it has already set
+    // the stack limit, which `enter_wasm` reuses, and the guards below.
+    #[cfg(feature = "std")]
+    let entered = store.0.check_entered()?;
+
     // The `enter_wasm` call below will reset the store context's
     // `stack_chain` to a new `InitialStack`, pointing to the
     // stack-allocated `initial_stack_csi`.
@@ -1413,12 +1441,32 @@ pub(crate) fn invoke_wasm_and_catch_traps<T>(
     // created by the `catch_traps` call below will store a pointer to this
     // stack-allocated `previous_runtime_state`.
     let mut previous_runtime_state = EntryStoreContext::enter_wasm(store, &mut initial_stack_csi);
+    // Keeps the engine's epoch ticker, if any, running while wasm executes.
+    #[cfg(all(feature = "std", target_has_atomic = "64"))]
+    let _ticking = if entered {
+        None
+    } else {
+        store.engine().enter_epoch_ticker()
+    };
+    // Lets interrupts be delivered to this thread while wasm executes. Fibers
+    // may be resumed on other threads, so code running on them is only
+    // interrupted at host calls.
+    #[cfg(all(feature = "std", unix, has_native_signals))]
+    let _interruptible = if entered || store.0.can_block() {
+        None
+    } else {
+        store.0.interrupt_state().map(|state| state.enter())
+    };
 
     if let Err(trap) = store.0.call_hook(CallHook::CallingWasm) {
         // `previous_runtime_state` implicitly dropped here
         return Err(trap);
     }
+    #[cfg(all(feature = "std", unix, has_native_signals))]
+    store.0.enter_cpu_accounting();
     let result = crate::runtime::vm::catch_traps(store, &mut previous_runtime_state, closure);
+    #[cfg(all(feature = "std", unix, has_native_signals))]
+    store.0.exit_cpu_accounting();
     #[cfg(feature = "component-model")]
     if result.is_err() {
         store.0.set_trapped();
@@ -2049,6 +2097,50 @@ impl<T> Caller<'_, T> {
         self.caller.get_module_export(&mut self.store, export)
     }
 
+    /// Looks up an exported [`Memory`] of the caller's module by its index in
+    /// the module's memory index space.
+    ///
+    /// This is similar to [`Self::get_export`] but avoids a string lookup,
+    /// see [`Instance::memory`] for more information.
+    ///
+    /// [`Instance::memory`]: crate::Instance::memory
+    pub fn memory(&mut self, index: u32) -> Option<Memory> {
+        self.caller.memory(&mut self.store, index)
+    }
+
+    /// Returns the contents of the caller's default memory, memory 0,
+    /// along with the data of the store.
+    ///
+    /// This is the same as looking the memory up with [`Self::memory`] and
+    /// calling [`Memory::data_and_store_mut`], but reads the memory's base
+    /// pointer and length directly from the calling instance instead of
+    /// creating and checking a [`Memory`], making it cheap enough to use on
+    /// every call of a host function which takes pointers into memory.
+    ///
+    /// The returned slice borrows this `Caller`, so it can't be used after
+    /// calling back into WebAssembly, which might grow the memory.
+    ///
+    /// Returns `None` if the caller's module doesn't export its memory 0, as
+    /// with [`Self::memory`], or if that memory is shared.
+    pub fn memory_and_data_mut(&mut self) -> Option<(&mut [u8], &mut T)> {
+        let index = MemoryIndex::from_u32(0);
+        let instance = self.store.0.instance(self.caller.id.instance());
+        let module = instance.runtime_module()?;
+        if !module.exports_memory(index) || module.env_module().memories[index].shared {
+            return None;
+        }
+        let definition = instance.get_memory(index);
+        // SAFETY: the memory isn't shared and belongs to the store, which is
+        // borrowed mutably along with `self` for as long as the slice is, so
+        // nothing else can access or resize it. The borrows of the memory
+        // and of the store's data don't overlap, as in
+        // `Memory::data_and_store_mut`.
+        let memory = unsafe {
+            core::slice::from_raw_parts_mut(definition.base.as_ptr(), definition.current_length())
+        };
+        Some((memory, self.store.data_mut()))
+    }
+
     /// Access the underlying data owned by this `Store`.
     ///
     /// Same as [`Store::data`](crate::Store::data)
@@ -2176,7 +2268,8 @@ struct HostFuncState<F> {
 
     // NB: We have to keep our `VMSharedTypeIndex` registered in the engine for
     // as long as this function exists.
-    _ty: RegisteredType,
+    #[cfg_attr(not(feature = "rr"), allow(dead_code))]
+    ty: RegisteredType,
 }
 
 impl core::fmt::Debug for HostFunc {
@@ -2225,7 +2318,7 @@ impl HostFunc {
                 ty.type_index(),
                 Box::new(HostFuncState {
                     func,
-                    _ty: ty.into_registered_type(),
+                    ty: ty.into_registered_type(),
                 }),
             )
         }
@@ -2336,13 +2429,23 @@ impl HostFunc {
                 // provided are valid to view as a slice.
                 let args = unsafe { args.as_mut() };
 
-                let ret = (state.func)(
-                    Caller {
-                        caller: Instance::from_wasmtime(instance, store.0),
-                        store: store.as_context_mut(),
-                    },
-                    args,
-                );
+                let call = |store: StoreContextMut<'_, T>, args: &mut [MaybeUninit<ValRaw>]| {
+                    let caller = Instance::from_wasmtime(instance, store.0);
+                    (state.func)(Caller { caller, store }, args)
+                };
+
+                // Host calls are recorded or replayed here so that both
+                // functions defined with `Func::new` and `Func::wrap` are
+                // covered.
+                #[cfg(feature = "rr")]
+                let ret = if store.0.has_host_call_log() {
+                    let results = state.ty.unwrap_func().returns();
+                    crate::store::rr::host_call(store.as_context_mut(), results, args, call)
+                } else {
+                    call(store.as_context_mut(), args)
+                };
+                #[cfg(not(feature = "rr"))]
+                let ret = call(store.as_context_mut(), args);
 
                 (gc_lifo_scope, ret)
             };
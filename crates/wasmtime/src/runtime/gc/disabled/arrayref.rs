@@ -1,6 +1,6 @@
 use crate::{
     ArrayType, AsContext, AsContextMut, GcRefImpl, Result, Val,
-    store::{StoreContextMut, StoreOpaque},
+    store::{StoreContext, StoreContextMut, StoreOpaque},
 };
 
 /// Support for `ArrayRefPre` disabled at compile time because the `gc` cargo
@@ -38,6 +38,17 @@ impl ArrayRef {
         Ok([].into_iter())
     }
 
+    pub fn data<'a, T: 'static>(&self, _store: impl Into<StoreContext<'a, T>>) -> Result<&'a [u8]> {
+        match *self {}
+    }
+
+    pub fn data_mut<'a, T: 'static>(
+        &self,
+        _store: impl Into<StoreContextMut<'a, T>>,
+    ) -> Result<&'a mut [u8]> {
+        match *self {}
+    }
+
     pub fn get(&self, _store: impl AsContextMut, _index: usize) -> Result<Val> {
         match *self {}
     }
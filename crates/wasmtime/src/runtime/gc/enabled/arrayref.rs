@@ -8,7 +8,7 @@ use crate::vm::{self, VMArrayRef, VMGcHeader};
 use crate::{AnyRef, FieldType};
 use crate::{
     ArrayType, AsContext, AsContextMut, EqRef, GcHeapOutOfMemory, GcRefImpl, GcRootIndex, HeapType,
-    OwnedRooted, RefType, Rooted, Val, ValRaw, ValType, WasmTy,
+    OwnedRooted, RefType, Rooted, StorageType, StoreContext, Val, ValRaw, ValType, WasmTy,
     prelude::*,
     store::{AutoAssertNoGc, StoreContextMut, StoreOpaque},
 };
@@ -698,6 +698,91 @@ impl ArrayRef {
         }
     }
 
+    /// Get this array's elements as a slice of bytes.
+    ///
+    /// This is only supported for arrays of numeric or vector elements, such as
+    /// `(array i8)` or `(array f64)`, whose elements are stored contiguously
+    /// in little-endian order. The returned slice is the array's length times
+    /// the size of its element type long.
+    ///
+    /// Note that this method will consider the entire store context provided
+    /// as borrowed for the duration of the lifetime of the returned slice,
+    /// since collecting garbage or growing the GC heap may move it.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if this array's elements are references, or if this
+    /// reference has been unrooted.
+    ///
+    /// # Panics
+    ///
+    /// Panics if this reference is associated with a different store.
+    pub fn data<'a, T: 'static>(&self, store: impl Into<StoreContext<'a, T>>) -> Result<&'a [u8]> {
+        let store = store.into().0;
+        let (offset, len) = self.data_range(store, false)?;
+        let gc_ref = self.inner.try_gc_ref(store)?;
+        Ok(store
+            .require_gc_store()?
+            .gc_heap
+            .gc_object_data(gc_ref)
+            .slice(offset, len))
+    }
+
+    /// Get this array's elements as a mutable slice of bytes.
+    ///
+    /// This is the same as [`ArrayRef::data`], except that it also requires
+    /// the array's elements to be mutable.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if this array's elements are references or aren't
+    /// mutable, or if this reference has been unrooted.
+    ///
+    /// # Panics
+    ///
+    /// Panics if this reference is associated with a different store.
+    pub fn data_mut<'a, T: 'static>(
+        &self,
+        store: impl Into<StoreContextMut<'a, T>>,
+    ) -> Result<&'a mut [u8]> {
+        let store = store.into().0;
+        let (offset, len) = self.data_range(store, true)?;
+        let gc_ref = self.inner.try_gc_ref(store)?.unchecked_copy();
+        Ok(store
+            .require_gc_store_mut()?
+            .gc_object_data(&gc_ref)
+            .slice_mut(offset, len))
+    }
+
+    /// Returns the offset and size, in bytes, of this array's elements within
+    /// its object, for the element types supported by `data`, and if `mutable`
+    /// is set only if the elements are mutable.
+    fn data_range(&self, store: &StoreOpaque, mutable: bool) -> Result<(u32, u32)> {
+        assert!(
+            self.comes_from_same_store(store),
+            "attempted to use an array with the wrong store",
+        );
+        let field_ty = self.field_ty(store)?;
+        ensure!(
+            !matches!(
+                field_ty.element_type(),
+                StorageType::ValType(ValType::Ref(_))
+            ),
+            "cannot access array data: array elements are references"
+        );
+        ensure!(
+            !mutable || field_ty.mutability().is_var(),
+            "cannot mutate array data: array elements are not mutable"
+        );
+        let type_index = self.type_index(store)?;
+        let layout = match store.engine().signatures().layout(type_index) {
+            Some(GcLayout::Array(a)) => a,
+            _ => unreachable!("array types should have array GC layouts"),
+        };
+        let len = self._len(store)?;
+        Ok((layout.base_size, len * layout.elem_size))
+    }
+
     fn header<'a>(&self, store: &'a AutoAssertNoGc<'_>) -> Result<&'a VMGcHeader> {
         assert!(self.comes_from_same_store(&store));
         let gc_ref = self.inner.try_gc_ref(store)?;
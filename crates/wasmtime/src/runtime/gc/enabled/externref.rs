@@ -322,9 +322,9 @@ impl ExternRef {
     where
         T: 'static + Any + Send + Sync,
     {
-        // Allocate the box once, regardless how many gc-and-retry attempts we
-        // make.
-        let value: Box<dyn Any + Send + Sync> = Box::new(value);
+        // Create the host data once, regardless how many gc-and-retry
+        // attempts we make.
+        let value = vm::ExternRefHostData::new(value);
 
         let gc_ref = store
             .retry_after_gc_async(limiter, value, asyncness, |store, value| {
@@ -335,11 +335,11 @@ impl ExternRef {
                     .map_err(|(x, n)| GcHeapOutOfMemory::new(x, n).into())
             })
             .await
-            // Translate the `GcHeapOutOfMemory`'s inner value from the boxed
-            // trait object into `T`.
+            // Translate the `GcHeapOutOfMemory`'s inner value from the host
+            // data into `T`.
             .map_err(
-                |e| match e.downcast::<GcHeapOutOfMemory<Box<dyn Any + Send + Sync>>>() {
-                    Ok(oom) => oom.map_inner(|x| *x.downcast::<T>().unwrap()).into(),
+                |e| match e.downcast::<GcHeapOutOfMemory<vm::ExternRefHostData>>() {
+                    Ok(oom) => oom.map_inner(|x| x.downcast::<T>().unwrap()).into(),
                     Err(e) => e,
                 },
             )?;
@@ -218,6 +218,23 @@ impl I31 {
     pub fn get_i32(&self) -> i32 {
         self.0.get_i32()
     }
+
+    /// Returns the raw `anyref` representation of this `I31`, the same as
+    /// [`AnyRef::to_raw`](crate::AnyRef::to_raw) returns for it but without
+    /// needing to root it first.
+    #[doc(hidden)]
+    #[inline]
+    pub fn to_raw_for_c_api(self) -> u32 {
+        VMGcRef::from_i31(self.into()).as_raw_u32()
+    }
+
+    /// The inverse of [`I31::to_raw_for_c_api`], returning `None` if `raw`
+    /// isn't an `i31ref`.
+    #[doc(hidden)]
+    #[inline]
+    pub fn from_raw_for_c_api(raw: u32) -> Option<I31> {
+        VMGcRef::from_raw_u32(raw)?.as_i31().map(I31)
+    }
 }
 
 unsafe impl WasmTy for I31 {
@@ -1277,6 +1277,27 @@ impl<T: GcRef> Rooted<T> {
         let gc_ref = store.clone_gc_ref(&gc_ref);
         Some(from_cloned_gc_ref(store, gc_ref))
     }
+
+    #[doc(hidden)]
+    pub fn into_parts_for_c_api(self) -> (NonZeroU64, u32, u32) {
+        (
+            self.inner.store_id.as_raw(),
+            self.inner.generation,
+            self.inner.index.0,
+        )
+    }
+
+    #[doc(hidden)]
+    pub fn from_raw_parts_for_c_api(a: NonZeroU64, b: u32, c: u32) -> Rooted<T> {
+        Rooted {
+            inner: GcRootIndex {
+                store_id: StoreId::from_raw(a),
+                generation: b,
+                index: PackedIndex(c),
+            },
+            _phantom: marker::PhantomData,
+        }
+    }
 }
 
 /// Nested rooting scopes.
@@ -1414,6 +1435,20 @@ where
         RootScope { store, scope }
     }
 
+    /// Enters a rooting scope which spans calls through the C API, returning
+    /// the token to later pass to [`RootScope::exit_for_c_api`].
+    #[doc(hidden)]
+    pub fn enter_for_c_api(store: &mut C) -> usize {
+        store.as_context().0.gc_roots().enter_lifo_scope()
+    }
+
+    /// Exits a rooting scope entered with [`RootScope::enter_for_c_api`],
+    /// unrooting everything rooted since.
+    #[doc(hidden)]
+    pub fn exit_for_c_api(store: &mut C, scope: usize) {
+        store.as_context_mut().0.exit_gc_lifo_scope(scope);
+    }
+
     fn gc_roots(&mut self) -> &mut RootSet {
         self.store.as_context_mut().0.gc_roots_mut()
     }
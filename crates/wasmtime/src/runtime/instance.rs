@@ -1,25 +1,43 @@
 use crate::linker::{Definition, DefinitionType};
 use crate::prelude::*;
 use crate::runtime::vm::{
-    self, Imports, ModuleRuntimeInfo, VMFuncRef, VMFunctionImport, VMGlobalImport, VMMemoryImport,
-    VMStore, VMTableImport, VMTagImport,
+    self, Imports, ModuleMemoryImages, ModuleRuntimeInfo, VMFuncRef, VMFunctionImport,
+    VMGlobalImport, VMMemoryImport, VMStore, VMTableImport, VMTagImport,
 };
 use crate::store::{
-    AllocateInstanceKind, Asyncness, InstanceId, StoreInstanceId, StoreOpaque, StoreResourceLimiter,
+    AllocateInstanceKind, Asyncness, AutoAssertNoGc, InstanceId, StoreInstanceId, StoreOpaque,
+    StoreResourceLimiter,
 };
 use crate::types::matching;
 use crate::{
-    AsContextMut, Engine, Export, Extern, Func, Global, Memory, Module, ModuleExport, SharedMemory,
-    StoreContext, StoreContextMut, Table, Tag, TypedFunc,
+    AsContext, AsContextMut, Engine, Export, Extern, Func, Global, Memory, Module, ModuleExport,
+    RuntimeEventKind, SharedMemory, StoreContext, StoreContextMut, Table, Tag, TypedFunc,
 };
 use alloc::sync::Arc;
 use core::ptr::NonNull;
 use wasmparser::WasmFeatures;
 use wasmtime_environ::{
-    EntityIndex, EntityType, FuncIndex, GlobalIndex, MemoryIndex, PrimaryMap, TableIndex, TagIndex,
-    TypeTrace,
+    DefinedFuncIndex, EntityIndex, EntityRef, EntityType, FuncIndex, GlobalIndex, MemoryIndex,
+    PrimaryMap, TableIndex, TagIndex, TypeTrace,
 };
 
+mod pool;
+mod snapshot;
+pub use self::pool::{InstancePool, PooledInstance, ResetPolicy};
+pub use self::snapshot::InstanceSnapshot;
+
+/// The number of calls made to a function of an [`Instance`], as returned by
+/// [`Instance::function_stats`].
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+pub struct FunctionStats<'a> {
+    /// The index of the function in its module's function index space.
+    pub index: u32,
+    /// The name of the function from the module's name section, if any.
+    pub name: Option<&'a str>,
+    /// The number of times the function has been called.
+    pub calls: u64,
+}
+
 /// An instantiated WebAssembly module.
 ///
 /// This type represents the instantiation of a [`Module`]. Once instantiated
@@ -215,6 +233,14 @@ impl Instance {
             let item = DefinitionType::from(store, item);
             cx.definition(ty, &item)
         })?;
+        check_specialized_globals(
+            store,
+            module,
+            imports.iter().filter_map(|import| match import {
+                Extern::Global(g) => Some(g),
+                _ => None,
+            }),
+        )?;
 
         // When pushing functions into `OwnedImports` it's required that their
         // `wasm_call` fields are all filled out. This `module` is guaranteed
@@ -245,11 +271,14 @@ impl Instance {
         imports: Imports<'_>,
         asyncness: Asyncness,
     ) -> Result<Instance> {
+        let event = store.0.engine().start_event();
         let (instance, start) = {
             let (mut limiter, store) = store.0.resource_limiter_and_store_opaque();
             // SAFETY: the safety contract of `new_raw` is the same as this
             // function.
-            unsafe { Instance::new_raw(store, limiter.as_mut(), module, imports, asyncness).await? }
+            unsafe {
+                Instance::new_raw(store, limiter.as_mut(), module, imports, None, asyncness).await?
+            }
         };
         if let Some(start) = start {
             if asyncness == Asyncness::No {
@@ -265,6 +294,10 @@ impl Instance {
                 unreachable!();
             }
         }
+        store
+            .0
+            .engine()
+            .finish_event(event, |duration| RuntimeEventKind::Instantiate { duration });
         Ok(instance)
     }
 
@@ -278,6 +311,9 @@ impl Instance {
     /// though it doesn't do any blocking work because an async resource
     /// limiter may need to yield.
     ///
+    /// If `memory_images` is provided then memories are initialized with them
+    /// instead of with the module's own images.
+    ///
     /// # Unsafety
     ///
     /// This method is unsafe because it does not type-check the `imports`
@@ -288,11 +324,13 @@ impl Instance {
         mut limiter: Option<&mut StoreResourceLimiter<'_>>,
         module: &Module,
         imports: Imports<'_>,
+        memory_images: Option<&ModuleMemoryImages>,
         asyncness: Asyncness,
     ) -> Result<(Instance, Option<FuncIndex>)> {
         if !Engine::same(store.engine(), module.engine()) {
             bail!("cross-`Engine` instantiation is not currently supported");
         }
+
         store.bump_resource_counts(module)?;
 
         // Allocate the GC heap, if necessary.
@@ -300,23 +338,48 @@ impl Instance {
             store.ensure_gc_store(limiter.as_deref_mut()).await?;
         }
 
-        let compiled_module = module.compiled_module();
-
         // Register the module just before instantiation to ensure we keep the module
         // properly referenced while in use by the store.
         let module_id = store.register_module(module)?;
 
+        // New instances of a module compiled with tiering run the optimized
+        // tier's code once it's ready. Its imports are identical to the
+        // baseline's, so the already-typechecked `imports` remain valid. The
+        // instance is still recorded as an instance of `module` itself, so
+        // `Instance::module` and `ModuleExport`s of `module` keep working; the
+        // optimized tier is only registered so that its code can be found
+        // when it traps or is unwound.
+        #[cfg(feature = "cranelift")]
+        let optimized = module.optimized_tier();
+        #[cfg(feature = "cranelift")]
+        let module = match &optimized {
+            Some(optimized) => {
+                store.register_module(optimized)?;
+                optimized
+            }
+            None => module,
+        };
+
+        let compiled_module = module.compiled_module();
+
         // The first thing we do is issue an instance allocation request
         // to the instance allocator. This, on success, will give us an
         // instance handle.
         //
         // SAFETY: this module, by construction, was already validated within
         // the store.
+        let kind = match memory_images {
+            Some(memory_images) => AllocateInstanceKind::Snapshot {
+                module_id,
+                memory_images,
+            },
+            None => AllocateInstanceKind::Module(module_id),
+        };
         let id = unsafe {
             store
                 .allocate_instance(
                     limiter.as_deref_mut(),
-                    AllocateInstanceKind::Module(module_id),
+                    kind,
                     &ModuleRuntimeInfo::Module(module.clone()),
                     imports,
                 )
@@ -402,6 +465,53 @@ impl Instance {
         store.module_for_instance(self.id).unwrap()
     }
 
+    /// Returns the number of times each function defined by this instance's
+    /// module has been called.
+    ///
+    /// This requires [`Config::count_function_calls`] to have been enabled
+    /// when the module was compiled, and otherwise returns nothing.
+    ///
+    /// # Panics
+    ///
+    /// Panics if `store` does not own this instance.
+    ///
+    /// [`Config::count_function_calls`]: crate::Config::count_function_calls
+    pub fn function_stats<'a, T: 'static>(
+        &self,
+        store: impl Into<StoreContext<'a, T>>,
+    ) -> impl ExactSizeIterator<Item = FunctionStats<'a>> + 'a {
+        let store = store.into().0;
+        let compiled = self._module(store).compiled_module();
+        store[self.id]
+            .call_counts()
+            .enumerate()
+            .map(move |(i, calls)| {
+                let index = compiled.module().func_index(DefinedFuncIndex::new(i));
+                FunctionStats {
+                    index: index.as_u32(),
+                    name: compiled.func_name(index),
+                    calls,
+                }
+            })
+    }
+
+    /// Returns the number of elements of the funcref tables defined by this
+    /// instance which have been initialized lazily so far, each of which took
+    /// a call from compiled code into the runtime.
+    ///
+    /// See [`Config::table_lazy_init`] and
+    /// [`Config::table_eager_init_threshold`].
+    ///
+    /// # Panics
+    ///
+    /// Panics if `store` does not own this instance.
+    ///
+    /// [`Config::table_lazy_init`]: crate::Config::table_lazy_init
+    /// [`Config::table_eager_init_threshold`]: crate::Config::table_eager_init_threshold
+    pub fn lazy_table_inits(&self, store: impl AsContext) -> u64 {
+        store.as_context().0[self.id].lazy_table_inits()
+    }
+
     /// Returns the list of exported items from this [`Instance`].
     ///
     /// # Panics
@@ -558,6 +668,31 @@ impl Instance {
         self.get_export(store, name)?.into_memory()
     }
 
+    /// Looks up an exported [`Memory`] value by its index in the module's
+    /// memory index space, which includes imported memories.
+    ///
+    /// This is like [`Instance::get_memory`] but avoids looking up the export
+    /// by name, which is useful for host functions that access a memory other
+    /// than the first of a module using the multi-memory proposal on every
+    /// call. The memory must still be exported by the module though, whatever
+    /// name it's exported under.
+    ///
+    /// Returns `None` if there is no memory at `index`, if it isn't exported,
+    /// or if it's a shared memory.
+    ///
+    /// # Panics
+    ///
+    /// Panics if `store` does not own this instance.
+    pub fn memory(&self, mut store: impl AsContextMut, index: u32) -> Option<Memory> {
+        let store = store.as_context_mut().0;
+        let index = MemoryIndex::from_u32(index);
+        if !self._module(store).exports_memory(index) {
+            return None;
+        }
+        self._get_export(store, EntityIndex::Memory(index))
+            .into_memory()
+    }
+
     /// Looks up an exported [`SharedMemory`] value by name.
     ///
     /// Returns `None` if there was no export named `name`, or if there was but
@@ -932,6 +1067,63 @@ impl<T: 'static> InstancePre<T> {
             Instance::new_started(&mut store, &self.module, imports.as_ref(), Asyncness::Yes).await
         }
     }
+
+    /// Creates a new instance within `store` which starts out in the state
+    /// captured by `snapshot`, instead of being initialized by the module.
+    ///
+    /// The new instance's memories, mutable globals, and tables are restored
+    /// from `snapshot` and the module's start function isn't run, so any
+    /// initialization performed before the snapshot was taken needn't be
+    /// repeated. Where the snapshot's memories have copy-on-write images they
+    /// are mapped into the new instance without being copied. The imports of
+    /// the new instance are those of this [`InstancePre`], see
+    /// [`InstanceSnapshot`] for what is and isn't captured in a snapshot.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `snapshot` was taken from an instance of a
+    /// different module, or in any of the situations that
+    /// [`InstancePre::instantiate`] returns an error other than the start
+    /// function trapping.
+    ///
+    /// # Panics
+    ///
+    /// Panics in the same situations as [`InstancePre::instantiate`].
+    pub fn instantiate_from_snapshot(
+        &self,
+        mut store: impl AsContextMut<Data = T>,
+        snapshot: &InstanceSnapshot,
+    ) -> Result<Instance> {
+        let mut store = store.as_context_mut();
+        snapshot.check_module(&self.module)?;
+        let imports = pre_instantiate_raw(
+            &mut store.0,
+            &self.module,
+            &self.items,
+            self.host_funcs,
+            &self.func_refs,
+            self.asyncness,
+        )?;
+        store.0.validate_sync_call()?;
+
+        let (instance, _start) = {
+            let (mut limiter, store) = store.0.resource_limiter_and_store_opaque();
+            // SAFETY: the imports were type-checked when this `InstancePre`
+            // was created, as in `instantiate`.
+            vm::assert_ready(unsafe {
+                Instance::new_raw(
+                    store,
+                    limiter.as_mut(),
+                    &self.module,
+                    imports.as_ref(),
+                    snapshot.memory_images(),
+                    Asyncness::No,
+                )
+            })?
+        };
+        snapshot.restore(&mut store, instance)?;
+        Ok(instance)
+    }
 }
 
 /// Helper function shared between
@@ -969,6 +1161,15 @@ fn pre_instantiate_raw(
         funcrefs.push_instance_pre_func_refs(func_refs.clone());
     }
 
+    check_specialized_globals(
+        store,
+        module,
+        items.iter().filter_map(|item| match item {
+            Definition::Extern(Extern::Global(g), _) => Some(g),
+            _ => None,
+        }),
+    )?;
+
     store.set_async_required(asyncness);
 
     let mut func_refs = func_refs.iter().map(|f| NonNull::from(f));
@@ -1001,6 +1202,37 @@ fn pre_instantiate_raw(
     Ok(imports)
 }
 
+/// Checks that the imported `globals` of `module`, in order, have the values
+/// which its code was specialized for, if any, see
+/// [`Linker::instantiate_pre_specialized`](crate::Linker::instantiate_pre_specialized).
+fn check_specialized_globals<'a>(
+    store: &mut StoreOpaque,
+    module: &Module,
+    globals: impl Iterator<Item = &'a Global>,
+) -> Result<()> {
+    let env_module = module.compiled_module().module();
+    if env_module.specialized_globals.is_empty() {
+        return Ok(());
+    }
+    let mut store = AutoAssertNoGc::new(store);
+    for (i, global) in globals.enumerate() {
+        let Some(expected) = env_module.specialized_globals.get(&GlobalIndex::new(i)) else {
+            continue;
+        };
+        if global._get(&mut store).const_op().as_ref() != expected.ops().first() {
+            let (name, field, _) = env_module
+                .imports()
+                .filter(|(_, _, ty)| matches!(ty, EntityType::Global(_)))
+                .nth(i)
+                .unwrap();
+            bail!(
+                "global import `{name}::{field}` doesn't have the value that the module was specialized for"
+            );
+        }
+    }
+    Ok(())
+}
+
 fn typecheck<I>(
     module: &Module,
     import_args: &[I],
@@ -0,0 +1,335 @@
+//! Pools of ready-to-run instances, see `InstancePool`.
+
+use crate::prelude::*;
+use crate::{AsContextMut, Extern, Global, Instance, InstancePre, Memory, Mutability, Store, Val};
+use core::cell::UnsafeCell;
+use core::mem;
+use core::sync::atomic::{AtomicU8, AtomicUsize, Ordering};
+use wasmtime_environ::EntityIndex;
+
+/// How the instances of an [`InstancePool`] are reset after they're used.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum ResetPolicy {
+    /// The store that an instance was used in is dropped, and the instance is
+    /// replaced with a new one in a new store.
+    ///
+    /// This restores all of the instance's state, including that of its
+    /// store, and works with any module. When the
+    /// [pooling allocator](crate::PoolingAllocationConfig) is used the slot
+    /// of the dropped instance is typically reused for its replacement, in
+    /// which case its memories are reset as configured by
+    /// [`linear_memory_keep_resident`](crate::PoolingAllocationConfig::linear_memory_keep_resident).
+    Reinstantiate,
+
+    /// The instance is kept in the same store, and only the parts of it
+    /// which are usually changed by a request are reset: the written pages
+    /// of its memories are restored to their copy-on-write image with
+    /// [`Memory::reset_dirty_to_image`], and its mutable globals which hold
+    /// numbers are set back to the values they had after instantiation.
+    ///
+    /// This is much cheaper than [`ResetPolicy::Reinstantiate`], but tables,
+    /// the sizes of memories, and the state of the store itself, such as its
+    /// fuel and its data, aren't reset. It's only suitable for modules which
+    /// don't otherwise keep state between requests, and an instance that
+    /// trapped should be discarded with [`PooledInstance::discard`] instead
+    /// of being reused.
+    ResetMemories,
+}
+
+/// A fixed-size pool of instances of the same module, each in its own
+/// [`Store`], which are instantiated ahead of time and reset between uses.
+///
+/// Even with an [`InstancePre`] creating an instance still allocates and
+/// initializes its state, maps its memories, and runs its start function. An
+/// `InstancePool` does all of that before an instance is needed, so serving a
+/// request with an instance taken from the pool with
+/// [`InstancePool::checkout`] doesn't involve any instantiation. Once the
+/// request is done the instance is reset according to the pool's
+/// [`ResetPolicy`] and made available again by
+/// [`PooledInstance::release`], or when the [`PooledInstance`] is dropped.
+///
+/// Taking instances from the pool and returning them doesn't take any locks,
+/// so a pool can be shared by many threads serving requests at once.
+///
+/// Instances are created with [`InstancePre::instantiate`], so the engine
+/// must not have async support enabled.
+pub struct InstancePool<T: 'static> {
+    pre: InstancePre<T>,
+    data: Box<dyn Fn() -> T + Send + Sync>,
+    reset: ResetPolicy,
+    slots: Box<[Slot<T>]>,
+    /// Where the next search for an available slot starts, to spread
+    /// concurrent searches over the pool.
+    next: AtomicUsize,
+}
+
+/// The slot has no instance, for example because resetting its last one
+/// failed.
+const EMPTY: u8 = 0;
+/// The slot has an instance which is ready to be used.
+const READY: u8 = 1;
+/// The slot is owned by a `PooledInstance`.
+const BUSY: u8 = 2;
+
+struct Slot<T: 'static> {
+    state: AtomicU8,
+    /// Only accessed by whoever moved `state` to `BUSY`.
+    entry: UnsafeCell<Option<Entry<T>>>,
+}
+
+struct Entry<T: 'static> {
+    store: Store<T>,
+    instance: Instance,
+    /// The instance's defined memories, which are reset with
+    /// `ResetPolicy::ResetMemories`.
+    memories: Vec<Memory>,
+    /// The instance's defined mutable globals and their values after
+    /// instantiation, which are restored with `ResetPolicy::ResetMemories`.
+    globals: Vec<(Global, Val)>,
+}
+
+// SAFETY: the entry of each slot is only accessed by the single owner of the
+// slot, as arbitrated by its atomic state, so sharing the pool only ever moves
+// stores between threads.
+unsafe impl<T: Send + 'static> Sync for InstancePool<T> {}
+
+impl<T: 'static> InstancePool<T> {
+    /// Creates a pool of `size` instances created by `pre`, each in a new
+    /// store whose data is created by `data`.
+    ///
+    /// All of the instances are created before this returns.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if any instance fails to be created, or if `reset`
+    /// is [`ResetPolicy::ResetMemories`] and the module defines a shared
+    /// memory, which can't be reset.
+    ///
+    /// # Panics
+    ///
+    /// Panics in the same situations as [`InstancePre::instantiate`].
+    pub fn new(
+        pre: InstancePre<T>,
+        size: usize,
+        reset: ResetPolicy,
+        data: impl Fn() -> T + Send + Sync + 'static,
+    ) -> Result<InstancePool<T>> {
+        let pool = InstancePool {
+            pre,
+            data: Box::new(data),
+            reset,
+            slots: (0..size)
+                .map(|_| Slot {
+                    state: AtomicU8::new(EMPTY),
+                    entry: UnsafeCell::new(None),
+                })
+                .collect(),
+            next: AtomicUsize::new(0),
+        };
+        for slot in pool.slots.iter() {
+            // SAFETY: the pool isn't shared yet.
+            unsafe {
+                *slot.entry.get() = Some(pool.instantiate()?);
+            }
+            slot.state.store(READY, Ordering::Release);
+        }
+        Ok(pool)
+    }
+
+    /// Returns the number of instances in this pool, including those in use.
+    pub fn size(&self) -> usize {
+        self.slots.len()
+    }
+
+    /// Returns the reset policy of this pool.
+    pub fn reset_policy(&self) -> ResetPolicy {
+        self.reset
+    }
+
+    /// Takes a ready-to-run instance out of this pool.
+    ///
+    /// Returns `Ok(None)` if all of the pool's instances are in use. If an
+    /// instance previously failed to be reset then a new instance is created
+    /// in its place here, and an error is returned if that fails.
+    pub fn checkout(&self) -> Result<Option<PooledInstance<'_, T>>> {
+        let n = self.slots.len();
+        let start = self.next.fetch_add(1, Ordering::Relaxed);
+        for i in 0..n {
+            let index = start.wrapping_add(i) % n;
+            if self.claim(index, READY) {
+                return Ok(Some(PooledInstance { pool: self, index }));
+            }
+        }
+        for i in 0..n {
+            let index = start.wrapping_add(i) % n;
+            if self.claim(index, EMPTY) {
+                let slot = &self.slots[index];
+                match self.instantiate() {
+                    Ok(entry) => {
+                        // SAFETY: this slot was just claimed.
+                        unsafe { *slot.entry.get() = Some(entry) };
+                        return Ok(Some(PooledInstance { pool: self, index }));
+                    }
+                    Err(e) => {
+                        slot.state.store(EMPTY, Ordering::Release);
+                        return Err(e);
+                    }
+                }
+            }
+        }
+        Ok(None)
+    }
+
+    fn claim(&self, index: usize, state: u8) -> bool {
+        self.slots[index]
+            .state
+            .compare_exchange(state, BUSY, Ordering::Acquire, Ordering::Relaxed)
+            .is_ok()
+    }
+
+    fn instantiate(&self) -> Result<Entry<T>> {
+        let mut store = Store::new(self.pre.module().engine(), (self.data)());
+        let instance = self.pre.instantiate(&mut store)?;
+
+        let env = self.pre.module().env_module();
+        let mut memories = Vec::new();
+        let mut globals = Vec::new();
+        if self.reset == ResetPolicy::ResetMemories {
+            let mut cx = store.as_context_mut();
+            for index in env.memories.keys().skip(env.num_imported_memories) {
+                match instance._get_export(cx.0, EntityIndex::Memory(index)) {
+                    Extern::Memory(memory) => memories.push(memory),
+                    _ => bail!("cannot reset an instance which defines a shared memory"),
+                }
+            }
+            for index in env.globals.keys().skip(env.num_imported_globals) {
+                let global = match instance._get_export(cx.0, EntityIndex::Global(index)) {
+                    Extern::Global(global) => global,
+                    _ => unreachable!(),
+                };
+                if global.ty(&cx).mutability() != Mutability::Var {
+                    continue;
+                }
+                let value = global.get(&mut cx);
+                if value.ref_().is_none() {
+                    globals.push((global, value));
+                }
+            }
+        }
+
+        Ok(Entry {
+            store,
+            instance,
+            memories,
+            globals,
+        })
+    }
+}
+
+/// An instance taken out of an [`InstancePool`] with
+/// [`InstancePool::checkout`].
+///
+/// The instance is reset and returned to its pool with
+/// [`PooledInstance::release`], or when this is dropped.
+pub struct PooledInstance<'a, T: 'static> {
+    pool: &'a InstancePool<T>,
+    index: usize,
+}
+
+impl<T: 'static> PooledInstance<'_, T> {
+    fn entry(&self) -> &Entry<T> {
+        // SAFETY: this owns the slot, and the slot's entry is always filled
+        // while it's owned by a `PooledInstance`.
+        unsafe { (*self.pool.slots[self.index].entry.get()).as_ref().unwrap() }
+    }
+
+    fn entry_mut(&mut self) -> &mut Entry<T> {
+        // SAFETY: see `entry`.
+        unsafe { (*self.pool.slots[self.index].entry.get()).as_mut().unwrap() }
+    }
+
+    /// Returns the instance.
+    pub fn instance(&self) -> Instance {
+        self.entry().instance
+    }
+
+    /// Returns the store that the instance lives in.
+    pub fn store(&self) -> &Store<T> {
+        &self.entry().store
+    }
+
+    /// Returns the store that the instance lives in.
+    pub fn store_mut(&mut self) -> &mut Store<T> {
+        &mut self.entry_mut().store
+    }
+
+    /// Resets this instance and returns it to its pool.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the instance couldn't be reset, in which case it's
+    /// dropped and a new instance is created in its place the next time that
+    /// the pool runs out of ready instances.
+    pub fn release(self) -> Result<()> {
+        let mut this = mem::ManuallyDrop::new(self);
+        this.reset()
+    }
+
+    /// Drops this instance and its store without returning it to its pool,
+    /// for example because it trapped and its state can't be trusted.
+    ///
+    /// A new instance is created in its place the next time that the pool
+    /// runs out of ready instances.
+    pub fn discard(self) {
+        let this = mem::ManuallyDrop::new(self);
+        this.give_back(false);
+    }
+
+    fn reset(&mut self) -> Result<()> {
+        let result = match self.pool.reset {
+            ResetPolicy::Reinstantiate => {
+                // Drop the old store first so that its resources, such as a
+                // pooling allocator slot, can be reused by its replacement.
+                let entry = self.pool.slots[self.index].entry.get();
+                // SAFETY: this owns the slot.
+                unsafe { *entry = None };
+                self.pool
+                    .instantiate()
+                    .map(|new| unsafe { *entry = Some(new) })
+            }
+            ResetPolicy::ResetMemories => {
+                let entry = self.entry_mut();
+                (|| {
+                    for memory in &entry.memories {
+                        memory.reset_dirty_to_image(&mut entry.store)?;
+                    }
+                    for (global, value) in &entry.globals {
+                        global.set(&mut entry.store, value.clone())?;
+                    }
+                    Ok(())
+                })()
+            }
+        };
+        self.give_back(result.is_ok());
+        result
+    }
+
+    /// Gives this instance's slot back to the pool, either with its instance
+    /// ready to be used again or, if `ready` is false, without an instance.
+    fn give_back(&self, ready: bool) {
+        let slot = &self.pool.slots[self.index];
+        if !ready {
+            // SAFETY: this owns the slot until its state is changed below.
+            unsafe { *slot.entry.get() = None };
+        }
+        let state = if ready { READY } else { EMPTY };
+        slot.state.store(state, Ordering::Release);
+    }
+}
+
+impl<T: 'static> Drop for PooledInstance<'_, T> {
+    fn drop(&mut self) {
+        // Errors are reflected by the slot being left empty, see `release`.
+        let _ = self.reset();
+    }
+}
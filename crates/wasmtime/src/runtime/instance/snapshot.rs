@@ -0,0 +1,373 @@
+//! Snapshots of the state of an instance, see `InstanceSnapshot`.
+
+use crate::prelude::*;
+use crate::runtime::vm::{MmapVec, ModuleMemoryImageSource, ModuleMemoryImages};
+use crate::store::StoreOpaque;
+use crate::{
+    AsContextMut, Extern, Func, Instance, Module, Ref, StoreContextMut, V128, Val, ValType,
+};
+use alloc::collections::BTreeMap;
+use alloc::sync::Arc;
+use core::fmt;
+use wasmtime_environ::{
+    DefinedGlobalIndex, DefinedMemoryIndex, DefinedTableIndex, EntityIndex, FuncIndex, PrimaryMap,
+};
+
+/// A snapshot of the state of an [`Instance`], from which new instances of
+/// the same module can be created.
+///
+/// Snapshots are taken with [`Instance::snapshot`], typically once an
+/// instance has finished expensive initialization such as starting up a
+/// language runtime, and new instances are then created from them with
+/// [`InstancePre::instantiate_from_snapshot`](crate::InstancePre::instantiate_from_snapshot)
+/// without repeating that work. Where the platform supports it the contents
+/// of memories are captured in copy-on-write images, like those created for
+/// a module's data segments, so that creating an instance from a snapshot
+/// doesn't copy its memory.
+///
+/// A snapshot captures:
+///
+/// * The contents and sizes of the instance's defined memories.
+/// * The values of the instance's defined mutable globals. Immutable globals
+///   are initialized by the module as usual.
+/// * The sizes and elements of the instance's defined tables.
+///
+/// Snapshots can only be taken of instances whose globals and tables contain
+/// nothing but numbers, null references, and references to functions of the
+/// instance itself, and which don't define shared memories. Imported items
+/// aren't part of a snapshot, and the state of passive data and element
+/// segments, and of any GC heap objects, isn't captured either.
+///
+/// Snapshots aren't tied to the store of the instance they were taken from,
+/// and may be used to create instances in any store of the same engine.
+pub struct InstanceSnapshot {
+    module: Module,
+    memories: PrimaryMap<DefinedMemoryIndex, MemorySnapshot>,
+    images: Option<ModuleMemoryImages>,
+    globals: Vec<(DefinedGlobalIndex, Value)>,
+    tables: PrimaryMap<DefinedTableIndex, Vec<Option<FuncIndex>>>,
+}
+
+/// The contents of one memory within an `InstanceSnapshot`.
+struct MemorySnapshot {
+    /// The byte size of the memory.
+    size: usize,
+    /// The offset in the memory that `contents` start at. All bytes outside
+    /// of `contents` are zero.
+    offset: usize,
+    contents: Arc<MemoryContents>,
+    /// How many bytes at the start of `contents` are covered by this memory's
+    /// image, if it has one.
+    mapped: usize,
+}
+
+struct MemoryContents(Vec<u8>);
+
+impl ModuleMemoryImageSource for MemoryContents {
+    fn wasm_data(&self) -> &[u8] {
+        &self.0
+    }
+
+    fn mmap(&self) -> Option<&MmapVec> {
+        None
+    }
+}
+
+/// The value of a global within an `InstanceSnapshot`.
+enum Value {
+    I32(i32),
+    I64(i64),
+    F32(u32),
+    F64(u64),
+    V128(V128),
+    Null,
+    Func(FuncIndex),
+}
+
+impl Instance {
+    /// Takes a snapshot of the current state of this instance, from which new
+    /// instances of its module can be created with
+    /// [`InstancePre::instantiate_from_snapshot`](crate::InstancePre::instantiate_from_snapshot).
+    ///
+    /// See [`InstanceSnapshot`] for what's captured. Taking a snapshot copies
+    /// the non-zero parts of this instance's memories, so it's relatively
+    /// expensive, but instantiating from it afterwards is cheap.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if this instance defines a shared memory, or if any
+    /// of its globals or tables contain a reference which isn't null or to a
+    /// function of this instance.
+    ///
+    /// # Panics
+    ///
+    /// Panics if `store` doesn't own this instance.
+    pub fn snapshot(&self, mut store: impl AsContextMut) -> Result<InstanceSnapshot> {
+        let mut store = store.as_context_mut();
+        let module = self._module(store.0).clone();
+        let env = module.env_module().clone();
+
+        // Functions in tables and globals are recorded by their index within
+        // the module, so record the index of every function which may be
+        // referenced.
+        let mut funcs = BTreeMap::new();
+        for (index, func) in env.functions.iter() {
+            if func.is_escaping() {
+                let func = self.get_func_by_index(store.0, index);
+                funcs.insert(func.vm_func_ref(store.0).as_ptr().addr(), index);
+            }
+        }
+
+        let mut memories = PrimaryMap::new();
+        for (index, ty) in env.memories.iter().skip(env.num_imported_memories) {
+            let memory = match self._get_export(store.0, EntityIndex::Memory(index)) {
+                Extern::Memory(memory) => memory,
+                _ => bail!("cannot snapshot an instance which defines a shared memory"),
+            };
+            let initial = ty.minimum_byte_size().map_or(usize::MAX, |size| {
+                usize::try_from(size).unwrap_or(usize::MAX)
+            });
+            memories.push(MemorySnapshot::new(memory.data(&store), initial));
+        }
+
+        #[cfg(has_virtual_memory)]
+        let images = if store.engine().tunables().memory_init_cow {
+            let snapshots = memories
+                .values()
+                .map(|memory| (memory.contents.clone(), memory.offset, memory.mapped));
+            Some(ModuleMemoryImages::from_snapshots(
+                store.engine(),
+                snapshots,
+            )?)
+        } else {
+            None
+        };
+        #[cfg(not(has_virtual_memory))]
+        let images = None;
+
+        let mut globals = Vec::new();
+        for (index, ty) in env.globals.iter().skip(env.num_imported_globals) {
+            if !ty.mutability {
+                continue;
+            }
+            let global = match self._get_export(store.0, EntityIndex::Global(index)) {
+                Extern::Global(global) => global,
+                _ => unreachable!(),
+            };
+            let value = match global.get(&mut store) {
+                Val::I32(i) => Value::I32(i),
+                Val::I64(i) => Value::I64(i),
+                Val::F32(f) => Value::F32(f),
+                Val::F64(f) => Value::F64(f),
+                Val::V128(v) => Value::V128(v),
+                val => match func_index(&funcs, store.0, val.ref_().unwrap())? {
+                    Some(func) => Value::Func(func),
+                    None => Value::Null,
+                },
+            };
+            globals.push((env.defined_global_index(index).unwrap(), value));
+        }
+
+        let mut tables = PrimaryMap::new();
+        for index in env.tables.keys().skip(env.num_imported_tables) {
+            let table = match self._get_export(store.0, EntityIndex::Table(index)) {
+                Extern::Table(table) => table,
+                _ => unreachable!(),
+            };
+            let mut elements = Vec::new();
+            for i in 0..table.size(&store) {
+                let element = table.get(&mut store, i).unwrap();
+                elements.push(func_index(&funcs, store.0, element)?);
+            }
+            tables.push(elements);
+        }
+
+        Ok(InstanceSnapshot {
+            module,
+            memories,
+            images,
+            globals,
+            tables,
+        })
+    }
+
+    fn get_func_by_index(&self, store: &mut StoreOpaque, index: FuncIndex) -> Func {
+        match self._get_export(store, EntityIndex::Function(index)) {
+            Extern::Func(func) => func,
+            _ => unreachable!(),
+        }
+    }
+}
+
+/// Returns the granularity that memory contents are captured at.
+fn page_size() -> usize {
+    #[cfg(has_virtual_memory)]
+    return crate::runtime::vm::host_page_size();
+    #[cfg(not(has_virtual_memory))]
+    return 1 << 16;
+}
+
+/// Returns the index of the function referenced by `r`, or `None` if `r` is
+/// null, given the indices of all functions keyed by their `VMFuncRef`s.
+fn func_index(
+    funcs: &BTreeMap<usize, FuncIndex>,
+    store: &StoreOpaque,
+    r: Ref,
+) -> Result<Option<FuncIndex>> {
+    match r {
+        Ref::Func(Some(func)) => match funcs.get(&func.vm_func_ref(store).as_ptr().addr()) {
+            Some(index) => Ok(Some(*index)),
+            None => bail!("cannot snapshot a reference to a function of another instance"),
+        },
+        r if r.is_null() => Ok(None),
+        _ => bail!("cannot snapshot a non-null reference which isn't to a function"),
+    }
+}
+
+impl MemorySnapshot {
+    /// Captures the contents of a memory, `data`, whose initial size is
+    /// `initial` bytes.
+    fn new(data: &[u8], initial: usize) -> MemorySnapshot {
+        let page_size = page_size();
+        // Only the pages between the first and last non-zero ones are saved.
+        let nonzero = |page: &[u8]| page.iter().any(|b| *b != 0);
+        let (offset, end) = match data.chunks(page_size).position(nonzero) {
+            Some(first) => {
+                let last = data.chunks(page_size).rposition(nonzero).unwrap();
+                (first * page_size, ((last + 1) * page_size).min(data.len()))
+            }
+            None => (0, 0),
+        };
+
+        // Images may only cover the initial size of memory, and must be a
+        // whole number of pages.
+        let mapped = end.min(initial & !(page_size - 1)).saturating_sub(offset) & !(page_size - 1);
+
+        MemorySnapshot {
+            size: data.len(),
+            offset,
+            contents: Arc::new(MemoryContents(data[offset..end].to_vec())),
+            mapped,
+        }
+    }
+}
+
+impl InstanceSnapshot {
+    /// Returns the module of the instance that this snapshot was taken from.
+    pub fn module(&self) -> &Module {
+        &self.module
+    }
+
+    pub(super) fn check_module(&self, module: &Module) -> Result<()> {
+        ensure!(
+            Module::same(&self.module, module),
+            "snapshot was taken from an instance of a different module"
+        );
+        Ok(())
+    }
+
+    pub(super) fn memory_images(&self) -> Option<&ModuleMemoryImages> {
+        self.images.as_ref()
+    }
+
+    /// Restores the state in this snapshot into `instance`, which has just
+    /// been created with this snapshot's memory images.
+    pub(super) fn restore<T: 'static>(
+        &self,
+        store: &mut StoreContextMut<'_, T>,
+        instance: Instance,
+    ) -> Result<()> {
+        let env = self.module.env_module();
+
+        for (index, snapshot) in self.memories.iter() {
+            let entity = EntityIndex::Memory(env.memory_index(index));
+            let memory = match instance._get_export(store.0, entity) {
+                Extern::Memory(memory) => memory,
+                _ => unreachable!(),
+            };
+            let size = memory.data_size(&*store);
+            if snapshot.size > size {
+                let page_size = usize::try_from(memory.page_size(&*store)).unwrap();
+                let delta = u64::try_from((snapshot.size - size) / page_size).unwrap();
+                memory.grow(&mut *store, delta)?;
+            }
+
+            // If this memory's image was mapped then everything but the
+            // contents beyond it are already in place. Otherwise the memory
+            // may have been initialized by the module, so clear any pages
+            // which aren't zero before copying in all of the contents.
+            let mapped = self
+                .images
+                .as_ref()
+                .is_some_and(|images| images.get_memory_image(index).is_some())
+                && !store.0[instance.id].get_defined_memory(index).needs_init();
+            let data = memory.data_mut(&mut *store);
+            let start = if mapped {
+                snapshot.offset + snapshot.mapped
+            } else {
+                for page in data.chunks_mut(page_size()) {
+                    if page.iter().any(|b| *b != 0) {
+                        page.fill(0);
+                    }
+                }
+                snapshot.offset
+            };
+            let contents = &snapshot.contents.0[start - snapshot.offset..];
+            data[start..][..contents.len()].copy_from_slice(contents);
+        }
+
+        for (index, value) in self.globals.iter() {
+            let entity = EntityIndex::Global(env.global_index(*index));
+            let global = match instance._get_export(store.0, entity) {
+                Extern::Global(global) => global,
+                _ => unreachable!(),
+            };
+            let val = match value {
+                Value::I32(i) => Val::I32(*i),
+                Value::I64(i) => Val::I64(*i),
+                Value::F32(f) => Val::F32(*f),
+                Value::F64(f) => Val::F64(*f),
+                Value::V128(v) => Val::V128(*v),
+                Value::Func(func) => Val::FuncRef(Some(instance.get_func_by_index(store.0, *func))),
+                Value::Null => match global.ty(&*store).content() {
+                    ValType::Ref(ty) => Val::null_ref(ty.heap_type()),
+                    _ => unreachable!(),
+                },
+            };
+            global.set(&mut *store, val)?;
+        }
+
+        for (index, elements) in self.tables.iter() {
+            let entity = EntityIndex::Table(env.table_index(index));
+            let table = match instance._get_export(store.0, entity) {
+                Extern::Table(table) => table,
+                _ => unreachable!(),
+            };
+            let null = Ref::null(table.ty(&*store).element().heap_type());
+            let size = table.size(&*store);
+            let len = u64::try_from(elements.len()).unwrap();
+            if len > size {
+                table.grow(&mut *store, len - size, null.clone())?;
+            }
+            for (i, element) in (0..).zip(elements) {
+                let element = match element {
+                    Some(func) => Ref::Func(Some(instance.get_func_by_index(store.0, *func))),
+                    None => null.clone(),
+                };
+                table.set(&mut *store, i, element)?;
+            }
+        }
+
+        Ok(())
+    }
+}
+
+impl fmt::Debug for InstanceSnapshot {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("InstanceSnapshot")
+            .field("memories", &self.memories.len())
+            .field("globals", &self.globals.len())
+            .field("tables", &self.tables.len())
+            .finish_non_exhaustive()
+    }
+}
@@ -5,9 +5,10 @@
 
 use crate::code::EngineCode;
 use crate::prelude::*;
-use crate::profiling_agent::ProfilingAgent;
+use crate::profiling_agent::{ProfilingAgent, SourceLine};
 use crate::runtime::vm::CompiledModuleId;
 use alloc::sync::Arc;
+use core::cell::OnceCell;
 use core::ops::Range;
 use core::str;
 use wasmtime_environ::{
@@ -69,17 +70,86 @@ impl CompiledModule {
         // TODO-Bug?: "code_memory" is not exclusive for this module in the case of components,
         // so we may be registering the same code range multiple times here.
 
-        profiler.register_module(self.engine_code.image(), &|addr| {
-            let idx = self.func_by_text_offset(addr)?;
-            let idx = self.module.func_index(idx);
-            let name = self.func_name(idx)?;
-            let mut demangled = String::new();
-            wasmtime_environ::demangle_function_name(&mut demangled, name).unwrap();
-            Some(demangled)
-        });
+        // Source lines are only looked up if the profiler asks for them, and
+        // then once for the whole text section.
+        let lines = OnceCell::new();
+        profiler.register_module(
+            self.engine_code.image(),
+            &|addr| {
+                let idx = self.func_by_text_offset(addr)?;
+                let idx = self.module.func_index(idx);
+                let name = self.func_name(idx)?;
+                let mut demangled = String::new();
+                wasmtime_environ::demangle_function_name(&mut demangled, name).unwrap();
+                Some(demangled)
+            },
+            &|text| {
+                let lines = lines.get_or_init(|| self.source_lines());
+                let start = lines.partition_point(|l| l.offset < text.start);
+                let end = lines.partition_point(|l| l.offset < text.end);
+                let mut ret = Vec::<SourceLine>::new();
+                for l in &lines[start..end] {
+                    if ret
+                        .last()
+                        .is_some_and(|prev| prev.line == l.line && prev.file == l.file)
+                    {
+                        continue;
+                    }
+                    ret.push(SourceLine {
+                        offset: l.offset - text.start,
+                        file: l.file.clone(),
+                        line: l.line,
+                    });
+                }
+                ret
+            },
+        );
         Ok(())
     }
 
+    /// Returns the source lines, according to the module's DWARF, of the code
+    /// in the text section, sorted by their text section offset.
+    ///
+    /// Where wasm instructions were inlined from other source functions the
+    /// innermost location is used. Nothing is returned if the module has no
+    /// debug information or no address map.
+    #[cfg(feature = "addr2line")]
+    fn source_lines(&self) -> Vec<SourceLine> {
+        let mut ret = Vec::new();
+        let Some(cx) = self.symbolize_context().ok().flatten() else {
+            return ret;
+        };
+        let Some(map) = wasmtime_environ::iterate_address_map(self.engine_code.address_map_data())
+        else {
+            return ret;
+        };
+        for (offset, pos) in map {
+            let Some(pos) = pos.file_offset() else {
+                continue;
+            };
+            let Ok(Some(location)) = cx
+                .addr2line()
+                .find_location(u64::from(pos) - cx.code_section_offset())
+            else {
+                continue;
+            };
+            let (Some(file), Some(line)) = (location.file, location.line) else {
+                continue;
+            };
+            ret.push(SourceLine {
+                offset: usize::try_from(offset).unwrap(),
+                file: file.to_string(),
+                line,
+            });
+        }
+        ret
+    }
+
+    #[cfg(not(feature = "addr2line"))]
+    fn source_lines(&self) -> Vec<SourceLine> {
+        Vec::new()
+    }
+
     /// Get this module's unique ID. It is unique with respect to a
     /// single allocator (which is ordinarily held on a Wasm engine).
     pub fn unique_id(&self) -> CompiledModuleId {
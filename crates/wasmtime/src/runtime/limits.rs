@@ -7,6 +7,22 @@ pub const DEFAULT_TABLE_LIMIT: usize = 10000;
 /// Value returned by [`ResourceLimiter::memories`] default method
 pub const DEFAULT_MEMORY_LIMIT: usize = 10000;
 
+/// Counts of resources created within a [`Store`](crate::Store), as returned by
+/// [`Store::resource_counts`](crate::Store::resource_counts).
+///
+/// These are the same counts that are checked against
+/// [`ResourceLimiter::instances`], [`ResourceLimiter::memories`] and
+/// [`ResourceLimiter::tables`] when instantiating.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct ResourceCounts {
+    /// The number of instances created within the store.
+    pub instances: usize,
+    /// The number of linear memories defined by instances within the store.
+    pub memories: usize,
+    /// The number of tables defined by instances within the store.
+    pub tables: usize,
+}
+
 /// Used by hosts to limit resource consumption of instances.
 ///
 /// This trait is used in conjunction with the
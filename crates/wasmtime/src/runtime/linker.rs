@@ -1,7 +1,9 @@
 use crate::func::HostFunc;
 use crate::hash_map::{Entry, HashMap};
 use crate::instance::InstancePre;
+use crate::runtime::vm::CompiledModuleId;
 use crate::store::StoreOpaque;
+use crate::sync::RwLock;
 use crate::{
     AsContext, AsContextMut, Caller, Engine, Extern, ExternType, Func, FuncType, ImportType,
     Instance, Module, Result, StoreContextMut, Val, ValRaw,
@@ -88,9 +90,20 @@ pub struct Linker<T> {
     map: HashMap<ImportKey, Definition>,
     allow_shadowing: bool,
     allow_unknown_exports: bool,
+    /// Imports of modules previously instantiated with this linker, keyed by
+    /// module, so instantiating the same module again doesn't need to look up
+    /// each of its imports by name.
+    ///
+    /// This is cleared whenever an item is defined in this linker, and is
+    /// bounded by `MAX_RESOLVED_IMPORTS` as entries for modules which have
+    /// since been dropped are never otherwise removed.
+    resolved_imports: RwLock<HashMap<CompiledModuleId, Arc<[Definition]>>>,
     _marker: marker::PhantomData<fn() -> T>,
 }
 
+/// The maximum number of modules whose imports are cached by a `Linker`.
+const MAX_RESOLVED_IMPORTS: usize = 64;
+
 impl<T> Debug for Linker<T> {
     fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
         f.debug_struct("Linker").finish_non_exhaustive()
@@ -106,6 +119,7 @@ impl<T> Clone for Linker<T> {
             map: self.map.clone(),
             allow_shadowing: self.allow_shadowing,
             allow_unknown_exports: self.allow_unknown_exports,
+            resolved_imports: Default::default(),
             _marker: self._marker,
         }
     }
@@ -154,6 +168,7 @@ impl<T> Linker<T> {
             strings: Vec::new(),
             allow_shadowing: false,
             allow_unknown_exports: false,
+            resolved_imports: Default::default(),
             _marker: marker::PhantomData,
         }
     }
@@ -780,6 +795,7 @@ impl<T> Linker<T> {
                     store,
                     module_name,
                     module,
+                    "command",
                     |store, func_ty, export_name, instance_pre| {
                         Func::new(
                             store,
@@ -844,6 +860,7 @@ impl<T> Linker<T> {
                 store,
                 module_name,
                 module,
+                "command",
                 |store, func_ty, export_name, instance_pre| {
                     let upvars = Arc::new((instance_pre, export_name));
                     Func::new_async(
@@ -887,11 +904,218 @@ impl<T> Linker<T> {
         }
     }
 
+    /// Define a [`Module`] in this linker which is only instantiated once one
+    /// of its exports is first called.
+    ///
+    /// This is the same as [`Linker::module`], except that Reactors aren't
+    /// instantiated, and their initialization function isn't called, until
+    /// one of the functions they export is called. Libraries which are
+    /// registered in every [`Store`](crate::Store) but only used by some of
+    /// the modules instantiated in them then don't cost anything in the
+    /// stores which don't use them. Commands are already instantiated on each
+    /// call, so they're defined the same way as with [`Linker::module`].
+    ///
+    /// Each export of a Reactor is defined as a host function which
+    /// instantiates the module the first time any of them is called, and then
+    /// calls the corresponding export of that one instance. This adds the
+    /// cost of a host call to each call, so libraries which are used by
+    /// every store, or which are called often, are better registered with
+    /// [`Linker::module`].
+    ///
+    /// Only functions can be defined lazily, so a Reactor's other exports
+    /// aren't defined. Like with Commands, an error is returned if it exports
+    /// anything else other than its memory and a few items exported by some
+    /// toolchains, unless [`Linker::allow_unknown_exports`] is enabled.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if any item is redefined twice in this linker and
+    /// shadowing is disallowed, if `module` has an export that can't be
+    /// defined lazily, or if any of its imports can't be resolved. Errors
+    /// from instantiating `module` or calling its initialization function are
+    /// returned by the call to the export which instantiated it, and the next
+    /// call tries again.
+    ///
+    /// # Panics
+    ///
+    /// Panics if the `store` provided comes from a different [`Engine`] than
+    /// this [`Linker`].
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// # use wasmtime::*;
+    /// # fn main() -> Result<()> {
+    /// # let engine = Engine::default();
+    /// # let mut store = Store::new(&engine, ());
+    /// let mut linker = Linker::new(&engine);
+    ///
+    /// // `lib` isn't instantiated here...
+    /// let wat = r#"(module (func (export "answer") (result i32) i32.const 42))"#;
+    /// let lib = Module::new(&engine, wat)?;
+    /// linker.module_lazy(&mut store, "lib", &lib)?;
+    ///
+    /// let wat = r#"
+    ///     (module
+    ///         (import "lib" "answer" (func $answer (result i32)))
+    ///         (func (export "run") (result i32)
+    ///             call $answer
+    ///         )
+    ///     )
+    /// "#;
+    /// let module = Module::new(&engine, wat)?;
+    /// let instance = linker.instantiate(&mut store, &module)?;
+    ///
+    /// // ... but only once `run` calls `lib::answer`.
+    /// let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+    /// assert_eq!(run.call(&mut store, ())?, 42);
+    /// # Ok(())
+    /// # }
+    /// ```
+    pub fn module_lazy(
+        &mut self,
+        mut store: impl AsContextMut<Data = T>,
+        module_name: &str,
+        module: &Module,
+    ) -> Result<&mut Self>
+    where
+        T: 'static,
+    {
+        // NB: this is intended to function the same as
+        // `Linker::module_lazy_async`, they should be kept in sync.
+        assert!(
+            Engine::same(&self.engine, store.as_context().engine()),
+            "different engines for this linker and the store provided"
+        );
+        if let ModuleKind::Command = ModuleKind::categorize(module)? {
+            return self.module(store, module_name, module);
+        }
+
+        // The functions defined below are owned by `store`, so this is the
+        // instance of `module` in `store`, once one of them has created it.
+        let instance = Arc::new(RwLock::new(None::<Instance>));
+        self.command(
+            store,
+            module_name,
+            module,
+            "lazily-instantiated",
+            |store, func_ty, export_name, instance_pre| {
+                let instance = instance.clone();
+                Func::new(
+                    store,
+                    func_ty.clone(),
+                    move |mut caller, params, results| {
+                        let existing = *instance.read();
+                        let lazy = match existing {
+                            Some(lazy) => lazy,
+                            None => {
+                                let lazy = instance_pre.instantiate(&mut caller)?;
+                                if let Some(Extern::Func(func)) =
+                                    lazy.get_export(&mut caller, "_initialize")
+                                {
+                                    func.typed::<(), ()>(&caller)
+                                        .and_then(|f| f.call(&mut caller, ()))
+                                        .context("calling the Reactor initialization function")?;
+                                }
+                                *instance.write() = Some(lazy);
+                                lazy
+                            }
+                        };
+
+                        // `unwrap()` is fine for the same reason as for
+                        // Commands in `Linker::module`.
+                        lazy.get_export(&mut caller, &export_name)
+                            .unwrap()
+                            .into_func()
+                            .unwrap()
+                            .call(&mut caller, params, results)
+                    },
+                )
+            },
+        )
+    }
+
+    /// Define a [`Module`] in this linker which is only instantiated once one
+    /// of its exports is first called.
+    ///
+    /// This is the same as [`Linker::module_lazy`], except for async `Store`s.
+    #[cfg(feature = "async")]
+    pub async fn module_lazy_async(
+        &mut self,
+        mut store: impl AsContextMut<Data = T>,
+        module_name: &str,
+        module: &Module,
+    ) -> Result<&mut Self>
+    where
+        T: Send + 'static,
+    {
+        // NB: this is intended to function the same as `Linker::module_lazy`,
+        // they should be kept in sync.
+        assert!(
+            Engine::same(&self.engine, store.as_context().engine()),
+            "different engines for this linker and the store provided"
+        );
+        if let ModuleKind::Command = ModuleKind::categorize(module)? {
+            return self.module_async(store, module_name, module).await;
+        }
+
+        let instance = Arc::new(RwLock::new(None::<Instance>));
+        self.command(
+            store,
+            module_name,
+            module,
+            "lazily-instantiated",
+            |store, func_ty, export_name, instance_pre| {
+                let upvars = Arc::new((instance.clone(), instance_pre, export_name));
+                Func::new_async(
+                    store,
+                    func_ty.clone(),
+                    move |mut caller, params, results| {
+                        let upvars = upvars.clone();
+                        Box::new(async move {
+                            let (instance, instance_pre, export_name) = &*upvars;
+                            let existing = *instance.read();
+                            let lazy = match existing {
+                                Some(lazy) => lazy,
+                                None => {
+                                    let lazy = instance_pre.instantiate_async(&mut caller).await?;
+                                    if let Some(Extern::Func(func)) =
+                                        lazy.get_export(&mut caller, "_initialize")
+                                    {
+                                        let func = func.typed::<(), ()>(&caller).context(
+                                            "loading the Reactor initialization function",
+                                        )?;
+                                        func.call_async(&mut caller, ()).await.context(
+                                            "calling the Reactor initialization function",
+                                        )?;
+                                    }
+                                    *instance.write() = Some(lazy);
+                                    lazy
+                                }
+                            };
+
+                            lazy.get_export(&mut caller, &export_name)
+                                .unwrap()
+                                .into_func()
+                                .unwrap()
+                                .call_async(&mut caller, params, results)
+                                .await
+                        })
+                    },
+                )
+            },
+        )
+    }
+
+    /// Defines each function export of `module` as the `Func` returned by
+    /// `mk_func`, for modules described as `kind` in errors and warnings which
+    /// are instantiated by those functions rather than up front.
     fn command(
         &mut self,
         mut store: impl AsContextMut<Data = T>,
         module_name: &str,
         module: &Module,
+        kind: &str,
         mk_func: impl Fn(&mut StoreContextMut<T>, &FuncType, String, InstancePre<T>) -> Func,
     ) -> Result<&mut Self>
     where
@@ -916,25 +1140,25 @@ impl<T> Linker<T> {
                 // Allow an exported "__data_end" memory for compatibility with toolchains
                 // which use --export-dynamic, which unfortunately doesn't work the way
                 // we want it to.
-                warn!("command module exporting '__data_end' is deprecated");
+                warn!("{kind} module exporting '__data_end' is deprecated");
             } else if export.name() == "__heap_base" && export.ty().global().is_some() {
                 // Allow an exported "__data_end" memory for compatibility with toolchains
                 // which use --export-dynamic, which unfortunately doesn't work the way
                 // we want it to.
-                warn!("command module exporting '__heap_base' is deprecated");
+                warn!("{kind} module exporting '__heap_base' is deprecated");
             } else if export.name() == "__dso_handle" && export.ty().global().is_some() {
                 // Allow an exported "__dso_handle" memory for compatibility with toolchains
                 // which use --export-dynamic, which unfortunately doesn't work the way
                 // we want it to.
-                warn!("command module exporting '__dso_handle' is deprecated")
+                warn!("{kind} module exporting '__dso_handle' is deprecated")
             } else if export.name() == "__rtti_base" && export.ty().global().is_some() {
                 // Allow an exported "__rtti_base" memory for compatibility with
                 // AssemblyScript.
                 warn!(
-                    "command module exporting '__rtti_base' is deprecated; pass `--runtime half` to the AssemblyScript compiler"
+                    "{kind} module exporting '__rtti_base' is deprecated; pass `--runtime half` to the AssemblyScript compiler"
                 );
             } else if !self.allow_unknown_exports {
-                bail!("command export '{}' is not a function", export.name());
+                bail!("{kind} export '{}' is not a function", export.name());
             }
         }
 
@@ -997,6 +1221,7 @@ impl<T> Linker<T> {
     }
 
     fn insert(&mut self, key: ImportKey, item: Definition) -> Result<()> {
+        self.resolved_imports.write().clear();
         match self.map.entry(key) {
             Entry::Occupied(_) if !self.allow_shadowing => {
                 let module = &self.strings[key.module];
@@ -1168,6 +1393,119 @@ impl<T> Linker<T> {
         self._instantiate_pre(module, None)
     }
 
+    /// Compiles `wasm` specialized for the values of the immutable globals
+    /// that it imports from this linker, and then performs the same checks as
+    /// [`Linker::instantiate_pre`] for it.
+    ///
+    /// All instances of a [`Module`] share its compiled code, so reading an
+    /// imported global loads its value from the instance, even if the global
+    /// is immutable and always has the same value, such as a configuration
+    /// flag. This method instead compiles a variant of the module where each
+    /// immutable `i32`, `i64`, `f32`, `f64` or `v128` global that it imports
+    /// from this linker is replaced with the global's current value in
+    /// `store`. The compiler can then constant-fold the code which depends on
+    /// these globals, for example removing checks of features which are
+    /// disabled.
+    ///
+    /// The [`Engine`] caches the specialized modules it compiles for as long
+    /// as they're in use, so pre-instantiating the same `wasm` again with the
+    /// same values reuses the compiled module. With
+    /// [`Config::cache`](crate::Config::cache) the compiled modules are also
+    /// cached on disk, keyed by the values they were specialized for.
+    ///
+    /// Instantiating the returned [`InstancePre`] fails unless the globals
+    /// that it's instantiated with have the values it was specialized for,
+    /// for example if it's instantiated in a store where this linker's
+    /// globals are different.
+    ///
+    /// The `wasm` may be in the text format if the `wat` feature is enabled.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `wasm` fails to compile, or for the same reasons as
+    /// [`Linker::instantiate_pre`].
+    ///
+    /// # Panics
+    ///
+    /// Panics if any global used to specialize `wasm` is not owned by
+    /// `store`.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// # use wasmtime::*;
+    /// # fn main() -> Result<()> {
+    /// # let engine = Engine::default();
+    /// let mut store = Store::new(&engine, ());
+    /// let mut linker = Linker::new(&engine);
+    /// let ty = GlobalType::new(ValType::I32, Mutability::Const);
+    /// let feature = Global::new(&mut store, ty, Val::I32(0))?;
+    /// linker.define(&store, "config", "feature", feature)?;
+    ///
+    /// let wat = r#"
+    ///     (module
+    ///         (import "config" "feature" (global $feature i32))
+    ///         (func (export "run") (result i32)
+    ///             (if (result i32) (global.get $feature)
+    ///                 (then (i32.const 1))
+    ///                 (else (i32.const 2))))
+    ///     )
+    /// "#;
+    /// let pre = linker.instantiate_pre_specialized(&mut store, wat.as_bytes())?;
+    /// let instance = pre.instantiate(&mut store)?;
+    /// let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+    /// assert_eq!(run.call(&mut store, ())?, 2);
+    /// # Ok(())
+    /// # }
+    /// ```
+    #[cfg(any(feature = "cranelift", feature = "winch"))]
+    pub fn instantiate_pre_specialized(
+        &self,
+        mut store: impl AsContextMut<Data = T>,
+        wasm: &[u8],
+    ) -> Result<InstancePre<T>>
+    where
+        T: 'static,
+    {
+        #[cfg(feature = "wat")]
+        let wasm = wat::parse_bytes(wasm)?;
+        let wasm: &[u8] = &wasm;
+
+        let mut store = store.as_context_mut();
+        let mut globals = Vec::new();
+        for payload in wasmparser::Parser::new(0).parse_all(wasm) {
+            let wasmparser::Payload::ImportSection(imports) = payload? else {
+                continue;
+            };
+            for import in imports.into_imports() {
+                let import = import?;
+                let wasmparser::TypeRef::Global(ty) = import.ty else {
+                    continue;
+                };
+                if ty.mutable {
+                    continue;
+                }
+                let Some(Extern::Global(global)) = self.get(&mut store, import.module, import.name)
+                else {
+                    continue;
+                };
+                if global.ty(&store).mutability().is_var() {
+                    continue;
+                }
+                if let Some(value) = global.get(&mut store).const_op() {
+                    globals.push((import.module.to_string(), import.name.to_string(), value));
+                }
+            }
+            break;
+        }
+
+        let module =
+            self.engine
+                .specialized_modules()
+                .get_or_compile(&self.engine, wasm, globals)?;
+        self._instantiate_pre(&module, Some(store.0))
+    }
+
     /// This is split out to optionally take a `store` so that when the
     /// `.instantiate` API is used we can get fresh up-to-date type information
     /// for memories and their current size, if necessary.
@@ -1187,10 +1525,23 @@ impl<T> Linker<T> {
     where
         T: 'static,
     {
-        let mut imports = module
-            .imports()
-            .map(|import| self._get_by_import(&import))
-            .collect::<Result<Vec<_>, _>>()?;
+        let cached = self.resolved_imports.read().get(&module.id()).cloned();
+        let resolved = match cached {
+            Some(imports) => imports,
+            None => {
+                let imports = module
+                    .imports()
+                    .map(|import| self._get_by_import(&import))
+                    .collect::<Result<Arc<[_]>, _>>()?;
+                let mut cache = self.resolved_imports.write();
+                if cache.len() >= MAX_RESOLVED_IMPORTS {
+                    cache.clear();
+                }
+                cache.insert(module.id(), imports.clone());
+                imports
+            }
+        };
+        let mut imports = resolved.to_vec();
         if let Some(store) = store {
             for import in imports.iter_mut() {
                 import.update_size(store);
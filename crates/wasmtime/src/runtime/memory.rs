@@ -5,14 +5,18 @@ use crate::store::{StoreInstanceId, StoreOpaque, StoreResourceLimiter};
 use crate::trampoline::generate_memory_export;
 #[cfg(feature = "async")]
 use crate::vm::VMStore;
-use crate::{AsContext, AsContextMut, Engine, MemoryType, StoreContext, StoreContextMut};
+use crate::{
+    AsContext, AsContextMut, Engine, MemoryType, RuntimeEventKind, StoreContext, StoreContextMut,
+};
+use alloc::sync::Arc;
+use core::any::Any;
 use core::cell::UnsafeCell;
 use core::fmt;
 use core::slice;
 use core::time::Duration;
 use wasmtime_environ::DefinedMemoryIndex;
 
-pub use crate::runtime::vm::WaitResult;
+pub use crate::runtime::vm::{SharedMemoryEvent, WaitResult};
 
 /// Error for out of bounds [`Memory`] access.
 #[derive(Debug)]
@@ -230,6 +234,78 @@ const _: () = {
     assert!(core::mem::offset_of!(Memory, instance) == 0);
 };
 
+/// Counters of how a [`Memory`] has grown, returned by
+/// [`Memory::growth_stats`].
+#[derive(Copy, Clone, Debug, Default, PartialEq, Eq)]
+pub struct MemoryGrowthStats {
+    /// The number of times that the memory grew.
+    pub grows: u64,
+    /// The number of times that growing the memory moved it to a new
+    /// allocation.
+    pub moves: u64,
+    /// The number of bytes of the memory's contents which were copied when
+    /// it moved.
+    pub bytes_copied: u64,
+}
+
+/// Contents which can be mapped copy-on-write into many linear memories, see
+/// [`Memory::new_from_source`].
+///
+/// Cloning a `MemorySource` is cheap and refers to the same contents.
+#[cfg(all(unix, feature = "std", not(miri)))]
+#[derive(Clone, Debug)]
+pub struct MemorySource {
+    source: Arc<vm::MemoryImageSource>,
+    len: usize,
+}
+
+#[cfg(all(unix, feature = "std", not(miri)))]
+impl MemorySource {
+    /// Creates a source holding a copy of `data`.
+    ///
+    /// The copy is kept in an anonymous file in memory which is sealed
+    /// against any further writes.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the anonymous file can't be created, which is
+    /// always the case on platforms other than Linux.
+    pub fn from_data(data: &[u8]) -> Result<MemorySource> {
+        match vm::MemoryImageSource::from_data(data)? {
+            Some(source) => Ok(MemorySource {
+                source: Arc::new(source),
+                len: data.len(),
+            }),
+            None => bail!("memory sources can't be created from data on this platform"),
+        }
+    }
+
+    /// Creates a source mapping the contents of `file`.
+    ///
+    /// Pages of the file are only read when a memory first accesses them, and
+    /// are shared with the operating system's page cache.
+    ///
+    /// # Unsafety
+    ///
+    /// `file` must not be truncated, nor its contents changed, for as long as
+    /// this source or any memory created from it is alive. Accessing mapped
+    /// pages beyond the end of the file raises `SIGBUS`, which Wasmtime
+    /// doesn't handle.
+    pub unsafe fn from_file(file: &std::fs::File) -> Result<MemorySource> {
+        let len = usize::try_from(file.metadata()?.len())?;
+        let file = Arc::new(file.try_clone()?);
+        Ok(MemorySource {
+            source: Arc::new(vm::MemoryImageSource::from_file(&file).unwrap()),
+            len,
+        })
+    }
+
+    /// Returns the size of this source, in bytes.
+    pub fn len(&self) -> usize {
+        self.len
+    }
+}
+
 impl Memory {
     /// Creates a new WebAssembly memory given the configuration of `ty`.
     ///
@@ -332,7 +408,8 @@ impl Memory {
     ///
     /// # Panics
     ///
-    /// Panics if this memory doesn't belong to `store`.
+    /// Panics if this memory doesn't belong to `store`, or if `store` is
+    /// [hibernating](crate::Store::hibernate).
     pub fn read(
         &self,
         store: impl AsContext,
@@ -380,10 +457,13 @@ impl Memory {
     ///
     /// # Panics
     ///
-    /// Panics if this memory doesn't belong to `store`.
+    /// Panics if this memory doesn't belong to `store`, or if `store` is
+    /// [hibernating](crate::Store::hibernate), since the memory can't be
+    /// restored through a shared borrow of the store.
     pub fn data<'a, T: 'static>(&self, store: impl Into<StoreContext<'a, T>>) -> &'a [u8] {
         unsafe {
             let store = store.into();
+            store.0.assert_not_hibernating();
             let definition = store[self.instance].memory(self.index);
             debug_assert!(!self.ty(store).is_shared());
             slice::from_raw_parts(definition.base.as_ptr(), definition.current_length())
@@ -395,15 +475,20 @@ impl Memory {
     /// Note that this method will consider the entire store context provided as
     /// borrowed for the duration of the lifetime of the returned slice.
     ///
+    /// If `store` is [hibernating](crate::Store::hibernate) then its memories
+    /// are restored first.
+    ///
     /// # Panics
     ///
-    /// Panics if this memory doesn't belong to `store`.
+    /// Panics if this memory doesn't belong to `store`, or if `store` is
+    /// hibernating and restoring its memories fails.
     pub fn data_mut<'a, T: 'static>(
         &self,
         store: impl Into<StoreContextMut<'a, T>>,
     ) -> &'a mut [u8] {
         unsafe {
             let store = store.into();
+            store.0.resume_for_memory_access();
             let definition = store[self.instance].memory(self.index);
             debug_assert!(!self.ty(store).is_shared());
             slice::from_raw_parts_mut(definition.base.as_ptr(), definition.current_length())
@@ -487,6 +572,13 @@ impl Memory {
         store[self.instance].memory(self.index).current_length()
     }
 
+    pub(crate) fn internal_data_mut<'a>(&self, store: &'a mut StoreOpaque) -> &'a mut [u8] {
+        unsafe {
+            let definition = store[self.instance].memory(self.index);
+            slice::from_raw_parts_mut(definition.base.as_ptr(), definition.current_length())
+        }
+    }
+
     /// Returns the size, in units of pages, of this Wasm memory.
     ///
     /// WebAssembly memories are made up of a whole number of pages, so the byte
@@ -632,11 +724,19 @@ impl Memory {
         limiter: Option<&mut StoreResourceLimiter<'_>>,
         delta: u64,
     ) -> Result<u64> {
+        let event = store.engine().start_event();
         let result = self
             .instance
             .get_mut(store)
             .memory_grow(limiter, self.index, delta)
             .await?;
+        store
+            .engine()
+            .finish_event(event, |duration| RuntimeEventKind::MemoryGrow {
+                delta,
+                succeeded: result.is_some(),
+                duration,
+            });
         match result {
             Some(size) => {
                 let page_size = self.wasmtime_ty(store).page_size();
@@ -646,6 +746,328 @@ impl Memory {
         }
     }
 
+    /// Grows this memory by `delta` pages like [`Memory::grow`], and then
+    /// populates the newly accessible pages so wasm doesn't take a page fault
+    /// on its first access to each of them.
+    ///
+    /// This is useful for latency-sensitive workloads which would rather pay
+    /// for faulting in memory up-front. It can be used even if
+    /// [`Config::memory_populate`](crate::Config::memory_populate), which
+    /// does this for all memories, isn't enabled. Populating is best-effort,
+    /// see that method for details, but growth itself behaves exactly like
+    /// [`Memory::grow`].
+    ///
+    /// # Errors
+    ///
+    /// Returns an error in the same situations as [`Memory::grow`]. When
+    /// using an async resource limiter, use [`Memory::grow_async`] followed
+    /// by [`Memory::populate`] instead.
+    ///
+    /// # Panics
+    ///
+    /// Panics if this memory doesn't belong to `store`.
+    pub fn grow_populated(&self, mut store: impl AsContextMut, delta: u64) -> Result<u64> {
+        let prev = self.grow(&mut store, delta)?;
+        let store = store.as_context().0;
+        let page_size = self.wasmtime_ty(store).page_size();
+        let start = usize::try_from(prev * page_size).unwrap();
+        self.populate_range(store, start..self.internal_data_size(store));
+        Ok(prev)
+    }
+
+    /// Populates all currently accessible pages of this memory, so wasm
+    /// doesn't take a page fault on its first access to each of them.
+    ///
+    /// See [`Config::memory_populate`](crate::Config::memory_populate) for
+    /// details on populating.
+    ///
+    /// # Panics
+    ///
+    /// Panics if this memory doesn't belong to `store`.
+    pub fn populate(&self, store: impl AsContext) {
+        let store = store.as_context().0;
+        self.populate_range(store, 0..self.internal_data_size(store));
+    }
+
+    fn populate_range(&self, store: &StoreOpaque, range: core::ops::Range<usize>) {
+        store[self.instance]
+            .get_defined_memory(self.index)
+            .populate(range);
+    }
+
+    /// Returns the number of sampled loads and stores by wasm to each page of
+    /// this memory, indexed by WebAssembly page.
+    ///
+    /// Accesses are only sampled when enabled with
+    /// [`Config::memory_access_sampling`](crate::Config::memory_access_sampling),
+    /// one in every configured interval of accesses across the whole store,
+    /// and otherwise every count is zero. Counts accumulate for as long as
+    /// the memory exists, and the returned histogram covers all of the
+    /// memory's current pages.
+    ///
+    /// # Panics
+    ///
+    /// Panics if this memory doesn't belong to `store`.
+    pub fn access_histogram(&self, store: impl AsContext) -> Vec<u64> {
+        let store = store.as_context().0;
+        store[self.instance]
+            .get_defined_memory(self.index)
+            .access_histogram()
+    }
+
+    /// Returns counters of how many times this memory has grown, how many of
+    /// those growths moved it, and how many bytes moving it copied.
+    ///
+    /// This can be used to tune
+    /// [`Config::memory_reservation_for_growth`](crate::Config::memory_reservation_for_growth)
+    /// and
+    /// [`Config::memory_reservation_for_growth_geometric`](crate::Config::memory_reservation_for_growth_geometric)
+    /// for guests which grow their memory often. Growing by zero pages and
+    /// failed growths aren't counted, and shared memories, which never move,
+    /// always report zeros.
+    ///
+    /// # Panics
+    ///
+    /// Panics if this memory doesn't belong to `store`.
+    pub fn growth_stats(&self, store: impl AsContext) -> MemoryGrowthStats {
+        let store = store.as_context().0;
+        store[self.instance]
+            .get_defined_memory(self.index)
+            .growth_stats()
+    }
+
+    /// Returns the byte ranges of this memory which lie on pages that have been
+    /// written to, by wasm or the host.
+    ///
+    /// A page is dirty from the first time it's written until it's restored
+    /// with [`Memory::reset_dirty_to_image`]. This is useful to, for example,
+    /// find the parts of a memory that a request modified in order to save
+    /// them in a checkpoint. The returned ranges are sorted and don't overlap,
+    /// and they always cover whole host pages except at the end of memory.
+    ///
+    /// Dirty pages are found by asking the kernel which pages are private to
+    /// this process, so there's no overhead when this isn't used. Pages which
+    /// were written but whose contents were later restored by other means,
+    /// for example by the pooling allocator's
+    /// [`linear_memory_keep_resident`](crate::PoolingAllocationConfig::linear_memory_keep_resident)
+    /// option, are still reported as dirty.
+    ///
+    /// # Errors
+    ///
+    /// This is only supported on Linux 6.7 and later, which provide the
+    /// `PAGEMAP_SCAN` ioctl, and an error is returned on other platforms. An
+    /// error is also returned for memories which aren't backed by virtual
+    /// memory allocated by Wasmtime, for example with a custom
+    /// [`MemoryCreator`](crate::MemoryCreator).
+    ///
+    /// # Panics
+    ///
+    /// Panics if this memory doesn't belong to `store`.
+    pub fn dirty_pages(&self, store: impl AsContext) -> Result<Vec<core::ops::Range<usize>>> {
+        let store = store.as_context().0;
+        store[self.instance]
+            .get_defined_memory(self.index)
+            .dirty_pages()
+    }
+
+    /// Restores the dirty pages of this memory, as reported by
+    /// [`Memory::dirty_pages`], back to their contents when the memory was
+    /// instantiated.
+    ///
+    /// Only pages that were written are reset: they're released back to the
+    /// kernel which then maps them to the module's copy-on-write memory image
+    /// again, or to zeros outside of the image. This can be much cheaper than
+    /// recreating the instance when only a small part of a large memory is
+    /// modified, for example when recycling an instance between requests.
+    /// Note that memory is not shrunk back to its initial size, and any pages
+    /// added by [`Memory::grow`] are reset to zeros.
+    ///
+    /// On `no_std` platforms using the `custom-virtual-memory` feature, which
+    /// can't track dirty pages, all of memory is reset instead: zeros are
+    /// mapped over it and the image is mapped back in with
+    /// `wasmtime_memory_image_map_at`, which the platform can implement with
+    /// copy-on-write.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error in the same situations as [`Memory::dirty_pages`],
+    /// other than on the `no_std` platforms described above. An
+    /// error is also returned if this memory wasn't initialized from a
+    /// copy-on-write image, for example if
+    /// [`Config::memory_init_cow`](crate::Config::memory_init_cow) is disabled
+    /// or if the module has no data for this memory and the pooling allocator
+    /// isn't used. Memories which have grown beyond their original
+    /// reservation, or which had a file mapped into them with
+    /// `Memory::map_file`, can't be reset either.
+    ///
+    /// # Panics
+    ///
+    /// Panics if this memory doesn't belong to `store`.
+    pub fn reset_dirty_to_image(&self, mut store: impl AsContextMut) -> Result<()> {
+        let store = store.as_context_mut().0;
+        self.instance
+            .get_mut(store)
+            .get_defined_memory_mut(self.index)
+            .reset_dirty_to_image()
+    }
+
+    /// Maps `len` bytes of `file`, starting at `file_offset`, copy-on-write
+    /// into this memory at byte `offset`, replacing the memory's current
+    /// contents in that range.
+    ///
+    /// This lets large inputs be made available to wasm without copying them:
+    /// pages of the file are only read when they're first accessed, and are
+    /// shared with the operating system's page cache until they're written
+    /// to. Writes from wasm or the host are private to this memory and are
+    /// never written back to `file`.
+    ///
+    /// The `offset`, `file_offset` and `len` must all be multiples of the
+    /// host's page size, and the range must be within both the current size
+    /// of this memory and the file. The mapping stays in place until the
+    /// memory is dropped, or until it's moved by [`Memory::grow`], at which
+    /// point the mapped contents are copied like any other contents.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if any of the above requirements aren't met, if this
+    /// memory isn't backed by virtual memory allocated by Wasmtime (for
+    /// example with a custom [`MemoryCreator`](crate::MemoryCreator)), or if
+    /// the mapping otherwise fails.
+    ///
+    /// # Unsafety
+    ///
+    /// No slices previously returned by [`Memory::data`] or
+    /// [`Memory::data_mut`] which overlap the mapped range may be used after
+    /// this returns, and `file` must not be truncated for as long as the
+    /// mapping is in place. Accessing mapped pages beyond the end of the file
+    /// raises `SIGBUS`, which Wasmtime doesn't handle.
+    ///
+    /// # Panics
+    ///
+    /// Panics if this memory doesn't belong to `store`.
+    #[cfg(all(unix, feature = "std", not(miri)))]
+    pub unsafe fn map_file(
+        &self,
+        mut store: impl AsContextMut,
+        offset: usize,
+        file: &std::fs::File,
+        file_offset: u64,
+        len: usize,
+    ) -> Result<()> {
+        let store = store.as_context_mut().0;
+        let memory = self
+            .instance
+            .get_mut(store)
+            .get_defined_memory_mut(self.index);
+        // SAFETY: the contract is upheld by the caller.
+        unsafe { memory.map_file(offset, file, file_offset, len) }
+    }
+
+    /// Creates a new memory of type `ty` in `store` whose contents start with
+    /// those of `source`, mapped copy-on-write.
+    ///
+    /// A [`MemorySource`] is created once, and can then be mapped into any
+    /// number of memories in any number of stores and engines. Each of these
+    /// memories shares the same physical pages of `source` until it writes to
+    /// them, so a large read-only dataset imported by many instances only
+    /// takes up memory once on the host rather than once per instance. Writes
+    /// by wasm or the host are private to the memory they're made to and are
+    /// never seen by `source` or by other memories.
+    ///
+    /// The mapping stays in place until the memory is dropped, or until it's
+    /// moved by [`Memory::grow`], at which point the memory gets its own copy
+    /// of its contents. Giving `ty` a maximum size which fits within its
+    /// [`Config::memory_reservation`](crate::Config::memory_reservation)
+    /// keeps it from ever moving.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `source` is larger than the minimum size of `ty`,
+    /// if the memory isn't backed by virtual memory allocated by Wasmtime (for
+    /// example with a custom [`MemoryCreator`](crate::MemoryCreator)), or in
+    /// the same situations as [`Memory::new`].
+    ///
+    /// # Panics
+    ///
+    /// This function will panic when used with a [`Store`](`crate::Store`)
+    /// which has a [`ResourceLimiterAsync`](`crate::ResourceLimiterAsync`).
+    #[cfg(all(unix, feature = "std", not(miri)))]
+    pub fn new_from_source(
+        mut store: impl AsContextMut,
+        ty: MemoryType,
+        source: &MemorySource,
+    ) -> Result<Memory> {
+        let mut store = store.as_context_mut();
+        let memory = Memory::new(&mut store, ty)?;
+        let page_size = crate::runtime::vm::host_page_size();
+        let len = source
+            .len
+            .checked_next_multiple_of(page_size)
+            .ok_or_else(|| format_err!("source is too large"))?;
+        if len > memory.data_size(&store) {
+            bail!("source is larger than the memory");
+        }
+        let vm_memory = memory
+            .instance
+            .get_mut(store.0)
+            .get_defined_memory_mut(memory.index);
+        // SAFETY: the memory was just created so nothing is borrowing its
+        // contents, and a `MemorySource`'s file is never truncated. The last
+        // page of `source` may extend beyond the end of its file, which reads
+        // as zeros.
+        unsafe { vm_memory.map_source(0, &source.source, 0, len)? };
+        Ok(memory)
+    }
+
+    /// Zeroes `len` bytes of this memory starting at byte `offset`, and
+    /// returns the pages backing them to the operating system.
+    ///
+    /// WebAssembly memories can't shrink, so a guest which frees a large
+    /// region keeps it resident at its peak size. If the guest, or a host
+    /// which knows the guest's allocator, can tell that a region is no longer
+    /// used then discarding it reduces the memory's resident size while the
+    /// region stays accessible: it reads as zeros afterwards and is backed
+    /// again by fresh pages once it's written to.
+    ///
+    /// Only pages which are entirely within the range are returned to the
+    /// operating system, the bytes of any partial pages at its ends are just
+    /// overwritten with zeros. This is also what happens to the whole range on
+    /// platforms other than Unix, or for memories which aren't backed by
+    /// virtual memory allocated by Wasmtime, for example with a custom
+    /// [`MemoryCreator`](crate::MemoryCreator).
+    ///
+    /// Discarding pages which were initialized from a copy-on-write image, or
+    /// which had a file mapped into them with `Memory::map_file`, means that
+    /// [`Memory::reset_dirty_to_image`] can't be used with this memory
+    /// afterwards.
+    ///
+    /// To let a guest discard memory itself, the host can define a function
+    /// import which calls this method on the guest's exported memory.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the range isn't within the current size of this
+    /// memory, or if returning the pages to the operating system fails.
+    ///
+    /// # Panics
+    ///
+    /// Panics if this memory doesn't belong to `store`.
+    pub fn discard(&self, mut store: impl AsContextMut, offset: usize, len: usize) -> Result<()> {
+        self.internal_discard(store.as_context_mut().0, offset, len)
+    }
+
+    pub(crate) fn internal_discard(
+        &self,
+        store: &mut StoreOpaque,
+        offset: usize,
+        len: usize,
+    ) -> Result<()> {
+        self.instance
+            .get_mut(store)
+            .get_defined_memory_mut(self.index)
+            .discard(offset, len)
+    }
+
     /// Creates a new memory from its raw component parts.
     ///
     /// # Safety
@@ -697,7 +1119,7 @@ impl Memory {
 ///
 /// Note that this is a relatively advanced feature and it is recommended to be
 /// familiar with wasmtime runtime code to use it.
-pub unsafe trait LinearMemory: Send + Sync + 'static {
+pub unsafe trait LinearMemory: Any + Send + Sync {
     /// Returns the number of allocated bytes which are accessible at this time.
     fn byte_size(&self) -> usize;
 
@@ -770,6 +1192,29 @@ pub unsafe trait MemoryCreator: Send + Sync {
         reserved_size_in_bytes: Option<usize>,
         guard_size_in_bytes: usize,
     ) -> Result<Box<dyn LinearMemory>, String>;
+
+    /// Returns a memory previously created by [`MemoryCreator::new_memory`]
+    /// to this creator once Wasmtime no longer uses it.
+    ///
+    /// By default `memory` is dropped. Creators which manage their own arenas
+    /// of memory can instead recycle it, for example by keeping it on a free
+    /// list and returning it from a later call to `new_memory`, which avoids
+    /// the cost of mapping and unmapping memory for every instance, much like
+    /// the [pooling allocator](crate::InstanceAllocationStrategy::Pooling)
+    /// does. The original type of `memory` can be recovered by converting it
+    /// to a `Box<dyn Any>` and downcasting it.
+    ///
+    /// Wasmtime never accesses `memory` after passing it here, but its
+    /// contents are whatever the instance last left in it. A recycled memory
+    /// must therefore be reset before it's returned from `new_memory` again:
+    /// its first `minimum` bytes must be zero, and its reservation and guard
+    /// region must satisfy the parameters of that call. Memory beyond the
+    /// `byte_size` of `memory` hasn't been accessible to WebAssembly, so only
+    /// that many bytes need resetting, which may be done lazily, on another
+    /// thread, or with `madvise` depending on the creator.
+    fn reuse_memory(&self, memory: Box<dyn LinearMemory>) {
+        drop(memory);
+    }
 }
 
 /// A constructor for externally-created shared memory.
@@ -1005,6 +1450,37 @@ impl SharedMemory {
         self.vm.atomic_wait64(addr, expected, timeout)
     }
 
+    /// Installs a hook which is invoked for every atomic wait and notify on
+    /// this shared memory, replacing any previously installed hook.
+    ///
+    /// This lets an embedder integrate the threads of wasm guests with its own
+    /// scheduler, for example an event loop which needs to know when a guest is
+    /// blocked on an address so that it can later wake it with
+    /// [`SharedMemory::atomic_notify`], or which needs to know when a guest
+    /// notifies an address the host is waiting on.
+    ///
+    /// The hook receives a [`SharedMemoryEvent::Wait`] just before a thread,
+    /// whether a wasm thread executing `memory.atomic.wait*` or a host thread
+    /// in [`SharedMemory::atomic_wait32`] or [`SharedMemory::atomic_wait64`],
+    /// checks the expected value and blocks. As with the wait itself, the value
+    /// may have changed by the time the thread blocks, in which case it
+    /// returns immediately. A [`SharedMemoryEvent::Notify`] is received after
+    /// any notification, from wasm or from the host, has woken its waiters.
+    ///
+    /// The hook runs synchronously on the thread performing the operation, and
+    /// is shared by all clones of this [`SharedMemory`]. It may call
+    /// [`SharedMemory::atomic_notify`] and this method itself, but it should
+    /// not block.
+    pub fn set_atomic_hook(&self, hook: impl Fn(SharedMemoryEvent) + Send + Sync + 'static) {
+        self.vm.set_atomic_hook(Some(Arc::new(hook)));
+    }
+
+    /// Removes the hook installed with [`SharedMemory::set_atomic_hook`], if
+    /// any.
+    pub fn clear_atomic_hook(&self) {
+        self.vm.set_atomic_hook(None);
+    }
+
     /// Return a reference to the [`Engine`] used to configure the shared
     /// memory.
     pub(crate) fn engine(&self) -> &Engine {
@@ -4,7 +4,7 @@ use crate::runtime::vm::open_file_for_mmap;
 use crate::runtime::vm::{CompiledModuleId, MmapVec, ModuleMemoryImages, VMWasmCallFunction};
 use crate::sync::OnceLock;
 use crate::{
-    Engine,
+    Engine, SerializedModuleInfo,
     code::EngineCode,
     code_memory::CodeMemory,
     instantiate::CompiledModule,
@@ -21,14 +21,38 @@ use wasmparser::{Parser, ValidPayload, Validator};
 #[cfg(feature = "debug")]
 use wasmtime_environ::FrameTable;
 use wasmtime_environ::{
-    CompiledFunctionsTable, CompiledModuleInfo, EntityIndex, HostPtr, ModuleTypes, ObjectKind,
-    TypeTrace, VMOffsets, VMSharedTypeIndex,
+    CompiledFunctionsTable, CompiledModuleInfo, EntityIndex, EntityRef, HostPtr, MemoryIndex,
+    ModuleTypes, ObjectKind, TypeTrace, VMOffsets, VMSharedTypeIndex,
 };
 #[cfg(feature = "gc")]
 use wasmtime_unwinder::ExceptionTable;
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+mod dedup;
+mod estimate;
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+mod lazy;
 mod registry;
-
+#[cfg(feature = "std")]
+mod shared;
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+mod specialize;
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+mod streaming;
+#[cfg(feature = "cranelift")]
+mod tier_up;
+
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub(crate) use dedup::CachedModules;
+pub use estimate::ModuleResourceEstimate;
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub use lazy::LazyModule;
 pub use registry::*;
+#[cfg(feature = "std")]
+pub use shared::SharedCodeRegistry;
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub(crate) use specialize::SpecializedModules;
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub use streaming::ModuleBuilder;
 
 /// A compiled WebAssembly module, ready to be instantiated.
 ///
@@ -161,6 +185,15 @@ struct ModuleInner {
 
     /// Runtime offset information for `VMContext`.
     offsets: VMOffsets<HostPtr>,
+
+    /// Whether each memory of this module, in its memory index space, is
+    /// exported, so that `Instance::memory` doesn't need to search exports.
+    exported_memories: Box<[bool]>,
+
+    /// The optimized tier of this module, if it was compiled with tiered
+    /// compilation enabled.
+    #[cfg(feature = "cranelift")]
+    tier_up: Option<Arc<tier_up::TierUp>>,
 }
 
 impl fmt::Debug for Module {
@@ -286,6 +319,33 @@ impl Module {
             .compile_module()
     }
 
+    /// Creates a new WebAssembly `Module` from the contents of the given
+    /// `file` on disk, which is mapped into memory instead of being read.
+    ///
+    /// This is the same as [`Module::from_file`], except that compilation
+    /// reads the module directly from a memory mapping of `file`. The pages
+    /// of large modules are then loaded as they're compiled, and can be
+    /// evicted again, instead of being copied into a buffer of the size of the
+    /// whole file first. As with all compilation, the bodies of functions are
+    /// validated as they're compiled, in parallel if
+    /// [`Config::parallel_compilation`](crate::Config::parallel_compilation)
+    /// is enabled. The mapping is dropped once compilation has finished.
+    ///
+    /// # Unsafety
+    ///
+    /// The file must not be modified or truncated by this or any other
+    /// process while it's being compiled, since that changes, or removes, the
+    /// memory that compilation is reading.
+    #[cfg(all(feature = "std", any(feature = "cranelift", feature = "winch")))]
+    pub unsafe fn from_mapped_file(engine: &Engine, file: impl AsRef<Path>) -> Result<Module> {
+        let open_file = open_file_for_mmap(file.as_ref())?;
+        let mmap = crate::runtime::vm::MmapVec::from_file(open_file)
+            .with_context(|| format!("failed to map input file: {}", file.as_ref().display()))?;
+        crate::CodeBuilder::new(engine)
+            .wasm_binary_or_text(&mmap[..], Some(file.as_ref()))?
+            .compile_module()
+    }
+
     /// Creates a new WebAssembly `Module` from the given in-memory `binary`
     /// data.
     ///
@@ -406,6 +466,30 @@ impl Module {
         Module::from_parts(engine, code, None)
     }
 
+    /// Reads the headers of a module previously serialized with
+    /// [`Module::serialize`] or [`Engine::precompile_module`] and reports
+    /// whether it can be deserialized with `engine`.
+    ///
+    /// This is much cheaper than [`Module::deserialize`] as it only parses the
+    /// artifact's ELF header and section table and the engine configuration
+    /// embedded within it, and doesn't map or otherwise prepare any of its
+    /// code. It's intended for checks such as whether a cached artifact needs
+    /// to be recompiled after an engine configuration change.
+    ///
+    /// Note that the contents of the artifact are not validated, so an
+    /// artifact reported as compatible may still fail to deserialize. Artifacts
+    /// compressed with `Engine::compress_precompiled` are decompressed in
+    /// full to be inspected.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `bytes` doesn't look like a precompiled module at
+    /// all. Mismatches with `engine` are instead reported through
+    /// [`SerializedModuleInfo::incompatibility`].
+    pub fn inspect_serialized(engine: &Engine, bytes: &[u8]) -> Result<SerializedModuleInfo> {
+        engine.inspect_precompiled_module(bytes)
+    }
+
     /// In-place deserialization of an in-memory compiled module previously
     /// created with [`Module::serialize`] or [`Engine::precompile_module`].
     ///
@@ -426,6 +510,39 @@ impl Module {
         Module::from_parts(engine, code, None)
     }
 
+    /// Same as [`Self::deserialize_raw`], except that `owner` is dropped once
+    /// the returned module no longer uses `memory`.
+    ///
+    /// This is useful when `memory` is a caller-managed mapping, such as a
+    /// region of shared memory, which needs to be released when Wasmtime is
+    /// done with it. The `owner` is dropped after the last clone of the
+    /// returned [`Module`], and every instance of it, has been dropped. It's
+    /// also dropped if deserialization fails.
+    ///
+    /// As with [`Self::deserialize_raw`] the memory is used in-place. Code
+    /// within it is never made executable by Wasmtime, so unless the module
+    /// targets Pulley this requires either that `memory` is already mapped
+    /// executable with the module's text section page-aligned or that a
+    /// [`CustomCodeMemory`](crate::CustomCodeMemory) is configured.
+    ///
+    /// # Unsafety
+    ///
+    /// All of the safety notes from [`Self::deserialize_raw`] apply here as
+    /// well, except that `memory` need only remain valid and unmodified until
+    /// `owner` is dropped.
+    pub unsafe fn deserialize_raw_with_owner(
+        engine: &Engine,
+        memory: NonNull<[u8]>,
+        owner: impl Send + Sync + 'static,
+    ) -> Result<Module> {
+        // SAFETY: the contract required by `load_code_raw_with_owner` is the
+        // same as this function.
+        let code = unsafe {
+            engine.load_code_raw_with_owner(memory, Box::new(owner), ObjectKind::Module)?
+        };
+        Module::from_parts(engine, code, None)
+    }
+
     /// Same as [`deserialize`], except that the contents of `path` are read to
     /// deserialize into a [`Module`].
     ///
@@ -433,7 +550,23 @@ impl Module {
     /// since the data doesn't need to be copied around, but rather the module
     /// can be used directly from an mmap'd view of the file provided.
     ///
+    /// When [copy-on-write memory initialization][cow] is enabled the initial
+    /// contents of the module's linear memories are stored in the file as
+    /// page-aligned images, built when the module was compiled. Instances of
+    /// the returned module map these images directly from the file, so no
+    /// data segments are processed and no anonymous memory is allocated to
+    /// initialize memories, and the pages of the images are shared with
+    /// every other process mapping the same file. Modules whose data segments
+    /// are too sparse may be compiled without images, see
+    /// [`Config::memory_guaranteed_dense_image_size`][dense].
+    ///
+    /// Artifacts compressed with `Engine::compress_precompiled` are instead
+    /// decompressed into anonymous memory, so none of the above applies to
+    /// them.
+    ///
     /// [`deserialize`]: Module::deserialize
+    /// [cow]: crate::Config::memory_init_cow
+    /// [dense]: crate::Config::memory_guaranteed_dense_image_size
     ///
     /// # Unsafety
     ///
@@ -487,6 +620,40 @@ impl Module {
         Module::from_parts(engine, code, None)
     }
 
+    /// Same as [`deserialize_file`] for each of `paths`, except that the code
+    /// of all the modules is published together.
+    ///
+    /// Making code executable on some platforms, notably AArch64 Linux,
+    /// requires flushing the pipelines of all cores running threads of this
+    /// process, which interrupts each of them. Loading modules one at a time
+    /// does this for each module, while this function does it once for all of
+    /// them, which makes loading many modules at once faster, especially on
+    /// hosts with many cores.
+    ///
+    /// The modules are returned in the same order as `paths`. If any of them
+    /// fails to load then an error is returned and none of them are.
+    ///
+    /// [`deserialize_file`]: Module::deserialize_file
+    ///
+    /// # Unsafety
+    ///
+    /// All of the reasons that [`deserialize_file`] is `unsafe` applies to
+    /// this function as well, for each of `paths`.
+    #[cfg(feature = "std")]
+    pub unsafe fn deserialize_files<P: AsRef<Path>>(
+        engine: &Engine,
+        paths: impl IntoIterator<Item = P>,
+    ) -> Result<Vec<Module>> {
+        crate::runtime::code_memory::publish_batch(|| {
+            paths
+                .into_iter()
+                // SAFETY: the contract of `deserialize_file` is the same as
+                // this function's for each path.
+                .map(|path| unsafe { Self::deserialize_file(engine, path) })
+                .collect()
+        })
+    }
+
     /// Entrypoint for creating a `Module` for all above functions, both
     /// of the AOT and jit-compiled categories.
     ///
@@ -542,6 +709,14 @@ impl Module {
 
         let _ = serializable;
 
+        let env_module = module.module();
+        let mut exported_memories = vec![false; env_module.memories.len()];
+        for export in env_module.exports.values() {
+            if let EntityIndex::Memory(index) = export {
+                exported_memories[index.index()] = true;
+            }
+        }
+
         Ok(Self {
             inner: Arc::new(ModuleInner {
                 engine: engine.clone(),
@@ -551,6 +726,9 @@ impl Module {
                 #[cfg(any(feature = "cranelift", feature = "winch"))]
                 serializable,
                 offsets,
+                exported_memories: exported_memories.into(),
+                #[cfg(feature = "cranelift")]
+                tier_up: None,
             }),
         })
     }
@@ -565,7 +743,19 @@ impl Module {
     /// configuration for WebAssembly features, for example, which are used to
     /// indicate what should be valid and what shouldn't be.
     ///
-    /// Validation automatically happens as part of [`Module::new`].
+    /// Validation automatically happens as part of [`Module::new`]. Note that
+    /// it isn't a separate pass there: each function body is validated while
+    /// it's translated for compilation, and the compiler relies on the type
+    /// information computed by the validator. Compiling a module therefore
+    /// can't skip validation even if the module is already known to be valid,
+    /// and there's no need to call this function before [`Module::new`] as
+    /// the same errors are reported either way.
+    ///
+    /// If modules are validated ahead of time, for example when they're
+    /// uploaded to a service, consider instead compiling them once with
+    /// [`Engine::precompile_module`] at that time. The resulting artifacts can
+    /// then be loaded with [`Module::deserialize`] wherever they're used,
+    /// which neither validates nor compiles the module again.
     ///
     /// # Errors
     ///
@@ -634,6 +824,22 @@ impl Module {
         Ok(self.engine_code().image().to_vec())
     }
 
+    /// Same as [`Module::serialize`] except that the serialized module is
+    /// written to `writer` instead of being returned in a vector.
+    ///
+    /// The bytes are written directly from this module's in-memory image, so
+    /// no copy of the whole artifact is made.
+    #[cfg(all(feature = "std", any(feature = "cranelift", feature = "winch")))]
+    pub fn serialize_to(&self, mut writer: impl std::io::Write) -> Result<()> {
+        if !self.inner.serializable {
+            bail!("cannot serialize a module exported from a component");
+        }
+        writer
+            .write_all(self.engine_code().image())
+            .context("failed to write serialized module")?;
+        Ok(())
+    }
+
     pub(crate) fn compiled_module(&self) -> &CompiledModule {
         &self.inner.module
     }
@@ -646,6 +852,16 @@ impl Module {
         self.compiled_module().module()
     }
 
+    /// Returns whether the memory at `index` in this module's memory index
+    /// space is exported.
+    pub(crate) fn exports_memory(&self, index: MemoryIndex) -> bool {
+        self.inner
+            .exported_memories
+            .get(index.index())
+            .copied()
+            .unwrap_or(false)
+    }
+
     pub(crate) fn types(&self) -> &ModuleTypes {
         self.inner.code.module_types()
     }
@@ -885,6 +1101,68 @@ impl Module {
         &self.inner.engine
     }
 
+    /// Starts compiling the optimized tier of this freshly compiled baseline
+    /// module in the background.
+    #[cfg(feature = "cranelift")]
+    pub(crate) fn start_tier_up(
+        mut self,
+        wasm: Vec<u8>,
+        dwarf_package: Option<Vec<u8>>,
+        specialized_globals: Vec<(String, String, wasmtime_environ::ConstOp)>,
+        inlined_imports: Vec<(String, String, crate::HostIntrinsic)>,
+        profile: Option<crate::CompileProfile>,
+    ) -> Module {
+        let tier_up = tier_up::TierUp::spawn(
+            self.engine(),
+            wasm,
+            dwarf_package,
+            specialized_globals,
+            inlined_imports,
+            profile,
+        );
+        Arc::get_mut(&mut self.inner)
+            .expect("newly compiled module should not be shared")
+            .tier_up = Some(tier_up);
+        self
+    }
+
+    /// Returns the optimized tier of this module, if it's available.
+    ///
+    /// When [`Config::tiered_compilation`](crate::Config::tiered_compilation)
+    /// is enabled this module holds baseline code and an optimized version is
+    /// compiled in the background. This returns the optimized version once
+    /// that compilation has finished successfully, and `None` while it's still
+    /// in progress, if it failed, or if this module wasn't compiled with
+    /// tiering.
+    ///
+    /// Instantiating this module automatically uses the optimized tier once
+    /// it's available, so this is primarily useful for observing the state of
+    /// tiering. Such instances are still instances of this module, for
+    /// example [`Instance::module`](crate::Instance::module) returns this
+    /// module and its [`ModuleExport`]s can be used with them.
+    #[cfg(feature = "cranelift")]
+    pub fn optimized_tier(&self) -> Option<Module> {
+        self.inner.tier_up.as_ref()?.get()
+    }
+
+    /// Blocks the current thread until the optimized tier of this module has
+    /// been compiled, and returns it.
+    ///
+    /// If this module wasn't compiled with tiering then it's already as
+    /// optimized as it will get and a clone of it is returned.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if compiling the optimized tier failed, in which case
+    /// instances of this module continue to use the baseline code.
+    #[cfg(feature = "cranelift")]
+    pub fn wait_optimized_tier(&self) -> Result<Module> {
+        match &self.inner.tier_up {
+            Some(tier_up) => tier_up.wait(),
+            None => Ok(self.clone()),
+        }
+    }
+
     /// Returns a summary of the resources required to instantiate this
     /// [`Module`].
     ///
@@ -975,6 +1253,18 @@ impl Module {
         self.engine_code().image().as_ptr_range()
     }
 
+    /// Returns an estimate of the resources needed by this module and by
+    /// each of its instances.
+    ///
+    /// This is computed from the module's compiled metadata, so it's cheap
+    /// and doesn't require instantiating the module. It's intended for
+    /// capacity planning, such as deciding whether a module fits within the
+    /// limits of a host before accepting it. See [`ModuleResourceEstimate`]
+    /// for the values reported.
+    pub fn resource_estimate(&self) -> ModuleResourceEstimate {
+        ModuleResourceEstimate::new(self)
+    }
+
     /// Force initialization of copy-on-write images to happen here-and-now
     /// instead of when they're requested during first instantiation.
     ///
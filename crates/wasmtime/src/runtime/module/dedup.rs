@@ -0,0 +1,48 @@
+//! Deduplication of identical modules compiled in an engine, see
+//! `Engine::compile_cached`.
+
+use super::ModuleInner;
+use crate::prelude::*;
+use crate::{Engine, Module};
+use alloc::sync::{Arc, Weak};
+use std::collections::HashMap;
+use std::sync::Mutex;
+
+/// An engine's modules compiled with `Engine::compile_cached`.
+///
+/// Modules are keyed by their contents, and are only held weakly so that
+/// they're freed once all their users have dropped them.
+#[derive(Default)]
+pub(crate) struct CachedModules {
+    modules: Mutex<HashMap<Box<[u8]>, Weak<ModuleInner>>>,
+}
+
+impl CachedModules {
+    /// Returns the live module compiled from `bytes`, compiling it if there
+    /// isn't one.
+    pub(crate) fn get_or_compile(&self, engine: &Engine, bytes: &[u8]) -> Result<Module> {
+        if let Some(module) = self.get(bytes) {
+            return Ok(module);
+        }
+
+        // Compile without holding the lock, so that other modules can be
+        // compiled in parallel. If the same module is compiled concurrently
+        // then the first one to finish is kept and the others are discarded,
+        // so that all callers share one copy of it.
+        let module = Module::new(engine, bytes)?;
+
+        let mut modules = self.modules.lock().unwrap();
+        if let Some(inner) = modules.get(bytes).and_then(|m| m.upgrade()) {
+            return Ok(Module { inner });
+        }
+        modules.retain(|_, inner| inner.strong_count() > 0);
+        modules.insert(Box::from(bytes), Arc::downgrade(&module.inner));
+        Ok(module)
+    }
+
+    fn get(&self, bytes: &[u8]) -> Option<Module> {
+        let modules = self.modules.lock().unwrap();
+        let inner = modules.get(bytes)?.upgrade()?;
+        Some(Module { inner })
+    }
+}
@@ -0,0 +1,109 @@
+//! Estimates of the resources needed to instantiate a module, see
+//! `Module::resource_estimate`.
+
+use crate::Module;
+use crate::runtime::vm::Instance;
+
+/// An estimate of the resources needed by a [`Module`] and each instance of
+/// it, returned by [`Module::resource_estimate`].
+///
+/// All values are computed from the compiled module's metadata without
+/// instantiating it. Sizes of memories and tables are the minimums declared
+/// by the module, which is what instantiation allocates. Instances may grow
+/// them further at runtime, and memories and tables imported by the module
+/// aren't included since they're allocated elsewhere.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct ModuleResourceEstimate {
+    pub(crate) code_bytes: usize,
+    pub(crate) text_bytes: usize,
+    pub(crate) data_bytes: usize,
+    pub(crate) memories: usize,
+    pub(crate) min_memory_bytes: u64,
+    pub(crate) tables: usize,
+    pub(crate) min_table_elements: u64,
+    pub(crate) instance_bytes: usize,
+}
+
+impl ModuleResourceEstimate {
+    pub(crate) fn new(module: &Module) -> ModuleResourceEstimate {
+        let env = module.env_module();
+        let code = module.engine_code();
+        let defined_memories = env.memories.values().skip(env.num_imported_memories);
+        let defined_tables = env.tables.values().skip(env.num_imported_tables);
+        ModuleResourceEstimate {
+            code_bytes: code.image().len(),
+            text_bytes: code.text_size(),
+            data_bytes: code.wasm_data().len(),
+            memories: env.num_defined_memories(),
+            min_memory_bytes: defined_memories
+                .map(|m| m.minimum_byte_size().unwrap_or(u64::MAX))
+                .fold(0, u64::saturating_add),
+            tables: env.num_defined_tables(),
+            min_table_elements: defined_tables
+                .map(|t| t.limits.min)
+                .fold(0, u64::saturating_add),
+            instance_bytes: Instance::alloc_layout(module.offsets()).size(),
+        }
+    }
+
+    /// Returns the size, in bytes, of the module's compiled code object,
+    /// which is loaded once and shared by all instances of the module.
+    ///
+    /// This includes the module's executable code, data segments and
+    /// metadata.
+    pub fn code_bytes(&self) -> usize {
+        self.code_bytes
+    }
+
+    /// Returns the size, in bytes, of the executable machine code within the
+    /// module's code object.
+    pub fn text_bytes(&self) -> usize {
+        self.text_bytes
+    }
+
+    /// Returns the size, in bytes, of the module's data segments as stored in
+    /// its code object.
+    ///
+    /// When [copy-on-write memory initialization](crate::Config::memory_init_cow)
+    /// is used the data is laid out as page-aligned memory images, so this may
+    /// be larger than the data segments in the original WebAssembly binary.
+    pub fn data_bytes(&self) -> usize {
+        self.data_bytes
+    }
+
+    /// Returns the number of linear memories defined by the module, each of
+    /// which needs a memory slot in the pooling allocator.
+    pub fn memories(&self) -> usize {
+        self.memories
+    }
+
+    /// Returns the sum of the minimum sizes, in bytes, of the linear memories
+    /// defined by the module.
+    ///
+    /// This saturates at `u64::MAX` for 64-bit memories whose minimum size
+    /// doesn't fit in a `u64`.
+    pub fn min_memory_bytes(&self) -> u64 {
+        self.min_memory_bytes
+    }
+
+    /// Returns the number of tables defined by the module, each of which
+    /// needs a table slot in the pooling allocator.
+    pub fn tables(&self) -> usize {
+        self.tables
+    }
+
+    /// Returns the sum of the minimum number of elements of the tables
+    /// defined by the module.
+    pub fn min_table_elements(&self) -> u64 {
+        self.min_table_elements
+    }
+
+    /// Returns the size, in bytes, of the host state allocated for each
+    /// instance of the module.
+    ///
+    /// This is the value which the pooling allocator compares against
+    /// `PoolingAllocationConfig::max_core_instance_size`.
+    pub fn instance_bytes(&self) -> usize {
+        self.instance_bytes
+    }
+}
@@ -0,0 +1,168 @@
+//! Modules which are compiled on first use, see `LazyModule`.
+
+use crate::prelude::*;
+use crate::{Engine, Module};
+use alloc::sync::Arc;
+use core::fmt;
+use std::sync::{Condvar, Mutex};
+
+/// A WebAssembly module whose compilation is deferred until it's first needed.
+///
+/// Creating a [`Module`] compiles every function within it up front, which for
+/// very large modules can dominate startup time even when most of the module
+/// is never executed. A `LazyModule` instead only validates its input when
+/// it's created and compiles it the first time [`LazyModule::get`] is called,
+/// so modules which are never instantiated never pay for compilation or
+/// occupy code memory.
+///
+/// Compilation can also be started ahead of time on a background thread with
+/// [`LazyModule::warm`], in which case [`LazyModule::get`] waits for the
+/// background compilation rather than compiling the module a second time.
+///
+/// Compilation happens at the granularity of a whole module: once a
+/// `LazyModule` has been compiled all of its functions are compiled.
+///
+/// `LazyModule` is cheap to clone and all clones share the same compiled
+/// module.
+#[derive(Clone)]
+pub struct LazyModule {
+    inner: Arc<LazyModuleInner>,
+}
+
+struct LazyModuleInner {
+    engine: Engine,
+    wasm: Vec<u8>,
+    state: Mutex<State>,
+    done: Condvar,
+}
+
+enum State {
+    Uncompiled,
+    Compiling,
+    Compiled(Module),
+    /// Errors aren't `Clone`, so only the message is retained for all the
+    /// callers of `LazyModule::get`.
+    Failed(String),
+}
+
+impl LazyModule {
+    /// Validates the WebAssembly binary or text in `bytes` and creates a
+    /// module from it which is compiled on first use.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `bytes` is not a valid WebAssembly module for
+    /// `engine`.
+    pub fn new(engine: &Engine, bytes: impl AsRef<[u8]>) -> Result<LazyModule> {
+        #[cfg(feature = "wat")]
+        let wasm = wat::parse_bytes(bytes.as_ref())?.into_owned();
+        #[cfg(not(feature = "wat"))]
+        let wasm = bytes.as_ref().to_vec();
+        Module::validate(engine, &wasm)?;
+        Ok(LazyModule {
+            inner: Arc::new(LazyModuleInner {
+                engine: engine.clone(),
+                wasm,
+                state: Mutex::new(State::Uncompiled),
+                done: Condvar::new(),
+            }),
+        })
+    }
+
+    /// Returns the engine that this module will be compiled with.
+    pub fn engine(&self) -> &Engine {
+        &self.inner.engine
+    }
+
+    /// Returns whether this module has finished compiling, successfully or
+    /// not.
+    pub fn is_compiled(&self) -> bool {
+        match &*self.inner.state.lock().unwrap() {
+            State::Uncompiled | State::Compiling => false,
+            State::Compiled(_) | State::Failed(_) => true,
+        }
+    }
+
+    /// Returns the compiled module, compiling it on the current thread if it
+    /// hasn't been compiled yet.
+    ///
+    /// If the module is being compiled by another thread, such as one started
+    /// by [`LazyModule::warm`], this blocks until that compilation finishes.
+    pub fn get(&self) -> Result<Module> {
+        let mut state = self.inner.state.lock().unwrap();
+        loop {
+            match &*state {
+                State::Uncompiled => break,
+                State::Compiling => state = self.inner.done.wait(state).unwrap(),
+                State::Compiled(module) => return Ok(module.clone()),
+                State::Failed(msg) => bail!("failed to compile lazy module: {msg}"),
+            }
+        }
+        *state = State::Compiling;
+        drop(state);
+        self.inner.compile()
+    }
+
+    /// Starts compiling this module on a background thread, if it isn't
+    /// compiled or being compiled already.
+    ///
+    /// This can be used to warm up modules which are expected to be used soon
+    /// without blocking the current thread.
+    pub fn warm(&self) {
+        {
+            let mut state = self.inner.state.lock().unwrap();
+            if !matches!(*state, State::Uncompiled) {
+                return;
+            }
+            *state = State::Compiling;
+        }
+        let inner = self.inner.clone();
+        let spawned = std::thread::Builder::new()
+            .name("wasmtime-lazy-module".to_string())
+            .spawn(move || {
+                let _ = inner.compile();
+            });
+        if let Err(e) = spawned {
+            log::warn!("failed to spawn thread to warm lazy module: {e}");
+            // Let the next call to `get` compile the module instead.
+            self.inner.finish(State::Uncompiled);
+        }
+    }
+}
+
+impl LazyModuleInner {
+    /// Compiles the module; the state must already be `State::Compiling`.
+    fn compile(&self) -> Result<Module> {
+        // If compilation panics then the state is marked as failed, rather
+        // than left as `Compiling`, so that waiting threads wake up and later
+        // calls to `get` don't block forever.
+        struct FailOnUnwind<'a>(&'a LazyModuleInner);
+        impl Drop for FailOnUnwind<'_> {
+            fn drop(&mut self) {
+                self.0
+                    .finish(State::Failed("compilation panicked".to_string()));
+            }
+        }
+        let guard = FailOnUnwind(self);
+        let result = Module::from_binary(&self.engine, &self.wasm);
+        core::mem::forget(guard);
+        self.finish(match &result {
+            Ok(module) => State::Compiled(module.clone()),
+            Err(e) => State::Failed(format!("{e:?}")),
+        });
+        result
+    }
+
+    fn finish(&self, state: State) {
+        *self.state.lock().unwrap() = state;
+        self.done.notify_all();
+    }
+}
+
+impl fmt::Debug for LazyModule {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("LazyModule")
+            .field("compiled", &self.is_compiled())
+            .finish_non_exhaustive()
+    }
+}
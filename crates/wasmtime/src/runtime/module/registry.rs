@@ -301,6 +301,17 @@ pub fn lookup_code(pc: usize) -> Option<(Arc<CodeMemory>, usize)> {
     Some((module.clone(), text_offset))
 }
 
+/// Same as `lookup_code`, but returns `None` instead of blocking if the global
+/// registry is locked, for use in asynchronous signal handlers which may have
+/// interrupted the thread while it was holding the lock.
+#[cfg(all(feature = "std", unix, has_native_signals))]
+pub fn try_lookup_code(pc: usize) -> Option<(Arc<CodeMemory>, usize)> {
+    let all_modules = global_code().try_read()?;
+    let (_end, (start, module)) = all_modules.range(pc..).next()?;
+    let text_offset = pc.checked_sub(*start)?;
+    Some((module.clone(), text_offset))
+}
+
 /// Registers a new region of code.
 ///
 /// Must not have been previously registered and must be `unregister`'d to
@@ -0,0 +1,108 @@
+//! Sharing of precompiled module code between processes, see
+//! `SharedCodeRegistry`.
+
+use crate::prelude::*;
+use crate::{Engine, Module, Precompiled};
+use core::hash::{Hash, Hasher};
+use core::sync::atomic::{AtomicU64, Ordering::Relaxed};
+use std::hash::DefaultHasher;
+use std::path::{Path, PathBuf};
+use std::{fs, io};
+
+/// A host-wide registry of precompiled modules, backed by a directory of
+/// files, which lets processes share the memory of identical modules.
+///
+/// Deserializing a module with [`Module::deserialize`] copies the artifact
+/// into memory private to the process, so every process which loads the same
+/// artifact holds its own copy of it. Instead
+/// [`SharedCodeRegistry::deserialize`] stores each distinct artifact once in
+/// the registry's directory, keyed by a hash of its contents, and maps it
+/// from there like [`Module::deserialize_file`]. Every process using the same
+/// directory therefore maps the same file, and the operating system shares
+/// the physical pages of the artifact between all of them.
+///
+/// The directory should be on a local filesystem and writable by all
+/// processes using the registry. Artifacts are named by a non-cryptographic
+/// hash, which may differ between builds of Wasmtime, so the contents of a
+/// file are always compared with the artifact before it's used.
+#[derive(Debug, Clone)]
+pub struct SharedCodeRegistry {
+    dir: PathBuf,
+}
+
+impl SharedCodeRegistry {
+    /// Creates a registry which stores artifacts in `dir`, creating the
+    /// directory if it doesn't exist.
+    pub fn new(dir: impl Into<PathBuf>) -> Result<SharedCodeRegistry> {
+        let dir = dir.into();
+        fs::create_dir_all(&dir)
+            .with_context(|| format!("failed to create directory: {}", dir.display()))?;
+        Ok(SharedCodeRegistry { dir })
+    }
+
+    /// Returns the directory that this registry stores artifacts in.
+    pub fn directory(&self) -> &Path {
+        &self.dir
+    }
+
+    /// Deserializes the precompiled module in `bytes`, mapping it from this
+    /// registry's copy of it.
+    ///
+    /// If the registry doesn't contain `bytes` yet then they're first written
+    /// to it. The contents of the registry's copy are verified to be
+    /// identical to `bytes` before the module is returned; if they aren't, for
+    /// example due to a hash collision, a private copy of `bytes` is used
+    /// instead.
+    ///
+    /// # Unsafety
+    ///
+    /// All of the reasons that [`Module::deserialize_file`] is `unsafe` apply
+    /// to this function as well. Notably the files within the registry's
+    /// directory must not be modified, other than by this method, for as
+    /// long as any module deserialized from them is alive.
+    pub unsafe fn deserialize(&self, engine: &Engine, bytes: &[u8]) -> Result<Module> {
+        // Don't store anything which isn't even shaped like a module, and
+        // let `deserialize` produce the error for it.
+        if Engine::detect_precompiled(bytes) != Some(Precompiled::Module) {
+            // SAFETY: the contract of `deserialize` is upheld by the caller.
+            return unsafe { Module::deserialize(engine, bytes) };
+        }
+
+        let mut hasher = DefaultHasher::new();
+        bytes.hash(&mut hasher);
+        let path = self.dir.join(format!("{:016x}.cwasm", hasher.finish()));
+
+        if !path.exists() {
+            self.insert(&path, bytes)
+                .with_context(|| format!("failed to write {}", path.display()))?;
+        }
+
+        // SAFETY: the contract of `deserialize_file` is upheld by the caller.
+        match unsafe { Module::deserialize_file(engine, &path) } {
+            Ok(module) if module.engine_code().image() == bytes => return Ok(module),
+            Ok(_) => log::warn!("contents of {} differ from the artifact", path.display()),
+            Err(e) => log::warn!("failed to deserialize {}: {e:?}", path.display()),
+        }
+        // SAFETY: the contract of `deserialize` is upheld by the caller.
+        unsafe { Module::deserialize(engine, bytes) }
+    }
+
+    /// Atomically creates `path` with the contents `bytes`, so that other
+    /// processes never observe a partially written file.
+    fn insert(&self, path: &Path, bytes: &[u8]) -> Result<()> {
+        static NEXT: AtomicU64 = AtomicU64::new(0);
+        let tmp = path.with_extension(format!(
+            "{}.{}.tmp",
+            std::process::id(),
+            NEXT.fetch_add(1, Relaxed)
+        ));
+        let result = fs::write(&tmp, bytes).and_then(|()| fs::hard_link(&tmp, path));
+        let _ = fs::remove_file(&tmp);
+        match result {
+            Ok(()) => Ok(()),
+            // Another process won the race to create the file.
+            Err(e) if e.kind() == io::ErrorKind::AlreadyExists => Ok(()),
+            Err(e) => Err(e.into()),
+        }
+    }
+}
@@ -0,0 +1,57 @@
+//! Caching of modules compiled for specific values of their imported
+//! immutable globals, see `Linker::instantiate_pre_specialized`.
+
+use super::ModuleInner;
+use crate::prelude::*;
+use crate::{CodeBuilder, Engine, Module};
+use alloc::sync::{Arc, Weak};
+use std::collections::HashMap;
+use std::sync::Mutex;
+use wasmtime_environ::ConstOp;
+
+/// The values of imported globals which a module is specialized for, by
+/// their module and field names.
+type SpecializedGlobals = Vec<(String, String, ConstOp)>;
+
+/// An engine's modules which have been compiled with specialized globals.
+///
+/// Modules are keyed by their wasm and the values they were specialized for,
+/// and are only held weakly so that they're freed once all their users have
+/// dropped them.
+#[derive(Default)]
+pub(crate) struct SpecializedModules {
+    modules: Mutex<HashMap<(Box<[u8]>, SpecializedGlobals), Weak<ModuleInner>>>,
+}
+
+impl SpecializedModules {
+    /// Returns `wasm` compiled with `globals`, compiling it if it isn't in
+    /// this cache.
+    pub(crate) fn get_or_compile(
+        &self,
+        engine: &Engine,
+        wasm: &[u8],
+        globals: SpecializedGlobals,
+    ) -> Result<Module> {
+        let key = (Box::from(wasm), globals);
+        if let Some(inner) = self.modules.lock().unwrap().get(&key) {
+            if let Some(inner) = inner.upgrade() {
+                return Ok(Module { inner });
+            }
+        }
+
+        // Compile without holding the lock, so that other modules can be
+        // compiled in parallel. If the same module is compiled concurrently
+        // the last one to finish is cached.
+        let mut builder = CodeBuilder::new(engine);
+        builder.wasm_binary(wasm, None)?;
+        for (module, name, value) in &key.1 {
+            builder.specialize_global(module, name, *value);
+        }
+        let module = builder.compile_module()?;
+
+        let mut modules = self.modules.lock().unwrap();
+        modules.retain(|_, inner| inner.strong_count() > 0);
+        modules.insert(key, Arc::downgrade(&module.inner));
+        Ok(module)
+    }
+}
@@ -0,0 +1,104 @@
+//! Incremental creation of modules from chunked input, see `ModuleBuilder`.
+
+use crate::prelude::*;
+use crate::{Engine, Module};
+use core::fmt;
+use wasmparser::{Chunk, Encoding, Parser, Payload, ValidPayload, Validator};
+
+/// A builder for a [`Module`] whose WebAssembly binary arrives in chunks, for
+/// example while it's being received over the network.
+///
+/// Each chunk passed to [`ModuleBuilder::feed`] is parsed as soon as it's
+/// received and the structure of the module is validated, so malformed
+/// modules are rejected without waiting for their end. Once the whole binary
+/// has been fed [`ModuleBuilder::finish`] compiles it into a [`Module`].
+/// Function bodies are only validated then, since compiling a function
+/// validates it as a part of translating it, and validating each body when
+/// it's received as well would do that work twice.
+///
+/// Note that only the binary format is supported, not the text format.
+pub struct ModuleBuilder {
+    engine: Engine,
+    wasm: Vec<u8>,
+    parsed: usize,
+    parser: Parser,
+    validator: Validator,
+    done: bool,
+}
+
+impl ModuleBuilder {
+    /// Creates a new builder for a module which will be compiled for `engine`.
+    pub fn new(engine: &Engine) -> ModuleBuilder {
+        ModuleBuilder {
+            engine: engine.clone(),
+            wasm: Vec::new(),
+            parsed: 0,
+            parser: Parser::new(0),
+            validator: Validator::new_with_features(engine.features()),
+            done: false,
+        }
+    }
+
+    /// Appends `bytes` to the WebAssembly binary being built, parsing and
+    /// validating the structure of as much of it as is now available.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the input so far is known to not be a valid
+    /// WebAssembly module, for example because it's malformed or because
+    /// bytes were fed after the end of the module. Invalid function bodies
+    /// are reported by [`ModuleBuilder::finish`] instead. Once an error has been
+    /// returned the builder should be discarded.
+    pub fn feed(&mut self, bytes: &[u8]) -> Result<()> {
+        if self.done && !bytes.is_empty() {
+            bail!("unexpected data after the end of the module");
+        }
+        self.wasm.extend_from_slice(bytes);
+        self.parse(false)
+    }
+
+    /// Finishes the module, compiling the WebAssembly binary fed to this
+    /// builder.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the input isn't a complete and valid module,
+    /// including if any function body is invalid, or if compilation fails.
+    pub fn finish(mut self) -> Result<Module> {
+        self.parse(true)?;
+        debug_assert!(self.done);
+        Module::from_binary(&self.engine, &self.wasm)
+    }
+
+    fn parse(&mut self, eof: bool) -> Result<()> {
+        while !self.done {
+            let data = &self.wasm[self.parsed..];
+            let (consumed, payload) = match self.parser.parse(data, eof)? {
+                Chunk::NeedMoreData(_) => return Ok(()),
+                Chunk::Parsed { consumed, payload } => (consumed, payload),
+            };
+            if let Payload::Version {
+                encoding: Encoding::Component,
+                ..
+            } = &payload
+            {
+                bail!("component passed to module builder");
+            }
+            // Function bodies are left to be validated while compiling.
+            if let ValidPayload::End(_) = self.validator.payload(&payload)? {
+                self.done = true;
+            }
+            self.parsed += consumed;
+        }
+        Ok(())
+    }
+}
+
+impl fmt::Debug for ModuleBuilder {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("ModuleBuilder")
+            .field("len", &self.wasm.len())
+            .field("done", &self.done)
+            .finish_non_exhaustive()
+    }
+}
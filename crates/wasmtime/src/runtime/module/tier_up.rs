@@ -0,0 +1,155 @@
+//! Background compilation of the optimized tier of modules, see
+//! `Config::tiered_compilation`.
+
+use crate::prelude::*;
+use crate::{CodeBuilder, CompileProfile, Engine, HostIntrinsic, Module};
+use alloc::sync::Arc;
+use std::panic::{self, AssertUnwindSafe};
+use std::sync::mpsc::{self, Sender};
+use std::sync::{Condvar, Mutex};
+use wasmtime_environ::ConstOp;
+
+/// State shared between a module compiled with the baseline tier and the
+/// job compiling its optimized tier.
+pub(super) struct TierUp {
+    state: Mutex<State>,
+    done: Condvar,
+}
+
+enum State {
+    Compiling,
+    Optimized(Module),
+    /// Errors aren't `Clone`, so only the message is retained for all the
+    /// callers of `Module::wait_optimized_tier`.
+    Failed(String),
+}
+
+type Job = Box<dyn FnOnce() + Send>;
+
+/// The thread which compiles the optimized tiers of all modules in this
+/// process, one at a time, along with the id of the process which spawned it.
+///
+/// A single thread bounds the number of threads that tiering creates no
+/// matter how many modules are compiled, and each compilation still uses the
+/// engine's parallel compilation for its functions. The thread isn't inherited
+/// by a child process after a `fork`, which is detected by the process id, in
+/// which case the child spawns its own.
+static WORKER: Mutex<Option<(u32, Sender<Job>)>> = Mutex::new(None);
+
+fn submit(job: Job) -> Result<()> {
+    let mut worker = WORKER.lock().unwrap();
+    let pid = std::process::id();
+    let job = match &*worker {
+        Some((owner, sender)) if *owner == pid => match sender.send(job) {
+            Ok(()) => return Ok(()),
+            Err(mpsc::SendError(job)) => job,
+        },
+        _ => job,
+    };
+    let (sender, receiver) = mpsc::channel::<Job>();
+    std::thread::Builder::new()
+        .name("wasmtime-tier-up".to_string())
+        .spawn(move || {
+            for job in receiver {
+                job();
+            }
+        })?;
+    sender.send(job).unwrap();
+    *worker = Some((pid, sender));
+    Ok(())
+}
+
+impl TierUp {
+    /// Queues compilation of `wasm` with the optimized tier's compiler,
+    /// specialized for the same globals and imports, and guided by the same
+    /// profile, as the baseline tier.
+    pub(super) fn spawn(
+        engine: &Engine,
+        wasm: Vec<u8>,
+        dwarf_package: Option<Vec<u8>>,
+        specialized_globals: Vec<(String, String, ConstOp)>,
+        inlined_imports: Vec<(String, String, HostIntrinsic)>,
+        profile: Option<CompileProfile>,
+    ) -> Arc<TierUp> {
+        let tier_up = Arc::new(TierUp {
+            state: Mutex::new(State::Compiling),
+            done: Condvar::new(),
+        });
+
+        let engine = engine.clone();
+        let shared = tier_up.clone();
+        let compile = move || -> Result<Module> {
+            engine.with_optimized_tier(|| {
+                let mut builder = CodeBuilder::new(&engine);
+                builder.wasm_binary(&wasm[..], None)?;
+                if let Some(dwarf_package) = &dwarf_package {
+                    builder.dwarf_package(dwarf_package)?;
+                }
+                for (module, name, value) in &specialized_globals {
+                    builder.specialize_global(module, name, *value);
+                }
+                for (module, name, intrinsic) in &inlined_imports {
+                    // SAFETY: the baseline tier was compiled with the same
+                    // intrinsics, which the caller promised are sound.
+                    unsafe {
+                        builder.inline_import(module, name, *intrinsic);
+                    }
+                }
+                if let Some(profile) = &profile {
+                    builder.profile(profile);
+                }
+                builder.compile_module()
+            })
+        };
+        let job = Box::new(move || {
+            // If the baseline module was dropped in the meantime then there's
+            // no one to hand the optimized tier to.
+            if Arc::strong_count(&shared) == 1 {
+                return;
+            }
+            // Catch panics so that the worker survives them and waiters are
+            // woken up.
+            let result = panic::catch_unwind(AssertUnwindSafe(compile))
+                .unwrap_or_else(|_| Err(format_err!("compilation panicked")));
+            shared.finish(result);
+        });
+        if let Err(e) = submit(job) {
+            tier_up.finish(Err(
+                e.context("failed to spawn thread for tiered compilation")
+            ));
+        }
+        tier_up
+    }
+
+    fn finish(&self, result: Result<Module>) {
+        let state = match result {
+            Ok(module) => State::Optimized(module),
+            Err(e) => {
+                log::warn!("failed to compile optimized tier: {e:?}");
+                State::Failed(format!("{e:?}"))
+            }
+        };
+        *self.state.lock().unwrap() = state;
+        self.done.notify_all();
+    }
+
+    /// Returns the optimized module if it has finished compiling.
+    pub(super) fn get(&self) -> Option<Module> {
+        match &*self.state.lock().unwrap() {
+            State::Optimized(module) => Some(module.clone()),
+            State::Compiling | State::Failed(_) => None,
+        }
+    }
+
+    /// Blocks until the optimized tier has finished compiling.
+    pub(super) fn wait(&self) -> Result<Module> {
+        let mut state = self.state.lock().unwrap();
+        loop {
+            match &*state {
+                State::Compiling => state = self.done.wait(state).unwrap(),
+                State::Optimized(module) => return Ok(module.clone()),
+                State::Failed(msg) => bail!("failed to compile optimized tier: {msg}"),
+            }
+        }
+    }
+}
@@ -15,6 +15,9 @@ use std::sync::Arc;
 use std::time::{Duration, Instant};
 use wasmtime_environ::demangle_function_name_or_index;
 
+mod aggregate;
+pub use aggregate::{AggregateGuestProfiler, ProfileFormat};
+
 // TODO: collect more data
 // - On non-Windows, measure thread-local CPU usage between events with
 //   rustix::time::clock_gettime(ClockId::ThreadCPUTime)
@@ -131,18 +134,7 @@ impl GuestProfiler {
             .into_iter()
             .filter_map(|(name, module)| {
                 assert!(Engine::same(module.engine(), engine));
-                let compiled = module.compiled_module();
-                let text_range = {
-                    // Assumption: within text, the code for a given module is packed linearly and
-                    // is non-overlapping; if this is violated, it should be safe but might result
-                    // in incorrect profiling results.
-                    let start = compiled.finished_function_ranges().next()?.1.start;
-                    let end = compiled.finished_function_ranges().last()?.1.end;
-
-                    let start = (module.engine_code().text_range().start + start).raw();
-                    let end = (module.engine_code().text_range().start + end).raw();
-                    start..end
-                };
+                let text_range = module_text_range(&module)?;
 
                 module_symbols(name, &module).map(|lib| {
                     let libhandle = profile.add_lib(lib);
@@ -261,6 +253,21 @@ impl GuestProfiler {
     }
 }
 
+/// Returns the range of addresses of the functions defined in `module`, or
+/// `None` if it doesn't define any.
+fn module_text_range(module: &Module) -> Option<Range<usize>> {
+    // Assumption: within text, the code for a given module is packed linearly and
+    // is non-overlapping; if this is violated, it should be safe but might result
+    // in incorrect profiling results.
+    let compiled = module.compiled_module();
+    let start = compiled.finished_function_ranges().next()?.1.start;
+    let end = compiled.finished_function_ranges().last()?.1.end;
+
+    let start = (module.engine_code().text_range().start + start).raw();
+    let end = (module.engine_code().text_range().start + end).raw();
+    Some(start..end)
+}
+
 fn module_symbols(name: String, module: &Module) -> Option<LibraryInfo> {
     let compiled = module.compiled_module();
     let symbols = Vec::from_iter(
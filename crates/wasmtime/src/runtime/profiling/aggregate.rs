@@ -0,0 +1,399 @@
+use super::module_text_range;
+use crate::prelude::*;
+use crate::runtime::vm::Backtrace;
+use crate::{AsContext, Engine, Module};
+use core::cmp::Ordering;
+use std::collections::HashMap;
+use std::io::Write;
+use std::ops::Range;
+use std::time::{Duration, Instant};
+use wasmtime_environ::{DefinedFuncIndex, demangle_function_name_or_index};
+
+/// The maximum number of frames recorded for each sample. Deeper stacks keep
+/// their innermost frames.
+const MAX_DEPTH: usize = 128;
+
+/// Collects profiling data for WebAssembly guests as a count of samples per
+/// distinct stack.
+///
+/// Unlike [`GuestProfiler`](crate::GuestProfiler), which records every sample
+/// with its timestamp, this profiler only keeps one entry per distinct stack,
+/// and at most a fixed number of those, so its memory usage is bounded no
+/// matter how long it runs. That makes it suitable for leaving on in
+/// production: call [`AggregateGuestProfiler::sample`] from an epoch deadline
+/// callback as with `GuestProfiler`, and periodically write out the profile
+/// with [`AggregateGuestProfiler::flush`].
+///
+/// Samples of stacks seen after the limit on distinct stacks is reached are
+/// still counted, but in a single `[truncated]` stack.
+///
+/// The "Security" section of the [`GuestProfiler`](crate::GuestProfiler)
+/// documentation applies to this profiler too, except that these profiles
+/// don't include offsets into the compiled code.
+#[derive(Debug)]
+pub struct AggregateGuestProfiler {
+    modules: Vec<AggregateModule>,
+    interval: Duration,
+    max_stacks: usize,
+    stacks: HashMap<Box<[StackFrame]>, Weight>,
+    truncated: Weight,
+    start: Instant,
+    scratch: Vec<StackFrame>,
+}
+
+#[derive(Debug)]
+struct AggregateModule {
+    name: String,
+    module: Module,
+    text_range: Range<usize>,
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Hash)]
+struct StackFrame {
+    module: u32,
+    func: DefinedFuncIndex,
+}
+
+#[derive(Debug, Default, Clone, Copy)]
+struct Weight {
+    samples: u64,
+    nanos: u64,
+}
+
+impl Weight {
+    fn add(&mut self, delta: Duration) {
+        self.samples += 1;
+        self.nanos = self
+            .nanos
+            .saturating_add(u64::try_from(delta.as_nanos()).unwrap_or(u64::MAX));
+    }
+}
+
+/// The formats an [`AggregateGuestProfiler`] can write its profile in.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum ProfileFormat {
+    /// An uncompressed protobuf in the [pprof] format, with a sample count and
+    /// a CPU time in nanoseconds for each stack.
+    ///
+    /// [pprof]: https://github.com/google/pprof/blob/main/proto/profile.proto
+    Pprof,
+    /// One line per stack with its `;`-separated frames, outermost first,
+    /// followed by its sample count, as consumed by `flamegraph.pl` and
+    /// `inferno`.
+    Collapsed,
+}
+
+impl AggregateGuestProfiler {
+    /// Begin profiling guests, recording at most `max_stacks` distinct stacks.
+    ///
+    /// The `interval` parameter should match the rate at which you intend to
+    /// call `sample`, and is recorded in the profile as the sampling period.
+    ///
+    /// Only modules which are present in the `modules` vector will appear in
+    /// stack traces, as with [`GuestProfiler::new`](crate::GuestProfiler::new).
+    pub fn new(
+        engine: &Engine,
+        interval: Duration,
+        max_stacks: usize,
+        modules: impl IntoIterator<Item = (String, Module)>,
+    ) -> Result<Self> {
+        if engine.tunables().debug_guest {
+            crate::bail!("Profiling cannot be performed when guest-debugging is enabled.");
+        }
+
+        let mut modules: Vec<_> = modules
+            .into_iter()
+            .filter_map(|(name, module)| {
+                assert!(Engine::same(module.engine(), engine));
+                let text_range = module_text_range(&module)?;
+                Some(AggregateModule {
+                    name,
+                    module,
+                    text_range,
+                })
+            })
+            .collect();
+        modules.sort_unstable_by_key(|m| m.text_range.start);
+
+        Ok(Self {
+            modules,
+            interval,
+            max_stacks,
+            stacks: HashMap::new(),
+            truncated: Weight::default(),
+            start: Instant::now(),
+            scratch: Vec::new(),
+        })
+    }
+
+    /// Begin profiling the modules of `component`, and of `extra_modules`.
+    ///
+    /// See [`AggregateGuestProfiler::new`] for more information.
+    #[cfg(feature = "component-model")]
+    pub fn new_component(
+        engine: &Engine,
+        interval: Duration,
+        max_stacks: usize,
+        component: crate::component::Component,
+        extra_modules: impl IntoIterator<Item = (String, Module)>,
+    ) -> Result<Self> {
+        let modules = component
+            .static_modules()
+            .map(|m| (m.name().unwrap_or("<unknown>").to_string(), m.clone()))
+            .chain(extra_modules);
+        Self::new(engine, interval, max_stacks, modules)
+    }
+
+    /// Add a sample of the current stack of `store` to the profile, where
+    /// `delta` is the CPU time used by the guest since its previous sample.
+    ///
+    /// `Duration::ZERO` may be passed as `delta` if CPU time isn't needed.
+    pub fn sample(&mut self, store: impl AsContext, delta: Duration) {
+        let backtrace = Backtrace::new(store.as_context().0);
+        self.scratch.clear();
+        for frame in backtrace.frames() {
+            if self.scratch.len() == MAX_DEPTH {
+                break;
+            }
+            if let Some(frame) = self.lookup(frame.pc()) {
+                self.scratch.push(frame);
+            }
+        }
+        // Frames are listed innermost first, but stacks are stored outermost
+        // first.
+        self.scratch.reverse();
+
+        if let Some(weight) = self.stacks.get_mut(&self.scratch[..]) {
+            weight.add(delta);
+        } else if self.stacks.len() < self.max_stacks {
+            let mut weight = Weight::default();
+            weight.add(delta);
+            self.stacks.insert(self.scratch.as_slice().into(), weight);
+        } else {
+            self.truncated.add(delta);
+        }
+    }
+
+    fn lookup(&self, pc: usize) -> Option<StackFrame> {
+        let idx = self
+            .modules
+            .binary_search_by(|probe| {
+                if probe.text_range.contains(&pc) {
+                    Ordering::Equal
+                } else {
+                    probe.text_range.start.cmp(&pc)
+                }
+            })
+            .ok()?;
+        let module = &self.modules[idx].module;
+        let text_offset = pc - module.engine_code().text_range().start.raw();
+        let func = module.compiled_module().func_by_text_offset(text_offset)?;
+        Some(StackFrame {
+            module: u32::try_from(idx).unwrap(),
+            func,
+        })
+    }
+
+    /// Returns the number of distinct stacks recorded since the profiler was
+    /// created or last flushed.
+    pub fn stacks(&self) -> usize {
+        self.stacks.len()
+    }
+
+    /// Writes out the samples recorded since the profiler was created or last
+    /// flushed in the given `format`, and then discards them.
+    ///
+    /// This can be called periodically to keep a continuous profile.
+    pub fn flush(&mut self, format: ProfileFormat, output: impl Write) -> Result<()> {
+        let result = match format {
+            ProfileFormat::Pprof => self.write_pprof(output),
+            ProfileFormat::Collapsed => self.write_collapsed(output),
+        };
+        self.stacks.clear();
+        self.truncated = Weight::default();
+        self.start = Instant::now();
+        result
+    }
+
+    fn func_name(&self, frame: StackFrame) -> String {
+        let module = &self.modules[frame.module as usize];
+        let compiled = module.module.compiled_module();
+        let func_idx = compiled.module().func_index(frame.func);
+        let mut name = format!("{}!", module.name);
+        demangle_function_name_or_index(
+            &mut name,
+            compiled.func_name(func_idx),
+            frame.func.as_u32() as usize,
+        )
+        .unwrap();
+        name
+    }
+
+    /// Returns the recorded stacks, other than the truncated stack, in a
+    /// deterministic order.
+    fn sorted_stacks(&self) -> Vec<(&[StackFrame], Weight)> {
+        let mut stacks: Vec<_> = self.stacks.iter().map(|(k, v)| (&k[..], *v)).collect();
+        stacks.sort_unstable_by(|a, b| a.0.cmp(b.0));
+        stacks
+    }
+
+    fn write_collapsed(&self, mut output: impl Write) -> Result<()> {
+        let mut names = HashMap::new();
+        for (stack, weight) in self.sorted_stacks() {
+            let mut line = String::new();
+            for frame in stack {
+                if !line.is_empty() {
+                    line.push(';');
+                }
+                line.push_str(
+                    names
+                        .entry(*frame)
+                        .or_insert_with(|| self.func_name(*frame)),
+                );
+            }
+            if line.is_empty() {
+                line.push_str("[unknown]");
+            }
+            writeln!(output, "{line} {}", weight.samples)?;
+        }
+        if self.truncated.samples > 0 {
+            writeln!(output, "[truncated] {}", self.truncated.samples)?;
+        }
+        Ok(())
+    }
+
+    fn write_pprof(&self, mut output: impl Write) -> Result<()> {
+        let mut profile = Pprof::default();
+        let samples = profile.string("samples");
+        let count = profile.string("count");
+        let cpu = profile.string("cpu");
+        let nanoseconds = profile.string("nanoseconds");
+        profile.value_type(1, samples, count);
+        profile.value_type(1, cpu, nanoseconds);
+
+        // Each function has a single location, with the same id.
+        let mut ids = HashMap::new();
+        let mut locations = Vec::new();
+        for (stack, weight) in self.sorted_stacks() {
+            locations.clear();
+            for frame in stack.iter().rev() {
+                let id = match ids.get(frame) {
+                    Some(id) => *id,
+                    None => {
+                        let id = ids.len() as u64 + 1;
+                        let name = profile.string(&self.func_name(*frame));
+                        profile.function(id, name);
+                        ids.insert(*frame, id);
+                        id
+                    }
+                };
+                locations.push(id);
+            }
+            profile.sample(&locations, weight);
+        }
+        if self.truncated.samples > 0 {
+            let id = ids.len() as u64 + 1;
+            let name = profile.string("[truncated]");
+            profile.function(id, name);
+            profile.sample(&[id], self.truncated);
+        }
+
+        let duration = u64::try_from(self.start.elapsed().as_nanos()).unwrap_or(u64::MAX);
+        let period = u64::try_from(self.interval.as_nanos()).unwrap_or(u64::MAX);
+        profile.value_type(11, cpu, nanoseconds);
+        profile.varint_field(10, duration);
+        profile.varint_field(12, period);
+        output.write_all(&profile.finish())?;
+        Ok(())
+    }
+}
+
+/// A minimal encoder of the `Profile` message of pprof's `profile.proto`.
+#[derive(Default)]
+struct Pprof {
+    buf: Vec<u8>,
+    strings: HashMap<String, u64>,
+    string_table: Vec<u8>,
+}
+
+impl Pprof {
+    fn varint(buf: &mut Vec<u8>, mut value: u64) {
+        while value >= 0x80 {
+            buf.push((value as u8) | 0x80);
+            value >>= 7;
+        }
+        buf.push(value as u8);
+    }
+
+    fn field(buf: &mut Vec<u8>, field: u64, value: u64) {
+        Self::varint(buf, field << 3);
+        Self::varint(buf, value);
+    }
+
+    fn bytes(buf: &mut Vec<u8>, field: u64, bytes: &[u8]) {
+        Self::varint(buf, (field << 3) | 2);
+        Self::varint(buf, bytes.len() as u64);
+        buf.extend_from_slice(bytes);
+    }
+
+    fn varint_field(&mut self, field: u64, value: u64) {
+        Self::field(&mut self.buf, field, value);
+    }
+
+    /// Returns the index of `s` in the string table, which always begins with
+    /// the empty string.
+    fn string(&mut self, s: &str) -> u64 {
+        if self.strings.is_empty() {
+            self.strings.insert(String::new(), 0);
+            Self::bytes(&mut self.string_table, 6, b"");
+        }
+        if let Some(idx) = self.strings.get(s) {
+            return *idx;
+        }
+        let idx = self.strings.len() as u64;
+        self.strings.insert(s.to_string(), idx);
+        Self::bytes(&mut self.string_table, 6, s.as_bytes());
+        idx
+    }
+
+    fn value_type(&mut self, field: u64, ty: u64, unit: u64) {
+        let mut msg = Vec::new();
+        Self::field(&mut msg, 1, ty);
+        Self::field(&mut msg, 2, unit);
+        Self::bytes(&mut self.buf, field, &msg);
+    }
+
+    fn function(&mut self, id: u64, name: u64) {
+        let mut function = Vec::new();
+        Self::field(&mut function, 1, id);
+        Self::field(&mut function, 2, name);
+        Self::field(&mut function, 3, name);
+        Self::bytes(&mut self.buf, 5, &function);
+
+        let mut line = Vec::new();
+        Self::field(&mut line, 1, id);
+        let mut location = Vec::new();
+        Self::field(&mut location, 1, id);
+        Self::bytes(&mut location, 4, &line);
+        Self::bytes(&mut self.buf, 4, &location);
+    }
+
+    fn sample(&mut self, locations: &[u64], weight: Weight) {
+        let mut ids = Vec::new();
+        for id in locations {
+            Self::varint(&mut ids, *id);
+        }
+        let mut values = Vec::new();
+        Self::varint(&mut values, weight.samples);
+        Self::varint(&mut values, weight.nanos);
+        let mut sample = Vec::new();
+        Self::bytes(&mut sample, 1, &ids);
+        Self::bytes(&mut sample, 2, &values);
+        Self::bytes(&mut self.buf, 2, &sample);
+    }
+
+    fn finish(mut self) -> Vec<u8> {
+        self.buf.extend_from_slice(&self.string_table);
+        self.buf
+    }
+}
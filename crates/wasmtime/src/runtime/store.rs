@@ -97,9 +97,9 @@ use crate::runtime::vm::VMContRef;
 use crate::runtime::vm::mpk::ProtectionKey;
 use crate::runtime::vm::{
     self, ExportMemory, GcStore, Imports, InstanceAllocationRequest, InstanceAllocator,
-    InstanceHandle, Interpreter, InterpreterRef, ModuleRuntimeInfo, OnDemandInstanceAllocator,
-    SendSyncPtr, SignalHandler, StoreBox, Unwind, VMContext, VMFuncRef, VMGcRef, VMStore,
-    VMStoreContext,
+    InstanceHandle, Interpreter, InterpreterRef, ModuleMemoryImages, ModuleRuntimeInfo,
+    OnDemandInstanceAllocator, SendSyncPtr, SignalHandler, StoreBox, Unwind, VMContext, VMFuncRef,
+    VMGcRef, VMStore, VMStoreContext,
 };
 use crate::trampoline::VMHostGlobalContext;
 #[cfg(feature = "debug")]
@@ -107,7 +107,7 @@ use crate::{BreakpointState, DebugHandler};
 use crate::{Engine, Module, Val, ValRaw, module::ModuleRegistry};
 #[cfg(feature = "gc")]
 use crate::{ExnRef, Rooted};
-use crate::{Global, Instance, Table};
+use crate::{Global, Instance, ResourceCounts, Table};
 use core::convert::Infallible;
 use core::fmt;
 use core::marker;
@@ -116,6 +116,8 @@ use core::num::NonZeroU64;
 use core::ops::{Deref, DerefMut};
 use core::pin::Pin;
 use core::ptr::NonNull;
+#[cfg(all(feature = "std", unix, has_native_signals))]
+use std::sync::Arc;
 use wasmtime_environ::{DefinedGlobalIndex, DefinedTableIndex, EntityRef, PrimaryMap, TripleExt};
 
 mod context;
@@ -132,11 +134,39 @@ pub(crate) use token::StoreToken;
 mod async_;
 #[cfg(all(feature = "async", feature = "call-hook"))]
 pub use self::async_::CallHookHandler;
+#[cfg(all(feature = "call-hook", feature = "std"))]
+mod transitions;
+#[cfg(all(feature = "call-hook", feature = "std"))]
+pub use self::transitions::CallTransition;
+#[cfg(all(feature = "call-hook", feature = "std"))]
+use self::transitions::CallTransitions;
+#[cfg(feature = "std")]
+mod cpu;
+#[cfg(all(feature = "std", unix, has_native_signals))]
+use self::cpu::CpuAccounting;
+#[cfg(feature = "std")]
+pub use self::cpu::CpuUsage;
+#[cfg(feature = "std")]
+mod entered;
+#[cfg(feature = "std")]
+use self::entered::Entered;
+mod hibernate;
+use self::hibernate::Hibernation;
+#[cfg(all(feature = "std", unix, has_native_signals))]
+mod interrupt;
+#[cfg(all(feature = "std", unix, has_native_signals))]
+pub use self::interrupt::InterruptHandle;
+#[cfg(all(feature = "std", unix, has_native_signals))]
+pub(crate) use self::interrupt::InterruptState;
+#[cfg(feature = "rr")]
+pub(crate) mod rr;
 
 #[cfg(feature = "gc")]
 use super::vm::VMExnRef;
 #[cfg(feature = "gc")]
 mod gc;
+#[cfg(feature = "gc")]
+pub use self::gc::GcStats;
 
 /// A [`Store`] is a collection of WebAssembly instances and host-defined state.
 ///
@@ -207,7 +237,7 @@ pub struct Store<T: 'static> {
     inner: ManuallyDrop<Box<StoreInner<T>>>,
 }
 
-#[derive(Copy, Clone, Debug)]
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
 /// Passed to the argument of [`Store::call_hook`] to indicate a state transition in
 /// the WebAssembly VM.
 pub enum CallHook {
@@ -381,6 +411,8 @@ enum CallHookInner<T: 'static> {
     Sync(Box<dyn FnMut(StoreContextMut<'_, T>, CallHook) -> Result<()> + Send + Sync>),
     #[cfg(all(feature = "async", feature = "call-hook"))]
     Async(Box<dyn CallHookHandler<T> + Send + Sync>),
+    #[cfg(all(feature = "call-hook", feature = "std"))]
+    Record(CallTransitions),
     #[expect(
         dead_code,
         reason = "forcing, regardless of cfg, the type param to be used"
@@ -482,6 +514,21 @@ pub struct StoreOpaque {
     #[cfg(feature = "component-model")]
     num_component_instances: usize,
     signal_handler: Option<SignalHandler>,
+    /// Present when `Config::signal_interruption` is enabled.
+    #[cfg(all(feature = "std", unix, has_native_signals))]
+    interrupt: Option<Arc<InterruptState>>,
+    /// Present once `Store::enable_cpu_accounting` is called.
+    #[cfg(all(feature = "std", unix, has_native_signals))]
+    cpu_accounting: Option<Box<CpuAccounting>>,
+    /// Present while the store is entered, see `Store::enter`.
+    #[cfg(feature = "std")]
+    entered: Option<Box<Entered>>,
+    /// Present while the store is hibernating, see `Store::hibernate`.
+    hibernation: Option<Box<Hibernation>>,
+    /// Present while host calls are recorded or replayed, see
+    /// `Store::record_host_calls`.
+    #[cfg(feature = "rr")]
+    host_call_log: Option<Box<rr::HostCallLog>>,
     modules: ModuleRegistry,
     func_refs: FuncRefs,
     host_globals: PrimaryMap<DefinedGlobalIndex, StoreBox<VMHostGlobalContext>>,
@@ -490,6 +537,8 @@ pub struct StoreOpaque {
     gc_roots: RootSet,
     #[cfg(feature = "gc")]
     gc_roots_list: GcRootsList,
+    #[cfg(feature = "gc")]
+    gc_stats: GcStats,
     // Types for which the embedder has created an allocator for.
     #[cfg(feature = "gc")]
     gc_host_alloc_types: crate::hash_set::HashSet<crate::type_registry::RegisteredType>,
@@ -521,6 +570,8 @@ pub struct StoreOpaque {
     // until the reserve is empty.
     fuel_reserve: u64,
     pub(crate) fuel_yield_interval: Option<NonZeroU64>,
+    #[cfg(all(feature = "async", feature = "std"))]
+    fuel_yield_tuner: Option<async_::FuelYieldTuner>,
     /// Indexed data within this `Store`, used to store information about
     /// globals, functions, memories, etc.
     store_data: StoreData,
@@ -540,6 +591,18 @@ pub struct StoreOpaque {
     /// guest code.
     pkey: Option<ProtectionKey>,
 
+    /// Embedder-provided key used by the pooling allocator to prefer slots
+    /// last used with the same key, see `Store::set_pooling_affinity`.
+    pooling_affinity: Option<u64>,
+
+    /// NUMA node that linear memories of this store are placed on, see
+    /// `Store::set_numa_node`.
+    numa_node: Option<u32>,
+
+    /// Whether backtraces are captured when wasm traps, see
+    /// `Store::set_wasm_backtrace`.
+    wasm_backtrace: bool,
+
     /// Runtime state for components used in the handling of resources, borrow,
     /// and calls. These also interact with the `ResourceAny` type and its
     /// internal representation.
@@ -750,11 +813,25 @@ impl<T> Store<T> {
             #[cfg(feature = "component-model")]
             num_component_instances: 0,
             signal_handler: None,
+            #[cfg(all(feature = "std", unix, has_native_signals))]
+            interrupt: engine
+                .config()
+                .signal_interruption
+                .then(|| Arc::new(InterruptState::new())),
+            #[cfg(all(feature = "std", unix, has_native_signals))]
+            cpu_accounting: None,
+            #[cfg(feature = "std")]
+            entered: None,
+            hibernation: None,
+            #[cfg(feature = "rr")]
+            host_call_log: None,
             gc_store: None,
             gc_roots: RootSet::default(),
             #[cfg(feature = "gc")]
             gc_roots_list: GcRootsList::default(),
             #[cfg(feature = "gc")]
+            gc_stats: GcStats::default(),
+            #[cfg(feature = "gc")]
             gc_host_alloc_types: Default::default(),
             #[cfg(feature = "gc")]
             pending_exception: None,
@@ -771,12 +848,17 @@ impl<T> Store<T> {
             async_state: Default::default(),
             fuel_reserve: 0,
             fuel_yield_interval: None,
+            #[cfg(all(feature = "async", feature = "std"))]
+            fuel_yield_tuner: None,
             store_data,
             traitobj: StorePtr(None),
             default_caller_vmctx: SendSyncPtr::new(NonNull::dangling()),
             hostcall_val_storage: Vec::new(),
             wasm_val_raw_storage: Vec::new(),
             pkey,
+            pooling_affinity: None,
+            numa_node: None,
+            wasm_backtrace: engine.config().wasm_backtrace,
             #[cfg(feature = "component-model")]
             component_host_table: Default::default(),
             #[cfg(feature = "component-model")]
@@ -814,6 +896,11 @@ impl<T> Store<T> {
         let store_data =
             <NonNull<ManuallyDrop<T>>>::from(&mut inner.data_no_provenance).cast::<()>();
         inner.inner.vm_store_context.store_data = store_data.into();
+        *inner
+            .inner
+            .vm_store_context
+            .memory_access_countdown
+            .get_mut() = engine.tunables().memory_access_sample_interval as usize;
 
         inner.traitobj = StorePtr(Some(NonNull::from(&mut *inner)));
 
@@ -1021,6 +1108,37 @@ impl<T> Store<T> {
         self.inner.call_hook = Some(CallHookInner::Sync(Box::new(hook)));
     }
 
+    /// Records the transitions between WebAssembly and host code in this
+    /// store, keeping the most recent `capacity` of them.
+    ///
+    /// This is a cheaper alternative to [`Store::call_hook`] for tracing: each
+    /// transition only appends a [`CallTransition`] with its kind and a
+    /// timestamp to a ring buffer, which is allocated up front, rather than
+    /// calling a function. Transitions are retrieved with
+    /// [`Store::take_call_transitions`], for example after each call into
+    /// WebAssembly, and the oldest are overwritten if they aren't retrieved
+    /// before the buffer is full.
+    ///
+    /// This replaces any call hook configured for this store, and is replaced
+    /// by configuring one.
+    #[cfg(all(feature = "call-hook", feature = "std"))]
+    pub fn record_call_transitions(&mut self, capacity: usize) {
+        self.inner.call_hook = Some(CallHookInner::Record(CallTransitions::new(capacity)));
+    }
+
+    /// Returns the transitions recorded since the last call to this method,
+    /// oldest first, along with the number of transitions which were
+    /// overwritten in that time.
+    ///
+    /// Returns nothing if [`Store::record_call_transitions`] isn't enabled.
+    #[cfg(all(feature = "call-hook", feature = "std"))]
+    pub fn take_call_transitions(&mut self) -> (Vec<CallTransition>, u64) {
+        match &mut self.inner.call_hook {
+            Some(CallHookInner::Record(transitions)) => transitions.take(),
+            _ => (Vec::new(), 0),
+        }
+    }
+
     /// Returns the [`Engine`] that this store is associated with.
     pub fn engine(&self) -> &Engine {
         self.inner.engine()
@@ -1048,6 +1166,16 @@ impl<T> Store<T> {
         StoreContextMut(&mut self.inner).gc(why)
     }
 
+    /// Returns statistics about the garbage collections performed within this
+    /// store and the current size of its GC heap.
+    ///
+    /// The counters are maintained as collections happen, so this is a cheap
+    /// O(1) operation.
+    #[cfg(feature = "gc")]
+    pub fn gc_stats(&self) -> GcStats {
+        self.inner.gc_stats()
+    }
+
     /// Returns the amount fuel in this [`Store`]. When fuel is enabled, it must
     /// be configured via [`Store::set_fuel`].
     ///
@@ -1082,6 +1210,84 @@ impl<T> Store<T> {
         self.inner.set_fuel(fuel)
     }
 
+    /// Returns the number of instances, memories, and tables that have been
+    /// created within this [`Store`].
+    ///
+    /// These counts are maintained as resources are created, so this is a
+    /// cheap O(1) operation. They're the same counts checked against the
+    /// limits of a [`ResourceLimiter`](crate::ResourceLimiter) configured with
+    /// [`Store::limiter`].
+    pub fn resource_counts(&self) -> ResourceCounts {
+        self.inner.resource_counts()
+    }
+
+    /// Configures a key used by the pooling allocator to pick slots for
+    /// linear memories allocated within this [`Store`].
+    ///
+    /// When a module is instantiated the
+    /// [pooling allocator](crate::InstanceAllocationStrategy::Pooling) already
+    /// prefers slots that were previously used by the same module, since
+    /// those may already have the module's memory image mapped. With an
+    /// affinity key configured it will additionally prefer, among those slots,
+    /// the one most recently used by a store with the same key. Embedders can
+    /// use a key per tenant, for example, to make it more likely that a
+    /// tenant's requests reuse pages which are still resident from its
+    /// previous request.
+    ///
+    /// This is only a hint and never causes an allocation to fail. It has no
+    /// effect with other allocation strategies. Passing `None` clears the key.
+    pub fn set_pooling_affinity(&mut self, key: Option<u64>) {
+        self.inner.set_pooling_affinity(key);
+    }
+
+    /// Returns the key configured with [`Store::set_pooling_affinity`].
+    pub fn pooling_affinity(&self) -> Option<u64> {
+        self.inner.pooling_affinity()
+    }
+
+    /// Configures whether a [`WasmBacktrace`](crate::WasmBacktrace) is
+    /// captured when WebAssembly in this store traps or returns an error.
+    ///
+    /// This defaults to the engine's
+    /// [`Config::wasm_backtrace`](crate::Config::wasm_backtrace) setting.
+    /// Disabling it avoids walking the stack on every trap, which is
+    /// worthwhile for guests that use traps for control flow such as
+    /// timeouts or aborts. Captured backtraces only record which function
+    /// each frame is in; debug information is consulted the first time a
+    /// frame's [`symbols`](crate::FrameInfo::symbols) are requested.
+    pub fn set_wasm_backtrace(&mut self, enable: bool) {
+        self.inner.set_wasm_backtrace(enable);
+    }
+
+    /// Configures the NUMA node that linear memories allocated within this
+    /// [`Store`] are placed on.
+    ///
+    /// On hosts with several NUMA nodes, memory which is on a different node
+    /// than the CPU accessing it is slower to access. Embedders which run
+    /// each store on threads pinned to one node can use this to keep the
+    /// store's linear memories on that node as well. Memories allocated by
+    /// instantiation after this call have their pages placed on `node`, and
+    /// with the [pooling allocator](crate::InstanceAllocationStrategy::Pooling)
+    /// pages which are still resident from a slot's previous use are migrated
+    /// to it. See also
+    /// [`PoolingAllocationConfig::numa_local_memory`](crate::PoolingAllocationConfig::numa_local_memory)
+    /// to place memories on the node of the allocating thread instead.
+    ///
+    /// Placement is only a preference, so memory is still allocated on other
+    /// nodes if `node` is out of memory, and this never causes an allocation
+    /// to fail. Memories which have already been allocated, and shared
+    /// memories, aren't affected. NUMA placement is currently only supported
+    /// on Linux, and this has no effect elsewhere. Passing `None` clears the
+    /// node.
+    pub fn set_numa_node(&mut self, node: Option<u32>) {
+        self.inner.set_numa_node(node);
+    }
+
+    /// Returns the node configured with [`Store::set_numa_node`].
+    pub fn numa_node(&self) -> Option<u32> {
+        self.inner.numa_node()
+    }
+
     /// Configures a [`Store`] to yield execution of async WebAssembly code
     /// periodically.
     ///
@@ -1212,6 +1418,239 @@ impl<T> Store<T> {
         self.inner.epoch_deadline_callback(Box::new(callback));
     }
 
+    /// Returns a handle with which the WebAssembly running in this store can
+    /// be interrupted from another thread.
+    ///
+    /// Returns an error if
+    /// [`Config::signal_interruption`](crate::Config::signal_interruption)
+    /// isn't enabled.
+    #[cfg(all(feature = "std", unix, has_native_signals))]
+    pub fn interrupt_handle(&self) -> Result<InterruptHandle> {
+        match self.inner.interrupt_state() {
+            Some(state) => Ok(InterruptHandle::new(state.clone())),
+            None => bail!("signal-based interruption is not enabled for this store's engine"),
+        }
+    }
+
+    /// Starts measuring the CPU used by WebAssembly executing in this store,
+    /// as reported by [`Store::cpu_usage`].
+    ///
+    /// Unlike [fuel](crate::Config::consume_fuel) this doesn't instrument the
+    /// generated code. Instead the CPU time and, on Linux, the number of
+    /// instructions retired by the current thread are read from the operating
+    /// system each time that the host calls into WebAssembly in this store,
+    /// and again once that call returns. The usage of host functions called
+    /// by WebAssembly is therefore included in these. Calls made on async
+    /// fibers aren't included, since the fiber may move between threads.
+    ///
+    /// The CPU time spent in WebAssembly itself is additionally measured in
+    /// [`CpuUsage::guest_cpu_time`] by reading the thread's CPU time at each
+    /// transition between WebAssembly and the host, and whenever an async
+    /// call is suspended and resumed. This includes calls made on async
+    /// fibers, and is suited to fair-share scheduling and billing of guests.
+    ///
+    /// Reading the counters takes a system call each, which is negligible
+    /// unless calls between WebAssembly and the host are very short.
+    ///
+    /// Instructions are counted with a `perf_event` counter per thread, which
+    /// requires hardware performance counters to be available and permitted
+    /// by `/proc/sys/kernel/perf_event_paranoid`. If they aren't then only
+    /// CPU times are reported.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if CPU accounting isn't supported on this platform,
+    /// which is currently the case everywhere but Unix.
+    #[cfg(feature = "std")]
+    pub fn enable_cpu_accounting(&mut self) -> Result<()> {
+        self.inner.enable_cpu_accounting()
+    }
+
+    /// Returns the CPU used by WebAssembly executing in this store so far, or
+    /// `None` if [`Store::enable_cpu_accounting`] wasn't called.
+    ///
+    /// Calls into WebAssembly which are still in progress aren't included.
+    #[cfg(feature = "std")]
+    pub fn cpu_usage(&self) -> Option<CpuUsage> {
+        self.inner.cpu_usage()
+    }
+
+    /// Limits the number of further instructions that WebAssembly may retire
+    /// in this store, after which it's interrupted with
+    /// [`Trap::Interrupt`](crate::Trap::Interrupt), or removes the limit if
+    /// `budget` is `None`.
+    ///
+    /// This is a cheaper alternative to [fuel](crate::Config::consume_fuel)
+    /// for limiting the CPU used by WebAssembly, without any instrumentation
+    /// of the generated code. The thread's instruction counter is configured
+    /// to send the interruption signal of
+    /// [`Config::signal_interruption`](crate::Config::signal_interruption)
+    /// when the budget runs out, so execution stops within a few instructions
+    /// of it, as determined by the hardware, rather than deterministically.
+    /// The budget takes effect the next time that the host calls into
+    /// WebAssembly.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if [`Store::enable_cpu_accounting`] wasn't called,
+    /// if instructions can't be counted, or if signal-based interruption
+    /// isn't enabled.
+    #[cfg(feature = "std")]
+    pub fn set_instruction_budget(&mut self, budget: Option<u64>) -> Result<()> {
+        self.inner.set_instruction_budget(budget)
+    }
+
+    /// Sets up the state of calls into WebAssembly once for all the calls
+    /// made on this thread until the matching [`Store::exit`].
+    ///
+    /// Each call from the host into WebAssembly computes the stack limit for
+    /// WebAssembly from the current stack pointer, registers itself with the
+    /// engine's [epoch ticker](crate::Engine::start_epoch_ticker) and with
+    /// [signal interruption](crate::Config::signal_interruption) if they're
+    /// used, and undoes all of this when it returns. Hosts which call into
+    /// the same store many times in a row, for example a few short guest
+    /// functions per request, can enter the store first so that the calls in
+    /// between reuse the state set up here instead. Each call still catches
+    /// its own traps.
+    ///
+    /// The stack limit is computed relative to the stack pointer of this
+    /// call, so calls made while the store is entered get less stack the
+    /// deeper they're made than here, and must be made on the same stack.
+    /// Calls to this method may be nested, and the store is exited by the
+    /// last matching call to [`Store::exit`].
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the store is already entered on another thread.
+    /// Calling into WebAssembly also fails while the store is entered on
+    /// another thread, so a store must be exited before it's used on another
+    /// thread.
+    #[cfg(feature = "std")]
+    pub fn enter(&mut self) -> Result<()> {
+        self.inner.enter()
+    }
+
+    /// Exits a call to [`Store::enter`].
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the store isn't entered, or was entered on another
+    /// thread.
+    #[cfg(feature = "std")]
+    pub fn exit(&mut self) -> Result<()> {
+        self.inner.exit()
+    }
+
+    /// Saves the contents of this store's linear memories and then releases
+    /// the memory backing them, for stores which are expected to sit idle for
+    /// a while.
+    ///
+    /// Memories are saved in chunks, skipping chunks which are entirely zero,
+    /// which are compressed if the `compressed-artifacts` feature is enabled.
+    /// Their pages are then released as with [`Memory::discard`]. Returns the
+    /// number of bytes that the saved contents take up.
+    ///
+    /// The contents are restored by [`Store::resume_from_hibernation`], which
+    /// is called automatically the next time that WebAssembly is called in
+    /// this store, or when a memory is accessed with [`Memory::data_mut`].
+    /// Accessing a memory with [`Memory::data`] while the store is
+    /// hibernating panics, so the host must call `resume_from_hibernation`
+    /// before reading memories itself. Shared memories aren't hibernated.
+    ///
+    /// [`Memory::discard`]: crate::Memory::discard
+    /// [`Memory::data`]: crate::Memory::data
+    /// [`Memory::data_mut`]: crate::Memory::data_mut
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the store is already hibernating, if WebAssembly is
+    /// executing in this store, for example when this is called from a host
+    /// function, or if saving the memories fails.
+    pub fn hibernate(&mut self) -> Result<usize> {
+        self.inner.hibernate()
+    }
+
+    /// Restores the memories saved by [`Store::hibernate`], if the store is
+    /// hibernating.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the saved contents can't be restored, in which
+    /// case the store remains hibernating.
+    pub fn resume_from_hibernation(&mut self) -> Result<()> {
+        self.inner.resume_from_hibernation()
+    }
+
+    /// Returns whether [`Store::hibernate`] was called and the store hasn't
+    /// resumed since.
+    pub fn is_hibernating(&self) -> bool {
+        self.inner.is_hibernating()
+    }
+
+    /// Starts recording each call from WebAssembly to a host function in this
+    /// store to `log`, so that the calls can later be replayed without the
+    /// host with [`Store::replay_host_calls`].
+    ///
+    /// Once a host function returns, the bytes of the store's linear memories
+    /// that it changed are logged, followed by its results or the message of
+    /// the error that it failed with. Host calls made while a host function
+    /// calls back into WebAssembly are part of the outermost host call. Each
+    /// memory is compared against a copy taken before the call, so recording
+    /// slows down host calls in proportion to the size of the store's
+    /// memories.
+    ///
+    /// Only the effects on unshared linear memories are logged: host
+    /// functions mustn't change globals or tables, return references, or
+    /// create memories. Host functions of components aren't logged.
+    ///
+    /// Recording continues until [`Store::stop_host_call_log`] is called or
+    /// the store is dropped.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the engine isn't configured with
+    /// [`RRConfig::Recording`](crate::RRConfig::Recording) or if this store
+    /// is already recording or replaying host calls.
+    #[cfg(feature = "rr")]
+    pub fn record_host_calls(
+        &mut self,
+        log: impl std::io::Write + Send + Sync + 'static,
+    ) -> Result<()> {
+        self.inner.record_host_calls(Box::new(log))
+    }
+
+    /// Starts replaying the host calls recorded by
+    /// [`Store::record_host_calls`] from `log`.
+    ///
+    /// Each call from WebAssembly to a host function in this store then
+    /// applies the next logged host call's effects instead of calling the
+    /// host function, so the recorded WebAssembly must be run again in the
+    /// same way, starting from the same state. This makes it possible to
+    /// benchmark and profile guest code deterministically without its host.
+    ///
+    /// If the log doesn't match then calls to host functions fail, and if the
+    /// guest diverges from the recording then its behavior is unspecified.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the engine isn't configured with
+    /// [`RRConfig::Replaying`](crate::RRConfig::Replaying) or if this store
+    /// is already recording or replaying host calls.
+    #[cfg(feature = "rr")]
+    pub fn replay_host_calls(
+        &mut self,
+        log: impl std::io::Read + Send + Sync + 'static,
+    ) -> Result<()> {
+        self.inner.replay_host_calls(Box::new(log))
+    }
+
+    /// Stops recording or replaying host calls, flushing the log if it's
+    /// being recorded.
+    #[cfg(feature = "rr")]
+    pub fn stop_host_call_log(&mut self) -> Result<()> {
+        self.inner.stop_host_call_log()
+    }
+
     /// Set an exception as the currently pending exception, and
     /// return an error that propagates the throw.
     ///
@@ -1376,6 +1815,36 @@ impl<'a, T> StoreContext<'a, T> {
     pub fn get_fuel(&self) -> Result<u64> {
         self.0.get_fuel()
     }
+
+    /// Returns the resource counts of this store.
+    ///
+    /// For more information see [`Store::resource_counts`].
+    pub fn resource_counts(&self) -> ResourceCounts {
+        self.0.resource_counts()
+    }
+
+    /// Returns statistics about this store's garbage collections.
+    ///
+    /// For more information see [`Store::gc_stats`].
+    #[cfg(feature = "gc")]
+    pub fn gc_stats(&self) -> GcStats {
+        self.0.gc_stats()
+    }
+
+    /// Returns the CPU used by WebAssembly executing in this store so far.
+    ///
+    /// Same as [`Store::cpu_usage`].
+    #[cfg(feature = "std")]
+    pub fn cpu_usage(&self) -> Option<CpuUsage> {
+        self.0.cpu_usage()
+    }
+
+    /// Returns whether this store is hibernating.
+    ///
+    /// Same as [`Store::is_hibernating`].
+    pub fn is_hibernating(&self) -> bool {
+        self.0.is_hibernating()
+    }
 }
 
 impl<'a, T> StoreContextMut<'a, T> {
@@ -1420,6 +1889,136 @@ impl<'a, T> StoreContextMut<'a, T> {
         self.0.get_fuel()
     }
 
+    /// Returns the resource counts of this store.
+    ///
+    /// For more information see [`Store::resource_counts`]
+    pub fn resource_counts(&self) -> ResourceCounts {
+        self.0.resource_counts()
+    }
+
+    /// Returns statistics about this store's garbage collections.
+    ///
+    /// For more information see [`Store::gc_stats`].
+    #[cfg(feature = "gc")]
+    pub fn gc_stats(&self) -> GcStats {
+        self.0.gc_stats()
+    }
+
+    /// Configures the pooling allocator affinity key of this store.
+    ///
+    /// For more information see [`Store::set_pooling_affinity`]
+    pub fn set_pooling_affinity(&mut self, key: Option<u64>) {
+        self.0.set_pooling_affinity(key);
+    }
+
+    /// Configures whether backtraces are captured when wasm traps.
+    ///
+    /// For more information see [`Store::set_wasm_backtrace`]
+    pub fn set_wasm_backtrace(&mut self, enable: bool) {
+        self.0.set_wasm_backtrace(enable);
+    }
+
+    /// Configures the NUMA node that linear memories of this store are placed
+    /// on.
+    ///
+    /// For more information see [`Store::set_numa_node`]
+    pub fn set_numa_node(&mut self, node: Option<u32>) {
+        self.0.set_numa_node(node);
+    }
+
+    /// Starts measuring the CPU used by WebAssembly executing in this store.
+    ///
+    /// For more information see [`Store::enable_cpu_accounting`]
+    #[cfg(feature = "std")]
+    pub fn enable_cpu_accounting(&mut self) -> Result<()> {
+        self.0.enable_cpu_accounting()
+    }
+
+    /// Returns the CPU used by WebAssembly executing in this store so far.
+    ///
+    /// For more information see [`Store::cpu_usage`]
+    #[cfg(feature = "std")]
+    pub fn cpu_usage(&self) -> Option<CpuUsage> {
+        self.0.cpu_usage()
+    }
+
+    /// Sets up the state of calls into WebAssembly once for all the calls
+    /// made on this thread until the matching exit.
+    ///
+    /// For more information see [`Store::enter`]
+    #[cfg(feature = "std")]
+    pub fn enter(&mut self) -> Result<()> {
+        self.0.enter()
+    }
+
+    /// Exits a call to [`StoreContextMut::enter`].
+    ///
+    /// For more information see [`Store::exit`]
+    #[cfg(feature = "std")]
+    pub fn exit(&mut self) -> Result<()> {
+        self.0.exit()
+    }
+
+    /// Limits the number of further instructions that WebAssembly may retire
+    /// in this store.
+    ///
+    /// For more information see [`Store::set_instruction_budget`]
+    #[cfg(feature = "std")]
+    pub fn set_instruction_budget(&mut self, budget: Option<u64>) -> Result<()> {
+        self.0.set_instruction_budget(budget)
+    }
+
+    /// Saves the contents of this store's linear memories and releases them.
+    ///
+    /// For more information see [`Store::hibernate`]
+    pub fn hibernate(&mut self) -> Result<usize> {
+        self.0.hibernate()
+    }
+
+    /// Restores the memories saved by [`Store::hibernate`].
+    ///
+    /// For more information see [`Store::resume_from_hibernation`]
+    pub fn resume_from_hibernation(&mut self) -> Result<()> {
+        self.0.resume_from_hibernation()
+    }
+
+    /// Returns whether this store is hibernating.
+    ///
+    /// For more information see [`Store::is_hibernating`]
+    pub fn is_hibernating(&self) -> bool {
+        self.0.is_hibernating()
+    }
+
+    /// Starts recording host calls to `log`.
+    ///
+    /// For more information see [`Store::record_host_calls`]
+    #[cfg(feature = "rr")]
+    pub fn record_host_calls(
+        &mut self,
+        log: impl std::io::Write + Send + Sync + 'static,
+    ) -> Result<()> {
+        self.0.record_host_calls(Box::new(log))
+    }
+
+    /// Starts replaying host calls from `log`.
+    ///
+    /// For more information see [`Store::replay_host_calls`]
+    #[cfg(feature = "rr")]
+    pub fn replay_host_calls(
+        &mut self,
+        log: impl std::io::Read + Send + Sync + 'static,
+    ) -> Result<()> {
+        self.0.replay_host_calls(Box::new(log))
+    }
+
+    /// Stops recording or replaying host calls.
+    ///
+    /// For more information see [`Store::stop_host_call_log`]
+    #[cfg(feature = "rr")]
+    pub fn stop_host_call_log(&mut self) -> Result<()> {
+        self.0.stop_host_call_log()
+    }
+
     /// Set the amount of fuel in this store.
     ///
     /// For more information see [`Store::set_fuel`]
@@ -1529,7 +2128,7 @@ impl<T> StoreInner<T> {
 
     #[inline]
     pub fn call_hook(&mut self, s: CallHook) -> Result<()> {
-        if self.inner.pkey.is_none() && self.call_hook.is_none() {
+        if self.inner.pkey.is_none() && self.call_hook.is_none() && !self.inner.observes_calls() {
             Ok(())
         } else {
             self.call_hook_slow_path(s)
@@ -1537,6 +2136,25 @@ impl<T> StoreInner<T> {
     }
 
     fn call_hook_slow_path(&mut self, s: CallHook) -> Result<()> {
+        // Interrupts requested while the store wasn't executing wasm, or while
+        // it was in a host function, are delivered on the way back into wasm.
+        #[cfg(all(feature = "std", unix, has_native_signals))]
+        if let Some(interrupt) = &self.inner.interrupt {
+            if matches!(s, CallHook::CallingWasm | CallHook::ReturningFromHost) && interrupt.take()
+            {
+                return Err(crate::Trap::Interrupt.into());
+            }
+        }
+        #[cfg(all(feature = "std", unix, has_native_signals))]
+        if let Some(accounting) = &mut self.inner.cpu_accounting {
+            match s {
+                CallHook::CallingWasm | CallHook::ReturningFromHost => accounting.resume_guest(),
+                CallHook::ReturningFromWasm | CallHook::CallingHost => {
+                    accounting.pause_guest();
+                }
+            }
+        }
+
         if let Some(pkey) = &self.inner.pkey {
             let allocator = self.engine().allocator();
             match s {
@@ -1573,6 +2191,12 @@ impl<T> StoreInner<T> {
                     .with_blocking(|store, cx| cx.block_on(handler.handle_call_event(store, s)))?;
             }
 
+            #[cfg(all(feature = "call-hook", feature = "std"))]
+            CallHookInner::Record(transitions) => {
+                transitions.record(s);
+                Ok(())
+            }
+
             CallHookInner::ForceTypeParameterToBeUsed { uninhabited, .. } => {
                 let _ = s;
                 match *uninhabited {}
@@ -1967,6 +2591,7 @@ impl StoreOpaque {
                 imports: vm::Imports::default(),
                 store,
                 limiter,
+                memory_images: None,
             };
 
             let (mem_alloc_index, mem) = engine
@@ -2094,6 +2719,10 @@ impl StoreOpaque {
         }
 
         log::trace!("============ Begin GC ===========");
+        let event = self.engine().start_event();
+        #[cfg(feature = "std")]
+        let start = std::time::Instant::now();
+        let allocated_before = self.unwrap_gc_store().gc_heap.allocated_bytes();
 
         // Take the GC roots out of `self` so we can borrow it mutably but still
         // call mutable methods on `self`.
@@ -2108,6 +2737,19 @@ impl StoreOpaque {
         roots.clear();
         self.gc_roots_list = roots;
 
+        let allocated_after = self.unwrap_gc_store().gc_heap.allocated_bytes();
+        let freed = allocated_before.saturating_sub(allocated_after);
+        self.gc_stats.collections += 1;
+        self.gc_stats.bytes_freed += u64::try_from(freed).unwrap();
+        #[cfg(feature = "std")]
+        {
+            let pause = start.elapsed();
+            self.gc_stats.total_pause += pause;
+            self.gc_stats.max_pause = self.gc_stats.max_pause.max(pause);
+        }
+
+        self.engine()
+            .finish_event(event, |duration| crate::RuntimeEventKind::Gc { duration });
         log::trace!("============ End GC ===========");
     }
 
@@ -2325,6 +2967,14 @@ impl StoreOpaque {
         }
     }
 
+    pub fn resource_counts(&self) -> ResourceCounts {
+        ResourceCounts {
+            instances: self.instance_count,
+            memories: self.memory_count,
+            tables: self.table_count,
+        }
+    }
+
     pub fn get_fuel(&self) -> Result<u64> {
         crate::ensure!(
             self.engine().tunables().consume_fuel,
@@ -2378,6 +3028,109 @@ impl StoreOpaque {
         self.set_fuel(self.get_fuel()?)
     }
 
+    #[cfg(feature = "std")]
+    pub fn enable_cpu_accounting(&mut self) -> Result<()> {
+        #[cfg(all(unix, has_native_signals))]
+        {
+            if self.cpu_accounting.is_none() {
+                self.cpu_accounting = Some(Box::new(CpuAccounting::new()));
+            }
+            return Ok(());
+        }
+        #[cfg(not(all(unix, has_native_signals)))]
+        bail!("CPU accounting is not supported on this platform")
+    }
+
+    #[cfg(feature = "std")]
+    pub fn cpu_usage(&self) -> Option<CpuUsage> {
+        #[cfg(all(unix, has_native_signals))]
+        return Some(self.cpu_accounting.as_ref()?.usage());
+        #[cfg(not(all(unix, has_native_signals)))]
+        None
+    }
+
+    #[cfg(feature = "std")]
+    pub fn set_instruction_budget(&mut self, budget: Option<u64>) -> Result<()> {
+        #[cfg(all(unix, has_native_signals))]
+        {
+            if budget.is_some() && self.interrupt.is_none() {
+                bail!("signal-based interruption is not enabled for this store's engine");
+            }
+            let Some(accounting) = &mut self.cpu_accounting else {
+                bail!("CPU accounting is not enabled for this store");
+            };
+            return accounting.set_instruction_budget(budget);
+        }
+        #[cfg(not(all(unix, has_native_signals)))]
+        {
+            let _ = budget;
+            bail!("CPU accounting is not supported on this platform")
+        }
+    }
+
+    /// Returns whether `Config::signal_interruption` or CPU accounting is
+    /// enabled for this store, which observe transitions between wasm and the
+    /// host in `StoreInner::call_hook`.
+    #[inline]
+    fn observes_calls(&self) -> bool {
+        #[cfg(all(feature = "std", unix, has_native_signals))]
+        if self.interrupt.is_some() || self.cpu_accounting.is_some() {
+            return true;
+        }
+        false
+    }
+
+    /// Stops measuring the CPU time of WebAssembly while its fiber may be
+    /// suspended, returning whether `resume_guest_cpu_time` should be called
+    /// once it's resumed.
+    #[cfg(feature = "async")]
+    #[inline]
+    pub(crate) fn pause_guest_cpu_time(&mut self) -> bool {
+        #[cfg(all(feature = "std", unix, has_native_signals))]
+        if let Some(accounting) = &mut self.cpu_accounting {
+            return accounting.pause_guest();
+        }
+        false
+    }
+
+    #[cfg(feature = "async")]
+    pub(crate) fn resume_guest_cpu_time(&mut self) {
+        #[cfg(all(feature = "std", unix, has_native_signals))]
+        if let Some(accounting) = &mut self.cpu_accounting {
+            accounting.resume_guest();
+        }
+    }
+
+    /// Starts measuring a call into WebAssembly, if
+    /// `Store::enable_cpu_accounting` was called.
+    #[cfg(all(feature = "std", unix, has_native_signals))]
+    #[inline]
+    pub(crate) fn enter_cpu_accounting(&mut self) {
+        if self.cpu_accounting.is_some() && !self.can_block() {
+            let interrupt = self.interrupt.as_deref();
+            self.cpu_accounting.as_mut().unwrap().enter(interrupt);
+        }
+    }
+
+    /// Finishes measuring a call into WebAssembly started with
+    /// `enter_cpu_accounting`.
+    #[cfg(all(feature = "std", unix, has_native_signals))]
+    #[inline]
+    pub(crate) fn exit_cpu_accounting(&mut self) {
+        if self.cpu_accounting.is_some() && !self.can_block() {
+            let interrupt = self.interrupt.as_deref();
+            self.cpu_accounting.as_mut().unwrap().exit(interrupt);
+        }
+    }
+
+    /// Returns the state used to interrupt this store, if
+    /// `Config::signal_interruption` is enabled.
+    #[cfg(all(feature = "std", unix, has_native_signals))]
+    #[inline]
+    pub(crate) fn interrupt_state(&self) -> Option<&Arc<InterruptState>> {
+        self.interrupt.as_ref()
+    }
+
     #[inline]
     pub fn signal_handler(&self) -> Option<*const SignalHandler> {
         let handler = self.signal_handler.as_ref()?;
@@ -2548,6 +3301,36 @@ at https://bytecodealliance.org/security.
         self.pkey
     }
 
+    #[inline]
+    pub fn pooling_affinity(&self) -> Option<u64> {
+        self.pooling_affinity
+    }
+
+    #[inline]
+    pub fn set_pooling_affinity(&mut self, key: Option<u64>) {
+        self.pooling_affinity = key;
+    }
+
+    #[inline]
+    pub fn wasm_backtrace(&self) -> bool {
+        self.wasm_backtrace
+    }
+
+    #[inline]
+    pub fn set_wasm_backtrace(&mut self, enable: bool) {
+        self.wasm_backtrace = enable;
+    }
+
+    #[inline]
+    pub fn numa_node(&self) -> Option<u32> {
+        self.numa_node
+    }
+
+    #[inline]
+    pub fn set_numa_node(&mut self, node: Option<u32>) {
+        self.numa_node = node;
+    }
+
     #[inline]
     #[cfg(feature = "component-model")]
     pub(crate) fn component_resource_state(
@@ -2660,13 +3443,14 @@ at https://bytecodealliance.org/security.
 
     /// Allocates a new continuation. Note that we currently don't support
     /// deallocating them. Instead, all continuations remain allocated
-    /// throughout the store's lifetime.
+    /// throughout the store's lifetime, and their stacks are returned to the
+    /// engine's cache when the store is dropped.
     #[cfg(feature = "stack-switching")]
     pub fn allocate_continuation(&mut self) -> Result<*mut VMContRef> {
         // FIXME(frank-emrich) Do we need to pin this?
         let mut continuation = Box::new(VMContRef::empty());
         let stack_size = self.engine.config().async_stack_size;
-        let stack = crate::vm::VMContinuationStack::new(stack_size)?;
+        let stack = self.engine.continuation_stacks().allocate(stack_size)?;
         continuation.stack = stack;
         let ptr = continuation.deref_mut() as *mut VMContRef;
         self.continuations.push(continuation);
@@ -2702,7 +3486,9 @@ at https://bytecodealliance.org/security.
         let id = self.instances.next_key();
 
         let allocator = match kind {
-            AllocateInstanceKind::Module(_) => self.engine().allocator(),
+            AllocateInstanceKind::Module(_) | AllocateInstanceKind::Snapshot { .. } => {
+                self.engine().allocator()
+            }
             AllocateInstanceKind::Dummy { allocator } => allocator,
         };
         // SAFETY: this function's own contract is the same as
@@ -2715,12 +3501,17 @@ at https://bytecodealliance.org/security.
                     imports,
                     store: self,
                     limiter,
+                    memory_images: match kind {
+                        AllocateInstanceKind::Snapshot { memory_images, .. } => Some(memory_images),
+                        _ => None,
+                    },
                 })
                 .await?
         };
 
         let actual = match kind {
-            AllocateInstanceKind::Module(module_id) => {
+            AllocateInstanceKind::Module(module_id)
+            | AllocateInstanceKind::Snapshot { module_id, .. } => {
                 log::trace!(
                     "Adding instance to store: store={:?}, module={module_id:?}, instance={id:?}",
                     self.id()
@@ -2854,6 +3645,13 @@ pub(crate) enum AllocateInstanceKind<'a> {
     /// engine's allocator will be used.
     Module(RegisteredModuleId),
 
+    /// Like `Module`, except that memories are initialized with
+    /// `memory_images` instead of the module's own images.
+    Snapshot {
+        module_id: RegisteredModuleId,
+        memory_images: &'a ModuleMemoryImages,
+    },
+
     /// Add a dummy instance that to the store.
     ///
     /// These are instances that are just implementation details of something
@@ -3012,6 +3810,14 @@ impl Drop for StoreOpaque {
                 }
             }
         }
+
+        // Nothing runs on the stacks of this store's continuations anymore,
+        // so they can be reused by other stores.
+        #[cfg(feature = "stack-switching")]
+        for continuation in self.continuations.iter_mut() {
+            let stack = continuation.detach_stack();
+            self.engine.continuation_stacks().deallocate(stack);
+        }
     }
 }
 
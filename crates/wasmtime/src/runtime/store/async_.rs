@@ -131,6 +131,35 @@ impl<T> Store<T> {
     pub fn epoch_deadline_async_yield_and_update(&mut self, delta: u64) {
         self.inner.epoch_deadline_async_yield_and_update(delta);
     }
+
+    /// Configures the fuel yield interval of this store to adapt so that each
+    /// slice of execution between yields takes about `slice` of wall-clock
+    /// time.
+    ///
+    /// A fixed [`Store::fuel_async_yield_interval`] is a tradeoff: too small an
+    /// interval wastes time yielding, while too large an interval lets one
+    /// guest delay the others on its executor. How much time an amount of fuel
+    /// takes varies between guests, so with this option the interval is
+    /// instead tuned at each yield from the time the previous slice took.
+    /// Adjustments are smoothed and bounded so a single slow slice, for example
+    /// due to preemption of the thread, doesn't swing the interval. Time spent
+    /// with the store's future suspended isn't counted.
+    ///
+    /// The interval configured with [`Store::fuel_async_yield_interval`] is
+    /// the starting point of the tuning and must be set first. Passing `None`
+    /// stops tuning, keeping the current interval.
+    ///
+    /// # Errors
+    ///
+    /// This method will error if fuel is not enabled, no yield interval is
+    /// configured, or `slice` is zero.
+    #[cfg(feature = "std")]
+    pub fn fuel_async_yield_time_slice(
+        &mut self,
+        slice: Option<std::time::Duration>,
+    ) -> Result<()> {
+        self.inner.fuel_async_yield_time_slice(slice)
+    }
 }
 
 impl<'a, T> StoreContextMut<'a, T> {
@@ -164,6 +193,17 @@ impl<'a, T> StoreContextMut<'a, T> {
     pub fn epoch_deadline_async_yield_and_update(&mut self, delta: u64) {
         self.0.epoch_deadline_async_yield_and_update(delta);
     }
+
+    /// Configures the fuel yield interval to adapt to a wall-clock time slice.
+    ///
+    /// For more information see [`Store::fuel_async_yield_time_slice`].
+    #[cfg(feature = "std")]
+    pub fn fuel_async_yield_time_slice(
+        &mut self,
+        slice: Option<std::time::Duration>,
+    ) -> Result<()> {
+        self.0.fuel_async_yield_time_slice(slice)
+    }
 }
 
 impl<T> StoreInner<T> {
@@ -178,8 +218,89 @@ impl<T> StoreInner<T> {
     }
 }
 
+/// State of [`Store::fuel_async_yield_time_slice`], which tunes the fuel
+/// yield interval of a store towards a target duration per slice.
+#[cfg(feature = "std")]
+pub(crate) struct FuelYieldTuner {
+    target: std::time::Duration,
+    slice_start: std::time::Instant,
+}
+
+#[cfg(feature = "std")]
+impl FuelYieldTuner {
+    /// The smallest interval the tuner will pick, to bound the overhead of
+    /// yielding for guests which are slow per unit of fuel.
+    const MIN_INTERVAL: u64 = 1_000;
+
+    /// The most the interval may grow or shrink by at each yield.
+    const MAX_STEP: u64 = 4;
+
+    /// Returns the interval to use for the next slice, given that `interval`
+    /// fuel was consumed since the current slice started.
+    fn next_interval(&mut self, interval: u64) -> u64 {
+        let now = std::time::Instant::now();
+        let elapsed = now.duration_since(self.slice_start).as_nanos().max(1);
+        self.slice_start = now;
+
+        // The interval which would have taken exactly `target`, averaged with
+        // the current interval to smooth out noisy measurements.
+        let ideal = u128::from(interval) * self.target.as_nanos() / elapsed;
+        let ideal = u64::try_from(ideal).unwrap_or(u64::MAX);
+        let next = interval / 2 + ideal / 2;
+        let min = (interval / Self::MAX_STEP).max(Self::MIN_INTERVAL);
+        let max = interval.saturating_mul(Self::MAX_STEP).max(min);
+        next.clamp(min, max)
+    }
+}
+
 #[doc(hidden)]
 impl StoreOpaque {
+    #[cfg(feature = "std")]
+    fn fuel_async_yield_time_slice(&mut self, slice: Option<std::time::Duration>) -> Result<()> {
+        crate::ensure!(
+            self.engine().tunables().consume_fuel,
+            "fuel is not configured in this store"
+        );
+        let Some(target) = slice else {
+            self.fuel_yield_tuner = None;
+            return Ok(());
+        };
+        crate::ensure!(
+            !target.is_zero(),
+            "fuel_async_yield_time_slice must not be 0"
+        );
+        crate::ensure!(
+            self.fuel_yield_interval.is_some(),
+            "fuel_async_yield_interval must be configured first"
+        );
+        self.fuel_yield_tuner = Some(FuelYieldTuner {
+            target,
+            slice_start: std::time::Instant::now(),
+        });
+        Ok(())
+    }
+
+    /// Adjusts the fuel yield interval, when tuning is enabled, after a slice
+    /// of execution ran out of fuel.
+    pub(crate) fn tune_fuel_yield_interval(&mut self) {
+        #[cfg(feature = "std")]
+        if let (Some(tuner), Some(interval)) =
+            (&mut self.fuel_yield_tuner, self.fuel_yield_interval)
+        {
+            self.fuel_yield_interval =
+                core::num::NonZeroU64::new(tuner.next_interval(interval.get()));
+        }
+    }
+
+    /// Restarts the current slice of execution for the purposes of tuning the
+    /// fuel yield interval, as the store's fiber is being resumed.
+    pub(crate) fn restart_fuel_yield_slice(&mut self) {
+        #[cfg(feature = "std")]
+        if let Some(tuner) = &mut self.fuel_yield_tuner {
+            tuner.slice_start = std::time::Instant::now();
+        }
+    }
+
     pub(crate) fn allocate_fiber_stack(&mut self) -> Result<wasmtime_fiber::FiberStack> {
         if let Some(stack) = self.async_state.last_fiber_stack().take() {
             return Ok(stack);
@@ -0,0 +1,32 @@
+//! Accounting of the CPU used by WebAssembly running in a store, see
+//! `Store::enable_cpu_accounting`.
+
+use core::time::Duration;
+
+#[cfg(all(unix, has_native_signals))]
+mod accounting;
+#[cfg(all(unix, has_native_signals))]
+pub(crate) use self::accounting::CpuAccounting;
+
+/// The CPU used by WebAssembly executing in a store, as returned by
+/// [`Store::cpu_usage`](crate::Store::cpu_usage).
+#[derive(Copy, Clone, Debug, Default, PartialEq, Eq)]
+pub struct CpuUsage {
+    /// The number of instructions retired in user mode, or `None` if they
+    /// can't be counted on this platform.
+    pub instructions: Option<u64>,
+    /// The CPU time consumed by calls from the host into WebAssembly, in
+    /// both user and kernel mode, including the time spent in host functions
+    /// that WebAssembly called.
+    ///
+    /// Calls made on async fibers aren't included.
+    pub cpu_time: Duration,
+    /// The CPU time consumed while executing WebAssembly code itself, in
+    /// both user and kernel mode.
+    ///
+    /// Unlike `cpu_time` this excludes the time spent in host functions, as
+    /// well as the time during which an async call is suspended, and it's
+    /// measured on whichever thread the WebAssembly executes on, so it
+    /// includes calls made on async fibers which move between threads.
+    pub guest_cpu_time: Duration,
+}
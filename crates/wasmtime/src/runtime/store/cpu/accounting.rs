@@ -0,0 +1,122 @@
+use super::CpuUsage;
+use crate::prelude::*;
+use crate::runtime::store::InterruptState;
+use crate::runtime::vm;
+use core::time::Duration;
+
+pub(crate) struct CpuAccounting {
+    usage: CpuUsage,
+    /// The number of calls into WebAssembly in progress. Only the outermost
+    /// one is measured, since it includes the others.
+    depth: usize,
+    start: vm::CpuSample,
+    /// The value of `usage.instructions` at which execution is interrupted.
+    instruction_limit: Option<u64>,
+    /// Whether the current thread's instruction counter is armed for the
+    /// outermost call in progress.
+    armed: bool,
+    /// The thread CPU time at which WebAssembly last started or resumed
+    /// executing, if it's executing.
+    guest_start_ns: Option<u64>,
+}
+
+impl CpuAccounting {
+    pub(crate) fn new() -> CpuAccounting {
+        CpuAccounting {
+            usage: CpuUsage {
+                instructions: vm::can_count_instructions().then_some(0),
+                cpu_time: Duration::ZERO,
+                guest_cpu_time: Duration::ZERO,
+            },
+            depth: 0,
+            start: vm::cpu_sample(),
+            instruction_limit: None,
+            armed: false,
+            guest_start_ns: None,
+        }
+    }
+
+    pub(crate) fn usage(&self) -> CpuUsage {
+        self.usage
+    }
+
+    pub(crate) fn set_instruction_budget(&mut self, budget: Option<u64>) -> Result<()> {
+        let Some(budget) = budget else {
+            self.instruction_limit = None;
+            return Ok(());
+        };
+        let Some(used) = self.usage.instructions else {
+            bail!("instructions can't be counted on this platform");
+        };
+        self.instruction_limit = Some(used.saturating_add(budget));
+        Ok(())
+    }
+
+    pub(crate) fn enter(&mut self, interrupt: Option<&InterruptState>) {
+        self.depth += 1;
+        if self.depth > 1 {
+            return;
+        }
+        self.start = vm::cpu_sample();
+        let (Some(limit), Some(used), Some(interrupt)) =
+            (self.instruction_limit, self.usage.instructions, interrupt)
+        else {
+            return;
+        };
+        let remaining = limit.saturating_sub(used);
+        if let Some((fd, limit)) = vm::arm_instruction_budget(remaining, vm::INTERRUPT_SIGNAL) {
+            interrupt.arm_instruction_budget(fd, limit);
+            self.armed = true;
+        }
+    }
+
+    pub(crate) fn exit(&mut self, interrupt: Option<&InterruptState>) {
+        // Accounting may have been enabled while the call was in progress.
+        let Some(depth) = self.depth.checked_sub(1) else {
+            return;
+        };
+        self.depth = depth;
+        if depth > 0 {
+            return;
+        }
+        if self.armed {
+            self.armed = false;
+            vm::disarm_instruction_budget();
+            if let Some(interrupt) = interrupt {
+                interrupt.disarm_instruction_budget();
+            }
+        }
+
+        let end = vm::cpu_sample();
+        let cpu_time = end.cpu_time_ns.saturating_sub(self.start.cpu_time_ns);
+        self.usage.cpu_time += Duration::from_nanos(cpu_time);
+        if let (Some(total), Some(start), Some(end)) = (
+            &mut self.usage.instructions,
+            self.start.instructions,
+            end.instructions,
+        ) {
+            *total += end.saturating_sub(start);
+        }
+    }
+
+    /// Records that WebAssembly starts or resumes executing on the current
+    /// thread, if it wasn't already.
+    pub(crate) fn resume_guest(&mut self) {
+        if self.guest_start_ns.is_none() {
+            self.guest_start_ns = Some(vm::thread_cpu_time_ns());
+        }
+    }
+
+    /// Records that WebAssembly stops executing on the current thread, for
+    /// example to call a host function or because its fiber is suspended.
+    ///
+    /// Returns whether it was executing.
+    pub(crate) fn pause_guest(&mut self) -> bool {
+        let Some(start) = self.guest_start_ns.take() else {
+            return false;
+        };
+        let elapsed = vm::thread_cpu_time_ns().saturating_sub(start);
+        self.usage.guest_cpu_time += Duration::from_nanos(elapsed);
+        true
+    }
+}
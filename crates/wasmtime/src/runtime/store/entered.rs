@@ -0,0 +1,127 @@
+//! Keeping the state of calls into WebAssembly set up across many calls, see
+//! `Store::enter`.
+//!
+//! Each call from the host into WebAssembly registers itself with the engine's
+//! epoch ticker and the store's interruption state, and computes the stack
+//! limit for WebAssembly from the current stack pointer, undoing all of this
+//! once the call returns. While a store is entered this is done once by
+//! `Store::enter` instead, and calls on the same thread reuse it.
+
+use super::StoreOpaque;
+use crate::prelude::*;
+
+/// The state set up by `Store::enter` until the matching `Store::exit`.
+pub(crate) struct Entered {
+    /// The number of `Store::enter` calls which haven't been exited yet.
+    depth: usize,
+    /// The thread that the store was entered on, see `current_thread`.
+    thread: usize,
+    /// The stack limit to restore when exiting, if entering set it.
+    prev_stack_limit: Option<usize>,
+    #[cfg(target_has_atomic = "64")]
+    _ticking: Option<crate::engine::epoch_ticker::ExecutingGuard>,
+    #[cfg(all(unix, has_native_signals))]
+    _interruptible: Option<super::interrupt::InterruptGuard>,
+}
+
+/// Returns an identifier of the current thread, which is the address of a
+/// thread-local and so is unique among running threads.
+fn current_thread() -> usize {
+    std::thread_local!(static THREAD: u8 = const { 0 });
+    THREAD.with(|t| t as *const u8 as usize)
+}
+
+impl StoreOpaque {
+    pub(crate) fn enter(&mut self) -> Result<()> {
+        if let Some(entered) = &mut self.entered {
+            if entered.thread != current_thread() {
+                bail!("the store is already entered on another thread");
+            }
+            entered.depth += 1;
+            return Ok(());
+        }
+
+        // Stores which can block run WebAssembly on fibers, each with its own
+        // stack limit, and don't deliver interrupts with signals.
+        let can_block = self.can_block();
+        let prev_stack_limit = if can_block || cfg!(miri) {
+            None
+        } else {
+            self.enter_stack_limit()
+        };
+        #[cfg(all(unix, has_native_signals))]
+        let _interruptible = if can_block {
+            None
+        } else {
+            self.interrupt_state().map(|state| state.enter())
+        };
+        self.entered = Some(Box::new(Entered {
+            depth: 1,
+            thread: current_thread(),
+            prev_stack_limit,
+            #[cfg(target_has_atomic = "64")]
+            _ticking: self.engine().enter_epoch_ticker(),
+            #[cfg(all(unix, has_native_signals))]
+            _interruptible,
+        }));
+        Ok(())
+    }
+
+    /// Sets the stack limit for WebAssembly relative to the current stack
+    /// pointer, unless it's already set, returning the previous limit if it
+    /// was changed.
+    fn enter_stack_limit(&mut self) -> Option<usize> {
+        let limit = self.vm_store_context().stack_limit.get();
+        // SAFETY: the store is borrowed mutably, and the limit is otherwise
+        // only accessed by WebAssembly running in it on this thread.
+        unsafe {
+            if *limit != usize::MAX {
+                return None;
+            }
+            // Without a host compiler backend only Pulley runs, which doesn't
+            // use the stack limit, as in `EntryStoreContext::enter_wasm`.
+            #[cfg(has_host_compiler_backend)]
+            {
+                let stack_pointer = crate::runtime::vm::get_stack_pointer();
+                let max_wasm_stack = self.engine().config().max_wasm_stack;
+                *limit = stack_pointer.checked_sub(max_wasm_stack).unwrap();
+                return Some(usize::MAX);
+            }
+            #[cfg(not(has_host_compiler_backend))]
+            None
+        }
+    }
+
+    pub(crate) fn exit(&mut self) -> Result<()> {
+        let Some(entered) = &mut self.entered else {
+            bail!("the store isn't entered");
+        };
+        if entered.thread != current_thread() {
+            bail!("the store was entered on another thread");
+        }
+        entered.depth -= 1;
+        if entered.depth > 0 {
+            return Ok(());
+        }
+        let entered = self.entered.take().unwrap();
+        if let Some(limit) = entered.prev_stack_limit {
+            // SAFETY: see `enter_stack_limit`.
+            unsafe {
+                *self.vm_store_context().stack_limit.get() = limit;
+            }
+        }
+        Ok(())
+    }
+
+    /// Returns whether this store was entered on the current thread, in which
+    /// case calls into WebAssembly don't need to set up their own state, or
+    /// an error if it was entered on another thread.
+    #[inline]
+    pub(crate) fn check_entered(&self) -> Result<bool> {
+        match &self.entered {
+            None => Ok(false),
+            Some(entered) if entered.thread == current_thread() => Ok(true),
+            Some(_) => bail!("the store is entered on another thread"),
+        }
+    }
+}
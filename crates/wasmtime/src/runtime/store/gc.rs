@@ -2,8 +2,49 @@
 
 use super::*;
 use crate::runtime::vm::VMGcRef;
+use core::time::Duration;
+
+/// Statistics about the garbage collections performed within a [`Store`], as
+/// returned by [`Store::gc_stats`].
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+#[non_exhaustive]
+pub struct GcStats {
+    /// The number of collections performed.
+    pub collections: u64,
+    /// The total time spent in collections.
+    ///
+    /// Pause times are only measured when the `std` feature is enabled, and
+    /// are otherwise zero.
+    pub total_pause: Duration,
+    /// The longest time spent in a single collection.
+    pub max_pause: Duration,
+    /// The total number of bytes freed by collections.
+    pub bytes_freed: u64,
+    /// The number of times the GC heap has been grown.
+    pub heap_grows: u64,
+    /// The current size of the GC heap, in bytes.
+    pub heap_size: u64,
+    /// The number of bytes of the GC heap currently allocated to objects,
+    /// including objects which are unreachable but not yet collected.
+    pub allocated_bytes: u64,
+}
 
 impl StoreOpaque {
+    pub fn gc_stats(&self) -> GcStats {
+        let (heap_size, allocated_bytes) = match &self.gc_store {
+            Some(gc_store) => (
+                gc_store.gc_heap.vmmemory().current_length(),
+                gc_store.gc_heap.allocated_bytes(),
+            ),
+            None => (0, 0),
+        };
+        GcStats {
+            heap_size: u64::try_from(heap_size).unwrap(),
+            allocated_bytes: u64::try_from(allocated_bytes).unwrap(),
+            ..self.gc_stats
+        }
+    }
+
     /// Attempt to grow the GC heap by `bytes_needed` or, if that fails, perform
     /// a garbage collection.
     ///
@@ -84,12 +125,14 @@ impl StoreOpaque {
         let current_size_in_bytes = u64::try_from(heap.memory.byte_size()).unwrap();
         let current_size_in_pages = current_size_in_bytes / page_size;
 
-        // Aim to double the heap size, amortizing the cost of growth.
-        let doubled_size_in_pages = current_size_in_pages.saturating_mul(2);
-        assert!(doubled_size_in_pages >= current_size_in_pages);
-        let delta_pages_for_doubling = doubled_size_in_pages - current_size_in_pages;
+        // Aim to grow the heap by the configured factor, by default doubling
+        // it, amortizing the cost of growth.
+        let growth_factor = heap.store.engine().config().gc_heap_growth_factor;
+        let grown_size_in_pages = (current_size_in_pages as f64 * growth_factor) as u64;
+        let grown_size_in_pages = grown_size_in_pages.max(current_size_in_pages);
+        let delta_pages_for_growth = grown_size_in_pages - current_size_in_pages;
 
-        // When doubling our size, saturate at the maximum memory size in pages.
+        // When growing our size, saturate at the maximum memory size in pages.
         //
         // TODO: we should consult the instance allocator for its configured
         // maximum memory size, if any, rather than assuming the index
@@ -97,7 +140,7 @@ impl StoreOpaque {
         let max_size_in_bytes = 1 << 32;
         let max_size_in_pages = max_size_in_bytes / page_size;
         let delta_to_max_size_in_pages = max_size_in_pages - current_size_in_pages;
-        let delta_pages_for_alloc = delta_pages_for_doubling.min(delta_to_max_size_in_pages);
+        let delta_pages_for_alloc = delta_pages_for_growth.min(delta_to_max_size_in_pages);
 
         // But always make sure we are attempting to grow at least as many pages
         // as needed by the requested allocation. This must happen *after* the
@@ -120,6 +163,7 @@ impl StoreOpaque {
                 .ok_or_else(|| format_err!("failed to grow GC heap"))?;
         }
         heap.store.vm_store_context.gc_heap = heap.memory.vmmemory();
+        heap.store.gc_stats.heap_grows += 1;
 
         let new_size_in_bytes = u64::try_from(heap.memory.byte_size()).unwrap();
         assert!(new_size_in_bytes > current_size_in_bytes);
@@ -0,0 +1,147 @@
+//! Hibernation of idle stores, see `Store::hibernate`.
+//!
+//! Hibernating a store saves the contents of its linear memories in chunks,
+//! skipping chunks which are entirely zero, and then discards the memories so
+//! that their pages are returned to the OS. Chunks are compressed with zstd
+//! when the `compressed-artifacts` feature is enabled, and otherwise copied
+//! as they are, in which case hibernating only saves the memory taken by
+//! chunks of zeros.
+//! Resuming writes the chunks back into the memories.
+
+use super::StoreOpaque;
+use crate::Memory;
+use crate::prelude::*;
+
+/// The size of the chunks that memories are saved in.
+const CHUNK_SIZE: usize = 64 << 10;
+
+/// The saved memory contents of a hibernating store.
+pub(crate) struct Hibernation {
+    memories: Vec<SavedMemory>,
+}
+
+struct SavedMemory {
+    memory: Memory,
+    /// The offset of each chunk which isn't entirely zero, and its saved
+    /// contents.
+    chunks: Vec<(usize, Box<[u8]>)>,
+}
+
+impl StoreOpaque {
+    pub(crate) fn hibernate(&mut self) -> Result<usize> {
+        if self.hibernation.is_some() {
+            bail!("the store is already hibernating");
+        }
+        // Wasm which is on the stack, for example because this is called
+        // from a host function through a `Caller`, would otherwise resume
+        // with its memories discarded.
+        //
+        // SAFETY: the store context is only written while entering and
+        // exiting wasm, which can't happen concurrently with `&mut self`.
+        let entry_fp = unsafe { *self.vm_store_context().last_wasm_entry_fp.get() };
+        if entry_fp != 0 {
+            bail!("cannot hibernate a store while WebAssembly is executing in it");
+        }
+        let memories: Vec<Memory> = self.all_memories().filter_map(|m| m.unshared()).collect();
+        let mut saved_bytes = 0;
+        let mut saved = Vec::with_capacity(memories.len());
+        for memory in memories {
+            let data = memory.internal_data_mut(self);
+            let mut chunks = Vec::new();
+            for (i, chunk) in data.chunks(CHUNK_SIZE).enumerate() {
+                if chunk.iter().all(|b| *b == 0) {
+                    continue;
+                }
+                let contents = save_chunk(chunk)?;
+                saved_bytes += contents.len();
+                chunks.push((i * CHUNK_SIZE, contents));
+            }
+            saved.push(SavedMemory { memory, chunks });
+        }
+
+        // Everything is saved before anything is discarded, so that if
+        // discarding fails resuming still restores every memory.
+        let memories: Vec<Memory> = saved.iter().map(|m| m.memory).collect();
+        self.hibernation = Some(Box::new(Hibernation { memories: saved }));
+        for memory in memories {
+            let len = memory.internal_data_size(self);
+            memory.internal_discard(self, 0, len)?;
+        }
+        Ok(saved_bytes)
+    }
+
+    pub(crate) fn resume_from_hibernation(&mut self) -> Result<()> {
+        let Some(hibernation) = self.hibernation.take() else {
+            return Ok(());
+        };
+        // The store stays hibernating if restoring fails, so that the saved
+        // contents aren't lost and resuming can be retried. Restoring writes
+        // whole chunks, so it doesn't matter that some may already have been
+        // restored by then.
+        let result = hibernation.memories.iter().try_for_each(|saved| {
+            let data = saved.memory.internal_data_mut(self);
+            for (offset, contents) in saved.chunks.iter() {
+                let len = CHUNK_SIZE.min(data.len() - offset);
+                restore_chunk(contents, &mut data[*offset..][..len])?;
+            }
+            Ok(())
+        });
+        if result.is_err() {
+            self.hibernation = Some(hibernation);
+        }
+        result
+    }
+
+    /// Panics if this store is hibernating, for host accesses to memories
+    /// which can't resume the store first.
+    #[inline]
+    #[track_caller]
+    pub(crate) fn assert_not_hibernating(&self) {
+        assert!(
+            !self.is_hibernating(),
+            "memory accessed while its store is hibernating, \
+             see `Store::resume_from_hibernation`"
+        );
+    }
+
+    /// Resumes this store if it's hibernating, for host accesses to memories
+    /// which can't return an error.
+    #[inline]
+    #[track_caller]
+    pub(crate) fn resume_for_memory_access(&mut self) {
+        if self.is_hibernating() {
+            self.resume_from_hibernation()
+                .expect("failed to resume store from hibernation");
+        }
+    }
+
+    #[inline]
+    pub(crate) fn is_hibernating(&self) -> bool {
+        self.hibernation.is_some()
+    }
+}
+
+#[cfg(feature = "compressed-artifacts")]
+fn save_chunk(chunk: &[u8]) -> Result<Box<[u8]>> {
+    let compressed = zstd::bulk::compress(chunk, 1).context("failed to compress memory")?;
+    Ok(compressed.into_boxed_slice())
+}
+
+#[cfg(feature = "compressed-artifacts")]
+fn restore_chunk(contents: &[u8], dst: &mut [u8]) -> Result<()> {
+    let len =
+        zstd::bulk::decompress_to_buffer(contents, dst).context("failed to decompress memory")?;
+    ensure!(len == dst.len(), "hibernated memory doesn't match its size");
+    Ok(())
+}
+
+#[cfg(not(feature = "compressed-artifacts"))]
+fn save_chunk(chunk: &[u8]) -> Result<Box<[u8]>> {
+    Ok(chunk.into())
+}
+
+#[cfg(not(feature = "compressed-artifacts"))]
+fn restore_chunk(contents: &[u8], dst: &mut [u8]) -> Result<()> {
+    dst.copy_from_slice(contents);
+    Ok(())
+}
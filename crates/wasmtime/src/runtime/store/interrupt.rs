@@ -0,0 +1,135 @@
+//! Interruption of WebAssembly running in a store by signaling the thread
+//! that runs it, see `Config::signal_interruption`.
+
+use crate::prelude::*;
+use crate::runtime::vm;
+use core::sync::atomic::{AtomicBool, AtomicI32, AtomicU64, Ordering};
+use std::sync::{Arc, Mutex};
+
+/// A handle which interrupts the WebAssembly running in a [`Store`] from any
+/// thread, created with [`Store::interrupt_handle`].
+///
+/// See [`Config::signal_interruption`] for more information.
+///
+/// [`Store`]: crate::Store
+/// [`Store::interrupt_handle`]: crate::Store::interrupt_handle
+/// [`Config::signal_interruption`]: crate::Config::signal_interruption
+#[derive(Clone)]
+pub struct InterruptHandle {
+    state: Arc<InterruptState>,
+}
+
+impl InterruptHandle {
+    pub(super) fn new(state: Arc<InterruptState>) -> InterruptHandle {
+        InterruptHandle { state }
+    }
+
+    /// Interrupts the WebAssembly running in this handle's store, which then
+    /// traps with [`Trap::Interrupt`](crate::Trap::Interrupt).
+    ///
+    /// If the store is running WebAssembly on a thread then that thread is
+    /// signaled and the trap happens right away, unless the thread is
+    /// executing a host function or a part of the runtime such as a libcall.
+    /// In that case, or if the store isn't running anything, the trap happens
+    /// the next time that WebAssembly is entered or that a host function
+    /// returns to WebAssembly in the store.
+    pub fn interrupt(&self) {
+        self.state.requested.store(true, Ordering::SeqCst);
+        let thread = self.state.thread.lock().unwrap();
+        if let Some(thread) = *thread {
+            // SAFETY: threads unregister themselves with the lock held
+            // before they stop executing WebAssembly, so `thread` is alive.
+            unsafe { vm::interrupt_thread(thread) };
+        }
+    }
+}
+
+/// The state shared between a store and its `InterruptHandle`s.
+pub(crate) struct InterruptState {
+    /// Whether an interrupt was requested and not yet delivered.
+    requested: AtomicBool,
+    /// The thread which is currently executing WebAssembly in the store, if
+    /// any, as returned by `vm::current_thread`.
+    thread: Mutex<Option<usize>>,
+    /// The instruction counter of the thread executing WebAssembly in the
+    /// store, or -1, while an instruction budget is armed on it, see
+    /// `Store::set_instruction_budget`.
+    budget_counter: AtomicI32,
+    /// The value of `budget_counter` at which the budget is exhausted.
+    budget_limit: AtomicU64,
+}
+
+impl InterruptState {
+    pub(super) fn new() -> InterruptState {
+        InterruptState {
+            requested: AtomicBool::new(false),
+            thread: Mutex::new(None),
+            budget_counter: AtomicI32::new(-1),
+            budget_limit: AtomicU64::new(u64::MAX),
+        }
+    }
+
+    /// Returns whether an interrupt is pending, without taking it.
+    #[inline]
+    pub(crate) fn is_requested(&self) -> bool {
+        self.requested.load(Ordering::Relaxed)
+    }
+
+    /// Takes the pending interrupt, returning whether there was one.
+    ///
+    /// This is async-signal-safe.
+    #[inline]
+    pub(crate) fn take(&self) -> bool {
+        self.requested.swap(false, Ordering::SeqCst)
+    }
+
+    /// Requests an interrupt once the instruction counter `fd` of the current
+    /// thread reaches `limit`. The counter must have been armed to send the
+    /// interrupt signal when that happens.
+    pub(super) fn arm_instruction_budget(&self, fd: i32, limit: u64) {
+        self.budget_limit.store(limit, Ordering::Relaxed);
+        self.budget_counter.store(fd, Ordering::SeqCst);
+    }
+
+    pub(super) fn disarm_instruction_budget(&self) {
+        self.budget_counter.store(-1, Ordering::SeqCst);
+    }
+
+    /// Requests an interrupt if the armed instruction budget is exhausted.
+    ///
+    /// This is async-signal-safe.
+    pub(crate) fn check_instruction_budget(&self) {
+        let fd = self.budget_counter.load(Ordering::SeqCst);
+        if fd < 0 {
+            return;
+        }
+        let limit = self.budget_limit.load(Ordering::Relaxed);
+        if vm::read_instructions(fd).is_some_and(|n| n >= limit) {
+            self.requested.store(true, Ordering::SeqCst);
+        }
+    }
+
+    /// Records that the current thread executes WebAssembly in the store
+    /// until the returned guard is dropped.
+    pub(crate) fn enter(self: &Arc<Self>) -> InterruptGuard {
+        let prev = self.thread.lock().unwrap().replace(vm::current_thread());
+        InterruptGuard {
+            state: self.clone(),
+            prev,
+        }
+    }
+}
+
+/// See `InterruptState::enter`.
+pub(crate) struct InterruptGuard {
+    state: Arc<InterruptState>,
+    /// The thread registered by an outer call into WebAssembly on the same
+    /// thread, which is restored when this is dropped.
+    prev: Option<usize>,
+}
+
+impl Drop for InterruptGuard {
+    fn drop(&mut self) {
+        *self.state.thread.lock().unwrap() = self.prev;
+    }
+}
@@ -0,0 +1,323 @@
+//! Recording and replaying of host calls, see `Store::record_host_calls`.
+//!
+//! While recording, each call from WebAssembly to a host function is logged
+//! once it returns: the bytes of the store's linear memories that it changed,
+//! followed by its results or the message of the error it failed with.
+//! Replaying applies the logged effects in the same order instead of calling
+//! the host functions. Host calls made while a host function calls back into
+//! WebAssembly aren't logged on their own, since their effects are part of
+//! the outermost host call's.
+//!
+//! Changes are found by comparing each memory against a copy taken before
+//! the host call, so recording is slow for stores with large memories while
+//! replaying only costs as much as the logged changes.
+//!
+//! Each entry of the log is its length as a little-endian `u32` followed by:
+//!
+//! * The number of memories changed, as a `u32`, and for each of them its
+//!   index in the store, its length after the call as a `u64`, the number of
+//!   ranges of bytes that changed as a `u32`, and for each range its offset
+//!   as a `u64`, its length as a `u32` and its contents.
+//! * `0` followed by the bytes of each result if the call returned, or `1`
+//!   followed by the length of the error message as a `u32` and the message
+//!   if it failed.
+
+use super::{StoreContextMut, StoreOpaque};
+use crate::prelude::*;
+use crate::{AsContextMut, Memory, ValRaw};
+use core::mem::{self, MaybeUninit};
+use std::io::{Read, Write};
+use wasmtime_environ::WasmValType;
+
+/// Memories are compared in chunks of this many bytes, and each changed chunk
+/// is logged as the range from its first to its last changed byte.
+const CHUNK_SIZE: usize = 4096;
+
+/// The log of host calls which a store is recording or replaying.
+pub(crate) enum HostCallLog {
+    Recording(Recorder),
+    Replaying(Box<dyn Read + Send + Sync>),
+}
+
+pub(crate) struct Recorder {
+    log: Box<dyn Write + Send + Sync>,
+    /// The number of host calls being executed, of which only the outermost
+    /// is logged.
+    depth: usize,
+    /// The contents of each memory before the outermost host call, kept to
+    /// reuse their allocations.
+    snapshots: Vec<Vec<u8>>,
+}
+
+impl StoreOpaque {
+    pub(crate) fn record_host_calls(&mut self, log: Box<dyn Write + Send + Sync>) -> Result<()> {
+        if !self.engine().is_recording() {
+            bail!("the engine isn't configured with `RRConfig::Recording`");
+        }
+        if self.host_call_log.is_some() {
+            bail!("the store is already recording or replaying host calls");
+        }
+        self.host_call_log = Some(Box::new(HostCallLog::Recording(Recorder {
+            log,
+            depth: 0,
+            snapshots: Vec::new(),
+        })));
+        Ok(())
+    }
+
+    pub(crate) fn replay_host_calls(&mut self, log: Box<dyn Read + Send + Sync>) -> Result<()> {
+        if !self.engine().is_replaying() {
+            bail!("the engine isn't configured with `RRConfig::Replaying`");
+        }
+        if self.host_call_log.is_some() {
+            bail!("the store is already recording or replaying host calls");
+        }
+        self.host_call_log = Some(Box::new(HostCallLog::Replaying(log)));
+        Ok(())
+    }
+
+    pub(crate) fn stop_host_call_log(&mut self) -> Result<()> {
+        if let Some(log) = self.host_call_log.take() {
+            if let HostCallLog::Recording(mut recorder) = *log {
+                recorder
+                    .log
+                    .flush()
+                    .context("failed to flush the host call log")?;
+            }
+        }
+        Ok(())
+    }
+
+    #[inline]
+    pub(crate) fn has_host_call_log(&self) -> bool {
+        self.host_call_log.is_some()
+    }
+
+    fn recorder(&mut self) -> Option<&mut Recorder> {
+        match self.host_call_log.as_deref_mut() {
+            Some(HostCallLog::Recording(recorder)) => Some(recorder),
+            _ => None,
+        }
+    }
+
+    fn unshared_memories(&self) -> Vec<Memory> {
+        self.all_memories().filter_map(|m| m.unshared()).collect()
+    }
+}
+
+/// Calls the host function `call`, whose results have the types `results`,
+/// recording or replaying it if the store is logging host calls.
+pub(crate) fn host_call<T: 'static>(
+    mut store: StoreContextMut<'_, T>,
+    results: &[WasmValType],
+    args: &mut [MaybeUninit<ValRaw>],
+    call: impl FnOnce(StoreContextMut<'_, T>, &mut [MaybeUninit<ValRaw>]) -> Result<()>,
+) -> Result<()> {
+    match store.0.host_call_log.as_deref() {
+        Some(HostCallLog::Replaying(_)) => return replay(store, results, args),
+        Some(HostCallLog::Recording(recorder)) if recorder.depth == 0 => {}
+        _ => return call(store, args),
+    }
+
+    let memories = store.0.unshared_memories();
+    let mut snapshots = mem::take(&mut store.0.recorder().unwrap().snapshots);
+    snapshots.resize_with(memories.len(), Vec::new);
+    for (memory, snapshot) in memories.iter().zip(&mut snapshots) {
+        snapshot.clear();
+        snapshot.extend_from_slice(memory.internal_data_mut(store.0));
+    }
+
+    store.0.recorder().unwrap().depth += 1;
+    let ret = call(store.as_context_mut(), args);
+
+    // The host function may have stopped the recording itself.
+    let Some(recorder) = store.0.recorder() else {
+        return ret;
+    };
+    recorder.depth -= 1;
+    let logged = encode(store.0, &memories, &mut snapshots, results, args, &ret)
+        .and_then(|entry| store.0.recorder().unwrap().write(&entry))
+        .context("failed to record host call");
+    store.0.recorder().unwrap().snapshots = snapshots;
+    logged?;
+    ret
+}
+
+impl Recorder {
+    fn write(&mut self, entry: &[u8]) -> Result<()> {
+        let len = u32::try_from(entry.len()).context("host call changed too much memory")?;
+        self.log.write_all(&len.to_le_bytes())?;
+        self.log.write_all(entry)?;
+        Ok(())
+    }
+}
+
+/// Encodes the effects of a host call as an entry of the log.
+fn encode(
+    store: &mut StoreOpaque,
+    memories: &[Memory],
+    snapshots: &mut [Vec<u8>],
+    results: &[WasmValType],
+    args: &[MaybeUninit<ValRaw>],
+    ret: &Result<()>,
+) -> Result<Vec<u8>> {
+    if store.unshared_memories().len() != memories.len() {
+        bail!("host calls which create memories can't be recorded");
+    }
+
+    let mut entry = Vec::new();
+    let mut changed = 0u32;
+    entry.extend_from_slice(&changed.to_le_bytes());
+    for (index, (memory, snapshot)) in memories.iter().zip(snapshots).enumerate() {
+        let data = memory.internal_data_mut(store);
+        // Memories can only grow, and new pages are zero.
+        let grown = data.len() != snapshot.len();
+        snapshot.resize(data.len(), 0);
+        let ranges = data
+            .chunks(CHUNK_SIZE)
+            .zip(snapshot.chunks(CHUNK_SIZE))
+            .enumerate()
+            .filter(|(_, (new, old))| new != old)
+            .map(|(i, (new, old))| {
+                let differs = |(a, b): (&u8, &u8)| a != b;
+                let start = new.iter().zip(old).position(differs).unwrap();
+                let end = new.iter().zip(old).rposition(differs).unwrap() + 1;
+                (i * CHUNK_SIZE + start, &new[start..end])
+            })
+            .collect::<Vec<_>>();
+        if ranges.is_empty() && !grown {
+            continue;
+        }
+        changed += 1;
+        entry.extend_from_slice(&u32::try_from(index)?.to_le_bytes());
+        entry.extend_from_slice(&u64::try_from(data.len())?.to_le_bytes());
+        entry.extend_from_slice(&u32::try_from(ranges.len())?.to_le_bytes());
+        for (offset, bytes) in ranges {
+            entry.extend_from_slice(&u64::try_from(offset)?.to_le_bytes());
+            entry.extend_from_slice(&u32::try_from(bytes.len())?.to_le_bytes());
+            entry.extend_from_slice(bytes);
+        }
+    }
+    entry[..4].copy_from_slice(&changed.to_le_bytes());
+
+    match ret {
+        Ok(()) => {
+            entry.push(0);
+            for (ty, val) in results.iter().zip(args) {
+                // SAFETY: the host function returned successfully, so it
+                // initialized its results.
+                let val = unsafe { val.assume_init_ref() };
+                match ty {
+                    WasmValType::I32 => entry.extend_from_slice(&val.get_u32().to_le_bytes()),
+                    WasmValType::F32 => entry.extend_from_slice(&val.get_f32().to_le_bytes()),
+                    WasmValType::I64 => entry.extend_from_slice(&val.get_u64().to_le_bytes()),
+                    WasmValType::F64 => entry.extend_from_slice(&val.get_f64().to_le_bytes()),
+                    WasmValType::V128 => entry.extend_from_slice(&val.get_v128().to_le_bytes()),
+                    WasmValType::Ref(_) => {
+                        bail!("host functions returning references can't be recorded")
+                    }
+                }
+            }
+        }
+        Err(e) => {
+            let message = format!("{e:#}");
+            entry.push(1);
+            entry.extend_from_slice(&u32::try_from(message.len())?.to_le_bytes());
+            entry.extend_from_slice(message.as_bytes());
+        }
+    }
+    Ok(entry)
+}
+
+/// Applies the next logged host call instead of calling the host function.
+fn replay<T: 'static>(
+    mut store: StoreContextMut<'_, T>,
+    results: &[WasmValType],
+    args: &mut [MaybeUninit<ValRaw>],
+) -> Result<()> {
+    let Some(HostCallLog::Replaying(log)) = store.0.host_call_log.as_deref_mut() else {
+        unreachable!()
+    };
+    let mut len = [0; 4];
+    log.read_exact(&mut len)
+        .context("failed to read the host call log, it may be exhausted")?;
+    let mut entry = vec![0; usize::try_from(u32::from_le_bytes(len))?];
+    log.read_exact(&mut entry)
+        .context("failed to read the host call log")?;
+    let mut entry = Cursor(&entry);
+
+    let memories = store.0.unshared_memories();
+    for _ in 0..entry.u32()? {
+        let memory = usize::try_from(entry.u32()?)?;
+        let Some(memory) = memories.get(memory) else {
+            bail!("host call log doesn't match the store's memories");
+        };
+        let len = usize::try_from(entry.u64()?)?;
+        let current = memory.internal_data_size(store.0);
+        if len > current {
+            let page_size = usize::try_from(memory.page_size(&store))?;
+            memory.grow(&mut store, u64::try_from((len - current) / page_size)?)?;
+        }
+        for _ in 0..entry.u32()? {
+            let offset = usize::try_from(entry.u64()?)?;
+            let bytes = entry.bytes(usize::try_from(entry.u32()?)?)?;
+            let Some(dst) = memory
+                .internal_data_mut(store.0)
+                .get_mut(offset..)
+                .and_then(|d| d.get_mut(..bytes.len()))
+            else {
+                bail!("host call log doesn't match the store's memories");
+            };
+            dst.copy_from_slice(bytes);
+        }
+    }
+
+    match entry.bytes(1)?[0] {
+        0 => {
+            for (ty, val) in results.iter().zip(args) {
+                let raw = match ty {
+                    WasmValType::I32 => ValRaw::u32(u32::from_le_bytes(entry.array()?)),
+                    WasmValType::F32 => ValRaw::f32(u32::from_le_bytes(entry.array()?)),
+                    WasmValType::I64 => ValRaw::u64(u64::from_le_bytes(entry.array()?)),
+                    WasmValType::F64 => ValRaw::f64(u64::from_le_bytes(entry.array()?)),
+                    WasmValType::V128 => ValRaw::v128(u128::from_le_bytes(entry.array()?)),
+                    WasmValType::Ref(_) => bail!("host call log contains a reference"),
+                };
+                val.write(raw);
+            }
+            Ok(())
+        }
+        1 => {
+            let len = usize::try_from(entry.u32()?)?;
+            let message = core::str::from_utf8(entry.bytes(len)?)?;
+            Err(format_err!("{message}"))
+        }
+        _ => bail!("malformed host call log"),
+    }
+}
+
+/// A reader of the fields of an entry of the log.
+struct Cursor<'a>(&'a [u8]);
+
+impl<'a> Cursor<'a> {
+    fn bytes(&mut self, len: usize) -> Result<&'a [u8]> {
+        if self.0.len() < len {
+            bail!("malformed host call log");
+        }
+        let (bytes, rest) = self.0.split_at(len);
+        self.0 = rest;
+        Ok(bytes)
+    }
+
+    fn array<const N: usize>(&mut self) -> Result<[u8; N]> {
+        Ok(self.bytes(N)?.try_into().unwrap())
+    }
+
+    fn u32(&mut self) -> Result<u32> {
+        Ok(u32::from_le_bytes(self.array()?))
+    }
+
+    fn u64(&mut self) -> Result<u64> {
+        Ok(u64::from_le_bytes(self.array()?))
+    }
+}
@@ -0,0 +1,56 @@
+//! Recording of transitions between WebAssembly and host code into a bounded
+//! buffer, as a cheaper alternative to a call hook.
+
+use crate::CallHook;
+use crate::prelude::*;
+use core::mem;
+use std::collections::VecDeque;
+use std::time::Instant;
+
+/// A transition between WebAssembly and host code recorded by a store, as
+/// returned by [`Store::take_call_transitions`](crate::Store::take_call_transitions).
+#[derive(Copy, Clone, Debug)]
+pub struct CallTransition {
+    /// The kind of transition.
+    pub kind: CallHook,
+    /// When the transition happened.
+    pub timestamp: Instant,
+}
+
+/// A ring buffer of the most recent transitions of a store.
+pub(super) struct CallTransitions {
+    buffer: VecDeque<CallTransition>,
+    capacity: usize,
+    dropped: u64,
+}
+
+impl CallTransitions {
+    pub(super) fn new(capacity: usize) -> Self {
+        Self {
+            buffer: VecDeque::with_capacity(capacity),
+            capacity,
+            dropped: 0,
+        }
+    }
+
+    #[inline]
+    pub(super) fn record(&mut self, kind: CallHook) {
+        if self.buffer.len() == self.capacity {
+            self.dropped += 1;
+            if self.buffer.pop_front().is_none() {
+                return;
+            }
+        }
+        self.buffer.push_back(CallTransition {
+            kind,
+            timestamp: Instant::now(),
+        });
+    }
+
+    /// Returns the recorded transitions, oldest first, and the number of
+    /// transitions which were overwritten, and resets both.
+    pub(super) fn take(&mut self) -> (Vec<CallTransition>, u64) {
+        let transitions = self.buffer.drain(..).collect();
+        (transitions, mem::take(&mut self.dropped))
+    }
+}
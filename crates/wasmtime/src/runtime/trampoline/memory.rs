@@ -9,6 +9,7 @@ use crate::runtime::vm::{
 };
 use crate::store::{AllocateInstanceKind, InstanceId, StoreOpaque, StoreResourceLimiter};
 use alloc::sync::Arc;
+use core::mem::ManuallyDrop;
 use wasmtime_environ::{
     DefinedMemoryIndex, DefinedTableIndex, EntityIndex, HostPtr, Module, StaticModuleIndex,
     Tunables, VMOffsets,
@@ -66,7 +67,16 @@ pub async fn create_memory(
 }
 
 struct LinearMemoryProxy {
-    mem: Box<dyn LinearMemory>,
+    mem: ManuallyDrop<Box<dyn LinearMemory>>,
+    creator: Arc<dyn MemoryCreator>,
+}
+
+impl Drop for LinearMemoryProxy {
+    fn drop(&mut self) {
+        // SAFETY: `self.mem` isn't used again.
+        let mem = unsafe { ManuallyDrop::take(&mut self.mem) };
+        self.creator.reuse_memory(mem);
+    }
 }
 
 impl RuntimeLinearMemory for LinearMemoryProxy {
@@ -115,7 +125,12 @@ impl RuntimeMemoryCreator for MemoryCreatorProxy {
                 reserved_size_in_bytes,
                 usize::try_from(tunables.memory_guard_size).unwrap(),
             )
-            .map(|mem| Box::new(LinearMemoryProxy { mem }) as Box<dyn RuntimeLinearMemory>)
+            .map(|mem| {
+                Box::new(LinearMemoryProxy {
+                    mem: ManuallyDrop::new(mem),
+                    creator: self.0.clone(),
+                }) as Box<dyn RuntimeLinearMemory>
+            })
             .map_err(|e| format_err!(e))
     }
 }
@@ -242,6 +257,10 @@ unsafe impl InstanceAllocator for SingleMemoryInstance<'_> {
         unreachable!()
     }
 
+    fn trim(&self, _target_bytes: usize) -> usize {
+        0
+    }
+
     fn next_available_pkey(&self) -> Option<ProtectionKey> {
         unreachable!()
     }
@@ -4,9 +4,12 @@ use super::coredump::WasmCoreDump;
 use crate::ThrownException;
 use crate::prelude::*;
 use crate::store::StoreOpaque;
+use crate::sync::OnceLock;
 use crate::{AsContext, Module};
 use core::fmt;
-use wasmtime_environ::{FilePos, demangle_function_name, demangle_function_name_or_index};
+use wasmtime_environ::{
+    FilePos, FuncIndex, demangle_function_name, demangle_function_name_or_index,
+};
 
 /// Representation of a WebAssembly trap and what caused it to occur.
 ///
@@ -84,6 +87,14 @@ pub(crate) fn from_runtime_box(
         backtrace,
         coredumpstack,
     } = *runtime_trap;
+    if let crate::runtime::vm::TrapReason::Jit { trap, .. }
+    | crate::runtime::vm::TrapReason::Wasm(trap) = &reason
+    {
+        let code = *trap;
+        store
+            .engine()
+            .record_event(|| crate::RuntimeEventKind::Trap { code });
+    }
     let (mut error, pc) = match reason {
         #[cfg(feature = "gc")]
         crate::runtime::vm::TrapReason::Exception => (ThrownException.into(), None),
@@ -207,8 +218,8 @@ impl WasmBacktrace {
     /// backtrace will have no frames in it.
     ///
     /// Note that this function will respect the [`Config::wasm_backtrace`]
-    /// configuration option and will return an empty backtrace if that is
-    /// disabled. To always capture a backtrace use the
+    /// configuration option, and [`Store::set_wasm_backtrace`], and will
+    /// return an empty backtrace if that is disabled. To always capture a backtrace use the
     /// [`WasmBacktrace::force_capture`] method.
     ///
     /// Also note that this function will only capture frames from the
@@ -216,6 +227,7 @@ impl WasmBacktrace {
     /// present.
     ///
     /// [`Config::wasm_backtrace`]: crate::Config::wasm_backtrace
+    /// [`Store::set_wasm_backtrace`]: crate::Store::set_wasm_backtrace
     ///
     /// # Example
     ///
@@ -247,7 +259,7 @@ impl WasmBacktrace {
     /// ```
     pub fn capture(store: impl AsContext) -> WasmBacktrace {
         let store = store.as_context();
-        if store.engine().config().wasm_backtrace {
+        if store.0.wasm_backtrace() {
             Self::force_capture(store)
         } else {
             WasmBacktrace {
@@ -427,14 +439,16 @@ impl fmt::Display for WasmBacktrace {
 /// Whenever an error happens while WebAssembly is executing a
 /// [`WasmBacktrace`] will be attached to the error returned which can be used
 /// to acquire this `FrameInfo`. For more information see [`WasmBacktrace`].
-#[derive(Debug)]
+///
+/// Capturing a frame only records its function and instruction. The debug
+/// information of its module, if any, isn't consulted until
+/// [`FrameInfo::symbols`] is first called.
 pub struct FrameInfo {
     module: Module,
     func_index: u32,
-    func_name: Option<String>,
     func_start: FilePos,
     instr: Option<FilePos>,
-    symbols: Vec<FrameSymbol>,
+    symbols: OnceLock<Vec<FrameSymbol>>,
 }
 
 impl FrameInfo {
@@ -448,9 +462,7 @@ impl FrameInfo {
         let func_start = compiled_module.func_start_srcloc(index);
         let instr =
             wasmtime_environ::lookup_file_pos(module.engine_code().address_map_data(), text_offset);
-        let index = compiled_module.module().func_index(index);
-        let func_index = index.as_u32();
-        let func_name = compiled_module.func_name(index).map(|s| s.to_string());
+        let func_index = compiled_module.module().func_index(index).as_u32();
 
         // In debug mode for now assert that we found a mapping for `pc` within
         // the function, because otherwise something is buggy along the way and
@@ -464,6 +476,17 @@ impl FrameInfo {
             "failed to find instruction for {text_offset:#x}"
         );
 
+        Some(FrameInfo {
+            module,
+            func_index,
+            instr,
+            func_start,
+            symbols: OnceLock::new(),
+        })
+    }
+
+    /// Looks up the debug symbols of this frame, for `FrameInfo::symbols`.
+    fn symbolize(&self) -> Vec<FrameSymbol> {
         // Use our wasm-relative pc to symbolize this frame. If there's a
         // symbolication context (dwarf debug info) available then we can try to
         // look this up there.
@@ -476,8 +499,14 @@ impl FrameInfo {
 
         let _ = &mut symbols;
         #[cfg(feature = "addr2line")]
-        if let Some(s) = &compiled_module.symbolize_context().ok().and_then(|c| c) {
-            if let Some(offset) = instr.and_then(|i| i.file_offset()) {
+        if let Some(s) = &self
+            .module
+            .compiled_module()
+            .symbolize_context()
+            .ok()
+            .and_then(|c| c)
+        {
+            if let Some(offset) = self.instr.and_then(|i| i.file_offset()) {
                 let to_lookup = u64::from(offset) - s.code_section_offset();
                 if let Ok(mut frames) = s.addr2line().find_frames(to_lookup).skip_all_loads() {
                     while let Ok(Some(frame)) = frames.next() {
@@ -500,14 +529,7 @@ impl FrameInfo {
             }
         }
 
-        Some(FrameInfo {
-            module,
-            func_index,
-            func_name,
-            instr,
-            func_start,
-            symbols,
-        })
+        symbols
     }
 
     /// Returns the WebAssembly function index for this frame.
@@ -540,7 +562,9 @@ impl FrameInfo {
     ///
     /// This function returns `None` when no name could be inferred.
     pub fn func_name(&self) -> Option<&str> {
-        self.func_name.as_deref()
+        self.module
+            .compiled_module()
+            .func_name(FuncIndex::from_u32(self.func_index))
     }
 
     /// Returns the offset within the original wasm module this frame's program
@@ -582,8 +606,23 @@ impl FrameInfo {
     /// information about a frame including the filename and line number. If no
     /// debug information was found or if it was malformed then this will return
     /// an empty array.
+    ///
+    /// The debug information is only parsed the first time this is called.
     pub fn symbols(&self) -> &[FrameSymbol] {
-        &self.symbols
+        self.symbols.get_or_init(|| self.symbolize())
+    }
+}
+
+impl fmt::Debug for FrameInfo {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("FrameInfo")
+            .field("module", &self.module)
+            .field("func_index", &self.func_index)
+            .field("func_name", &self.func_name())
+            .field("func_start", &self.func_start)
+            .field("instr", &self.instr)
+            .field("symbols", &self.symbols())
+            .finish()
     }
 }
 
@@ -7,7 +7,7 @@ use crate::Engine;
 use crate::error::OutOfMemory;
 use crate::hash_set::HashSet;
 use crate::prelude::*;
-use crate::sync::RwLock;
+use crate::sync::ShardedRwLock;
 use crate::vm::GcRuntime;
 use alloc::borrow::Cow;
 use alloc::sync::Arc;
@@ -181,6 +181,11 @@ impl Engine {
 }
 
 impl TypeCollection {
+    /// Get the engine whose registry these types are registered within.
+    pub fn engine(&self) -> &Engine {
+        &self.engine
+    }
+
     /// Treats the type collection as a map from a module type index to
     /// registered shared type indexes.
     ///
@@ -212,6 +217,12 @@ impl TypeCollection {
         log::trace!("TypeCollection::trampoline_type({ty:?}) -> {trampoline_ty:?}");
         trampoline_ty
     }
+
+    /// Returns the number of wasm-to-array trampolines that this collection's
+    /// associated module has compiled.
+    pub fn trampoline_count(&self) -> usize {
+        self.trampolines.values().filter(|t| t.is_some()).count()
+    }
 }
 
 impl Drop for TypeCollection {
@@ -1561,13 +1572,23 @@ impl Drop for TypeRegistryInner {
 /// call must match. To implement this efficiently, keep a registry of all
 /// types, shared by all instances, so that call sites can just do an
 /// index comparison.
+///
+/// Types are looked up far more often than they're registered, for example
+/// every instantiation looks up the types of its module, so the registry uses
+/// a sharded lock on which readers on different threads don't contend.
 #[derive(Debug)]
-pub struct TypeRegistry(RwLock<TypeRegistryInner>);
+pub struct TypeRegistry(ShardedRwLock<TypeRegistryInner>);
 
 impl TypeRegistry {
     /// Creates a new shared type registry.
     pub fn new() -> Self {
-        Self(RwLock::new(TypeRegistryInner::default()))
+        Self(ShardedRwLock::new(TypeRegistryInner::default()))
+    }
+
+    /// Returns the number of types and rec groups currently registered.
+    pub fn len(&self) -> (usize, usize) {
+        let inner = self.0.read();
+        (inner.types.len(), inner.hash_consing_map.len())
     }
 
     #[inline]
@@ -4,7 +4,7 @@ use crate::{
     StructRef, V128, ValType, prelude::*,
 };
 use core::ptr;
-use wasmtime_environ::WasmHeapTopType;
+use wasmtime_environ::{ConstOp, WasmHeapTopType};
 
 pub use crate::runtime::vm::ValRaw;
 
@@ -125,6 +125,19 @@ impl Val {
         Val::AnyRef(None)
     }
 
+    /// Returns the constant expression which evaluates to this value, if this
+    /// isn't a reference.
+    pub(crate) fn const_op(&self) -> Option<ConstOp> {
+        match *self {
+            Val::I32(x) => Some(ConstOp::I32Const(x)),
+            Val::I64(x) => Some(ConstOp::I64Const(x)),
+            Val::F32(x) => Some(ConstOp::F32Const(x)),
+            Val::F64(x) => Some(ConstOp::F64Const(x)),
+            Val::V128(x) => Some(ConstOp::V128Const(x.as_u128())),
+            _ => None,
+        }
+    }
+
     pub(crate) const fn null_top(top: WasmHeapTopType) -> Val {
         match top {
             WasmHeapTopType::Func => Val::FuncRef(None),
@@ -109,16 +109,24 @@ pub use crate::runtime::vm::instance::{
 };
 pub use crate::runtime::vm::interpreter::*;
 pub use crate::runtime::vm::memory::{
-    Memory, MemoryBase, RuntimeLinearMemory, RuntimeMemoryCreator, SharedMemory,
+    Memory, MemoryBase, RuntimeLinearMemory, RuntimeMemoryCreator, SharedMemory, SharedMemoryHook,
 };
 pub use crate::runtime::vm::mmap_vec::MmapVec;
 pub use crate::runtime::vm::provenance::*;
 pub use crate::runtime::vm::stack_switching::*;
 pub use crate::runtime::vm::store_box::*;
+#[cfg(all(feature = "std", unix, has_native_signals))]
+pub use crate::runtime::vm::sys::cpu::*;
 #[cfg(feature = "std")]
 pub use crate::runtime::vm::sys::mmap::open_file_for_mmap;
+#[cfg(all(feature = "std", unix, has_native_signals))]
+pub use crate::runtime::vm::sys::signals::{
+    INTERRUPT_SIGNAL, current_thread, init_interrupts, interrupt_thread,
+};
 #[cfg(has_host_compiler_backend)]
 pub use crate::runtime::vm::sys::unwind::UnwindRegistration;
+#[cfg(all(unix, feature = "std", not(miri)))]
+pub use crate::runtime::vm::sys::vm::MemoryImageSource;
 pub use crate::runtime::vm::table::{Table, TableElementType};
 #[cfg(feature = "gc")]
 pub use crate::runtime::vm::throw::*;
@@ -415,6 +423,62 @@ pub fn host_page_size() -> usize {
     };
 }
 
+/// Returns whether the host supports backing memory with transparent huge
+/// pages.
+pub fn huge_pages_available() -> bool {
+    #[cfg(has_virtual_memory)]
+    return sys::vm::supports_huge_pages();
+    #[cfg(not(has_virtual_memory))]
+    return false;
+}
+
+/// Asks the host to back the `len` bytes of mapped memory at `ptr`, which must
+/// be page-aligned, with transparent huge pages.
+///
+/// # Safety
+///
+/// The range must be part of a mapping owned by the caller.
+#[cfg(has_virtual_memory)]
+pub unsafe fn advise_huge_pages(ptr: *mut u8, len: usize) -> Result<()> {
+    unsafe {
+        sys::vm::advise_huge_pages(ptr, len)?;
+    }
+    Ok(())
+}
+
+/// Returns the NUMA node of the CPU that the current thread is running on, if
+/// the host supports NUMA placement of memory.
+pub fn current_numa_node() -> Option<u32> {
+    #[cfg(has_virtual_memory)]
+    return sys::vm::current_numa_node();
+    #[cfg(not(has_virtual_memory))]
+    return None;
+}
+
+/// Asks the host to allocate the pages of the `len` bytes of mapped memory at
+/// `ptr`, which must be page-aligned, on NUMA `node`, also migrating pages
+/// which are already resident there if `migrate` is set. With `None` the
+/// host's default policy is restored instead.
+///
+/// Migrating requires the host to walk the range's page tables, so it should
+/// only be requested for the part of the range which may be resident.
+///
+/// # Safety
+///
+/// The range must be part of a mapping owned by the caller.
+#[cfg(has_virtual_memory)]
+pub unsafe fn bind_numa_node(
+    ptr: *mut u8,
+    len: usize,
+    node: Option<u32>,
+    migrate: bool,
+) -> Result<()> {
+    unsafe {
+        sys::vm::bind_numa_node(ptr, len, node, migrate)?;
+    }
+    Ok(())
+}
+
 /// Result of `Memory::atomic_wait32` and `Memory::atomic_wait64`
 #[derive(Copy, Clone, PartialEq, Eq, Debug)]
 pub enum WaitResult {
@@ -429,6 +493,29 @@ pub enum WaitResult {
     TimedOut = 2,
 }
 
+/// An atomic wait or notify operation on a shared memory, passed to the hook
+/// installed with `SharedMemory::set_atomic_hook`.
+#[derive(Copy, Clone, PartialEq, Eq, Debug)]
+#[non_exhaustive]
+pub enum SharedMemoryEvent {
+    /// A thread is about to wait on the byte address `addr`, and will block if
+    /// the value there is still the expected value.
+    Wait {
+        /// The address being waited on.
+        addr: u64,
+    },
+    /// A thread notified up to `count` waiters on the byte address `addr`, of
+    /// which `woken` were woken.
+    Notify {
+        /// The address that was notified.
+        addr: u64,
+        /// The maximum number of waiters to wake.
+        count: u32,
+        /// The number of waiters that were actually woken.
+        woken: u32,
+    },
+}
+
 /// Description about a fault that occurred in WebAssembly.
 #[derive(Debug)]
 pub struct WasmFault {
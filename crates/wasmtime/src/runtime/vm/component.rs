@@ -77,6 +77,72 @@ impl InstanceState {
     }
 }
 
+/// Regions of guest memory which the string and list arguments of calls to a
+/// component instance's exports are lowered into.
+///
+/// Regions are allocated with the guest's `realloc` function the first time
+/// they're needed and are then reused by every following call, which starts
+/// allocating from the beginning of them again.
+#[derive(Default)]
+pub struct ArgumentScratch {
+    regions: Vec<ScratchRegion>,
+}
+
+struct ScratchRegion {
+    realloc: RuntimeReallocIndex,
+    base: usize,
+    size: usize,
+    used: usize,
+}
+
+impl ArgumentScratch {
+    /// The minimum size of a region, so that small arguments share one.
+    pub const MIN_REGION_SIZE: usize = 4096;
+
+    /// The alignment requested for regions, which is the largest alignment of
+    /// any component value.
+    pub const REGION_ALIGN: u32 = 8;
+
+    /// Marks all regions as unused, for the start of a new call.
+    pub fn reset(&mut self) {
+        for region in self.regions.iter_mut() {
+            region.used = 0;
+        }
+    }
+
+    /// Allocates `size` bytes aligned to `align` from a region which was
+    /// allocated with `realloc`, returning `None` if none have enough space
+    /// left.
+    pub fn alloc(
+        &mut self,
+        realloc: RuntimeReallocIndex,
+        align: u32,
+        size: usize,
+    ) -> Option<usize> {
+        let align = usize::try_from(align).ok()?;
+        for region in self.regions.iter_mut().filter(|r| r.realloc == realloc) {
+            let start = (region.base + region.used).checked_next_multiple_of(align)?;
+            let end = start.checked_add(size)?;
+            if end <= region.base + region.size {
+                region.used = end - region.base;
+                return Some(start);
+            }
+        }
+        None
+    }
+
+    /// Adds a region of `size` bytes at `base` which was allocated with
+    /// `realloc`, with its first `used` bytes already in use.
+    pub fn push(&mut self, realloc: RuntimeReallocIndex, base: usize, size: usize, used: usize) {
+        self.regions.push(ScratchRegion {
+            realloc,
+            base,
+            size,
+            used,
+        });
+    }
+}
+
 /// Runtime representation of a component instance and all state necessary for
 /// the instance itself.
 ///
@@ -145,6 +211,10 @@ pub struct ComponentInstance {
     /// duration of the lifetime of this instance.
     imports: Arc<PrimaryMap<RuntimeImportIndex, RuntimeImport>>,
 
+    /// Guest memory reused to lower the arguments of calls to exports, if
+    /// enabled with `Instance::set_argument_scratch`.
+    argument_scratch: Option<ArgumentScratch>,
+
     /// Self-pointer back to `Store<T>` and its functions.
     store: VMStoreRawPtr,
 
@@ -334,6 +404,7 @@ impl ComponentInstance {
             component: component.clone(),
             resource_types,
             imports: imports.clone(),
+            argument_scratch: None,
             store: VMStoreRawPtr(store),
             vmctx: OwnedVMContext::new(),
         })?;
@@ -911,6 +982,26 @@ impl ComponentInstance {
         self.instances[idx]
     }
 
+    /// Returns the regions used to lower arguments to exports, if enabled.
+    pub fn argument_scratch(self: Pin<&mut Self>) -> Option<&mut ArgumentScratch> {
+        // SAFETY: we've chosen the `Pin` guarantee of `Self` to not apply to
+        // the scratch returned.
+        unsafe { self.get_unchecked_mut().argument_scratch.as_mut() }
+    }
+
+    /// Enables or disables `argument_scratch`, where disabling it forgets
+    /// about any regions which were allocated.
+    pub fn set_argument_scratch(self: Pin<&mut Self>, enable: bool) {
+        // SAFETY: we've chosen the `Pin` guarantee of `Self` to not apply to
+        // the scratch.
+        let scratch = unsafe { &mut self.get_unchecked_mut().argument_scratch };
+        if !enable {
+            *scratch = None;
+        } else if scratch.is_none() {
+            *scratch = Some(ArgumentScratch::default());
+        }
+    }
+
     fn instances_mut(self: Pin<&mut Self>) -> &mut PrimaryMap<RuntimeInstanceIndex, InstanceId> {
         // SAFETY: we've chosen the `Pin` guarantee of `Self` to not apply to
         // the map returned.
@@ -4,7 +4,9 @@
 use super::sys::DecommitBehavior;
 use crate::Engine;
 use crate::prelude::*;
-use crate::runtime::vm::sys::vm::{self, MemoryImageSource, PageMap, reset_with_pagemap};
+use crate::runtime::vm::sys::vm::{
+    self, MemoryImageSource, PageMap, reset_with_pagemap, written_regions,
+};
 use crate::runtime::vm::{
     HostAlignedByteCount, MmapOffset, ModuleMemoryImageSource, host_page_size,
 };
@@ -239,6 +241,34 @@ impl ModuleMemoryImages {
 
         Ok(Some(ModuleMemoryImages { memories }))
     }
+
+    /// Creates images for the defined memories of an instance from snapshots
+    /// of their contents.
+    ///
+    /// Each item of `snapshots` is, in order of defined memory index, the
+    /// source of the contents of a memory, the offset in linear memory that
+    /// they start at, and how many bytes at their start should be mapped. The
+    /// offset and length must be multiples of the host page size. Memories
+    /// with nothing to map, or whose image can't be created on this platform,
+    /// get no image.
+    pub fn from_snapshots(
+        engine: &Engine,
+        snapshots: impl IntoIterator<Item = (Arc<impl ModuleMemoryImageSource>, usize, usize)>,
+    ) -> Result<ModuleMemoryImages> {
+        let page_size = u32::try_from(host_page_size()).unwrap();
+        let mut memories = PrimaryMap::new();
+        for (source, offset, len) in snapshots {
+            let image = if len == 0 {
+                None
+            } else {
+                let offset = HostAlignedByteCount::new(offset)
+                    .expect("snapshot offset is a multiple of the host page size");
+                MemoryImage::new(engine, page_size, offset, &source, 0..len)?.map(Arc::new)
+            };
+            memories.push(image);
+        }
+        Ok(ModuleMemoryImages { memories })
+    }
 }
 
 /// Slot management of a copy-on-write image which can be reused for the pooling
@@ -333,6 +363,20 @@ pub struct MemoryImageSlot {
     /// initial image content, as appropriate. Everything between
     /// `self.accessible` and `self.static_size` is inaccessible.
     dirty: bool,
+
+    /// Whether the embedder has mapped something other than `image` or
+    /// anonymous memory into this slot, for example with
+    /// `LocalMemory::map_file`.
+    ///
+    /// Restoring the original mapping of such a slot would restore the
+    /// foreign contents too, so when this is set the slot is instead reset
+    /// with fresh anonymous memory.
+    foreign_mappings: bool,
+
+    /// The NUMA node which the whole slot is known to be bound to, `Some(None)`
+    /// for the default policy, or `None` if part of a bound slot was remapped
+    /// since, which reverts that part to the default policy.
+    numa_node: Option<Option<u32>>,
 }
 
 impl fmt::Debug for MemoryImageSlot {
@@ -342,6 +386,8 @@ impl fmt::Debug for MemoryImageSlot {
             .field("static_size", &self.static_size)
             .field("accessible", &self.accessible)
             .field("dirty", &self.dirty)
+            .field("foreign_mappings", &self.foreign_mappings)
+            .field("numa_node", &self.numa_node)
             .finish_non_exhaustive()
     }
 }
@@ -366,6 +412,8 @@ impl MemoryImageSlot {
             accessible,
             image: None,
             dirty: false,
+            foreign_mappings: false,
+            numa_node: Some(None),
         }
     }
 
@@ -485,6 +533,7 @@ impl MemoryImageSlot {
                     unsafe {
                         image.map_at(&self.base)?;
                     }
+                    self.forget_numa_node();
                 }
             }
             self.image = maybe_image.cloned();
@@ -503,6 +552,7 @@ impl MemoryImageSlot {
                 image.remap_as_zeros_at(self.base.as_mut_ptr())?;
             }
             self.image = None;
+            self.forget_numa_node();
         }
         Ok(())
     }
@@ -533,6 +583,67 @@ impl MemoryImageSlot {
         Ok(bytes_resident)
     }
 
+    /// Restores the pages of this slot which have been written, as found with
+    /// `pagemap`, back to their original contents.
+    ///
+    /// Only written pages are decommitted, which on Linux maps them back to
+    /// the image, or to zeros outside of it. Pages which wasm only read, or
+    /// never touched, are left as-is.
+    pub(crate) fn reset_dirty_to_image(&mut self, pagemap: &PageMap) -> Result<()> {
+        if self.foreign_mappings {
+            bail!("memory has had a file mapped into it and has no image to reset to");
+        }
+        assert_eq!(
+            vm::decommit_behavior(),
+            DecommitBehavior::RestoreOriginalMapping
+        );
+        let base = self.base.as_mut_ptr();
+        let mut result = Ok(());
+        written_regions(pagemap, base, self.accessible, |region| {
+            if result.is_ok() {
+                // SAFETY: `region` is within the accessible part of this slot,
+                // which is owned by this slot.
+                result = unsafe { vm::decommit_pages(base.add(region.start), region.len()) };
+            }
+        })?;
+        result.context("failed to decommit dirty pages")
+    }
+
+    /// Restores all of the accessible memory of this slot back to its
+    /// original contents, by mapping zeros over it and then mapping its image
+    /// in again.
+    ///
+    /// This is used on custom platforms, which don't have dirty page tracking
+    /// but whose `wasmtime_memory_image_map_at` can map an image cheaply, for
+    /// example copy-on-write.
+    #[cfg(not(feature = "std"))]
+    pub(crate) fn reset_to_image(&mut self) -> Result<()> {
+        if self.foreign_mappings {
+            bail!("memory has had a file mapped into it and has no image to reset to");
+        }
+        if self.accessible.is_zero() {
+            return Ok(());
+        }
+        let base = self.base.as_mut_ptr();
+        let len = self.accessible.byte_count();
+        self.forget_numa_node();
+        unsafe {
+            match &self.image {
+                Some(image) => {
+                    image.source.remap_as_zeros_at(base, len)?;
+                    if !image.len.is_zero() {
+                        image.map_at(&self.base)?;
+                    }
+                }
+                None => {
+                    vm::erase_existing_mapping(base, len)?;
+                    vm::expose_existing_mapping(base, len)?;
+                }
+            }
+        }
+        Ok(())
+    }
+
     #[allow(dead_code, reason = "only used in some cfgs")]
     unsafe fn reset_all_memory_contents(
         &mut self,
@@ -540,6 +651,10 @@ impl MemoryImageSlot {
         keep_resident: HostAlignedByteCount,
         decommit: impl FnMut(*mut u8, usize),
     ) -> Result<usize> {
+        if self.foreign_mappings {
+            self.reset_with_anon_memory()?;
+            return Ok(0);
+        }
         match vm::decommit_behavior() {
             DecommitBehavior::Zero => {
                 // If we're not on Linux then there's no generic platform way to
@@ -678,6 +793,13 @@ impl MemoryImageSlot {
         Ok(())
     }
 
+    /// Returns the range of the slot which maps its image, if it has one.
+    pub(crate) fn image_range(&self) -> Option<Range<usize>> {
+        let image = self.image.as_ref()?;
+        let start = image.linear_memory_offset.byte_count();
+        Some(start..start + image.len.byte_count())
+    }
+
     pub(crate) fn has_image(&self) -> bool {
         self.image.is_some()
     }
@@ -687,6 +809,70 @@ impl MemoryImageSlot {
         self.dirty
     }
 
+    /// Zeroes the `len` bytes at `offset` in this slot, which must be
+    /// accessible, and releases the physical memory backing them, see
+    /// `LocalMemory::discard`.
+    ///
+    /// Releasing pages which map the image, or something else mapped by the
+    /// embedder, would reveal what they map again, so fresh anonymous memory
+    /// is mapped over them instead and the slot is then treated like one with
+    /// foreign mappings.
+    #[cfg(all(unix, feature = "std", not(miri)))]
+    pub(crate) fn discard(
+        &mut self,
+        offset: HostAlignedByteCount,
+        len: HostAlignedByteCount,
+    ) -> Result<()> {
+        let end = offset.checked_add(len)?;
+        assert!(end <= self.accessible);
+        let overlaps_image = self.image.as_ref().is_some_and(|image| {
+            let image_end = image.linear_memory_offset.checked_add(image.len).unwrap();
+            image.linear_memory_offset < end && offset < image_end
+        });
+        let anonymous = !self.foreign_mappings && !overlaps_image;
+        // SAFETY: the range was checked to be within the accessible part of
+        // this slot, which is owned by this slot.
+        unsafe {
+            let ptr = self.base.as_mut_ptr().add(offset.byte_count());
+            vm::discard_pages(ptr, len.byte_count(), anonymous)?;
+        }
+        if !anonymous {
+            self.foreign_mappings = true;
+            self.forget_numa_node();
+        }
+        Ok(())
+    }
+
+    /// Records that something other than this slot's image has been mapped
+    /// into it, so it must be entirely erased when it's next reset.
+    #[allow(dead_code, reason = "only used in some cfgs")]
+    pub(crate) fn set_foreign_mappings(&mut self) {
+        self.foreign_mappings = true;
+        self.forget_numa_node();
+    }
+
+    /// Returns the NUMA node which the whole slot is known to be bound to,
+    /// `Some(None)` for the default policy, or `None` if it's unknown.
+    #[allow(dead_code, reason = "only used in some cfgs")]
+    pub(crate) fn numa_node(&self) -> Option<Option<u32>> {
+        self.numa_node
+    }
+
+    /// Records the NUMA node which the whole slot was bound to, see
+    /// `numa_node`.
+    #[allow(dead_code, reason = "only used in some cfgs")]
+    pub(crate) fn set_numa_node(&mut self, node: Option<Option<u32>>) {
+        self.numa_node = node;
+    }
+
+    /// Records that part of the slot was remapped, so if it was bound to a
+    /// node then that part no longer is.
+    fn forget_numa_node(&mut self) {
+        if let Some(Some(_)) = self.numa_node {
+            self.numa_node = None;
+        }
+    }
+
     /// Map anonymous zeroed memory across the whole slot,
     /// inaccessible. Used both during instantiate and during drop.
     pub(crate) fn reset_with_anon_memory(&mut self) -> Result<()> {
@@ -702,6 +888,8 @@ impl MemoryImageSlot {
 
         self.image = None;
         self.accessible = HostAlignedByteCount::ZERO;
+        self.foreign_mappings = false;
+        self.numa_node = Some(None);
 
         Ok(())
     }
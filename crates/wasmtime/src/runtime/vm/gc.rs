@@ -193,8 +193,8 @@ impl GcStore {
     /// * `Err(_)`: Unrecoverable allocation failure.
     pub fn alloc_externref(
         &mut self,
-        value: Box<dyn Any + Send + Sync>,
-    ) -> Result<Result<VMExternRef, (Box<dyn Any + Send + Sync>, u64)>> {
+        value: ExternRefHostData,
+    ) -> Result<Result<VMExternRef, (ExternRefHostData, u64)>> {
         let host_data_id = self.host_data_table.alloc(value);
         match self.gc_heap.alloc_externref(host_data_id)? {
             Ok(x) => Ok(Ok(x)),
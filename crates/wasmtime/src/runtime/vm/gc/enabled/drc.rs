@@ -59,10 +59,11 @@ use core::{
     alloc::Layout,
     any::Any,
     mem,
+    num::NonZeroU32,
     ops::{Deref, DerefMut},
     ptr::NonNull,
 };
-use wasmtime_environ::drc::{ARRAY_LENGTH_OFFSET, DrcTypeLayouts};
+use wasmtime_environ::drc::{ALLOC_ALIGN, ARRAY_LENGTH_OFFSET, DrcTypeLayouts};
 use wasmtime_environ::{
     GcArrayLayout, GcLayout, GcStructLayout, GcTypeLayouts, VMGcKind, VMSharedTypeIndex,
 };
@@ -76,7 +77,9 @@ const GC_REF_ARRAY_ELEMS_OFFSET: u32 = ARRAY_LENGTH_OFFSET + (mem::size_of::<u32
 /// will not be able to reclaim garbage cycles.
 ///
 /// This is not a moving collector; it doesn't have a nursery or do any
-/// compaction.
+/// compaction. Objects are, however, bump-allocated out of a free block of the
+/// heap, inline in compiled Wasm code, for as long as that block has room; see
+/// `VMDrcHeapData`.
 #[derive(Default)]
 pub struct DrcCollector {
     layouts: DrcTypeLayouts,
@@ -120,11 +123,12 @@ struct DrcHeap {
     /// Count of how many no-gc scopes we are currently within.
     no_gc_count: u64,
 
-    /// The head of the over-approximated-stack-roots list.
+    /// The head of the over-approximated-stack-roots list and the bump
+    /// region.
     ///
     /// Note that this is exposed directly to compiled Wasm code through the
     /// vmctx, so must not move.
-    over_approximated_stack_roots: Box<Option<VMGcRef>>,
+    heap_data: Box<VMDrcHeapData>,
 
     /// The storage for the GC heap itself.
     memory: Option<crate::vm::Memory>,
@@ -161,7 +165,7 @@ impl DrcHeap {
             engine: engine.weak(),
             trace_infos: HashMap::with_capacity(1),
             no_gc_count: 0,
-            over_approximated_stack_roots: Box::new(None),
+            heap_data: Box::new(VMDrcHeapData::default()),
             memory: None,
             vmmemory: None,
             free_list: None,
@@ -173,6 +177,52 @@ impl DrcHeap {
         self.engine.upgrade().unwrap()
     }
 
+    /// Allocates `alloc_size` bytes, which must be a multiple of
+    /// `ALLOC_ALIGN`, out of the bump region, refilling it from the free list
+    /// if it doesn't have room.
+    ///
+    /// Compiled Wasm code does the same inline, calling into the runtime only
+    /// when the bump region doesn't have room.
+    fn bump_alloc(&mut self, alloc_size: u32) -> Result<Option<NonZeroU32>> {
+        debug_assert_eq!(alloc_size % ALLOC_ALIGN, 0);
+        if let Some(index) = self.heap_data.bump(alloc_size) {
+            return Ok(Some(index));
+        }
+
+        // Hand whatever is left of the bump region back to the free list, and
+        // take a new region out of the first free block which is large enough
+        // for both this allocation and many more like it.
+        self.retire_bump_region();
+        let min_size = alloc_size.max(MIN_BUMP_REGION_SIZE);
+        let free_list = self.free_list.as_mut().unwrap();
+        let Some((index, len)) = free_list.alloc_block(usize::try_from(min_size).unwrap())? else {
+            return Ok(None);
+        };
+        self.heap_data.bump_next = index.get();
+        self.heap_data.bump_end = index.get() + len;
+        Ok(self.heap_data.bump(alloc_size))
+    }
+
+    /// Return the unused part of the bump region to the free list.
+    fn retire_bump_region(&mut self) {
+        let VMDrcHeapData {
+            bump_next,
+            bump_end,
+            ..
+        } = &mut *self.heap_data;
+        if let Some(index) = NonZeroU32::new(*bump_next)
+            && *bump_end > *bump_next
+        {
+            let len = usize::try_from(*bump_end - *bump_next).unwrap();
+            self.free_list
+                .as_mut()
+                .unwrap()
+                .dealloc(index, FreeList::layout(len));
+        }
+        *bump_next = 0;
+        *bump_end = 0;
+    }
+
     fn dealloc(&mut self, gc_ref: VMGcRef) {
         let drc_ref = drc_ref(&gc_ref);
         let size = self.index(drc_ref).object_size();
@@ -303,7 +353,11 @@ impl DrcHeap {
     }
 
     /// Enumerate all of the given `VMGcRef`'s outgoing edges.
-    fn trace_gc_ref(&self, gc_ref: &VMGcRef, stack: &mut Vec<VMGcRef>) {
+    ///
+    /// Objects allocated inline by compiled Wasm code don't have their type's
+    /// tracing information inserted when they're allocated, so it's inserted
+    /// here if necessary.
+    fn trace_gc_ref(&mut self, gc_ref: &VMGcRef, stack: &mut Vec<VMGcRef>) {
         debug_assert!(!gc_ref.is_i31());
 
         let header = self.header(gc_ref);
@@ -311,11 +365,8 @@ impl DrcHeap {
             debug_assert!(header.kind().matches(VMGcKind::ExternRef));
             return;
         };
-        match self
-            .trace_infos
-            .get(&ty)
-            .expect("should have inserted trace info for every GC type allocated in this heap")
-        {
+        self.ensure_trace_info(ty);
+        match &self.trace_infos[&ty] {
             TraceInfo::Struct { gc_ref_offsets } => {
                 stack.reserve(gc_ref_offsets.len());
                 let data = self.gc_object_data(gc_ref);
@@ -348,7 +399,9 @@ impl DrcHeap {
 
     /// Iterate over the over-approximated-stack-roots list.
     fn iter_over_approximated_stack_roots(&self) -> impl Iterator<Item = VMGcRef> + '_ {
-        let mut link = (*self.over_approximated_stack_roots)
+        let mut link = self
+            .heap_data
+            .over_approximated_stack_roots
             .as_ref()
             .map(|r| r.unchecked_copy());
 
@@ -475,7 +528,9 @@ impl DrcHeap {
 
         // The `VMGcRef` of the next object in the over-approximated-stack-roots
         // list, if any.
-        let mut next = (*self.over_approximated_stack_roots)
+        let mut next = self
+            .heap_data
+            .over_approximated_stack_roots
             .as_ref()
             .map(|r| r.unchecked_copy());
 
@@ -509,7 +564,7 @@ impl DrcHeap {
             let prev_next = header.next_over_approximated_stack_root();
             header.set_in_over_approximated_stack_roots_bit(false);
             match &prev {
-                None => *self.over_approximated_stack_roots = prev_next,
+                None => self.heap_data.over_approximated_stack_roots = prev_next,
                 Some(prev) => self
                     .index_mut(drc_ref(prev))
                     .set_next_over_approximated_stack_root(prev_next),
@@ -670,6 +725,44 @@ unsafe impl GcHeapObject for VMDrcExternRef {
     }
 }
 
+/// The DRC heap's data which is exposed to compiled Wasm code through the
+/// vmctx, see `wasmtime_environ::drc::HEAP_DATA_*_OFFSET`.
+///
+/// Besides the over-approximated-stack-roots list, this holds the bump region:
+/// the heap indices `bump_next..bump_end`, which were taken out of the free
+/// list as a whole. Compiled Wasm code allocates objects at `bump_next`, and
+/// pushes them onto the over-approximated-stack-roots list, without calling
+/// into the runtime for as long as the region has room. This makes allocating
+/// the many short-lived objects of allocation-heavy programs a few
+/// instructions each, rather than a libcall and a search of the free list.
+#[repr(C)]
+#[derive(Default)]
+struct VMDrcHeapData {
+    /// The head of the over-approximated-stack-roots list.
+    over_approximated_stack_roots: Option<VMGcRef>,
+    /// The next heap index to allocate at, or zero if there is no bump region.
+    bump_next: u32,
+    /// The end of the bump region.
+    bump_end: u32,
+}
+
+/// The smallest bump region to take out of the free list, which amortizes
+/// the cost of searching the free list for a new one.
+const MIN_BUMP_REGION_SIZE: u32 = 4096;
+
+impl VMDrcHeapData {
+    /// Allocates `alloc_size` bytes out of the bump region, if it has room.
+    fn bump(&mut self, alloc_size: u32) -> Option<NonZeroU32> {
+        let index = NonZeroU32::new(self.bump_next)?;
+        let new_next = self.bump_next.checked_add(alloc_size)?;
+        if new_next > self.bump_end {
+            return None;
+        }
+        self.bump_next = new_next;
+        Some(index)
+    }
+}
+
 unsafe impl GcHeap for DrcHeap {
     fn is_attached(&self) -> bool {
         debug_assert_eq!(self.memory.is_some(), self.free_list.is_some());
@@ -680,7 +773,8 @@ unsafe impl GcHeap for DrcHeap {
     fn attach(&mut self, memory: crate::vm::Memory) {
         assert!(!self.is_attached());
         assert!(!memory.is_shared_memory());
-        debug_assert!(self.over_approximated_stack_roots.is_none());
+        debug_assert!(self.heap_data.over_approximated_stack_roots.is_none());
+        debug_assert_eq!(self.heap_data.bump_end, 0);
         let len = memory.vmmemory().current_length();
         self.free_list = Some(FreeList::new(len));
         self.vmmemory = Some(memory.vmmemory());
@@ -693,7 +787,7 @@ unsafe impl GcHeap for DrcHeap {
         let DrcHeap {
             engine: _,
             no_gc_count,
-            over_approximated_stack_roots,
+            heap_data,
             free_list,
             dec_ref_stack,
             memory,
@@ -706,7 +800,7 @@ unsafe impl GcHeap for DrcHeap {
         } = self;
 
         *no_gc_count = 0;
-        **over_approximated_stack_roots = None;
+        **heap_data = VMDrcHeapData::default();
         *free_list = None;
         *vmmemory = None;
         debug_assert!(dec_ref_stack.as_ref().is_some_and(|s| s.is_empty()));
@@ -767,12 +861,14 @@ unsafe impl GcHeap for DrcHeap {
         // Push this object onto the head of the over-approximated-stack-roots
         // list.
         header.set_in_over_approximated_stack_roots_bit(true);
-        let next = (*self.over_approximated_stack_roots)
+        let next = self
+            .heap_data
+            .over_approximated_stack_roots
             .as_ref()
             .map(|r| r.unchecked_copy());
         self.index_mut(drc_ref(&gc_ref))
             .set_next_over_approximated_stack_root(next);
-        *self.over_approximated_stack_roots = Some(gc_ref);
+        self.heap_data.over_approximated_stack_roots = Some(gc_ref);
     }
 
     fn alloc_externref(
@@ -823,7 +919,15 @@ unsafe impl GcHeap for DrcHeap {
 
         let object_size = u32::try_from(layout.size()).unwrap();
 
-        let gc_ref = match self.free_list.as_mut().unwrap().alloc(layout)? {
+        // Prefer the bump region, falling back to the free list's smaller
+        // blocks once the heap has no free blocks large enough for a new bump
+        // region.
+        let alloc_size = FreeList::alloc_size(layout)?;
+        let index = match self.bump_alloc(alloc_size)? {
+            Some(index) => Some(index),
+            None => self.free_list.as_mut().unwrap().alloc(layout)?,
+        };
+        let gc_ref = match index {
             None => return Ok(Err(u64::try_from(layout.size()).unwrap())),
             Some(index) => VMGcRef::from_heap_index(index).unwrap(),
         };
@@ -906,7 +1010,7 @@ unsafe impl GcHeap for DrcHeap {
     }
 
     unsafe fn vmctx_gc_heap_data(&self) -> NonNull<u8> {
-        let ptr: NonNull<Option<VMGcRef>> = NonNull::from(&*self.over_approximated_stack_roots);
+        let ptr: NonNull<VMDrcHeapData> = NonNull::from(&*self.heap_data);
         ptr.cast()
     }
 
@@ -938,6 +1042,15 @@ unsafe impl GcHeap for DrcHeap {
             current_length: AtomicUsize::new(vmmemory.current_length()),
         }
     }
+
+    fn allocated_bytes(&self) -> usize {
+        // The unused part of the bump region is allocated from the free
+        // list's point of view, but not from ours.
+        let bump_region_len = self.heap_data.bump_end - self.heap_data.bump_next;
+        self.free_list.as_ref().map_or(0, |free_list| {
+            free_list.allocated_bytes() - usize::try_from(bump_region_len).unwrap()
+        })
+    }
 }
 
 struct DrcCollection<'a> {
@@ -1033,6 +1146,31 @@ mod tests {
         );
     }
 
+    #[test]
+    fn vm_drc_heap_data_offsets() {
+        use wasmtime_environ::drc::*;
+        assert_eq!(
+            HEAP_DATA_OVER_APPROX_LIST_HEAD_OFFSET,
+            u32::try_from(core::mem::offset_of!(
+                VMDrcHeapData,
+                over_approximated_stack_roots
+            ))
+            .unwrap(),
+        );
+        assert_eq!(
+            HEAP_DATA_BUMP_NEXT_OFFSET,
+            u32::try_from(core::mem::offset_of!(VMDrcHeapData, bump_next)).unwrap(),
+        );
+        assert_eq!(
+            HEAP_DATA_BUMP_END_OFFSET,
+            u32::try_from(core::mem::offset_of!(VMDrcHeapData, bump_end)).unwrap(),
+        );
+        assert_eq!(
+            usize::try_from(ALLOC_ALIGN).unwrap(),
+            FreeList::layout(1).align()
+        );
+    }
+
     #[test]
     fn ref_count_is_at_correct_offset() {
         let extern_data = VMDrcHeader {
@@ -1060,6 +1198,8 @@ mod tests {
             num_defined_globals: 0,
             num_defined_tags: 0,
             num_escaped_funcs: 0,
+            num_call_counters: 0,
+            num_call_indirect_caches: 0,
         });
 
         assert_eq!(
@@ -25,6 +25,8 @@ pub(crate) struct FreeList {
     /// Our free blocks, as a map from index to length of the free block at that
     /// index.
     free_block_index_to_len: BTreeMap<u32, u32>,
+    /// The number of bytes currently allocated out of this free list.
+    allocated_bytes: usize,
 }
 
 /// Our minimum and maximum supported alignment. Every allocation is aligned to
@@ -48,6 +50,7 @@ impl FreeList {
         let mut free_list = FreeList {
             capacity,
             free_block_index_to_len: BTreeMap::new(),
+            allocated_bytes: 0,
         };
 
         let end = u32::try_from(free_list.capacity).unwrap_or_else(|_| {
@@ -132,9 +135,18 @@ impl FreeList {
             "FreeList::add_capacity(..): adding block {index:#x}..{:#x}",
             index.get() + size
         );
+        // The new block is added by deallocating it, so it's first counted as
+        // allocated to keep `allocated_bytes` balanced.
+        self.allocated_bytes += usize::try_from(size).unwrap();
         self.dealloc(index, layout);
     }
 
+    /// The number of bytes currently allocated out of this free list,
+    /// including the rounding of each allocation up to our alignment.
+    pub fn allocated_bytes(&self) -> usize {
+        self.allocated_bytes
+    }
+
     #[cfg(test)]
     fn max_size(&self) -> usize {
         let cap = core::cmp::min(self.capacity, usize::try_from(u32::MAX).unwrap());
@@ -143,7 +155,7 @@ impl FreeList {
 
     /// Check the given layout for compatibility with this free list and return
     /// the actual block size we will use for this layout.
-    fn check_layout(&self, layout: Layout) -> Result<u32> {
+    pub fn alloc_size(layout: Layout) -> Result<u32> {
         ensure!(
             layout.align() <= ALIGN_USIZE,
             "requested allocation's alignment of {} is greater than max supported \
@@ -230,7 +242,7 @@ impl FreeList {
     /// * `Err(_)`:
     pub fn alloc(&mut self, layout: Layout) -> Result<Option<NonZeroU32>> {
         log::trace!("FreeList::alloc({layout:?})");
-        let alloc_size = self.check_layout(layout)?;
+        let alloc_size = Self::alloc_size(layout)?;
         debug_assert_eq!(alloc_size % ALIGN_U32, 0);
 
         let (block_index, block_len) = match self.first_fit(alloc_size) {
@@ -250,10 +262,34 @@ impl FreeList {
         #[cfg(debug_assertions)]
         self.check_integrity();
 
+        self.allocated_bytes += usize::try_from(alloc_size).unwrap();
+
         log::trace!("FreeList::alloc({layout:?}) -> {block_index:#x}");
         Ok(Some(unsafe { NonZeroU32::new_unchecked(block_index) }))
     }
 
+    /// Allocate the whole of the first free block which is at least
+    /// `min_size` bytes long, returning its index and length.
+    ///
+    /// The block can be handed back, in whole or in part, with `dealloc`.
+    pub fn alloc_block(&mut self, min_size: usize) -> Result<Option<(NonZeroU32, u32)>> {
+        log::trace!("FreeList::alloc_block({min_size:#x})");
+        let min_size = Self::alloc_size(Self::layout(min_size))?;
+
+        let Some((block_index, block_len)) = self.first_fit(min_size) else {
+            return Ok(None);
+        };
+        debug_assert_ne!(block_index, 0);
+
+        #[cfg(debug_assertions)]
+        self.check_integrity();
+
+        self.allocated_bytes += usize::try_from(block_len).unwrap();
+
+        log::trace!("FreeList::alloc_block({min_size:#x}) -> ({block_index:#x}, {block_len:#x})");
+        Ok(Some((NonZeroU32::new(block_index).unwrap(), block_len)))
+    }
+
     /// Deallocate an object with the given layout.
     pub fn dealloc(&mut self, index: NonZeroU32, layout: Layout) {
         log::trace!("FreeList::dealloc({index:#x}, {layout:?})");
@@ -261,8 +297,9 @@ impl FreeList {
         let index = index.get();
         debug_assert_eq!(index % ALIGN_U32, 0);
 
-        let alloc_size = self.check_layout(layout).unwrap();
+        let alloc_size = Self::alloc_size(layout).unwrap();
         debug_assert_eq!(alloc_size % ALIGN_U32, 0);
+        self.allocated_bytes -= usize::try_from(alloc_size).unwrap();
 
         let prev_block = self
             .free_block_index_to_len
@@ -950,4 +987,55 @@ mod tests {
             "but not enough capacity for two"
         );
     }
+
+    #[test]
+    fn alloc_block() {
+        let mut free_list = FreeList::new(ALIGN_USIZE * 8);
+        let a = free_list
+            .alloc(FreeList::layout(ALIGN_USIZE))
+            .unwrap()
+            .unwrap();
+        let b = free_list
+            .alloc(FreeList::layout(ALIGN_USIZE))
+            .unwrap()
+            .unwrap();
+        free_list.dealloc(a, FreeList::layout(ALIGN_USIZE));
+
+        // The first block is too small, so the rest of the capacity is taken.
+        let (index, len) = free_list.alloc_block(2 * ALIGN_USIZE).unwrap().unwrap();
+        assert_eq!(index.get(), b.get() + ALIGN_U32);
+        assert_eq!(len, 5 * ALIGN_U32);
+        assert_eq!(free_list.allocated_bytes(), 6 * ALIGN_USIZE);
+        assert!(free_list.alloc_block(2 * ALIGN_USIZE).unwrap().is_none());
+
+        // Part of the block can be handed back.
+        let rest = NonZeroU32::new(index.get() + ALIGN_U32).unwrap();
+        free_list.dealloc(rest, FreeList::layout(4 * ALIGN_USIZE));
+        assert_eq!(free_list.allocated_bytes(), 2 * ALIGN_USIZE);
+        assert_eq!(
+            free_list.alloc_block(4 * ALIGN_USIZE).unwrap(),
+            Some((rest, 4 * ALIGN_U32)),
+        );
+    }
+
+    #[test]
+    fn allocated_bytes() {
+        let layout = Layout::from_size_align(ALIGN_USIZE + 1, ALIGN_USIZE).unwrap();
+
+        let mut free_list = FreeList::new(ALIGN_USIZE * 4);
+        assert_eq!(free_list.allocated_bytes(), 0);
+
+        let a = free_list.alloc(layout).unwrap().unwrap();
+        assert_eq!(free_list.allocated_bytes(), 2 * ALIGN_USIZE);
+
+        free_list.add_capacity(ALIGN_USIZE * 4);
+        assert_eq!(
+            free_list.allocated_bytes(),
+            2 * ALIGN_USIZE,
+            "adding capacity doesn't allocate"
+        );
+
+        free_list.dealloc(a, layout);
+        assert_eq!(free_list.allocated_bytes(), 0);
+    }
 }
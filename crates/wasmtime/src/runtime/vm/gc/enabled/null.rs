@@ -234,6 +234,16 @@ unsafe impl GcHeap for NullHeap {
         self.memory.as_ref().unwrap().vmmemory()
     }
 
+    fn allocated_bytes(&self) -> usize {
+        if !self.is_attached() {
+            return 0;
+        }
+        // SAFETY: the bump pointer is only written by Wasm, which isn't
+        // running while the heap is borrowed.
+        let next = unsafe { *self.next.get() };
+        usize::try_from(next.get() - 1).unwrap()
+    }
+
     fn clone_gc_ref(&mut self, gc_ref: &VMGcRef) -> VMGcRef {
         gc_ref.unchecked_copy()
     }
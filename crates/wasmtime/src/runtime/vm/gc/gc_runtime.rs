@@ -405,6 +405,10 @@ pub unsafe trait GcHeap: 'static + Send + Sync {
     /// updated `VMMemoryDefinition` record.
     fn vmmemory(&self) -> VMMemoryDefinition;
 
+    /// Get the number of bytes of this heap which are currently allocated to
+    /// objects, including any which are unreachable but not yet collected.
+    fn allocated_bytes(&self) -> usize;
+
     /// Get a slice of the raw bytes of the GC heap.
     #[inline]
     fn heap_slice(&self) -> &[u8] {
@@ -15,6 +15,8 @@
 
 use crate::prelude::*;
 use core::any::Any;
+use core::cell::UnsafeCell;
+use core::mem::{self, MaybeUninit};
 use wasmtime_core::{
     alloc::PanicOnOom,
     slab::{Id, Slab},
@@ -23,7 +25,104 @@ use wasmtime_core::{
 /// Side table for each `externref`'s host data value.
 #[derive(Default)]
 pub struct ExternRefHostDataTable {
-    slab: Slab<Box<dyn Any + Send + Sync>>,
+    slab: Slab<ExternRefHostData>,
+}
+
+/// The host data value of an `externref`.
+///
+/// Values which fit in two words and don't need to be dropped, such as
+/// integer handles, are stored inline in the table rather than boxed, so
+/// creating an `externref` for them doesn't allocate.
+pub enum ExternRefHostData {
+    /// A small value stored inline.
+    Inline(InlineHostData),
+    /// Any other value.
+    Boxed(Box<dyn Any + Send + Sync>),
+}
+
+/// The storage for `ExternRefHostData::Inline`.
+pub struct InlineHostData {
+    bytes: UnsafeCell<[MaybeUninit<u64>; 2]>,
+    /// Converts a pointer to `bytes` into a pointer to the value as its
+    /// original type.
+    as_any: unsafe fn(*mut u8) -> *mut (dyn Any + Send + Sync),
+}
+
+// SAFETY: the value in `bytes` is only accessed as its original type, which
+// was `Send` and `Sync`, and through `&self` or `&mut self` as appropriate.
+unsafe impl Send for InlineHostData {}
+unsafe impl Sync for InlineHostData {}
+
+unsafe fn inline_as_any<T: Any + Send + Sync>(ptr: *mut u8) -> *mut (dyn Any + Send + Sync) {
+    ptr.cast::<T>() as *mut (dyn Any + Send + Sync)
+}
+
+impl ExternRefHostData {
+    /// Creates the host data for `value`, storing it inline if possible.
+    pub fn new<T: Any + Send + Sync>(value: T) -> ExternRefHostData {
+        type Bytes = [MaybeUninit<u64>; 2];
+        if mem::size_of::<T>() > mem::size_of::<Bytes>()
+            || mem::align_of::<T>() > mem::align_of::<Bytes>()
+            || mem::needs_drop::<T>()
+        {
+            return ExternRefHostData::Boxed(Box::new(value));
+        }
+        let bytes = UnsafeCell::new([MaybeUninit::uninit(); 2]);
+        // SAFETY: `T` fits within `bytes` as checked above.
+        unsafe {
+            bytes.get().cast::<T>().write(value);
+        }
+        ExternRefHostData::Inline(InlineHostData {
+            bytes,
+            as_any: inline_as_any::<T>,
+        })
+    }
+
+    /// Get a shared borrow of this host data.
+    pub fn get(&self) -> &(dyn Any + Send + Sync) {
+        match self {
+            // SAFETY: the value is borrowed for as long as `self` is.
+            ExternRefHostData::Inline(data) => unsafe { &*data.value() },
+            ExternRefHostData::Boxed(data) => deref_box(data),
+        }
+    }
+
+    /// Get a mutable borrow of this host data.
+    pub fn get_mut(&mut self) -> &mut (dyn Any + Send + Sync) {
+        match self {
+            // SAFETY: the value is borrowed mutably for as long as `self` is.
+            ExternRefHostData::Inline(data) => unsafe { &mut *data.value() },
+            ExternRefHostData::Boxed(data) => deref_box_mut(data),
+        }
+    }
+
+    /// Takes the value out of this host data, or returns `None` if it isn't a
+    /// `T`.
+    pub fn downcast<T: Any>(self) -> Option<T> {
+        match self {
+            ExternRefHostData::Inline(data) => {
+                // SAFETY: `data` is owned here so the value isn't borrowed
+                // elsewhere, and it's only read if it's a `T`, which doesn't
+                // need to be dropped so can be moved out of `data`.
+                unsafe {
+                    if !(*data.value()).is::<T>() {
+                        return None;
+                    }
+                    Some(data.bytes.get().cast::<T>().read())
+                }
+            }
+            ExternRefHostData::Boxed(data) => data.downcast::<T>().ok().map(|b| *b),
+        }
+    }
+}
+
+impl InlineHostData {
+    /// Returns a pointer to the value as its original type.
+    fn value(&self) -> *mut (dyn Any + Send + Sync) {
+        // SAFETY: `bytes` holds a value of the type `as_any` was instantiated
+        // with.
+        unsafe { (self.as_any)(self.bytes.get().cast()) }
+    }
 }
 
 /// ID into the `externref` host data table.
@@ -41,7 +140,7 @@ fn deref_box_mut<T: ?Sized>(b: &mut Box<T>) -> &mut T {
 
 impl ExternRefHostDataTable {
     /// Allocate a new `externref` host data value.
-    pub fn alloc(&mut self, value: Box<dyn Any + Send + Sync>) -> ExternRefHostDataId {
+    pub fn alloc(&mut self, value: ExternRefHostData) -> ExternRefHostDataId {
         // TODO(#12069): handle allocation failure here
         let id = self.slab.alloc(value).panic_on_oom();
         let id = ExternRefHostDataId(id);
@@ -50,21 +149,19 @@ impl ExternRefHostDataTable {
     }
 
     /// Deallocate an `externref` host data value.
-    pub fn dealloc(&mut self, id: ExternRefHostDataId) -> Box<dyn Any + Send + Sync> {
+    pub fn dealloc(&mut self, id: ExternRefHostDataId) -> ExternRefHostData {
         log::trace!("deallocated externref host data: {id:?}");
         self.slab.dealloc(id.0)
     }
 
     /// Get a shared borrow of the host data associated with the given ID.
     pub fn get(&self, id: ExternRefHostDataId) -> &(dyn Any + Send + Sync) {
-        let data: &Box<dyn Any + Send + Sync> = self.slab.get(id.0).unwrap();
-        deref_box(data)
+        self.slab.get(id.0).unwrap().get()
     }
 
     /// Get a mutable borrow of the host data associated with the given ID.
     pub fn get_mut(&mut self, id: ExternRefHostDataId) -> &mut (dyn Any + Send + Sync) {
-        let data: &mut Box<dyn Any + Send + Sync> = self.slab.get_mut(id.0).unwrap();
-        deref_box_mut(data)
+        self.slab.get_mut(id.0).unwrap().get_mut()
     }
 }
 
@@ -77,10 +174,37 @@ mod tests {
         let mut table = ExternRefHostDataTable::default();
 
         let x = 42_u32;
-        let id = table.alloc(Box::new(x));
+        let id = table.alloc(ExternRefHostData::new(x));
         assert!(table.get(id).is::<u32>());
         assert_eq!(*table.get(id).downcast_ref::<u32>().unwrap(), 42);
         assert!(table.get_mut(id).is::<u32>());
         assert_eq!(*table.get_mut(id).downcast_ref::<u32>().unwrap(), 42);
     }
+
+    #[test]
+    fn inline_host_data() {
+        let mut table = ExternRefHostDataTable::default();
+
+        let small = ExternRefHostData::new([1_u64, 2]);
+        assert!(matches!(small, ExternRefHostData::Inline(_)));
+        let id = table.alloc(small);
+        table.get_mut(id).downcast_mut::<[u64; 2]>().unwrap()[1] = 3;
+        assert_eq!(*table.get(id).downcast_ref::<[u64; 2]>().unwrap(), [1, 3]);
+        let small = table.dealloc(id);
+        assert_eq!(small.downcast::<u32>(), None);
+
+        let small = ExternRefHostData::new([1_u64, 2]);
+        assert_eq!(small.downcast::<[u64; 2]>(), Some([1, 2]));
+
+        assert!(matches!(
+            ExternRefHostData::new([0_u64; 3]),
+            ExternRefHostData::Boxed(_)
+        ));
+        assert!(matches!(
+            ExternRefHostData::new(String::new()),
+            ExternRefHostData::Boxed(_)
+        ));
+        let boxed = ExternRefHostData::new(String::from("hello"));
+        assert_eq!(boxed.downcast::<String>().as_deref(), Some("hello"));
+    }
 }
@@ -36,10 +36,10 @@ use core::{mem, ptr};
 use wasmtime_environ::ModuleInternedTypeIndex;
 use wasmtime_environ::error::OutOfMemory;
 use wasmtime_environ::{
-    DataIndex, DefinedGlobalIndex, DefinedMemoryIndex, DefinedTableIndex, DefinedTagIndex,
-    ElemIndex, EntityIndex, EntityRef, FuncIndex, GlobalIndex, HostPtr, MemoryIndex, PrimaryMap,
-    PtrSize, TableIndex, TableInitialValue, TableSegmentElements, TagIndex, Trap, VMCONTEXT_MAGIC,
-    VMOffsets, VMSharedTypeIndex, packed_option::ReservedValue,
+    DataIndex, DefinedFuncIndex, DefinedGlobalIndex, DefinedMemoryIndex, DefinedTableIndex,
+    DefinedTagIndex, ElemIndex, EntityIndex, EntityRef, FuncIndex, GlobalIndex, HostPtr,
+    MemoryIndex, PrimaryMap, PtrSize, TableIndex, TableInitialValue, TableSegmentElements,
+    TagIndex, Trap, VMCONTEXT_MAGIC, VMOffsets, VMSharedTypeIndex, packed_option::ReservedValue,
 };
 #[cfg(feature = "wmemcheck")]
 use wasmtime_wmemcheck::Wmemcheck;
@@ -136,6 +136,10 @@ pub struct Instance {
     /// If the index is present in the set, the segment has been dropped.
     dropped_data: EntitySet<DataIndex>,
 
+    /// The number of funcref table elements of this instance which have been
+    /// initialized lazily.
+    lazy_table_inits: u64,
+
     // TODO: add support for multiple memories; `wmemcheck_state` corresponds to
     // memory 0.
     #[cfg(feature = "wmemcheck")]
@@ -197,6 +201,7 @@ impl Instance {
             tables,
             dropped_elements,
             dropped_data,
+            lazy_table_inits: 0,
             #[cfg(feature = "wmemcheck")]
             wmemcheck_state,
             store: None,
@@ -774,7 +779,7 @@ impl Instance {
         result
     }
 
-    fn alloc_layout(offsets: &VMOffsets<HostPtr>) -> Layout {
+    pub(crate) fn alloc_layout(offsets: &VMOffsets<HostPtr>) -> Layout {
         let size = mem::size_of::<Self>()
             .checked_add(usize::try_from(offsets.size_of_vmctx()).unwrap())
             .unwrap();
@@ -1267,7 +1272,34 @@ impl Instance {
         idx: DefinedTableIndex,
         range: impl IntoIterator<Item = u64>,
     ) -> &mut Table {
+        let initialized = self.as_mut().init_func_table_elems(registry, idx, range);
+        *self.as_mut().lazy_table_inits_mut() += initialized;
+        self.get_defined_table(idx)
+    }
+
+    /// Initializes every element of the defined table `idx`, which compiled
+    /// code expects to be fully initialized, see
+    /// `Module::table_initialized_eagerly`.
+    pub(crate) fn init_table_eagerly(
+        self: Pin<&mut Self>,
+        registry: &ModuleRegistry,
+        idx: DefinedTableIndex,
+    ) {
+        let size = u64::try_from(self.tables[idx].1.size()).unwrap();
+        self.init_func_table_elems(registry, idx, 0..size);
+    }
+
+    /// Initializes the uninitialized elements of the defined table `idx`
+    /// within `range`, if it's a funcref table, returning how many were
+    /// initialized.
+    fn init_func_table_elems(
+        mut self: Pin<&mut Self>,
+        registry: &ModuleRegistry,
+        idx: DefinedTableIndex,
+        range: impl IntoIterator<Item = u64>,
+    ) -> u64 {
         let elt_ty = self.tables[idx].1.element_type();
+        let mut initialized = 0;
 
         if elt_ty == TableElementType::Func {
             for i in range {
@@ -1302,10 +1334,17 @@ impl Instance {
                     .1
                     .set_func(i, func_ref)
                     .expect("Table type should match and index should be in-bounds");
+                initialized += 1;
             }
         }
 
-        self.get_defined_table(idx)
+        initialized
+    }
+
+    /// Returns the number of funcref table elements of this instance which
+    /// have been initialized lazily.
+    pub fn lazy_table_inits(&self) -> u64 {
+        self.lazy_table_inits
     }
 
     /// Get a table by index regardless of whether it is locally-defined or an
@@ -1537,6 +1576,53 @@ impl Instance {
                 ptr = ptr.add(1);
             }
         }
+
+        // Zero the function call counters.
+        //
+        // SAFETY: the counters are within bounds of the vmctx, which is safe to
+        // initialize here.
+        unsafe {
+            let offsets = instance.runtime_info.offsets();
+            let ptr = instance.vmctx_plus_offset_raw::<u64>(offsets.vmctx_call_counters_begin());
+            ptr::write_bytes(ptr.as_ptr(), 0, offsets.num_call_counters as usize);
+        }
+
+        // Empty the `call_indirect` caches, whose index is `u64::MAX` until
+        // their first call.
+        //
+        // SAFETY: the caches are within bounds of the vmctx, which is safe to
+        // initialize here.
+        unsafe {
+            let offsets = instance.runtime_info.offsets();
+            let begin = offsets.vmctx_call_indirect_caches_begin();
+            let size = offsets.size_of_call_indirect_cache();
+            let ptr = instance.vmctx_plus_offset_raw::<u8>(begin);
+            ptr::write_bytes(
+                ptr.as_ptr(),
+                0,
+                offsets.num_call_indirect_caches as usize * usize::from(size),
+            );
+            for i in 0..offsets.num_call_indirect_caches {
+                let offset = offsets.vmctx_call_indirect_cache(i)
+                    + u32::from(offsets.call_indirect_cache_index());
+                instance
+                    .vmctx_plus_offset_raw::<u64>(offset)
+                    .write(u64::MAX);
+            }
+        }
+    }
+
+    /// Returns the values of this instance's function call counters, one per
+    /// defined function if function call counting is enabled and otherwise
+    /// none.
+    pub fn call_counts(&self) -> impl ExactSizeIterator<Item = u64> + '_ {
+        let offsets = self.runtime_info.offsets();
+        (0..offsets.num_call_counters).map(move |i| {
+            let offset = offsets.vmctx_call_counter(DefinedFuncIndex::from_u32(i));
+            // SAFETY: the counters are within bounds of the vmctx, and are
+            // `u64`s initialized to zero in `initialize_vmctx`.
+            unsafe { *self.vmctx_plus_offset::<u64>(offset) }
+        })
     }
 
     /// Attempts to convert from the host `addr` specified to a WebAssembly
@@ -1645,6 +1731,11 @@ impl Instance {
         unsafe { &mut self.get_unchecked_mut().dropped_data }
     }
 
+    fn lazy_table_inits_mut(self: Pin<&mut Self>) -> &mut u64 {
+        // SAFETY: see `store_mut` above.
+        unsafe { &mut self.get_unchecked_mut().lazy_table_inits }
+    }
+
     fn memories_mut(
         self: Pin<&mut Self>,
     ) -> &mut PrimaryMap<DefinedMemoryIndex, (MemoryAllocationIndex, Memory)> {
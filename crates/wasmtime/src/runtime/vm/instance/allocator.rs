@@ -5,13 +5,15 @@ use crate::runtime::vm::instance::{Instance, InstanceHandle};
 use crate::runtime::vm::memory::Memory;
 use crate::runtime::vm::mpk::ProtectionKey;
 use crate::runtime::vm::table::Table;
-use crate::runtime::vm::{CompiledModuleId, ModuleRuntimeInfo};
+use crate::runtime::vm::{CompiledModuleId, MemoryImage, ModuleMemoryImages, ModuleRuntimeInfo};
 use crate::store::{Asyncness, InstanceId, StoreOpaque, StoreResourceLimiter};
 use crate::{OpaqueRootScope, Val};
+use alloc::sync::Arc;
 use core::{mem, ptr};
 use wasmtime_environ::{
-    DefinedMemoryIndex, DefinedTableIndex, HostPtr, InitMemory, MemoryInitialization,
-    MemoryInitializer, Module, PrimaryMap, SizeOverflow, TableInitialValue, Trap, VMOffsets,
+    DefinedMemoryIndex, DefinedTableIndex, HostPtr, InitMemory, MemoryIndex, MemoryInitialization,
+    MemoryInitializer, Module, PrimaryMap, SizeOverflow, StaticMemoryInitializer,
+    TableInitialValue, Trap, VMOffsets,
 };
 
 #[cfg(feature = "gc")]
@@ -55,6 +57,21 @@ pub struct InstanceAllocationRequest<'a, 'b> {
 
     /// The store's resource limiter, if configured by the embedder.
     pub limiter: Option<&'a mut StoreResourceLimiter<'b>>,
+
+    /// Images to initialize memories with instead of the module's own, for
+    /// example when instantiating from a snapshot.
+    pub memory_images: Option<&'a ModuleMemoryImages>,
+}
+
+impl<'a> InstanceAllocationRequest<'a, '_> {
+    /// Returns the `MemoryImage` to use for copy-on-write initialization of
+    /// `memory`, if any.
+    fn memory_image(&self, memory: DefinedMemoryIndex) -> Result<Option<&'a Arc<MemoryImage>>> {
+        match self.memory_images {
+            Some(images) => Ok(images.get_memory_image(memory)),
+            None => self.runtime_info.memory_image(memory),
+        }
+    }
 }
 
 /// The index of a memory allocation within an `InstanceAllocator`.
@@ -269,6 +286,14 @@ pub unsafe trait InstanceAllocator: Send + Sync {
     /// this module from slots in linear memory.
     fn purge_module(&self, module: CompiledModuleId);
 
+    /// Releases memory that this allocator keeps around for reuse, such as
+    /// pages kept resident in unused pool slots or cached fiber stacks, until
+    /// at least `target_bytes` have been released or nothing is left to
+    /// release.
+    ///
+    /// Returns an estimate of the number of bytes released.
+    fn trim(&self, target_bytes: usize) -> usize;
+
     /// Use the next available protection key.
     ///
     /// The pooling allocator can use memory protection keys (MPK) for
@@ -292,6 +317,11 @@ pub unsafe trait InstanceAllocator: Send + Sync {
     fn as_pooling(&self) -> Option<&PoolingInstanceAllocator> {
         None
     }
+
+    /// Returns `Some(&OnDemandInstanceAllocator)` if this is one.
+    fn as_on_demand(&self) -> Option<&OnDemandInstanceAllocator> {
+        None
+    }
 }
 
 impl dyn InstanceAllocator + '_ {
@@ -576,6 +606,17 @@ async fn initialize_tables(
         .await?;
     }
 
+    // Compiled code expects some tables to be fully initialized despite lazy
+    // initialization, so initialize what the segments above didn't.
+    for index in module.tables.keys() {
+        if !module.table_initialized_eagerly(store.engine().tunables(), index) {
+            continue;
+        }
+        let defined_index = module.defined_table_index(index).unwrap();
+        let (instance, registry) = store.instance_and_module_registry_mut(context.instance);
+        instance.init_table_eagerly(registry, defined_index);
+    }
+
     Ok(())
 }
 
@@ -631,11 +672,42 @@ fn check_memory_init_bounds(
     Ok(())
 }
 
-fn initialize_memories(
+/// When instantiating asynchronously, the number of bytes of data segments
+/// copied into linear memory between yields.
+#[cfg(feature = "async")]
+const MEMORY_INIT_YIELD_BYTES: usize = 1 << 20;
+
+/// Copies `len` bytes of the data of `init`, starting `start` bytes into it,
+/// into memory `memory_index` of `instance`.
+fn write_memory_init(
+    instance: &Instance,
+    memory_index: MemoryIndex,
+    init: &StaticMemoryInitializer,
+    start: usize,
+    len: usize,
+) {
+    let memory = instance.get_memory(memory_index);
+
+    unsafe {
+        let src = &instance.wasm_data(init.data.clone())[start..][..len];
+        let offset = usize::try_from(init.offset).unwrap() + start;
+        let dst = memory.base.as_ptr().add(offset);
+
+        assert!(offset + src.len() <= memory.current_length());
+
+        // FIXME audit whether this is safe in the presence of shared
+        // memory
+        // (https://github.com/bytecodealliance/wasmtime/issues/4203).
+        ptr::copy_nonoverlapping(src.as_ptr(), dst, src.len())
+    }
+}
+
+async fn initialize_memories(
     store: &mut StoreOpaque,
     context: &mut ConstEvalContext,
     const_evaluator: &mut ConstExprEvaluator,
     module: &Module,
+    asyncness: Asyncness,
 ) -> Result<()> {
     // Delegates to the `init_memory` method which is sort of a duplicate of
     // `instance.memory_init_segment` but is used at compile-time in other
@@ -651,6 +723,11 @@ fn initialize_memories(
         store: &'a mut StoreOpaque,
         context: &'a mut ConstEvalContext,
         const_evaluator: &'a mut ConstExprEvaluator,
+        /// If present, writes are recorded here to be performed after all
+        /// segments have been visited, so that they can be interleaved with
+        /// yields. Segment offsets are constant expressions which can't read
+        /// memory, so deferring the writes isn't observable.
+        deferred: Option<Vec<(MemoryIndex, StaticMemoryInitializer)>>,
     }
 
     impl InitMemory for InitMemoryAtInstantiation<'_> {
@@ -692,38 +769,58 @@ fn initialize_memories(
             // doesn't need initialization, due to something like copy-on-write
             // pre-initializing it via mmap magic, then this initializer can be
             // skipped entirely.
-            let instance = self.store.instance_mut(self.context.instance);
+            let instance = self.store.instance(self.context.instance);
             if let Some(memory_index) = self.module.defined_memory_index(memory_index) {
                 if !instance.memories[memory_index].1.needs_init() {
                     return true;
                 }
             }
-            let memory = instance.get_memory(memory_index);
-
-            unsafe {
-                let src = instance.wasm_data(init.data.clone());
-                let offset = usize::try_from(init.offset).unwrap();
-                let dst = memory.base.as_ptr().add(offset);
+            match &mut self.deferred {
+                Some(deferred) => deferred.push((memory_index, init.clone())),
+                None => write_memory_init(instance, memory_index, init, 0, init.data.len()),
+            }
+            true
+        }
+    }
 
-                assert!(offset + src.len() <= memory.current_length());
+    // Large data segments can take a while to copy, so when instantiating
+    // asynchronously the copies are split into chunks with yields in between.
+    let deferred = match asyncness {
+        Asyncness::No => None,
+        #[cfg(feature = "async")]
+        Asyncness::Yes => Some(Vec::new()),
+    };
+    let mut state = InitMemoryAtInstantiation {
+        module,
+        store: &mut *store,
+        context: &mut *context,
+        const_evaluator,
+        deferred,
+    };
+    let ok = module.memory_initialization.init_memory(&mut state);
 
-                // FIXME audit whether this is safe in the presence of shared
-                // memory
-                // (https://github.com/bytecodealliance/wasmtime/issues/4203).
-                ptr::copy_nonoverlapping(src.as_ptr(), dst, src.len())
+    #[cfg(feature = "async")]
+    if let Some(deferred) = state.deferred {
+        // Writes preceding an out-of-bounds segment are still performed, as
+        // they would have been synchronously.
+        let mut copied = 0;
+        for (memory_index, init) in deferred {
+            let len = init.data.len();
+            let mut start = 0;
+            while start < len {
+                let chunk = (len - start).min(MEMORY_INIT_YIELD_BYTES - copied);
+                let instance = store.instance(context.instance);
+                write_memory_init(instance, memory_index, &init, start, chunk);
+                start += chunk;
+                copied += chunk;
+                if copied == MEMORY_INIT_YIELD_BYTES {
+                    copied = 0;
+                    crate::runtime::vm::Yield::new().await;
+                }
             }
-            true
         }
     }
 
-    let ok = module
-        .memory_initialization
-        .init_memory(&mut InitMemoryAtInstantiation {
-            module,
-            store,
-            context,
-            const_evaluator,
-        });
     if !ok {
         return Err(Trap::MemoryOutOfBounds.into());
     }
@@ -842,7 +939,14 @@ pub async fn initialize_instance(
         module,
     )
     .await?;
-    initialize_memories(store, &mut context, &mut const_evaluator, &module)?;
+    initialize_memories(
+        store,
+        &mut context,
+        &mut const_evaluator,
+        &module,
+        asyncness,
+    )
+    .await?;
 
     Ok(())
 }
@@ -13,6 +13,10 @@ use wasmtime_environ::{DefinedMemoryIndex, DefinedTableIndex, HostPtr, Module, V
 #[cfg(feature = "gc")]
 use crate::runtime::vm::{GcHeap, GcHeapAllocationIndex, GcRuntime};
 
+#[cfg(feature = "async")]
+use crate::sync::RwLock;
+#[cfg(feature = "async")]
+use core::sync::atomic::{AtomicU64, Ordering};
 #[cfg(feature = "async")]
 use wasmtime_fiber::RuntimeFiberStackCreator;
 
@@ -32,6 +36,19 @@ pub struct OnDemandInstanceAllocator {
     stack_size: usize,
     #[cfg(feature = "async")]
     stack_zeroing: bool,
+    #[cfg(feature = "async")]
+    stack_cache: Arc<StackCache>,
+}
+
+/// Fiber stacks released to an `OnDemandInstanceAllocator`, kept to be handed
+/// out again instead of being unmapped. Shared by clones of the allocator.
+#[cfg(feature = "async")]
+#[derive(Default)]
+struct StackCache {
+    stacks: RwLock<Vec<wasmtime_fiber::FiberStack>>,
+    max: usize,
+    hits: AtomicU64,
+    misses: AtomicU64,
 }
 
 impl OnDemandInstanceAllocator {
@@ -50,6 +67,8 @@ impl OnDemandInstanceAllocator {
             stack_size,
             #[cfg(feature = "async")]
             stack_zeroing,
+            #[cfg(feature = "async")]
+            stack_cache: Default::default(),
         }
     }
 
@@ -58,6 +77,27 @@ impl OnDemandInstanceAllocator {
     pub fn set_stack_creator(&mut self, stack_creator: Arc<dyn RuntimeFiberStackCreator>) {
         self.stack_creator = Some(stack_creator);
     }
+
+    /// Keep up to `size` released fiber stacks for reuse.
+    #[cfg(feature = "async")]
+    pub fn set_stack_cache_size(&mut self, size: usize) {
+        self.stack_cache = Arc::new(StackCache {
+            max: size,
+            ..StackCache::default()
+        });
+    }
+
+    /// Returns the number of cached fiber stacks, and the number of fiber
+    /// stack allocations which did and didn't reuse one.
+    #[cfg(feature = "async")]
+    pub(crate) fn stack_cache_stats(&self) -> (usize, u64, u64) {
+        let cache = &self.stack_cache;
+        (
+            cache.stacks.read().len(),
+            cache.hits.load(Ordering::Relaxed),
+            cache.misses.load(Ordering::Relaxed),
+        )
+    }
 }
 
 impl Default for OnDemandInstanceAllocator {
@@ -70,6 +110,8 @@ impl Default for OnDemandInstanceAllocator {
             stack_size: 0,
             #[cfg(feature = "async")]
             stack_zeroing: false,
+            #[cfg(feature = "async")]
+            stack_cache: Default::default(),
         }
     }
 }
@@ -121,7 +163,7 @@ unsafe impl InstanceAllocator for OnDemandInstanceAllocator {
             .unwrap_or_else(|| &DefaultMemoryCreator);
 
         let image = if let Some(memory_index) = memory_index {
-            request.runtime_info.memory_image(memory_index)?
+            request.memory_image(memory_index)?
         } else {
             None
         };
@@ -132,6 +174,7 @@ unsafe impl InstanceAllocator for OnDemandInstanceAllocator {
             request.store.engine(),
             creator,
             image,
+            request.store.numa_node(),
             request.limiter.as_deref_mut(),
         )
         .await?;
@@ -179,6 +222,13 @@ unsafe impl InstanceAllocator for OnDemandInstanceAllocator {
         if self.stack_size == 0 {
             crate::bail!("fiber stacks are not supported by the allocator")
         }
+        if self.stack_cache.max > 0 {
+            if let Some(stack) = self.stack_cache.stacks.write().pop() {
+                self.stack_cache.hits.fetch_add(1, Ordering::Relaxed);
+                return Ok(stack);
+            }
+            self.stack_cache.misses.fetch_add(1, Ordering::Relaxed);
+        }
         let stack = match &self.stack_creator {
             Some(stack_creator) => {
                 let stack = stack_creator.new_stack(self.stack_size, self.stack_zeroing)?;
@@ -191,13 +241,40 @@ unsafe impl InstanceAllocator for OnDemandInstanceAllocator {
 
     #[cfg(feature = "async")]
     unsafe fn deallocate_fiber_stack(&self, stack: wasmtime_fiber::FiberStack) {
-        // The on-demand allocator has no further bookkeeping for fiber stacks
-        // beyond dropping them.
-        let _ = stack;
+        // Stacks are either cached for reuse or dropped, there's no further
+        // bookkeeping.
+        if self.stack_cache.max > 0 {
+            let mut stacks = self.stack_cache.stacks.write();
+            if stacks.len() < self.stack_cache.max {
+                stacks.push(stack);
+            }
+        }
     }
 
     fn purge_module(&self, _: CompiledModuleId) {}
 
+    #[cfg(feature = "async")]
+    fn trim(&self, target_bytes: usize) -> usize {
+        // Cached stacks are the only memory kept around here.
+        let mut trimmed = 0;
+        while trimmed < target_bytes {
+            let Some(stack) = self.stack_cache.stacks.write().pop() else {
+                break;
+            };
+            trimmed += stack.range().map_or(self.stack_size, |r| r.len());
+        }
+        trimmed
+    }
+
+    #[cfg(not(feature = "async"))]
+    fn trim(&self, _target_bytes: usize) -> usize {
+        0
+    }
+
+    fn as_on_demand(&self) -> Option<&OnDemandInstanceAllocator> {
+        Some(self)
+    }
+
     fn next_available_pkey(&self) -> Option<ProtectionKey> {
         // The on-demand allocator cannot use protection keys--it requires
         // back-to-back allocation of memory slots that this allocator cannot
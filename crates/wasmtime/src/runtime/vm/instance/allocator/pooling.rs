@@ -18,6 +18,7 @@
 //! item is stored in its own separate pool: [`memory_pool`], [`table_pool`],
 //! [`stack_pool`]. See those modules for more details.
 
+mod background_decommit;
 mod decommit_queue;
 mod index_allocator;
 mod memory_pool;
@@ -41,6 +42,7 @@ cfg_if::cfg_if! {
     }
 }
 
+use self::background_decommit::BackgroundDecommit;
 use self::decommit_queue::DecommitQueue;
 use self::memory_pool::MemoryPool;
 use self::table_pool::TablePool;
@@ -231,6 +233,12 @@ pub struct PoolingInstanceAllocatorConfig {
     pub max_memory_protection_keys: usize,
     /// Whether to enable PAGEMAP_SCAN on Linux.
     pub pagemap_scan: Enabled,
+    /// Whether to reset and decommit deallocated slots on a background
+    /// thread.
+    pub background_decommit: bool,
+    /// Whether linear memories of stores without a NUMA node are placed on
+    /// the node of the thread allocating them.
+    pub numa_local_memory: bool,
 }
 
 impl Default for PoolingInstanceAllocatorConfig {
@@ -248,6 +256,8 @@ impl Default for PoolingInstanceAllocatorConfig {
             memory_protection_keys: Enabled::No,
             max_memory_protection_keys: 16,
             pagemap_scan: Enabled::No,
+            background_decommit: false,
+            numa_local_memory: false,
         }
     }
 }
@@ -327,10 +337,20 @@ pub struct PoolingInstanceAllocator {
     live_stacks: AtomicUsize,
 
     pagemap: Option<PageMap>,
+
+    /// Present when deallocated slots are reset and decommitted on a
+    /// background thread rather than by the deallocating thread.
+    background_decommit: Option<BackgroundDecommit>,
 }
 
 impl Drop for PoolingInstanceAllocator {
     fn drop(&mut self) {
+        // The background thread borrows this allocator, so it must always be
+        // stopped before the pools are torn down.
+        if let Some(background) = &self.background_decommit {
+            background.shutdown();
+        }
+
         if !cfg!(debug_assertions) {
             return;
         }
@@ -398,6 +418,7 @@ impl PoolingInstanceAllocator {
                 })?),
                 Enabled::No => None,
             },
+            background_decommit: config.background_decommit.then(BackgroundDecommit::default),
         })
     }
 
@@ -498,6 +519,17 @@ impl PoolingInstanceAllocator {
         queue.flush(self)
     }
 
+    /// Waits for any outstanding background decommits and then flushes the
+    /// decommit queue, returning whether either may have freed up slots.
+    fn flush_for_retry(&self) -> bool {
+        let waited = self
+            .background_decommit
+            .as_ref()
+            .is_some_and(|b| b.wait_idle());
+        let queue = self.decommit_queue.lock().unwrap();
+        self.flush_decommit_queue(queue) || waited
+    }
+
     /// Execute `f` and if it returns `Err(PoolConcurrencyLimitError)`, then try
     /// flushing the decommit queue. If flushing the queue freed up slots, then
     /// try running `f` again.
@@ -505,8 +537,7 @@ impl PoolingInstanceAllocator {
     fn with_flush_and_retry<T>(&self, mut f: impl FnMut() -> Result<T>) -> Result<T> {
         f().or_else(|e| {
             if e.is::<PoolConcurrencyLimitError>() {
-                let queue = self.decommit_queue.lock().unwrap();
-                if self.flush_decommit_queue(queue) {
+                if self.flush_for_retry() {
                     return f();
                 }
             }
@@ -548,6 +579,113 @@ impl PoolingInstanceAllocator {
             }
         }
     }
+
+    /// Resets a deallocated memory's image slot and returns it to the memory
+    /// pool, possibly after a batched decommit.
+    ///
+    /// # Safety
+    ///
+    /// The memory must no longer be in use.
+    unsafe fn reset_memory(&self, allocation_index: MemoryAllocationIndex, memory: Memory) {
+        // Reset the image slot. If there is any error clearing the
+        // image, just drop it here, and let the drop handler for the
+        // slot unmap in a way that retains the address space
+        // reservation.
+        let mut image = memory.unwrap_static_image();
+        let mut queue = DecommitQueue::default();
+        let bytes_resident = image
+            .clear_and_remain_ready(
+                self.pagemap.as_ref(),
+                self.memories.keep_resident,
+                |ptr, len| {
+                    // SAFETY: the memory in `image` won't be used until this
+                    // decommit queue is flushed, and by definition the memory is
+                    // not in use when calling this function.
+                    unsafe {
+                        queue.push_raw(ptr, len);
+                    }
+                },
+            )
+            .expect("failed to reset memory image");
+
+        // SAFETY: this image is not in use and its memory regions were enqueued
+        // with `push_raw` above.
+        unsafe {
+            queue.push_memory(allocation_index, image, bytes_resident);
+        }
+        self.merge_or_flush(queue);
+    }
+
+    /// Zeroes a deallocated table's pages and returns it to the table pool,
+    /// possibly after a batched decommit.
+    ///
+    /// # Safety
+    ///
+    /// The table must no longer be in use.
+    unsafe fn reset_table(&self, allocation_index: TableAllocationIndex, mut table: Table) {
+        let mut queue = DecommitQueue::default();
+        // SAFETY: This table is no longer in use by the allocator when this
+        // method is called and additionally all image ranges are pushed with
+        // the understanding that the memory won't get used until the whole
+        // queue is flushed.
+        let bytes_resident = unsafe {
+            self.tables.reset_table_pages_to_zero(
+                self.pagemap.as_ref(),
+                allocation_index,
+                &mut table,
+                |ptr, len| {
+                    queue.push_raw(ptr, len);
+                },
+            )
+        };
+
+        // SAFETY: the table has had all its memory regions enqueued above.
+        unsafe {
+            queue.push_table(allocation_index, table, bytes_resident);
+        }
+        self.merge_or_flush(queue);
+    }
+
+    /// Zeroes a deallocated fiber stack and returns it to the stack pool,
+    /// possibly after a batched decommit.
+    ///
+    /// # Safety
+    ///
+    /// The stack must no longer be in use.
+    #[cfg(feature = "async")]
+    unsafe fn reset_fiber_stack(&self, mut stack: wasmtime_fiber::FiberStack) {
+        let mut queue = DecommitQueue::default();
+        // SAFETY: the stack is no longer in use by definition when this
+        // function is called and memory ranges pushed here are otherwise no
+        // longer in use.
+        let bytes_resident = unsafe {
+            self.stacks
+                .zero_stack(&mut stack, |ptr, len| queue.push_raw(ptr, len))
+        };
+        // SAFETY: this stack's memory regions were enqueued above.
+        unsafe {
+            queue.push_stack(stack, bytes_resident);
+        }
+        self.merge_or_flush(queue);
+    }
+
+    /// Waits for any outstanding background decommits, so that no slots are
+    /// owned by the background thread when the process forks.
+    pub fn prepare_fork(&self) {
+        if let Some(background) = &self.background_decommit {
+            background.wait_idle();
+        }
+    }
+
+    /// Replaces the background decommit thread, which doesn't exist in a
+    /// child process forked after `prepare_fork`.
+    pub fn after_fork_child(&self) {
+        if let Some(background) = &self.background_decommit {
+            // SAFETY: this allocator is owned by its engine and doesn't move
+            // once deallocations start.
+            unsafe { background.after_fork_child(self) }
+        }
+    }
 }
 
 #[async_trait::async_trait]
@@ -689,8 +827,7 @@ unsafe impl InstanceAllocator for PoolingInstanceAllocator {
             };
 
             if e.is::<PoolConcurrencyLimitError>() {
-                let queue = self.decommit_queue.lock().unwrap();
-                if self.flush_decommit_queue(queue) {
+                if self.flush_for_retry() {
                     return self.memories.allocate(request, ty, memory_index).await;
                 }
             }
@@ -712,33 +849,20 @@ unsafe impl InstanceAllocator for PoolingInstanceAllocator {
         let prev = self.live_memories.fetch_sub(1, Ordering::Relaxed);
         debug_assert!(prev > 0);
 
-        // Reset the image slot. If there is any error clearing the
-        // image, just drop it here, and let the drop handler for the
-        // slot unmap in a way that retains the address space
-        // reservation.
-        let mut image = memory.unwrap_static_image();
-        let mut queue = DecommitQueue::default();
-        let bytes_resident = image
-            .clear_and_remain_ready(
-                self.pagemap.as_ref(),
-                self.memories.keep_resident,
-                |ptr, len| {
-                    // SAFETY: the memory in `image` won't be used until this
-                    // decommit queue is flushed, and by definition the memory is
-                    // not in use when calling this function.
-                    unsafe {
-                        queue.push_raw(ptr, len);
-                    }
-                },
-            )
-            .expect("failed to reset memory image");
-
-        // SAFETY: this image is not in use and its memory regions were enqueued
-        // with `push_raw` above.
-        unsafe {
-            queue.push_memory(allocation_index, image, bytes_resident);
+        match &self.background_decommit {
+            Some(background) => {
+                let job = Box::new(move |pool: &PoolingInstanceAllocator| {
+                    // SAFETY: the memory is no longer in use, per this
+                    // method's contract, and is owned by this job.
+                    unsafe { pool.reset_memory(allocation_index, memory) }
+                });
+                // SAFETY: this allocator is owned by its engine and doesn't
+                // move once deallocations start.
+                unsafe { background.submit(self, job) }
+            }
+            // SAFETY: same as this method.
+            None => unsafe { self.reset_memory(allocation_index, memory) },
         }
-        self.merge_or_flush(queue);
     }
 
     async fn allocate_table(
@@ -756,8 +880,7 @@ unsafe impl InstanceAllocator for PoolingInstanceAllocator {
             };
 
             if e.is::<PoolConcurrencyLimitError>() {
-                let queue = self.decommit_queue.lock().unwrap();
-                if self.flush_decommit_queue(queue) {
+                if self.flush_for_retry() {
                     return self.tables.allocate(request, ty).await;
                 }
             }
@@ -774,32 +897,24 @@ unsafe impl InstanceAllocator for PoolingInstanceAllocator {
         &self,
         _table_index: DefinedTableIndex,
         allocation_index: TableAllocationIndex,
-        mut table: Table,
+        table: Table,
     ) {
         let prev = self.live_tables.fetch_sub(1, Ordering::Relaxed);
         debug_assert!(prev > 0);
 
-        let mut queue = DecommitQueue::default();
-        // SAFETY: This table is no longer in use by the allocator when this
-        // method is called and additionally all image ranges are pushed with
-        // the understanding that the memory won't get used until the whole
-        // queue is flushed.
-        let bytes_resident = unsafe {
-            self.tables.reset_table_pages_to_zero(
-                self.pagemap.as_ref(),
-                allocation_index,
-                &mut table,
-                |ptr, len| {
-                    queue.push_raw(ptr, len);
-                },
-            )
-        };
-
-        // SAFETY: the table has had all its memory regions enqueued above.
-        unsafe {
-            queue.push_table(allocation_index, table, bytes_resident);
+        match &self.background_decommit {
+            Some(background) => {
+                let job = Box::new(move |pool: &PoolingInstanceAllocator| {
+                    // SAFETY: the table is no longer in use, per this method's
+                    // contract, and is owned by this job.
+                    unsafe { pool.reset_table(allocation_index, table) }
+                });
+                // SAFETY: see `deallocate_memory`.
+                unsafe { background.submit(self, job) }
+            }
+            // SAFETY: same as this method.
+            None => unsafe { self.reset_table(allocation_index, table) },
         }
-        self.merge_or_flush(queue);
     }
 
     #[cfg(feature = "async")]
@@ -810,27 +925,42 @@ unsafe impl InstanceAllocator for PoolingInstanceAllocator {
     }
 
     #[cfg(feature = "async")]
-    unsafe fn deallocate_fiber_stack(&self, mut stack: wasmtime_fiber::FiberStack) {
+    unsafe fn deallocate_fiber_stack(&self, stack: wasmtime_fiber::FiberStack) {
         self.live_stacks.fetch_sub(1, Ordering::Relaxed);
-        let mut queue = DecommitQueue::default();
-        // SAFETY: the stack is no longer in use by definition when this
-        // function is called and memory ranges pushed here are otherwise no
-        // longer in use.
-        let bytes_resident = unsafe {
-            self.stacks
-                .zero_stack(&mut stack, |ptr, len| queue.push_raw(ptr, len))
-        };
-        // SAFETY: this stack's memory regions were enqueued above.
-        unsafe {
-            queue.push_stack(stack, bytes_resident);
+        match &self.background_decommit {
+            Some(background) => {
+                let job = Box::new(move |pool: &PoolingInstanceAllocator| {
+                    // SAFETY: the stack is no longer in use, per this method's
+                    // contract, and is owned by this job.
+                    unsafe { pool.reset_fiber_stack(stack) }
+                });
+                // SAFETY: see `deallocate_memory`.
+                unsafe { background.submit(self, job) }
+            }
+            // SAFETY: same as this method.
+            None => unsafe { self.reset_fiber_stack(stack) },
         }
-        self.merge_or_flush(queue);
     }
 
     fn purge_module(&self, module: CompiledModuleId) {
         self.memories.purge_module(module);
     }
 
+    fn trim(&self, target_bytes: usize) -> usize {
+        // Slots waiting in the decommit queue can't be trimmed, so flush it
+        // first.
+        let queue = self.decommit_queue.lock().unwrap();
+        self.flush_decommit_queue(queue);
+
+        let mut trimmed = self.memories.trim(target_bytes);
+        trimmed += self.tables.trim(target_bytes.saturating_sub(trimmed));
+        #[cfg(feature = "async")]
+        {
+            trimmed += self.stacks.trim(target_bytes.saturating_sub(trimmed));
+        }
+        trimmed
+    }
+
     fn next_available_pkey(&self) -> Option<ProtectionKey> {
         self.memories.next_available_pkey()
     }
@@ -0,0 +1,184 @@
+//! Support for resetting and decommitting pooling allocator slots on a
+//! background thread.
+//!
+//! When enabled via `PoolingAllocationConfig::background_decommit`, the work
+//! of deallocating a memory, table, or stack (zeroing the memory that is kept
+//! resident, queueing and performing the `madvise` decommits, and returning
+//! the slot to its free list) is sent to a dedicated thread instead of being
+//! performed on the thread that drops the store.
+//!
+//! Slots handed to the background thread are unavailable until it has
+//! processed them, so allocations that fail because a pool is exhausted first
+//! wait for the background thread to become idle before retrying, see
+//! `BackgroundDecommit::wait_idle`.
+//!
+//! The thread doesn't survive a `fork`, so a child process replaces it with a
+//! new one in `BackgroundDecommit::after_fork_child`.
+
+use super::PoolingInstanceAllocator;
+use crate::prelude::*;
+use crate::runtime::vm::SendSyncPtr;
+use core::mem;
+use core::ptr::NonNull;
+use std::fmt;
+use std::sync::mpsc::{self, Sender};
+use std::sync::{Condvar, Mutex, OnceLock};
+use std::thread::JoinHandle;
+
+/// A unit of deallocation work to perform on the background thread.
+///
+/// A job takes ownership of the memory, table, or stack that it resets. Once
+/// one of the `deallocate_*` methods has been called its slot is no longer
+/// referenced by any store, so the job is the only owner of the slot until
+/// it's returned to its free list and it's sound to move it to another
+/// thread. The slot types are `Send` (see `_assert_slots_send` below), so
+/// this doesn't need any `unsafe` on the part of the submitter.
+pub type Job = Box<dyn FnOnce(&PoolingInstanceAllocator) + Send>;
+
+fn _assert_slots_send() {
+    fn _assert_send<T: Send>() {}
+
+    _assert_send::<crate::runtime::vm::Memory>();
+    _assert_send::<crate::runtime::vm::Table>();
+    #[cfg(feature = "async")]
+    _assert_send::<wasmtime_fiber::FiberStack>();
+}
+
+/// State for the background decommit thread of a `PoolingInstanceAllocator`.
+///
+/// The thread is spawned lazily on the first submitted job, at which point the
+/// owning allocator has reached its final location in memory.
+#[derive(Default)]
+pub struct BackgroundDecommit {
+    worker: OnceLock<Worker>,
+    /// Number of jobs submitted which have not yet completed.
+    pending: Mutex<usize>,
+    /// Signaled whenever `pending` drops to zero.
+    idle: Condvar,
+}
+
+struct Worker {
+    /// The sending half of the job channel, or `None` if spawning the thread
+    /// failed or the worker has been shut down.
+    sender: Mutex<Option<Sender<Job>>>,
+    thread: Mutex<Option<JoinHandle<()>>>,
+}
+
+impl fmt::Debug for BackgroundDecommit {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("BackgroundDecommit")
+            .field("pending", &*self.pending.lock().unwrap())
+            .finish_non_exhaustive()
+    }
+}
+
+impl BackgroundDecommit {
+    /// Submits `job` to run on the background thread, spawning the thread if
+    /// this is the first job.
+    ///
+    /// If the background thread can't be spawned, or has exited, then `job`
+    /// is run on the current thread instead.
+    ///
+    /// # Safety
+    ///
+    /// `pool` must be the allocator which owns `self`, and it must not be
+    /// moved before `shutdown` has been called.
+    pub unsafe fn submit(&self, pool: &PoolingInstanceAllocator, job: Job) {
+        *self.pending.lock().unwrap() += 1;
+        let worker = self.worker.get_or_init(|| Worker::spawn(self, pool));
+        let job = match &*worker.sender.lock().unwrap() {
+            Some(sender) => match sender.send(job) {
+                Ok(()) => return,
+                Err(mpsc::SendError(job)) => job,
+            },
+            None => job,
+        };
+        job(pool);
+        self.job_done();
+    }
+
+    fn job_done(&self) {
+        let mut pending = self.pending.lock().unwrap();
+        *pending -= 1;
+        if *pending == 0 {
+            self.idle.notify_all();
+        }
+    }
+
+    /// Blocks until all submitted jobs have completed.
+    ///
+    /// Returns whether any jobs were outstanding, and so whether any slots may
+    /// have been returned to their pools.
+    pub fn wait_idle(&self) -> bool {
+        let mut pending = self.pending.lock().unwrap();
+        let had_pending = *pending > 0;
+        while *pending > 0 {
+            pending = self.idle.wait(pending).unwrap();
+        }
+        had_pending
+    }
+
+    /// Replaces the background thread, if it was spawned, with a new one in a
+    /// child process forked while it existed.
+    ///
+    /// The caller must have waited for the thread to become idle with
+    /// `wait_idle` before forking.
+    ///
+    /// # Safety
+    ///
+    /// Same as `submit`.
+    pub unsafe fn after_fork_child(&self, pool: &PoolingInstanceAllocator) {
+        let Some(worker) = self.worker.get() else {
+            return;
+        };
+        // The handle refers to a thread of the parent process, which can't
+        // be joined from the child.
+        mem::forget(worker.thread.lock().unwrap().take());
+        let new = Worker::spawn(self, pool);
+        *worker.sender.lock().unwrap() = new.sender.into_inner().unwrap();
+        *worker.thread.lock().unwrap() = new.thread.into_inner().unwrap();
+    }
+
+    /// Completes all outstanding jobs and stops the background thread.
+    pub fn shutdown(&self) {
+        let Some(worker) = self.worker.get() else {
+            return;
+        };
+        drop(worker.sender.lock().unwrap().take());
+        if let Some(thread) = worker.thread.lock().unwrap().take() {
+            let _ = thread.join();
+        }
+    }
+}
+
+impl Worker {
+    fn spawn(state: &BackgroundDecommit, pool: &PoolingInstanceAllocator) -> Worker {
+        let (sender, receiver) = mpsc::channel::<Job>();
+        let state = SendSyncPtr::new(NonNull::from(state));
+        let pool = SendSyncPtr::new(NonNull::from(pool));
+        let thread = std::thread::Builder::new()
+            .name("wasmtime-decommit".to_string())
+            .spawn(move || {
+                // SAFETY: the allocator joins this thread in `shutdown` before
+                // it is dropped, and doesn't move while this thread is running.
+                let (state, pool) = unsafe { (state.as_ref(), pool.as_ref()) };
+                for job in receiver {
+                    job(pool);
+                    state.job_done();
+                }
+            });
+        match thread {
+            Ok(thread) => Worker {
+                sender: Mutex::new(Some(sender)),
+                thread: Mutex::new(Some(thread)),
+            },
+            Err(e) => {
+                log::warn!("failed to spawn background decommit thread: {e}");
+                Worker {
+                    sender: Mutex::new(None),
+                    thread: Mutex::new(None),
+                }
+            }
+        }
+    }
+}
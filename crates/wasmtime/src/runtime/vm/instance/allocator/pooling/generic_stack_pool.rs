@@ -87,10 +87,19 @@ impl StackPool {
         let _ = stack;
     }
 
+    pub fn trim(&self, _target_bytes: usize) -> usize {
+        0
+    }
+
     pub fn unused_warm_slots(&self) -> u32 {
         0
     }
 
+    pub fn unused_cold_slots(&self) -> u32 {
+        let live = self.live_stacks.load(Ordering::Relaxed);
+        u32::try_from(self.stack_limit.saturating_sub(live)).unwrap_or(u32::MAX)
+    }
+
     pub fn unused_bytes_resident(&self) -> Option<usize> {
         None
     }
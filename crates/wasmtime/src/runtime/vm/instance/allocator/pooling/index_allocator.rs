@@ -66,6 +66,22 @@ impl SimpleIndexAllocator {
         self.0.unused_bytes_resident()
     }
 
+    /// Returns the number of slots in this allocator which have never been
+    /// used.
+    pub fn unused_cold_slots(&self) -> u32 {
+        self.0.unused_cold_slots()
+    }
+
+    /// See [`ModuleAffinityIndexAllocator::trimmable_slots`].
+    pub fn trimmable_slots(&self) -> Vec<SlotId> {
+        self.0.trimmable_slots()
+    }
+
+    /// See [`ModuleAffinityIndexAllocator::alloc_warm_and_clear_affinity`].
+    pub fn alloc_warm_and_clear_affinity(&self, slot: SlotId) -> Option<usize> {
+        self.0.alloc_warm_and_clear_affinity(slot)
+    }
+
     #[cfg(test)]
     pub(crate) fn testing_freelist(&self) -> Vec<SlotId> {
         self.0.testing_freelist()
@@ -122,6 +138,14 @@ struct Inner {
 
     /// Cache for the sum of the `bytes_resident` of all `UnusedWarm` slots.
     unused_bytes_resident: usize,
+
+    /// Number of allocations requesting an affinity which were satisfied by
+    /// a slot affine to the request.
+    affinity_hits: u64,
+
+    /// Number of allocations requesting an affinity for which no affine slot
+    /// was available.
+    affinity_misses: u64,
 }
 
 /// A helper "linked list" data structure which is based on indices.
@@ -141,8 +165,9 @@ struct Link {
 
 #[derive(Clone, Debug)]
 enum SlotState {
-    /// This slot is currently in use and is affine to the specified module's memory.
-    Used(Option<MemoryInModule>),
+    /// This slot is currently in use and is affine to the specified module's
+    /// memory, and to the specified store affinity key.
+    Used(Option<MemoryInModule>, Option<u64>),
 
     /// This slot is not currently used, and has never been used.
     UnusedCold,
@@ -168,6 +193,9 @@ struct Unused {
     /// Which module this slot was historically affine to, if any.
     affinity: Option<MemoryInModule>,
 
+    /// The affinity key of the store that last used this slot, if any.
+    key: Option<u64>,
+
     /// Number of bytes that are part of `UnusedWarm` slots and are currently
     /// kept resident (vs paged out).
     bytes_resident: usize,
@@ -179,6 +207,10 @@ struct Unused {
     unused_list_link: Link,
 }
 
+/// Maximum number of affine slots inspected when looking for a slot last used
+/// with a particular affinity key, bounding the cost of allocation.
+const MAX_KEY_SCAN: usize = 16;
+
 enum AllocMode {
     ForceAffineAndClear,
     AnySlot,
@@ -195,6 +227,8 @@ impl ModuleAffinityIndexAllocator {
             slot_state: (0..capacity).map(|_| SlotState::UnusedCold).collect(),
             warm: List::default(),
             unused_bytes_resident: 0,
+            affinity_hits: 0,
+            affinity_misses: 0,
         }))
     }
 
@@ -210,7 +244,7 @@ impl ModuleAffinityIndexAllocator {
         !inner
             .slot_state
             .iter()
-            .any(|s| matches!(s, SlotState::Used(_)))
+            .any(|s| matches!(s, SlotState::Used(..)))
     }
 
     /// Allocate a new index from this allocator optionally using `id` as an
@@ -218,7 +252,18 @@ impl ModuleAffinityIndexAllocator {
     ///
     /// Returns `None` if no more slots are available.
     pub fn alloc(&self, for_memory: Option<MemoryInModule>) -> Option<SlotId> {
-        self._alloc(for_memory, AllocMode::AnySlot)
+        self._alloc(for_memory, None, AllocMode::AnySlot)
+    }
+
+    /// Same as [`Self::alloc`], but amongst the slots affine to `for_memory`
+    /// additionally prefers the one most recently used with the affinity
+    /// `key`, if any.
+    pub fn alloc_with_key(
+        &self,
+        for_memory: Option<MemoryInModule>,
+        key: Option<u64>,
+    ) -> Option<SlotId> {
+        self._alloc(for_memory, key, AllocMode::AnySlot)
     }
 
     /// Attempts to allocate a guaranteed-affine slot to the module `id`
@@ -235,18 +280,33 @@ impl ModuleAffinityIndexAllocator {
     ) -> Option<SlotId> {
         self._alloc(
             Some(MemoryInModule(module_id, memory_index)),
+            None,
             AllocMode::ForceAffineAndClear,
         )
     }
 
-    fn _alloc(&self, for_memory: Option<MemoryInModule>, mode: AllocMode) -> Option<SlotId> {
+    fn _alloc(
+        &self,
+        for_memory: Option<MemoryInModule>,
+        key: Option<u64>,
+        mode: AllocMode,
+    ) -> Option<SlotId> {
         let mut inner = self.0.lock().unwrap();
         let inner = &mut *inner;
 
         // As a first-pass always attempt an affine allocation. This will
         // succeed if any slots are considered affine to `module_id` (if it's
         // specified). Failing that something else is attempted to be chosen.
-        let slot_id = inner.pick_affine(for_memory).or_else(|| {
+        let affine = inner.pick_affine(for_memory, key);
+        // Track how often affinity requests are satisfied, for metrics.
+        if for_memory.is_some() && matches!(mode, AllocMode::AnySlot) {
+            if affine.is_some() {
+                inner.affinity_hits += 1;
+            } else {
+                inner.affinity_misses += 1;
+            }
+        }
+        let slot_id = affine.or_else(|| {
             match mode {
                 // If any slot is requested then this is a normal instantiation
                 // looking for an index. Without any affine candidates there are
@@ -291,10 +351,10 @@ impl ModuleAffinityIndexAllocator {
         if let SlotState::UnusedWarm(Unused { bytes_resident, .. }) = slot {
             inner.unused_bytes_resident -= *bytes_resident;
         }
-        *slot = SlotState::Used(match mode {
-            AllocMode::ForceAffineAndClear => None,
-            AllocMode::AnySlot => for_memory,
-        });
+        *slot = match mode {
+            AllocMode::ForceAffineAndClear => SlotState::Used(None, None),
+            AllocMode::AnySlot => SlotState::Used(for_memory, key),
+        };
 
         Some(slot_id)
     }
@@ -302,8 +362,8 @@ impl ModuleAffinityIndexAllocator {
     pub(crate) fn free(&self, index: SlotId, bytes_resident: usize) {
         let mut inner = self.0.lock().unwrap();
         let inner = &mut *inner;
-        let module_memory = match inner.slot_state[index.index()] {
-            SlotState::Used(module_memory) => module_memory,
+        let (module_memory, key) = match inner.slot_state[index.index()] {
+            SlotState::Used(module_memory, key) => (module_memory, key),
             _ => unreachable!(),
         };
 
@@ -336,12 +396,50 @@ impl ModuleAffinityIndexAllocator {
         inner.unused_bytes_resident += bytes_resident;
         inner.slot_state[index.index()] = SlotState::UnusedWarm(Unused {
             affinity: module_memory,
+            key,
             bytes_resident,
             affine_list_link,
             unused_list_link,
         });
     }
 
+    /// Returns the unused warm slots which still have bytes resident, from the
+    /// least to the most recently used.
+    ///
+    /// These are the slots which trimming can release memory from, see
+    /// `InstanceAllocator::trim`.
+    pub fn trimmable_slots(&self) -> Vec<SlotId> {
+        let inner = self.0.lock().unwrap();
+        inner
+            .warm
+            .iter(&inner.slot_state, |s| &s.unused_list_link)
+            .filter(|slot| {
+                let unused = match &inner.slot_state[slot.index()] {
+                    SlotState::UnusedWarm(u) => u,
+                    _ => unreachable!(),
+                };
+                unused.bytes_resident > 0
+            })
+            .collect()
+    }
+
+    /// Allocates `slot` if it's still unused and warm, without recording any
+    /// affinity for it, so that it can be trimmed and then freed again.
+    ///
+    /// Returns the number of bytes which were resident in the slot, or `None`
+    /// if it has been allocated since it was returned by `trimmable_slots`.
+    pub fn alloc_warm_and_clear_affinity(&self, slot: SlotId) -> Option<usize> {
+        let mut inner = self.0.lock().unwrap();
+        let bytes_resident = match &inner.slot_state[slot.index()] {
+            SlotState::UnusedWarm(u) => u.bytes_resident,
+            _ => return None,
+        };
+        inner.remove(slot);
+        inner.unused_bytes_resident -= bytes_resident;
+        inner.slot_state[slot.index()] = SlotState::Used(None, None);
+        Some(bytes_resident)
+    }
+
     /// Return the number of empty slots available in this allocator.
     #[cfg(test)]
     pub fn num_empty_slots(&self) -> usize {
@@ -386,16 +484,56 @@ impl ModuleAffinityIndexAllocator {
     pub fn unused_bytes_resident(&self) -> usize {
         self.0.lock().unwrap().unused_bytes_resident
     }
+
+    /// Returns the number of slots in this allocator which have never been
+    /// used.
+    ///
+    /// Note that this acquires a `Mutex` for synchronization at this time to
+    /// read the internal counter information.
+    pub fn unused_cold_slots(&self) -> u32 {
+        let inner = self.0.lock().unwrap();
+        u32::try_from(inner.slot_state.len()).unwrap() - inner.last_cold
+    }
+
+    /// Returns the number of allocations with an affinity request that were,
+    /// and were not, satisfied with an affine slot.
+    ///
+    /// Note that this acquires a `Mutex` for synchronization at this time to
+    /// read the internal counter information.
+    pub fn affinity_hits_and_misses(&self) -> (u64, u64) {
+        let inner = self.0.lock().unwrap();
+        (inner.affinity_hits, inner.affinity_misses)
+    }
 }
 
 impl Inner {
     /// Attempts to allocate a slot already affine to `id`, returning `None` if
     /// `id` is `None` or if there are no affine slots.
-    fn pick_affine(&mut self, for_memory: Option<MemoryInModule>) -> Option<SlotId> {
+    ///
+    /// If `key` is provided then the most recently used affine slot that was
+    /// last used with `key` is preferred, if one is found within the
+    /// `MAX_KEY_SCAN` most recently used affine slots.
+    fn pick_affine(
+        &mut self,
+        for_memory: Option<MemoryInModule>,
+        key: Option<u64>,
+    ) -> Option<SlotId> {
         // Note that the `tail` is chosen here of the affine list as it's the
         // most recently used, which for affine allocations is what we want --
         // maximizing temporal reuse.
-        let ret = self.module_affine.get(&for_memory?)?.tail?;
+        let mut ret = self.module_affine.get(&for_memory?)?.tail?;
+        if key.is_some() {
+            let mut cur = Some(ret);
+            for _ in 0..MAX_KEY_SCAN {
+                let Some(slot) = cur else { break };
+                let unused = self.slot_state[slot.index()].unwrap_unused();
+                if unused.key == key {
+                    ret = slot;
+                    break;
+                }
+                cur = unused.affine_list_link.prev;
+            }
+        }
         self.remove(ret);
         Some(ret)
     }
@@ -506,7 +644,6 @@ impl List {
         state
     }
 
-    #[cfg(test)]
     fn iter<'a>(
         &'a self,
         states: &'a [SlotState],
@@ -550,6 +687,31 @@ mod test {
         }
     }
 
+    #[test]
+    fn test_affinity_key() {
+        let id = MemoryInModule(CompiledModuleId::new(), DefinedMemoryIndex::new(0));
+        let state = ModuleAffinityIndexAllocator::new(100, 100);
+
+        let a = state.alloc_with_key(Some(id), Some(1)).unwrap();
+        let b = state.alloc_with_key(Some(id), Some(2)).unwrap();
+        state.free(a, 0);
+        state.free(b, 0);
+
+        // Without a key the most recently freed affine slot is used, but with
+        // a key the slot last used with that key is preferred.
+        let c = state.alloc_with_key(Some(id), Some(1)).unwrap();
+        assert_eq!(c, a);
+        state.free(c, 0);
+        let d = state.alloc(Some(id)).unwrap();
+        assert_eq!(d, a);
+        state.free(d, 0);
+
+        // An unknown key falls back to any affine slot.
+        let e = state.alloc_with_key(Some(id), Some(3)).unwrap();
+        assert!(e == a || e == b);
+        assert_eq!(state.affinity_hits_and_misses(), (3, 2));
+    }
+
     #[test]
     fn test_affinity_allocation_strategy() {
         let id1 = MemoryInModule(CompiledModuleId::new(), DefinedMemoryIndex::new(0));
@@ -138,6 +138,11 @@ pub struct MemoryPool {
     /// Keep track of protection keys handed out to initialized stores; this
     /// allows us to round-robin the assignment of stores to stripes.
     next_available_pkey: AtomicUsize,
+
+    /// Whether memories of stores without a NUMA node are bound to the node
+    /// of the allocating thread, see
+    /// `PoolingAllocationConfig::numa_local_memory`.
+    numa_local_memory: bool,
 }
 
 /// The state of memory for each slot in this pool.
@@ -281,6 +286,7 @@ impl MemoryPool {
                 config.linear_memory_keep_resident,
             )?,
             next_available_pkey: AtomicUsize::new(0),
+            numa_local_memory: config.numa_local_memory,
         };
 
         Ok(pool)
@@ -363,12 +369,15 @@ impl MemoryPool {
 
         let striped_allocation_index = self.stripes[stripe_index]
             .allocator
-            .alloc(memory_index.and_then(|mem_idx| {
-                request
-                    .runtime_info
-                    .unique_id()
-                    .map(|id| MemoryInModule(id, mem_idx))
-            }))
+            .alloc_with_key(
+                memory_index.and_then(|mem_idx| {
+                    request
+                        .runtime_info
+                        .unique_id()
+                        .map(|id| MemoryInModule(id, mem_idx))
+                }),
+                request.store.pooling_affinity(),
+            )
             .map(|slot| StripedAllocationIndex(u32::try_from(slot.index()).unwrap()))
             .ok_or_else(|| {
                 super::PoolConcurrencyLimitError::new(
@@ -400,7 +409,7 @@ impl MemoryPool {
 
         let mut slot = self.take_memory_image_slot(allocation_index)?;
         let image = match memory_index {
-            Some(memory_index) => request.runtime_info.memory_image(memory_index)?,
+            Some(memory_index) => request.memory_image(memory_index)?,
             None => None,
         };
         let initial_size = ty
@@ -422,6 +431,13 @@ impl MemoryPool {
         // else to come in and map something.
         let initial_size = usize::try_from(initial_size).unwrap();
         slot.instantiate(initial_size, image, ty, tunables)?;
+        self.bind_numa_node(
+            request,
+            &mut slot,
+            base.as_mut_ptr(),
+            base_capacity,
+            initial_size,
+        );
 
         let memory = Memory::new_static(
             ty,
@@ -454,6 +470,51 @@ impl MemoryPool {
         }
     }
 
+    /// Binds `slot`, at `base` and of `len` bytes, to the NUMA node that
+    /// memory for `request` should be placed on, or restores the default
+    /// policy if it has none, unless the slot is already bound that way.
+    ///
+    /// This is best-effort, so failures are only logged.
+    fn bind_numa_node(
+        &self,
+        request: &InstanceAllocationRequest<'_, '_>,
+        slot: &mut MemoryImageSlot,
+        base: *mut u8,
+        len: HostAlignedByteCount,
+        initial_size: usize,
+    ) {
+        let node = match request.store.numa_node() {
+            Some(node) => Some(node),
+            None if self.numa_local_memory => crate::runtime::vm::current_numa_node(),
+            None => None,
+        };
+        if slot.numa_node() == Some(node) {
+            return;
+        }
+        // Pages of the slot can only be resident below the memory's initial
+        // size or below what `keep_resident` kept of its previous use, so only
+        // those are migrated, and the rest of the slot only gets the policy.
+        let resident = HostAlignedByteCount::new_rounded_up(initial_size)
+            .unwrap_or(len)
+            .max(self.keep_resident)
+            .min(len);
+        // SAFETY: the slot is owned by this allocation, and the memory policy
+        // doesn't affect its contents.
+        let result = unsafe {
+            let rest = base.add(resident.byte_count());
+            let rest_len = len.saturating_sub(resident).byte_count();
+            crate::runtime::vm::bind_numa_node(base, resident.byte_count(), node, true)
+                .and_then(|()| crate::runtime::vm::bind_numa_node(rest, rest_len, node, false))
+        };
+        match result {
+            Ok(()) => slot.set_numa_node(Some(node)),
+            Err(e) => {
+                slot.set_numa_node(None);
+                log::debug!("failed to set the NUMA node of a linear memory slot: {e}");
+            }
+        }
+    }
+
     /// Deallocate a previously-allocated memory.
     ///
     /// # Safety
@@ -530,6 +591,41 @@ impl MemoryPool {
         }
     }
 
+    /// Releases the pages kept resident in unused slots, least recently used
+    /// first, until at least `target_bytes` have been released. Returns the
+    /// number of bytes released.
+    ///
+    /// Trimmed slots are reset to anonymous memory, so they lose their
+    /// affinity and their memory image, if any.
+    pub fn trim(&self, target_bytes: usize) -> usize {
+        let mut trimmed = 0;
+        for (stripe_index, stripe) in self.stripes.iter().enumerate() {
+            for id in stripe.allocator.trimmable_slots() {
+                if trimmed >= target_bytes {
+                    return trimmed;
+                }
+                let Some(bytes_resident) = stripe.allocator.alloc_warm_and_clear_affinity(id)
+                else {
+                    continue;
+                };
+
+                // As in `purge_module`, if anything fails then the slot is
+                // left in the "unknown" state and is remapped on next use.
+                let index = StripedAllocationIndex(id.0)
+                    .as_unstriped_slot_index(stripe_index, self.stripes.len());
+                if let Ok(mut slot) = self.take_memory_image_slot(index) {
+                    if slot.reset_with_anon_memory().is_ok() {
+                        self.return_memory_image_slot(index, slot);
+                        trimmed += bytes_resident;
+                    }
+                }
+
+                stripe.allocator.free(id, 0);
+            }
+        }
+        trimmed
+    }
+
     fn get_base(&self, allocation_index: MemoryAllocationIndex) -> MmapOffset {
         assert!(allocation_index.index() < self.layout.num_slots);
         let offset = self
@@ -614,6 +710,20 @@ impl MemoryPool {
             .map(|i| i.allocator.unused_bytes_resident())
             .sum()
     }
+
+    pub fn unused_cold_slots(&self) -> u32 {
+        self.stripes
+            .iter()
+            .map(|i| i.allocator.unused_cold_slots())
+            .sum()
+    }
+
+    pub fn affinity_hits_and_misses(&self) -> (u64, u64) {
+        self.stripes
+            .iter()
+            .map(|i| i.allocator.affinity_hits_and_misses())
+            .fold((0, 0), |(h, m), (hi, mi)| (h + hi, m + mi))
+    }
 }
 
 /// The index of a memory allocation within an `InstanceAllocator`.
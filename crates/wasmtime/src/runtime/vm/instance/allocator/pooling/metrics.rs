@@ -109,6 +109,51 @@ impl PoolingAllocatorMetrics {
         self.allocator().stacks.unused_bytes_resident()
     }
 
+    /// Returns the number of slots for linear memories in this allocator
+    /// which have never been used.
+    ///
+    /// Together with [`Self::memories`] and [`Self::unused_warm_memories`]
+    /// this accounts for every slot in the memory pool, so this can be used to
+    /// detect when the pool is close to exhaustion.
+    pub fn unused_cold_memories(&self) -> u32 {
+        self.allocator().memories.unused_cold_slots()
+    }
+
+    /// Returns the number of slots for tables in this allocator which have
+    /// never been used.
+    pub fn unused_cold_tables(&self) -> u32 {
+        self.allocator().tables.unused_cold_slots()
+    }
+
+    /// Returns the number of slots for stacks in this allocator which have
+    /// never been used.
+    #[cfg(feature = "async")]
+    pub fn unused_cold_stacks(&self) -> u32 {
+        self.allocator().stacks.unused_cold_slots()
+    }
+
+    /// Returns the number of regions of memory currently queued to be
+    /// decommitted.
+    ///
+    /// Regions are queued when slots are deallocated and the queue is flushed
+    /// once it reaches the configured
+    /// [`decommit_batch_size`](crate::PoolingAllocationConfig::decommit_batch_size).
+    pub fn decommit_queue_len(&self) -> usize {
+        self.allocator().decommit_queue.lock().unwrap().raw_len()
+    }
+
+    /// Returns the number of linear memory allocations which were able to
+    /// reuse a slot previously used by the same memory of the same module.
+    pub fn memory_affinity_hits(&self) -> u64 {
+        self.allocator().memories.affinity_hits_and_misses().0
+    }
+
+    /// Returns the number of linear memory allocations for which no slot
+    /// previously used by the same memory of the same module was available.
+    pub fn memory_affinity_misses(&self) -> u64 {
+        self.allocator().memories.affinity_hits_and_misses().1
+    }
+
     fn allocator(&self) -> &PoolingInstanceAllocator {
         self.engine
             .allocator()
@@ -184,6 +229,37 @@ mod tests {
         assert_eq!(metrics.tables(), 0);
     }
 
+    #[test]
+    #[cfg_attr(miri, ignore)]
+    fn cold_slots_and_affinity() -> Result<()> {
+        let engine = Engine::new(&Config::new().allocation_strategy(small_pool_config()))?;
+        let metrics = engine.pooling_allocator_metrics().unwrap();
+        let module = Module::new(&engine, "(module (memory 1) (table 1 funcref))")?;
+
+        assert_eq!(metrics.unused_cold_memories(), 10);
+        assert_eq!(metrics.unused_cold_tables(), 10);
+        assert_eq!(metrics.memory_affinity_hits(), 0);
+        assert_eq!(metrics.memory_affinity_misses(), 0);
+
+        let mut store = Store::new(&engine, ());
+        crate::Instance::new(&mut store, &module, &[])?;
+        assert_eq!(metrics.unused_cold_memories(), 9);
+        assert_eq!(metrics.unused_cold_tables(), 9);
+        assert_eq!(metrics.memory_affinity_misses(), 1);
+        drop(store);
+
+        // The second instantiation reuses the slot affine to this module.
+        let mut store = Store::new(&engine, ());
+        crate::Instance::new(&mut store, &module, &[])?;
+        assert_eq!(metrics.unused_cold_memories(), 9);
+        assert_eq!(metrics.memory_affinity_hits(), 1);
+        assert_eq!(metrics.memory_affinity_misses(), 1);
+        drop(store);
+
+        assert_eq!(metrics.decommit_queue_len(), 0);
+        Ok(())
+    }
+
     #[test]
     fn test_non_pooling_allocator() {
         let engine =
@@ -308,6 +384,49 @@ mod tests {
         Ok(())
     }
 
+    #[test]
+    #[cfg_attr(any(miri, not(target_os = "linux")), ignore)]
+    fn trim() -> Result<()> {
+        let mut pool = small_pool_config();
+        pool.linear_memory_keep_resident(65536);
+        pool.table_keep_resident(65536);
+        pool.pagemap_scan(Enabled::No);
+        let mut config = Config::new();
+        config.allocation_strategy(pool);
+        let engine = Engine::new(&config)?;
+
+        let metrics = engine.pooling_allocator_metrics().unwrap();
+        let host_page_size = crate::vm::host_page_size();
+
+        let module = Module::new(&engine, r#"(module (memory 1) (table 1 funcref))"#)?;
+        let stores = (0..4)
+            .map(|_| {
+                let mut store = Store::new(&engine, ());
+                crate::Instance::new(&mut store, &module, &[]).unwrap();
+                store
+            })
+            .collect::<Vec<_>>();
+        drop(stores);
+        assert_eq!(metrics.unused_memory_bytes_resident(), 4 * 65536);
+        assert_eq!(metrics.unused_table_bytes_resident(), 4 * host_page_size);
+
+        // Trimming stops once the target is reached.
+        assert_eq!(engine.trim(1), 65536);
+        assert_eq!(metrics.unused_memory_bytes_resident(), 3 * 65536);
+        assert_eq!(metrics.unused_table_bytes_resident(), 4 * host_page_size);
+
+        assert_eq!(engine.trim(usize::MAX), 3 * 65536 + 4 * host_page_size);
+        assert_eq!(metrics.unused_memory_bytes_resident(), 0);
+        assert_eq!(metrics.unused_table_bytes_resident(), 0);
+        assert_eq!(metrics.unused_warm_memories(), 4);
+        assert_eq!(engine.trim(usize::MAX), 0);
+
+        // Trimmed slots are still usable.
+        let mut store = Store::new(&engine, ());
+        crate::Instance::new(&mut store, &module, &[])?;
+        Ok(())
+    }
+
     #[test]
     #[cfg_attr(miri, ignore)]
     fn gc_heaps() -> Result<()> {
@@ -2,7 +2,7 @@ use super::{
     TableAllocationIndex,
     index_allocator::{SimpleIndexAllocator, SlotId},
 };
-use crate::runtime::vm::sys::vm::{PageMap, commit_pages, reset_with_pagemap};
+use crate::runtime::vm::sys::vm::{PageMap, commit_pages, decommit_pages, reset_with_pagemap};
 use crate::runtime::vm::{
     InstanceAllocationRequest, Mmap, PoolingInstanceAllocatorConfig, SendSyncPtr, Table,
     mmap::AlignedLength,
@@ -248,6 +248,33 @@ impl TablePool {
         }
     }
 
+    /// Releases the pages kept resident in unused slots, least recently used
+    /// first, until at least `target_bytes` have been released. Returns the
+    /// number of bytes released.
+    pub fn trim(&self, target_bytes: usize) -> usize {
+        let mut trimmed = 0;
+        for id in self.index_allocator.trimmable_slots() {
+            if trimmed >= target_bytes {
+                break;
+            }
+            let Some(bytes_resident) = self.index_allocator.alloc_warm_and_clear_affinity(id)
+            else {
+                continue;
+            };
+            let base = self.get(TableAllocationIndex(id.0));
+            // SAFETY: the slot was just allocated, so nothing else is using
+            // its memory, and `get` returns the start of a `table_size` region.
+            // A table's pages are committed again when it's allocated.
+            if unsafe { decommit_pages(base, self.table_size.byte_count()) }.is_ok() {
+                trimmed += bytes_resident;
+                self.index_allocator.free(id, 0);
+            } else {
+                self.index_allocator.free(id, bytes_resident);
+            }
+        }
+        trimmed
+    }
+
     pub fn unused_warm_slots(&self) -> u32 {
         self.index_allocator.unused_warm_slots()
     }
@@ -255,6 +282,10 @@ impl TablePool {
     pub fn unused_bytes_resident(&self) -> usize {
         self.index_allocator.unused_bytes_resident()
     }
+
+    pub fn unused_cold_slots(&self) -> u32 {
+        self.index_allocator.unused_cold_slots()
+    }
 }
 
 #[cfg(test)]
@@ -2,7 +2,7 @@
 
 use super::index_allocator::{SimpleIndexAllocator, SlotId};
 use crate::prelude::*;
-use crate::runtime::vm::sys::vm::commit_pages;
+use crate::runtime::vm::sys::vm::{commit_pages, decommit_pages};
 use crate::runtime::vm::{
     HostAlignedByteCount, Mmap, PoolingInstanceAllocatorConfig, mmap::AlignedLength,
 };
@@ -249,10 +249,49 @@ impl StackPool {
         self.index_allocator.free(SlotId(index), bytes_resident);
     }
 
+    /// Releases the pages kept resident in unused stacks, least recently used
+    /// first, until at least `target_bytes` have been released. Returns the
+    /// number of bytes released.
+    pub fn trim(&self, target_bytes: usize) -> usize {
+        let mut trimmed = 0;
+        for id in self.index_allocator.trimmable_slots() {
+            if trimmed >= target_bytes {
+                break;
+            }
+            let Some(bytes_resident) = self.index_allocator.alloc_warm_and_clear_affinity(id)
+            else {
+                continue;
+            };
+            let size_without_guard = self.stack_size.byte_count() - self.page_size.byte_count();
+            // SAFETY: the slot was just allocated, so nothing else is using
+            // the stack, and its guard page is left alone.
+            let result = unsafe {
+                let bottom_of_stack = self
+                    .mapping
+                    .as_ptr()
+                    .add(self.stack_size.unchecked_mul(id.index()).byte_count())
+                    .add(self.page_size.byte_count())
+                    .cast_mut();
+                decommit_pages(bottom_of_stack, size_without_guard)
+            };
+            if result.is_ok() {
+                trimmed += bytes_resident;
+                self.index_allocator.free(id, 0);
+            } else {
+                self.index_allocator.free(id, bytes_resident);
+            }
+        }
+        trimmed
+    }
+
     pub fn unused_warm_slots(&self) -> u32 {
         self.index_allocator.unused_warm_slots()
     }
 
+    pub fn unused_cold_slots(&self) -> u32 {
+        self.index_allocator.unused_cold_slots()
+    }
+
     pub fn unused_bytes_resident(&self) -> Option<usize> {
         if self.async_stack_zeroing {
             Some(self.index_allocator.unused_bytes_resident())
@@ -56,6 +56,7 @@
 
 #[cfg(feature = "stack-switching")]
 use super::stack_switching::VMContObj;
+use crate::RuntimeEventKind;
 use crate::prelude::*;
 use crate::runtime::store::{Asyncness, InstanceId, StoreInstanceId, StoreOpaque};
 #[cfg(feature = "gc")]
@@ -255,6 +256,7 @@ fn memory_grow(
     let (mut limiter, store) = store.resource_limiter_and_store_opaque();
     let limiter = limiter.as_mut();
     block_on!(store, async |store, _| {
+        let event = store.engine().start_event();
         let instance = store.instance_mut(instance);
         let module = instance.env_module();
         let page_size_log2 = module.memories[module.memory_index(memory_index)].page_size_log2;
@@ -264,6 +266,13 @@ fn memory_grow(
             .await?
             .map(|size_in_bytes| AllocationSize(size_in_bytes >> page_size_log2));
 
+        store
+            .engine()
+            .finish_event(event, |duration| RuntimeEventKind::MemoryGrow {
+                delta,
+                succeeded: result.is_some(),
+                duration,
+            });
         Ok(result)
     })?
 }
@@ -1281,6 +1290,8 @@ fn memory_atomic_wait64(
 // Hook for when an instance runs out of fuel.
 fn out_of_gas(store: &mut dyn VMStore, _instance: InstanceId) -> Result<()> {
     block_on!(store, async |store, _| {
+        #[cfg(feature = "async")]
+        store.tune_fuel_yield_interval();
         if !store.refuel() {
             return Err(Trap::OutOfFuel.into());
         }
@@ -1762,3 +1773,19 @@ fn breakpoint(store: &mut dyn VMStore, _instance: InstanceId) -> Result<()> {
     let _ = store;
     Ok(())
 }
+
+// Records a sampled memory access, see `Config::memory_access_sampling`.
+fn record_memory_access(store: &mut dyn VMStore, instance: InstanceId, memory: u32, addr: u64) {
+    let memory = DefinedMemoryIndex::from_u32(memory);
+    store
+        .instance_mut(instance)
+        .get_defined_memory_mut(memory)
+        .record_access(addr);
+
+    // Schedule the next sample.
+    let interval = store.engine().tunables().memory_access_sample_interval;
+    *store
+        .vm_store_context_mut()
+        .memory_access_countdown
+        .get_mut() = interval as usize;
+}
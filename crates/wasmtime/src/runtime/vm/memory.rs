@@ -77,6 +77,8 @@
 use crate::Engine;
 use crate::prelude::*;
 use crate::runtime::store::StoreResourceLimiter;
+#[cfg(all(unix, feature = "std", not(miri)))]
+use crate::runtime::vm::MemoryImageSource;
 use crate::runtime::vm::vmcontext::VMMemoryDefinition;
 #[cfg(has_virtual_memory)]
 use crate::runtime::vm::{HostAlignedByteCount, MmapOffset};
@@ -104,12 +106,12 @@ use self::static_::StaticMemory;
 #[cfg(feature = "threads")]
 mod shared_memory;
 #[cfg(feature = "threads")]
-pub use shared_memory::SharedMemory;
+pub use shared_memory::{SharedMemory, SharedMemoryHook};
 
 #[cfg(not(feature = "threads"))]
 mod shared_memory_disabled;
 #[cfg(not(feature = "threads"))]
-pub use shared_memory_disabled::SharedMemory;
+pub use shared_memory_disabled::{SharedMemory, SharedMemoryHook};
 
 /// A memory allocator
 pub trait RuntimeMemoryCreator: Send + Sync {
@@ -237,13 +239,20 @@ impl Memory {
         engine: &Engine,
         creator: &dyn RuntimeMemoryCreator,
         memory_image: Option<&Arc<MemoryImage>>,
+        numa_node: Option<u32>,
         limiter: Option<&mut StoreResourceLimiter<'_>>,
     ) -> Result<Self> {
         let (minimum, maximum) = Self::limit_new(ty, limiter).await?;
         let tunables = engine.tunables();
         let allocation = creator.new_memory(ty, tunables, minimum, maximum)?;
 
-        let memory = LocalMemory::new(ty, tunables, allocation, memory_image)?;
+        let mut memory = LocalMemory::new(ty, tunables, allocation, memory_image)?;
+        memory.numa_node = numa_node;
+        memory.advise_huge_pages();
+        memory.bind_numa_node();
+        if memory.memory_populate {
+            memory.populate(0..memory.byte_size());
+        }
         Ok(if ty.shared {
             Memory::Shared(SharedMemory::wrap(engine, ty, memory)?)
         } else {
@@ -273,6 +282,10 @@ impl Memory {
         assert!(memory.memory_image.is_none());
         memory.memory_image = Some(memory_image);
         memory.memory_may_move = false;
+        memory.advise_huge_pages();
+        if memory.memory_populate {
+            memory.populate(0..memory.byte_size());
+        }
 
         Ok(if ty.shared {
             // FIXME(#4244): not supported with the pooling allocator (which
@@ -452,6 +465,116 @@ impl Memory {
         }
     }
 
+    /// Populates the pages backing the byte `range` of this memory, see
+    /// `LocalMemory::populate`.
+    pub fn populate(&self, range: Range<usize>) {
+        match self {
+            Memory::Local(mem) => mem.populate(range),
+            // Shared memories are only ever populated through their
+            // configuration when they're created or grown.
+            Memory::Shared(_) => {}
+        }
+    }
+
+    /// Records a sampled access to byte `addr` of this memory, see
+    /// `LocalMemory::record_access`.
+    pub fn record_access(&mut self, addr: u64) {
+        match self {
+            Memory::Local(mem) => mem.record_access(addr),
+            // Compiled code doesn't sample accesses to shared memories.
+            Memory::Shared(_) => {}
+        }
+    }
+
+    /// Returns the sampled access counts of each page of this memory, see
+    /// `LocalMemory::access_histogram`.
+    pub fn access_histogram(&self) -> Vec<u64> {
+        match self {
+            Memory::Local(mem) => mem.access_histogram(),
+            Memory::Shared(_) => Vec::new(),
+        }
+    }
+
+    /// Returns counters of this memory's growth, see
+    /// `LocalMemory::growth_stats`.
+    pub fn growth_stats(&self) -> crate::MemoryGrowthStats {
+        match self {
+            Memory::Local(mem) => mem.growth_stats,
+            // Shared memories never move, and their growth isn't counted.
+            Memory::Shared(_) => crate::MemoryGrowthStats::default(),
+        }
+    }
+
+    /// Returns the byte ranges of this memory which have been written to, see
+    /// `LocalMemory::dirty_pages`.
+    pub fn dirty_pages(&self) -> Result<Vec<Range<usize>>> {
+        match self {
+            Memory::Local(mem) => mem.dirty_pages(),
+            Memory::Shared(_) => bail!("dirty pages aren't tracked for shared memories"),
+        }
+    }
+
+    /// Restores the written pages of this memory to their original contents,
+    /// see `LocalMemory::reset_dirty_to_image`.
+    pub fn reset_dirty_to_image(&mut self) -> Result<()> {
+        match self {
+            Memory::Local(mem) => mem.reset_dirty_to_image(),
+            Memory::Shared(_) => bail!("shared memories cannot be reset to their image"),
+        }
+    }
+
+    /// Maps `len` bytes of `file` starting at `file_offset` copy-on-write over
+    /// this memory starting at byte `offset`, see `LocalMemory::map_file`.
+    ///
+    /// # Safety
+    ///
+    /// See `LocalMemory::map_file`.
+    #[cfg(all(unix, feature = "std", not(miri)))]
+    pub unsafe fn map_file(
+        &mut self,
+        offset: usize,
+        file: &std::fs::File,
+        file_offset: u64,
+        len: usize,
+    ) -> Result<()> {
+        match self {
+            // SAFETY: the contract is upheld by the caller.
+            Memory::Local(mem) => unsafe { mem.map_file(offset, file, file_offset, len) },
+            Memory::Shared(_) => bail!("files cannot be mapped into shared memories"),
+        }
+    }
+
+    /// Maps `len` bytes of `source` starting at `source_offset` copy-on-write
+    /// over this memory starting at byte `offset`, see
+    /// `LocalMemory::map_source`.
+    ///
+    /// # Safety
+    ///
+    /// See `LocalMemory::map_source`.
+    #[cfg(all(unix, feature = "std", not(miri)))]
+    pub unsafe fn map_source(
+        &mut self,
+        offset: usize,
+        source: &MemoryImageSource,
+        source_offset: u64,
+        len: usize,
+    ) -> Result<()> {
+        match self {
+            // SAFETY: the contract is upheld by the caller.
+            Memory::Local(mem) => unsafe { mem.map_source(offset, source, source_offset, len) },
+            Memory::Shared(_) => bail!("sources cannot be mapped into shared memories"),
+        }
+    }
+
+    /// Zeroes `len` bytes of this memory starting at byte `offset` and
+    /// releases the pages backing them, see `LocalMemory::discard`.
+    pub fn discard(&mut self, offset: usize, len: usize) -> Result<()> {
+        match self {
+            Memory::Local(mem) => mem.discard(offset, len),
+            Memory::Shared(_) => bail!("shared memories cannot be discarded"),
+        }
+    }
+
     /// Implementation of `memory.atomic.notify` for all memories.
     #[cfg(feature = "threads")]
     pub fn atomic_notify(&mut self, addr: u64, count: u32) -> Result<u32, Trap> {
@@ -521,9 +644,34 @@ pub struct LocalMemory {
     memory_guard_size: usize,
     memory_reservation: usize,
 
+    /// Whether newly accessible pages are populated eagerly, see
+    /// `Config::memory_populate`.
+    memory_populate: bool,
+
+    /// Whether this memory asks to be backed by transparent huge pages, see
+    /// `Config::memory_huge_pages`.
+    memory_huge_pages: bool,
+
+    /// The NUMA node that this memory's pages are placed on, if any, see
+    /// `Store::set_numa_node`.
+    numa_node: Option<u32>,
+
+    /// The number of sampled accesses to each page of this memory, see
+    /// `Config::memory_access_sampling`. This only grows as far as the
+    /// highest page that has been sampled.
+    access_histogram: Vec<u64>,
+
+    /// Counters of this memory's growth, see `Memory::growth_stats`.
+    growth_stats: crate::MemoryGrowthStats,
+
     /// An optional CoW mapping that provides the initial content of this
     /// memory.
     memory_image: Option<MemoryImageSlot>,
+
+    /// Whether a file has been mapped into this memory with `map_file` since
+    /// it was created or last moved.
+    #[cfg(all(unix, feature = "std", not(miri)))]
+    mapped_files: bool,
 }
 
 impl LocalMemory {
@@ -570,6 +718,13 @@ impl LocalMemory {
             memory_image,
             memory_guard_size: tunables.memory_guard_size.try_into().unwrap(),
             memory_reservation: tunables.memory_reservation.try_into().unwrap(),
+            memory_populate: tunables.memory_populate,
+            memory_huge_pages: tunables.memory_huge_pages,
+            numa_node: None,
+            access_histogram: Vec::new(),
+            growth_stats: Default::default(),
+            #[cfg(all(unix, feature = "std", not(miri)))]
+            mapped_files: false,
         })
     }
 
@@ -679,6 +834,21 @@ impl LocalMemory {
                 if required_to_not_move_memory {
                     assert_eq!(base_ptr_before, self.alloc.base().as_mut_ptr());
                 }
+                self.growth_stats.grows += 1;
+                if self.alloc.base().as_mut_ptr() != base_ptr_before {
+                    self.growth_stats.moves += 1;
+                    self.growth_stats.bytes_copied += u64::try_from(old_byte_size).unwrap();
+                    self.advise_huge_pages();
+                    self.bind_numa_node();
+                    // Moved memory is copied into fresh anonymous memory.
+                    #[cfg(all(unix, feature = "std", not(miri)))]
+                    {
+                        self.mapped_files = false;
+                    }
+                }
+                if self.memory_populate {
+                    self.populate(old_byte_size..new_byte_size);
+                }
 
                 Ok(Some((old_byte_size, new_byte_size)))
             }
@@ -703,6 +873,130 @@ impl LocalMemory {
         self.alloc.byte_size()
     }
 
+    /// Counts a sampled access to byte `addr` of this memory in the page that
+    /// contains it.
+    ///
+    /// Accesses are sampled before they're bounds checked, so out-of-bounds
+    /// addresses are ignored.
+    pub fn record_access(&mut self, addr: u64) {
+        if addr >= self.byte_size() as u64 {
+            return;
+        }
+        let page = usize::try_from(addr >> self.ty.page_size_log2).unwrap();
+        if page >= self.access_histogram.len() {
+            self.access_histogram.resize(page + 1, 0);
+        }
+        self.access_histogram[page] += 1;
+    }
+
+    /// Returns the number of sampled accesses to each page of this memory,
+    /// indexed by page, covering all of the memory's current pages.
+    pub fn access_histogram(&self) -> Vec<u64> {
+        let pages = self.byte_size() >> self.ty.page_size_log2;
+        let mut histogram = self.access_histogram.clone();
+        histogram.resize(pages, 0);
+        histogram
+    }
+
+    /// Asks the host to fault in the pages backing the byte `range` of this
+    /// memory now, rather than on wasm's first access to each of them.
+    ///
+    /// This is best-effort, so failures are only logged, and only pages which
+    /// lie entirely within `range` are populated.
+    pub fn populate(&self, range: Range<usize>) {
+        assert!(range.start <= range.end && range.end <= self.byte_size());
+        #[cfg(has_virtual_memory)]
+        {
+            let page_size = crate::runtime::vm::host_page_size();
+            let base = self.alloc.base().as_mut_ptr();
+            let start = (base.addr() + range.start).next_multiple_of(page_size) - base.addr();
+            let end = ((base.addr() + range.end) & !(page_size - 1)).saturating_sub(base.addr());
+            if start >= end {
+                return;
+            }
+            // Pages which map a file, such as this memory's image, are only
+            // read-faulted so that they stay shared with the file rather than
+            // each being copied, and the rest are write-faulted.
+            let file = self
+                .memory_image
+                .as_ref()
+                .and_then(|slot| slot.image_range())
+                .unwrap_or(0..0);
+            #[cfg(all(unix, feature = "std", not(miri)))]
+            let file = if self.mapped_files {
+                0..usize::MAX
+            } else {
+                file
+            };
+            let file = file.start.clamp(start, end)..file.end.clamp(start, end);
+            for (range, write) in [
+                (start..file.start, true),
+                (file.clone(), false),
+                (file.end..end, true),
+            ] {
+                if range.is_empty() {
+                    continue;
+                }
+                // SAFETY: the range is within the accessible part of this
+                // memory, and populating pages doesn't change their contents.
+                let result = unsafe {
+                    super::sys::vm::populate_pages(base.add(range.start), range.len(), write)
+                };
+                if let Err(e) = result {
+                    log::debug!("failed to populate linear memory pages: {e}");
+                }
+            }
+        }
+    }
+
+    /// Asks the host to back the whole reservation of this memory with
+    /// transparent huge pages, if configured.
+    ///
+    /// This only applies to mmap-based memories, and is best-effort, so
+    /// failures are only logged.
+    fn advise_huge_pages(&self) {
+        if !self.memory_huge_pages {
+            return;
+        }
+        #[cfg(has_virtual_memory)]
+        if let MemoryBase::Mmap(base) = self.alloc.base() {
+            let page_size = crate::runtime::vm::host_page_size();
+            let len = self.alloc.byte_capacity() & !(page_size - 1);
+            // SAFETY: the whole capacity of this memory is reserved for it,
+            // and advice about huge pages doesn't change its contents.
+            let result = unsafe { super::sys::vm::advise_huge_pages(base.as_mut_ptr(), len) };
+            if let Err(e) = result {
+                log::debug!("failed to request huge pages for linear memory: {e}");
+            }
+        }
+    }
+
+    /// Asks the host to place the pages of the whole reservation of this
+    /// memory on its NUMA node, if it has one.
+    ///
+    /// This only applies to mmap-based memories, and is best-effort, so
+    /// failures are only logged.
+    fn bind_numa_node(&self) {
+        let Some(node) = self.numa_node else {
+            return;
+        };
+        #[cfg(has_virtual_memory)]
+        if let MemoryBase::Mmap(base) = self.alloc.base() {
+            let page_size = crate::runtime::vm::host_page_size();
+            let len = self.alloc.byte_capacity() & !(page_size - 1);
+            // SAFETY: the whole capacity of this memory is reserved for it,
+            // and its memory policy doesn't change its contents. Pages are
+            // migrated since a memory which moved was copied before this.
+            let result =
+                unsafe { super::sys::vm::bind_numa_node(base.as_mut_ptr(), len, Some(node), true) };
+            if let Err(e) = result {
+                log::debug!("failed to bind linear memory to NUMA node {node}: {e}");
+            }
+        }
+        #[cfg(not(has_virtual_memory))]
+        let _ = node;
+    }
+
     pub fn needs_init(&self) -> bool {
         match &self.memory_image {
             Some(image) => !image.has_image(),
@@ -730,6 +1024,199 @@ impl LocalMemory {
     pub fn unwrap_static_image(self) -> MemoryImageSlot {
         self.memory_image.unwrap()
     }
+
+    /// Returns the ranges of bytes of this memory which are on pages that have
+    /// been written to since the memory was created, or since they were last
+    /// restored with `reset_dirty_to_image`.
+    ///
+    /// Ranges are sorted, don't overlap, and are merged when adjacent. This
+    /// requires the `PAGEMAP_SCAN` ioctl, added in Linux 6.7, and memory which
+    /// is backed by an mmap.
+    pub fn dirty_pages(&self) -> Result<Vec<Range<usize>>> {
+        #[cfg(has_virtual_memory)]
+        if let Some(pagemap) = super::sys::vm::PageMap::new() {
+            let MemoryBase::Mmap(base) = self.alloc.base() else {
+                bail!("memory isn't backed by an mmap");
+            };
+            let byte_size = self.byte_size();
+            let len = HostAlignedByteCount::new_rounded_up(byte_size)?;
+            let mut ranges: Vec<Range<usize>> = Vec::new();
+            super::sys::vm::written_regions(&pagemap, base.as_mut_ptr(), len, |region| {
+                let region = region.start..region.end.min(byte_size);
+                match ranges.last_mut() {
+                    Some(prev) if prev.end == region.start => prev.end = region.end,
+                    _ => ranges.push(region),
+                }
+            })?;
+            return Ok(ranges);
+        }
+        bail!("dirty page tracking isn't supported on this platform")
+    }
+
+    /// Restores the pages of this memory which have been written back to the
+    /// contents of its copy-on-write image, or to zeros outside of the image.
+    ///
+    /// Only the pages reported by `dirty_pages` are touched. This requires the
+    /// same support as `dirty_pages`, and additionally that this memory was
+    /// initialized from a copy-on-write image slot.
+    pub fn reset_dirty_to_image(&mut self) -> Result<()> {
+        #[cfg(has_virtual_memory)]
+        if let Some(pagemap) = super::sys::vm::PageMap::new() {
+            let Some(image) = &mut self.memory_image else {
+                bail!("memory has no copy-on-write image to reset to");
+            };
+            return image.reset_dirty_to_image(&pagemap);
+        }
+        // Custom platforms can't track dirty pages, so all of memory is
+        // reset instead, by mapping the image in again.
+        #[cfg(all(has_virtual_memory, not(feature = "std")))]
+        if let Some(image) = &mut self.memory_image {
+            return image.reset_to_image();
+        }
+        bail!("dirty page tracking isn't supported on this platform")
+    }
+
+    /// Maps `len` bytes of `file` starting at `file_offset` copy-on-write over
+    /// this memory starting at byte `offset`, replacing its current contents.
+    ///
+    /// All of `offset`, `file_offset` and `len` must be multiples of the host
+    /// page size, the range must be within the current size of this memory,
+    /// and the file must be at least `file_offset + len` bytes long. Only
+    /// memories which are backed by an mmap support this.
+    ///
+    /// Writes to the mapped range are private to this memory. If this memory
+    /// is later reused by the pooling allocator then its slot is entirely
+    /// erased, rather than reset to its original mapping, so that the file's
+    /// contents never leak into another instance.
+    ///
+    /// # Safety
+    ///
+    /// Nothing may be borrowing the bytes being replaced, and `file` must not
+    /// be truncated while the mapping is in place, since accessing mapped
+    /// pages beyond the end of a file raises `SIGBUS`.
+    #[cfg(all(unix, feature = "std", not(miri)))]
+    pub unsafe fn map_file(
+        &mut self,
+        offset: usize,
+        file: &std::fs::File,
+        file_offset: u64,
+        len: usize,
+    ) -> Result<()> {
+        let len_u64 = u64::try_from(len).unwrap();
+        match file_offset.checked_add(len_u64) {
+            Some(end) if end <= file.metadata()?.len() => {}
+            _ => bail!("range is out of bounds of the file"),
+        }
+        let file = Arc::new(file.try_clone()?);
+        let source = MemoryImageSource::from_file(&file).unwrap();
+        // SAFETY: the contract is upheld by the caller.
+        unsafe { self.map_source(offset, &source, file_offset, len) }
+    }
+
+    /// Maps `len` bytes of `source`, starting at `source_offset`,
+    /// copy-on-write over this memory starting at byte `offset`.
+    ///
+    /// The offsets and length must be multiples of the host page size and the
+    /// range must be within the current size of this memory. The mapping
+    /// keeps its own reference to `source`'s file.
+    ///
+    /// # Safety
+    ///
+    /// Nothing may be borrowing the bytes being replaced, and the range of
+    /// `source` must stay within its file while the mapping is in place.
+    #[cfg(all(unix, feature = "std", not(miri)))]
+    pub unsafe fn map_source(
+        &mut self,
+        offset: usize,
+        source: &MemoryImageSource,
+        source_offset: u64,
+        len: usize,
+    ) -> Result<()> {
+        let base = match self.alloc.base() {
+            MemoryBase::Mmap(base) => base,
+            MemoryBase::Raw(_) => bail!("memory isn't backed by an mmap"),
+        };
+        let (Ok(offset), Ok(len)) = (
+            HostAlignedByteCount::new(offset),
+            HostAlignedByteCount::new(len),
+        ) else {
+            bail!("offset and length must be multiples of the host page size");
+        };
+        if source_offset % u64::try_from(crate::runtime::vm::host_page_size()).unwrap() != 0 {
+            bail!("source offset must be a multiple of the host page size");
+        }
+        match offset.checked_add(len) {
+            Ok(end) if end.byte_count() <= self.alloc.byte_size() => {}
+            _ => bail!("range is out of bounds of the memory"),
+        }
+        if len.is_zero() {
+            return Ok(());
+        }
+
+        if let Some(image) = &mut self.memory_image {
+            image.set_foreign_mappings();
+        }
+        self.mapped_files = true;
+        // SAFETY: the range was checked to be within this memory above, and
+        // the caller guarantees that nothing is using it.
+        unsafe { base.map_image_at(source, source_offset, offset, len) }
+    }
+
+    /// Zeroes the `len` bytes of this memory starting at byte `offset`, which
+    /// must be within its current size, and releases the physical memory
+    /// backing the pages entirely within that range while keeping them
+    /// accessible.
+    ///
+    /// Pages are only released for memories backed by an mmap on Unix, where
+    /// pages of anonymous memory are released with `madvise` and any others,
+    /// such as those mapping a copy-on-write image, are replaced with fresh
+    /// anonymous memory. Elsewhere, and for partial pages at either end of the
+    /// range, the bytes are simply overwritten with zeros.
+    pub fn discard(&mut self, offset: usize, len: usize) -> Result<()> {
+        let end = match offset.checked_add(len) {
+            Some(end) if end <= self.byte_size() => end,
+            _ => bail!("range is out of bounds of the memory"),
+        };
+        let base = self.alloc.base().as_mut_ptr();
+
+        #[cfg(all(unix, feature = "std", not(miri)))]
+        if let MemoryBase::Mmap(_) = self.alloc.base() {
+            let page_size = crate::runtime::vm::host_page_size();
+            let pages_start = HostAlignedByteCount::new_rounded_up(offset)?;
+            let pages_end = HostAlignedByteCount::new(end - end % page_size).unwrap();
+            if let Ok(pages_len) = pages_end.checked_sub(pages_start)
+                && !pages_len.is_zero()
+            {
+                match &mut self.memory_image {
+                    Some(image) => image.discard(pages_start, pages_len)?,
+                    // SAFETY: the pages are within this memory, which is
+                    // exclusively borrowed.
+                    None => unsafe {
+                        super::sys::vm::discard_pages(
+                            base.add(pages_start.byte_count()),
+                            pages_len.byte_count(),
+                            !self.mapped_files,
+                        )?;
+                    },
+                }
+                // SAFETY: the partial pages at either end of the range are
+                // within this memory too.
+                unsafe {
+                    core::ptr::write_bytes(base.add(offset), 0, pages_start.byte_count() - offset);
+                    core::ptr::write_bytes(
+                        base.add(pages_end.byte_count()),
+                        0,
+                        end - pages_end.byte_count(),
+                    );
+                }
+                return Ok(());
+            }
+        }
+
+        // SAFETY: the range was checked to be within this memory above.
+        unsafe { core::ptr::write_bytes(base.add(offset), 0, len) };
+        Ok(())
+    }
 }
 
 /// In the configurations where bounds checks were elided in JIT code (because
@@ -39,6 +39,11 @@ pub struct MmapMemory {
     // specified so that the cost of repeated growth is amortized.
     extra_to_reserve_on_growth: HostAlignedByteCount,
 
+    // Whether to reserve at least as many extra bytes as the new size of
+    // memory whenever it moves, see
+    // `Config::memory_reservation_for_growth_geometric`.
+    geometric_growth: bool,
+
     // Size in bytes of extra guard pages before the start and after the end to
     // optimize loads and stores with constant offsets.
     pre_guard_size: HostAlignedByteCount,
@@ -121,6 +126,7 @@ impl MmapMemory {
             pre_guard_size: pre_guard_bytes,
             offset_guard_size: offset_guard_bytes,
             extra_to_reserve_on_growth,
+            geometric_growth: tunables.memory_reservation_for_growth_geometric,
         })
     }
 
@@ -134,6 +140,27 @@ impl MmapMemory {
         accessible
     }
 
+    /// Get the number of bytes to reserve for growth beyond `new_accessible`
+    /// when this memory moves to grow to it.
+    fn extra_to_reserve_on_move(
+        &self,
+        new_accessible: HostAlignedByteCount,
+    ) -> HostAlignedByteCount {
+        if !self.geometric_growth {
+            return self.extra_to_reserve_on_growth;
+        }
+        // Reserving as much again as the new size means that the capacity at
+        // least doubles on every move, but there's no point in reserving
+        // beyond the maximum size of memory.
+        let mut extra = new_accessible;
+        if let Some(max) = self.maximum {
+            if let Ok(max) = HostAlignedByteCount::new_rounded_up(max) {
+                extra = extra.min(max.saturating_sub(new_accessible));
+            }
+        }
+        extra.max(self.extra_to_reserve_on_growth)
+    }
+
     /// Get the amount to which this memory can grow.
     fn current_capacity(&self) -> HostAlignedByteCount {
         let mmap_len = self.mmap.len_aligned();
@@ -164,7 +191,7 @@ impl RuntimeLinearMemory for MmapMemory {
             let request_bytes = self
                 .pre_guard_size
                 .checked_add(new_accessible)
-                .and_then(|s| s.checked_add(self.extra_to_reserve_on_growth))
+                .and_then(|s| s.checked_add(self.extra_to_reserve_on_move(new_accessible)))
                 .and_then(|s| s.checked_add(self.offset_guard_size))
                 .context("overflow calculating size of memory allocation")?;
 
@@ -2,15 +2,18 @@ use crate::Engine;
 use crate::prelude::*;
 use crate::runtime::vm::memory::{LocalMemory, MmapMemory, validate_atomic_addr};
 use crate::runtime::vm::parking_spot::{ParkingSpot, Waiter};
-use crate::runtime::vm::{self, Memory, VMMemoryDefinition, WaitResult};
+use crate::runtime::vm::{self, Memory, SharedMemoryEvent, VMMemoryDefinition, WaitResult};
 use std::cell::RefCell;
 use std::ops::Range;
 use std::ptr::NonNull;
-use std::sync::atomic::{AtomicU32, AtomicU64, Ordering};
+use std::sync::atomic::{AtomicBool, AtomicU32, AtomicU64, Ordering};
 use std::sync::{Arc, RwLock};
 use std::time::{Duration, Instant};
 use wasmtime_environ::Trap;
 
+/// A callback invoked for each atomic wait and notify on a shared memory.
+pub type SharedMemoryHook = Arc<dyn Fn(SharedMemoryEvent) + Send + Sync>;
+
 /// For shared memory (and only for shared memory), this lock-version restricts
 /// access when growing the memory or checking its size. This is to conform with
 /// the [thread proposal]: "When `IsSharedArrayBuffer(...)` is true, the return
@@ -25,6 +28,10 @@ pub struct SharedMemory(Arc<SharedMemoryInner>);
 struct SharedMemoryInner {
     memory: RwLock<LocalMemory>,
     spot: ParkingSpot,
+    hook: RwLock<Option<SharedMemoryHook>>,
+    /// Whether `hook` is `Some`, so that waits and notifies don't need to
+    /// take its lock when there's no hook, which is the common case.
+    has_hook: AtomicBool,
     ty: wasmtime_environ::Memory,
     def: LongTermVMMemoryDefinition,
 }
@@ -61,6 +68,8 @@ impl SharedMemory {
         Ok(Self(Arc::new(SharedMemoryInner {
             ty: *ty,
             spot: ParkingSpot::default(),
+            hook: RwLock::new(None),
+            has_hook: AtomicBool::new(false),
             def: LongTermVMMemoryDefinition(memory.vmmemory()),
             memory: RwLock::new(memory),
         })))
@@ -121,7 +130,36 @@ impl SharedMemory {
         let ptr = validate_atomic_addr(&self.0.def.0, addr_index, 4, 4)?;
         log::trace!("memory.atomic.notify(addr={addr_index:#x}, count={count})");
         let ptr = unsafe { &*ptr };
-        Ok(self.0.spot.notify(ptr, count))
+        let woken = self.0.spot.notify(ptr, count);
+        self.run_hook(SharedMemoryEvent::Notify {
+            addr: addr_index,
+            count,
+            woken,
+        });
+        Ok(woken)
+    }
+
+    /// Installs, or with `None` removes, the hook invoked for each atomic
+    /// wait and notify on this memory.
+    pub fn set_atomic_hook(&self, hook: Option<SharedMemoryHook>) {
+        let mut slot = self.0.hook.write().unwrap();
+        self.0.has_hook.store(hook.is_some(), Ordering::Relaxed);
+        *slot = hook;
+    }
+
+    #[inline]
+    fn run_hook(&self, event: SharedMemoryEvent) {
+        // A hook installed concurrently with this event may or may not see
+        // it either way, so a relaxed load is enough.
+        if !self.0.has_hook.load(Ordering::Relaxed) {
+            return;
+        }
+        // Clone the hook out of the lock so it may itself notify or replace
+        // the hook without deadlocking.
+        let hook = self.0.hook.read().unwrap().clone();
+        if let Some(hook) = hook {
+            hook(event);
+        }
     }
 
     /// Implementation of `memory.atomic.wait32` for this shared memory.
@@ -141,6 +179,7 @@ impl SharedMemory {
         assert!(std::mem::align_of::<AtomicU32>() <= 4);
         let atomic = unsafe { AtomicU32::from_ptr(addr.cast()) };
         let deadline = timeout.map(|d| Instant::now() + d);
+        self.run_hook(SharedMemoryEvent::Wait { addr: addr_index });
 
         WAITER.with(|waiter| {
             let mut waiter = waiter.borrow_mut();
@@ -165,6 +204,7 @@ impl SharedMemory {
         assert!(std::mem::align_of::<AtomicU64>() <= 8);
         let atomic = unsafe { AtomicU64::from_ptr(addr.cast()) };
         let deadline = timeout.map(|d| Instant::now() + d);
+        self.run_hook(SharedMemoryEvent::Wait { addr: addr_index });
 
         WAITER.with(|waiter| {
             let mut waiter = waiter.borrow_mut();
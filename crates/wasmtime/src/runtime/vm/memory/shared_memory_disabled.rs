@@ -1,12 +1,15 @@
 use crate::Engine;
 use crate::prelude::*;
 use crate::runtime::vm::memory::LocalMemory;
-use crate::runtime::vm::{VMMemoryDefinition, WaitResult};
+use crate::runtime::vm::{SharedMemoryEvent, VMMemoryDefinition, WaitResult};
+use alloc::sync::Arc;
 use core::ops::Range;
 use core::ptr::NonNull;
 use core::time::Duration;
 use wasmtime_environ::Trap;
 
+pub type SharedMemoryHook = Arc<dyn Fn(SharedMemoryEvent) + Send + Sync>;
+
 #[derive(Clone)]
 pub enum SharedMemory {}
 
@@ -35,6 +38,10 @@ impl SharedMemory {
         match *self {}
     }
 
+    pub fn set_atomic_hook(&self, _hook: Option<SharedMemoryHook>) {
+        match *self {}
+    }
+
     pub fn atomic_wait32(
         &self,
         _addr_index: u64,
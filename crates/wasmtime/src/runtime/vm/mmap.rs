@@ -289,6 +289,9 @@ impl<T> Mmap<T> {
 
     /// Makes the specified `range` within this `Mmap` to be read/execute.
     ///
+    /// This clears the instruction cache for `range`, but the pipelines of
+    /// other cores must still be flushed afterwards, see `CodeMemory::publish`.
+    ///
     /// # Unsafety
     ///
     /// This method is unsafe as it's generally not valid to simply make memory
@@ -350,6 +353,33 @@ impl<T> Mmap<T> {
         }
     }
 
+    /// Makes the specified `range` within this `Mmap` read-only, except for
+    /// `text` within it which is made read/execute, with a single batched
+    /// protection change.
+    #[cfg(has_virtual_memory_batch)]
+    pub unsafe fn make_readonly_and_executable(
+        &self,
+        range: Range<usize>,
+        text: Range<usize>,
+        enable_branch_protection: bool,
+    ) -> Result<()> {
+        assert!(range.start <= text.start);
+        assert!(text.start <= text.end);
+        assert!(text.end <= range.end);
+        assert!(range.end <= self.len());
+        let page_size = crate::runtime::vm::host_page_size();
+        assert!(
+            range.start % page_size == 0 && text.start % page_size == 0,
+            "changing of protections isn't page-aligned",
+        );
+
+        unsafe {
+            self.sys
+                .make_readonly_and_executable(range, text, enable_branch_protection)
+                .context("failed to make memory readonly and executable")
+        }
+    }
+
     /// Makes the specified `range` within this `Mmap` to be read-write.
     pub unsafe fn make_readwrite(&self, range: Range<usize>) -> Result<()> {
         assert!(range.start <= self.len());
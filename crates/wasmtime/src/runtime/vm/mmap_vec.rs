@@ -5,6 +5,7 @@ use crate::runtime::vm::{Mmap, mmap::UnalignedLength};
 #[cfg(not(has_virtual_memory))]
 use alloc::alloc::Layout;
 use alloc::sync::Arc;
+use core::any::Any;
 use core::ops::{Deref, Range};
 use core::ptr::NonNull;
 #[cfg(feature = "std")]
@@ -38,7 +39,10 @@ pub enum MmapVec {
         layout: Layout,
     },
     #[doc(hidden)]
-    ExternallyOwned { memory: SendSyncPtr<[u8]> },
+    ExternallyOwned {
+        memory: SendSyncPtr<[u8]>,
+        owner: Option<Box<dyn Any + Send + Sync>>,
+    },
     #[doc(hidden)]
     #[cfg(has_virtual_memory)]
     Mmap {
@@ -74,9 +78,12 @@ impl MmapVec {
         MmapVec::Alloc { base, layout }
     }
 
-    fn new_externally_owned(memory: NonNull<[u8]>) -> MmapVec {
+    fn new_externally_owned(
+        memory: NonNull<[u8]>,
+        owner: Option<Box<dyn Any + Send + Sync>>,
+    ) -> MmapVec {
         let memory = SendSyncPtr::new(memory);
-        MmapVec::ExternallyOwned { memory }
+        MmapVec::ExternallyOwned { memory, owner }
     }
 
     /// Creates a new zero-initialized `MmapVec` with the given `size`
@@ -122,7 +129,21 @@ impl MmapVec {
     /// of the provided memory. As such, outside writes to this memory region
     /// will result in undefined and likely very undesirable behavior.
     pub unsafe fn from_raw(memory: NonNull<[u8]>) -> Result<MmapVec> {
-        Ok(MmapVec::new_externally_owned(memory))
+        Ok(MmapVec::new_externally_owned(memory, None))
+    }
+
+    /// Same as [`Self::from_raw`], except that `owner` is kept alive for as
+    /// long as this `MmapVec` and is dropped once `memory` is no longer in use.
+    ///
+    /// # Safety
+    ///
+    /// Same as [`Self::from_raw`], and `memory` must remain valid until
+    /// `owner` is dropped.
+    pub unsafe fn from_raw_with_owner(
+        memory: NonNull<[u8]>,
+        owner: Box<dyn Any + Send + Sync>,
+    ) -> Result<MmapVec> {
+        Ok(MmapVec::new_externally_owned(memory, Some(owner)))
     }
 
     /// Creates a new `MmapVec` from the contents of an existing
@@ -226,6 +247,26 @@ impl MmapVec {
         unsafe { mmap.make_readonly(range.start..range.end) }
     }
 
+    /// Makes all of this `mmap` read-only, except for the `text` range within
+    /// it which is made read/execute, with a single batched protection
+    /// change.
+    #[cfg(has_virtual_memory_batch)]
+    pub unsafe fn make_readonly_and_executable(
+        &self,
+        text: Range<usize>,
+        enable_branch_protection: bool,
+    ) -> Result<()> {
+        let (mmap, len) = match self {
+            MmapVec::Mmap { mmap, len } => (mmap, *len),
+            MmapVec::ExternallyOwned { .. } => {
+                bail!("Unable to make externally owned memory executable");
+            }
+        };
+        assert!(text.start <= text.end);
+        assert!(text.end <= len);
+        unsafe { mmap.make_readonly_and_executable(0..len, text, enable_branch_protection) }
+    }
+
     /// Makes the specified `range` within this `mmap` to be
     /// read-write (and not executable).
     #[cfg(has_virtual_memory)]
@@ -324,7 +365,7 @@ impl Deref for MmapVec {
             MmapVec::Alloc { base, layout } => unsafe {
                 core::slice::from_raw_parts(base.as_ptr(), layout.size())
             },
-            MmapVec::ExternallyOwned { memory } => unsafe { memory.as_ref() },
+            MmapVec::ExternallyOwned { memory, .. } => unsafe { memory.as_ref() },
             #[cfg(has_virtual_memory)]
             MmapVec::Mmap { mmap, len } => {
                 // SAFETY: all bytes for this mmap, which is owned by
@@ -343,7 +384,8 @@ impl Drop for MmapVec {
                 alloc::alloc::dealloc(base.as_mut(), layout.clone());
             },
             MmapVec::ExternallyOwned { .. } => {
-                // Memory is allocated externally, nothing to do
+                // Memory is allocated externally, nothing to do other than
+                // dropping the `owner`, if any, which happens automatically.
             }
             #[cfg(has_virtual_memory)]
             MmapVec::Mmap { .. } => {
@@ -1,4 +1,6 @@
+use crate::prelude::*;
 use crate::runtime::vm::HostAlignedByteCount;
+use core::ops::Range;
 use core::slice;
 
 #[derive(Debug)]
@@ -11,6 +13,19 @@ impl PageMap {
     }
 }
 
+/// Reports the regions of `ptr` for `len` bytes which have been written to.
+///
+/// A `PageMap` can't be created on this platform so this is unreachable.
+#[allow(dead_code, reason = "not used on linux64")]
+pub fn written_regions(
+    pagemap: &PageMap,
+    _ptr: *mut u8,
+    _len: HostAlignedByteCount,
+    _report: impl FnMut(Range<usize>),
+) -> Result<()> {
+    match *pagemap {}
+}
+
 /// Resets `ptr` for `len` bytes.
 ///
 /// Returns the number of bytse that are still resident after this returns.
@@ -2,7 +2,10 @@
 //! specialized for executing stack switching continuations.
 
 use crate::Result;
+use crate::prelude::*;
+use crate::sync::RwLock;
 use core::ops::Range;
+use core::sync::atomic::{AtomicU64, Ordering};
 
 use crate::runtime::vm::stack_switching::VMHostArray;
 use crate::runtime::vm::{VMContext, VMFuncRef, ValRaw};
@@ -76,6 +79,12 @@ impl VMContinuationStack {
         self.0.range()
     }
 
+    /// Releases the memory of this stack back to the OS, except for its top
+    /// `keep_resident` bytes, leaving it zeroed and ready to be reused.
+    pub fn decommit(&self, keep_resident: usize) -> Result<()> {
+        Ok(self.0.decommit(keep_resident)?)
+    }
+
     /// Returns the instruction pointer stored in the Fiber's ControlContext.
     pub fn control_context_instruction_pointer(&self) -> usize {
         self.0.control_context_instruction_pointer()
@@ -115,3 +124,82 @@ impl VMContinuationStack {
         )
     }
 }
+
+/// Continuation stacks released by stores, kept by an engine to be handed out
+/// again instead of being unmapped. See `Config::continuation_stack_cache_size`.
+#[derive(Default)]
+pub struct VMContinuationStackCache {
+    stacks: RwLock<Vec<VMContinuationStack>>,
+    max: usize,
+    keep_resident: usize,
+    hits: AtomicU64,
+    misses: AtomicU64,
+}
+
+// The cached stacks aren't in use by anything, they're only memory to hand
+// out again.
+unsafe impl Send for VMContinuationStackCache {}
+unsafe impl Sync for VMContinuationStackCache {}
+
+impl VMContinuationStackCache {
+    /// Creates a cache which keeps up to `max` stacks, each with its top
+    /// `keep_resident` bytes left resident.
+    pub fn new(max: usize, keep_resident: usize) -> Self {
+        Self {
+            max,
+            keep_resident,
+            ..Self::default()
+        }
+    }
+
+    /// Returns a cached stack, or a new one of `size` bytes if the cache is
+    /// empty.
+    pub fn allocate(&self, size: usize) -> Result<VMContinuationStack> {
+        if self.max > 0 {
+            if let Some(stack) = self.stacks.write().pop() {
+                self.hits.fetch_add(1, Ordering::Relaxed);
+                return Ok(stack);
+            }
+            self.misses.fetch_add(1, Ordering::Relaxed);
+        }
+        VMContinuationStack::new(size)
+    }
+
+    /// Returns `stack`, which must no longer be in use, to this cache, or
+    /// drops it if the cache is full.
+    pub fn deallocate(&self, stack: VMContinuationStack) {
+        if self.max == 0 || stack.is_unallocated() || stack.is_from_raw_parts() {
+            return;
+        }
+        if self.stacks.read().len() >= self.max || stack.decommit(self.keep_resident).is_err() {
+            return;
+        }
+        let mut stacks = self.stacks.write();
+        if stacks.len() < self.max {
+            stacks.push(stack);
+        }
+    }
+
+    /// Drops cached stacks until at least `target_bytes` have been released,
+    /// returning the number of bytes released.
+    pub fn trim(&self, target_bytes: usize) -> usize {
+        let mut trimmed = 0;
+        while trimmed < target_bytes {
+            let Some(stack) = self.stacks.write().pop() else {
+                break;
+            };
+            trimmed += stack.range().map_or(0, |r| r.len());
+        }
+        trimmed
+    }
+
+    /// Returns the number of cached stacks, and the number of allocations
+    /// which did and didn't reuse one.
+    pub fn stats(&self) -> (usize, u64, u64) {
+        (
+            self.stacks.read().len(),
+            self.hits.load(Ordering::Relaxed),
+            self.misses.load(Ordering::Relaxed),
+        )
+    }
+}
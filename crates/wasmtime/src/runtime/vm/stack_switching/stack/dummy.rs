@@ -43,6 +43,10 @@ impl VMContinuationStack {
         panic!("Stack switching disabled or not implemented on this platform")
     }
 
+    pub fn decommit(&self, _keep_resident: usize) -> Result<()> {
+        panic!("Stack switching disabled or not implemented on this platform")
+    }
+
     pub fn control_context_instruction_pointer(&self) -> usize {
         panic!("Stack switching disabled or not implemented on this platform")
     }
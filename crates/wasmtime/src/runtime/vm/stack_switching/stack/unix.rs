@@ -152,6 +152,22 @@ impl VMContinuationStack {
         Some(self.top)
     }
 
+    pub fn decommit(&self, keep_resident: usize) -> io::Result<()> {
+        if self.allocator != Allocator::Mmap {
+            return Ok(());
+        }
+        // The lowest page is the guard page, which is never committed. The
+        // stack grows down, so the pages which are kept are the ones at the
+        // top that every continuation uses.
+        let page_size = rustix::param::page_size();
+        let usable = self.len - page_size;
+        let keep = keep_resident.next_multiple_of(page_size).min(usable);
+        unsafe {
+            let base = self.top.sub(self.len).add(page_size);
+            crate::runtime::vm::sys::vm::decommit_pages(base, usable - keep)
+        }
+    }
+
     pub fn range(&self) -> Option<Range<usize>> {
         let base = unsafe { self.top.sub(self.len).addr() };
         Some(base..base + self.len)
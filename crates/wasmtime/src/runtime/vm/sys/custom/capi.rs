@@ -46,6 +46,20 @@ pub use WASMTIME_PROT_WRITE as PROT_WRITE;
 pub type wasmtime_trap_handler_t =
     extern "C" fn(ip: usize, fp: usize, has_faulting_addr: bool, faulting_addr: usize);
 
+/// A region of virtual memory and the protections it should have, passed to
+/// `wasmtime_mprotect_batch`.
+#[cfg(has_virtual_memory_batch)]
+#[repr(C)]
+#[expect(non_camel_case_types, reason = "matching C conventions")]
+pub struct wasmtime_memory_region {
+    /// The start of the region, which is page-aligned.
+    pub ptr: *mut u8,
+    /// The size of the region in bytes, which is never zero.
+    pub size: usize,
+    /// The protections for the region, as with `wasmtime_mprotect`.
+    pub prot_flags: u32,
+}
+
 /// Abstract pointer type used in the `wasmtime_memory_image_*` APIs which
 /// is defined by the embedder.
 #[cfg(has_virtual_memory)]
@@ -99,6 +113,18 @@ unsafe extern "C" {
     #[cfg(has_virtual_memory)]
     pub fn wasmtime_mprotect(ptr: *mut u8, size: usize, prot_flags: u32) -> i32;
 
+    /// Configures the protections of each of the `len` regions in `regions`,
+    /// as if with `wasmtime_mprotect` for each of them in order.
+    ///
+    /// This is only required when Wasmtime is built with the
+    /// `custom-virtual-memory-batch` feature, and is used instead of several
+    /// consecutive calls to `wasmtime_mprotect` on platforms where each call
+    /// is expensive. The regions don't overlap.
+    ///
+    /// Returns 0 on success and an error code on failure.
+    #[cfg(has_virtual_memory_batch)]
+    pub fn wasmtime_mprotect_batch(regions: *const wasmtime_memory_region, len: usize) -> i32;
+
     /// Returns the page size, in bytes, of the current system.
     #[cfg(has_virtual_memory)]
     pub fn wasmtime_page_size() -> usize;
@@ -155,7 +181,8 @@ unsafe extern "C" {
     /// pointing back to the memory used by the image originally.
     ///
     /// Note that the memory region will be unmapped with `wasmtime_munmap` in
-    /// the future.
+    /// the future. It may also be remapped with `wasmtime_mmap_remap` and then
+    /// have the image mapped at it again, to reset a memory to its image.
     ///
     /// Aborts the process on failure.
     #[cfg(has_virtual_memory)]
@@ -109,6 +109,42 @@ impl Mmap {
         Ok(())
     }
 
+    /// Makes `range` read-only except for `text` within it, which is made
+    /// read/execute, with a single call to `wasmtime_mprotect_batch`.
+    #[cfg(has_virtual_memory_batch)]
+    pub unsafe fn make_readonly_and_executable(
+        &self,
+        range: Range<usize>,
+        text: Range<usize>,
+        enable_branch_protection: bool,
+    ) -> Result<()> {
+        // not mapped into the C API at this time.
+        let _ = enable_branch_protection;
+
+        let base = self.memory.as_ptr().cast::<u8>();
+        let regions = [
+            (range.start..text.start, capi::PROT_READ),
+            (text.clone(), capi::PROT_READ | capi::PROT_EXEC),
+            (text.end..range.end, capi::PROT_READ),
+        ];
+        let regions = regions
+            .into_iter()
+            .filter(|(range, _)| !range.is_empty())
+            .map(|(range, prot_flags)| capi::wasmtime_memory_region {
+                ptr: base.wrapping_add(range.start),
+                size: range.len(),
+                prot_flags,
+            })
+            .collect::<Vec<_>>();
+        unsafe {
+            cvt(capi::wasmtime_mprotect_batch(
+                regions.as_ptr(),
+                regions.len(),
+            ))?;
+        }
+        Ok(())
+    }
+
     pub unsafe fn make_readwrite(&self, range: Range<usize>) -> Result<()> {
         unsafe {
             let base = self.memory.as_ptr().byte_add(range.start).cast();
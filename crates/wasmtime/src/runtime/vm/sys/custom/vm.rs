@@ -7,7 +7,7 @@ use core::ptr::{self, NonNull};
 #[cfg(feature = "std")]
 use std::{fs::File, sync::Arc};
 
-pub use crate::runtime::vm::pagemap_disabled::{PageMap, reset_with_pagemap};
+pub use crate::runtime::vm::pagemap_disabled::{PageMap, reset_with_pagemap, written_regions};
 
 pub unsafe fn expose_existing_mapping(ptr: *mut u8, len: usize) -> Result<()> {
     unsafe {
@@ -49,6 +49,33 @@ pub unsafe fn decommit_pages(addr: *mut u8, len: usize) -> Result<()> {
     }
 }
 
+pub unsafe fn populate_pages(_addr: *mut u8, _len: usize, _write: bool) -> Result<()> {
+    // There's no way to ask the embedder to do this, so leave pages to be
+    // faulted in on first access.
+    Ok(())
+}
+
+pub fn supports_huge_pages() -> bool {
+    false
+}
+
+pub unsafe fn advise_huge_pages(_addr: *mut u8, _len: usize) -> Result<()> {
+    Ok(())
+}
+
+pub fn current_numa_node() -> Option<u32> {
+    None
+}
+
+pub unsafe fn bind_numa_node(
+    _addr: *mut u8,
+    _len: usize,
+    _node: Option<u32>,
+    _migrate: bool,
+) -> Result<()> {
+    Ok(())
+}
+
 pub fn get_page_size() -> usize {
     unsafe { capi::wasmtime_page_size() }
 }
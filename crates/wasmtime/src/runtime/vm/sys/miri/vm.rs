@@ -3,7 +3,7 @@ use std::fs::File;
 use std::io;
 use std::sync::Arc;
 
-pub use crate::runtime::vm::pagemap_disabled::{PageMap, reset_with_pagemap};
+pub use crate::runtime::vm::pagemap_disabled::{PageMap, reset_with_pagemap, written_regions};
 
 pub unsafe fn expose_existing_mapping(ptr: *mut u8, len: usize) -> io::Result<()> {
     unsafe {
@@ -41,6 +41,31 @@ pub unsafe fn decommit_pages(ptr: *mut u8, len: usize) -> io::Result<()> {
     Ok(())
 }
 
+pub unsafe fn populate_pages(_ptr: *mut u8, _len: usize, _write: bool) -> io::Result<()> {
+    Ok(())
+}
+
+pub fn supports_huge_pages() -> bool {
+    false
+}
+
+pub unsafe fn advise_huge_pages(_ptr: *mut u8, _len: usize) -> io::Result<()> {
+    Ok(())
+}
+
+pub fn current_numa_node() -> Option<u32> {
+    None
+}
+
+pub unsafe fn bind_numa_node(
+    _ptr: *mut u8,
+    _len: usize,
+    _node: Option<u32>,
+    _migrate: bool,
+) -> io::Result<()> {
+    Ok(())
+}
+
 pub fn get_page_size() -> usize {
     4096
 }
@@ -0,0 +1,278 @@
+//! Per-thread CPU counters used to account for the CPU usage of stores, see
+//! `Store::enable_cpu_accounting`.
+//!
+//! CPU time is read with `CLOCK_THREAD_CPUTIME_ID`. On Linux the number of
+//! retired instructions is additionally counted with a `perf_event` counter
+//! per thread, which is opened the first time that the thread runs wasm in a
+//! store with accounting enabled and which can be armed to send the interrupt
+//! signal once a budget of instructions is exhausted.
+
+/// A reading of the current thread's counters.
+#[derive(Copy, Clone, Debug)]
+pub struct CpuSample {
+    /// The number of instructions retired by the thread in user mode, if
+    /// they can be counted.
+    pub instructions: Option<u64>,
+    /// The CPU time consumed by the thread, in nanoseconds.
+    pub cpu_time_ns: u64,
+}
+
+/// Reads the current thread's counters.
+pub fn cpu_sample() -> CpuSample {
+    CpuSample {
+        instructions: instructions::with(|c| c.read()),
+        cpu_time_ns: thread_cpu_time_ns(),
+    }
+}
+
+/// Returns the CPU time consumed by the current thread, in nanoseconds.
+pub fn thread_cpu_time_ns() -> u64 {
+    let mut ts = libc::timespec {
+        tv_sec: 0,
+        tv_nsec: 0,
+    };
+    let rc = unsafe { libc::clock_gettime(libc::CLOCK_THREAD_CPUTIME_ID, &mut ts) };
+    if rc != 0 {
+        return 0;
+    }
+    (ts.tv_sec as u64)
+        .saturating_mul(1_000_000_000)
+        .saturating_add(ts.tv_nsec as u64)
+}
+
+/// Returns whether retired instructions can be counted on the current
+/// thread.
+pub fn can_count_instructions() -> bool {
+    instructions::with(|_| ()).is_some()
+}
+
+/// Arms the current thread's instruction counter to send `signal` to the
+/// thread once `remaining` more instructions have retired, and every
+/// `remaining` instructions after that until it's disarmed.
+///
+/// Returns the counter, to be read with `read_instructions`, and the value
+/// that it will have reached when the budget is exhausted.
+pub fn arm_instruction_budget(remaining: u64, signal: libc::c_int) -> Option<(i32, u64)> {
+    instructions::with(|c| {
+        let start = c.read()?;
+        c.set_period(remaining.max(1), signal)?;
+        Some((c.fd(), start.saturating_add(remaining)))
+    })?
+}
+
+/// Disarms the current thread's instruction counter, see
+/// `arm_instruction_budget`.
+pub fn disarm_instruction_budget() {
+    instructions::with(|c| c.disarm());
+}
+
+/// Reopens the current thread's instruction counter in a forked child
+/// process, where the inherited counter keeps counting the parent's thread.
+pub fn reset_thread_counters() {
+    instructions::reset();
+}
+
+/// Reads the instruction counter `fd` returned by `arm_instruction_budget`.
+///
+/// This is async-signal-safe.
+pub fn read_instructions(fd: i32) -> Option<u64> {
+    let mut value = 0u64;
+    let n = unsafe { libc::read(fd, (&raw mut value).cast(), size_of::<u64>()) };
+    if n == size_of::<u64>() as isize {
+        Some(value)
+    } else {
+        None
+    }
+}
+
+#[cfg(all(
+    target_os = "linux",
+    any(
+        target_arch = "x86_64",
+        target_arch = "aarch64",
+        target_arch = "riscv64",
+        target_arch = "s390x"
+    )
+))]
+mod instructions {
+    use super::read_instructions;
+    use core::cell::{Cell, RefCell};
+
+    /// The prefix of `struct perf_event_attr` up to `PERF_ATTR_SIZE_VER0`,
+    /// which is all that's needed here and which all kernels accept.
+    #[repr(C)]
+    #[derive(Default)]
+    struct PerfEventAttr {
+        type_: u32,
+        size: u32,
+        config: u64,
+        sample_period: u64,
+        sample_type: u64,
+        read_format: u64,
+        flags: u64,
+        wakeup_events: u32,
+        bp_type: u32,
+        config1: u64,
+    }
+
+    const PERF_TYPE_HARDWARE: u32 = 0;
+    const PERF_COUNT_HW_INSTRUCTIONS: u64 = 1;
+    const ATTR_EXCLUDE_KERNEL: u64 = 1 << 5;
+    const ATTR_EXCLUDE_HV: u64 = 1 << 6;
+
+    const PERF_FLAG_FD_CLOEXEC: libc::c_ulong = 1 << 3;
+    const PERF_EVENT_IOC_PERIOD: libc::c_ulong = 0x4008_2404;
+
+    const F_SETSIG: libc::c_int = 10;
+    const F_SETOWN_EX: libc::c_int = 15;
+    const F_OWNER_TID: libc::c_int = 0;
+
+    #[repr(C)]
+    struct FOwnerEx {
+        type_: libc::c_int,
+        pid: libc::pid_t,
+    }
+
+    /// The period of the counter while no budget is armed, large enough that
+    /// it never overflows.
+    const DISARMED_PERIOD: u64 = 1 << 62;
+
+    pub(super) struct Counter {
+        fd: i32,
+        /// The signal configured to be sent on overflow, if any.
+        signal: Cell<Option<libc::c_int>>,
+        armed: Cell<bool>,
+    }
+
+    impl Counter {
+        fn open() -> Option<Counter> {
+            let mut attr = PerfEventAttr::default();
+            attr.type_ = PERF_TYPE_HARDWARE;
+            attr.size = size_of::<PerfEventAttr>() as u32;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            attr.sample_period = DISARMED_PERIOD;
+            attr.flags = ATTR_EXCLUDE_KERNEL | ATTR_EXCLUDE_HV;
+            let fd = unsafe {
+                libc::syscall(
+                    libc::SYS_perf_event_open,
+                    &raw const attr,
+                    0 as libc::pid_t,
+                    -1 as libc::c_int,
+                    -1 as libc::c_int,
+                    PERF_FLAG_FD_CLOEXEC,
+                )
+            };
+            if fd < 0 {
+                return None;
+            }
+            Some(Counter {
+                fd: fd as i32,
+                signal: Cell::new(None),
+                armed: Cell::new(false),
+            })
+        }
+
+        pub(super) fn fd(&self) -> i32 {
+            self.fd
+        }
+
+        pub(super) fn read(&self) -> Option<u64> {
+            read_instructions(self.fd)
+        }
+
+        pub(super) fn set_period(&self, period: u64, signal: libc::c_int) -> Option<()> {
+            if self.signal.get() != Some(signal) {
+                // Deliver overflow notifications as `signal` to this thread
+                // rather than as `SIGIO` to the process.
+                let owner = FOwnerEx {
+                    type_: F_OWNER_TID,
+                    pid: unsafe { libc::syscall(libc::SYS_gettid) as libc::pid_t },
+                };
+                unsafe {
+                    if libc::fcntl(self.fd, F_SETOWN_EX, &raw const owner) != 0
+                        || libc::fcntl(self.fd, F_SETSIG, signal) != 0
+                        || libc::fcntl(self.fd, libc::F_SETFL, libc::O_ASYNC) != 0
+                    {
+                        return None;
+                    }
+                }
+                self.signal.set(Some(signal));
+            }
+            let rc = unsafe { libc::ioctl(self.fd, PERF_EVENT_IOC_PERIOD as _, &raw const period) };
+            if rc != 0 {
+                return None;
+            }
+            self.armed.set(true);
+            Some(())
+        }
+
+        pub(super) fn disarm(&self) {
+            if self.armed.replace(false) {
+                let period = DISARMED_PERIOD;
+                unsafe { libc::ioctl(self.fd, PERF_EVENT_IOC_PERIOD as _, &raw const period) };
+            }
+        }
+    }
+
+    impl Drop for Counter {
+        fn drop(&mut self) {
+            unsafe {
+                libc::close(self.fd);
+            }
+        }
+    }
+
+    std::thread_local! {
+        static COUNTER: RefCell<Option<Counter>> = RefCell::new(Counter::open());
+    }
+
+    /// Runs `f` with the current thread's counter, if one could be opened.
+    pub(super) fn with<R>(f: impl FnOnce(&Counter) -> R) -> Option<R> {
+        COUNTER
+            .try_with(|c| c.borrow().as_ref().map(f))
+            .ok()
+            .flatten()
+    }
+
+    /// Replaces the current thread's counter with a new one.
+    pub(super) fn reset() {
+        let _ = COUNTER.try_with(|c| *c.borrow_mut() = Counter::open());
+    }
+}
+
+#[cfg(not(all(
+    target_os = "linux",
+    any(
+        target_arch = "x86_64",
+        target_arch = "aarch64",
+        target_arch = "riscv64",
+        target_arch = "s390x"
+    )
+)))]
+mod instructions {
+    pub(super) enum Counter {}
+
+    impl Counter {
+        pub(super) fn fd(&self) -> i32 {
+            match *self {}
+        }
+
+        pub(super) fn read(&self) -> Option<u64> {
+            match *self {}
+        }
+
+        pub(super) fn set_period(&self, _period: u64, _signal: libc::c_int) -> Option<()> {
+            match *self {}
+        }
+
+        pub(super) fn disarm(&self) {
+            match *self {}
+        }
+    }
+
+    pub(super) fn with<R>(_f: impl FnOnce(&Counter) -> R) -> Option<R> {
+        None
+    }
+
+    pub(super) fn reset() {}
+}
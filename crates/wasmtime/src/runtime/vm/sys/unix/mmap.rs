@@ -183,10 +183,6 @@ impl Mmap {
             mprotect(base, len, flags)?;
         }
 
-        // Flush any in-flight instructions from the pipeline
-        #[cfg(feature = "std")]
-        wasmtime_jit_icache_coherence::pipeline_flush_mt().context("Failed pipeline flush")?;
-
         Ok(())
     }
 
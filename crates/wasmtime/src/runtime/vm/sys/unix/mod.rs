@@ -13,6 +13,8 @@ pub mod unwind;
 #[cfg(has_virtual_memory)]
 pub mod vm;
 
+#[cfg(has_native_signals)]
+pub mod cpu;
 #[cfg(all(has_native_signals, target_vendor = "apple"))]
 pub mod machports;
 #[cfg(has_native_signals)]
@@ -2,7 +2,6 @@
 //!
 //! For other platforms, a no-op implementation is provided.
 
-#[cfg(feature = "pooling-allocator")]
 use crate::prelude::*;
 
 use self::ioctl::{Categories, PageMapScanBuilder};
@@ -10,6 +9,7 @@ use crate::runtime::vm::{HostAlignedByteCount, host_page_size};
 use rustix::ioctl::ioctl;
 use std::fs::File;
 use std::mem::MaybeUninit;
+use std::ops::Range;
 use std::ptr;
 
 /// A static file-per-process which represents this process's page map file.
@@ -22,7 +22,6 @@ use std::ptr;
 /// Also note that updating this is not done via mutation but rather it's done
 /// with `dup2` to replace the file descriptor that `File` points to in-place.
 /// The local copy of of `File` is then closed in the atfork handler.
-#[cfg(feature = "pooling-allocator")]
 static PROCESS_PAGEMAP: std::sync::LazyLock<Option<File>> = std::sync::LazyLock::new(|| {
     use rustix::fd::AsRawFd;
 
@@ -98,7 +97,6 @@ static PROCESS_PAGEMAP: std::sync::LazyLock<Option<File>> = std::sync::LazyLock:
 pub struct PageMap(&'static File);
 
 impl PageMap {
-    #[cfg(feature = "pooling-allocator")]
     pub fn new() -> Option<PageMap> {
         let file = PROCESS_PAGEMAP.as_ref()?;
 
@@ -119,6 +117,49 @@ impl PageMap {
     }
 }
 
+/// Reports the regions of `ptr` for `len` bytes which have been written to.
+///
+/// This uses the same `PAGEMAP_SCAN` search as `reset_with_pagemap` below,
+/// except that the scan is repeated until it reaches the end of memory so
+/// every dirty page is found. Regions are passed to `report` in ascending
+/// order as ranges of byte offsets from `ptr`, and adjacent regions may be
+/// reported separately.
+pub fn written_regions(
+    pagemap: &PageMap,
+    ptr: *mut u8,
+    len: HostAlignedByteCount,
+    mut report: impl FnMut(Range<usize>),
+) -> Result<()> {
+    const MAX_REGIONS: usize = 32;
+    let mut storage = [MaybeUninit::uninit(); MAX_REGIONS];
+
+    let end = ptr.addr() + len.byte_count();
+    let mut start = ptr.addr();
+    while start < end {
+        let region = ptr::slice_from_raw_parts(ptr.with_addr(start), end - start);
+        let scan_arg = PageMapScanBuilder::new(region)
+            .category_inverted(Categories::PFNZERO | Categories::FILE)
+            .category_mask(
+                Categories::WRITTEN | Categories::PRESENT | Categories::PFNZERO | Categories::FILE,
+            )
+            .return_mask(Categories::empty())
+            .build(&mut storage);
+
+        // SAFETY: see `reset_with_pagemap` below.
+        let result = unsafe { ioctl(&pagemap.0, scan_arg).context("failed pagemap scan")? };
+        for region in result.regions() {
+            let offset = region.start().addr() - ptr.addr();
+            report(offset..offset + region.len());
+        }
+
+        // The scan only stops early when it runs out of space for regions, in
+        // which case it has always reported at least one.
+        debug_assert!(result.walk_end().addr() > start);
+        start = result.walk_end().addr();
+    }
+    Ok(())
+}
+
 /// Resets `ptr` for `len` bytes.
 ///
 /// This function is a dual implementation of this function in the
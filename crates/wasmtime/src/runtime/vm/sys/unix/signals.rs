@@ -17,6 +17,12 @@ static mut PREV_SIGSEGV: libc::sigaction = UNINIT_SIGACTION;
 static mut PREV_SIGBUS: libc::sigaction = UNINIT_SIGACTION;
 static mut PREV_SIGILL: libc::sigaction = UNINIT_SIGACTION;
 static mut PREV_SIGFPE: libc::sigaction = UNINIT_SIGACTION;
+static mut PREV_INTERRUPT: libc::sigaction = UNINIT_SIGACTION;
+
+/// The signal sent to threads executing wasm to interrupt them, see
+/// `Config::signal_interruption`. This is the same signal that Go uses for
+/// preemption, as it's ignored by default and isn't otherwise commonly used.
+pub const INTERRUPT_SIGNAL: libc::c_int = libc::SIGURG;
 
 pub struct TrapHandler;
 
@@ -195,6 +201,98 @@ unsafe extern "C" fn trap_handler(
     unsafe { delegate_signal_to_previous_handler(previous, signum, siginfo, context) }
 }
 
+/// Installs the handler for `INTERRUPT_SIGNAL`, if it isn't already.
+///
+/// Unlike the trap handlers this is installed only once an engine which uses
+/// signal-based interruption is created, and it's never uninstalled.
+pub fn init_interrupts() {
+    static INIT: std::sync::Once = std::sync::Once::new();
+    INIT.call_once(|| {
+        let mut handler: libc::sigaction = unsafe { mem::zeroed() };
+        // SA_RESTART avoids spurious `EINTR`s in host code that the signal
+        // happens to arrive in, and see `TrapHandler::new` for the others.
+        handler.sa_flags = libc::SA_SIGINFO | libc::SA_ONSTACK | libc::SA_RESTART;
+        handler.sa_sigaction = (interrupt_handler as *const ()).addr();
+        unsafe {
+            libc::sigemptyset(&mut handler.sa_mask);
+            if libc::sigaction(INTERRUPT_SIGNAL, &handler, &raw mut PREV_INTERRUPT) != 0 {
+                panic!(
+                    "unable to install signal handler: {}",
+                    io::Error::last_os_error(),
+                );
+            }
+        }
+    });
+}
+
+/// Returns an identifier of the current thread, for `interrupt_thread`.
+pub fn current_thread() -> usize {
+    unsafe { libc::pthread_self() as usize }
+}
+
+/// Sends `INTERRUPT_SIGNAL` to `thread`, as returned by `current_thread`.
+///
+/// # Unsafety
+///
+/// The thread must still be running.
+pub unsafe fn interrupt_thread(thread: usize) {
+    unsafe {
+        libc::pthread_kill(thread as libc::pthread_t, INTERRUPT_SIGNAL);
+    }
+}
+
+unsafe extern "C" fn interrupt_handler(
+    signum: libc::c_int,
+    siginfo: *mut libc::siginfo_t,
+    context: *mut libc::c_void,
+) {
+    let handled = tls::with(|info| {
+        let Some(info) = info else {
+            return false;
+        };
+        // The signal may also have been sent by the store's instruction
+        // counter, see `Store::set_instruction_budget`.
+        if let Some(interrupt) = info.interrupt() {
+            interrupt.check_instruction_budget();
+        }
+        // If the store executing wasm on this thread didn't request an
+        // interrupt then this signal is someone else's. Note that another
+        // store further up the stack may have, in which case its interrupt is
+        // delivered once control returns to it.
+        if !info.interrupt().is_some_and(|i| i.is_requested()) {
+            return false;
+        }
+        // Only interrupt compiled wasm at points where its state is
+        // consistent, otherwise the interrupt is left pending until the next
+        // transition between wasm and the host.
+        let regs = unsafe { get_trap_registers(context, signum) };
+        if let Some(handler) = info.test_if_interrupt(regs) {
+            unsafe {
+                store_handler_in_ucontext(context, &handler);
+            }
+        }
+        true
+    });
+
+    if handled {
+        return;
+    }
+
+    // Unlike with traps, returning without handling this signal is fine, and
+    // is what its default disposition does anyway.
+    unsafe {
+        let previous = *(&raw const PREV_INTERRUPT);
+        if previous.sa_flags & libc::SA_SIGINFO != 0 {
+            mem::transmute::<
+                usize,
+                extern "C" fn(libc::c_int, *mut libc::siginfo_t, *mut libc::c_void),
+            >(previous.sa_sigaction)(signum, siginfo, context)
+        } else if previous.sa_sigaction != libc::SIG_DFL && previous.sa_sigaction != libc::SIG_IGN {
+            mem::transmute::<usize, extern "C" fn(libc::c_int)>(previous.sa_sigaction)(signum)
+        }
+    }
+}
+
 pub unsafe fn delegate_signal_to_previous_handler(
     previous: *const libc::sigaction,
     signum: libc::c_int,
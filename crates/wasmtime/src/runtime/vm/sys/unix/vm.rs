@@ -6,7 +6,7 @@ use std::io;
 #[cfg(feature = "std")]
 use std::sync::Arc;
 
-pub use super::pagemap::{PageMap, reset_with_pagemap};
+pub use super::pagemap::{PageMap, reset_with_pagemap, written_regions};
 
 pub unsafe fn expose_existing_mapping(ptr: *mut u8, len: usize) -> io::Result<()> {
     unsafe {
@@ -44,6 +44,17 @@ pub unsafe fn commit_pages(_addr: *mut u8, _len: usize) -> io::Result<()> {
 
 #[cfg(feature = "pooling-allocator")]
 pub unsafe fn decommit_pages(addr: *mut u8, len: usize) -> io::Result<()> {
+    unsafe { discard_pages(addr, len, true) }
+}
+
+/// Zeroes the pages at `addr` and releases the physical memory backing them,
+/// while leaving them readable and writable.
+///
+/// When `anonymous` is set then on Linux the pages are released with
+/// `madvise`, which only zeroes the pages of private anonymous mappings and
+/// otherwise restores their original mapping, see `decommit_behavior`.
+/// Otherwise a new anonymous mapping replaces them.
+pub unsafe fn discard_pages(addr: *mut u8, len: usize, anonymous: bool) -> io::Result<()> {
     if len == 0 {
         return Ok(());
     }
@@ -55,19 +66,161 @@ pub unsafe fn decommit_pages(addr: *mut u8, len: usize) -> io::Result<()> {
 
                 // On Linux, this is enough to cause the kernel to initialize
                 // the pages to 0 on next access
-                madvise(addr as _, len, Advice::LinuxDontNeed)?;
+                if anonymous {
+                    madvise(addr as _, len, Advice::LinuxDontNeed)?;
+                    return Ok(());
+                }
+            } else {
+                let _ = anonymous;
+            }
+        }
+
+        // By creating a new mapping at the same location, this will
+        // discard the mapping for the pages in the given range.
+        // The new mapping will be to the CoW zero page, so this
+        // effectively zeroes the pages.
+        mmap_anonymous(
+            addr as _,
+            len,
+            ProtFlags::READ | ProtFlags::WRITE,
+            MapFlags::PRIVATE | super::mmap::MMAP_NORESERVE_FLAG | MapFlags::FIXED,
+        )?;
+    }
+
+    Ok(())
+}
+
+pub unsafe fn populate_pages(addr: *mut u8, len: usize, write: bool) -> io::Result<()> {
+    if len == 0 {
+        return Ok(());
+    }
+
+    unsafe {
+        cfg_if::cfg_if! {
+            if #[cfg(target_os = "linux")] {
+                use rustix::mm::{madvise, Advice};
+
+                // Read-faulting private file mappings keeps their pages
+                // shared with the page cache, whereas write-faulting them
+                // copies each page. Anonymous memory, however, must be
+                // write-faulted, since reading it only maps the zero page.
+                //
+                // `MADV_POPULATE_*` were added in Linux 5.14, so fall back
+                // to a hint on older kernels which reject them.
+                let advice = if write {
+                    Advice::LinuxPopulateWrite
+                } else {
+                    Advice::LinuxPopulateRead
+                };
+                match madvise(addr.cast(), len, advice) {
+                    Err(rustix::io::Errno::INVAL) => madvise(addr.cast(), len, Advice::WillNeed)?,
+                    result => result?,
+                }
             } else {
-                // By creating a new mapping at the same location, this will
-                // discard the mapping for the pages in the given range.
-                // The new mapping will be to the CoW zero page, so this
-                // effectively zeroes the pages.
-                mmap_anonymous(
-                    addr as _,
-                    len,
-                    ProtFlags::READ | ProtFlags::WRITE,
-                    MapFlags::PRIVATE | super::mmap::MMAP_NORESERVE_FLAG | MapFlags::FIXED,
-                )?;
+                let _ = write;
+                rustix::mm::madvise(addr.cast(), len, rustix::mm::Advice::WillNeed)?;
+            }
+        }
+    }
+
+    Ok(())
+}
+
+pub fn supports_huge_pages() -> bool {
+    if cfg!(target_os = "linux") {
+        // Transparent huge pages are available unless the kernel wasn't built
+        // with them, in which case this file doesn't exist, or they've been
+        // disabled by selecting `[never]` in it.
+        match std::fs::read_to_string("/sys/kernel/mm/transparent_hugepage/enabled") {
+            Ok(policy) => !policy.contains("[never]"),
+            Err(_) => false,
+        }
+    } else {
+        false
+    }
+}
+
+pub unsafe fn advise_huge_pages(addr: *mut u8, len: usize) -> io::Result<()> {
+    if len == 0 {
+        return Ok(());
+    }
+
+    cfg_if::cfg_if! {
+        if #[cfg(target_os = "linux")] {
+            unsafe {
+                rustix::mm::madvise(addr.cast(), len, rustix::mm::Advice::LinuxHugepage)?;
+            }
+        } else {
+            let _ = addr;
+        }
+    }
+
+    Ok(())
+}
+
+pub fn current_numa_node() -> Option<u32> {
+    cfg_if::cfg_if! {
+        if #[cfg(target_os = "linux")] {
+            let mut cpu = 0u32;
+            let mut node = 0u32;
+            let rc = unsafe {
+                libc::syscall(
+                    libc::SYS_getcpu,
+                    &raw mut cpu,
+                    &raw mut node,
+                    core::ptr::null_mut::<libc::c_void>(),
+                )
+            };
+            if rc == 0 { Some(node) } else { None }
+        } else {
+            None
+        }
+    }
+}
+
+pub unsafe fn bind_numa_node(
+    addr: *mut u8,
+    len: usize,
+    node: Option<u32>,
+    migrate: bool,
+) -> io::Result<()> {
+    if len == 0 {
+        return Ok(());
+    }
+
+    cfg_if::cfg_if! {
+        if #[cfg(target_os = "linux")] {
+            // Constants from `linux/mempolicy.h`, which `libc` doesn't define.
+            const MPOL_DEFAULT: libc::c_long = 0;
+            const MPOL_PREFERRED: libc::c_long = 1;
+            const MPOL_MF_MOVE: libc::c_long = 1 << 1;
+
+            // Large enough for the kernel's maximum of 1024 nodes.
+            const MASK_WORDS: usize = 1024 / libc::c_ulong::BITS as usize;
+            let mut mask: [libc::c_ulong; MASK_WORDS] = [0; MASK_WORDS];
+            let bits = usize::try_from(libc::c_ulong::BITS).unwrap();
+            let (mode, flags) = match node {
+                Some(node) => {
+                    let node = usize::try_from(node).unwrap();
+                    if node >= mask.len() * bits {
+                        return Err(io::Error::from_raw_os_error(libc::EINVAL));
+                    }
+                    mask[node / bits] |= 1 << (node % bits);
+                    let flags = if migrate { MPOL_MF_MOVE } else { 0 };
+                    (MPOL_PREFERRED, flags)
+                }
+                None => (MPOL_DEFAULT, 0),
+            };
+            // Note that the kernel ignores the last bit of `maxnode`.
+            let maxnode = mask.len() * bits + 1;
+            let rc = unsafe {
+                libc::syscall(libc::SYS_mbind, addr, len, mode, mask.as_ptr(), maxnode, flags)
+            };
+            if rc != 0 {
+                return Err(io::Error::last_os_error());
             }
+        } else {
+            let _ = (addr, node, migrate);
         }
     }
 
@@ -230,9 +230,6 @@ impl Mmap {
             }
         }
 
-        // Flush any in-flight instructions from the pipeline
-        #[cfg(feature = "std")]
-        wasmtime_jit_icache_coherence::pipeline_flush_mt().context("Failed pipeline flush")?;
         Ok(())
     }
 
@@ -6,7 +6,7 @@ use std::sync::Arc;
 use windows_sys::Win32::System::Memory::*;
 use windows_sys::Win32::System::SystemInformation::*;
 
-pub use crate::runtime::vm::pagemap_disabled::{PageMap, reset_with_pagemap};
+pub use crate::runtime::vm::pagemap_disabled::{PageMap, reset_with_pagemap, written_regions};
 
 pub unsafe fn expose_existing_mapping(ptr: *mut u8, len: usize) -> io::Result<()> {
     if len == 0 {
@@ -44,6 +44,32 @@ pub unsafe fn decommit_pages(addr: *mut u8, len: usize) -> io::Result<()> {
     unsafe { erase_existing_mapping(addr, len) }
 }
 
+pub unsafe fn populate_pages(_addr: *mut u8, _len: usize, _write: bool) -> io::Result<()> {
+    // Not implemented on Windows, pages are faulted in on first access.
+    Ok(())
+}
+
+pub fn supports_huge_pages() -> bool {
+    false
+}
+
+pub unsafe fn advise_huge_pages(_addr: *mut u8, _len: usize) -> io::Result<()> {
+    Ok(())
+}
+
+pub fn current_numa_node() -> Option<u32> {
+    None
+}
+
+pub unsafe fn bind_numa_node(
+    _addr: *mut u8,
+    _len: usize,
+    _node: Option<u32>,
+    _migrate: bool,
+) -> io::Result<()> {
+    Ok(())
+}
+
 pub fn get_page_size() -> usize {
     unsafe {
         let mut info = MaybeUninit::uninit();
@@ -540,6 +540,9 @@ mod call_thread_state {
         pub(super) unwind: Cell<UnwindState>,
         #[cfg(all(has_native_signals))]
         pub(super) signal_handler: Option<*const SignalHandler>,
+        /// The interrupt state of the store, see `Config::signal_interruption`.
+        #[cfg(all(feature = "std", unix, has_native_signals))]
+        pub(super) interrupt: Option<*const crate::runtime::store::InterruptState>,
         pub(super) capture_backtrace: bool,
         #[cfg(feature = "coredump")]
         pub(super) capture_coredump: bool,
@@ -579,7 +582,9 @@ mod call_thread_state {
                 unwinder: store.unwinder(),
                 #[cfg(all(has_native_signals))]
                 signal_handler: store.signal_handler(),
-                capture_backtrace: store.engine().config().wasm_backtrace,
+                #[cfg(all(feature = "std", unix, has_native_signals))]
+                interrupt: store.interrupt_state().map(|i| &**i as *const _),
+                capture_backtrace: store.wasm_backtrace(),
                 #[cfg(feature = "coredump")]
                 capture_coredump: store.engine().config().coredump_on_trap,
                 vm_store_context: store.vm_store_context_ptr(),
@@ -1051,6 +1056,37 @@ impl CallThreadState {
         TrapTest::Trap(entry_handler)
     }
 
+    /// Returns the interrupt state of the store executing wasm, if it has
+    /// signal-based interruption enabled.
+    #[cfg(all(feature = "std", unix, has_native_signals))]
+    pub(crate) fn interrupt(&self) -> Option<&crate::runtime::store::InterruptState> {
+        // SAFETY: the store outlives its calls into wasm.
+        self.interrupt.map(|i| unsafe { &*i })
+    }
+
+    /// Tests whether the wasm interrupted by a signal at `regs` can trap, and
+    /// if so takes the store's pending interrupt and returns the handler to
+    /// resume at.
+    ///
+    /// This is called from an asynchronous signal handler, so it must not
+    /// block: unlike a trap the signal may have arrived while this thread was
+    /// in host code holding a lock.
+    #[cfg(all(feature = "std", unix, has_native_signals))]
+    pub(crate) fn test_if_interrupt(&self, regs: TrapRegisters) -> Option<Handler> {
+        let (code, text_offset) = crate::runtime::module::try_lookup_code(regs.pc)?;
+
+        // Only interrupt instructions which were compiled from wasm code, and
+        // not the trampolines and prologues around them, during which frames
+        // are only partially set up.
+        wasmtime_environ::lookup_file_pos(code.address_map_data(), text_offset)?.file_offset()?;
+
+        if !self.interrupt()?.take() {
+            return None;
+        }
+        self.set_jit_trap(regs, None, wasmtime_environ::Trap::Interrupt);
+        Some(self.entry_trap_handler())
+    }
+
     pub(crate) fn set_jit_trap(
         &self,
         TrapRegisters { pc, fp, .. }: TrapRegisters,
@@ -1179,6 +1179,13 @@ pub struct VMStoreContext {
     /// `store-data-address` unsafe intrinsic.
     pub store_data: VmPtr<()>,
 
+    /// The number of linear memory accesses remaining until the next one is
+    /// sampled, when `Config::memory_access_sampling` is enabled.
+    ///
+    /// Compiled code decrements this on each access and calls the
+    /// `record_memory_access` libcall once it reaches zero, which resets it.
+    pub memory_access_countdown: UnsafeCell<usize>,
+
     /// The range, in addresses, of the guard page that is currently in use.
     ///
     /// This field is used when signal handlers are run to determine whether a
@@ -1273,6 +1280,7 @@ impl Default for VMStoreContext {
             stack_chain: UnsafeCell::new(VMStackChain::Absent),
             async_guard_range: ptr::null_mut()..ptr::null_mut(),
             store_data: VmPtr::dangling(),
+            memory_access_countdown: UnsafeCell::new(0),
         }
     }
 }
@@ -1339,6 +1347,10 @@ mod test_vmstore_context {
             offset_of!(VMStoreContext, store_data),
             usize::from(offsets.ptr.vmstore_context_store_data())
         );
+        assert_eq!(
+            offset_of!(VMStoreContext, memory_access_countdown),
+            usize::from(offsets.ptr.vmstore_context_memory_access_countdown())
+        );
     }
 }
 
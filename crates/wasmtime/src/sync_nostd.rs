@@ -12,6 +12,11 @@
 //! [`RawRwLock`] which wrap host-provided synchronization primitives that
 //! support true concurrent access with proper blocking behavior.
 //!
+//! With `atomic-sync-primitives` enabled, locks are instead spinlocks built
+//! on atomics. They don't call out to the host at all, which is cheaper for
+//! the short critical sections Wasmtime has, but they busy-wait on contention
+//! rather than blocking.
+//!
 //! See a brief overview of this module in `sync_std.rs` as well.
 
 #![cfg_attr(
@@ -168,6 +173,10 @@ impl<T: Default> Default for RwLock<T> {
     }
 }
 
+/// Without threads to shard readers across, the sharded lock of `sync_std.rs`
+/// is just a plain `RwLock`.
+pub type ShardedRwLock<T> = RwLock<T>;
+
 struct RwLockReadGuard<'a, T> {
     lock: &'a RwLock<T>,
 }
@@ -221,9 +230,9 @@ impl<T> Drop for RwLockWriteGuard<'_, T> {
     }
 }
 
-#[cfg(not(has_custom_sync))]
+#[cfg(not(any(has_custom_sync, has_atomic_sync)))]
 use panic_on_contention as raw;
-#[cfg(not(has_custom_sync))]
+#[cfg(not(any(has_custom_sync, has_atomic_sync)))]
 mod panic_on_contention {
     use core::sync::atomic::{AtomicBool, AtomicU32, Ordering};
 
@@ -311,6 +320,126 @@ mod panic_on_contention {
     }
 }
 
+#[cfg(has_atomic_sync)]
+use spin as raw;
+#[cfg(any(has_atomic_sync, test))]
+mod spin {
+    use core::hint::spin_loop;
+    use core::sync::atomic::{AtomicBool, AtomicU32, Ordering};
+
+    #[derive(Debug)]
+    pub struct Mutex {
+        locked: AtomicBool,
+    }
+
+    impl Mutex {
+        pub const fn new() -> Mutex {
+            Mutex {
+                locked: AtomicBool::new(false),
+            }
+        }
+
+        #[inline]
+        pub fn lock(&self) {
+            while self
+                .locked
+                .compare_exchange_weak(false, true, Ordering::Acquire, Ordering::Relaxed)
+                .is_err()
+            {
+                while self.locked.load(Ordering::Relaxed) {
+                    spin_loop();
+                }
+            }
+        }
+
+        #[inline]
+        pub unsafe fn unlock(&self) {
+            self.locked.store(false, Ordering::Release);
+        }
+    }
+
+    /// Set while a writer holds the lock.
+    const WRITE_LOCKED: u32 = 1 << 31;
+    /// Set while a writer is waiting for the lock, which keeps new readers
+    /// from acquiring it so that writers aren't starved.
+    const WRITER_WAITING: u32 = 1 << 30;
+    /// The remaining bits count the readers holding the lock.
+    const READERS: u32 = WRITER_WAITING - 1;
+
+    #[derive(Debug)]
+    pub struct RwLock {
+        state: AtomicU32,
+    }
+
+    impl RwLock {
+        pub const fn new() -> RwLock {
+            RwLock {
+                state: AtomicU32::new(0),
+            }
+        }
+
+        #[inline]
+        pub fn read(&self) {
+            loop {
+                let state = self.state.load(Ordering::Relaxed);
+                if state & !READERS == 0 {
+                    assert!(state < READERS, "too many readers");
+                    if self
+                        .state
+                        .compare_exchange_weak(
+                            state,
+                            state + 1,
+                            Ordering::Acquire,
+                            Ordering::Relaxed,
+                        )
+                        .is_ok()
+                    {
+                        return;
+                    }
+                }
+                spin_loop();
+            }
+        }
+
+        #[inline]
+        pub unsafe fn read_unlock(&self) {
+            self.state.fetch_sub(1, Ordering::Release);
+        }
+
+        #[inline]
+        pub fn write(&self) {
+            loop {
+                let state = self.state.load(Ordering::Relaxed);
+                if state & !WRITER_WAITING == 0 {
+                    if self
+                        .state
+                        .compare_exchange_weak(
+                            state,
+                            WRITE_LOCKED,
+                            Ordering::Acquire,
+                            Ordering::Relaxed,
+                        )
+                        .is_ok()
+                    {
+                        return;
+                    }
+                } else if state & WRITER_WAITING == 0 {
+                    self.state.fetch_or(WRITER_WAITING, Ordering::Relaxed);
+                }
+                spin_loop();
+            }
+        }
+
+        #[inline]
+        pub unsafe fn write_unlock(&self) {
+            // Leave `WRITER_WAITING` as-is, since other writers may have set
+            // it while this one held the lock.
+            let prev = self.state.fetch_and(!WRITE_LOCKED, Ordering::Release);
+            debug_assert!(prev & WRITE_LOCKED != 0);
+        }
+    }
+}
+
 #[cfg(has_custom_sync)]
 use custom_capi as raw;
 #[cfg(has_custom_sync)]
@@ -445,6 +574,60 @@ mod tests {
         drop((a, b));
     }
 
+    #[test]
+    fn spin_locks_contended() {
+        use std::sync::Arc;
+
+        struct Counter {
+            mutex: spin::Mutex,
+            rwlock: spin::RwLock,
+            value: UnsafeCell<u64>,
+        }
+        unsafe impl Sync for Counter {}
+
+        let counter = Arc::new(Counter {
+            mutex: spin::Mutex::new(),
+            rwlock: spin::RwLock::new(),
+            value: UnsafeCell::new(0),
+        });
+        let threads = (0..4)
+            .map(|i| {
+                let counter = counter.clone();
+                std::thread::spawn(move || {
+                    for _ in 0..1000 {
+                        // Every increment holds the write lock, and half of
+                        // them also hold the mutex while the others take a
+                        // read lock in between.
+                        if i % 2 == 0 {
+                            counter.mutex.lock();
+                            counter.rwlock.write();
+                            unsafe {
+                                *counter.value.get() += 1;
+                                counter.rwlock.write_unlock();
+                                counter.mutex.unlock();
+                            }
+                        } else {
+                            counter.rwlock.read();
+                            unsafe {
+                                let _ = *counter.value.get();
+                                counter.rwlock.read_unlock();
+                            }
+                            counter.rwlock.write();
+                            unsafe {
+                                *counter.value.get() += 1;
+                                counter.rwlock.write_unlock();
+                            }
+                        }
+                    }
+                })
+            })
+            .collect::<Vec<_>>();
+        for thread in threads {
+            thread.join().unwrap();
+        }
+        assert_eq!(unsafe { *counter.value.get() }, 4000);
+    }
+
     #[test]
     #[should_panic(expected = "concurrent write request")]
     fn rwlock_panic_read_then_write() {
@@ -4,6 +4,10 @@
 //! implementation on no_std. The no_std implementations live in
 //! `sync_nostd.rs`.
 
+use crate::prelude::*;
+use core::cell::UnsafeCell;
+use core::fmt;
+use core::sync::atomic::{AtomicUsize, Ordering};
 use once_cell::sync::OnceCell;
 use std::ops::{Deref, DerefMut};
 
@@ -51,8 +55,138 @@ impl<T> RwLock<T> {
         self.0.read().unwrap()
     }
 
+    /// Acquires a read lock if that can be done without blocking, for use in
+    /// contexts such as signal handlers which must not wait on other threads,
+    /// or on the current one.
+    #[inline]
+    pub fn try_read(&self) -> Option<impl Deref<Target = T> + '_> {
+        match self.0.try_read() {
+            Ok(guard) => Some(guard),
+            Err(std::sync::TryLockError::Poisoned(e)) => Some(e.into_inner()),
+            Err(std::sync::TryLockError::WouldBlock) => None,
+        }
+    }
+
     #[inline]
     pub fn write(&self) -> impl DerefMut<Target = T> + '_ {
         self.0.write().unwrap()
     }
 }
+
+/// A reader-writer lock for data which is read far more often than it's
+/// written, and from many threads at once.
+///
+/// The lock is split into one shard per CPU, each on its own cache line.
+/// Readers only lock the shard of their thread, so concurrent readers on
+/// different threads don't contend on the same cache line. Writers lock every
+/// shard, in order, which makes writing correspondingly more expensive.
+pub struct ShardedRwLock<T> {
+    shards: Box<[Shard]>,
+    val: UnsafeCell<T>,
+}
+
+#[repr(align(64))]
+#[derive(Default)]
+struct Shard(std::sync::RwLock<()>);
+
+// SAFETY: `val` is only accessed through the guards below, which provide the
+// same guarantees as `std::sync::RwLock`.
+unsafe impl<T: Send> Send for ShardedRwLock<T> {}
+unsafe impl<T: Send + Sync> Sync for ShardedRwLock<T> {}
+
+impl<T> ShardedRwLock<T> {
+    pub fn new(val: T) -> ShardedRwLock<T> {
+        let shards = std::thread::available_parallelism()
+            .map_or(1, |n| n.get())
+            .next_power_of_two()
+            .min(MAX_SHARDS);
+        ShardedRwLock {
+            shards: (0..shards).map(|_| Shard::default()).collect(),
+            val: UnsafeCell::new(val),
+        }
+    }
+
+    #[inline]
+    pub fn read(&self) -> impl Deref<Target = T> + '_ {
+        let shard = &self.shards[thread_shard() & (self.shards.len() - 1)];
+        ShardedReadGuard {
+            _guard: shard.0.read().unwrap(),
+            val: &self.val,
+        }
+    }
+
+    pub fn write(&self) -> impl DerefMut<Target = T> + '_ {
+        ShardedWriteGuard {
+            _guards: self.shards.iter().map(|s| s.0.write().unwrap()).collect(),
+            val: &self.val,
+        }
+    }
+}
+
+impl<T: Default> Default for ShardedRwLock<T> {
+    fn default() -> ShardedRwLock<T> {
+        ShardedRwLock::new(T::default())
+    }
+}
+
+impl<T: fmt::Debug> fmt::Debug for ShardedRwLock<T> {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("ShardedRwLock")
+            .field("shards", &self.shards.len())
+            .field("val", &*self.read())
+            .finish()
+    }
+}
+
+/// The maximum number of shards of a `ShardedRwLock`, which must be a power
+/// of two.
+const MAX_SHARDS: usize = 64;
+
+/// Returns the index of the current thread's shard, before it's reduced
+/// modulo the number of shards. Threads are assigned indices round-robin as
+/// they first take a lock, so that up to `MAX_SHARDS` threads never share one.
+#[inline]
+fn thread_shard() -> usize {
+    static NEXT: AtomicUsize = AtomicUsize::new(0);
+    std::thread_local! {
+        static SHARD: usize = NEXT.fetch_add(1, Ordering::Relaxed);
+    }
+    SHARD.try_with(|s| *s).unwrap_or(0)
+}
+
+struct ShardedReadGuard<'a, T> {
+    _guard: std::sync::RwLockReadGuard<'a, ()>,
+    val: &'a UnsafeCell<T>,
+}
+
+impl<T> Deref for ShardedReadGuard<'_, T> {
+    type Target = T;
+
+    #[inline]
+    fn deref(&self) -> &T {
+        // SAFETY: We hold a read lock on one shard, and writers hold a write
+        // lock on all of them.
+        unsafe { &*self.val.get() }
+    }
+}
+
+struct ShardedWriteGuard<'a, T> {
+    _guards: Vec<std::sync::RwLockWriteGuard<'a, ()>>,
+    val: &'a UnsafeCell<T>,
+}
+
+impl<T> Deref for ShardedWriteGuard<'_, T> {
+    type Target = T;
+
+    fn deref(&self) -> &T {
+        // SAFETY: We hold the write lock on every shard.
+        unsafe { &*self.val.get() }
+    }
+}
+
+impl<T> DerefMut for ShardedWriteGuard<'_, T> {
+    fn deref_mut(&mut self) -> &mut T {
+        // SAFETY: We hold the write lock on every shard.
+        unsafe { &mut *self.val.get() }
+    }
+}
@@ -3,14 +3,16 @@ use object::write::{Object, SymbolId};
 use std::any::Any;
 use std::mem;
 use std::sync::Mutex;
+use std::time::Instant;
 use wasmparser::FuncValidatorAllocations;
 use wasmtime_cranelift::CompiledFunction;
 #[cfg(feature = "component-model")]
 use wasmtime_environ::component::ComponentTranslation;
 use wasmtime_environ::error::Result;
 use wasmtime_environ::{
-    CompileError, CompiledFunctionBody, DefinedFuncIndex, FuncKey, FunctionBodyData, FunctionLoc,
-    ModuleTranslation, ModuleTypesBuilder, PrimaryMap, StaticModuleIndex, Tunables, VMOffsets,
+    CompileError, CompiledFunctionBody, DefinedFuncIndex, FuncKey, FunctionBodyData,
+    FunctionCompileStats, FunctionLoc, ModuleTranslation, ModuleTypesBuilder, PrimaryMap,
+    StaticModuleIndex, Tunables, VMOffsets,
 };
 use winch_codegen::{BuiltinFunctions, CallingConvention, TargetIsa};
 
@@ -120,6 +122,7 @@ impl wasmtime_environ::Compiler for Compiler {
         symbol: &str,
     ) -> Result<CompiledFunctionBody, CompileError> {
         log::trace!("compiling function: {key:?} = {symbol:?}");
+        let start = Instant::now();
 
         let (module_index, def_func_index) = key.unwrap_defined_wasm_function();
         debug_assert_eq!(module_index, translation.module_index());
@@ -160,10 +163,19 @@ impl wasmtime_environ::Compiler for Compiler {
             self.emit_unwind_info(&mut func)?;
         }
 
+        // Winch compiles in a single pass without an IR, so only the overall
+        // time and the resulting code size are reported.
+        let stats = FunctionCompileStats {
+            total_time: start.elapsed(),
+            code_size: func.buffer.data().len(),
+            ..Default::default()
+        };
+
         Ok(CompiledFunctionBody {
             code: box_dyn_any_compiled_function(func),
             // TODO: Winch doesn't support GC objects and stack maps and all that yet.
             needs_gc_heap: false,
+            stats,
         })
     }
 
@@ -40,8 +40,11 @@ impl Wizer {
         if !self.func_renames.is_empty() {
             bail!("components do not support renaming functions");
         }
+        if self.get_incremental() {
+            bail!("components do not support incremental snapshots");
+        }
 
-        let snapshot = snapshot::snapshot(&cx, instance).await;
+        let snapshot = snapshot::snapshot(&cx, instance, self.get_page_aligned_data()).await;
         let rewritten_wasm = self.rewrite_component(&mut cx, &snapshot);
         self.debug_assert_valid_wasm(&rewritten_wasm);
 
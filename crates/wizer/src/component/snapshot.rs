@@ -20,6 +20,7 @@ pub struct ComponentSnapshot {
 pub async fn snapshot(
     component: &ComponentContext<'_>,
     ctx: &mut impl ComponentInstanceState,
+    page_aligned_data: bool,
 ) -> ComponentSnapshot {
     let mut modules = Vec::new();
 
@@ -39,6 +40,8 @@ pub async fn snapshot(
                 module_index,
                 component,
             },
+            page_aligned_data,
+            None,
         )
         .await;
         modules.push((module_index, snapshot));
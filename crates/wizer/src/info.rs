@@ -1,5 +1,8 @@
+use crate::snapshot::DataSegment;
 use std::convert::TryFrom;
 use std::ops::Range;
+use wasm_encoder::SectionId;
+use wasmtime::{Result, bail};
 
 /// Info that we keep track of on a per module-within-a-module-linking-bundle
 /// basis.
@@ -207,6 +210,48 @@ impl<'a> ModuleContext<'a> {
         &self.exports
     }
 
+    /// Get this module's active data segments, which must all have constant
+    /// offsets, in the order that they're applied during instantiation.
+    ///
+    /// This is the memory image that incremental snapshots are diffed
+    /// against.
+    pub(crate) fn active_data_segments(&self) -> Result<Vec<DataSegment>> {
+        let mut segments = Vec::new();
+        let sections = self
+            .raw_sections
+            .iter()
+            .filter(|s| s.id == u8::from(SectionId::Data));
+        for section in sections {
+            let reader = wasmparser::BinaryReader::new(section.data, 0);
+            for data in wasmparser::DataSectionReader::new(reader)? {
+                let data = data?;
+                let wasmparser::DataKind::Active {
+                    memory_index,
+                    offset_expr,
+                } = data.kind
+                else {
+                    continue;
+                };
+                let mut ops = offset_expr.get_operators_reader();
+                let offset = match ops.read()? {
+                    wasmparser::Operator::I32Const { value } => u64::from(value.cast_unsigned()),
+                    wasmparser::Operator::I64Const { value } => value.cast_unsigned(),
+                    _ => bail!("incremental snapshots require constant data segment offsets"),
+                };
+                if !matches!(ops.read()?, wasmparser::Operator::End) {
+                    bail!("incremental snapshots require constant data segment offsets");
+                }
+                segments.push(DataSegment {
+                    memory_index,
+                    data: data.data.to_vec(),
+                    offset,
+                    is64: self.memories[usize::try_from(memory_index).unwrap()].memory64,
+                });
+            }
+        }
+        Ok(segments)
+    }
+
     pub(crate) fn has_wasi_initialize(&self) -> bool {
         self.exports.iter().any(|e| e.name == "_initialize")
     }
@@ -29,6 +29,8 @@ use std::collections::{HashMap, HashSet};
 pub use wasmparser::ValType;
 
 const DEFAULT_KEEP_INIT_FUNC: bool = false;
+const DEFAULT_PAGE_ALIGNED_DATA: bool = false;
+const DEFAULT_INCREMENTAL: bool = false;
 
 /// Wizer: the WebAssembly pre-initializer!
 ///
@@ -98,6 +100,41 @@ pub struct Wizer {
         arg(long, require_equals = true, value_name = "true|false")
     )]
     keep_init_func: Option<Option<bool>>,
+
+    /// Should the data segments of the snapshot be made of whole 64 KiB
+    /// chunks of memory?
+    ///
+    /// With this enabled, data segments cover every 64 KiB-aligned chunk of
+    /// memory with any non-zero bytes, merged when adjacent, and chunks which
+    /// are all zeros are left out. This can make the output larger, but lets
+    /// runtimes map memory directly from the module when instantiating it,
+    /// for example Wasmtime's `memory_init_cow`, rather than copying many
+    /// small segments into place.
+    ///
+    /// This is `false` by default.
+    #[cfg_attr(
+        feature = "clap",
+        arg(long, require_equals = true, value_name = "true|false")
+    )]
+    page_aligned_data: Option<Option<bool>>,
+
+    /// Should the snapshot keep the input's data segments as they are, and
+    /// only add data segments for memory which the initialization function
+    /// changed?
+    ///
+    /// This is intended for re-initializing a module which Wizer has already
+    /// pre-initialized, for example with `--init-func` naming a function
+    /// which applies further configuration, so that the work done by the
+    /// previous snapshot isn't re-serialized and the output only grows by
+    /// what changed. All of the input's active data segments must have
+    /// constant offsets.
+    ///
+    /// This is `false` by default.
+    #[cfg_attr(
+        feature = "clap",
+        arg(long, require_equals = true, value_name = "true|false")
+    )]
+    incremental: Option<Option<bool>>,
 }
 
 #[cfg(feature = "clap")]
@@ -151,6 +188,8 @@ impl Wizer {
             init_func: "wizer-initialize".to_string(),
             func_renames: vec![],
             keep_init_func: None,
+            page_aligned_data: None,
+            incremental: None,
         }
     }
 
@@ -184,6 +223,24 @@ impl Wizer {
         self
     }
 
+    /// Should the data segments of the snapshot be made of whole 64 KiB
+    /// chunks of memory, so that runtimes can map them directly?
+    ///
+    /// This is `false` by default.
+    pub fn page_aligned_data(&mut self, page_aligned: bool) -> &mut Self {
+        self.page_aligned_data = Some(Some(page_aligned));
+        self
+    }
+
+    /// Should the snapshot keep the input's data segments, and only add
+    /// segments for memory which changed during initialization?
+    ///
+    /// This is `false` by default.
+    pub fn incremental(&mut self, incremental: bool) -> &mut Self {
+        self.incremental = Some(Some(incremental));
+        self
+    }
+
     /// First half of [`Self::run`] which instruments the provided `wasm` and
     /// produces a new wasm module which should be run by a runtime.
     ///
@@ -234,7 +291,18 @@ impl Wizer {
         // Parse rename spec.
         let renames = FuncRenames::parse(&self.func_renames)?;
 
-        let snapshot = snapshot::snapshot(&cx, instance).await;
+        let previous = if self.get_incremental() {
+            Some(cx.active_data_segments()?)
+        } else {
+            None
+        };
+        let snapshot = snapshot::snapshot(
+            &cx,
+            instance,
+            self.get_page_aligned_data(),
+            previous.as_deref(),
+        )
+        .await;
         let rewritten_wasm = self.rewrite(&mut cx, &snapshot, &renames);
 
         self.debug_assert_valid_wasm(&rewritten_wasm);
@@ -369,6 +437,20 @@ impl Wizer {
             None => DEFAULT_KEEP_INIT_FUNC,
         }
     }
+
+    fn get_page_aligned_data(&self) -> bool {
+        match self.page_aligned_data {
+            Some(page_aligned) => page_aligned.unwrap_or(true),
+            None => DEFAULT_PAGE_ALIGNED_DATA,
+        }
+    }
+
+    fn get_incremental(&self) -> bool {
+        match self.incremental {
+            Some(incremental) => incremental.unwrap_or(true),
+            None => DEFAULT_INCREMENTAL,
+        }
+    }
 }
 
 /// Abstract ability to load state from a WebAssembly instance after it's been
@@ -22,7 +22,8 @@ pub struct Snapshot {
     /// A new minimum size for each memory (in units of pages).
     pub memory_mins: Vec<u64>,
 
-    /// Segments of non-zero memory.
+    /// Segments of non-zero memory, or with an incremental snapshot the
+    /// previous segments followed by segments of memory which changed.
     pub data_segments: Vec<DataSegment>,
 }
 
@@ -55,13 +56,23 @@ pub struct DataSegment {
 
 /// Snapshot the given instance's globals, memories, and instances from the Wasm
 /// defaults.
+///
+/// If `previous` is given then memories are snapshotted incrementally: the
+/// `previous` data segments are kept as they are, and only the regions of
+/// memory which differ from the image they initialize are added after them.
 //
 // TODO: when we support reference types, we will have to snapshot tables.
-pub async fn snapshot(module: &ModuleContext<'_>, ctx: &mut impl InstanceState) -> Snapshot {
+pub async fn snapshot(
+    module: &ModuleContext<'_>,
+    ctx: &mut impl InstanceState,
+    page_aligned_data: bool,
+    previous: Option<&[DataSegment]>,
+) -> Snapshot {
     log::debug!("Snapshotting the initialized state");
 
     let globals = snapshot_globals(module, ctx).await;
-    let (memory_mins, data_segments) = snapshot_memories(module, ctx).await;
+    let (memory_mins, data_segments) =
+        snapshot_memories(module, ctx, page_aligned_data, previous).await;
 
     Snapshot {
         globals,
@@ -115,15 +126,33 @@ impl DataSegmentRange {
     }
 }
 
+/// The alignment of data segments with `Wizer::page_aligned_data`, which is
+/// the largest host page size that runtimes are likely to map memory with.
+const PAGE_ALIGNED_DATA_ALIGN: usize = 1 << 16;
+
+/// Build the contents of the memory `memory_index`, which is `len` bytes
+/// long, as initialized by the data segments `segments`.
+fn memory_image(memory_index: u32, len: usize, segments: &[DataSegment]) -> Vec<u8> {
+    let mut image = vec![0; len];
+    for segment in segments.iter().filter(|s| s.memory_index == memory_index) {
+        let offset = usize::try_from(segment.offset).unwrap();
+        image[offset..][..segment.data.len()].copy_from_slice(&segment.data);
+    }
+    image
+}
+
 /// Find the initialized minimum page size of each memory, as well as all
-/// regions of non-zero memory.
+/// regions of non-zero memory, or of memory which differs from the `previous`
+/// data segments.
 async fn snapshot_memories(
     module: &ModuleContext<'_>,
     instance: &mut impl InstanceState,
+    page_aligned_data: bool,
+    previous: Option<&[DataSegment]>,
 ) -> (Vec<u64>, Vec<DataSegment>) {
     log::debug!("Snapshotting memories");
 
-    // Find and record non-zero regions of memory (in parallel).
+    // Find and record changed regions of memory (in parallel).
     let mut memory_mins = vec![];
     let mut data_segments = vec![];
     let iter = module
@@ -138,25 +167,47 @@ async fn snapshot_memories(
 
                 let memory_data = &memory[..];
 
+                // A byte has changed if it's non-zero, or for incremental
+                // snapshots if it differs from the previous image.
+                let previous_image =
+                    previous.map(|segments| memory_image(memory_index, memory.len(), segments));
+                let changed = |i: usize| match &previous_image {
+                    Some(image) => memory_data[i] != image[i],
+                    None => memory_data[i] != 0,
+                };
+
+                // With page-aligned data, consider each aligned chunk of
+                // memory in parallel, and create a data segment covering all
+                // of each chunk with any changed bytes. Adjacent chunks are
+                // merged into one segment below.
+                if page_aligned_data {
+                    let align = PAGE_ALIGNED_DATA_ALIGN;
+                    let num_chunks = memory.len().div_ceil(align);
+                    data_segments.par_extend((0..num_chunks).into_par_iter().filter_map(|i| {
+                        let range = i * align..((i + 1) * align).min(memory.len());
+                        range.clone().any(|j| changed(j)).then(|| DataSegmentRange {
+                            memory_index,
+                            range,
+                        })
+                    }));
+                    return;
+                }
+
                 // Consider each Wasm page in parallel. Create data segments for each
-                // region of non-zero memory.
+                // region of changed memory.
                 data_segments.par_extend((0..num_wasm_pages).into_par_iter().flat_map(|i| {
                     let page_end = (i + 1) * page_size;
                     let mut start = i * page_size;
                     let mut segments = vec![];
                     while start < page_end {
-                        let nonzero = match memory_data[start..page_end]
-                            .iter()
-                            .position(|byte| *byte != 0)
-                        {
+                        let first_changed = match (start..page_end).position(|j| changed(j)) {
                             None => break,
                             Some(i) => i,
                         };
-                        start += nonzero;
-                        let end = memory_data[start..page_end]
-                            .iter()
-                            .position(|byte| *byte == 0)
-                            .map_or(page_end, |zero| start + zero);
+                        start += first_changed;
+                        let end = (start..page_end)
+                            .position(|j| !changed(j))
+                            .map_or(page_end, |unchanged| start + unchanged);
                         segments.push(DataSegmentRange {
                             memory_index,
                             range: start..end,
@@ -169,8 +220,11 @@ async fn snapshot_memories(
             .await;
     }
 
+    // Incremental snapshots keep all of the previous segments, and the
+    // segments for changed memory are applied after them.
+    let previous = previous.unwrap_or(&[]);
     if data_segments.is_empty() {
-        return (memory_mins, Vec::new());
+        return (memory_mins, previous.to_vec());
     }
 
     // Sort data segments to enforce determinism in the face of the
@@ -209,7 +263,8 @@ async fn snapshot_memories(
         a.merge(b);
     }
 
-    remove_excess_segments(&mut merged_data_segments);
+    let max_data_segments = MAX_DATA_SEGMENTS.saturating_sub(previous.len()).max(1);
+    remove_excess_segments(&mut merged_data_segments, max_data_segments);
 
     // With the final set of data segments now extract the actual data of each
     // memory, copying it into a `DataSegment`, to return the final list of
@@ -219,7 +274,8 @@ async fn snapshot_memories(
     // `merged_data_segments` list is traversed to extract a `DataSegment` for
     // each range that `merged_data_segments` indicates. This relies on
     // `merged_data_segments` being a sorted list by `memory_index` at least.
-    let mut final_data_segments = Vec::with_capacity(merged_data_segments.len());
+    let mut final_data_segments = Vec::with_capacity(previous.len() + merged_data_segments.len());
+    final_data_segments.extend_from_slice(previous);
     let mut merged = merged_data_segments.iter().peekable();
     let iter = module
         .defined_memories()
@@ -245,14 +301,18 @@ async fn snapshot_memories(
 
 /// Engines apply a limit on how many segments a module may contain, and Wizer
 /// can run afoul of it. When that happens, we need to merge data segments
-/// together until our number of data segments fits within the limit.
-fn remove_excess_segments(merged_data_segments: &mut Vec<DataSegmentRange>) {
-    if merged_data_segments.len() < MAX_DATA_SEGMENTS {
+/// together until our number of data segments fits within the limit, which is
+/// `max_data_segments`.
+fn remove_excess_segments(
+    merged_data_segments: &mut Vec<DataSegmentRange>,
+    max_data_segments: usize,
+) {
+    if merged_data_segments.len() < max_data_segments {
         return;
     }
 
     // We need to remove `excess` number of data segments.
-    let excess = merged_data_segments.len() - MAX_DATA_SEGMENTS;
+    let excess = merged_data_segments.len() - max_data_segments;
 
     #[derive(Clone, Copy, PartialEq, Eq)]
     struct GapIndex {
@@ -1,8 +1,15 @@
+#[cfg(not(feature = "rayon"))]
+use crate::rayoff::IntoParallelIterator;
 use crate::{InstanceState, SnapshotVal, Wizer};
+#[cfg(feature = "rayon")]
+use rayon::iter::{IntoParallelIterator, ParallelIterator};
+use std::pin::pin;
+use std::sync::Arc;
+use std::task::{Context as TaskContext, Poll, Wake};
 use wasmparser::ValType;
 use wasmtime::error::Context;
 
-use wasmtime::{Extern, Instance, Module, Result, Store, Val};
+use wasmtime::{Engine, Extern, Instance, Module, Result, Store, Val};
 
 impl Wizer {
     /// Initialize the given Wasm, snapshot it, and return the serialized
@@ -26,6 +33,34 @@ impl Wizer {
             .await
     }
 
+    /// Initializes and snapshots each of the `wasms` modules, returning the
+    /// result for each of them in the same order.
+    ///
+    /// All modules are compiled with the shared `engine`, and with the `rayon`
+    /// feature they're processed in parallel across threads. Enabling the
+    /// engine's compilation cache, with
+    /// [`Config::cache`](wasmtime::Config::cache), additionally lets inputs
+    /// which haven't changed skip compilation on later runs.
+    ///
+    /// Each module is processed as with [`Wizer::run`], in a new store created
+    /// by `new_store` and instantiated by `instantiate`. Note that this blocks
+    /// the calling thread until all modules are done.
+    pub fn run_batch<T: Send>(
+        &self,
+        engine: &Engine,
+        wasms: &[&[u8]],
+        new_store: impl Fn(&Engine) -> Result<Store<T>> + Sync,
+        instantiate: impl AsyncFn(&mut Store<T>, &Module) -> Result<Instance> + Sync,
+    ) -> Vec<Result<Vec<u8>>> {
+        (0..wasms.len())
+            .into_par_iter()
+            .map(|i| {
+                let mut store = new_store(engine)?;
+                block_on(self.run(&mut store, wasms[i], &instantiate))
+            })
+            .collect()
+    }
+
     /// Check that the module exports an initialization function, and that the
     /// function has the correct type.
     fn validate_init_func(&self, module: &wasmtime::Module) -> wasmtime::Result<()> {
@@ -86,6 +121,28 @@ impl Wizer {
     }
 }
 
+/// Runs `future` to completion on the current thread, parking the thread
+/// while it's pending.
+fn block_on<F: Future>(future: F) -> F::Output {
+    struct ThreadWaker(std::thread::Thread);
+
+    impl Wake for ThreadWaker {
+        fn wake(self: Arc<Self>) {
+            self.0.unpark();
+        }
+    }
+
+    let waker = Arc::new(ThreadWaker(std::thread::current())).into();
+    let mut cx = TaskContext::from_waker(&waker);
+    let mut future = pin!(future);
+    loop {
+        match future.as_mut().poll(&mut cx) {
+            Poll::Ready(ret) => return ret,
+            Poll::Pending => std::thread::park(),
+        }
+    }
+}
+
 /// Impementation of [`InstanceState`] backed by Wasmtime.
 pub struct WasmtimeWizer<'a, T: 'static> {
     /// The Wasmtime-based store that owns the `instance` field.
@@ -1018,3 +1018,146 @@ async fn memory64() -> Result<()> {
     let wizer = get_wizer();
     wizen_and_run_wasm(&[], 10, &wasm, wizer).await
 }
+
+#[test]
+fn run_batch() -> Result<()> {
+    let _ = env_logger::try_init();
+    let wasms = (0..8)
+        .map(|i| {
+            wat_to_wasm(&format!(
+                r#"
+(module
+  (global $g (mut i32) i32.const 0)
+  (func (export "wizer-initialize")
+    i32.const {i}
+    global.set $g)
+  (func (export "run") (result i32)
+    global.get $g))
+                "#
+            ))
+        })
+        .collect::<Result<Vec<_>, _>>()?;
+    let mut wasms = wasms.iter().map(|w| &w[..]).collect::<Vec<_>>();
+    let invalid = wat_to_wasm("(module)")?;
+    wasms.push(&invalid);
+
+    let engine = Engine::default();
+    let results = get_wizer().run_batch(
+        &engine,
+        &wasms,
+        |engine| Ok(Store::new(engine, ())),
+        async |store, module| Instance::new_async(store, module, &[]).await,
+    );
+    assert_eq!(results.len(), wasms.len());
+    let (last, results) = results.split_last().unwrap();
+    assert!(last.is_err());
+
+    for (i, wasm) in results.iter().enumerate() {
+        let module = Module::new(&engine, wasm.as_ref().unwrap())?;
+        let mut store = Store::new(&engine, ());
+        let instance = Instance::new(&mut store, &module, &[])?;
+        let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+        assert_eq!(run.call(&mut store, ())?, i32::try_from(i)?);
+    }
+    Ok(())
+}
+
+#[tokio::test]
+async fn page_aligned_data() -> Result<()> {
+    let wat = r#"
+(module
+  (memory 3)
+  (func (export "wizer-initialize")
+    i32.const 10
+    i32.const 1
+    i32.store8
+    i32.const 12
+    i32.const 2
+    i32.store8
+    i32.const 0x20005
+    i32.const 3
+    i32.store8)
+  (func (export "run") (result i32)
+    (i32.add
+      (i32.add (i32.load8_u (i32.const 10)) (i32.load8_u (i32.const 12)))
+      (i32.load8_u (i32.const 0x20005)))))
+    "#;
+    let wasm = wat_to_wasm(wat)?;
+    let mut wizer = get_wizer();
+    wizer.page_aligned_data(true);
+    wizen_and_run_wasm(&[], 6, &wasm, wizer.clone()).await?;
+
+    let snapshot = wizer.run(&mut store()?, &wasm, instantiate).await?;
+    let mut segments = Vec::new();
+    for payload in wasmparser::Parser::new(0).parse_all(&snapshot) {
+        if let wasmparser::Payload::DataSection(reader) = payload? {
+            for data in reader {
+                let data = data?;
+                let wasmparser::DataKind::Active { offset_expr, .. } = data.kind else {
+                    panic!("expected an active data segment");
+                };
+                let mut ops = offset_expr.get_operators_reader();
+                let wasmparser::Operator::I32Const { value } = ops.read()? else {
+                    panic!("expected a constant offset");
+                };
+                segments.push((value, data.data.len()));
+            }
+        }
+    }
+    assert_eq!(segments, [(0, 0x10000), (0x20000, 0x10000)]);
+    Ok(())
+}
+
+#[tokio::test]
+async fn incremental() -> Result<()> {
+    let wat = r#"
+(module
+  (memory 1)
+  (data (i32.const 0) "\01")
+  (func (export "wizer-initialize")
+    i32.const 100
+    i32.const 2
+    i32.store8)
+  (func (export "reinit")
+    i32.const 200
+    i32.const 4
+    i32.store8)
+  (func (export "run") (result i32)
+    (i32.add
+      (i32.add (i32.load8_u (i32.const 0)) (i32.load8_u (i32.const 100)))
+      (i32.load8_u (i32.const 200)))))
+    "#;
+    let wasm = wat_to_wasm(wat)?;
+    let wasm = get_wizer().run(&mut store()?, &wasm, instantiate).await?;
+
+    let mut wizer = get_wizer();
+    wizer.init_func("reinit").incremental(true);
+    wizen_and_run_wasm(&[], 7, &wasm, wizer.clone()).await?;
+
+    // The previous snapshot's segments are kept as they are, followed by a
+    // segment for just the byte which `reinit` changed.
+    let active_segments = |wasm: &[u8]| -> Result<Vec<(i32, Vec<u8>)>> {
+        let mut segments = Vec::new();
+        for payload in wasmparser::Parser::new(0).parse_all(wasm) {
+            if let wasmparser::Payload::DataSection(reader) = payload? {
+                for data in reader {
+                    let data = data?;
+                    let wasmparser::DataKind::Active { offset_expr, .. } = data.kind else {
+                        continue;
+                    };
+                    let mut ops = offset_expr.get_operators_reader();
+                    let wasmparser::Operator::I32Const { value } = ops.read()? else {
+                        panic!("expected a constant offset");
+                    };
+                    segments.push((value, data.data.to_vec()));
+                }
+            }
+        }
+        Ok(segments)
+    };
+    let mut expected = active_segments(&wasm)?;
+    let snapshot = wizer.run(&mut store()?, &wasm, instantiate).await?;
+    expected.push((200, vec![4]));
+    assert_eq!(active_segments(&snapshot)?, expected);
+    Ok(())
+}
@@ -0,0 +1,209 @@
+/*
+An HTTP server embedding Wasmtime through its C++ API, which handles each
+request by instantiating a component in a new `Store` and calling its `handle`
+export. This is the C++ equivalent of `wasmtime serve`, used by
+`benches/cpp-embedding-rps.sh` to measure the overhead of the C and C++ APIs.
+
+You can build the example using CMake:
+
+cargo build -p example-http-rps-wasm --target wasm32-wasip2
+mkdir build && (cd build && cmake .. && \
+  cmake --build . --target wasmtime-http-rps-cpp)
+
+And then serve requests on port 8080 with:
+
+build/wasmtime-http-rps-cpp 8080
+
+Without a port the server answers a few requests of its own and then exits.
+*/
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <netinet/in.h>
+#include <optional>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+#include <wasmtime.hh>
+#include <wasmtime/component.hh>
+
+using namespace wasmtime;
+
+static std::vector<uint8_t> read_binary_file(const char *path) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    throw std::runtime_error(std::string("failed to open wasm file: ") + path);
+  }
+  std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+  return data;
+}
+
+struct Server {
+  Engine engine;
+  std::optional<component::InstancePre> pre;
+  std::optional<WasiConfigTemplate> wasi;
+
+  // Handles one request in a new store, as `wasmtime serve` does, returning
+  // the response body.
+  Result<std::string> handle(const std::string &method,
+                             const std::string &path) {
+    Store store(engine);
+    auto set_wasi = store.context().set_wasi(wasi->config());
+    if (!set_wasi) {
+      return set_wasi.err();
+    }
+    auto instance = pre->instantiate(store);
+    if (!instance) {
+      return instance.err();
+    }
+    auto index = instance.ok_ref().get_export_index(store, nullptr, "handle");
+    if (!index) {
+      return Error("the component doesn't export `handle`");
+    }
+    auto func = instance.ok_ref().get_func(store, *index);
+    auto handle = func->typed<std::tuple<std::string, std::string>,
+                              std::string>(store);
+    if (!handle) {
+      return handle.err();
+    }
+    return handle.ok_ref().call(store, {method, path});
+  }
+
+  // Serves the requests of one connection until it's closed.
+  void serve(int conn) {
+    std::string buf;
+    char chunk[4096];
+    while (true) {
+      size_t end;
+      while ((end = buf.find("\r\n\r\n")) == std::string::npos) {
+        ssize_t n = read(conn, chunk, sizeof(chunk));
+        if (n <= 0) {
+          close(conn);
+          return;
+        }
+        buf.append(chunk, n);
+      }
+      // Requests with bodies aren't supported, the request line is all
+      // that's read.
+      std::string head = buf.substr(0, end);
+      buf.erase(0, end + 4);
+      size_t method_end = head.find(' ');
+      size_t path_end = head.find(' ', method_end + 1);
+      std::string method = head.substr(0, method_end);
+      std::string path =
+          head.substr(method_end + 1, path_end - method_end - 1);
+
+      std::string status = "200 OK";
+      auto body = handle(method, path);
+      std::string text;
+      if (body) {
+        text = body.ok();
+      } else {
+        status = "500 Internal Server Error";
+        text = body.err().message() + "\n";
+      }
+      std::string response = "HTTP/1.1 " + status +
+                             "\r\ncontent-type: text/plain"
+                             "\r\ncontent-length: " +
+                             std::to_string(text.size()) + "\r\n\r\n" + text;
+      if (write(conn, response.data(), response.size()) < 0) {
+        close(conn);
+        return;
+      }
+    }
+  }
+
+  // Accepts connections on `listener` forever, serving each on its own
+  // thread.
+  void run(int listener) {
+    while (true) {
+      int conn = accept(listener, nullptr, nullptr);
+      if (conn < 0) {
+        continue;
+      }
+      std::thread([this, conn] { serve(conn); }).detach();
+    }
+  }
+};
+
+static int listen_on(uint16_t port) {
+  int listener = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1;
+  setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  if (bind(listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+      listen(listener, SOMAXCONN) < 0) {
+    throw std::runtime_error("failed to listen on port " +
+                             std::to_string(port));
+  }
+  return listener;
+}
+
+// Sends a few requests over one connection to the server listening on
+// `listener` and checks their responses.
+static void self_test(int listener) {
+  sockaddr_in addr;
+  socklen_t len = sizeof(addr);
+  getsockname(listener, reinterpret_cast<sockaddr *>(&addr), &len);
+  int conn = socket(AF_INET, SOCK_STREAM, 0);
+  if (connect(conn, reinterpret_cast<sockaddr *>(&addr), len) < 0) {
+    throw std::runtime_error("failed to connect to the server");
+  }
+  std::string request = "GET / HTTP/1.1\r\nhost: localhost\r\n\r\n";
+  std::string expected = "Hello, wasi:http/proxy world!\n";
+  for (int i = 0; i < 3; i++) {
+    if (write(conn, request.data(), request.size()) < 0) {
+      throw std::runtime_error("failed to send a request");
+    }
+    std::string response;
+    char chunk[4096];
+    while (response.find(expected) == std::string::npos) {
+      ssize_t n = read(conn, chunk, sizeof(chunk));
+      if (n <= 0) {
+        throw std::runtime_error("unexpected response: " + response);
+      }
+      response.append(chunk, n);
+    }
+    std::cout << response.substr(0, response.find("\r\n")) << "\n";
+  }
+  close(conn);
+}
+
+int main(int argc, char **argv) {
+  const char *path =
+      argc > 2 ? argv[2] : "target/wasm32-wasip2/debug/http_rps.wasm";
+
+  Server server;
+  auto bytes = read_binary_file(path);
+  Span<uint8_t> wasm(bytes.data(), bytes.size());
+  auto handler = component::Component::compile(server.engine, wasm).unwrap();
+  component::Linker linker(server.engine);
+  linker.add_wasip2().unwrap();
+  server.pre = linker.instantiate_pre(handler).unwrap();
+  server.wasi = WasiConfigTemplate(WasiConfig());
+
+  if (argc > 1) {
+    int listener = listen_on(static_cast<uint16_t>(std::stoi(argv[1])));
+    std::cout << "Serving HTTP on http://127.0.0.1:" << argv[1] << "/\n";
+    server.run(listener);
+  }
+
+  // Serve the connection of `self_test` on this thread until it's closed.
+  int listener = listen_on(0);
+  std::thread client(self_test, listener);
+  int conn = accept(listener, nullptr, nullptr);
+  server.serve(conn);
+  client.join();
+  close(listener);
+  return 0;
+}
@@ -0,0 +1,17 @@
+// The handler of the C++ embedding HTTP server in `../main.cc`, which responds
+// with the same body as https://github.com/sunfishcode/hello-wasi-http, the
+// component used to benchmark `wasmtime serve`.
+wit_bindgen::generate!({
+    path: "..",
+    world: "handler",
+});
+
+struct Handler;
+
+export!(Handler);
+
+impl Guest for Handler {
+    fn handle(_method: String, _path: String) -> String {
+        "Hello, wasi:http/proxy world!\n".to_string()
+    }
+}
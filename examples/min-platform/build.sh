@@ -26,6 +26,12 @@ if [ "$WASMTIME_SIGNALS_BASED_TRAPS" = "1" ]; then
   features="$features,custom"
 fi
 
+if [ "$WASMTIME_VIRTUAL_MEMORY_BATCH" = "1" ]; then
+  cflags="$cflags -DWASMTIME_VIRTUAL_MEMORY -DWASMTIME_NATIVE_SIGNALS"
+  cflags="$cflags -DWASMTIME_VIRTUAL_MEMORY_BATCH"
+  features="$features,custom-batch"
+fi
+
 if [ "$WASMTIME_CUSTOM_SYNC" = "1" ]; then
   cflags="$cflags -DWASMTIME_CUSTOM_SYNC"
   features="$features,custom-sync-primitives"
@@ -52,6 +52,19 @@ int wasmtime_mprotect(uint8_t *ptr, uintptr_t size, uint32_t prot_flags) {
   return 0;
 }
 
+#ifdef WASMTIME_VIRTUAL_MEMORY_BATCH
+int wasmtime_mprotect_batch(const struct wasmtime_memory_region *regions,
+                            uintptr_t len) {
+  for (uintptr_t i = 0; i < len; i++) {
+    int rc = wasmtime_mprotect(regions[i].ptr, regions[i].size,
+                               regions[i].prot_flags);
+    if (rc != 0)
+      return rc;
+  }
+  return 0;
+}
+#endif
+
 uintptr_t wasmtime_page_size(void) { return sysconf(_SC_PAGESIZE); }
 
 #endif // WASMTIME_VIRTUAL_MEMORY
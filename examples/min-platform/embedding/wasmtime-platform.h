@@ -16,6 +16,8 @@
 //
 // * `WASMTIME_SIGNALS_BASED_TRAPS` - corresponds to `signals-based-traps`
 // * `WASMTIME_CUSTOM_SYNC` - corresponds to `custom-sync-primitives`
+// * `WASMTIME_VIRTUAL_MEMORY_BATCH` - corresponds to
+//   `custom-virtual-memory-batch`
 //
 // Some more information about this header can additionally be found at
 // <https://docs.wasmtime.dev/stability-platform-support.html>.
@@ -60,6 +62,27 @@
 typedef struct wasmtime_memory_image wasmtime_memory_image;
 #endif
 
+#if defined(WASMTIME_VIRTUAL_MEMORY_BATCH)
+/**
+ * A region of virtual memory and the protections it should have, passed to
+ * `wasmtime_mprotect_batch`.
+ */
+typedef struct wasmtime_memory_region {
+  /**
+   * The start of the region, which is page-aligned.
+   */
+  uint8_t *ptr;
+  /**
+   * The size of the region in bytes, which is never zero.
+   */
+  uintptr_t size;
+  /**
+   * The protections for the region, as with `wasmtime_mprotect`.
+   */
+  uint32_t prot_flags;
+} wasmtime_memory_region;
+#endif
+
 #if defined(WASMTIME_NATIVE_SIGNALS)
 /**
  * Handler function for traps in Wasmtime passed to `wasmtime_init_traps`.
@@ -155,6 +178,21 @@ extern int32_t wasmtime_munmap(uint8_t *ptr, uintptr_t size);
 extern int32_t wasmtime_mprotect(uint8_t *ptr, uintptr_t size, uint32_t prot_flags);
 #endif
 
+#if defined(WASMTIME_VIRTUAL_MEMORY_BATCH)
+/**
+ * Configures the protections of each of the `len` regions in `regions`,
+ * as if with `wasmtime_mprotect` for each of them in order.
+ *
+ * This is only required when Wasmtime is built with the
+ * `custom-virtual-memory-batch` feature, and is used instead of several
+ * consecutive calls to `wasmtime_mprotect` on platforms where each call
+ * is expensive. The regions don't overlap.
+ *
+ * Returns 0 on success and an error code on failure.
+ */
+extern int32_t wasmtime_mprotect_batch(const struct wasmtime_memory_region *regions, uintptr_t len);
+#endif
+
 #if defined(WASMTIME_VIRTUAL_MEMORY)
 /**
  * Returns the page size, in bytes, of the current system.
@@ -220,7 +258,8 @@ extern int32_t wasmtime_memory_image_new(const uint8_t *ptr,
  * pointing back to the memory used by the image originally.
  *
  * Note that the memory region will be unmapped with `wasmtime_munmap` in
- * the future.
+ * the future. It may also be remapped with `wasmtime_mmap_remap` and then
+ * have the image mapped at it again, to reset a memory to its image.
  *
  * Aborts the process on failure.
  */
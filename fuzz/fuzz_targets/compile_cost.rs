@@ -0,0 +1,32 @@
+//! Generate a Wasm module and check that compiling and instantiating it takes
+//! time and memory in proportion to its size.
+
+#![no_main]
+
+use libfuzzer_sys::arbitrary::{Result, Unstructured};
+use wasmtime_fuzzing::generators::Config;
+use wasmtime_fuzzing::oracles::blowup::{PeakAllocator, check_compile_and_instantiate_cost};
+use wasmtime_fuzzing::single_module_fuzzer::KnownValid;
+
+#[global_allocator]
+static ALLOCATOR: PeakAllocator = PeakAllocator::new();
+
+wasmtime_fuzzing::single_module_fuzzer!(execute gen_module);
+
+fn execute(
+    module: &[u8],
+    known_valid: KnownValid,
+    config: Config,
+    _: &mut Unstructured<'_>,
+) -> Result<()> {
+    check_compile_and_instantiate_cost(module, known_valid, &config, &ALLOCATOR);
+    Ok(())
+}
+
+fn gen_module(config: &mut Config, u: &mut Unstructured<'_>) -> Result<(Vec<u8>, KnownValid)> {
+    // Start functions would run arbitrary code during instantiation, which
+    // isn't what's measured here.
+    config.module_config.config.allow_start_export = false;
+    let module = config.generate(u, None)?;
+    Ok((module.to_bytes(), KnownValid::Yes))
+}
@@ -0,0 +1,94 @@
+//! Benchmarks of the interpreter's dispatch loop, comparing a loop whose body
+//! is a pair of instructions with the same loop using the macro-instruction
+//! which fuses them.
+
+use criterion::*;
+use pulley_interpreter::interp::{DoneReason, RegType, Val, Vm, XRegVal};
+use pulley_interpreter::*;
+use std::ptr::NonNull;
+
+criterion_main!(benches);
+criterion_group!(benches, bench_shladd);
+
+const ITERATIONS: u32 = 10_000;
+
+/// Encodes a function which sums `x0 << 2` while counting `x0` down to zero,
+/// with `body` computing `x1 += x0 << 2`.
+fn counted_loop(body: &[Op]) -> Vec<u8> {
+    let mut loop_body = Vec::new();
+    for op in body {
+        op.encode(&mut loop_body);
+    }
+    Op::from(Xsub32U8 {
+        dst: XReg::x0,
+        src1: XReg::x0,
+        src2: 1,
+    })
+    .encode(&mut loop_body);
+
+    let mut code = Vec::new();
+    Op::from(Xconst32 {
+        dst: XReg::x1,
+        imm: 0,
+    })
+    .encode(&mut code);
+    Op::from(Xconst32 {
+        dst: XReg::x2,
+        imm: 0,
+    })
+    .encode(&mut code);
+    code.extend_from_slice(&loop_body);
+    let offset = -i32::try_from(loop_body.len()).unwrap();
+    Op::from(BrIfXneq32 {
+        a: XReg::x0,
+        b: XReg::x2,
+        offset: offset.into(),
+    })
+    .encode(&mut code);
+    Op::from(Xmov {
+        dst: XReg::x0,
+        src: XReg::x1,
+    })
+    .encode(&mut code);
+    Op::from(Ret {}).encode(&mut code);
+    code
+}
+
+fn run(vm: &mut Vm, code: &[u8]) -> u32 {
+    let args = [Val::XReg(XRegVal::new_u32(ITERATIONS))];
+    match unsafe { vm.call(NonNull::from(code).cast(), &args, [RegType::XReg]) } {
+        DoneReason::ReturnToHost(mut rets) => match rets.next() {
+            Some(Val::XReg(x)) => x.get_u32(),
+            _ => unreachable!(),
+        },
+        _ => unreachable!(),
+    }
+}
+
+fn bench_shladd(c: &mut Criterion) {
+    let shift = U6::new(2).unwrap();
+    let unfused = counted_loop(&[
+        Op::from(Xshl32U6 {
+            operands: BinaryOperands::new(XReg::x3, XReg::x0, shift),
+        }),
+        Op::from(Xadd32 {
+            operands: BinaryOperands::new(XReg::x1, XReg::x1, XReg::x3),
+        }),
+    ]);
+    let fused = counted_loop(&[Op::from(Xshladd32 {
+        dst: XReg::x1,
+        src1: XReg::x1,
+        src2: XReg::x0,
+        shift,
+    })]);
+
+    let mut vm = Vm::new();
+    let expected = run(&mut vm, &unfused);
+    assert_eq!(run(&mut vm, &fused), expected);
+
+    let mut group = c.benchmark_group("dispatch-shladd");
+    group.throughput(Throughput::Elements(ITERATIONS.into()));
+    group.bench_function("unfused", |b| b.iter(|| run(&mut vm, &unfused)));
+    group.bench_function("fused", |b| b.iter(|| run(&mut vm, &fused)));
+    group.finish();
+}
@@ -417,6 +417,15 @@ impl Decode for ExtendedOpcode {
     }
 }
 
+impl Decode for U6 {
+    fn decode<T>(bytecode: &mut T) -> Result<Self, T::Error>
+    where
+        T: BytecodeStream,
+    {
+        u8::decode(bytecode).map(|byte| U6::new(byte & 0x3f).unwrap())
+    }
+}
+
 impl<D: Reg, S1: Reg, S2: Reg> Decode for BinaryOperands<D, S1, S2> {
     fn decode<T>(bytecode: &mut T) -> Result<Self, T::Error>
     where
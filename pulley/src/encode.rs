@@ -169,6 +169,17 @@ impl Encode for PcRelOffset {
     }
 }
 
+impl Encode for U6 {
+    const WIDTH: u8 = 1;
+
+    fn encode<E>(&self, sink: &mut E)
+    where
+        E: Extend<u8>,
+    {
+        u8::from(*self).encode(sink);
+    }
+}
+
 impl<D: Reg, S1: Reg, S2: Reg> Encode for BinaryOperands<D, S1, S2> {
     const WIDTH: u8 = 2;
 
@@ -3,7 +3,7 @@
 use crate::decode::*;
 use crate::encode::Encode;
 use crate::imms::*;
-use crate::profile::{ExecutingPc, ExecutingPcRef};
+use crate::profile::{ExecutingPc, ExecutingPcRef, OpcodePairs};
 use crate::regs::*;
 use alloc::string::ToString;
 use alloc::vec::Vec;
@@ -27,6 +27,7 @@ const DEFAULT_STACK_SIZE: usize = 1 << 20; // 1 MiB
 pub struct Vm {
     state: MachineState,
     executing_pc: ExecutingPc,
+    opcode_pairs: OpcodePairs,
 }
 
 impl Default for Vm {
@@ -46,6 +47,7 @@ impl Vm {
         Self {
             state: MachineState::with_stack(stack_size),
             executing_pc: ExecutingPc::default(),
+            opcode_pairs: OpcodePairs::default(),
         }
     }
 
@@ -147,10 +149,11 @@ impl Vm {
     /// initialize this call's arguments.
     pub unsafe fn call_run(&mut self, pc: NonNull<u8>) -> DoneReason<()> {
         self.state.debug_assert_done_reason_none();
+        self.opcode_pairs.break_sequence();
         let interpreter = Interpreter {
             state: &mut self.state,
             pc: unsafe { UnsafeBytecodeStream::new(pc) },
-            executing_pc: self.executing_pc.as_ref(),
+            executing_pc: self.executing_pc.as_ref(&mut self.opcode_pairs),
         };
         let done = interpreter.run();
         self.state.done_decode(done)
@@ -229,6 +232,20 @@ impl Vm {
     pub fn executing_pc(&self) -> &ExecutingPc {
         &self.executing_pc
     }
+
+    /// Gets the counts of pairs of consecutive opcodes executed by this
+    /// interpreter.
+    #[cfg(feature = "profile")]
+    pub fn opcode_pairs(&self) -> &OpcodePairs {
+        &self.opcode_pairs
+    }
+
+    /// Gets mutable access to the counts of pairs of consecutive opcodes
+    /// executed by this interpreter, for example to enable counting.
+    #[cfg(feature = "profile")]
+    pub fn opcode_pairs_mut(&mut self) -> &mut OpcodePairs {
+        &mut self.opcode_pairs
+    }
 }
 
 impl Drop for Vm {
@@ -1177,7 +1194,7 @@ impl Interpreter<'_> {
 
     fn record_executing_pc_for_profiling(&mut self) {
         // Note that this is a no-op if `feature = "profile"` is disabled.
-        self.executing_pc.record(self.pc.as_ptr().as_ptr() as usize);
+        self.executing_pc.record(self.pc.as_ptr());
     }
 }
 
@@ -1296,13 +1313,14 @@ impl AddressingMode for AddrG32Bne {
 fn simple_push_pop() {
     let mut state = MachineState::with_stack(16);
     let pc = ExecutingPc::default();
+    let mut opcode_pairs = OpcodePairs::default();
     unsafe {
         let mut bytecode = [0; 10];
         let mut i = Interpreter {
             state: &mut state,
             // this isn't actually read so just manufacture a dummy one
             pc: UnsafeBytecodeStream::new(NonNull::new(bytecode.as_mut_ptr().offset(4)).unwrap()),
-            executing_pc: pc.as_ref(),
+            executing_pc: pc.as_ref(&mut opcode_pairs),
         };
         assert!(i.push::<crate::Ret, _>(0_i32).is_continue());
         assert_eq!(i.pop::<i32>(), 0_i32);
@@ -1753,6 +1771,22 @@ impl OpVisitor for Interpreter<'_> {
         ControlFlow::Continue(())
     }
 
+    fn xshladd32(&mut self, dst: XReg, src1: XReg, src2: XReg, shift: U6) -> ControlFlow<Done> {
+        let a = self.state[src1].get_u32();
+        let b = self.state[src2].get_u32();
+        let shift = u32::from(u8::from(shift));
+        self.state[dst].set_u32(a.wrapping_add(b.wrapping_shl(shift)));
+        ControlFlow::Continue(())
+    }
+
+    fn xshladd64(&mut self, dst: XReg, src1: XReg, src2: XReg, shift: U6) -> ControlFlow<Done> {
+        let a = self.state[src1].get_u64();
+        let b = self.state[src2].get_u64();
+        let shift = u32::from(u8::from(shift));
+        self.state[dst].set_u64(a.wrapping_add(b.wrapping_shl(shift)));
+        ControlFlow::Continue(())
+    }
+
     fn xsub32(&mut self, operands: BinaryOperands<XReg>) -> ControlFlow<Done> {
         let a = self.state[operands.src1].get_u32();
         let b = self.state[operands.src2].get_u32();
@@ -283,6 +283,13 @@ macro_rules! for_each_op {
             /// `dst = src1 * src2 + src3`
             xmadd64 = Xmadd64 { dst: XReg, src1: XReg, src2: XReg, src3: XReg };
 
+            /// `low32(dst) = low32(src1) + (low32(src2) << shift)`
+            ///
+            /// The scaled index of an address computation, for example.
+            xshladd32 = Xshladd32 { dst: XReg, src1: XReg, src2: XReg, shift: U6 };
+            /// `dst = src1 + (src2 << shift)`
+            xshladd64 = Xshladd64 { dst: XReg, src1: XReg, src2: XReg, shift: U6 };
+
             /// 32-bit wrapping subtraction: `low32(dst) = low32(src1) - low32(src2)`.
             ///
             /// The upper 32-bits of `dst` are unmodified.
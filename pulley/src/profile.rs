@@ -3,7 +3,10 @@
 //! This is used in conjunction with the `profiler-html.rs` example with Pulley
 //! and the `pulley.rs` ProfilingAgent in Wasmtime.
 
+use crate::opcode::{ExtendedOpcode, Opcode};
 use anyhow::{Context, Result, anyhow, bail};
+use core::marker::PhantomData;
+use core::ptr::NonNull;
 use std::fs::{File, OpenOptions};
 use std::io::{BufWriter, Write};
 use std::sync::Arc;
@@ -46,8 +49,12 @@ struct ExecutingPcState {
 }
 
 impl ExecutingPc {
-    pub(crate) fn as_ref(&self) -> ExecutingPcRef<'_> {
-        ExecutingPcRef(&self.0.current_pc)
+    pub(crate) fn as_ref<'a>(&'a self, opcode_pairs: &'a mut OpcodePairs) -> ExecutingPcRef<'a> {
+        ExecutingPcRef {
+            current_pc: &self.0.current_pc,
+            opcode_pairs: NonNull::from(opcode_pairs),
+            _marker: PhantomData,
+        }
     }
 
     /// Loads the currently executing program counter, if the interpreter is
@@ -71,12 +78,126 @@ impl ExecutingPc {
 }
 
 #[derive(Copy, Clone)]
-#[repr(transparent)]
-pub(crate) struct ExecutingPcRef<'a>(&'a AtomicUsize);
+pub(crate) struct ExecutingPcRef<'a> {
+    current_pc: &'a AtomicUsize,
+    // A pointer rather than `&'a mut` as this type is `Copy`, but it's still
+    // exclusively borrowed for `'a`.
+    opcode_pairs: NonNull<OpcodePairs>,
+    _marker: PhantomData<&'a mut OpcodePairs>,
+}
 
 impl ExecutingPcRef<'_> {
-    pub(crate) fn record(&self, pc: usize) {
-        self.0.store(pc, Relaxed);
+    pub(crate) fn record(&self, pc: NonNull<u8>) {
+        self.current_pc.store(pc.as_ptr() as usize, Relaxed);
+        // SAFETY: `pc` points at the opcode about to be executed and the
+        // interpreter is the only user of `opcode_pairs` while it runs.
+        unsafe {
+            (*self.opcode_pairs.as_ptr()).record(pc.as_ptr());
+        }
+    }
+}
+
+/// Counts of how often each pair of consecutive opcodes was executed by an
+/// interpreter.
+///
+/// Frequent pairs are candidates for new macro-instructions which do the work
+/// of both instructions in one dispatch. Counting is disabled by default as
+/// it slows down the interpreter loop noticeably, and is enabled with
+/// [`OpcodePairs::set_enabled`] through
+/// [`Vm::opcode_pairs_mut`](crate::interp::Vm::opcode_pairs_mut).
+#[derive(Default)]
+pub struct OpcodePairs {
+    enabled: bool,
+    /// Counts indexed by `prev * NUM_OPCODES + next`, allocated on first use.
+    counts: Vec<u64>,
+    /// The previously executed opcode, if any.
+    prev: Option<usize>,
+}
+
+/// The total number of opcodes, with extended opcodes numbered after all the
+/// others.
+const NUM_OPCODES: usize = Opcode::MAX as usize + 1 + ExtendedOpcode::MAX as usize;
+
+/// An opcode in a pair counted by [`OpcodePairs`].
+#[derive(Clone, Copy, Debug, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub enum AnyOpcode {
+    /// An opcode that isn't extended.
+    Op(Opcode),
+    /// An extended opcode.
+    ExtendedOp(ExtendedOpcode),
+}
+
+impl AnyOpcode {
+    fn from_index(index: usize) -> AnyOpcode {
+        match u8::try_from(index) {
+            Ok(op) if op < Opcode::ExtendedOp as u8 => AnyOpcode::Op(Opcode::new(op).unwrap()),
+            _ => {
+                let op = u16::try_from(index - Opcode::MAX as usize - 1).unwrap();
+                AnyOpcode::ExtendedOp(ExtendedOpcode::new(op).unwrap())
+            }
+        }
+    }
+}
+
+impl OpcodePairs {
+    /// Enables or disables counting.
+    pub fn set_enabled(&mut self, enabled: bool) {
+        self.enabled = enabled;
+        self.prev = None;
+    }
+
+    /// Resets all counts to zero.
+    pub fn clear(&mut self) {
+        self.counts.clear();
+        self.prev = None;
+    }
+
+    /// Returns the pairs which were executed, along with how many times they
+    /// were, with the most frequent pairs first.
+    pub fn pairs(&self) -> Vec<(AnyOpcode, AnyOpcode, u64)> {
+        let mut pairs = self
+            .counts
+            .iter()
+            .enumerate()
+            .filter(|(_, count)| **count > 0)
+            .map(|(i, count)| {
+                let prev = AnyOpcode::from_index(i / NUM_OPCODES);
+                let next = AnyOpcode::from_index(i % NUM_OPCODES);
+                (prev, next, *count)
+            })
+            .collect::<Vec<_>>();
+        pairs.sort_by(|a, b| b.2.cmp(&a.2).then((a.0, a.1).cmp(&(b.0, b.1))));
+        pairs
+    }
+
+    /// Forgets the previous opcode, for example when the interpreter is
+    /// entered from the host, so that it isn't paired with the next one.
+    pub(crate) fn break_sequence(&mut self) {
+        self.prev = None;
+    }
+
+    /// Records the execution of the instruction at `pc`.
+    ///
+    /// # Safety
+    ///
+    /// `pc` must point to a valid instruction.
+    pub(crate) unsafe fn record(&mut self, pc: *const u8) {
+        if !self.enabled {
+            return;
+        }
+        let op = unsafe { pc.read() };
+        let index = if op == Opcode::ExtendedOp as u8 {
+            let extended = unsafe { u16::from_le_bytes(pc.add(1).cast::<[u8; 2]>().read()) };
+            Opcode::MAX as usize + 1 + usize::from(extended)
+        } else {
+            usize::from(op)
+        };
+        if let Some(prev) = self.prev.replace(index) {
+            if self.counts.is_empty() {
+                self.counts = vec![0; NUM_OPCODES * NUM_OPCODES];
+            }
+            self.counts[prev * NUM_OPCODES + index] += 1;
+        }
     }
 }
 
@@ -1,13 +1,15 @@
-//! Stubs for when profiling is disabled to have the "executing_pc" field
-//! basically compiled away.
+//! Stubs for when profiling is disabled to have the "executing_pc" and
+//! "opcode_pairs" fields basically compiled away.
 
 use core::marker;
+use core::ptr::NonNull;
 
 #[derive(Default, Clone)]
 pub(crate) struct ExecutingPc;
 
 impl ExecutingPc {
-    pub(crate) fn as_ref(&self) -> ExecutingPcRef<'_> {
+    pub(crate) fn as_ref(&self, opcode_pairs: &mut OpcodePairs) -> ExecutingPcRef<'_> {
+        let _ = opcode_pairs;
         ExecutingPcRef {
             _marker: marker::PhantomData,
         }
@@ -23,7 +25,14 @@ pub(crate) struct ExecutingPcRef<'a> {
 }
 
 impl ExecutingPcRef<'_> {
-    pub(crate) fn record(&self, pc: usize) {
+    pub(crate) fn record(&self, pc: NonNull<u8>) {
         let _ = pc;
     }
 }
+
+#[derive(Default)]
+pub(crate) struct OpcodePairs;
+
+impl OpcodePairs {
+    pub(crate) fn break_sequence(&mut self) {}
+}
@@ -157,6 +157,28 @@ fn xadd32() {
     }
 }
 
+#[test]
+fn xshladd32() {
+    for (expected, a, b, shift) in [
+        (0x1234567800000000 | (10 + (3 << 2)), 10u64, 3u64, 2u8),
+        (0x1234567800000000 | 1, 1, 1 << 31, 1),
+    ] {
+        unsafe {
+            assert_one(
+                [(x(0), 0x1234567812345678), (x(1), a), (x(2), b)],
+                Xshladd32 {
+                    dst: x(0),
+                    src1: x(1),
+                    src2: x(2),
+                    shift: U6::new(shift).unwrap(),
+                },
+                x(0),
+                expected,
+            );
+        }
+    }
+}
+
 #[test]
 fn xadd64() {
     for (expected, a, b) in [(42u64, 10u64, 32u64), (0, u64::MAX, 1)] {
@@ -816,3 +838,33 @@ fn trap() {
     // `dst` should not have been written to the second time.
     assert_eq!(vm.state()[dst].get_u32(), 1);
 }
+
+#[test]
+#[cfg(feature = "profile")]
+fn opcode_pairs() {
+    use pulley_interpreter::profile::AnyOpcode;
+
+    let mut vm = Vm::new();
+    vm.opcode_pairs_mut().set_enabled(true);
+    let dst = XReg::new(0).unwrap();
+
+    unsafe {
+        run(
+            &mut vm,
+            &[
+                Op::Xconst16(Xconst16 { dst, imm: 1 }),
+                Op::Xconst16(Xconst16 { dst, imm: 2 }),
+                Op::Xconst16(Xconst16 { dst, imm: 3 }),
+                Op::Ret(Ret {}),
+            ],
+        )
+        .unwrap();
+    }
+
+    let xconst16 = AnyOpcode::Op(Opcode::Xconst16);
+    let ret = AnyOpcode::Op(Opcode::Ret);
+    assert_eq!(
+        vm.opcode_pairs().pairs(),
+        [(xconst16, xconst16, 2), (xconst16, ret, 1)]
+    );
+}
@@ -444,6 +444,65 @@ fn array_set_wrong_field_type() -> Result<()> {
     Ok(())
 }
 
+#[test]
+fn array_data() -> Result<()> {
+    let mut store = gc_store()?;
+
+    let array_ty = ArrayType::new(
+        store.engine(),
+        FieldType::new(Mutability::Var, ValType::F64.into()),
+    );
+    let pre = ArrayRefPre::new(&mut store, array_ty);
+    let array = ArrayRef::new(&mut store, &pre, &Val::F64(1.5f64.to_bits()), 3)?;
+
+    let data = array.data(&store)?;
+    assert_eq!(data.len(), 24);
+    assert_eq!(data[..8], 1.5f64.to_le_bytes());
+
+    array.data_mut(&mut store)?[8..16].copy_from_slice(&2.5f64.to_le_bytes());
+    assert_eq!(array.get(&mut store, 1)?.unwrap_f64(), 2.5);
+
+    array.set(&mut store, 2, Val::F64(3.5f64.to_bits()))?;
+    assert_eq!(array.data(&store)?[16..], 3.5f64.to_le_bytes());
+
+    Ok(())
+}
+
+#[test]
+fn array_data_i8() -> Result<()> {
+    let mut store = gc_store()?;
+
+    let array_ty = ArrayType::new(
+        store.engine(),
+        FieldType::new(Mutability::Const, StorageType::I8),
+    );
+    let pre = ArrayRefPre::new(&mut store, array_ty);
+    let array = ArrayRef::new_fixed(&mut store, &pre, &[Val::I32(1), Val::I32(0x102)])?;
+
+    assert_eq!(array.data(&store)?, [1, 2]);
+    // The elements are immutable.
+    assert!(array.data_mut(&mut store).is_err());
+
+    Ok(())
+}
+
+#[test]
+fn array_data_of_refs() -> Result<()> {
+    let mut store = gc_store()?;
+
+    let array_ty = ArrayType::new(
+        store.engine(),
+        FieldType::new(Mutability::Var, StorageType::ValType(ValType::ANYREF)),
+    );
+    let pre = ArrayRefPre::new(&mut store, array_ty);
+    let array = ArrayRef::new(&mut store, &pre, &Val::AnyRef(None), 1)?;
+
+    assert!(array.data(&store).is_err());
+    assert!(array.data_mut(&mut store).is_err());
+
+    Ok(())
+}
+
 #[test]
 fn array_ty() -> Result<()> {
     let mut store = gc_store()?;
@@ -4,6 +4,7 @@ use std::sync::atomic::AtomicUsize;
 use std::sync::atomic::Ordering;
 use std::sync::{Arc, Mutex};
 use std::task::{Context, Poll, Waker};
+use std::time::Duration;
 use wasmtime::*;
 
 fn async_store() -> Store<()> {
@@ -315,6 +316,94 @@ async fn iloop_with_fuel() {
     assert_eq!(pending, 99);
 }
 
+#[tokio::test]
+#[cfg_attr(miri, ignore)]
+async fn fuel_yield_time_slice_adapts_interval() -> Result<()> {
+    let engine = Engine::new(Config::new().consume_fuel(true))?;
+    let mut store = Store::new(&engine, ());
+    store.set_fuel(u64::MAX)?;
+
+    // A time slice requires a starting interval, and must be non-zero.
+    assert!(
+        store
+            .fuel_async_yield_time_slice(Some(Duration::from_millis(1)))
+            .is_err()
+    );
+    store.fuel_async_yield_interval(Some(1_000))?;
+    assert!(
+        store
+            .fuel_async_yield_time_slice(Some(Duration::ZERO))
+            .is_err()
+    );
+    store.fuel_async_yield_time_slice(Some(Duration::from_millis(10)))?;
+
+    let module = Module::new(
+        &engine,
+        "
+            (module
+                (func
+                    (local i32)
+                    i32.const 10000000
+                    local.set 0
+                    (loop
+                        local.get 0
+                        i32.const -1
+                        i32.add
+                        local.tee 0
+                        br_if 0)
+                )
+                (start 0)
+            )
+        ",
+    )?;
+    let instance = Instance::new_async(&mut store, &module, &[]);
+    let (instance, pending) = CountPending::new(Box::pin(instance)).await;
+    instance?;
+
+    // A fixed interval would yield tens of thousands of times, but a loop this
+    // tight consumes far more than 1000 fuel per 10ms so the interval grows.
+    let fixed = 10_000_000 * 4 / 1_000;
+    assert!(pending < fixed / 10, "yielded {pending} times");
+    Ok(())
+}
+
+#[tokio::test]
+#[cfg_attr(miri, ignore)]
+async fn instantiate_yields_between_data_segment_copies() -> Result<()> {
+    let mut config = Config::new();
+    config.memory_init_cow(false);
+    let engine = Engine::new(&config)?;
+    let mut store = Store::new(&engine, ());
+
+    // Three MiB of data segments, which are copied in 1 MiB chunks.
+    let data = "a".repeat(1 << 20);
+    let module = Module::new(
+        &engine,
+        format!(
+            r#"
+                (module
+                    (memory 64)
+                    (data (i32.const 0) "{data}{data}")
+                    (data (i32.const 0x300000) "{data}")
+                    (func (export "load") (param i32) (result i32)
+                        local.get 0
+                        i32.load8_u))
+            "#
+        ),
+    )?;
+    let instance = Instance::new_async(&mut store, &module, &[]);
+    let (instance, pending) = CountPending::new(Box::pin(instance)).await;
+    let instance = instance?;
+    assert_eq!(pending, 3);
+
+    let load = instance.get_typed_func::<u32, u32>(&mut store, "load")?;
+    let a = u32::from(b'a');
+    assert_eq!(load.call_async(&mut store, 0x1fffff).await?, a);
+    assert_eq!(load.call_async(&mut store, 0x2fffff).await?, 0);
+    assert_eq!(load.call_async(&mut store, 0x3fffff).await?, a);
+    Ok(())
+}
+
 #[tokio::test]
 #[cfg_attr(miri, ignore)]
 async fn fuel_eventually_finishes() {
@@ -1142,3 +1231,32 @@ async fn async_gc_with_func_new_and_func_wrap() -> Result<()> {
 
     Ok(())
 }
+
+#[tokio::test]
+#[cfg_attr(miri, ignore)]
+async fn stack_cache_reuses_stacks_across_stores() -> Result<()> {
+    let mut config = Config::new();
+    config.async_stack_cache_size(1);
+    let engine = Engine::new(&config)?;
+    let module = Module::new(&engine, r#"(module (func (export "f")))"#)?;
+
+    let stats = engine.async_stack_cache_stats().unwrap();
+    assert_eq!(stats.cached_stacks(), 0);
+
+    for i in 0..3 {
+        let mut store = Store::new(&engine, ());
+        let instance = Instance::new_async(&mut store, &module, &[]).await?;
+        let f = instance.get_typed_func::<(), ()>(&mut store, "f")?;
+        f.call_async(&mut store, ()).await?;
+        drop(store);
+
+        // Only the first store needs to allocate a stack, the rest reuse the
+        // one released by the previous store.
+        let stats = engine.async_stack_cache_stats().unwrap();
+        assert_eq!(stats.cached_stacks(), 1);
+        assert_eq!(stats.misses(), 1);
+        assert_eq!(stats.hits(), i);
+    }
+
+    Ok(())
+}
@@ -411,6 +411,55 @@ fn recursion() -> Result<(), Error> {
     Ok(())
 }
 
+#[test]
+fn record_call_transitions() -> Result<(), Error> {
+    let engine = Engine::default();
+    let mut store = Store::new(&engine, ());
+    store.record_call_transitions(4);
+    let mut linker = Linker::new(&engine);
+    linker.func_wrap("host", "f", || {})?;
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (import "host" "f" (func $f))
+                (func (export "run") (call $f)))
+        "#,
+    )?;
+    let run = linker
+        .instantiate(&mut store, &module)?
+        .get_typed_func::<(), ()>(&mut store, "run")?;
+
+    run.call(&mut store, ())?;
+    let (transitions, dropped) = store.take_call_transitions();
+    let kinds: Vec<_> = transitions.iter().map(|t| t.kind).collect();
+    assert_eq!(
+        kinds,
+        [
+            CallHook::CallingWasm,
+            CallHook::CallingHost,
+            CallHook::ReturningFromHost,
+            CallHook::ReturningFromWasm,
+        ]
+    );
+    assert!(
+        transitions
+            .windows(2)
+            .all(|w| w[0].timestamp <= w[1].timestamp)
+    );
+    assert_eq!(dropped, 0);
+
+    // Only the most recent transitions are kept once the buffer is full.
+    run.call(&mut store, ())?;
+    run.call(&mut store, ())?;
+    let (transitions, dropped) = store.take_call_transitions();
+    assert_eq!(transitions.len(), 4);
+    assert_eq!(transitions[0].kind, CallHook::CallingWasm);
+    assert_eq!(dropped, 4);
+    assert_eq!(store.take_call_transitions().0.len(), 0);
+    Ok(())
+}
+
 #[test]
 fn trapping() -> Result<(), Error> {
     const TRAP_IN_F: i32 = 0;
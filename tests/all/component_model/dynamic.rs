@@ -136,6 +136,52 @@ fn lists() -> Result<()> {
     Ok(())
 }
 
+#[test]
+fn lazy_results() -> Result<()> {
+    let engine = super::engine();
+    let mut store = Store::new(&engine, ());
+
+    let component = Component::new(&engine, make_echo_component("(list u32)", 8))?;
+    let instance = Linker::new(&engine).instantiate(&mut store, &component)?;
+    let func = instance.get_func(&mut store, "echo").unwrap();
+    let input = Val::List((0..1000).map(Val::U32).collect());
+
+    let sum = func.call_lazy(&mut store, &[input.clone()], |mut results| {
+        assert_eq!(results.len(), 1);
+        let list = results.list(0)?;
+        assert_eq!(list.list_len(), 1000);
+        let mut sum = 0;
+        for elem in list {
+            match elem? {
+                Val::U32(x) => sum += x,
+                other => panic!("unexpected {other:?}"),
+            }
+        }
+        Ok(sum)
+    })?;
+    assert_eq!(sum, (0..1000).sum());
+
+    let output = func.call_lazy(&mut store, &[input.clone()], |mut results| {
+        let mut list = results.list(0)?;
+        assert_eq!(list.get(999).unwrap()?, Val::U32(999));
+        assert!(list.get(1000).is_none());
+        results.get(0)
+    })?;
+    assert_eq!(input, output);
+
+    // Results which are returned as flat values rather than in memory.
+    let component = Component::new(&engine, make_echo_component("u32", 4))?;
+    let instance = Linker::new(&engine).instantiate(&mut store, &component)?;
+    let func = instance.get_func(&mut store, "echo").unwrap();
+    let output = func.call_lazy(&mut store, &[Val::U32(42)], |mut results| {
+        assert!(results.list(0).is_err());
+        results.get(0)
+    })?;
+    assert_eq!(output, Val::U32(42));
+
+    Ok(())
+}
+
 #[test]
 fn records() -> Result<()> {
     let engine = super::engine();
@@ -293,3 +293,61 @@ fn core_dump_with_shared_memory() -> Result<()> {
 
     Ok(())
 }
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn core_dump_memory_selection() -> Result<()> {
+    let mut config = Config::new();
+    config.coredump_on_trap(true);
+    let engine = Engine::new(&config)?;
+    let mut store = Store::new(&engine, ());
+    let wat = r#"(module
+        (memory 1)
+        (func (export "foo") unreachable)
+        (data (i32.const 16) "hello")
+        (data (i32.const 0x8000) "world")
+    )"#;
+    let module = Module::new(&engine, wat)?;
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let foo = instance.get_typed_func::<(), ()>(&mut store, "foo")?;
+    let err = foo.call(&mut store, ()).unwrap_err();
+    let coredump = err.downcast_ref::<WasmCoreDump>().unwrap();
+
+    // Returns the data segments of a serialized core dump as
+    // `(offset, bytes)` pairs.
+    fn segments(bytes: &[u8]) -> Result<Vec<(i32, Vec<u8>)>> {
+        let mut ret = Vec::new();
+        for payload in wasmparser::Parser::new(0).parse_all(bytes) {
+            if let wasmparser::Payload::DataSection(s) = payload? {
+                for data in s {
+                    let data = data?;
+                    let wasmparser::DataKind::Active { offset_expr, .. } = data.kind else {
+                        bail!("expected an active data segment");
+                    };
+                    let wasmparser::Operator::I32Const { value } =
+                        offset_expr.get_operators_reader().read()?
+                    else {
+                        bail!("expected an i32 offset");
+                    };
+                    ret.push((value, data.data.to_vec()));
+                }
+            }
+        }
+        Ok(ret)
+    }
+
+    let all = coredump.serialize(&mut store, "all");
+    assert_eq!(
+        segments(&all)?,
+        [(16, b"hello".to_vec()), (0x8000, b"world".to_vec())]
+    );
+
+    let none = coredump.serialize_with(&mut store, "none", &CoreDumpMemory::None);
+    assert!(segments(&none)?.is_empty());
+
+    let ranges = CoreDumpMemory::Ranges(vec![(0, 0x7ffe..0x8003), (1, 0..16)]);
+    let ranges = coredump.serialize_with(&mut store, "ranges", &ranges);
+    assert_eq!(segments(&ranges)?, [(0x8000, b"wor".to_vec())]);
+
+    Ok(())
+}
@@ -12,3 +12,154 @@ fn engine_without_compiler_cannot_compile() -> Result<()> {
     }
     Ok(())
 }
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn stats_track_loaded_code() -> Result<()> {
+    let engine = Engine::default();
+    assert_eq!(engine.stats().code_objects(), 0);
+
+    let module = Module::new(
+        &engine,
+        r#"(module (import "" "" (func)) (func (export "f") call 0))"#,
+    )?;
+    let clone = module.clone();
+    let stats = engine.stats();
+    assert_eq!(stats.code_objects(), 1);
+    assert!(stats.text_bytes() > 0);
+    assert!(stats.code_bytes() >= stats.text_bytes());
+    assert!(stats.trampolines() >= 1);
+    assert!(stats.types() >= 1);
+    assert!(stats.rec_groups() >= 1);
+
+    drop(module);
+    assert_eq!(engine.stats().code_objects(), 1);
+    drop(clone);
+    let stats = engine.stats();
+    assert_eq!(stats.code_objects(), 0);
+    assert_eq!(stats.code_bytes(), 0);
+    assert_eq!(stats.text_bytes(), 0);
+    assert_eq!(stats.trampolines(), 0);
+    assert_eq!(stats.types(), 0);
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn event_sink_records_runtime_events() -> Result<()> {
+    let sink = EventSink::new(16);
+    let mut config = Config::new();
+    config.event_sink(Some(sink.clone()));
+    let engine = Engine::new(&config)?;
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (memory 1)
+                (func (export "grow") (result i32) (memory.grow (i32.const 1)))
+                (func (export "trap") unreachable))
+        "#,
+    )?;
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let grow = instance.get_typed_func::<(), i32>(&mut store, "grow")?;
+    assert_eq!(grow.call(&mut store, ())?, 1);
+    let trap = instance.get_typed_func::<(), ()>(&mut store, "trap")?;
+    assert!(trap.call(&mut store, ()).is_err());
+
+    let (events, dropped) = sink.drain();
+    assert_eq!(dropped, 0);
+    let kinds = events.iter().map(|e| e.kind).collect::<Vec<_>>();
+    assert!(matches!(kinds[0], RuntimeEventKind::Compile { .. }));
+    assert!(matches!(kinds[1], RuntimeEventKind::Instantiate { .. }));
+    assert!(matches!(
+        kinds[2],
+        RuntimeEventKind::MemoryGrow {
+            delta: 1,
+            succeeded: true,
+            ..
+        }
+    ));
+    assert_eq!(
+        kinds[3],
+        RuntimeEventKind::Trap {
+            code: Trap::UnreachableCodeReached
+        }
+    );
+    assert_eq!(kinds.len(), 4);
+    assert!(sink.drain().0.is_empty());
+
+    // Events beyond a thread's capacity are dropped until the next drain.
+    for _ in 0..20 {
+        assert!(trap.call(&mut store, ()).is_err());
+    }
+    let (events, dropped) = sink.drain();
+    assert_eq!(events.len(), 16);
+    assert_eq!(dropped, 4);
+
+    // Each thread records into its own buffer.
+    std::thread::spawn(move || trap.call(&mut store, ()).unwrap_err())
+        .join()
+        .unwrap();
+    let (events, dropped) = sink.drain();
+    assert_eq!(events.len(), 1);
+    assert_eq!(dropped, 0);
+    Ok(())
+}
+
+#[test]
+#[cfg(unix)]
+#[cfg_attr(miri, ignore)]
+fn modules_are_usable_after_fork() -> Result<()> {
+    let mut config = Config::new();
+    config.epoch_interruption(true);
+    let engine = Engine::new(&config)?;
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (func (export "add") (param i32 i32) (result i32)
+                    (i32.add (local.get 0) (local.get 1)))
+                (func (export "run")
+                    (loop $l (br $l))))
+        "#,
+    )?;
+    engine.start_epoch_ticker(std::time::Duration::from_millis(1))?;
+
+    let child = |engine: &Engine| -> Result<()> {
+        engine.after_fork_child()?;
+        let mut store = Store::new(engine, ());
+        store.set_epoch_deadline(5);
+        let instance = Instance::new(&mut store, &module, &[])?;
+        let add = instance.get_typed_func::<(i32, i32), i32>(&mut store, "add")?;
+        assert_eq!(add.call(&mut store, (1, 2))?, 3);
+        // The epoch ticker must have been respawned for this to return.
+        let run = instance.get_typed_func::<(), ()>(&mut store, "run")?;
+        let trap = run.call(&mut store, ()).unwrap_err();
+        assert_eq!(trap.downcast::<Trap>()?, Trap::Interrupt);
+        // Compiling must not wait on the parent's compilation threads.
+        Module::new(engine, "(module (func (export \"f\")))")?;
+        Ok(())
+    };
+
+    engine.prepare_fork()?;
+    unsafe {
+        match libc::fork() {
+            0 => {
+                let child = std::panic::AssertUnwindSafe(|| child(&engine));
+                let ok = std::panic::catch_unwind(child).is_ok_and(|result| result.is_ok());
+                libc::_exit(if ok { 0 } else { 1 });
+            }
+            -1 => panic!("failed to fork: {}", std::io::Error::last_os_error()),
+            pid => {
+                engine.after_fork_parent();
+                let mut status = 0;
+                assert_eq!(libc::waitpid(pid, &mut status, 0), pid);
+                assert!(libc::WIFEXITED(status));
+                assert_eq!(libc::WEXITSTATUS(status), 0);
+            }
+        }
+    }
+    engine.stop_epoch_ticker();
+    Ok(())
+}
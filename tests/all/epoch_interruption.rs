@@ -496,3 +496,43 @@ async fn drop_future_on_epoch_yield(config: &mut Config) -> Result<()> {
     assert_eq!(true, alive_flag.load(Ordering::Acquire));
     Ok(())
 }
+
+#[wasmtime_test]
+fn epoch_ticker_interrupts_infinite_loop(config: &mut Config) -> Result<()> {
+    let engine = build_engine(config)?;
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (func (export "run")
+                  (loop $l
+                    (br $l))))
+        "#,
+    )?;
+
+    assert!(
+        engine
+            .start_epoch_ticker(std::time::Duration::ZERO)
+            .is_err()
+    );
+    engine.start_epoch_ticker(std::time::Duration::from_millis(1))?;
+    assert_eq!(
+        engine.epoch_ticker_interval(),
+        Some(std::time::Duration::from_millis(1))
+    );
+
+    // Run twice so that the ticker goes idle in between.
+    for _ in 0..2 {
+        let mut store = Store::new(&engine, ());
+        store.set_epoch_deadline(5);
+        let instance = Instance::new(&mut store, &module, &[])?;
+        let run = instance.get_typed_func::<(), ()>(&mut store, "run")?;
+        let trap = run.call(&mut store, ()).unwrap_err();
+        assert_eq!(trap.downcast::<Trap>()?, Trap::Interrupt);
+        std::thread::sleep(std::time::Duration::from_millis(10));
+    }
+
+    engine.stop_epoch_ticker();
+    assert_eq!(engine.epoch_ticker_interval(), None);
+    Ok(())
+}
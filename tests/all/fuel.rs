@@ -382,3 +382,53 @@ fn ensure_stack_alignment(config: &mut Config) -> Result<()> {
     );
     Ok(())
 }
+
+#[wasmtime_test(strategies(not(Winch)))]
+#[cfg_attr(miri, ignore)]
+fn per_loop_metering(config: &mut Config) -> Result<()> {
+    config.consume_fuel(true);
+    config.fuel_metering(FuelMetering::PerLoop);
+    let engine = Engine::new(config)?;
+    let mut store = Store::new(&engine, ());
+    let module = Module::new(
+        &engine,
+        r#"
+(module
+  (func (export "count") (param $n i32)
+    (loop $l
+      (br_if $l (local.tee $n (i32.sub (local.get $n) (i32.const 1))))
+    )
+  )
+  (func (export "skip") (param i32)
+    (block
+      (br_if 0 (local.get 0))
+      (drop (i32.add (i32.const 1) (i32.const 2)))
+    )
+  )
+  (func (export "iloop")
+    (loop br 0)
+  )
+)
+        "#,
+    )?;
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let count = instance.get_typed_func::<i32, ()>(&mut store, "count")?;
+    let skip = instance.get_typed_func::<i32, ()>(&mut store, "skip")?;
+    let iloop = instance.get_typed_func::<(), ()>(&mut store, "iloop")?;
+
+    // One fuel for entering the function, and five per iteration.
+    store.set_fuel(1_000)?;
+    count.call(&mut store, 10)?;
+    assert_eq!(store.get_fuel()?, 1_000 - 51);
+
+    // The whole function body is charged for, whether or not it's skipped.
+    for arg in [0, 1] {
+        store.set_fuel(1_000)?;
+        skip.call(&mut store, arg)?;
+        assert_eq!(store.get_fuel()?, 1_000 - 6);
+    }
+
+    let trap = iloop.call(&mut store, ()).unwrap_err();
+    assert_eq!(trap.downcast::<Trap>()?, Trap::OutOfFuel);
+    Ok(())
+}
@@ -623,6 +623,21 @@ fn signatures_match() {
     assert!(f.ty(&store).results().nth(0).unwrap().is_f64());
 }
 
+#[test]
+fn ty_index_identifies_types() {
+    let mut store = Store::<()>::default();
+
+    let a = Func::wrap(&mut store, |_: i32| -> i64 { 0 });
+    let b = Func::wrap(&mut store, |_: i32| -> i64 { 1 });
+    let c = Func::wrap(&mut store, |_: i64| -> i64 { 2 });
+    assert_eq!(a.ty_index(&store), b.ty_index(&store));
+    assert_ne!(a.ty_index(&store), c.ty_index(&store));
+
+    let mut store2 = Store::new(store.engine(), ());
+    let d = Func::wrap(&mut store2, |_: i32| -> i64 { 3 });
+    assert_eq!(a.ty_index(&store), d.ty_index(&store2));
+}
+
 #[test]
 #[cfg_attr(miri, ignore)]
 fn import_works() -> Result<()> {
@@ -1061,6 +1076,67 @@ fn caller_memory(config: &mut Config) -> wasmtime::Result<()> {
     Ok(())
 }
 
+#[test]
+#[cfg_attr(miri, ignore)]
+fn caller_memory_and_data_mut() -> wasmtime::Result<()> {
+    let engine = Engine::default();
+    let mut store = Store::<u32>::new(&engine, 0);
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (import "" "sum" (func $sum (param i32 i32)))
+                (memory (export "memory") 1)
+                (data (i32.const 8) "\01\02\03")
+                (func (export "run") (param i32 i32)
+                    (call $sum (local.get 0) (local.get 1)))
+                (func (export "grow") (drop (memory.grow (i32.const 1)))))
+        "#,
+    )?;
+    let sum = Func::wrap(
+        &mut store,
+        |mut caller: Caller<'_, u32>, ptr: u32, len: u32| -> Result<()> {
+            let (memory, sum) = caller.memory_and_data_mut().unwrap();
+            let bytes = memory
+                .get(ptr as usize..)
+                .and_then(|m| m.get(..len as usize))
+                .ok_or_else(|| format_err!("out of bounds"))?;
+            *sum = bytes.iter().map(|b| u32::from(*b)).sum();
+            memory[0] = 42;
+            Ok(())
+        },
+    );
+    let instance = Instance::new(&mut store, &module, &[sum.into()])?;
+    let run = instance.get_typed_func::<(u32, u32), ()>(&mut store, "run")?;
+    run.call(&mut store, (8, 3))?;
+    assert_eq!(*store.data(), 6);
+    let memory = instance.get_memory(&mut store, "memory").unwrap();
+    assert_eq!(memory.data(&store)[0], 42);
+
+    // The length reflects growth of the memory.
+    assert!(run.call(&mut store, (0x10000, 1)).is_err());
+    let grow = instance.get_typed_func::<(), ()>(&mut store, "grow")?;
+    grow.call(&mut store, ())?;
+    run.call(&mut store, (0x10000, 1))?;
+    assert_eq!(*store.data(), 0);
+
+    // Memories which aren't exported aren't available.
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (import "" "f" (func $f))
+                (memory 1)
+                (start $f))
+        "#,
+    )?;
+    let f = Func::wrap(&mut store, |mut caller: Caller<'_, u32>| {
+        assert!(caller.memory_and_data_mut().is_none());
+    });
+    Instance::new(&mut store, &module, &[f.into()])?;
+    Ok(())
+}
+
 #[test]
 #[cfg_attr(miri, ignore)]
 fn func_write_nothing() -> wasmtime::Result<()> {
@@ -1331,6 +1331,75 @@ fn drc_traces_the_correct_number_of_gc_refs_in_arrays() -> Result<()> {
 // Test that we can completely fill the GC heap until we get an OOM. This
 // exercises growing the GC heap and that we configure compilation tunables and
 // runtime memories backing GC heaps correctly.
+#[test]
+#[cfg_attr(miri, ignore)]
+fn drc_inline_alloc() -> Result<()> {
+    let _ = env_logger::try_init();
+
+    for inline in [false, true] {
+        let mut config = Config::new();
+        config.wasm_function_references(true);
+        config.wasm_gc(true);
+        config.collector(Collector::DeferredReferenceCounting);
+        config.gc_inline_alloc(inline);
+        // Keep the GC heap small so that it has to be collected, and so that
+        // allocations get interleaved with the free list's reuse of collected
+        // garbage.
+        config.memory_reservation(1 << 20);
+        config.memory_reservation_for_growth(0);
+        config.memory_guard_size(0);
+        config.memory_may_move(false);
+
+        let engine = Engine::new(&config)?;
+        let module = Module::new(
+            &engine,
+            r#"
+                (module
+                    (type $pair (struct (field i32) (field (ref null $pair))))
+                    (type $garbage (array (mut i32)))
+                    (func (export "run") (param $n i32) (result i32)
+                        (local $list (ref null $pair))
+                        (local $i i32)
+                        (local $sum i32)
+
+                        ;; Build a list while allocating garbage.
+                        loop
+                            (local.set $list (struct.new $pair (local.get $i) (local.get $list)))
+                            (drop (array.new $garbage (local.get $i) (i32.const 3)))
+                            (local.set $i (i32.add (local.get $i) (i32.const 1)))
+                            (br_if 0 (i32.lt_u (local.get $i) (local.get $n)))
+                        end
+
+                        ;; Sum up the list.
+                        block
+                            loop
+                                (br_if 1 (ref.is_null (local.get $list)))
+                                (local.set $sum
+                                    (i32.add (local.get $sum)
+                                             (struct.get $pair 0 (local.get $list))))
+                                (local.set $list (struct.get $pair 1 (local.get $list)))
+                                br 0
+                            end
+                        end
+                        local.get $sum
+                    )
+                )
+            "#,
+        )?;
+
+        let mut store = Store::new(&engine, ());
+        let instance = Instance::new(&mut store, &module, &[])?;
+        let run = instance.get_typed_func::<u32, u32>(&mut store, "run")?;
+        for _ in 0..3 {
+            assert_eq!(run.call(&mut store, 20_000)?, 20_000 * 19_999 / 2);
+        }
+        store.gc(None)?;
+        assert_eq!(run.call(&mut store, 10)?, 45);
+    }
+
+    Ok(())
+}
+
 #[test]
 #[cfg_attr(any(miri, not(target_pointer_width = "64")), ignore)]
 fn gc_heap_oom() -> Result<()> {
@@ -1800,3 +1869,60 @@ fn array_init_elem_oom() -> Result<()> {
 
     Ok(())
 }
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn gc_stats() -> Result<()> {
+    let _ = env_logger::try_init();
+
+    let mut config = Config::new();
+    config.wasm_function_references(true);
+    config.wasm_gc(true);
+    config.collector(Collector::DeferredReferenceCounting);
+    config.gc_heap_growth_factor(1.5);
+
+    let engine = Engine::new(&config)?;
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (type $s (struct (field i64)))
+                (func (export "run")
+                    (drop (struct.new $s (i64.const 1))))
+            )
+        "#,
+    )?;
+
+    let mut store = Store::new(&engine, ());
+    assert_eq!(store.gc_stats(), GcStats::default());
+
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let run = instance.get_typed_func::<(), ()>(&mut store, "run")?;
+    for _ in 0..10 {
+        run.call(&mut store, ())?;
+    }
+
+    let before = store.gc_stats();
+    assert_eq!(before.collections, 0);
+    assert!(before.allocated_bytes > 0);
+    assert!(before.heap_size >= before.allocated_bytes);
+
+    store.gc(None)?;
+    let after = store.gc_stats();
+    assert_eq!(after.collections, 1);
+    assert!(after.bytes_freed > 0);
+    assert_eq!(
+        after.allocated_bytes,
+        before.allocated_bytes - after.bytes_freed
+    );
+    assert!(after.max_pause <= after.total_pause);
+
+    Ok(())
+}
+
+#[test]
+fn gc_heap_growth_factor_must_be_at_least_one() {
+    let mut config = Config::new();
+    config.gc_heap_growth_factor(0.5);
+    assert!(Engine::new(&config).is_err());
+}
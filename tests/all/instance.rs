@@ -1,4 +1,5 @@
 use wasmtime::*;
+use wasmtime_test_macros::wasmtime_test;
 
 #[test]
 #[cfg_attr(miri, ignore)]
@@ -79,3 +80,273 @@ fn linear_memory_limits() -> Result<()> {
         Ok(())
     }
 }
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn instantiate_from_snapshot() -> Result<()> {
+    let wat = r#"
+        (module
+            (memory (export "memory") 1 10)
+            (global $g (export "g") (mut i32) (i32.const 0))
+            (global $starts (export "starts") (mut i32) (i32.const 0))
+            (table (export "table") 1 funcref)
+            (data (i32.const 0) "hello")
+            (func $start
+                (global.set $starts (i32.add (global.get $starts) (i32.const 1))))
+            (func $init (export "init")
+                (global.set $g (i32.const 42))
+                (drop (memory.grow (i32.const 1)))
+                (i32.store (i32.const 100000) (i32.const 7))
+                (drop (table.grow (ref.func $answer) (i32.const 1)))
+                (table.set (i32.const 0) (ref.func $answer)))
+            (func $answer (export "answer") (result i32) i32.const 42)
+            (start $start)
+        )"#;
+
+    for pooling in [false, true] {
+        let mut config = Config::new();
+        if pooling {
+            config.allocation_strategy(PoolingAllocationConfig::default());
+        }
+        let engine = Engine::new(&config)?;
+        let module = Module::new(&engine, wat)?;
+        let linker = Linker::new(&engine);
+        let pre = linker.instantiate_pre(&module)?;
+
+        let mut store = Store::new(&engine, ());
+        let instance = pre.instantiate(&mut store)?;
+        let init = instance.get_typed_func::<(), ()>(&mut store, "init")?;
+        init.call(&mut store, ())?;
+        let snapshot = instance.snapshot(&mut store)?;
+        assert!(Module::same(snapshot.module(), &module));
+
+        let mut store = Store::new(&engine, ());
+        let instance = pre.instantiate_from_snapshot(&mut store, &snapshot)?;
+        let memory = instance.get_memory(&mut store, "memory").unwrap();
+        assert_eq!(memory.size(&store), 2);
+        assert_eq!(&memory.data(&store)[..5], b"hello");
+        assert_eq!(memory.data(&store)[100000], 7);
+        let g = instance.get_global(&mut store, "g").unwrap();
+        assert_eq!(g.get(&mut store).unwrap_i32(), 42);
+        let starts = instance.get_global(&mut store, "starts").unwrap();
+        assert_eq!(starts.get(&mut store).unwrap_i32(), 1);
+
+        let table = instance.get_table(&mut store, "table").unwrap();
+        assert_eq!(table.size(&store), 2);
+        for i in 0..2 {
+            let func = table.get(&mut store, i).unwrap();
+            let func = func.unwrap_func().unwrap();
+            assert_eq!(func.typed::<(), i32>(&store)?.call(&mut store, ())?, 42);
+        }
+
+        // Changes to an instance don't affect the snapshot it came from.
+        memory.data_mut(&mut store)[0] = b'j';
+        let instance = pre.instantiate_from_snapshot(&mut store, &snapshot)?;
+        let memory = instance.get_memory(&mut store, "memory").unwrap();
+        assert_eq!(&memory.data(&store)[..5], b"hello");
+
+        let other = Module::new(&engine, wat)?;
+        let pre = linker.instantiate_pre(&other)?;
+        assert!(
+            pre.instantiate_from_snapshot(&mut store, &snapshot)
+                .is_err()
+        );
+    }
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn instance_pool() -> Result<()> {
+    let wat = r#"
+        (module
+            (memory (export "memory") 1)
+            (global $g (mut i32) (i32.const 0))
+            (data (i32.const 0) "a")
+            (func (export "bump") (result i32)
+                (i32.store8 (i32.const 0) (i32.const 98))
+                (global.set $g (i32.add (global.get $g) (i32.const 1)))
+                (global.get $g))
+        )"#;
+
+    fn assert_sync<T: Sync>(_: &T) {}
+
+    for pooling in [false, true] {
+        let mut config = Config::new();
+        if pooling {
+            config.allocation_strategy(PoolingAllocationConfig::default());
+        }
+        let engine = Engine::new(&config)?;
+        let module = Module::new(&engine, wat)?;
+        let pre = Linker::new(&engine).instantiate_pre(&module)?;
+        let pool = InstancePool::new(pre, 2, ResetPolicy::Reinstantiate, || ())?;
+        assert_sync(&pool);
+        assert_eq!(pool.size(), 2);
+
+        let a = pool.checkout()?.unwrap();
+        let mut b = pool.checkout()?.unwrap();
+        assert!(pool.checkout()?.is_none());
+        drop(a);
+
+        for _ in 0..2 {
+            let instance = b.instance();
+            let bump = instance.get_typed_func::<(), i32>(b.store_mut(), "bump")?;
+            assert_eq!(bump.call(b.store_mut(), ())?, 1);
+            let memory = instance.get_memory(b.store_mut(), "memory").unwrap();
+            assert_eq!(memory.data(b.store())[0], b'b');
+            b.release()?;
+            b = pool.checkout()?.unwrap();
+        }
+
+        // Discarded instances are replaced when the pool runs out.
+        b.discard();
+        let a = pool.checkout()?.unwrap();
+        let b = pool.checkout()?.unwrap();
+        assert!(pool.checkout()?.is_none());
+        drop((a, b));
+    }
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn memory_by_index() -> Result<()> {
+    let engine = Engine::default();
+    let mut store = Store::new(&engine, ());
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (import "" "m" (memory 1))
+                (import "" "f" (func (param i32)))
+                (memory (export "scratch") 1)
+                (memory 1)
+                (export "m" (memory 0))
+                (func (export "run") (call 0 (i32.const 3))))
+        "#,
+    )?;
+    let imported = Memory::new(&mut store, MemoryType::new(1, None))?;
+    let poke = Func::wrap(&mut store, |mut caller: Caller<'_, ()>, addr: i32| {
+        let scratch = caller.memory(1).unwrap();
+        scratch.data_mut(&mut caller)[addr as usize] = 42;
+        assert!(caller.memory(2).is_none());
+    });
+    let instance = Instance::new(&mut store, &module, &[imported.into(), poke.into()])?;
+
+    let m = instance.memory(&mut store, 0).unwrap();
+    assert_eq!(m.data_ptr(&store), imported.data_ptr(&store));
+    let scratch = instance.memory(&mut store, 1).unwrap();
+    let by_name = instance.get_memory(&mut store, "scratch").unwrap();
+    assert_eq!(scratch.data_ptr(&store), by_name.data_ptr(&store));
+    assert!(instance.memory(&mut store, 2).is_none());
+    assert!(instance.memory(&mut store, 3).is_none());
+
+    let run = instance.get_typed_func::<(), ()>(&mut store, "run")?;
+    run.call(&mut store, ())?;
+    assert_eq!(scratch.data(&store)[3], 42);
+    Ok(())
+}
+
+#[wasmtime_test(strategies(not(Winch)))]
+#[cfg_attr(miri, ignore)]
+fn function_call_counts(config: &mut Config) -> Result<()> {
+    config.count_function_calls(true);
+    let engine = Engine::new(config)?;
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (import "" "" (func))
+                (func $leaf)
+                (func (export "run") (param i32)
+                    (loop $l
+                        call $leaf
+                        (br_if $l
+                            (local.tee 0 (i32.sub (local.get 0) (i32.const 1)))))))
+        "#,
+    )?;
+    let mut store = Store::new(&engine, ());
+    let import = Func::wrap(&mut store, || {});
+    let instance = Instance::new(&mut store, &module, &[import.into()])?;
+    fn counts(instance: Instance, store: &Store<()>) -> Vec<(u32, Option<&str>, u64)> {
+        instance
+            .function_stats(store)
+            .map(|s| (s.index, s.name, s.calls))
+            .collect()
+    }
+    assert_eq!(
+        counts(instance, &store),
+        [(1, Some("leaf"), 0), (2, None, 0)]
+    );
+
+    let run = instance.get_typed_func::<i32, ()>(&mut store, "run")?;
+    run.call(&mut store, 10)?;
+    run.call(&mut store, 5)?;
+    assert_eq!(
+        counts(instance, &store),
+        [(1, Some("leaf"), 15), (2, None, 2)]
+    );
+
+    // Counters are per-instance, and nothing is counted without the option.
+    let other = Instance::new(&mut store, &module, &[import.into()])?;
+    assert!(other.function_stats(&store).all(|s| s.calls == 0));
+    let module = Module::new(&Engine::default(), "(module (func))")?;
+    let mut store = Store::new(module.engine(), ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    assert_eq!(instance.function_stats(&store).len(), 0);
+    Ok(())
+}
+
+#[wasmtime_test(strategies(not(Winch)))]
+#[cfg_attr(miri, ignore)]
+fn compile_with_profile(config: &mut Config) -> Result<()> {
+    let wat = r#"
+        (module
+            (func $cold (result i32) i32.const 1)
+            (func $hot (param i32) (result i32)
+                (i32.add (local.get 0) (i32.const 1)))
+            (func (export "run") (param i32) (result i32)
+                (loop $l
+                    (local.set 0 (call $hot (local.get 0)))
+                    (br_if $l (i32.lt_u (local.get 0) (i32.const 10))))
+                local.get 0)
+            (func (export "unused") (result i32) call $cold))
+    "#;
+
+    let mut profiling = config.clone();
+    profiling.count_function_calls(true);
+    let engine = Engine::new(&profiling)?;
+    let module = Module::new(&engine, wat)?;
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let run = instance.get_typed_func::<i32, i32>(&mut store, "run")?;
+    assert_eq!(run.call(&mut store, 0)?, 10);
+
+    let mut profile = CompileProfile::new();
+    profile.add_instance(&store, &instance);
+    assert_eq!(profile.calls(0), Some(0));
+    assert_eq!(profile.calls(1), Some(10));
+    assert_eq!(profile.calls(2), Some(1));
+
+    // Profiles round-trip through their text form.
+    let text = profile.to_string();
+    assert_eq!(text, "0 0\n1 10\n2 1\n3 0\n");
+    assert_eq!(text.parse::<CompileProfile>()?, profile);
+    assert!("1".parse::<CompileProfile>().is_err());
+    assert!("1 ten".parse::<CompileProfile>().is_err());
+
+    // Compiling with the profile doesn't change the module's behavior.
+    config.compiler_inlining(true);
+    let engine = Engine::new(config)?;
+    let module = CodeBuilder::new(&engine)
+        .wasm_binary_or_text(wat.as_bytes(), None)?
+        .profile(&profile)
+        .compile_module()?;
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let run = instance.get_typed_func::<i32, i32>(&mut store, "run")?;
+    assert_eq!(run.call(&mut store, 3)?, 10);
+    let unused = instance.get_typed_func::<(), i32>(&mut store, "unused")?;
+    assert_eq!(unused.call(&mut store, ())?, 1);
+    Ok(())
+}
@@ -1,5 +1,6 @@
 //! Tests related to the unsafe Wasmtime intrinsics we can give to components
-//! via `CodeBuilder::expose_unsafe_intrinsics`.
+//! via `CodeBuilder::expose_unsafe_intrinsics`, and to the host intrinsics that
+//! calls to imports are compiled to via `CodeBuilder::inline_import`.
 
 use super::*;
 use std::{cell::UnsafeCell, path::Path, sync::Arc};
@@ -651,3 +652,82 @@ fn other_import_name() -> Result<()> {
 
     Ok(())
 }
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn inlined_host_imports() -> Result<()> {
+    #[repr(C)]
+    struct Data {
+        counter: i32,
+        scale: f64,
+    }
+
+    let engine = Engine::default();
+    let wat = r#"
+        (module
+            (import "host" "counter" (func $counter (result i32)))
+            (import "host" "scale" (func $scale (result f64)))
+            (import "host" "pi" (func $pi (result f32)))
+            (func (export "counter") (result i32) call $counter)
+            (func (export "scale") (result f64) call $scale)
+            (func (export "pi") (result f32) call $pi)
+            (func (export "tail-counter") (result i32) return_call $counter))
+    "#;
+    let mut code_builder = CodeBuilder::new(&engine);
+    code_builder.wasm_binary_or_text(wat.as_bytes(), None)?;
+    unsafe {
+        let counter = u32::try_from(core::mem::offset_of!(Data, counter))?;
+        let scale = u32::try_from(core::mem::offset_of!(Data, scale))?;
+        code_builder
+            .inline_import("host", "counter", HostIntrinsic::I32StoreData(counter))
+            .inline_import("host", "scale", HostIntrinsic::F64StoreData(scale))
+            .inline_import("host", "pi", HostIntrinsic::F32Const(3.5_f32.to_bits()))
+            .inline_import("host", "unused", HostIntrinsic::I64Const(1));
+    }
+    let module = code_builder.compile_module()?;
+
+    let mut linker = Linker::<Data>::new(&engine);
+    linker.func_wrap("host", "counter", |caller: Caller<'_, Data>| {
+        caller.data().counter
+    })?;
+    linker.func_wrap("host", "scale", |caller: Caller<'_, Data>| {
+        caller.data().scale
+    })?;
+    linker.func_wrap("host", "pi", || 3.5_f32)?;
+    let mut store = Store::new(
+        &engine,
+        Data {
+            counter: 7,
+            scale: 0.5,
+        },
+    );
+    let instance = linker.instantiate(&mut store, &module)?;
+    let counter = instance.get_typed_func::<(), i32>(&mut store, "counter")?;
+    let tail_counter = instance.get_typed_func::<(), i32>(&mut store, "tail-counter")?;
+    let scale = instance.get_typed_func::<(), f64>(&mut store, "scale")?;
+    let pi = instance.get_typed_func::<(), f32>(&mut store, "pi")?;
+
+    assert_eq!(counter.call(&mut store, ())?, 7);
+    assert_eq!(tail_counter.call(&mut store, ())?, 7);
+    assert_eq!(scale.call(&mut store, ())?, 0.5);
+    assert_eq!(pi.call(&mut store, ())?, 3.5);
+    store.data_mut().counter = 8;
+    store.data_mut().scale = 2.0;
+    assert_eq!(counter.call(&mut store, ())?, 8);
+    assert_eq!(tail_counter.call(&mut store, ())?, 8);
+    assert_eq!(scale.call(&mut store, ())?, 2.0);
+
+    // The intrinsic's result must match the import's type.
+    let mut code_builder = CodeBuilder::new(&engine);
+    code_builder.wasm_binary_or_text(wat.as_bytes(), None)?;
+    unsafe {
+        code_builder.inline_import("host", "counter", HostIntrinsic::I64Const(1));
+    }
+    let err = code_builder.compile_module().unwrap_err();
+    assert!(
+        format!("{err:?}").contains("doesn't match its inlined behavior"),
+        "{err:?}"
+    );
+
+    Ok(())
+}
@@ -1164,3 +1164,36 @@ fn growth_trap() -> Result<()> {
 
     Ok(())
 }
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn resource_counts() -> Result<()> {
+    let engine = Engine::default();
+    let module = Module::new(
+        &engine,
+        r#"(module
+            (memory 0)
+            (table 0 funcref)
+            (table 0 funcref)
+           )"#,
+    )?;
+
+    let mut store = Store::new(&engine, ());
+    assert_eq!(store.resource_counts(), ResourceCounts::default());
+
+    Instance::new(&mut store, &module, &[])?;
+    Instance::new(&mut store, &module, &[])?;
+    assert_eq!(
+        store.resource_counts(),
+        ResourceCounts {
+            instances: 2,
+            memories: 2,
+            tables: 4,
+        }
+    );
+    assert_eq!(
+        store.as_context().resource_counts(),
+        store.resource_counts()
+    );
+    Ok(())
+}
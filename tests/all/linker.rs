@@ -92,6 +92,43 @@ fn link_twice_bad() -> Result<()> {
     Ok(())
 }
 
+#[test]
+#[cfg_attr(miri, ignore)]
+fn repeated_instantiate_sees_redefinitions() -> Result<()> {
+    let mut store = Store::<()>::default();
+    let mut linker = Linker::new(store.engine());
+    linker.allow_shadowing(true);
+    linker.func_wrap("host", "f", || 1i32)?;
+    let module = Module::new(
+        store.engine(),
+        r#"(module
+            (import "host" "f" (func $f (result i32)))
+            (func (export "run") (result i32) call $f))"#,
+    )?;
+
+    for _ in 0..2 {
+        let instance = linker.instantiate(&mut store, &module)?;
+        let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+        assert_eq!(run.call(&mut store, ())?, 1);
+    }
+
+    linker.func_wrap("host", "f", || 2i32)?;
+    let instance = linker.instantiate(&mut store, &module)?;
+    let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+    assert_eq!(run.call(&mut store, ())?, 2);
+
+    // A clone of the linker resolves against its own definitions.
+    let mut clone = linker.clone();
+    clone.func_wrap("host", "f", || 3i32)?;
+    let instance = clone.instantiate(&mut store, &module)?;
+    let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+    assert_eq!(run.call(&mut store, ())?, 3);
+    let instance = linker.instantiate(&mut store, &module)?;
+    let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+    assert_eq!(run.call(&mut store, ())?, 2);
+    Ok(())
+}
+
 #[test]
 #[cfg_attr(miri, ignore)]
 fn function_interposition() -> Result<()> {
@@ -209,6 +246,73 @@ fn allow_unknown_exports() -> Result<()> {
     Ok(())
 }
 
+#[test]
+#[cfg_attr(miri, ignore)]
+fn module_lazy() -> Result<()> {
+    let mut store = Store::<usize>::default();
+    let mut linker = Linker::new(store.engine());
+    linker.func_wrap("host", "initialized", |mut caller: Caller<'_, usize>| {
+        *caller.data_mut() += 1;
+    })?;
+    let lib = Module::new(
+        store.engine(),
+        r#"(module
+            (import "host" "initialized" (func $initialized))
+            (global $counter (mut i32) (i32.const 0))
+            (memory (export "memory") 1)
+            (func (export "_initialize") call $initialized)
+            (func (export "increment") (result i32)
+                (global.set $counter (i32.add (global.get $counter) (i32.const 1)))
+                (global.get $counter))
+            (func (export "get") (result i32) (global.get $counter))
+        )"#,
+    )?;
+    linker.module_lazy(&mut store, "lib", &lib)?;
+    assert!(linker.get(&mut store, "lib", "memory").is_none());
+
+    let module = Module::new(
+        store.engine(),
+        r#"(module
+            (import "lib" "increment" (func $increment (result i32)))
+            (import "lib" "get" (func $get (result i32)))
+            (func (export "run") (result i32)
+                call $increment
+                drop
+                call $get)
+        )"#,
+    )?;
+    let instance = linker.instantiate(&mut store, &module)?;
+    assert_eq!(*store.data(), 0);
+
+    // All of the exports share one instance, which is initialized once.
+    let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+    assert_eq!(run.call(&mut store, ())?, 1);
+    assert_eq!(run.call(&mut store, ())?, 2);
+    assert_eq!(*store.data(), 1);
+
+    // Each store gets its own instance.
+    let mut store2 = Store::new(store.engine(), 0);
+    linker.allow_shadowing(true);
+    linker.module_lazy(&mut store2, "lib", &lib)?;
+    let instance = linker.instantiate(&mut store2, &module)?;
+    let run = instance.get_typed_func::<(), i32>(&mut store2, "run")?;
+    assert_eq!(run.call(&mut store2, ())?, 1);
+    assert_eq!(*store2.data(), 1);
+
+    // Only functions can be defined lazily.
+    let module = Module::new(
+        store.engine(),
+        r#"(module (func (export "f")) (global (export "g") i32 (i32.const 0)))"#,
+    )?;
+    let mut linker = Linker::new(store.engine());
+    assert!(linker.module_lazy(&mut store, "module", &module).is_err());
+    linker.allow_unknown_exports(true);
+    linker.module_lazy(&mut store, "module", &module)?;
+    assert!(linker.get(&mut store, "module", "g").is_none());
+
+    Ok(())
+}
+
 #[test]
 #[cfg_attr(miri, ignore)]
 fn no_leak() -> Result<()> {
@@ -774,3 +878,57 @@ fn linker_defines_table_subtype_err() -> Result<()> {
 
     Ok(())
 }
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn instantiate_pre_specialized() -> Result<()> {
+    let engine = Engine::default();
+    let wat = r#"
+        (module
+            (import "env" "flag" (global $flag i32))
+            (import "env" "counter" (global $counter (mut i32)))
+            (func (export "run") (result i32)
+                (if (result i32) (global.get $flag)
+                    (then (i32.add (global.get $counter) (i32.const 100)))
+                    (else (global.get $counter))))
+        )
+    "#;
+    let store_with = |flag: i32| -> Result<(Store<()>, Linker<()>)> {
+        let mut store = Store::new(&engine, ());
+        let mut linker = Linker::new(&engine);
+        let ty = GlobalType::new(ValType::I32, Mutability::Const);
+        let g = Global::new(&mut store, ty, Val::I32(flag))?;
+        linker.define(&store, "env", "flag", g)?;
+        let ty = GlobalType::new(ValType::I32, Mutability::Var);
+        let g = Global::new(&mut store, ty, Val::I32(1))?;
+        linker.define(&store, "env", "counter", g)?;
+        Ok((store, linker))
+    };
+
+    let (mut store, linker) = store_with(1)?;
+    let pre = linker.instantiate_pre_specialized(&mut store, wat.as_bytes())?;
+    let instance = pre.instantiate(&mut store)?;
+    let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+    assert_eq!(run.call(&mut store, ())?, 101);
+
+    // The same values reuse the same compiled module.
+    let (mut store2, linker2) = store_with(1)?;
+    let pre2 = linker2.instantiate_pre_specialized(&mut store2, wat.as_bytes())?;
+    assert!(Module::same(pre.module(), pre2.module()));
+
+    // Different values get a different module, which can't be instantiated
+    // with the original values.
+    let (mut store3, linker3) = store_with(0)?;
+    let pre3 = linker3.instantiate_pre_specialized(&mut store3, wat.as_bytes())?;
+    assert!(!Module::same(pre.module(), pre3.module()));
+    let instance = pre3.instantiate(&mut store3)?;
+    let run = instance.get_typed_func::<(), i32>(&mut store3, "run")?;
+    assert_eq!(run.call(&mut store3, ())?, 1);
+
+    let e = linker.instantiate(&mut store, pre3.module()).unwrap_err();
+    assert_eq!(
+        e.to_string(),
+        "global import `env::flag` doesn't have the value that the module was specialized for"
+    );
+    Ok(())
+}
@@ -47,8 +47,12 @@ mod pooling_allocator;
 mod profiling;
 mod pulley;
 mod relocs;
+#[cfg(feature = "rr")]
+mod rr;
 mod stack_creator;
 mod stack_overflow;
+#[cfg(all(feature = "stack-switching", unix, target_arch = "x86_64"))]
+mod stack_switching;
 mod store;
 mod structs;
 mod table;
@@ -777,3 +777,618 @@ fn configure_zero(config: &mut Config) -> Result<()> {
 
     Ok(())
 }
+
+#[test]
+#[cfg(unix)]
+#[cfg_attr(miri, ignore)]
+fn map_file() -> Result<()> {
+    use std::io::{Read, Seek, Write};
+
+    const PAGE: usize = 1 << 16;
+    let mut file = tempfile::tempfile()?;
+    file.write_all(&vec![0xab_u8; 2 * PAGE])?;
+
+    for pooling in [false, true] {
+        let mut config = Config::new();
+        if pooling {
+            let mut pool = crate::small_pool_config();
+            pool.total_memories(1).max_memory_size(4 * PAGE);
+            config.allocation_strategy(InstanceAllocationStrategy::Pooling(pool));
+        }
+        let engine = Engine::new(&config)?;
+        let module = Module::new(
+            &engine,
+            r#"
+                (module
+                    (memory (export "memory") 3)
+                    (func (export "load") (param i32) (result i32)
+                        local.get 0
+                        i32.load8_u)
+                    (data (i32.const 0) "x"))
+            "#,
+        )?;
+
+        let mut store = Store::new(&engine, ());
+        let instance = Instance::new(&mut store, &module, &[])?;
+        let memory = instance.get_memory(&mut store, "memory").unwrap();
+        let load = instance.get_typed_func::<u32, u32>(&mut store, "load")?;
+
+        unsafe {
+            memory.map_file(&mut store, PAGE, &file, PAGE as u64, PAGE)?;
+            assert!(memory.map_file(&mut store, 1, &file, 0, PAGE).is_err());
+            assert!(
+                memory
+                    .map_file(&mut store, 2 * PAGE, &file, 0, 2 * PAGE)
+                    .is_err()
+            );
+            assert!(
+                memory
+                    .map_file(&mut store, 0, &file, PAGE as u64, 2 * PAGE)
+                    .is_err()
+            );
+        }
+        assert_eq!(load.call(&mut store, 0)?, u32::from(b'x'));
+        assert_eq!(load.call(&mut store, PAGE as u32)?, 0xab);
+        assert_eq!(load.call(&mut store, 2 * PAGE as u32 - 1)?, 0xab);
+        assert_eq!(load.call(&mut store, 2 * PAGE as u32)?, 0);
+
+        // Writes are private to the memory.
+        memory.data_mut(&mut store)[PAGE] = 1;
+        assert_eq!(load.call(&mut store, PAGE as u32)?, 1);
+        let mut contents = Vec::new();
+        file.rewind()?;
+        file.read_to_end(&mut contents)?;
+        assert!(contents.iter().all(|b| *b == 0xab));
+
+        // A reused slot doesn't see the file's contents.
+        drop(store);
+        let mut store = Store::new(&engine, ());
+        let instance = Instance::new(&mut store, &module, &[])?;
+        let load = instance.get_typed_func::<u32, u32>(&mut store, "load")?;
+        assert_eq!(load.call(&mut store, 0)?, u32::from(b'x'));
+        assert_eq!(load.call(&mut store, PAGE as u32)?, 0);
+        assert_eq!(load.call(&mut store, 2 * PAGE as u32 - 1)?, 0);
+    }
+
+    Ok(())
+}
+
+#[test]
+#[cfg(target_os = "linux")]
+#[cfg_attr(miri, ignore)]
+fn memory_from_source() -> Result<()> {
+    use std::io::Write;
+
+    const PAGE: usize = 1 << 16;
+    let data = MemorySource::from_data(&[0xab; PAGE + 1])?;
+    let mut file = tempfile::tempfile()?;
+    file.write_all(&[0xab; PAGE + 1])?;
+    let file = unsafe { MemorySource::from_file(&file)? };
+
+    let engine = Engine::default();
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (memory (import "" "weights") 2 2)
+                (func (export "load") (param i32) (result i32)
+                    local.get 0
+                    i32.load8_u)
+                (func (export "store") (param i32 i32)
+                    local.get 0
+                    local.get 1
+                    i32.store8)
+                (data (i32.const 1) "x"))
+        "#,
+    )?;
+
+    for source in [data, file] {
+        assert_eq!(source.len(), PAGE + 1);
+        let mut stores = Vec::new();
+        for _ in 0..2 {
+            let mut store = Store::new(&engine, ());
+            let memory = Memory::new_from_source(&mut store, MemoryType::new(2, Some(2)), &source)?;
+            let instance = Instance::new(&mut store, &module, &[memory.into()])?;
+            let load = instance.get_typed_func::<u32, u32>(&mut store, "load")?;
+            let store8 = instance.get_typed_func::<(u32, u32), ()>(&mut store, "store")?;
+            stores.push((store, load, store8));
+        }
+
+        // Writes are private to each memory.
+        let (store, _, store8) = &mut stores[0];
+        store8.call(&mut *store, (PAGE as u32, 1))?;
+        for (i, (store, load, _)) in stores.iter_mut().enumerate() {
+            assert_eq!(load.call(&mut *store, 0)?, 0xab);
+            assert_eq!(load.call(&mut *store, 1)?, u32::from(b'x'));
+            let expected = if i == 0 { 1 } else { 0xab };
+            assert_eq!(load.call(&mut *store, PAGE as u32)?, expected);
+            assert_eq!(load.call(&mut *store, PAGE as u32 + 1)?, 0);
+            assert_eq!(load.call(&mut *store, 2 * PAGE as u32 - 1)?, 0);
+        }
+        let mut store = Store::new(&engine, ());
+        let memory = Memory::new_from_source(&mut store, MemoryType::new(2, None), &source)?;
+        assert_eq!(memory.data(&store)[PAGE], 0xab);
+
+        // The source must fit within the memory's initial size.
+        assert!(Memory::new_from_source(&mut store, MemoryType::new(1, None), &source).is_err());
+    }
+
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn dirty_pages() -> Result<()> {
+    const PAGE: usize = 1 << 16;
+
+    for pooling in [false, true] {
+        let mut config = Config::new();
+        if pooling {
+            let mut pool = crate::small_pool_config();
+            pool.total_memories(1).max_memory_size(4 * PAGE);
+            config.allocation_strategy(InstanceAllocationStrategy::Pooling(pool));
+        }
+        let engine = Engine::new(&config)?;
+        let module = Module::new(
+            &engine,
+            r#"
+                (module
+                    (memory (export "memory") 3)
+                    (func (export "store") (param i32 i32)
+                        local.get 0
+                        local.get 1
+                        i32.store8)
+                    (func (export "load") (param i32) (result i32)
+                        local.get 0
+                        i32.load8_u)
+                    (data (i32.const 0) "x"))
+            "#,
+        )?;
+
+        let mut store = Store::new(&engine, ());
+        let instance = Instance::new(&mut store, &module, &[])?;
+        let memory = instance.get_memory(&mut store, "memory").unwrap();
+        let store8 = instance.get_typed_func::<(u32, u32), ()>(&mut store, "store")?;
+        let load = instance.get_typed_func::<u32, u32>(&mut store, "load")?;
+
+        if !PoolingAllocationConfig::is_pagemap_scan_available() {
+            assert!(memory.dirty_pages(&store).is_err());
+            assert!(memory.reset_dirty_to_image(&mut store).is_err());
+            continue;
+        }
+
+        // Reading memory doesn't dirty it.
+        assert_eq!(load.call(&mut store, 0)?, u32::from(b'x'));
+        assert_eq!(load.call(&mut store, PAGE as u32)?, 0);
+        assert!(memory.dirty_pages(&store)?.is_empty());
+
+        let written = [1, PAGE + 1, 3 * PAGE - 1];
+        for addr in written {
+            store8.call(&mut store, (addr as u32, 1))?;
+        }
+        let dirty = memory.dirty_pages(&store)?;
+        for addr in written {
+            assert!(dirty.iter().any(|range| range.contains(&addr)));
+        }
+        assert!(dirty.windows(2).all(|w| w[0].end < w[1].start));
+        assert!(dirty.last().unwrap().end <= 3 * PAGE);
+
+        memory.reset_dirty_to_image(&mut store)?;
+        assert!(memory.dirty_pages(&store)?.is_empty());
+        assert_eq!(load.call(&mut store, 0)?, u32::from(b'x'));
+        for addr in written {
+            assert_eq!(load.call(&mut store, addr as u32)?, 0);
+        }
+
+        // Outside of the pooling allocator host-created memories have no
+        // image to reset to.
+        if !pooling {
+            let host = Memory::new(&mut store, MemoryType::new(1, None))?;
+            host.data_mut(&mut store)[0] = 1;
+            assert!(!host.dirty_pages(&store)?.is_empty());
+            assert!(host.reset_dirty_to_image(&mut store).is_err());
+        }
+    }
+
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn discard() -> Result<()> {
+    const PAGE: usize = 1 << 16;
+
+    for pooling in [false, true] {
+        let mut config = Config::new();
+        if pooling {
+            let mut pool = crate::small_pool_config();
+            pool.total_memories(1).max_memory_size(4 * PAGE);
+            config.allocation_strategy(InstanceAllocationStrategy::Pooling(pool));
+        }
+        let engine = Engine::new(&config)?;
+        let module = Module::new(
+            &engine,
+            r#"
+                (module
+                    (memory (export "memory") 3)
+                    (data (i32.const 0) "x"))
+            "#,
+        )?;
+
+        let mut store = Store::new(&engine, ());
+        let instance = Instance::new(&mut store, &module, &[])?;
+        let memory = instance.get_memory(&mut store, "memory").unwrap();
+
+        // Discarded ranges read as zeros, including partial pages at either
+        // end, and the bytes around them are untouched.
+        memory.data_mut(&mut store).fill(0xff);
+        memory.discard(&mut store, 1, 2 * PAGE)?;
+        let data = memory.data(&store);
+        assert_eq!(data[0], 0xff);
+        assert!(data[1..2 * PAGE + 1].iter().all(|b| *b == 0));
+        assert!(data[2 * PAGE + 1..].iter().all(|b| *b == 0xff));
+
+        // Discarding the memory's image doesn't bring it back.
+        memory.discard(&mut store, 0, PAGE)?;
+        assert_eq!(memory.data(&store)[0], 0);
+
+        // Discarded memory can be written again.
+        memory.data_mut(&mut store)[PAGE] = 1;
+        assert_eq!(memory.data(&store)[PAGE], 1);
+
+        memory.discard(&mut store, 3 * PAGE, 0)?;
+        assert!(memory.discard(&mut store, 3 * PAGE - 1, 2).is_err());
+        assert!(memory.discard(&mut store, usize::MAX, 2).is_err());
+    }
+
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn hibernate() -> Result<()> {
+    const PAGE: usize = 1 << 16;
+
+    let engine = Engine::default();
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (memory (export "memory") 3)
+                (func (export "load") (param i32) (result i32)
+                    (i32.load8_u (local.get 0)))
+                (data (i32.const 0) "x"))
+        "#,
+    )?;
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let memory = instance.get_memory(&mut store, "memory").unwrap();
+    let load = instance.get_typed_func::<u32, u32>(&mut store, "load")?;
+    memory.data_mut(&mut store)[PAGE + 1] = 2;
+
+    // Only the first two pages aren't zero.
+    let saved = store.hibernate()?;
+    assert!(saved > 0 && saved <= 2 * PAGE);
+    assert!(store.is_hibernating());
+    assert!(store.hibernate().is_err());
+
+    // Calling into wasm resumes the store.
+    assert_eq!(load.call(&mut store, PAGE as u32 + 1)?, 2);
+    assert!(!store.is_hibernating());
+    assert_eq!(memory.data(&store)[0], b'x');
+
+    // So does accessing a memory mutably from the host.
+    store.hibernate()?;
+    assert_eq!(memory.data_mut(&mut store)[0], b'x');
+    assert!(!store.is_hibernating());
+
+    // Memory grown while hibernating is restored too.
+    store.hibernate()?;
+    memory.grow(&mut store, 1)?;
+    store.resume_from_hibernation()?;
+    assert_eq!(memory.data(&store)[0], b'x');
+    assert_eq!(memory.data(&store)[PAGE + 1], 2);
+    assert_eq!(memory.data_size(&store), 4 * PAGE);
+    store.resume_from_hibernation()?;
+
+    // A store can't hibernate while wasm is executing in it.
+    let module = Module::new(
+        &engine,
+        r#"(module (import "" "" (func $f)) (func (export "run") call $f))"#,
+    )?;
+    let hibernate = Func::wrap(&mut store, |mut caller: Caller<'_, ()>| {
+        assert!(caller.as_context_mut().hibernate().is_err());
+    });
+    let instance = Instance::new(&mut store, &module, &[hibernate.into()])?;
+    let run = instance.get_typed_func::<(), ()>(&mut store, "run")?;
+    run.call(&mut store, ())?;
+    assert!(!store.is_hibernating());
+
+    Ok(())
+}
+
+#[wasmtime_test]
+#[cfg_attr(miri, ignore)]
+fn memory_populate(config: &mut Config) -> Result<()> {
+    config.memory_populate(true);
+    let engine = Engine::new(&config)?;
+    let mut store = Store::new(&engine, ());
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (memory (export "memory") 1 4)
+                (func (export "store") (param i32 i32)
+                    local.get 0
+                    local.get 1
+                    i32.store8)
+                (data (i32.const 0) "x"))
+        "#,
+    )?;
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let memory = instance.get_memory(&mut store, "memory").unwrap();
+    let store8 = instance.get_typed_func::<(u32, u32), ()>(&mut store, "store")?;
+
+    assert_eq!(memory.data(&store)[0], b'x');
+    assert_eq!(memory.grow(&mut store, 1)?, 1);
+    assert_eq!(memory.grow_populated(&mut store, 1)?, 2);
+    memory.populate(&store);
+    assert!(memory.grow_populated(&mut store, 2).is_err());
+    assert_eq!(memory.size(&store), 3);
+
+    store8.call(&mut store, (3 << 16) - 1, 1)?;
+    let data = memory.data(&store);
+    assert_eq!(data[0], b'x');
+    assert!(data[1..(3 << 16) - 1].iter().all(|b| *b == 0));
+    assert_eq!(data[(3 << 16) - 1], 1);
+
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn huge_pages() -> Result<()> {
+    let mut config = Config::new();
+    config.memory_huge_pages(Enabled::Yes);
+    if !Config::are_huge_pages_available() {
+        assert!(Engine::new(&config).is_err());
+    }
+
+    config.memory_huge_pages(Enabled::Auto);
+    config.code_huge_pages(Enabled::Auto);
+    config.memory_populate(true);
+    let engine = Engine::new(&config)?;
+    let mut store = Store::new(&engine, ());
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (memory (export "memory") 64)
+                (func (export "store") (param i32 i32)
+                    local.get 0
+                    local.get 1
+                    i32.store)
+                (func (export "load") (param i32) (result i32)
+                    local.get 0
+                    i32.load))
+        "#,
+    )?;
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let memory = instance.get_memory(&mut store, "memory").unwrap();
+    let store32 = instance.get_typed_func::<(u32, u32), ()>(&mut store, "store")?;
+    let load = instance.get_typed_func::<u32, u32>(&mut store, "load")?;
+
+    memory.grow(&mut store, 64)?;
+    for addr in (0..128 << 16).step_by(1 << 20) {
+        store32.call(&mut store, (addr, addr))?;
+    }
+    for addr in (0..128 << 16).step_by(1 << 20) {
+        assert_eq!(load.call(&mut store, addr)?, addr);
+    }
+
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn memory64_index_masking() -> Result<()> {
+    if !cfg!(target_pointer_width = "64") {
+        return Ok(());
+    }
+    const RESERVATION: u64 = 1 << 20;
+    let wat = r#"
+        (module
+            (memory i64 1)
+            (func (export "store") (param i64 i32)
+                local.get 0
+                local.get 1
+                i32.store offset=4)
+            (func (export "load") (param i64) (result i32)
+                local.get 0
+                i32.load offset=4))
+    "#;
+
+    let mut config = Config::new();
+    config.wasm_memory64(true);
+    config.memory_reservation(RESERVATION);
+    config.memory_guard_size(1 << 16);
+    config.memory_may_move(false);
+    let engine = Engine::new(&config)?;
+    let (_, report) = CodeBuilder::new(&engine)
+        .wasm_binary_or_text(wat.as_bytes(), None)?
+        .compile_module_with_report()?;
+    assert_eq!(report.bounds_checks(), 2);
+    assert_eq!(report.bounds_checks_elided(), 0);
+
+    config.memory64_index_masking(true);
+    let engine = Engine::new(&config)?;
+    let (module, report) = CodeBuilder::new(&engine)
+        .wasm_binary_or_text(wat.as_bytes(), None)?
+        .compile_module_with_report()?;
+    assert_eq!(report.bounds_checks(), 0);
+    assert_eq!(report.bounds_checks_elided(), 2);
+
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let store32 = instance.get_typed_func::<(u64, u32), ()>(&mut store, "store")?;
+    let load = instance.get_typed_func::<u64, u32>(&mut store, "load")?;
+    store32.call(&mut store, (8, 42))?;
+    assert_eq!(load.call(&mut store, 8)?, 42);
+
+    // Accesses beyond the memory but within the reservation still trap.
+    let trap = load.call(&mut store, 1 << 16).unwrap_err();
+    assert_eq!(trap.downcast::<Trap>()?, Trap::MemoryOutOfBounds);
+
+    // Indices beyond the reservation wrap around instead of trapping.
+    assert_eq!(load.call(&mut store, RESERVATION + 8)?, 42);
+    assert_eq!(load.call(&mut store, u64::MAX - RESERVATION + 9)?, 42);
+
+    // Masking requires a fixed, power-of-two reservation.
+    config.memory_reservation(RESERVATION + (1 << 16));
+    assert!(Engine::new(&config).is_err());
+    config.memory_reservation(RESERVATION);
+    config.memory_may_move(true);
+    assert!(Engine::new(&config).is_err());
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn merged_bounds_checks() -> Result<()> {
+    let wat = r#"
+        (module
+            (memory 1)
+            (func (export "sum") (param i32) (result i32)
+                (i32.load offset=12 (local.get 0))
+                (i32.load (local.get 0))
+                i32.add
+                (i32.load offset=4 (local.get 0))
+                i32.add
+                (i32.load (i32.add (local.get 0) (i32.const 8)))
+                i32.add
+                ;; Not covered by the first check.
+                (i32.load offset=16 (local.get 0))
+                i32.add))
+    "#;
+
+    let mut config = Config::new();
+    config.signals_based_traps(false);
+    config.memory_reservation(0);
+    config.memory_guard_size(0);
+    let engine = Engine::new(&config)?;
+    let (module, report) = CodeBuilder::new(&engine)
+        .wasm_binary_or_text(wat.as_bytes(), None)?
+        .compile_module_with_report()?;
+    assert_eq!(report.bounds_checks(), 2);
+    assert_eq!(report.bounds_checks_elided(), 3);
+    assert_eq!(report.bounds_checks_merged(), 3);
+
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let sum = instance.get_typed_func::<u32, u32>(&mut store, "sum")?;
+    assert_eq!(sum.call(&mut store, 0)?, 0);
+    assert_eq!(sum.call(&mut store, 65536 - 20)?, 0);
+    for p in [65536 - 19, 65536 - 16, 65536 - 8, u32::MAX - 8] {
+        let trap = sum.call(&mut store, p).unwrap_err();
+        assert_eq!(trap.downcast::<Trap>()?, Trap::MemoryOutOfBounds);
+    }
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn memory_access_sampling() -> Result<()> {
+    let wat = r#"
+        (module
+            (memory (export "memory") 3)
+            (func (export "store") (param i32 i32)
+                local.get 0
+                local.get 1
+                i32.store offset=4)
+            (func (export "load") (param i32) (result i32)
+                local.get 0
+                i32.load))
+    "#;
+
+    let mut config = Config::new();
+    config.memory_access_sampling(1);
+    let engine = Engine::new(&config)?;
+    let module = Module::new(&engine, wat)?;
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let memory = instance.get_memory(&mut store, "memory").unwrap();
+    let store32 = instance.get_typed_func::<(u32, u32), ()>(&mut store, "store")?;
+    let load = instance.get_typed_func::<u32, u32>(&mut store, "load")?;
+    assert_eq!(memory.access_histogram(&store), [0, 0, 0]);
+
+    for i in 0..3 {
+        store32.call(&mut store, (i * 8, i))?;
+    }
+    // The offset of the access is included, placing this on the next page.
+    store32.call(&mut store, (65536 * 2 - 4, 0))?;
+    assert_eq!(load.call(&mut store, 16)?, 2);
+    assert!(load.call(&mut store, 65536 * 3).is_err());
+    assert_eq!(memory.access_histogram(&store), [4, 0, 1]);
+
+    memory.grow(&mut store, 1)?;
+    assert_eq!(memory.access_histogram(&store), [4, 0, 1, 0]);
+
+    // With a larger interval only some accesses are recorded.
+    config.memory_access_sampling(4);
+    let engine = Engine::new(&config)?;
+    let module = Module::new(&engine, wat)?;
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let memory = instance.get_memory(&mut store, "memory").unwrap();
+    let load = instance.get_typed_func::<u32, u32>(&mut store, "load")?;
+    for _ in 0..10 {
+        load.call(&mut store, 65536)?;
+    }
+    assert_eq!(memory.access_histogram(&store), [0, 2, 0]);
+
+    // Modules compiled without sampling never record accesses.
+    let engine = Engine::default();
+    let module = Module::new(&engine, wat)?;
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let memory = instance.get_memory(&mut store, "memory").unwrap();
+    let load = instance.get_typed_func::<u32, u32>(&mut store, "load")?;
+    load.call(&mut store, 0)?;
+    assert_eq!(memory.access_histogram(&store), [0, 0, 0]);
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn memory_growth_stats() -> Result<()> {
+    let grow_one_page_at_a_time = |geometric: bool| -> Result<MemoryGrowthStats> {
+        let mut config = Config::new();
+        config.memory_reservation(0);
+        config.memory_guard_size(0);
+        config.memory_reservation_for_growth(0);
+        config.memory_reservation_for_growth_geometric(geometric);
+        let engine = Engine::new(&config)?;
+        let mut store = Store::new(&engine, ());
+        let memory = Memory::new(&mut store, MemoryType::new(1, None))?;
+        memory.data_mut(&mut store)[0] = 1;
+        for _ in 0..100 {
+            memory.grow(&mut store, 1)?;
+        }
+        assert_eq!(memory.data(&store)[0], 1);
+        Ok(memory.growth_stats(&store))
+    };
+
+    // Without reserving ahead every growth moves the memory.
+    let stats = grow_one_page_at_a_time(false)?;
+    assert_eq!(stats.grows, 100);
+    assert_eq!(stats.moves, 100);
+    assert_eq!(stats.bytes_copied, (1..=100).sum::<u64>() * 65536);
+
+    // Reserving ahead geometrically only moves it a logarithmic number of
+    // times, copying less than twice its final size.
+    let stats = grow_one_page_at_a_time(true)?;
+    assert_eq!(stats.grows, 100);
+    assert!(stats.moves <= 8, "{stats:?}");
+    assert!(stats.bytes_copied < 2 * 101 * 65536, "{stats:?}");
+    Ok(())
+}
@@ -4,6 +4,7 @@ mod not_for_windows {
 
     use rustix::mm::{MapFlags, MprotectFlags, ProtFlags, mmap_anonymous, mprotect, munmap};
 
+    use std::any::Any;
     use std::ptr::null_mut;
     use std::sync::{Arc, Mutex};
 
@@ -45,6 +46,23 @@ mod not_for_windows {
                 glob_bytes_counter: glob_counter,
             }
         }
+
+        /// Zeroes this memory and shrinks it back to `minimum` bytes.
+        unsafe fn reset(&mut self, minimum: usize) {
+            assert!(minimum <= self.used_wasm_bytes);
+            unsafe {
+                std::ptr::write_bytes(self.mem as *mut u8, 0, self.used_wasm_bytes);
+                let start = (self.mem as *mut u8).add(minimum) as _;
+                mprotect(
+                    start,
+                    self.used_wasm_bytes - minimum,
+                    MprotectFlags::empty(),
+                )
+                .expect("mprotect failed");
+            }
+            *self.glob_bytes_counter.lock().unwrap() -= self.used_wasm_bytes - minimum;
+            self.used_wasm_bytes = minimum;
+        }
     }
 
     impl Drop for CustomMemory {
@@ -122,6 +140,45 @@ mod not_for_windows {
         }
     }
 
+    /// A creator which keeps memories on a free list once Wasmtime is done with
+    /// them, and resets them for reuse by later instances.
+    struct RecyclingMemoryCreator {
+        inner: CustomMemoryCreator,
+        free: Mutex<Vec<Box<CustomMemory>>>,
+    }
+
+    unsafe impl MemoryCreator for RecyclingMemoryCreator {
+        fn new_memory(
+            &self,
+            ty: MemoryType,
+            minimum: usize,
+            maximum: Option<usize>,
+            reserved_size: Option<usize>,
+            guard_size: usize,
+        ) -> Result<Box<dyn LinearMemory>, String> {
+            let mut free = self.free.lock().unwrap();
+            let capacity = maximum.unwrap_or(10 << 20);
+            let reusable = |m: &Box<CustomMemory>| {
+                m.used_wasm_bytes >= minimum && m.byte_capacity() >= capacity
+            };
+            match free.iter().position(reusable) {
+                Some(i) => {
+                    let mut mem = free.swap_remove(i);
+                    unsafe { mem.reset(minimum) };
+                    Ok(mem)
+                }
+                None => self
+                    .inner
+                    .new_memory(ty, minimum, maximum, reserved_size, guard_size),
+            }
+        }
+
+        fn reuse_memory(&self, memory: Box<dyn LinearMemory>) {
+            let memory: Box<dyn Any> = memory;
+            self.free.lock().unwrap().push(memory.downcast().unwrap());
+        }
+    }
+
     fn config() -> (Store<()>, Arc<CustomMemoryCreator>) {
         let mem_creator = Arc::new(CustomMemoryCreator::new());
         let mut config = Config::new();
@@ -190,4 +247,45 @@ mod not_for_windows {
 
         Ok(())
     }
+
+    #[test]
+    fn host_memory_reuse() -> wasmtime::Result<()> {
+        let mem_creator = Arc::new(RecyclingMemoryCreator {
+            inner: CustomMemoryCreator::new(),
+            free: Mutex::new(Vec::new()),
+        });
+        let mut config = Config::new();
+        config
+            .with_host_memory(mem_creator.clone())
+            .memory_reservation(0)
+            .memory_guard_size(0);
+        let engine = Engine::new(&config)?;
+        let module = Module::new(
+            &engine,
+            r#"
+            (module
+                (memory (export "memory") 1 2)
+                (func (export "dirty")
+                    (drop (memory.grow (i32.const 1)))
+                    (i32.store (i32.const 0) (i32.const 1))
+                    (i32.store (i32.const 70000) (i32.const 1)))
+            )
+        "#,
+        )?;
+
+        for _ in 0..3 {
+            let mut store = Store::new(&engine, ());
+            let instance = Instance::new(&mut store, &module, &[])?;
+            let memory = instance.get_memory(&mut store, "memory").unwrap();
+            assert_eq!(memory.size(&store), 1);
+            assert!(memory.data(&store).iter().all(|b| *b == 0));
+            let dirty = instance.get_typed_func::<(), ()>(&mut store, "dirty")?;
+            dirty.call(&mut store, ())?;
+        }
+
+        assert_eq!(*mem_creator.inner.num_created_memories.lock().unwrap(), 1);
+        assert_eq!(mem_creator.free.lock().unwrap().len(), 1);
+
+        Ok(())
+    }
 }
@@ -264,6 +264,289 @@ fn large_add_chain_no_stack_overflow() -> Result<()> {
     Ok(())
 }
 
+#[test]
+#[cfg_attr(miri, ignore)]
+fn tiered_compilation() -> Result<()> {
+    let mut config = Config::new();
+    config.tiered_compilation(true);
+    let engine = Engine::new(&config)?;
+    let module = Module::new(
+        &engine,
+        r#"(module (func (export "f") (result i32) (i32.add (i32.const 1) (i32.const 2))))"#,
+    )?;
+
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let f = instance.get_typed_func::<(), i32>(&mut store, "f")?;
+    assert_eq!(f.call(&mut store, ())?, 3);
+
+    // Once the optimized tier is ready new instances use it, but they're still
+    // instances of the original module.
+    let optimized = module.wait_optimized_tier()?;
+    assert!(optimized.optimized_tier().is_none());
+    assert!(module.optimized_tier().is_some());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    assert!(Module::same(instance.module(&store), &module));
+    let f = instance.get_typed_func::<(), i32>(&mut store, "f")?;
+    assert_eq!(f.call(&mut store, ())?, 3);
+    let export = module.get_export_index("f").unwrap();
+    let f = instance
+        .get_module_export(&mut store, &export)
+        .and_then(|f| f.into_func())
+        .unwrap();
+    assert_eq!(f.typed::<(), i32>(&store)?.call(&mut store, ())?, 3);
+
+    // Tiering is only supported with Cranelift.
+    if cfg!(target_arch = "x86_64") {
+        config.strategy(Strategy::Winch);
+        assert!(Engine::new(&config).is_err());
+    }
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn compile_report() -> Result<()> {
+    let engine = Engine::default();
+    let (module, report) = CodeBuilder::new(&engine)
+        .wasm_binary_or_text(
+            br#"
+                (module
+                    (import "" "" (func))
+                    (func $small (export "small") (result i32) i32.const 1)
+                    (func (export "big") (param i32) (result i32)
+                        (i32.add (local.get 0) (i32.mul (local.get 0) (local.get 0))))
+                )
+            "#,
+            None,
+        )?
+        .compile_module_with_report()?;
+
+    let functions = report.functions();
+    assert_eq!(functions.len(), 2);
+    assert_eq!(functions[0].index(), 1);
+    assert_eq!(functions[0].name(), Some("small"));
+    assert_eq!(functions[1].index(), 2);
+    assert_eq!(functions[1].name(), None);
+    for f in functions {
+        let stats = f.stats();
+        assert!(stats.code_size > 0);
+        assert!(stats.total_time >= stats.translation_time);
+    }
+    assert!(report.code_size() >= functions[0].stats().code_size);
+
+    let mut store = Store::new(&engine, ());
+    let import = Func::wrap(&mut store, || {});
+    let instance = Instance::new(&mut store, &module, &[import.into()])?;
+    let big = instance.get_typed_func::<i32, i32>(&mut store, "big")?;
+    assert_eq!(big.call(&mut store, 3)?, 12);
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn compile_deadline() -> Result<()> {
+    let wat = r#"(module (func (export "f") (result i32) i32.const 1))"#;
+
+    let mut config = Config::new();
+    config.compile_deadline(Duration::ZERO);
+    let engine = Engine::new(&config)?;
+    let err = Module::new(&engine, wat).unwrap_err();
+    assert!(err.is::<CompileDeadlineExceeded>(), "{err:?}");
+    let exceeded = err.downcast_ref::<CompileDeadlineExceeded>().unwrap();
+    assert_eq!(exceeded.deadline(), Duration::ZERO);
+
+    // Modules without any functions have nothing to compile.
+    Module::new(&engine, "(module)")?;
+
+    config.compile_deadline(Duration::from_secs(3600));
+    let engine = Engine::new(&config)?;
+    Module::new(&engine, wat)?;
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn lazy_module() -> Result<()> {
+    let engine = Engine::default();
+    let wat = r#"(module (func (export "f") (result i32) i32.const 7))"#;
+
+    assert!(LazyModule::new(&engine, "(module (func (result i32)))").is_err());
+
+    let lazy = LazyModule::new(&engine, wat)?;
+    assert!(!lazy.is_compiled());
+    let module = lazy.get()?;
+    assert!(lazy.is_compiled());
+    assert!(Module::same(&module, &lazy.clone().get()?));
+
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let f = instance.get_typed_func::<(), i32>(&mut store, "f")?;
+    assert_eq!(f.call(&mut store, ())?, 7);
+
+    // Warming compiles in the background, and `get` waits for that rather
+    // than compiling again.
+    let lazy = LazyModule::new(&engine, wat)?;
+    lazy.warm();
+    let module = lazy.get()?;
+    lazy.warm();
+    assert!(Module::same(&module, &lazy.get()?));
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn module_builder() -> Result<()> {
+    let engine = Engine::default();
+    let wasm = wat::parse_str(
+        r#"(module
+            (memory 1)
+            (func (export "f") (result i32) i32.const 7)
+            (data (i32.const 0) "hello"))"#,
+    )?;
+
+    // Feeding a byte at a time works.
+    let mut builder = ModuleBuilder::new(&engine);
+    for byte in wasm.iter() {
+        builder.feed(std::slice::from_ref(byte))?;
+    }
+    let module = builder.finish()?;
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let f = instance.get_typed_func::<(), i32>(&mut store, "f")?;
+    assert_eq!(f.call(&mut store, ())?, 7);
+
+    // Truncated input is an error.
+    let mut builder = ModuleBuilder::new(&engine);
+    builder.feed(&wasm[..wasm.len() - 1])?;
+    assert!(builder.finish().is_err());
+
+    // Trailing input is an error.
+    let mut builder = ModuleBuilder::new(&engine);
+    builder.feed(&wasm)?;
+    assert!(builder.feed(&[0]).is_err());
+
+    // Malformed modules are rejected before the end of the input.
+    let mut builder = ModuleBuilder::new(&engine);
+    assert!(builder.feed(b"\0asm\x02\0\0\0").is_err());
+
+    // Invalid function bodies are rejected once, when compiling.
+    let invalid = wat::parse_str(
+        r#"(module
+            (func (result i32))
+            (data "hello"))"#,
+    )?;
+    let mut builder = ModuleBuilder::new(&engine);
+    builder.feed(&invalid)?;
+    let err = builder.finish().unwrap_err();
+    assert!(
+        format!("{err:?}").contains("type mismatch"),
+        "bad error: {err:?}"
+    );
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn serialize_to_writer() -> Result<()> {
+    let engine = Engine::default();
+    let module = Module::new(&engine, "(module (func))")?;
+    let mut written = Vec::new();
+    module.serialize_to(&mut written)?;
+    assert_eq!(written, module.serialize()?);
+    unsafe {
+        Module::deserialize(&engine, &written)?;
+    }
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn precompile_modules_batch() -> Result<()> {
+    let engine = Engine::default();
+    let a = wat::parse_str(r#"(module (func (export "a")))"#)?;
+    let b = wat::parse_str(r#"(module (func (export "b")))"#)?;
+    let artifacts = engine.precompile_modules(&[&a, &b, &a])?;
+    assert_eq!(artifacts.len(), 3);
+    assert_eq!(artifacts[0], artifacts[2]);
+    assert_eq!(artifacts[0], engine.precompile_module(&a)?);
+    assert_eq!(artifacts[1], engine.precompile_module(&b)?);
+
+    let err = engine.precompile_modules(&[&a, b"garbage"]).unwrap_err();
+    assert!(
+        format!("{err:?}").contains("failed to compile module 1"),
+        "bad error: {err:?}"
+    );
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn inspect_serialized() -> Result<()> {
+    let engine = Engine::default();
+    let module = Module::new(
+        &engine,
+        "(module (func) (memory 1) (data (i32.const 0) \"abc\"))",
+    )?;
+    let serialized = module.serialize()?;
+
+    let info = Module::inspect_serialized(&engine, &serialized)?;
+    assert!(info.is_compatible());
+    assert!(info.incompatibility().is_none());
+    assert_eq!(info.image_size(), serialized.len());
+    assert!(info.text_size() > 0);
+    assert!(info.wasm_data_size() >= 3);
+
+    let mut config = Config::new();
+    config.memory_reservation(1 << 20);
+    let other = Engine::new(&config)?;
+    let info = Module::inspect_serialized(&other, &serialized)?;
+    assert!(!info.is_compatible());
+    let msg = info.incompatibility().unwrap();
+    assert!(msg.contains("memory reservation"), "bad message: {msg}");
+
+    assert!(Module::inspect_serialized(&engine, b"garbage").is_err());
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn resource_estimate() -> Result<()> {
+    let engine = Engine::default();
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (import "" "m" (memory 100))
+                (memory 2)
+                (memory 3)
+                (table 10 funcref)
+                (func)
+                (data (memory 1) (i32.const 0) "abc"))
+        "#,
+    )?;
+    let estimate = module.resource_estimate();
+    let image = module.image_range();
+    assert_eq!(
+        estimate.code_bytes(),
+        image.end as usize - image.start as usize
+    );
+    assert!(estimate.text_bytes() > 0);
+    assert!(estimate.text_bytes() < estimate.code_bytes());
+    assert!(estimate.data_bytes() >= 3);
+    assert_eq!(estimate.memories(), 2);
+    assert_eq!(estimate.min_memory_bytes(), 5 * 65536);
+    assert_eq!(estimate.tables(), 1);
+    assert_eq!(estimate.min_table_elements(), 10);
+    assert!(estimate.instance_bytes() > 0);
+
+    let empty = Module::new(&engine, "(module)")?.resource_estimate();
+    assert_eq!(empty.memories(), 0);
+    assert_eq!(empty.data_bytes(), 0);
+    assert!(empty.instance_bytes() < estimate.instance_bytes());
+    Ok(())
+}
+
 #[test]
 fn compile_a_component() -> Result<()> {
     let engine = Engine::default();
@@ -619,6 +902,53 @@ fn deserialize_raw_avoids_copy() {
     assert_eq!(f.call(&mut store, (26, 50)).unwrap(), 76);
 }
 
+#[test]
+#[cfg_attr(miri, ignore)]
+fn deserialize_raw_with_owner_releases_memory() {
+    struct Release(Arc<AtomicBool>);
+
+    impl Drop for Release {
+        fn drop(&mut self) {
+            self.0.store(true, Relaxed);
+        }
+    }
+
+    let mut config = Config::new();
+    let target = format!("{}", Triple::pulley_host());
+    config.target(&target).unwrap();
+    let engine = Engine::new(&config).unwrap();
+    let module = Module::new(&engine, r#"(module (func (export "f")))"#).unwrap();
+    let serialized = Box::into_raw(module.serialize().unwrap().into_boxed_slice());
+    let module_memory = std::ptr::NonNull::new(serialized).unwrap();
+
+    let released = Arc::new(AtomicBool::new(false));
+    let owner = Release(released.clone());
+    let module =
+        unsafe { Module::deserialize_raw_with_owner(&engine, module_memory, owner).unwrap() };
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[]).unwrap();
+    drop(module);
+    assert!(!released.load(Relaxed));
+    instance
+        .get_typed_func::<(), ()>(&mut store, "f")
+        .unwrap()
+        .call(&mut store, ())
+        .unwrap();
+    drop(store);
+    assert!(released.load(Relaxed));
+
+    // SAFETY: the module, and everything using it, is gone.
+    drop(unsafe { Box::from_raw(serialized) });
+
+    // The owner is also dropped if deserialization fails.
+    let released = Arc::new(AtomicBool::new(false));
+    let mut garbage = vec![0; 16];
+    let memory = std::ptr::NonNull::from(&mut garbage[..]);
+    let owner = Release(released.clone());
+    assert!(unsafe { Module::deserialize_raw_with_owner(&engine, memory, owner) }.is_err());
+    assert!(released.load(Relaxed));
+}
+
 #[test]
 #[cfg_attr(miri, ignore)]
 fn deserialize_raw_fails_for_native() {
@@ -649,3 +979,27 @@ fn deserialize_raw_fails_for_native() {
         );
     }
 }
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn compile_cached_shares_identical_modules() -> Result<()> {
+    let engine = Engine::default();
+    let a = engine.compile_cached(b"(module (func (export \"f\")))")?;
+    let b = engine.compile_cached(b"(module (func (export \"f\")))")?;
+    assert!(Module::same(&a, &b));
+
+    // Different bytes, or a different engine, get their own module.
+    let c = engine.compile_cached(b"(module (func (export \"g\")))")?;
+    assert!(!Module::same(&a, &c));
+    let d = Engine::default().compile_cached(b"(module (func (export \"f\")))")?;
+    assert!(!Module::same(&a, &d));
+
+    // Once every user has dropped the module it can still be compiled again.
+    drop((a, b));
+    engine.compile_cached(b"(module (func (export \"f\")))")?;
+
+    // Errors aren't cached.
+    assert!(engine.compile_cached(b"(module").is_err());
+    assert!(engine.compile_cached(b"(module").is_err());
+    Ok(())
+}
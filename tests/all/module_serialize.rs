@@ -125,6 +125,35 @@ fn test_deserialize_from_file() -> Result<()> {
     }
 }
 
+#[test]
+#[cfg_attr(miri, ignore)]
+fn deserialize_files() -> Result<()> {
+    let engine = Engine::default();
+    let td = tempfile::TempDir::new()?;
+    let mut paths = Vec::new();
+    for i in 0..10 {
+        let wat = format!("(module (func (export \"run\") (result i32) i32.const {i}))");
+        let path = td.path().join(format!("module{i}.bin"));
+        fs::write(&path, serialize(&engine, &wat)?)?;
+        paths.push(path);
+    }
+
+    let modules = unsafe { Module::deserialize_files(&engine, &paths)? };
+    assert_eq!(modules.len(), paths.len());
+    let mut store = Store::new(&engine, ());
+    for (i, module) in modules.iter().enumerate() {
+        let instance = Instance::new(&mut store, module, &[])?;
+        let func = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+        assert_eq!(func.call(&mut store, ())?, i32::try_from(i)?);
+    }
+
+    // One missing file fails the whole batch.
+    paths.push(td.path().join("missing.bin"));
+    assert!(unsafe { Module::deserialize_files(&engine, &paths) }.is_err());
+
+    Ok(())
+}
+
 #[test]
 #[cfg_attr(miri, ignore)]
 fn deserialize_from_serialized() -> Result<()> {
@@ -154,3 +183,179 @@ fn detect_precompiled() -> Result<()> {
     );
     Ok(())
 }
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn shared_code_registry() -> Result<()> {
+    let engine = Engine::default();
+    let td = tempfile::TempDir::new()?;
+    let registry = SharedCodeRegistry::new(td.path().join("code"))?;
+    let buffer = serialize(
+        &engine,
+        "(module (func (export \"run\") (result i32) i32.const 42))",
+    )?;
+
+    let call = |module: &Module| -> Result<i32> {
+        let mut store = Store::new(&engine, ());
+        let instance = Instance::new(&mut store, module, &[])?;
+        let func = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+        func.call(&mut store, ())
+    };
+
+    // Both loads of the same artifact are served by a single file.
+    let module1 = unsafe { registry.deserialize(&engine, &buffer)? };
+    let module2 = unsafe { registry.deserialize(&engine, &buffer)? };
+    assert_eq!(call(&module1)?, 42);
+    assert_eq!(call(&module2)?, 42);
+    let files = fs::read_dir(registry.directory())?.collect::<Result<Vec<_>, _>>()?;
+    assert_eq!(files.len(), 1);
+    drop((module1, module2));
+
+    // If the file doesn't hold the artifact then a private copy is used.
+    fs::write(files[0].path(), b"not the artifact")?;
+    let module = unsafe { registry.deserialize(&engine, &buffer)? };
+    assert_eq!(call(&module)?, 42);
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn deserialize_file_memory_image() -> Result<()> {
+    let mut config = Config::new();
+    config.memory_init_cow(true);
+    let engine = Engine::new(&config)?;
+    let buffer = serialize(
+        &engine,
+        r#"
+            (module
+                (memory (export "memory") 1)
+                (data (i32.const 0x1000) "hello"))
+        "#,
+    )?;
+    let td = tempfile::TempDir::new()?;
+    let path = td.path().join("module.cwasm");
+    fs::write(&path, &buffer)?;
+    let module = unsafe { Module::deserialize_file(&engine, &path)? };
+    module.initialize_copy_on_write_image()?;
+
+    // Writes to one instance's memory are private to it, and don't reach the
+    // file the initial image is mapped from.
+    let mut store = Store::new(&engine, ());
+    let memory1 = Instance::new(&mut store, &module, &[])?
+        .get_memory(&mut store, "memory")
+        .unwrap();
+    let memory2 = Instance::new(&mut store, &module, &[])?
+        .get_memory(&mut store, "memory")
+        .unwrap();
+    assert_eq!(&memory1.data(&store)[0x1000..0x1005], b"hello");
+    memory1.data_mut(&mut store)[0x1000..0x1005].copy_from_slice(b"world");
+    assert_eq!(&memory1.data(&store)[0x1000..0x1005], b"world");
+    assert_eq!(&memory2.data(&store)[0x1000..0x1005], b"hello");
+    drop(store);
+    assert_eq!(fs::read(&path)?, buffer);
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn compressed_artifacts() -> Result<()> {
+    let engine = Engine::default();
+    let buffer = serialize(
+        &engine,
+        r#"
+            (module
+                (memory (export "memory") 1)
+                (func (export "run") (result i32) i32.const 42)
+                (data (i32.const 0x1000) "hello"))
+        "#,
+    )?;
+    let compressed = engine.compress_precompiled(&buffer, 3)?;
+    assert_eq!(
+        Engine::detect_precompiled(&compressed),
+        Some(Precompiled::Module)
+    );
+    let info = Module::inspect_serialized(&engine, &compressed)?;
+    assert!(info.is_compatible());
+    assert_eq!(info.image_size(), buffer.len());
+
+    let td = tempfile::TempDir::new()?;
+    let path = td.path().join("module.cwasm");
+    fs::write(&path, &compressed)?;
+    assert_eq!(
+        Engine::detect_precompiled_file(&path)?,
+        Some(Precompiled::Module)
+    );
+
+    let mut store = Store::new(&engine, ());
+    for module in [
+        unsafe { Module::deserialize(&engine, &compressed)? },
+        unsafe { Module::deserialize_file(&engine, &path)? },
+    ] {
+        assert_eq!(module.serialize()?, buffer);
+        let instance = Instance::new(&mut store, &module, &[])?;
+        let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+        assert_eq!(run.call(&mut store, ())?, 42);
+        let memory = instance.get_memory(&mut store, "memory").unwrap();
+        assert_eq!(&memory.data(&store)[0x1000..0x1005], b"hello");
+    }
+
+    // Truncated artifacts are rejected rather than partially loaded.
+    let truncated = &compressed[..compressed.len() - 1];
+    assert!(unsafe { Module::deserialize(&engine, truncated) }.is_err());
+    assert!(engine.compress_precompiled(&compressed, 3).is_err());
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn multi_target_artifacts() -> Result<()> {
+    let wat = "(module (func (export \"run\") (result i32) i32.const 42))";
+    let engine = Engine::default();
+    let native = serialize(&engine, wat)?;
+    let mut config = Config::new();
+    config.consume_fuel(true);
+    let fuel_engine = Engine::new(&config)?;
+    let fuel = serialize(&fuel_engine, wat)?;
+
+    let bundle = Engine::bundle_precompiled(&[&fuel, &native])?;
+    assert_eq!(
+        Engine::detect_precompiled(&bundle),
+        Some(Precompiled::Module)
+    );
+    let td = tempfile::TempDir::new()?;
+    let path = td.path().join("module.cwasm");
+    fs::write(&path, &bundle)?;
+    assert_eq!(
+        Engine::detect_precompiled_file(&path)?,
+        Some(Precompiled::Module)
+    );
+    assert!(Module::inspect_serialized(&engine, &bundle)?.is_compatible());
+
+    // Each engine picks the variant that it's compatible with.
+    for (engine, expected) in [(&engine, &native), (&fuel_engine, &fuel)] {
+        let modules = unsafe {
+            [
+                Module::deserialize(engine, &bundle)?,
+                Module::deserialize_file(engine, &path)?,
+            ]
+        };
+        for module in modules {
+            assert_eq!(&module.serialize()?, expected);
+            let mut store = Store::new(engine, ());
+            store.set_fuel(1000).ok();
+            let instance = Instance::new(&mut store, &module, &[])?;
+            let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+            assert_eq!(run.call(&mut store, ())?, 42);
+        }
+    }
+
+    // Without a compatible variant loading fails with the reason of each.
+    let bundle = Engine::bundle_precompiled(&[&fuel])?;
+    let err = unsafe { Module::deserialize(&engine, &bundle) }.unwrap_err();
+    assert!(format!("{err:?}").contains("variant 0"), "{err:?}");
+    assert!(!Module::inspect_serialized(&engine, &bundle)?.is_compatible());
+
+    assert!(Engine::bundle_precompiled(&[]).is_err());
+    assert!(Engine::bundle_precompiled(&[&native, b"not an artifact"]).is_err());
+    Ok(())
+}
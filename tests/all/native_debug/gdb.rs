@@ -82,3 +82,38 @@ check: exited normally
     )?;
     Ok(())
 }
+
+#[test]
+#[ignore]
+fn test_debug_dwarf_gdb_lazy() -> Result<()> {
+    // The process is started under gdb, so lazily registered debug
+    // information is registered as soon as code is loaded.
+    let output = gdb_with_script(
+        &[
+            "-Ccache=n",
+            "-Ddebug-info",
+            "-Ddebug-info-lazy",
+            "-Oopt-level=0",
+            "--invoke",
+            "fib",
+            test_programs_artifacts::DWARF_FIB_WASM,
+            "3",
+        ],
+        r#"set breakpoint pending on
+b fib
+r
+info locals
+c"#,
+    )?;
+
+    check_gdb_output(
+        &output,
+        r#"
+check: Breakpoint 1 (fib) pending
+check: hit Breakpoint 1
+sameln: fib (n=3)
+check: exited normally
+"#,
+    )?;
+    Ok(())
+}
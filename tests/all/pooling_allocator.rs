@@ -233,6 +233,121 @@ fn memory_zeroed() -> Result<()> {
     Ok(())
 }
 
+#[test]
+#[cfg_attr(miri, ignore)]
+fn background_decommit() -> Result<()> {
+    if skip_pooling_allocator_tests() {
+        return Ok(());
+    }
+
+    let mut pool = crate::small_pool_config();
+    pool.total_core_instances(1)
+        .linear_memory_keep_resident(4096)
+        .background_decommit(true);
+    let mut config = Config::new();
+    config.allocation_strategy(pool);
+    config.memory_guard_size(0);
+    config.memory_reservation(1 << 16);
+
+    let engine = Engine::new(&config)?;
+
+    let module = Module::new(
+        &engine,
+        r#"(module (memory (export "m") 1) (table 1 funcref))"#,
+    )?;
+
+    // With only one slot of each kind, every instantiation after the first
+    // must wait for the previous store's slots to be reset in the background.
+    for _ in 0..10 {
+        let mut store = Store::new(&engine, ());
+        let instance = Instance::new(&mut store, &module, &[])?;
+        let memory = instance.get_memory(&mut store, "m").unwrap();
+
+        let data = memory.data_mut(&mut store);
+        assert!(data.iter().all(|b| *b == 0));
+        data.fill(0xFE);
+    }
+
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn numa_placement() -> Result<()> {
+    if skip_pooling_allocator_tests() {
+        return Ok(());
+    }
+
+    let mut pool = crate::small_pool_config();
+    pool.total_core_instances(1)
+        .linear_memory_keep_resident(4096)
+        .numa_local_memory(true);
+    let mut config = Config::new();
+    config.allocation_strategy(pool);
+    config.memory_guard_size(0);
+    config.memory_reservation(1 << 16);
+
+    let engine = Engine::new(&config)?;
+    let plain = Module::new(&engine, r#"(module (memory (export "m") 1))"#)?;
+    // A module with an image, which is mapped over part of the slot when it
+    // changes.
+    let imaged = Module::new(
+        &engine,
+        r#"(module (memory (export "m") 1) (data (i32.const 0) "x"))"#,
+    )?;
+
+    // Placing memory on the thread's node, an explicit node, or the default
+    // node must all leave slots in working order when they're reused.
+    for node in [None, Some(0), None, Some(0)] {
+        for (module, first) in [(&plain, 0), (&imaged, b'x'), (&plain, 0)] {
+            let mut store = Store::new(&engine, ());
+            store.set_numa_node(node);
+            assert_eq!(store.numa_node(), node);
+            let instance = Instance::new(&mut store, module, &[])?;
+            let memory = instance.get_memory(&mut store, "m").unwrap();
+
+            // Either way the memory prefers a node, the explicit one if set,
+            // which is checked where the kernel lets the policy be queried.
+            #[cfg(target_os = "linux")]
+            if let Some((mode, mask)) = numa_policy(memory.data_ptr(&store)) {
+                const MPOL_PREFERRED: libc::c_int = 1;
+                assert_eq!(mode, MPOL_PREFERRED);
+                if node == Some(0) {
+                    assert_eq!(mask, 1);
+                }
+            }
+
+            let data = memory.data_mut(&mut store);
+            assert_eq!(data[0], first);
+            assert!(data[1..].iter().all(|b| *b == 0));
+            data.fill(0xFE);
+        }
+    }
+
+    Ok(())
+}
+
+/// Returns the memory policy mode of the page at `addr` and the first word of
+/// its node mask, or `None` if the kernel doesn't let them be queried.
+#[cfg(target_os = "linux")]
+fn numa_policy(addr: *mut u8) -> Option<(libc::c_int, libc::c_ulong)> {
+    const MPOL_F_ADDR: libc::c_ulong = 1 << 1;
+    const MASK_WORDS: usize = 1024 / libc::c_ulong::BITS as usize;
+    let mut mode: libc::c_int = 0;
+    let mut mask: [libc::c_ulong; MASK_WORDS] = [0; MASK_WORDS];
+    let rc = unsafe {
+        libc::syscall(
+            libc::SYS_get_mempolicy,
+            &raw mut mode,
+            mask.as_mut_ptr(),
+            MASK_WORDS * libc::c_ulong::BITS as usize,
+            addr,
+            MPOL_F_ADDR,
+        )
+    };
+    if rc == 0 { Some((mode, mask[0])) } else { None }
+}
+
 #[test]
 #[cfg_attr(miri, ignore)]
 fn table_limit() -> Result<()> {
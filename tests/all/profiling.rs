@@ -1,5 +1,7 @@
+use std::sync::{Arc, Mutex};
+use std::time::Duration;
 use wasmtime::component::Component;
-use wasmtime::{Config, Engine, Module, Result};
+use wasmtime::*;
 
 #[test]
 #[cfg_attr(miri, ignore)]
@@ -22,3 +24,68 @@ fn perfmap() -> Result<()> {
 
     Ok(())
 }
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn aggregate_guest_profiler() -> Result<()> {
+    let mut config = Config::new();
+    config.epoch_interruption(true);
+    let engine = Engine::new(&config)?;
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (import "" "tick" (func $tick))
+                (func $inner
+                    call $tick
+                    (loop $l))
+                (func $run (export "run")
+                    call $inner
+                    call $inner))
+        "#,
+    )?;
+
+    // The first profiler has room for one stack, the second for none.
+    let profilers = [1, 0].map(|max_stacks| {
+        let profiler = AggregateGuestProfiler::new(
+            &engine,
+            Duration::from_millis(1),
+            max_stacks,
+            [("guest".to_string(), module.clone())],
+        );
+        Arc::new(Mutex::new(profiler.unwrap()))
+    });
+
+    for profiler in &profilers {
+        let mut store = Store::new(&engine, ());
+        let profiler = profiler.clone();
+        store.set_epoch_deadline(1);
+        store.epoch_deadline_callback(move |cx| {
+            profiler.lock().unwrap().sample(&cx, Duration::ZERO);
+            Ok(UpdateDeadline::Continue(1))
+        });
+        let tick = Func::wrap(&mut store, |caller: Caller<'_, ()>| {
+            caller.engine().increment_epoch();
+        });
+        let instance = Instance::new(&mut store, &module, &[tick.into()])?;
+        let run = instance.get_typed_func::<(), ()>(&mut store, "run")?;
+        run.call(&mut store, ())?;
+    }
+
+    // Both samples are taken at the loop in `$inner`, so they have the same
+    // stack.
+    let mut profiler = profilers[0].lock().unwrap();
+    assert_eq!(profiler.stacks(), 1);
+    let mut collapsed = Vec::new();
+    profiler.flush(ProfileFormat::Collapsed, &mut collapsed)?;
+    assert_eq!(String::from_utf8(collapsed)?, "guest!run;guest!inner 2\n");
+    assert_eq!(profiler.stacks(), 0);
+
+    let mut profiler = profilers[1].lock().unwrap();
+    assert_eq!(profiler.stacks(), 0);
+    let mut pprof = Vec::new();
+    profiler.flush(ProfileFormat::Pprof, &mut pprof)?;
+    assert!(pprof.windows(11).any(|w| w == b"[truncated]"));
+
+    Ok(())
+}
@@ -0,0 +1,117 @@
+use std::io::{Cursor, Write};
+use std::sync::{Arc, Mutex};
+use wasmtime::*;
+
+const WAT: &str = r#"
+    (module
+        (import "host" "read" (func $read (param i32) (result i32)))
+        (memory (export "memory") 1)
+        (func (export "run") (result i32)
+            (local $n i32)
+            (local $sum i32)
+            (local.set $n (call $read (i32.const 100)))
+            (loop $l
+                (if (local.get $n)
+                    (then
+                        (local.set $n (i32.sub (local.get $n) (i32.const 1)))
+                        (local.set $sum
+                            (i32.add
+                                (local.get $sum)
+                                (i32.load8_u offset=100 (local.get $n))))
+                        (br $l))))
+            (local.get $sum))
+    )
+"#;
+
+/// A log which can still be read once the store recording to it is dropped.
+#[derive(Clone, Default)]
+struct SharedLog(Arc<Mutex<Vec<u8>>>);
+
+impl Write for SharedLog {
+    fn write(&mut self, buf: &[u8]) -> std::io::Result<usize> {
+        self.0.lock().unwrap().write(buf)
+    }
+
+    fn flush(&mut self) -> std::io::Result<()> {
+        Ok(())
+    }
+}
+
+fn engine(rr: RRConfig) -> Result<Engine> {
+    let mut config = Config::new();
+    config.rr(rr);
+    Engine::new(&config)
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn replay_host_calls() -> Result<()> {
+    let engine = engine(RRConfig::Recording)?;
+    let module = Module::new(&engine, WAT)?;
+    let log = SharedLog::default();
+    let mut store = Store::new(&engine, ());
+    store.record_host_calls(log.clone())?;
+    let read = Func::wrap(&mut store, |mut caller: Caller<'_, ()>, ptr: u32| {
+        let memory = caller.get_export("memory").unwrap().into_memory().unwrap();
+        memory.write(&mut caller, ptr as usize, &[1, 2, 3, 4])?;
+        Ok(4)
+    });
+    let instance = Instance::new(&mut store, &module, &[read.into()])?;
+    let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+    assert_eq!(run.call(&mut store, ())?, 10);
+    store.stop_host_call_log()?;
+
+    let engine = engine(RRConfig::Replaying)?;
+    let module = Module::new(&engine, WAT)?;
+    let mut store = Store::new(&engine, ());
+    let log = log.0.lock().unwrap().clone();
+    store.replay_host_calls(Cursor::new(log))?;
+    let read = Func::wrap(&mut store, |_: u32| -> i32 {
+        panic!("host functions aren't called while replaying")
+    });
+    let instance = Instance::new(&mut store, &module, &[read.into()])?;
+    let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+    assert_eq!(run.call(&mut store, ())?, 10);
+
+    // The log only contains one host call.
+    assert!(run.call(&mut store, ()).is_err());
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn replay_host_call_errors() -> Result<()> {
+    let engine = engine(RRConfig::Recording)?;
+    let module = Module::new(&engine, WAT)?;
+    let log = SharedLog::default();
+    let mut store = Store::new(&engine, ());
+    store.record_host_calls(log.clone())?;
+    let read = Func::wrap(&mut store, |_: u32| -> Result<i32> { bail!("no input") });
+    let instance = Instance::new(&mut store, &module, &[read.into()])?;
+    let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+    assert!(run.call(&mut store, ()).is_err());
+    drop(store);
+
+    let engine = engine(RRConfig::Replaying)?;
+    let module = Module::new(&engine, WAT)?;
+    let mut store = Store::new(&engine, ());
+    let log = log.0.lock().unwrap().clone();
+    store.replay_host_calls(Cursor::new(log))?;
+    let read = Func::wrap(&mut store, |_: u32| -> i32 {
+        panic!("host functions aren't called while replaying")
+    });
+    let instance = Instance::new(&mut store, &module, &[read.into()])?;
+    let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+    let err = run.call(&mut store, ()).unwrap_err();
+    assert!(format!("{err:?}").contains("no input"), "{err:?}");
+    Ok(())
+}
+
+#[test]
+fn host_call_log_requires_rr_config() -> Result<()> {
+    let engine = Engine::default();
+    let mut store = Store::new(&engine, ());
+    assert!(store.record_host_calls(SharedLog::default()).is_err());
+    assert!(store.replay_host_calls(Cursor::new(Vec::new())).is_err());
+    Ok(())
+}
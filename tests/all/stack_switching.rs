@@ -0,0 +1,49 @@
+use wasmtime::*;
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn continuation_stack_cache_reuses_stacks_across_stores() -> Result<()> {
+    let mut config = Config::new();
+    config
+        .wasm_exceptions(true)
+        .wasm_function_references(true)
+        .wasm_stack_switching(true)
+        .continuation_stack_cache_size(1);
+    let engine = Engine::new(&config)?;
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (type $ft (func))
+                (type $ct (cont $ft))
+                (func $f)
+                (elem declare func $f)
+                (func (export "run")
+                    (resume $ct (cont.new $ct (ref.func $f)))
+                )
+            )
+        "#,
+    )?;
+
+    let stats = engine.continuation_stack_cache_stats();
+    assert_eq!(stats.cached_stacks(), 0);
+
+    for i in 0..3 {
+        let mut store = Store::new(&engine, ());
+        let instance = Instance::new(&mut store, &module, &[])?;
+        let run = instance.get_typed_func::<(), ()>(&mut store, "run")?;
+        run.call(&mut store, ())?;
+        drop(store);
+
+        // Only the first store needs to allocate a stack, the rest reuse the
+        // one released by the previous store.
+        let stats = engine.continuation_stack_cache_stats();
+        assert_eq!(stats.cached_stacks(), 1);
+        assert_eq!(stats.misses(), 1);
+        assert_eq!(stats.hits(), i);
+    }
+
+    assert!(engine.trim(usize::MAX) > 0);
+    assert_eq!(engine.continuation_stack_cache_stats().cached_stacks(), 0);
+    Ok(())
+}
@@ -1,5 +1,5 @@
 use std::sync::atomic::{AtomicUsize, Ordering::SeqCst};
-use wasmtime::{Engine, Store};
+use wasmtime::{Engine, Instance, Module, Result, Store, Trap};
 
 #[test]
 fn into_inner() {
@@ -20,3 +20,47 @@ fn into_inner() {
     Store::new(&engine, A).into_data();
     assert_eq!(HITS.load(SeqCst), 2);
 }
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn enter() -> Result<()> {
+    let mut store = Store::<()>::default();
+    let module = Module::new(
+        store.engine(),
+        r#"(module
+            (global $g (mut i32) (i32.const 0))
+            (func (export "incr") (result i32)
+                (global.set $g (i32.add (global.get $g) (i32.const 1)))
+                (global.get $g))
+            (func $recurse (export "recurse") call $recurse)
+        )"#,
+    )?;
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let incr = instance.get_typed_func::<(), i32>(&mut store, "incr")?;
+    let recurse = instance.get_typed_func::<(), ()>(&mut store, "recurse")?;
+
+    store.enter()?;
+    store.enter()?;
+    for i in 1..=100 {
+        assert_eq!(incr.call(&mut store, ())?, i);
+    }
+    store.exit()?;
+
+    // The stack limit set when entering still catches stack overflow.
+    let err = recurse.call(&mut store, ()).unwrap_err();
+    assert_eq!(err.downcast::<Trap>()?, Trap::StackOverflow);
+    assert_eq!(incr.call(&mut store, ())?, 101);
+
+    // The store can't be used on another thread while it's entered.
+    let mut store = std::thread::spawn(move || {
+        assert!(store.enter().is_err());
+        assert!(incr.call(&mut store, ()).is_err());
+        store
+    })
+    .join()
+    .unwrap();
+    store.exit()?;
+    assert!(store.exit().is_err());
+    assert_eq!(incr.call(&mut store, ())?, 102);
+    Ok(())
+}
@@ -386,3 +386,172 @@ fn gc_store_with_table_initializers() -> Result<()> {
 
     Ok(())
 }
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn cache_call_indirects() -> Result<()> {
+    let mut config = Config::new();
+    config.cache_call_indirects(true);
+    let engine = Engine::new(&config)?;
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (type $i2i (func (param i32) (result i32)))
+                (func $inc (type $i2i) (i32.add (local.get 0) (i32.const 1)))
+                (func $dbl (type $i2i) (i32.mul (local.get 0) (i32.const 2)))
+                (func $nop)
+
+                ;; Only holds functions of type $i2i, so calls with that type
+                ;; don't need a signature check.
+                (table $uniform 3 funcref)
+                (elem (table $uniform) (i32.const 0) func $inc $dbl)
+
+                ;; Holds functions of different types.
+                (table $mixed 3 funcref)
+                (elem (table $mixed) (i32.const 0) func $inc $nop)
+
+                (func (export "uniform") (param i32 i32) (result i32)
+                    (call_indirect $uniform (type $i2i) (local.get 1) (local.get 0)))
+                (func (export "mixed") (param i32 i32) (result i32)
+                    (call_indirect $mixed (type $i2i) (local.get 1) (local.get 0)))
+            )
+        "#,
+    )?;
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+
+    for name in ["uniform", "mixed"] {
+        let f = instance.get_typed_func::<(i32, i32), i32>(&mut store, name)?;
+        // Hit the cache, then switch to another function and back.
+        assert_eq!(f.call(&mut store, (0, 10))?, 11);
+        assert_eq!(f.call(&mut store, (0, 11))?, 12);
+        if name == "uniform" {
+            assert_eq!(f.call(&mut store, (1, 10))?, 20);
+        }
+        assert_eq!(f.call(&mut store, (0, 12))?, 13);
+
+        // Traps are never cached, and don't disturb the cache.
+        for _ in 0..2 {
+            let trap = f.call(&mut store, (2, 0)).unwrap_err();
+            assert_eq!(trap.downcast::<Trap>()?, Trap::IndirectCallToNull);
+            let trap = f.call(&mut store, (-1, 0)).unwrap_err();
+            assert_eq!(trap.downcast::<Trap>()?, Trap::TableOutOfBounds);
+        }
+        assert_eq!(f.call(&mut store, (0, 13))?, 14);
+    }
+
+    let mixed = instance.get_typed_func::<(i32, i32), i32>(&mut store, "mixed")?;
+    for _ in 0..2 {
+        let trap = mixed.call(&mut store, (1, 0)).unwrap_err();
+        assert_eq!(trap.downcast::<Trap>()?, Trap::BadSignature);
+    }
+
+    // Caches are per instance.
+    let other = Instance::new(&mut store, &module, &[])?;
+    let f = other.get_typed_func::<(i32, i32), i32>(&mut store, "uniform")?;
+    assert_eq!(f.call(&mut store, (1, 3))?, 6);
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn cache_call_indirects_mutable_tables() -> Result<()> {
+    let mut config = Config::new();
+    config.cache_call_indirects(true);
+    let engine = Engine::new(&config)?;
+
+    // Tables which are modified, whether by the module itself or through an
+    // export, must not be cached.
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (type $i2i (func (param i32) (result i32)))
+                (func $inc (type $i2i) (i32.add (local.get 0) (i32.const 1)))
+                (func $dbl (type $i2i) (i32.mul (local.get 0) (i32.const 2)))
+                (table $t 1 funcref)
+                (elem (table $t) (i32.const 0) func $inc)
+                (table $e (export "table") 1 funcref)
+                (elem (table $e) (i32.const 0) func $inc)
+                (elem declare func $dbl)
+
+                (func (export "set") (table.set $t (i32.const 0) (ref.func $dbl)))
+                (func (export "call") (param i32) (result i32)
+                    (call_indirect $t (type $i2i) (local.get 0) (i32.const 0)))
+                (func (export "call-exported") (param i32) (result i32)
+                    (call_indirect $e (type $i2i) (local.get 0) (i32.const 0)))
+                (func (export "dbl") (type $i2i) (call $dbl (local.get 0)))
+            )
+        "#,
+    )?;
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let call = instance.get_typed_func::<i32, i32>(&mut store, "call")?;
+    let set = instance.get_typed_func::<(), ()>(&mut store, "set")?;
+    assert_eq!(call.call(&mut store, 5)?, 6);
+    set.call(&mut store, ())?;
+    assert_eq!(call.call(&mut store, 5)?, 10);
+
+    let call = instance.get_typed_func::<i32, i32>(&mut store, "call-exported")?;
+    assert_eq!(call.call(&mut store, 5)?, 6);
+    let table = instance.get_table(&mut store, "table").unwrap();
+    let dbl = instance.get_func(&mut store, "dbl").unwrap();
+    table.set(&mut store, 0, dbl.into())?;
+    assert_eq!(call.call(&mut store, 5)?, 10);
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn table_eager_init_threshold() -> Result<()> {
+    let wat = r#"
+        (module
+            (type $i2i (func (param i32) (result i32)))
+            (func $inc (type $i2i) (i32.add (local.get 0) (i32.const 1)))
+            (func $dbl (type $i2i) (i32.mul (local.get 0) (i32.const 2)))
+            (table $small 3 funcref)
+            (elem (table $small) (i32.const 0) func $inc $dbl)
+            (table $large 100 funcref)
+            (elem (table $large) (i32.const 0) func $inc $dbl)
+
+            (func (export "small") (param i32 i32) (result i32)
+                (call_indirect $small (type $i2i) (local.get 1) (local.get 0)))
+            (func (export "large") (param i32 i32) (result i32)
+                (call_indirect $large (type $i2i) (local.get 1) (local.get 0)))
+            (func (export "grow-small")
+                (drop (table.grow $small (ref.null func) (i32.const 1))))
+        )
+    "#;
+
+    for threshold in [0, 10] {
+        let mut config = Config::new();
+        config.table_eager_init_threshold(threshold);
+        let engine = Engine::new(&config)?;
+        let module = Module::new(&engine, wat)?;
+        let mut store = Store::new(&engine, ());
+        let instance = Instance::new(&mut store, &module, &[])?;
+        assert_eq!(instance.lazy_table_inits(&store), 0);
+
+        let small = instance.get_typed_func::<(i32, i32), i32>(&mut store, "small")?;
+        assert_eq!(small.call(&mut store, (0, 10))?, 11);
+        assert_eq!(small.call(&mut store, (1, 10))?, 20);
+        let trap = small.call(&mut store, (2, 0)).unwrap_err();
+        assert_eq!(trap.downcast::<Trap>()?, Trap::IndirectCallToNull);
+
+        // Elements added by growing the table are initialized either way.
+        let grow = instance.get_typed_func::<(), ()>(&mut store, "grow-small")?;
+        grow.call(&mut store, ())?;
+        let trap = small.call(&mut store, (3, 0)).unwrap_err();
+        assert_eq!(trap.downcast::<Trap>()?, Trap::IndirectCallToNull);
+        let small_inits = if threshold == 0 { 3 } else { 0 };
+        assert_eq!(instance.lazy_table_inits(&store), small_inits);
+
+        // The large table is initialized lazily regardless.
+        let large = instance.get_typed_func::<(i32, i32), i32>(&mut store, "large")?;
+        assert_eq!(large.call(&mut store, (1, 10))?, 20);
+        assert_eq!(large.call(&mut store, (1, 11))?, 22);
+        assert_eq!(instance.lazy_table_inits(&store), small_inits + 1);
+    }
+    Ok(())
+}
@@ -230,6 +230,38 @@ fn test_trap_backtrace_disabled() -> Result<()> {
     Ok(())
 }
 
+#[test]
+fn test_trap_backtrace_store_setting() -> Result<()> {
+    let mut config = Config::default();
+    config.wasm_backtrace(false);
+    let engine = Engine::new(&config)?;
+    let module = Module::new(
+        &engine,
+        r#"
+            (module $hello_mod
+                (func (export "run") (call $hello))
+                (func $hello (unreachable))
+            )
+        "#,
+    )?;
+
+    let mut store = Store::<()>::new(&engine, ());
+    store.set_wasm_backtrace(true);
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let run_func = instance.get_typed_func::<(), ()>(&mut store, "run")?;
+    let e = run_func.call(&mut store, ()).unwrap_err();
+    let trace = e.downcast_ref::<WasmBacktrace>().unwrap().frames();
+    assert_eq!(trace.len(), 2);
+    assert_eq!(trace[0].func_name(), Some("hello"));
+    assert!(trace[0].symbols().is_empty());
+
+    store.set_wasm_backtrace(false);
+    let e = run_func.call(&mut store, ()).unwrap_err();
+    assert!(e.downcast_ref::<WasmBacktrace>().is_none());
+    assert_eq!(e.downcast::<Trap>()?, Trap::UnreachableCodeReached);
+    Ok(())
+}
+
 #[test]
 fn test_trap_trace_cb() -> Result<()> {
     let mut store = Store::<()>::default();
@@ -1823,3 +1855,125 @@ fn return_call_to_aborting_wasm_function_with_stack_adjustments() -> Result<()>
 
     Ok(())
 }
+
+#[test]
+#[cfg(unix)]
+fn signal_interruption_traps_infinite_loop() -> Result<()> {
+    let mut config = Config::new();
+    config.signal_interruption(true).gc_support(false);
+    let engine = Engine::new(&config)?;
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (func (export "run")
+                    (loop $l br $l)))
+        "#,
+    )?;
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let run = instance.get_typed_func::<(), ()>(&mut store, "run")?;
+
+    let handle = store.interrupt_handle()?;
+    let interrupter = std::thread::spawn(move || {
+        std::thread::sleep(std::time::Duration::from_millis(50));
+        handle.interrupt();
+    });
+    let err = run.call(&mut store, ()).unwrap_err();
+    assert_eq!(err.downcast::<Trap>()?, Trap::Interrupt);
+    interrupter.join().unwrap();
+
+    // An interrupt requested while nothing is running is delivered when wasm
+    // is next entered.
+    store.interrupt_handle()?.interrupt();
+    let err = run.call(&mut store, ()).unwrap_err();
+    assert_eq!(err.downcast::<Trap>()?, Trap::Interrupt);
+
+    // Stores of engines without signal interruption have no handle.
+    assert!(Store::<()>::default().interrupt_handle().is_err());
+    Ok(())
+}
+
+#[test]
+#[cfg(unix)]
+fn cpu_accounting_and_instruction_budget() -> Result<()> {
+    let mut config = Config::new();
+    config.signal_interruption(true).gc_support(false);
+    let engine = Engine::new(&config)?;
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (func (export "spin") (param i32)
+                    (loop $l
+                        local.get 0
+                        i32.const 1
+                        i32.sub
+                        local.tee 0
+                        br_if $l))
+                (func (export "forever")
+                    (loop $l br $l)))
+        "#,
+    )?;
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let spin = instance.get_typed_func::<i32, ()>(&mut store, "spin")?;
+    let forever = instance.get_typed_func::<(), ()>(&mut store, "forever")?;
+
+    assert!(store.cpu_usage().is_none());
+    assert!(store.set_instruction_budget(Some(1)).is_err());
+    store.enable_cpu_accounting()?;
+    let before = store.cpu_usage().unwrap();
+    spin.call(&mut store, 10_000_000)?;
+    let after = store.cpu_usage().unwrap();
+    assert!(after.cpu_time > before.cpu_time);
+
+    let Some(instructions) = after.instructions else {
+        // Performance counters aren't available here.
+        return Ok(());
+    };
+    assert!(instructions >= 10_000_000);
+
+    store.set_instruction_budget(Some(100_000_000))?;
+    let err = forever.call(&mut store, ()).unwrap_err();
+    assert_eq!(err.downcast::<Trap>()?, Trap::Interrupt);
+    let used = store.cpu_usage().unwrap().instructions.unwrap() - instructions;
+    assert!(used >= 100_000_000);
+
+    // Without a budget nothing is interrupted.
+    store.set_instruction_budget(None)?;
+    spin.call(&mut store, 1_000_000)?;
+    Ok(())
+}
+
+#[test]
+#[cfg(unix)]
+fn guest_cpu_time_excludes_host_calls() -> Result<()> {
+    let engine = Engine::default();
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (import "" "host" (func $host))
+                (func (export "run")
+                    call $host))
+        "#,
+    )?;
+    let mut store = Store::new(&engine, ());
+    store.enable_cpu_accounting()?;
+    let host = Func::wrap(&mut store, || {
+        // Burn some CPU time in the host.
+        let start = std::time::Instant::now();
+        while start.elapsed() < std::time::Duration::from_millis(50) {
+            std::hint::spin_loop();
+        }
+    });
+    let instance = Instance::new(&mut store, &module, &[host.into()])?;
+    let run = instance.get_typed_func::<(), ()>(&mut store, "run")?;
+    run.call(&mut store, ())?;
+
+    let usage = store.cpu_usage().unwrap();
+    assert!(usage.cpu_time >= std::time::Duration::from_millis(40));
+    assert!(usage.guest_cpu_time < std::time::Duration::from_millis(10));
+    Ok(())
+}
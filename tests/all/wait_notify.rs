@@ -120,3 +120,62 @@ fn atomic_wait_notify_basic() -> Result<()> {
     assert_eq!(shared_memory_second_word, 21);
     Ok(())
 }
+
+#[test]
+fn atomic_hook_observes_guest_waits() -> Result<()> {
+    let wat = r#"(module
+        (import "env" "memory" (memory 1 1 shared))
+
+        (func (export "wait") (result i32)
+            (memory.atomic.wait32 (i32.const 8) (i32.const 0) (i64.const -1))
+        )
+
+        (func (export "notify") (result i32)
+            (memory.atomic.notify (i32.const 16) (i32.const 2))
+        )
+    )"#;
+    let Some(engine) = engine() else {
+        return Ok(());
+    };
+    let module = Module::new(&engine, wat)?;
+    let shared_memory = SharedMemory::new(&engine, MemoryType::shared(1, 1))?;
+    let (tx, rx) = std::sync::mpsc::channel();
+    let tx = std::sync::Mutex::new(tx);
+    shared_memory.set_atomic_hook(move |event| tx.lock().unwrap().send(event).unwrap());
+
+    let thread = {
+        let engine = engine.clone();
+        let module = module.clone();
+        let shared_memory = shared_memory.clone();
+        std::thread::spawn(move || {
+            let mut store = Store::new(&engine, ());
+            let instance = Instance::new(&mut store, &module, &[shared_memory.into()]).unwrap();
+            let wait = instance
+                .get_typed_func::<(), i32>(&mut store, "wait")
+                .unwrap();
+            wait.call(&mut store, ()).unwrap()
+        })
+    };
+
+    // Once the guest reports that it's waiting, wake it from the host.
+    assert_eq!(rx.recv()?, SharedMemoryEvent::Wait { addr: 8 });
+    while shared_memory.atomic_notify(8, 1)? == 0 {
+        std::thread::yield_now();
+    }
+    assert_eq!(thread.join().unwrap(), 0);
+
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[shared_memory.clone().into()])?;
+    let notify = instance.get_typed_func::<(), i32>(&mut store, "notify")?;
+    assert_eq!(notify.call(&mut store, ())?, 0);
+
+    shared_memory.clear_atomic_hook();
+    let events = rx.try_iter().collect::<Vec<_>>();
+    let notify = SharedMemoryEvent::Notify {
+        addr: 16,
+        count: 2,
+        woken: 0,
+    };
+    assert_eq!(events.last(), Some(&notify));
+    Ok(())
+}
@@ -0,0 +1,25 @@
+;;! target = "pulley64"
+;;! test = "compile"
+
+(module
+  (func $shladd32 (param i32 i32) (result i32)
+    (i32.add
+      (local.get 0)
+      (i32.shl (local.get 1) (i32.const 2))))
+
+  (func $shladd64 (param i64 i64) (result i64)
+    (i64.add
+      (i64.shl (local.get 1) (i64.const 3))
+      (local.get 0)))
+)
+;; wasm[0]::function[0]::shladd32:
+;;       push_frame
+;;       xshladd32 x0, x2, x3, 2
+;;       pop_frame
+;;       ret
+;;
+;; wasm[0]::function[1]::shladd64:
+;;       push_frame
+;;       xshladd64 x0, x2, x3, 3
+;;       pop_frame
+;;       ret
@@ -30,7 +30,7 @@
 ;;       movk    x17, #0x28
 ;;       add     x16, x16, x17
 ;;       cmp     sp, x16
-;;       b.lo    #0x150
+;;       b.lo    #0x138
 ;;   2c: mov     x9, x1
 ;;       sub     x28, x28, #0x20
 ;;       mov     sp, x28
@@ -40,41 +40,35 @@
 ;;       stur    x0, [x28]
 ;;       ldur    w0, [x28, #0xc]
 ;;       ldur    x1, [x9, #0x40]
-;;       mov     w2, w0
-;;       adds    x2, x2, #4
-;;       b.hs    #0x154
-;;   5c: cmp     x2, x1, uxtx
-;;       b.hi    #0x158
-;;   64: ldur    x3, [x9, #0x38]
-;;       add     x3, x3, x0, uxtx
-;;       mov     x4, #0
-;;       cmp     x2, x1, uxtx
-;;       csel    x3, x4, x3, hi
-;;       ldur    w0, [x3]
+;;       cmp     x0, x1, uxtx
+;;       b.hi    #0x13c
+;;   58: ldur    x2, [x9, #0x38]
+;;       add     x2, x2, x0, uxtx
+;;       mov     x3, #0
+;;       cmp     x0, x1, uxtx
+;;       csel    x2, x3, x2, hi
+;;       ldur    w0, [x2]
 ;;       ldur    w1, [x28, #0xc]
 ;;       ldur    x2, [x9, #0x40]
-;;       mov     w3, w1
-;;       adds    x3, x3, #8
-;;       b.hs    #0x15c
-;;   90: cmp     x3, x2, uxtx
-;;       b.hi    #0x160
-;;   98: ldur    x4, [x9, #0x38]
-;;       add     x4, x4, x1, uxtx
-;;       add     x4, x4, #4
-;;       mov     x5, #0
-;;       cmp     x3, x2, uxtx
-;;       csel    x4, x5, x4, hi
-;;       ldur    w1, [x4]
+;;       cmp     x1, x2, uxtx
+;;       b.hi    #0x140
+;;   80: ldur    x3, [x9, #0x38]
+;;       add     x3, x3, x1, uxtx
+;;       add     x3, x3, #4
+;;       mov     x4, #0
+;;       cmp     x1, x2, uxtx
+;;       csel    x3, x4, x3, hi
+;;       ldur    w1, [x3]
 ;;       ldur    w2, [x28, #0xc]
 ;;       ldur    x3, [x9, #0x40]
 ;;       mov     w4, w2
 ;;       mov     w16, #3
 ;;       movk    w16, #0x10, lsl #16
 ;;       adds    x4, x4, x16, uxtx
-;;       b.hs    #0x164
-;;   d0: cmp     x4, x3, uxtx
-;;       b.hi    #0x168
-;;   d8: ldur    x5, [x9, #0x38]
+;;       b.hs    #0x144
+;;   b8: cmp     x4, x3, uxtx
+;;       b.hi    #0x148
+;;   c0: ldur    x5, [x9, #0x38]
 ;;       add     x5, x5, x2, uxtx
 ;;       orr     x16, xzr, #0xfffff
 ;;       add     x5, x5, x16, uxtx
@@ -104,10 +98,8 @@
 ;;       ldr     x28, [sp], #0x10
 ;;       ldp     x29, x30, [sp], #0x10
 ;;       ret
-;;  150: .byte   0x1f, 0xc1, 0x00, 0x00
-;;  154: .byte   0x1f, 0xc1, 0x00, 0x00
-;;  158: .byte   0x1f, 0xc1, 0x00, 0x00
-;;  15c: .byte   0x1f, 0xc1, 0x00, 0x00
-;;  160: .byte   0x1f, 0xc1, 0x00, 0x00
-;;  164: .byte   0x1f, 0xc1, 0x00, 0x00
-;;  168: .byte   0x1f, 0xc1, 0x00, 0x00
+;;  138: .byte   0x1f, 0xc1, 0x00, 0x00
+;;  13c: .byte   0x1f, 0xc1, 0x00, 0x00
+;;  140: .byte   0x1f, 0xc1, 0x00, 0x00
+;;  144: .byte   0x1f, 0xc1, 0x00, 0x00
+;;  148: .byte   0x1f, 0xc1, 0x00, 0x00
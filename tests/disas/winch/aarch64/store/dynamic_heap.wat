@@ -30,7 +30,7 @@
 ;;       movk    x17, #0x20
 ;;       add     x16, x16, x17
 ;;       cmp     sp, x16
-;;       b.lo    #0x124
+;;       b.lo    #0x10c
 ;;   2c: mov     x9, x0
 ;;       sub     x28, x28, #0x20
 ;;       mov     sp, x28
@@ -43,32 +43,26 @@
 ;;       ldur    w0, [x28, #8]
 ;;       ldur    w1, [x28, #0xc]
 ;;       ldur    x2, [x9, #0x40]
-;;       mov     w3, w1
-;;       adds    x3, x3, #4
-;;       b.hs    #0x128
-;;   68: cmp     x3, x2, uxtx
-;;       b.hi    #0x12c
-;;   70: ldur    x4, [x9, #0x38]
-;;       add     x4, x4, x1, uxtx
-;;       mov     x5, #0
-;;       cmp     x3, x2, uxtx
-;;       csel    x4, x5, x4, hi
-;;       stur    w0, [x4]
+;;       cmp     x1, x2, uxtx
+;;       b.hi    #0x110
+;;   64: ldur    x3, [x9, #0x38]
+;;       add     x3, x3, x1, uxtx
+;;       mov     x4, #0
+;;       cmp     x1, x2, uxtx
+;;       csel    x3, x4, x3, hi
+;;       stur    w0, [x3]
 ;;       ldur    w0, [x28, #4]
 ;;       ldur    w1, [x28, #0xc]
 ;;       ldur    x2, [x9, #0x40]
-;;       mov     w3, w1
-;;       adds    x3, x3, #8
-;;       b.hs    #0x130
-;;   a0: cmp     x3, x2, uxtx
-;;       b.hi    #0x134
-;;   a8: ldur    x4, [x9, #0x38]
-;;       add     x4, x4, x1, uxtx
-;;       add     x4, x4, #4
-;;       mov     x5, #0
-;;       cmp     x3, x2, uxtx
-;;       csel    x4, x5, x4, hi
-;;       stur    w0, [x4]
+;;       cmp     x1, x2, uxtx
+;;       b.hi    #0x114
+;;   90: ldur    x3, [x9, #0x38]
+;;       add     x3, x3, x1, uxtx
+;;       add     x3, x3, #4
+;;       mov     x4, #0
+;;       cmp     x1, x2, uxtx
+;;       csel    x3, x4, x3, hi
+;;       stur    w0, [x3]
 ;;       ldur    w0, [x28]
 ;;       ldur    w1, [x28, #0xc]
 ;;       ldur    x2, [x9, #0x40]
@@ -76,10 +70,10 @@
 ;;       mov     w16, #3
 ;;       movk    w16, #0x10, lsl #16
 ;;       adds    x3, x3, x16, uxtx
-;;       b.hs    #0x138
-;;   e4: cmp     x3, x2, uxtx
-;;       b.hi    #0x13c
-;;   ec: ldur    x4, [x9, #0x38]
+;;       b.hs    #0x118
+;;   cc: cmp     x3, x2, uxtx
+;;       b.hi    #0x11c
+;;   d4: ldur    x4, [x9, #0x38]
 ;;       add     x4, x4, x1, uxtx
 ;;       orr     x16, xzr, #0xfffff
 ;;       add     x4, x4, x16, uxtx
@@ -93,10 +87,8 @@
 ;;       ldr     x28, [sp], #0x10
 ;;       ldp     x29, x30, [sp], #0x10
 ;;       ret
-;;  124: .byte   0x1f, 0xc1, 0x00, 0x00
-;;  128: .byte   0x1f, 0xc1, 0x00, 0x00
-;;  12c: .byte   0x1f, 0xc1, 0x00, 0x00
-;;  130: .byte   0x1f, 0xc1, 0x00, 0x00
-;;  134: .byte   0x1f, 0xc1, 0x00, 0x00
-;;  138: .byte   0x1f, 0xc1, 0x00, 0x00
-;;  13c: .byte   0x1f, 0xc1, 0x00, 0x00
+;;  10c: .byte   0x1f, 0xc1, 0x00, 0x00
+;;  110: .byte   0x1f, 0xc1, 0x00, 0x00
+;;  114: .byte   0x1f, 0xc1, 0x00, 0x00
+;;  118: .byte   0x1f, 0xc1, 0x00, 0x00
+;;  11c: .byte   0x1f, 0xc1, 0x00, 0x00
@@ -135,3 +135,57 @@
   (export "empty-list" (func $f))
 )
 (assert_trap (invoke "empty-list" (list.const)) "realloc return: beyond end of memory")
+
+;; lists of primitives are copied between components in one go
+(component
+  (component $callee
+    (core module $m
+      (memory (export "memory") 1)
+      (func (export "realloc") (param i32 i32 i32 i32) (result i32)
+        i32.const 100)
+      (func (export "sum") (param $ptr i32) (param $len i32) (result i32)
+        (local $sum i32)
+        (block $done
+          (loop $loop
+            (br_if $done (i32.eqz (local.get $len)))
+            (local.set $sum
+              (i32.add (local.get $sum) (i32.load (local.get $ptr))))
+            (local.set $ptr (i32.add (local.get $ptr) (i32.const 4)))
+            (local.set $len (i32.sub (local.get $len) (i32.const 1)))
+            (br $loop)))
+        local.get $sum)
+    )
+    (core instance $i (instantiate $m))
+    (func (export "sum") (param "a" (list u32)) (result u32)
+      (canon lift
+        (core func $i "sum")
+        (memory $i "memory")
+        (realloc (func $i "realloc"))
+      )
+    )
+  )
+  (component $caller
+    (import "sum" (func $sum (param "a" (list u32)) (result u32)))
+    (core module $libc (memory (export "memory") 1))
+    (core instance $libc (instantiate $libc))
+    (core func $sum_lower (canon lower (func $sum) (memory $libc "memory")))
+    (core module $m
+      (import "" "memory" (memory 1))
+      (import "" "sum" (func $sum (param i32 i32) (result i32)))
+      (data (i32.const 8) "\01\00\00\00\02\00\00\00\03\00\00\00\04\00\00\00")
+      (func (export "run") (result i32)
+        (call $sum (i32.const 8) (i32.const 4)))
+    )
+    (core instance $i (instantiate $m
+      (with "" (instance
+        (export "memory" (memory $libc "memory"))
+        (export "sum" (func $sum_lower))
+      ))
+    ))
+    (func (export "run") (result u32) (canon lift (core func $i "run")))
+  )
+  (instance $callee (instantiate $callee))
+  (instance $caller (instantiate $caller (with "sum" (func $callee "sum"))))
+  (export "run" (func $caller "run"))
+)
+(assert_return (invoke "run") (u32.const 10))
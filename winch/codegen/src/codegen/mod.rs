@@ -663,7 +663,10 @@ where
     /// Winch implementation differs in that, it defaults to the general case
     /// for dynamic heaps rather than optimizing for doing the least amount of
     /// work possible at runtime, this is done to align with Winch's principle
-    /// of doing the least amount of work possible at compile time. For static
+    /// of doing the least amount of work possible at compile time. The
+    /// exception is an access covered by the guard region, which only needs
+    /// to be checked against the heap's bound, and which is both cheaper to
+    /// compile and to run than the general case. For static
     /// heaps, Winch does a bit more of work, given that some of the cases that
     /// are checked against, can benefit compilation times, like for example,
     /// detecting an out of bounds access at compile time.
@@ -780,6 +783,45 @@ where
                 },
             )?;
             Some(addr)
+
+        // Account for the case in which the guard region is at least as large
+        // as `offset + access_size`. The access is out of bounds if:
+        //
+        // index > bound
+        //
+        // Any access which passes that check, but which lands beyond the
+        // bound, will fault in the guard region and be reported by the
+        // virtual memory subsystem at runtime. This avoids the overflow check
+        // and the temporary register needed by the general case below.
+        } else if heap
+            .memory
+            .can_use_virtual_memory(self.tunables, self.env.page_size_log2)
+            && offset_with_access_size <= self.tunables.memory_guard_size
+        {
+            let bounds = bounds::load_dynamic_heap_bounds::<_>(
+                &mut self.context,
+                self.masm,
+                &heap,
+                ptr_size,
+            )?;
+            let addr = bounds::load_heap_addr_checked(
+                self.masm,
+                &mut self.context,
+                ptr_size,
+                &heap,
+                enable_spectre_mitigation,
+                bounds,
+                index,
+                offset,
+                |masm, bounds, index| {
+                    let index_reg = index.as_typed_reg().reg;
+                    let bounds_reg = bounds.as_typed_reg().reg;
+                    masm.cmp(index_reg, bounds_reg.into(), ptr_size)?;
+                    Ok(IntCmpKind::GtU)
+                },
+            )?;
+            self.context.free_reg(bounds.as_typed_reg().reg);
+            Some(addr)
         } else {
             // Account for the general case for bounds-checked memories. The
             // access is out of bounds if: